@@ -140,6 +140,45 @@ void sys_cache_flush(vaddr_t start_addr, size_t size)
 	dcache_flush_mlines((u32_t)start_addr, (u32_t)size);
 }
 
+/**
+ *
+ * @brief Invalidate d-cache lines
+ *
+ * The lines covering <start_addr> and <size> are discarded without being
+ * written back, so that the next reads get what is in memory.
+ *
+ * @param start_addr the pointer to start the multi-line invalidation
+ * @param size the number of bytes that are to be invalidated
+ *
+ * @return N/A
+ */
+
+void sys_cache_invalidate(vaddr_t start_addr, size_t size)
+{
+	u32_t addr = (u32_t)start_addr;
+	u32_t end_addr;
+	unsigned int key;
+
+	if (!dcache_available() || (size == 0)) {
+		return;
+	}
+
+	end_addr = addr + size - 1;
+	addr &= (u32_t)(~(DCACHE_LINE_SIZE - 1));
+
+	key = irq_lock(); /* --enter critical section-- */
+
+	do {
+		_arc_v2_aux_reg_write(_ARC_V2_DC_IVDL, addr);
+		__asm__ volatile("nop_s");
+		__asm__ volatile("nop_s");
+		__asm__ volatile("nop_s");
+		addr += DCACHE_LINE_SIZE;
+	} while (addr <= end_addr);
+
+	irq_unlock(key); /* --exit critical section-- */
+}
+
 
 #if defined(CONFIG_CACHE_LINE_SIZE_DETECT)
 size_t sys_cache_line_size;
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief d-cache manipulation
+ *
+ * This module contains functions for manipulation of the d-cache of the
+ * Cortex-M7.
+ */
+
+#include <kernel.h>
+#include <arch/cpu.h>
+#include <misc/util.h>
+#include <cache.h>
+#include <arch/arm/cortex_m/cmsis.h>
+
+#define DCACHE_LINE_SIZE CONFIG_CACHE_LINE_SIZE
+
+/**
+ *
+ * @brief Flush d-cache lines to main memory
+ *
+ * No alignment is required for either <virt> or <size>, the d-cache lines
+ * covering the buffer are cleaned.
+ *
+ * @return N/A
+ */
+void sys_cache_flush(vaddr_t virt, size_t size)
+{
+	u32_t start = (u32_t)virt & ~(DCACHE_LINE_SIZE - 1);
+
+	if (!size) {
+		return;
+	}
+
+	SCB_CleanDCache_by_Addr((u32_t *)start, (u32_t)virt - start + size);
+}
+
+/**
+ *
+ * @brief Invalidate d-cache lines
+ *
+ * The d-cache lines covering <virt> and <size> are discarded, so that the
+ * next reads get what is in main memory. Whatever shares these lines must
+ * not have been written since the buffer was flushed.
+ *
+ * @return N/A
+ */
+void sys_cache_invalidate(vaddr_t virt, size_t size)
+{
+	u32_t start = (u32_t)virt & ~(DCACHE_LINE_SIZE - 1);
+
+	if (!size) {
+		return;
+	}
+
+	SCB_InvalidateDCache_by_Addr((u32_t *)start,
+				     (u32_t)virt - start + size);
+}
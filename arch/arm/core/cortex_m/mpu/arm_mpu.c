@@ -281,6 +281,61 @@ void arm_core_mpu_configure(u8_t type, u32_t base, u32_t size)
 }
 
 #if defined(CONFIG_USERSPACE)
+/*
+ * Shadow copy of the domain partition regions, as last written to the MPU.
+ * Switching between threads of different memory domains then only rewrites
+ * the regions that differ, most often none or a few of them.
+ */
+#define DOMAIN_REGIONS_CACHED 16
+
+static u32_t domain_rbar[DOMAIN_REGIONS_CACHED];
+static u32_t domain_rasr[DOMAIN_REGIONS_CACHED];
+static u32_t domain_cached;
+
+/**
+ * This internal function programs a domain partition region, unless the
+ * region already holds the given configuration.
+ */
+static void _domain_region_set(u32_t index, u32_t rbar, u32_t rasr)
+{
+	u32_t slot = index -
+		_get_region_index_by_type(THREAD_DOMAIN_PARTITION_REGION);
+
+	if (slot < DOMAIN_REGIONS_CACHED) {
+		if ((domain_cached & BIT(slot)) && domain_rbar[slot] == rbar &&
+		    domain_rasr[slot] == rasr) {
+			return;
+		}
+		domain_rbar[slot] = rbar;
+		domain_rasr[slot] = rasr;
+		domain_cached |= BIT(slot);
+	}
+
+	ARM_MPU_DEV->rnr = index;
+	ARM_MPU_DEV->rbar = rbar;
+	ARM_MPU_DEV->rasr = rasr;
+}
+
+static void _domain_region_init(u32_t index, u32_t region_addr,
+				u32_t region_attr)
+{
+	SYS_LOG_DBG("[%d] 0x%08x 0x%08x", index, region_addr, region_attr);
+	_domain_region_set(index,
+			   (region_addr & REGION_BASE_ADDR_MASK) |
+			   REGION_VALID | index,
+			   region_attr | REGION_ENABLE);
+}
+
+static void _domain_region_disable(u32_t index)
+{
+	__ASSERT(index < _get_num_regions(),
+		"Index 0x%x out-of-bound (supported regions: 0x%x)\n",
+		index,
+		_get_num_regions());
+	SYS_LOG_DBG("disable region 0x%x", index);
+	_domain_region_set(index, 0, 0);
+}
+
 void arm_core_mpu_configure_user_context(struct k_thread *thread)
 {
 	u32_t base = (u32_t)thread->stack_obj;
@@ -342,10 +397,11 @@ void arm_core_mpu_configure_mem_domain(struct k_mem_domain *mem_domain)
 				    region_index, pparts->start, pparts->size);
 			region_attr = pparts->attr |
 				      _size_to_mpu_rasr_size(pparts->size);
-			_region_init(region_index, pparts->start, region_attr);
+			_domain_region_init(region_index, pparts->start,
+					    region_attr);
 			num_partitions--;
 		} else {
-			_disable_region(region_index);
+			_domain_region_disable(region_index);
 		}
 		pparts++;
 	}
@@ -371,10 +427,10 @@ void arm_core_mpu_configure_mem_partition(u32_t part_index,
 		SYS_LOG_DBG("set region 0x%x 0x%x 0x%x",
 			    region_index + part_index, part->start, part->size);
 		region_attr = part->attr | _size_to_mpu_rasr_size(part->size);
-		_region_init(region_index + part_index, part->start,
-			     region_attr);
+		_domain_region_init(region_index + part_index, part->start,
+				    region_attr);
 	} else {
-		_disable_region(region_index + part_index);
+		_domain_region_disable(region_index + part_index);
 	}
 }
 
@@ -388,7 +444,7 @@ void arm_core_mpu_mem_partition_remove(u32_t part_index)
 	u32_t region_index =
 		_get_region_index_by_type(THREAD_DOMAIN_PARTITION_REGION);
 
-	_disable_region(region_index + part_index);
+	_domain_region_disable(region_index + part_index);
 }
 
 /**
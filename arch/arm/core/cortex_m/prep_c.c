@@ -70,9 +70,14 @@ static inline void enable_floating_point(void)
 	 * Upon reset, the FPU Context Control Register is 0xC0000000
 	 * (both Automatic and Lazy state preservation is enabled).
 	 * Disable lazy state preservation so the volatile FP registers are
-	 * always saved on exception.
+	 * always saved on exception, unless the context switch code takes
+	 * care of completing it (see __pendsv()).
 	 */
+#ifdef CONFIG_FP_SHARING_LAZY
+	FPU->FPCCR = FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk;
+#else
 	FPU->FPCCR = FPU_FPCCR_ASPEN_Msk; /* FPU_FPCCR_LSPEN = 0 */
+#endif
 
 	/*
 	 * Although automatic state preservation is enabled, the processor
@@ -114,6 +119,11 @@ void _PrepC(void)
 	enable_floating_point();
 	_bss_zero();
 	_data_copy();
+#ifdef CONFIG_ARCH_HAS_RAMFUNC_SUPPORT
+	/* code may have been copied to RAM, complete it before running it */
+	__DSB();
+	__ISB();
+#endif
 #ifdef CONFIG_BOOT_TIME_MEASUREMENT
 	__start_time_stamp = 0;
 #endif
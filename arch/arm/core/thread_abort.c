@@ -39,6 +39,13 @@ void _impl_k_thread_abort(k_tid_t thread)
 	_k_thread_single_abort(thread);
 	_thread_monitor_exit(thread);
 
+#ifdef CONFIG_FP_SHARING_LAZY
+	/* its live FP context must not be saved once the thread is gone */
+	if (_kernel.current_fp == thread) {
+		_kernel.current_fp = NULL;
+	}
+#endif
+
 	if (_current == thread) {
 		if ((SCB->ICSR & SCB_ICSR_VECTACTIVE_Msk) == 0) {
 			_Swap(key);
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Alternative to posix_core.c, with the same interface to the rest of the
+ * POSIX arch
+ *
+ * Principle of operation:
+ *
+ * All Zephyr threads run on the single native pthread started by the SOC to
+ * emulate the CPU. Each Zephyr thread has its own native context and stack,
+ * and a context switch is just a swapcontext() on that same pthread,
+ * instead of a handoff between pthreads through a mutex and condition
+ * variable, which costs several host syscalls and host scheduler decisions.
+ *
+ * As in posix_core.c, a table (threads_table) is used to abstract the native
+ * contexts, and an index in this table identifies threads in the IF to the
+ * kernel. The contexts are allocated apart from the table, as a ucontext_t
+ * may not be moved once saved (it may point into itself).
+ */
+
+#define POSIX_ARCH_DEBUG_PRINTS 0
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include "posix_core.h"
+#include "posix_arch_internal.h"
+#include "posix_soc_if.h"
+#include "kernel_internal.h"
+#include "kernel_structs.h"
+#include "ksched.h"
+#include "kswap.h"
+
+#define PREFIX     "POSIX arch core: "
+#define ERPREFIX   PREFIX"error on "
+#define NO_MEM_ERR PREFIX"Can't allocate memory\n"
+
+#if POSIX_ARCH_DEBUG_PRINTS
+#define PC_DEBUG(fmt, ...) posix_print_trace(PREFIX fmt, __VA_ARGS__)
+#else
+#define PC_DEBUG(...)
+#endif
+
+#define PC_ALLOC_CHUNK_SIZE 64
+
+/* Native context of a thread, followed by its native stack */
+struct thread_context {
+	ucontext_t context;
+	char stack[] __aligned(16);
+};
+
+static int threads_table_size;
+struct threads_table_el {
+	enum {NOTUSED = 0, USED, ABORTED, FAILED} state;
+	struct thread_context *ctx;
+	posix_thread_status_t *status;
+	int thead_cnt; /* For debugging: Unique, consecutive, thread number */
+};
+
+static struct threads_table_el *threads_table;
+
+static int thread_create_count; /* For debugging. Thread creation counter */
+
+/* The native pthread emulating the CPU */
+static pthread_t cpu_thread;
+/* Index of the running thread, -1 for the init thread */
+static int currently_running_thread;
+/* Context of a thread which aborted itself, freed once switched out of */
+static struct thread_context *zombie_ctx;
+
+static void free_zombie(void)
+{
+	free(zombie_ctx);
+	zombie_ctx = NULL;
+}
+
+/**
+ * Let the ready thread run, and suspend this thread until it is swapped back
+ * in, or drop it for good if it is being aborted
+ *
+ * called from __swap() which does the picking from the kernel structures
+ */
+void posix_swap(int next_allowed_thread_nbr, int this_th_nbr)
+{
+	struct threads_table_el *this = &threads_table[this_th_nbr];
+	struct threads_table_el *next = &threads_table[next_allowed_thread_nbr];
+
+	PC_DEBUG("%s: We let thread [%i] %i run\n",
+		__func__,
+		next->thead_cnt,
+		next_allowed_thread_nbr);
+
+	currently_running_thread = next_allowed_thread_nbr;
+
+	if (this->state == ABORTED) {
+		PC_DEBUG("Thread [%i] %i: %s: Aborting curr.\n",
+			this->thead_cnt,
+			this_th_nbr,
+			__func__);
+
+		/* We cannot free the stack we are running on */
+		zombie_ctx = this->ctx;
+		this->ctx = NULL;
+		setcontext(&next->ctx->context);
+		CODE_UNREACHABLE; /* LCOV_EXCL_LINE */
+	}
+
+	_SAFE_CALL(swapcontext(&this->ctx->context, &next->ctx->context));
+
+	free_zombie();
+}
+
+/**
+ * Let the ready thread (main) run, and drop the init thread
+ *
+ * Called from _arch_switch_to_main_thread() which does the picking from the
+ * kernel structures
+ *
+ * The init thread runs directly on the stack of the CPU pthread, which is
+ * simply left behind
+ */
+void posix_main_thread_start(int next_allowed_thread_nbr)
+{
+	PC_DEBUG("%s: Init thread dying now\n", __func__);
+
+	currently_running_thread = next_allowed_thread_nbr;
+	setcontext(&threads_table[next_allowed_thread_nbr].ctx->context);
+	CODE_UNREACHABLE; /* LCOV_EXCL_LINE */
+}
+
+/**
+ * Entry point of the native context of a Zephyr thread, run the first time
+ * the thread is swapped in
+ */
+static void posix_thread_starter(int thread_idx)
+{
+	posix_thread_status_t *ptr = threads_table[thread_idx].status;
+
+	PC_DEBUG("Thread [%i] %i: %s: Starting\n",
+		threads_table[thread_idx].thead_cnt,
+		thread_idx,
+		__func__);
+
+	free_zombie();
+
+	posix_new_thread_pre_start();
+
+	_thread_entry(ptr->entry_point, ptr->arg1, ptr->arg2, ptr->arg3);
+
+	/*
+	 * We only reach this point if the thread actually returns which should
+	 * not happen. There is no other pthread to fall back to, as there
+	 * would be in posix_core.c
+	 */
+	/* LCOV_EXCL_START */
+	threads_table[thread_idx].state = FAILED;
+
+	posix_print_error_and_exit(PREFIX"Thread [%i] %i ended!?!\n",
+				   threads_table[thread_idx].thead_cnt,
+				   thread_idx);
+	/* LCOV_EXCL_STOP */
+}
+
+/**
+ * Return the first free entry index in the threads table
+ */
+static int ttable_get_empty_slot(void)
+{
+
+	for (int i = 0; i < threads_table_size; i++) {
+		if (threads_table[i].state == NOTUSED) {
+			return i;
+		}
+	}
+
+	/*
+	 * else, we run out table without finding an index
+	 * => we expand the table
+	 */
+
+	threads_table = realloc(threads_table,
+				(threads_table_size + PC_ALLOC_CHUNK_SIZE)
+				* sizeof(struct threads_table_el));
+	if (threads_table == NULL) { /* LCOV_EXCL_BR_LINE */
+		posix_print_error_and_exit(NO_MEM_ERR); /* LCOV_EXCL_LINE */
+	}
+
+	/* Clear new piece of table */
+	memset(&threads_table[threads_table_size],
+		0,
+		PC_ALLOC_CHUNK_SIZE * sizeof(struct threads_table_el));
+
+	threads_table_size += PC_ALLOC_CHUNK_SIZE;
+
+	/* The first newly created entry is good: */
+	return threads_table_size - PC_ALLOC_CHUNK_SIZE;
+}
+
+/**
+ * Called from _new_thread(),
+ * Create a new native context for the new Zephyr thread.
+ * _new_thread() picks from the kernel structures what it is that we need to
+ * call with what parameters
+ */
+void posix_new_thread(posix_thread_status_t *ptr)
+{
+	struct thread_context *ctx;
+	int t_slot;
+
+	ctx = malloc(sizeof(*ctx) + CONFIG_ARCH_POSIX_UCONTEXT_STACK_SIZE);
+	if (ctx == NULL) { /* LCOV_EXCL_BR_LINE */
+		posix_print_error_and_exit(NO_MEM_ERR); /* LCOV_EXCL_LINE */
+	}
+
+	_SAFE_CALL(getcontext(&ctx->context));
+	ctx->context.uc_stack.ss_sp = ctx->stack;
+	ctx->context.uc_stack.ss_size = CONFIG_ARCH_POSIX_UCONTEXT_STACK_SIZE;
+	ctx->context.uc_link = NULL;
+
+	t_slot = ttable_get_empty_slot();
+	threads_table[t_slot].state = USED;
+	threads_table[t_slot].ctx = ctx;
+	threads_table[t_slot].status = ptr;
+	threads_table[t_slot].thead_cnt = thread_create_count++;
+	ptr->thread_idx = t_slot;
+
+	makecontext(&ctx->context, (void (*)(void))posix_thread_starter,
+		    1, t_slot);
+
+	PC_DEBUG("created thread [%i] %i\n",
+		threads_table[t_slot].thead_cnt,
+		ptr->thread_idx);
+}
+
+/**
+ * Called from _IntLibInit()
+ * prepare whatever needs to be prepared to be able to start threads
+ */
+void posix_init_multithreading(void)
+{
+	thread_create_count = 0;
+
+	currently_running_thread = -1;
+	cpu_thread = pthread_self();
+
+	threads_table = calloc(PC_ALLOC_CHUNK_SIZE,
+				sizeof(struct threads_table_el));
+	if (threads_table == NULL) { /* LCOV_EXCL_BR_LINE */
+		posix_print_error_and_exit(NO_MEM_ERR); /* LCOV_EXCL_LINE */
+	}
+
+	threads_table_size = PC_ALLOC_CHUNK_SIZE;
+}
+
+/**
+ * Free any allocated memory by the posix core and clean up.
+ * Note that this function cannot be called from a SW thread
+ * (the CPU is assumed halted. Otherwise we will cancel ourselves)
+ *
+ * The CPU pthread is cancelled while halted. As it may still be unwinding
+ * on the stack of the thread which halted it, that context is not freed.
+ */
+void posix_core_clean_up(void)
+{
+
+	if (!threads_table) { /* LCOV_EXCL_BR_LINE */
+		return; /* LCOV_EXCL_LINE */
+	}
+
+	/* LCOV_EXCL_START */
+	if (pthread_cancel(cpu_thread)) {
+		posix_print_warning(PREFIX"cleanup: could not stop CPU\n");
+	}
+	/* LCOV_EXCL_STOP */
+
+	for (int i = 0; i < threads_table_size; i++) {
+		if (i != currently_running_thread) {
+			free(threads_table[i].ctx);
+		}
+	}
+
+	free_zombie();
+	free(threads_table);
+	threads_table = NULL;
+}
+
+
+void posix_abort_thread(int thread_idx)
+{
+	if (threads_table[thread_idx].state != USED) { /* LCOV_EXCL_BR_LINE */
+		/* The thread may have been already aborted before */
+		return; /* LCOV_EXCL_LINE */
+	}
+
+	PC_DEBUG("Aborting not scheduled thread [%i] %i\n",
+		threads_table[thread_idx].thead_cnt,
+		thread_idx);
+
+	/* The thread is not running, its context can go right away */
+	threads_table[thread_idx].state = ABORTED;
+	free(threads_table[thread_idx].ctx);
+	threads_table[thread_idx].ctx = NULL;
+}
+
+
+#if defined(CONFIG_ARCH_HAS_THREAD_ABORT)
+
+extern void _k_thread_single_abort(struct k_thread *thread);
+
+void _impl_k_thread_abort(k_tid_t thread)
+{
+	unsigned int key;
+	int thread_idx;
+
+	posix_thread_status_t *tstatus =
+					(posix_thread_status_t *)
+					thread->callee_saved.thread_status;
+
+	thread_idx = tstatus->thread_idx;
+
+	key = irq_lock();
+
+	__ASSERT(!(thread->base.user_options & K_ESSENTIAL),
+		 "essential thread aborted");
+
+	_k_thread_single_abort(thread);
+	_thread_monitor_exit(thread);
+
+	if (tstatus->aborted) {
+		PC_DEBUG("%s ignoring re_abort of [%i] %i\n",
+			__func__,
+			threads_table[thread_idx].thead_cnt,
+			thread_idx);
+
+		_reschedule(key);
+		return;
+	}
+
+	tstatus->aborted = 1;
+
+	if (_current == thread) {
+		/* posix_swap() drops this context once switched out of */
+		threads_table[thread_idx].state = ABORTED;
+		PC_DEBUG("Thread [%i] %i: %s Marked myself as aborting\n",
+			threads_table[thread_idx].thead_cnt,
+			thread_idx,
+			__func__);
+
+		_Swap(key);
+		CODE_UNREACHABLE; /* LCOV_EXCL_LINE */
+	}
+
+	posix_abort_thread(thread_idx);
+
+	/* The abort handler might have altered the ready queue. */
+	_reschedule(key);
+}
+#endif
@@ -18,6 +18,10 @@
 #include "posix_core.h"
 #include "irq.h"
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+extern void _thread_runtime_swap(void);
+#endif
+
 /**
  *
  * @brief Initiate a cooperative context switch
@@ -53,6 +57,10 @@ unsigned int __swap(unsigned int key)
 	_sys_k_event_logger_context_switch();
 #endif
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	_thread_runtime_swap();
+#endif
+
 	posix_thread_status_t *ready_thread_ptr =
 		(posix_thread_status_t *)
 		_kernel.ready_q.cache->callee_saved.thread_status;
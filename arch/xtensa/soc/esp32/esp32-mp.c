@@ -5,11 +5,14 @@
  */
 
 /* Include esp-idf headers first to avoid redefining BIT() macro */
+#include <soc/soc.h>
 #include <soc.h>
 
 #include <zephyr.h>
+#include <init.h>
 #include <spinlock.h>
 #include <kernel_structs.h>
+#include <kernel_internal.h>
 
 #define _REG(base, off) (*(volatile u32_t *)((base) + (off)))
 
@@ -22,6 +25,11 @@
 #define DPORT_APPCPU_CTRL_B    _REG(DPORT_BASE, 0x030)
 #define DPORT_APPCPU_CTRL_C    _REG(DPORT_BASE, 0x034)
 
+/* One register per cross-core interrupt source, the interrupt stays
+ * raised until the register is cleared
+ */
+#define DPORT_CPU_INTR_FROM_CPU(n) _REG(DPORT_BASE, 0x0DC + 4 * (n))
+
 /* Two fields with same naming conventions live in two different
  * registers and have different widths...
  */
@@ -91,6 +99,9 @@ static void appcpu_entry2(void)
 	__asm__ volatile("wsr.PS %0" : : "r"(ps));
 
 	ie = 0;
+#ifdef CONFIG_SMP
+	ie |= BIT(CONFIG_ESP32_SCHED_IPI_IRQ);
+#endif
 	__asm__ volatile("wsr.INTENABLE %0" : : "r"(ie));
 	__asm__ volatile("wsr.VECBASE %0" : : "r"(start_rec->vecbase));
 	__asm__ volatile("rsync");
@@ -231,3 +242,52 @@ void _arch_start_cpu(int cpu_num, k_thread_stack_t *stack, int sz,
 
 	smp_log("ESP32: APPCPU initialized");
 }
+
+#ifdef CONFIG_SMP
+/* Each CPU gets its own cross-core interrupt source, routed to the
+ * same line on that CPU only.  The handler just acknowledges it, the
+ * thread which caused it is switched to on interrupt exit.
+ */
+static void sched_ipi_isr(void *arg)
+{
+	ARG_UNUSED(arg);
+
+	DPORT_CPU_INTR_FROM_CPU(_arch_curr_cpu()->id) = 0;
+}
+
+void _arch_sched_ipi(u32_t cpu_mask)
+{
+	int cpu;
+
+	for (cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		if (cpu_mask & BIT(cpu)) {
+			DPORT_CPU_INTR_FROM_CPU(cpu) = 1;
+		}
+	}
+}
+
+/* Runs on the main CPU before the APPCPU is started, which enables
+ * the line for itself in appcpu_entry2()
+ */
+static int esp32_sched_ipi_init(struct device *dev)
+{
+	int cpu;
+
+	ARG_UNUSED(dev);
+
+	IRQ_CONNECT(CONFIG_ESP32_SCHED_IPI_IRQ, 1, sched_ipi_isr, NULL, 0);
+
+	for (cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		DPORT_CPU_INTR_FROM_CPU(cpu) = 0;
+		esp32_rom_intr_matrix_set(cpu, ETS_FROM_CPU_INTR0_SOURCE + cpu,
+					  CONFIG_ESP32_SCHED_IPI_IRQ);
+	}
+
+	irq_enable(CONFIG_ESP32_SCHED_IPI_IRQ);
+
+	return 0;
+}
+
+SYS_INIT(esp32_sched_ipi_init, PRE_KERNEL_1,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif
@@ -9,12 +9,15 @@
  */
 
 #include <errno.h>
+#include <string.h>
 #include <misc/__assert.h>
 #include <misc/util.h>
 #include <device.h>
 #include <init.h>
 #include <soc.h>
 #include <adc.h>
+#include <dma.h>
+#include <cache.h>
 
 #define SYS_LOG_DOMAIN "dev/adc_sam_afec"
 #define SYS_LOG_LEVEL CONFIG_SYS_LOG_ADC_LEVEL
@@ -28,6 +31,13 @@ struct adc_sam_dev_cfg {
 	void (*irq_config)(void);
 	u8_t irq_id;
 	u8_t periph_id;
+#ifdef CONFIG_ADC_STREAM
+	/* Timer Counter whose channel 0 TIOA output triggers conversions */
+	Tc *tc;
+	u8_t tc_periph_id;
+	u8_t dma_channel;
+	u8_t dma_perid;
+#endif
 };
 
 struct channel_samples {
@@ -42,6 +52,16 @@ struct adc_sam_dev_data {
 	u16_t measured_channels;
 	u16_t active_chan_last;
 	struct channel_samples samples[ADC_CHANNELS];
+#ifdef CONFIG_ADC_STREAM
+	struct device *dev_dma;
+	adc_stream_callback_t stream_cb;
+	void *stream_user_data;
+	u16_t *stream_buf;
+	/* samples per half of the ring buffer */
+	u32_t stream_half;
+	/* the half being filled is the second one */
+	bool stream_second;
+#endif
 };
 
 #define CONF_ADC_PRESCALER ((SOC_ATMEL_SAM_MCK_FREQ_HZ / 15000000) - 1)
@@ -147,6 +167,226 @@ static int adc_sam_read(struct device *dev, struct adc_seq_table *seq_tbl)
 	return 0;
 }
 
+#ifdef CONFIG_ADC_STREAM
+static struct device *adc_sam_dev_from_dma_channel(u32_t channel);
+
+/* Set the timer period, choosing the finest clock the 16-bit counter
+ * allows.
+ */
+static int adc_sam_stream_timer(TcChannel *tc_ch, u32_t period_us)
+{
+	static const struct {
+		u32_t clks;
+		u32_t div;
+	} clocks[] = {
+		{ TC_CMR_TCCLKS_TIMER_CLOCK2, 8 },
+		{ TC_CMR_TCCLKS_TIMER_CLOCK3, 32 },
+		{ TC_CMR_TCCLKS_TIMER_CLOCK4, 128 },
+	};
+	u64_t ticks;
+
+	for (int i = 0; i < ARRAY_SIZE(clocks); i++) {
+		ticks = (u64_t)period_us * SOC_ATMEL_SAM_MCK_FREQ_HZ /
+			clocks[i].div / USEC_PER_SEC;
+		if (ticks > 0xFFFF) {
+			continue;
+		}
+
+		if (ticks < 2) {
+			return -EINVAL;
+		}
+
+		/* TIOA rises at RA, which triggers the AFEC, and
+		 * falls at RC, where the counter restarts.
+		 */
+		tc_ch->TC_CCR = TC_CCR_CLKDIS;
+		tc_ch->TC_CMR = clocks[i].clks
+			      | TC_CMR_WAVE
+			      | TC_CMR_WAVSEL_UP_RC
+			      | TC_CMR_ACPA_SET
+			      | TC_CMR_ACPC_CLEAR;
+		tc_ch->TC_RA = ticks / 2;
+		tc_ch->TC_RC = ticks;
+
+		return 0;
+	}
+
+	return -EINVAL;
+}
+
+/* This function is executed in the interrupt context */
+static void adc_sam_dma_callback(struct device *dev_dma, u32_t channel,
+				 int status)
+{
+	struct device *dev = adc_sam_dev_from_dma_channel(channel);
+	struct adc_sam_dev_data *const dev_data = DEV_DATA(dev);
+	adc_stream_callback_t cb = dev_data->stream_cb;
+	void *user_data = dev_data->stream_user_data;
+	u16_t *samples;
+
+	if (!cb) {
+		return;
+	}
+
+	if (status) {
+		SYS_LOG_ERR("DMA error %d", status);
+		adc_stream_stop(dev);
+		cb(dev, ADC_STREAM_ERROR, NULL, 0, user_data);
+		return;
+	}
+
+	samples = dev_data->stream_buf;
+	if (dev_data->stream_second) {
+		samples += dev_data->stream_half;
+	}
+
+	/* Assure cache coherency after DMA write operation */
+	sys_cache_invalidate((vaddr_t)samples,
+			     dev_data->stream_half * sizeof(u16_t));
+
+	dev_data->stream_second = !dev_data->stream_second;
+
+	cb(dev, dev_data->stream_second ? ADC_STREAM_HALF_FULL :
+	   ADC_STREAM_FULL, samples, dev_data->stream_half, user_data);
+}
+
+static int adc_sam_stream_start(struct device *dev,
+				const struct adc_stream_config *cfg)
+{
+	const struct adc_sam_dev_cfg *dev_cfg = DEV_CFG(dev);
+	struct adc_sam_dev_data *const dev_data = DEV_DATA(dev);
+	Afec *const afec = dev_cfg->regs;
+	TcChannel *const tc_ch = &dev_cfg->tc->TC_CHANNEL[0];
+	struct adc_seq_table *seq_tbl = cfg->seq_table;
+	struct dma_block_config blk[2];
+	struct dma_config dma_cfg;
+	u32_t half_len = cfg->buffer_length / 2;
+	u16_t channels = 0;
+	u8_t channel;
+	int ret;
+
+	if (!seq_tbl->num_entries || !cfg->callback) {
+		return -EINVAL;
+	}
+
+	/* The AFEC converts the enabled channels in increasing order, that
+	 * is the order they are stored to the buffer in.
+	 */
+	for (int i = 0; i < seq_tbl->num_entries; i++) {
+		channel = seq_tbl->entries[i].channel_id;
+		if (channel >= ADC_CHANNELS || BIT(channel) <= channels) {
+			SYS_LOG_ERR("Channels not in increasing order");
+			return -EINVAL;
+		}
+
+		channels |= BIT(channel);
+	}
+
+	if (!half_len ||
+	    half_len % (seq_tbl->num_entries * sizeof(u16_t))) {
+		SYS_LOG_ERR("Buffer halves must hold whole frames");
+		return -EINVAL;
+	}
+
+	if (k_sem_take(&dev_data->mutex_thread, K_NO_WAIT)) {
+		return -EBUSY;
+	}
+
+	soc_pmc_peripheral_enable(dev_cfg->tc_periph_id);
+
+	ret = adc_sam_stream_timer(tc_ch, cfg->period_us);
+	if (ret < 0) {
+		SYS_LOG_ERR("Period of %u us out of range", cfg->period_us);
+		goto error;
+	}
+
+	memset(blk, 0, sizeof(blk));
+	blk[0].source_address = (u32_t)&afec->AFEC_LCDR;
+	blk[0].dest_address = (u32_t)cfg->buffer;
+	blk[0].block_size = half_len;
+	blk[0].next_block = &blk[1];
+	blk[1].source_address = (u32_t)&afec->AFEC_LCDR;
+	blk[1].dest_address = (u32_t)cfg->buffer + half_len;
+	blk[1].block_size = half_len;
+
+	memset(&dma_cfg, 0, sizeof(dma_cfg));
+	dma_cfg.dma_slot = dev_cfg->dma_perid;
+	dma_cfg.channel_direction = PERIPHERAL_TO_MEMORY;
+	dma_cfg.complete_callback_en = 1;
+	dma_cfg.error_callback_en = 1;
+	dma_cfg.cyclic = 1;
+	dma_cfg.source_data_size = sizeof(u16_t);
+	dma_cfg.dest_data_size = sizeof(u16_t);
+	dma_cfg.source_burst_length = 1;
+	dma_cfg.dest_burst_length = 1;
+	dma_cfg.block_count = 2;
+	dma_cfg.head_block = blk;
+	dma_cfg.dma_callback = adc_sam_dma_callback;
+
+	ret = dma_config(dev_data->dev_dma, dev_cfg->dma_channel, &dma_cfg);
+	if (ret < 0) {
+		goto error;
+	}
+
+	dev_data->stream_cb = cfg->callback;
+	dev_data->stream_user_data = cfg->user_data;
+	dev_data->stream_buf = cfg->buffer;
+	dev_data->stream_half = half_len / sizeof(u16_t);
+	dev_data->stream_second = false;
+
+	/* Drop a stale conversion result, it would request a transfer */
+	(void)afec->AFEC_LCDR;
+
+	/* No dirty line may be written back over the DMA data later on */
+	sys_cache_invalidate((vaddr_t)cfg->buffer, 2 * half_len);
+
+	ret = dma_start(dev_data->dev_dma, dev_cfg->dma_channel);
+	if (ret < 0) {
+		dev_data->stream_cb = NULL;
+		goto error;
+	}
+
+	afec->AFEC_CHER = channels;
+	afec->AFEC_MR = (afec->AFEC_MR & ~AFEC_MR_TRGSEL_Msk)
+		      | AFEC_MR_TRGEN_EN
+		      | AFEC_MR_TRGSEL_AFEC_TRIG1;
+
+	tc_ch->TC_CCR = TC_CCR_CLKEN | TC_CCR_SWTRG;
+
+	return 0;
+
+error:
+	k_sem_give(&dev_data->mutex_thread);
+
+	return ret;
+}
+
+static int adc_sam_stream_stop(struct device *dev)
+{
+	const struct adc_sam_dev_cfg *dev_cfg = DEV_CFG(dev);
+	struct adc_sam_dev_data *const dev_data = DEV_DATA(dev);
+	Afec *const afec = dev_cfg->regs;
+	unsigned int key;
+
+	key = irq_lock();
+	if (!dev_data->stream_cb) {
+		irq_unlock(key);
+		return 0;
+	}
+	dev_data->stream_cb = NULL;
+	irq_unlock(key);
+
+	dev_cfg->tc->TC_CHANNEL[0].TC_CCR = TC_CCR_CLKDIS;
+	afec->AFEC_MR &= ~AFEC_MR_TRGEN_EN;
+	afec->AFEC_CHDR = BIT_MASK(ADC_CHANNELS);
+	dma_stop(dev_data->dev_dma, dev_cfg->dma_channel);
+
+	k_sem_give(&dev_data->mutex_thread);
+
+	return 0;
+}
+#endif /* CONFIG_ADC_STREAM */
+
 static void adc_sam_configure(struct device *dev)
 {
 	const struct adc_sam_dev_cfg *dev_cfg = DEV_CFG(dev);
@@ -185,6 +425,14 @@ static int adc_sam_initialize(struct device *dev)
 	k_sem_init(&dev_data->sem_meas, 0, 1);
 	k_sem_init(&dev_data->mutex_thread, 1, 1);
 
+#ifdef CONFIG_ADC_STREAM
+	dev_data->dev_dma = device_get_binding(CONFIG_ADC_SAM_AFEC_DMA_NAME);
+	if (!dev_data->dev_dma) {
+		SYS_LOG_ERR("%s device not found", CONFIG_ADC_SAM_AFEC_DMA_NAME);
+		return -ENODEV;
+	}
+#endif
+
 	/* Configure interrupts */
 	dev_cfg->irq_config();
 
@@ -204,6 +452,10 @@ static int adc_sam_initialize(struct device *dev)
 
 static const struct adc_driver_api adc_sam_driver_api = {
 	.read    = adc_sam_read,
+#ifdef CONFIG_ADC_STREAM
+	.stream_start = adc_sam_stream_start,
+	.stream_stop = adc_sam_stream_stop,
+#endif
 };
 
 /* ADC_0 */
@@ -225,6 +477,12 @@ static const struct adc_sam_dev_cfg adc0_sam_config = {
 	.periph_id = ID_AFEC0,
 	.irq_config = adc0_irq_config,
 	.irq_id = AFEC0_IRQn,
+#ifdef CONFIG_ADC_STREAM
+	.tc = TC0,
+	.tc_periph_id = ID_TC0_CHANNEL0,
+	.dma_channel = CONFIG_ADC_0_SAM_AFEC_DMA_CHANNEL,
+	.dma_perid = DMA_PERID_AFEC0_RX,
+#endif
 };
 
 static struct adc_sam_dev_data adc0_sam_data;
@@ -253,6 +511,12 @@ static const struct adc_sam_dev_cfg adc1_sam_config = {
 	.periph_id = ID_AFEC1,
 	.irq_config = adc1_irq_config,
 	.irq_id = AFEC1_IRQn,
+#ifdef CONFIG_ADC_STREAM
+	.tc = TC1,
+	.tc_periph_id = ID_TC1_CHANNEL0,
+	.dma_channel = CONFIG_ADC_1_SAM_AFEC_DMA_CHANNEL,
+	.dma_perid = DMA_PERID_AFEC1_RX,
+#endif
 };
 
 static struct adc_sam_dev_data adc1_sam_data;
@@ -261,3 +525,22 @@ DEVICE_AND_API_INIT(adc1_sam, CONFIG_ADC_1_NAME, &adc_sam_initialize,
 		    &adc1_sam_data, &adc1_sam_config, POST_KERNEL,
 		    CONFIG_ADC_INIT_PRIORITY, &adc_sam_driver_api);
 #endif
+
+#ifdef CONFIG_ADC_STREAM
+static struct device *adc_sam_dev_from_dma_channel(u32_t channel)
+{
+#ifdef CONFIG_ADC_0
+	if (channel == CONFIG_ADC_0_SAM_AFEC_DMA_CHANNEL) {
+		return DEVICE_GET(adc0_sam);
+	}
+#endif
+#ifdef CONFIG_ADC_1
+	if (channel == CONFIG_ADC_1_SAM_AFEC_DMA_CHANNEL) {
+		return DEVICE_GET(adc1_sam);
+	}
+#endif
+	__ASSERT(0, "DMA channel %u not used by an AFEC", channel);
+
+	return NULL;
+}
+#endif
@@ -72,10 +72,59 @@ static struct {
 
 static struct device *h4_dev;
 
+#if defined(CONFIG_BT_H4_ASYNC)
+#define RX_BUF_COUNT CONFIG_BT_H4_ASYNC_RX_BUF_COUNT
+#define RX_BUF_SIZE  CONFIG_BT_H4_ASYNC_RX_BUF_SIZE
+
+/* The UART receives into a ring of buffers which rx_thread parses. */
+static struct {
+	u8_t buf[RX_BUF_COUNT][RX_BUF_SIZE];
+	/* bytes received into each buffer, set from the UART callback */
+	volatile size_t len[RX_BUF_COUNT];
+	/* buffers handed to the UART and not parsed completely yet */
+	atomic_t in_use;
+	/* buffers released by the UART */
+	atomic_t released;
+	/* next buffer to hand to the UART */
+	u8_t next;
+	/* buffer being parsed and parse position in it */
+	u8_t rd;
+	size_t rd_pos;
+	/* data h4_read() takes from */
+	const u8_t *src;
+	size_t src_len;
+	/* reception stopped for lack of free buffers */
+	volatile bool stopped;
+	struct k_sem sem;
+} rxa = {
+	.sem = _K_SEM_INITIALIZER(rxa.sem, 0, UINT_MAX),
+};
+
+static struct {
+	bool data;
+} txa;
+
+static int h4_read(u8_t *buf, int len)
+{
+	int read = min(len, rxa.src_len);
+
+	memcpy(buf, rxa.src, read);
+	rxa.src += read;
+	rxa.src_len -= read;
+
+	return read;
+}
+#else
+static inline int h4_read(u8_t *buf, int len)
+{
+	return uart_fifo_read(h4_dev, buf, len);
+}
+#endif /* CONFIG_BT_H4_ASYNC */
+
 static inline void h4_get_type(void)
 {
 	/* Get packet type */
-	if (uart_fifo_read(h4_dev, &rx.type, 1) != 1) {
+	if (h4_read(&rx.type, 1) != 1) {
 		BT_WARN("Unable to read H:4 packet type");
 		rx.type = H4_NONE;
 		return;
@@ -101,8 +150,7 @@ static inline void get_acl_hdr(void)
 	struct bt_hci_acl_hdr *hdr = &rx.acl;
 	int to_read = sizeof(*hdr) - rx.remaining;
 
-	rx.remaining -= uart_fifo_read(h4_dev, (u8_t *)hdr + to_read,
-				       rx.remaining);
+	rx.remaining -= h4_read((u8_t *)hdr + to_read, rx.remaining);
 	if (!rx.remaining) {
 		rx.remaining = sys_le16_to_cpu(hdr->len);
 		BT_DBG("Got ACL header. Payload %u bytes", rx.remaining);
@@ -115,8 +163,7 @@ static inline void get_evt_hdr(void)
 	struct bt_hci_evt_hdr *hdr = &rx.evt;
 	int to_read = rx.hdr_len - rx.remaining;
 
-	rx.remaining -= uart_fifo_read(h4_dev, (u8_t *)hdr + to_read,
-				       rx.remaining);
+	rx.remaining -= h4_read((u8_t *)hdr + to_read, rx.remaining);
 	if (rx.hdr_len == sizeof(*hdr) && rx.remaining < sizeof(*hdr)) {
 		switch (rx.evt.evt) {
 		case BT_HCI_EVT_LE_META_EVENT:
@@ -176,6 +223,87 @@ static struct net_buf *get_rx(int timeout)
 	}
 }
 
+#if defined(CONFIG_BT_H4_ASYNC)
+static void process_rx(void);
+
+/* Hand the next buffer of the ring to the UART, if it has been parsed */
+static u8_t *rx_buf_next(void)
+{
+	u8_t idx = rxa.next;
+
+	if (atomic_test_and_set_bit(&rxa.in_use, idx)) {
+		return NULL;
+	}
+
+	rxa.len[idx] = 0;
+	atomic_clear_bit(&rxa.released, idx);
+	rxa.next = (idx + 1) % RX_BUF_COUNT;
+
+	return rxa.buf[idx];
+}
+
+/* Parse the received data, in the order the buffers were filled */
+static void rx_process_bufs(void)
+{
+	bool released;
+	size_t end;
+	u8_t *buf;
+	u8_t idx;
+
+	while (1) {
+		idx = rxa.rd;
+		if (!atomic_test_bit(&rxa.in_use, idx)) {
+			break;
+		}
+
+		/* The length is final once the buffer is released. */
+		released = atomic_test_bit(&rxa.released, idx);
+		end = rxa.len[idx];
+
+		if (rxa.rd_pos < end) {
+			rxa.src = &rxa.buf[idx][rxa.rd_pos];
+			rxa.src_len = end - rxa.rd_pos;
+			while (rxa.src_len) {
+				process_rx();
+			}
+			rxa.rd_pos = end;
+			continue;
+		}
+
+		if (!released) {
+			break;
+		}
+
+		rxa.rd_pos = 0;
+		rxa.rd = (idx + 1) % RX_BUF_COUNT;
+		atomic_clear_bit(&rxa.in_use, idx);
+	}
+
+	if (rxa.stopped) {
+		buf = rx_buf_next();
+		if (buf) {
+			BT_DBG("Restarting reception");
+			rxa.stopped = false;
+			uart_rx_enable(h4_dev, buf, RX_BUF_SIZE,
+				       CONFIG_BT_H4_ASYNC_RX_TIMEOUT);
+		}
+	}
+}
+
+static void rx_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	BT_DBG("started");
+
+	while (1) {
+		k_sem_take(&rxa.sem, K_FOREVER);
+		rx_process_bufs();
+	}
+}
+#else
 static void rx_thread(void *p1, void *p2, void *p3)
 {
 	struct net_buf *buf;
@@ -226,11 +354,23 @@ static void rx_thread(void *p1, void *p2, void *p3)
 		} while (buf);
 	}
 }
+#endif /* CONFIG_BT_H4_ASYNC */
 
 static size_t h4_discard(struct device *uart, size_t len)
 {
 	u8_t buf[33];
 
+#if defined(CONFIG_BT_H4_ASYNC)
+	/* The data is in the ring already, skip it without copying */
+	if (rxa.src_len) {
+		len = min(len, rxa.src_len);
+		rxa.src += len;
+		rxa.src_len -= len;
+
+		return len;
+	}
+#endif
+
 	return uart_fifo_read(uart, buf, min(len, sizeof(buf)));
 }
 
@@ -250,9 +390,16 @@ static inline void read_payload(void)
 				return;
 			}
 
+#if defined(CONFIG_BT_H4_ASYNC)
+			/* Parsing runs in rx_thread, wait for a buffer while
+			 * the UART goes on receiving.
+			 */
+			rx.buf = get_rx(K_FOREVER);
+#else
 			BT_WARN("Failed to allocate, deferring to rx_thread");
 			uart_irq_rx_disable(h4_dev);
 			return;
+#endif
 		}
 
 		BT_DBG("Allocated rx.buf %p", rx.buf);
@@ -267,7 +414,7 @@ static inline void read_payload(void)
 		copy_hdr(rx.buf);
 	}
 
-	read = uart_fifo_read(h4_dev, net_buf_tail(rx.buf), rx.remaining);
+	read = h4_read(net_buf_tail(rx.buf), rx.remaining);
 	net_buf_add(rx.buf, read);
 	rx.remaining -= read;
 
@@ -295,6 +442,10 @@ static inline void read_payload(void)
 	if (prio) {
 		BT_DBG("Calling bt_recv_prio(%p)", buf);
 		bt_recv_prio(buf);
+	} else if (IS_ENABLED(CONFIG_BT_H4_ASYNC)) {
+		/* already in rx_thread */
+		BT_DBG("Calling bt_recv(%p)", buf);
+		bt_recv(buf);
 	} else {
 		BT_DBG("Putting buf %p to rx fifo", buf);
 		net_buf_put(&rx.fifo, buf);
@@ -329,6 +480,7 @@ static inline void read_header(void)
 	}
 }
 
+#if !defined(CONFIG_BT_H4_ASYNC)
 static inline void process_tx(void)
 {
 	int bytes;
@@ -378,6 +530,7 @@ done:
 		uart_irq_tx_disable(h4_dev);
 	}
 }
+#endif /* !CONFIG_BT_H4_ASYNC */
 
 static inline void process_rx(void)
 {
@@ -397,6 +550,7 @@ static inline void process_rx(void)
 	}
 }
 
+#if !defined(CONFIG_BT_H4_ASYNC)
 static void bt_uart_isr(struct device *unused)
 {
 	ARG_UNUSED(unused);
@@ -411,13 +565,102 @@ static void bt_uart_isr(struct device *unused)
 		}
 	}
 }
+#else
+/* Send the type of the next buffer, then its data, called locked */
+static void tx_next(void)
+{
+	if (tx.buf && !txa.data) {
+		txa.data = true;
+		if (!uart_tx(h4_dev, tx.buf->data, tx.buf->len, K_FOREVER)) {
+			return;
+		}
+	}
+
+	while (1) {
+		if (tx.buf) {
+			net_buf_unref(tx.buf);
+		}
+
+		tx.buf = net_buf_get(&tx.fifo, K_NO_WAIT);
+		if (!tx.buf) {
+			return;
+		}
+
+		switch (bt_buf_get_type(tx.buf)) {
+		case BT_BUF_ACL_OUT:
+			tx.type = H4_ACL;
+			break;
+		case BT_BUF_CMD:
+			tx.type = H4_CMD;
+			break;
+		default:
+			BT_ERR("Unknown buffer type");
+			continue;
+		}
+
+		txa.data = false;
+		if (!uart_tx(h4_dev, &tx.type, 1, K_FOREVER)) {
+			return;
+		}
+
+		BT_ERR("Unable to send H:4 type");
+	}
+}
+
+static void h4_uart_cb(struct uart_event *evt, void *user_data)
+{
+	u8_t *buf;
+	int idx;
+
+	switch (evt->type) {
+	case UART_TX_DONE:
+	case UART_TX_ABORTED:
+		tx_next();
+		break;
+	case UART_RX_RDY:
+		idx = (evt->data.rx.buf - rxa.buf[0]) / RX_BUF_SIZE;
+		rxa.len[idx] = evt->data.rx.offset + evt->data.rx.len;
+		k_sem_give(&rxa.sem);
+		break;
+	case UART_RX_BUF_REQUEST:
+		buf = rx_buf_next();
+		if (buf) {
+			uart_rx_buf_rsp(h4_dev, buf, RX_BUF_SIZE);
+		}
+		break;
+	case UART_RX_BUF_RELEASED:
+		idx = (evt->data.rx_buf.buf - rxa.buf[0]) / RX_BUF_SIZE;
+		atomic_set_bit(&rxa.released, idx);
+		k_sem_give(&rxa.sem);
+		break;
+	case UART_RX_STOPPED:
+		BT_ERR("UART error 0x%02x", evt->data.rx_stop.reason);
+		break;
+	case UART_RX_DISABLED:
+		rxa.stopped = true;
+		k_sem_give(&rxa.sem);
+		break;
+	}
+}
+#endif /* CONFIG_BT_H4_ASYNC */
 
 static int h4_send(struct net_buf *buf)
 {
 	BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf), buf->len);
 
 	net_buf_put(&tx.fifo, buf);
+
+#if defined(CONFIG_BT_H4_ASYNC)
+	unsigned int key = irq_lock();
+
+	if (!tx.buf) {
+		tx_next();
+	}
+
+	irq_unlock(key);
+#else
 	uart_irq_tx_enable(h4_dev);
+#endif
 
 	return 0;
 }
@@ -437,7 +680,16 @@ static int h4_open(void)
 	h4_discard(h4_dev, 32);
 #endif
 
+#if defined(CONFIG_BT_H4_ASYNC)
+	if (uart_callback_set(h4_dev, h4_uart_cb, NULL) ||
+	    uart_rx_enable(h4_dev, rx_buf_next(), RX_BUF_SIZE,
+			   CONFIG_BT_H4_ASYNC_RX_TIMEOUT)) {
+		BT_ERR("UART has no asynchronous API");
+		return -EIO;
+	}
+#else
 	uart_irq_callback_set(h4_dev, bt_uart_isr);
+#endif
 
 	k_thread_create(&rx_thread_data, rx_thread_stack,
 			K_THREAD_STACK_SIZEOF(rx_thread_stack),
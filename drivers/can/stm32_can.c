@@ -6,6 +6,7 @@
 
 #include <clock_control/stm32_clock_control.h>
 #include <clock_control.h>
+#include <can/can_stm32.h>
 #include <misc/util.h>
 #include <string.h>
 #include <kernel.h>
@@ -98,6 +99,14 @@ static void can_stm32_isr(void *arg)
 		k_sem_give(&data->tx_int_sem);
 	}
 
+	/* Releasing a message clears the flag, so check it first */
+	if (can->RF0R & CAN_RF0R_FOVR0) {
+		data->rx_overrun++;
+		can->RF0R = CAN_RF0R_FOVR0;
+		SYS_LOG_DBG("RX FIFO overrun (%u)", data->rx_overrun);
+	}
+
+	/* Drain all pending messages in one go */
 	while (can->RF0R & CAN_RF0R_FMP0) {
 		CAN_FIFOMailBox_TypeDef *mbox;
 		int filter_match_index;
@@ -107,8 +116,11 @@ static void can_stm32_isr(void *arg)
 		filter_match_index = ((mbox->RDTR & CAN_RDT0R_FMI)
 					   >> CAN_RDT0R_FMI_Pos);
 
+		/* A message which can't be dispatched must still be
+		 * released, or it blocks the FIFO.
+		 */
 		if (filter_match_index >= CONFIG_CAN_MAX_FILTER) {
-			break;
+			goto release;
 		}
 
 		SYS_LOG_DBG("Message on filter index %d", filter_match_index);
@@ -119,7 +131,9 @@ static void can_stm32_isr(void *arg)
 				struct k_msgq *msg_q =
 					data->rx_response[filter_match_index];
 
-				k_msgq_put(msg_q, &msg, K_NO_WAIT);
+				if (k_msgq_put(msg_q, &msg, K_NO_WAIT)) {
+					data->rx_dropped++;
+				}
 			} else {
 				can_rx_callback_t callback =
 					data->rx_response[filter_match_index];
@@ -127,6 +141,7 @@ static void can_stm32_isr(void *arg)
 			}
 		}
 
+release:
 		/* Release message */
 		can->RF0R |= CAN_RF0R_RFOM0;
 	}
@@ -779,6 +794,15 @@ void can_stm32_detach(struct device *dev, int filter_nr)
 	k_mutex_unlock(&data->set_filter_mutex);
 }
 
+void can_stm32_get_rx_lost(struct device *dev, u32_t *overrun,
+			   u32_t *dropped)
+{
+	struct can_stm32_data *data = DEV_DATA(dev);
+
+	*overrun = data->rx_overrun;
+	*dropped = data->rx_dropped;
+}
+
 static const struct can_driver_api can_api_funcs = {
 	.configure = can_stm32_runtime_configure,
 	.send = can_stm32_send,
@@ -62,6 +62,10 @@ struct can_stm32_data {
 	u64_t filter_usage;
 	u64_t response_type;
 	void *rx_response[CONFIG_CAN_MAX_FILTER];
+	/* messages lost as the hardware FIFO overran */
+	u32_t rx_overrun;
+	/* messages lost as the message queue of their filter was full */
+	u32_t rx_dropped;
 };
 
 struct can_stm32_config {
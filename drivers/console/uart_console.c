@@ -10,7 +10,8 @@
  *
  *
  * Serial console driver.
- * Hooks into the printk and fputc (for printf) modules. Poll driven.
+ * Hooks into the printk and fputc (for printf) modules. Poll driven, the
+ * output can be interrupt driven with CONFIG_UART_CONSOLE_ASYNC_TX.
  */
 
 #include <kernel.h>
@@ -81,6 +82,79 @@ static int console_in(void)
 }
 #endif
 
+#ifdef CONFIG_UART_CONSOLE_ASYNC_TX
+static u8_t tx_buf[CONFIG_UART_CONSOLE_TX_BUF_SIZE];
+/* oldest character of the buffer and number of characters buffered */
+static u16_t tx_head, tx_len;
+/* set once the UART interrupts are handled by the console */
+static bool tx_irq_ready;
+
+/* Send the oldest buffered character, called with interrupts locked */
+static void tx_send_one(void)
+{
+	uart_poll_out(uart_console_dev, tx_buf[tx_head]);
+	tx_head = (tx_head + 1) % sizeof(tx_buf);
+	tx_len--;
+}
+
+static void tx_put(u8_t c)
+{
+	unsigned int key = irq_lock();
+
+	if (!tx_irq_ready || k_is_in_isr()) {
+		/* keep the output in order */
+		while (tx_len) {
+			tx_send_one();
+		}
+
+		uart_poll_out(uart_console_dev, c);
+		irq_unlock(key);
+		return;
+	}
+
+	/* make room by waiting for the oldest character to be sent */
+	if (tx_len == sizeof(tx_buf)) {
+		tx_send_one();
+	}
+
+	tx_buf[(tx_head + tx_len) % sizeof(tx_buf)] = c;
+	tx_len++;
+
+	uart_irq_tx_enable(uart_console_dev);
+
+	irq_unlock(key);
+}
+
+/* Refill the transmit FIFO from the buffer, from the UART interrupt */
+static void tx_isr(void)
+{
+	unsigned int key = irq_lock();
+	int len;
+
+	if (!tx_len) {
+		uart_irq_tx_disable(uart_console_dev);
+		irq_unlock(key);
+		return;
+	}
+
+	/* the contiguous part of the buffered output */
+	len = sizeof(tx_buf) - tx_head;
+	if (len > tx_len) {
+		len = tx_len;
+	}
+
+	len = uart_fifo_fill(uart_console_dev, &tx_buf[tx_head], len);
+	tx_head = (tx_head + len) % sizeof(tx_buf);
+	tx_len -= len;
+
+	irq_unlock(key);
+}
+
+#define console_putc(c) tx_put(c)
+#else
+#define console_putc(c) uart_poll_out(uart_console_dev, c)
+#endif /* CONFIG_UART_CONSOLE_ASYNC_TX */
+
 #if defined(CONFIG_PRINTK) || defined(CONFIG_STDOUT_CONSOLE)
 /**
  *
@@ -106,9 +180,9 @@ static int console_out(int c)
 #endif  /* CONFIG_UART_CONSOLE_DEBUG_SERVER_HOOKS */
 
 	if ('\n' == c) {
-		uart_poll_out(uart_console_dev, '\r');
+		console_putc('\r');
 	}
-	uart_poll_out(uart_console_dev, c);
+	console_putc(c);
 
 	return c;
 }
@@ -461,6 +535,12 @@ void uart_console_isr(struct device *unused)
 		u8_t byte;
 		int rx;
 
+#ifdef CONFIG_UART_CONSOLE_ASYNC_TX
+		if (uart_irq_tx_ready(uart_console_dev)) {
+			tx_isr();
+		}
+#endif
+
 		if (!uart_irq_rx_ready(uart_console_dev)) {
 			continue;
 		}
@@ -528,8 +608,8 @@ void uart_console_isr(struct device *unused)
 				break;
 			case '\r':
 				cmd->line[cur + end] = '\0';
-				uart_poll_out(uart_console_dev, '\r');
-				uart_poll_out(uart_console_dev, '\n');
+				console_putc('\r');
+				console_putc('\n');
 				cur = 0;
 				end = 0;
 				k_fifo_put(lines_queue, cmd);
@@ -563,6 +643,10 @@ static void console_input_init(void)
 
 	uart_irq_callback_set(uart_console_dev, uart_console_isr);
 
+#ifdef CONFIG_UART_CONSOLE_ASYNC_TX
+	tx_irq_ready = true;
+#endif
+
 	/* Drain the fifo */
 	while (uart_irq_rx_ready(uart_console_dev)) {
 		uart_fifo_read(uart_console_dev, &c, 1);
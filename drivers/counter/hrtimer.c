@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * High resolution timers, kept in a queue ordered by expiry time. The
+ * alarm of the counter device is always set, either for the first timer
+ * or, at the latest, half a counter period ahead so that the wrap
+ * arounds of the counter are all seen.
+ */
+
+#include <kernel.h>
+#include <init.h>
+#include <errno.h>
+#include <counter.h>
+#include <hrtimer.h>
+
+#define SYS_LOG_DOMAIN "hrtimer"
+#define SYS_LOG_LEVEL SYS_LOG_LEVEL_ERROR
+#include <logging/sys_log.h>
+
+#define MAX_DELTA 0x80000000
+
+static struct device *counter_dev;
+static sys_dlist_t hrtimer_queue = SYS_DLIST_STATIC_INIT(&hrtimer_queue);
+
+/* upper word and last value of the counter */
+static u32_t counter_high;
+static u32_t counter_last;
+
+/* Must be called with interrupts locked */
+static u64_t now_locked(void)
+{
+	u32_t now = counter_read(counter_dev);
+
+	if (now < counter_last) {
+		counter_high++;
+	}
+
+	counter_last = now;
+
+	return ((u64_t)counter_high << 32) | now;
+}
+
+/* a timer which is not queued has no next node */
+static inline bool is_queued(struct hrtimer *timer)
+{
+	return timer->node.next != NULL;
+}
+
+static inline void dequeue(struct hrtimer *timer)
+{
+	sys_dlist_remove(&timer->node);
+	timer->node.next = NULL;
+}
+
+static void hrtimer_alarm(struct device *dev, void *user_data);
+
+/* Must be called with interrupts locked */
+static int hrtimer_program(void)
+{
+	struct hrtimer *first;
+	u64_t delta = MAX_DELTA;
+	u64_t now = now_locked();
+
+	first = SYS_DLIST_PEEK_HEAD_CONTAINER(&hrtimer_queue, first, node);
+	if (first) {
+		if (first->expiry <= now) {
+			delta = 1;
+		} else if (first->expiry - now < MAX_DELTA) {
+			delta = first->expiry - now;
+		}
+	}
+
+	return counter_set_alarm(counter_dev, hrtimer_alarm, (u32_t)delta,
+				 NULL);
+}
+
+static void hrtimer_alarm(struct device *dev, void *user_data)
+{
+	struct hrtimer *timer;
+	unsigned int key;
+
+	key = irq_lock();
+
+	while ((timer = SYS_DLIST_PEEK_HEAD_CONTAINER(&hrtimer_queue, timer,
+						      node)) &&
+	       timer->expiry <= now_locked()) {
+		dequeue(timer);
+
+		/* the handler may start timers again */
+		irq_unlock(key);
+		timer->handler(timer);
+		key = irq_lock();
+	}
+
+	if (hrtimer_program()) {
+		SYS_LOG_ERR("Unable to set the counter alarm");
+	}
+
+	irq_unlock(key);
+}
+
+void hrtimer_init(struct hrtimer *timer, hrtimer_handler_t handler)
+{
+	timer->node.next = NULL;
+	timer->handler = handler;
+}
+
+u64_t hrtimer_now(void)
+{
+	unsigned int key;
+	u64_t now;
+
+	key = irq_lock();
+	now = now_locked();
+	irq_unlock(key);
+
+	return now;
+}
+
+int hrtimer_start_at(struct hrtimer *timer, u64_t ticks)
+{
+	struct hrtimer *next;
+	unsigned int key;
+	int err = 0;
+
+	key = irq_lock();
+
+	if (is_queued(timer)) {
+		dequeue(timer);
+	}
+
+	timer->expiry = ticks;
+
+	/* timers with the same expiry run in the order they were started */
+	SYS_DLIST_FOR_EACH_CONTAINER(&hrtimer_queue, next, node) {
+		if (next->expiry > ticks) {
+			sys_dlist_insert_before(&hrtimer_queue, &next->node,
+						&timer->node);
+			break;
+		}
+	}
+
+	if (!is_queued(timer)) {
+		sys_dlist_append(&hrtimer_queue, &timer->node);
+	}
+
+	if (sys_dlist_is_head(&hrtimer_queue, &timer->node)) {
+		err = hrtimer_program();
+	}
+
+	irq_unlock(key);
+
+	return err;
+}
+
+int hrtimer_start_us(struct hrtimer *timer, u32_t us)
+{
+	u64_t ticks = (u64_t)us * CONFIG_HRTIMER_COUNTER_FREQ / USEC_PER_SEC;
+
+	return hrtimer_start_at(timer, hrtimer_now() + ticks);
+}
+
+void hrtimer_stop(struct hrtimer *timer)
+{
+	unsigned int key;
+
+	key = irq_lock();
+
+	/* an alarm set for the timer only causes a spurious interrupt */
+	if (is_queued(timer)) {
+		dequeue(timer);
+	}
+
+	irq_unlock(key);
+}
+
+static int hrtimer_sys_init(struct device *dev)
+{
+	unsigned int key;
+	int err;
+
+	ARG_UNUSED(dev);
+
+	counter_dev = device_get_binding(CONFIG_HRTIMER_COUNTER_NAME);
+	if (!counter_dev) {
+		SYS_LOG_ERR("Counter device %s not found",
+			    CONFIG_HRTIMER_COUNTER_NAME);
+		return -ENODEV;
+	}
+
+	err = counter_start(counter_dev);
+	if (err) {
+		return err;
+	}
+
+	key = irq_lock();
+	err = hrtimer_program();
+	irq_unlock(key);
+
+	return err;
+}
+
+SYS_INIT(hrtimer_sys_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE);
@@ -15,6 +15,7 @@
 #include <init.h>
 #include <errno.h>
 #include <crypto/cipher.h>
+#include <crypto/hash.h>
 
 #if !defined(CONFIG_MBEDTLS_CFG_FILE)
 #include "mbedtls/config.h"
@@ -24,12 +25,17 @@
 
 #include <mbedtls/ccm.h>
 #include <mbedtls/aes.h>
+#include <mbedtls/md.h>
 
 #define MTLS_SUPPORT (CAP_RAW_KEY | CAP_SEPARATE_IO_BUFS | CAP_SYNC_OPS)
 
 struct mtls_shim_session {
-	mbedtls_ccm_context mtls;
+	union {
+		mbedtls_ccm_context mtls;
+		mbedtls_md_context_t md;
+	};
 	bool in_use;
+	bool hmac;
 };
 
 #define CRYPTO_MAX_SESSION CONFIG_CRYPTO_MBEDTLS_SHIM_MAX_SESSION
@@ -182,6 +188,131 @@ static int mtls_session_free(struct device *dev, struct cipher_ctx *ctx)
 	return 0;
 }
 
+static int mtls_hash_restart(struct mtls_shim_session *session)
+{
+	if (session->hmac) {
+		return mbedtls_md_hmac_reset(&session->md);
+	}
+
+	return mbedtls_md_starts(&session->md);
+}
+
+static int mtls_hash(struct hash_ctx *ctx, struct hash_pkt *pkt, bool finish)
+{
+	struct mtls_shim_session *session = ctx->drv_sessn_state;
+	int ret;
+
+	if (session->hmac) {
+		ret = mbedtls_md_hmac_update(&session->md, pkt->in_buf,
+					     pkt->in_len);
+	} else {
+		ret = mbedtls_md_update(&session->md, pkt->in_buf,
+					pkt->in_len);
+	}
+
+	if (ret || !finish) {
+		goto out;
+	}
+
+	if (session->hmac) {
+		ret = mbedtls_md_hmac_finish(&session->md, pkt->out_buf);
+	} else {
+		ret = mbedtls_md_finish(&session->md, pkt->out_buf);
+	}
+
+	if (!ret) {
+		ret = mtls_hash_restart(session);
+	}
+
+out:
+	if (ret) {
+		SYS_LOG_ERR("Could not hash (%d)", ret);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int mtls_hash_session_setup(struct device *dev, struct hash_ctx *ctx,
+				   enum hash_algo algo)
+{
+	const mbedtls_md_info_t *info;
+	struct mtls_shim_session *session;
+	int ctx_idx;
+	int ret;
+
+	if (ctx->flags & ~(MTLS_SUPPORT)) {
+		SYS_LOG_ERR("Unsupported flag");
+		return -EINVAL;
+	}
+
+	switch (algo) {
+	case CRYPTO_HASH_ALGO_SHA224:
+		info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA224);
+		break;
+	case CRYPTO_HASH_ALGO_SHA256:
+		info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+		break;
+	default:
+		info = NULL;
+		break;
+	}
+
+	if (!info) {
+		SYS_LOG_ERR("Unsupported algo");
+		return -EINVAL;
+	}
+
+	ctx_idx = mtls_get_unused_session_index();
+	if (ctx_idx < 0) {
+		SYS_LOG_ERR("No free session for now");
+		return -ENOSPC;
+	}
+
+	session = &mtls_sessions[ctx_idx];
+	session->hmac = ctx->key != NULL;
+
+	mbedtls_md_init(&session->md);
+
+	ret = mbedtls_md_setup(&session->md, info, session->hmac);
+	if (ret) {
+		goto error;
+	}
+
+	if (session->hmac) {
+		ret = mbedtls_md_hmac_starts(&session->md, ctx->key,
+					     ctx->keylen);
+	} else {
+		ret = mbedtls_md_starts(&session->md);
+	}
+
+	if (ret) {
+		goto error;
+	}
+
+	ctx->drv_sessn_state = session;
+	ctx->hash_hndlr = mtls_hash;
+
+	return 0;
+
+error:
+	SYS_LOG_ERR("Could not setup the hash (%d)", ret);
+	mbedtls_md_free(&session->md);
+	session->in_use = false;
+
+	return -EINVAL;
+}
+
+static int mtls_hash_session_free(struct device *dev, struct hash_ctx *ctx)
+{
+	struct mtls_shim_session *session = ctx->drv_sessn_state;
+
+	mbedtls_md_free(&session->md);
+	session->in_use = false;
+
+	return 0;
+}
+
 static int mtls_query_caps(struct device *dev)
 {
 	return MTLS_SUPPORT;
@@ -197,6 +328,8 @@ static struct crypto_driver_api mtls_crypto_funcs = {
 	.free_session = mtls_session_free,
 	.crypto_async_callback_set = NULL,
 	.query_hw_caps = mtls_query_caps,
+	.hash_begin_session = mtls_hash_session_setup,
+	.hash_free_session = mtls_hash_session_free,
 };
 
 DEVICE_AND_API_INIT(crypto_mtls, CONFIG_CRYPTO_MBEDTLS_SHIM_DRV_NAME,
@@ -0,0 +1,403 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file Driver for the AES engine of the STM32 CRYP peripheral.
+ */
+
+#define SYS_LOG_LEVEL CONFIG_SYS_LOG_CRYPTO_LEVEL
+#include <logging/sys_log.h>
+
+#include <kernel.h>
+#include <device.h>
+#include <init.h>
+#include <errno.h>
+#include <string.h>
+#include <soc.h>
+#include <clock_control.h>
+#include <clock_control/stm32_clock_control.h>
+#include <crypto/cipher.h>
+
+#define CRYP_SUPPORT (CAP_RAW_KEY | CAP_SEPARATE_IO_BUFS | CAP_SYNC_OPS | \
+		      CAP_ASYNC_OPS)
+
+#define CRYP_BLOCK_SIZE 16
+
+/* timeout of a synchronous operation, in milliseconds */
+#define CRYP_TIMEOUT 1000
+
+#define CRYPTO_MAX_SESSION CONFIG_CRYPTO_STM32_MAX_SESSION
+
+struct crypto_stm32_session {
+	u8_t key[32];
+	u32_t key_size;
+	u8_t iv[CRYP_BLOCK_SIZE];
+	bool encrypt;
+	bool in_use;
+};
+
+struct crypto_stm32_data {
+	CRYP_HandleTypeDef hcryp;
+	/* the peripheral holds the key of a single session at a time */
+	struct k_sem device_sem;
+	crypto_completion_cb callback;
+	/* asynchronous operation in progress */
+	struct cipher_pkt *pkt;
+};
+
+static struct crypto_stm32_session crypto_stm32_sessions[CRYPTO_MAX_SESSION];
+
+#define DEV_DATA(dev) ((struct crypto_stm32_data *)(dev)->driver_data)
+
+DEVICE_DECLARE(crypto_stm32);
+
+/* Load the key and IV of the session, then start the operation */
+static int crypto_stm32_run(struct cipher_ctx *ctx, struct cipher_pkt *pkt,
+			    const u8_t *in, u8_t *out, const u8_t *iv)
+{
+	struct crypto_stm32_data *data = DEV_DATA(ctx->device);
+	struct crypto_stm32_session *session = ctx->drv_sessn_state;
+	CRYP_HandleTypeDef *hcryp = &data->hcryp;
+	enum cipher_mode mode = ctx->ops.cipher_mode;
+	bool async = ctx->flags & CAP_ASYNC_OPS;
+	u8_t *src = (u8_t *)in;
+	u16_t size = pkt->in_len;
+	HAL_StatusTypeDef status;
+
+	if (pkt->in_len < 0 || pkt->in_len > UINT16_MAX ||
+	    (mode != CRYPTO_CIPHER_MODE_CTR && size % CRYP_BLOCK_SIZE)) {
+		SYS_LOG_ERR("Unsupported length %d", pkt->in_len);
+		return -EINVAL;
+	}
+
+	if (k_sem_take(&data->device_sem, async ? K_NO_WAIT : K_FOREVER)) {
+		return -EBUSY;
+	}
+
+	if (iv) {
+		memcpy(session->iv, iv, CRYP_BLOCK_SIZE);
+	}
+
+	hcryp->Init.KeySize = session->key_size;
+	hcryp->Init.pKey = session->key;
+	hcryp->Init.pInitVect = session->iv;
+	HAL_CRYP_Init(hcryp);
+
+	if (async) {
+		data->pkt = pkt;
+
+		switch (mode) {
+		case CRYPTO_CIPHER_MODE_ECB:
+			status = session->encrypt ?
+				HAL_CRYP_AESECB_Encrypt_IT(hcryp, src, size,
+							   out) :
+				HAL_CRYP_AESECB_Decrypt_IT(hcryp, src, size,
+							   out);
+			break;
+		case CRYPTO_CIPHER_MODE_CBC:
+			status = session->encrypt ?
+				HAL_CRYP_AESCBC_Encrypt_IT(hcryp, src, size,
+							   out) :
+				HAL_CRYP_AESCBC_Decrypt_IT(hcryp, src, size,
+							   out);
+			break;
+		default:
+			status = session->encrypt ?
+				HAL_CRYP_AESCTR_Encrypt_IT(hcryp, src, size,
+							   out) :
+				HAL_CRYP_AESCTR_Decrypt_IT(hcryp, src, size,
+							   out);
+			break;
+		}
+
+		if (status != HAL_OK) {
+			data->pkt = NULL;
+			k_sem_give(&data->device_sem);
+			return -EIO;
+		}
+
+		/* the semaphore is released on completion */
+		return 0;
+	}
+
+	switch (mode) {
+	case CRYPTO_CIPHER_MODE_ECB:
+		status = session->encrypt ?
+			HAL_CRYP_AESECB_Encrypt(hcryp, src, size, out,
+						CRYP_TIMEOUT) :
+			HAL_CRYP_AESECB_Decrypt(hcryp, src, size, out,
+						CRYP_TIMEOUT);
+		break;
+	case CRYPTO_CIPHER_MODE_CBC:
+		status = session->encrypt ?
+			HAL_CRYP_AESCBC_Encrypt(hcryp, src, size, out,
+						CRYP_TIMEOUT) :
+			HAL_CRYP_AESCBC_Decrypt(hcryp, src, size, out,
+						CRYP_TIMEOUT);
+		break;
+	default:
+		status = session->encrypt ?
+			HAL_CRYP_AESCTR_Encrypt(hcryp, src, size, out,
+						CRYP_TIMEOUT) :
+			HAL_CRYP_AESCTR_Decrypt(hcryp, src, size, out,
+						CRYP_TIMEOUT);
+		break;
+	}
+
+	k_sem_give(&data->device_sem);
+
+	if (status != HAL_OK) {
+		SYS_LOG_ERR("CRYP error %d", status);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static int crypto_stm32_ecb_op(struct cipher_ctx *ctx, struct cipher_pkt *pkt)
+{
+	if (pkt->out_buf_max < pkt->in_len) {
+		return -EINVAL;
+	}
+
+	pkt->out_len = pkt->in_len;
+
+	return crypto_stm32_run(ctx, pkt, pkt->in_buf, pkt->out_buf, NULL);
+}
+
+/* Same buffer layout as the TinyCrypt shim: the IV is placed before the
+ * cipher text on encryption, and expected there on decryption.
+ */
+static int crypto_stm32_cbc_op(struct cipher_ctx *ctx, struct cipher_pkt *pkt,
+			       u8_t *iv)
+{
+	struct crypto_stm32_session *session = ctx->drv_sessn_state;
+
+	if (session->encrypt) {
+		if (pkt->out_buf_max < pkt->in_len + CRYP_BLOCK_SIZE) {
+			return -EINVAL;
+		}
+
+		memcpy(pkt->out_buf, iv, CRYP_BLOCK_SIZE);
+		pkt->out_len = pkt->in_len + CRYP_BLOCK_SIZE;
+
+		return crypto_stm32_run(ctx, pkt, pkt->in_buf,
+					pkt->out_buf + CRYP_BLOCK_SIZE, iv);
+	}
+
+	if (iv != pkt->in_buf) {
+		SYS_LOG_ERR("IV and cipher text must be contiguous");
+		return -EINVAL;
+	}
+
+	if (pkt->out_buf_max < pkt->in_len) {
+		return -EINVAL;
+	}
+
+	pkt->out_len = pkt->in_len;
+
+	return crypto_stm32_run(ctx, pkt, pkt->in_buf + CRYP_BLOCK_SIZE,
+				pkt->out_buf, iv);
+}
+
+static int crypto_stm32_ctr_op(struct cipher_ctx *ctx, struct cipher_pkt *pkt,
+			       u8_t *iv)
+{
+	/* the counter part of the split counter starts at 0 */
+	u8_t ctr[CRYP_BLOCK_SIZE] = { 0 };
+	int ivlen = ctx->keylen - (ctx->mode_params.ctr_info.ctr_len >> 3);
+
+	if (pkt->out_buf_max < pkt->in_len) {
+		return -EINVAL;
+	}
+
+	memcpy(ctr, iv, ivlen);
+	pkt->out_len = pkt->in_len;
+
+	return crypto_stm32_run(ctx, pkt, pkt->in_buf, pkt->out_buf, ctr);
+}
+
+static void crypto_stm32_complete(CRYP_HandleTypeDef *hcryp, int status)
+{
+	struct crypto_stm32_data *data =
+		CONTAINER_OF(hcryp, struct crypto_stm32_data, hcryp);
+	struct cipher_pkt *pkt = data->pkt;
+
+	data->pkt = NULL;
+	k_sem_give(&data->device_sem);
+
+	if (pkt && data->callback) {
+		data->callback(pkt, status);
+	}
+}
+
+void HAL_CRYP_OutCpltCallback(CRYP_HandleTypeDef *hcryp)
+{
+	crypto_stm32_complete(hcryp, 0);
+}
+
+void HAL_CRYP_ErrorCallback(CRYP_HandleTypeDef *hcryp)
+{
+	crypto_stm32_complete(hcryp, -EIO);
+}
+
+static void crypto_stm32_isr(void *arg)
+{
+	struct device *dev = arg;
+
+	HAL_CRYP_IRQHandler(&DEV_DATA(dev)->hcryp);
+}
+
+static int crypto_stm32_get_unused_session_index(void)
+{
+	unsigned int key = irq_lock();
+	int i;
+
+	for (i = 0; i < CRYPTO_MAX_SESSION; i++) {
+		if (!crypto_stm32_sessions[i].in_use) {
+			crypto_stm32_sessions[i].in_use = true;
+			irq_unlock(key);
+			return i;
+		}
+	}
+
+	irq_unlock(key);
+
+	return -1;
+}
+
+static int crypto_stm32_session_setup(struct device *dev,
+				      struct cipher_ctx *ctx,
+				      enum cipher_algo algo,
+				      enum cipher_mode mode,
+				      enum cipher_op op_type)
+{
+	struct crypto_stm32_session *session;
+	int ctx_idx;
+
+	if (ctx->flags & ~(CRYP_SUPPORT)) {
+		SYS_LOG_ERR("Unsupported flag");
+		return -EINVAL;
+	}
+
+	if (algo != CRYPTO_CIPHER_ALGO_AES) {
+		SYS_LOG_ERR("Unsupported algo");
+		return -EINVAL;
+	}
+
+	switch (mode) {
+	case CRYPTO_CIPHER_MODE_ECB:
+		ctx->ops.block_crypt_hndlr = crypto_stm32_ecb_op;
+		break;
+	case CRYPTO_CIPHER_MODE_CBC:
+		ctx->ops.cbc_crypt_hndlr = crypto_stm32_cbc_op;
+		break;
+	case CRYPTO_CIPHER_MODE_CTR:
+		if (ctx->mode_params.ctr_info.ctr_len != 32) {
+			SYS_LOG_ERR("Only 32 bit counters are supported");
+			return -EINVAL;
+		}
+		ctx->ops.ctr_crypt_hndlr = crypto_stm32_ctr_op;
+		break;
+	default:
+		SYS_LOG_ERR("Unsupported mode");
+		return -EINVAL;
+	}
+
+	ctx_idx = crypto_stm32_get_unused_session_index();
+	if (ctx_idx < 0) {
+		SYS_LOG_ERR("No free session for now");
+		return -ENOSPC;
+	}
+
+	session = &crypto_stm32_sessions[ctx_idx];
+
+	switch (ctx->keylen) {
+	case 16:
+		session->key_size = CRYP_KEYSIZE_128B;
+		break;
+	case 24:
+		session->key_size = CRYP_KEYSIZE_192B;
+		break;
+	case 32:
+		session->key_size = CRYP_KEYSIZE_256B;
+		break;
+	default:
+		SYS_LOG_ERR("%u key size is not supported", ctx->keylen);
+		session->in_use = false;
+		return -EINVAL;
+	}
+
+	memcpy(session->key, ctx->key.bit_stream, ctx->keylen);
+	session->encrypt = op_type == CRYPTO_CIPHER_OP_ENCRYPT;
+
+	ctx->drv_sessn_state = session;
+
+	return 0;
+}
+
+static int crypto_stm32_session_free(struct device *dev,
+				     struct cipher_ctx *ctx)
+{
+	struct crypto_stm32_session *session = ctx->drv_sessn_state;
+
+	memset(session->key, 0, sizeof(session->key));
+	session->in_use = false;
+
+	return 0;
+}
+
+static int crypto_stm32_callback_set(struct device *dev,
+				     crypto_completion_cb cb)
+{
+	DEV_DATA(dev)->callback = cb;
+
+	return 0;
+}
+
+static int crypto_stm32_query_caps(struct device *dev)
+{
+	return CRYP_SUPPORT;
+}
+
+static int crypto_stm32_init(struct device *dev)
+{
+	struct crypto_stm32_data *data = DEV_DATA(dev);
+	struct device *clock = device_get_binding(STM32_CLOCK_CONTROL_NAME);
+	struct stm32_pclken pclken = {
+		.bus = STM32_CLOCK_BUS_AHB2,
+		.enr = LL_AHB2_GRP1_PERIPH_CRYP,
+	};
+
+	__ASSERT_NO_MSG(clock != NULL);
+
+	clock_control_on(clock, (clock_control_subsys_t *)&pclken);
+
+	k_sem_init(&data->device_sem, 1, 1);
+
+	data->hcryp.Instance = CRYP;
+	data->hcryp.Init.DataType = CRYP_DATATYPE_8B;
+
+	IRQ_CONNECT(CRYP_IRQn, CONFIG_CRYPTO_STM32_IRQ_PRI, crypto_stm32_isr,
+		    DEVICE_GET(crypto_stm32), 0);
+	irq_enable(CRYP_IRQn);
+
+	return 0;
+}
+
+static struct crypto_driver_api crypto_stm32_funcs = {
+	.begin_session = crypto_stm32_session_setup,
+	.free_session = crypto_stm32_session_free,
+	.crypto_async_callback_set = crypto_stm32_callback_set,
+	.query_hw_caps = crypto_stm32_query_caps,
+};
+
+static struct crypto_stm32_data crypto_stm32_dev_data;
+
+DEVICE_AND_API_INIT(crypto_stm32, CONFIG_CRYPTO_STM32_DRV_NAME,
+		    &crypto_stm32_init, &crypto_stm32_dev_data, NULL,
+		    POST_KERNEL, CONFIG_CRYPTO_INIT_PRIORITY,
+		    (void *)&crypto_stm32_funcs);
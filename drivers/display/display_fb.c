@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <display.h>
+#include <string.h>
+#include <misc/util.h>
+
+void display_fb_init(struct display_fb *fb, struct device *dev,
+		     void *buf0, void *buf1)
+{
+	struct display_capabilities caps;
+
+	display_get_capabilities(dev, &caps);
+
+	fb->dev = dev;
+	fb->buf[0] = buf0;
+	fb->buf[1] = buf1;
+	fb->draw = 0;
+	fb->bytes_per_pixel = caps.bytes_per_pixel;
+	fb->width = caps.x_resolution;
+	fb->height = caps.y_resolution;
+	fb->dirty_y0 = 0;
+	fb->dirty_y1 = fb->height;
+}
+
+void display_fb_mark_dirty(struct display_fb *fb, u16_t x, u16_t y,
+			   u16_t w, u16_t h)
+{
+	u16_t y1 = min(y + h, fb->height);
+
+	if (y >= y1) {
+		return;
+	}
+
+	fb->dirty_y0 = min(fb->dirty_y0, y);
+	fb->dirty_y1 = max(fb->dirty_y1, y1);
+}
+
+int display_fb_flush(struct display_fb *fb)
+{
+	struct display_buffer_descriptor desc;
+	size_t line = fb->width * fb->bytes_per_pixel;
+	size_t offset = fb->dirty_y0 * line;
+	u8_t *shown;
+	int ret;
+
+	/* The other buffer may still be read by the previous transfer */
+	ret = display_sync(fb->dev, K_FOREVER);
+	if (ret) {
+		return ret;
+	}
+
+	if (fb->dirty_y0 >= fb->dirty_y1) {
+		return 0;
+	}
+
+	desc.width = fb->width;
+	desc.pitch = fb->width;
+	desc.height = fb->dirty_y1 - fb->dirty_y0;
+
+	shown = fb->buf[fb->draw];
+	ret = display_write_async(fb->dev, 0, fb->dirty_y0, &desc,
+				  shown + offset);
+	if (ret) {
+		return ret;
+	}
+
+	/* Bring the other buffer up to date while the lines are sent */
+	fb->draw ^= 1;
+	memcpy(fb->buf[fb->draw] + offset, shown + offset, desc.height * line);
+
+	fb->dirty_y0 = fb->height;
+	fb->dirty_y1 = 0;
+
+	return 0;
+}
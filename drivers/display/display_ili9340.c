@@ -10,6 +10,7 @@
 #define SYS_LOG_LEVEL CONFIG_SYS_LOG_ILI9340_LEVEL
 #include <logging/sys_log.h>
 
+#include <display.h>
 #include <gpio.h>
 #include <misc/byteorder.h>
 #include <spi.h>
@@ -22,6 +23,12 @@ struct ili9340_data {
 #ifdef CONFIG_ILI9340_GPIO_CS
 	struct spi_cs_control cs_ctrl;
 #endif
+#ifdef CONFIG_SPI_ASYNC
+	struct spi_buf async_buf;
+	struct spi_buf_set async_bufs;
+	struct k_poll_signal async_signal;
+	bool async_pending;
+#endif
 };
 
 #define ILI9340_CMD_DATA_PIN_COMMAND 0
@@ -92,15 +99,135 @@ int ili9340_init(struct device *dev)
 	SYS_LOG_DBG("Exiting sleep mode");
 	ili9340_exit_sleep(data);
 
-	/* device_get_binding checks if driver_api is not zero before checking
-	 * device name.
-	 * So just set driver_api to 1 else the function call will fail
-	 */
-	dev->driver_api = (void *)1;
+#ifdef CONFIG_SPI_ASYNC
+	k_poll_signal_init(&data->async_signal);
+	data->async_bufs.buffers = &data->async_buf;
+	data->async_bufs.count = 1;
+	data->async_pending = false;
+#endif
+
+	return 0;
+}
+
+/* Wait for the end of an asynchronous write, any other transfer would
+ * switch the command/data line under it.
+ */
+static int ili9340_sync(struct device *dev, s32_t timeout)
+{
+#ifdef CONFIG_SPI_ASYNC
+	struct ili9340_data *data = (struct ili9340_data *)dev->driver_data;
+	struct k_poll_event evt =
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SIGNAL,
+					 K_POLL_MODE_NOTIFY_ONLY,
+					 &data->async_signal);
+
+	if (!data->async_pending) {
+		return 0;
+	}
+
+	if (k_poll(&evt, 1, timeout)) {
+		return -EAGAIN;
+	}
+
+	data->async_pending = false;
+	k_poll_signal_reset(&data->async_signal);
+
+	if (data->async_signal.result) {
+		SYS_LOG_ERR("Write failed %d", data->async_signal.result);
+		return -EIO;
+	}
+#endif
+	return 0;
+}
+
+static int ili9340_write(struct device *dev, u16_t x, u16_t y,
+			 const struct display_buffer_descriptor *desc,
+			 const void *buf)
+{
+	struct ili9340_data *data = (struct ili9340_data *)dev->driver_data;
+	size_t len = ILI9340_BYTES_PER_PIXEL * desc->width;
+	const u8_t *line = buf;
+	u8_t cmd = ILI9340_CMD_MEM_WRITE;
+
+	ili9340_sync(dev, K_FOREVER);
+
+	SYS_LOG_DBG("Writing %dx%d (w,h) bitmap @ %dx%d (x,y)",
+		    desc->width, desc->height, x, y);
+	ili9340_set_mem_area(data, x, y, desc->width, desc->height);
+
+	if (desc->pitch == desc->width) {
+		ili9340_transmit(data, cmd, (void *)buf, len * desc->height);
+		return 0;
+	}
+
+	/* One line at a time, each one continuing the memory write */
+	for (u16_t i = 0; i < desc->height; i++) {
+		ili9340_transmit(data, cmd, (void *)line, len);
+		line += ILI9340_BYTES_PER_PIXEL * desc->pitch;
+		cmd = ILI9340_CMD_MEM_WRITE_CONTINUE;
+	}
 
 	return 0;
 }
 
+#ifdef CONFIG_SPI_ASYNC
+static int ili9340_write_async(struct device *dev, u16_t x, u16_t y,
+			       const struct display_buffer_descriptor *desc,
+			       const void *buf)
+{
+	struct ili9340_data *data = (struct ili9340_data *)dev->driver_data;
+	int ret;
+
+	if (desc->pitch != desc->width) {
+		return -EINVAL;
+	}
+
+	ili9340_sync(dev, K_FOREVER);
+
+	SYS_LOG_DBG("Starting %dx%d (w,h) bitmap @ %dx%d (x,y)",
+		    desc->width, desc->height, x, y);
+	ili9340_set_mem_area(data, x, y, desc->width, desc->height);
+	ili9340_transmit(data, ILI9340_CMD_MEM_WRITE, NULL, 0);
+
+	data->async_buf.buf = (void *)buf;
+	data->async_buf.len =
+		ILI9340_BYTES_PER_PIXEL * desc->width * desc->height;
+
+	gpio_pin_write(data->command_data_gpio, CONFIG_ILI9340_CMD_DATA_PIN,
+		       ILI9340_CMD_DATA_PIN_DATA);
+	ret = spi_write_async(data->spi_dev, &data->spi_config,
+			      &data->async_bufs, &data->async_signal);
+	if (ret) {
+		return ret;
+	}
+
+	data->async_pending = true;
+
+	return 0;
+}
+#endif
+
+static int ili9340_blanking(struct device *dev, bool blank)
+{
+	struct ili9340_data *data = (struct ili9340_data *)dev->driver_data;
+
+	ili9340_sync(dev, K_FOREVER);
+
+	SYS_LOG_DBG("Turning display %s", blank ? "off" : "on");
+	ili9340_transmit(data, blank ? ILI9340_CMD_DISPLAY_OFF :
+			 ILI9340_CMD_DISPLAY_ON, NULL, 0);
+
+	return 0;
+}
+
+static void ili9340_get_capabilities(struct device *dev,
+				     struct display_capabilities *caps)
+{
+	caps->x_resolution = ILI9340_X_RES;
+	caps->y_resolution = ILI9340_Y_RES;
+	caps->bytes_per_pixel = ILI9340_BYTES_PER_PIXEL;
+}
+
 void ili9340_write_pixel(const struct device *dev, const u16_t x, const u16_t y,
 			 const u8_t r, const u8_t g, const u8_t b)
 {
@@ -114,28 +241,23 @@ void ili9340_write_bitmap(const struct device *dev, const u16_t x,
 			  const u16_t y, const u16_t w, const u16_t h,
 			  const u8_t *rgb_data)
 {
-	struct ili9340_data *data = (struct ili9340_data *)dev->driver_data;
+	const struct display_buffer_descriptor desc = {
+		.width = w,
+		.height = h,
+		.pitch = w,
+	};
 
-	SYS_LOG_DBG("Writing %dx%d (w,h) bitmap @ %dx%d (x,y)", w, h, x, y);
-	ili9340_set_mem_area(data, x, y, w, h);
-	ili9340_transmit(data, ILI9340_CMD_MEM_WRITE, (void *)rgb_data,
-			 3 * w * h);
+	ili9340_write((struct device *)dev, x, y, &desc, rgb_data);
 }
 
 void ili9340_display_on(struct device *dev)
 {
-	struct ili9340_data *data = (struct ili9340_data *)dev->driver_data;
-
-	SYS_LOG_DBG("Turning display on");
-	ili9340_transmit(data, ILI9340_CMD_DISPLAY_ON, NULL, 0);
+	ili9340_blanking(dev, false);
 }
 
 void ili9340_display_off(struct device *dev)
 {
-	struct ili9340_data *data = (struct ili9340_data *)dev->driver_data;
-
-	SYS_LOG_DBG("Turning display off");
-	ili9340_transmit(data, ILI9340_CMD_DISPLAY_OFF, NULL, 0);
+	ili9340_blanking(dev, true);
 }
 
 void ili9340_transmit(struct ili9340_data *data, u8_t cmd, void *tx_data,
@@ -178,7 +300,18 @@ void ili9340_set_mem_area(struct ili9340_data *data, const u16_t x,
 	ili9340_transmit(data, ILI9340_CMD_PAGE_ADDR, &spi_data[0], 4);
 }
 
+static const struct display_driver_api ili9340_api = {
+	.write = ili9340_write,
+#ifdef CONFIG_SPI_ASYNC
+	.write_async = ili9340_write_async,
+#endif
+	.sync = ili9340_sync,
+	.blanking = ili9340_blanking,
+	.get_capabilities = ili9340_get_capabilities,
+};
+
 static struct ili9340_data ili9340_data;
 
-DEVICE_INIT(ili9340, CONFIG_ILI9340_DEV_NAME, &ili9340_init, &ili9340_data,
-	    NULL, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+DEVICE_AND_API_INIT(ili9340, CONFIG_ILI9340_DEV_NAME, &ili9340_init,
+		    &ili9340_data, NULL, APPLICATION,
+		    CONFIG_APPLICATION_INIT_PRIORITY, &ili9340_api);
@@ -17,6 +17,7 @@
 #define ILI9340_CMD_MEM_WRITE 0x2c
 #define ILI9340_CMD_MEM_ACCESS_CTRL 0x36
 #define ILI9340_CMD_PIXEL_FORMAT_SET 0x3A
+#define ILI9340_CMD_MEM_WRITE_CONTINUE 0x3C
 #define ILI9340_CMD_FRAME_CTRL_NORMAL_MODE 0xB1
 #define ILI9340_CMD_DISPLAY_FUNCTION_CTRL 0xB6
 #define ILI9340_CMD_POWER_CTRL_1 0xC0
@@ -38,6 +39,13 @@
 #define ILI9340_DATA_PIXEL_FORMAT_MCU_18_BIT 0x06
 #define ILI9340_DATA_PIXEL_FORMAT_MCU_16_BIT 0x05
 
+/* Landscape orientation and 18 bit pixels sent as 3 bytes, as set by the
+ * LCD specific initialization.
+ */
+#define ILI9340_X_RES 320
+#define ILI9340_Y_RES 240
+#define ILI9340_BYTES_PER_PIXEL 3
+
 struct ili9340_data;
 
 /**
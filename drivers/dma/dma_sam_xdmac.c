@@ -27,6 +27,11 @@
 /* DMA channel configuration */
 struct sam_xdmac_channel_cfg {
 	dma_callback callback;
+	u8_t data_size;
+	bool cyclic;
+	/* linked list of a multi block or cyclic transfer */
+	struct sam_xdmac_linked_list_desc_view1
+		desc[CONFIG_DMA_SAM_XDMAC_MAX_BLOCKS];
 };
 
 /* Device constant configuration parameters */
@@ -154,8 +159,6 @@ int sam_xdmac_transfer_configure(struct device *dev, u32_t channel,
 
 		/* Set length of data in the microblock */
 		xdmac->XDMAC_CHID[channel].XDMAC_CUBC = param->ublen;
-		/* Set block length: block length is (blen+1) microblocks */
-		xdmac->XDMAC_CHID[channel].XDMAC_CBC = param->blen;
 	} else {
 		/*
 		 * Linked List is enabled, configure additional transfer
@@ -166,16 +169,62 @@ int sam_xdmac_transfer_configure(struct device *dev, u32_t channel,
 		xdmac->XDMAC_CHID[channel].XDMAC_CNDA = param->nda;
 	}
 
+	/* Set block length: block length is (blen+1) microblocks, descriptor
+	 * views 0 to 2 use it as well.
+	 */
+	xdmac->XDMAC_CHID[channel].XDMAC_CBC = param->blen;
+
 	/* Set next descriptor configuration */
 	xdmac->XDMAC_CHID[channel].XDMAC_CNDC = param->ndc;
 
 	return 0;
 }
 
+/* Describe the blocks of a transfer in the channel's linked list */
+static int sam_xdmac_build_list(struct sam_xdmac_channel_cfg *ch,
+				struct dma_config *cfg)
+{
+	struct sam_xdmac_linked_list_desc_view1 *desc = ch->desc;
+	struct dma_block_config *block = cfg->head_block;
+	u32_t ublen;
+	u32_t i;
+
+	for (i = 0; i < cfg->block_count; i++, block = block->next_block) {
+		if (!block) {
+			SYS_LOG_ERR("Only %u blocks chained", i);
+			return -EINVAL;
+		}
+
+		ublen = block->block_size >> ch->data_size;
+		if (ublen > XDMAC_CUBC_UBLEN_Msk) {
+			SYS_LOG_ERR("Block %u too large", i);
+			return -EINVAL;
+		}
+
+		desc[i].mbr_nda = (u32_t)&desc[i + 1];
+		desc[i].mbr_ubc = ublen
+			| XDMA_UBC_NDE_FETCH_EN
+			| XDMA_UBC_NSEN_UPDATED
+			| XDMA_UBC_NDEN_UPDATED
+			| XDMA_UBC_NVIEW_NDV1;
+		desc[i].mbr_sa = block->source_address;
+		desc[i].mbr_da = block->dest_address;
+	}
+
+	if (cfg->cyclic) {
+		desc[i - 1].mbr_nda = (u32_t)desc;
+	} else {
+		desc[i - 1].mbr_ubc &= ~XDMA_UBC_NDE;
+	}
+
+	return 0;
+}
+
 static int sam_xdmac_config(struct device *dev, u32_t channel,
 			    struct dma_config *cfg)
 {
 	struct sam_xdmac_dev_data *const dev_data = DEV_DATA(dev);
+	struct sam_xdmac_channel_cfg *ch;
 	struct sam_xdmac_channel_config channel_cfg;
 	struct sam_xdmac_transfer_config transfer_cfg;
 	u32_t burst_size;
@@ -195,12 +244,17 @@ static int sam_xdmac_config(struct device *dev, u32_t channel,
 		return -EINVAL;
 	}
 
-	if (cfg->block_count != 1) {
-		SYS_LOG_ERR("Only single block transfer is currently supported."
-			    " Please submit a patch.");
+	if (cfg->block_count < 1 ||
+	    cfg->block_count > CONFIG_DMA_SAM_XDMAC_MAX_BLOCKS) {
+		SYS_LOG_ERR("Invalid 'block_count' value");
 		return -EINVAL;
 	}
 
+	if (cfg->half_complete_callback_en) {
+		SYS_LOG_ERR("Half complete callback is not supported");
+		return -ENOTSUP;
+	}
+
 	burst_size = find_msb_set(cfg->source_burst_length) - 1;
 	SYS_LOG_DBG("burst_size=%d", burst_size);
 	data_size = find_msb_set(cfg->source_data_size) - 1;
@@ -245,7 +299,8 @@ static int sam_xdmac_config(struct device *dev, u32_t channel,
 	channel_cfg.sus = 0;
 	channel_cfg.dus = 0;
 	channel_cfg.cie =
-		  (cfg->complete_callback_en ? XDMAC_CIE_BIE : XDMAC_CIE_LIE)
+		  (cfg->complete_callback_en || cfg->cyclic ?
+		   XDMAC_CIE_BIE : XDMAC_CIE_LIE)
 		| (cfg->error_callback_en ? XDMAC_INT_ERR : 0);
 
 	ret = sam_xdmac_channel_configure(dev, channel, &channel_cfg);
@@ -253,18 +308,81 @@ static int sam_xdmac_config(struct device *dev, u32_t channel,
 		return ret;
 	}
 
-	dev_data->dma_channels[channel].callback = cfg->dma_callback;
+	ch = &dev_data->dma_channels[channel];
+	ch->callback = cfg->dma_callback;
+	ch->data_size = data_size;
+	ch->cyclic = cfg->cyclic;
 
 	memset(&transfer_cfg, 0, sizeof(transfer_cfg));
 	transfer_cfg.sa = cfg->head_block->source_address;
 	transfer_cfg.da = cfg->head_block->dest_address;
 	transfer_cfg.ublen = cfg->head_block->block_size >> data_size;
 
+	if (cfg->block_count > 1 || cfg->cyclic) {
+		ret = sam_xdmac_build_list(ch, cfg);
+		if (ret < 0) {
+			return ret;
+		}
+
+		transfer_cfg.nda = (u32_t)ch->desc;
+		transfer_cfg.ndc =
+			  XDMAC_CNDC_NDE_DSCR_FETCH_EN
+			| XDMAC_CNDC_NDSUP_SRC_PARAMS_UPDATED
+			| XDMAC_CNDC_NDDUP_DST_PARAMS_UPDATED
+			| XDMAC_CNDC_NDVIEW_NDV1;
+	}
+
 	ret = sam_xdmac_transfer_configure(dev, channel, &transfer_cfg);
 
 	return ret;
 }
 
+static int sam_xdmac_reload(struct device *dev, u32_t channel,
+			    u32_t src, u32_t dst, size_t size)
+{
+	struct sam_xdmac_dev_data *const dev_data = DEV_DATA(dev);
+	Xdmac *const xdmac = DEV_CFG(dev)->regs;
+	struct sam_xdmac_channel_cfg *ch;
+	struct sam_xdmac_linked_list_desc_view1 *desc;
+	u32_t ublen;
+
+	if (channel >= DMA_CHANNELS_NO) {
+		return -EINVAL;
+	}
+
+	ch = &dev_data->dma_channels[channel];
+	ublen = size >> ch->data_size;
+	if (ublen > XDMAC_CUBC_UBLEN_Msk) {
+		return -EINVAL;
+	}
+
+	if (!(xdmac->XDMAC_GS & (XDMAC_GS_ST0 << channel))) {
+		/* Stopped: the next start transfers this single block */
+		xdmac->XDMAC_CHID[channel].XDMAC_CSA = src;
+		xdmac->XDMAC_CHID[channel].XDMAC_CDA = dst;
+		xdmac->XDMAC_CHID[channel].XDMAC_CUBC = ublen;
+		xdmac->XDMAC_CHID[channel].XDMAC_CBC = 0;
+		xdmac->XDMAC_CHID[channel].XDMAC_CNDC =
+			XDMAC_CNDC_NDE_DSCR_FETCH_DIS;
+		return 0;
+	}
+
+	/*
+	 * Running cyclic list: the descriptor to be fetched next is the one
+	 * of the block just completed, replace it.
+	 */
+	desc = (struct sam_xdmac_linked_list_desc_view1 *)
+		(xdmac->XDMAC_CHID[channel].XDMAC_CNDA & XDMAC_CNDA_NDA_Msk);
+	if (!ch->cyclic || (desc->mbr_ubc & XDMAC_CUBC_UBLEN_Msk) != ublen) {
+		return -EBUSY;
+	}
+
+	desc->mbr_sa = src;
+	desc->mbr_da = dst;
+
+	return 0;
+}
+
 int sam_xdmac_transfer_start(struct device *dev, u32_t channel)
 {
 	Xdmac *const xdmac = DEV_CFG(dev)->regs;
@@ -339,6 +457,7 @@ static const struct dma_driver_api sam_xdmac_driver_api = {
 	.config = sam_xdmac_config,
 	.start = sam_xdmac_transfer_start,
 	.stop = sam_xdmac_transfer_stop,
+	.reload = sam_xdmac_reload,
 };
 
 /* DMA0 */
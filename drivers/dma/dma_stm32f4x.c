@@ -51,6 +51,14 @@ struct dma_stm32_stream {
 	struct device *dev;
 	struct dma_stm32_stream_reg regs;
 	bool busy;
+	/* callback at the end of each block, not only of the transfer */
+	bool block_callback;
+
+	/* block chain, the next block is loaded when a block completes */
+	struct dma_block_config *head_block;
+	struct dma_block_config *next_block;
+	u32_t block_count;
+	u32_t next_idx;
 
 	void (*dma_callback)(struct device *dev, u32_t id,
 			     int error_code);
@@ -110,6 +118,8 @@ struct dma_stm32_config {
 #define   DMA_STM32_TEI		BIT(3) /* Transfer error interrupt	      */
 #define   DMA_STM32_HTI		BIT(4) /* Transfer half complete interrupt    */
 #define   DMA_STM32_TCI		BIT(5) /* Transfer complete interrupt	      */
+#define   DMA_STM32_IRQ_FLAGS	(DMA_STM32_FEI | DMA_STM32_DMEI | \
+				 DMA_STM32_TEI | DMA_STM32_HTI | DMA_STM32_TCI)
 
 /* DMA Stream x Configuration Register */
 #define DMA_STM32_SCR(x)		(0x10 + 0x18 * (x))
@@ -146,6 +156,7 @@ struct dma_stm32_config {
 					| DMA_STM32_SCR_PINCOS \
 					| DMA_STM32_SCR_PL_MASK)
 #define   DMA_STM32_SCR_IRQ_MASK	(DMA_STM32_SCR_TCIE \
+					| DMA_STM32_SCR_HTIE \
 					| DMA_STM32_SCR_TEIE \
 					| DMA_STM32_SCR_DMEIE)
 
@@ -217,7 +228,9 @@ static u32_t dma_stm32_irq_status(struct dma_stm32_device *ddata,
 		irqs = dma_stm32_read(ddata, DMA_STM32_LISR);
 	}
 
-	return (irqs >> (((id & 2) << 3) | ((id & 1) * 6)));
+	irqs >>= ((id & 2) << 3) | ((id & 1) * 6);
+
+	return irqs & DMA_STM32_IRQ_FLAGS;
 }
 
 static void dma_stm32_irq_clear(struct dma_stm32_device *ddata,
@@ -232,6 +245,82 @@ static void dma_stm32_irq_clear(struct dma_stm32_device *ddata,
 	}
 }
 
+static u32_t dma_stm32_mem_addr(struct dma_stm32_stream *stream,
+				struct dma_block_config *block)
+{
+	if (stream->direction == MEMORY_TO_PERIPHERAL) {
+		return block->source_address;
+	}
+
+	return block->dest_address;
+}
+
+static void dma_stm32_block_regs(struct dma_stm32_stream *stream,
+				 u32_t src, u32_t dst, u32_t size)
+{
+	struct dma_stm32_stream_reg *regs = &stream->regs;
+
+	if (stream->direction == MEMORY_TO_PERIPHERAL) {
+		regs->sm0ar = src;
+		regs->spar = dst;
+	} else {
+		regs->spar = src;
+		regs->sm0ar = dst;
+	}
+
+	regs->sndtr = size;
+}
+
+static void dma_stm32_advance(struct dma_stm32_stream *stream)
+{
+	if (++stream->next_idx < stream->block_count) {
+		stream->next_block = stream->next_block->next_block;
+	} else if (stream->regs.scr & DMA_STM32_SCR_DBM) {
+		/* cyclic, start over */
+		stream->next_idx = 0;
+		stream->next_block = stream->head_block;
+	} else {
+		stream->next_block = NULL;
+	}
+}
+
+/* Software chaining: the stream has stopped, go on with the next block */
+static void dma_stm32_chain_next(struct dma_stm32_device *ddata, u32_t id)
+{
+	struct dma_stm32_stream *stream = &ddata->stream[id];
+	struct dma_stm32_stream_reg *regs = &stream->regs;
+	struct dma_block_config *block = stream->next_block;
+
+	dma_stm32_block_regs(stream, block->source_address,
+			     block->dest_address, block->block_size);
+	dma_stm32_advance(stream);
+
+	dma_stm32_write(ddata, DMA_STM32_SPAR(id),  regs->spar);
+	dma_stm32_write(ddata, DMA_STM32_SM0AR(id), regs->sm0ar);
+	dma_stm32_write(ddata, DMA_STM32_SNDTR(id), regs->sndtr);
+	dma_stm32_write(ddata, DMA_STM32_SCR(id),
+			regs->scr | DMA_STM32_SCR_EN);
+}
+
+/*
+ * Double buffer mode: the stream has switched to the other memory address,
+ * load the next block of the chain into the one just completed.
+ */
+static void dma_stm32_load_idle(struct dma_stm32_device *ddata, u32_t id,
+				u32_t config)
+{
+	struct dma_stm32_stream *stream = &ddata->stream[id];
+	u32_t addr = dma_stm32_mem_addr(stream, stream->next_block);
+
+	if (config & DMA_STM32_SCR_CT) {
+		dma_stm32_write(ddata, DMA_STM32_SM0AR(id), addr);
+	} else {
+		dma_stm32_write(ddata, DMA_STM32_SM1AR(id), addr);
+	}
+
+	dma_stm32_advance(stream);
+}
+
 static void dma_stm32_irq_handler(void *arg, u32_t id)
 {
 	struct device *dev = arg;
@@ -243,19 +332,40 @@ static void dma_stm32_irq_handler(void *arg, u32_t id)
 	config = dma_stm32_read(ddata, DMA_STM32_SCR(id));
 	sfcr = dma_stm32_read(ddata, DMA_STM32_SFCR(id));
 
-	/* Silently ignore spurious transfer half complete IRQ */
 	if (irqstatus & DMA_STM32_HTI) {
 		dma_stm32_irq_clear(ddata, id, DMA_STM32_HTI);
-		return;
-	}
+		irqstatus &= ~DMA_STM32_HTI;
 
-	stream->busy = false;
+		/* Silently ignore spurious transfer half complete IRQ */
+		if (config & DMA_STM32_SCR_HTIE) {
+			stream->dma_callback(stream->dev, id,
+					     DMA_STATUS_HALF_COMPLETE);
+		}
+
+		if (!irqstatus) {
+			return;
+		}
+	}
 
 	if ((irqstatus & DMA_STM32_TCI) && (config & DMA_STM32_SCR_TCIE)) {
 		dma_stm32_irq_clear(ddata, id, DMA_STM32_TCI);
 
-		stream->dma_callback(stream->dev, id, 0);
+		if (config & DMA_STM32_SCR_DBM) {
+			dma_stm32_load_idle(ddata, id, config);
+		} else if (config & DMA_STM32_SCR_CIRC) {
+			/* Keeps going over the same block */
+		} else if (stream->next_block) {
+			dma_stm32_chain_next(ddata, id);
+		} else {
+			stream->busy = false;
+		}
+
+		if (!stream->busy || stream->block_callback) {
+			stream->dma_callback(stream->dev, id, 0);
+		}
 	} else {
+		stream->busy = false;
+
 		SYS_LOG_ERR("Internal error: IRQ status: 0x%x\n", irqstatus);
 		dma_stm32_irq_clear(ddata, id, irqstatus);
 
@@ -320,7 +430,8 @@ static int dma_stm32_config_devcpy(struct device *dev, u32_t id,
 			DMA_STM32_SCR_MSIZE(dst_bus_width) |
 			DMA_STM32_SCR_PBURST(src_burst_size) |
 			DMA_STM32_SCR_MBURST(dst_burst_size) |
-			DMA_STM32_SCR_REQ(ddata->channel_rx);
+			DMA_STM32_SCR_REQ(ddata->channel_rx) |
+			DMA_STM32_SCR_MINC;
 		break;
 	default:
 		SYS_LOG_ERR("DMA error: Direction not supported: %d",
@@ -360,12 +471,51 @@ static int dma_stm32_config_memcpy(struct device *dev, u32_t id)
 	return 0;
 }
 
+static int dma_stm32_check_blocks(struct dma_config *config)
+{
+	struct dma_block_config *block = config->head_block;
+	u32_t i;
+
+	if (!block || !config->block_count) {
+		return -EINVAL;
+	}
+
+	if (config->cyclic &&
+	    config->channel_direction == MEMORY_TO_MEMORY) {
+		SYS_LOG_ERR("DMA error: No cyclic memory to memory transfer");
+		return -EINVAL;
+	}
+
+	for (i = 0; i < config->block_count; i++, block = block->next_block) {
+		if (!block) {
+			SYS_LOG_ERR("DMA error: Only %u blocks chained", i);
+			return -EINVAL;
+		}
+
+		if (block->block_size > DMA_STM32_MAX_DATA_ITEMS) {
+			SYS_LOG_ERR("DMA error: Data size too big: %d\n",
+				    block->block_size);
+			return -EINVAL;
+		}
+
+		/* Double buffer mode has a single transfer count */
+		if (config->cyclic &&
+		    block->block_size != config->head_block->block_size) {
+			SYS_LOG_ERR("DMA error: Cyclic blocks differ in size");
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
 static int dma_stm32_config(struct device *dev, u32_t id,
 			    struct dma_config *config)
 {
 	struct dma_stm32_device *ddata = dev->driver_data;
 	struct dma_stm32_stream *stream = &ddata->stream[id];
 	struct dma_stm32_stream_reg *regs = &ddata->stream[id].regs;
+	struct dma_block_config *block;
 	int ret;
 
 
@@ -377,35 +527,96 @@ static int dma_stm32_config(struct device *dev, u32_t id,
 		return -EBUSY;
 	}
 
-	if (config->head_block->block_size > DMA_STM32_MAX_DATA_ITEMS) {
-		SYS_LOG_ERR("DMA error: Data size too big: %d\n",
-		       config->head_block->block_size);
-		return -EINVAL;
+	ret = dma_stm32_check_blocks(config);
+	if (ret) {
+		return ret;
 	}
 
 	stream->busy		= true;
 	stream->dma_callback	= config->dma_callback;
 	stream->direction	= config->channel_direction;
+	stream->block_callback	= config->complete_callback_en ||
+				  config->cyclic;
 
-	if (stream->direction == MEMORY_TO_PERIPHERAL) {
-		regs->sm0ar = (u32_t)config->head_block->source_address;
-		regs->spar = (u32_t)config->head_block->dest_address;
-	} else {
-		regs->spar = (u32_t)config->head_block->source_address;
-		regs->sm0ar = (u32_t)config->head_block->dest_address;
-	}
+	block = config->head_block;
+	dma_stm32_block_regs(stream, block->source_address,
+			     block->dest_address, block->block_size);
 
 	if (stream->direction == MEMORY_TO_MEMORY) {
 		ret = dma_stm32_config_memcpy(dev, id);
 	} else {
 		ret = dma_stm32_config_devcpy(dev, id, config);
+		regs->scr |= DMA_STM32_SCR_TCIE | DMA_STM32_SCR_TEIE;
 	}
 
-	regs->sndtr = config->head_block->block_size;
+	if (config->half_complete_callback_en) {
+		regs->scr |= DMA_STM32_SCR_HTIE;
+	}
+
+	stream->head_block = block;
+	stream->block_count = config->block_count;
+
+	if (config->cyclic && config->block_count > 1) {
+		/* Ping-pong between the two memory addresses */
+		regs->scr |= DMA_STM32_SCR_DBM;
+		regs->sm1ar = dma_stm32_mem_addr(stream, block->next_block);
+		stream->next_idx = 1;
+		stream->next_block = block->next_block;
+		dma_stm32_advance(stream);
+	} else if (config->cyclic) {
+		regs->scr |= DMA_STM32_SCR_CIRC;
+		stream->next_block = NULL;
+	} else {
+		stream->next_idx = 0;
+		stream->next_block = block;
+		dma_stm32_advance(stream);
+	}
 
 	return ret;
 }
 
+static int dma_stm32_reload(struct device *dev, u32_t id,
+			    u32_t src, u32_t dst, size_t size)
+{
+	struct dma_stm32_device *ddata = dev->driver_data;
+	struct dma_stm32_stream *stream;
+	u32_t config, addr;
+
+	if (id >= DMA_STM32_MAX_STREAMS) {
+		return -EINVAL;
+	}
+
+	stream = &ddata->stream[id];
+	config = dma_stm32_read(ddata, DMA_STM32_SCR(id));
+
+	if (!(config & DMA_STM32_SCR_EN)) {
+		if (size > DMA_STM32_MAX_DATA_ITEMS) {
+			return -EINVAL;
+		}
+
+		/* Stopped: the next dma_start() transfers this block only */
+		dma_stm32_block_regs(stream, src, dst, size);
+		stream->regs.scr &= ~(DMA_STM32_SCR_DBM | DMA_STM32_SCR_CT);
+		stream->next_block = NULL;
+		stream->busy = true;
+		return 0;
+	}
+
+	if (!(config & DMA_STM32_SCR_DBM) || size != stream->regs.sndtr) {
+		return -EBUSY;
+	}
+
+	/* Running ping-pong: replace the block not being transferred */
+	addr = (stream->direction == MEMORY_TO_PERIPHERAL) ? src : dst;
+	if (config & DMA_STM32_SCR_CT) {
+		dma_stm32_write(ddata, DMA_STM32_SM0AR(id), addr);
+	} else {
+		dma_stm32_write(ddata, DMA_STM32_SM1AR(id), addr);
+	}
+
+	return 0;
+}
+
 static int dma_stm32_start(struct device *dev, u32_t id)
 {
 	struct dma_stm32_device *ddata = dev->driver_data;
@@ -509,6 +720,7 @@ static const struct dma_driver_api dma_funcs = {
 	.config		 = dma_stm32_config,
 	.start		 = dma_stm32_start,
 	.stop		 = dma_stm32_stop,
+	.reload		 = dma_stm32_reload,
 };
 
 const struct dma_stm32_config dma_stm32_1_cdata = {
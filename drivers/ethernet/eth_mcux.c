@@ -23,6 +23,14 @@
 #include <net/net_pkt.h>
 #include <net/net_if.h>
 #include <net/ethernet.h>
+#include <cache.h>
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+#include <net/ethernet_rx_poll.h>
+#endif
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+#include <ptp_clock.h>
+#include <misc/byteorder.h>
+#endif
 
 #include "fsl_enet.h"
 #include "fsl_phy.h"
@@ -75,17 +83,21 @@ struct eth_context {
 	u8_t mac_addr[6];
 	struct k_work phy_work;
 	struct k_delayed_work delayed_phy_work;
-	/* TODO: FIXME. This Ethernet frame sized buffer is used for
-	 * interfacing with MCUX. How it works is that hardware uses
-	 * DMA scatter buffers to receive a frame, and then public
-	 * MCUX call gathers them into this buffer (there's no other
-	 * public interface). All this happens only for this driver
-	 * to scatter this buffer again into Zephyr fragment buffers.
-	 * This is not efficient, but proper resolution of this issue
-	 * depends on introduction of zero-copy networking support
-	 * in Zephyr, and adding needed interface to MCUX (or
-	 * bypassing it and writing a more complex driver working
-	 * directly with hardware).
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+	struct net_eth_rx_poll rx_poll;
+#endif
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	struct net_stats_eth stats;
+#endif
+	/* This Ethernet frame sized buffer is used for interfacing
+	 * with MCUX. How it works is that hardware uses DMA scatter
+	 * buffers to receive a frame, and then public MCUX call
+	 * gathers them into this buffer (there's no other public
+	 * interface). All this happens only for this driver to
+	 * scatter this buffer again into Zephyr fragment buffers.
+	 * CONFIG_ETH_MCUX_RX_ZERO_COPY avoids that on the RX side by
+	 * driving the descriptor ring directly with the network data
+	 * buffers. The TX side still goes through this buffer.
 	 *
 	 * Note that we do not copy FCS into this buffer thus the
 	 * size is 1514 bytes.
@@ -115,12 +127,44 @@ tx_buffer_desc[CONFIG_ETH_MCUX_TX_BUFFERS];
 	ROUND_UP(ENET_FRAME_MAX_FRAMELEN, ENET_BUFF_ALIGNMENT)
 #endif /* CONFIG_NET_VLAN */
 
+#if defined(CONFIG_ETH_MCUX_RX_ZERO_COPY)
+/* Room left in a network data buffer once its start is aligned for the DMA */
+#define ETH_MCUX_RX_FRAG_SIZE \
+	ROUND_DOWN(CONFIG_NET_BUF_DATA_SIZE - (ENET_BUFF_ALIGNMENT - 1), \
+		   ENET_BUFF_ALIGNMENT)
+
+BUILD_ASSERT_MSG(ETH_MCUX_RX_FRAG_SIZE >= ENET_RX_MIN_BUFFERSIZE,
+		 "NET_BUF_DATA_SIZE too small for the RX descriptors");
+BUILD_ASSERT_MSG(ETH_MCUX_RX_FRAG_SIZE * CONFIG_ETH_MCUX_RX_BUFFERS >
+		 ETH_MCUX_BUFFER_SIZE,
+		 "Not enough RX descriptors for a full sized frame");
+
+/* Data buffers the descriptors of the same index point to */
+static struct net_buf *rx_frag[CONFIG_ETH_MCUX_RX_BUFFERS];
+#else
 static u8_t __aligned(ENET_BUFF_ALIGNMENT)
 rx_buffer[CONFIG_ETH_MCUX_RX_BUFFERS][ETH_MCUX_BUFFER_SIZE];
+#endif
 
 static u8_t __aligned(ENET_BUFF_ALIGNMENT)
 tx_buffer[CONFIG_ETH_MCUX_TX_BUFFERS][ETH_MCUX_BUFFER_SIZE];
 
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+/* Timestamps of the PTP event messages, kept by MCUX until looked up */
+#define ETH_MCUX_PTP_TS_COUNT 8
+
+static enet_ptp_time_data_t ptp_rx_ts[ETH_MCUX_PTP_TS_COUNT];
+static enet_ptp_time_data_t ptp_tx_ts[ETH_MCUX_PTP_TS_COUNT];
+
+/* Offsets of the fields identifying a message in the PTP header */
+#define PTP_MSG_TYPE_OFFSET		0
+#define PTP_VERSION_OFFSET		1
+#define PTP_SOURCE_PORT_ID_OFFSET	20
+#define PTP_SEQUENCE_ID_OFFSET		30
+
+DEVICE_DECLARE(eth_mcux_ptp_clock_0);
+#endif
+
 static void eth_mcux_decode_duplex_and_speed(u32_t status,
 					     phy_duplex_t *p_phy_duplex,
 					     phy_speed_t *p_phy_speed)
@@ -391,34 +435,144 @@ static int eth_tx(struct net_if *iface, struct net_pkt *pkt)
 	return 0;
 }
 
-static void eth_rx(struct device *iface)
+#if defined(CONFIG_ETH_MCUX_RX_ZERO_COPY)
+static struct net_buf *eth_rx_frag_alloc(void)
 {
-	struct eth_context *context = iface->driver_data;
-	struct net_buf *prev_buf;
+	struct net_buf *frag;
+
+	frag = net_pkt_get_reserve_rx_data(0, K_NO_WAIT);
+	if (!frag) {
+		return NULL;
+	}
+
+	net_buf_reserve(frag, ROUND_UP((u32_t)frag->data,
+				       ENET_BUFF_ALIGNMENT) -
+			(u32_t)frag->data);
+
+	/* No dirty line is to be written back over what the DMA writes */
+	sys_cache_flush((vaddr_t)frag->data, ETH_MCUX_RX_FRAG_SIZE);
+
+	return frag;
+}
+
+/* Hand the data buffers of the frame over to a packet, posting new ones
+ * to the descriptors.
+ */
+static struct net_pkt *eth_rx_frame(struct eth_context *context,
+				    u32_t frame_length)
+{
+	enet_handle_t *handle = &context->enet_handle;
+	struct net_buf *new_frag[CONFIG_ETH_MCUX_RX_BUFFERS];
+	volatile enet_rx_bd_struct_t *bd;
 	struct net_pkt *pkt;
-	const u8_t *src;
-	u32_t frame_length = 0;
 	status_t status;
-	unsigned int imask;
-	u16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
+	int count, i;
 
-	status = ENET_GetRxFrameSize(&context->enet_handle,
-				     (uint32_t *)&frame_length);
-	if (status) {
-		enet_data_error_stats_t error_stats;
+	count = (frame_length + ETH_MCUX_RX_FRAG_SIZE - 1) /
+		ETH_MCUX_RX_FRAG_SIZE;
 
-		SYS_LOG_ERR("ENET_GetRxFrameSize return: %d", (int)status);
+	pkt = net_pkt_get_reserve_rx(0, K_NO_WAIT);
+	if (!pkt) {
+		goto drop;
+	}
 
-		ENET_GetRxErrBeforeReadFrame(&context->enet_handle,
-					     &error_stats);
-		/* Flush the current read buffer.  This operation can
-		 * only report failure if there is no frame to flush,
-		 * which cannot happen in this context.
-		 */
-		status = ENET_ReadFrame(ENET, &context->enet_handle, NULL, 0);
-		assert(status == kStatus_Success);
-		return;
+	/* Get all the buffers first, the frame is dropped as a whole
+	 * otherwise and the descriptors keep theirs.
+	 */
+	for (i = 0; i < count; i++) {
+		new_frag[i] = eth_rx_frag_alloc();
+		if (!new_frag[i]) {
+			while (i--) {
+				net_pkt_frag_unref(new_frag[i]);
+			}
+
+			net_pkt_unref(pkt);
+			goto drop;
+		}
+	}
+
+	bd = handle->rxBdCurrent[0];
+
+	for (i = 0; i < count; i++) {
+		int idx = bd - handle->rxBdBase[0];
+		struct net_buf *frag = rx_frag[idx];
+		size_t len = min(frame_length, ETH_MCUX_RX_FRAG_SIZE);
+
+		sys_cache_invalidate((vaddr_t)frag->data, len);
+		net_buf_add(frag, len);
+		net_pkt_frag_add(pkt, frag);
+		frame_length -= len;
+
+		rx_frag[idx] = new_frag[i];
+		bd->buffer = new_frag[i]->data;
+		bd->length = 0;
+		bd->control &= ENET_BUFFDESCRIPTOR_RX_WRAP_MASK;
+		bd->control |= ENET_BUFFDESCRIPTOR_RX_EMPTY_MASK;
+
+		if (bd->control & ENET_BUFFDESCRIPTOR_RX_WRAP_MASK) {
+			bd = handle->rxBdBase[0];
+		} else {
+			bd++;
+		}
+	}
+
+	handle->rxBdCurrent[0] = bd;
+	ENET->RDAR = ENET_RDAR_RDAR_MASK;
+
+	return pkt;
+
+drop:
+	/* Flush the current read buffer.  This operation can only
+	 * report failure if there is no frame to flush, which cannot
+	 * happen in this context.
+	 */
+	status = ENET_ReadFrame(ENET, handle, NULL, 0);
+	assert(status == kStatus_Success);
+
+	return NULL;
+}
+
+static int eth_rx_ring_init(enet_buffer_config_t *buffer_config)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_ETH_MCUX_RX_BUFFERS; i++) {
+		rx_frag[i] = eth_rx_frag_alloc();
+		if (!rx_frag[i]) {
+			while (i--) {
+				net_pkt_frag_unref(rx_frag[i]);
+			}
+
+			return -ENOMEM;
+		}
+	}
+
+	buffer_config->rxBuffSizeAlign = ETH_MCUX_RX_FRAG_SIZE;
+	buffer_config->rxBufferAlign = rx_frag[0]->data;
+
+	return 0;
+}
+
+/* ENET_Init() lays the RX buffers out contiguously, point every
+ * descriptor to its own data buffer instead.
+ */
+static void eth_rx_ring_post(void)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_ETH_MCUX_RX_BUFFERS; i++) {
+		rx_buffer_desc[i].buffer = rx_frag[i]->data;
 	}
+}
+#else
+static struct net_pkt *eth_rx_frame(struct eth_context *context,
+				    u32_t frame_length)
+{
+	struct net_buf *prev_buf;
+	struct net_pkt *pkt;
+	const u8_t *src;
+	status_t status;
+	unsigned int imask;
 
 	pkt = net_pkt_get_reserve_rx(0, K_NO_WAIT);
 	if (!pkt) {
@@ -432,7 +586,7 @@ static void eth_rx(struct device *iface)
 		 */
 		status = ENET_ReadFrame(ENET, &context->enet_handle, NULL, 0);
 		assert(status == kStatus_Success);
-		return;
+		return NULL;
 	}
 
 	if (sizeof(context->frame_buf) < frame_length) {
@@ -440,7 +594,7 @@ static void eth_rx(struct device *iface)
 		net_pkt_unref(pkt);
 		status = ENET_ReadFrame(ENET, &context->enet_handle, NULL, 0);
 		assert(status == kStatus_Success);
-		return;
+		return NULL;
 	}
 
 	/* As context->frame_buf is shared resource used by both eth_tx
@@ -454,7 +608,7 @@ static void eth_rx(struct device *iface)
 		irq_unlock(imask);
 		SYS_LOG_ERR("ENET_ReadFrame failed: %d", (int)status);
 		net_pkt_unref(pkt);
-		return;
+		return NULL;
 	}
 
 	src = context->frame_buf;
@@ -468,8 +622,7 @@ static void eth_rx(struct device *iface)
 			irq_unlock(imask);
 			SYS_LOG_ERR("Failed to get fragment buf");
 			net_pkt_unref(pkt);
-			assert(status == kStatus_Success);
-			return;
+			return NULL;
 		}
 
 		if (!prev_buf) {
@@ -491,6 +644,93 @@ static void eth_rx(struct device *iface)
 		frame_length -= frag_len;
 	} while (frame_length > 0);
 
+	irq_unlock(imask);
+
+	return pkt;
+}
+#endif /* CONFIG_ETH_MCUX_RX_ZERO_COPY */
+
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+/* Set the timestamp MCUX recorded for a PTP event message over Ethernet */
+static void eth_rx_timestamp(struct eth_context *context, struct net_pkt *pkt)
+{
+	u8_t *msg = net_pkt_ll(pkt) + sizeof(struct net_eth_hdr);
+	u16_t type = ntohs(NET_ETH_HDR(pkt)->type);
+	enet_ptp_time_data_t ts_data;
+	struct net_ptp_time ts;
+
+	if (type == NET_ETH_PTYPE_VLAN) {
+		/* the type follows the tag control information */
+		type = sys_get_be16(msg + 2);
+		msg += 4;
+	}
+
+	if (type != NET_ETH_PTYPE_PTP ||
+	    msg + PTP_SEQUENCE_ID_OFFSET + 2 >
+	    pkt->frags->data + pkt->frags->len) {
+		return;
+	}
+
+	ts_data.messageType = msg[PTP_MSG_TYPE_OFFSET] & 0x0f;
+	if (ts_data.messageType > kENET_PtpEventMsgType) {
+		return;
+	}
+
+	ts_data.version = msg[PTP_VERSION_OFFSET] & 0x0f;
+	ts_data.sequenceId = sys_get_be16(msg + PTP_SEQUENCE_ID_OFFSET);
+	memcpy(ts_data.sourcePortId, msg + PTP_SOURCE_PORT_ID_OFFSET,
+	       kENET_PtpSrcPortIdLen);
+
+	if (ENET_GetRxFrameTime(&context->enet_handle, &ts_data) !=
+	    kStatus_Success) {
+		return;
+	}
+
+	ts.second = ts_data.timeStamp.second;
+	ts.nanosecond = ts_data.timeStamp.nanosecond;
+	net_pkt_set_timestamp(pkt, &ts);
+}
+#endif /* CONFIG_ETH_MCUX_PTP_CLOCK */
+
+/* Receive the next frame of the ring, -EAGAIN if there is none */
+static int eth_rx(struct eth_context *context)
+{
+	struct net_pkt *pkt;
+	u32_t frame_length = 0;
+	status_t status;
+	u16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
+
+	status = ENET_GetRxFrameSize(&context->enet_handle,
+				     (uint32_t *)&frame_length);
+	if (status == kStatus_ENET_RxFrameEmpty) {
+		return -EAGAIN;
+	}
+
+	if (status) {
+		enet_data_error_stats_t error_stats;
+
+		SYS_LOG_ERR("ENET_GetRxFrameSize return: %d", (int)status);
+
+		ENET_GetRxErrBeforeReadFrame(&context->enet_handle,
+					     &error_stats);
+		/* Flush the current read buffer.  This operation can
+		 * only report failure if there is no frame to flush,
+		 * which cannot happen in this context.
+		 */
+		status = ENET_ReadFrame(ENET, &context->enet_handle, NULL, 0);
+		assert(status == kStatus_Success);
+		return 0;
+	}
+
+	pkt = eth_rx_frame(context, frame_length);
+	if (!pkt) {
+		return 0;
+	}
+
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+	eth_rx_timestamp(context, pkt);
+#endif
+
 #if defined(CONFIG_NET_VLAN)
 	{
 		struct net_eth_hdr *hdr = NET_ETH_HDR(pkt);
@@ -515,12 +755,44 @@ static void eth_rx(struct device *iface)
 	}
 #endif
 
-	irq_unlock(imask);
-
 	if (net_recv_data(get_iface(context, vlan_tag), pkt) < 0) {
 		net_pkt_unref(pkt);
 	}
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+static int eth_rx_poll(struct net_eth_rx_poll *rx_poll, int budget)
+{
+	struct eth_context *context =
+		CONTAINER_OF(rx_poll, struct eth_context, rx_poll);
+	int count = 0;
+
+	while (count < budget && !eth_rx(context)) {
+		count++;
+	}
+
+	return count;
+}
+
+static bool eth_rx_complete(struct net_eth_rx_poll *rx_poll)
+{
+	struct eth_context *context =
+		CONTAINER_OF(rx_poll, struct eth_context, rx_poll);
+	u32_t frame_length;
+
+	ENET_ClearInterruptStatus(ENET, kENET_RxFrameInterrupt);
+	ENET_EnableInterrupts(ENET, kENET_RxFrameInterrupt);
+
+	/* A frame received before the status was cleared raised no
+	 * interrupt: keep on polling for it.
+	 */
+	return ENET_GetRxFrameSize(&context->enet_handle,
+				   (uint32_t *)&frame_length) !=
+		kStatus_ENET_RxFrameEmpty;
 }
+#endif /* CONFIG_NET_L2_ETHERNET_RX_POLL */
 
 static void eth_callback(ENET_Type *base, enet_handle_t *handle,
 			 enet_event_t event, void *param)
@@ -530,7 +802,7 @@ static void eth_callback(ENET_Type *base, enet_handle_t *handle,
 
 	switch (event) {
 	case kENET_RxEvent:
-		eth_rx(iface);
+		eth_rx(context);
 		break;
 	case kENET_TxEvent:
 		/* Free the TX buffer. */
@@ -577,9 +849,20 @@ static int eth_0_init(struct device *dev)
 		.txBuffSizeAlign = ETH_MCUX_BUFFER_SIZE,
 		.rxBdStartAddrAlign = rx_buffer_desc,
 		.txBdStartAddrAlign = tx_buffer_desc,
+#if !defined(CONFIG_ETH_MCUX_RX_ZERO_COPY)
 		.rxBufferAlign = rx_buffer[0],
+#endif
 		.txBufferAlign = tx_buffer[0],
 	};
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+	enet_ptp_config_t ptp_config = {
+		.ptpTsRxBuffNum = ETH_MCUX_PTP_TS_COUNT,
+		.ptpTsTxBuffNum = ETH_MCUX_PTP_TS_COUNT,
+		.rxPtpTsData = ptp_rx_ts,
+		.txPtpTsData = ptp_tx_ts,
+		.channel = kENET_PtpTimerChannel1,
+	};
+#endif
 
 	k_sem_init(&context->tx_buf_sem,
 		   CONFIG_ETH_MCUX_TX_BUFFERS, CONFIG_ETH_MCUX_TX_BUFFERS);
@@ -587,6 +870,13 @@ static int eth_0_init(struct device *dev)
 	k_delayed_work_init(&context->delayed_phy_work,
 			    eth_mcux_delayed_phy_work);
 
+#if defined(CONFIG_ETH_MCUX_RX_ZERO_COPY)
+	if (eth_rx_ring_init(&buffer_config) < 0) {
+		SYS_LOG_ERR("No RX data buffers");
+		return -ENOMEM;
+	}
+#endif
+
 	sys_clock = CLOCK_GetFreq(kCLOCK_CoreSysClk);
 
 	ENET_GetDefaultConfig(&enet_config);
@@ -606,6 +896,11 @@ static int eth_0_init(struct device *dev)
 	enet_config.macSpecialConfig |= kENET_ControlVLANTagEnable;
 #endif
 
+#if defined(CONFIG_ETH_MCUX_RX_CHECKSUM_OFFLOAD)
+	enet_config.rxAccelerConfig |= kENET_RxAccelIpCheckEnabled |
+		kENET_RxAccelProtoCheckEnabled;
+#endif
+
 	ENET_Init(ENET,
 		  &context->enet_handle,
 		  &enet_config,
@@ -613,14 +908,35 @@ static int eth_0_init(struct device *dev)
 		  context->mac_addr,
 		  sys_clock);
 
+#if defined(CONFIG_ETH_MCUX_RX_ZERO_COPY)
+	eth_rx_ring_post();
+#endif
+
 	ENET_SetSMI(ENET, sys_clock, false);
 
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+	/* The 1588 timer runs from the system clock */
+	ptp_config.ptp1588ClockSrc_Hz = sys_clock;
+	ENET_Ptp1588Configure(ENET, &context->enet_handle, &ptp_config);
+#endif
+
 	SYS_LOG_DBG("MAC %02x:%02x:%02x:%02x:%02x:%02x",
 		    context->mac_addr[0], context->mac_addr[1],
 		    context->mac_addr[2], context->mac_addr[3],
 		    context->mac_addr[4], context->mac_addr[5]);
 
 	ENET_SetCallback(&context->enet_handle, eth_callback, dev);
+
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	net_eth_rx_poll_init(&context->rx_poll, eth_rx_poll, eth_rx_complete,
+			     &context->stats);
+#else
+	net_eth_rx_poll_init(&context->rx_poll, eth_rx_poll, eth_rx_complete,
+			     NULL);
+#endif
+#endif
+
 	eth_0_config_func();
 
 	eth_mcux_phy_start(context);
@@ -668,17 +984,45 @@ static void eth_iface_init(struct net_if *iface)
 
 static enum ethernet_hw_caps eth_mcux_get_capabilities(struct device *dev)
 {
+	enum ethernet_hw_caps caps;
+
 	ARG_UNUSED(dev);
 
-	return ETHERNET_HW_VLAN | ETHERNET_LINK_10BASE_T |
+	caps = ETHERNET_HW_VLAN | ETHERNET_LINK_10BASE_T |
 		ETHERNET_LINK_100BASE_T;
+#if defined(CONFIG_ETH_MCUX_RX_CHECKSUM_OFFLOAD)
+	caps |= ETHERNET_HW_RX_CHKSUM_OFFLOAD;
+#endif
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+	caps |= ETHERNET_PTP;
+#endif
+
+	return caps;
 }
 
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+static struct device *eth_mcux_get_ptp_clock(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	return DEVICE_GET(eth_mcux_ptp_clock_0);
+}
+#endif
+
+static struct eth_context eth_0_context;
+
 static const struct ethernet_api api_funcs = {
 	.iface_api.init = eth_iface_init,
 	.iface_api.send = eth_tx,
 
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	.stats = &eth_0_context.stats,
+#endif
+
 	.get_capabilities = eth_mcux_get_capabilities,
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+	.get_ptp_clock = eth_mcux_get_ptp_clock,
+#endif
 };
 
 static void eth_mcux_rx_isr(void *p)
@@ -686,7 +1030,16 @@ static void eth_mcux_rx_isr(void *p)
 	struct device *dev = p;
 	struct eth_context *context = dev->driver_data;
 
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+	/* The frames are received from the polling thread, with the
+	 * interrupt masked until the ring is drained.
+	 */
+	ENET_DisableInterrupts(ENET, kENET_RxFrameInterrupt);
+	ENET_ClearInterruptStatus(ENET, kENET_RxFrameInterrupt);
+	net_eth_rx_poll_schedule(&context->rx_poll);
+#else
 	ENET_ReceiveIRQHandler(ENET, &context->enet_handle);
+#endif
 }
 
 static void eth_mcux_tx_isr(void *p)
@@ -697,6 +1050,16 @@ static void eth_mcux_tx_isr(void *p)
 	ENET_TransmitIRQHandler(ENET, &context->enet_handle);
 }
 
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+static void eth_mcux_ptp_isr(void *p)
+{
+	struct device *dev = p;
+	struct eth_context *context = dev->driver_data;
+
+	ENET_Ptp1588TimerIRQHandler(ENET, &context->enet_handle);
+}
+#endif
+
 static void eth_mcux_error_isr(void *p)
 {
 	struct device *dev = p;
@@ -742,4 +1105,115 @@ static void eth_0_config_func(void)
 	IRQ_CONNECT(IRQ_ETH_ERR_MISC, CONFIG_ETH_MCUX_0_IRQ_PRI,
 		    eth_mcux_error_isr, DEVICE_GET(eth_mcux_0), 0);
 	irq_enable(IRQ_ETH_ERR_MISC);
+
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+	IRQ_CONNECT(IRQ_ETH_IEEE1588_TMR, CONFIG_ETH_MCUX_0_IRQ_PRI,
+		    eth_mcux_ptp_isr, DEVICE_GET(eth_mcux_0), 0);
+	irq_enable(IRQ_ETH_IEEE1588_TMR);
+#endif
+}
+
+#if defined(CONFIG_ETH_MCUX_PTP_CLOCK)
+static int ptp_clock_mcux_set(struct device *dev,
+			      const struct net_ptp_time *tm)
+{
+	struct eth_context *context = dev->driver_data;
+	enet_ptp_time_t enet_time;
+
+	enet_time.second = tm->second;
+	enet_time.nanosecond = tm->nanosecond;
+	ENET_Ptp1588SetTimer(ENET, &context->enet_handle, &enet_time);
+
+	return 0;
+}
+
+static int ptp_clock_mcux_get(struct device *dev, struct net_ptp_time *tm)
+{
+	struct eth_context *context = dev->driver_data;
+	enet_ptp_time_t enet_time;
+
+	ENET_Ptp1588GetTimer(ENET, &context->enet_handle, &enet_time);
+	tm->second = enet_time.second;
+	tm->nanosecond = enet_time.nanosecond;
+
+	return 0;
+}
+
+static int ptp_clock_mcux_adjust(struct device *dev, s32_t increment)
+{
+	struct eth_context *context = dev->driver_data;
+	enet_ptp_time_t enet_time;
+	unsigned int key;
+	s32_t ns;
+
+	if (increment <= -(s32_t)NSEC_PER_SEC ||
+	    increment >= (s32_t)NSEC_PER_SEC) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	ENET_Ptp1588GetTimer(ENET, &context->enet_handle, &enet_time);
+
+	ns = enet_time.nanosecond + increment;
+	if (ns < 0) {
+		ns += NSEC_PER_SEC;
+		enet_time.second--;
+	} else if (ns >= NSEC_PER_SEC) {
+		ns -= NSEC_PER_SEC;
+		enet_time.second++;
+	}
+
+	enet_time.nanosecond = ns;
+	ENET_Ptp1588SetTimer(ENET, &context->enet_handle, &enet_time);
+
+	irq_unlock(key);
+
+	return 0;
 }
+
+static int ptp_clock_mcux_rate_adjust(struct device *dev, s32_t ppb)
+{
+	u32_t inc = (ENET->ATINC & ENET_ATINC_INC_MASK) >>
+		ENET_ATINC_INC_SHIFT;
+	u64_t period;
+
+	ARG_UNUSED(dev);
+
+	if (ppb == 0) {
+		ENET_Ptp1588AdjustTimer(ENET, inc, 0);
+		return 0;
+	}
+
+	/* Every period timer clocks, the timer is incremented by one
+	 * nanosecond more, or less, than the nominal increment.
+	 */
+	period = NSEC_PER_SEC / ((u64_t)inc * (ppb > 0 ? ppb : -ppb));
+	if (period == 0 || period > ENET_ATCOR_COR_MASK) {
+		return -ERANGE;
+	}
+
+	ENET_Ptp1588AdjustTimer(ENET, ppb > 0 ? inc + 1 : inc - 1, period);
+
+	return 0;
+}
+
+static const struct ptp_clock_driver_api ptp_clock_mcux_api = {
+	.set = ptp_clock_mcux_set,
+	.get = ptp_clock_mcux_get,
+	.adjust = ptp_clock_mcux_adjust,
+	.rate_adjust = ptp_clock_mcux_rate_adjust,
+};
+
+static int ptp_clock_mcux_init(struct device *dev)
+{
+	/* The timer is started along with the controller */
+	ARG_UNUSED(dev);
+
+	return 0;
+}
+
+DEVICE_AND_API_INIT(eth_mcux_ptp_clock_0, "PTP_CLOCK", ptp_clock_mcux_init,
+		    &eth_0_context, NULL, POST_KERNEL,
+		    CONFIG_APPLICATION_INIT_PRIORITY, &ptp_clock_mcux_api);
+#endif /* CONFIG_ETH_MCUX_PTP_CLOCK */
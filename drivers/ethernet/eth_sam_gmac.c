@@ -31,6 +31,9 @@
 #include <net/net_pkt.h>
 #include <net/net_if.h>
 #include <net/ethernet.h>
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+#include <net/ethernet_rx_poll.h>
+#endif
 #include <i2c.h>
 #include <soc.h>
 #include "phy_sam_gmac.h"
@@ -183,6 +186,8 @@ static int rx_descriptors_init(Gmac *gmac, struct gmac_queue *queue)
 			 "Misaligned RX buffer address");
 		__ASSERT(rx_buf->size == CONFIG_NET_BUF_DATA_SIZE,
 			 "Incorrect length of RX data buffer");
+		/* No dirty line is to be written back over the DMA data */
+		DCACHE_CLEAN(rx_buf_addr, CONFIG_NET_BUF_DATA_SIZE);
 		/* Give ownership to GMAC and remove the wrap bit */
 		rx_desc_list->buf[i].w0 = (u32_t)rx_buf_addr & GMAC_RXW0_ADDR;
 		rx_desc_list->buf[i].w1 = 0;
@@ -555,6 +560,8 @@ static struct net_pkt *frame_get(struct gmac_queue *queue)
 				last_frag = frag;
 				frag = new_frag;
 				rx_frag_list->buf[tail] = (u32_t)frag;
+				DCACHE_CLEAN(frag->data,
+					     CONFIG_NET_BUF_DATA_SIZE);
 			}
 		}
 
@@ -599,17 +606,32 @@ static inline struct net_if *get_iface(struct eth_sam_dev_data *ctx,
 #endif
 }
 
-static void eth_rx(struct gmac_queue *queue)
+/* Get a frame, protected from rx_error_handler() when polling */
+static struct net_pkt *frame_get_locked(struct gmac_queue *queue)
+{
+	struct net_pkt *rx_frame;
+	unsigned int key;
+
+	key = irq_lock();
+	rx_frame = frame_get(queue);
+	irq_unlock(key);
+
+	return rx_frame;
+}
+
+/* Receive up to budget frames, return how many were received */
+static int eth_rx(struct gmac_queue *queue, int budget)
 {
 	struct eth_sam_dev_data *dev_data =
 		CONTAINER_OF(queue, struct eth_sam_dev_data, queue_list);
 	u16_t vlan_tag = NET_VLAN_TAG_UNSPEC;
 	struct net_pkt *rx_frame;
+	int count = 0;
 
 	/* More than one frame could have been received by GMAC, get all
 	 * complete frames stored in the GMAC RX descriptor list.
 	 */
-	rx_frame = frame_get(queue);
+	rx_frame = count < budget ? frame_get_locked(queue) : NULL;
 	while (rx_frame) {
 		SYS_LOG_DBG("ETH rx");
 
@@ -646,10 +668,38 @@ static void eth_rx(struct gmac_queue *queue)
 			net_pkt_unref(rx_frame);
 		}
 
-		rx_frame = frame_get(queue);
+		count++;
+		rx_frame = count < budget ? frame_get_locked(queue) : NULL;
 	}
+
+	return count;
+}
+
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+static int eth_rx_poll(struct net_eth_rx_poll *rx_poll, int budget)
+{
+	struct eth_sam_dev_data *dev_data =
+		CONTAINER_OF(rx_poll, struct eth_sam_dev_data, rx_poll);
+
+	return eth_rx(&dev_data->queue_list[0], budget);
 }
 
+static bool eth_rx_complete(struct net_eth_rx_poll *rx_poll)
+{
+	struct eth_sam_dev_data *dev_data =
+		CONTAINER_OF(rx_poll, struct eth_sam_dev_data, rx_poll);
+	struct gmac_desc_list *rx_desc_list =
+		&dev_data->queue_list[0].rx_desc_list;
+
+	GMAC->GMAC_IER = GMAC_IER_RCOMP;
+
+	/* The status of a frame received while the interrupt was masked
+	 * may have been cleared already: keep on polling for it.
+	 */
+	return rx_desc_list->buf[rx_desc_list->tail].w0 & GMAC_RXW0_OWNERSHIP;
+}
+#endif /* CONFIG_NET_L2_ETHERNET_RX_POLL */
+
 static int eth_tx(struct net_if *iface, struct net_pkt *pkt)
 {
 	struct device *const dev = net_if_get_device(iface);
@@ -768,7 +818,15 @@ static void queue0_isr(void *arg)
 		SYS_LOG_DBG("rx.w1=0x%08x, tail=%d",
 			    queue->rx_desc_list.buf[queue->rx_desc_list.tail].w1,
 			    queue->rx_desc_list.tail);
-		eth_rx(queue);
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+		/* The frames are received from the polling thread, with the
+		 * interrupt masked until the ring is drained.
+		 */
+		gmac->GMAC_IDR = GMAC_IDR_RCOMP;
+		net_eth_rx_poll_schedule(&dev_data->rx_poll);
+#else
+		eth_rx(queue, queue->rx_desc_list.len);
+#endif
 	}
 
 	/* TX packet */
@@ -870,6 +928,16 @@ static void eth0_iface_init(struct net_if *iface)
 			     sizeof(dev_data->mac_addr),
 			     NET_LINK_ETHERNET);
 
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	net_eth_rx_poll_init(&dev_data->rx_poll, eth_rx_poll, eth_rx_complete,
+			     &dev_data->stats);
+#else
+	net_eth_rx_poll_init(&dev_data->rx_poll, eth_rx_poll, eth_rx_complete,
+			     NULL);
+#endif
+#endif
+
 	/* Initialize GMAC queues */
 	/* Note: Queues 1 and 2 are not used, configured to stay idle */
 	priority_queue_init_as_idle(cfg->regs, &dev_data->queue_list[2]);
@@ -903,14 +971,24 @@ static enum ethernet_hw_caps eth_sam_gmac_get_capabilities(struct device *dev)
 {
 	ARG_UNUSED(dev);
 
+	/* Checksum offload is always enabled, see GMAC_DCFGR_TXCOEN and
+	 * GMAC_NCFGR_RXCOEN.
+	 */
 	return ETHERNET_HW_VLAN | ETHERNET_LINK_10BASE_T |
-		ETHERNET_LINK_100BASE_T;
+		ETHERNET_LINK_100BASE_T | ETHERNET_HW_TX_CHKSUM_OFFLOAD |
+		ETHERNET_HW_RX_CHKSUM_OFFLOAD | ETHERNET_HW_TX_SG;
 }
 
+static struct eth_sam_dev_data eth0_data;
+
 static const struct ethernet_api eth_api = {
 	.iface_api.init = eth0_iface_init,
 	.iface_api.send = eth_tx,
 
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	.stats = &eth0_data.stats,
+#endif
+
 	.get_capabilities = eth_sam_gmac_get_capabilities,
 };
 
@@ -11,6 +11,7 @@
 #define _ETH_SAM_GMAC_PRIV_H_
 
 #include <zephyr/types.h>
+#include <cache.h>
 
 #define GMAC_MTU 1500
 #define GMAC_FRAME_SIZE_MAX (GMAC_MTU + 18)
@@ -26,19 +27,11 @@
 /** RX/TX descriptors count for priority queues */
 #define PRIORITY_QUEUE_DESC_COUNT         1
 
-/* FIXME change to
- * #if __DCACHE_PRESENT == 1
- * when cache support is added
- */
-#if 0
+/* Both are no-ops unless CONFIG_CACHE_FLUSHING is enabled */
 #define DCACHE_INVALIDATE(addr, size) \
-		SCB_InvalidateDCache_by_Addr((u32_t *)addr, size)
+		sys_cache_invalidate((vaddr_t)(addr), size)
 #define DCACHE_CLEAN(addr, size) \
-		SCB_CleanDCache_by_Addr((u32_t *)addr, size)
-#else
-#define DCACHE_INVALIDATE(addr, size) { ; }
-#define DCACHE_CLEAN(addr, size) { ; }
-#endif
+		sys_cache_flush((vaddr_t)(addr), size)
 
 /*
  * Receive buffer descriptor bit field definitions
@@ -180,6 +173,12 @@ struct eth_sam_dev_data {
 	struct net_if *iface;
 	u8_t mac_addr[6];
 	struct gmac_queue queue_list[GMAC_QUEUE_NO];
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+	struct net_eth_rx_poll rx_poll;
+#endif
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	struct net_stats_eth stats;
+#endif
 };
 
 #define DEV_CFG(dev) \
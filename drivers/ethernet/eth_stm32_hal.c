@@ -195,6 +195,49 @@ release_desc:
 	return pkt;
 }
 
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+static int eth_rx_poll(struct net_eth_rx_poll *rx_poll, int budget)
+{
+	struct eth_stm32_hal_dev_data *dev_data =
+		CONTAINER_OF(rx_poll, struct eth_stm32_hal_dev_data, rx_poll);
+	struct net_pkt *pkt;
+	int count = 0;
+	int res;
+
+	while (count < budget) {
+		pkt = eth_rx(net_if_get_device(dev_data->iface));
+		if (!pkt) {
+			break;
+		}
+
+		count++;
+
+		res = net_recv_data(dev_data->iface, pkt);
+		if (res < 0) {
+			SYS_LOG_ERR("Failed to enqueue frame "
+				"into RX queue: %d", res);
+			net_pkt_unref(pkt);
+		}
+	}
+
+	return count;
+}
+
+static bool eth_rx_complete(struct net_eth_rx_poll *rx_poll)
+{
+	struct eth_stm32_hal_dev_data *dev_data =
+		CONTAINER_OF(rx_poll, struct eth_stm32_hal_dev_data, rx_poll);
+	ETH_HandleTypeDef *heth = &dev_data->heth;
+
+	__HAL_ETH_DMA_CLEAR_IT(heth, ETH_DMA_IT_R);
+	__HAL_ETH_DMA_ENABLE_IT(heth, ETH_DMA_IT_R);
+
+	/* A frame received before the status was cleared raised no
+	 * interrupt: keep on polling for it.
+	 */
+	return !(heth->RxDesc->Status & ETH_DMARXDESC_OWN);
+}
+#else
 static void rx_thread(void *arg1, void *unused1, void *unused2)
 {
 	struct device *dev;
@@ -225,6 +268,7 @@ static void rx_thread(void *arg1, void *unused1, void *unused2)
 		}
 	}
 }
+#endif /* CONFIG_NET_L2_ETHERNET_RX_POLL */
 
 static void eth_isr(void *arg)
 {
@@ -256,7 +300,15 @@ void HAL_ETH_RxCpltCallback(ETH_HandleTypeDef *heth_handle)
 
 	__ASSERT_NO_MSG(dev_data != NULL);
 
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+	/* The frames are received from the polling thread, with the
+	 * interrupt masked until the ring is drained.
+	 */
+	__HAL_ETH_DMA_DISABLE_IT(heth_handle, ETH_DMA_IT_R);
+	net_eth_rx_poll_schedule(&dev_data->rx_poll);
+#else
 	k_sem_give(&dev_data->rx_int_sem);
+#endif
 }
 
 static int eth_initialize(struct device *dev)
@@ -345,6 +397,16 @@ static void eth_iface_init(struct net_if *iface)
 
 	/* Initialize semaphores */
 	k_mutex_init(&dev_data->tx_mutex);
+
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	net_eth_rx_poll_init(&dev_data->rx_poll, eth_rx_poll, eth_rx_complete,
+			     &dev_data->stats);
+#else
+	net_eth_rx_poll_init(&dev_data->rx_poll, eth_rx_poll, eth_rx_complete,
+			     NULL);
+#endif
+#else
 	k_sem_init(&dev_data->rx_int_sem, 0, UINT_MAX);
 
 	/* Start interruption-poll thread */
@@ -353,6 +415,7 @@ static void eth_iface_init(struct net_if *iface)
 			rx_thread, (void *) dev, NULL, NULL,
 			K_PRIO_COOP(CONFIG_ETH_STM32_HAL_RX_THREAD_PRIO),
 			0, K_NO_WAIT);
+#endif
 
 	HAL_ETH_DMATxDescListInit(heth, dma_tx_desc_tab,
 		&dma_tx_buffer[0][0], ETH_TXBUFNB);
@@ -376,15 +439,28 @@ static void eth_iface_init(struct net_if *iface)
 
 static enum ethernet_hw_caps eth_stm32_hal_get_capabilities(struct device *dev)
 {
+	enum ethernet_hw_caps caps;
+
 	ARG_UNUSED(dev);
 
-	return ETHERNET_LINK_10BASE_T | ETHERNET_LINK_100BASE_T;
+	caps = ETHERNET_LINK_10BASE_T | ETHERNET_LINK_100BASE_T;
+#if defined(CONFIG_ETH_STM32_HAL_HW_CHECKSUM)
+	caps |= ETHERNET_HW_TX_CHKSUM_OFFLOAD | ETHERNET_HW_RX_CHKSUM_OFFLOAD;
+#endif
+
+	return caps;
 }
 
+static struct eth_stm32_hal_dev_data eth0_data;
+
 static const struct ethernet_api eth_api = {
 	.iface_api.init = eth_iface_init,
 	.iface_api.send = eth_tx,
 
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	.stats = &eth0_data.stats,
+#endif
+
 	.get_capabilities = eth_stm32_hal_get_capabilities,
 };
 
@@ -416,7 +492,11 @@ static struct eth_stm32_hal_dev_data eth0_data = {
 			.AutoNegotiation = ETH_AUTONEGOTIATION_ENABLE,
 			.PhyAddress = CONFIG_ETH_STM32_HAL_PHY_ADDRESS,
 			.RxMode = ETH_RXINTERRUPT_MODE,
+#if defined(CONFIG_ETH_STM32_HAL_HW_CHECKSUM)
+			.ChecksumMode = ETH_CHECKSUM_BY_HARDWARE,
+#else
 			.ChecksumMode = ETH_CHECKSUM_BY_SOFTWARE,
+#endif
 			.MediaInterface = ETH_MEDIA_INTERFACE_RMII,
 		},
 	},
@@ -8,6 +8,10 @@
 
 #include <kernel.h>
 #include <zephyr/types.h>
+#include <net/net_stats.h>
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+#include <net/ethernet_rx_poll.h>
+#endif
 
 #define ETH_STM32_HAL_MTU 1500
 #define ETH_STM32_HAL_FRAME_SIZE_MAX (ETH_STM32_HAL_MTU + 18)
@@ -33,10 +37,17 @@ struct eth_stm32_hal_dev_data {
 	/* clock device */
 	struct device *clock;
 	struct k_mutex tx_mutex;
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+	struct net_eth_rx_poll rx_poll;
+#else
 	struct k_sem rx_int_sem;
 	K_THREAD_STACK_MEMBER(rx_thread_stack,
 		CONFIG_ETH_STM32_HAL_RX_THREAD_STACK_SIZE);
 	struct k_thread rx_thread;
+#endif
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	struct net_stats_eth stats;
+#endif
 };
 
 #define DEV_CFG(dev) \
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <kernel.h>
+#include <flash.h>
+
+#define FLASH_ASYNC_OP_WRITE	0
+#define FLASH_ASYNC_OP_ERASE	1
+
+static K_FIFO_DEFINE(flash_async_fifo);
+
+#if CONFIG_FLASH_ASYNC_COALESCE_SIZE > 0
+static u8_t flash_async_buf[CONFIG_FLASH_ASYNC_COALESCE_SIZE];
+#endif
+
+static void flash_async_done(struct flash_async_req *req, int rc)
+{
+	/* req may be reused by the caller from the callback on */
+	struct k_poll_signal *signal = req->signal;
+
+	if (req->cb) {
+		req->cb(req, rc);
+	}
+	if (signal) {
+		k_poll_signal(signal, rc);
+	}
+}
+
+static int flash_async_submit(struct flash_async_req *req, u8_t op)
+{
+	if (!req || !req->dev || !req->len ||
+	    (op == FLASH_ASYNC_OP_WRITE && !req->data)) {
+		return -EINVAL;
+	}
+
+	req->_op = op;
+	k_fifo_put(&flash_async_fifo, req);
+	return 0;
+}
+
+int flash_write_async(struct flash_async_req *req)
+{
+	return flash_async_submit(req, FLASH_ASYNC_OP_WRITE);
+}
+
+int flash_erase_async(struct flash_async_req *req)
+{
+	return flash_async_submit(req, FLASH_ASYNC_OP_ERASE);
+}
+
+static void flash_async_write(struct flash_async_req *req)
+{
+	int rc;
+#if CONFIG_FLASH_ASYNC_COALESCE_SIZE > 0
+	struct flash_async_req *next;
+	sys_slist_t batch;
+	sys_snode_t *node;
+	size_t len;
+
+	if (req->len > sizeof(flash_async_buf)) {
+		goto single;
+	}
+
+	/*
+	 * Gather the writes queued behind this one that continue it on the
+	 * same device, the driver is then called once for all of them.
+	 */
+	sys_slist_init(&batch);
+	sys_slist_append(&batch, &req->node);
+	memcpy(flash_async_buf, req->data, req->len);
+	len = req->len;
+
+	while (1) {
+		next = k_fifo_peek_head(&flash_async_fifo);
+		if (!next || next->_op != FLASH_ASYNC_OP_WRITE ||
+		    next->dev != req->dev ||
+		    next->offset != req->offset + len ||
+		    len + next->len > sizeof(flash_async_buf)) {
+			break;
+		}
+		next = k_fifo_get(&flash_async_fifo, K_NO_WAIT);
+		memcpy(flash_async_buf + len, next->data, next->len);
+		len += next->len;
+		sys_slist_append(&batch, &next->node);
+	}
+
+	if (sys_slist_peek_head(&batch) == sys_slist_peek_tail(&batch)) {
+		goto single;
+	}
+
+	flash_write_protection_set(req->dev, false);
+	rc = flash_write(req->dev, req->offset, flash_async_buf, len);
+	flash_write_protection_set(req->dev, true);
+
+	while ((node = sys_slist_get(&batch)) != NULL) {
+		flash_async_done(CONTAINER_OF(node, struct flash_async_req,
+					      node), rc);
+	}
+	return;
+
+single:
+#endif
+	flash_write_protection_set(req->dev, false);
+	rc = flash_write(req->dev, req->offset, req->data, req->len);
+	flash_write_protection_set(req->dev, true);
+	flash_async_done(req, rc);
+}
+
+static void flash_async_erase(struct flash_async_req *req)
+{
+	off_t offset = req->offset;
+	size_t len = req->len;
+	int rc;
+#if defined(CONFIG_FLASH_PAGE_LAYOUT)
+	struct flash_pages_info info;
+
+	/*
+	 * Erase page by page and let other threads in between, so that their
+	 * flash reads do not wait for the whole erase.
+	 */
+	rc = flash_get_page_info_by_offs(req->dev, offset, &info);
+	if (rc == 0 && info.start_offset == offset) {
+		while (len) {
+			rc = flash_get_page_info_by_offs(req->dev, offset,
+							 &info);
+			if (rc || info.size > len) {
+				break;
+			}
+			flash_write_protection_set(req->dev, false);
+			rc = flash_erase(req->dev, offset, info.size);
+			flash_write_protection_set(req->dev, true);
+			if (rc) {
+				break;
+			}
+			offset += info.size;
+			len -= info.size;
+			k_yield();
+		}
+		if (!len || rc) {
+			flash_async_done(req, rc);
+			return;
+		}
+	}
+#endif
+
+	/* the rest is not made of whole pages, leave the check to the driver */
+	flash_write_protection_set(req->dev, false);
+	rc = flash_erase(req->dev, offset, len);
+	flash_write_protection_set(req->dev, true);
+	flash_async_done(req, rc);
+}
+
+static void flash_async_thread(void *p1, void *p2, void *p3)
+{
+	struct flash_async_req *req;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		req = k_fifo_get(&flash_async_fifo, K_FOREVER);
+		if (req->_op == FLASH_ASYNC_OP_WRITE) {
+			flash_async_write(req);
+		} else {
+			flash_async_erase(req);
+		}
+	}
+}
+
+K_THREAD_DEFINE(flash_async_tid, CONFIG_FLASH_ASYNC_STACK_SIZE,
+		flash_async_thread, NULL, NULL, NULL,
+		CONFIG_FLASH_ASYNC_THREAD_PRIO, 0, K_NO_WAIT);
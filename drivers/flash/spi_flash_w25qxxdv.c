@@ -10,6 +10,7 @@
 #include <spi.h>
 #include <init.h>
 #include <string.h>
+#include <misc/byteorder.h>
 #include "spi_flash_w25qxxdv_defs.h"
 #include "spi_flash_w25qxxdv.h"
 #include "flash_priv.h"
@@ -18,7 +19,7 @@ static int spi_flash_wb_access(struct spi_flash_data *ctx,
 			       u8_t cmd, bool addressed, off_t offset,
 			       void *data, size_t length, bool write)
 {
-	u8_t access[4];
+	u8_t access[5];
 	struct spi_buf buf[2] = {
 		{
 			.buf = access
@@ -40,6 +41,13 @@ static int spi_flash_wb_access(struct spi_flash_data *ctx,
 		access[3] = (u8_t) offset;
 
 		buf[0].len = 4;
+
+		/* fast read and SFDP read are followed by one dummy byte */
+		if (cmd == W25QXXDV_CMD_FASTREAD ||
+		    cmd == W25QXXDV_CMD_RDSFDP) {
+			access[4] = 0;
+			buf[0].len = 5;
+		}
 	} else {
 		buf[0].len = 1;
 	}
@@ -80,6 +88,50 @@ static inline int spi_flash_wb_id(struct device *dev)
 	return 0;
 }
 
+/*
+ * Read the flash density from the JEDEC basic flash parameter table, the
+ * configured size is kept if the part has no usable SFDP.
+ */
+static void spi_flash_wb_sfdp(struct device *dev)
+{
+	struct spi_flash_data *const driver_data = dev->driver_data;
+	u8_t hdr[W25QXXDV_SFDP_HDR_LEN];
+	u8_t bfpt[8];
+	u32_t density;
+
+	/* SFDP header, directly followed by the first parameter header */
+	if (spi_flash_wb_access(driver_data, W25QXXDV_CMD_RDSFDP, true, 0,
+				hdr, sizeof(hdr), false) != 0 ||
+	    sys_get_le32(hdr) != W25QXXDV_SFDP_SIGNATURE) {
+		return;
+	}
+
+	if (spi_flash_wb_access(driver_data, W25QXXDV_CMD_RDSFDP, true,
+				W25QXXDV_SFDP_HDR_LEN, hdr, sizeof(hdr),
+				false) != 0) {
+		return;
+	}
+
+	/* table pointer is 24 bits at byte 4 of the parameter header */
+	if (spi_flash_wb_access(driver_data, W25QXXDV_CMD_RDSFDP, true,
+				sys_get_le32(&hdr[4]) & 0xFFFFFF, bfpt,
+				sizeof(bfpt), false) != 0) {
+		return;
+	}
+
+	/* second DWORD of the table holds the density in bits */
+	density = sys_get_le32(&bfpt[4]);
+	if (density & W25QXXDV_SFDP_DENSITY_EXP_BIT) {
+		density &= ~W25QXXDV_SFDP_DENSITY_EXP_BIT;
+		if (density < 3 || density > 34) {
+			return;
+		}
+		driver_data->size = 1U << (density - 3);
+	} else if (density != 0xFFFFFFFF) {
+		driver_data->size = (density >> 3) + 1;
+	}
+}
+
 static u8_t spi_flash_wb_reg_read(struct device *dev, u8_t reg)
 {
 	struct spi_flash_data *const driver_data = dev->driver_data;
@@ -127,7 +179,7 @@ static int spi_flash_wb_read(struct device *dev, off_t offset, void *data,
 
 	wait_for_flash_idle(dev);
 
-	ret = spi_flash_wb_access(driver_data, W25QXXDV_CMD_READ,
+	ret = spi_flash_wb_access(driver_data, W25QXXDV_CMD_FASTREAD,
 				  true, offset, data, len, false);
 
 	k_sem_give(&driver_data->sem);
@@ -139,6 +191,7 @@ static int spi_flash_wb_write(struct device *dev, off_t offset,
 			      const void *data, size_t len)
 {
 	struct spi_flash_data *const driver_data = dev->driver_data;
+	size_t chunk;
 	u8_t reg;
 	int ret;
 
@@ -160,10 +213,30 @@ static int spi_flash_wb_write(struct device *dev, off_t offset,
 
 	/* Assume write protection has been disabled. Note that w25qxxdv
 	 * flash automatically turns on write protection at the completion
-	 * of each write or erase transaction.
+	 * of each write or erase transaction, it is turned off again for
+	 * every page after the first one.
 	 */
-	ret = spi_flash_wb_access(driver_data, W25QXXDV_CMD_PP,
-				  true, offset, (void *)data, len, true);
+	while (1) {
+		/* a page program wraps around at the end of the page */
+		chunk = min(len, W25QXXDV_PAGE_SIZE -
+			    (offset & (W25QXXDV_PAGE_SIZE - 1)));
+
+		ret = spi_flash_wb_access(driver_data, W25QXXDV_CMD_PP,
+					  true, offset, (void *)data, chunk,
+					  true);
+		len -= chunk;
+		if (ret != 0 || !len) {
+			break;
+		}
+		offset += chunk;
+		data = (const u8_t *)data + chunk;
+
+		wait_for_flash_idle(dev);
+		ret = spi_flash_wb_reg_write(dev, W25QXXDV_CMD_WREN);
+		if (ret != 0) {
+			break;
+		}
+	}
 
 	k_sem_give(&driver_data->sem);
 
@@ -211,23 +284,23 @@ static inline int spi_flash_wb_erase_internal(struct device *dev,
 
 	wait_for_flash_idle(dev);
 
-	switch (size) {
-	case W25QXXDV_SECTOR_SIZE:
-		erase_opcode = W25QXXDV_CMD_SE;
-		break;
-	case W25QXXDV_BLOCK32K_SIZE:
-		erase_opcode = W25QXXDV_CMD_BE32K;
-		break;
-	case W25QXXDV_BLOCK_SIZE:
-		erase_opcode = W25QXXDV_CMD_BE;
-		break;
-	case CONFIG_SPI_FLASH_W25QXXDV_FLASH_SIZE:
+	if (size == driver_data->size) {
 		erase_opcode = W25QXXDV_CMD_CE;
 		need_offset = false;
-		break;
-	default:
-		return -EIO;
-
+	} else {
+		switch (size) {
+		case W25QXXDV_SECTOR_SIZE:
+			erase_opcode = W25QXXDV_CMD_SE;
+			break;
+		case W25QXXDV_BLOCK32K_SIZE:
+			erase_opcode = W25QXXDV_CMD_BE32K;
+			break;
+		case W25QXXDV_BLOCK_SIZE:
+			erase_opcode = W25QXXDV_CMD_BE;
+			break;
+		default:
+			return -EIO;
+		}
 	}
 
 	/* Assume write protection has been disabled. Note that w25qxxdv
@@ -247,7 +320,7 @@ static int spi_flash_wb_erase(struct device *dev, off_t offset, size_t size)
 	u8_t reg;
 
 	if ((offset < 0) || ((offset & W25QXXDV_SECTOR_MASK) != 0) ||
-	    ((size + offset) > CONFIG_SPI_FLASH_W25QXXDV_FLASH_SIZE) ||
+	    ((size + offset) > driver_data->size) ||
 	    ((size & W25QXXDV_SECTOR_MASK) != 0)) {
 		return -ENODEV;
 	}
@@ -262,12 +335,16 @@ static int spi_flash_wb_erase(struct device *dev, off_t offset, size_t size)
 	}
 
 	while ((size_remaining >= W25QXXDV_SECTOR_SIZE) && (ret == 0)) {
-		if (size_remaining == CONFIG_SPI_FLASH_W25QXXDV_FLASH_SIZE) {
+		if (size_remaining == driver_data->size) {
 			ret = spi_flash_wb_erase_internal(dev, offset, size);
 			break;
 		}
 
-		if (size_remaining >= W25QXXDV_BLOCK_SIZE) {
+		/* a block erase is only used on a block boundary, it would
+		 * erase data before new_offset otherwise
+		 */
+		if ((size_remaining >= W25QXXDV_BLOCK_SIZE) &&
+		    !(new_offset & (W25QXXDV_BLOCK_SIZE - 1))) {
 			ret = spi_flash_wb_erase_internal(dev, new_offset,
 							  W25QXXDV_BLOCK_SIZE);
 			new_offset += W25QXXDV_BLOCK_SIZE;
@@ -275,7 +352,8 @@ static int spi_flash_wb_erase(struct device *dev, off_t offset, size_t size)
 			continue;
 		}
 
-		if (size_remaining >= W25QXXDV_BLOCK32K_SIZE) {
+		if ((size_remaining >= W25QXXDV_BLOCK32K_SIZE) &&
+		    !(new_offset & (W25QXXDV_BLOCK32K_SIZE - 1))) {
 			ret = spi_flash_wb_erase_internal(dev, new_offset,
 							  W25QXXDV_BLOCK32K_SIZE);
 			new_offset += W25QXXDV_BLOCK32K_SIZE;
@@ -312,12 +390,14 @@ static const struct flash_driver_api spi_flash_api = {
 static int spi_flash_wb_configure(struct device *dev)
 {
 	struct spi_flash_data *data = dev->driver_data;
+	int ret;
 
 	data->spi = device_get_binding(CONFIG_SPI_FLASH_W25QXXDV_SPI_NAME);
 	if (!data->spi) {
 		return -EINVAL;
 	}
 
+	data->size = CONFIG_SPI_FLASH_W25QXXDV_FLASH_SIZE;
 	data->spi_cfg.frequency = CONFIG_SPI_FLASH_W25QXXDV_SPI_FREQ_0;
 	data->spi_cfg.operation = SPI_WORD_SET(8);
 	data->spi_cfg.slave = CONFIG_SPI_FLASH_W25QXXDV_SPI_SLAVE;
@@ -335,7 +415,12 @@ static int spi_flash_wb_configure(struct device *dev)
 	data->spi_cfg.cs = &data->cs_ctrl;
 #endif /* CONFIG_SPI_FLASH_W25QXXDV_GPIO_SPI_CS */
 
-	return spi_flash_wb_id(dev);
+	ret = spi_flash_wb_id(dev);
+	if (ret == 0) {
+		spi_flash_wb_sfdp(dev);
+	}
+
+	return ret;
 }
 
 static int spi_flash_init(struct device *dev)
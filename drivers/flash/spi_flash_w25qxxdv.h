@@ -21,6 +21,7 @@ struct spi_flash_data {
 #endif /* CONFIG_SPI_FLASH_W25QXXDV_GPIO_SPI_CS */
 	struct spi_config spi_cfg;
 	struct k_sem sem;
+	u32_t size; /* flash capacity in bytes */
 };
 
 
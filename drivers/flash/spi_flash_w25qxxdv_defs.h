@@ -53,6 +53,14 @@
 #define W25QXXDV_SECR_EFAIL_BIT  (0x1 << 6)
 #define W25QXXDV_SECR_PFAIL_BIT  (0x1 << 5)
 
+/* program page size, a page program wraps around within a page */
+#define W25QXXDV_PAGE_SIZE       (0x100)
+
+/* SFDP, JEDEC JESD216 */
+#define W25QXXDV_SFDP_SIGNATURE  (0x50444653) /* "SFDP" */
+#define W25QXXDV_SFDP_HDR_LEN    (8)
+#define W25QXXDV_SFDP_DENSITY_EXP_BIT (0x1 << 31)
+
 /* supported erase size */
 #define W25QXXDV_SECTOR_SIZE     (0x1000)
 #define W25QXXDV_BLOCK32K_SIZE   (0x8000)
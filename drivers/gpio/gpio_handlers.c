@@ -46,3 +46,10 @@ Z_SYSCALL_HANDLER(gpio_get_pending_int, port)
 	Z_OOPS(Z_SYSCALL_DRIVER_GPIO(port, get_pending_int));
 	return _impl_gpio_get_pending_int((struct device *)port);
 }
+
+Z_SYSCALL_HANDLER(gpio_port_update, port, set, clear, toggle)
+{
+	Z_OOPS(Z_SYSCALL_DRIVER_GPIO(port, port_update));
+	return _impl_gpio_port_update((struct device *)port, set, clear,
+				      toggle);
+}
@@ -152,6 +152,20 @@ static int gpio_mcux_write(struct device *dev,
 	return 0;
 }
 
+static int gpio_mcux_port_update(struct device *dev, u32_t set,
+				 u32_t clear, u32_t toggle)
+{
+	const struct gpio_mcux_config *config = dev->config->config_info;
+	GPIO_Type *gpio_base = config->gpio_base;
+
+	/* Writing zeros leaves the data output of the pins unchanged */
+	gpio_base->PCOR = clear & ~set;
+	gpio_base->PSOR = set;
+	gpio_base->PTOR = toggle;
+
+	return 0;
+}
+
 static int gpio_mcux_read(struct device *dev,
 			  int access_op, u32_t pin, u32_t *value)
 {
@@ -231,6 +245,7 @@ static const struct gpio_driver_api gpio_mcux_driver_api = {
 	.manage_callback = gpio_mcux_manage_callback,
 	.enable_callback = gpio_mcux_enable_callback,
 	.disable_callback = gpio_mcux_disable_callback,
+	.port_update = gpio_mcux_port_update,
 };
 
 #ifdef CONFIG_GPIO_MCUX_PORTA
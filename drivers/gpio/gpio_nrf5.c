@@ -301,6 +301,24 @@ static int gpio_nrf5_write(struct device *dev,
 	return 0;
 }
 
+static int gpio_nrf5_port_update(struct device *dev, u32_t set,
+				 u32_t clear, u32_t toggle)
+{
+	volatile struct _gpio *gpio = GPIO_STRUCT(dev);
+	unsigned int key;
+
+	gpio->OUTCLR = clear & ~set;
+	gpio->OUTSET = set;
+
+	if (toggle) {
+		key = irq_lock();
+		gpio->OUT ^= toggle;
+		irq_unlock(key);
+	}
+
+	return 0;
+}
+
 static int gpio_nrf5_manage_callback(struct device *dev,
 				    struct gpio_callback *callback, bool set)
 {
@@ -446,6 +464,7 @@ static const struct gpio_driver_api gpio_nrf5_drv_api_funcs = {
 	.manage_callback = gpio_nrf5_manage_callback,
 	.enable_callback = gpio_nrf5_enable_callback,
 	.disable_callback = gpio_nrf5_disable_callback,
+	.port_update = gpio_nrf5_port_update,
 };
 
 static int gpio_nrf5_init(struct device *dev)
@@ -104,6 +104,28 @@ static int gpio_stm32_write(struct device *dev, int access_op,
 	return stm32_gpio_set(cfg->base, pin, value);
 }
 
+/**
+ * @brief Update the output of several pins of the port
+ */
+static int gpio_stm32_port_update(struct device *dev, u32_t set,
+				  u32_t clear, u32_t toggle)
+{
+	const struct gpio_stm32_config *cfg = dev->config->config_info;
+	GPIO_TypeDef *gpio = (GPIO_TypeDef *)cfg->base;
+	unsigned int key;
+
+	/* atomic set and reset, set taking precedence */
+	gpio->BSRR = ((clear & 0xffff) << 16) | (set & 0xffff);
+
+	if (toggle) {
+		key = irq_lock();
+		gpio->ODR ^= toggle & 0xffff;
+		irq_unlock(key);
+	}
+
+	return 0;
+}
+
 /**
  * @brief Read the pin or port status
  */
@@ -164,6 +186,7 @@ static const struct gpio_driver_api gpio_stm32_driver = {
 	.config = gpio_stm32_config,
 	.write = gpio_stm32_write,
 	.read = gpio_stm32_read,
+	.port_update = gpio_stm32_port_update,
 	.manage_callback = gpio_stm32_manage_callback,
 	.enable_callback = gpio_stm32_enable_callback,
 	.disable_callback = gpio_stm32_disable_callback,
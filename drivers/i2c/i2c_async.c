@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <kernel.h>
+#include <i2c.h>
+
+static K_FIFO_DEFINE(i2c_async_fifo);
+
+int i2c_transfer_async(struct i2c_async_req *req)
+{
+	if (!req || !req->dev || !req->msgs || !req->num_msgs) {
+		return -EINVAL;
+	}
+
+	k_fifo_put(&i2c_async_fifo, req);
+	return 0;
+}
+
+static void i2c_async_thread(void *p1, void *p2, void *p3)
+{
+	struct i2c_async_req *req;
+	struct k_poll_signal *signal;
+	int rc;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		req = k_fifo_get(&i2c_async_fifo, K_FOREVER);
+		rc = i2c_transfer(req->dev, req->msgs, req->num_msgs,
+				  req->addr);
+
+		/* req may be reused by the caller from the callback on */
+		signal = req->signal;
+		if (req->cb) {
+			req->cb(req, rc);
+		}
+		if (signal) {
+			k_poll_signal(signal, rc);
+		}
+	}
+}
+
+K_THREAD_DEFINE(i2c_async_tid, CONFIG_I2C_ASYNC_STACK_SIZE,
+		i2c_async_thread, NULL, NULL, NULL,
+		CONFIG_I2C_ASYNC_THREAD_PRIO, 0, K_NO_WAIT);
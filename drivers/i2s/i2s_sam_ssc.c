@@ -12,9 +12,11 @@
  *   be configured independently. If RX and TX path are set to different bit
  *   clock frequencies the latter setting will quietly override the former.
  *   We should return an error in such a case.
- * - DMA is used in simple single block transfer mode and as such is not able
- *   to handle high speed data. To support higher transfer speeds the DMA
- *   linked list mode should be used.
+ * - Memory blocks are chained without a gap by a DMA linked list of two
+ *   blocks only if they have the configured block size. A TX block of a
+ *   different size is sent with a separate transfer, after a gap.
+ * - With chained blocks the STOP trigger lets the block queued to the DMA
+ *   after the current one be sent as well.
  */
 
 #include <errno.h>
@@ -81,7 +83,16 @@ struct stream {
 	struct i2s_config cfg;
 	struct ring_buf mem_block_queue;
 	void *mem_block;
+	/* block chained after mem_block in the DMA linked list */
+	void *mem_block_next;
+	bool chained;
 	bool last_block;
+	u32_t errors;
+	/* timed start: SSC_CR value written at start_cycle */
+	struct k_timer start_timer;
+	u32_t start_cycle;
+	Ssc *start_ssc;
+	u32_t start_cr;
 	int (*stream_start)(struct stream *, Ssc *const, struct device *);
 	void (*stream_disable)(struct stream *, Ssc *const, struct device *);
 	void (*queue_drop)(struct stream *);
@@ -134,6 +145,36 @@ static int queue_get(struct ring_buf *rb, void **mem_block, size_t *size)
 	return 0;
 }
 
+/*
+ * Get data from the queue if the next block holds size bytes
+ */
+static int queue_get_sized(struct ring_buf *rb, void **mem_block, size_t size)
+{
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (rb->tail == rb->head || rb->buf[rb->tail].size != size) {
+		irq_unlock(key);
+		return -ENOMEM;
+	}
+
+	*mem_block = rb->buf[rb->tail].mem_block;
+	MODULO_INC(rb->tail, rb->len);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+/*
+ * Number of blocks in the queue
+ */
+static u32_t queue_count(struct ring_buf *rb)
+{
+	return (rb->head + rb->len - rb->tail) % rb->len;
+}
+
 /*
  * Put data in the queue
  */
@@ -162,19 +203,37 @@ static int queue_put(struct ring_buf *rb, void *mem_block, size_t size)
 	return 0;
 }
 
+/*
+ * With next_mem_block set the transfer is a cyclic linked list of two blocks,
+ * the memory side of each one is replaced with dma_reload() once transferred.
+ */
 static int start_dma(struct device *dev_dma, u32_t channel,
 		     struct dma_config *cfg, void *src, void *dst,
-		     u32_t blk_size)
+		     u32_t blk_size, void *next_mem_block)
 {
-	struct dma_block_config blk_cfg;
+	struct dma_block_config blk_cfg[2];
 	int ret;
 
-	memset(&blk_cfg, 0, sizeof(blk_cfg));
-	blk_cfg.block_size = blk_size;
-	blk_cfg.source_address = (u32_t)src;
-	blk_cfg.dest_address = (u32_t)dst;
+	memset(blk_cfg, 0, sizeof(blk_cfg));
+	blk_cfg[0].block_size = blk_size;
+	blk_cfg[0].source_address = (u32_t)src;
+	blk_cfg[0].dest_address = (u32_t)dst;
+
+	cfg->head_block = blk_cfg;
+	cfg->block_count = 1;
+	cfg->cyclic = 0;
 
-	cfg->head_block = &blk_cfg;
+	if (next_mem_block) {
+		blk_cfg[1] = blk_cfg[0];
+		if (cfg->channel_direction == PERIPHERAL_TO_MEMORY) {
+			blk_cfg[1].dest_address = (u32_t)next_mem_block;
+		} else {
+			blk_cfg[1].source_address = (u32_t)next_mem_block;
+		}
+		blk_cfg[0].next_block = &blk_cfg[1];
+		cfg->block_count = 2;
+		cfg->cyclic = 1;
+	}
 
 	ret = dma_config(dev_dma, channel, cfg);
 	if (ret < 0) {
@@ -210,6 +269,7 @@ static void dma_rx_callback(struct device *dev_dma, u32_t channel, int status)
 	ret = queue_put(&stream->mem_block_queue, stream->mem_block,
 			stream->cfg.block_size);
 	if (ret < 0) {
+		stream->errors++;
 		stream->state = I2S_STATE_ERROR;
 		goto rx_disable;
 	}
@@ -222,17 +282,45 @@ static void dma_rx_callback(struct device *dev_dma, u32_t channel, int status)
 		goto rx_disable;
 	}
 
+	if (stream->chained) {
+		/* The DMA goes on with the chained block, replace the one
+		 * just received before the DMA wraps around to it.
+		 */
+		stream->mem_block = stream->mem_block_next;
+		stream->mem_block_next = NULL;
+
+		ret = k_mem_slab_alloc(stream->cfg.mem_slab,
+				       &stream->mem_block_next, K_NO_WAIT);
+		if (ret < 0) {
+			stream->errors++;
+			stream->state = I2S_STATE_ERROR;
+			goto rx_disable;
+		}
+
+		ret = dma_reload(dev_data->dev_dma, stream->dma_channel,
+				 (u32_t)&(ssc->SSC_RHR),
+				 (u32_t)stream->mem_block_next,
+				 stream->cfg.block_size);
+		if (ret < 0) {
+			SYS_LOG_DBG("Failed to chain RX DMA transfer: %d", ret);
+			goto rx_disable;
+		}
+
+		return;
+	}
+
 	/* Prepare to receive the next data block */
 	ret = k_mem_slab_alloc(stream->cfg.mem_slab, &stream->mem_block,
 			       K_NO_WAIT);
 	if (ret < 0) {
+		stream->errors++;
 		stream->state = I2S_STATE_ERROR;
 		goto rx_disable;
 	}
 
 	ret = start_dma(dev_data->dev_dma, stream->dma_channel, &stream->dma_cfg,
 			(void *)&(ssc->SSC_RHR), stream->mem_block,
-			stream->cfg.block_size);
+			stream->cfg.block_size, NULL);
 	if (ret < 0) {
 		SYS_LOG_DBG("Failed to start RX DMA transfer: %d", ret);
 		goto rx_disable;
@@ -244,6 +332,40 @@ rx_disable:
 	rx_stream_disable(stream, ssc, dev_data->dev_dma);
 }
 
+/*
+ * Start the DMA with the block at the head of the TX queue, chained with the
+ * following one if both have the configured size.
+ */
+static int tx_start_dma(struct stream *stream, Ssc *const ssc,
+			struct device *dev_dma)
+{
+	size_t mem_block_size;
+	int ret;
+
+	ret = queue_get(&stream->mem_block_queue, &stream->mem_block,
+			&mem_block_size);
+	if (ret < 0) {
+		return ret;
+	}
+	k_sem_give(&stream->sem);
+
+	/* Assure cache coherency before DMA read operation */
+	DCACHE_CLEAN(stream->mem_block, mem_block_size);
+
+	stream->mem_block_next = NULL;
+	if (mem_block_size == stream->cfg.block_size &&
+	    queue_get_sized(&stream->mem_block_queue, &stream->mem_block_next,
+			    mem_block_size) == 0) {
+		k_sem_give(&stream->sem);
+		DCACHE_CLEAN(stream->mem_block_next, mem_block_size);
+	}
+	stream->chained = stream->mem_block_next != NULL;
+
+	return start_dma(dev_dma, stream->dma_channel, &stream->dma_cfg,
+			 stream->mem_block, (void *)&(ssc->SSC_THR),
+			 mem_block_size, stream->mem_block_next);
+}
+
 /* This function is executed in the interrupt context */
 static void dma_tx_callback(struct device *dev_dma, u32_t channel, int status)
 {
@@ -252,7 +374,6 @@ static void dma_tx_callback(struct device *dev_dma, u32_t channel, int status)
 	struct i2s_sam_dev_data *const dev_data = DEV_DATA(dev);
 	Ssc *const ssc = dev_cfg->regs;
 	struct stream *stream = &dev_data->tx;
-	size_t mem_block_size;
 	int ret;
 
 	__ASSERT_NO_MSG(stream->mem_block != NULL);
@@ -267,32 +388,62 @@ static void dma_tx_callback(struct device *dev_dma, u32_t channel, int status)
 		goto tx_disable;
 	}
 
+	if (stream->chained) {
+		stream->mem_block = stream->mem_block_next;
+		stream->mem_block_next = NULL;
+	}
+
+	if (stream->mem_block) {
+		/* The DMA goes on with the chained block */
+		if (stream->last_block) {
+			return;
+		}
+
+		/* Replace the block just sent before the DMA wraps around
+		 * to it, if the next one can be chained.
+		 */
+		ret = queue_get_sized(&stream->mem_block_queue,
+				      &stream->mem_block_next,
+				      stream->cfg.block_size);
+		if (ret < 0) {
+			return;
+		}
+		k_sem_give(&stream->sem);
+
+		/* Assure cache coherency before DMA read operation */
+		DCACHE_CLEAN(stream->mem_block_next, stream->cfg.block_size);
+
+		ret = dma_reload(dev_data->dev_dma, stream->dma_channel,
+				 (u32_t)stream->mem_block_next,
+				 (u32_t)&(ssc->SSC_THR), stream->cfg.block_size);
+		if (ret < 0) {
+			SYS_LOG_DBG("Failed to chain TX DMA transfer: %d", ret);
+			goto tx_disable;
+		}
+
+		return;
+	}
+
 	/* Stop transmission if we were requested */
 	if (stream->last_block) {
 		stream->state = I2S_STATE_READY;
 		goto tx_disable;
 	}
 
+	/* Nothing was chained, a cyclic transfer has wrapped around */
+	dma_stop(dev_data->dev_dma, stream->dma_channel);
+
 	/* Prepare to send the next data block */
-	ret = queue_get(&stream->mem_block_queue, &stream->mem_block,
-			&mem_block_size);
-	if (ret < 0) {
+	ret = tx_start_dma(stream, ssc, dev_data->dev_dma);
+	if (ret == -ENOMEM) {
 		if (stream->state == I2S_STATE_STOPPING) {
 			stream->state = I2S_STATE_READY;
 		} else {
+			stream->errors++;
 			stream->state = I2S_STATE_ERROR;
 		}
 		goto tx_disable;
-	}
-	k_sem_give(&stream->sem);
-
-	/* Assure cache coherency before DMA read operation */
-	DCACHE_CLEAN(stream->mem_block, mem_block_size);
-
-	ret = start_dma(dev_data->dev_dma, stream->dma_channel, &stream->dma_cfg,
-			stream->mem_block, (void *)&(ssc->SSC_THR),
-			mem_block_size);
-	if (ret < 0) {
+	} else if (ret < 0) {
 		SYS_LOG_DBG("Failed to start TX DMA transfer: %d", ret);
 		goto tx_disable;
 	}
@@ -568,6 +719,7 @@ static int i2s_sam_configure(struct device *dev, enum i2s_dir dir,
 	}
 
 	memcpy(&stream->cfg, i2s_cfg, sizeof(struct i2s_config));
+	stream->errors = 0;
 
 	bit_clk_freq = i2s_cfg->frame_clk_freq * word_size_bits * num_words;
 	ret = bit_clock_set(ssc, bit_clk_freq);
@@ -606,6 +758,15 @@ static int rx_stream_start(struct stream *stream, Ssc *const ssc,
 		return ret;
 	}
 
+	/* A second block lets the DMA chain them, else blocks are received
+	 * with a transfer each.
+	 */
+	if (k_mem_slab_alloc(stream->cfg.mem_slab, &stream->mem_block_next,
+			     K_NO_WAIT) < 0) {
+		stream->mem_block_next = NULL;
+	}
+	stream->chained = stream->mem_block_next != NULL;
+
 	/* Workaround for a hardware bug: DMA engine will read first data
 	 * item even if SSC_SR.RXEN (Receive Enable) is not set. An extra read
 	 * before enabling DMA engine sets hardware FSM in the correct state.
@@ -614,7 +775,7 @@ static int rx_stream_start(struct stream *stream, Ssc *const ssc,
 
 	ret = start_dma(dev_dma, stream->dma_channel, &stream->dma_cfg,
 			(void *)&(ssc->SSC_RHR), stream->mem_block,
-			stream->cfg.block_size);
+			stream->cfg.block_size, stream->mem_block_next);
 	if (ret < 0) {
 		SYS_LOG_ERR("Failed to start RX DMA transfer: %d", ret);
 		return ret;
@@ -625,24 +786,14 @@ static int rx_stream_start(struct stream *stream, Ssc *const ssc,
 
 	ssc->SSC_IER = SSC_IER_OVRUN;
 
-	ssc->SSC_CR = SSC_CR_RXEN;
-
 	return 0;
 }
 
 static int tx_stream_start(struct stream *stream, Ssc *const ssc,
 			  struct device *dev_dma)
 {
-	size_t mem_block_size;
 	int ret;
 
-	ret = queue_get(&stream->mem_block_queue, &stream->mem_block,
-			&mem_block_size);
-	if (ret < 0) {
-		return ret;
-	}
-	k_sem_give(&stream->sem);
-
 	/* Workaround for a hardware bug: DMA engine will transfer first data
 	 * item even if SSC_SR.TXEN (Transmit Enable) is not set. An extra write
 	 * before enabling DMA engine sets hardware FSM in the correct state.
@@ -650,13 +801,10 @@ static int tx_stream_start(struct stream *stream, Ssc *const ssc,
 	 */
 	ssc->SSC_THR = 0;
 
-	/* Assure cache coherency before DMA read operation */
-	DCACHE_CLEAN(stream->mem_block, mem_block_size);
-
-	ret = start_dma(dev_dma, stream->dma_channel, &stream->dma_cfg,
-			stream->mem_block, (void *)&(ssc->SSC_THR),
-			mem_block_size);
-	if (ret < 0) {
+	ret = tx_start_dma(stream, ssc, dev_dma);
+	if (ret == -ENOMEM) {
+		return ret;
+	} else if (ret < 0) {
 		SYS_LOG_ERR("Failed to start TX DMA transfer: %d", ret);
 		return ret;
 	}
@@ -666,8 +814,6 @@ static int tx_stream_start(struct stream *stream, Ssc *const ssc,
 
 	ssc->SSC_IER = SSC_IER_TXEMPTY;
 
-	ssc->SSC_CR = SSC_CR_TXEN;
-
 	return 0;
 }
 
@@ -681,6 +827,10 @@ static void rx_stream_disable(struct stream *stream, Ssc *const ssc,
 		k_mem_slab_free(stream->cfg.mem_slab, &stream->mem_block);
 		stream->mem_block = NULL;
 	}
+	if (stream->mem_block_next != NULL) {
+		k_mem_slab_free(stream->cfg.mem_slab, &stream->mem_block_next);
+		stream->mem_block_next = NULL;
+	}
 }
 
 static void tx_stream_disable(struct stream *stream, Ssc *const ssc,
@@ -693,6 +843,10 @@ static void tx_stream_disable(struct stream *stream, Ssc *const ssc,
 		k_mem_slab_free(stream->cfg.mem_slab, &stream->mem_block);
 		stream->mem_block = NULL;
 	}
+	if (stream->mem_block_next != NULL) {
+		k_mem_slab_free(stream->cfg.mem_slab, &stream->mem_block_next);
+		stream->mem_block_next = NULL;
+	}
 }
 
 static void rx_queue_drop(struct stream *stream)
@@ -723,6 +877,115 @@ static void tx_queue_drop(struct stream *stream)
 	}
 }
 
+/* Enable the interface at start_cycle. The timer expires in the last
+ * ticks before it, interrupts are only locked to check the time and
+ * write the register, so that nothing comes in between.
+ */
+static void stream_start_expiry(struct k_timer *timer)
+{
+	struct stream *stream = CONTAINER_OF(timer, struct stream,
+					     start_timer);
+	unsigned int key;
+
+	for (;;) {
+		key = irq_lock();
+		if ((s32_t)(stream->start_cycle - k_cycle_get_32()) <= 0) {
+			stream->start_ssc->SSC_CR = stream->start_cr;
+			irq_unlock(key);
+			return;
+		}
+		irq_unlock(key);
+	}
+}
+
+static int i2s_sam_start(struct device *dev, enum i2s_dir dir,
+			 const u32_t *cycle)
+{
+	const struct i2s_sam_dev_cfg *const dev_cfg = DEV_CFG(dev);
+	struct i2s_sam_dev_data *const dev_data = DEV_DATA(dev);
+	Ssc *const ssc = dev_cfg->regs;
+	struct stream *stream;
+	u32_t ticks;
+	int ret;
+
+	if (dir == I2S_DIR_RX) {
+		stream = &dev_data->rx;
+	} else if (dir == I2S_DIR_TX) {
+		stream = &dev_data->tx;
+	} else {
+		SYS_LOG_ERR("Either RX or TX direction must be selected");
+		return -EINVAL;
+	}
+
+	if (stream->state != I2S_STATE_READY) {
+		SYS_LOG_DBG("START trigger: invalid state");
+		return -EIO;
+	}
+
+	if (cycle && (s32_t)(*cycle - k_cycle_get_32()) < 0) {
+		return -ETIME;
+	}
+
+	__ASSERT_NO_MSG(stream->mem_block == NULL);
+
+	ret = stream->stream_start(stream, ssc, dev_data->dev_dma);
+	if (ret < 0) {
+		SYS_LOG_DBG("START trigger failed %d", ret);
+		return ret;
+	}
+
+	stream->state = I2S_STATE_RUNNING;
+	stream->last_block = false;
+
+	if (!cycle) {
+		ssc->SSC_CR = (dir == I2S_DIR_RX) ? SSC_CR_RXEN : SSC_CR_TXEN;
+		return 0;
+	}
+
+	/* The DMA is ready and waits for the interface. A timer of n ticks
+	 * expires between n - 1 and n ticks from now: arm it for the whole
+	 * ticks left, and wait for the rest of the time in its handler.
+	 */
+	stream->start_cycle = *cycle;
+	stream->start_ssc = ssc;
+	stream->start_cr = (dir == I2S_DIR_RX) ? SSC_CR_RXEN : SSC_CR_TXEN;
+
+	ticks = (*cycle - k_cycle_get_32()) / sys_clock_hw_cycles_per_tick;
+	if (ticks) {
+		k_timer_start(&stream->start_timer, __ticks_to_ms(ticks), 0);
+	} else {
+		stream_start_expiry(&stream->start_timer);
+	}
+
+	return 0;
+}
+
+static int i2s_sam_start_at(struct device *dev, enum i2s_dir dir,
+			    u32_t cycle)
+{
+	return i2s_sam_start(dev, dir, &cycle);
+}
+
+static int i2s_sam_stats_get(struct device *dev, enum i2s_dir dir,
+			     struct i2s_stats *stats)
+{
+	struct i2s_sam_dev_data *const dev_data = DEV_DATA(dev);
+	struct stream *stream;
+
+	if (dir == I2S_DIR_RX) {
+		stream = &dev_data->rx;
+	} else if (dir == I2S_DIR_TX) {
+		stream = &dev_data->tx;
+	} else {
+		return -EINVAL;
+	}
+
+	stats->queued = queue_count(&stream->mem_block_queue);
+	stats->errors = stream->errors;
+
+	return 0;
+}
+
 static int i2s_sam_trigger(struct device *dev, enum i2s_dir dir,
 			   enum i2s_trigger_cmd cmd)
 {
@@ -731,7 +994,6 @@ static int i2s_sam_trigger(struct device *dev, enum i2s_dir dir,
 	Ssc *const ssc = dev_cfg->regs;
 	struct stream *stream;
 	unsigned int key;
-	int ret;
 
 	if (dir == I2S_DIR_RX) {
 		stream = &dev_data->rx;
@@ -744,22 +1006,7 @@ static int i2s_sam_trigger(struct device *dev, enum i2s_dir dir,
 
 	switch (cmd) {
 	case I2S_TRIGGER_START:
-		if (stream->state != I2S_STATE_READY) {
-			SYS_LOG_DBG("START trigger: invalid state");
-			return -EIO;
-		}
-
-		__ASSERT_NO_MSG(stream->mem_block == NULL);
-
-		ret = stream->stream_start(stream, ssc, dev_data->dev_dma);
-		if (ret < 0) {
-			SYS_LOG_DBG("START trigger failed %d", ret);
-			return ret;
-		}
-
-		stream->state = I2S_STATE_RUNNING;
-		stream->last_block = false;
-		break;
+		return i2s_sam_start(dev, dir, NULL);
 
 	case I2S_TRIGGER_STOP:
 		key = irq_lock();
@@ -789,6 +1036,7 @@ static int i2s_sam_trigger(struct device *dev, enum i2s_dir dir,
 			SYS_LOG_DBG("DROP trigger: invalid state");
 			return -EIO;
 		}
+		k_timer_stop(&stream->start_timer);
 		stream->stream_disable(stream, ssc, dev_data->dev_dma);
 		stream->queue_drop(stream);
 		stream->state = I2S_STATE_READY;
@@ -873,6 +1121,7 @@ static void i2s_sam_isr(void *arg)
 	/* Check for RX buffer overrun */
 	if (isr_status & SSC_SR_OVRUN) {
 		dev_data->rx.state = I2S_STATE_ERROR;
+		dev_data->rx.errors++;
 		/* Disable interrupt */
 		ssc->SSC_IDR = SSC_IDR_OVRUN;
 		SYS_LOG_DBG("RX buffer overrun error");
@@ -880,6 +1129,7 @@ static void i2s_sam_isr(void *arg)
 	/* Check for TX buffer underrun */
 	if (isr_status & SSC_SR_TXEMPTY) {
 		dev_data->tx.state = I2S_STATE_ERROR;
+		dev_data->tx.errors++;
 		/* Disable interrupt */
 		ssc->SSC_IDR = SSC_IDR_TXEMPTY;
 		SYS_LOG_DBG("TX buffer underrun error");
@@ -900,6 +1150,9 @@ static int i2s_sam_initialize(struct device *dev)
 	k_sem_init(&dev_data->tx.sem, CONFIG_I2S_SAM_SSC_TX_BLOCK_COUNT,
 		   CONFIG_I2S_SAM_SSC_TX_BLOCK_COUNT);
 
+	k_timer_init(&dev_data->rx.start_timer, stream_start_expiry, NULL);
+	k_timer_init(&dev_data->tx.start_timer, stream_start_expiry, NULL);
+
 	dev_data->dev_dma = device_get_binding(CONFIG_I2S_SAM_SSC_DMA_NAME);
 	if (!dev_data->dev_dma) {
 		SYS_LOG_ERR("%s device not found", CONFIG_I2S_SAM_SSC_DMA_NAME);
@@ -928,6 +1181,8 @@ static const struct i2s_driver_api i2s_sam_driver_api = {
 	.read = i2s_sam_read,
 	.write = i2s_sam_write,
 	.trigger = i2s_sam_trigger,
+	.start_at = i2s_sam_start_at,
+	.stats_get = i2s_sam_stats_get,
 };
 
 /* I2S0 */
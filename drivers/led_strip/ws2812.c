@@ -36,8 +36,10 @@
 #define BLU_OFFSET            (8 * sizeof(u8_t) * CONFIG_WS2812_BLU_ORDER)
 #ifdef CONFIG_WS2812_HAS_WHITE_CHANNEL
 #define WHT_OFFSET            (8 * sizeof(u8_t) * CONFIG_WS2812_WHT_ORDER)
+#define PX_SIZE               32
 #else
 #define WHT_OFFSET            -1
+#define PX_SIZE               24
 #endif
 
 /*
@@ -47,22 +49,45 @@
  */
 #define RESET_NFRAMES ((size_t)ceiling_fraction(3 * SPI_FREQ, 4000000) + 1)
 
+/* Room for the SPI frames of the pixels shifted out in one transfer */
+#define DATA_SIZE             (CONFIG_WS2812_STRIP_BUF_PIXELS * PX_SIZE)
+
 struct ws2812_data {
 	struct device *spi;
 	struct spi_config config;
+	/* kept here as the SPI driver uses them until the transfer ends */
+	struct spi_buf tx_buf;
+	struct spi_buf_set tx;
+#if defined(CONFIG_WS2812_STRIP_ASYNC)
+	struct k_poll_signal done;
+	bool busy;
+#endif
+	u8_t buf[DATA_SIZE + RESET_NFRAMES];
 };
 
+/* SPI frames for each value of a nibble, most significant bit first */
+static u8_t nibble_frames[16][4];
+
+static void ws2812_init_frames(void)
+{
+	int i, j;
+
+	for (i = 0; i < 16; i++) {
+		for (j = 0; j < 4; j++) {
+			nibble_frames[i][j] = i & BIT(3 - j) ?
+					      ONE_FRAME : ZERO_FRAME;
+		}
+	}
+}
+
 /*
  * Convert a color channel's bits into a sequence of SPI frames (with
  * the proper pulse and inter-pulse widths) to shift out.
  */
 static inline void ws2812_serialize_color(u8_t buf[8], u8_t color)
 {
-	int i;
-
-	for (i = 0; i < 8; i++) {
-		buf[i] = color & BIT(7 - i) ? ONE_FRAME : ZERO_FRAME;
-	}
+	memcpy(buf, nibble_frames[color >> 4], 4);
+	memcpy(buf + 4, nibble_frames[color & 0x0f], 4);
 }
 
 /*
@@ -75,98 +100,140 @@ static size_t ws2812_serialize_pixel(u8_t px[32], struct led_rgb *pixel)
 	ws2812_serialize_color(px + BLU_OFFSET, pixel->b);
 	if (IS_ENABLED(CONFIG_WS2812_HAS_WHITE_CHANNEL)) {
 		ws2812_serialize_color(px + WHT_OFFSET, 0); /* unused */
-		return 32;
 	}
-	return 24;
+	return PX_SIZE;
+}
+
+/*
+ * Wait for the end of the previous update, which may still be shifted
+ * out in the background, before the buffer is reused.
+ */
+static int ws2812_wait(struct ws2812_data *data)
+{
+#if defined(CONFIG_WS2812_STRIP_ASYNC)
+	struct k_poll_event evt =
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SIGNAL,
+					 K_POLL_MODE_NOTIFY_ONLY,
+					 &data->done);
+	int rc;
+
+	if (!data->busy) {
+		return 0;
+	}
+
+	rc = k_poll(&evt, 1, K_FOREVER);
+	data->busy = false;
+	data->done.signaled = 0;
+
+	return rc ? rc : data->done.result;
+#else
+	return 0;
+#endif
 }
 
 /*
- * Latch current color values on strip and reset its state machines.
+ * Shift out the first len bytes of the buffer. The last transfer of an
+ * update is followed by the reset frames, which latch the colors on the
+ * strip and reset its state machines.
  */
-static int ws2812_reset_strip(struct ws2812_data *data)
+static int ws2812_send(struct ws2812_data *data, size_t len, bool last)
 {
-	u8_t reset_buf[RESET_NFRAMES];
-	const struct spi_buf reset = {
-		.buf = reset_buf,
-		.len = sizeof(reset_buf),
-	};
-	const struct spi_buf_set tx = {
-		.buffers = &reset,
-		.count = 1
-	};
-
-	memset(reset_buf, 0x00, sizeof(reset_buf));
-
-	return spi_write(data->spi, &data->config, &tx);
+	int rc;
+
+	data->tx_buf.buf = data->buf;
+	data->tx_buf.len = len;
+	data->tx.buffers = &data->tx_buf;
+	data->tx.count = 1;
+
+	if (!last) {
+		return spi_write(data->spi, &data->config, &data->tx);
+	}
+
+	memset(data->buf + len, 0x00, RESET_NFRAMES);
+	data->tx_buf.len += RESET_NFRAMES;
+
+#if defined(CONFIG_WS2812_STRIP_ASYNC)
+	rc = spi_write_async(data->spi, &data->config, &data->tx, &data->done);
+	data->busy = !rc;
+#else
+	rc = spi_write(data->spi, &data->config, &data->tx);
+#endif
+
+	return rc;
 }
 
 static int ws2812_strip_update_rgb(struct device *dev, struct led_rgb *pixels,
 				   size_t num_pixels)
 {
 	struct ws2812_data *drv_data = dev->driver_data;
-	struct spi_config *config = &drv_data->config;
-	u8_t px_buf[32]; /* 32 are needed when a white channel is present. */
-	struct spi_buf buf = {
-		.buf = px_buf,
-	};
-	const struct spi_buf_set tx = {
-		.buffers = &buf,
-		.count = 1
-	};
+	size_t len = 0;
 	size_t i;
 	int rc;
 
+	rc = ws2812_wait(drv_data);
+	if (rc) {
+		SYS_LOG_ERR("previous update failed: %d", rc);
+	}
+
 	for (i = 0; i < num_pixels; i++) {
-		buf.len = ws2812_serialize_pixel(px_buf, &pixels[i]);
-		rc = spi_write(drv_data->spi, config, &tx);
-		if (rc) {
-			/*
-			 * Latch anything we've shifted out first, to
-			 * call visual attention to the problematic
-			 * pixel.
-			 */
-			(void)ws2812_reset_strip(drv_data);
-			SYS_LOG_ERR("can't set pixel %u: %d", i, rc);
-			return rc;
+		if (len + PX_SIZE > DATA_SIZE) {
+			rc = ws2812_send(drv_data, len, false);
+			if (rc) {
+				/*
+				 * Latch anything we've shifted out first, to
+				 * call visual attention to the problematic
+				 * pixels.
+				 */
+				(void)ws2812_send(drv_data, 0, true);
+				SYS_LOG_ERR("can't set pixel %u: %d", i, rc);
+				return rc;
+			}
+
+			len = 0;
 		}
+
+		len += ws2812_serialize_pixel(drv_data->buf + len, &pixels[i]);
 	}
 
-	return ws2812_reset_strip(drv_data);
+	return ws2812_send(drv_data, len, true);
 }
 
 static int ws2812_strip_update_channels(struct device *dev, u8_t *channels,
 					size_t num_channels)
 {
 	struct ws2812_data *drv_data = dev->driver_data;
-	struct spi_config *config = &drv_data->config;
-	u8_t px_buf[8]; /* one byte per bit */
-	const struct spi_buf buf = {
-		.buf = px_buf,
-		.len = sizeof(px_buf),
-	};
-	const struct spi_buf_set tx = {
-		.buffers = &buf,
-		.count = 1
-	};
+	size_t len = 0;
 	size_t i;
 	int rc;
 
+	rc = ws2812_wait(drv_data);
+	if (rc) {
+		SYS_LOG_ERR("previous update failed: %d", rc);
+	}
+
 	for (i = 0; i < num_channels; i++) {
-		ws2812_serialize_color(px_buf, channels[i]);
-		rc = spi_write(drv_data->spi, config, &tx);
-		if (rc) {
-			/*
-			 * Latch anything we've shifted out first, to
-			 * call visual attention to the problematic
-			 * pixel.
-			 */
-			(void)ws2812_reset_strip(drv_data);
-			SYS_LOG_ERR("can't set channel %u: %d", i, rc);
-			return rc;
+		if (len + 8 > DATA_SIZE) {
+			rc = ws2812_send(drv_data, len, false);
+			if (rc) {
+				/*
+				 * Latch anything we've shifted out first, to
+				 * call visual attention to the problematic
+				 * channels.
+				 */
+				(void)ws2812_send(drv_data, 0, true);
+				SYS_LOG_ERR("can't set channel %u: %d", i, rc);
+				return rc;
+			}
+
+			len = 0;
 		}
+
+		/* one byte per bit */
+		ws2812_serialize_color(drv_data->buf + len, channels[i]);
+		len += 8;
 	}
 
-	return ws2812_reset_strip(drv_data);
+	return ws2812_send(drv_data, len, true);
 }
 
 static int ws2812_strip_init(struct device *dev)
@@ -186,6 +253,12 @@ static int ws2812_strip_init(struct device *dev)
 	config->slave = 0;	/* MOSI only. */
 	config->cs = NULL;
 
+#if defined(CONFIG_WS2812_STRIP_ASYNC)
+	k_poll_signal_init(&data->done);
+#endif
+
+	ws2812_init_frames();
+
 	return 0;
 }
 
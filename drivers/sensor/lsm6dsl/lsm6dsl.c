@@ -128,6 +128,16 @@ static int lsm6dsl_accel_set_odr_raw(struct device *dev, u8_t odr)
 
 	data->accel_freq = lsm6dsl_odr_to_freq_val(odr);
 
+#if defined(CONFIG_LSM6DSL_FIFO)
+	/* The FIFO follows the accelerometer */
+	if (data->hw_tf->update_reg(data,
+				LSM6DSL_REG_FIFO_CTRL5,
+				LSM6DSL_MASK_FIFO_CTRL5_ODR_FIFO,
+				odr << LSM6DSL_SHIFT_FIFO_CTRL5_ODR_FIFO) < 0) {
+		return -EIO;
+	}
+#endif
+
 	return 0;
 }
 
@@ -690,6 +700,128 @@ static int lsm6dsl_channel_get(struct device *dev,
 	return 0;
 }
 
+#if defined(CONFIG_LSM6DSL_FIFO)
+/* FIFO words of a sample: gyroscope X, Y, Z, then accelerometer X, Y, Z */
+#define LSM6DSL_FIFO_SAMPLE_WORDS	6
+#define LSM6DSL_FIFO_SAMPLE_SIZE	(LSM6DSL_FIFO_SAMPLE_WORDS * 2)
+/* samples per bus transfer */
+#define LSM6DSL_FIFO_CHUNK		20
+
+static int lsm6dsl_fifo_init(struct device *dev)
+{
+	struct lsm6dsl_data *data = dev->driver_data;
+	u16_t fth = CONFIG_LSM6DSL_FIFO_WATERMARK * LSM6DSL_FIFO_SAMPLE_WORDS;
+	u8_t val;
+
+	val = (fth & 0xff) << LSM6DSL_SHIFT_FIFO_CTRL1_FTH;
+	if (data->hw_tf->update_reg(data, LSM6DSL_REG_FIFO_CTRL1,
+				    LSM6DSL_MASK_FIFO_CTRL1_FTH, val) < 0) {
+		return -EIO;
+	}
+
+	val = (fth >> 8) << LSM6DSL_SHIFT_FIFO_CTRL2_FTH;
+	if (data->hw_tf->update_reg(data, LSM6DSL_REG_FIFO_CTRL2,
+				    LSM6DSL_MASK_FIFO_CTRL2_FTH, val) < 0) {
+		return -EIO;
+	}
+
+	/* Both sensors in the FIFO, without decimation */
+	val = (1 << LSM6DSL_SHIFT_FIFO_CTRL3_DEC_FIFO_GYRO) |
+	      (1 << LSM6DSL_SHIFT_FIFO_CTRL3_DEC_FIFO_XL);
+	if (data->hw_tf->update_reg(data, LSM6DSL_REG_FIFO_CTRL3,
+				    LSM6DSL_MASK_FIFO_CTRL3_DEC_FIFO_GYRO |
+				    LSM6DSL_MASK_FIFO_CTRL3_DEC_FIFO_XL,
+				    val) < 0) {
+		return -EIO;
+	}
+
+	return data->hw_tf->update_reg(data,
+				LSM6DSL_REG_FIFO_CTRL5,
+				LSM6DSL_MASK_FIFO_CTRL5_ODR_FIFO |
+				LSM6DSL_MASK_FIFO_CTRL5_FIFO_MODE,
+				(CONFIG_LSM6DSL_ACCEL_ODR <<
+				 LSM6DSL_SHIFT_FIFO_CTRL5_ODR_FIFO) |
+				(LSM6DSL_FIFO_MODE_CONTINUOUS <<
+				 LSM6DSL_SHIFT_FIFO_CTRL5_FIFO_MODE));
+}
+
+static int lsm6dsl_fifo_read(struct device *dev, struct sensor_fifo *fifo)
+{
+	struct lsm6dsl_data *data = dev->driver_data;
+	u8_t buf[LSM6DSL_FIFO_CHUNK * LSM6DSL_FIFO_SAMPLE_SIZE];
+	u16_t words, pattern, left, n, i;
+	s16_t *out = fifo->buf;
+	u8_t status[4];
+
+	fifo->count = 0;
+
+	if (data->hw_tf->read_data(data, LSM6DSL_REG_FIFO_STATUS1,
+				   status, sizeof(status)) < 0) {
+		SYS_LOG_DBG("failed to read FIFO status");
+		return -EIO;
+	}
+
+	fifo->timestamp = k_cycle_get_32();
+
+	words = status[0] | ((status[1] & LSM6DSL_MASK_FIFO_STATUS2_DIFF_FIFO)
+			     << 8);
+	pattern = status[2] |
+		  ((status[3] & LSM6DSL_MASK_FIFO_STATUS4_FIFO_PATTERN) << 8);
+
+	/* Drop the rest of a sample partly read, to start on gyroscope X */
+	if (pattern) {
+		n = LSM6DSL_FIFO_SAMPLE_WORDS - pattern;
+		if (n > words) {
+			return 0;
+		}
+
+		if (data->hw_tf->read_data(data, LSM6DSL_REG_FIFO_DATA_OUT_L,
+					   buf, n * 2) < 0) {
+			return -EIO;
+		}
+		words -= n;
+	}
+
+	left = min(words / LSM6DSL_FIFO_SAMPLE_WORDS, fifo->max_samples);
+	while (left) {
+		n = min(left, LSM6DSL_FIFO_CHUNK);
+		if (data->hw_tf->read_data(data, LSM6DSL_REG_FIFO_DATA_OUT_L,
+				buf, n * LSM6DSL_FIFO_SAMPLE_SIZE) < 0) {
+			SYS_LOG_DBG("failed to read FIFO");
+			return -EIO;
+		}
+
+		for (i = 0; i < n * LSM6DSL_FIFO_SAMPLE_WORDS; i++) {
+			*out++ = (s16_t)sys_get_le16(&buf[i * 2]);
+		}
+
+		fifo->count += n;
+		left -= n;
+	}
+
+	fifo->num_values = LSM6DSL_FIFO_SAMPLE_WORDS;
+	fifo->chan[0] = SENSOR_CHAN_GYRO_X;
+	fifo->chan[1] = SENSOR_CHAN_GYRO_Y;
+	fifo->chan[2] = SENSOR_CHAN_GYRO_Z;
+	fifo->chan[3] = SENSOR_CHAN_ACCEL_X;
+	fifo->chan[4] = SENSOR_CHAN_ACCEL_Y;
+	fifo->chan[5] = SENSOR_CHAN_ACCEL_Z;
+
+	/* mdps/LSB to nano rad/s and mg/LSB to nano m/s^2 */
+	for (i = 0; i < 3; i++) {
+		fifo->scale[i] = (s32_t)(data->gyro_sensitivity *
+					 SENSOR_PI / 180);
+		fifo->scale[i + 3] = (s32_t)(data->accel_sensitivity *
+					     SENSOR_G);
+	}
+
+	fifo->period = data->accel_freq ?
+		       sys_clock_hw_cycles_per_sec / data->accel_freq : 0;
+
+	return 0;
+}
+#endif /* CONFIG_LSM6DSL_FIFO */
+
 static const struct sensor_driver_api lsm6dsl_api_funcs = {
 	.attr_set = lsm6dsl_attr_set,
 #if CONFIG_LSM6DSL_TRIGGER
@@ -697,6 +829,9 @@ static const struct sensor_driver_api lsm6dsl_api_funcs = {
 #endif
 	.sample_fetch = lsm6dsl_sample_fetch,
 	.channel_get = lsm6dsl_channel_get,
+#if defined(CONFIG_LSM6DSL_FIFO)
+	.fifo_read = lsm6dsl_fifo_read,
+#endif
 };
 
 static int lsm6dsl_init_chip(struct device *dev)
@@ -745,10 +880,15 @@ static int lsm6dsl_init_chip(struct device *dev)
 		return -EIO;
 	}
 
+#if defined(CONFIG_LSM6DSL_FIFO)
+	if (lsm6dsl_fifo_init(dev) < 0) {
+#else
 	if (data->hw_tf->update_reg(data,
 				LSM6DSL_REG_FIFO_CTRL5,
 				LSM6DSL_MASK_FIFO_CTRL5_FIFO_MODE,
-				0 << LSM6DSL_SHIFT_FIFO_CTRL5_FIFO_MODE) < 0) {
+				LSM6DSL_FIFO_MODE_BYPASS <<
+				LSM6DSL_SHIFT_FIFO_CTRL5_FIFO_MODE) < 0) {
+#endif
 		SYS_LOG_DBG("failed to set FIFO mode");
 		return -EIO;
 	}
@@ -71,12 +71,14 @@
 #define LSM6DSL_SHIFT_FIFO_CTRL4_DEC_DS3_FIFO		0
 
 #define LSM6DSL_REG_FIFO_CTRL5				0x0A
-#define LSM6DSL_MASK_FIFO_CTRL5_ODR_FIFO		(BIT(5) | BIT(4) | \
-							 BIT(3))
+#define LSM6DSL_MASK_FIFO_CTRL5_ODR_FIFO		(BIT(6) | BIT(5) | \
+							 BIT(4) | BIT(3))
 #define LSM6DSL_SHIFT_FIFO_CTRL5_ODR_FIFO		3
 #define LSM6DSL_MASK_FIFO_CTRL5_FIFO_MODE		(BIT(2) | BIT(1) | \
 							 BIT(0))
 #define LSM6DSL_SHIFT_FIFO_CTRL5_FIFO_MODE		0
+#define LSM6DSL_FIFO_MODE_BYPASS			0
+#define LSM6DSL_FIFO_MODE_CONTINUOUS			6
 
 #define LSM6DSL_REG_DRDY_PULSE_CFG_G			0x0B
 #define LSM6DSL_MASK_DRDY_PULSE_CFG_G_DRDY_PULSED	BIT(7)
@@ -369,7 +371,7 @@
 #define LSM6DSL_MASK_FIFO_STATUS3_FIFO_PATTERN		0x0F
 #define LSM6DSL_SHIFT_FIFO_STATUS3_FIFO_PATTERN		0
 
-#define LSM6DSL_REG_FIFO_STATUS4			0x3C
+#define LSM6DSL_REG_FIFO_STATUS4			0x3D
 #define LSM6DSL_MASK_FIFO_STATUS4_FIFO_PATTERN		(BIT(1) | BIT(0))
 #define LSM6DSL_SHIFT_FIFO_STATUS4_FIFO_PATTERN		0
 
@@ -19,7 +19,11 @@ int lsm6dsl_trigger_set(struct device *dev,
 {
 	struct lsm6dsl_data *drv_data = dev->driver_data;
 
+#if defined(CONFIG_LSM6DSL_FIFO)
+	__ASSERT_NO_MSG(trig->type == SENSOR_TRIG_FIFO_WATERMARK);
+#else
 	__ASSERT_NO_MSG(trig->type == SENSOR_TRIG_DATA_READY);
+#endif
 
 	gpio_pin_disable_callback(drv_data->gpio, CONFIG_LSM6DSL_GPIO_PIN_NUM);
 
@@ -115,6 +119,16 @@ int lsm6dsl_init_interrupt(struct device *dev)
 		return -EIO;
 	}
 
+#if defined(CONFIG_LSM6DSL_FIFO)
+	/* enable FIFO watermark interrupt */
+	if (drv_data->hw_tf->update_reg(drv_data,
+			       LSM6DSL_REG_INT1_CTRL,
+			       LSM6DSL_MASK_INT1_FTH,
+			       1 << LSM6DSL_SHIFT_INT1_FTH) < 0) {
+		SYS_LOG_ERR("Could not enable FIFO watermark interrupt.");
+		return -EIO;
+	}
+#else
 	/* enable data-ready interrupt */
 	if (drv_data->hw_tf->update_reg(drv_data,
 			       LSM6DSL_REG_INT1_CTRL,
@@ -125,6 +139,7 @@ int lsm6dsl_init_interrupt(struct device *dev)
 		SYS_LOG_ERR("Could not enable data-ready interrupt.");
 		return -EIO;
 	}
+#endif
 
 #if defined(CONFIG_LSM6DSL_TRIGGER_OWN_THREAD)
 	k_sem_init(&drv_data->gpio_sem, 0, UINT_MAX);
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <sensor.h>
+
+void sensor_fifo_get_q31(const struct sensor_fifo *fifo, u8_t idx,
+			 s8_t shift, sensor_q31_t *out)
+{
+	const s16_t *raw = &fifo->buf[idx];
+	s64_t mult, q;
+	u16_t i;
+
+	/* Units per LSB in Q30, the one division of the batch */
+	mult = ((s64_t)fifo->scale[idx] << 30) / 1000000000;
+
+	for (i = 0; i < fifo->count; i++, raw += fifo->num_values) {
+		/* q = raw * mult * 2^(31 - shift) / 2^30 */
+		if (shift) {
+			q = ((s64_t)*raw * mult) >> (shift - 1);
+		} else {
+			q = (s64_t)*raw * mult * 2;
+		}
+
+		if (q > INT32_MAX) {
+			q = INT32_MAX;
+		} else if (q < INT32_MIN) {
+			q = INT32_MIN;
+		}
+
+		out[i] = q;
+	}
+}
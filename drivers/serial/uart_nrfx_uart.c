@@ -292,11 +292,370 @@ static void uart_nrfx_irq_callback_set(struct device *dev,
 	(void)dev;
 	m_irq_callback = cb;
 }
+#endif /* CONFIG_UART_INTERRUPT_DRIVEN */
+
+#ifdef CONFIG_UART_ASYNC_API
+
+/* The UART peripheral has no EasyDMA, buffers are moved byte by byte from
+ * the interrupt handler and only complete buffers or idle line timeouts
+ * are reported to the user.
+ */
+static struct {
+	uart_callback_t callback;
+	void *user_data;
+
+	const u8_t *tx_buf;
+	size_t tx_size;
+	size_t tx_counter;
+	struct k_timer tx_timeout_timer;
+
+	u8_t *rx_buf;
+	size_t rx_size;
+	size_t rx_counter;
+	size_t rx_offset;
+	u8_t *rx_secondary_buf;
+	size_t rx_secondary_size;
+	s32_t rx_timeout;
+	struct k_timer rx_timeout_timer;
+} uart0_cb;
+
+static void user_callback(struct uart_event *event)
+{
+	if (uart0_cb.callback) {
+		uart0_cb.callback(event, uart0_cb.user_data);
+	}
+}
+
+static int uart_nrfx_callback_set(struct device *dev, uart_callback_t callback,
+				  void *user_data)
+{
+	uart0_cb.callback = callback;
+	uart0_cb.user_data = user_data;
+
+	return 0;
+}
+
+static int uart_nrfx_tx(struct device *dev, const u8_t *buf, size_t len,
+			s32_t timeout)
+{
+	int key;
+
+	if (len == 0) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (uart0_cb.tx_buf) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	uart0_cb.tx_buf = buf;
+	uart0_cb.tx_size = len;
+	uart0_cb.tx_counter = 0;
+
+	/* The first byte is sent here, the next ones each time the previous
+	 * one is out.
+	 */
+	nrf_uart_event_clear(NRF_UART0, NRF_UART_EVENT_TXDRDY);
+	nrf_uart_txd_set(NRF_UART0, buf[0]);
+	nrf_uart_int_enable(NRF_UART0, NRF_UART_INT_MASK_TXDRDY);
+
+	if (timeout != K_FOREVER) {
+		k_timer_start(&uart0_cb.tx_timeout_timer, timeout, 0);
+	}
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+static int uart_nrfx_tx_abort(struct device *dev)
+{
+	struct uart_event evt;
+	int key;
+
+	key = irq_lock();
+
+	if (!uart0_cb.tx_buf) {
+		irq_unlock(key);
+		return -EFAULT;
+	}
+
+	k_timer_stop(&uart0_cb.tx_timeout_timer);
+	nrf_uart_int_disable(NRF_UART0, NRF_UART_INT_MASK_TXDRDY);
+
+	evt.type = UART_TX_ABORTED;
+	evt.data.tx.buf = uart0_cb.tx_buf;
+	evt.data.tx.len = uart0_cb.tx_counter;
+	uart0_cb.tx_buf = NULL;
+
+	user_callback(&evt);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+static int uart_nrfx_rx_enable(struct device *dev, u8_t *buf, size_t len,
+			       s32_t timeout)
+{
+	struct uart_event evt;
+	int key;
+
+	if (len == 0) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (uart0_cb.rx_buf) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	uart0_cb.rx_buf = buf;
+	uart0_cb.rx_size = len;
+	uart0_cb.rx_counter = 0;
+	uart0_cb.rx_offset = 0;
+	uart0_cb.rx_secondary_buf = NULL;
+	uart0_cb.rx_timeout = timeout;
+
+	nrf_uart_event_clear(NRF_UART0, NRF_UART_EVENT_ERROR);
+	nrf_uart_int_enable(NRF_UART0, NRF_UART_INT_MASK_RXDRDY |
+				       NRF_UART_INT_MASK_ERROR);
+
+	evt.type = UART_RX_BUF_REQUEST;
+	user_callback(&evt);
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+static int uart_nrfx_rx_buf_rsp(struct device *dev, u8_t *buf, size_t len)
+{
+	int key;
+	int err = 0;
+
+	key = irq_lock();
+
+	if (!uart0_cb.rx_buf) {
+		err = -EACCES;
+	} else if (uart0_cb.rx_secondary_buf) {
+		err = -EBUSY;
+	} else {
+		uart0_cb.rx_secondary_buf = buf;
+		uart0_cb.rx_secondary_size = len;
+	}
+
+	irq_unlock(key);
+
+	return err;
+}
+
+/* Report the data received since the last report, called locked */
+static void rx_rdy_report(void)
+{
+	struct uart_event evt;
+
+	if (uart0_cb.rx_counter == uart0_cb.rx_offset) {
+		return;
+	}
+
+	evt.type = UART_RX_RDY;
+	evt.data.rx.buf = uart0_cb.rx_buf;
+	evt.data.rx.offset = uart0_cb.rx_offset;
+	evt.data.rx.len = uart0_cb.rx_counter - uart0_cb.rx_offset;
+	uart0_cb.rx_offset = uart0_cb.rx_counter;
+
+	user_callback(&evt);
+}
+
+static void rx_buf_release(u8_t *buf)
+{
+	struct uart_event evt;
+
+	evt.type = UART_RX_BUF_RELEASED;
+	evt.data.rx_buf.buf = buf;
+
+	user_callback(&evt);
+}
+
+/* Stop reception and release the buffers, called locked */
+static void rx_stop(void)
+{
+	struct uart_event evt;
 
+	nrf_uart_int_disable(NRF_UART0, NRF_UART_INT_MASK_RXDRDY |
+					NRF_UART_INT_MASK_ERROR);
+	k_timer_stop(&uart0_cb.rx_timeout_timer);
+
+	rx_rdy_report();
+	rx_buf_release(uart0_cb.rx_buf);
+	if (uart0_cb.rx_secondary_buf) {
+		rx_buf_release(uart0_cb.rx_secondary_buf);
+	}
+
+	uart0_cb.rx_buf = NULL;
+	uart0_cb.rx_secondary_buf = NULL;
+
+	evt.type = UART_RX_DISABLED;
+	user_callback(&evt);
+}
+
+static int uart_nrfx_rx_disable(struct device *dev)
+{
+	int key;
+
+	key = irq_lock();
+
+	if (!uart0_cb.rx_buf) {
+		irq_unlock(key);
+		return -EFAULT;
+	}
+
+	rx_stop();
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+static void rx_isr(void)
+{
+	struct uart_event evt;
+	u8_t c;
+
+	nrf_uart_event_clear(NRF_UART0, NRF_UART_EVENT_RXDRDY);
+	c = nrf_uart_rxd_get(NRF_UART0);
+
+	if (!uart0_cb.rx_buf) {
+		return;
+	}
+
+	uart0_cb.rx_buf[uart0_cb.rx_counter++] = c;
+
+	if (uart0_cb.rx_counter < uart0_cb.rx_size) {
+		/* report the data once the line goes idle */
+		if (uart0_cb.rx_timeout != K_FOREVER) {
+			k_timer_start(&uart0_cb.rx_timeout_timer,
+				      uart0_cb.rx_timeout, 0);
+		}
+		return;
+	}
+
+	k_timer_stop(&uart0_cb.rx_timeout_timer);
+	rx_rdy_report();
+
+	if (!uart0_cb.rx_secondary_buf) {
+		/* no buffer to continue with */
+		rx_stop();
+		return;
+	}
+
+	rx_buf_release(uart0_cb.rx_buf);
+
+	uart0_cb.rx_buf = uart0_cb.rx_secondary_buf;
+	uart0_cb.rx_size = uart0_cb.rx_secondary_size;
+	uart0_cb.rx_counter = 0;
+	uart0_cb.rx_offset = 0;
+	uart0_cb.rx_secondary_buf = NULL;
+
+	evt.type = UART_RX_BUF_REQUEST;
+	user_callback(&evt);
+}
+
+static void error_isr(void)
+{
+	struct uart_event evt;
+
+	nrf_uart_event_clear(NRF_UART0, NRF_UART_EVENT_ERROR);
+
+	evt.type = UART_RX_STOPPED;
+	evt.data.rx_stop.reason = nrf_uart_errorsrc_get_and_clear(NRF_UART0);
+	evt.data.rx_stop.data.buf = uart0_cb.rx_buf;
+	evt.data.rx_stop.data.offset = uart0_cb.rx_offset;
+	evt.data.rx_stop.data.len = uart0_cb.rx_counter - uart0_cb.rx_offset;
+	uart0_cb.rx_offset = uart0_cb.rx_counter;
+
+	user_callback(&evt);
+
+	if (uart0_cb.rx_buf) {
+		rx_stop();
+	}
+}
+
+static void tx_isr(void)
+{
+	struct uart_event evt;
+
+	if (!uart0_cb.tx_buf) {
+		nrf_uart_int_disable(NRF_UART0, NRF_UART_INT_MASK_TXDRDY);
+		return;
+	}
+
+	if (++uart0_cb.tx_counter < uart0_cb.tx_size) {
+		nrf_uart_event_clear(NRF_UART0, NRF_UART_EVENT_TXDRDY);
+		nrf_uart_txd_set(NRF_UART0,
+				 uart0_cb.tx_buf[uart0_cb.tx_counter]);
+		return;
+	}
+
+	/* TXDRDY is left set, as poll_out and fifo_fill expect */
+	nrf_uart_int_disable(NRF_UART0, NRF_UART_INT_MASK_TXDRDY);
+	k_timer_stop(&uart0_cb.tx_timeout_timer);
+
+	evt.type = UART_TX_DONE;
+	evt.data.tx.buf = uart0_cb.tx_buf;
+	evt.data.tx.len = uart0_cb.tx_size;
+	uart0_cb.tx_buf = NULL;
+
+	user_callback(&evt);
+}
+
+static void uart_nrfx_async_isr(void)
+{
+	if (nrf_uart_int_enable_check(NRF_UART0, NRF_UART_INT_MASK_RXDRDY) &&
+	    nrf_uart_event_check(NRF_UART0, NRF_UART_EVENT_RXDRDY)) {
+		rx_isr();
+	}
+
+	if (nrf_uart_int_enable_check(NRF_UART0, NRF_UART_INT_MASK_ERROR) &&
+	    nrf_uart_event_check(NRF_UART0, NRF_UART_EVENT_ERROR)) {
+		error_isr();
+	}
+
+	if (nrf_uart_int_enable_check(NRF_UART0, NRF_UART_INT_MASK_TXDRDY) &&
+	    nrf_uart_event_check(NRF_UART0, NRF_UART_EVENT_TXDRDY)) {
+		tx_isr();
+	}
+}
+
+static void tx_timeout(struct k_timer *timer)
+{
+	(void)uart_nrfx_tx_abort(NULL);
+}
+
+static void rx_timeout(struct k_timer *timer)
+{
+	int key;
+
+	key = irq_lock();
+	if (uart0_cb.rx_buf) {
+		rx_rdy_report();
+	}
+	irq_unlock(key);
+}
+#endif /* CONFIG_UART_ASYNC_API */
+
+#if defined(CONFIG_UART_INTERRUPT_DRIVEN) || defined(CONFIG_UART_ASYNC_API)
 /**
  * @brief Interrupt service routine.
  *
- * This simply calls the callback function, if one exists.
+ * This simply calls the callback function, if one exists. The
+ * asynchronous API handles the interrupts itself once its callback is set.
  *
  * @param arg Argument to ISR.
  *
@@ -306,11 +665,22 @@ static void uart_nrfx_isr(void *arg)
 {
 	struct device *dev = arg;
 
+	ARG_UNUSED(dev);
+
+#ifdef CONFIG_UART_ASYNC_API
+	if (uart0_cb.callback) {
+		uart_nrfx_async_isr();
+		return;
+	}
+#endif
+
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	if (m_irq_callback) {
 		m_irq_callback(dev);
 	}
+#endif
 }
-#endif /* CONFIG_UART_INTERRUPT_DRIVEN */
+#endif /* CONFIG_UART_INTERRUPT_DRIVEN || CONFIG_UART_ASYNC_API */
 
 DEVICE_DECLARE(uart_nrfx_uart0);
 
@@ -373,7 +743,12 @@ static int uart_nrfx_init(struct device *dev)
 	nrf_uart_task_trigger(NRF_UART0, NRF_UART_TASK_STARTTX);
 	nrf_uart_task_trigger(NRF_UART0, NRF_UART_TASK_STARTRX);
 
-#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+#ifdef CONFIG_UART_ASYNC_API
+	k_timer_init(&uart0_cb.tx_timeout_timer, tx_timeout, NULL);
+	k_timer_init(&uart0_cb.rx_timeout_timer, rx_timeout, NULL);
+#endif
+
+#if defined(CONFIG_UART_INTERRUPT_DRIVEN) || defined(CONFIG_UART_ASYNC_API)
 
 	IRQ_CONNECT(NRFX_IRQ_NUMBER_GET(NRF_UART0),
 		    CONFIG_UART_0_IRQ_PRI,
@@ -390,6 +765,14 @@ static const struct uart_driver_api uart_nrfx_uart_driver_api = {
 	.poll_in          = uart_nrfx_poll_in,          /** Console I/O function */
 	.poll_out         = uart_nrfx_poll_out,         /** Console I/O function */
 	.err_check        = uart_nrfx_err_check,        /** Console I/O function */
+#ifdef CONFIG_UART_ASYNC_API
+	.callback_set     = uart_nrfx_callback_set,
+	.tx               = uart_nrfx_tx,
+	.tx_abort         = uart_nrfx_tx_abort,
+	.rx_enable        = uart_nrfx_rx_enable,
+	.rx_buf_rsp       = uart_nrfx_rx_buf_rsp,
+	.rx_disable       = uart_nrfx_rx_disable,
+#endif /* CONFIG_UART_ASYNC_API */
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 	.fifo_fill        = uart_nrfx_fifo_fill,        /** IRQ FIFO fill function */
 	.fifo_read        = uart_nrfx_fifo_read,        /** IRQ FIFO read function */
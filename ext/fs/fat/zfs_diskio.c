@@ -25,12 +25,274 @@
 / by use of this software.
 /----------------------------------------------------------------------------*/
 
+#include <string.h>
 #include <diskio.h>	/* FatFs lower layer API */
 #include <ffconf.h>
 #include <disk_access.h>
 
 static const char* const pdrv_str[] = {_VOLUME_STRS};
 
+#if defined(CONFIG_FS_FATFS_CACHE)
+/*-----------------------------------------------------------------------*/
+/* Sector cache                                                          */
+/*-----------------------------------------------------------------------*/
+/* Single sector accesses, which is what FatFs does for the FAT, the     */
+/* directories and partial data sectors, go through a write-back cache   */
+/* with LRU eviction. Dirty sectors reach the disk when they are evicted */
+/* or when the volume is synced. Multi sector accesses go straight to    */
+/* the disk, with the cache kept coherent.                               */
+/*-----------------------------------------------------------------------*/
+
+#define CACHE_SECTORS	CONFIG_FS_FATFS_CACHE_SECTORS
+#define CACHE_RA	CONFIG_FS_FATFS_CACHE_READ_AHEAD
+
+struct cache_line {
+	DWORD sector;
+	u32_t stamp;	/* last use, the oldest line is evicted */
+	BYTE pdrv;
+	BYTE valid;
+	BYTE dirty;
+	BYTE data[_MAX_SS];
+};
+
+static struct cache_line cache[CACHE_SECTORS];
+static u32_t cache_stamp;
+static K_MUTEX_DEFINE(cache_mtx);
+
+#if CACHE_RA > 0
+/* Read-ahead window, only holds data that is also on the disk or in the */
+/* cache, writes update it in place.                                     */
+static BYTE ra_buf[CACHE_RA][_MAX_SS];
+static DWORD ra_start;
+static BYTE ra_pdrv;
+static UINT ra_cnt;
+static DWORD ra_next[_VOLUMES];	/* sector following the last read */
+#endif
+
+static struct cache_line *cache_find(BYTE pdrv, DWORD sector)
+{
+	int i;
+
+	for (i = 0; i < CACHE_SECTORS; i++) {
+		if (cache[i].valid && cache[i].pdrv == pdrv &&
+		    cache[i].sector == sector) {
+			return &cache[i];
+		}
+	}
+	return NULL;
+}
+
+static int cache_flush_line(struct cache_line *line)
+{
+	int rc;
+
+	rc = disk_access_write(pdrv_str[line->pdrv], line->data,
+			       line->sector, 1);
+	if (rc == 0) {
+		line->dirty = 0;
+	}
+	return rc;
+}
+
+static struct cache_line *cache_alloc(BYTE pdrv, DWORD sector)
+{
+	struct cache_line *line = &cache[0];
+	int i;
+
+	for (i = 0; i < CACHE_SECTORS; i++) {
+		if (!cache[i].valid) {
+			line = &cache[i];
+			break;
+		}
+		if ((s32_t)(cache[i].stamp - line->stamp) < 0) {
+			line = &cache[i];
+		}
+	}
+
+	if (line->valid && line->dirty && cache_flush_line(line) != 0) {
+		return NULL;
+	}
+
+	line->pdrv = pdrv;
+	line->sector = sector;
+	line->valid = 1;
+	line->dirty = 0;
+	line->stamp = ++cache_stamp;
+	return line;
+}
+
+/* Write the dirty sectors of a drive in ascending order */
+static int cache_sync(BYTE pdrv)
+{
+	struct cache_line *line;
+	int i;
+
+	while (1) {
+		line = NULL;
+		for (i = 0; i < CACHE_SECTORS; i++) {
+			if (cache[i].valid && cache[i].dirty &&
+			    cache[i].pdrv == pdrv &&
+			    (!line || cache[i].sector < line->sector)) {
+				line = &cache[i];
+			}
+		}
+		if (!line) {
+			return 0;
+		}
+		if (cache_flush_line(line) != 0) {
+			return -1;
+		}
+	}
+}
+
+static void cache_invalidate(BYTE pdrv)
+{
+	int i;
+
+	for (i = 0; i < CACHE_SECTORS; i++) {
+		if (cache[i].pdrv == pdrv) {
+			cache[i].valid = 0;
+		}
+	}
+#if CACHE_RA > 0
+	if (ra_pdrv == pdrv) {
+		ra_cnt = 0;
+	}
+#endif
+}
+
+#if CACHE_RA > 0
+static BYTE *ra_find(BYTE pdrv, DWORD sector)
+{
+	if (ra_cnt && ra_pdrv == pdrv && sector >= ra_start &&
+	    sector - ra_start < ra_cnt) {
+		return ra_buf[sector - ra_start];
+	}
+	return NULL;
+}
+
+static BYTE *ra_fill(BYTE pdrv, DWORD sector)
+{
+	struct cache_line *line;
+	int i;
+
+	if (disk_access_read(pdrv_str[pdrv], ra_buf[0], sector,
+			     CACHE_RA) != 0) {
+		/* e.g. past the end of the disk, read without the window */
+		ra_cnt = 0;
+		return NULL;
+	}
+	/* the cache holds newer data for dirty sectors */
+	for (i = 0; i < CACHE_RA; i++) {
+		line = cache_find(pdrv, sector + i);
+		if (line && line->dirty) {
+			memcpy(ra_buf[i], line->data, _MAX_SS);
+		}
+	}
+	ra_pdrv = pdrv;
+	ra_start = sector;
+	ra_cnt = CACHE_RA;
+	return ra_buf[0];
+}
+#endif
+
+static DRESULT cache_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
+{
+	struct cache_line *line;
+	BYTE *data;
+	UINT i;
+
+#if CACHE_RA > 0
+	int sequential = (sector == ra_next[pdrv]);
+
+	ra_next[pdrv] = sector + count;
+#endif
+
+	if (count > 1) {
+		if (disk_access_read(pdrv_str[pdrv], buff, sector,
+				     count) != 0) {
+			return RES_ERROR;
+		}
+		/* the cache holds newer data for dirty sectors */
+		for (i = 0; i < count; i++) {
+			line = cache_find(pdrv, sector + i);
+			if (line && line->dirty) {
+				memcpy(buff + i * _MAX_SS, line->data,
+				       _MAX_SS);
+			}
+		}
+		return RES_OK;
+	}
+
+	line = cache_find(pdrv, sector);
+	if (line) {
+		line->stamp = ++cache_stamp;
+		memcpy(buff, line->data, _MAX_SS);
+		return RES_OK;
+	}
+
+#if CACHE_RA > 0
+	data = ra_find(pdrv, sector);
+	if (!data && sequential) {
+		data = ra_fill(pdrv, sector);
+	}
+	if (data) {
+		memcpy(buff, data, _MAX_SS);
+		return RES_OK;
+	}
+#endif
+
+	line = cache_alloc(pdrv, sector);
+	if (!line) {
+		return RES_ERROR;
+	}
+	data = line->data;
+	if (disk_access_read(pdrv_str[pdrv], data, sector, 1) != 0) {
+		line->valid = 0;
+		return RES_ERROR;
+	}
+	memcpy(buff, data, _MAX_SS);
+	return RES_OK;
+}
+
+static DRESULT cache_write(BYTE pdrv, const BYTE *buff, DWORD sector,
+			   UINT count)
+{
+	struct cache_line *line;
+	UINT i;
+
+	if (count > 1) {
+		if (disk_access_write(pdrv_str[pdrv], buff, sector,
+				      count) != 0) {
+			return RES_ERROR;
+		}
+	}
+
+	for (i = 0; i < count; i++, sector++, buff += _MAX_SS) {
+#if CACHE_RA > 0
+		BYTE *data = ra_find(pdrv, sector);
+
+		if (data) {
+			memcpy(data, buff, _MAX_SS);
+		}
+#endif
+		line = cache_find(pdrv, sector);
+		if (!line && count == 1) {
+			line = cache_alloc(pdrv, sector);
+			if (!line) {
+				return RES_ERROR;
+			}
+		}
+		if (line) {
+			memcpy(line->data, buff, _MAX_SS);
+			line->dirty = (count == 1);
+			line->stamp = ++cache_stamp;
+		}
+	}
+	return RES_OK;
+}
+#endif /* CONFIG_FS_FATFS_CACHE */
+
 /*-----------------------------------------------------------------------*/
 /* Get Drive Status                                                      */
 /*-----------------------------------------------------------------------*/
@@ -54,6 +316,14 @@ DSTATUS disk_initialize(BYTE pdrv)
 {
 	__ASSERT(pdrv < ARRAY_SIZE(pdrv_str), "pdrv out-of-range\n");
 
+#if defined(CONFIG_FS_FATFS_CACHE)
+	k_mutex_lock(&cache_mtx, K_FOREVER);
+	/* the drive is (re)mounted, do not trust what was cached for it */
+	cache_sync(pdrv);
+	cache_invalidate(pdrv);
+	k_mutex_unlock(&cache_mtx);
+#endif
+
 	if (disk_access_init(pdrv_str[pdrv]) != 0) {
 		return STA_NOINIT;
 	} else {
@@ -69,11 +339,20 @@ DRESULT disk_read(BYTE pdrv, BYTE *buff, DWORD sector, UINT count)
 {
 	__ASSERT(pdrv < ARRAY_SIZE(pdrv_str), "pdrv out-of-range\n");
 
+#if defined(CONFIG_FS_FATFS_CACHE)
+	DRESULT res;
+
+	k_mutex_lock(&cache_mtx, K_FOREVER);
+	res = cache_read(pdrv, buff, sector, count);
+	k_mutex_unlock(&cache_mtx);
+	return res;
+#else
 	if (disk_access_read(pdrv_str[pdrv], buff, sector, count) != 0) {
 		return RES_ERROR;
 	} else {
 		return RES_OK;
 	}
+#endif
 
 }
 
@@ -84,11 +363,20 @@ DRESULT disk_write(BYTE pdrv, const BYTE *buff, DWORD sector, UINT count)
 {
 	__ASSERT(pdrv < ARRAY_SIZE(pdrv_str), "pdrv out-of-range\n");
 
+#if defined(CONFIG_FS_FATFS_CACHE)
+	DRESULT res;
+
+	k_mutex_lock(&cache_mtx, K_FOREVER);
+	res = cache_write(pdrv, buff, sector, count);
+	k_mutex_unlock(&cache_mtx);
+	return res;
+#else
 	if(disk_access_write(pdrv_str[pdrv], buff, sector, count) != 0) {
 		return RES_ERROR;
 	} else {
 		return RES_OK;
 	}
+#endif
 }
 
 /*-----------------------------------------------------------------------*/
@@ -103,6 +391,13 @@ DRESULT disk_ioctl(BYTE pdrv, BYTE cmd, void *buff)
 
 	switch (cmd) {
 	case CTRL_SYNC:
+#if defined(CONFIG_FS_FATFS_CACHE)
+		k_mutex_lock(&cache_mtx, K_FOREVER);
+		if (cache_sync(pdrv) != 0) {
+			ret = RES_ERROR;
+		}
+		k_mutex_unlock(&cache_mtx);
+#endif
 		if(disk_access_ioctl(pdrv_str[pdrv],
 				DISK_IOCTL_CTRL_SYNC, buff) != 0) {
 			ret = RES_ERROR;
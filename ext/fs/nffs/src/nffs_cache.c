@@ -253,6 +253,9 @@ nffs_cache_inode_ensure(struct nffs_cache_inode **out_cache_inode,
 
     cache_inode = nffs_cache_inode_find(inode_entry);
     if (cache_inode != NULL) {
+        /* Keep the list in least recently used order. */
+        TAILQ_REMOVE(&nffs_cache_inode_list, cache_inode, nci_link);
+        TAILQ_INSERT_HEAD(&nffs_cache_inode_list, cache_inode, nci_link);
         rc = 0;
         goto done;
     }
@@ -29,6 +29,7 @@ extern "C" {
  */
 #define STAT_MGMT_ID_SHOW   0
 #define STAT_MGMT_ID_LIST   1
+#define STAT_MGMT_ID_SNAPSHOT   2
 
 /**
  * @brief Represents a single value in a statistics group.
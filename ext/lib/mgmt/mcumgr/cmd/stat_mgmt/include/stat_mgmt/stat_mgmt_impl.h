@@ -27,6 +27,9 @@
 #ifndef H_STAT_MGMT_IMPL_
 #define H_STAT_MGMT_IMPL_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -63,6 +66,20 @@ int stat_mgmt_impl_foreach_entry(const char *group_name,
                                  stat_mgmt_foreach_entry_fn *cb,
                                  void *arg);
 
+/**
+ * @brief Takes a binary snapshot of one or all stat groups.
+ *
+ * @param group_name            The name of the stat group to take, or NULL to
+ *                                  take all groups.
+ * @param buf                   The buffer to write the snapshot into.
+ * @param len                   The size of the buffer.
+ *
+ * @return                      The snapshot length on success;
+ *                              negative MGMT_ERR_[...] code on failure.
+ */
+int stat_mgmt_impl_snapshot(const char *group_name, uint8_t *buf,
+                            size_t len);
+
 #ifdef __cplusplus
 }
 #endif
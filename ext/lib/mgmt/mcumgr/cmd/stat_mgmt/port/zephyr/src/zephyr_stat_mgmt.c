@@ -17,6 +17,7 @@
  * under the License.
  */
 
+#include <errno.h>
 #include <misc/util.h>
 #include <stats.h>
 #include <mgmt/mgmt.h>
@@ -95,3 +96,20 @@ stat_mgmt_impl_foreach_entry(const char *group_name,
 
     return stats_walk(hdr, zephyr_stat_mgmt_walk_cb, &walk_arg);
 }
+
+int
+stat_mgmt_impl_snapshot(const char *group_name, uint8_t *buf, size_t len)
+{
+    int rc;
+
+    rc = stats_snapshot(group_name, buf, len);
+    switch (rc) {
+    case -ENOENT:
+        return -MGMT_ERR_ENOENT;
+    case -ENOMEM:
+        /* Snapshot larger than CONFIG_STAT_MGMT_SNAPSHOT_SIZE. */
+        return -MGMT_ERR_EMSGSIZE;
+    default:
+        return rc;
+    }
+}
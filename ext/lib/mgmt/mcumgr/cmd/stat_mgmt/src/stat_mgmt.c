@@ -28,10 +28,12 @@
 
 static mgmt_handler_fn stat_mgmt_show;
 static mgmt_handler_fn stat_mgmt_list;
+static mgmt_handler_fn stat_mgmt_snapshot;
 
 static struct mgmt_handler stat_mgmt_handlers[] = {
     [STAT_MGMT_ID_SHOW] = { stat_mgmt_show, NULL },
     [STAT_MGMT_ID_LIST] = { stat_mgmt_list, NULL },
+    [STAT_MGMT_ID_SNAPSHOT] = { stat_mgmt_snapshot, NULL },
 };
 
 #define STAT_MGMT_HANDLER_CNT \
@@ -153,6 +155,56 @@ stat_mgmt_list(struct mgmt_ctxt *ctxt)
     return 0;
 }
 
+/**
+ * Command handler: stat snapshot
+ *
+ * Returns the binary snapshot of the named group, or of all groups if no
+ * name is given, in a single byte string.
+ */
+static int
+stat_mgmt_snapshot(struct mgmt_ctxt *ctxt)
+{
+    char stat_name[STAT_MGMT_MAX_NAME_LEN];
+    uint8_t buf[STAT_MGMT_SNAPSHOT_SIZE];
+    CborError err;
+    int len;
+
+    struct cbor_attr_t attrs[] = {
+        {
+            .attribute = "name",
+            .type = CborAttrTextStringType,
+            .addr.string = stat_name,
+            .len = sizeof(stat_name)
+        },
+        { NULL },
+    };
+
+    stat_name[0] = '\0';
+
+    err = cbor_read_object(&ctxt->it, attrs);
+    if (err != 0) {
+        return MGMT_ERR_EINVAL;
+    }
+
+    len = stat_mgmt_impl_snapshot(stat_name[0] != '\0' ? stat_name : NULL,
+                                  buf, sizeof(buf));
+    if (len < 0) {
+        return -len;
+    }
+
+    err = 0;
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "rc");
+    err |= cbor_encode_int(&ctxt->encoder, MGMT_ERR_EOK);
+    err |= cbor_encode_text_stringz(&ctxt->encoder, "snapshot");
+    err |= cbor_encode_byte_string(&ctxt->encoder, buf, len);
+
+    if (err != 0) {
+        return MGMT_ERR_ENOMEM;
+    }
+
+    return 0;
+}
+
 void
 stat_mgmt_register_group(void)
 {
@@ -25,10 +25,12 @@
 #include "syscfg/syscfg.h"
 
 #define STAT_MGMT_MAX_NAME_LEN  MYNEWT_VAL(STAT_MGMT_MAX_NAME_LEN)
+#define STAT_MGMT_SNAPSHOT_SIZE MYNEWT_VAL(STAT_MGMT_SNAPSHOT_SIZE)
 
 #elif defined __ZEPHYR__
 
 #define STAT_MGMT_MAX_NAME_LEN  CONFIG_STAT_MGMT_MAX_NAME_LEN
+#define STAT_MGMT_SNAPSHOT_SIZE CONFIG_STAT_MGMT_SNAPSHOT_SIZE
 
 #else
 
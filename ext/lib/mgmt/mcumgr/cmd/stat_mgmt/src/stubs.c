@@ -31,6 +31,12 @@ stat_mgmt_impl_get_group(int idx, const char **out_name)
     return MGMT_ERR_ENOTSUP;
 }
 
+int __attribute__((weak))
+stat_mgmt_impl_snapshot(const char *group_name, uint8_t *buf, size_t len)
+{
+    return -MGMT_ERR_ENOTSUP;
+}
+
 int __attribute__((weak))
 stat_mgmt_impl_foreach_entry(const char *stat_name,
                              stat_mgmt_foreach_entry_fn *cb,
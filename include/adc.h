@@ -14,6 +14,7 @@
 
 #include <zephyr/types.h>
 #include <device.h>
+#include <errno.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -63,6 +64,70 @@ struct adc_seq_table {
 	u8_t stride[3];
 };
 
+#if defined(CONFIG_ADC_STREAM)
+/**
+ * @brief ADC stream events
+ */
+enum adc_stream_event {
+	/** The first half of the buffer has been filled. */
+	ADC_STREAM_HALF_FULL,
+
+	/** The second half of the buffer has been filled. */
+	ADC_STREAM_FULL,
+
+	/** Sampling stopped on an error. */
+	ADC_STREAM_ERROR,
+};
+
+/**
+ * @brief ADC stream callback
+ *
+ * Called in interrupt context. The samples stay valid until the hardware
+ * wraps around to them, i.e. for half of the buffer's duration.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param evt Stream event.
+ * @param samples Filled half of the buffer, NULL on error.
+ * @param count Number of samples in the filled half.
+ * @param user_data User data given in the stream configuration.
+ */
+typedef void (*adc_stream_callback_t)(struct device *dev,
+				      enum adc_stream_event evt,
+				      const u16_t *samples, u32_t count,
+				      void *user_data);
+
+/**
+ * @brief ADC stream configuration
+ *
+ * The channels sampled are the ones of the sequence table, the buffer
+ * fields of its entries are not used. On every period one sample of each
+ * channel is stored to the buffer, in sequence table order, so the buffer
+ * holds frames of seq_table->num_entries samples.
+ */
+struct adc_stream_config {
+	/** Channels to sample. */
+	struct adc_seq_table *seq_table;
+
+	/** Sampling period in microseconds. */
+	u32_t period_us;
+
+	/** Ring buffer written by the hardware. */
+	u16_t *buffer;
+
+	/**
+	 * Length of the ring buffer in bytes, each half holding a whole
+	 * number of frames.
+	 */
+	u32_t buffer_length;
+
+	/** Called as each half of the buffer is filled. */
+	adc_stream_callback_t callback;
+
+	/** User data passed to the callback. */
+	void *user_data;
+};
+#endif
+
 /**
  * @brief ADC driver API
  *
@@ -77,6 +142,15 @@ struct adc_driver_api {
 
 	/** Pointer to the read routine. */
 	int (*read)(struct device *dev, struct adc_seq_table *seq_table);
+
+#if defined(CONFIG_ADC_STREAM)
+	/** Pointer to the stream start routine. */
+	int (*stream_start)(struct device *dev,
+			    const struct adc_stream_config *cfg);
+
+	/** Pointer to the stream stop routine. */
+	int (*stream_stop)(struct device *dev);
+#endif
 };
 
 /**
@@ -142,6 +216,58 @@ static inline int _impl_adc_read(struct device *dev,
 	return api->read(dev, seq_table);
 }
 
+#if defined(CONFIG_ADC_STREAM)
+/**
+ * @brief Start continuous sampling.
+ *
+ * This routine starts sampling the channels of the stream configuration
+ * at a fixed rate into a ring buffer, without CPU involvement per sample.
+ * The callback is invoked each time one half of the buffer is filled,
+ * the hardware then goes on with the other half. Sampling continues
+ * until adc_stream_stop() is called. adc_read() is blocked meanwhile.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param cfg Stream configuration, it need not be kept after the call.
+ *
+ * @retval 0 On success.
+ * @retval -ENOTSUP If the driver does not support streaming.
+ * @retval -EBUSY If the ADC is in use.
+ * @retval -EINVAL If the configuration is invalid.
+ */
+static inline int adc_stream_start(struct device *dev,
+				   const struct adc_stream_config *cfg)
+{
+	const struct adc_driver_api *api = dev->driver_api;
+
+	if (!api->stream_start) {
+		return -ENOTSUP;
+	}
+
+	return api->stream_start(dev, cfg);
+}
+
+/**
+ * @brief Stop continuous sampling.
+ *
+ * This routine may be called from the stream callback.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ *
+ * @retval 0 On success.
+ * @retval -ENOTSUP If the driver does not support streaming.
+ */
+static inline int adc_stream_stop(struct device *dev)
+{
+	const struct adc_driver_api *api = dev->driver_api;
+
+	if (!api->stream_stop) {
+		return -ENOTSUP;
+	}
+
+	return api->stream_stop(dev);
+}
+#endif
+
 /**
  * @}
  */
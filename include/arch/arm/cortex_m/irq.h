@@ -138,6 +138,17 @@ static inline void _arch_isr_direct_footer(int maybe_swap)
 	} \
 	static inline int name##_body(void)
 
+#define _ARCH_ISR_DIRECT_RAMFUNC_DECLARE(name) \
+	static ALWAYS_INLINE int name##_body(void); \
+	__ramfunc __attribute__ ((interrupt ("IRQ"))) void name(void) \
+	{ \
+		int check_reschedule; \
+		ISR_DIRECT_HEADER(); \
+		check_reschedule = name##_body(); \
+		ISR_DIRECT_FOOTER(check_reschedule); \
+	} \
+	static ALWAYS_INLINE int name##_body(void)
+
 /* Spurious interrupt handler. Throws an error if called */
 extern void _irq_spurious(void *unused);
 
@@ -72,6 +72,102 @@ int base64_encode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 int base64_decode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 		  size_t slen);
 
+/**
+ * @brief          State of an incremental base64 encoding
+ */
+struct base64_encoder {
+	u8_t buf[3];
+	u8_t len;
+};
+
+/**
+ * @brief          Start an incremental base64 encoding
+ *
+ * @param enc      encoder state
+ */
+void base64_encoder_init(struct base64_encoder *enc);
+
+/**
+ * @brief          Encode the next part of the data
+ *
+ * Up to 2 bytes are kept in the encoder until more data or
+ * base64_encode_finish() completes them. The output is not null
+ * terminated, so that the outputs of successive calls form the
+ * encoding of the whole data.
+ *
+ * @param enc      encoder state
+ * @param dst      destination buffer
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written
+ * @param src      source buffer
+ * @param slen     amount of data to be encoded
+ *
+ * @return         0 if successful, or -ENOMEM if the buffer is too small,
+ *                 *olen is then set to the size needed and the encoder
+ *                 state is unchanged.
+ */
+int base64_encode_update(struct base64_encoder *enc, u8_t *dst, size_t dlen,
+			 size_t *olen, const u8_t *src, size_t slen);
+
+/**
+ * @brief          Encode the bytes left in the encoder, with padding
+ *
+ * @param enc      encoder state
+ * @param dst      destination buffer, 4 bytes are enough
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written
+ *
+ * @return         0 if successful, or -ENOMEM if the buffer is too small.
+ */
+int base64_encode_finish(struct base64_encoder *enc, u8_t *dst, size_t dlen,
+			 size_t *olen);
+
+/**
+ * @brief          State of an incremental base64 decoding
+ */
+struct base64_decoder {
+	u32_t bits;
+	u8_t len;
+	u8_t pad;
+};
+
+/**
+ * @brief          Start an incremental base64 decoding
+ *
+ * @param dec      decoder state
+ */
+void base64_decoder_init(struct base64_decoder *dec);
+
+/**
+ * @brief          Decode the next part of base64-formatted data
+ *
+ * Symbols can be split across calls at any point, spaces and line
+ * breaks are skipped.
+ *
+ * @param dec      decoder state
+ * @param dst      destination buffer, with room for 3 bytes per 4 source
+ *                 bytes, plus 3 bytes
+ * @param dlen     size of the destination buffer
+ * @param olen     number of bytes written
+ * @param src      source buffer
+ * @param slen     amount of data to be decoded
+ *
+ * @return         0 if successful, -ENOMEM if the buffer is too small, or
+ *                 -EINVAL if the input data is not correct. After an
+ *                 error, the decoder must be initialized again.
+ */
+int base64_decode_update(struct base64_decoder *dec, u8_t *dst, size_t dlen,
+			 size_t *olen, const u8_t *src, size_t slen);
+
+/**
+ * @brief          Check that the decoded data ended on a complete quartet
+ *
+ * @param dec      decoder state
+ *
+ * @return         0 if successful, or -EINVAL if symbols are missing.
+ */
+int base64_decode_finish(struct base64_decoder *dec);
+
 #ifdef __cplusplus
 }
 #endif
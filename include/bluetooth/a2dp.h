@@ -14,7 +14,10 @@
 extern "C" {
 #endif
 
+#include <net/buf.h>
+#include <bluetooth/l2cap.h>
 #include <bluetooth/avdtp.h>
+#include <bluetooth/a2dp-codec.h>
 
 /** @brief Stream Structure */
 struct bt_a2dp_stream {
@@ -104,6 +107,159 @@ struct bt_a2dp *bt_a2dp_connect(struct bt_conn *conn);
 int bt_a2dp_register_endpoint(struct bt_a2dp_endpoint *endpoint,
 			      u8_t media_type, u8_t role);
 
+/** @def BT_A2DP_MEDIA_HDR_LEN
+ *  @brief Size of the media packet and SBC payload headers
+ */
+#define BT_A2DP_MEDIA_HDR_LEN 13
+
+/** @def BT_A2DP_MEDIA_RESERVE
+ *  @brief Headroom needed by media packet buffers
+ *
+ *  Buffers of a source media pool are sized
+ *  BT_A2DP_MEDIA_RESERVE + MTU - BT_A2DP_MEDIA_HDR_LEN.
+ */
+#define BT_A2DP_MEDIA_RESERVE (BT_L2CAP_CHAN_SEND_RESERVE + \
+			       BT_A2DP_MEDIA_HDR_LEN)
+
+/** @brief SBC media transport, source side */
+struct bt_a2dp_media_tx {
+	/** Transport channel the media packets are sent on */
+	struct bt_l2cap_br_chan *chan;
+	/** Pool the media packets are allocated from */
+	struct net_buf_pool *pool;
+	/** Media packet being filled, if any */
+	struct net_buf *buf;
+	/** Number of SBC frames in the packet being filled */
+	u8_t frames;
+	/** Audio samples per SBC frame */
+	u16_t frame_samples;
+	/** Sequence number of the next media packet */
+	u16_t seq;
+	/** Timestamp of the first frame of the next media packet */
+	u32_t ts;
+	/** Synchronization source identifier */
+	u32_t ssrc;
+};
+
+/** @brief SBC media transport, sink side */
+struct bt_a2dp_media_rx {
+	/** Pool the buffered media packets are copied to */
+	struct net_buf_pool *pool;
+	/** Buffered media packets, oldest sequence number first */
+	struct net_buf *bufs[CONFIG_BT_A2DP_MEDIA_RX_SLOTS];
+	/** Number of buffered media packets */
+	u8_t count;
+	/** Whether enough media was buffered to start playing */
+	bool playing;
+	/** Whether a packet was played, making next_seq valid */
+	bool synced;
+	/** Sequence number expected to be played next */
+	u16_t next_seq;
+	/** Audio samples per SBC frame */
+	u16_t frame_samples;
+	/** Buffered duration, in samples, needed to start playing */
+	u32_t target;
+};
+
+/** @brief Get the length of an SBC frame.
+ *
+ *  @param cfg SBC configuration, with one option selected per field.
+ *  @param bitpool Bitpool the frames are encoded with.
+ *
+ *  @return Frame length in octets, or 0 if the configuration is invalid.
+ */
+u16_t bt_a2dp_sbc_frame_len(const struct bt_a2dp_codec_sbc_params *cfg,
+			    u8_t bitpool);
+
+/** @brief Get the number of audio samples per channel in an SBC frame.
+ *
+ *  @param cfg SBC configuration, with one option selected per field.
+ *
+ *  @return Samples per frame, or 0 if the configuration is invalid.
+ */
+u16_t bt_a2dp_sbc_frame_samples(const struct bt_a2dp_codec_sbc_params *cfg);
+
+/** @brief Initialize a source media transport.
+ *
+ *  @param tx Media transport.
+ *  @param chan Open AVDTP transport channel.
+ *  @param pool Pool of media packet buffers, see BT_A2DP_MEDIA_RESERVE.
+ *  @param frame_samples Audio samples per SBC frame.
+ */
+void bt_a2dp_media_tx_init(struct bt_a2dp_media_tx *tx,
+			   struct bt_l2cap_br_chan *chan,
+			   struct net_buf_pool *pool, u16_t frame_samples);
+
+/** @brief Reserve room for the next SBC frame.
+ *
+ *  The encoder writes the frame directly to the returned memory, which is
+ *  inside the media packet buffer. Frames are packed into the current
+ *  packet until the next one would exceed the channel MTU or the SBC frame
+ *  count limit, at which point the packet is sent and a new one started.
+ *
+ *  @param tx Media transport.
+ *  @param len Length of the SBC frame.
+ *
+ *  @return Pointer to write the frame to, or NULL if no buffer is
+ *  available, the frame does not fit the MTU or sending failed.
+ */
+u8_t *bt_a2dp_media_tx_frame(struct bt_a2dp_media_tx *tx, u16_t len);
+
+/** @brief Send the media packet being filled.
+ *
+ *  @param tx Media transport.
+ *
+ *  @return 0 in case of success (or if there was nothing to send) and
+ *  error code in case of error, in which case the packet is dropped.
+ */
+int bt_a2dp_media_tx_flush(struct bt_a2dp_media_tx *tx);
+
+/** @brief Initialize a sink media transport.
+ *
+ *  @param rx Media transport.
+ *  @param pool Pool of buffers the received media packets are copied to.
+ *  @param frame_samples Audio samples per SBC frame.
+ *  @param target Buffered duration, in samples, needed before playing.
+ */
+void bt_a2dp_media_rx_init(struct bt_a2dp_media_rx *rx,
+			   struct net_buf_pool *pool, u16_t frame_samples,
+			   u32_t target);
+
+/** @brief Queue a received media packet.
+ *
+ *  To be called from the recv callback of the transport channel. The
+ *  packet is copied so that the incoming buffer is released right away.
+ *  Packets are kept ordered by sequence number; duplicates and packets
+ *  arriving after their slot was played are dropped.
+ *
+ *  @param rx Media transport.
+ *  @param buf Received media packet.
+ *
+ *  @return 0 in case of success and error code in case of error.
+ */
+int bt_a2dp_media_rx_recv(struct bt_a2dp_media_rx *rx, struct net_buf *buf);
+
+/** @brief Get the next media packet to play.
+ *
+ *  Nothing is returned until the buffered media covers the target
+ *  duration, and again after the buffer has run empty.
+ *
+ *  @param rx Media transport.
+ *  @param ts Timestamp of the first SBC frame in the packet.
+ *  @param frames Number of SBC frames in the packet.
+ *
+ *  @return Buffer holding the SBC frames, to be released with
+ *  net_buf_unref(), or NULL if nothing is to be played yet.
+ */
+struct net_buf *bt_a2dp_media_rx_get(struct bt_a2dp_media_rx *rx,
+				     u32_t *ts, u8_t *frames);
+
+/** @brief Release all buffered media packets.
+ *
+ *  @param rx Media transport.
+ */
+void bt_a2dp_media_rx_reset(struct bt_a2dp_media_rx *rx);
+
 #ifdef __cplusplus
 }
 #endif
@@ -158,6 +158,31 @@ struct bt_conn_info {
  */
 int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info);
 
+/** @brief Connection TX statistics
+ *
+ *  @param pkts ACL packets handed to the controller
+ *  @param bytes ACL payload bytes handed to the controller
+ *  @param stalls Times sending had to wait for a free controller buffer
+ */
+struct bt_conn_tx_stats {
+	u32_t pkts;
+	u32_t bytes;
+	u32_t stalls;
+};
+
+/** @brief Get connection TX statistics
+ *
+ *  The counters start from zero when the connection is created, sampling
+ *  them periodically gives the throughput of the connection.
+ *
+ *  @param conn Connection object.
+ *  @param stats Connection TX statistics object.
+ *
+ *  @return Zero on success or (negative) error code on failure.
+ */
+int bt_conn_get_tx_stats(const struct bt_conn *conn,
+			 struct bt_conn_tx_stats *stats);
+
 /** @brief Update the connection parameters.
  *
  *  @param conn Connection object.
@@ -128,6 +128,14 @@ struct bt_hci_cp_vs_set_scan_req_reports {
 	u8_t  enable;
 } __packed;
 
+#define BT_HCI_VS_SCAN_PATTERN_LEN_MAX          29
+#define BT_HCI_OP_VS_SET_SCAN_PATTERN           BT_OP(BT_OGF_VS, 0x000e)
+struct bt_hci_cp_vs_set_scan_pattern {
+	u8_t  ad_type;
+	u8_t  len;
+	u8_t  data[0];
+} __packed;
+
 /* Events */
 
 struct bt_hci_evt_vs {
@@ -191,7 +191,9 @@ struct bt_l2cap_chan_ops {
 	/** Channel alloc_buf callback
 	 *
 	 *  If this callback is provided the channel will use it to allocate
-	 *  buffers to store incoming data.
+	 *  buffers to store incoming data. Otherwise the segments of an
+	 *  incoming SDU are passed to recv as they were received, chained
+	 *  as fragments of the first one, without copying.
 	 *
 	 *  @param chan The channel requesting a buffer.
 	 *
@@ -212,6 +214,14 @@ struct bt_l2cap_chan_ops {
  */
 #define BT_L2CAP_CHAN_SEND_RESERVE (CONFIG_BT_HCI_RESERVE + 4 + 4)
 
+/** @def BT_L2CAP_SDU_CHAN_SEND_RESERVE
+ *  @brief Headroom needed for outgoing buffers starting an SDU
+ *
+ *  Fragments of an outgoing SDU with this headroom, and which fit in a
+ *  segment, are sent as they are instead of being copied.
+ */
+#define BT_L2CAP_SDU_CHAN_SEND_RESERVE (BT_L2CAP_CHAN_SEND_RESERVE + 2)
+
 /** @brief L2CAP Server structure. */
 struct bt_l2cap_server {
 	/** Server PSM. Possible values:
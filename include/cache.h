@@ -24,6 +24,18 @@ extern "C" {
 	extern _sys_cache_flush_sig(sys_cache_flush);
 #endif
 
+/*
+ * Discard the d-cache lines of a buffer, e.g. before reading what a DMA
+ * engine wrote there. Dirty lines are not written back: the buffer is to be
+ * flushed before it is handed to the device. The flush instructions of x86
+ * invalidate the lines as well.
+ */
+#if defined(CONFIG_X86)
+	#define sys_cache_invalidate sys_cache_flush
+#else
+	extern _sys_cache_flush_sig(sys_cache_invalidate);
+#endif
+
 #else
 
 /*
@@ -43,6 +55,14 @@ static inline _sys_cache_flush_sig(sys_cache_flush)
 	/* do nothing */
 }
 
+static inline _sys_cache_flush_sig(sys_cache_invalidate)
+{
+	ARG_UNUSED(virt);
+	ARG_UNUSED(size);
+
+	/* do nothing */
+}
+
 #endif /* CACHE_FLUSHING */
 
 #if defined(CONFIG_CACHE_LINE_SIZE_DETECT)
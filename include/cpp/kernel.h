@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief C++ wrappers for kernel objects
+ *
+ * The wrappers are references to kernel objects defined with the usual
+ * K_*_DEFINE() macros, so the objects stay in the kernel object sections
+ * where the kernel (and userspace permission tracking) expects them. The
+ * wrappers are constexpr, have no virtual methods and never allocate:
+ * their inline methods compile to the same calls as the C API.
+ */
+
+#ifndef __CPP_KERNEL_H__
+#define __CPP_KERNEL_H__
+
+#ifndef __cplusplus
+#error "This header is for C++ only"
+#endif
+
+#include <kernel.h>
+
+namespace zephyr {
+
+/**
+ * @brief Reference to a mutex defined with K_MUTEX_DEFINE().
+ */
+class mutex {
+public:
+	constexpr explicit mutex(struct k_mutex &m) : m_mutex(m) {}
+
+	int lock(s32_t timeout = K_FOREVER)
+	{
+		return k_mutex_lock(&m_mutex, timeout);
+	}
+
+	void unlock()
+	{
+		k_mutex_unlock(&m_mutex);
+	}
+
+	struct k_mutex *native_handle() const
+	{
+		return &m_mutex;
+	}
+
+private:
+	struct k_mutex &m_mutex;
+};
+
+/**
+ * @brief Lock a mutex for the lifetime of the guard.
+ *
+ * The mutex is locked without timeout, which cannot fail, and unlocked
+ * when the guard goes out of scope.
+ */
+template <typename Mutex>
+class lock_guard {
+public:
+	explicit lock_guard(Mutex &m) : m_mutex(m)
+	{
+		m_mutex.lock(K_FOREVER);
+	}
+
+	~lock_guard()
+	{
+		m_mutex.unlock();
+	}
+
+	lock_guard(const lock_guard &) = delete;
+	lock_guard &operator=(const lock_guard &) = delete;
+
+private:
+	Mutex &m_mutex;
+};
+
+/**
+ * @brief Typed reference to a message queue of T.
+ *
+ * Messages are copied byte by byte by the kernel, so T must be trivially
+ * copyable. Define the queue with ZEPHYR_MSGQ_DEFINE() so that its
+ * message size and alignment match T.
+ */
+template <typename T>
+class msgq {
+public:
+	constexpr explicit msgq(struct k_msgq &q) : m_msgq(q) {}
+
+	int put(const T &msg, s32_t timeout = K_NO_WAIT)
+	{
+		return k_msgq_put(&m_msgq, const_cast<T *>(&msg), timeout);
+	}
+
+	int get(T &msg, s32_t timeout = K_FOREVER)
+	{
+		return k_msgq_get(&m_msgq, &msg, timeout);
+	}
+
+	u32_t num_used() const
+	{
+		return k_msgq_num_used_get(&m_msgq);
+	}
+
+	u32_t num_free() const
+	{
+		return k_msgq_num_free_get(&m_msgq);
+	}
+
+	void purge()
+	{
+		k_msgq_purge(&m_msgq);
+	}
+
+	struct k_msgq *native_handle() const
+	{
+		return &m_msgq;
+	}
+
+private:
+	struct k_msgq &m_msgq;
+};
+
+/** @internal Size of a memory slab block holding a T */
+template <typename T>
+constexpr size_t slab_block_size()
+{
+	return (sizeof(T) + sizeof(void *) - 1) / sizeof(void *) *
+	       sizeof(void *);
+}
+
+/** @internal Alignment of a memory slab of T */
+template <typename T>
+constexpr size_t slab_align()
+{
+	return alignof(T) > sizeof(void *) ? alignof(T) : sizeof(void *);
+}
+
+/**
+ * @brief Typed reference to a memory slab of blocks holding a T.
+ *
+ * The blocks are not constructed: the storage of a T is returned as is.
+ * Define the slab with ZEPHYR_MEM_SLAB_DEFINE().
+ */
+template <typename T>
+class mem_slab {
+public:
+	constexpr explicit mem_slab(struct k_mem_slab &slab) : m_slab(slab) {}
+
+	/** @return The block, or NULL if none was free before the timeout */
+	T *alloc(s32_t timeout = K_NO_WAIT)
+	{
+		void *mem;
+
+		if (k_mem_slab_alloc(&m_slab, &mem, timeout)) {
+			return NULL;
+		}
+
+		return static_cast<T *>(mem);
+	}
+
+	void free(T *block)
+	{
+		void *mem = block;
+
+		k_mem_slab_free(&m_slab, &mem);
+	}
+
+	u32_t num_free() const
+	{
+		return k_mem_slab_num_free_get(&m_slab);
+	}
+
+	struct k_mem_slab *native_handle() const
+	{
+		return &m_slab;
+	}
+
+private:
+	struct k_mem_slab &m_slab;
+};
+
+} /* namespace zephyr */
+
+/**
+ * @brief Statically define a mutex and its C++ wrapper.
+ *
+ * The mutex itself is named name_obj.
+ */
+#define ZEPHYR_MUTEX_DEFINE(name)					\
+	K_MUTEX_DEFINE(name##_obj);					\
+	static zephyr::mutex name(name##_obj)
+
+/**
+ * @brief Statically define a message queue of type and its C++ wrapper.
+ *
+ * The message queue itself is named name_obj.
+ */
+#define ZEPHYR_MSGQ_DEFINE(name, type, max_msgs)			\
+	K_MSGQ_DEFINE(name##_obj, sizeof(type), max_msgs, alignof(type)); \
+	static zephyr::msgq<type> name(name##_obj)
+
+/**
+ * @brief Statically define a memory slab of type and its C++ wrapper.
+ *
+ * The memory slab itself is named name_obj.
+ */
+#define ZEPHYR_MEM_SLAB_DEFINE(name, type, num_blocks)			\
+	K_MEM_SLAB_DEFINE(name##_obj, zephyr::slab_block_size<type>(),	\
+			  num_blocks, zephyr::slab_align<type>());	\
+	static zephyr::mem_slab<type> name(name##_obj)
+
+#endif /* __CPP_KERNEL_H__ */
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief C++ wrapper owning a network buffer reference
+ */
+
+#ifndef __CPP_NET_BUF_H__
+#define __CPP_NET_BUF_H__
+
+#ifndef __cplusplus
+#error "This header is for C++ only"
+#endif
+
+#include <net/buf.h>
+
+namespace zephyr {
+
+/**
+ * @brief Owner of one reference to a network buffer.
+ *
+ * The reference is released when the owner goes out of scope. Owners
+ * can be moved but not copied, a new reference being taken explicitly
+ * with ref(). The owner is the size of a pointer and has no virtual
+ * methods.
+ */
+class net_buf_ptr {
+public:
+	constexpr net_buf_ptr() : m_buf(NULL) {}
+
+	/** Take over the reference held by the caller on buf */
+	constexpr explicit net_buf_ptr(struct net_buf *buf) : m_buf(buf) {}
+
+	net_buf_ptr(net_buf_ptr &&other) : m_buf(other.release()) {}
+
+	net_buf_ptr &operator=(net_buf_ptr &&other)
+	{
+		reset(other.release());
+		return *this;
+	}
+
+	net_buf_ptr(const net_buf_ptr &) = delete;
+	net_buf_ptr &operator=(const net_buf_ptr &) = delete;
+
+	~net_buf_ptr()
+	{
+		if (m_buf) {
+			net_buf_unref(m_buf);
+		}
+	}
+
+	static net_buf_ptr alloc(struct net_buf_pool *pool,
+				 s32_t timeout = K_NO_WAIT)
+	{
+		return net_buf_ptr(net_buf_alloc(pool, timeout));
+	}
+
+	/** @return A new owner of another reference to the buffer */
+	net_buf_ptr ref() const
+	{
+		return net_buf_ptr(m_buf ? net_buf_ref(m_buf) : NULL);
+	}
+
+	/** Give up the reference without releasing it */
+	struct net_buf *release()
+	{
+		struct net_buf *buf = m_buf;
+
+		m_buf = NULL;
+		return buf;
+	}
+
+	/** Release the reference, then take over the one on buf */
+	void reset(struct net_buf *buf = NULL)
+	{
+		struct net_buf *old = m_buf;
+
+		m_buf = buf;
+		if (old) {
+			net_buf_unref(old);
+		}
+	}
+
+	/** Hand the reference over to a FIFO */
+	void put(struct k_fifo *fifo)
+	{
+		net_buf_put(fifo, release());
+	}
+
+	struct net_buf *get() const
+	{
+		return m_buf;
+	}
+
+	struct net_buf *operator->() const
+	{
+		return m_buf;
+	}
+
+	explicit operator bool() const
+	{
+		return m_buf != NULL;
+	}
+
+	u8_t *data() const
+	{
+		return m_buf->data;
+	}
+
+	u16_t len() const
+	{
+		return m_buf->len;
+	}
+
+	size_t tailroom() const
+	{
+		return net_buf_tailroom(m_buf);
+	}
+
+	void *add(size_t len)
+	{
+		return net_buf_add(m_buf, len);
+	}
+
+	void *pull(size_t len)
+	{
+		return net_buf_pull(m_buf, len);
+	}
+
+private:
+	struct net_buf *m_buf;
+};
+
+} /* namespace zephyr */
+
+#endif /* __CPP_NET_BUF_H__ */
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+/** @file
+ * @brief CRC 32 computation function
+ */
+
+#ifndef __CRC32_H
+#define __CRC32_H
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @defgroup crc32 CRC 32
+ * @ingroup checksum
+ * @{
+ */
+
+/**
+ * @brief Update an IEEE CRC 32 with the content of a buffer.
+ *
+ * Continues the computation of a CRC over non-contiguous blocks: use 0
+ * as the crc of the first block, then the return value from block N-1
+ * for block N.
+ *
+ * @param crc CRC of the previous blocks
+ * @param data Input bytes for the computation
+ * @param len Length of the input in bytes
+ *
+ * @return The CRC32 value of all the blocks so far
+ */
+u32_t crc32_ieee_update(u32_t crc, const u8_t *data, size_t len);
+
+/**
+ * @brief Compute the IEEE CRC 32 of a buffer.
+ *
+ * The checksum of Ethernet, zlib and PNG: uses 0x04C11DB7 as the
+ * polynomial, 0xffffffff as the initial value and final XOR, and
+ * reflects the input and the output.
+ *
+ * @param data Input bytes for the computation
+ * @param len Length of the input in bytes
+ *
+ * @return The computed CRC32 value
+ */
+static inline u32_t crc32_ieee(const u8_t *data, size_t len)
+{
+	return crc32_ieee_update(0, data, len);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
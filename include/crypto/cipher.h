@@ -22,6 +22,7 @@
 #include <misc/util.h>
 #include <misc/__assert.h>
 #include "cipher_structs.h"
+#include "hash_structs.h"
 
 /* The API a crypto driver should implement */
 struct crypto_driver_api {
@@ -38,6 +39,13 @@ struct crypto_driver_api {
 	/* Register async crypto op completion callback with the driver*/
 	int (*crypto_async_callback_set)(struct device *dev,
 					 crypto_completion_cb cb);
+
+	/* Setup a hash session, optional */
+	int (*hash_begin_session)(struct device *dev, struct hash_ctx *ctx,
+				  enum hash_algo algo);
+
+	/* Tear down an established hash session */
+	int (*hash_free_session)(struct device *dev, struct hash_ctx *ctx);
 };
 
 /* Following are the calls an app could make to get cipher stuff done.
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Crypto Hash APIs
+ *
+ * This file contains the hash APIs of the Crypto Abstraction layer. Hash
+ * sessions are provided by the same drivers as cipher sessions.
+ *
+ * [Experimental] Users should note that the APIs can change
+ * as a part of ongoing development.
+ */
+
+#ifndef __CRYPTO_HASH_H__
+#define __CRYPTO_HASH_H__
+
+#include <crypto/cipher.h>
+
+/*
+ * @brief Setup a hash session
+ *
+ * The session computes an HMAC when ctx->key is set, a plain hash
+ * otherwise.
+ *
+ * @param[in]  dev      Pointer to the device structure for the driver instance.
+ * @param[in]  ctx      Pointer to the context structure, key, keylen and
+ *			flags are to be populated by the app before this call.
+ * @param[in]  algo     The hash algorithm to be used in this session.
+ *
+ * @return 0 on success, -ENOTSUP if the driver does not support hashing,
+ *			  negative errno code on fail.
+ */
+static inline int hash_begin_session(struct device *dev,
+				     struct hash_ctx *ctx,
+				     enum hash_algo algo)
+{
+	struct crypto_driver_api *api;
+
+	api = (struct crypto_driver_api *) dev->driver_api;
+	ctx->device = dev;
+
+	if (!api->hash_begin_session) {
+		return -ENOTSUP;
+	}
+
+	return api->hash_begin_session(dev, ctx, algo);
+}
+
+/*
+ * @brief Cleanup a hash session
+ *
+ * @param[in]  dev      Pointer to the device structure for the driver instance.
+ * @param[in]  ctx      Pointer to the hash context structure, of the session
+ *			 to be freed.
+ *
+ * @return 0 on success, negative errno code on fail.
+ */
+static inline int hash_free_session(struct device *dev,
+				    struct hash_ctx *ctx)
+{
+	struct crypto_driver_api *api;
+
+	api = (struct crypto_driver_api *) dev->driver_api;
+
+	return api->hash_free_session(dev, ctx);
+}
+
+/*
+ * @brief Add data to the hash of a session
+ *
+ * @param[in]  ctx       Pointer to the hash context of this op.
+ * @param[in]  pkt       Structure holding the data to be hashed.
+ *
+ * @return 0 on success, negative errno code on fail.
+ */
+static inline int hash_update(struct hash_ctx *ctx, struct hash_pkt *pkt)
+{
+	pkt->ctx = ctx;
+	return ctx->hash_hndlr(ctx, pkt, false);
+}
+
+/*
+ * @brief Add the last data to the hash of a session and get the digest
+ *
+ * The session is then ready for a new hash, with the same key.
+ *
+ * @param[in]  ctx       Pointer to the hash context of this op.
+ * @param[in/out]  pkt   Structure holding the data to be hashed and the
+ *			 digest buffer.
+ *
+ * @return 0 on success, negative errno code on fail.
+ */
+static inline int hash_compute(struct hash_ctx *ctx, struct hash_pkt *pkt)
+{
+	pkt->ctx = ctx;
+	return ctx->hash_hndlr(ctx, pkt, true);
+}
+
+#endif /* __CRYPTO_HASH_H__ */
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Crypto Hash structure definitions
+ *
+ * This file contains the structures of the hash sessions of the Crypto
+ * Abstraction layer.
+ *
+ * [Experimental] Users should note that the Structures can change
+ * as a part of ongoing development.
+ */
+
+#ifndef __CRYPTO_HASH_STRUCTS_H__
+#define __CRYPTO_HASH_STRUCTS_H__
+
+#include <device.h>
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+enum hash_algo {
+	CRYPTO_HASH_ALGO_SHA224 = 1,
+	CRYPTO_HASH_ALGO_SHA256 = 2,
+};
+
+/* Forward declarations */
+struct hash_ctx;
+struct hash_pkt;
+
+/* Function signature for hashing, the digest is written out and the
+ * session restarted when finish is true.
+ */
+typedef int (*hash_op_t)(struct hash_ctx *ctx, struct hash_pkt *pkt,
+			 bool finish);
+
+/* Structure encoding the parameters of a hash session, see
+ * struct cipher_ctx for the contract of the common fields.
+ */
+struct hash_ctx {
+
+	/* Function to be invoked per hash operation. To be populated by
+	 * the crypto driver on return from hash_begin_session().
+	 */
+	hash_op_t hash_hndlr;
+
+	/* HMAC key, or NULL for a plain hash. To be populated by the app
+	 * before calling hash_begin_session().
+	 */
+	const u8_t *key;
+
+	/* The device driver instance this hash context relates to. Will be
+	 * populated by the hash_begin_session() API.
+	 */
+	struct device *device;
+
+	/* Driver state of this session, populated by the driver on return
+	 * from hash_begin_session()
+	 */
+	void *drv_sessn_state;
+
+	/* HMAC key length in bytes. To be populated by the app before
+	 * calling hash_begin_session()
+	 */
+	u16_t keylen;
+
+	/* CAP_* flags of the session, as for cipher sessions. To be
+	 * populated by the app before calling hash_begin_session().
+	 */
+	u16_t flags;
+};
+
+/* Structure encoding IO parameters of one hash operation */
+struct hash_pkt {
+
+	/* Start address of the data to be hashed */
+	const u8_t *in_buf;
+
+	/* Bytes to be hashed */
+	size_t in_len;
+
+	/* Digest, to be allocated by the application with room for the
+	 * digest of the algorithm. Only written when the hash is finished.
+	 */
+	u8_t *out_buf;
+
+	/* Context this packet relates to. Will be populated by the
+	 * hash_update() and hash_compute() APIs.
+	 */
+	struct hash_ctx *ctx;
+};
+
+#endif /* __CRYPTO_HASH_STRUCTS_H__ */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Scheduler tracing
+ *
+ * Records scheduling events in per-CPU binary ring buffers, without locking,
+ * and hands them out in packets for streaming to a host. All the recording
+ * hooks compile to nothing when CONFIG_SCHED_TRACE is disabled.
+ */
+
+#ifndef _SCHED_TRACE_H_
+#define _SCHED_TRACE_H_
+
+/* event identifiers */
+
+#define SCHED_TRACE_SWITCH_OUT	1	/* arg: outgoing thread */
+#define SCHED_TRACE_SWITCH_IN	2	/* arg: incoming thread */
+#define SCHED_TRACE_ISR_ENTER	3
+#define SCHED_TRACE_ISR_EXIT	4
+#define SCHED_TRACE_PEND	5	/* arg: pending thread */
+#define SCHED_TRACE_UNPEND	6	/* arg: unpended thread */
+#define SCHED_TRACE_TIMEOUT	7	/* arg: expired timeout */
+
+/* first word of every packet */
+#define SCHED_TRACE_PACKET_MAGIC 0xc1fc1fc1
+
+#ifndef _ASMLANGUAGE
+
+#include <zephyr/types.h>
+#include <toolchain.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Trace event, as found in packets
+ *
+ * @a timestamp comes from k_cycle_get_32(). For thread events, @a data is
+ * the priority of the thread.
+ */
+struct sched_trace_event {
+	u32_t timestamp;
+	u32_t arg;
+	u16_t id;
+	u16_t data;
+};
+
+/**
+ * @brief Trace packet header
+ *
+ * Each packet holds @a count events recorded on CPU @a cpu, in order.
+ * @a dropped is the number of events lost on that CPU since the previous
+ * packet because its buffer was full.
+ */
+struct sched_trace_packet_header {
+	u32_t magic;
+	u16_t cpu;
+	u16_t count;
+	u32_t dropped;
+};
+
+#ifdef CONFIG_SCHED_TRACE
+
+extern void _sched_trace_event(u16_t id, u32_t arg, u16_t data);
+extern void _sched_trace_isr_enter(void);
+extern void _sched_trace_isr_exit(void);
+
+/**
+ * @brief Fetch recorded events as one packet
+ *
+ * Builds a packet, header first, out of the events recorded on the next CPU
+ * having some, in a round-robin fashion. Only one context at a time may drain
+ * the trace buffers.
+ *
+ * @param buf Destination buffer
+ * @param len Size of @a buf, at least one header and one event
+ *
+ * @return Size of the packet written to @a buf, 0 if there is no event.
+ */
+extern size_t sched_trace_drain(void *buf, size_t len);
+
+#define _SCHED_TRACE_THREAD(id, thread) \
+	_sched_trace_event(id, (u32_t)(uintptr_t)(thread), \
+			   (u16_t)(thread)->base.prio)
+
+#define _sched_trace_switch_out(thread) \
+	_SCHED_TRACE_THREAD(SCHED_TRACE_SWITCH_OUT, thread)
+#define _sched_trace_switch_in(thread) \
+	_SCHED_TRACE_THREAD(SCHED_TRACE_SWITCH_IN, thread)
+#define _sched_trace_pend(thread) \
+	_SCHED_TRACE_THREAD(SCHED_TRACE_PEND, thread)
+#define _sched_trace_unpend(thread) \
+	_SCHED_TRACE_THREAD(SCHED_TRACE_UNPEND, thread)
+#define _sched_trace_timeout(timeout) \
+	_sched_trace_event(SCHED_TRACE_TIMEOUT, (u32_t)(uintptr_t)(timeout), 0)
+
+#else
+
+#define _sched_trace_switch_out(thread) do { } while ((0))
+#define _sched_trace_switch_in(thread) do { } while ((0))
+#define _sched_trace_pend(thread) do { } while ((0))
+#define _sched_trace_unpend(thread) do { } while ((0))
+#define _sched_trace_timeout(timeout) do { } while ((0))
+
+#endif /* CONFIG_SCHED_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !_ASMLANGUAGE */
+
+#endif /* _SCHED_TRACE_H_ */
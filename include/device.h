@@ -240,6 +240,67 @@ struct device {
 
 void _sys_device_do_config_level(int level);
 
+#if defined(CONFIG_DEVICE_INIT_DEFERRED)
+void _sys_device_deferred_start(void);
+
+/**
+ * @brief Finish the initialization of a device on another thread
+ *
+ * Called by the init function of a driver, at any level, to run the slow
+ * part of the initialization, init, on one of the deferred initialization
+ * threads once the kernel runs. The boot goes on meanwhile. The driver API
+ * should be usable once init returns, users wait for it with
+ * device_init_wait(). When no more deferred initialization can be queued,
+ * init is called before returning.
+ *
+ * The dependencies of a device are waited for by its init function with
+ * device_init_wait(), which runs them there if no thread did yet.
+ *
+ * @param dev Pointer to device structure
+ * @param init Remaining initialization of the device
+ */
+void device_init_defer(struct device *dev, int (*init)(struct device *dev));
+
+/**
+ * @brief Wait for the deferred initialization of a device
+ *
+ * If no thread started it yet, the initialization is run by the caller.
+ * Before the kernel runs, only K_NO_WAIT may be used.
+ *
+ * @param dev Pointer to device structure
+ * @param timeout Waiting period in milliseconds, or one of the special
+ *        values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 if the device has no deferred initialization.
+ * @retval -EAGAIN if it did not end within the timeout.
+ * @return the value returned by the deferred initialization otherwise.
+ */
+int device_init_wait(struct device *dev, s32_t timeout);
+#else
+static inline void device_init_defer(struct device *dev,
+				     int (*init)(struct device *dev))
+{
+	init(dev);
+}
+
+static inline int device_init_wait(struct device *dev, s32_t timeout)
+{
+	return 0;
+}
+#endif /* CONFIG_DEVICE_INIT_DEFERRED */
+
+#if defined(CONFIG_BOOT_INIT_PROFILE)
+/**
+ * @brief Print the time taken by each init function
+ *
+ * @details Prints one line per device or SYS_INIT() entry run so far, in
+ * initialization order, with the address of its init function, its start
+ * time and its duration in hardware cycles. scripts/init_profile.py turns
+ * this output into a report.
+ */
+void device_init_profile_print(void);
+#endif
+
 /**
  * @brief Retrieve the device structure for a driver by name
  *
@@ -248,6 +309,10 @@ void _sys_device_do_config_level(int level);
  * it can use this function to retrieve the device structure of the lower level
  * driver by the name the driver exposes to the system.
  *
+ * Devices defined in the same file are better referenced with DEVICE_GET(),
+ * which needs no lookup. With CONFIG_DEVICE_BINDING_HASH the lookup is
+ * done in a hash table rather than by comparing every device name.
+ *
  * @param name device name to search for.
  *
  * @return pointer to device structure; NULL if not found or cannot be used.
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __DELTA_IMG_H__
+#define __DELTA_IMG_H__
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+#include <dfu/flash_img.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Patch format, all integers are little endian:
+ *
+ * header:  u32 magic (DELTA_IMG_MAGIC), u32 size of the new image
+ * records: u32 diff length, u32 extra length, s32 source adjustment,
+ *          diff data, diff length bytes once decoded,
+ *          extra length bytes copied to the new image as is.
+ *
+ * Diff data is added byte by byte to the image in slot 0, starting at the
+ * source offset. It is coded in runs: a byte with the top bit set stands
+ * for (byte & 0x7f) + 1 bytes of the old image copied unchanged, a byte
+ * with the top bit clear is followed by byte + 1 values to add. After the
+ * extra data the source offset moves by the adjustment. Records follow
+ * each other until the new image is complete.
+ */
+#define DELTA_IMG_MAGIC 0x544c4544 /* "DELT" */
+
+#define DELTA_IMG_HDR_SIZE 12
+
+struct delta_img_context {
+	struct flash_img_context img;
+	u8_t hdr[DELTA_IMG_HDR_SIZE];
+	u8_t hdr_len;
+	u8_t state;
+	u8_t run_left;
+	bool run_copy;
+	u32_t img_size;
+	u32_t out_bytes;
+	off_t src_off;
+	u32_t diff_left;
+	u32_t extra_left;
+	s32_t adjust;
+};
+
+/**
+ * @brief Initialize context needed for applying a patch.
+ *
+ * @param ctx context to be initialized
+ * @param dev flash driver holding the image slots
+ */
+void delta_img_init(struct delta_img_context *ctx, struct device *dev);
+
+/**
+ * @brief Apply the next part of a patch.
+ *
+ * The image in slot 0 is patched into image slot 1 as the patch is
+ * received, the new image is written out through the image writer. The
+ * progress can be read with flash_img_bytes_written() on ctx->img.
+ *
+ * @param ctx context
+ * @param data patch data
+ * @param len Number of bytes of patch data
+ * @param flush true for the end of the patch, the new image is then
+ * written out completely
+ *
+ * @return  0 on success, -EINVAL on a malformed or truncated patch,
+ * negative errno code of the flash access otherwise.
+ */
+int delta_img_write(struct delta_img_context *ctx, const u8_t *data,
+		    size_t len, bool flush);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif	/* __DELTA_IMG_H__ */
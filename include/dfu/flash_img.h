@@ -8,12 +8,39 @@
 #ifndef __FLASH_IMG_H__
 #define __FLASH_IMG_H__
 
+#if defined(CONFIG_IMG_WRITE_ASYNC)
+#include <kernel.h>
+#include <flash.h>
+#endif
+#if defined(CONFIG_IMG_HASH_SHA256)
+#include <tinycrypt/sha256.h>
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 struct flash_img_context {
+#if defined(CONFIG_IMG_WRITE_ASYNC)
+	u8_t bufs[2][CONFIG_IMG_BLOCK_BUF_SIZE];
+	u8_t *buf; /* block being collected */
+	struct flash_async_req req;
+	struct k_sem done;
+	int write_rc;
+	bool pending;
+#else
 	u8_t buf[CONFIG_IMG_BLOCK_BUF_SIZE];
+#endif
+#if defined(CONFIG_IMG_ERASE_PROGRESSIVELY)
+#if defined(CONFIG_IMG_WRITE_ASYNC)
+	struct flash_async_req erase_req;
+	int erase_rc;
+#endif
+	off_t erased_end; /* end of the erased part of the slot */
+#endif
+#if defined(CONFIG_IMG_HASH_SHA256)
+	struct tc_sha256_state_struct sha;
+#endif
 	struct device *dev;
 	size_t bytes_written;
 	u16_t buf_bytes;
@@ -56,6 +83,21 @@ size_t flash_img_bytes_written(struct flash_img_context *ctx);
 int flash_img_buffered_write(struct flash_img_context *ctx, u8_t *data,
 		    size_t len, bool flush);
 
+#if defined(CONFIG_IMG_HASH_SHA256)
+/**
+ * @brief Get the SHA-256 digest of the data passed to the image writer.
+ *
+ * The padding of the last block is not part of the digest. To be called
+ * once, after the final flash_img_buffered_write() call.
+ *
+ * @param ctx context
+ * @param digest buffer of TC_SHA256_DIGEST_SIZE bytes for the digest
+ *
+ * @return  0 on success, negative errno code on fail
+ */
+int flash_img_hash_get(struct flash_img_context *ctx, u8_t *digest);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
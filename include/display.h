@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Public API for display drivers and framebuffers
+ */
+
+#ifndef __DISPLAY_H__
+#define __DISPLAY_H__
+
+/**
+ * @brief Display Interface
+ * @defgroup display_interface Display Interface
+ * @ingroup io_interfaces
+ * @{
+ */
+
+#include <device.h>
+#include <errno.h>
+#include <kernel.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Display capabilities
+ *
+ * @param x_resolution Width of the display in pixels
+ * @param y_resolution Height of the display in pixels
+ * @param bytes_per_pixel Size of a pixel in the buffers written
+ */
+struct display_capabilities {
+	u16_t x_resolution;
+	u16_t y_resolution;
+	u8_t bytes_per_pixel;
+};
+
+/**
+ * @brief Description of a buffer written to the display
+ *
+ * @param width Width of the region written, in pixels
+ * @param height Height of the region written, in pixels
+ * @param pitch Distance between the starts of two lines in the buffer, in
+ *        pixels
+ */
+struct display_buffer_descriptor {
+	u16_t width;
+	u16_t height;
+	u16_t pitch;
+};
+
+/**
+ * @typedef display_api_write
+ * @brief Callback API to write a region of the display
+ * See display_write() for argument description
+ */
+typedef int (*display_api_write)(struct device *dev, u16_t x, u16_t y,
+				 const struct display_buffer_descriptor *desc,
+				 const void *buf);
+
+/**
+ * @typedef display_api_sync
+ * @brief Callback API to wait for an asynchronous write
+ * See display_sync() for argument description
+ */
+typedef int (*display_api_sync)(struct device *dev, s32_t timeout);
+
+/**
+ * @typedef display_api_blanking
+ * @brief Callback API to turn the display on or off
+ * See display_blanking_on() for argument description
+ */
+typedef int (*display_api_blanking)(struct device *dev, bool blank);
+
+/**
+ * @typedef display_api_get_capabilities
+ * @brief Callback API to get the capabilities of the display
+ * See display_get_capabilities() for argument description
+ */
+typedef void (*display_api_get_capabilities)(struct device *dev,
+					     struct display_capabilities *caps);
+
+/**
+ * @brief Display driver API
+ */
+struct display_driver_api {
+	display_api_write write;
+	display_api_write write_async;
+	display_api_sync sync;
+	display_api_blanking blanking;
+	display_api_get_capabilities get_capabilities;
+};
+
+/**
+ * @brief Write a region of the display
+ *
+ * The function returns once the region is written.
+ *
+ * @param dev Pointer to device structure
+ * @param x x coordinate of the upper left corner
+ * @param y y coordinate of the upper left corner
+ * @param desc Description of the buffer
+ * @param buf Pixels of the region, desc->height lines of desc->width pixels
+ *
+ * @retval 0 on success else negative errno code.
+ */
+static inline int display_write(struct device *dev, u16_t x, u16_t y,
+				const struct display_buffer_descriptor *desc,
+				const void *buf)
+{
+	const struct display_driver_api *api = dev->driver_api;
+
+	return api->write(dev, x, y, desc, buf);
+}
+
+/**
+ * @brief Start writing a region of the display
+ *
+ * The function returns once the transfer is started, the buffer must not be
+ * modified until display_sync() returns. The buffer lines must be contiguous,
+ * that is desc->pitch equal to desc->width. Any other call to the driver
+ * waits for the transfer to end first. Drivers without asynchronous
+ * transfers write the region before returning.
+ *
+ * @param dev Pointer to device structure
+ * @param x x coordinate of the upper left corner
+ * @param y y coordinate of the upper left corner
+ * @param desc Description of the buffer
+ * @param buf Pixels of the region
+ *
+ * @retval 0 on success else negative errno code.
+ */
+static inline int display_write_async(struct device *dev, u16_t x, u16_t y,
+			const struct display_buffer_descriptor *desc,
+			const void *buf)
+{
+	const struct display_driver_api *api = dev->driver_api;
+
+	if (!api->write_async) {
+		return api->write(dev, x, y, desc, buf);
+	}
+
+	return api->write_async(dev, x, y, desc, buf);
+}
+
+/**
+ * @brief Wait for the end of an asynchronous write
+ *
+ * @param dev Pointer to device structure
+ * @param timeout Waiting period in milliseconds, or one of the special
+ *        values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 if no write is pending anymore.
+ * @retval -EAGAIN if the write did not end within the timeout.
+ * @retval -EIO if the write failed.
+ */
+static inline int display_sync(struct device *dev, s32_t timeout)
+{
+	const struct display_driver_api *api = dev->driver_api;
+
+	if (!api->sync) {
+		return 0;
+	}
+
+	return api->sync(dev, timeout);
+}
+
+/**
+ * @brief Turn the display on
+ *
+ * @param dev Pointer to device structure
+ *
+ * @retval 0 on success else negative errno code.
+ */
+static inline int display_blanking_off(struct device *dev)
+{
+	const struct display_driver_api *api = dev->driver_api;
+
+	return api->blanking(dev, false);
+}
+
+/**
+ * @brief Turn the display off
+ *
+ * @param dev Pointer to device structure
+ *
+ * @retval 0 on success else negative errno code.
+ */
+static inline int display_blanking_on(struct device *dev)
+{
+	const struct display_driver_api *api = dev->driver_api;
+
+	return api->blanking(dev, true);
+}
+
+/**
+ * @brief Get the capabilities of the display
+ *
+ * @param dev Pointer to device structure
+ * @param caps Capabilities of the display
+ */
+static inline void display_get_capabilities(struct device *dev,
+					    struct display_capabilities *caps)
+{
+	const struct display_driver_api *api = dev->driver_api;
+
+	api->get_capabilities(dev, caps);
+}
+
+#if defined(CONFIG_DISPLAY_FB)
+/**
+ * @brief Double buffered framebuffer
+ *
+ * The application draws into one full screen buffer and marks the regions
+ * it changed. display_fb_flush() starts sending the changed lines to the
+ * display and swaps the buffers, so that the next frame is drawn while the
+ * previous one is transferred. Changes are tracked as a range of lines,
+ * sent full width in a single contiguous transfer. All fields are private.
+ */
+struct display_fb {
+	struct device *dev;
+	u8_t *buf[2];
+	u8_t draw;
+	u8_t bytes_per_pixel;
+	u16_t width;
+	u16_t height;
+	/* changed lines of the buffer being drawn, dirty_y1 excluded */
+	u16_t dirty_y0;
+	u16_t dirty_y1;
+};
+
+/**
+ * @brief Initialize a framebuffer
+ *
+ * Each buffer must hold a full screen, x_resolution * y_resolution *
+ * bytes_per_pixel bytes as reported by display_get_capabilities(). The
+ * whole screen is considered changed, buf0 is the first buffer drawn.
+ *
+ * @param fb Framebuffer
+ * @param dev Display the framebuffer is shown on
+ * @param buf0 First buffer
+ * @param buf1 Second buffer
+ */
+void display_fb_init(struct display_fb *fb, struct device *dev,
+		     void *buf0, void *buf1);
+
+/**
+ * @brief Get the buffer to draw into
+ *
+ * Lines are stored one after the other, without padding. The buffer is
+ * valid until the next display_fb_flush().
+ *
+ * @param fb Framebuffer
+ *
+ * @return Buffer holding the current frame
+ */
+static inline void *display_fb_get(struct display_fb *fb)
+{
+	return fb->buf[fb->draw];
+}
+
+/**
+ * @brief Mark a region of the frame as changed
+ *
+ * @param fb Framebuffer
+ * @param x x coordinate of the upper left corner
+ * @param y y coordinate of the upper left corner
+ * @param w Width of the region
+ * @param h Height of the region
+ */
+void display_fb_mark_dirty(struct display_fb *fb, u16_t x, u16_t y,
+			   u16_t w, u16_t h);
+
+/**
+ * @brief Show the current frame
+ *
+ * Waits for the transfer of the previous frame, starts sending the lines
+ * changed since then and swaps the buffers. The changed lines are copied to
+ * the new drawing buffer, so that it holds the frame just shown.
+ *
+ * @param fb Framebuffer
+ *
+ * @retval 0 on success else negative errno code.
+ */
+int display_fb_flush(struct display_fb *fb);
+#endif /* CONFIG_DISPLAY_FB */
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* __DISPLAY_H__ */
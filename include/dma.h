@@ -15,6 +15,7 @@
 
 #include <kernel.h>
 #include <device.h>
+#include <errno.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -116,7 +117,13 @@ struct dma_block_config {
  *     dest_chaining_en     [ 18 ]      - enable/disable destination block
  *                                        chaining.
  *                                        0-disable, 1-enable
- *     reserved             [ 19 : 31 ]
+ *     cyclic               [ 19 ]      - 0-stop after the last block
+ *                                        1-restart with the head block after
+ *                                          the last block, until stopped
+ *     half_complete_callback_en [ 20 ] - 0-disable, 1-callback invoked with
+ *                                          DMA_STATUS_HALF_COMPLETE when
+ *                                          half of a block is transferred
+ *     reserved             [ 21 : 31 ]
  *
  *     source_data_size    [ 0 : 15 ]   - width of source data (in bytes)
  *     dest_data_size      [ 16 : 31 ]  - width of dest data (in bytes)
@@ -124,11 +131,13 @@ struct dma_block_config {
  *     dest_burst_length   [ 16 : 31 ]  - number of destination data units
  *
  *     block_count  is the number of blocks used for block chaining, this
- *     depends on availability of the DMA controller.
+ *     depends on availability of the DMA controller. The blocks are linked
+ *     through next_block, starting with head_block.
  *
  * dma_callback is the callback function pointer. If enabled, callback function
  *              will be invoked at transfer completion or when error happens
- *              (error_code: zero-transfer success, non zero-error happens).
+ *              (error_code: zero-transfer success, DMA_STATUS_HALF_COMPLETE-
+ *              half of a block transferred, other non zero-error happens).
  */
 struct dma_config {
 	u32_t  dma_slot :             6;
@@ -140,7 +149,9 @@ struct dma_config {
 	u32_t  channel_priority :     4;
 	u32_t  source_chaining_en :   1;
 	u32_t  dest_chaining_en :     1;
-	u32_t  reserved :            13;
+	u32_t  cyclic :               1;
+	u32_t  half_complete_callback_en : 1;
+	u32_t  reserved :            11;
 	u32_t  source_data_size :    16;
 	u32_t  dest_data_size :      16;
 	u32_t  source_burst_length : 16;
@@ -151,6 +162,9 @@ struct dma_config {
 			     int error_code);
 };
 
+/** Callback status: half of the current block has been transferred */
+#define DMA_STATUS_HALF_COMPLETE 1
+
 /**
  * @cond INTERNAL_HIDDEN
  *
@@ -165,10 +179,14 @@ typedef int (*dma_api_start)(struct device *dev, u32_t channel);
 
 typedef int (*dma_api_stop)(struct device *dev, u32_t channel);
 
+typedef int (*dma_api_reload)(struct device *dev, u32_t channel,
+			      u32_t src, u32_t dst, size_t size);
+
 struct dma_driver_api {
 	dma_api_config config;
 	dma_api_start start;
 	dma_api_stop stop;
+	dma_api_reload reload;
 };
 /**
  * @endcond
@@ -193,6 +211,38 @@ static inline int dma_config(struct device *dev, u32_t channel,
 	return api->config(dev, channel, config);
 }
 
+/**
+ * @brief Reload the buffer of a configured channel.
+ *
+ * The channel keeps its configuration, only the source, destination and size
+ * of a block are replaced. On a stopped channel the head block is replaced and
+ * dma_start() starts the new transfer. On a running cyclic channel with two or
+ * more blocks the block not being transferred is replaced, so that a stream
+ * can continue into a new buffer without a gap; the size must then be the one
+ * of the replaced block.
+ *
+ * @param dev     Pointer to the device structure for the driver instance.
+ * @param channel Numeric identification of the channel to reload
+ * @param src     Source address of the block
+ * @param dst     Destination address of the block
+ * @param size    Number of bytes of the block
+ *
+ * @retval 0 if successful.
+ * @retval -ENOTSUP if the driver does not support reloading.
+ * @retval Negative errno code if failure.
+ */
+static inline int dma_reload(struct device *dev, u32_t channel,
+			     u32_t src, u32_t dst, size_t size)
+{
+	const struct dma_driver_api *api = dev->driver_api;
+
+	if (!api->reload) {
+		return -ENOTSUP;
+	}
+
+	return api->reload(dev, channel, src, dst, size);
+}
+
 /**
  * @brief Enables DMA channel and starts the transfer, the channel must be
  *        configured beforehand.
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2018 Alexander Wachter
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _CAN_STM32_H_
+#define _CAN_STM32_H_
+
+#include <device.h>
+#include <zephyr/types.h>
+
+/**
+ * @brief Get the number of received messages a STM32 CAN controller lost
+ *
+ * The counters start at zero when the controller is initialized and
+ * are never reset.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param overrun Set to the messages lost as the RX FIFO overran.
+ * @param dropped Set to the messages lost as the message queue attached
+ *                to their filter was full.
+ */
+void can_stm32_get_rx_lost(struct device *dev, u32_t *overrun,
+			   u32_t *dropped);
+
+#endif /* _CAN_STM32_H_ */
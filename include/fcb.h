@@ -65,6 +65,10 @@ struct fcb {
 
 	const struct flash_area *fap; /* Flash area used by the fcb instance */
 				     /* This can be transfer to FCB user    */
+#if defined(CONFIG_FCB_SECTOR_CACHE)
+	/* Per sector, end of the elements already found to be valid */
+	u32_t f_valid_off[CONFIG_FCB_SECTOR_CACHE_SIZE];
+#endif
 };
 
 /*
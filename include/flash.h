@@ -270,6 +270,67 @@ static inline size_t _impl_flash_get_write_block_size(struct device *dev)
 	return api->write_block_size;
 }
 
+#if defined(CONFIG_FLASH_ASYNC)
+struct flash_async_req;
+
+/**
+ * @brief Callback type for the completion of an asynchronous flash request
+ *
+ * The callback is called from the flash request thread, the request may be
+ * reused from then on.
+ *
+ * @param req The request that completed
+ * @param result 0 on success, negative errno code on fail.
+ */
+typedef void (*flash_async_cb)(struct flash_async_req *req, int result);
+
+/**
+ * @brief Asynchronous flash request
+ *
+ * Filled in by the caller. The request, and the data of a write, must stay
+ * valid until its completion is reported. The callback and the signal are
+ * both optional, the signal is raised with the result of the request.
+ */
+struct flash_async_req {
+	sys_snode_t node;		/* used by the request queue */
+	struct device *dev;
+	off_t offset;
+	const void *data;		/* data to write, unused for erase */
+	size_t len;
+	flash_async_cb cb;
+	struct k_poll_signal *signal;
+	void *user_data;
+	u8_t _op;			/* set on submission */
+};
+
+/**
+ *  @brief  Queue a write of a buffer into flash memory
+ *
+ *  The write is done by the flash request thread, which also takes care of
+ *  the write protection. Requests are done in the order they are queued,
+ *  writes continuing each other on the same device may be done with a
+ *  single call to the driver.
+ *
+ *  @param  req             : write request
+ *
+ *  @return  0 on success, -EINVAL if the request is invalid.
+ */
+int flash_write_async(struct flash_async_req *req);
+
+/**
+ *  @brief  Queue an erase of part of a flash memory
+ *
+ *  The erase is done by the flash request thread, page by page when the
+ *  page layout is known, so that reads of other threads are not held back
+ *  until the whole area is erased.
+ *
+ *  @param  req             : erase request, data is not used
+ *
+ *  @return  0 on success, -EINVAL if the request is invalid.
+ */
+int flash_erase_async(struct flash_async_req *req);
+#endif /* CONFIG_FLASH_ASYNC */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _NFFS_FS_H_
+#define _NFFS_FS_H_
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set the size of the NFFS caches
+ *
+ * Limits the number of file inodes and data blocks which NFFS keeps cached
+ * in RAM, the least recently used entries being evicted first. The caches
+ * are emptied, so this is best done before heavy use of the file system.
+ *
+ * @param inodes Number of cached inodes, 1 to CONFIG_FS_NFFS_NUM_CACHE_INODES
+ * @param blocks Number of cached blocks, 1 to CONFIG_FS_NFFS_NUM_CACHE_BLOCKS
+ *
+ * @retval 0 Success
+ * @retval -EINVAL Limit out of range
+ */
+int fs_nffs_cache_limit_set(u32_t inodes, u32_t blocks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _NFFS_FS_H_ */
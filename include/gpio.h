@@ -13,6 +13,8 @@
 #ifndef __GPIO_H__
 #define __GPIO_H__
 
+#include <errno.h>
+
 #include <misc/__assert.h>
 #include <misc/slist.h>
 
@@ -122,6 +124,8 @@ typedef int (*gpio_disable_callback_t)(struct device *port,
 				       int access_op,
 				       u32_t pin);
 typedef u32_t (*gpio_api_get_pending_int)(struct device *dev);
+typedef int (*gpio_port_update_t)(struct device *port, u32_t set,
+				  u32_t clear, u32_t toggle);
 
 struct gpio_driver_api {
 	gpio_config_t config;
@@ -131,6 +135,7 @@ struct gpio_driver_api {
 	gpio_enable_callback_t enable_callback;
 	gpio_disable_callback_t disable_callback;
 	gpio_api_get_pending_int get_pending_int;
+	gpio_port_update_t port_update;
 };
 
 __syscall int gpio_config(struct device *port, int access_op, u32_t pin,
@@ -369,6 +374,74 @@ static inline int gpio_port_read(struct device *port, u32_t *value)
 	return gpio_read(port, GPIO_ACCESS_BY_PORT, 0, value);
 }
 
+/**
+ * @brief Update the output of several pins of the port at once.
+ *
+ * The output of the port becomes ((output & ~clear) | set) ^ toggle, a
+ * pin both in set and clear being set. Pins outside of the three masks
+ * are left unchanged. Drivers do this with as few register writes as the
+ * controller allows, which is much faster than writing the pins one by
+ * one, but the pins may not all change at the same time.
+ *
+ * @param port Pointer to the device structure for the driver instance.
+ * @param set Mask of the pins to set.
+ * @param clear Mask of the pins to clear.
+ * @param toggle Mask of the pins to toggle.
+ * @retval 0 If successful.
+ * @retval -ENOTSUP If the driver does not support it.
+ */
+__syscall int gpio_port_update(struct device *port, u32_t set, u32_t clear,
+			       u32_t toggle);
+
+/**
+ * @internal
+ */
+static inline int _impl_gpio_port_update(struct device *port, u32_t set,
+					 u32_t clear, u32_t toggle)
+{
+	const struct gpio_driver_api *api =
+		(const struct gpio_driver_api *)port->driver_api;
+
+	if (!api->port_update) {
+		return -ENOTSUP;
+	}
+
+	return api->port_update(port, set, clear, toggle);
+}
+
+/**
+ * @brief Set the output of several pins of the port at once.
+ * @param port Pointer to the device structure for the driver instance.
+ * @param mask Mask of the pins to set.
+ * @return 0 if successful, negative errno code on failure.
+ */
+static inline int gpio_port_set_bits(struct device *port, u32_t mask)
+{
+	return gpio_port_update(port, mask, 0, 0);
+}
+
+/**
+ * @brief Clear the output of several pins of the port at once.
+ * @param port Pointer to the device structure for the driver instance.
+ * @param mask Mask of the pins to clear.
+ * @return 0 if successful, negative errno code on failure.
+ */
+static inline int gpio_port_clear_bits(struct device *port, u32_t mask)
+{
+	return gpio_port_update(port, 0, mask, 0);
+}
+
+/**
+ * @brief Toggle the output of several pins of the port at once.
+ * @param port Pointer to the device structure for the driver instance.
+ * @param mask Mask of the pins to toggle.
+ * @return 0 if successful, negative errno code on failure.
+ */
+static inline int gpio_port_toggle_bits(struct device *port, u32_t mask)
+{
+	return gpio_port_update(port, 0, 0, mask);
+}
+
 /**
  * @brief Enable callback(s) for the port.
  * @param port Pointer to the device structure for the driver instance.
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Public API for high resolution timers
+ */
+
+#ifndef __HRTIMER_H__
+#define __HRTIMER_H__
+
+/**
+ * @brief High resolution timer Interface
+ * @defgroup hrtimer_interface High resolution timer Interface
+ * @ingroup io_interfaces
+ * @{
+ */
+
+#include <zephyr/types.h>
+#include <misc/dlist.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct hrtimer;
+
+/**
+ * @typedef hrtimer_handler_t
+ * @brief Expiry handler, run in the interrupt of the counter device.
+ *
+ * @param timer The timer which expired.
+ */
+typedef void (*hrtimer_handler_t)(struct hrtimer *timer);
+
+/**
+ * @brief High resolution timer
+ *
+ * Timers are timed by the counter device CONFIG_HRTIMER_COUNTER_NAME,
+ * in ticks of CONFIG_HRTIMER_COUNTER_FREQ Hz. The fields are private.
+ */
+struct hrtimer {
+	sys_dnode_t node;
+	u64_t expiry;
+	hrtimer_handler_t handler;
+};
+
+/**
+ * @brief Initialize a timer.
+ *
+ * @param timer Timer to initialize.
+ * @param handler Function run when the timer expires.
+ */
+void hrtimer_init(struct hrtimer *timer, hrtimer_handler_t handler);
+
+/**
+ * @brief Get the current time, in counter ticks.
+ *
+ * @return The value of the counter, extended to 64 bits.
+ */
+u64_t hrtimer_now(void);
+
+/**
+ * @brief Start a timer at an absolute time.
+ *
+ * A running timer is restarted. The timer expires at once if the time
+ * is already past.
+ *
+ * @param timer Timer to start.
+ * @param ticks Expiry time, as returned by hrtimer_now().
+ *
+ * @retval 0 If successful.
+ * @retval Negative errno code if the counter alarm could not be set.
+ */
+int hrtimer_start_at(struct hrtimer *timer, u64_t ticks);
+
+/**
+ * @brief Start a timer some microseconds from now.
+ *
+ * @param timer Timer to start.
+ * @param us Delay before the timer expires, in microseconds.
+ *
+ * @retval 0 If successful.
+ * @retval Negative errno code if the counter alarm could not be set.
+ */
+int hrtimer_start_us(struct hrtimer *timer, u32_t us);
+
+/**
+ * @brief Stop a timer.
+ *
+ * Stopping a timer which is not running has no effect.
+ *
+ * @param timer Timer to stop.
+ */
+void hrtimer_stop(struct hrtimer *timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* __HRTIMER_H__ */
@@ -25,6 +25,7 @@ extern "C" {
 
 #include <zephyr/types.h>
 #include <device.h>
+#include <misc/slist.h>
 
 /*
  * The following #defines are used to configure the I2C controller.
@@ -684,6 +685,55 @@ static inline int i2c_reg_update_addr(struct device *dev,
 				  addr_size, new_value);
 }
 
+#if defined(CONFIG_I2C_ASYNC)
+struct i2c_async_req;
+
+/**
+ * @brief Callback type for the completion of an asynchronous I2C request
+ *
+ * The callback is called from the I2C request thread, the request may be
+ * reused, or queued again, from then on.
+ *
+ * @param req The request that completed
+ * @param result 0 on success, negative errno code on fail.
+ */
+typedef void (*i2c_async_cb)(struct i2c_async_req *req, int result);
+
+/**
+ * @brief Asynchronous I2C request
+ *
+ * Filled in by the caller. The request, the messages and their buffers must
+ * stay valid until its completion is reported. The callback and the signal
+ * are both optional, the signal is raised with the result of the request.
+ */
+struct i2c_async_req {
+	sys_snode_t node;		/* used by the request queue */
+	struct device *dev;
+	struct i2c_msg *msgs;
+	u8_t num_msgs;
+	u16_t addr;
+	i2c_async_cb cb;
+	struct k_poll_signal *signal;
+	void *user_data;
+};
+
+/**
+ * @brief Queue a transfer of several messages to or from an I2C device.
+ *
+ * The transfer is done by the I2C request thread with i2c_transfer().
+ * Requests of all buses are done one after the other in the order they are
+ * queued, so the devices of a bus need no locking of their own between
+ * queued requests. A driver can queue several requests back to back and
+ * handle the data in the callbacks.
+ *
+ * @param req Request
+ *
+ * @retval 0 If the request is queued.
+ * @retval -EINVAL If the request is invalid.
+ */
+int i2c_transfer_async(struct i2c_async_req *req);
+#endif /* CONFIG_I2C_ASYNC */
+
 struct i2c_client_config {
 	char *i2c_master;
 	u16_t i2c_addr;
@@ -25,6 +25,7 @@
 
 #include <zephyr/types.h>
 #include <device.h>
+#include <errno.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -308,6 +309,19 @@ struct i2s_config {
 	s32_t timeout;
 };
 
+/** @struct i2s_stats
+ * @brief Stream statistics.
+ *
+ * @param queued Number of memory blocks in the queue: received blocks waiting
+ *        to be read for RX, blocks waiting to be sent for TX.
+ * @param errors Number of overruns (RX) or underruns (TX) since the stream
+ *        was last configured.
+ */
+struct i2s_stats {
+	u32_t queued;
+	u32_t errors;
+};
+
 /**
  * @cond INTERNAL_HIDDEN
  *
@@ -320,6 +334,9 @@ struct i2s_driver_api {
 	int (*write)(struct device *dev, void *mem_block, size_t size);
 	int (*trigger)(struct device *dev, enum i2s_dir dir,
 		       enum i2s_trigger_cmd cmd);
+	int (*start_at)(struct device *dev, enum i2s_dir dir, u32_t cycle);
+	int (*stats_get)(struct device *dev, enum i2s_dir dir,
+			 struct i2s_stats *stats);
 };
 /**
  * @endcond
@@ -444,6 +461,63 @@ static inline int i2s_trigger(struct device *dev, enum i2s_dir dir,
 	return api->trigger(dev, dir, cmd);
 }
 
+/**
+ * @brief Start the transmission / reception of data at a given time.
+ *
+ * Same as the I2S_TRIGGER_START trigger, except that the interface starts
+ * when the hardware cycle counter, as read by k_cycle_get_32(), reaches
+ * cycle. The function returns once the start is armed, so the streams of
+ * several interfaces can be armed in turn for the same cycle. They are
+ * then aligned to within the interrupt latency. I2S_TRIGGER_DROP cancels
+ * a start that did not happen yet.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param dir Stream direction: RX or TX.
+ * @param cycle Value of the hardware cycle counter to start at.
+ *
+ * @retval 0 If successful.
+ * @retval -EINVAL Invalid argument.
+ * @retval -EIO The trigger cannot be executed in the current state or a DMA
+ *         channel cannot be allocated.
+ * @retval -ENOMEM RX/TX memory block not available.
+ * @retval -ETIME The given cycle has passed already.
+ * @retval -ENOTSUP The driver does not support timed start.
+ */
+static inline int i2s_start_at(struct device *dev, enum i2s_dir dir,
+			       u32_t cycle)
+{
+	const struct i2s_driver_api *api = dev->driver_api;
+
+	if (!api->start_at) {
+		return -ENOTSUP;
+	}
+
+	return api->start_at(dev, dir, cycle);
+}
+
+/**
+ * @brief Get the statistics of a stream.
+ *
+ * @param dev Pointer to the device structure for the driver instance.
+ * @param dir Stream direction: RX or TX.
+ * @param stats Statistics of the stream.
+ *
+ * @retval 0 If successful.
+ * @retval -EINVAL Invalid argument.
+ * @retval -ENOTSUP The driver does not keep statistics.
+ */
+static inline int i2s_stats_get(struct device *dev, enum i2s_dir dir,
+				struct i2s_stats *stats)
+{
+	const struct i2s_driver_api *api = dev->driver_api;
+
+	if (!api->stats_get) {
+		return -ENOTSUP;
+	}
+
+	return api->stats_get(dev, dir, stats);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -159,6 +159,28 @@ extern "C" {
  */
 #define ISR_DIRECT_DECLARE(name) _ARCH_ISR_DIRECT_DECLARE(name)
 
+/**
+ * @brief Helper macro to declare a direct interrupt service routine in RAM.
+ *
+ * Same as ISR_DIRECT_DECLARE(), but on architectures supporting it (see
+ * __ramfunc) the ISR, with its body inlined, is placed in RAM so that it
+ * runs without flash wait states. The functions called by the body are
+ * not moved, and the MPU configuration, if any, must allow executing code
+ * from RAM.
+ *
+ * Connected with IRQ_DIRECT_CONNECT(), the ISR is reached from the vector
+ * table without going through the software ISR table, and a context switch
+ * is only requested on exit when the ISR returned nonzero and a thread
+ * other than the interrupted one is now the next to run.
+ *
+ * @param name symbol name of the ISR
+ */
+#if defined(CONFIG_ARCH_HAS_RAMFUNC_SUPPORT)
+#define ISR_DIRECT_RAMFUNC_DECLARE(name) _ARCH_ISR_DIRECT_RAMFUNC_DECLARE(name)
+#else
+#define ISR_DIRECT_RAMFUNC_DECLARE(name) ISR_DIRECT_DECLARE(name)
+#endif
+
 /**
  * @brief Lock interrupts.
  *
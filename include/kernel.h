@@ -28,12 +28,16 @@
 #include <misc/sflist.h>
 #include <misc/util.h>
 #include <misc/mempool_base.h>
+#ifdef CONFIG_MEM_POOL_TLSF
+#include <misc/tlsf.h>
+#endif
 #include <kernel_version.h>
 #include <random/rand32.h>
 #include <kernel_arch_thread.h>
 #include <syscall.h>
 #include <misc/printk.h>
 #include <arch/cpu.h>
+#include <spinlock.h>
 #include <misc/rb.h>
 
 #ifdef __cplusplus
@@ -379,11 +383,25 @@ struct _timeout;
 typedef void (*_timeout_func_t)(struct _timeout *t);
 
 struct _timeout {
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+	/* rbnode while pending, node once expired or for other uses */
+	union {
+		sys_dnode_t node;
+		struct rbnode rbnode;
+	};
+#else
 	sys_dnode_t node;
+#endif
 	struct k_thread *thread;
 	sys_dlist_t *wait_q;
 	s32_t delta_ticks_from_prev;
 	_timeout_func_t func;
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+	/* absolute expiry, in ticks announced since boot */
+	s64_t expiry;
+	/* insertion order, to expire same-tick timeouts FIFO */
+	u32_t order_key;
+#endif
 };
 
 extern s32_t _timeout_remaining_get(struct _timeout *timeout);
@@ -481,6 +499,11 @@ struct _thread_base {
 
 	/* Recursive count of irq_lock() calls */
 	u8_t global_lock_count;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	/* "May run on" bits for each CPU */
+	u8_t cpu_mask;
+#endif
 #endif
 
 	/* data returned by APIs */
@@ -507,11 +530,83 @@ struct _thread_stack_info {
 	 * that should be writable by the thread
 	 */
 	u32_t size;
+
+#ifdef CONFIG_THREAD_STACK_WATERMARK
+	/* Lowest unused stack space seen when switching out of the thread */
+	u32_t unused;
+#endif
 };
 
 typedef struct _thread_stack_info _thread_stack_info_t;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @brief Thread runtime statistics
+ *
+ * All durations are in hardware cycles, as returned by k_cycle_get_32().
+ *
+ * In @a ready_latency_hist, bucket 0 counts the ready-to-run latencies
+ * lower than 2^CONFIG_THREAD_RUNTIME_STATS_HIST_SHIFT cycles, and each
+ * following bucket counts latencies up to twice as large as the previous
+ * one. The last bucket counts all the larger latencies.
+ */
+struct k_thread_runtime_stats {
+	/** cycles spent running */
+	u64_t execution_cycles;
+	/** number of times the thread was switched in */
+	u32_t switch_count;
+	/** number of times the thread was switched out while still ready */
+	u32_t preempt_count;
+	/** largest time spent ready before running */
+	u32_t ready_latency_max;
+	/** histogram of the time spent ready before running */
+	u32_t ready_latency_hist[CONFIG_THREAD_RUNTIME_STATS_HIST_BUCKETS];
+};
+
+struct _thread_runtime {
+	struct k_thread_runtime_stats stats;
+
+	/* cycle count when last switched in */
+	u32_t switched_in;
+
+	/* cycle count when last made ready */
+	u32_t ready_since;
+};
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
+#ifdef CONFIG_MUTEX_PI_CHAIN
+struct k_mutex;
+
+struct _thread_mutex_pi {
+	/* mutexes held by the thread, in acquisition order */
+	sys_dlist_t held;
+
+	/* mutex the thread is waiting for, if any */
+	struct k_mutex *pended_on;
+
+	/* priority of the thread before it inherited any */
+	int base_prio;
+};
+#endif /* CONFIG_MUTEX_PI_CHAIN */
+
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+struct _thread_cbs {
+	/* budget and period, in ticks; a zero budget disables the server */
+	s32_t budget;
+	s32_t period;
+
+	/* budget left in the current period, in ticks */
+	s32_t remaining;
+
+	/* budget / period, in 1/1024th */
+	u32_t bandwidth;
+
+	/* budget replenishment, when throttled */
+	struct _timeout timeout;
+};
+#endif /* CONFIG_SCHED_DEADLINE_CBS */
+
 #if defined(CONFIG_USERSPACE)
 struct _mem_domain_info {
 	/* memory domain queue node */
@@ -520,6 +615,18 @@ struct _mem_domain_info {
 	struct k_mem_domain *mem_domain;
 };
 
+#if defined(CONFIG_USERSPACE_OBJ_CACHE)
+struct _k_object_cache {
+	/* generation the entries are valid for */
+	u32_t gen;
+	/* thread's permission index, -2 if not looked up yet */
+	int index;
+	/* direct-mapped cache of kernel object lookups */
+	void *obj[CONFIG_USERSPACE_OBJ_CACHE_SIZE];
+	struct _k_object *ko[CONFIG_USERSPACE_OBJ_CACHE_SIZE];
+};
+#endif
+
 #endif /* CONFIG_USERSPACE */
 
 /**
@@ -567,11 +674,30 @@ struct k_thread {
 	struct _thread_stack_info stack_info;
 #endif /* CONFIG_THREAD_STACK_INFO */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	/** runtime statistics */
+	struct _thread_runtime runtime;
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	/** constant bandwidth server */
+	struct _thread_cbs cbs;
+#endif
+
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	/** mutex priority inheritance */
+	struct _thread_mutex_pi mutex_pi;
+#endif
+
 #if defined(CONFIG_USERSPACE)
 	/** memory domain info of the thread */
 	struct _mem_domain_info mem_domain_info;
 	/** Base address of thread stack */
 	k_thread_stack_t *stack_obj;
+#if defined(CONFIG_USERSPACE_OBJ_CACHE)
+	/** kernel objects recently looked up by system calls */
+	struct _k_object_cache obj_cache;
+#endif
 #endif /* CONFIG_USERSPACE */
 
 #if defined(CONFIG_USE_SWITCH)
@@ -1083,6 +1209,140 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
 __syscall void k_thread_deadline_set(k_tid_t thread, int deadline);
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+/**
+ * @brief Run a thread as a constant bandwidth server
+ *
+ * The thread gets a budget of @a budget milliseconds of CPU time every
+ * @a period milliseconds. Its deadline is managed by the kernel: it is set
+ * one period ahead and postponed by one period on each budget
+ * replenishment. When the thread exhausts its budget, it is throttled,
+ * i.e. not scheduled anymore until the end of its current period, so that it
+ * cannot steal time from the other threads. When it wakes up and its
+ * remaining budget is larger than what its bandwidth allows until the
+ * deadline, it gets a fresh budget and deadline.
+ *
+ * The set of servers is subject to an admission test: the sum of their
+ * bandwidths (budget / period) may not exceed
+ * CONFIG_SCHED_DEADLINE_CBS_MAX_BANDWIDTH percent.
+ *
+ * Budgets are accounted in ticks. Deadlines only order threads of the same
+ * static priority, so all the servers meant to share the CPU under EDF
+ * must run at the same priority.
+ *
+ * @param thread Thread to operate upon
+ * @param budget Budget per period, in milliseconds; 0 turns the server off
+ * @param period Period, in milliseconds
+ *
+ * @retval 0 Server set
+ * @retval -EINVAL Invalid budget or period
+ * @retval -EBUSY The admission test failed
+ */
+__syscall int k_thread_cbs_set(k_tid_t thread, u32_t budget, u32_t period);
+#endif
+
+#ifdef CONFIG_SCHED_CPU_MASK
+/**
+ * @brief Sets all CPU enable masks to zero
+ *
+ * After this returns, the thread will no longer be schedulable on any
+ * CPUs.  The thread must not be currently runnable.
+ *
+ * @param thread Thread to operate upon
+ * @return Zero on success, otherwise error code
+ */
+int k_thread_cpu_mask_clear(k_tid_t thread);
+
+/**
+ * @brief Sets all CPU enable masks to one
+ *
+ * After this returns, the thread will be schedulable on any CPU.  The
+ * thread must not be currently runnable.
+ *
+ * @param thread Thread to operate upon
+ * @return Zero on success, otherwise error code
+ */
+int k_thread_cpu_mask_enable_all(k_tid_t thread);
+
+/**
+ * @brief Enable thread to run on specified CPU
+ *
+ * The thread must not be currently runnable.
+ *
+ * @param thread Thread to operate upon
+ * @param cpu CPU index
+ * @return Zero on success, otherwise error code
+ */
+int k_thread_cpu_mask_enable(k_tid_t thread, int cpu);
+
+/**
+ * @brief Prevent thread to run on specified CPU
+ *
+ * The thread must not be currently runnable.
+ *
+ * @param thread Thread to operate upon
+ * @param cpu CPU index
+ * @return Zero on success, otherwise error code
+ */
+int k_thread_cpu_mask_disable(k_tid_t thread, int cpu);
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/**
+ * @brief Get the runtime statistics of a thread
+ *
+ * The execution cycles of a running thread include its current run.
+ *
+ * @param thread Thread to get the statistics of
+ * @param stats Where to copy the statistics
+ *
+ * @return 0 on success, -EINVAL if @a thread or @a stats is NULL
+ */
+int k_thread_runtime_stats_get(k_tid_t thread,
+			       struct k_thread_runtime_stats *stats);
+#endif
+
+#ifdef CONFIG_THREAD_STACK_WATERMARK
+/**
+ * @brief Get the lowest unused stack space of a thread seen so far
+ *
+ * The kernel keeps track of it at low cost on each context switch, see
+ * CONFIG_THREAD_STACK_WATERMARK. Scanning the whole stack with
+ * stack_unused_space_get() is exact, but slower.
+ *
+ * @param thread Thread to get the stack space of
+ *
+ * @return Unused stack space in bytes
+ */
+static inline size_t k_thread_stack_unused_get(k_tid_t thread)
+{
+	return thread->stack_info.unused;
+}
+#endif
+
+#ifdef CONFIG_FP_SHARING_STATS
+/**
+ * @brief Floating point context switch statistics
+ */
+struct k_float_stats {
+	/** Floating point contexts saved during context switches */
+	u32_t saves;
+	/** Context switches which left the floating point registers alone */
+	u32_t saves_avoided;
+};
+
+/**
+ * @brief Get the floating point context switch statistics
+ *
+ * Each context switch either saves the floating point context of the
+ * thread owning the registers, or leaves the registers in place because
+ * the incoming thread does not use them or already owns them.
+ *
+ * @param stats Where to copy the statistics
+ */
+void k_float_stats_get(struct k_float_stats *stats);
+#endif
+
 /**
  * @brief Suspend a thread.
  *
@@ -1743,6 +2003,18 @@ extern u32_t k_uptime_delta_32(s64_t *reftime);
  */
 #define k_cycle_get_32()	_arch_k_cycle_get_32()
 
+/**
+ * @brief Read the hardware clock, extended to 64 bits.
+ *
+ * This routine returns the same clock as k_cycle_get_32(), extended in
+ * software so that it does not wrap around. This relies on the clock
+ * being read at least once per wrap around, which the system clock
+ * interrupt does.
+ *
+ * @return Current hardware clock up-counter (in cycles).
+ */
+__syscall u64_t k_cycle_get_64(void);
+
 /**
  * @}
  */
@@ -1753,6 +2025,11 @@ extern u32_t k_uptime_delta_32(s64_t *reftime);
 
 struct k_queue {
 	sys_sflist_t data_q;
+	struct k_spinlock lock;
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+	/* lock-free LIFO of appended nodes, merged into data_q under lock */
+	atomic_t inbox;
+#endif
 	union {
 		_wait_q_t wait_q;
 
@@ -1957,10 +2234,7 @@ __syscall void *k_queue_get(struct k_queue *queue, s32_t timeout);
  *
  * @return true if data item was removed
  */
-static inline bool k_queue_remove(struct k_queue *queue, void *data)
-{
-	return sys_sflist_find_and_remove(&queue->data_q, (sys_sfnode_t *)data);
-}
+extern bool k_queue_remove(struct k_queue *queue, void *data);
 
 /**
  * @brief Query a queue to see if it has data available.
@@ -1977,8 +2251,20 @@ static inline bool k_queue_remove(struct k_queue *queue, void *data)
  */
 __syscall int k_queue_is_empty(struct k_queue *queue);
 
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+/* set in k_queue.inbox when there may be waiters: no lock-free append */
+#define _K_QUEUE_INBOX_WAITERS 0x1
+
+extern void z_queue_inbox_merge(struct k_queue *queue);
+#endif
+
 static inline int _impl_k_queue_is_empty(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+	if (atomic_get(&queue->inbox) & ~_K_QUEUE_INBOX_WAITERS) {
+		return 0;
+	}
+#endif
 	return (int)sys_sflist_is_empty(&queue->data_q);
 }
 
@@ -1995,6 +2281,9 @@ __syscall void *k_queue_peek_head(struct k_queue *queue);
 
 static inline void *_impl_k_queue_peek_head(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+	z_queue_inbox_merge(queue);
+#endif
 	return z_queue_node_peek(sys_sflist_peek_head(&queue->data_q), false);
 }
 
@@ -2011,6 +2300,9 @@ __syscall void *k_queue_peek_tail(struct k_queue *queue);
 
 static inline void *_impl_k_queue_peek_tail(struct k_queue *queue)
 {
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+	z_queue_inbox_merge(queue);
+#endif
 	return z_queue_node_peek(sys_sflist_peek_tail(&queue->data_q), false);
 }
 
@@ -2531,6 +2823,9 @@ struct k_work {
 	void *_reserved;		/* Used by k_queue implementation. */
 	k_work_handler_t handler;
 	atomic_t flags[1];
+#ifdef CONFIG_WORK_POOL
+	u32_t queued_at;		/* Submission time, in cycles. */
+#endif
 };
 
 struct k_delayed_work {
@@ -2614,6 +2909,9 @@ static inline void k_work_submit_to_queue(struct k_work_q *work_q,
 					  struct k_work *work)
 {
 	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+#ifdef CONFIG_WORK_POOL
+		work->queued_at = k_cycle_get_32();
+#endif
 		k_queue_append(&work_q->queue, work);
 	}
 }
@@ -2657,6 +2955,26 @@ extern void k_work_q_start(struct k_work_q *work_q,
 			   k_thread_stack_t *stack,
 			   size_t stack_size, int prio);
 
+#ifdef CONFIG_SCHED_CPU_MASK
+/**
+ * @brief Start a workqueue on a given CPU.
+ *
+ * This routine starts workqueue @a work_q like k_work_q_start(), but its
+ * work processing thread is only allowed to run on CPU @a cpu.
+ *
+ * @param work_q Address of workqueue.
+ * @param stack Pointer to work queue thread's stack space.
+ * @param stack_size Size of the work queue thread's stack (in bytes).
+ * @param prio Priority of the work queue's thread.
+ * @param cpu CPU the work queue's thread runs on.
+ *
+ * @return N/A
+ */
+extern void k_work_q_start_on_cpu(struct k_work_q *work_q,
+				  k_thread_stack_t *stack,
+				  size_t stack_size, int prio, int cpu);
+#endif
+
 /**
  * @brief Initialize a delayed work item.
  *
@@ -2809,6 +3127,232 @@ static inline s32_t k_delayed_work_remaining_get(struct k_delayed_work *work)
 	return _timeout_remaining_get(&work->timeout);
 }
 
+#ifdef CONFIG_WORK_WHEEL
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_wheel_work {
+	struct k_work work;
+	sys_dnode_t node;
+	struct k_work_q *work_q;
+	/* expiry tick, and tick of the wheel slot the item is linked in */
+	u32_t expiry;
+	u32_t slot;
+	bool linked;
+};
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Initialize a wheel work item.
+ *
+ * Wheel work items are delayed work items meant for timers that are
+ * rescheduled much more often than they expire, such as retransmission or
+ * keepalive timers. They are kept on a hashed wheel of
+ * CONFIG_WORK_WHEEL_SLOTS slots of one system clock tick, where submitting,
+ * resubmitting and cancelling cost O(1). Postponing an item does not even
+ * move it: the wheel finds out that its expiry changed when it reaches
+ * the slot the item is in.
+ *
+ * @param work Address of wheel work item.
+ * @param handler Function to invoke each time work item is processed.
+ *
+ * @return N/A
+ */
+extern void k_wheel_work_init(struct k_wheel_work *work,
+			      k_work_handler_t handler);
+
+/**
+ * @brief Submit a wheel work item.
+ *
+ * This routine schedules wheel work item @a work to be processed by
+ * workqueue @a work_q after a delay of @a delay milliseconds, like
+ * k_delayed_work_submit_to_queue(). If the item is already scheduled on
+ * the wheel, it is rescheduled with the new delay.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param work_q Address of workqueue.
+ * @param work Address of wheel work item.
+ * @param delay Delay before submitting the work item (in milliseconds).
+ *
+ * @retval 0 Work item scheduled or submitted.
+ * @retval -EINVAL Work item is being dequeued by its workqueue.
+ * @retval -EADDRINUSE Work item is pending on a different workqueue.
+ */
+extern int k_wheel_work_submit_to_queue(struct k_work_q *work_q,
+					struct k_wheel_work *work,
+					s32_t delay);
+
+/**
+ * @brief Submit a wheel work item to the system workqueue.
+ *
+ * @see k_wheel_work_submit_to_queue()
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param work Address of wheel work item.
+ * @param delay Delay before submitting the work item (in milliseconds).
+ *
+ * @retval 0 Work item scheduled or submitted.
+ * @retval -EADDRINUSE Work item is pending on a different workqueue.
+ */
+static inline int k_wheel_work_submit(struct k_wheel_work *work, s32_t delay)
+{
+	return k_wheel_work_submit_to_queue(&k_sys_work_q, work, delay);
+}
+
+/**
+ * @brief Cancel a wheel work item.
+ *
+ * This routine cancels wheel work item @a work, whether it is still on the
+ * wheel or already pending in its workqueue.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param work Address of wheel work item.
+ *
+ * @retval 0 Work item countdown canceled.
+ * @retval -EINVAL Work item is being processed or has completed its work.
+ */
+extern int k_wheel_work_cancel(struct k_wheel_work *work);
+
+/**
+ * @brief Get time remaining before a wheel work item gets scheduled.
+ *
+ * @param work Address of wheel work item.
+ *
+ * @return Remaining time (in milliseconds), zero if the item is not on
+ *         the wheel.
+ */
+extern s32_t k_wheel_work_remaining_get(struct k_wheel_work *work);
+#endif /* CONFIG_WORK_WHEEL */
+
+#ifdef CONFIG_WORK_POOL
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_work_pool {
+	/* lowest priority level, also used through the k_work_q APIs */
+	struct k_work_q work_q;
+	struct k_queue queues[CONFIG_WORK_POOL_PRIORITIES - 1];
+	int prio;
+
+	struct k_spinlock lock;
+	u32_t workers;
+	u32_t busy;
+	u32_t executed;
+	u32_t latency_max;
+	u32_t run_max;
+	u64_t latency_total;
+};
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/** Priority level of work items submitted through the k_work_q APIs. */
+#define K_WORK_POOL_PRIO_DEFAULT (CONFIG_WORK_POOL_PRIORITIES - 1)
+
+/**
+ * @brief Work pool statistics.
+ *
+ * Durations are in hardware cycles, as returned by k_cycle_get_32().
+ */
+struct k_work_pool_stats {
+	/** Work items waiting, per priority level */
+	u32_t pending[CONFIG_WORK_POOL_PRIORITIES];
+	/** Number of worker threads */
+	u32_t workers;
+	/** Number of worker threads running a work item */
+	u32_t busy;
+	/** Number of work items run */
+	u32_t executed;
+	/** Average time between submission and start of a work item */
+	u32_t latency_avg;
+	/** Longest time between submission and start of a work item */
+	u32_t latency_max;
+	/** Longest run time of a work item */
+	u32_t run_max;
+};
+
+/**
+ * @brief Start a work pool.
+ *
+ * A work pool is a workqueue served by several threads, so that a long
+ * running work item only holds up one of them. Idle workers take the
+ * oldest work item of the most urgent priority level: items do not wait
+ * behind a busy worker while another one is idle.
+ *
+ * This routine starts the pool with a first worker thread, which may run
+ * on any CPU. Add more workers with k_work_pool_add_worker().
+ *
+ * The pool's @a work_q member can be passed to k_work_submit_to_queue() and
+ * k_delayed_work_submit_to_queue(): such items get the lowest priority
+ * level, K_WORK_POOL_PRIO_DEFAULT.
+ *
+ * @param pool Address of work pool.
+ * @param stack Pointer to the first worker's stack.
+ * @param stack_size Size of the first worker's stack, in bytes.
+ * @param prio Thread priority of the workers.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_start(struct k_work_pool *pool,
+			      k_thread_stack_t *stack, size_t stack_size,
+			      int prio);
+
+/**
+ * @brief Add a worker thread to a work pool.
+ *
+ * @param pool Address of work pool.
+ * @param thread Address of the worker's thread object.
+ * @param stack Pointer to the worker's stack.
+ * @param stack_size Size of the worker's stack, in bytes.
+ * @param cpu CPU the worker is pinned to, or -1 to run it on any CPU.
+ *            Pinning requires CONFIG_SCHED_CPU_MASK.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_add_worker(struct k_work_pool *pool,
+				   struct k_thread *thread,
+				   k_thread_stack_t *stack, size_t stack_size,
+				   int cpu);
+
+/**
+ * @brief Submit a work item to a work pool.
+ *
+ * Same as k_work_submit_to_queue(), with a priority level: idle workers
+ * take items of a lower level first.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param pool Address of work pool.
+ * @param work Address of work item.
+ * @param prio Priority level, from 0 (most urgent) to
+ *             K_WORK_POOL_PRIO_DEFAULT.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_submit(struct k_work_pool *pool, struct k_work *work,
+			       int prio);
+
+/**
+ * @brief Get work pool statistics.
+ *
+ * @param pool Address of work pool.
+ * @param stats Address of the structure receiving the statistics.
+ *
+ * @return N/A
+ */
+extern void k_work_pool_stats_get(struct k_work_pool *pool,
+				  struct k_work_pool_stats *stats);
+#endif /* CONFIG_WORK_POOL */
+
 /** @} */
 /**
  * @defgroup mutex_apis Mutex APIs
@@ -2822,10 +3366,15 @@ static inline s32_t k_delayed_work_remaining_get(struct k_delayed_work *work)
  */
 struct k_mutex {
 	_wait_q_t wait_q;
+	struct k_spinlock lock;
 	/** Mutex owner */
 	struct k_thread *owner;
 	u32_t lock_count;
 	int owner_orig_prio;
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	/* node in the owner's list of held mutexes */
+	sys_dnode_t held_node;
+#endif
 
 	_OBJECT_TRACING_NEXT_PTR(k_mutex);
 };
@@ -2919,21 +3468,69 @@ __syscall void k_mutex_unlock(struct k_mutex *mutex);
  * @}
  */
 
+#ifdef CONFIG_FUTEX
 /**
- * @cond INTERNAL_HIDDEN
+ * @defgroup futex_apis Futex APIs
+ * @ingroup kernel_apis
+ * @{
  */
 
-struct k_sem {
-	_wait_q_t wait_q;
-	unsigned int count;
-	unsigned int limit;
-	_POLL_EVENT;
-
-	_OBJECT_TRACING_NEXT_PTR(k_sem);
-};
+/**
+ * @brief Wait on a futex.
+ *
+ * A futex is any atomic variable of the caller's memory, including user
+ * memory, on which threads can wait for it to change. This is the
+ * building block of synchronization primitives that only need a system
+ * call under contention, like the ones in <misc/futex.h>.
+ *
+ * This routine puts the calling thread to sleep if @a futex still has the
+ * value @a expected, atomically with respect to k_futex_wake(), until it is
+ * woken up by k_futex_wake() on the same futex or @a timeout expires.
+ *
+ * @param futex Address of the futex.
+ * @param expected Value @a futex is expected to have.
+ * @param timeout Waiting period, in milliseconds, or one of the special
+ *                values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Woken up by k_futex_wake().
+ * @retval -EAGAIN @a futex did not have the value @a expected.
+ * @retval -ETIMEDOUT Waiting period timed out.
+ */
+__syscall int k_futex_wait(atomic_t *futex, atomic_val_t expected,
+			   s32_t timeout);
 
-#define _K_SEM_INITIALIZER(obj, initial_count, count_limit) \
-	{ \
+/**
+ * @brief Wake up threads waiting on a futex.
+ *
+ * @param futex Address of the futex.
+ * @param wake_all Wake up all the waiting threads rather than the highest
+ *                 priority one.
+ *
+ * @return Number of threads woken up.
+ */
+__syscall int k_futex_wake(atomic_t *futex, int wake_all);
+
+/**
+ * @}
+ */
+#endif /* CONFIG_FUTEX */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_sem {
+	_wait_q_t wait_q;
+	struct k_spinlock lock;
+	unsigned int count;
+	unsigned int limit;
+	_POLL_EVENT;
+
+	_OBJECT_TRACING_NEXT_PTR(k_sem);
+};
+
+#define _K_SEM_INITIALIZER(obj, initial_count, count_limit) \
+	{ \
 	.wait_q = _WAIT_Q_INIT(&obj.wait_q), \
 	.count = initial_count, \
 	.limit = count_limit, \
@@ -3068,6 +3665,104 @@ static inline unsigned int _impl_k_sem_count_get(struct k_sem *sem)
 
 /** @} */
 
+#ifdef CONFIG_THREAD_POOL
+/**
+ * @defgroup thread_pool_apis Thread Pool APIs
+ * @ingroup kernel_apis
+ * @{
+ */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+struct k_thread_pool {
+	/* idle workers, the most recently used first */
+	struct k_lifo idle;
+	int prio;
+};
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Thread pool worker.
+ *
+ * The fields are private, the structure is provided by the application
+ * for each worker thread of a pool.
+ */
+struct k_thread_pool_worker {
+	/* first word reserved for the idle LIFO */
+	void *_reserved;
+	struct k_thread thread;
+	struct k_sem start;
+	k_thread_entry_t entry;
+	void *p1;
+	void *p2;
+	void *p3;
+	struct k_thread_pool *pool;
+};
+
+/**
+ * @brief Initialize a thread pool.
+ *
+ * A thread pool is a set of threads created once and parked, which run
+ * entry functions on demand. Dispatching to an idle worker only wakes it
+ * up, which is much cheaper than creating a thread for a short-lived
+ * task. Add workers with k_thread_pool_add_worker().
+ *
+ * @param pool Address of thread pool.
+ * @param prio Thread priority of the workers.
+ *
+ * @return N/A
+ */
+extern void k_thread_pool_init(struct k_thread_pool *pool, int prio);
+
+/**
+ * @brief Add a worker thread to a thread pool.
+ *
+ * @param pool Address of thread pool.
+ * @param worker Address of the worker, which must stay valid for as long
+ *               as the pool is used.
+ * @param stack Pointer to the worker's stack.
+ * @param stack_size Size of the worker's stack, in bytes.
+ *
+ * @return N/A
+ */
+extern void k_thread_pool_add_worker(struct k_thread_pool *pool,
+				     struct k_thread_pool_worker *worker,
+				     k_thread_stack_t *stack,
+				     size_t stack_size);
+
+/**
+ * @brief Run a function in a worker thread of a thread pool.
+ *
+ * The function runs with the priority of the pool, as the entry point
+ * of a thread would. It must return, rather than abort its thread, for
+ * the worker to go back to the pool.
+ *
+ * @note Can be called by ISRs, with @a timeout set to K_NO_WAIT.
+ *
+ * @param pool Address of thread pool.
+ * @param entry Function to run.
+ * @param p1 1st parameter of the function.
+ * @param p2 2nd parameter of the function.
+ * @param p3 3rd parameter of the function.
+ * @param timeout Waiting period for a worker to be idle (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 The function was handed to a worker.
+ * @retval -EAGAIN No worker was idle before the timeout.
+ */
+extern int k_thread_pool_dispatch(struct k_thread_pool *pool,
+				  k_thread_entry_t entry,
+				  void *p1, void *p2, void *p3,
+				  s32_t timeout);
+
+/** @} */
+#endif /* CONFIG_THREAD_POOL */
+
 /**
  * @defgroup alert_apis Alert APIs
  * @ingroup kernel_apis
@@ -3223,6 +3918,7 @@ __syscall void k_alert_send(struct k_alert *alert);
  */
 struct k_msgq {
 	_wait_q_t wait_q;
+	struct k_spinlock lock;
 	size_t msg_size;
 	u32_t max_msgs;
 	char *buffer_start;
@@ -3258,6 +3954,8 @@ struct k_msgq {
 
 
 #define K_MSGQ_FLAG_ALLOC	BIT(0)
+#define K_MSGQ_FLAG_PUT_LOAN	BIT(1)
+#define K_MSGQ_FLAG_GET_LOAN	BIT(2)
 
 /**
  * @brief Message Queue Attributes
@@ -3361,10 +4059,46 @@ void k_msgq_cleanup(struct k_msgq *q);
  * @retval 0 Message sent.
  * @retval -ENOMSG Returned without waiting or queue purged.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A slot of the queue is loaned by k_msgq_put_loan().
  * @req K-MSGQ-002
  */
 __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Loan a message queue slot to write a message in place.
+ *
+ * This routine reserves the next free slot of message queue @a q, which the
+ * caller fills directly and then sends with k_msgq_put_commit(), saving a
+ * copy compared to k_msgq_put(). Only one slot of a queue can be loaned for
+ * writing at a time, and other senders fail with -EBUSY meanwhile. The
+ * message is handed to a receiver already waiting with k_msgq_get() with a
+ * single copy.
+ *
+ * The slot is in the queue's buffer, so this routine is not available to
+ * user mode threads.
+ *
+ * @param q Address of the message queue.
+ * @param slot Address of area to hold the address of the slot.
+ * @param timeout Waiting period for a free slot (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Slot loaned.
+ * @retval -ENOMSG Returned without waiting or queue purged.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A slot of the queue is already loaned for writing.
+ */
+extern int k_msgq_put_loan(struct k_msgq *q, void **slot, s32_t timeout);
+
+/**
+ * @brief Send the message written in a loaned message queue slot.
+ *
+ * @param q Address of the message queue.
+ *
+ * @retval 0 Message sent.
+ * @retval -EINVAL No slot of the queue is loaned for writing.
+ */
+extern int k_msgq_put_commit(struct k_msgq *q);
+
 /**
  * @brief Receive a message from a message queue.
  *
@@ -3381,10 +4115,46 @@ __syscall int k_msgq_put(struct k_msgq *q, void *data, s32_t timeout);
  * @retval 0 Message received.
  * @retval -ENOMSG Returned without waiting.
  * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY The first message is loaned by k_msgq_get_loan().
  * @req K-MSGQ-002
  */
 __syscall int k_msgq_get(struct k_msgq *q, void *data, s32_t timeout);
 
+/**
+ * @brief Loan the first message of a message queue to read it in place.
+ *
+ * This routine gives access to the first message of message queue @a q
+ * directly in the queue's buffer, saving a copy compared to k_msgq_get().
+ * The message stays in the queue until the caller is done with it and
+ * calls k_msgq_get_release(). Only one message of a queue can be loaned for
+ * reading at a time, and other receivers fail with -EBUSY meanwhile.
+ *
+ * The message is in the queue's buffer, so this routine is not available
+ * to user mode threads.
+ *
+ * @param q Address of the message queue.
+ * @param slot Address of area to hold the address of the message.
+ * @param timeout Waiting period for a message (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Message loaned.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EBUSY A message of the queue is already loaned for reading.
+ */
+extern int k_msgq_get_loan(struct k_msgq *q, void **slot, s32_t timeout);
+
+/**
+ * @brief Remove a loaned message from a message queue.
+ *
+ * @param q Address of the message queue.
+ *
+ * @retval 0 Message removed.
+ * @retval -EINVAL No message of the queue is loaned for reading, or the
+ *                 queue was purged since.
+ */
+extern int k_msgq_get_release(struct k_msgq *q);
+
 /**
  * @brief Purge a message queue.
  *
@@ -3480,6 +4250,19 @@ struct k_mem_block {
  * @{
  */
 
+/**
+ * @brief Mailbox message scatter-gather entry.
+ *
+ * Describes one of the buffers holding the data of a scatter-gather
+ * message, e.g. the data of one fragment of a net_buf chain.
+ */
+struct k_mbox_sg {
+	/** start of the buffer */
+	void *data;
+	/** size of the buffer (in bytes) */
+	size_t size;
+};
+
 struct k_mbox_msg {
 	/** internal use only - needed for legacy API support */
 	u32_t _mailbox;
@@ -3499,9 +4282,17 @@ struct k_mbox_msg {
 	k_tid_t tx_target_thread;
 	/** internal use only - thread waiting on send (may be a dummy) */
 	k_tid_t _syncing_thread;
+	/** internal use only - scatter-gather list of message data */
+	const struct k_mbox_sg *_tx_sg;
+	/** internal use only - number of scatter-gather entries */
+	u32_t _tx_sg_count;
 #if (CONFIG_NUM_MBOX_ASYNC_MSGS > 0)
 	/** internal use only - semaphore used during asynchronous send */
 	struct k_sem *_async_sem;
+#ifdef CONFIG_POLL
+	/** internal use only - signal raised after asynchronous send */
+	struct k_poll_signal *_async_signal;
+#endif
 #endif
 };
 
@@ -3597,6 +4388,61 @@ extern int k_mbox_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
 extern void k_mbox_async_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
 			     struct k_sem *sem);
 
+/**
+ * @brief Send a scatter-gather mailbox message in a synchronous manner.
+ *
+ * This routine is similar to k_mbox_put(), except that the message data
+ * is not in a buffer or a memory pool block, but in the @a count buffers
+ * described by @a sg. The size of the message is the sum of their sizes,
+ * and the tx_data and tx_block fields of @a tx_msg are ignored.
+ *
+ * The buffers are handed over to the receiver by reference: a receiver
+ * can consume them in place with k_mbox_data_sg_get(), or have them
+ * copied with k_mbox_data_get() or k_mbox_data_block_get().
+ *
+ * @param mbox Address of the mailbox.
+ * @param tx_msg Address of the transmit message descriptor.
+ * @param sg Array of scatter-gather entries describing the message data.
+ * @param count Number of entries in @a sg.
+ * @param timeout Waiting period for the message to be received (in
+ *                milliseconds), or one of the special values K_NO_WAIT
+ *                and K_FOREVER. Once the message has been received,
+ *                this routine waits as long as necessary for the message
+ *                to be completely processed.
+ *
+ * @retval 0 Message sent.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+extern int k_mbox_sg_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
+			 const struct k_mbox_sg *sg, u32_t count,
+			 s32_t timeout);
+
+#if defined(CONFIG_POLL) || defined(__DOXYGEN__)
+/**
+ * @brief Send a scatter-gather mailbox message in an asynchronous manner.
+ *
+ * This routine is similar to k_mbox_sg_put(), except that it does not wait
+ * for a receiver to process the message. Optionally, @a signal is raised
+ * when the message has been both received and completely processed by the
+ * receiver, with the number of bytes the receiver consumed as result.
+ * Until then, the buffers described by @a sg and the array itself must be
+ * left untouched.
+ *
+ * @param mbox Address of the mailbox.
+ * @param tx_msg Address of the transmit message descriptor.
+ * @param sg Array of scatter-gather entries describing the message data.
+ * @param count Number of entries in @a sg.
+ * @param signal Address of a poll signal, or NULL if none is needed.
+ *
+ * @return N/A
+ */
+extern void k_mbox_async_sg_put(struct k_mbox *mbox,
+				struct k_mbox_msg *tx_msg,
+				const struct k_mbox_sg *sg, u32_t count,
+				struct k_poll_signal *signal);
+#endif
+
 /**
  * @brief Receive a mailbox message.
  *
@@ -3672,6 +4518,40 @@ extern int k_mbox_data_block_get(struct k_mbox_msg *rx_msg,
 				 struct k_mem_pool *pool,
 				 struct k_mem_block *block, s32_t timeout);
 
+/**
+ * @brief Access scatter-gather mailbox message data in place.
+ *
+ * This routine gives access to the buffers of a message sent with
+ * k_mbox_sg_put() or k_mbox_async_sg_put(), without copying them. The
+ * message is not disposed of: once its data has been processed, the
+ * receiver must call k_mbox_data_release(), after which the buffers
+ * must no longer be accessed.
+ *
+ * The receiver should only consume the first rx_msg->size bytes of the
+ * buffers, which may be less than their total size.
+ *
+ * @param rx_msg Address of a receive message descriptor.
+ * @param sg Address of the pointer set to the scatter-gather entries.
+ *
+ * @return Number of scatter-gather entries, or -EINVAL if the message is
+ *         not a scatter-gather message.
+ */
+extern int k_mbox_data_sg_get(struct k_mbox_msg *rx_msg,
+			      const struct k_mbox_sg **sg);
+
+/**
+ * @brief Dispose of a received mailbox message after in-place processing.
+ *
+ * This routine completes the processing of a received message whose data
+ * the receiver has consumed in place, and notifies the sender, which is
+ * told that rx_msg->size bytes were consumed.
+ *
+ * @param rx_msg Address of a receive message descriptor.
+ *
+ * @return N/A
+ */
+extern void k_mbox_data_release(struct k_mbox_msg *rx_msg);
+
 /** @} */
 
 /**
@@ -3693,6 +4573,8 @@ struct k_pipe {
 		_wait_q_t      writers; /**< Writer wait queue */
 	} wait_q;
 
+	struct k_spinlock lock;         /**< Protects pipe state */
+
 	_OBJECT_TRACING_NEXT_PTR(k_pipe);
 	u8_t	       flags;		/**< Flags */
 };
@@ -3701,6 +4583,8 @@ struct k_pipe {
  * @cond INTERNAL_HIDDEN
  */
 #define K_PIPE_FLAG_ALLOC	BIT(0)	/** Buffer was allocated */
+#define K_PIPE_FLAG_PUT_LOAN	BIT(1)	/** Buffer space loaned to a writer */
+#define K_PIPE_FLAG_GET_LOAN	BIT(2)	/** Buffer data loaned to a reader */
 
 #define _K_PIPE_INITIALIZER(obj, pipe_buffer, pipe_buffer_size)        \
 	{                                                             \
@@ -3805,12 +4689,48 @@ __syscall int k_pipe_alloc_init(struct k_pipe *pipe, size_t size);
  * @retval -EIO Returned without waiting; zero data bytes were written.
  * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
  *                 minus one data bytes were written.
+ * @retval -EBUSY Buffer space is loaned by k_pipe_put_loan().
  * @req K-PIPE-002
  */
 __syscall int k_pipe_put(struct k_pipe *pipe, void *data,
 			 size_t bytes_to_write, size_t *bytes_written,
 			 size_t min_xfer, s32_t timeout);
 
+/**
+ * @brief Loan pipe buffer space to write data in place.
+ *
+ * This routine gives access to the free space following the data in the
+ * buffer of @a pipe, which the caller fills directly and then sends with
+ * k_pipe_put_commit(), saving a copy compared to k_pipe_put(). The space
+ * is contiguous, so it may be smaller than the free space of the buffer if
+ * that wraps around. Only one writer can hold a loan at a time, and other
+ * writers fail with -EBUSY meanwhile. Committed data is handed to readers
+ * already waiting with k_pipe_get() with a single copy.
+ *
+ * The space is in the pipe's buffer, so this routine is not available to
+ * user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of area to hold the address of the space.
+ * @param bytes Address of area to hold the size of the space (in bytes).
+ *
+ * @retval 0 Space loaned.
+ * @retval -EIO The buffer is full, or the pipe has none.
+ * @retval -EBUSY Buffer space is already loaned.
+ */
+extern int k_pipe_put_loan(struct k_pipe *pipe, void **data, size_t *bytes);
+
+/**
+ * @brief Send data written in loaned pipe buffer space.
+ *
+ * @param pipe Address of the pipe.
+ * @param bytes Number of bytes written, at most the size of the loan.
+ *
+ * @retval 0 Data sent.
+ * @retval -EINVAL No buffer space is loaned, or @a bytes exceeds the loan.
+ */
+extern int k_pipe_put_commit(struct k_pipe *pipe, size_t bytes);
+
 /**
  * @brief Read data from a pipe.
  *
@@ -3829,12 +4749,47 @@ __syscall int k_pipe_put(struct k_pipe *pipe, void *data,
  * @retval -EIO Returned without waiting; zero data bytes were read.
  * @retval -EAGAIN Waiting period timed out; between zero and @a min_xfer
  *                 minus one data bytes were read.
+ * @retval -EBUSY Buffer data is loaned by k_pipe_get_loan().
  * @req K-PIPE-002
  */
 __syscall int k_pipe_get(struct k_pipe *pipe, void *data,
 			 size_t bytes_to_read, size_t *bytes_read,
 			 size_t min_xfer, s32_t timeout);
 
+/**
+ * @brief Loan pipe buffer data to read it in place.
+ *
+ * This routine gives access to the data at the head of the buffer of
+ * @a pipe, saving a copy compared to k_pipe_get(). The data is contiguous,
+ * so it may be less than the buffer holds if that wraps around. The data
+ * stays in the pipe until the caller releases some or all of it with
+ * k_pipe_get_release(). Only one reader can hold a loan at a time, and
+ * other readers fail with -EBUSY meanwhile.
+ *
+ * The data is in the pipe's buffer, so this routine is not available to
+ * user mode threads.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of area to hold the address of the data.
+ * @param bytes Address of area to hold the size of the data (in bytes).
+ *
+ * @retval 0 Data loaned.
+ * @retval -EIO The buffer is empty, or the pipe has none.
+ * @retval -EBUSY Buffer data is already loaned.
+ */
+extern int k_pipe_get_loan(struct k_pipe *pipe, void **data, size_t *bytes);
+
+/**
+ * @brief Remove loaned data from a pipe.
+ *
+ * @param pipe Address of the pipe.
+ * @param bytes Number of bytes consumed, at most the size of the loan.
+ *
+ * @retval 0 Data removed.
+ * @retval -EINVAL No buffer data is loaned, or @a bytes exceeds the loan.
+ */
+extern int k_pipe_get_release(struct k_pipe *pipe, size_t bytes);
+
 /**
  * @brief Write memory block to a pipe.
  *
@@ -3859,14 +4814,38 @@ extern void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
  * @cond INTERNAL_HIDDEN
  */
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+struct _k_mem_slab_magazine {
+	struct k_spinlock lock;
+	u32_t count;
+	/* frees bypass the magazine while threads wait for a block */
+	u8_t bypass;
+	char *blocks[CONFIG_MEM_SLAB_CPU_CACHE_DEPTH];
+	u32_t alloc_hits;
+	u32_t alloc_misses;
+	u32_t free_hits;
+	u32_t free_misses;
+};
+#endif
+
 struct k_mem_slab {
 	_wait_q_t wait_q;
+	struct k_spinlock lock;
 	u32_t num_blocks;
 	size_t block_size;
 	char *buffer;
+	/* blocks freed since they were carved from the buffer */
 	char *free_list;
+	/* blocks carved from the buffer so far, on first allocation */
+	u32_t num_carved;
+	/* blocks off free_list, including the ones cached per CPU */
 	u32_t num_used;
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	struct _k_mem_slab_magazine cache[CONFIG_MP_NUM_CPUS];
+	u8_t cache_bypass;
+#endif
+
 	_OBJECT_TRACING_NEXT_PTR(k_mem_slab);
 };
 
@@ -3878,6 +4857,7 @@ struct k_mem_slab {
 	.block_size = slab_block_size, \
 	.buffer = slab_buffer, \
 	.free_list = NULL, \
+	.num_carved = 0, \
 	.num_used = 0, \
 	_OBJECT_TRACING_INIT \
 	}
@@ -3992,7 +4972,13 @@ extern void k_mem_slab_free(struct k_mem_slab *slab, void **mem);
  */
 static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
 {
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	extern u32_t _k_mem_slab_num_cached(struct k_mem_slab *slab);
+
+	return slab->num_used - _k_mem_slab_num_cached(slab);
+#else
 	return slab->num_used;
+#endif
 }
 
 /**
@@ -4008,9 +4994,109 @@ static inline u32_t k_mem_slab_num_used_get(struct k_mem_slab *slab)
  */
 static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
 {
-	return slab->num_blocks - slab->num_used;
+	return slab->num_blocks - k_mem_slab_num_used_get(slab);
 }
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+/**
+ * @brief Memory slab per-CPU cache statistics.
+ */
+struct k_mem_slab_cache_stats {
+	/** Allocations served by the local CPU's magazine */
+	u32_t alloc_hits;
+	/** Allocations that had to go to the shared free list */
+	u32_t alloc_misses;
+	/** Frees kept in the local CPU's magazine */
+	u32_t free_hits;
+	/** Frees that had to go to the shared free list */
+	u32_t free_misses;
+};
+
+/**
+ * @brief Get the per-CPU cache statistics of a memory slab.
+ *
+ * The statistics of all the CPUs are summed up.
+ *
+ * @param slab Address of the memory slab.
+ * @param stats Statistics filled by this routine.
+ *
+ * @return N/A
+ */
+extern void k_mem_slab_cache_stats_get(struct k_mem_slab *slab,
+				       struct k_mem_slab_cache_stats *stats);
+#endif
+
+/** @} */
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+#ifdef CONFIG_MEM_POOL_STATS
+#define _K_MEM_POOL_STATS_BUCKETS CONFIG_MEM_POOL_STATS_BUCKETS
+#else
+#define _K_MEM_POOL_STATS_BUCKETS 1
+#endif
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @addtogroup mem_pool_apis
+ * @{
+ */
+
+/**
+ * @brief Sampled memory pool allocation.
+ */
+struct k_mem_pool_sample {
+	/** Address the allocation routine was called from */
+	void *caller;
+	/** Requested size (in bytes) */
+	u32_t size;
+};
+
+/**
+ * @brief Memory pool statistics.
+ *
+ * Histograms count blocks or requests by size, in power of two buckets:
+ * bucket 0 holds sizes below 16 bytes, bucket i sizes from 2^(i+3) to
+ * 2^(i+4) - 1 bytes, and the last bucket all larger sizes.
+ */
+struct k_mem_pool_stats {
+	/** Successful allocations */
+	u32_t alloc_count;
+	/** Frees */
+	u32_t free_count;
+	/** Allocations that failed or timed out */
+	u32_t failed_count;
+	/** Bytes currently allocated, counting whole blocks */
+	u32_t used_bytes;
+	/** High watermark of used_bytes */
+	u32_t max_used_bytes;
+	/** Blocks currently allocated */
+	u32_t used_blocks;
+	/** High watermark of used_blocks */
+	u32_t max_used_blocks;
+	/** Allocation requests by requested size, including failed ones */
+	u32_t request_hist[_K_MEM_POOL_STATS_BUCKETS];
+	/** Allocated blocks by block size */
+	u32_t used_hist[_K_MEM_POOL_STATS_BUCKETS];
+	/** Free blocks by block size, computed by k_mem_pool_stats_get() */
+	u32_t free_hist[_K_MEM_POOL_STATS_BUCKETS];
+	/** Caller of the last failed allocation */
+	void *last_failed_caller;
+	/** Requested size of the last failed allocation */
+	u32_t last_failed_size;
+#ifdef CONFIG_MEM_POOL_STATS
+	/** Every CONFIG_MEM_POOL_STATS_SAMPLE_RATE-th allocation, latest
+	 * first; unused entries have a NULL caller
+	 */
+	struct k_mem_pool_sample samples[CONFIG_MEM_POOL_STATS_SAMPLES];
+#endif
+};
+
 /** @} */
 
 /**
@@ -4018,8 +5104,16 @@ static inline u32_t k_mem_slab_num_free_get(struct k_mem_slab *slab)
  */
 
 struct k_mem_pool {
+#ifdef CONFIG_MEM_POOL_TLSF
+	struct sys_tlsf tlsf;
+#else
 	struct sys_mem_pool_base base;
+#endif
 	_wait_q_t wait_q;
+#ifdef CONFIG_MEM_POOL_STATS
+	struct k_mem_pool_stats stats;
+	u8_t sample_next;
+#endif
 };
 
 /**
@@ -4044,6 +5138,10 @@ struct k_mem_pool {
  *
  * @code extern struct k_mem_pool <name>; @endcode
  *
+ * With CONFIG_MEM_POOL_TLSF, the pool is a heap serving blocks of any size
+ * instead, large enough to hold as many blocks of @a max_size or @a min_size
+ * bytes as the partitioned pool would.
+ *
  * @param name Name of the memory pool.
  * @param minsz Size of the smallest blocks in the pool (in bytes).
  * @param maxsz Size of the largest blocks in the pool (in bytes).
@@ -4051,6 +5149,27 @@ struct k_mem_pool {
  * @param align Alignment of the pool's buffer (power of 2).
  * @req K-MPOOL-001
  */
+#ifdef CONFIG_MEM_POOL_TLSF
+/* The TLSF heap is sized to hold at once as many blocks as the buddy
+ * allocator would, of either the largest or the smallest size.
+ */
+#define _K_MEM_POOL_TLSF_SIZE(minsz, maxsz, nmax)			\
+	(_TLSF_BUF_SIZE(maxsz, nmax) >					\
+	 _TLSF_BUF_SIZE(minsz, (nmax) * ((maxsz) / (minsz))) ?		\
+	 _TLSF_BUF_SIZE(maxsz, nmax) :					\
+	 _TLSF_BUF_SIZE(minsz, (nmax) * ((maxsz) / (minsz))))
+
+#define K_MEM_POOL_DEFINE(name, minsz, maxsz, nmax, align)		\
+	char __aligned((align) > _TLSF_ALIGN ? (align) : _TLSF_ALIGN)	\
+		_mpool_buf_##name[_K_MEM_POOL_TLSF_SIZE(minsz, maxsz, nmax)]; \
+	struct k_mem_pool name __in_section(_k_mem_pool, static, name) = { \
+		.tlsf = {						\
+			.buf = _mpool_buf_##name,			\
+			.buf_size = sizeof(_mpool_buf_##name),		\
+		},							\
+		.wait_q = _WAIT_Q_INIT(&name.wait_q),			\
+	}
+#else
 #define K_MEM_POOL_DEFINE(name, minsz, maxsz, nmax, align)		\
 	char __aligned(align) _mpool_buf_##name[_ALIGN4(maxsz * nmax)	\
 				  + _MPOOL_BITS_SIZE(maxsz, minsz, nmax)]; \
@@ -4063,8 +5182,10 @@ struct k_mem_pool {
 			.n_levels = _MPOOL_LVLS(maxsz, minsz),		\
 			.levels = _mpool_lvls_##name,			\
 			.flags = SYS_MEM_POOL_KERNEL			\
-		} \
+		},							\
+		.wait_q = _WAIT_Q_INIT(&name.wait_q),			\
 	}
+#endif
 
 /**
  * @brief Allocate memory from a memory pool.
@@ -4125,6 +5246,31 @@ extern void k_mem_pool_free(struct k_mem_block *block);
  */
 extern void k_mem_pool_free_id(struct k_mem_block_id *id);
 
+#ifdef CONFIG_MEM_POOL_STATS
+/**
+ * @brief Get the statistics of a memory pool.
+ *
+ * @param pool Address of the memory pool.
+ * @param stats Statistics filled by this routine.
+ *
+ * @return N/A
+ */
+extern void k_mem_pool_stats_get(struct k_mem_pool *pool,
+				 struct k_mem_pool_stats *stats);
+
+/**
+ * @brief Reset the statistics of a memory pool.
+ *
+ * Counters, failure information and samples are cleared, and high
+ * watermarks are set to the current usage.
+ *
+ * @param pool Address of the memory pool.
+ *
+ * @return N/A
+ */
+extern void k_mem_pool_stats_reset(struct k_mem_pool *pool);
+#endif
+
 /**
  * @}
  */
@@ -4188,10 +5334,15 @@ extern void *k_calloc(size_t nmemb, size_t size);
 #define _INIT_OBJ_POLL_EVENT(obj) do { } while ((0))
 #endif
 
+struct k_poll_set;
+
 /* private - implementation data created as needed, per-type */
 struct _poller {
 	struct k_thread *thread;
 	volatile int is_polling;
+
+	/* poll set the events belong to, NULL for k_poll() */
+	struct k_poll_set *set;
 };
 
 /* private - types bit positions */
@@ -4475,6 +5626,93 @@ __syscall void k_poll_signal_check(struct k_poll_signal *signal,
 
 __syscall int k_poll_signal(struct k_poll_signal *signal, int result);
 
+/* public - persistent poll set */
+struct k_poll_set {
+	/* PRIVATE - DO NOT TOUCH */
+	struct _poller poller;
+
+	/* events whose condition was met since they were last reported */
+	sys_dlist_t ready;
+
+	/* threads waiting in k_poll_set_wait() */
+	_wait_q_t wait_q;
+
+	/* number of events in the set */
+	int num_events;
+};
+
+/**
+ * @brief Initialize a poll set.
+ *
+ * A poll set keeps its events registered with their objects across waits,
+ * so that waiting on it costs a function of the number of events that are
+ * ready, not of the number of events in the set. It is meant for threads
+ * that repeatedly wait on the same, large, collection of objects.
+ *
+ * When an object wakes up the pollers of several events, the events of a
+ * poll set are ranked at the priority of the thread that initialized the set
+ * or last waited on it.
+ *
+ * Poll sets are only available to supervisor threads.
+ *
+ * @param set Address of the poll set.
+ *
+ * @return N/A
+ */
+extern void k_poll_set_init(struct k_poll_set *set);
+
+/**
+ * @brief Add an event to a poll set.
+ *
+ * The event must have been initialized with k_poll_event_init() or one of
+ * the K_POLL_EVENT_xxx initializers, and must not be in use in a k_poll()
+ * call or in another poll set. It stays in the set, and must not be
+ * modified, until it is removed with k_poll_set_remove().
+ *
+ * @param set Address of the poll set.
+ * @param event Address of the event.
+ *
+ * @retval 0 Event added.
+ * @retval -EBUSY Event already in use.
+ */
+extern int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event);
+
+/**
+ * @brief Remove an event from a poll set.
+ *
+ * @param set Address of the poll set.
+ * @param event Address of the event.
+ *
+ * @retval 0 Event removed.
+ * @retval -EINVAL Event not in the set.
+ */
+extern int k_poll_set_remove(struct k_poll_set *set,
+			     struct k_poll_event *event);
+
+/**
+ * @brief Wait for events of a poll set to be ready.
+ *
+ * This routine waits until at least one event of the set is ready and
+ * returns the addresses of up to @a max_ready ready events in @a ready,
+ * with their state field set to the conditions that were met.
+ *
+ * Events are level-triggered: an event whose condition is still met, e.g.
+ * because the semaphore was not taken, is reported again by the next call.
+ * The state of the events does not need to be reset by the caller.
+ *
+ * @param set Address of the poll set.
+ * @param ready Array receiving the addresses of the ready events.
+ * @param max_ready Size of the @a ready array.
+ * @param timeout Waiting period for an event to be ready (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @return Number of ready events (at least 1) if successful.
+ * @retval -EAGAIN Waiting period timed out.
+ * @retval -EINTR Waiting was cancelled, see k_queue_cancel_wait().
+ */
+extern int k_poll_set_wait(struct k_poll_set *set, struct k_poll_event **ready,
+			   int max_ready, s32_t timeout);
+
 /**
  * @internal
  */
@@ -97,14 +97,16 @@
 /*
  * link in shell initialization objects for all modules that use shell and
  * their shell commands are automatically initialized by the kernel.
+ * The section names end with the module or command name, sorting them
+ * lets the shell look them up with a binary search.
  */
 
 #define	SHELL_INIT_SECTIONS()				\
 		__shell_module_start = .;		\
-		KEEP(*(".shell_module_*"));		\
+		KEEP(*(SORT_BY_NAME(".shell_module_*")));	\
 		__shell_module_end = .;			\
 		__shell_cmd_start = .;			\
-		KEEP(*(".shell_cmd_*"));		\
+		KEEP(*(SORT_BY_NAME(".shell_cmd_*")));	\
 		__shell_cmd_end = .;			\
 
 #ifdef CONFIG_APPLICATION_MEMORY
@@ -247,6 +249,24 @@ extern char __ccm_noinit_end[];
 extern char __ccm_end[];
 #endif /* CONFIG_CCM_BASE_ADDRESS */
 
+#ifdef CONFIG_ITCM_BASE_ADDRESS
+extern char __itcm_rom_start[];
+extern char __itcm_start[];
+extern char __itcm_end[];
+#endif /* CONFIG_ITCM_BASE_ADDRESS */
+
+#ifdef CONFIG_DTCM_BASE_ADDRESS
+extern char __dtcm_data_rom_start[];
+extern char __dtcm_start[];
+extern char __dtcm_data_start[];
+extern char __dtcm_data_end[];
+extern char __dtcm_bss_start[];
+extern char __dtcm_bss_end[];
+extern char __dtcm_noinit_start[];
+extern char __dtcm_noinit_end[];
+extern char __dtcm_end[];
+#endif /* CONFIG_DTCM_BASE_ADDRESS */
+
 
 #endif /* ! _ASMLANGUAGE */
 
@@ -25,6 +25,27 @@
 #define __ccm_noinit_section _GENERIC_SECTION(_CCM_NOINIT_SECTION_NAME)
 #endif /* CONFIG_ARM */
 
+/*
+ * Code and data in tightly coupled memories, when the board has them,
+ * else code goes to RAM (see __ramfunc) and data stays where it was.
+ */
+#if defined(CONFIG_ITCM_BASE_ADDRESS)
+#define __itcm __attribute__((noinline)) __attribute__((long_call)) \
+	__in_section_unique(_ITCM_SECTION_NAME)
+#else
+#define __itcm __ramfunc
+#endif
+
+#if defined(CONFIG_DTCM_BASE_ADDRESS)
+#define __dtcm __in_section_unique(_DTCM_DATA_SECTION_NAME)
+#define __dtcm_bss __in_section_unique(_DTCM_BSS_SECTION_NAME)
+#define __dtcm_noinit __in_section_unique(_DTCM_NOINIT_SECTION_NAME)
+#else
+#define __dtcm
+#define __dtcm_bss
+#define __dtcm_noinit __noinit
+#endif
+
 #endif /* !_ASMLANGUAGE */
 
 #endif /* _section_tags__h_ */
@@ -58,6 +58,11 @@
 
 #endif
 
+#define _ITCM_SECTION_NAME		itcm
+#define _DTCM_DATA_SECTION_NAME		dtcm_data
+#define _DTCM_BSS_SECTION_NAME		dtcm_bss
+#define _DTCM_NOINIT_SECTION_NAME	dtcm_noinit
+
 #include <linker/section_tags.h>
 
 #endif /* _SECTIONS_H */
@@ -30,6 +30,25 @@ extern "C" {
 #define SYS_LOG_LEVEL CONFIG_SYS_LOG_OVERRIDE_LEVEL
 #endif
 
+#if defined(CONFIG_SYS_LOG_DEFERRED)
+void sys_log_deferred(int level, const char *domain, const char *fmt, ...);
+
+/**
+ * @brief Set the log level of a domain at runtime
+ *
+ * Messages of the domain above the level are dropped when logging. The
+ * level can only be lowered from the one the domain is built with.
+ *
+ * @param domain Log domain, as defined by SYS_LOG_DOMAIN. The string must
+ * stay valid as long as the filter is in use.
+ * @param level New log level, SYS_LOG_LEVEL_OFF to SYS_LOG_LEVEL_DEBUG.
+ *
+ * @return 0 on success, -EINVAL on an invalid level, -ENOMEM if all the
+ * CONFIG_SYS_LOG_DEFERRED_FILTERS filters are in use.
+ */
+int sys_log_filter_set(const char *domain, int level);
+#endif
+
 /**
  * @brief System Log
  * @defgroup system_log System Log
@@ -48,6 +67,14 @@ void syslog_hook_install(void (*hook)(const char *, ...));
 #define SYS_LOG_BACKEND_FN printk
 #endif
 
+#if defined(CONFIG_SYS_LOG_DEFERRED)
+/* only the arguments are stored, the thread of the logger outputs them */
+#define SYS_LOG_BACKEND_CALL_FN(level, ...)				\
+	sys_log_deferred(level, SYS_LOG_DOMAIN, ##__VA_ARGS__)
+#else
+#define SYS_LOG_BACKEND_CALL_FN(level, ...) SYS_LOG_BACKEND_FN(__VA_ARGS__)
+#endif
+
 /* Should use color? */
 #if defined(CONFIG_SYS_LOG_SHOW_COLOR)
 #define SYS_LOG_COLOR_OFF     "\x1B[0m"
@@ -94,30 +121,33 @@ void syslog_hook_install(void (*hook)(const char *, ...));
 
 /* [domain] [level] function: */
 #define LOG_LAYOUT "[%s]%s %s: %s"
-#define LOG_BACKEND_CALL(log_lv, log_color, log_format, color_off, ...)	\
-	SYS_LOG_BACKEND_FN(LOG_LAYOUT log_format "%s" SYS_LOG_NL,	\
+#define LOG_BACKEND_CALL(level, log_lv, log_color, log_format, color_off, \
+			 ...)						\
+	SYS_LOG_BACKEND_CALL_FN(level, LOG_LAYOUT log_format "%s" SYS_LOG_NL, \
 	SYS_LOG_DOMAIN, log_lv, __func__, log_color, ##__VA_ARGS__, color_off)
 
-#define LOG_NO_COLOR(log_lv, log_format, ...)				\
-	LOG_BACKEND_CALL(log_lv, "", log_format, "", ##__VA_ARGS__)
-#define LOG_COLOR(log_lv, log_color, log_format, ...)			\
-	LOG_BACKEND_CALL(log_lv, log_color, log_format,			\
+#define LOG_NO_COLOR(level, log_lv, log_format, ...)			\
+	LOG_BACKEND_CALL(level, log_lv, "", log_format, "", ##__VA_ARGS__)
+#define LOG_COLOR(level, log_lv, log_color, log_format, ...)		\
+	LOG_BACKEND_CALL(level, log_lv, log_color, log_format,		\
 	SYS_LOG_COLOR_OFF, ##__VA_ARGS__)
 
-#define SYS_LOG_ERR(...) LOG_COLOR(SYS_LOG_TAG_ERR, SYS_LOG_COLOR_RED,	\
-	##__VA_ARGS__)
+#define SYS_LOG_ERR(...) LOG_COLOR(SYS_LOG_LEVEL_ERROR, SYS_LOG_TAG_ERR, \
+	SYS_LOG_COLOR_RED, ##__VA_ARGS__)
 
 #if (SYS_LOG_LEVEL >= SYS_LOG_LEVEL_WARNING)
-#define SYS_LOG_WRN(...) LOG_COLOR(SYS_LOG_TAG_WRN,			\
+#define SYS_LOG_WRN(...) LOG_COLOR(SYS_LOG_LEVEL_WARNING, SYS_LOG_TAG_WRN, \
 	SYS_LOG_COLOR_YELLOW, ##__VA_ARGS__)
 #endif
 
 #if (SYS_LOG_LEVEL >= SYS_LOG_LEVEL_INFO)
-#define SYS_LOG_INF(...) LOG_NO_COLOR(SYS_LOG_TAG_INF, ##__VA_ARGS__)
+#define SYS_LOG_INF(...) LOG_NO_COLOR(SYS_LOG_LEVEL_INFO, SYS_LOG_TAG_INF, \
+	##__VA_ARGS__)
 #endif
 
 #if (SYS_LOG_LEVEL == SYS_LOG_LEVEL_DEBUG)
-#define SYS_LOG_DBG(...) LOG_NO_COLOR(SYS_LOG_TAG_DBG, ##__VA_ARGS__)
+#define SYS_LOG_DBG(...) LOG_NO_COLOR(SYS_LOG_LEVEL_DEBUG, SYS_LOG_TAG_DBG, \
+	##__VA_ARGS__)
 #endif
 
 #else
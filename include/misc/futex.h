@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Mutexes and semaphores built on futexes
+ *
+ * These objects live entirely in the caller's memory and are only
+ * manipulated with atomic operations as long as they are not contended;
+ * k_futex_wait() and k_futex_wake() are only called to put a thread to
+ * sleep or to wake one up. A user thread using them therefore only makes
+ * system calls under contention.
+ *
+ * Unlike k_mutex, sys_futex_mutex has no priority inheritance and is not
+ * recursive.
+ */
+
+#ifndef _MISC_FUTEX_H_
+#define _MISC_FUTEX_H_
+
+#include <kernel.h>
+#include <atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* sys_futex_mutex states */
+#define _SYS_FUTEX_MUTEX_UNLOCKED	0
+#define _SYS_FUTEX_MUTEX_LOCKED		1
+#define _SYS_FUTEX_MUTEX_CONTENDED	2
+
+struct sys_futex_mutex {
+	atomic_t val;
+};
+
+struct sys_futex_sem {
+	atomic_t count;
+	atomic_t waiters;
+	atomic_val_t limit;
+};
+
+#define SYS_FUTEX_MUTEX_INITIALIZER { ATOMIC_INIT(_SYS_FUTEX_MUTEX_UNLOCKED) }
+
+#define SYS_FUTEX_SEM_INITIALIZER(initial_count, count_limit) \
+	{ ATOMIC_INIT(initial_count), ATOMIC_INIT(0), count_limit }
+
+/**
+ * @brief Initialize a futex mutex.
+ *
+ * @param mutex Address of the mutex.
+ */
+static inline void sys_futex_mutex_init(struct sys_futex_mutex *mutex)
+{
+	atomic_set(&mutex->val, _SYS_FUTEX_MUTEX_UNLOCKED);
+}
+
+/**
+ * @brief Lock a futex mutex.
+ *
+ * The timeout applies to each time the calling thread has to wait, not to
+ * the whole operation.
+ *
+ * @param mutex Address of the mutex.
+ * @param timeout Waiting period to lock the mutex (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Mutex locked.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+static inline int sys_futex_mutex_lock(struct sys_futex_mutex *mutex,
+				       s32_t timeout)
+{
+	if (atomic_cas(&mutex->val, _SYS_FUTEX_MUTEX_UNLOCKED,
+		       _SYS_FUTEX_MUTEX_LOCKED)) {
+		return 0;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		return -EBUSY;
+	}
+
+	/* Mark the mutex contended, so that its owner wakes us up, and
+	 * sleep until we are the one who found it unlocked.
+	 */
+	while (atomic_set(&mutex->val, _SYS_FUTEX_MUTEX_CONTENDED) !=
+	       _SYS_FUTEX_MUTEX_UNLOCKED) {
+		if (k_futex_wait(&mutex->val, _SYS_FUTEX_MUTEX_CONTENDED,
+				 timeout) == -ETIMEDOUT) {
+			return -EAGAIN;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Unlock a futex mutex.
+ *
+ * @param mutex Address of the mutex, locked by the calling thread.
+ */
+static inline void sys_futex_mutex_unlock(struct sys_futex_mutex *mutex)
+{
+	if (atomic_dec(&mutex->val) != _SYS_FUTEX_MUTEX_LOCKED) {
+		atomic_set(&mutex->val, _SYS_FUTEX_MUTEX_UNLOCKED);
+		k_futex_wake(&mutex->val, 0);
+	}
+}
+
+/**
+ * @brief Initialize a futex semaphore.
+ *
+ * @param sem Address of the semaphore.
+ * @param initial_count Initial semaphore count.
+ * @param limit Maximum permitted semaphore count.
+ */
+static inline void sys_futex_sem_init(struct sys_futex_sem *sem,
+				      unsigned int initial_count,
+				      unsigned int limit)
+{
+	atomic_set(&sem->count, initial_count);
+	atomic_set(&sem->waiters, 0);
+	sem->limit = limit;
+}
+
+/**
+ * @brief Take a futex semaphore.
+ *
+ * The timeout applies to each time the calling thread has to wait, not to
+ * the whole operation.
+ *
+ * @param sem Address of the semaphore.
+ * @param timeout Waiting period to take the semaphore (in milliseconds),
+ *                or one of the special values K_NO_WAIT and K_FOREVER.
+ *
+ * @retval 0 Semaphore taken.
+ * @retval -EBUSY Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+static inline int sys_futex_sem_take(struct sys_futex_sem *sem, s32_t timeout)
+{
+	atomic_val_t count;
+	int ret;
+
+	for (;;) {
+		count = atomic_get(&sem->count);
+		if (count > 0) {
+			if (atomic_cas(&sem->count, count, count - 1)) {
+				return 0;
+			}
+			continue;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			return -EBUSY;
+		}
+
+		/* A give that happens after we announced ourselves wakes us
+		 * up; one happening before changes the count, and the wait
+		 * returns right away.
+		 */
+		atomic_inc(&sem->waiters);
+		ret = k_futex_wait(&sem->count, 0, timeout);
+		atomic_dec(&sem->waiters);
+
+		if (ret == -ETIMEDOUT) {
+			return -EAGAIN;
+		}
+	}
+}
+
+/**
+ * @brief Give a futex semaphore.
+ *
+ * The count is left unchanged if it already reached its limit.
+ *
+ * @param sem Address of the semaphore.
+ */
+static inline void sys_futex_sem_give(struct sys_futex_sem *sem)
+{
+	atomic_val_t count;
+
+	do {
+		count = atomic_get(&sem->count);
+		if (count >= sem->limit) {
+			break;
+		}
+	} while (!atomic_cas(&sem->count, count, count + 1));
+
+	if (atomic_get(&sem->waiters) != 0) {
+		k_futex_wake(&sem->count, 0);
+	}
+}
+
+/**
+ * @brief Get a futex semaphore's count.
+ *
+ * @param sem Address of the semaphore.
+ *
+ * @return Current semaphore count.
+ */
+static inline unsigned int sys_futex_sem_count_get(struct sys_futex_sem *sem)
+{
+	return atomic_get(&sem->count);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MISC_FUTEX_H_ */
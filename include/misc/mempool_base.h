@@ -107,4 +107,8 @@ int _sys_mem_pool_block_alloc(struct sys_mem_pool_base *p, size_t size,
 void _sys_mem_pool_block_free(struct sys_mem_pool_base *p, u32_t level,
 			      u32_t block);
 
+size_t _sys_mem_pool_base_level_size(struct sys_mem_pool_base *p, u32_t level);
+
+u32_t _sys_mem_pool_base_free_count(struct sys_mem_pool_base *p, u32_t level);
+
 #endif /* SYS_MEMPOOL_BASE_H */
@@ -66,6 +66,8 @@ struct rbtree {
 	struct rbnode *root;
 	rb_lessthan_t lessthan_fn;
 	int max_depth;
+	/* Cached lowest-sorted node, maintained by insert and remove */
+	struct rbnode *min;
 };
 
 typedef void (*rb_visit_t)(struct rbnode *node, void *cookie);
@@ -87,10 +89,12 @@ void rb_remove(struct rbtree *tree, struct rbnode *node);
 
 /**
  * @brief Returns the lowest-sorted member of the tree
+ *
+ * The node is cached in the tree, so this is O(1).
  */
 static inline struct rbnode *rb_get_min(struct rbtree *tree)
 {
-	return _rb_get_minmax(tree, 0);
+	return tree->min;
 }
 
 /**
@@ -112,6 +116,27 @@ static inline struct rbnode *rb_get_max(struct rbtree *tree)
  */
 int rb_contains(struct rbtree *tree, struct rbnode *node);
 
+/**
+ * @brief Returns the member of the tree sorted after the given node
+ *
+ * Together with rb_get_min(), this enumerates the tree in order
+ * without any state beyond the current node, so unlike RB_FOR_EACH it
+ * needs no stack and the loop may remove the current node once the
+ * next one has been fetched:
+ *
+ *     for (n = rb_get_min(tree); n; n = next) {
+ *             next = rb_next(tree, n);
+ *             ...
+ *     }
+ *
+ * The successor is the leftmost node of the right subtree when there
+ * is one, otherwise it is found by a search from the root, so a step
+ * costs O(log2(N)) in the worst case.
+ *
+ * @return The next node, or NULL if node is the highest-sorted one
+ */
+struct rbnode *rb_next(struct rbtree *tree, struct rbnode *node);
+
 /**
  * @brief Walk/enumerate a rbtree
  *
@@ -19,6 +19,9 @@ static inline size_t stack_unused_space_get(const char *stack, size_t size)
 {
 	size_t unused = 0;
 	int i;
+#if !defined(CONFIG_STACK_GROWS_UP)
+	const u32_t *word;
+#endif
 
 #ifdef CONFIG_STACK_SENTINEL
 	/* First 4 bytes of the stack buffer reserved for the sentinel
@@ -42,7 +45,22 @@ static inline size_t stack_unused_space_get(const char *stack, size_t size)
 		}
 	}
 #else
-	for (i = 0; i < size; i++) {
+	/* Compare a word at a time up to the first one written */
+	for (i = 0; i < size && ((uintptr_t)&stack[i] & 3); i++) {
+		if ((unsigned char)stack[i] != 0xaa) {
+			return unused;
+		}
+		unused++;
+	}
+
+	for (word = (const u32_t *)&stack[i]; i + 4 <= size; i += 4) {
+		if (*word++ != 0xaaaaaaaa) {
+			break;
+		}
+		unused += 4;
+	}
+
+	for (; i < size; i++) {
 		if ((unsigned char)stack[i] == 0xaa) {
 			unused++;
 		} else {
@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef SYS_TLSF_H
+#define SYS_TLSF_H
+
+#include <zephyr/types.h>
+#include <stddef.h>
+
+/*
+ * Two-Level Segregated Fit heap, used as the k_mem_pool backend with
+ * CONFIG_MEM_POOL_TLSF.
+ *
+ * Free blocks are kept in size classes: a first level of power of two
+ * ranges, each split in 2^SL_LOG2 linear second level ranges, with one
+ * bitmap per level telling which classes have free blocks. Allocation and
+ * free are O(1) and allocations are only rounded up to the size class
+ * granularity. Adjacent free blocks are merged on free.
+ *
+ * Nothing here is thread safe, callers provide locking.
+ */
+
+#define _TLSF_ALIGN_LOG2	3
+#define _TLSF_ALIGN		(1 << _TLSF_ALIGN_LOG2)
+#define _TLSF_SL_LOG2		CONFIG_MEM_POOL_TLSF_SL_LOG2
+#define _TLSF_SL_COUNT		(1 << _TLSF_SL_LOG2)
+#define _TLSF_FL_SHIFT		(_TLSF_SL_LOG2 + _TLSF_ALIGN_LOG2)
+#define _TLSF_FL_INDEX_MAX	CONFIG_MEM_POOL_TLSF_FL_INDEX_MAX
+#define _TLSF_FL_COUNT		(_TLSF_FL_INDEX_MAX - _TLSF_FL_SHIFT + 2)
+
+struct sys_tlsf_block {
+	/* physically previous block, NULL for the first one */
+	struct sys_tlsf_block *prev_phys;
+	/* size including this header, low bit set when free */
+	size_t size;
+	/* free list links, only valid (and present) in free blocks */
+	struct sys_tlsf_block *next_free;
+	struct sys_tlsf_block *prev_free;
+};
+
+/* Per block overhead: allocated blocks only keep the first two fields */
+#define _TLSF_HDR_SIZE	(2 * sizeof(void *))
+
+#define _TLSF_ROUND(n)	((((n) + _TLSF_ALIGN - 1) / _TLSF_ALIGN) * _TLSF_ALIGN)
+
+/* Size of the block holding an allocation of n bytes */
+#define _TLSF_BLOCK_SIZE(n)						\
+	(_TLSF_ROUND((n) + _TLSF_HDR_SIZE) < sizeof(struct sys_tlsf_block) ? \
+	 _TLSF_ROUND(sizeof(struct sys_tlsf_block)) :			\
+	 _TLSF_ROUND((n) + _TLSF_HDR_SIZE))
+
+/* Buffer size needed to hold n allocations of sz bytes at once */
+#define _TLSF_BUF_SIZE(sz, n) ((n) * _TLSF_BLOCK_SIZE(sz) + _TLSF_HDR_SIZE)
+
+struct sys_tlsf {
+	void *buf;
+	size_t buf_size;
+	u32_t fl_bitmap;
+	u32_t sl_bitmap[_TLSF_FL_COUNT];
+	struct sys_tlsf_block *free[_TLSF_FL_COUNT][_TLSF_SL_COUNT];
+};
+
+/**
+ * @brief Initialize a TLSF heap over the buffer it was defined with
+ *
+ * The buffer must be aligned to at least _TLSF_ALIGN bytes.
+ *
+ * @param h Heap to initialize
+ */
+void _sys_tlsf_init(struct sys_tlsf *h);
+
+/**
+ * @brief Allocate memory from a TLSF heap
+ *
+ * @param h Heap to allocate from
+ * @param size Requested size, in bytes
+ * @return _TLSF_ALIGN aligned memory, or NULL if none is available
+ */
+void *_sys_tlsf_alloc(struct sys_tlsf *h, size_t size);
+
+/**
+ * @brief Free memory allocated from a TLSF heap
+ *
+ * @param h Heap the memory was allocated from
+ * @param ptr Memory returned by _sys_tlsf_alloc()
+ */
+void _sys_tlsf_free(struct sys_tlsf *h, void *ptr);
+
+/**
+ * @brief Get the usable size of memory allocated from a TLSF heap
+ *
+ * @param ptr Memory returned by _sys_tlsf_alloc()
+ * @return Size of the block holding it, less its header
+ */
+static inline size_t _sys_tlsf_usable_size(void *ptr)
+{
+	struct sys_tlsf_block *b =
+		(struct sys_tlsf_block *)((char *)ptr - _TLSF_HDR_SIZE);
+
+	return (b->size & ~(size_t)1) - _TLSF_HDR_SIZE;
+}
+
+/**
+ * @brief Call a function on the usable size of all the free blocks
+ *
+ * @param h Heap to walk
+ * @param cb Function to call
+ * @param arg Argument passed to @a cb
+ */
+void _sys_tlsf_foreach_free(struct sys_tlsf *h,
+			    void (*cb)(size_t size, void *arg), void *arg);
+
+#endif /* SYS_TLSF_H */
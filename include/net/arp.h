@@ -51,7 +51,7 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt);
 enum net_verdict net_arp_input(struct net_pkt *pkt);
 
 struct arp_entry {
-	struct k_delayed_work arp_request_timer;
+	u32_t req_start;
 	struct net_if *iface;
 	struct net_pkt *pending;
 	struct in_addr ip;
@@ -533,6 +533,9 @@ struct net_buf_pool {
 	/** Amount of available buffers in the pool. */
 	s16_t avail_count;
 
+	/** Lowest amount of available buffers, may be reset by the user. */
+	s16_t min_avail_count;
+
 	/** Total size of the pool. */
 	const u16_t pool_size;
 
@@ -559,6 +562,7 @@ struct net_buf_pool {
 		.buf_count = _count,                                         \
 		.uninit_count = _count,                                      \
 		.avail_count = _count,                                       \
+		.min_avail_count = _count,                                   \
 		.destroy = _destroy,                                         \
 		.name = STRINGIFY(_pool),                                    \
 	}
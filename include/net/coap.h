@@ -169,6 +169,15 @@ typedef int (*coap_method_t)(struct coap_resource *resource,
 typedef void (*coap_notify_t)(struct coap_resource *resource,
 			      struct coap_observer *observer);
 
+/**
+ * @typedef coap_notify_send_t
+ * @brief Type of the callback being called for each observer of a resource
+ * by coap_resource_notify_shared(), to send it the shared notification.
+ */
+typedef int (*coap_notify_send_t)(struct coap_resource *resource,
+				  struct coap_observer *observer,
+				  const struct coap_packet *notification);
+
 /**
  * @brief Description of CoAP resource.
  *
@@ -185,6 +194,34 @@ struct coap_resource {
 	int age;
 };
 
+/**
+ * @brief Path segment matching any single Uri-Path segment in a
+ * resource tree.
+ */
+#define COAP_RESOURCE_WILDCARD "*"
+
+/**
+ * @brief Node of a CoAP resource tree, one per distinct path prefix.
+ */
+struct coap_resource_node {
+	const char *segment;
+	struct coap_resource *resource; /* Resource ending at this node */
+	struct coap_resource_node *child; /* First node one segment deeper */
+	struct coap_resource_node *next; /* Next node with the same parent */
+	u8_t len; /* Segment length */
+};
+
+/**
+ * @brief CoAP resources organized by their Uri-Path segments, so that
+ * requests are dispatched without comparing against every resource.
+ */
+struct coap_resource_tree {
+	struct coap_resource_node root;
+	struct coap_resource_node *nodes; /* Storage for the other nodes */
+	u16_t max_nodes;
+	u16_t num_nodes;
+};
+
 /**
  * @brief Represents a remote device that is observing a local resource.
  */
@@ -195,6 +232,20 @@ struct coap_observer {
 	u8_t tkl;
 };
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+/* Number of option numbers from enum coap_option_num */
+#define COAP_OPTION_INDEX_SLOTS 19
+
+/**
+ * @brief Location of an option inside a parsed CoAP packet.
+ */
+struct coap_option_pos {
+	u16_t num; /* Option number */
+	u16_t offset; /* Value offset from the start of the CoAP header */
+	u16_t len; /* Value length */
+};
+#endif
+
 /**
  * @brief Representation of a CoAP packet.
  */
@@ -205,6 +256,14 @@ struct coap_packet {
 	u8_t hdr_len; /* CoAP header length */
 	u8_t opt_len; /* Total options length (delta + len + value) */
 	u16_t last_delta; /* Used only when preparing CoAP packet */
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	/* Options found by coap_packet_parse(), in packet order */
+	struct coap_option_pos opt_idx[CONFIG_COAP_OPTION_INDEX_SIZE];
+	/* First entry + 1 in opt_idx for each known option number */
+	u8_t opt_idx_first[COAP_OPTION_INDEX_SLOTS];
+	u8_t opt_idx_num;
+	bool opt_idx_valid;
+#endif
 };
 
 /**
@@ -223,7 +282,11 @@ struct coap_pending {
 	struct net_pkt *pkt;
 	struct sockaddr addr;
 	s32_t timeout;
+	u32_t t0;
+	u32_t deadline;
 	u16_t id;
+	u8_t retries;
+	u8_t backoff;
 };
 
 /**
@@ -408,6 +471,9 @@ struct coap_reply *coap_reply_next_unused(
  * @brief After a response is received, clear all pending
  * retransmissions related to that response.
  *
+ * With CONFIG_COAP_COCOA the round-trip time of the exchange also
+ * updates the retransmission timeout estimated for the peer.
+ *
  * @param response The received response
  * @param pendings Pointer to the array of #coap_reply structures
  * @param len Size of the array of #coap_reply structures
@@ -438,7 +504,8 @@ struct coap_reply *coap_response_received(
 
 /**
  * @brief Returns the next pending about to expire, pending->timeout
- * informs how many ms to next expiration.
+ * informs how many ms to next expiration, counted from the last call
+ * to coap_pending_cycle().
  *
  * @param pendings Pointer to the array of #coap_pending structures
  * @param len Size of the array of #coap_pending structures
@@ -449,10 +516,46 @@ struct coap_reply *coap_response_received(
 struct coap_pending *coap_pending_next_to_expire(
 	struct coap_pending *pendings, size_t len);
 
+/**
+ * @brief Returns how long to wait until the next pending expires.
+ *
+ * Lets a single timer serve every pending retransmission in @a
+ * pendings: arm it with the returned value and, when it fires, handle
+ * all pendings returned by coap_pending_next_to_expire() whose
+ * deadline has passed.
+ *
+ * @param pendings Pointer to the array of #coap_pending structures
+ * @param len Size of the array of #coap_pending structures
+ *
+ * @return Time in ms until the earliest deadline, 0 if it has already
+ * passed, K_FOREVER if no pending is active.
+ */
+s32_t coap_pending_next_timeout(struct coap_pending *pendings, size_t len);
+
+/**
+ * @brief Counts the confirmable exchanges outstanding with a peer.
+ *
+ * Used to enforce NSTART: a new confirmable request should only be
+ * sent to @a addr when fewer than CONFIG_COAP_NSTART exchanges are
+ * outstanding with it.
+ *
+ * @param pendings Pointer to the array of #coap_pending structures
+ * @param len Size of the array of #coap_pending structures
+ * @param addr Address of the peer
+ *
+ * @return Number of active pendings addressed to @a addr.
+ */
+int coap_pending_outstanding(struct coap_pending *pendings, size_t len,
+			     const struct sockaddr *addr);
+
 /**
  * @brief After a request is sent, user may want to cycle the pending
  * retransmission so the timeout is updated.
  *
+ * With CONFIG_COAP_COCOA the initial timeout is taken from the
+ * retransmission timeout estimated for the peer, otherwise it is
+ * CONFIG_COAP_INIT_ACK_TIMEOUT_MS.
+ *
  * @param pending Pending representation to have its timeout updated
  *
  * @return false if this is the last retransmission.
@@ -491,6 +594,78 @@ int coap_handle_request(struct coap_packet *cpkt,
 			struct coap_option *options,
 			u8_t opt_num);
 
+/**
+ * @brief Initialize a resource tree and add a set of resources to it.
+ *
+ * Each distinct path prefix takes one node from @a nodes, so a tree
+ * for N resources with paths of depth D needs at most N * D nodes.
+ *
+ * @param tree Resource tree to initialize
+ * @param nodes Storage for the tree nodes
+ * @param max_nodes Number of elements in @a nodes
+ * @param resources Array of resources terminated by an element with a
+ * NULL path, or NULL
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_resource_tree_init(struct coap_resource_tree *tree,
+			    struct coap_resource_node *nodes,
+			    u16_t max_nodes,
+			    struct coap_resource *resources);
+
+/**
+ * @brief Add a resource to a resource tree.
+ *
+ * A path segment equal to COAP_RESOURCE_WILDCARD matches any single
+ * Uri-Path segment. Segments which match exactly are preferred over
+ * the wildcard.
+ *
+ * @param tree Resource tree
+ * @param resource Resource to add
+ *
+ * @return 0 in case of success, -EALREADY if a resource with the same
+ * path was already added, -ENOMEM if the tree is out of nodes or
+ * -EINVAL in case of another error.
+ */
+int coap_resource_tree_add(struct coap_resource_tree *tree,
+			   struct coap_resource *resource);
+
+/**
+ * @brief Find the resource and method handler for a request.
+ *
+ * Walks the tree once along the Uri-Path options of the request.
+ *
+ * @param tree Resource tree
+ * @param code Request method code
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ * @param resource Set to the matching resource, or NULL if none matches
+ *
+ * @return Method handler of the matching resource, or NULL if there is
+ * no such resource or it does not implement the method.
+ */
+coap_method_t coap_resource_tree_match(const struct coap_resource_tree *tree,
+				       u8_t code,
+				       struct coap_option *options,
+				       u8_t opt_num,
+				       struct coap_resource **resource);
+
+/**
+ * @brief When a request is received, call the appropriate method of
+ * the matching resource in a resource tree.
+ *
+ * @param cpkt Packet received
+ * @param tree Resource tree
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_handle_request_tree(struct coap_packet *cpkt,
+			     const struct coap_resource_tree *tree,
+			     struct coap_option *options,
+			     u8_t opt_num);
+
 /**
  * @brief Indicates that this resource was updated and that the @a
  * notify callback should be called for every registered observer.
@@ -501,6 +676,48 @@ int coap_handle_request(struct coap_packet *cpkt,
  */
 int coap_resource_notify(struct coap_resource *resource);
 
+/**
+ * @brief Indicates that this resource was updated, and hands the same
+ * notification to the @a send callback for every registered observer.
+ *
+ * The options and payload of @a notification are encoded only once, the
+ * callback builds the packet for each observer from it with
+ * coap_packet_init_shared(). Unlike coap_resource_notify(), the age of the
+ * resource is not incremented here, as the Observe option is part of the
+ * shared notification: increment it before building the notification.
+ *
+ * @param resource Resource that was updated
+ * @param notification Notification, whose type, token and ID are ignored
+ * @param send Callback sending the notification to one observer
+ *
+ * @return 0 in case of success or the first error returned by @a send,
+ * all the observers being notified anyway.
+ */
+int coap_resource_notify_shared(struct coap_resource *resource,
+				const struct coap_packet *notification,
+				coap_notify_send_t send);
+
+/**
+ * @brief Create a new CoAP packet holding the options and payload of an
+ * already built one, with a header and token of its own.
+ *
+ * The options and payload are copied as they are, without encoding them
+ * again, so that the same message can be sent to several peers.
+ *
+ * @param cpkt New packet to be initialized using the storage from @a pkt.
+ * @param pkt Network packet that will contain the CoAP packet
+ * @param shared Packet whose code, options and payload are copied
+ * @param type CoAP message type
+ * @param tokenlen CoAP message token length
+ * @param token CoAP message token
+ * @param id CoAP message identifier
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_packet_init_shared(struct coap_packet *cpkt, struct net_pkt *pkt,
+			    const struct coap_packet *shared, u8_t type,
+			    u8_t tokenlen, u8_t *token, u16_t id);
+
 /**
  * @brief Returns if this request is enabling observing a resource.
  *
@@ -38,6 +38,7 @@ enum net_dhcpv4_state {
 	NET_DHCPV4_RENEWING,
 	NET_DHCPV4_REBINDING,
 	NET_DHCPV4_BOUND,
+	NET_DHCPV4_REBOOTING,
 };
 
 /**
@@ -118,6 +118,40 @@ typedef void (*dns_resolve_cb_t)(enum dns_resolve_status status,
 				 struct dns_addrinfo *info,
 				 void *user_data);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/**
+ * Cached answer of a query.
+ */
+struct dns_cache_entry {
+	/** Addresses of the answer, none if the answer was negative */
+	struct sockaddr addr[CONFIG_DNS_RESOLVER_CACHE_MAX_ADDRS];
+
+	/** Uptime, in ms, when the answer expires */
+	s64_t expires;
+
+	/** Uptime, in ms, of the last query answered from here */
+	u32_t last_used;
+
+	/** DNS id of the query sent for the name, when pending */
+	u16_t id;
+
+	/** Query type */
+	enum dns_query_type query_type;
+
+	/** Number of addresses */
+	u8_t addr_count;
+
+	/** Is this entry in use */
+	bool is_used;
+
+	/** Is the answer still being waited for */
+	bool is_pending;
+
+	/** The resolved name */
+	char name[CONFIG_DNS_RESOLVER_CACHE_MAX_NAME_LEN + 1];
+};
+#endif
+
 /**
  * DNS resolve context structure.
  */
@@ -166,8 +200,20 @@ struct dns_resolve_context {
 
 		/** DNS id of this query */
 		u16_t id;
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		/** Cache entry getting the answer, shared with the other
+		 * queries for the same name.
+		 */
+		struct dns_cache_entry *cache;
+#endif
 	} queries[CONFIG_DNS_NUM_CONCUR_QUERIES];
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/** Answers of the recent queries */
+	struct dns_cache_entry cache[CONFIG_DNS_RESOLVER_CACHE_ENTRIES];
+#endif
+
 	/** Is this context in use */
 	bool is_used;
 };
@@ -238,6 +284,9 @@ int dns_resolve_cancel(struct dns_resolve_context *ctx,
  * We might send the query to multiple servers (if there are more than one
  * server configured), but we only use the result of the first received
  * response.
+ * If CONFIG_DNS_RESOLVER_CACHE is enabled, a cached answer is passed to
+ * the callback before this function returns, and a query for a name that
+ * is already being resolved gets the answer of the pending query.
  *
  * @param ctx DNS context
  * @param query What the caller wants to resolve.
@@ -263,6 +312,21 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 		     void *user_data,
 		     s32_t timeout);
 
+/**
+ * @brief Flush cached DNS answers.
+ *
+ * @details This drops the cached answers of a name, or all of them, so
+ * that the next queries are sent to the servers again. Answers still
+ * being waited for are not affected. Nothing is done if
+ * CONFIG_DNS_RESOLVER_CACHE is not enabled.
+ *
+ * @param ctx DNS context
+ * @param query Name whose answers are dropped, NULL to drop all.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int dns_resolve_flush(struct dns_resolve_context *ctx, const char *query);
+
 /**
  * @brief Get default DNS context.
  *
@@ -332,6 +396,20 @@ static inline int dns_cancel_addr_info(u16_t dns_id)
 	return dns_resolve_cancel(dns_resolve_get_default(), dns_id);
 }
 
+/**
+ * @brief Flush cached DNS answers.
+ *
+ * @details This variant uses the system wide DNS context.
+ *
+ * @param query Name whose answers are dropped, NULL to drop all.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+static inline int dns_flush_addr_info(const char *query)
+{
+	return dns_resolve_flush(dns_resolve_get_default(), query);
+}
+
 /**
  * @}
  */
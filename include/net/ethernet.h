@@ -44,6 +44,7 @@ struct net_eth_addr {
 #define NET_ETH_PTYPE_IP		0x0800
 #define NET_ETH_PTYPE_IPV6		0x86dd
 #define NET_ETH_PTYPE_VLAN		0x8100
+#define NET_ETH_PTYPE_PTP		0x88f7
 
 #define NET_ETH_MINIMAL_FRAME_SIZE	60
 
@@ -71,6 +72,27 @@ enum ethernet_hw_caps {
 
 	/** Changing duplex (half/full) supported */
 	ETHERNET_DUPLEX_SET		= BIT(7),
+
+	/** Scatter-gather TX supported: every fragment of a packet gets
+	 * its own DMA descriptor, the frame is not copied into a linear
+	 * buffer.
+	 */
+	ETHERNET_HW_TX_SG		= BIT(8),
+
+	/** TCP segmentation offload supported: packets whose
+	 * net_pkt_tso_mss() is set carry more data than a segment, and are
+	 * split by the hardware into segments of that size. The IP and TCP
+	 * headers, lengths and checksums of the segments are derived from
+	 * the ones of the packet, PSH and FIN being kept for the last
+	 * segment only. This needs ETHERNET_HW_TX_SG and
+	 * ETHERNET_HW_TX_CHKSUM_OFFLOAD.
+	 */
+	ETHERNET_HW_TCP_TSO		= BIT(9),
+
+	/** The driver provides a PTP clock, from get_ptp_clock(), and sets
+	 * the timestamp of received PTP event messages from it.
+	 */
+	ETHERNET_PTP			= BIT(10),
 };
 
 enum ethernet_config_type {
@@ -129,6 +151,11 @@ struct ethernet_api {
 	int (*vlan_setup)(struct device *dev, struct net_if *iface,
 			  u16_t tag, bool enable);
 #endif /* CONFIG_NET_VLAN */
+
+#if defined(CONFIG_PTP_CLOCK)
+	/** Return the PTP clock device of the interface */
+	struct device *(*get_ptp_clock)(struct device *dev);
+#endif
 };
 
 struct net_eth_hdr {
@@ -282,6 +309,28 @@ enum ethernet_hw_caps net_eth_get_hw_capabilities(struct net_if *iface)
 	return eth->get_capabilities(net_if_get_device(iface));
 }
 
+#if defined(CONFIG_PTP_CLOCK)
+/**
+ * @brief Return the PTP clock of an Ethernet interface.
+ *
+ * @param iface Network interface
+ *
+ * @return PTP clock device, NULL if the interface has none
+ */
+static inline struct device *net_eth_get_ptp_clock(struct net_if *iface)
+{
+	struct device *dev = net_if_get_device(iface);
+	const struct ethernet_api *api = dev->driver_api;
+
+	if (!(net_eth_get_hw_capabilities(iface) & ETHERNET_PTP) ||
+	    !api->get_ptp_clock) {
+		return NULL;
+	}
+
+	return api->get_ptp_clock(dev);
+}
+#endif /* CONFIG_PTP_CLOCK */
+
 #if defined(CONFIG_NET_VLAN)
 /**
  * @brief Add VLAN tag to the interface.
@@ -0,0 +1,130 @@
+/** @file
+ * @brief Ethernet RX polling
+ *
+ * Interrupt mitigation helper for Ethernet drivers.
+ */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __ETHERNET_RX_POLL_H
+#define __ETHERNET_RX_POLL_H
+
+/**
+ * @brief Ethernet RX polling
+ * @defgroup eth_rx_poll Ethernet RX polling
+ * @ingroup ethernet
+ * @{
+ *
+ * Instead of handling every received frame from its own interrupt, the
+ * driver masks the RX interrupt when it fires and calls
+ * net_eth_rx_poll_schedule(). Its poll() function is then called from the
+ * RX polling thread to go through the DMA descriptor ring, a budget of
+ * frames at a time, until the ring is drained. Finally complete() is
+ * called for the driver to unmask the RX interrupt.
+ */
+
+#include <kernel.h>
+#include <atomic.h>
+#include <net/net_stats.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct net_eth_rx_poll;
+
+/**
+ * @brief Receive frames from the DMA ring.
+ *
+ * @param rx_poll RX poller of the driver.
+ * @param budget Maximum number of frames to receive.
+ *
+ * @return Number of frames received, less than budget if the ring is
+ * drained.
+ */
+typedef int (*net_eth_rx_poll_cb_t)(struct net_eth_rx_poll *rx_poll,
+				    int budget);
+
+/**
+ * @brief Unmask the RX interrupt once the ring is drained.
+ *
+ * @param rx_poll RX poller of the driver.
+ *
+ * @return true if frames were received in the meantime, in which case
+ * the polling goes on.
+ */
+typedef bool (*net_eth_rx_complete_cb_t)(struct net_eth_rx_poll *rx_poll);
+
+struct net_eth_rx_poll {
+	/* Polling run, delayed by the coalescing time */
+	struct k_delayed_work work;
+
+	net_eth_rx_poll_cb_t poll;
+	net_eth_rx_complete_cb_t complete;
+
+	/* Set from the interrupt until the ring is drained */
+	atomic_t scheduled;
+
+	/* Frames received since the RX interrupt */
+	u32_t irq_pkts;
+
+	/* Maximum number of frames per polling run */
+	u16_t budget;
+
+	/* Time to wait, in ms, after the RX interrupt before polling */
+	u16_t delay;
+
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	struct net_stats_eth_rx_poll *stats;
+#endif
+};
+
+/**
+ * @brief Initialize the RX poller of a driver.
+ *
+ * The budget and coalescing time are set to their Kconfig defaults.
+ *
+ * @param rx_poll RX poller.
+ * @param poll Driver function receiving frames.
+ * @param complete Driver function unmasking the RX interrupt.
+ * @param stats Statistics of the interface, can be NULL.
+ */
+void net_eth_rx_poll_init(struct net_eth_rx_poll *rx_poll,
+			  net_eth_rx_poll_cb_t poll,
+			  net_eth_rx_complete_cb_t complete,
+			  struct net_stats_eth *stats);
+
+/**
+ * @brief Set the coalescing thresholds of an RX poller.
+ *
+ * @param rx_poll RX poller.
+ * @param budget Maximum number of frames received before other work,
+ * like the other pollers, gets a chance to run.
+ * @param delay Time to wait, in ms, after the RX interrupt before
+ * polling, letting more frames to be handled in one go.
+ */
+void net_eth_rx_poll_set_coalesce(struct net_eth_rx_poll *rx_poll,
+				  u16_t budget, u16_t delay);
+
+/**
+ * @brief Start polling, to be called from the RX interrupt.
+ *
+ * The driver masks the RX interrupt before calling this function.
+ *
+ * @param rx_poll RX poller.
+ */
+void net_eth_rx_poll_schedule(struct net_eth_rx_poll *rx_poll);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ETHERNET_RX_POLL_H */
@@ -58,6 +58,7 @@ enum http_state {
 enum http_url_flags {
 	HTTP_URL_STANDARD = 0,
 	HTTP_URL_WEBSOCKET,
+	HTTP_URL_STATIC,
 };
 
 enum http_connection_type {
@@ -212,6 +213,55 @@ typedef void (*http_close_cb_t)(struct http_ctx *ctx,
 				int status,
 				void *user_data);
 
+#if defined(CONFIG_HTTP_SERVER)
+/**
+ * @typedef http_stream_cb_t
+ * @brief Streamed response data callback.
+ *
+ * @details The stream callback is called by http_send_stream() to get
+ * the next piece of the response body. The data is written directly into
+ * the network buffer that is sent as one chunk.
+ *
+ * @param ctx The context to use.
+ * @param buf Where to write the data.
+ * @param len Maximum number of bytes that can be written to buf.
+ * @param user_data The user data given in http_send_stream() call.
+ *
+ * @return Number of bytes written, 0 if there is no more data, <0 if
+ * there was an error and the response is to be aborted.
+ */
+typedef int (*http_stream_cb_t)(struct http_ctx *ctx,
+				u8_t *buf,
+				size_t len,
+				void *user_data);
+#endif /* CONFIG_HTTP_SERVER */
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_RESPONSES)
+/**
+ * Precomputed HTTP response. It is sent by the server as is to GET and
+ * HEAD requests for its URL, without calling the application. The header
+ * and the body are sent from where they are stored, so they can be
+ * constant data in flash, and they must stay valid while the response is
+ * registered.
+ */
+struct http_static_response {
+	/** URL, the request URL must match it exactly */
+	const char *url;
+
+	/** Status line and header fields, each ending with "\r\n". The
+	 * server adds the Content-Length and Connection fields and the
+	 * empty line that ends the header.
+	 */
+	const char *header;
+
+	/** Body, not sent to HEAD requests */
+	const u8_t *body;
+
+	/** Length of the body */
+	size_t body_len;
+};
+#endif /* CONFIG_HTTP_SERVER_STATIC_RESPONSES */
+
 /** Websocket and HTTP callbacks */
 struct http_cb {
 	/** Function that is called when a connection is established.
@@ -637,6 +687,49 @@ struct http_root_url *http_server_add_default(struct http_server_urls *urls,
  */
 int http_server_del_default(struct http_server_urls *urls);
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_RESPONSES)
+/**
+ * @brief Add a static response to a list of URLs that are tied to certain
+ * webcontext.
+ *
+ * @detail The response takes one of the URL entries. It can be removed
+ * with http_server_del_url().
+ *
+ * @param urls URL struct that will contain all the URLs the user wants to
+ * register.
+ * @param rsp Static response. It must stay valid while it is registered.
+ *
+ * @return NULL if there is no room for the URL, pointer to URL if
+ * registering was ok.
+ */
+struct http_root_url *http_server_add_static(struct http_server_urls *urls,
+				const struct http_static_response *rsp);
+#endif /* CONFIG_HTTP_SERVER_STATIC_RESPONSES */
+
+/**
+ * @brief Send a response whose body is produced by a callback.
+ *
+ * @details The body is sent with chunked transfer encoding. The callback
+ * is called until it returns 0, each time writing one chunk directly into
+ * a network buffer.
+ *
+ * @param ctx Http context.
+ * @param header Status line and header fields, each ending with "\r\n".
+ * The Transfer-Encoding field, the Connection field if the connection is
+ * not kept alive, and the empty line that ends the header are added to it.
+ * @param cb Callback that produces the body.
+ * @param stream_data User data that is passed to the callback.
+ * @param dst Remote socket address
+ * @param user_send_data User specific data to this connection. This is passed
+ * as a parameter to sent cb after the packet has been sent.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int http_send_stream(struct http_ctx *ctx, const char *header,
+		     http_stream_cb_t cb, void *stream_data,
+		     const struct sockaddr *dst,
+		     void *user_send_data);
+
 #else /* CONFIG_HTTP_SERVER */
 
 static inline int http_server_init(struct http_ctx *ctx,
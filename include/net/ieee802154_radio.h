@@ -34,6 +34,7 @@ enum ieee802154_hw_caps {
 	IEEE802154_HW_2_4_GHZ	= BIT(4), /* 2.4Ghz radio supported */
 	IEEE802154_HW_TX_RX_ACK = BIT(5), /* Handles ACK request on TX */
 	IEEE802154_HW_SUB_GHZ	= BIT(6), /* Sub-GHz radio supported */
+	IEEE802154_HW_RETRANSMISSION = BIT(7), /* Retransmits when no ACK */
 };
 
 enum ieee802154_filter_type {
@@ -81,7 +82,15 @@ struct ieee802154_radio_api {
 	/** Set TX power level in dbm */
 	int (*set_txpower)(struct device *dev, s16_t dbm);
 
-	/** Transmit a packet fragment */
+	/** Transmit a packet fragment
+	 *
+	 * With IEEE802154_HW_CSMA, the radio does the whole CSMA-CA
+	 * channel access before transmitting. With IEEE802154_HW_TX_RX_ACK
+	 * it waits for the ACK of frames requesting one, and with
+	 * IEEE802154_HW_RETRANSMISSION also retransmits them until they are
+	 * acknowledged. The call only returns once this is done, an error
+	 * telling the fragment could not be delivered.
+	 */
 	int (*tx)(struct device *dev,
 		  struct net_pkt *pkt,
 		  struct net_buf *frag);
@@ -198,6 +198,71 @@ int lwm2m_engine_get_bool(char *path, bool *value);
 int lwm2m_engine_get_float32(char *pathstr, float32_value_t *buf);
 int lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf);
 
+/*
+ * Pre-resolved resource: set or get a resource value through a handle
+ * without parsing the path and looking up the object instance each time.
+ * Getting or setting through a handle whose object instance has been
+ * deleted fails with -ENOENT.
+ */
+struct lwm2m_engine_obj_inst;
+struct lwm2m_engine_obj_field;
+struct lwm2m_engine_res_inst;
+
+struct lwm2m_res_handle {
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res_inst *res;
+	u16_t obj_id;
+	u16_t obj_inst_id;
+	u16_t res_id;
+};
+
+int lwm2m_engine_get_res_handle(char *pathstr,
+				struct lwm2m_res_handle *handle);
+
+int lwm2m_engine_handle_set_opaque(struct lwm2m_res_handle *handle,
+				   char *data_ptr, u16_t data_len);
+int lwm2m_engine_handle_set_string(struct lwm2m_res_handle *handle,
+				   char *data_ptr);
+int lwm2m_engine_handle_set_u8(struct lwm2m_res_handle *handle, u8_t value);
+int lwm2m_engine_handle_set_u16(struct lwm2m_res_handle *handle, u16_t value);
+int lwm2m_engine_handle_set_u32(struct lwm2m_res_handle *handle, u32_t value);
+int lwm2m_engine_handle_set_u64(struct lwm2m_res_handle *handle, u64_t value);
+int lwm2m_engine_handle_set_s8(struct lwm2m_res_handle *handle, s8_t value);
+int lwm2m_engine_handle_set_s16(struct lwm2m_res_handle *handle, s16_t value);
+int lwm2m_engine_handle_set_s32(struct lwm2m_res_handle *handle, s32_t value);
+int lwm2m_engine_handle_set_s64(struct lwm2m_res_handle *handle, s64_t value);
+int lwm2m_engine_handle_set_bool(struct lwm2m_res_handle *handle, bool value);
+int lwm2m_engine_handle_set_float32(struct lwm2m_res_handle *handle,
+				    float32_value_t *value);
+int lwm2m_engine_handle_set_float64(struct lwm2m_res_handle *handle,
+				    float64_value_t *value);
+
+int lwm2m_engine_handle_get_opaque(struct lwm2m_res_handle *handle,
+				   void *buf, u16_t buflen);
+int lwm2m_engine_handle_get_string(struct lwm2m_res_handle *handle,
+				   void *buf, u16_t buflen);
+int lwm2m_engine_handle_get_u8(struct lwm2m_res_handle *handle, u8_t *value);
+int lwm2m_engine_handle_get_u16(struct lwm2m_res_handle *handle,
+				u16_t *value);
+int lwm2m_engine_handle_get_u32(struct lwm2m_res_handle *handle,
+				u32_t *value);
+int lwm2m_engine_handle_get_u64(struct lwm2m_res_handle *handle,
+				u64_t *value);
+int lwm2m_engine_handle_get_s8(struct lwm2m_res_handle *handle, s8_t *value);
+int lwm2m_engine_handle_get_s16(struct lwm2m_res_handle *handle,
+				s16_t *value);
+int lwm2m_engine_handle_get_s32(struct lwm2m_res_handle *handle,
+				s32_t *value);
+int lwm2m_engine_handle_get_s64(struct lwm2m_res_handle *handle,
+				s64_t *value);
+int lwm2m_engine_handle_get_bool(struct lwm2m_res_handle *handle,
+				 bool *value);
+int lwm2m_engine_handle_get_float32(struct lwm2m_res_handle *handle,
+				    float32_value_t *buf);
+int lwm2m_engine_handle_get_float64(struct lwm2m_res_handle *handle,
+				    float64_value_t *buf);
+
 int lwm2m_engine_register_read_callback(char *path,
 					lwm2m_engine_get_data_cb_t cb);
 int lwm2m_engine_register_pre_write_callback(char *path,
@@ -36,6 +36,26 @@ enum mqtt_app {
 	MQTT_APP_SERVER
 };
 
+#if CONFIG_MQTT_INFLIGHT_WINDOW > 0
+/**
+ * QoS 1 or QoS 2 PUBLISH message sent and not acknowledged yet
+ */
+struct mqtt_inflight {
+	/** Fragments holding the packed PUBLISH msg, released once the
+	 * broker has received it
+	 */
+	struct net_buf *frags;
+
+	/** Packet Identifier of the PUBLISH msg */
+	u16_t pkt_id;
+
+	/** MQTT_PUBLISH until the PUBREC is received, then MQTT_PUBREL.
+	 * MQTT_INVALID if the entry is free.
+	 */
+	u8_t state;
+};
+#endif
+
 /**
  * MQTT context structure
  *
@@ -60,7 +80,11 @@ enum mqtt_app {
  * messages.
  *
  * <b>NOTE: The application (and not the API) is in charge of keeping track of
- * the state of the received and sent messages.</b>
+ * the state of the received and sent messages.</b> The only exception is
+ * the in-flight window enabled by CONFIG_MQTT_INFLIGHT_WINDOW: up to that
+ * many QoS 1/2 PUBLISH messages may be sent without waiting for their
+ * acknowledgement, and the unacknowledged ones are sent again with the DUP
+ * flag set when the next CONNACK is received.
  */
 struct mqtt_ctx {
 	/** Net app context structure */
@@ -135,7 +159,12 @@ struct mqtt_ctx {
 	 *
 	 * @param [in] ctx MQTT context
 	 * @param [in] msg Publish message, this parameter is only used
-	 *                 when the type is MQTT_PUBLISH
+	 *                 when the type is MQTT_PUBLISH. Its topic and
+	 *                 payload point into the received packet and are
+	 *                 only valid during the callback. Payloads larger
+	 *                 than CONFIG_MQTT_MSG_MAX_SIZE that span several
+	 *                 fragments have msg->msg set to NULL and must be
+	 *                 read from msg->msg_frag.
 	 * @param [in] pkt_id Packet Identifier for the input msg
 	 * @param [in] type Packet type
 	 */
@@ -182,6 +211,15 @@ struct mqtt_ctx {
 	/* Internal use only */
 	int (*rcv)(struct mqtt_ctx *ctx, struct net_pkt *);
 
+	/** PUBLISH msgs queued by mqtt_tx_publish_queue(), internal use */
+	struct net_pkt *tx_queue;
+	u32_t tx_queue_len;
+
+#if CONFIG_MQTT_INFLIGHT_WINDOW > 0
+	/** QoS 1/2 PUBLISH msgs waiting for acknowledgement */
+	struct mqtt_inflight inflight[CONFIG_MQTT_INFLIGHT_WINDOW];
+#endif
+
 	/** Application type, see: enum mqtt_app */
 	u8_t app_type;
 
@@ -300,6 +338,9 @@ int mqtt_tx_pubrel(struct mqtt_ctx *ctx, u16_t id);
 /**
  * Sends the MQTT PUBLISH message
  *
+ * @details Messages previously queued by mqtt_tx_publish_queue() are sent
+ * in the same TCP segment, before this one.
+ *
  * @param [in] ctx MQTT context structure
  * @param [in] msg MQTT PUBLISH msg
  *
@@ -307,9 +348,43 @@ int mqtt_tx_pubrel(struct mqtt_ctx *ctx, u16_t id);
  * @retval -EINVAL
  * @retval -ENOMEM
  * @retval -EIO
+ * @retval -EAGAIN if the in-flight window is full
+ * @retval -EALREADY if msg's Packet Identifier is already in flight
  */
 int mqtt_tx_publish(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg);
 
+/**
+ * Queues the MQTT PUBLISH message
+ *
+ * @details Queued messages are sent together, in one TCP segment, by
+ * mqtt_tx_flush(), by the next mqtt_tx_publish() or once
+ * CONFIG_MQTT_PUBLISH_QUEUE_LEN bytes are queued. The message is packed
+ * straight into network buffers, so its size is not limited by
+ * CONFIG_MQTT_MSG_MAX_SIZE.
+ *
+ * @param [in] ctx MQTT context structure
+ * @param [in] msg MQTT PUBLISH msg
+ *
+ * @retval 0 on success
+ * @retval -EINVAL
+ * @retval -ENOMEM
+ * @retval -EIO
+ * @retval -EAGAIN if the in-flight window is full
+ * @retval -EALREADY if msg's Packet Identifier is already in flight
+ */
+int mqtt_tx_publish_queue(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg);
+
+/**
+ * Sends the MQTT PUBLISH messages queued by mqtt_tx_publish_queue()
+ *
+ * @param [in] ctx MQTT context structure
+ *
+ * @retval 0 on success or if nothing was queued
+ * @retval -EIO
+ * @retval -ENOMEM
+ */
+int mqtt_tx_flush(struct mqtt_ctx *ctx);
+
 /**
  * Sends the MQTT PINGREQ message
  *
@@ -8,6 +8,7 @@
 #define _MQTT_TYPES_H_
 
 #include <zephyr/types.h>
+#include <net/buf.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -86,6 +87,14 @@ struct mqtt_publish_msg {
 	u16_t topic_len;
 	u8_t *msg;
 	u16_t msg_len;
+
+	/** Received msgs only: fragment holding the first byte of msg and
+	 * the offset of that byte in it. If the payload spans several
+	 * fragments, msg is NULL and the payload must be read from this
+	 * fragment chain.
+	 */
+	struct net_buf *msg_frag;
+	u16_t msg_offset;
 };
 
 /**
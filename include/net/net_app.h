@@ -37,6 +37,9 @@
 #include <mbedtls/ssl.h>
 #include <mbedtls/error.h>
 #include <mbedtls/debug.h>
+#if defined(CONFIG_NET_APP_TLS_SESSION_TICKETS)
+#include <mbedtls/ssl_ticket.h>
+#endif
 #endif /* CONFIG_MBEDTLS */
 #endif /* CONFIG_NET_APP_TLS || CONFIG_NET_APP_DTLS */
 
@@ -302,6 +305,11 @@ struct net_app_ctx {
 		/** DTLS final timer. Connection is terminated if this expires.
 		 */
 		struct k_delayed_work fin_timer;
+
+#if defined(CONFIG_NET_APP_DTLS_COALESCE)
+		/** DTLS records waiting to be sent in the same datagram. */
+		struct net_pkt *tx_pkt;
+#endif
 	} dtls;
 #endif
 
@@ -368,6 +376,9 @@ struct net_app_ctx {
 			net_app_cert_cb_t cert_cb;
 			mbedtls_x509_crt srvcert;
 			mbedtls_pk_context pkey;
+#if defined(CONFIG_NET_APP_TLS_SESSION_TICKETS)
+			mbedtls_ssl_ticket_context ticket_ctx;
+#endif
 #endif
 #if defined(CONFIG_NET_APP_CLIENT)
 			net_app_ca_cert_cb_t ca_cert_cb;
@@ -403,6 +414,11 @@ struct net_app_ctx {
 
 		/** Is the connection closing */
 		u8_t connection_closing : 1;
+
+#if defined(CONFIG_NET_APP_DTLS_COALESCE)
+		/** Are the records being sent to be coalesced */
+		u8_t tx_coalesce : 1;
+#endif
 	} tls;
 #endif /* CONFIG_NET_APP_TLS || CONFIG_NET_APP_DTLS */
 
@@ -955,6 +971,16 @@ int net_app_client_tls(struct net_app_ctx *ctx,
 		       struct k_mem_pool *pool,
 		       k_thread_stack_t *stack,
 		       size_t stack_size);
+
+#if defined(CONFIG_NET_APP_TLS_SESSION_CACHE)
+/**
+ * @brief Forget the cached TLS sessions.
+ *
+ * @details The next connection to each peer does a full handshake. This
+ * should be called when the trusted certificates change.
+ */
+void net_app_client_tls_sessions_clear(void);
+#endif /* CONFIG_NET_APP_TLS_SESSION_CACHE */
 #endif /* CONFIG_NET_APP_CLIENT */
 
 #if defined(CONFIG_NET_APP_SERVER)
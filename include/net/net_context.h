@@ -215,6 +215,14 @@ struct net_context {
 #if defined(CONFIG_NET_CONTEXT_PRIORITY)
 		/** Priority of the network data sent via this net_context */
 		u8_t priority;
+#endif
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+		/** Receive buffer size, in bytes */
+		u32_t rcvbuf;
+#endif
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+		/** Send buffer size, in bytes */
+		u32_t sndbuf;
 #endif
 	} options;
 
@@ -275,6 +283,14 @@ struct net_context {
 		struct k_fifo recv_q;
 		struct k_fifo accept_q;
 	};
+
+	/** Raised when the socket may have become readable or writable */
+	struct k_poll_signal poll_signal;
+
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	/** Datagram bytes in recv_q, counted against options.rcvbuf */
+	atomic_t recv_q_len;
+#endif
 #endif /* CONFIG_NET_SOCKETS */
 };
 
@@ -713,6 +729,53 @@ int net_context_sendto(struct net_pkt *pkt,
 		       void *token,
 		       void *user_data);
 
+/**
+ * @brief One datagram of a net_context_sendto_batch() call.
+ */
+struct net_context_dgram {
+	/** The network buffer to send */
+	struct net_pkt *pkt;
+
+	/** Destination address, NULL for the one set by net_context_connect() */
+	const struct sockaddr *dst_addr;
+
+	/** Length of the destination address */
+	socklen_t addrlen;
+
+	/** Caller specified value that is passed as is to callback */
+	void *token;
+};
+
+/**
+ * @brief Send several network buffers from a UDP context.
+ *
+ * @details This function sends the datagrams in turn as
+ * net_context_sendto() would do, but the work which does not depend on
+ * the datagram is only done once: the context is checked and bound once,
+ * the destination address is checked and the source address and the
+ * neighbor are looked up once for consecutive datagrams to the same
+ * peer, and the packets are submitted to the TX traffic class queues in
+ * one go when all of them went through the stack.
+ * This is similar as the sendmmsg() function.
+ *
+ * @param context The network context to use.
+ * @param dgrams The datagrams to send.
+ * @param count Number of datagrams.
+ * @param cb Caller-supplied callback function, called for every datagram.
+ * @param timeout Timeout for the connection. Possible values
+ * are K_FOREVER, K_NO_WAIT, >0.
+ * @param user_data Caller-supplied user data.
+ *
+ * @return Number of datagrams sent, which the caller does not own anymore,
+ * or < 0 if the first one could not be sent.
+ */
+int net_context_sendto_batch(struct net_context *context,
+			     struct net_context_dgram *dgrams,
+			     int count,
+			     net_context_send_cb_t cb,
+			     s32_t timeout,
+			     void *user_data);
+
 /**
  * @brief Receive network data from a peer specified by context.
  *
@@ -779,6 +842,8 @@ int net_context_update_recv_wnd(struct net_context *context,
 
 enum net_context_option {
 	NET_OPT_PRIORITY = 1,
+	NET_OPT_RCVBUF = 2,
+	NET_OPT_SNDBUF = 3,
 };
 
 /**
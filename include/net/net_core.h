@@ -240,6 +240,12 @@ static inline void net_analyze_stack(const char *name,
 #define NET_TC_COUNT 1
 #endif /* CONFIG_NET_TC_TX_COUNT && CONFIG_NET_TC_RX_COUNT */
 
+#if defined(CONFIG_NET_TC_RX_FLOW_QUEUES)
+#define NET_TC_RX_FLOW_QUEUES CONFIG_NET_TC_RX_FLOW_QUEUES
+#else
+#define NET_TC_RX_FLOW_QUEUES 1
+#endif
+
 /**
  * @}
  */
@@ -69,6 +69,11 @@ struct net_if_addr {
 
 	/** Is this IP address used or not */
 	bool is_used;
+
+#if defined(CONFIG_NET_IF_IPV6_ADDR_HASH)
+	/** Node in the hash table of the IPv6 addresses */
+	sys_snode_t hash_node;
+#endif
 };
 
 /**
@@ -87,6 +92,11 @@ struct net_if_mcast_addr {
 
 	/** IP address */
 	struct net_addr address;
+
+#if defined(CONFIG_NET_IF_IPV6_ADDR_HASH)
+	/** Node in the hash table of the IPv6 multicast addresses */
+	sys_snode_t hash_node;
+#endif
 };
 
 #if defined(CONFIG_NET_IPV6)
@@ -149,7 +149,8 @@ struct net_mgmt_event_callback {
 		 * be called in case those events come.
 		 * Note that only the command part is treated as a mask,
 		 * matching one to several commands. Layer and layer code will
-		 * be made of an exact match.
+		 * be made of an exact match, and must not be changed while
+		 * the callback is added.
 		 */
 		u32_t event_mask;
 		/** Internal place holder when a synchronous event wait is
@@ -184,6 +185,18 @@ void net_mgmt_init_event_callback(struct net_mgmt_event_callback *cb,
  */
 void net_mgmt_add_event_callback(struct net_mgmt_event_callback *cb);
 
+/**
+ * @brief Add a user callback called directly by the event notifier
+ * @param cb A valid pointer on user's callback to add.
+ *
+ * Unlike with net_mgmt_add_event_callback(), the handler runs right away
+ * in the context of the thread notifying the event, without going through
+ * the event queue and thread. It must therefore be short, and must not
+ * notify events nor add or delete callbacks itself. Use
+ * net_mgmt_del_event_callback() to delete it.
+ */
+void net_mgmt_add_direct_event_callback(struct net_mgmt_event_callback *cb);
+
 /**
  * @brief Delete a user callback
  * @param cb A valid pointer on user's callback to delete.
@@ -268,6 +281,7 @@ void net_mgmt_event_init(void);
 #else
 #define net_mgmt_init_event_callback(...)
 #define net_mgmt_add_event_callback(...)
+#define net_mgmt_add_direct_event_callback(...)
 #define net_mgmt_event_notify(...)
 #define net_mgmt_event_init(...)
 #define net_mgmt_event_notify_with_info(...)
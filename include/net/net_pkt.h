@@ -27,6 +27,7 @@
 #include <net/net_if.h>
 #include <net/net_context.h>
 #include <net/ethernet_vlan.h>
+#include <net/ptp_time.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -87,9 +88,27 @@ struct net_pkt {
 	 * when packet is about to be sent.
 	 */
 	u16_t total_pkt_len;
+#endif
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+	/* Cycle count at the end of the last latency stage, with the low
+	 * bit set, or 0 if the packet is not being measured.
+	 */
+	u32_t stage_time;
 #endif
 	u16_t data_len;         /* amount of payload data that can be added */
 
+#if defined(CONFIG_NET_TCP_TSO)
+	u16_t tso_mss;		/* segment size if sent with TCP segmentation
+				 * offload, 0 for a single segment
+				 */
+#endif
+#if defined(CONFIG_NET_PKT_TIMESTAMP)
+	/* Time the packet was received at, read from the PTP clock of the
+	 * interface, zero if the driver did not timestamp it.
+	 */
+	struct net_ptp_time timestamp;
+#endif
+
 	u16_t appdatalen;
 	u8_t ll_reserve;	/* link layer header length */
 	u8_t ip_hdr_len;	/* pre-filled in order to avoid func call */
@@ -511,6 +530,56 @@ static inline void net_pkt_set_vlan_tci(struct net_pkt *pkt, u16_t tci)
 }
 #endif
 
+#if defined(CONFIG_NET_TCP_TSO)
+static inline u16_t net_pkt_tso_mss(struct net_pkt *pkt)
+{
+	return pkt->tso_mss;
+}
+
+static inline void net_pkt_set_tso_mss(struct net_pkt *pkt, u16_t mss)
+{
+	pkt->tso_mss = mss;
+}
+#else
+static inline u16_t net_pkt_tso_mss(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+	return 0;
+}
+
+static inline void net_pkt_set_tso_mss(struct net_pkt *pkt, u16_t mss)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(mss);
+}
+#endif /* CONFIG_NET_TCP_TSO */
+
+#if defined(CONFIG_NET_PKT_TIMESTAMP)
+static inline struct net_ptp_time *net_pkt_timestamp(struct net_pkt *pkt)
+{
+	return &pkt->timestamp;
+}
+
+static inline void net_pkt_set_timestamp(struct net_pkt *pkt,
+					 const struct net_ptp_time *timestamp)
+{
+	pkt->timestamp = *timestamp;
+}
+#else
+static inline struct net_ptp_time *net_pkt_timestamp(struct net_pkt *pkt)
+{
+	ARG_UNUSED(pkt);
+	return NULL;
+}
+
+static inline void net_pkt_set_timestamp(struct net_pkt *pkt,
+					 const struct net_ptp_time *timestamp)
+{
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(timestamp);
+}
+#endif /* CONFIG_NET_PKT_TIMESTAMP */
+
 static inline size_t net_pkt_get_len(struct net_pkt *pkt)
 {
 	return net_buf_frags_len(pkt->frags);
@@ -556,6 +625,12 @@ static inline u8_t *net_pkt_ll(struct net_pkt *pkt)
 	return net_pkt_ip_data(pkt) - net_pkt_ll_reserve(pkt);
 }
 
+/* Packet data is in a single fragment, e.g. from net_pkt_get_frag_linear() */
+static inline bool net_pkt_is_linear(struct net_pkt *pkt)
+{
+	return pkt->frags && !pkt->frags->frags;
+}
+
 static inline struct net_linkaddr *net_pkt_ll_src(struct net_pkt *pkt)
 {
 	return &pkt->lladdr_src;
@@ -653,6 +728,32 @@ static inline void net_pkt_set_src_ipv6_addr(struct net_pkt *pkt)
 	NET_BUF_POOL_DEFINE(name, count, CONFIG_NET_BUF_DATA_SIZE,	\
 			    CONFIG_NET_BUF_USER_DATA_SIZE, NULL)
 
+#if defined(CONFIG_NET_PKT_LINEAR)
+/**
+ * @brief Create a data buffer pool of contiguous packet buffers
+ *
+ * @details Unlike the pools created by NET_PKT_DATA_POOL_DEFINE(), the
+ * buffers of this pool have a variable size, as needed by
+ * :c:func:`net_pkt_get_frag_linear`, and up to @a count of them can be
+ * as large as CONFIG_NET_PKT_LINEAR_MAX_SIZE.
+ *
+ * @param name Name of the pool.
+ * @param count Number of buffers in this pool.
+ */
+#define NET_PKT_LINEAR_POOL_DEFINE(name, count)				\
+	static struct net_buf _net_buf_##name[count] __noinit;		\
+	K_MEM_POOL_DEFINE(net_buf_mem_pool_##name, 32,			\
+			  CONFIG_NET_PKT_LINEAR_MAX_SIZE, count, 4);	\
+	static const struct net_buf_data_alloc net_buf_data_alloc_##name = { \
+		.cb = &net_buf_var_cb,					\
+		.alloc_data = &net_buf_mem_pool_##name,			\
+	};								\
+	struct net_buf_pool name __net_buf_align			\
+			__in_section(_net_buf_pool, static, name) =	\
+		NET_BUF_POOL_INITIALIZER(name, &net_buf_data_alloc_##name, \
+					 _net_buf_##name, count, NULL)
+#endif /* CONFIG_NET_PKT_LINEAR */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
 
 /* Debug versions of the net_pkt functions that are used when tracking
@@ -728,6 +829,14 @@ struct net_buf *net_pkt_get_frag_debug(struct net_pkt *pkt,
 #define net_pkt_get_frag(pkt, timeout)					\
 	net_pkt_get_frag_debug(pkt, timeout, __func__, __LINE__)
 
+#if defined(CONFIG_NET_PKT_LINEAR)
+struct net_buf *net_pkt_get_frag_linear_debug(struct net_pkt *pkt,
+					      size_t len, s32_t timeout,
+					      const char *caller, int line);
+#define net_pkt_get_frag_linear(pkt, len, timeout)			\
+	net_pkt_get_frag_linear_debug(pkt, len, timeout, __func__, __LINE__)
+#endif
+
 void net_pkt_unref_debug(struct net_pkt *pkt, const char *caller, int line);
 #define net_pkt_unref(pkt) net_pkt_unref_debug(pkt, __func__, __LINE__)
 
@@ -931,6 +1040,28 @@ struct net_buf *net_pkt_get_reserve_tx_data(u16_t reserve_head,
  */
 struct net_buf *net_pkt_get_frag(struct net_pkt *pkt, s32_t timeout);
 
+#if defined(CONFIG_NET_PKT_LINEAR)
+/**
+ * @brief Get a contiguous data fragment for a whole frame.
+ *
+ * @details The fragment is allocated from the contiguous RX or TX
+ * buffer pool, depending on the packet, and has room for at least
+ * @a len bytes after the link layer reserve of the packet. A packet made
+ * of a single fragment is parsed without crossing fragment boundaries.
+ *
+ * @param pkt Network packet.
+ * @param len Size of the frame data, not counting the link layer reserve.
+ * @param timeout Affects the action taken should the net buf pool be empty.
+ *        If K_NO_WAIT, then return immediately. If K_FOREVER, then
+ *        wait as long as necessary. Otherwise, wait up to the specified
+ *        number of milliseconds before timing out.
+ *
+ * @return Network buffer if successful, NULL otherwise.
+ */
+struct net_buf *net_pkt_get_frag_linear(struct net_pkt *pkt, size_t len,
+					s32_t timeout);
+#endif
+
 /**
  * @brief Place packet back into the available packets slab
  *
@@ -1319,6 +1450,134 @@ struct net_buf *net_frag_read_be16(struct net_buf *frag, u16_t offset,
 struct net_buf *net_frag_read_be32(struct net_buf *frag, u16_t offset,
 				   u16_t *pos, u32_t *value);
 
+/**
+ * @brief Position in the data of a packet
+ *
+ * @details A cursor keeps track of the fragment and offset it points to,
+ * so that parsing or rewriting a packet sequentially goes through its
+ * fragment chain once. The cursor always points to a byte of data, or
+ * has a NULL fragment once at the end of the data.
+ */
+struct net_pkt_cursor {
+	/** Current fragment, NULL at the end of the data */
+	struct net_buf *frag;
+	/** Offset in the current fragment */
+	u16_t pos;
+};
+
+/**
+ * @brief Initialize a cursor at an offset in the data of a packet
+ *
+ * @param pkt Network packet.
+ * @param cursor Cursor to initialize.
+ * @param offset Offset from the start of the packet data.
+ *
+ * @return 0 if successful, -ENOBUFS if the packet has less than
+ *         @a offset bytes of data.
+ */
+int net_pkt_cursor_init(struct net_pkt *pkt, struct net_pkt_cursor *cursor,
+			u16_t offset);
+
+/**
+ * @brief Read data at a cursor and move it past the data
+ *
+ * @param cursor Cursor.
+ * @param data Buffer receiving the data, or NULL to only move the cursor.
+ * @param len Amount of data to read.
+ *
+ * @return 0 if successful, -ENOBUFS if there is less than @a len bytes
+ *         of data left, in which case the cursor is left unchanged.
+ */
+int net_pkt_cursor_read(struct net_pkt_cursor *cursor, void *data,
+			u16_t len);
+
+/**
+ * @brief Move a cursor forward
+ *
+ * @param cursor Cursor.
+ * @param len Amount of data to skip.
+ *
+ * @return 0 if successful, -ENOBUFS if there is less than @a len bytes
+ *         of data left, in which case the cursor is left unchanged.
+ */
+static inline int net_pkt_cursor_skip(struct net_pkt_cursor *cursor,
+				      u16_t len)
+{
+	return net_pkt_cursor_read(cursor, NULL, len);
+}
+
+/**
+ * @brief Read a byte at a cursor
+ *
+ * @param cursor Cursor.
+ * @param value Value read.
+ *
+ * @return 0 if successful, -ENOBUFS at the end of the data.
+ */
+static inline int net_pkt_cursor_read_u8(struct net_pkt_cursor *cursor,
+					 u8_t *value)
+{
+	return net_pkt_cursor_read(cursor, value, sizeof(u8_t));
+}
+
+/**
+ * @brief Read a 16 bit big endian value at a cursor
+ *
+ * @param cursor Cursor.
+ * @param value Value read, in host byte order.
+ *
+ * @return 0 if successful, -ENOBUFS if there is not enough data left.
+ */
+int net_pkt_cursor_read_be16(struct net_pkt_cursor *cursor, u16_t *value);
+
+/**
+ * @brief Read a 32 bit big endian value at a cursor
+ *
+ * @param cursor Cursor.
+ * @param value Value read, in host byte order.
+ *
+ * @return 0 if successful, -ENOBUFS if there is not enough data left.
+ */
+int net_pkt_cursor_read_be32(struct net_pkt_cursor *cursor, u32_t *value);
+
+/**
+ * @brief Overwrite data at a cursor and move it past the data
+ *
+ * @details Only the existing data of the packet is overwritten, the
+ * packet does not grow: use net_pkt_write() or net_pkt_append() for that.
+ *
+ * @param cursor Cursor.
+ * @param data Data to write.
+ * @param len Amount of data to write.
+ *
+ * @return 0 if successful, -ENOBUFS if there is less than @a len bytes
+ *         of data left, in which case nothing is written.
+ */
+int net_pkt_cursor_write(struct net_pkt_cursor *cursor, const void *data,
+			 u16_t len);
+
+/**
+ * @brief Access contiguous data at a cursor
+ *
+ * @details The cursor is not moved, so that the data can be parsed in
+ * place and then skipped.
+ *
+ * @param cursor Cursor.
+ * @param len Amount of data needed.
+ *
+ * @return Pointer to the data if the next @a len bytes are in the current
+ *         fragment, NULL otherwise.
+ */
+static inline void *net_pkt_cursor_peek(struct net_pkt_cursor *cursor,
+					u16_t len)
+{
+	if (!cursor->frag || cursor->pos + len > cursor->frag->len) {
+		return NULL;
+	}
+
+	return cursor->frag->data + cursor->pos;
+}
+
 /**
  * @brief Write data to an arbitrary offset in fragments list of a packet.
  *
@@ -1616,6 +1875,29 @@ const char *net_pkt_pool2str(struct net_buf_pool *pool);
 #define net_pkt_print(...)
 #endif /* CONFIG_NET_DEBUG_NET_PKT */
 
+#if defined(CONFIG_NET_PKT_ALLOC_TRACK)
+/**
+ * @typedef net_pkt_track_cb_t
+ * @brief Callback used while iterating over packet allocation sites
+ *
+ * @param site Return address in the function which allocated the
+ * packets, NULL for the sites which did not fit in the table.
+ * @param allocs Number of packets allocated from this site.
+ * @param live Number of these packets still in use.
+ * @param user_data A valid pointer to user data or NULL
+ */
+typedef void (*net_pkt_track_cb_t)(void *site, u32_t allocs, u16_t live,
+				   void *user_data);
+
+/**
+ * @brief Go through the call sites which allocated network packets
+ *
+ * @param cb User supplied callback function to call.
+ * @param user_data User specified data.
+ */
+void net_pkt_track_foreach(net_pkt_track_cb_t cb, void *user_data);
+#endif /* CONFIG_NET_PKT_ALLOC_TRACK */
+
 /**
  * @}
  */
@@ -133,6 +133,37 @@ struct net_stats_tcp {
 
 	/** Number of connection attempts for closed ports, triggering a RST. */
 	net_stats_t connrst;
+
+	/** Number of fast retransmits, after three duplicate ACKs. */
+	net_stats_t fast_rexmit;
+
+	/** Number of congestion window resets after a retransmission
+	 * timeout.
+	 */
+	net_stats_t timeout;
+};
+
+/**
+ * @brief Congestion control state of a TCP connection
+ */
+struct net_stats_tcp_cc {
+	/** Congestion window, in bytes. */
+	u32_t cwnd;
+
+	/** Slow start threshold, in bytes. */
+	u32_t ssthresh;
+
+	/** Smoothed round trip time, in ms. */
+	u32_t srtt;
+
+	/** Round trip time variation, in ms. */
+	u32_t rttvar;
+
+	/** Number of fast retransmits. */
+	u32_t fast_rexmit;
+
+	/** Number of retransmission timeouts. */
+	u32_t timeout;
 };
 
 struct net_stats_udp {
@@ -250,6 +281,74 @@ struct net_stats_tc {
 	} recv[NET_TC_RX_COUNT];
 };
 
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+/** Stages of the packet latency statistics. Each stage is measured from
+ * the end of the previous one, so that the stages of a packet add up.
+ */
+enum net_stats_latency_stage {
+	/** From net_recv_data() to the RX traffic class thread */
+	NET_STATS_LATENCY_RX_QUEUE,
+	/** L2 and IP processing, up to the transport layer */
+	NET_STATS_LATENCY_RX_IP,
+	/** Transport layer, up to the receive callback of the context */
+	NET_STATS_LATENCY_RX_L4,
+	/** From the receive callback to the read of the socket */
+	NET_STATS_LATENCY_RX_SOCKET,
+	/** From the context send to the interface TX queue */
+	NET_STATS_LATENCY_TX_STACK,
+	/** From the interface TX queue to the TX traffic class thread */
+	NET_STATS_LATENCY_TX_QUEUE,
+	/** Time spent in the send function of the driver */
+	NET_STATS_LATENCY_TX_DRIVER,
+
+	NET_STATS_LATENCY_STAGES
+};
+
+#define NET_STATS_LATENCY_BUCKETS 16
+
+struct net_stats_latency {
+	/** Number of packets measured */
+	net_stats_t count;
+
+	/** Highest latency, in microseconds */
+	u32_t max;
+
+	/** Sum of the latencies, in microseconds */
+	u64_t sum;
+
+	/** Bucket 0 counts latencies below 1 us, bucket n those from
+	 * 2^(n-1) us to 2^n us, the last bucket all the longer ones.
+	 */
+	net_stats_t hist[NET_STATS_LATENCY_BUCKETS];
+};
+
+/** Latency statistics of all the interfaces, indexed by stage */
+extern struct net_stats_latency net_stats_latency[NET_STATS_LATENCY_STAGES];
+
+struct net_pkt;
+
+/**
+ * @brief Account the latency of a stage of a packet
+ *
+ * The stage lasted from the end of the previous stage, or from the time the
+ * packet was received or sent by the application, up to now. Packets which
+ * were not timestamped are ignored.
+ *
+ * @param pkt Network packet
+ * @param stage Stage that just ended
+ */
+void net_stats_update_latency(struct net_pkt *pkt,
+			      enum net_stats_latency_stage stage);
+
+/**
+ * @brief Account the latency of a stage not tied to a packet timestamp
+ *
+ * @param stage Stage that just ended
+ * @param cycles Duration of the stage in hardware cycles
+ */
+void net_stats_update_latency_cycles(enum net_stats_latency_stage stage,
+				     u32_t cycles);
+#endif /* CONFIG_NET_STATISTICS_LATENCY */
 
 struct net_stats {
 	net_stats_t processing_error;
@@ -341,6 +440,20 @@ struct net_stats_eth_hw_timestamp {
 	net_stats_t tx_hwtstamp_skipped;
 };
 
+/* RX polling, see ethernet_rx_poll.h */
+struct net_stats_eth_rx_poll {
+	/* RX interrupts which started polling */
+	net_stats_t interrupts;
+	/* Polling runs */
+	net_stats_t polls;
+	/* Frames received by the polling runs */
+	net_stats_t pkts;
+	/* Polling runs which used up their budget */
+	net_stats_t budget_exhausted;
+	/* Most frames received after one RX interrupt */
+	net_stats_t max_pkts_per_irq;
+};
+
 /* Ethernet specific statistics */
 struct net_stats_eth {
 	struct net_stats_bytes bytes;
@@ -356,6 +469,7 @@ struct net_stats_eth {
 	net_stats_t tx_dropped;
 	net_stats_t tx_timeout_count;
 	net_stats_t tx_restart_queue;
+	struct net_stats_eth_rx_poll rx_poll;
 };
 
 #if defined(CONFIG_NET_STATISTICS_USER_API)
@@ -461,6 +575,21 @@ NET_MGMT_DEFINE_REQUEST_HANDLER(NET_REQUEST_STATS_GET_ETHERNET);
 
 #endif /* CONFIG_NET_STATISTICS_USER_API */
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+struct net_context;
+
+/**
+ * @brief Get the congestion control state of a TCP connection
+ *
+ * @param context Connected TCP context.
+ * @param stats Filled with the current state of the connection.
+ *
+ * @return 0 if ok, -ENOTCONN if the connection is not established.
+ */
+int net_stats_tcp_cc_get(struct net_context *context,
+			 struct net_stats_tcp_cc *stats);
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 /**
  * @}
  */
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Time representation of the Precision Time Protocol
+ */
+
+#ifndef __PTP_TIME_H
+#define __PTP_TIME_H
+
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief PTP time, as kept by PTP clocks and used for packet timestamps
+ */
+struct net_ptp_time {
+	/** Seconds, only the 48 lower bits are carried by PTP messages */
+	u64_t second;
+
+	/** Nanoseconds, less than one second */
+	u32_t nanosecond;
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PTP_TIME_H */
@@ -86,4 +86,40 @@ int sntp_request(struct sntp_ctx *ctx,
  */
 void sntp_close(struct sntp_ctx *ctx);
 
+#if defined(CONFIG_SNTP_SERVICE)
+/**
+ * @brief Start the background SNTP service
+ *
+ * @details The server is polled at an adaptive interval and the samples
+ * are filtered to keep a wall clock offset on top of the kernel uptime.
+ * Small corrections are slewed, large ones are stepped.
+ *
+ * @param srv_addr IP address of NTP/SNTP server.
+ * @param srv_port Port number of NTP/SNTP server.
+ * @param timeout Timeout of sntp context initialization (in milliseconds).
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int sntp_service_start(const char *srv_addr, u16_t srv_port, u32_t timeout);
+
+/**
+ * @brief Stop the background SNTP service
+ *
+ * @details The clock keeps running from the last correction.
+ */
+void sntp_service_stop(void);
+
+/**
+ * @brief Get the current time of the SNTP service
+ *
+ * @details No network traffic is involved, the time is computed from the
+ * kernel uptime.
+ *
+ * @param epoch_ms Milliseconds since 1 January 1970 are returned here.
+ *
+ * @return 0 if ok, -EAGAIN if the clock has not been synchronized yet.
+ */
+int sntp_time_get(u64_t *epoch_ms);
+#endif /* CONFIG_SNTP_SERVICE */
+
 #endif
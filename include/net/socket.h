@@ -40,8 +40,58 @@ struct zsock_pollfd {
 #define ZSOCK_POLLIN 1
 #define ZSOCK_POLLOUT 4
 
+/* Values are compatible with Linux, EPOLLIN and EPOLLOUT are POLLIN and
+ * POLLOUT
+ */
+#define ZSOCK_EPOLLIN ZSOCK_POLLIN
+#define ZSOCK_EPOLLOUT ZSOCK_POLLOUT
+#define ZSOCK_EPOLLET (1u << 31)
+
+#define ZSOCK_EPOLL_CTL_ADD 1
+#define ZSOCK_EPOLL_CTL_DEL 2
+#define ZSOCK_EPOLL_CTL_MOD 3
+
+typedef union zsock_epoll_data {
+	void *ptr;
+	int fd;
+	u32_t u32;
+	u64_t u64;
+} zsock_epoll_data_t;
+
+struct zsock_epoll_event {
+	u32_t events;
+	zsock_epoll_data_t data;
+};
+
+/* Values are compatible with Linux */
+#define SOL_SOCKET 1
+#define SO_SNDBUF 7
+#define SO_RCVBUF 8
+
 #define ZSOCK_MSG_PEEK 0x02
+#define ZSOCK_MSG_TRUNC 0x20
 #define ZSOCK_MSG_DONTWAIT 0x40
+#define ZSOCK_MSG_WAITFORONE 0x10000
+
+struct zsock_iovec {
+	void *iov_base;
+	size_t iov_len;
+};
+
+struct zsock_msghdr {
+	void *msg_name;
+	socklen_t msg_namelen;
+	struct zsock_iovec *msg_iov;
+	size_t msg_iovlen;
+	void *msg_control;
+	size_t msg_controllen;
+	int msg_flags;
+};
+
+struct zsock_mmsghdr {
+	struct zsock_msghdr msg_hdr;
+	unsigned int msg_len;
+};
 
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
@@ -69,13 +119,78 @@ ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
 		     const struct sockaddr *dest_addr, socklen_t addrlen);
 ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
 		       struct sockaddr *src_addr, socklen_t *addrlen);
+ssize_t zsock_sendmsg(int sock, const struct zsock_msghdr *msg, int flags);
+ssize_t zsock_recvmsg(int sock, struct zsock_msghdr *msg, int flags);
+int zsock_sendmmsg(int sock, struct zsock_mmsghdr *msgvec, unsigned int vlen,
+		   int flags);
+int zsock_recvmmsg(int sock, struct zsock_mmsghdr *msgvec, unsigned int vlen,
+		   int flags);
+int zsock_setsockopt(int sock, int level, int optname,
+		     const void *optval, socklen_t optlen);
+int zsock_getsockopt(int sock, int level, int optname,
+		     void *optval, socklen_t *optlen);
 int zsock_fcntl(int sock, int cmd, int flags);
 int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout);
+int zsock_epoll_create1(int flags);
+int zsock_epoll_ctl(int epfd, int op, int fd, struct zsock_epoll_event *event);
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout);
 int zsock_inet_pton(sa_family_t family, const char *src, void *dst);
 int zsock_getaddrinfo(const char *host, const char *service,
 		      const struct zsock_addrinfo *hints,
 		      struct zsock_addrinfo **res);
 
+struct net_buf;
+
+/**
+ * @brief Get a buffer to fill with data to send without copy
+ *
+ * @details The buffer comes from the data pool of the socket and can be
+ * filled up to its tailroom. Chain several of them with net_buf_frag_add()
+ * to send more, then pass the chain to zsock_sendto_zc().
+ *
+ * @param sock Socket the data will be sent on.
+ * @param timeout Time to wait for a free buffer, in ms.
+ *
+ * @return Buffer, or NULL with errno set if none is available.
+ */
+struct net_buf *zsock_zc_buf_get(int sock, s32_t timeout);
+
+/**
+ * @brief Release buffers received or not sent
+ *
+ * @param frags Buffer chain from zsock_recvfrom_zc() or
+ * zsock_zc_buf_get().
+ */
+void zsock_zc_buf_put(struct net_buf *frags);
+
+/**
+ * @brief Send a buffer chain without copying it
+ *
+ * @details The stack owns the chain from then on, whether the call
+ * succeeds or not.
+ *
+ * @return Number of bytes sent, or -1 with errno set.
+ */
+ssize_t zsock_sendto_zc(int sock, struct net_buf *frags, int flags,
+			const struct sockaddr *dest_addr, socklen_t addrlen);
+
+/**
+ * @brief Receive the buffers data arrived in, without copying them
+ *
+ * @details For a stream socket, all the data of the oldest segment
+ * queued is returned, for a datagram socket a whole datagram. The
+ * buffers are lent to the application, which must give them back with
+ * zsock_zc_buf_put() as soon as possible: they belong to the RX pool of
+ * the network stack. MSG_PEEK is not supported.
+ *
+ * @param frags Set to the buffer chain holding the data, NULL on EOF.
+ *
+ * @return Number of bytes in the chain, 0 on EOF, or -1 with errno set.
+ */
+ssize_t zsock_recvfrom_zc(int sock, struct net_buf **frags, int flags,
+			  struct sockaddr *src_addr, socklen_t *addrlen);
+
 #if defined(CONFIG_NET_SOCKETS_POSIX_NAMES)
 static inline int socket(int family, int type, int proto)
 {
@@ -118,6 +233,18 @@ static inline ssize_t recv(int sock, void *buf, size_t max_len, int flags)
 	return zsock_recv(sock, buf, max_len, flags);
 }
 
+static inline int setsockopt(int sock, int level, int optname,
+			     const void *optval, socklen_t optlen)
+{
+	return zsock_setsockopt(sock, level, optname, optval, optlen);
+}
+
+static inline int getsockopt(int sock, int level, int optname,
+			     void *optval, socklen_t *optlen)
+{
+	return zsock_getsockopt(sock, level, optname, optval, optlen);
+}
+
 /* This conflicts with fcntl.h, so code must include fcntl.h before socket.h: */
 #define fcntl zsock_fcntl
 
@@ -134,6 +261,33 @@ static inline ssize_t recvfrom(int sock, void *buf, size_t max_len, int flags,
 	return zsock_recvfrom(sock, buf, max_len, flags, src_addr, addrlen);
 }
 
+static inline ssize_t sendmsg(int sock, const struct zsock_msghdr *msg,
+			      int flags)
+{
+	return zsock_sendmsg(sock, msg, flags);
+}
+
+static inline ssize_t recvmsg(int sock, struct zsock_msghdr *msg, int flags)
+{
+	return zsock_recvmsg(sock, msg, flags);
+}
+
+static inline int sendmmsg(int sock, struct zsock_mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_sendmmsg(sock, msgvec, vlen, flags);
+}
+
+static inline int recvmmsg(int sock, struct zsock_mmsghdr *msgvec,
+			   unsigned int vlen, int flags)
+{
+	return zsock_recvmmsg(sock, msgvec, vlen, flags);
+}
+
+#define iovec zsock_iovec
+#define msghdr zsock_msghdr
+#define mmsghdr zsock_mmsghdr
+
 static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 {
 	return zsock_poll(fds, nfds, timeout);
@@ -143,8 +297,36 @@ static inline int poll(struct zsock_pollfd *fds, int nfds, int timeout)
 #define POLLIN ZSOCK_POLLIN
 #define POLLOUT ZSOCK_POLLOUT
 
+static inline int epoll_create1(int flags)
+{
+	return zsock_epoll_create1(flags);
+}
+
+static inline int epoll_ctl(int epfd, int op, int fd,
+			    struct zsock_epoll_event *event)
+{
+	return zsock_epoll_ctl(epfd, op, fd, event);
+}
+
+static inline int epoll_wait(int epfd, struct zsock_epoll_event *events,
+			     int maxevents, int timeout)
+{
+	return zsock_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+#define epoll_event zsock_epoll_event
+#define epoll_data_t zsock_epoll_data_t
+#define EPOLLIN ZSOCK_EPOLLIN
+#define EPOLLOUT ZSOCK_EPOLLOUT
+#define EPOLLET ZSOCK_EPOLLET
+#define EPOLL_CTL_ADD ZSOCK_EPOLL_CTL_ADD
+#define EPOLL_CTL_DEL ZSOCK_EPOLL_CTL_DEL
+#define EPOLL_CTL_MOD ZSOCK_EPOLL_CTL_MOD
+
 #define MSG_PEEK ZSOCK_MSG_PEEK
+#define MSG_TRUNC ZSOCK_MSG_TRUNC
 #define MSG_DONTWAIT ZSOCK_MSG_DONTWAIT
+#define MSG_WAITFORONE ZSOCK_MSG_WAITFORONE
 
 static inline char *inet_ntop(sa_family_t family, const void *src, char *dst,
 			      size_t size)
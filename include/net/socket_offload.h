@@ -0,0 +1,72 @@
+/**
+ * @file
+ * @brief Socket API offload
+ *
+ * Lets a network driver for a module with its own TCP/IP stack provide
+ * the BSD Sockets compatible API directly.
+ */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __NET_SOCKET_OFFLOAD_H
+#define __NET_SOCKET_OFFLOAD_H
+
+#include <net/socket.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Socket operations of an offloading driver
+ *
+ * @details Each operation has the semantics of the zsock_* call of the
+ * same name: it returns -1 and sets errno on failure. Operations a
+ * driver leaves NULL fail with EOPNOTSUPP. zsock_send() and zsock_recv()
+ * are mapped to sendto and recvfrom without an address. The results of
+ * getaddrinfo must stay valid until the next call, as freeaddrinfo()
+ * does nothing.
+ */
+struct socket_offload {
+	int (*socket)(int family, int type, int proto);
+	int (*close)(int sock);
+	int (*bind)(int sock, const struct sockaddr *addr,
+		    socklen_t addrlen);
+	int (*connect)(int sock, const struct sockaddr *addr,
+		       socklen_t addrlen);
+	int (*listen)(int sock, int backlog);
+	int (*accept)(int sock, struct sockaddr *addr, socklen_t *addrlen);
+	ssize_t (*sendto)(int sock, const void *buf, size_t len, int flags,
+			  const struct sockaddr *dest_addr, socklen_t addrlen);
+	ssize_t (*recvfrom)(int sock, void *buf, size_t max_len, int flags,
+			    struct sockaddr *src_addr, socklen_t *addrlen);
+	int (*setsockopt)(int sock, int level, int optname,
+			  const void *optval, socklen_t optlen);
+	int (*getsockopt)(int sock, int level, int optname,
+			  void *optval, socklen_t *optlen);
+	int (*fcntl)(int sock, int cmd, int flags);
+	int (*poll)(struct zsock_pollfd *fds, int nfds, int timeout);
+	int (*getaddrinfo)(const char *host, const char *service,
+			   const struct zsock_addrinfo *hints,
+			   struct zsock_addrinfo **res);
+};
+
+/**
+ * @brief Register the socket operations of the offloading driver
+ *
+ * @details Called by the driver once it is ready, usually from its
+ * init function. Only one driver can provide the sockets.
+ *
+ * @param ops Socket operations, which must stay valid.
+ */
+void socket_offload_register(const struct socket_offload *ops);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NET_SOCKET_OFFLOAD_H */
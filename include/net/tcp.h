@@ -42,6 +42,18 @@ extern "C" {
 struct net_tcp_hdr *net_tcp_get_hdr(struct net_pkt *pkt,
 				    struct net_tcp_hdr *hdr);
 
+/**
+ * @brief Get the room left in the send buffer of a TCP connection.
+ *
+ * @details The data queued and not acknowledged by the peer yet counts
+ * against CONFIG_NET_TCP_SEND_BUFFER.
+ *
+ * @param context TCP network context.
+ *
+ * @return Number of bytes that can be queued, 0 if the buffer is full.
+ */
+size_t net_tcp_get_send_space(struct net_context *context);
+
 /**
  * @brief Set TCP packet header data in net_pkt.
  *
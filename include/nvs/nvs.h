@@ -26,6 +26,36 @@ extern "C" {
  * @{
  */
 
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+/**
+ * @brief Non-volatile Storage lookup cache slot
+ *
+ * @param data_addr Address of the latest entry data for id
+ * @param id Entry id, 0xFFFF when the slot is unused
+ * @param len Length in flash of the latest entry, 0 when deleted
+ */
+struct nvs_lookup {
+	off_t data_addr;
+	u16_t id;
+	u16_t len;
+};
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+
+#if defined(CONFIG_NVS_BATCH)
+/**
+ * @brief Non-volatile Storage batch of entries
+ *
+ * @param buf Buffer holding the staged entries
+ * @param size Size of the buffer
+ * @param used Number of bytes of the buffer in use
+ */
+struct nvs_batch {
+	u8_t *buf;
+	u16_t size;
+	u16_t used;
+};
+#endif /* CONFIG_NVS_BATCH */
+
 /**
  * @brief Non-volatile Storage File system structure
  *
@@ -42,6 +72,12 @@ extern "C" {
  * @param write_block_size Alignment size in bytes_to_copy
  * @param nvs_lock Mutex
  * @param flash_device Flash Device
+ * @param lookup_cache Latest entry per id, only with CONFIG_NVS_LOOKUP_CACHE
+ * @param gc_lock Mutex held during garbage collection, only with
+ * CONFIG_NVS_BACKGROUND_GC
+ * @param gc_work Background garbage collection work item
+ * @param gc_reserve Space kept free in the write sector for a running
+ * background garbage collection
  */
 struct nvs_fs {
 	u32_t magic; /* filesystem magic, repeated at start of each sector */
@@ -65,6 +101,14 @@ struct nvs_fs {
 
 	struct k_mutex nvs_lock;
 	struct device *flash_device;
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	struct nvs_lookup lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+#endif
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	struct k_mutex gc_lock;
+	struct k_work gc_work;
+	u16_t gc_reserve;
+#endif
 };
 
 /**
@@ -168,6 +212,55 @@ ssize_t nvs_read(struct nvs_fs *fs, u16_t id, void *data, size_t len);
 ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 		  u16_t cnt);
 
+#if defined(CONFIG_NVS_BATCH)
+/**
+ * @brief nvs_batch_init
+ *
+ * Initializes an empty batch. Entries added to the batch are staged in buf
+ * until the batch is committed.
+ *
+ * @param batch Pointer to batch
+ * @param buf Pointer to the buffer the entries are staged in
+ * @param size Size of the buffer in bytes
+ */
+void nvs_batch_init(struct nvs_batch *batch, void *buf, size_t size);
+
+/**
+ * @brief nvs_batch_write
+ *
+ * Add an entry to a batch, nothing is written to flash yet. A zero length
+ * deletes the entry when the batch is committed. The staged entries,
+ * including their header and crc, should fit in the batch buffer and in the
+ * maximum storage length of the file system.
+ *
+ * @param fs Pointer to file system
+ * @param batch Pointer to batch
+ * @param id Id of the entry to be written
+ * @param data Pointer to the data to be written
+ * @param len Number of bytes to be written
+ * @retval 0 Success
+ * @retval -ENOMEM the entry does not fit in the batch
+ * @retval -ERRNO errno code if error
+ */
+int nvs_batch_write(struct nvs_fs *fs, struct nvs_batch *batch, u16_t id,
+		    const void *data, size_t len);
+
+/**
+ * @brief nvs_batch_commit
+ *
+ * Write all entries of a batch to the file system in a single append. The
+ * entries become visible together: when power is lost before the commit
+ * completes, none of them are. On success the batch is emptied and can be
+ * reused.
+ *
+ * @param fs Pointer to file system
+ * @param batch Pointer to batch
+ * @retval 0 Success
+ * @retval -ERRNO errno code if error
+ */
+int nvs_batch_commit(struct nvs_fs *fs, struct nvs_batch *batch);
+#endif /* CONFIG_NVS_BATCH */
+
 /**
  * @}
  */
@@ -18,6 +18,9 @@ extern "C" {
 typedef void *mqd_t;
 typedef unsigned int mode_t;
 
+/* Number of message priorities, from 0 to MQ_PRIO_MAX - 1 */
+#define MQ_PRIO_MAX 32
+
 typedef struct mq_attr {
 	long mq_flags;
 	long mq_maxmsg;
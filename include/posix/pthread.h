@@ -77,6 +77,7 @@ static inline int pthread_cond_init(pthread_cond_t *cv,
 {
 	ARG_UNUSED(att);
 	_waitq_init(&cv->wait_q);
+	cv->mutex = NULL;
 	return 0;
 }
 
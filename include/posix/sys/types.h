@@ -50,6 +50,8 @@ typedef struct pthread_mutexattr {
 /* Condition variables */
 typedef struct pthread_cond {
 	_wait_q_t wait_q;
+	/* mutex of the waiting threads, which signals move them to */
+	struct pthread_mutex *mutex;
 } pthread_cond_t;
 
 typedef struct pthread_condattr {
@@ -75,9 +77,9 @@ typedef unsigned long useconds_t;
 typedef u32_t pthread_rwlockattr_t;
 
 typedef struct pthread_rwlock_obj {
-	struct k_sem rd_sem;
-	struct k_sem wr_sem;
-	struct k_sem reader_active;/* blocks WR till reader has acquired lock */
+	_wait_q_t rd_wait_q;
+	_wait_q_t wr_wait_q;
+	u32_t readers;	/* number of read locks held */
 	s32_t status;
 	k_tid_t wr_owner;
 } pthread_rwlock_t;
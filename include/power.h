@@ -115,6 +115,108 @@ extern int _sys_soc_suspend(s32_t ticks);
  * @}
  */
 
+#ifdef CONFIG_SYS_PM_POLICY
+
+#include <misc/dlist.h>
+
+/**
+ * @brief Power Management Policy
+ *
+ * With the policy enabled, the kernel provides _sys_soc_suspend() and
+ * _sys_soc_resume(): the SOC describes its power states instead, and each
+ * time the kernel idles the policy enters the deepest state which meets
+ * the latency constraints set and fits in the predicted idle time.
+ *
+ * @defgroup power_management_policy Power Management Policy
+ * @ingroup power_management_api
+ * @{
+ */
+
+/** @brief Description of a power state */
+struct sys_pm_state {
+	/** Time to enter the state, in microseconds */
+	u32_t entry_latency_us;
+	/** Time to resume from the state, in microseconds */
+	u32_t exit_latency_us;
+	/** Minimum time to stay in the state for it to save power */
+	u32_t min_residency_us;
+	/**
+	 * Enter the state, with the same contract as _sys_soc_suspend():
+	 * called with interrupts disabled with the upcoming idle time, it
+	 * sets up a wake event, re-enables interrupts once in the state and
+	 * returns SYS_PM_LOW_POWER_STATE or SYS_PM_DEEP_SLEEP, or returns
+	 * SYS_PM_NOT_HANDLED with interrupts still disabled.
+	 */
+	int (*enter)(s32_t ticks);
+	/** Optional, called with interrupts disabled on wake up */
+	void (*exit)(void);
+};
+
+/** @brief Residency statistics of a power state */
+struct sys_pm_state_stats {
+	/** Number of times the state was entered */
+	u32_t count;
+	/** Total time spent in the state, in microseconds */
+	u64_t residency_us;
+};
+
+/** @brief Latency constraint, owned by the caller */
+struct sys_pm_constraint {
+	sys_dnode_t node;
+	u32_t latency_us;
+};
+
+/**
+ * @brief Register a power state of the SOC
+ *
+ * States must be registered from the shallowest to the deepest one,
+ * typically from an init function of the SOC.
+ *
+ * @param state Description of the state, must stay valid.
+ *
+ * @return Index of the state, -EINVAL if the state has no enter function,
+ * -ENOMEM if CONFIG_SYS_PM_POLICY_MAX_STATES states are already registered.
+ */
+int sys_pm_state_register(const struct sys_pm_state *state);
+
+/**
+ * @brief Set a wake up latency constraint
+ *
+ * Until the constraint is removed, only the states whose entry and exit
+ * latencies add up to at most @a latency_us are entered.
+ *
+ * @param constraint Constraint to set, must not already be set.
+ * @param latency_us Maximum wake up latency, in microseconds.
+ */
+void sys_pm_constraint_add(struct sys_pm_constraint *constraint,
+			   u32_t latency_us);
+
+/**
+ * @brief Remove a wake up latency constraint
+ *
+ * @param constraint Constraint previously set with sys_pm_constraint_add().
+ */
+void sys_pm_constraint_remove(struct sys_pm_constraint *constraint);
+
+/**
+ * @brief Get the residency statistics of a power state
+ *
+ * The time spent in a state is measured with k_cycle_get_32(), it is only
+ * meaningful for states which keep the hardware clock running.
+ *
+ * @param state Index of the state, as returned on registration.
+ * @param stats Filled with the statistics.
+ *
+ * @return 0 on success, -EINVAL if there is no such state.
+ */
+int sys_pm_state_stats_get(int state, struct sys_pm_state_stats *stats);
+
+/**
+ * @}
+ */
+
+#endif /* CONFIG_SYS_PM_POLICY */
+
 #endif /* CONFIG_SYS_POWER_MANAGEMENT */
 
 #ifdef __cplusplus
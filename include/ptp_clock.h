@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Public API for PTP clock drivers
+ *
+ * A PTP clock is the hardware clock an Ethernet controller timestamps
+ * packets with. A synchronization protocol such as PTP or gPTP steers it,
+ * and the driver of the controller gives access to it through
+ * net_eth_get_ptp_clock().
+ */
+
+#ifndef __PTP_CLOCK_H
+#define __PTP_CLOCK_H
+
+#include <device.h>
+#include <net/ptp_time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief PTP clock Interface
+ * @defgroup ptp_clock_interface PTP clock Interface
+ * @ingroup io_interfaces
+ * @{
+ */
+
+/** @cond INTERNAL_HIDDEN */
+struct ptp_clock_driver_api {
+	int (*set)(struct device *dev, const struct net_ptp_time *tm);
+	int (*get)(struct device *dev, struct net_ptp_time *tm);
+	int (*adjust)(struct device *dev, s32_t increment);
+	int (*rate_adjust)(struct device *dev, s32_t ppb);
+};
+/** @endcond */
+
+/**
+ * @brief Set the time of the PTP clock.
+ *
+ * @param dev PTP clock device
+ * @param tm Time to set
+ *
+ * @return 0 if ok, <0 if error
+ */
+static inline int ptp_clock_set(struct device *dev,
+				const struct net_ptp_time *tm)
+{
+	const struct ptp_clock_driver_api *api = dev->driver_api;
+
+	return api->set(dev, tm);
+}
+
+/**
+ * @brief Get the time of the PTP clock.
+ *
+ * @param dev PTP clock device
+ * @param tm Where to store the current time
+ *
+ * @return 0 if ok, <0 if error
+ */
+static inline int ptp_clock_get(struct device *dev, struct net_ptp_time *tm)
+{
+	const struct ptp_clock_driver_api *api = dev->driver_api;
+
+	return api->get(dev, tm);
+}
+
+/**
+ * @brief Step the time of the PTP clock.
+ *
+ * @param dev PTP clock device
+ * @param increment Nanoseconds to add to the time, may be negative
+ *
+ * @return 0 if ok, <0 if error
+ */
+static inline int ptp_clock_adjust(struct device *dev, s32_t increment)
+{
+	const struct ptp_clock_driver_api *api = dev->driver_api;
+
+	return api->adjust(dev, increment);
+}
+
+/**
+ * @brief Set the rate of the PTP clock.
+ *
+ * The rate is relative to the nominal frequency of the clock, it replaces
+ * the one set before.
+ *
+ * @param dev PTP clock device
+ * @param ppb Frequency offset in parts per billion, positive to speed the
+ *        clock up
+ *
+ * @retval 0 If successful.
+ * @retval -ERANGE If the offset is beyond what the hardware can correct.
+ */
+static inline int ptp_clock_rate_adjust(struct device *dev, s32_t ppb)
+{
+	const struct ptp_clock_driver_api *api = dev->driver_api;
+
+	return api->rate_adjust(dev, ppb);
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PTP_CLOCK_H */
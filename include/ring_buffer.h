@@ -12,6 +12,7 @@
 
 #include <kernel.h>
 #include <misc/util.h>
+#include <atomic.h>
 #include <errno.h>
 
 #ifdef __cplusplus
@@ -200,6 +201,177 @@ int sys_ring_buf_put(struct ring_buf *buf, u16_t type, u8_t value,
 int sys_ring_buf_get(struct ring_buf *buf, u16_t *type, u8_t *value,
 		     u32_t *data, u8_t *size32);
 
+/**
+ * @brief A structure to represent a byte ring buffer
+ *
+ * A byte ring buffer has a single producer and a single consumer, which
+ * can run concurrently without any locking, for instance a thread and an
+ * interrupt handler. The indexes run freely and are reduced modulo the
+ * size, which must be a power of 2, when accessing the buffer.
+ */
+struct ring_buf_bytes {
+	atomic_t head;	/**< Read index, only written by the consumer */
+	atomic_t tail;	/**< Write index, only written by the producer */
+	u32_t mask;	/**< Size of buf minus 1 */
+	u8_t *buf;	/**< Memory region for stored bytes */
+};
+
+/**
+ * @brief Statically define and initialize a byte ring buffer.
+ *
+ * The ring buffer holds 2^pow bytes.
+ *
+ * @param name Name of the ring buffer.
+ * @param pow Ring buffer size exponent.
+ */
+#define SYS_RING_BUF_BYTES_DECLARE_POW2(name, pow) \
+	static u8_t _ring_buffer_data_##name[1 << (pow)]; \
+	struct ring_buf_bytes name = { \
+		.mask = (1 << (pow)) - 1, \
+		.buf = _ring_buffer_data_##name \
+	}
+
+/**
+ * @brief Initialize a byte ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Ring buffer size in bytes, a power of 2.
+ * @param data Ring buffer data area.
+ */
+static inline void sys_ring_buf_bytes_init(struct ring_buf_bytes *buf,
+					   u32_t size, u8_t *data)
+{
+	__ASSERT(is_power_of_two(size), "size must be a power of 2");
+
+	atomic_set(&buf->head, 0);
+	atomic_set(&buf->tail, 0);
+	buf->mask = size - 1;
+	buf->buf = data;
+}
+
+/**
+ * @brief Get the number of bytes stored in a byte ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Number of bytes which can be read.
+ */
+static inline u32_t sys_ring_buf_bytes_used_get(struct ring_buf_bytes *buf)
+{
+	return (u32_t)atomic_get(&buf->tail) - (u32_t)atomic_get(&buf->head);
+}
+
+/**
+ * @brief Get the free space of a byte ring buffer.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return Number of bytes which can be written.
+ */
+static inline u32_t sys_ring_buf_bytes_space_get(struct ring_buf_bytes *buf)
+{
+	return buf->mask + 1 - sys_ring_buf_bytes_used_get(buf);
+}
+
+/**
+ * @brief Determine if a byte ring buffer is empty.
+ *
+ * @param buf Address of ring buffer.
+ *
+ * @return 1 if the ring buffer is empty, or 0 if not.
+ */
+static inline int sys_ring_buf_bytes_is_empty(struct ring_buf_bytes *buf)
+{
+	return sys_ring_buf_bytes_used_get(buf) == 0;
+}
+
+/**
+ * @brief Claim contiguous space of a byte ring buffer for writing.
+ *
+ * The space is made available to the consumer by
+ * sys_ring_buf_bytes_put_finish(), which allows filling the buffer in
+ * place, for instance by DMA. Less space than requested is returned when
+ * the buffer is too full or the free space wraps around the end of the
+ * buffer. Only the producer may call this function.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Set to the start of the claimed space.
+ * @param size Number of bytes requested.
+ *
+ * @return Number of bytes claimed, possibly 0.
+ */
+u32_t sys_ring_buf_bytes_put_claim(struct ring_buf_bytes *buf, u8_t **data,
+				   u32_t size);
+
+/**
+ * @brief Make written bytes available to the consumer.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Number of bytes written, at most the space claimed.
+ *
+ * @retval 0 Bytes were committed.
+ * @retval -EINVAL @a size exceeds the free space of the ring buffer.
+ */
+int sys_ring_buf_bytes_put_finish(struct ring_buf_bytes *buf, u32_t size);
+
+/**
+ * @brief Write bytes to a byte ring buffer.
+ *
+ * Only the producer may call this function.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Bytes to write.
+ * @param size Number of bytes to write.
+ *
+ * @return Number of bytes written, less than @a size if the ring buffer
+ *         is full.
+ */
+u32_t sys_ring_buf_bytes_put(struct ring_buf_bytes *buf, const u8_t *data,
+			     u32_t size);
+
+/**
+ * @brief Claim contiguous stored bytes of a byte ring buffer for reading.
+ *
+ * The bytes are read in place, for instance by DMA, and released by
+ * sys_ring_buf_bytes_get_finish(). Less bytes than requested are returned
+ * when fewer are stored or the stored bytes wrap around the end of the
+ * buffer. Only the consumer may call this function.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Set to the first claimed byte.
+ * @param size Number of bytes requested.
+ *
+ * @return Number of bytes claimed, possibly 0.
+ */
+u32_t sys_ring_buf_bytes_get_claim(struct ring_buf_bytes *buf, u8_t **data,
+				   u32_t size);
+
+/**
+ * @brief Release read bytes to the producer.
+ *
+ * @param buf Address of ring buffer.
+ * @param size Number of bytes read, at most the bytes claimed.
+ *
+ * @retval 0 Bytes were released.
+ * @retval -EINVAL @a size exceeds the bytes stored in the ring buffer.
+ */
+int sys_ring_buf_bytes_get_finish(struct ring_buf_bytes *buf, u32_t size);
+
+/**
+ * @brief Read bytes from a byte ring buffer.
+ *
+ * Only the consumer may call this function.
+ *
+ * @param buf Address of ring buffer.
+ * @param data Area to store the bytes.
+ * @param size Size of the area.
+ *
+ * @return Number of bytes read, less than @a size if the ring buffer
+ *         holds fewer bytes.
+ */
+u32_t sys_ring_buf_bytes_get(struct ring_buf_bytes *buf, u8_t *data,
+			     u32_t size);
+
 /**
  * @}
  */
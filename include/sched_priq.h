@@ -9,6 +9,7 @@
 #include <misc/util.h>
 #include <misc/dlist.h>
 #include <misc/rb.h>
+#include <zephyr/types.h>
 
 /* Two abstractions are defined here for "thread priority queues".
  *
@@ -25,8 +26,14 @@
  * much better O(logN) scaling in the presence of large number of
  * threads.
  *
- * Each can be used for either the wait_q or system ready queue,
- * configurable at build time.
+ * A third "multiqueue" implementation keeps one list per priority
+ * level plus a bitmap of the non-empty levels, making add, remove and
+ * best all O(1) at the cost of a list head per priority.  Threads
+ * within a level are strictly FIFO, so it cannot take deadlines into
+ * account, and it is only available for the ready queue.
+ *
+ * Each of the first two can be used for either the wait_q or system
+ * ready queue, configurable at build time.
  */
 
 struct k_thread;
@@ -44,4 +51,18 @@ void _priq_rb_add(struct _priq_rb *pq, struct k_thread *thread);
 void _priq_rb_remove(struct _priq_rb *pq, struct k_thread *thread);
 struct k_thread *_priq_rb_best(struct _priq_rb *pq);
 
+#define _PRIQ_MQ_NUM_QUEUES (CONFIG_NUM_COOP_PRIORITIES +	\
+			     CONFIG_NUM_PREEMPT_PRIORITIES + 1)
+#define _PRIQ_MQ_NUM_WORDS ((_PRIQ_MQ_NUM_QUEUES + 31) / 32)
+
+struct _priq_mq {
+	sys_dlist_t queues[_PRIQ_MQ_NUM_QUEUES];
+	u32_t bitmask[_PRIQ_MQ_NUM_WORDS];
+};
+
+void _priq_mq_init(struct _priq_mq *pq);
+void _priq_mq_add(struct _priq_mq *pq, struct k_thread *thread);
+void _priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread);
+struct k_thread *_priq_mq_best(struct _priq_mq *pq);
+
 #endif /* _sched_priq__h_ */
@@ -182,6 +182,12 @@ enum sensor_trigger_type {
 
 	/** Trigger fires when a double tap is detected. */
 	SENSOR_TRIG_DOUBLE_TAP,
+
+	/**
+	 * Trigger fires when the sensor FIFO reaches its watermark, the
+	 * samples can then be read with @ref sensor_fifo_read.
+	 */
+	SENSOR_TRIG_FIFO_WATERMARK,
 };
 
 /**
@@ -277,11 +283,51 @@ typedef int (*sensor_channel_get_t)(struct device *dev,
 				    enum sensor_channel chan,
 				    struct sensor_value *val);
 
+/** @brief Maximum number of values in a sample read from a FIFO */
+#define SENSOR_FIFO_MAX_VALUES 6
+
+/**
+ * @brief Samples read from a sensor FIFO.
+ *
+ * The caller provides the buffer, the driver fills it with raw samples and
+ * the description needed to convert them, so that they can be decoded
+ * later, or elsewhere, with @ref sensor_fifo_value_get.
+ */
+struct sensor_fifo {
+	/** Buffer for raw values, filled sample by sample */
+	s16_t *buf;
+	/** Capacity of buf in samples */
+	u16_t max_samples;
+
+	/** Number of samples read */
+	u16_t count;
+	/** Number of values per sample */
+	u8_t num_values;
+	/** Channel of each value of a sample */
+	enum sensor_channel chan[SENSOR_FIFO_MAX_VALUES];
+	/** Scale of each value of a sample, in nano units per LSB */
+	s32_t scale[SENSOR_FIFO_MAX_VALUES];
+	/** Time of the last sample read, in hardware cycles */
+	u32_t timestamp;
+	/** Time between two samples, in hardware cycles */
+	u32_t period;
+};
+
+/**
+ * @typedef sensor_fifo_read_t
+ * @brief Callback API for reading samples from a sensor FIFO
+ *
+ * See sensor_fifo_read() for argument description
+ */
+typedef int (*sensor_fifo_read_t)(struct device *dev,
+				  struct sensor_fifo *fifo);
+
 struct sensor_driver_api {
 	sensor_attr_set_t attr_set;
 	sensor_trigger_set_t trigger_set;
 	sensor_sample_fetch_t sample_fetch;
 	sensor_channel_get_t channel_get;
+	sensor_fifo_read_t fifo_read;
 };
 
 /**
@@ -434,6 +480,68 @@ static inline int _impl_sensor_channel_get(struct device *dev,
 	return api->channel_get(dev, chan, val);
 }
 
+/**
+ * @brief Read the samples stored in the FIFO of a sensor
+ *
+ * Drains up to fifo->max_samples samples from the hardware FIFO with as
+ * few bus transfers as possible, typically from the handler of a
+ * @ref SENSOR_TRIG_FIFO_WATERMARK trigger. The samples are stored raw,
+ * oldest first.
+ *
+ * This API is not permitted for user threads.
+ *
+ * @param dev Pointer to the sensor device
+ * @param fifo Buffer and description of the samples read
+ *
+ * @return 0 if successful, -ENOTSUP if the sensor has no FIFO, negative
+ * errno code otherwise.
+ */
+static inline int sensor_fifo_read(struct device *dev,
+				   struct sensor_fifo *fifo)
+{
+	const struct sensor_driver_api *api = dev->driver_api;
+
+	if (!api->fifo_read) {
+		return -ENOTSUP;
+	}
+
+	return api->fifo_read(dev, fifo);
+}
+
+/**
+ * @brief Convert a value of a sample read from a FIFO
+ *
+ * @param fifo Samples read with @ref sensor_fifo_read
+ * @param sample Index of the sample, 0 is the oldest
+ * @param idx Index of the value in the sample, see fifo->chan
+ * @param val Converted value
+ */
+static inline void sensor_fifo_value_get(const struct sensor_fifo *fifo,
+					 u16_t sample, u8_t idx,
+					 struct sensor_value *val)
+{
+	s64_t micro;
+
+	micro = (s64_t)fifo->buf[sample * fifo->num_values + idx] *
+		fifo->scale[idx] / 1000;
+	val->val1 = micro / 1000000;
+	val->val2 = micro % 1000000;
+}
+
+/**
+ * @brief Get the time of a sample read from a FIFO
+ *
+ * @param fifo Samples read with @ref sensor_fifo_read
+ * @param sample Index of the sample, 0 is the oldest
+ *
+ * @return Time of the sample in hardware cycles, see k_cycle_get_32().
+ */
+static inline u32_t sensor_fifo_sample_time(const struct sensor_fifo *fifo,
+					    u16_t sample)
+{
+	return fifo->timestamp - (fifo->count - 1 - sample) * fifo->period;
+}
+
 /**
  * @brief The value of gravitational constant in micro m/s^2.
  */
@@ -516,6 +624,68 @@ static inline double sensor_value_to_double(struct sensor_value *val)
 	return (double)val->val1 + (double)val->val2 / 1000000;
 }
 
+/**
+ * @brief Fixed-point sensor value.
+ *
+ * The value is q / 2^(31 - shift), i.e. shift is the number of integer bits
+ * of the format, chosen by the user for the range of the channel. For
+ * instance a shift of 8 covers +/-256 m/s^2 with a resolution of about
+ * 0.12 micro m/s^2. A Q15 value is the upper half of the Q31 one.
+ */
+typedef s32_t sensor_q31_t;
+
+/**
+ * @brief Convert a struct sensor_value to fixed point.
+ *
+ * @param val Value to convert.
+ * @param shift Integer bits of the result, 0 to 31.
+ * @return The converted value, saturated to the range of the format.
+ */
+static inline sensor_q31_t sensor_value_to_q31(const struct sensor_value *val,
+					       s8_t shift)
+{
+	s64_t one = (s64_t)1 << (31 - shift);
+	s64_t q = val->val1 * one + (val->val2 * one) / 1000000;
+
+	if (q > INT32_MAX) {
+		return INT32_MAX;
+	} else if (q < INT32_MIN) {
+		return INT32_MIN;
+	}
+
+	return q;
+}
+
+/**
+ * @brief Convert a fixed-point value to a struct sensor_value.
+ *
+ * @param q Value to convert.
+ * @param shift Integer bits of q, 0 to 31.
+ * @param val Converted value.
+ */
+static inline void sensor_q31_to_value(sensor_q31_t q, s8_t shift,
+				       struct sensor_value *val)
+{
+	s64_t micro = ((s64_t)q * 1000000) >> (31 - shift);
+
+	val->val1 = micro / 1000000;
+	val->val2 = micro % 1000000;
+}
+
+/**
+ * @brief Convert one value of all samples read from a FIFO to fixed point.
+ *
+ * The scale of the value is turned into a multiplier once for the batch,
+ * every sample then costs a multiplication and a shift, no division.
+ *
+ * @param fifo Samples read with @ref sensor_fifo_read
+ * @param idx Index of the value in a sample, see fifo->chan
+ * @param shift Integer bits of the results, 0 to 31.
+ * @param out Array of fifo->count results.
+ */
+void sensor_fifo_get_q31(const struct sensor_fifo *fifo, u8_t idx,
+			 s8_t shift, sensor_q31_t *out);
+
 #include <syscalls/sensor.h>
 
 #ifdef __cplusplus
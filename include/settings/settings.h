@@ -134,6 +134,32 @@ int settings_register(struct settings_handler *cf);
  */
 int settings_load(void);
 
+/**
+ * Load serialized items of a single subtree from registered persistence
+ * sources, the handlers of other subtrees are not called. Once loaded, the
+ * subtree is committed. This allows a subsystem to load its items on first
+ * use instead of at startup.
+ *
+ * @param subtree Name of the subtree to load, e.g. "bt" or "bt/mesh".
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int settings_load_subtree(const char *subtree);
+
+/**
+ * Load a single serialized item from registered persistence sources and
+ * hand it to its handler. Sources which can look up an item directly do so
+ * instead of walking all of their contents.
+ *
+ * The item is not committed.
+ *
+ * @param name Name/key of the settings item.
+ *
+ * @return 0 on success, -ENOENT if the item is not stored, other non-zero
+ * value on failure.
+ */
+int settings_load_one(const char *name);
+
 /**
  * Save currently running serialized items. All serialized items which are different
  * from currently persisted values will be saved.
@@ -72,7 +72,7 @@ typedef int (*shell_mcumgr_function_t)(const char *line, void *arg);
  * @details This macro defines a shell_module object that is automatically
  * configured by the kernel during system initialization.
  *
- * @param _name Module name to be entered in shell console.
+ * @param _name Module name to be entered in shell console, a string literal.
  * @param _commands Array of commands to register.
  * Shell array entries must be packed to calculate array size correctly.
  */
@@ -87,7 +87,7 @@ typedef int (*shell_mcumgr_function_t)(const char *line, void *arg);
  * this also enables setting a custom prompt handler when the module is
  * selected.
  *
- * @param _name Module name to be entered in shell console.
+ * @param _name Module name to be entered in shell console, a string literal.
  * @param _commands Array of commands to register.
  * Shell array entries must be packed to calculate array size correctly.
  * @param _prompt Optional prompt handler to be set when module is selected.
@@ -106,6 +106,8 @@ typedef int (*shell_mcumgr_function_t)(const char *line, void *arg);
  * The command will be available in the default module, so it will be available
  * immediately.
  *
+ * The name of the command must be a string literal, it is part of the name
+ * of the linker section, which keeps the commands sorted.
  */
 #ifdef CONFIG_CONSOLE_SHELL
 #define SHELL_REGISTER(_name, _commands) \
@@ -114,7 +116,7 @@ typedef int (*shell_mcumgr_function_t)(const char *line, void *arg);
 #define SHELL_REGISTER_WITH_PROMPT(_name, _commands, _prompt) \
 	\
 	static struct shell_module (__shell__name) __used \
-	__attribute__((__section__(".shell_module_"))) = { \
+	__attribute__((__section__(".shell_module_" _name))) = { \
 		  .module_name = _name, \
 		  .commands = _commands, \
 		  .prompt = _prompt \
@@ -123,7 +125,7 @@ typedef int (*shell_mcumgr_function_t)(const char *line, void *arg);
 #define SHELL_REGISTER_COMMAND(name, callback, _help) \
 	\
 	const struct shell_cmd (__shell__##name) __used \
-	__attribute__((__section__(".shell_cmd_"))) = { \
+	__attribute__((__section__(".shell_cmd_" name))) = { \
 		  .cmd_name = name, \
 		  .cb = callback, \
 		  .help = _help \
@@ -7,6 +7,8 @@
 #define _SPINLOCK_H
 
 #include <atomic.h>
+#include <toolchain.h>
+#include <zephyr/types.h>
 
 struct k_spinlock_key {
 	int key;
@@ -20,6 +22,17 @@ struct k_spinlock {
 #ifdef CONFIG_DEBUG
 	int saved_key;
 #endif
+#ifdef CONFIG_SPINLOCK_STATS
+	/* Number of acquisitions that found the lock already held */
+	u32_t contended;
+#endif
+#endif
+
+#if defined(CONFIG_CPLUSPLUS) && !defined(CONFIG_SMP)
+	/* Make sure k_spinlock has the same (nonzero) size in C as in
+	 * C++, since it is embedded in kernel objects shared by both.
+	 */
+	char dummy;
 #endif
 };
 
@@ -34,11 +47,19 @@ static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 	k.key = _arch_irq_lock();
 
 #ifdef CONFIG_SMP
+# ifdef CONFIG_SPINLOCK_STATS
+	if (!atomic_cas(&l->locked, 0, 1)) {
+		l->contended++;
+		while (!atomic_cas(&l->locked, 0, 1)) {
+		}
+	}
+# else
+	while (!atomic_cas(&l->locked, 0, 1)) {
+	}
+# endif
 # ifdef CONFIG_DEBUG
 	l->saved_key = k.key;
 # endif
-	while (!atomic_cas(&l->locked, 0, 1)) {
-	}
 #endif
 
 	return k;
@@ -66,4 +87,33 @@ static inline void k_spin_unlock(struct k_spinlock *l, k_spinlock_key_t key)
 	_arch_irq_unlock(key.key);
 }
 
+/* Releases the lock without restoring the interrupt state saved in
+ * the key, for use by code (i.e. context switch) that will unlock
+ * interrupts itself later.
+ */
+static inline void k_spin_release(struct k_spinlock *l)
+{
+#ifdef CONFIG_SMP
+	atomic_clear(&l->locked);
+#else
+	ARG_UNUSED(l);
+#endif
+}
+
+#ifdef CONFIG_SPINLOCK_STATS
+/**
+ * @brief Number of times a spinlock was found held when acquired
+ *
+ * The counter is only updated while the lock is held and is never
+ * reset, so it can be sampled periodically to find hot locks.
+ *
+ * @param l Spinlock to query
+ * @return Contended acquisition count
+ */
+static inline u32_t k_spin_contention_get(struct k_spinlock *l)
+{
+	return l->contended;
+}
+#endif
+
 #endif /* _SPINLOCK_H */
@@ -36,6 +36,15 @@
  *
  * - STATS_SECT_ENTRY64(): 64-bits.  Useful for storing chunks of data.
  *
+ * - STATS_SECT_HIST(): a histogram of 32-bit buckets, updated with
+ *   STATS_HIST_ADD().  Bucket 0 counts the zero values, bucket i the values
+ *   from 2^(i-1) to 2^i - 1, the last bucket also counts all larger values.
+ *   Only valid in groups of 32-bit entries.
+ *
+ * Updates are safe against concurrent updates from threads and interrupts:
+ * 32-bit entries are updated with atomic operations, the others with
+ * interrupts locked.
+ *
  * Following the static entry declaration is the statistic names declaration.
  * This is compiled out when the CONFIGURE_STATS_NAME setting is undefined.
  *
@@ -53,6 +62,9 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <zephyr/types.h>
+#include <atomic.h>
+#include <irq.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +73,8 @@ extern "C" {
 struct stats_name_map {
 	u16_t snm_off;
 	const char *snm_name;
+	/* number of entries sharing the name, more than one for histograms */
+	u8_t snm_cnt;
 } __packed;
 
 struct stats_hdr {
@@ -130,6 +144,39 @@ struct stats_hdr {
  */
 #define STATS_SECT_ENTRY64(var__) u64_t var__;
 
+/**
+ * @brief Declares a histogram of 32-bit buckets inside a group struct.
+ *
+ * @param var__                 The name to assign to the histogram.
+ * @param n__                   The number of buckets.
+ */
+#define STATS_SECT_HIST(var__, n__) u32_t var__[n__];
+
+static inline void stats_incn(void *entry, size_t size, u32_t n)
+{
+	unsigned int key;
+
+	if (size == sizeof(atomic_t)) {
+		atomic_add(entry, n);
+		return;
+	}
+
+	key = irq_lock();
+	if (size == sizeof(u16_t)) {
+		*(u16_t *)entry += n;
+	} else {
+		*(u64_t *)entry += n;
+	}
+	irq_unlock(key);
+}
+
+static inline unsigned int stats_hist_bucket(u32_t value, unsigned int n)
+{
+	unsigned int bucket = value ? 32 - __builtin_clz(value) : 0;
+
+	return (bucket < n) ? bucket : n - 1;
+}
+
 /**
  * @brief Increases a statistic entry by the specified amount.
  *
@@ -140,8 +187,8 @@ struct stats_hdr {
  * @param var__                 The statistic entry to increase.
  * @param n__                   The amount to increase the statistic entry by.
  */
-#define STATS_INCN(group__, var__, n__)	\
-	((group__).var__ += (n__))
+#define STATS_INCN(group__, var__, n__)				\
+	stats_incn(&(group__).var__, sizeof((group__).var__), (n__))
 
 /**
  * @brief Increments a statistic entry.
@@ -167,6 +214,21 @@ struct stats_hdr {
 #define STATS_CLEAR(group__, var__) \
 	((group__).var__ = 0)
 
+/**
+ * @brief Adds a value to a histogram.
+ *
+ * Increments the bucket of the value.  Compiled out if CONFIG_STATS is not
+ * defined.
+ *
+ * @param group__               The group containing the histogram.
+ * @param var__                 The histogram.
+ * @param value__               The value to account for.
+ */
+#define STATS_HIST_ADD(group__, var__, value__)				\
+	stats_incn(&(group__).var__[stats_hist_bucket((value__),	\
+		   sizeof((group__).var__) / sizeof(u32_t))],		\
+		   sizeof(u32_t), 1)
+
 #define STATS_SIZE_16 (sizeof(u16_t))
 #define STATS_SIZE_32 (sizeof(u32_t))
 #define STATS_SIZE_64 (sizeof(u64_t))
@@ -336,6 +398,41 @@ struct stats_hdr *stats_group_get_next(const struct stats_hdr *cur);
  */
 struct stats_hdr *stats_group_find(const char *name);
 
+/**
+ * @brief Reads a statistic entry.
+ *
+ * @param hdr                   The group containing the entry.
+ * @param off                   The offset of the entry, from `hdr`, as passed
+ *                                  to a stats_walk_fn.
+ *
+ * @return                      The value of the entry.
+ */
+u64_t stats_value_get(const struct stats_hdr *hdr, u16_t off);
+
+/**
+ * @brief Takes a binary snapshot of statistics groups.
+ *
+ * The snapshot is a sequence of group records, integers in little endian:
+ *
+ * - u8 length of the group name, followed by the name
+ * - u8 size of the entries, in bytes
+ * - u8 number of entries
+ * - the entries, in the order they are declared in
+ *
+ * Entry names are not part of the snapshot, they are the same for all
+ * devices running the same image and can be read once with stats_walk().
+ *
+ * @param name                  The name of the group to take, or NULL to take
+ *                                  all the registered groups.
+ * @param buf                   The buffer to write the snapshot into.
+ * @param len                   The size of the buffer.
+ *
+ * @return                      The length of the snapshot on success;
+ *                              -ENOENT if there is no such group;
+ *                              -ENOMEM if the buffer is too small.
+ */
+int stats_snapshot(const char *name, u8_t *buf, size_t len);
+
 #else /* CONFIG_STATS */
 
 #define STATS_SECT_START(group__) \
@@ -345,11 +442,13 @@ struct stats_hdr *stats_group_find(const char *name);
 #define STATS_SECT_ENTRY16(var__)
 #define STATS_SECT_ENTRY32(var__)
 #define STATS_SECT_ENTRY64(var__)
+#define STATS_SECT_HIST(var__, n__)
 #define STATS_RESET(var__)
 #define STATS_SIZE_INIT_PARMS(group__, size__)
 #define STATS_INCN(group__, var__, n__)
 #define STATS_INC(group__, var__)
 #define STATS_CLEAR(group__, var__)
+#define STATS_HIST_ADD(group__, var__, value__)
 #define STATS_INIT_AND_REG(group__, size__, name__) (0)
 
 #endif /* !CONFIG_STATS */
@@ -362,7 +461,12 @@ struct stats_hdr *stats_group_find(const char *name);
 	const struct stats_name_map STATS_NAME_MAP_NAME(sectname__)[] = {
 
 #define STATS_NAME(sectname__, entry__)	\
-	{ offsetof(STATS_SECT_DECL(sectname__), entry__), #entry__ },
+	{ offsetof(STATS_SECT_DECL(sectname__), entry__), #entry__, 1 },
+
+/* The buckets are named <histogram>.<bucket> */
+#define STATS_NAME_HIST(sectname__, entry__)				  \
+	{ offsetof(STATS_SECT_DECL(sectname__), entry__), #entry__,	  \
+	  sizeof(((STATS_SECT_DECL(sectname__) *)0)->entry__) / sizeof(u32_t) },
 
 #define STATS_NAME_END(sectname__) }
 
@@ -374,6 +478,7 @@ struct stats_hdr *stats_group_find(const char *name);
 
 #define STATS_NAME_START(name__)
 #define STATS_NAME(name__, entry__)
+#define STATS_NAME_HIST(name__, entry__)
 #define STATS_NAME_END(name__)
 #define STATS_NAME_INIT_PARMS(name__) NULL, 0
 
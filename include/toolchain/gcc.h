@@ -135,6 +135,17 @@ do {                                                                    \
 #endif
 #define __used		__attribute__((__used__))
 #define __deprecated	__attribute__((deprecated))
+
+/*
+ * Place a function in RAM, it is copied there at boot along with the
+ * initialized data. Long calls reach it wherever the code calling it is.
+ */
+#if defined(CONFIG_ARCH_HAS_RAMFUNC_SUPPORT)
+#define __ramfunc	__attribute__((noinline)) \
+			__attribute__((long_call, section(".ramfunc")))
+#else
+#define __ramfunc
+#endif
 #define ARG_UNUSED(x) (void)(x)
 
 #define likely(x)   __builtin_expect((long)!!(x), 1L)
@@ -72,6 +72,103 @@ extern "C" {
  */
 typedef void (*uart_irq_callback_t)(struct device *port);
 
+#ifdef CONFIG_UART_ASYNC_API
+
+/** @brief Types of events passed to the asynchronous API callback. */
+enum uart_event_type {
+	/** @brief The whole TX buffer was sent. */
+	UART_TX_DONE,
+	/**
+	 * @brief Transmission was aborted by uart_tx_abort() or by its
+	 * timeout, uart_event::data::tx::len holds the number of bytes sent.
+	 */
+	UART_TX_ABORTED,
+	/**
+	 * @brief Data was received into the RX buffer.
+	 *
+	 * Reported when the buffer is full, when no data arrived for the RX
+	 * timeout and when RX is disabled. The data is at
+	 * uart_event::data::rx::buf + uart_event::data::rx::offset.
+	 */
+	UART_RX_RDY,
+	/**
+	 * @brief The driver asks for the next RX buffer.
+	 *
+	 * It is provided with uart_rx_buf_rsp(). Without a next buffer,
+	 * reception stops once the current buffer is full.
+	 */
+	UART_RX_BUF_REQUEST,
+	/** @brief The driver does not use the RX buffer anymore. */
+	UART_RX_BUF_RELEASED,
+	/** @brief Reception stopped, all RX buffers were released. */
+	UART_RX_DISABLED,
+	/**
+	 * @brief Reception stopped on a line error.
+	 *
+	 * Followed by the release of the buffers and UART_RX_DISABLED.
+	 */
+	UART_RX_STOPPED,
+};
+
+/** @brief UART TX event data. */
+struct uart_event_tx {
+	/** @brief The buffer passed to uart_tx(). */
+	const u8_t *buf;
+	/** @brief Number of bytes sent. */
+	size_t len;
+};
+
+/** @brief UART RX event data. */
+struct uart_event_rx {
+	/** @brief The RX buffer. */
+	u8_t *buf;
+	/** @brief Offset of the new data in the buffer. */
+	size_t offset;
+	/** @brief Number of new bytes. */
+	size_t len;
+};
+
+/** @brief UART RX buffer event data. */
+struct uart_event_rx_buf {
+	/** @brief The released buffer. */
+	u8_t *buf;
+};
+
+/** @brief UART RX stopped event data. */
+struct uart_event_rx_stop {
+	/** @brief UART_ERROR_* flags of the error. */
+	int reason;
+	/** @brief Data received before the error. */
+	struct uart_event_rx data;
+};
+
+/** @brief Structure passed to the asynchronous API callback. */
+struct uart_event {
+	/** @brief Type of the event. */
+	enum uart_event_type type;
+	/** @brief Event data, depending on the type. */
+	union {
+		struct uart_event_tx tx;
+		struct uart_event_rx rx;
+		struct uart_event_rx_buf rx_buf;
+		struct uart_event_rx_stop rx_stop;
+	} data;
+};
+
+/**
+ * @typedef uart_callback_t
+ * @brief Define the application callback function signature for the
+ * asynchronous API.
+ *
+ * Called from interrupt context.
+ *
+ * @param evt The event.
+ * @param user_data Pointer passed to uart_callback_set().
+ */
+typedef void (*uart_callback_t)(struct uart_event *evt, void *user_data);
+
+#endif /* CONFIG_UART_ASYNC_API */
+
 /**
  * @typedef uart_irq_config_func_t
  * @brief For configuring IRQ on each individual UART device.
@@ -115,6 +212,18 @@ struct uart_driver_api {
 	/** Console I/O function */
 	int (*err_check)(struct device *dev);
 
+#ifdef CONFIG_UART_ASYNC_API
+	int (*callback_set)(struct device *dev, uart_callback_t callback,
+			    void *user_data);
+	int (*tx)(struct device *dev, const u8_t *buf, size_t len,
+		  s32_t timeout);
+	int (*tx_abort)(struct device *dev);
+	int (*rx_enable)(struct device *dev, u8_t *buf, size_t len,
+			 s32_t timeout);
+	int (*rx_buf_rsp)(struct device *dev, u8_t *buf, size_t len);
+	int (*rx_disable)(struct device *dev);
+#endif
+
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 
 	/** Interrupt driven FIFO fill function */
@@ -585,6 +694,166 @@ static inline void uart_irq_callback_set(struct device *dev,
 
 #endif
 
+#ifdef CONFIG_UART_ASYNC_API
+
+/**
+ * @brief Set the callback of the asynchronous API.
+ *
+ * @param dev UART device structure.
+ * @param callback Callback function.
+ * @param user_data Pointer passed to the callback.
+ *
+ * @retval 0 If successful.
+ * @retval -ENOTSUP If the driver does not support the asynchronous API.
+ */
+static inline int uart_callback_set(struct device *dev,
+				    uart_callback_t callback,
+				    void *user_data)
+{
+	const struct uart_driver_api *api =
+		(const struct uart_driver_api *)dev->driver_api;
+
+	if (api->callback_set == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->callback_set(dev, callback, user_data);
+}
+
+/**
+ * @brief Send a buffer.
+ *
+ * Returns at once, the end of the transmission is reported with
+ * UART_TX_DONE, or UART_TX_ABORTED. The buffer must stay valid until then.
+ *
+ * @param dev UART device structure.
+ * @param buf Data to send.
+ * @param len Number of bytes to send.
+ * @param timeout Time in milliseconds after which the transmission is
+ * aborted, K_FOREVER for none.
+ *
+ * @retval 0 If successful.
+ * @retval -EBUSY If a transmission is ongoing.
+ * @retval -ENOTSUP If the driver does not support the asynchronous API.
+ */
+static inline int uart_tx(struct device *dev, const u8_t *buf, size_t len,
+			  s32_t timeout)
+{
+	const struct uart_driver_api *api =
+		(const struct uart_driver_api *)dev->driver_api;
+
+	if (api->tx == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->tx(dev, buf, len, timeout);
+}
+
+/**
+ * @brief Abort the ongoing transmission.
+ *
+ * @param dev UART device structure.
+ *
+ * @retval 0 If successful, UART_TX_ABORTED is reported.
+ * @retval -EFAULT If there was no transmission.
+ * @retval -ENOTSUP If the driver does not support the asynchronous API.
+ */
+static inline int uart_tx_abort(struct device *dev)
+{
+	const struct uart_driver_api *api =
+		(const struct uart_driver_api *)dev->driver_api;
+
+	if (api->tx_abort == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->tx_abort(dev);
+}
+
+/**
+ * @brief Start receiving into a buffer.
+ *
+ * Received data is reported with UART_RX_RDY, when the buffer is full or
+ * when the line was idle for the timeout after the last byte. The driver
+ * asks for the next buffer with UART_RX_BUF_REQUEST, and swaps to it once
+ * the current one is full, so that reception is not interrupted.
+ *
+ * @param dev UART device structure.
+ * @param buf First RX buffer.
+ * @param len Size of the buffer.
+ * @param timeout Idle time in milliseconds after which the data received
+ * so far is reported, K_FOREVER to only report full buffers.
+ *
+ * @retval 0 If successful.
+ * @retval -EBUSY If reception is already enabled.
+ * @retval -ENOTSUP If the driver does not support the asynchronous API.
+ */
+static inline int uart_rx_enable(struct device *dev, u8_t *buf, size_t len,
+				 s32_t timeout)
+{
+	const struct uart_driver_api *api =
+		(const struct uart_driver_api *)dev->driver_api;
+
+	if (api->rx_enable == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->rx_enable(dev, buf, len, timeout);
+}
+
+/**
+ * @brief Provide the next RX buffer.
+ *
+ * To be called in response to UART_RX_BUF_REQUEST, it may be called from
+ * the callback.
+ *
+ * @param dev UART device structure.
+ * @param buf Next RX buffer.
+ * @param len Size of the buffer.
+ *
+ * @retval 0 If successful.
+ * @retval -EBUSY If the next buffer was already provided.
+ * @retval -EACCES If reception is disabled.
+ * @retval -ENOTSUP If the driver does not support the asynchronous API.
+ */
+static inline int uart_rx_buf_rsp(struct device *dev, u8_t *buf, size_t len)
+{
+	const struct uart_driver_api *api =
+		(const struct uart_driver_api *)dev->driver_api;
+
+	if (api->rx_buf_rsp == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->rx_buf_rsp(dev, buf, len);
+}
+
+/**
+ * @brief Stop receiving.
+ *
+ * The data received so far is reported, the buffers are released and
+ * UART_RX_DISABLED is reported.
+ *
+ * @param dev UART device structure.
+ *
+ * @retval 0 If successful.
+ * @retval -EFAULT If reception was not enabled.
+ * @retval -ENOTSUP If the driver does not support the asynchronous API.
+ */
+static inline int uart_rx_disable(struct device *dev)
+{
+	const struct uart_driver_api *api =
+		(const struct uart_driver_api *)dev->driver_api;
+
+	if (api->rx_disable == NULL) {
+		return -ENOTSUP;
+	}
+
+	return api->rx_disable(dev);
+}
+
+#endif /* CONFIG_UART_ASYNC_API */
+
 #ifdef CONFIG_UART_LINE_CTRL
 
 /**
@@ -360,6 +360,11 @@ void usb_transfer_ep_callback(u8_t ep, enum usb_dc_ep_cb_status_code);
  * and can be executed in IRQ context. The provided callback will be called
  * on transfer completion (or error) in thread context.
  *
+ * A transfer submitted while the endpoint is busy is queued, and started
+ * once the transfers submitted before it on that endpoint are complete.
+ * Queuing the next buffer before the current one completes keeps the
+ * endpoint busy between transfers.
+ *
  * @param[in]  ep           Endpoint address corresponding to the one
  *                          listed in the device configuration table
  * @param[in]  data         Pointer to data buffer to write-to/read-from
@@ -8,6 +8,7 @@
 #include <string.h>
 #include <device.h>
 #include <misc/util.h>
+#include <misc/printk.h>
 #include <atomic.h>
 
 extern struct device __device_init_start[];
@@ -32,6 +33,111 @@ extern u32_t __device_busy_end[];
 #define DEVICE_BUSY_SIZE (__device_busy_end - __device_busy_start)
 #endif
 
+#if defined(CONFIG_DEVICE_BINDING_HASH)
+#define BINDING_HASH_MASK (CONFIG_DEVICE_BINDING_HASH_SIZE - 1)
+
+BUILD_ASSERT_MSG((CONFIG_DEVICE_BINDING_HASH_SIZE &
+		  BINDING_HASH_MASK) == 0,
+		 "DEVICE_BINDING_HASH_SIZE must be a power of two");
+
+/* Open addressing with linear probing, entries are never removed */
+static struct device *binding_hash[CONFIG_DEVICE_BINDING_HASH_SIZE];
+
+/* FNV-1a */
+static u32_t binding_hash_name(const char *name)
+{
+	u32_t hash = 2166136261U;
+
+	while (*name) {
+		hash = (hash ^ (u8_t)*name++) * 16777619U;
+	}
+
+	return hash;
+}
+
+static void binding_hash_add(struct device *dev)
+{
+	u32_t i = binding_hash_name(dev->config->name);
+	int n;
+
+	for (n = 0; n < CONFIG_DEVICE_BINDING_HASH_SIZE; n++, i++) {
+		if (!binding_hash[i & BINDING_HASH_MASK]) {
+			binding_hash[i & BINDING_HASH_MASK] = dev;
+			return;
+		}
+	}
+}
+
+static struct device *binding_hash_find(const char *name)
+{
+	u32_t i = binding_hash_name(name);
+	struct device *dev;
+	int n;
+
+	for (n = 0; n < CONFIG_DEVICE_BINDING_HASH_SIZE; n++, i++) {
+		dev = binding_hash[i & BINDING_HASH_MASK];
+		if (!dev) {
+			break;
+		}
+
+		if (dev->config->name == name ||
+		    !strcmp(name, dev->config->name)) {
+			return dev;
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_DEVICE_BINDING_HASH */
+
+#if defined(CONFIG_BOOT_INIT_PROFILE)
+struct init_profile_entry {
+	struct device *dev;
+	u32_t start;
+	u32_t cycles;
+	u8_t level;
+};
+
+static struct init_profile_entry init_profile[CONFIG_BOOT_INIT_PROFILE_ENTRIES];
+static int init_profile_count;
+static int init_profile_dropped;
+
+static void init_profile_add(struct device *dev, int level, u32_t start)
+{
+	u32_t end = k_cycle_get_32();
+	struct init_profile_entry *entry;
+
+	if (init_profile_count == ARRAY_SIZE(init_profile)) {
+		init_profile_dropped++;
+		return;
+	}
+
+	entry = &init_profile[init_profile_count++];
+	entry->dev = dev;
+	entry->start = start;
+	entry->cycles = end - start;
+	entry->level = level;
+}
+
+void device_init_profile_print(void)
+{
+	struct init_profile_entry *entry;
+	int i;
+
+	printk("init profile: %d entries, %d dropped, %u cycles/s\n",
+	       init_profile_count, init_profile_dropped,
+	       (u32_t)sys_clock_hw_cycles_per_sec);
+
+	for (i = 0; i < init_profile_count; i++) {
+		entry = &init_profile[i];
+
+		printk("init: %u %p %u %u %s\n", entry->level,
+		       entry->dev->config->init, entry->start, entry->cycles,
+		       entry->dev->config->name);
+	}
+}
+#endif /* CONFIG_BOOT_INIT_PROFILE */
+
 /**
  * @brief Execute all the device initialization functions at a given level
  *
@@ -50,16 +156,154 @@ void _sys_device_do_config_level(int level)
 	for (info = config_levels[level]; info < config_levels[level+1];
 								info++) {
 		struct device_config *device = info->config;
+#if defined(CONFIG_BOOT_INIT_PROFILE)
+		u32_t start = k_cycle_get_32();
+#endif
 
 		device->init(info);
+#if defined(CONFIG_BOOT_INIT_PROFILE)
+		init_profile_add(info, level, start);
+#endif
 		_k_object_init(info);
+
+#if defined(CONFIG_DEVICE_BINDING_HASH)
+		if (info->driver_api) {
+			binding_hash_add(info);
+		}
+#endif
+	}
+}
+
+#if defined(CONFIG_DEVICE_INIT_DEFERRED)
+enum {
+	DEFERRED_QUEUED,
+	DEFERRED_RUNNING,
+	DEFERRED_DONE,
+};
+
+struct deferred_init {
+	void *fifo_reserved;
+	struct device *dev;
+	int (*init)(struct device *dev);
+	atomic_t state;
+	int result;
+	/* given once done, and given back by each waiter */
+	struct k_sem done;
+};
+
+static struct deferred_init deferred[CONFIG_DEVICE_INIT_DEFERRED_MAX];
+static int deferred_count;
+static K_FIFO_DEFINE(deferred_fifo);
+
+static K_THREAD_STACK_ARRAY_DEFINE(deferred_stacks,
+				   CONFIG_DEVICE_INIT_DEFERRED_THREADS,
+				   CONFIG_DEVICE_INIT_DEFERRED_STACK_SIZE);
+static struct k_thread deferred_threads[CONFIG_DEVICE_INIT_DEFERRED_THREADS];
+
+/* Run by whoever gets to it first, a thread or a waiter */
+static void deferred_run(struct deferred_init *d)
+{
+	if (!atomic_cas(&d->state, DEFERRED_QUEUED, DEFERRED_RUNNING)) {
+		return;
+	}
+
+	d->result = d->init(d->dev);
+	atomic_set(&d->state, DEFERRED_DONE);
+	k_sem_give(&d->done);
+}
+
+static void deferred_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		deferred_run(k_fifo_get(&deferred_fifo, K_FOREVER));
+	}
+}
+
+/* Called by the initialization thread before the POST_KERNEL level */
+void _sys_device_deferred_start(void)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_DEVICE_INIT_DEFERRED_THREADS; i++) {
+		k_thread_create(&deferred_threads[i], deferred_stacks[i],
+				K_THREAD_STACK_SIZEOF(deferred_stacks[i]),
+				deferred_thread, NULL, NULL, NULL,
+				CONFIG_DEVICE_INIT_DEFERRED_PRIORITY, 0,
+				K_NO_WAIT);
+	}
+}
+
+void device_init_defer(struct device *dev, int (*init)(struct device *dev))
+{
+	struct deferred_init *d = NULL;
+	unsigned int key;
+
+	key = irq_lock();
+
+	if (deferred_count < ARRAY_SIZE(deferred)) {
+		d = &deferred[deferred_count];
+		d->dev = dev;
+		d->init = init;
+		atomic_set(&d->state, DEFERRED_QUEUED);
+		k_sem_init(&d->done, 0, 1);
+		deferred_count++;
+	}
+
+	irq_unlock(key);
+
+	if (!d) {
+		init(dev);
+		return;
+	}
+
+	k_fifo_put(&deferred_fifo, d);
+}
+
+int device_init_wait(struct device *dev, s32_t timeout)
+{
+	struct deferred_init *d;
+	int i;
+
+	for (i = 0; i < deferred_count; i++) {
+		d = &deferred[i];
+		if (d->dev != dev) {
+			continue;
+		}
+
+		deferred_run(d);
+
+		if (k_sem_take(&d->done, timeout)) {
+			return -EAGAIN;
+		}
+
+		k_sem_give(&d->done);
+
+		return d->result;
 	}
+
+	return 0;
 }
+#endif /* CONFIG_DEVICE_INIT_DEFERRED */
 
 struct device *device_get_binding(const char *name)
 {
 	struct device *info;
 
+#if defined(CONFIG_DEVICE_BINDING_HASH)
+	info = binding_hash_find(name);
+	if (info) {
+		return info;
+	}
+
+	/* Devices which didn't fit or got their API after initialization
+	 * are only found by the search below.
+	 */
+#endif
+
 	/* Split the search into two loops: in the common scenario, where
 	 * device names are stored in ROM (and are referenced by the user
 	 * with CONFIG_* macros), only cheap pointer comparisons will be
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * @brief Futexes: waiting on an atomic variable of the caller's memory
+ *
+ * Waiting threads are kept in a small table of wait queues hashed by futex
+ * address, so that futexes need no kernel-side object and can live in user
+ * memory. Each waiting thread records the futex it waits on in its swap
+ * data, and a wake up only concerns the threads of the bucket waiting on
+ * that very futex.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <wait_q.h>
+#include <ksched.h>
+#include <init.h>
+#include <syscall_handler.h>
+
+#define NUM_BUCKETS CONFIG_FUTEX_HASH_BUCKETS
+
+BUILD_ASSERT_MSG((NUM_BUCKETS & (NUM_BUCKETS - 1)) == 0,
+		 "CONFIG_FUTEX_HASH_BUCKETS must be a power of 2");
+
+struct futex_bucket {
+	struct k_spinlock lock;
+	_wait_q_t wait_q;
+};
+
+static struct futex_bucket buckets[NUM_BUCKETS];
+
+static inline struct futex_bucket *bucket_of(atomic_t *futex)
+{
+	return &buckets[((uintptr_t)futex / sizeof(atomic_t)) &
+			(NUM_BUCKETS - 1)];
+}
+
+static int init_futex_module(struct device *dev)
+{
+	int i;
+
+	ARG_UNUSED(dev);
+
+	for (i = 0; i < NUM_BUCKETS; i++) {
+		_waitq_init(&buckets[i].wait_q);
+	}
+
+	return 0;
+}
+
+SYS_INIT(init_futex_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+
+int _impl_k_futex_wait(atomic_t *futex, atomic_val_t expected, s32_t timeout)
+{
+	struct futex_bucket *bucket = bucket_of(futex);
+	k_spinlock_key_t key = k_spin_lock(&bucket->lock);
+	int ret;
+
+	if (atomic_get(futex) != expected) {
+		k_spin_unlock(&bucket->lock, key);
+		return -EAGAIN;
+	}
+
+	if (timeout == K_NO_WAIT) {
+		k_spin_unlock(&bucket->lock, key);
+		return -ETIMEDOUT;
+	}
+
+	_current->base.swap_data = futex;
+
+	ret = _pend_curr_spinlock(&bucket->lock, key, &bucket->wait_q, timeout);
+
+	return ret == -EAGAIN ? -ETIMEDOUT : ret;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_futex_wait, futex, expected, timeout)
+{
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(futex, sizeof(atomic_t)));
+
+	return _impl_k_futex_wait((atomic_t *)futex, expected, timeout);
+}
+#endif
+
+int _impl_k_futex_wake(atomic_t *futex, int wake_all)
+{
+	struct futex_bucket *bucket = bucket_of(futex);
+	k_spinlock_key_t key = k_spin_lock(&bucket->lock);
+	struct k_thread *thread, *found;
+	int woken = 0;
+
+	do {
+		found = NULL;
+		_WAIT_Q_FOR_EACH(&bucket->wait_q, thread) {
+			if (thread->base.swap_data == futex) {
+				found = thread;
+				break;
+			}
+		}
+
+		if (!found) {
+			break;
+		}
+
+		_unpend_thread(found);
+		_ready_thread(found);
+		_set_thread_return_value(found, 0);
+		woken++;
+	} while (wake_all);
+
+	_reschedule_spinlock(&bucket->lock, key);
+
+	return woken;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_futex_wake, futex, wake_all)
+{
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(futex, sizeof(atomic_t)));
+
+	return _impl_k_futex_wake((atomic_t *)futex, wake_all);
+}
+#endif
@@ -191,6 +191,19 @@ extern void smp_init(void);
 
 extern void smp_timer_init(void);
 
+#ifdef CONFIG_SCHED_IPI_SUPPORTED
+/**
+ * @brief Interrupt other CPUs so that they reschedule
+ *
+ * Raises an interrupt on each CPU whose bit is set in cpu_mask.  The
+ * handler itself has nothing to do: the interrupt exit path of the
+ * target picks the best ready thread, as it does for any interrupt.
+ *
+ * @param cpu_mask Mask of the CPUs to interrupt, by CPU number
+ */
+extern void _arch_sched_ipi(u32_t cpu_mask);
+#endif
+
 #ifdef CONFIG_NEWLIB_LIBC
 /**
  * @brief Fetch dimentions of newlib heap area for _sbrk()
@@ -46,6 +46,11 @@ GEN_OFFSET_SYM(_ready_q_t, cache);
 GEN_OFFSET_SYM(_kernel_t, current_fp);
 #endif
 
+#ifdef CONFIG_FP_SHARING_STATS
+GEN_OFFSET_SYM(_kernel_t, fp_saves);
+GEN_OFFSET_SYM(_kernel_t, fp_saves_avoided);
+#endif
+
 GEN_ABSOLUTE_SYM(_STRUCT_KERNEL_SIZE, sizeof(struct _kernel));
 
 GEN_OFFSET_SYM(_thread_base_t, user_options);
@@ -14,6 +14,7 @@
 #include <misc/dlist.h>
 #include <misc/rb.h>
 #include <string.h>
+#include <spinlock.h>
 #endif
 
 #define K_NUM_PRIORITIES \
@@ -45,6 +46,9 @@
 /* Thread is suspended */
 #define _THREAD_SUSPENDED (1 << 4)
 
+/* Thread has exhausted its CBS budget for the current period */
+#define _THREAD_THROTTLED (1 << 5)
+
 /* Thread is present in the ready queue */
 #define _THREAD_QUEUED (1 << 6)
 
@@ -71,8 +75,10 @@ struct _ready_q {
 	struct k_thread *cache;
 #endif
 
-#ifdef CONFIG_SCHED_DUMB
+#if defined(CONFIG_SCHED_DUMB)
 	sys_dlist_t runq;
+#elif defined(CONFIG_SCHED_MULTIQ)
+	struct _priq_mq runq;
 #else
 	struct _priq_rb runq;
 #endif
@@ -99,6 +105,16 @@ struct _cpu {
 	/* True when _current is allowed to context switch */
 	u8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* protects ready_q, which may be touched by other CPUs when
+	 * they make one of our threads ready or steal work from us
+	 */
+	struct k_spinlock runq_lock;
+
+	/* threads ready to run on this CPU, not including current */
+	struct _ready_q ready_q;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -126,8 +142,18 @@ struct _kernel {
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 	/* queue of timeouts */
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+	struct rbtree timeout_q;
+
+	/* ticks announced so far, the time base of timeout_q keys */
+	s64_t timeout_tick;
+
+	/* next struct _timeout::order_key to hand out */
+	u32_t timeout_order_key;
+#else
 	sys_dlist_t timeout_q;
 #endif
+#endif
 
 #ifdef CONFIG_SYS_POWER_MANAGEMENT
 	s32_t idle; /* Number of ticks for kernel idling */
@@ -153,6 +179,12 @@ struct _kernel {
 	struct k_thread *current_fp;
 #endif
 
+#ifdef CONFIG_FP_SHARING_STATS
+	/* FP contexts saved, and context switches leaving the FP regs alone */
+	u32_t fp_saves;
+	u32_t fp_saves_avoided;
+#endif
+
 #if defined(CONFIG_THREAD_MONITOR)
 	struct k_thread *threads; /* singly linked list of ALL threads */
 #endif
@@ -241,6 +273,9 @@ static ALWAYS_INLINE void _new_thread_init(struct k_thread *thread,
 #if defined(CONFIG_THREAD_STACK_INFO)
 	thread->stack_info.start = (u32_t)pStack;
 	thread->stack_info.size = (u32_t)stackSize;
+#ifdef CONFIG_THREAD_STACK_WATERMARK
+	thread->stack_info.unused = (u32_t)stackSize;
+#endif
 #endif /* CONFIG_THREAD_STACK_INFO */
 }
 
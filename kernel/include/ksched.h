@@ -40,12 +40,19 @@ void _remove_thread_from_ready_q(struct k_thread *thread);
 int _is_thread_time_slicing(struct k_thread *thread);
 void _unpend_thread_no_timeout(struct k_thread *thread);
 int _pend_current_thread(int key, _wait_q_t *wait_q, s32_t timeout);
+int _pend_curr_spinlock(struct k_spinlock *lock, k_spinlock_key_t key,
+			_wait_q_t *wait_q, s32_t timeout);
 void _pend_thread(struct k_thread *thread, _wait_q_t *wait_q, s32_t timeout);
 int _reschedule(int key);
+int _reschedule_spinlock(struct k_spinlock *lock, k_spinlock_key_t key);
 struct k_thread *_unpend_first_thread(_wait_q_t *wait_q);
+struct k_thread *_requeue_first_thread(_wait_q_t *from, _wait_q_t *to);
 void _unpend_thread(struct k_thread *thread);
 int _unpend_all(_wait_q_t *wait_q);
 void _thread_priority_set(struct k_thread *thread, int prio);
+void _thread_priority_set_no_reschedule(struct k_thread *thread, int prio);
+void _pended_thread_priority_set(struct k_thread *thread, _wait_q_t *wait_q,
+				 int prio);
 void *_get_next_switch_handle(void *interrupted);
 struct k_thread *_find_first_thread_to_unpend(_wait_q_t *wait_q,
 					      struct k_thread *from);
@@ -78,7 +85,7 @@ static inline int _is_thread_prevented_from_running(struct k_thread *thread)
 	u8_t state = thread->base.thread_state;
 
 	return state & (_THREAD_PENDING | _THREAD_PRESTART | _THREAD_DEAD |
-			_THREAD_DUMMY | _THREAD_SUSPENDED);
+			_THREAD_DUMMY | _THREAD_SUSPENDED | _THREAD_THROTTLED);
 
 }
 
@@ -266,6 +273,21 @@ static ALWAYS_INLINE void _sched_unlock_no_reschedule(void)
 #endif
 }
 
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+void _sched_cbs_tick(s32_t ticks);
+void _sched_cbs_abort(struct k_thread *thread);
+#else
+#define _sched_cbs_tick(ticks) do { } while ((0))
+#define _sched_cbs_abort(thread) do { } while ((0))
+#endif
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+void _thread_runtime_switch(struct k_thread *old_thread,
+			    struct k_thread *new_thread);
+#else
+#define _thread_runtime_switch(old_thread, new_thread) do { } while ((0))
+#endif
+
 static ALWAYS_INLINE int _is_thread_timeout_expired(struct k_thread *thread)
 {
 #ifdef CONFIG_SYS_CLOCK_EXISTS
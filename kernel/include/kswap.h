@@ -7,7 +7,9 @@
 #define _KSWAP_H
 
 #include <ksched.h>
+#include <spinlock.h>
 #include <kernel_arch_func.h>
+#include <debug/sched_trace.h>
 
 #ifdef CONFIG_TIMESLICING
 extern void _update_time_slice_before_swap(void);
@@ -21,6 +23,12 @@ extern void _check_stack_sentinel(void);
 #define _check_stack_sentinel() /**/
 #endif
 
+#ifdef CONFIG_THREAD_STACK_WATERMARK
+extern void _check_stack_watermark(void);
+#else
+#define _check_stack_watermark() /**/
+#endif
+
 extern void _sys_k_event_logger_context_switch(void);
 
 /* In SMP, the irq_lock() is a spinlock which is implicitly released
@@ -41,7 +49,9 @@ void _smp_release_global_lock(struct k_thread *thread);
  * Needed for SMP, where the scheduler requires spinlocking that we
  * don't want to have to do in per-architecture assembly.
  */
-static inline unsigned int _Swap(unsigned int key)
+static inline unsigned int do_swap(unsigned int key,
+				   struct k_spinlock *lock,
+				   int is_spinlock)
 {
 	struct k_thread *new_thread, *old_thread;
 	int ret = 0;
@@ -49,23 +59,41 @@ static inline unsigned int _Swap(unsigned int key)
 	old_thread = _current;
 
 	_check_stack_sentinel();
+	_check_stack_watermark();
 	_update_time_slice_before_swap();
 
 #ifdef CONFIG_KERNEL_EVENT_LOGGER_CONTEXT_SWITCH
 	_sys_k_event_logger_context_switch();
 #endif
 
+	if (is_spinlock) {
+		k_spin_release(lock);
+	}
+
 	new_thread = _get_next_ready_thread();
 
 	if (new_thread != old_thread) {
 		old_thread->swap_retval = -EAGAIN;
 
+		_sched_trace_switch_out(old_thread);
+		_sched_trace_switch_in(new_thread);
+		_thread_runtime_switch(old_thread, new_thread);
+
 #ifdef CONFIG_SMP
 		_current_cpu->swap_ok = 0;
 
 		new_thread->base.cpu = _arch_curr_cpu()->id;
 
-		_smp_release_global_lock(new_thread);
+		/* A thread swapping away from a spinlock does not
+		 * necessarily hold the global lock, so it may need to
+		 * be taken on behalf of the incoming thread instead
+		 * of handed over.
+		 */
+		if (!is_spinlock || old_thread->base.global_lock_count) {
+			_smp_release_global_lock(new_thread);
+		} else {
+			_smp_reacquire_global_lock(new_thread);
+		}
 #endif
 
 		_current = new_thread;
@@ -75,21 +103,55 @@ static inline unsigned int _Swap(unsigned int key)
 		ret = _current->swap_retval;
 	}
 
-	irq_unlock(key);
+	if (is_spinlock) {
+		_arch_irq_unlock(key);
+	} else {
+		irq_unlock(key);
+	}
 
 	return ret;
 }
 
+static inline unsigned int _Swap(unsigned int key)
+{
+	return do_swap(key, NULL, 0);
+}
+
+/* Like _Swap(), but releases a k_spinlock taken by the caller
+ * instead of the legacy irq_lock().
+ */
+static inline unsigned int _Swap_spinlock(struct k_spinlock *lock,
+					  k_spinlock_key_t key)
+{
+	return do_swap(key.key, lock, 1);
+}
+
 #else /* !CONFIG_USE_SWITCH */
 
 extern unsigned int __swap(unsigned int key);
 
 static inline unsigned int _Swap(unsigned int key)
 {
+	unsigned int ret;
+
 	_check_stack_sentinel();
+	_check_stack_watermark();
 	_update_time_slice_before_swap();
 
-	return __swap(key);
+	/* the incoming thread is only known once back from __swap() */
+	_sched_trace_switch_out(_current);
+	ret = __swap(key);
+	_sched_trace_switch_in(_current);
+
+	return ret;
+}
+
+static inline unsigned int _Swap_spinlock(struct k_spinlock *lock,
+					  k_spinlock_key_t key)
+{
+	k_spin_release(lock);
+
+	return _Swap(key.key);
 }
 #endif
 
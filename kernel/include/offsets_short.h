@@ -29,6 +29,12 @@
 #define _kernel_offset_to_current_fp \
 	(___kernel_t_current_fp_OFFSET)
 
+#define _kernel_offset_to_fp_saves \
+	(___kernel_t_fp_saves_OFFSET)
+
+#define _kernel_offset_to_fp_saves_avoided \
+	(___kernel_t_fp_saves_avoided_OFFSET)
+
 #define _kernel_offset_to_ready_q_cache \
 	(___kernel_t_ready_q_OFFSET + ___ready_q_t_cache_OFFSET)
 
@@ -70,6 +70,23 @@ extern void _dump_object_error(int retval, void *obj, struct _k_object *ko,
  */
 extern struct _k_object *_k_object_find(void *obj);
 
+#ifdef CONFIG_USERSPACE_OBJ_CACHE
+/**
+ * Kernel object lookup on behalf of the current thread
+ *
+ * Same as _k_object_find(), served from the current thread's cache of
+ * recent lookups when possible. Permissions are not cached: they are
+ * still checked by _k_object_validate().
+ *
+ * @param obj Address of kernel object to get metadata
+ * @return Kernel object's metadata, or NULL if the parameter wasn't the
+ * memory address of a kernel object
+ */
+extern struct _k_object *_k_object_find_cached(void *obj);
+#else
+#define _k_object_find_cached(obj) _k_object_find(obj)
+#endif
+
 typedef void (*_wordlist_cb_func_t)(struct _k_object *ko, void *context);
 
 /**
@@ -280,7 +297,8 @@ static inline int _obj_validation_check(struct _k_object *ko,
 
 #define Z_SYSCALL_IS_OBJ(ptr, type, init) \
 	Z_SYSCALL_VERIFY_MSG( \
-	    !_obj_validation_check(_k_object_find((void *)ptr), (void *)ptr, \
+	    !_obj_validation_check(_k_object_find_cached((void *)ptr), \
+				   (void *)ptr, \
 				   type, init), "access denied")
 
 /**
@@ -15,12 +15,18 @@
  */
 
 #include <misc/dlist.h>
+#include <misc/rb.h>
 #include <drivers/system_timer.h>
+#include <debug/sched_trace.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+extern int _timeout_lessthan(struct rbnode *a, struct rbnode *b);
+#endif
+
 /* initialize the timeouts part of k_thread when enabled in the kernel */
 
 static inline void _init_timeout(struct _timeout *t, _timeout_func_t func)
@@ -87,6 +93,8 @@ static inline void _handle_one_expired_timeout(struct _timeout *timeout)
 
 	timeout->delta_ticks_from_prev = _INACTIVE;
 
+	_sched_trace_timeout(timeout);
+
 	K_DEBUG("timeout %p\n", timeout);
 	if (thread) {
 		_unpend_thread_timing_out(thread, timeout);
@@ -124,14 +132,25 @@ static inline int _abort_timeout(struct _timeout *timeout)
 		return _INACTIVE;
 	}
 
-	if (!sys_dlist_is_tail(&_timeout_q, &timeout->node)) {
-		sys_dnode_t *next_node =
-			sys_dlist_peek_next(&_timeout_q, &timeout->node);
-		struct _timeout *next = (struct _timeout *)next_node;
-
-		next->delta_ticks_from_prev += timeout->delta_ticks_from_prev;
+	if (timeout->delta_ticks_from_prev == _EXPIRED) {
+		/* already moved to the expired list being handled */
+		sys_dlist_remove(&timeout->node);
+	} else {
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+		rb_remove(&_timeout_q, &timeout->rbnode);
+#else
+		if (!sys_dlist_is_tail(&_timeout_q, &timeout->node)) {
+			sys_dnode_t *next_node =
+				sys_dlist_peek_next(&_timeout_q,
+						    &timeout->node);
+			struct _timeout *next = (struct _timeout *)next_node;
+
+			next->delta_ticks_from_prev +=
+				timeout->delta_ticks_from_prev;
+		}
+		sys_dlist_remove(&timeout->node);
+#endif
 	}
-	sys_dlist_remove(&timeout->node);
 	timeout->delta_ticks_from_prev = _INACTIVE;
 
 	return 0;
@@ -164,6 +183,14 @@ static inline void _dump_timeout_q(void)
 #ifdef CONFIG_KERNEL_DEBUG
 	struct _timeout *timeout;
 
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+	K_DEBUG("_timeout_q: %p, root: %p, tick: %lld\n",
+		&_timeout_q, _timeout_q.root, _kernel.timeout_tick);
+
+	RB_FOR_EACH_CONTAINER(&_timeout_q, timeout, rbnode) {
+		_dump_timeout(timeout, 1);
+	}
+#else
 	K_DEBUG("_timeout_q: %p, head: %p, tail: %p\n",
 		&_timeout_q, _timeout_q.head, _timeout_q.tail);
 
@@ -171,6 +198,7 @@ static inline void _dump_timeout_q(void)
 		_dump_timeout(timeout, 1);
 	}
 #endif
+#endif
 }
 
 /*
@@ -190,6 +218,13 @@ static inline void _dump_timeout_q(void)
  * they were queued. This could be changed at the cost of potential longer
  * interrupt latency.
  *
+ * With CONFIG_TIMEOUT_QUEUE_RBTREE, the timeout is instead inserted in
+ * O(log N) into a tree keyed by absolute expiry tick, and timeouts
+ * expiring on the same tick are ordered (and expire) in insertion order.
+ *
+ * With a non-zero CONFIG_TIMEOUT_SLACK_TICKS, the timeout may expire up to
+ * that many ticks late so that it is handled in the same batch as others.
+ *
  * Must be called with interrupts locked.
  */
 
@@ -219,7 +254,9 @@ static inline void _add_timeout(struct k_thread *thread,
 	}
 
 	s32_t *delta = &timeout->delta_ticks_from_prev;
+#ifndef CONFIG_TIMEOUT_QUEUE_RBTREE
 	struct _timeout *in_q;
+#endif
 
 #ifdef CONFIG_TICKLESS_KERNEL
 	/*
@@ -237,7 +274,34 @@ static inline void _add_timeout(struct k_thread *thread,
 	}
 	adjusted_timeout = *delta;
 #endif
+
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+	/* delta_ticks_from_prev only flags the timeout as active here */
+	timeout->expiry = _kernel.timeout_tick + *delta;
+#if CONFIG_TIMEOUT_SLACK_TICKS > 0
+	/* align on the slack grid so that neighbouring timeouts coalesce */
+	timeout->expiry += CONFIG_TIMEOUT_SLACK_TICKS -
+		(timeout->expiry % (CONFIG_TIMEOUT_SLACK_TICKS + 1));
+#endif
+	timeout->order_key = _kernel.timeout_order_key++;
+	rb_insert(&_timeout_q, &timeout->rbnode);
+#else
 	SYS_DLIST_FOR_EACH_CONTAINER(&_timeout_q, in_q, node) {
+#if CONFIG_TIMEOUT_SLACK_TICKS > 0
+		/*
+		 * Expire together with a timeout already queued at most
+		 * CONFIG_TIMEOUT_SLACK_TICKS later, rather than on a tick
+		 * of its own.
+		 */
+		if (in_q->delta_ticks_from_prev - *delta <=
+		    CONFIG_TIMEOUT_SLACK_TICKS &&
+		    *delta <= in_q->delta_ticks_from_prev) {
+			*delta = 0;
+			sys_dlist_insert_after(&_timeout_q, &in_q->node,
+					       &timeout->node);
+			goto inserted;
+		}
+#endif
 		if (*delta <= in_q->delta_ticks_from_prev) {
 			in_q->delta_ticks_from_prev -= *delta;
 			sys_dlist_insert_before(&_timeout_q, &in_q->node,
@@ -251,6 +315,7 @@ static inline void _add_timeout(struct k_thread *thread,
 	sys_dlist_append(&_timeout_q, &timeout->node);
 
 inserted:
+#endif
 	K_DEBUG("after adding timeout %p\n", timeout);
 	_dump_timeout(timeout, 0);
 	_dump_timeout_q();
@@ -281,10 +346,26 @@ static inline void _add_thread_timeout(struct k_thread *thread,
 
 static inline s32_t _get_next_timeout_expiry(void)
 {
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+	struct rbnode *n = rb_get_min(&_timeout_q);
+	struct _timeout *t;
+	s64_t ticks;
+
+	if (!n) {
+		return K_FOREVER;
+	}
+
+	t = CONTAINER_OF(n, struct _timeout, rbnode);
+	ticks = t->expiry - _kernel.timeout_tick;
+
+	/* an overdue timeout is handled on the next announced tick */
+	return ticks > 0 ? (s32_t)ticks : 1;
+#else
 	struct _timeout *t = (struct _timeout *)
 			     sys_dlist_peek_head(&_timeout_q);
 
 	return t ? t->delta_ticks_from_prev : K_FOREVER;
+#endif
 }
 
 #ifdef __cplusplus
@@ -29,6 +29,7 @@
 #include <misc/dlist.h>
 #include <kernel_internal.h>
 #include <kswap.h>
+#include <wait_q.h>
 #include <entropy.h>
 
 /* kernel build timestamp items */
@@ -117,7 +118,11 @@ k_tid_t const _idle_thread3 = (k_tid_t)&_idle_thread3_s;
 K_THREAD_STACK_DEFINE(_interrupt_stack3, CONFIG_ISR_STACK_SIZE);
 #endif
 
-#ifdef CONFIG_SYS_CLOCK_EXISTS
+#if defined(CONFIG_TIMEOUT_QUEUE_RBTREE)
+	#define initialize_timeouts() do { \
+		_timeout_q.lessthan_fn = _timeout_lessthan; \
+	} while ((0))
+#elif defined(CONFIG_SYS_CLOCK_EXISTS)
 	#define initialize_timeouts() do { \
 		sys_dlist_init(&_timeout_q); \
 	} while ((0))
@@ -160,6 +165,10 @@ void _bss_zero(void)
 	memset(&__ccm_bss_start, 0,
 		((u32_t) &__ccm_bss_end - (u32_t) &__ccm_bss_start));
 #endif
+#ifdef CONFIG_DTCM_BASE_ADDRESS
+	memset(&__dtcm_bss_start, 0,
+		((u32_t) &__dtcm_bss_end - (u32_t) &__dtcm_bss_start));
+#endif
 #ifdef CONFIG_APPLICATION_MEMORY
 	memset(&__app_bss_start, 0,
 		 ((u32_t) &__app_bss_end - (u32_t) &__app_bss_start));
@@ -184,6 +193,14 @@ void _data_copy(void)
 	memcpy(&__ccm_data_start, &__ccm_data_rom_start,
 		 ((u32_t) &__ccm_data_end - (u32_t) &__ccm_data_start));
 #endif
+#ifdef CONFIG_ITCM_BASE_ADDRESS
+	memcpy(&__itcm_start, &__itcm_rom_start,
+		 ((u32_t) &__itcm_end - (u32_t) &__itcm_start));
+#endif
+#ifdef CONFIG_DTCM_BASE_ADDRESS
+	memcpy(&__dtcm_data_start, &__dtcm_data_rom_start,
+		 ((u32_t) &__dtcm_data_end - (u32_t) &__dtcm_data_start));
+#endif
 #ifdef CONFIG_APPLICATION_MEMORY
 	memcpy(&__app_data_ram_start, &__app_data_rom_start,
 		 ((u32_t) &__app_data_ram_end - (u32_t) &__app_data_ram_start));
@@ -206,6 +223,9 @@ static void bg_thread_main(void *unused1, void *unused2, void *unused3)
 	ARG_UNUSED(unused2);
 	ARG_UNUSED(unused3);
 
+#if defined(CONFIG_DEVICE_INIT_DEFERRED)
+	_sys_device_deferred_start();
+#endif
 	_sys_device_do_config_level(_SYS_INIT_LEVEL_POST_KERNEL);
 #if CONFIG_STACK_POINTER_RANDOM
 	z_stack_adjust_initialized = 1;
@@ -220,6 +240,10 @@ static void bg_thread_main(void *unused1, void *unused2, void *unused3)
 	/* Final init level before app starts */
 	_sys_device_do_config_level(_SYS_INIT_LEVEL_APPLICATION);
 
+#if defined(CONFIG_BOOT_INIT_PROFILE_PRINT)
+	device_init_profile_print();
+#endif
+
 #ifdef CONFIG_CPLUSPLUS
 	/* Process the .ctors and .init_array sections */
 	extern void __do_global_ctors_aux(void);
@@ -147,6 +147,8 @@ static int mbox_message_match(struct k_mbox_msg *tx_msg,
 		/* update data location fields for receiver only */
 		rx_msg->tx_data = tx_msg->tx_data;
 		rx_msg->tx_block = tx_msg->tx_block;
+		rx_msg->_tx_sg = tx_msg->_tx_sg;
+		rx_msg->_tx_sg_count = tx_msg->_tx_sg_count;
 		if (rx_msg->tx_data != NULL) {
 			rx_msg->tx_block.data = NULL;
 		} else if (rx_msg->tx_block.data != NULL) {
@@ -204,11 +206,20 @@ static void mbox_message_dispose(struct k_mbox_msg *rx_msg)
 	 */
 	if (sending_thread->base.thread_state & _THREAD_DUMMY) {
 		struct k_sem *async_sem = tx_msg->_async_sem;
+#ifdef CONFIG_POLL
+		struct k_poll_signal *async_signal = tx_msg->_async_signal;
+		size_t size = tx_msg->size;
+#endif
 
 		mbox_async_free((struct k_mbox_async *)sending_thread);
 		if (async_sem != NULL) {
 			k_sem_give(async_sem);
 		}
+#ifdef CONFIG_POLL
+		if (async_signal != NULL) {
+			k_poll_signal(async_signal, (int)size);
+		}
+#endif
 		return;
 	}
 #endif
@@ -310,11 +321,56 @@ int k_mbox_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg, s32_t timeout)
 {
 	/* configure things for a synchronous send, then send the message */
 	tx_msg->_syncing_thread = _current;
+	tx_msg->_tx_sg = NULL;
+	tx_msg->_tx_sg_count = 0;
+
+	return mbox_message_put(mbox, tx_msg, timeout);
+}
+
+/* attach a scatter-gather list to a message, in place of its data */
+static void mbox_message_sg_set(struct k_mbox_msg *tx_msg,
+				const struct k_mbox_sg *sg, u32_t count)
+{
+	tx_msg->tx_data = NULL;
+	tx_msg->tx_block.data = NULL;
+	tx_msg->_tx_sg = sg;
+	tx_msg->_tx_sg_count = count;
+
+	tx_msg->size = 0;
+	for (u32_t i = 0; i < count; i++) {
+		tx_msg->size += sg[i].size;
+	}
+}
+
+int k_mbox_sg_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
+		  const struct k_mbox_sg *sg, u32_t count, s32_t timeout)
+{
+	tx_msg->_syncing_thread = _current;
+	mbox_message_sg_set(tx_msg, sg, count);
 
 	return mbox_message_put(mbox, tx_msg, timeout);
 }
 
 #if (CONFIG_NUM_MBOX_ASYNC_MSGS > 0)
+/* allocate and configure an asynchronous copy of a message */
+static struct k_mbox_async *mbox_async_msg_get(struct k_mbox_msg *tx_msg)
+{
+	struct k_mbox_async *async;
+
+	mbox_async_alloc(&async);
+
+	async->thread.prio = _current->base.prio;
+
+	async->tx_msg = *tx_msg;
+	async->tx_msg._syncing_thread = (struct k_thread *)&async->thread;
+	async->tx_msg._async_sem = NULL;
+#ifdef CONFIG_POLL
+	async->tx_msg._async_signal = NULL;
+#endif
+
+	return async;
+}
+
 void k_mbox_async_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
 		      struct k_sem *sem)
 {
@@ -324,17 +380,29 @@ void k_mbox_async_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
 	 * allocate an asynchronous message descriptor, configure both parts,
 	 * then send the message asynchronously
 	 */
-	mbox_async_alloc(&async);
+	async = mbox_async_msg_get(tx_msg);
+	async->tx_msg._tx_sg = NULL;
+	async->tx_msg._tx_sg_count = 0;
+	async->tx_msg._async_sem = sem;
 
-	async->thread.prio = _current->base.prio;
+	mbox_message_put(mbox, &async->tx_msg, K_FOREVER);
+}
 
-	async->tx_msg = *tx_msg;
-	async->tx_msg._syncing_thread = (struct k_thread *)&async->thread;
-	async->tx_msg._async_sem = sem;
+#ifdef CONFIG_POLL
+void k_mbox_async_sg_put(struct k_mbox *mbox, struct k_mbox_msg *tx_msg,
+			 const struct k_mbox_sg *sg, u32_t count,
+			 struct k_poll_signal *signal)
+{
+	struct k_mbox_async *async;
+
+	async = mbox_async_msg_get(tx_msg);
+	mbox_message_sg_set(&async->tx_msg, sg, count);
+	async->tx_msg._async_signal = signal;
 
 	mbox_message_put(mbox, &async->tx_msg, K_FOREVER);
 }
 #endif
+#endif
 
 void k_mbox_data_get(struct k_mbox_msg *rx_msg, void *buffer)
 {
@@ -348,7 +416,35 @@ void k_mbox_data_get(struct k_mbox_msg *rx_msg, void *buffer)
 	/* copy message data to buffer, then dispose of message */
 	if ((rx_msg->tx_data != NULL) && (rx_msg->size > 0)) {
 		memcpy(buffer, rx_msg->tx_data, rx_msg->size);
+	} else if (rx_msg->_tx_sg != NULL) {
+		/* gather scatter-gather data, up to the agreed size */
+		size_t left = rx_msg->size;
+		char *dst = buffer;
+
+		for (u32_t i = 0; i < rx_msg->_tx_sg_count && left; i++) {
+			size_t len = min(rx_msg->_tx_sg[i].size, left);
+
+			memcpy(dst, rx_msg->_tx_sg[i].data, len);
+			dst += len;
+			left -= len;
+		}
+	}
+	mbox_message_dispose(rx_msg);
+}
+
+int k_mbox_data_sg_get(struct k_mbox_msg *rx_msg, const struct k_mbox_sg **sg)
+{
+	if (rx_msg->_tx_sg == NULL) {
+		return -EINVAL;
 	}
+
+	*sg = rx_msg->_tx_sg;
+
+	return rx_msg->_tx_sg_count;
+}
+
+void k_mbox_data_release(struct k_mbox_msg *rx_msg)
+{
 	mbox_message_dispose(rx_msg);
 }
 
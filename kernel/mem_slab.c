@@ -13,6 +13,7 @@
 #include <misc/dlist.h>
 #include <ksched.h>
 #include <init.h>
+#include <string.h>
 
 extern struct k_mem_slab _k_mem_slab_list_start[];
 extern struct k_mem_slab _k_mem_slab_list_end[];
@@ -21,29 +22,32 @@ extern struct k_mem_slab _k_mem_slab_list_end[];
 struct k_mem_slab *_trace_list_k_mem_slab;
 #endif	/* CONFIG_OBJECT_TRACING */
 
-/**
- * @brief Initialize kernel memory slab subsystem.
- *
- * Perform any initialization of memory slabs that wasn't done at build time.
- * Currently this just involves creating the list of free blocks for each slab.
+/*
+ * Blocks are carved from the buffer the first time they are handed out,
+ * so slabs need no setup at boot or init time: the free list only holds
+ * blocks which were freed, and is used before carving new ones.
  *
- * @return N/A
+ * Must be called with the slab locked.
  */
-static void create_free_list(struct k_mem_slab *slab)
+static char *free_block_get(struct k_mem_slab *slab)
 {
-	u32_t j;
-	char *p;
+	char *block = slab->free_list;
 
-	slab->free_list = NULL;
-	p = slab->buffer;
-
-	for (j = 0; j < slab->num_blocks; j++) {
-		*(char **)p = slab->free_list;
-		slab->free_list = p;
-		p += slab->block_size;
+	if (block != NULL) {
+		slab->free_list = *(char **)block;
+	} else if (slab->num_carved < slab->num_blocks) {
+		block = slab->buffer + slab->num_carved * slab->block_size;
+		slab->num_carved++;
+	} else {
+		return NULL;
 	}
+
+	slab->num_used++;
+
+	return block;
 }
 
+#ifdef CONFIG_OBJECT_TRACING
 /**
  * @brief Complete initialization of statically defined memory slabs.
  *
@@ -60,7 +64,6 @@ static int init_mem_slab_module(struct device *dev)
 	for (slab = _k_mem_slab_list_start;
 	     slab < _k_mem_slab_list_end;
 	     slab++) {
-		create_free_list(slab);
 		SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 	}
 	return 0;
@@ -68,6 +71,7 @@ static int init_mem_slab_module(struct device *dev)
 
 SYS_INIT(init_mem_slab_module, PRE_KERNEL_1,
 	 CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
+#endif /* CONFIG_OBJECT_TRACING */
 
 void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 		    size_t block_size, u32_t num_blocks)
@@ -75,56 +79,286 @@ void k_mem_slab_init(struct k_mem_slab *slab, void *buffer,
 	slab->num_blocks = num_blocks;
 	slab->block_size = block_size;
 	slab->buffer = buffer;
+	slab->free_list = NULL;
+	slab->num_carved = 0;
 	slab->num_used = 0;
-	create_free_list(slab);
 	_waitq_init(&slab->wait_q);
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	memset(slab->cache, 0, sizeof(slab->cache));
+	slab->cache_bypass = 0;
+#endif
 	SYS_TRACING_OBJ_INIT(k_mem_slab, slab);
 
 	_k_object_init(slab);
 }
 
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+
+#define MAGAZINE_DEPTH CONFIG_MEM_SLAB_CPU_CACHE_DEPTH
+#define MAGAZINE_BATCH (MAGAZINE_DEPTH / 2)
+
+/*
+ * Each CPU has a magazine of free blocks per slab, protected by its own
+ * lock, which is normally only taken by that CPU. Blocks in magazines are
+ * off the slab's free list and counted in num_used.
+ *
+ * Lock order is slab lock, then magazine lock: a CPU that finds both its
+ * magazine and the free list empty steals from the other magazines before
+ * waiting. A thread about to wait sets the bypass flag of every magazine,
+ * so that blocks freed from then on reach the free list, where waiters
+ * get them, instead of staying cached.
+ */
+
+static inline struct _k_mem_slab_magazine *local_magazine(
+	struct k_mem_slab *slab)
+{
+	/* Migrating after reading the CPU id is harmless: the magazine is
+	 * locked anyway, it just would not be our own.
+	 */
+	return &slab->cache[_current_cpu->id];
+}
+
+static bool cache_alloc(struct k_mem_slab *slab, void **mem)
+{
+	struct _k_mem_slab_magazine *mag = local_magazine(slab);
+	k_spinlock_key_t key = k_spin_lock(&mag->lock);
+	bool hit = mag->count != 0;
+
+	if (hit) {
+		*mem = mag->blocks[--mag->count];
+		mag->alloc_hits++;
+	} else {
+		mag->alloc_misses++;
+	}
+
+	k_spin_unlock(&mag->lock, key);
+
+	return hit;
+}
+
+/* Must be called with the slab locked */
+static void cache_refill(struct k_mem_slab *slab)
+{
+	struct _k_mem_slab_magazine *mag = local_magazine(slab);
+	k_spinlock_key_t key = k_spin_lock(&mag->lock);
+
+	char *block;
+
+	while (mag->count < MAGAZINE_BATCH &&
+	       (block = free_block_get(slab)) != NULL) {
+		mag->blocks[mag->count++] = block;
+	}
+
+	k_spin_unlock(&mag->lock, key);
+}
+
+/*
+ * Must be called with the slab locked and no free block left: take a
+ * block from any magazine. When the caller is going to wait for one if
+ * none is found, magazines are also switched to bypass as they are
+ * searched, so that no block can be cached behind us.
+ */
+static void *cache_steal(struct k_mem_slab *slab, bool bypass)
+{
+	void *block = NULL;
+	int i;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS && block == NULL; i++) {
+		struct _k_mem_slab_magazine *mag = &slab->cache[i];
+		k_spinlock_key_t key = k_spin_lock(&mag->lock);
+
+		if (bypass) {
+			mag->bypass = 1;
+			slab->cache_bypass = 1;
+		}
+
+		if (mag->count != 0) {
+			block = mag->blocks[--mag->count];
+		}
+
+		k_spin_unlock(&mag->lock, key);
+	}
+
+	return block;
+}
+
+/* Must be called with the slab locked and no thread waiting on it */
+static void cache_bypass_clear(struct k_mem_slab *slab)
+{
+	int i;
+
+	if (!slab->cache_bypass) {
+		return;
+	}
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _k_mem_slab_magazine *mag = &slab->cache[i];
+		k_spinlock_key_t key = k_spin_lock(&mag->lock);
+
+		mag->bypass = 0;
+		k_spin_unlock(&mag->lock, key);
+	}
+
+	slab->cache_bypass = 0;
+}
+
+/*
+ * Cache a freed block in the local magazine. If it is full, half of it is
+ * detached as a chain of blocks, that the caller must return to the free
+ * list along with the block.
+ */
+static bool cache_free(struct k_mem_slab *slab, char *block, char **chain)
+{
+	struct _k_mem_slab_magazine *mag = local_magazine(slab);
+	k_spinlock_key_t key = k_spin_lock(&mag->lock);
+	bool hit = false;
+	int i;
+
+	if (mag->bypass) {
+		/* leave the block to the waiters */
+	} else if (mag->count < MAGAZINE_DEPTH) {
+		mag->blocks[mag->count++] = block;
+		mag->free_hits++;
+		hit = true;
+	} else {
+		mag->free_misses++;
+		for (i = 0; i < MAGAZINE_BATCH; i++) {
+			char *b = mag->blocks[--mag->count];
+
+			*(char **)b = *chain;
+			*chain = b;
+		}
+	}
+
+	k_spin_unlock(&mag->lock, key);
+
+	return hit;
+}
+
+u32_t _k_mem_slab_num_cached(struct k_mem_slab *slab)
+{
+	u32_t cached = 0;
+	int i;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cached += slab->cache[i].count;
+	}
+
+	return cached;
+}
+
+void k_mem_slab_cache_stats_get(struct k_mem_slab *slab,
+				struct k_mem_slab_cache_stats *stats)
+{
+	int i;
+
+	memset(stats, 0, sizeof(*stats));
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _k_mem_slab_magazine *mag = &slab->cache[i];
+		k_spinlock_key_t key = k_spin_lock(&mag->lock);
+
+		stats->alloc_hits += mag->alloc_hits;
+		stats->alloc_misses += mag->alloc_misses;
+		stats->free_hits += mag->free_hits;
+		stats->free_misses += mag->free_misses;
+		k_spin_unlock(&mag->lock, key);
+	}
+}
+
+#endif /* CONFIG_MEM_SLAB_CPU_CACHE */
+
 int k_mem_slab_alloc(struct k_mem_slab *slab, void **mem, s32_t timeout)
 {
-	unsigned int key = irq_lock();
+	k_spinlock_key_t key;
 	int result;
 
-	if (slab->free_list != NULL) {
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	if (cache_alloc(slab, mem)) {
+		return 0;
+	}
+#endif
+
+	key = k_spin_lock(&slab->lock);
+
+	if ((*mem = free_block_get(slab)) != NULL) {
 		/* take a free block */
-		*mem = slab->free_list;
-		slab->free_list = *(char **)(slab->free_list);
-		slab->num_used++;
 		result = 0;
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+		cache_refill(slab);
+	} else if ((*mem = cache_steal(slab, timeout != K_NO_WAIT)) != NULL) {
+		/* take a block cached by another CPU */
+		result = 0;
+#endif
 	} else if (timeout == K_NO_WAIT) {
 		/* don't wait for a free block to become available */
 		*mem = NULL;
 		result = -ENOMEM;
 	} else {
 		/* wait for a free block or timeout */
-		result = _pend_current_thread(key, &slab->wait_q, timeout);
+		result = _pend_curr_spinlock(&slab->lock, key, &slab->wait_q,
+					     timeout);
 		if (result == 0) {
 			*mem = _current->base.swap_data;
 		}
 		return result;
 	}
 
-	irq_unlock(key);
+	k_spin_unlock(&slab->lock, key);
 
 	return result;
 }
 
 void k_mem_slab_free(struct k_mem_slab *slab, void **mem)
 {
-	int key = irq_lock();
-	struct k_thread *pending_thread = _unpend_first_thread(&slab->wait_q);
+	k_spinlock_key_t key;
+	struct k_thread *pending_thread;
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	char *chain = NULL;
+
+	if (cache_free(slab, *mem, &chain)) {
+		return;
+	}
+#endif
+
+	key = k_spin_lock(&slab->lock);
+
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+	while (chain != NULL) {
+		char *next = *(char **)chain;
+
+		*(char **)chain = slab->free_list;
+		slab->free_list = chain;
+		slab->num_used--;
+		chain = next;
+	}
+#endif
+
+	pending_thread = _unpend_first_thread(&slab->wait_q);
 
 	if (pending_thread) {
 		_set_thread_return_value_with_data(pending_thread, 0, *mem);
 		_ready_thread(pending_thread);
-		_reschedule(key);
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+		/* a flushed magazine can serve more waiters */
+		while (slab->free_list != NULL &&
+		       (pending_thread = _unpend_first_thread(&slab->wait_q))) {
+			_set_thread_return_value_with_data(pending_thread, 0,
+							   slab->free_list);
+			slab->free_list = *(char **)(slab->free_list);
+			slab->num_used++;
+			_ready_thread(pending_thread);
+		}
+#endif
+		_reschedule_spinlock(&slab->lock, key);
 	} else {
 		**(char ***)mem = slab->free_list;
 		slab->free_list = *(char **)mem;
 		slab->num_used--;
-		irq_unlock(key);
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+		cache_bypass_clear(slab);
+#endif
+		k_spin_unlock(&slab->lock, key);
 	}
 }
@@ -27,10 +27,14 @@ static int pool_id(struct k_mem_pool *pool)
 	return pool - &_k_mem_pool_list_start[0];
 }
 
+/* The wait queue of static pools is initialized at build time */
 static void k_mem_pool_init(struct k_mem_pool *p)
 {
-	_waitq_init(&p->wait_q);
+#ifdef CONFIG_MEM_POOL_TLSF
+	_sys_tlsf_init(&p->tlsf);
+#else
 	_sys_mem_pool_base_init(&p->base);
+#endif
 }
 
 int init_static_pools(struct device *unused)
@@ -47,8 +51,217 @@ int init_static_pools(struct device *unused)
 
 SYS_INIT(init_static_pools, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
-int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
-		     size_t size, s32_t timeout)
+#ifdef CONFIG_MEM_POOL_TLSF
+/* TLSF blocks are identified by their offset in the pool, in units of
+ * the heap alignment, spread over the level and block fields.
+ */
+#define BLOCK_BITS 20
+
+static void *block_data(struct k_mem_pool *p, struct k_mem_block_id *id)
+{
+	u32_t offset = (id->level << BLOCK_BITS) | id->block;
+
+	return (char *)p->tlsf.buf + offset * _TLSF_ALIGN;
+}
+#endif
+
+#ifdef CONFIG_MEM_POOL_STATS
+
+#define SAMPLES CONFIG_MEM_POOL_STATS_SAMPLES
+#define SAMPLE_RATE CONFIG_MEM_POOL_STATS_SAMPLE_RATE
+
+/* Address the public allocation routine was called from */
+#define CALLER() __builtin_return_address(0)
+
+static int size_bucket(size_t size)
+{
+	int bucket = size < 16 ? 0 : 31 - __builtin_clz(size) - 3;
+
+	return min(bucket, CONFIG_MEM_POOL_STATS_BUCKETS - 1);
+}
+
+static size_t block_size(struct k_mem_pool *p, struct k_mem_block_id *id)
+{
+#ifdef CONFIG_MEM_POOL_TLSF
+	return _sys_tlsf_usable_size(block_data(p, id));
+#else
+	return _sys_mem_pool_base_level_size(&p->base, id->level);
+#endif
+}
+
+static void stats_alloc(struct k_mem_pool *p, struct k_mem_block *block,
+			size_t size, int ret, void *caller)
+{
+	struct k_mem_pool_stats *s = &p->stats;
+	unsigned int key = irq_lock();
+	size_t bsz;
+
+	s->request_hist[size_bucket(size)]++;
+
+	if (ret != 0) {
+		s->failed_count++;
+		s->last_failed_caller = caller;
+		s->last_failed_size = size;
+		irq_unlock(key);
+		return;
+	}
+
+	bsz = block_size(p, &block->id);
+
+	s->alloc_count++;
+	s->used_hist[size_bucket(bsz)]++;
+	s->used_bytes += bsz;
+	s->used_blocks++;
+	s->max_used_bytes = max(s->max_used_bytes, s->used_bytes);
+	s->max_used_blocks = max(s->max_used_blocks, s->used_blocks);
+
+	if (SAMPLE_RATE != 0 && (s->alloc_count % SAMPLE_RATE) == 0) {
+		s->samples[p->sample_next].caller = caller;
+		s->samples[p->sample_next].size = size;
+		p->sample_next = (p->sample_next + 1) % SAMPLES;
+	}
+
+	irq_unlock(key);
+}
+
+static void stats_free(struct k_mem_pool *p, struct k_mem_block_id *id)
+{
+	struct k_mem_pool_stats *s = &p->stats;
+	size_t bsz = block_size(p, id);
+	unsigned int key = irq_lock();
+
+	s->free_count++;
+	s->used_hist[size_bucket(bsz)]--;
+	s->used_bytes -= bsz;
+	s->used_blocks--;
+
+	irq_unlock(key);
+}
+
+#ifdef CONFIG_MEM_POOL_TLSF
+static void count_free(size_t size, void *arg)
+{
+	struct k_mem_pool_stats *stats = arg;
+
+	stats->free_hist[size_bucket(size)]++;
+}
+#endif
+
+void k_mem_pool_stats_get(struct k_mem_pool *p, struct k_mem_pool_stats *stats)
+{
+	unsigned int key = irq_lock();
+	int i;
+
+	*stats = p->stats;
+
+	/* the samples are a ring, report them latest first */
+	for (i = 0; i < SAMPLES; i++) {
+		stats->samples[i] =
+			p->stats.samples[(p->sample_next + SAMPLES - 1 - i) %
+					 SAMPLES];
+	}
+
+	memset(stats->free_hist, 0, sizeof(stats->free_hist));
+
+#ifdef CONFIG_MEM_POOL_TLSF
+	_sys_tlsf_foreach_free(&p->tlsf, count_free, stats);
+	irq_unlock(key);
+#else
+	irq_unlock(key);
+
+	for (i = 0; i < p->base.n_levels; i++) {
+		stats->free_hist[size_bucket(
+			_sys_mem_pool_base_level_size(&p->base, i))] +=
+			_sys_mem_pool_base_free_count(&p->base, i);
+	}
+#endif
+}
+
+void k_mem_pool_stats_reset(struct k_mem_pool *p)
+{
+	struct k_mem_pool_stats *s = &p->stats;
+	unsigned int key = irq_lock();
+
+	s->alloc_count = 0;
+	s->free_count = 0;
+	s->failed_count = 0;
+	s->max_used_bytes = s->used_bytes;
+	s->max_used_blocks = s->used_blocks;
+	memset(s->request_hist, 0, sizeof(s->request_hist));
+	s->last_failed_caller = NULL;
+	s->last_failed_size = 0;
+	memset(s->samples, 0, sizeof(s->samples));
+	p->sample_next = 0;
+
+	irq_unlock(key);
+}
+
+#else
+
+#define CALLER() NULL
+#define stats_alloc(p, block, size, ret, caller) do { } while (false)
+#define stats_free(p, id) do { } while (false)
+
+#endif /* CONFIG_MEM_POOL_STATS */
+
+#ifdef CONFIG_MEM_POOL_TLSF
+
+static int pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
+		      size_t size, s32_t timeout, void *caller)
+{
+	unsigned int key;
+	void *data;
+	u32_t offset;
+	s64_t end = 0;
+
+	__ASSERT(!(_is_in_isr() && timeout != K_NO_WAIT), "");
+
+	if (timeout > 0) {
+		end = _tick_get() + _ms_to_ticks(timeout);
+	}
+
+	key = irq_lock();
+
+	while ((data = _sys_tlsf_alloc(&p->tlsf, size)) == NULL) {
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			stats_alloc(p, block, size, -ENOMEM, caller);
+			return -ENOMEM;
+		}
+
+		/* Frees wake up all waiters to retry their allocation */
+		_pend_current_thread(key, &p->wait_q, timeout);
+
+		if (timeout != K_FOREVER) {
+			timeout = end - _tick_get();
+
+			if (timeout <= 0) {
+				stats_alloc(p, block, size, -EAGAIN, caller);
+				return -EAGAIN;
+			}
+		}
+
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+
+	offset = ((char *)data - (char *)p->tlsf.buf) / _TLSF_ALIGN;
+
+	block->data = data;
+	block->id.pool = pool_id(p);
+	block->id.level = offset >> BLOCK_BITS;
+	block->id.block = offset & ((1 << BLOCK_BITS) - 1);
+
+	stats_alloc(p, block, size, 0, caller);
+
+	return 0;
+}
+
+#else
+
+static int pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
+		      size_t size, s32_t timeout, void *caller)
 {
 	int ret;
 	s64_t end = 0;
@@ -88,6 +301,7 @@ int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 
 		if (ret == 0 || timeout == K_NO_WAIT ||
 		    (ret && ret != -ENOMEM)) {
+			stats_alloc(p, block, size, ret, caller);
 			return ret;
 		}
 
@@ -102,20 +316,39 @@ int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
 		}
 	}
 
+	stats_alloc(p, block, size, -EAGAIN, caller);
+
 	return -EAGAIN;
 }
 
+#endif /* CONFIG_MEM_POOL_TLSF */
+
+int k_mem_pool_alloc(struct k_mem_pool *p, struct k_mem_block *block,
+		     size_t size, s32_t timeout)
+{
+	return pool_alloc(p, block, size, timeout, CALLER());
+}
+
 void k_mem_pool_free_id(struct k_mem_block_id *id)
 {
 	int key, need_sched = 0;
 	struct k_mem_pool *p = get_pool(id->pool);
 
+	stats_free(p, id);
+
+#ifdef CONFIG_MEM_POOL_TLSF
+	key = irq_lock();
+
+	_sys_tlsf_free(&p->tlsf, block_data(p, id));
+#else
 	_sys_mem_pool_block_free(&p->base, id->level, id->block);
 
+	key = irq_lock();
+#endif
+
 	/* Wake up anyone blocked on this pool and let them repeat
 	 * their allocation attempts
 	 */
-	key = irq_lock();
 
 	need_sched = _unpend_all(&p->wait_q);
 
@@ -131,7 +364,7 @@ void k_mem_pool_free(struct k_mem_block *block)
 	k_mem_pool_free_id(&block->id);
 }
 
-void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
+static void *pool_malloc(struct k_mem_pool *pool, size_t size, void *caller)
 {
 	struct k_mem_block block;
 
@@ -143,7 +376,7 @@ void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
 				   &size)) {
 		return NULL;
 	}
-	if (k_mem_pool_alloc(pool, &block, size, K_NO_WAIT) != 0) {
+	if (pool_alloc(pool, &block, size, K_NO_WAIT, caller) != 0) {
 		return NULL;
 	}
 
@@ -154,6 +387,11 @@ void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
 	return (char *)block.data + sizeof(struct k_mem_block_id);
 }
 
+void *k_mem_pool_malloc(struct k_mem_pool *pool, size_t size)
+{
+	return pool_malloc(pool, size, CALLER());
+}
+
 void k_free(void *ptr)
 {
 	if (ptr != NULL) {
@@ -179,7 +417,7 @@ K_MEM_POOL_DEFINE(_heap_mem_pool, 64, CONFIG_HEAP_MEM_POOL_SIZE, 1, 4);
 
 void *k_malloc(size_t size)
 {
-	return k_mem_pool_malloc(_HEAP_MEM_POOL, size);
+	return pool_malloc(_HEAP_MEM_POOL, size, CALLER());
 }
 
 void *k_calloc(size_t nmemb, size_t size)
@@ -191,7 +429,7 @@ void *k_calloc(size_t nmemb, size_t size)
 		return NULL;
 	}
 
-	ret = k_malloc(bounds);
+	ret = pool_malloc(_HEAP_MEM_POOL, bounds, CALLER());
 	if (ret) {
 		memset(ret, 0, bounds);
 	}
@@ -209,7 +447,7 @@ void *z_thread_malloc(size_t size)
 	void *ret;
 
 	if (_current->resource_pool) {
-		ret = k_mem_pool_malloc(_current->resource_pool, size);
+		ret = pool_malloc(_current->resource_pool, size, CALLER());
 	} else {
 		ret = NULL;
 	}
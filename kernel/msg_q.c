@@ -108,34 +108,99 @@ void k_msgq_cleanup(struct k_msgq *q)
 }
 
 
+/*
+ * Loans: while a slot is loaned for writing, other senders fail with
+ * -EBUSY, so the free slot at write_ptr stays the loaned one; conversely
+ * for the message at read_ptr and receivers. A thread waiting for a loan
+ * pends with NULL swap data: it takes no message nor gives any when woken
+ * up, it just retries.
+ */
+
+static void msgq_write_advance(struct k_msgq *q)
+{
+	q->write_ptr += q->msg_size;
+	if (q->write_ptr == q->buffer_end) {
+		q->write_ptr = q->buffer_start;
+	}
+	q->used_msgs++;
+}
+
+static void msgq_read_advance(struct k_msgq *q)
+{
+	q->read_ptr += q->msg_size;
+	if (q->read_ptr == q->buffer_end) {
+		q->read_ptr = q->buffer_start;
+	}
+	q->used_msgs--;
+}
+
+/* Must be called with the queue locked, after a message was removed */
+static bool msgq_writer_resume(struct k_msgq *q)
+{
+	struct k_thread *pending_thread = _unpend_first_thread(&q->wait_q);
+
+	if (!pending_thread) {
+		return false;
+	}
+
+	if (pending_thread->base.swap_data) {
+		/* add thread's message to queue */
+		memcpy(q->write_ptr, pending_thread->base.swap_data,
+		       q->msg_size);
+		msgq_write_advance(q);
+	}
+
+	/* wake up waiting thread */
+	_set_thread_return_value(pending_thread, 0);
+	_ready_thread(pending_thread);
+
+	return true;
+}
+
+/* Pend waiting for a loan, with a timeout left to retry with */
+static int msgq_loan_wait(struct k_msgq *q, k_spinlock_key_t key,
+			  s32_t *timeout, s64_t end)
+{
+	int result;
+
+	_current->base.swap_data = NULL;
+	result = _pend_curr_spinlock(&q->lock, key, &q->wait_q, *timeout);
+
+	if (result == 0 && *timeout != K_FOREVER) {
+		*timeout = max(end - k_uptime_get(), K_NO_WAIT);
+	}
+
+	return result;
+}
+
 int _impl_k_msgq_put(struct k_msgq *q, void *data, s32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
-	unsigned int key = irq_lock();
+	k_spinlock_key_t key = k_spin_lock(&q->lock);
 	struct k_thread *pending_thread;
 	int result;
 
-	if (q->used_msgs < q->max_msgs) {
+	if (q->flags & K_MSGQ_FLAG_PUT_LOAN) {
+		result = -EBUSY;
+	} else if (q->used_msgs < q->max_msgs) {
 		/* message queue isn't full */
 		pending_thread = _unpend_first_thread(&q->wait_q);
-		if (pending_thread) {
+		if (pending_thread && pending_thread->base.swap_data) {
 			/* give message to waiting thread */
 			memcpy(pending_thread->base.swap_data, data,
 			       q->msg_size);
+		} else {
+			/* put message in queue */
+			memcpy(q->write_ptr, data, q->msg_size);
+			msgq_write_advance(q);
+		}
+		if (pending_thread) {
 			/* wake up waiting thread */
 			_set_thread_return_value(pending_thread, 0);
 			_ready_thread(pending_thread);
-			_reschedule(key);
+			_reschedule_spinlock(&q->lock, key);
 			return 0;
-		} else {
-			/* put message in queue */
-			memcpy(q->write_ptr, data, q->msg_size);
-			q->write_ptr += q->msg_size;
-			if (q->write_ptr == q->buffer_end) {
-				q->write_ptr = q->buffer_start;
-			}
-			q->used_msgs++;
 		}
 		result = 0;
 	} else if (timeout == K_NO_WAIT) {
@@ -144,10 +209,10 @@ int _impl_k_msgq_put(struct k_msgq *q, void *data, s32_t timeout)
 	} else {
 		/* wait for put message success, failure, or timeout */
 		_current->base.swap_data = data;
-		return _pend_current_thread(key, &q->wait_q, timeout);
+		return _pend_curr_spinlock(&q->lock, key, &q->wait_q, timeout);
 	}
 
-	irq_unlock(key);
+	k_spin_unlock(&q->lock, key);
 
 	return result;
 }
@@ -187,35 +252,19 @@ int _impl_k_msgq_get(struct k_msgq *q, void *data, s32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
-	unsigned int key = irq_lock();
-	struct k_thread *pending_thread;
+	k_spinlock_key_t key = k_spin_lock(&q->lock);
 	int result;
 
-	if (q->used_msgs > 0) {
+	if (q->flags & K_MSGQ_FLAG_GET_LOAN) {
+		result = -EBUSY;
+	} else if (q->used_msgs > 0) {
 		/* take first available message from queue */
 		memcpy(data, q->read_ptr, q->msg_size);
-		q->read_ptr += q->msg_size;
-		if (q->read_ptr == q->buffer_end) {
-			q->read_ptr = q->buffer_start;
-		}
-		q->used_msgs--;
+		msgq_read_advance(q);
 
 		/* handle first thread waiting to write (if any) */
-		pending_thread = _unpend_first_thread(&q->wait_q);
-		if (pending_thread) {
-			/* add thread's message to queue */
-			memcpy(q->write_ptr, pending_thread->base.swap_data,
-			       q->msg_size);
-			q->write_ptr += q->msg_size;
-			if (q->write_ptr == q->buffer_end) {
-				q->write_ptr = q->buffer_start;
-			}
-			q->used_msgs++;
-
-			/* wake up waiting thread */
-			_set_thread_return_value(pending_thread, 0);
-			_ready_thread(pending_thread);
-			_reschedule(key);
+		if (msgq_writer_resume(q)) {
+			_reschedule_spinlock(&q->lock, key);
 			return 0;
 		}
 		result = 0;
@@ -225,10 +274,10 @@ int _impl_k_msgq_get(struct k_msgq *q, void *data, s32_t timeout)
 	} else {
 		/* wait for get message success or timeout */
 		_current->base.swap_data = data;
-		return _pend_current_thread(key, &q->wait_q, timeout);
+		return _pend_curr_spinlock(&q->lock, key, &q->wait_q, timeout);
 	}
 
-	irq_unlock(key);
+	k_spin_unlock(&q->lock, key);
 
 	return result;
 }
@@ -245,9 +294,124 @@ Z_SYSCALL_HANDLER(k_msgq_get, msgq_p, data, timeout)
 }
 #endif
 
+int k_msgq_put_loan(struct k_msgq *q, void **slot, s32_t timeout)
+{
+	s64_t end = timeout > 0 ? k_uptime_get() + timeout : 0;
+	k_spinlock_key_t key;
+	int result;
+
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	do {
+		key = k_spin_lock(&q->lock);
+
+		if (q->flags & K_MSGQ_FLAG_PUT_LOAN) {
+			result = -EBUSY;
+		} else if (q->used_msgs < q->max_msgs) {
+			*slot = q->write_ptr;
+			q->flags |= K_MSGQ_FLAG_PUT_LOAN;
+			result = 0;
+		} else if (timeout == K_NO_WAIT) {
+			result = -ENOMSG;
+		} else {
+			result = msgq_loan_wait(q, key, &timeout, end);
+			continue;
+		}
+
+		k_spin_unlock(&q->lock, key);
+		return result;
+	} while (result == 0);
+
+	return result;
+}
+
+int k_msgq_put_commit(struct k_msgq *q)
+{
+	k_spinlock_key_t key = k_spin_lock(&q->lock);
+	struct k_thread *pending_thread;
+
+	if (!(q->flags & K_MSGQ_FLAG_PUT_LOAN)) {
+		k_spin_unlock(&q->lock, key);
+		return -EINVAL;
+	}
+
+	q->flags &= ~K_MSGQ_FLAG_PUT_LOAN;
+
+	pending_thread = _unpend_first_thread(&q->wait_q);
+	if (pending_thread && pending_thread->base.swap_data) {
+		/* give message to waiting thread */
+		memcpy(pending_thread->base.swap_data, q->write_ptr,
+		       q->msg_size);
+	} else {
+		msgq_write_advance(q);
+	}
+
+	if (pending_thread) {
+		_set_thread_return_value(pending_thread, 0);
+		_ready_thread(pending_thread);
+		_reschedule_spinlock(&q->lock, key);
+	} else {
+		k_spin_unlock(&q->lock, key);
+	}
+
+	return 0;
+}
+
+int k_msgq_get_loan(struct k_msgq *q, void **slot, s32_t timeout)
+{
+	s64_t end = timeout > 0 ? k_uptime_get() + timeout : 0;
+	k_spinlock_key_t key;
+	int result;
+
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+
+	do {
+		key = k_spin_lock(&q->lock);
+
+		if (q->flags & K_MSGQ_FLAG_GET_LOAN) {
+			result = -EBUSY;
+		} else if (q->used_msgs > 0) {
+			*slot = q->read_ptr;
+			q->flags |= K_MSGQ_FLAG_GET_LOAN;
+			result = 0;
+		} else if (timeout == K_NO_WAIT) {
+			result = -ENOMSG;
+		} else {
+			result = msgq_loan_wait(q, key, &timeout, end);
+			continue;
+		}
+
+		k_spin_unlock(&q->lock, key);
+		return result;
+	} while (result == 0);
+
+	return result;
+}
+
+int k_msgq_get_release(struct k_msgq *q)
+{
+	k_spinlock_key_t key = k_spin_lock(&q->lock);
+
+	if (!(q->flags & K_MSGQ_FLAG_GET_LOAN)) {
+		k_spin_unlock(&q->lock, key);
+		return -EINVAL;
+	}
+
+	q->flags &= ~K_MSGQ_FLAG_GET_LOAN;
+	msgq_read_advance(q);
+
+	if (msgq_writer_resume(q)) {
+		_reschedule_spinlock(&q->lock, key);
+	} else {
+		k_spin_unlock(&q->lock, key);
+	}
+
+	return 0;
+}
+
 void _impl_k_msgq_purge(struct k_msgq *q)
 {
-	unsigned int key = irq_lock();
+	k_spinlock_key_t key = k_spin_lock(&q->lock);
 	struct k_thread *pending_thread;
 
 	/* wake up any threads that are waiting to write */
@@ -258,8 +422,12 @@ void _impl_k_msgq_purge(struct k_msgq *q)
 
 	q->used_msgs = 0;
 	q->read_ptr = q->write_ptr;
+	/* a message loaned for reading is gone, a slot loaned for writing
+	 * is still the next free one
+	 */
+	q->flags &= ~K_MSGQ_FLAG_GET_LOAN;
 
-	_reschedule(key);
+	_reschedule_spinlock(&q->lock, key);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -24,6 +24,12 @@
  * When releasing the mutex, thread A must release M2 before it releases M1.
  * Failure to follow this nested model may result in threads running at
  * unexpected priority levels (too high, or too low).
+ *
+ * With CONFIG_MUTEX_PI_CHAIN, the inherited priority is passed on along
+ * chains of owners waiting for other mutexes, and each thread keeps the
+ * list of the mutexes it holds: its priority is recomputed from the
+ * waiters of the mutexes it still holds whenever it releases one, so the
+ * nested model above is not required anymore.
  */
 
 #include <kernel.h>
@@ -40,6 +46,14 @@
 #define RECORD_STATE_CHANGE(mutex) do { } while ((0))
 #define RECORD_CONFLICT(mutex) do { } while ((0))
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+/* inheritance chains span several mutexes, which then share one lock */
+static struct k_spinlock pi_chain_lock;
+#define MUTEX_LOCK(mutex) (&pi_chain_lock)
+#else
+#define MUTEX_LOCK(mutex) (&(mutex)->lock)
+#endif
+
 
 extern struct k_mutex _k_mutex_list_start[];
 extern struct k_mutex _k_mutex_list_end[];
@@ -109,15 +123,109 @@ static void adjust_owner_prio(struct k_mutex *mutex, int new_prio)
 			'y' : 'n',
 			new_prio, mutex->owner->base.prio);
 
-		_thread_priority_set(mutex->owner, new_prio);
+		/* Called with the mutex spinlock held and the
+		 * scheduler locked; the following pend or
+		 * k_sched_unlock() takes care of rescheduling.
+		 */
+		_thread_priority_set_no_reschedule(mutex->owner, new_prio);
+	}
+}
+
+#ifdef CONFIG_MUTEX_PI_CHAIN
+static void set_prio(struct k_thread *thread, int prio)
+{
+	struct k_mutex *pended_on = thread->mutex_pi.pended_on;
+
+	K_DEBUG("%p prio changed to %d (was %d)\n", thread, prio,
+		thread->base.prio);
+
+	if (pended_on) {
+		_pended_thread_priority_set(thread, &pended_on->wait_q, prio);
+	} else {
+		_thread_priority_set_no_reschedule(thread, prio);
+	}
+}
+
+/* Priority of a thread given the waiters of the mutexes it holds */
+static int inherited_prio(struct k_thread *thread)
+{
+	int prio = thread->mutex_pi.base_prio;
+	struct k_mutex *held;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&thread->mutex_pi.held, held,
+				     held_node) {
+		struct k_thread *waiter = _waitq_head(&held->wait_q);
+
+		if (waiter) {
+			prio = new_prio_for_inheritance(waiter->base.prio,
+							prio);
+		}
+	}
+
+	return prio;
+}
+
+/* Raise the owners along the chain starting at mutex to prio */
+static void chain_raise_prio(struct k_mutex *mutex, int prio)
+{
+	int depth;
+
+	for (depth = 0; mutex && depth < CONFIG_MUTEX_PI_CHAIN_DEPTH;
+	     depth++) {
+		struct k_thread *owner = mutex->owner;
+		int new_prio = new_prio_for_inheritance(prio,
+							owner->base.prio);
+
+		if (!_is_prio_higher(new_prio, owner->base.prio)) {
+			break;
+		}
+
+		set_prio(owner, new_prio);
+
+		prio = new_prio;
+		mutex = owner->mutex_pi.pended_on;
+	}
+}
+
+/* Recompute the priorities along the chain starting at thread */
+static void chain_update_prio(struct k_thread *thread)
+{
+	int depth;
+
+	for (depth = 0; thread && depth < CONFIG_MUTEX_PI_CHAIN_DEPTH;
+	     depth++) {
+		struct k_mutex *pended_on = thread->mutex_pi.pended_on;
+		int prio = inherited_prio(thread);
+
+		if (prio == thread->base.prio) {
+			break;
+		}
+
+		set_prio(thread, prio);
+
+		thread = pended_on ? pended_on->owner : NULL;
+	}
+}
+
+static void held_add(struct k_thread *thread, struct k_mutex *mutex)
+{
+	if (sys_dlist_is_empty(&thread->mutex_pi.held)) {
+		thread->mutex_pi.base_prio = thread->base.prio;
 	}
+
+	sys_dlist_append(&thread->mutex_pi.held, &mutex->held_node);
 }
+#endif /* CONFIG_MUTEX_PI_CHAIN */
 
 int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 {
-	int new_prio, key;
+#ifndef CONFIG_MUTEX_PI_CHAIN
+	int new_prio;
+#endif
+	k_spinlock_key_t key;
 
 	_sched_lock();
+	key = k_spin_lock(MUTEX_LOCK(mutex));
 
 	if (likely(mutex->lock_count == 0 || mutex->owner == _current)) {
 
@@ -130,10 +238,17 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 		mutex->lock_count++;
 		mutex->owner = _current;
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+		if (mutex->lock_count == 1) {
+			held_add(_current, mutex);
+		}
+#endif
+
 		K_DEBUG("%p took mutex %p, count: %d, orig prio: %d\n",
 			_current, mutex, mutex->lock_count,
 			mutex->owner_orig_prio);
 
+		k_spin_unlock(MUTEX_LOCK(mutex), key);
 		k_sched_unlock();
 
 		return 0;
@@ -142,22 +257,27 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 	RECORD_CONFLICT();
 
 	if (unlikely(timeout == K_NO_WAIT)) {
+		k_spin_unlock(MUTEX_LOCK(mutex), key);
 		k_sched_unlock();
 		return -EBUSY;
 	}
 
+	K_DEBUG("adjusting prio up on mutex %p\n", mutex);
+
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	_current->mutex_pi.pended_on = mutex;
+	chain_raise_prio(mutex, _current->base.prio);
+#else
 	new_prio = new_prio_for_inheritance(_current->base.prio,
 					    mutex->owner->base.prio);
 
-	key = irq_lock();
-
-	K_DEBUG("adjusting prio up on mutex %p\n", mutex);
-
 	if (_is_prio_higher(new_prio, mutex->owner->base.prio)) {
 		adjust_owner_prio(mutex, new_prio);
 	}
+#endif
 
-	int got_mutex = _pend_current_thread(key, &mutex->wait_q, timeout);
+	int got_mutex = _pend_curr_spinlock(MUTEX_LOCK(mutex), key,
+					    &mutex->wait_q, timeout);
 
 	K_DEBUG("on mutex %p got_mutex value: %d\n", mutex, got_mutex);
 
@@ -173,17 +293,23 @@ int _impl_k_mutex_lock(struct k_mutex *mutex, s32_t timeout)
 
 	K_DEBUG("%p timeout on mutex %p\n", _current, mutex);
 
+	key = k_spin_lock(MUTEX_LOCK(mutex));
+
+	K_DEBUG("adjusting prio down on mutex %p\n", mutex);
+
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	_current->mutex_pi.pended_on = NULL;
+	chain_update_prio(mutex->owner);
+#else
 	struct k_thread *waiter = _waitq_head(&mutex->wait_q);
 
 	new_prio = mutex->owner_orig_prio;
 	new_prio = waiter ? new_prio_for_inheritance(waiter->base.prio,
 						     new_prio) : new_prio;
 
-	K_DEBUG("adjusting prio down on mutex %p\n", mutex);
-
-	key = irq_lock();
 	adjust_owner_prio(mutex, new_prio);
-	irq_unlock(key);
+#endif
+	k_spin_unlock(MUTEX_LOCK(mutex), key);
 
 	k_sched_unlock();
 
@@ -200,7 +326,7 @@ Z_SYSCALL_HANDLER(k_mutex_lock, mutex, timeout)
 
 void _impl_k_mutex_unlock(struct k_mutex *mutex)
 {
-	int key;
+	k_spinlock_key_t key;
 
 	__ASSERT(mutex->lock_count > 0, "");
 	__ASSERT(mutex->owner == _current, "");
@@ -209,31 +335,42 @@ void _impl_k_mutex_unlock(struct k_mutex *mutex)
 
 	RECORD_STATE_CHANGE();
 
+	key = k_spin_lock(MUTEX_LOCK(mutex));
+
 	mutex->lock_count--;
 
 	K_DEBUG("mutex %p lock_count: %d\n", mutex, mutex->lock_count);
 
 	if (mutex->lock_count != 0) {
+		k_spin_unlock(MUTEX_LOCK(mutex), key);
 		k_sched_unlock();
 		return;
 	}
 
-	key = irq_lock();
-
+#ifndef CONFIG_MUTEX_PI_CHAIN
 	adjust_owner_prio(mutex, mutex->owner_orig_prio);
+#endif
 
 	struct k_thread *new_owner = _unpend_first_thread(&mutex->wait_q);
 
 	mutex->owner = new_owner;
 
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	sys_dlist_remove(&mutex->held_node);
+	chain_update_prio(_current);
+
+	if (new_owner) {
+		new_owner->mutex_pi.pended_on = NULL;
+		held_add(new_owner, mutex);
+	}
+#endif
+
 	K_DEBUG("new owner of mutex %p: %p (prio: %d)\n",
 		mutex, new_owner, new_owner ? new_owner->base.prio : -1000);
 
 	if (new_owner) {
 		_ready_thread(new_owner);
 
-		irq_unlock(key);
-
 		_set_thread_return_value(new_owner, 0);
 
 		/*
@@ -245,7 +382,7 @@ void _impl_k_mutex_unlock(struct k_mutex *mutex)
 		mutex->owner_orig_prio = new_owner->base.prio;
 	}
 
-	irq_unlock(key);
+	k_spin_unlock(MUTEX_LOCK(mutex), key);
 
 	k_sched_unlock();
 }
@@ -409,8 +409,6 @@ static int pipe_return_code(size_t min_xfer, size_t bytes_remaining,
  */
 static void pipe_thread_ready(struct k_thread *thread)
 {
-	unsigned int  key;
-
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 	if (thread->base.thread_state & _THREAD_DUMMY) {
 		pipe_async_finish((struct k_pipe_async *)thread);
@@ -418,9 +416,7 @@ static void pipe_thread_ready(struct k_thread *thread)
 	}
 #endif
 
-	key = irq_lock();
 	_ready_thread(thread);
-	irq_unlock(key);
 }
 
 /**
@@ -434,7 +430,7 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	struct k_thread    *reader;
 	struct k_pipe_desc *desc;
 	sys_dlist_t    xfer_list;
-	unsigned int   key;
+	k_spinlock_key_t key;
 	size_t         num_bytes_written = 0;
 	size_t         bytes_copied;
 
@@ -442,7 +438,13 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	ARG_UNUSED(async_desc);
 #endif
 
-	key = irq_lock();
+	key = k_spin_lock(&pipe->lock);
+
+	if (pipe->flags & K_PIPE_FLAG_PUT_LOAN) {
+		k_spin_unlock(&pipe->lock, key);
+		*bytes_written = 0;
+		return -EBUSY;
+	}
 
 	/*
 	 * Create a list of "working readers" into which the data will be
@@ -452,13 +454,13 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 	if (!pipe_xfer_prepare(&xfer_list, &reader, &pipe->wait_q.readers,
 				pipe->size - pipe->bytes_used, bytes_to_write,
 				min_xfer, timeout)) {
-		irq_unlock(key);
+		k_spin_unlock(&pipe->lock, key);
 		*bytes_written = 0;
 		return -EIO;
 	}
 
 	_sched_lock();
-	irq_unlock(key);
+	k_spin_unlock(&pipe->lock, key);
 
 	/*
 	 * 1. 'xfer_list' currently contains a list of reader threads that can
@@ -485,9 +487,7 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		desc->bytes_to_xfer -= bytes_copied;
 
 		/* The thread's read request has been satisfied. Ready it. */
-		key = irq_lock();
 		_ready_thread(thread);
-		irq_unlock(key);
 
 		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
 	}
@@ -535,11 +535,11 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		 * Lock interrupts and unlock the scheduler before
 		 * manipulating the writers wait_q.
 		 */
-		key = irq_lock();
+		key = k_spin_lock(&pipe->lock);
 		_sched_unlock_no_reschedule();
 		_pend_thread((struct k_thread *) &async_desc->thread,
 			     &pipe->wait_q.writers, K_FOREVER);
-		_reschedule(key);
+		_reschedule_spinlock(&pipe->lock, key);
 		return 0;
 	}
 #endif
@@ -555,9 +555,10 @@ int _k_pipe_put_internal(struct k_pipe *pipe, struct k_pipe_async *async_desc,
 		 * Lock interrupts and unlock the scheduler before
 		 * manipulating the writers wait_q.
 		 */
-		key = irq_lock();
+		key = k_spin_lock(&pipe->lock);
 		_sched_unlock_no_reschedule();
-		_pend_current_thread(key, &pipe->wait_q.writers, timeout);
+		_pend_curr_spinlock(&pipe->lock, key, &pipe->wait_q.writers,
+				    timeout);
 	} else {
 		k_sched_unlock();
 	}
@@ -574,14 +575,20 @@ int _impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 	struct k_thread    *writer;
 	struct k_pipe_desc *desc;
 	sys_dlist_t    xfer_list;
-	unsigned int   key;
+	k_spinlock_key_t key;
 	size_t         num_bytes_read = 0;
 	size_t         bytes_copied;
 
 	__ASSERT(min_xfer <= bytes_to_read, "");
 	__ASSERT(bytes_read != NULL, "");
 
-	key = irq_lock();
+	key = k_spin_lock(&pipe->lock);
+
+	if (pipe->flags & K_PIPE_FLAG_GET_LOAN) {
+		k_spin_unlock(&pipe->lock, key);
+		*bytes_read = 0;
+		return -EBUSY;
+	}
 
 	/*
 	 * Create a list of "working readers" into which the data will be
@@ -591,13 +598,13 @@ int _impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 	if (!pipe_xfer_prepare(&xfer_list, &writer, &pipe->wait_q.writers,
 				pipe->bytes_used, bytes_to_read,
 				min_xfer, timeout)) {
-		irq_unlock(key);
+		k_spin_unlock(&pipe->lock, key);
 		*bytes_read = 0;
 		return -EIO;
 	}
 
 	_sched_lock();
-	irq_unlock(key);
+	k_spin_unlock(&pipe->lock, key);
 
 	num_bytes_read = pipe_buffer_get(pipe, data, bytes_to_read);
 
@@ -697,9 +704,10 @@ int _impl_k_pipe_get(struct k_pipe *pipe, void *data, size_t bytes_to_read,
 
 	if (timeout != K_NO_WAIT) {
 		_current->base.swap_data = &pipe_desc;
-		key = irq_lock();
+		key = k_spin_lock(&pipe->lock);
 		_sched_unlock_no_reschedule();
-		_pend_current_thread(key, &pipe->wait_q.readers, timeout);
+		_pend_curr_spinlock(&pipe->lock, key, &pipe->wait_q.readers,
+				    timeout);
 	} else {
 		k_sched_unlock();
 	}
@@ -757,6 +765,163 @@ Z_SYSCALL_HANDLER(k_pipe_put, pipe, data, bytes_to_write, bytes_written_p,
 }
 #endif
 
+/*
+ * Loans: while buffer space is loaned for writing, other writers fail with
+ * -EBUSY, so that the space following write_index stays the loaned one;
+ * conversely for the data at read_index and readers.
+ */
+
+static size_t pipe_put_loan_size(struct k_pipe *pipe)
+{
+	return min(pipe->size - pipe->bytes_used,
+		   pipe->size - pipe->write_index);
+}
+
+static size_t pipe_get_loan_size(struct k_pipe *pipe)
+{
+	return min(pipe->bytes_used, pipe->size - pipe->read_index);
+}
+
+/*
+ * Wake up the threads of @a wait_q whose request @a xfer fully satisfies.
+ * The pipe must be locked; it is unlocked on return.
+ */
+static void pipe_loan_xfer(struct k_pipe *pipe, k_spinlock_key_t key,
+			   _wait_q_t *wait_q,
+			   size_t (*xfer)(struct k_pipe *pipe,
+					  unsigned char *buf, size_t size))
+{
+	struct k_thread *thread;
+	struct k_pipe_desc *desc;
+	sys_dlist_t xfer_list;
+	size_t bytes_copied;
+
+	sys_dlist_init(&xfer_list);
+
+	while ((thread = _waitq_head(wait_q))) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = xfer(pipe, desc->buffer, desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		if (desc->bytes_to_xfer != 0) {
+			/* keeps waiting for the rest */
+			break;
+		}
+
+		_unpend_thread(thread);
+		sys_dlist_append(&xfer_list, &thread->base.qnode_dlist);
+	}
+
+	_sched_lock();
+	k_spin_unlock(&pipe->lock, key);
+
+	while ((thread = (struct k_thread *)sys_dlist_get(&xfer_list))) {
+		pipe_thread_ready(thread);
+	}
+
+	k_sched_unlock();
+}
+
+static size_t pipe_loan_put(struct k_pipe *pipe, unsigned char *buf,
+			    size_t size)
+{
+	return pipe_buffer_put(pipe, buf, size);
+}
+
+int k_pipe_put_loan(struct k_pipe *pipe, void **data, size_t *bytes)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+	int result;
+
+	if (pipe->flags & K_PIPE_FLAG_PUT_LOAN) {
+		result = -EBUSY;
+	} else if (pipe->bytes_used == pipe->size) {
+		result = -EIO;
+	} else {
+		*data = pipe->buffer + pipe->write_index;
+		*bytes = pipe_put_loan_size(pipe);
+		pipe->flags |= K_PIPE_FLAG_PUT_LOAN;
+		result = 0;
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return result;
+}
+
+int k_pipe_put_commit(struct k_pipe *pipe, size_t bytes)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (!(pipe->flags & K_PIPE_FLAG_PUT_LOAN) ||
+	    bytes > pipe_put_loan_size(pipe)) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->flags &= ~K_PIPE_FLAG_PUT_LOAN;
+	pipe->bytes_used += bytes;
+	pipe->write_index += bytes;
+	if (pipe->write_index == pipe->size) {
+		pipe->write_index = 0;
+	}
+
+	/* Readers only wait on an empty buffer, so none can be waiting
+	 * while data is loaned to a reader.
+	 */
+	pipe_loan_xfer(pipe, key, &pipe->wait_q.readers, pipe_buffer_get);
+
+	return 0;
+}
+
+int k_pipe_get_loan(struct k_pipe *pipe, void **data, size_t *bytes)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+	int result;
+
+	if (pipe->flags & K_PIPE_FLAG_GET_LOAN) {
+		result = -EBUSY;
+	} else if (pipe->bytes_used == 0) {
+		result = -EIO;
+	} else {
+		*data = pipe->buffer + pipe->read_index;
+		*bytes = pipe_get_loan_size(pipe);
+		pipe->flags |= K_PIPE_FLAG_GET_LOAN;
+		result = 0;
+	}
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return result;
+}
+
+int k_pipe_get_release(struct k_pipe *pipe, size_t bytes)
+{
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (!(pipe->flags & K_PIPE_FLAG_GET_LOAN) ||
+	    bytes > pipe_get_loan_size(pipe)) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->flags &= ~K_PIPE_FLAG_GET_LOAN;
+	pipe->bytes_used -= bytes;
+	pipe->read_index += bytes;
+	if (pipe->read_index == pipe->size) {
+		pipe->read_index = 0;
+	}
+
+	/* Writers only wait on a full buffer, so none can be waiting
+	 * while buffer space is loaned to a writer.
+	 */
+	pipe_loan_xfer(pipe, key, &pipe->wait_q.writers, pipe_loan_put);
+
+	return 0;
+}
+
 #if (CONFIG_NUM_PIPE_ASYNC_MSGS > 0)
 void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 		      size_t bytes_to_write, struct k_sem *sem)
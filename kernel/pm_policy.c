@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Power management policy: each time the kernel idles, enter the deepest
+ * registered power state whose entry and exit latencies meet the latency
+ * constraints currently set, and whose minimum residency fits in the
+ * predicted idle time.
+ *
+ * The predicted idle time is the time to the next kernel timeout scaled by
+ * a correction factor learned from the observed idle durations, since
+ * interrupts often end idling well before the next timeout.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <errno.h>
+#include <misc/dlist.h>
+#include <power.h>
+
+/* fixed point one of the correction factor, and weight of its average */
+#define CORR_ONE 1024
+#define CORR_SHIFT 3
+
+#define NO_STATE (-1)
+
+static const struct sys_pm_state *pm_states[CONFIG_SYS_PM_POLICY_MAX_STATES];
+static struct sys_pm_state_stats pm_stats[CONFIG_SYS_PM_POLICY_MAX_STATES];
+static int pm_state_count;
+
+static sys_dlist_t pm_constraints = SYS_DLIST_STATIC_INIT(&pm_constraints);
+
+/* state entered by the ongoing idle period, and when it started */
+static int pm_state_cur = NO_STATE;
+static u32_t pm_idle_start;
+static u32_t pm_idle_expected_us;
+
+static u32_t pm_corr = CORR_ONE;
+
+int sys_pm_state_register(const struct sys_pm_state *state)
+{
+	unsigned int key;
+	int index;
+
+	if (!state->enter) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	if (pm_state_count == CONFIG_SYS_PM_POLICY_MAX_STATES) {
+		irq_unlock(key);
+		return -ENOMEM;
+	}
+
+	index = pm_state_count++;
+	pm_states[index] = state;
+
+	irq_unlock(key);
+
+	return index;
+}
+
+void sys_pm_constraint_add(struct sys_pm_constraint *constraint,
+			   u32_t latency_us)
+{
+	unsigned int key;
+
+	constraint->latency_us = latency_us;
+
+	key = irq_lock();
+	sys_dlist_append(&pm_constraints, &constraint->node);
+	irq_unlock(key);
+}
+
+void sys_pm_constraint_remove(struct sys_pm_constraint *constraint)
+{
+	unsigned int key;
+
+	key = irq_lock();
+	sys_dlist_remove(&constraint->node);
+	irq_unlock(key);
+}
+
+int sys_pm_state_stats_get(int state, struct sys_pm_state_stats *stats)
+{
+	unsigned int key;
+
+	if (state < 0 || state >= pm_state_count) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	*stats = pm_stats[state];
+	irq_unlock(key);
+
+	return 0;
+}
+
+static u32_t pm_latency_max(void)
+{
+	struct sys_pm_constraint *constraint;
+	u32_t latency = UINT32_MAX;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&pm_constraints, constraint, node) {
+		latency = min(latency, constraint->latency_us);
+	}
+
+	return latency;
+}
+
+/* Account for the end of the idle period, with interrupts locked */
+static void pm_idle_end(void)
+{
+	const struct sys_pm_state *state;
+	u32_t cycles, us, ratio;
+	int i = pm_state_cur;
+
+	if (i == NO_STATE) {
+		return;
+	}
+
+	cycles = k_cycle_get_32() - pm_idle_start;
+	us = SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC;
+	state = pm_states[i];
+	pm_state_cur = NO_STATE;
+
+	pm_stats[i].count++;
+	pm_stats[i].residency_us += us;
+
+	if (pm_idle_expected_us != UINT32_MAX) {
+		ratio = min(((u64_t)us * CORR_ONE) / pm_idle_expected_us,
+			    CORR_ONE);
+		pm_corr = pm_corr - (pm_corr >> CORR_SHIFT) +
+			  (ratio >> CORR_SHIFT);
+	}
+
+	if (state->exit) {
+		state->exit();
+	}
+}
+
+int _sys_soc_suspend(s32_t ticks)
+{
+	const struct sys_pm_state *state;
+	u32_t latency, predicted;
+	unsigned int key;
+	int i, ret;
+
+	if (ticks == K_FOREVER) {
+		pm_idle_expected_us = UINT32_MAX;
+		predicted = UINT32_MAX;
+	} else {
+		pm_idle_expected_us = max(min((u64_t)ticks *
+					      sys_clock_us_per_tick,
+					      UINT32_MAX - 1), 1);
+		predicted = ((u64_t)pm_idle_expected_us * pm_corr) /
+			    CORR_ONE;
+	}
+
+	latency = pm_latency_max();
+
+	/* states are registered from the shallowest to the deepest */
+	for (i = pm_state_count - 1; i >= 0; i--) {
+		state = pm_states[i];
+
+		if ((u64_t)state->entry_latency_us +
+		    state->exit_latency_us <= latency &&
+		    (u64_t)state->entry_latency_us + state->exit_latency_us +
+		    state->min_residency_us <= predicted) {
+			break;
+		}
+	}
+
+	if (i < 0) {
+		/*
+		 * Plain idling is not measured: let the correction factor
+		 * drift back up, so that a run of short idle periods does
+		 * not keep the deeper states out for good.
+		 */
+		pm_corr += (CORR_ONE - pm_corr) >> CORR_SHIFT;
+		return SYS_PM_NOT_HANDLED;
+	}
+
+	pm_state_cur = i;
+	pm_idle_start = k_cycle_get_32();
+
+	ret = state->enter(ticks);
+	if (ret == SYS_PM_NOT_HANDLED) {
+		pm_state_cur = NO_STATE;
+		return ret;
+	}
+
+	/* unless already done by _sys_soc_resume() from the wake event */
+	key = irq_lock();
+	pm_idle_end();
+	irq_unlock(key);
+
+	return ret;
+}
+
+void _sys_soc_resume(void)
+{
+	pm_idle_end();
+}
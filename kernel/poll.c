@@ -52,6 +52,10 @@ static inline int is_condition_met(struct k_poll_event *event, u32_t *state)
 		}
 		break;
 	case K_POLL_TYPE_DATA_AVAILABLE:
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+		/* make appenders take the path signaling poll events */
+		atomic_or(&event->queue->inbox, _K_QUEUE_INBOX_WAITERS);
+#endif
 		if (!k_queue_is_empty(event->queue)) {
 			*state = K_POLL_STATE_FIFO_DATA_AVAILABLE;
 			return 1;
@@ -316,6 +320,24 @@ oops_free:
 }
 #endif
 
+/* must be called with interrupts locked */
+static void poll_set_signal(struct k_poll_event *event, u32_t state)
+{
+	struct k_poll_set *set = event->poller->set;
+	struct k_thread *thread;
+
+	/* the object removed the event from its list: queue it as ready */
+	event->state |= state;
+	sys_dlist_append(&set->ready, &event->_node);
+
+	thread = _unpend_first_thread(&set->wait_q);
+	if (thread) {
+		_set_thread_return_value(thread,
+				state == K_POLL_STATE_NOT_READY ? -EINTR : 0);
+		_ready_thread(thread);
+	}
+}
+
 /* must be called with interrupts locked */
 static int signal_poll_event(struct k_poll_event *event, u32_t state)
 {
@@ -323,6 +345,11 @@ static int signal_poll_event(struct k_poll_event *event, u32_t state)
 		goto ready_event;
 	}
 
+	if (event->poller->set) {
+		poll_set_signal(event, state);
+		return 0;
+	}
+
 	struct k_thread *thread = event->poller->thread;
 
 	__ASSERT(event->poller->thread, "poller should have a thread\n");
@@ -352,6 +379,152 @@ ready_event:
 	return 0;
 }
 
+void k_poll_set_init(struct k_poll_set *set)
+{
+	set->poller.thread = _current;
+	set->poller.is_polling = 1;
+	set->poller.set = set;
+	sys_dlist_init(&set->ready);
+	_waitq_init(&set->wait_q);
+	set->num_events = 0;
+}
+
+int k_poll_set_add(struct k_poll_set *set, struct k_poll_event *event)
+{
+	unsigned int key = irq_lock();
+	u32_t state;
+
+	if (event->poller) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	set->num_events++;
+
+	if (is_condition_met(event, &state)) {
+		event->poller = &set->poller;
+		poll_set_signal(event, state);
+		_reschedule(key);
+		return 0;
+	}
+
+	event->state = K_POLL_STATE_NOT_READY;
+	register_event(event, &set->poller);
+	irq_unlock(key);
+
+	return 0;
+}
+
+int k_poll_set_remove(struct k_poll_set *set, struct k_poll_event *event)
+{
+	unsigned int key = irq_lock();
+
+	if (event->poller != &set->poller) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	/* unlinks the event from its object or from the ready list */
+	clear_event_registration(event);
+	set->num_events--;
+	irq_unlock(key);
+
+	return 0;
+}
+
+/*
+ * Report the ready events of @a set whose condition is still met, and put
+ * the other ones back on their objects. Reported events stay in the ready
+ * list, behind the unreported ones, for the next wait to check them again.
+ */
+static int poll_set_harvest(struct k_poll_set *set, struct k_poll_event **ready,
+			    int max_ready)
+{
+	struct k_poll_event *event;
+	sys_dlist_t reported;
+	unsigned int key;
+	int budget, num_ready = 0;
+	u32_t state;
+
+	sys_dlist_init(&reported);
+
+	/* events signaled while the lock is released can join the ready list
+	 * behind us: bound the work to one pass over the set
+	 */
+	key = irq_lock();
+	for (budget = set->num_events; budget > 0 && num_ready < max_ready;
+	     budget--) {
+		event = (struct k_poll_event *)sys_dlist_get(&set->ready);
+		if (!event) {
+			break;
+		}
+
+		if (is_condition_met(event, &state)) {
+			event->state = state;
+			ready[num_ready++] = event;
+			sys_dlist_append(&reported, &event->_node);
+		} else {
+			event->state = K_POLL_STATE_NOT_READY;
+			register_event(event, &set->poller);
+		}
+
+		irq_unlock(key);
+		key = irq_lock();
+	}
+
+	while ((event = (struct k_poll_event *)sys_dlist_get(&reported))) {
+		sys_dlist_append(&set->ready, &event->_node);
+	}
+	irq_unlock(key);
+
+	return num_ready;
+}
+
+int k_poll_set_wait(struct k_poll_set *set, struct k_poll_event **ready,
+		    int max_ready, s32_t timeout)
+{
+	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
+	__ASSERT(ready, "NULL ready array\n");
+	__ASSERT(max_ready > 0, "zero ready events\n");
+
+	s64_t end = timeout > 0 ? k_uptime_get() + timeout : 0;
+	unsigned int key;
+	int rc;
+
+	for (;;) {
+		rc = poll_set_harvest(set, ready, max_ready);
+		if (rc > 0) {
+			return rc;
+		}
+
+		key = irq_lock();
+
+		if (!sys_dlist_is_empty(&set->ready)) {
+			/* signaled since the harvest */
+			irq_unlock(key);
+			continue;
+		}
+
+		if (timeout == K_NO_WAIT) {
+			irq_unlock(key);
+			return -EAGAIN;
+		}
+
+		set->poller.thread = _current;
+		rc = _pend_current_thread(key, &set->wait_q, timeout);
+		if (rc != 0) {
+			return rc;
+		}
+
+		/* the condition may have been consumed before we ran: wait
+		 * again for what is left of the waiting period
+		 */
+		if (timeout != K_FOREVER) {
+			timeout = max(end - k_uptime_get(), K_NO_WAIT);
+		}
+	}
+}
+
 void _handle_obj_poll_events(sys_dlist_t *events, u32_t state)
 {
 	struct k_poll_event *poll_event;
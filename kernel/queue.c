@@ -81,9 +81,109 @@ SYS_INIT(init_queue_module, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
 
 #endif /* CONFIG_OBJECT_TRACING */
 
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+/*
+ * Lock-free append: when no thread may be waiting on the queue, appended
+ * nodes are pushed with a compare-and-swap on the inbox, a LIFO of nodes
+ * linked through their sflist node, without taking the lock nor going
+ * through the scheduler. Any locked access to data_q first moves the inbox
+ * contents, in order, to the end of data_q, so FIFO ordering is kept.
+ *
+ * A thread about to wait on the queue sets _K_QUEUE_INBOX_WAITERS, which
+ * sends producers to the regular, locked, path that wakes waiters up. The
+ * flag is cleared by that path once it sees no more waiters.
+ */
+BUILD_ASSERT(sizeof(atomic_t) == sizeof(void *));
+
+static bool inbox_push(struct k_queue *queue, sys_sfnode_t *node)
+{
+	atomic_val_t old;
+
+	do {
+		old = atomic_get(&queue->inbox);
+		if (old & _K_QUEUE_INBOX_WAITERS) {
+			return false;
+		}
+		node->next_and_flags = (unative_t)old;
+	} while (!atomic_cas(&queue->inbox, old, (atomic_val_t)node));
+
+	return true;
+}
+
+/* must be called with the queue lock held */
+static void inbox_merge(struct k_queue *queue)
+{
+	sys_sfnode_t *node, *next, *head = NULL, *tail;
+	atomic_val_t old;
+
+	do {
+		old = atomic_get(&queue->inbox);
+		if (!(old & ~_K_QUEUE_INBOX_WAITERS)) {
+			return;
+		}
+	} while (!atomic_cas(&queue->inbox, old,
+			     old & _K_QUEUE_INBOX_WAITERS));
+
+	/* reverse the LIFO into a list in append order */
+	node = (sys_sfnode_t *)(old & ~_K_QUEUE_INBOX_WAITERS);
+	tail = node;
+	while (node) {
+		next = (sys_sfnode_t *)node->next_and_flags;
+		node->next_and_flags = (unative_t)head;
+		head = node;
+		node = next;
+	}
+
+	sys_sflist_append_list(&queue->data_q, head, tail);
+}
+
+/* must be called with the queue lock held */
+static void inbox_waiters_set(struct k_queue *queue)
+{
+	atomic_or(&queue->inbox, _K_QUEUE_INBOX_WAITERS);
+	inbox_merge(queue);
+}
+
+/* must be called with the queue lock held, once waiters were woken up */
+static void inbox_waiters_update(struct k_queue *queue)
+{
+#if defined(CONFIG_POLL)
+	unsigned int key = irq_lock();
+
+	if (sys_dlist_is_empty(&queue->poll_events)) {
+		atomic_and(&queue->inbox, ~_K_QUEUE_INBOX_WAITERS);
+	}
+	irq_unlock(key);
+#else
+	if (!_waitq_head(&queue->wait_q)) {
+		atomic_and(&queue->inbox, ~_K_QUEUE_INBOX_WAITERS);
+	}
+#endif
+}
+
+void z_queue_inbox_merge(struct k_queue *queue)
+{
+	k_spinlock_key_t key;
+
+	if (!(atomic_get(&queue->inbox) & ~_K_QUEUE_INBOX_WAITERS)) {
+		return;
+	}
+
+	key = k_spin_lock(&queue->lock);
+	inbox_merge(queue);
+	k_spin_unlock(&queue->lock, key);
+}
+#else
+#define inbox_merge(queue) do { } while ((0))
+#define inbox_waiters_update(queue) do { } while ((0))
+#endif /* CONFIG_QUEUE_LOCKLESS_APPEND */
+
 void _impl_k_queue_init(struct k_queue *queue)
 {
 	sys_sflist_init(&queue->data_q);
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+	atomic_clear(&queue->inbox);
+#endif
 	_waitq_init(&queue->wait_q);
 #if defined(CONFIG_POLL)
 	sys_dlist_init(&queue->poll_events);
@@ -115,13 +215,17 @@ static void prepare_thread_to_run(struct k_thread *thread, void *data)
 static inline void handle_poll_events(struct k_queue *queue, u32_t state)
 {
 #ifdef CONFIG_POLL
+	/* k_poll() still synchronizes its event lists with irq_lock() */
+	unsigned int key = irq_lock();
+
 	_handle_obj_poll_events(&queue->poll_events, state);
+	irq_unlock(key);
 #endif
 }
 
 void _impl_k_queue_cancel_wait(struct k_queue *queue)
 {
-	unsigned int key = irq_lock();
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 #if !defined(CONFIG_POLL)
 	struct k_thread *first_pending_thread;
 
@@ -134,7 +238,7 @@ void _impl_k_queue_cancel_wait(struct k_queue *queue)
 	handle_poll_events(queue, K_POLL_STATE_NOT_READY);
 #endif /* !CONFIG_POLL */
 
-	_reschedule(key);
+	_reschedule_spinlock(&queue->lock, key);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -143,9 +247,9 @@ Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_queue_cancel_wait, K_OBJ_QUEUE,
 #endif
 
 static int queue_insert(struct k_queue *queue, void *prev, void *data,
-			bool alloc)
+			bool alloc, bool append)
 {
-	unsigned int key = irq_lock();
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 #if !defined(CONFIG_POLL)
 	struct k_thread *first_pending_thread;
 
@@ -153,17 +257,24 @@ static int queue_insert(struct k_queue *queue, void *prev, void *data,
 
 	if (first_pending_thread) {
 		prepare_thread_to_run(first_pending_thread, data);
-		_reschedule(key);
+		inbox_waiters_update(queue);
+		_reschedule_spinlock(&queue->lock, key);
 		return 0;
 	}
 #endif /* !CONFIG_POLL */
 
+	inbox_merge(queue);
+	if (append) {
+		prev = sys_sflist_peek_tail(&queue->data_q);
+	}
+
 	/* Only need to actually allocate if no threads are pending */
 	if (alloc) {
 		struct alloc_node *anode;
 
 		anode = z_thread_malloc(sizeof(*anode));
 		if (!anode) {
+			k_spin_unlock(&queue->lock, key);
 			return -ENOMEM;
 		}
 		anode->data = data;
@@ -177,30 +288,52 @@ static int queue_insert(struct k_queue *queue, void *prev, void *data,
 #if defined(CONFIG_POLL)
 	handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
 #endif /* CONFIG_POLL */
+	inbox_waiters_update(queue);
 
-	_reschedule(key);
+	_reschedule_spinlock(&queue->lock, key);
 	return 0;
 }
 
 void k_queue_insert(struct k_queue *queue, void *prev, void *data)
 {
-	queue_insert(queue, prev, data, false);
+	queue_insert(queue, prev, data, false, false);
 }
 
 void k_queue_append(struct k_queue *queue, void *data)
 {
-	queue_insert(queue, sys_sflist_peek_tail(&queue->data_q), data, false);
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+	if (inbox_push(queue, data)) {
+		return;
+	}
+#endif
+	queue_insert(queue, NULL, data, false, true);
 }
 
 void k_queue_prepend(struct k_queue *queue, void *data)
 {
-	queue_insert(queue, NULL, data, false);
+	queue_insert(queue, NULL, data, false, false);
+}
+
+bool k_queue_remove(struct k_queue *queue, void *data)
+{
+	k_spinlock_key_t key;
+	bool removed;
+
+	key = k_spin_lock(&queue->lock);
+
+	/* items appended lock-free are not in data_q yet */
+	inbox_merge(queue);
+	removed = sys_sflist_find_and_remove(&queue->data_q,
+					     (sys_sfnode_t *)data);
+
+	k_spin_unlock(&queue->lock, key);
+
+	return removed;
 }
 
 int _impl_k_queue_alloc_append(struct k_queue *queue, void *data)
 {
-	return queue_insert(queue, sys_sflist_peek_tail(&queue->data_q), data,
-			    true);
+	return queue_insert(queue, NULL, data, true, true);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -215,7 +348,7 @@ Z_SYSCALL_HANDLER(k_queue_alloc_append, queue, data)
 
 int _impl_k_queue_alloc_prepend(struct k_queue *queue, void *data)
 {
-	return queue_insert(queue, NULL, data, true);
+	return queue_insert(queue, NULL, data, true, false);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -232,7 +365,7 @@ void k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 {
 	__ASSERT(head && tail, "invalid head or tail");
 
-	unsigned int key = irq_lock();
+	k_spinlock_key_t key = k_spin_lock(&queue->lock);
 #if !defined(CONFIG_POLL)
 	struct k_thread *thread;
 
@@ -242,15 +375,18 @@ void k_queue_append_list(struct k_queue *queue, void *head, void *tail)
 	}
 
 	if (head) {
+		inbox_merge(queue);
 		sys_sflist_append_list(&queue->data_q, head, tail);
 	}
 
 #else
+	inbox_merge(queue);
 	sys_sflist_append_list(&queue->data_q, head, tail);
 	handle_poll_events(queue, K_POLL_STATE_DATA_AVAILABLE);
 #endif /* !CONFIG_POLL */
+	inbox_waiters_update(queue);
 
-	_reschedule(key);
+	_reschedule_spinlock(&queue->lock, key);
 }
 
 void k_queue_merge_slist(struct k_queue *queue, sys_slist_t *list)
@@ -275,7 +411,7 @@ static void *k_queue_poll(struct k_queue *queue, s32_t timeout)
 {
 	struct k_poll_event event;
 	int err, elapsed = 0, done = 0;
-	unsigned int key;
+	k_spinlock_key_t key;
 	void *val;
 	u32_t start;
 
@@ -296,11 +432,12 @@ static void *k_queue_poll(struct k_queue *queue, s32_t timeout)
 		}
 
 		/* sys_sflist_* aren't threadsafe, so must be always protected
-		 * by irq_lock.
+		 * by the queue lock.
 		 */
-		key = irq_lock();
+		key = k_spin_lock(&queue->lock);
+		inbox_merge(queue);
 		val = z_queue_node_peek(sys_sflist_get(&queue->data_q), true);
-		irq_unlock(key);
+		k_spin_unlock(&queue->lock, key);
 
 		if (!val && timeout != K_FOREVER) {
 			elapsed = k_uptime_get_32() - start;
@@ -314,32 +451,45 @@ static void *k_queue_poll(struct k_queue *queue, s32_t timeout)
 
 void *_impl_k_queue_get(struct k_queue *queue, s32_t timeout)
 {
-	unsigned int key;
+	k_spinlock_key_t key;
 	void *data;
 
-	key = irq_lock();
+	key = k_spin_lock(&queue->lock);
 
+	inbox_merge(queue);
 	if (likely(!sys_sflist_is_empty(&queue->data_q))) {
 		sys_sfnode_t *node;
 
 		node = sys_sflist_get_not_empty(&queue->data_q);
 		data = z_queue_node_peek(node, true);
-		irq_unlock(key);
+		k_spin_unlock(&queue->lock, key);
 		return data;
 	}
 
 	if (timeout == K_NO_WAIT) {
-		irq_unlock(key);
+		k_spin_unlock(&queue->lock, key);
 		return NULL;
 	}
 
 #if defined(CONFIG_POLL)
-	irq_unlock(key);
+	k_spin_unlock(&queue->lock, key);
 
 	return k_queue_poll(queue, timeout);
 
 #else
-	int ret = _pend_current_thread(key, &queue->wait_q, timeout);
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+	inbox_waiters_set(queue);
+	if (!sys_sflist_is_empty(&queue->data_q)) {
+		/* appended locklessly before the flag was set */
+		data = z_queue_node_peek(sys_sflist_get_not_empty(
+						 &queue->data_q), true);
+		k_spin_unlock(&queue->lock, key);
+		return data;
+	}
+#endif
+
+	int ret = _pend_curr_spinlock(&queue->lock, key, &queue->wait_q,
+				      timeout);
 
 	return ret ? NULL : _current->base.swap_data;
 #endif /* CONFIG_POLL */
@@ -12,10 +12,14 @@
 #include <kernel_arch_func.h>
 #include <syscall_handler.h>
 
-#ifdef CONFIG_SCHED_DUMB
+#if defined(CONFIG_SCHED_DUMB)
 #define _priq_run_add		_priq_dumb_add
 #define _priq_run_remove	_priq_dumb_remove
 #define _priq_run_best		_priq_dumb_best
+#elif defined(CONFIG_SCHED_MULTIQ)
+#define _priq_run_add		_priq_mq_add
+#define _priq_run_remove	_priq_mq_remove
+#define _priq_run_best		_priq_mq_best
 #else
 #define _priq_run_add		_priq_rb_add
 #define _priq_run_remove	_priq_rb_remove
@@ -42,6 +46,17 @@ static struct k_spinlock sched_lock;
 			!__i.key;					\
 			k_spin_unlock(lck, __key), __i.key = 1)
 
+/* The ready queue (and the lock protecting it) from which the current
+ * CPU picks its next thread.
+ */
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+#define _local_runq (&_current_cpu->ready_q.runq)
+#define _local_runq_lock (&_current_cpu->runq_lock)
+#else
+#define _local_runq (&_kernel.ready_q.runq)
+#define _local_runq_lock (&sched_lock)
+#endif
+
 static inline int _is_preempt(struct k_thread *thread)
 {
 #ifdef CONFIG_PREEMPT_ENABLED
@@ -144,6 +159,127 @@ static int should_preempt(struct k_thread *th, int preempt_ok)
 	return 0;
 }
 
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+static int runq_cpu_allowed(struct k_thread *thread, int cpu)
+{
+#ifdef CONFIG_SCHED_CPU_MASK
+	return !!(thread->base.cpu_mask & BIT(cpu));
+#else
+	ARG_UNUSED(thread);
+	ARG_UNUSED(cpu);
+	return 1;
+#endif
+}
+
+/* Threads are queued on the CPU they last ran on (which is likely
+ * to still have their working set cached), unless their mask no
+ * longer allows it, in which case the lowest allowed CPU is used.
+ * Imbalance is corrected lazily by idle CPUs stealing work.
+ */
+static int runq_target_cpu(struct k_thread *thread)
+{
+	int cpu = thread->base.cpu;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if (!runq_cpu_allowed(thread, cpu)) {
+		__ASSERT(thread->base.cpu_mask, "thread %p has no CPUs",
+			 thread);
+		cpu = find_lsb_set(thread->base.cpu_mask) - 1;
+	}
+#endif
+
+	return cpu;
+}
+
+/* Called with the local runq_lock held when this CPU has nothing to
+ * run.  Moves the best thread from some other CPU's queue into the
+ * local one.  Remote queues are only ever try-locked, so two idle
+ * CPUs stealing from each other cannot deadlock, and a busy remote
+ * queue is simply skipped.
+ */
+static struct k_thread *steal_thread(void)
+{
+	int me = _current_cpu->id;
+
+	for (int i = 1; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *c = &_kernel.cpus[(me + i) % CONFIG_MP_NUM_CPUS];
+		struct k_thread *th;
+
+		if (!atomic_cas(&c->runq_lock.locked, 0, 1)) {
+			continue;
+		}
+
+		th = _priq_run_best(&c->ready_q.runq);
+		if (th && runq_cpu_allowed(th, me)) {
+			_priq_run_remove(&c->ready_q.runq, th);
+
+			/* Must be updated before dropping the remote
+			 * lock, see runq_remove()
+			 */
+			th->base.cpu = me;
+		} else {
+			th = NULL;
+		}
+
+		atomic_clear(&c->runq_lock.locked);
+
+		if (th) {
+			_priq_run_add(_local_runq, th);
+			return th;
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_SCHED_PER_CPU_RUNQ */
+
+static void runq_add(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	int cpu = runq_target_cpu(thread);
+	struct _cpu *c = &_kernel.cpus[cpu];
+
+	LOCKED(&c->runq_lock) {
+		thread->base.cpu = cpu;
+		_priq_run_add(&c->ready_q.runq, thread);
+		_mark_thread_as_queued(thread);
+	}
+#else
+	_priq_run_add(&_kernel.ready_q.runq, thread);
+	_mark_thread_as_queued(thread);
+#endif
+}
+
+static void runq_remove(struct k_thread *thread)
+{
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* The thread can be stolen by another CPU between reading its
+	 * queue index and acquiring that queue's lock, in which case
+	 * the index will have changed under us and we retry.
+	 */
+	int done = 0;
+
+	while (!done) {
+		struct _cpu *c = &_kernel.cpus[thread->base.cpu];
+
+		LOCKED(&c->runq_lock) {
+			if (!_is_thread_queued(thread)) {
+				done = 1;
+			} else if (c == &_kernel.cpus[thread->base.cpu]) {
+				_priq_run_remove(&c->ready_q.runq, thread);
+				_mark_thread_as_not_queued(thread);
+				done = 1;
+			}
+		}
+	}
+#else
+	if (_is_thread_queued(thread)) {
+		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		_mark_thread_as_not_queued(thread);
+	}
+#endif
+}
+
 static struct k_thread *next_up(void)
 {
 #ifndef CONFIG_SMP
@@ -171,7 +307,14 @@ static struct k_thread *next_up(void)
 	int active = !_is_thread_prevented_from_running(_current);
 
 	/* Choose the best thread that is not current */
-	struct k_thread *th = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *th = _priq_run_best(_local_runq);
+
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	if (!th && (!active || _is_idle(_current))) {
+		th = steal_thread();
+	}
+#endif
+
 	if (!th) {
 		th = _current_cpu->idle_thread;
 	}
@@ -189,13 +332,16 @@ static struct k_thread *next_up(void)
 
 	/* Put _current back into the queue */
 	if (th != _current && active && !_is_idle(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+		_current->base.cpu = _current_cpu->id;
+#endif
+		_priq_run_add(_local_runq, _current);
 		_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (_is_thread_queued(th)) {
-		_priq_run_remove(&_kernel.ready_q.runq, th);
+		_priq_run_remove(_local_runq, th);
 	}
 	_mark_thread_as_not_queued(th);
 
@@ -225,21 +371,101 @@ static void update_cache(int preempt_ok)
 #endif
 }
 
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+/* Whether the thread should preempt whatever the CPU is running.  The
+ * other CPU's _current is read without its lock: the worst outcomes
+ * are a spurious IPI, or a missed one for a CPU which was switching
+ * threads anyway and will then see the new thread.
+ */
+static int cpu_should_preempt(struct _cpu *cpu, struct k_thread *thread)
+{
+	struct k_thread *cur = cpu->current;
+
+	if (!cur || !_is_thread_ready(cur)) {
+		return 0;
+	}
+
+	if (_is_idle(cur)) {
+		return 1;
+	}
+
+	return (_is_preempt(cur) || is_metairq(thread)) &&
+		_is_t1_higher_prio_than_t2(thread, cur);
+}
+
+/* Called with the thread just made ready.  Interrupts the one other
+ * CPU, if any, which should switch to it right away.
+ */
+static void sched_ipi(struct k_thread *thread)
+{
+	int me = _current_cpu->id;
+	int target = -1;
+
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	/* Only the CPU whose queue holds the thread will look at it */
+	if (thread->base.cpu != me &&
+	    cpu_should_preempt(&_kernel.cpus[thread->base.cpu], thread)) {
+		target = thread->base.cpu;
+	}
+#else
+	/* Prefer the current CPU, then an idle one, then the one
+	 * running the lowest priority thread
+	 */
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		struct _cpu *c = &_kernel.cpus[i];
+
+		if (!cpu_should_preempt(c, thread)) {
+			continue;
+		}
+
+		if (i == me) {
+			return;
+		}
+
+		if (target < 0 || _is_idle(c->current) ||
+		    (!_is_idle(_kernel.cpus[target].current) &&
+		     _is_t1_higher_prio_than_t2(_kernel.cpus[target].current,
+						c->current))) {
+			target = i;
+		}
+	}
+#endif
+
+	if (target >= 0) {
+		_arch_sched_ipi(BIT(target));
+	}
+}
+#else
+#define sched_ipi(thread) do { } while (0)
+#endif
+
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+static void cbs_wakeup(struct k_thread *thread);
+#endif
+
 void _add_thread_to_ready_q(struct k_thread *thread)
 {
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	thread->runtime.ready_since = k_cycle_get_32();
+#endif
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	if (thread->cbs.budget) {
+		cbs_wakeup(thread);
+	}
+#endif
+
 	LOCKED(&sched_lock) {
-		_priq_run_add(&_kernel.ready_q.runq, thread);
-		_mark_thread_as_queued(thread);
+		runq_add(thread);
 		update_cache(0);
+		sched_ipi(thread);
 	}
 }
 
 void _move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	LOCKED(&sched_lock) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
-		_mark_thread_as_queued(thread);
+		runq_remove(thread);
+		runq_add(thread);
 		update_cache(0);
 	}
 }
@@ -248,8 +474,7 @@ void _remove_thread_from_ready_q(struct k_thread *thread)
 {
 	LOCKED(&sched_lock) {
 		if (_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			_mark_thread_as_not_queued(thread);
+			runq_remove(thread);
 			update_cache(thread == _current);
 		}
 	}
@@ -257,6 +482,7 @@ void _remove_thread_from_ready_q(struct k_thread *thread)
 
 static void pend(struct k_thread *thread, _wait_q_t *wait_q, s32_t timeout)
 {
+	_sched_trace_pend(thread);
 	_remove_thread_from_ready_q(thread);
 	_mark_thread_as_pending(thread);
 
@@ -318,6 +544,8 @@ struct k_thread *_find_first_thread_to_unpend(_wait_q_t *wait_q,
 
 void _unpend_thread_no_timeout(struct k_thread *thread)
 {
+	_sched_trace_unpend(thread);
+
 	LOCKED(&sched_lock) {
 		_priq_wait_remove(&pended_on(thread)->waitq, thread);
 		_mark_thread_as_not_pending(thread);
@@ -334,12 +562,52 @@ int _pend_current_thread(int key, _wait_q_t *wait_q, s32_t timeout)
 	return _Swap(key);
 }
 
+int _pend_curr_spinlock(struct k_spinlock *lock, k_spinlock_key_t key,
+			_wait_q_t *wait_q, s32_t timeout)
+{
+	pend(_current, wait_q, timeout);
+	return _Swap_spinlock(lock, key);
+}
+
+/* Callers may hold only an object spinlock and not the legacy global
+ * lock, which is what still synchronizes the timeout queue.
+ */
+static void abort_thread_timeout(struct k_thread *thread)
+{
+	int key = irq_lock();
+
+	_abort_thread_timeout(thread);
+	irq_unlock(key);
+}
+
 struct k_thread *_unpend_first_thread(_wait_q_t *wait_q)
 {
 	struct k_thread *t = _unpend1_no_timeout(wait_q);
 
 	if (t) {
-		_abort_thread_timeout(t);
+		abort_thread_timeout(t);
+	}
+
+	return t;
+}
+
+/* Moves the first thread pended on a wait queue to another one
+ * without waking it up ("wait morphing"), e.g. from a condition
+ * variable to the mutex it must reacquire.  The thread no longer has
+ * a timeout, it waits on the new queue forever.
+ */
+struct k_thread *_requeue_first_thread(_wait_q_t *from, _wait_q_t *to)
+{
+	struct k_thread *t = _unpend_first_thread(from);
+
+	if (t) {
+		LOCKED(&sched_lock) {
+			_mark_thread_as_pending(t);
+#ifdef CONFIG_WAITQ_FAST
+			t->base.pended_on = to;
+#endif
+			_priq_wait_add(&to->waitq, t);
+		}
 	}
 
 	return t;
@@ -348,7 +616,7 @@ struct k_thread *_unpend_first_thread(_wait_q_t *wait_q)
 void _unpend_thread(struct k_thread *thread)
 {
 	_unpend_thread_no_timeout(thread);
-	_abort_thread_timeout(thread);
+	abort_thread_timeout(thread);
 }
 
 /* FIXME: this API is glitchy when used in SMP.  If the thread is
@@ -358,7 +626,7 @@ void _unpend_thread(struct k_thread *thread)
  * priorities on either _current or a pended thread, though, so it's
  * fine for now.
  */
-void _thread_priority_set(struct k_thread *thread, int prio)
+static int thread_priority_set(struct k_thread *thread, int prio)
 {
 	int need_sched = 0;
 
@@ -366,47 +634,92 @@ void _thread_priority_set(struct k_thread *thread, int prio)
 		need_sched = _is_thread_ready(thread);
 
 		if (need_sched) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			thread->base.prio = prio;
-			_priq_run_add(&_kernel.ready_q.runq, thread);
+			runq_add(thread);
 			update_cache(1);
+			sched_ipi(thread);
 		} else {
 			thread->base.prio = prio;
 		}
 	}
 
-	if (need_sched) {
+	return need_sched;
+}
+
+void _thread_priority_set(struct k_thread *thread, int prio)
+{
+	if (thread_priority_set(thread, prio)) {
 		_reschedule(irq_lock());
 	}
 }
 
-int _reschedule(int key)
+void _thread_priority_set_no_reschedule(struct k_thread *thread, int prio)
+{
+	(void)thread_priority_set(thread, prio);
+}
+
+void _pended_thread_priority_set(struct k_thread *thread, _wait_q_t *wait_q,
+				 int prio)
+{
+	int pending = 0;
+
+	LOCKED(&sched_lock) {
+		/* keep the wait queue sorted by priority */
+		pending = _is_thread_pending(thread);
+		if (pending) {
+			_priq_wait_remove(&wait_q->waitq, thread);
+			thread->base.prio = prio;
+			_priq_wait_add(&wait_q->waitq, thread);
+		}
+	}
+
+	if (!pending) {
+		(void)thread_priority_set(thread, prio);
+	}
+}
+
+static int resched(void)
 {
 #ifdef CONFIG_SMP
 	if (!_current_cpu->swap_ok) {
-		goto noswap;
+		return 0;
 	}
 
 	_current_cpu->swap_ok = 0;
 #endif
 
 	if (_is_in_isr()) {
-		goto noswap;
+		return 0;
 	}
 
 #ifdef CONFIG_SMP
-	return _Swap(key);
+	return 1;
 #else
-	if (_get_next_ready_thread() != _current) {
+	return _get_next_ready_thread() != _current;
+#endif
+}
+
+int _reschedule(int key)
+{
+	if (resched()) {
 		return _Swap(key);
 	}
-#endif
 
- noswap:
 	irq_unlock(key);
 	return 0;
 }
 
+int _reschedule_spinlock(struct k_spinlock *lock, k_spinlock_key_t key)
+{
+	if (resched()) {
+		return _Swap_spinlock(lock, key);
+	}
+
+	k_spin_unlock(lock, key);
+	return 0;
+}
+
 void k_sched_lock(void)
 {
 	LOCKED(&sched_lock) {
@@ -437,7 +750,7 @@ struct k_thread *_get_next_ready_thread(void)
 {
 	struct k_thread *ret = 0;
 
-	LOCKED(&sched_lock) {
+	LOCKED(_local_runq_lock) {
 		ret = next_up();
 	}
 
@@ -451,16 +764,18 @@ void *_get_next_switch_handle(void *interrupted)
 	_current->switch_handle = interrupted;
 
 #ifdef CONFIG_SMP
-	LOCKED(&sched_lock) {
+	LOCKED(_local_runq_lock) {
 		struct k_thread *th = next_up();
 
 		if (_current != th) {
 			_current_cpu->swap_ok = 0;
+			_thread_runtime_switch(_current, th);
 			_current = th;
 		}
 	}
 
 #else
+	_thread_runtime_switch(_current, _get_next_ready_thread());
 	_current = _get_next_ready_thread();
 #endif
 
@@ -557,6 +872,59 @@ struct k_thread *_priq_rb_best(struct _priq_rb *pq)
 	return CONTAINER_OF(n, struct k_thread, base.qnode_rb);
 }
 
+#ifdef CONFIG_SCHED_MULTIQ
+void _priq_mq_init(struct _priq_mq *pq)
+{
+	for (int i = 0; i < ARRAY_SIZE(pq->queues); i++) {
+		sys_dlist_init(&pq->queues[i]);
+	}
+
+	memset(pq->bitmask, 0, sizeof(pq->bitmask));
+}
+
+void _priq_mq_add(struct _priq_mq *pq, struct k_thread *thread)
+{
+	int prio_idx = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!_is_idle(thread));
+
+	sys_dlist_append(&pq->queues[prio_idx], &thread->base.qnode_dlist);
+	pq->bitmask[prio_idx >> 5] |= BIT(prio_idx & 0x1f);
+}
+
+void _priq_mq_remove(struct _priq_mq *pq, struct k_thread *thread)
+{
+	int prio_idx = thread->base.prio - K_HIGHEST_THREAD_PRIO;
+
+	__ASSERT_NO_MSG(!_is_idle(thread));
+
+	sys_dlist_remove(&thread->base.qnode_dlist);
+	if (sys_dlist_is_empty(&pq->queues[prio_idx])) {
+		pq->bitmask[prio_idx >> 5] &= ~BIT(prio_idx & 0x1f);
+	}
+}
+
+/* Lower indexes are higher priorities, so the best thread is at the
+ * head of the queue for the lowest set bit.  The loop over bitmap
+ * words is bounded at build time and is a single iteration for
+ * configurations with 32 or fewer priorities.
+ */
+struct k_thread *_priq_mq_best(struct _priq_mq *pq)
+{
+	for (int i = 0; i < _PRIQ_MQ_NUM_WORDS; i++) {
+		if (pq->bitmask[i]) {
+			int idx = (i << 5) + find_lsb_set(pq->bitmask[i]) - 1;
+			sys_dnode_t *n = sys_dlist_peek_head(&pq->queues[idx]);
+
+			return CONTAINER_OF(n, struct k_thread,
+					    base.qnode_dlist);
+		}
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_SCHED_MULTIQ */
+
 #ifdef CONFIG_TIMESLICING
 extern s32_t _time_slice_duration;    /* Measured in ms */
 extern s32_t _time_slice_elapsed;     /* Measured in ms */
@@ -587,8 +955,8 @@ int _is_thread_time_slicing(struct k_thread *thread)
 	}
 
 
-	LOCKED(&sched_lock) {
-		struct k_thread *next = _priq_run_best(&_kernel.ready_q.runq);
+	LOCKED(_local_runq_lock) {
+		struct k_thread *next = _priq_run_best(_local_runq);
 
 		if (next) {
 			ret = thread->base.prio == next->base.prio;
@@ -624,6 +992,74 @@ void _update_time_slice_before_swap(void)
 }
 #endif /* CONFIG_TIMESLICING */
 
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+/* Must be called with interrupts locked, right before a thread switch */
+void _thread_runtime_switch(struct k_thread *old_thread,
+			    struct k_thread *new_thread)
+{
+	u32_t now = k_cycle_get_32();
+	struct _thread_runtime *rt;
+	u32_t latency;
+	int bucket;
+
+	if (old_thread == new_thread) {
+		return;
+	}
+
+	rt = &old_thread->runtime;
+	rt->stats.execution_cycles += now - rt->switched_in;
+	if (_is_thread_ready(old_thread)) {
+		rt->stats.preempt_count++;
+		rt->ready_since = now;
+	}
+
+	rt = &new_thread->runtime;
+	latency = now - rt->ready_since;
+	bucket = (int)find_msb_set(latency) -
+		 CONFIG_THREAD_RUNTIME_STATS_HIST_SHIFT;
+	bucket = min(max(bucket, 0),
+		     CONFIG_THREAD_RUNTIME_STATS_HIST_BUCKETS - 1);
+
+	rt->stats.ready_latency_hist[bucket]++;
+	rt->stats.ready_latency_max = max(rt->stats.ready_latency_max,
+					  latency);
+	rt->stats.switch_count++;
+	rt->switched_in = now;
+}
+
+#ifndef CONFIG_USE_SWITCH
+/* Entry point for the arch context switch code, where the incoming
+ * thread is the cached next ready thread.
+ */
+void _thread_runtime_swap(void)
+{
+	_thread_runtime_switch(_current, _kernel.ready_q.cache);
+}
+#endif
+
+int k_thread_runtime_stats_get(k_tid_t thread,
+			       struct k_thread_runtime_stats *stats)
+{
+	unsigned int key;
+
+	if (!thread || !stats) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	*stats = thread->runtime.stats;
+	if (thread == _current) {
+		stats->execution_cycles +=
+			k_cycle_get_32() - thread->runtime.switched_in;
+	}
+
+	irq_unlock(key);
+
+	return 0;
+}
+#endif /* CONFIG_THREAD_RUNTIME_STATS */
+
 int _unpend_all(_wait_q_t *waitq)
 {
 	int need_sched = 0;
@@ -638,12 +1074,14 @@ int _unpend_all(_wait_q_t *waitq)
 	return need_sched;
 }
 
-void _sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
-#ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+#if defined(CONFIG_SCHED_DUMB)
+	sys_dlist_init(&rq->runq);
+#elif defined(CONFIG_SCHED_MULTIQ)
+	_priq_mq_init(&rq->runq);
 #else
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = _priq_rb_lessthan,
 		}
@@ -651,6 +1089,17 @@ void _sched_init(void)
 #endif
 }
 
+void _sched_init(void)
+{
+#ifdef CONFIG_SCHED_PER_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
+	}
+#else
+	init_ready_q(&_kernel.ready_q);
+#endif
+}
+
 int _impl_k_thread_priority_get(k_tid_t thread)
 {
 	return thread->base.prio;
@@ -700,8 +1149,8 @@ void _impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_lock) {
 		th->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (_is_thread_queued(th)) {
-			_priq_run_remove(&_kernel.ready_q.runq, th);
-			_priq_run_add(&_kernel.ready_q.runq, th);
+			runq_remove(th);
+			runq_add(th);
 		}
 	}
 }
@@ -722,14 +1171,187 @@ Z_SYSCALL_HANDLER(k_thread_deadline_set, thread_p, deadline)
 #endif
 #endif
 
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+/* total bandwidth of the servers, in 1/1024th */
+static u32_t cbs_total_bandwidth;
+
+#define CBS_MAX_BANDWIDTH \
+	((CONFIG_SCHED_DEADLINE_CBS_MAX_BANDWIDTH * 1024) / 100)
+
+static inline int cbs_period_cycles(struct k_thread *thread)
+{
+	return thread->cbs.period * sys_clock_hw_cycles_per_tick;
+}
+
+static void cbs_deadline_set(struct k_thread *thread, int deadline)
+{
+	LOCKED(&sched_lock) {
+		thread->base.prio_deadline = deadline;
+		if (_is_thread_queued(thread)) {
+			runq_remove(thread);
+			runq_add(thread);
+		}
+	}
+}
+
+/*
+ * CBS wakeup rule: a thread resuming with more budget than its bandwidth
+ * allows it to consume until its deadline would get more than its share of
+ * the CPU, so it is given a fresh period instead.
+ */
+static void cbs_wakeup(struct k_thread *thread)
+{
+	int now = (int)k_cycle_get_32();
+	s64_t left = thread->base.prio_deadline - now;
+
+	if (left <= 0 ||
+	    (s64_t)thread->cbs.remaining * cbs_period_cycles(thread) >=
+	    left * thread->cbs.budget) {
+		thread->cbs.remaining = thread->cbs.budget;
+		thread->base.prio_deadline = now + cbs_period_cycles(thread);
+	}
+}
+
+static void cbs_replenish(struct _timeout *timeout)
+{
+	struct k_thread *thread =
+		CONTAINER_OF(timeout, struct k_thread, cbs.timeout);
+	unsigned int key = irq_lock();
+
+	thread->cbs.remaining = thread->cbs.budget;
+	thread->base.prio_deadline += cbs_period_cycles(thread);
+	thread->base.thread_state &= ~_THREAD_THROTTLED;
+	_ready_thread(thread);
+
+	_reschedule(key);
+}
+
+/* Always called from the system clock interrupt, for the current thread */
+void _sched_cbs_tick(s32_t ticks)
+{
+	struct k_thread *thread = _current;
+	unsigned int key;
+
+	if (!thread->cbs.budget) {
+		return;
+	}
+
+	key = irq_lock();
+
+	thread->cbs.remaining -= ticks;
+	if (thread->cbs.remaining <= 0 && _is_thread_ready(thread)) {
+		int left = thread->base.prio_deadline - (int)k_cycle_get_32();
+		s32_t delay = left / sys_clock_hw_cycles_per_tick;
+
+		/* throttle until the end of the current period */
+		_remove_thread_from_ready_q(thread);
+		thread->base.thread_state |= _THREAD_THROTTLED;
+		_add_timeout(NULL, &thread->cbs.timeout, NULL,
+			     delay > 0 ? delay : 1);
+	}
+
+	irq_unlock(key);
+}
+
+/* Release the server of a thread: called with interrupts locked */
+static void cbs_release(struct k_thread *thread)
+{
+	_abort_timeout(&thread->cbs.timeout);
+	cbs_total_bandwidth -= thread->cbs.bandwidth;
+	thread->cbs.bandwidth = 0;
+	thread->cbs.budget = 0;
+
+	if (thread->base.thread_state & _THREAD_THROTTLED) {
+		thread->base.thread_state &= ~_THREAD_THROTTLED;
+		_ready_thread(thread);
+	}
+}
+
+void _sched_cbs_abort(struct k_thread *thread)
+{
+	unsigned int key = irq_lock();
+
+	if (thread->cbs.budget) {
+		cbs_release(thread);
+	}
+
+	irq_unlock(key);
+}
+
+int _impl_k_thread_cbs_set(k_tid_t tid, u32_t budget, u32_t period)
+{
+	struct k_thread *thread = tid;
+	s32_t budget_ticks, period_ticks;
+	u32_t bandwidth;
+	unsigned int key;
+
+	if (!budget) {
+		key = irq_lock();
+		if (thread->cbs.budget) {
+			cbs_release(thread);
+		}
+		_reschedule(key);
+
+		return 0;
+	}
+
+	if (budget > period || period > INT32_MAX) {
+		return -EINVAL;
+	}
+
+	budget_ticks = max(_ms_to_ticks(budget), 1);
+	period_ticks = max(_ms_to_ticks(period), budget_ticks);
+	bandwidth = ceiling_fraction(budget_ticks * 1024, period_ticks);
+
+	key = irq_lock();
+
+	if (cbs_total_bandwidth - thread->cbs.bandwidth + bandwidth >
+	    CBS_MAX_BANDWIDTH) {
+		irq_unlock(key);
+		return -EBUSY;
+	}
+
+	if (!thread->cbs.budget) {
+		_init_timeout(&thread->cbs.timeout, cbs_replenish);
+	}
+
+	cbs_total_bandwidth += bandwidth - thread->cbs.bandwidth;
+	thread->cbs.bandwidth = bandwidth;
+	thread->cbs.budget = budget_ticks;
+	thread->cbs.period = period_ticks;
+
+	/* start a new period, unless throttled until the current one ends */
+	if (!(thread->base.thread_state & _THREAD_THROTTLED)) {
+		thread->cbs.remaining = budget_ticks;
+		cbs_deadline_set(thread, (int)k_cycle_get_32() +
+				 cbs_period_cycles(thread));
+	}
+
+	_reschedule(key);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_thread_cbs_set, thread_p, budget, period)
+{
+	struct k_thread *thread = (struct k_thread *)thread_p;
+
+	Z_OOPS(Z_SYSCALL_OBJ(thread, K_OBJ_THREAD));
+
+	return _impl_k_thread_cbs_set((k_tid_t)thread, budget, period);
+}
+#endif
+#endif /* CONFIG_SCHED_DEADLINE_CBS */
+
 void _impl_k_yield(void)
 {
 	__ASSERT(!_is_in_isr(), "");
 
 	if (!_is_idle(_current)) {
 		LOCKED(&sched_lock) {
-			_priq_run_remove(&_kernel.ready_q.runq, _current);
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_remove(_current);
+			runq_add(_current);
 			update_cache(1);
 		}
 	}
@@ -819,6 +1441,48 @@ void _impl_k_wakeup(k_tid_t thread)
 Z_SYSCALL_HANDLER1_SIMPLE_VOID(k_wakeup, K_OBJ_THREAD, k_tid_t);
 #endif
 
+#ifdef CONFIG_SCHED_CPU_MASK
+static int cpu_mask_mod(k_tid_t t, u32_t enable_mask, u32_t disable_mask)
+{
+	int ret = 0;
+
+	LOCKED(&sched_lock) {
+		if (_is_thread_prevented_from_running(t)) {
+			t->base.cpu_mask |= enable_mask;
+			t->base.cpu_mask &= ~disable_mask;
+		} else {
+			ret = -EINVAL;
+		}
+	}
+
+	return ret;
+}
+
+int k_thread_cpu_mask_clear(k_tid_t thread)
+{
+	return cpu_mask_mod(thread, 0, 0xffffffff);
+}
+
+int k_thread_cpu_mask_enable_all(k_tid_t thread)
+{
+	return cpu_mask_mod(thread, BIT(CONFIG_MP_NUM_CPUS) - 1, 0);
+}
+
+int k_thread_cpu_mask_enable(k_tid_t thread, int cpu)
+{
+	__ASSERT(cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS, "invalid cpu %d", cpu);
+
+	return cpu_mask_mod(thread, BIT(cpu), 0);
+}
+
+int k_thread_cpu_mask_disable(k_tid_t thread, int cpu)
+{
+	__ASSERT(cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS, "invalid cpu %d", cpu);
+
+	return cpu_mask_mod(thread, 0, BIT(cpu));
+}
+#endif /* CONFIG_SCHED_CPU_MASK */
+
 k_tid_t _impl_k_current_get(void)
 {
 	return _current;
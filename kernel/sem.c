@@ -85,7 +85,11 @@ Z_SYSCALL_HANDLER(k_sem_init, sem, initial_count, limit)
 static inline void handle_poll_events(struct k_sem *sem)
 {
 #ifdef CONFIG_POLL
+	/* k_poll() still synchronizes its event lists with irq_lock() */
+	unsigned int key = irq_lock();
+
 	_handle_obj_poll_events(&sem->poll_events, K_POLL_STATE_SEM_AVAILABLE);
+	irq_unlock(key);
 #endif
 }
 
@@ -132,10 +136,10 @@ void _sem_give_non_preemptible(struct k_sem *sem)
 
 void _impl_k_sem_give(struct k_sem *sem)
 {
-	unsigned int key = irq_lock();
+	k_spinlock_key_t key = k_spin_lock(&sem->lock);
 
 	do_sem_give(sem);
-	_reschedule(key);
+	_reschedule_spinlock(&sem->lock, key);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -146,20 +150,20 @@ int _impl_k_sem_take(struct k_sem *sem, s32_t timeout)
 {
 	__ASSERT(!_is_in_isr() || timeout == K_NO_WAIT, "");
 
-	unsigned int key = irq_lock();
+	k_spinlock_key_t key = k_spin_lock(&sem->lock);
 
 	if (likely(sem->count > 0)) {
 		sem->count--;
-		irq_unlock(key);
+		k_spin_unlock(&sem->lock, key);
 		return 0;
 	}
 
 	if (timeout == K_NO_WAIT) {
-		irq_unlock(key);
+		k_spin_unlock(&sem->lock, key);
 		return -EBUSY;
 	}
 
-	return _pend_current_thread(key, &sem->wait_q, timeout);
+	return _pend_curr_spinlock(&sem->lock, key, &sem->wait_q, timeout);
 }
 
 #ifdef CONFIG_USERSPACE
@@ -13,6 +13,7 @@
 #include <wait_q.h>
 #include <drivers/system_timer.h>
 #include <syscall_handler.h>
+#include <init.h>
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 #ifdef _NON_OPTIMIZED_TICKS_PER_SEC
@@ -136,6 +137,39 @@ Z_SYSCALL_HANDLER(k_uptime_get, ret_p)
 }
 #endif
 
+/* upper word and last value of the 64-bit hardware clock */
+static u32_t cycle_high;
+static u32_t cycle_last;
+
+u64_t _impl_k_cycle_get_64(void)
+{
+	unsigned int key = irq_lock();
+	u32_t now = k_cycle_get_32();
+	u64_t cycles;
+
+	if (now < cycle_last) {
+		cycle_high++;
+	}
+
+	cycle_last = now;
+	cycles = ((u64_t)cycle_high << 32) | now;
+
+	irq_unlock(key);
+
+	return cycles;
+}
+
+#ifdef CONFIG_USERSPACE
+Z_SYSCALL_HANDLER(k_cycle_get_64, ret_p)
+{
+	u64_t *ret = (u64_t *)ret_p;
+
+	Z_OOPS(Z_SYSCALL_MEMORY_WRITE(ret, sizeof(*ret)));
+	*ret = _impl_k_cycle_get_64();
+	return 0;
+}
+#endif
+
 s64_t k_uptime_delta(s64_t *reftime)
 {
 	s64_t uptime, delta;
@@ -169,6 +203,162 @@ u32_t k_uptime_delta_32(s64_t *reftime)
 
 volatile int _handling_timeouts;
 
+#ifdef CONFIG_TIMEOUT_OFFLOAD
+/*
+ * With timeout offloading, the tick ISR only moves the expired timeouts to
+ * expired_q and wakes up the offload thread, which readies the threads and
+ * runs the timer expiry functions in batches, at thread level. Timeouts
+ * sitting on expired_q are still marked _EXPIRED until handled.
+ */
+static sys_dlist_t expired_q = SYS_DLIST_STATIC_INIT(&expired_q);
+static K_SEM_DEFINE(expired_sem, 0, 1);
+
+static K_THREAD_STACK_DEFINE(timeout_offload_stack,
+			     CONFIG_TIMEOUT_OFFLOAD_STACK_SIZE);
+static struct k_thread timeout_offload_thread_data;
+
+static void timeout_offload_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_sem_take(&expired_sem, K_FOREVER);
+
+		while (1) {
+			unsigned int key = irq_lock();
+			sys_dnode_t *node = sys_dlist_get(&expired_q);
+
+			if (!node) {
+				irq_unlock(key);
+				break;
+			}
+
+			/*
+			 * Self-link the node so that an _abort_timeout() racing
+			 * with the handling below does not touch expired_q.
+			 */
+			node->next = node;
+			node->prev = node;
+
+			irq_unlock(key);
+
+			_handle_one_expired_timeout(
+				CONTAINER_OF(node, struct _timeout, node));
+		}
+	}
+}
+
+static int timeout_offload_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_thread_create(&timeout_offload_thread_data, timeout_offload_stack,
+			K_THREAD_STACK_SIZEOF(timeout_offload_stack),
+			timeout_offload_thread, NULL, NULL, NULL,
+			CONFIG_TIMEOUT_OFFLOAD_PRIORITY, 0, K_FOREVER);
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	/* sys_clock timekeeping happens only on the main CPU */
+	k_thread_cpu_mask_clear(&timeout_offload_thread_data);
+	k_thread_cpu_mask_enable(&timeout_offload_thread_data, 0);
+#endif
+
+	k_thread_start(&timeout_offload_thread_data);
+
+	return 0;
+}
+
+SYS_INIT(timeout_offload_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_TIMEOUT_OFFLOAD */
+
+/*
+ * Hand the timeouts collected by handle_timeouts() over for handling: either
+ * right away, in the tick ISR, or to the offload thread in one batch.
+ */
+static inline void dispatch_expired_timeouts(sys_dlist_t *expired)
+{
+#ifdef CONFIG_TIMEOUT_OFFLOAD
+	sys_dnode_t *node;
+	unsigned int key;
+
+	if (sys_dlist_is_empty(expired)) {
+		return;
+	}
+
+	key = irq_lock();
+	while ((node = sys_dlist_get(expired)) != NULL) {
+		sys_dlist_append(&expired_q, node);
+	}
+	irq_unlock(key);
+
+	k_sem_give(&expired_sem);
+#else
+	_handle_expired_timeouts(expired);
+#endif
+}
+
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+int _timeout_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	struct _timeout *ta = CONTAINER_OF(a, struct _timeout, rbnode);
+	struct _timeout *tb = CONTAINER_OF(b, struct _timeout, rbnode);
+
+	if (ta->expiry != tb->expiry) {
+		return ta->expiry < tb->expiry;
+	}
+
+	/* The tree needs a strict ordering to find nodes on removal;
+	 * the insertion sequence also makes same-tick expiry FIFO.
+	 */
+	return (s32_t)(ta->order_key - tb->order_key) < 0;
+}
+
+/*
+ * With the tree, advancing time is just moving the time base: every
+ * timeout whose absolute expiry is now in the past is at the left of
+ * the tree and is moved to the expired list, relieving the irq lock
+ * in between each one as for the list implementation.
+ */
+static inline void handle_timeouts(s32_t ticks)
+{
+	sys_dlist_t expired;
+	unsigned int key;
+	struct rbnode *n;
+
+	sys_dlist_init(&expired);
+
+	key = irq_lock();
+
+	_kernel.timeout_tick += ticks;
+
+	_handling_timeouts = 1;
+
+	while ((n = rb_get_min(&_timeout_q)) != NULL) {
+		struct _timeout *timeout =
+			CONTAINER_OF(n, struct _timeout, rbnode);
+
+		if (timeout->expiry > _kernel.timeout_tick) {
+			break;
+		}
+
+		rb_remove(&_timeout_q, n);
+		timeout->delta_ticks_from_prev = _EXPIRED;
+		sys_dlist_append(&expired, &timeout->node);
+
+		irq_unlock(key);
+		key = irq_lock();
+	}
+
+	irq_unlock(key);
+
+	dispatch_expired_timeouts(&expired);
+
+	_handling_timeouts = 0;
+}
+#else
 static inline void handle_timeouts(s32_t ticks)
 {
 	sys_dlist_t expired;
@@ -253,10 +443,11 @@ static inline void handle_timeouts(s32_t ticks)
 
 	irq_unlock(key);
 
-	_handle_expired_timeouts(&expired);
+	dispatch_expired_timeouts(&expired);
 
 	_handling_timeouts = 0;
 }
+#endif /* CONFIG_TIMEOUT_QUEUE_RBTREE */
 #else
 	#define handle_timeouts(ticks) do { } while ((0))
 #endif
@@ -334,11 +525,16 @@ void _nano_sys_clock_tick_announce(s32_t ticks)
 	_sys_clock_tick_count += ticks;
 	irq_unlock(key);
 #endif
+	/* keep track of the wrap arounds of the hardware clock */
+	(void)_impl_k_cycle_get_64();
+
 	handle_timeouts(ticks);
 
 	/* time slicing is basically handled like just yet another timeout */
 	handle_time_slicing(ticks);
 
+	_sched_cbs_tick(ticks);
+
 #ifdef CONFIG_TICKLESS_KERNEL
 	u32_t next_to = _get_next_timeout_expiry();
 
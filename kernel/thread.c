@@ -18,6 +18,7 @@
 
 #include <kernel_structs.h>
 #include <misc/printk.h>
+#include <misc/stack.h>
 #include <sys_clock.h>
 #include <drivers/system_timer.h>
 #include <ksched.h>
@@ -27,6 +28,7 @@
 #include <kernel_internal.h>
 #include <kswap.h>
 #include <init.h>
+#include <string.h>
 
 extern struct _static_thread_data _static_thread_data_list_start[];
 extern struct _static_thread_data _static_thread_data_list_end[];
@@ -209,6 +211,32 @@ void _check_stack_sentinel(void)
 }
 #endif
 
+#ifdef CONFIG_THREAD_STACK_WATERMARK
+/* Update the lowest unused stack space of the outgoing thread in _Swap()
+ *
+ * Only the highest word of the stack known to be unused is checked, the
+ * stack is scanned again when that word was written. A deeper use which
+ * leaves that word untouched, e.g. a partly written local array, is only
+ * seen by a later scan.
+ */
+void _check_stack_watermark(void)
+{
+	struct _thread_stack_info *info = &_current->stack_info;
+	u32_t unused = info->unused & ~3;
+
+	if (_current->base.thread_state & _THREAD_DUMMY) {
+		return;
+	}
+
+	if (unused < sizeof(u32_t) ||
+	    *(u32_t *)(info->start + unused - sizeof(u32_t)) == 0xaaaaaaaa) {
+		return;
+	}
+
+	info->unused = stack_unused_space_get((char *)info->start, unused);
+}
+#endif
+
 #ifdef CONFIG_MULTITHREADING
 void _impl_k_thread_start(struct k_thread *thread)
 {
@@ -310,10 +338,24 @@ void _setup_new_thread(struct k_thread *new_thread,
 	_kernel.threads = new_thread;
 	irq_unlock(key);
 #endif
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	memset(&new_thread->runtime, 0, sizeof(new_thread->runtime));
+#endif
+#ifdef CONFIG_SCHED_DEADLINE_CBS
+	new_thread->cbs.budget = 0;
+	new_thread->cbs.bandwidth = 0;
+#endif
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	sys_dlist_init(&new_thread->mutex_pi.held);
+	new_thread->mutex_pi.pended_on = NULL;
+#endif
 #ifdef CONFIG_USERSPACE
 	_k_object_init(new_thread);
 	_k_object_init(stack);
 	new_thread->stack_obj = stack;
+#ifdef CONFIG_USERSPACE_OBJ_CACHE
+	new_thread->obj_cache.gen = 0;
+#endif
 
 	/* Any given thread has access to itself */
 	k_object_access_grant(new_thread, new_thread);
@@ -519,6 +561,8 @@ void _k_thread_single_abort(struct k_thread *thread)
 		thread->fn_abort();
 	}
 
+	_sched_cbs_abort(thread);
+
 	if (_is_thread_ready(thread)) {
 		_remove_thread_from_ready_q(thread);
 	} else {
@@ -624,6 +668,14 @@ void _init_thread_base(struct _thread_base *thread_base, int priority,
 
 	thread_base->sched_locked = 0;
 
+#ifdef CONFIG_SMP
+	thread_base->cpu = 0;
+#endif
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	thread_base->cpu_mask = BIT(CONFIG_MP_NUM_CPUS) - 1;
+#endif
+
 	/* swap_data does not need to be initialized */
 
 	_init_thread_timeout(thread_base);
@@ -666,3 +718,15 @@ FUNC_NORETURN void k_thread_user_mode_enter(k_thread_entry_t entry,
 	_thread_entry(entry, p1, p2, p3);
 #endif
 }
+
+#ifdef CONFIG_FP_SHARING_STATS
+void k_float_stats_get(struct k_float_stats *stats)
+{
+	unsigned int key = irq_lock();
+
+	stats->saves = _kernel.fp_saves;
+	stats->saves_avoided = _kernel.fp_saves_avoided;
+
+	irq_unlock(key);
+}
+#endif
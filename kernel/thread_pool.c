@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * Thread pools: parked threads which run entry functions on demand
+ *
+ * Idle workers wait on their own semaphore and are kept in a LIFO, so that
+ * the most recently used worker, whose stack is the most likely to still
+ * be cached, is dispatched first. A dispatch takes an idle worker, hands it
+ * the function and gives its semaphore: no thread is created.
+ */
+
+#include <kernel.h>
+#include <errno.h>
+
+static void thread_pool_main(void *worker_ptr, void *p2, void *p3)
+{
+	struct k_thread_pool_worker *worker = worker_ptr;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (1) {
+		k_lifo_put(&worker->pool->idle, worker);
+		k_sem_take(&worker->start, K_FOREVER);
+
+		worker->entry(worker->p1, worker->p2, worker->p3);
+	}
+}
+
+void k_thread_pool_init(struct k_thread_pool *pool, int prio)
+{
+	k_lifo_init(&pool->idle);
+	pool->prio = prio;
+}
+
+void k_thread_pool_add_worker(struct k_thread_pool *pool,
+			      struct k_thread_pool_worker *worker,
+			      k_thread_stack_t *stack, size_t stack_size)
+{
+	worker->pool = pool;
+	k_sem_init(&worker->start, 0, 1);
+
+	k_thread_create(&worker->thread, stack, stack_size, thread_pool_main,
+			worker, NULL, NULL, pool->prio, 0, K_NO_WAIT);
+}
+
+int k_thread_pool_dispatch(struct k_thread_pool *pool,
+			   k_thread_entry_t entry,
+			   void *p1, void *p2, void *p3, s32_t timeout)
+{
+	struct k_thread_pool_worker *worker;
+
+	worker = k_lifo_get(&pool->idle, timeout);
+	if (!worker) {
+		return -EAGAIN;
+	}
+
+	worker->entry = entry;
+	worker->p1 = p1;
+	worker->p2 = p2;
+	worker->p3 = p3;
+
+	k_sem_give(&worker->start);
+
+	return 0;
+}
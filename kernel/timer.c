@@ -235,6 +235,13 @@ s32_t _timeout_remaining_get(struct _timeout *timeout)
 
 	if (timeout->delta_ticks_from_prev == _INACTIVE) {
 		remaining_ticks = 0;
+#ifdef CONFIG_TIMEOUT_QUEUE_RBTREE
+	} else if (timeout->delta_ticks_from_prev == _EXPIRED) {
+		remaining_ticks = 0;
+	} else {
+		remaining_ticks = timeout->expiry - _kernel.timeout_tick;
+	}
+#else
 	} else {
 		/*
 		 * compute remaining ticks by walking the timeout list
@@ -250,6 +257,7 @@ s32_t _timeout_remaining_get(struct _timeout *timeout)
 			remaining_ticks += t->delta_ticks_from_prev;
 		}
 	}
+#endif
 
 	irq_unlock(key);
 	return __ticks_to_ms(remaining_ticks);
@@ -47,6 +47,40 @@ struct perm_ctx {
 	struct k_thread *parent;
 };
 
+#ifdef CONFIG_USERSPACE_OBJ_CACHE
+BUILD_ASSERT_MSG((CONFIG_USERSPACE_OBJ_CACHE_SIZE &
+		  (CONFIG_USERSPACE_OBJ_CACHE_SIZE - 1)) == 0,
+		 "CONFIG_USERSPACE_OBJ_CACHE_SIZE must be a power of 2");
+
+/* Bumped whenever a cached lookup may have become stale, flushing the
+ * caches of all threads on their next lookup. Starts at 1 so that zeroed
+ * thread caches are invalid.
+ */
+static atomic_t obj_cache_gen = ATOMIC_INIT(1);
+
+static void obj_cache_invalidate(void)
+{
+	atomic_inc(&obj_cache_gen);
+}
+
+static struct _k_object_cache *obj_cache_get(void)
+{
+	struct _k_object_cache *cache = &_current->obj_cache;
+	u32_t gen = atomic_get(&obj_cache_gen);
+
+	if (cache->gen != gen) {
+		memset(cache->obj, 0, sizeof(cache->obj));
+		cache->index = -2;
+		cache->gen = gen;
+	}
+
+	return cache;
+}
+
+#else
+#define obj_cache_invalidate() do { } while (0)
+#endif
+
 #ifdef CONFIG_DYNAMIC_OBJECTS
 struct dyn_obj {
 	struct _k_object kobj;
@@ -174,6 +208,7 @@ void k_object_free(void *obj)
 	if (dyn_obj) {
 		rb_remove(&obj_rb_tree, &dyn_obj->node);
 		sys_dlist_remove(&dyn_obj->obj_list);
+		obj_cache_invalidate();
 	}
 	irq_unlock(key);
 
@@ -200,6 +235,27 @@ struct _k_object *_k_object_find(void *obj)
 	return ret;
 }
 
+#ifdef CONFIG_USERSPACE_OBJ_CACHE
+struct _k_object *_k_object_find_cached(void *obj)
+{
+	struct _k_object_cache *cache = obj_cache_get();
+	u32_t slot = ((u32_t)obj >> 3) & (CONFIG_USERSPACE_OBJ_CACHE_SIZE - 1);
+	struct _k_object *ko;
+
+	if (obj && cache->obj[slot] == obj) {
+		return cache->ko[slot];
+	}
+
+	ko = _k_object_find(obj);
+	if (ko) {
+		cache->obj[slot] = obj;
+		cache->ko[slot] = ko;
+	}
+
+	return ko;
+}
+#endif
+
 void _k_object_wordlist_foreach(_wordlist_cb_func_t func, void *context)
 {
 	int key;
@@ -228,6 +284,21 @@ static int thread_index_get(struct k_thread *t)
 	return ko->data;
 }
 
+static int current_index_get(void)
+{
+#ifdef CONFIG_USERSPACE_OBJ_CACHE
+	struct _k_object_cache *cache = obj_cache_get();
+
+	if (cache->index == -2) {
+		cache->index = thread_index_get(_current);
+	}
+
+	return cache->index;
+#else
+	return thread_index_get(_current);
+#endif
+}
+
 static void unref_check(struct _k_object *ko)
 {
 	for (int i = 0; i < CONFIG_MAX_THREAD_BYTES; i++) {
@@ -261,6 +332,7 @@ static void unref_check(struct _k_object *ko)
 			CONTAINER_OF(ko, struct dyn_obj, kobj);
 		rb_remove(&obj_rb_tree, &dyn_obj->node);
 		sys_dlist_remove(&dyn_obj->obj_list);
+		obj_cache_invalidate();
 		k_free(dyn_obj);
 	}
 #endif
@@ -327,6 +399,7 @@ void _thread_perms_all_clear(struct k_thread *thread)
 
 	if (index != -1) {
 		_k_object_wordlist_foreach(clear_perms_cb, (void *)index);
+		obj_cache_invalidate();
 	}
 }
 
@@ -338,7 +411,7 @@ static int thread_perms_test(struct _k_object *ko)
 		return 1;
 	}
 
-	index = thread_index_get(_current);
+	index = current_index_get();
 	if (index != -1) {
 		return sys_bitfield_test_bit((mem_addr_t)&ko->perms, index);
 	}
@@ -13,7 +13,7 @@ static struct _k_object *validate_any_object(void *obj)
 	struct _k_object *ko;
 	int ret;
 
-	ko = _k_object_find(obj);
+	ko = _k_object_find_cached(obj);
 
 	/* This can be any kernel object and it doesn't have to be
 	 * initialized
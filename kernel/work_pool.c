@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * Work pools: workqueues served by several threads
+ *
+ * Every priority level is a k_queue shared by all the workers, the lowest
+ * one being the pool's k_work_q, so that the regular workqueue APIs can
+ * submit to the pool. An idle worker takes the first item of the most
+ * urgent non-empty level, and otherwise waits with k_poll() on all the
+ * levels: each submitted item wakes up one idle worker.
+ */
+
+#include <kernel_structs.h>
+#include <wait_q.h>
+#include <errno.h>
+
+static inline struct k_queue *pool_queue(struct k_work_pool *pool, int prio)
+{
+	return prio == K_WORK_POOL_PRIO_DEFAULT ?
+		&pool->work_q.queue : &pool->queues[prio];
+}
+
+static struct k_work *pool_work_get(struct k_work_pool *pool)
+{
+	struct k_work *work;
+
+	for (int prio = 0; prio <= K_WORK_POOL_PRIO_DEFAULT; prio++) {
+		work = k_queue_get(pool_queue(pool, prio), K_NO_WAIT);
+		if (work) {
+			return work;
+		}
+	}
+
+	return NULL;
+}
+
+static void pool_work_run(struct k_work_pool *pool, struct k_work *work)
+{
+	k_work_handler_t handler = work->handler;
+	u32_t start = k_cycle_get_32();
+	u32_t latency = start - work->queued_at;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&pool->lock);
+	pool->busy++;
+	k_spin_unlock(&pool->lock, key);
+
+	/* Reset pending state so it can be resubmitted by handler */
+	if (atomic_test_and_clear_bit(work->flags, K_WORK_STATE_PENDING)) {
+		handler(work);
+	}
+
+	/* the handler may have freed the item: only use local values */
+	u32_t run = k_cycle_get_32() - start;
+
+	key = k_spin_lock(&pool->lock);
+	pool->busy--;
+	pool->executed++;
+	pool->latency_total += latency;
+	pool->latency_max = max(pool->latency_max, latency);
+	pool->run_max = max(pool->run_max, run);
+	k_spin_unlock(&pool->lock, key);
+}
+
+static void work_pool_main(void *pool_ptr, void *p2, void *p3)
+{
+	struct k_work_pool *pool = pool_ptr;
+	struct k_poll_event events[CONFIG_WORK_POOL_PRIORITIES];
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (int prio = 0; prio <= K_WORK_POOL_PRIO_DEFAULT; prio++) {
+		k_poll_event_init(&events[prio], K_POLL_TYPE_DATA_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY,
+				  pool_queue(pool, prio));
+	}
+
+	while (1) {
+		struct k_work *work = pool_work_get(pool);
+
+		if (!work) {
+			for (int prio = 0; prio <= K_WORK_POOL_PRIO_DEFAULT;
+			     prio++) {
+				events[prio].state = K_POLL_STATE_NOT_READY;
+			}
+			k_poll(events, ARRAY_SIZE(events), K_FOREVER);
+			continue;
+		}
+
+		pool_work_run(pool, work);
+
+		/* Make sure we don't hog up the CPU if the queues never (or
+		 * very rarely) get empty.
+		 */
+		k_yield();
+	}
+}
+
+static void pool_worker_create(struct k_work_pool *pool,
+			       struct k_thread *thread,
+			       k_thread_stack_t *stack, size_t stack_size,
+			       int cpu)
+{
+	k_spinlock_key_t key;
+
+	k_thread_create(thread, stack, stack_size, work_pool_main,
+			pool, 0, 0, pool->prio, 0, K_FOREVER);
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if (cpu >= 0) {
+		k_thread_cpu_mask_clear(thread);
+		k_thread_cpu_mask_enable(thread, cpu);
+	}
+#else
+	__ASSERT(cpu < 0, "pinning workers requires CONFIG_SCHED_CPU_MASK");
+#endif
+
+	key = k_spin_lock(&pool->lock);
+	pool->workers++;
+	k_spin_unlock(&pool->lock, key);
+
+	k_thread_start(thread);
+}
+
+void k_work_pool_start(struct k_work_pool *pool, k_thread_stack_t *stack,
+		       size_t stack_size, int prio)
+{
+	k_queue_init(&pool->work_q.queue);
+	for (int i = 0; i < K_WORK_POOL_PRIO_DEFAULT; i++) {
+		k_queue_init(&pool->queues[i]);
+	}
+
+	pool->prio = prio;
+	pool->workers = 0;
+	pool->busy = 0;
+	pool->executed = 0;
+	pool->latency_max = 0;
+	pool->run_max = 0;
+	pool->latency_total = 0;
+
+	_k_object_init(&pool->work_q);
+	pool_worker_create(pool, &pool->work_q.thread, stack, stack_size, -1);
+}
+
+void k_work_pool_add_worker(struct k_work_pool *pool, struct k_thread *thread,
+			    k_thread_stack_t *stack, size_t stack_size, int cpu)
+{
+	pool_worker_create(pool, thread, stack, stack_size, cpu);
+}
+
+void k_work_pool_submit(struct k_work_pool *pool, struct k_work *work,
+			int prio)
+{
+	__ASSERT(prio >= 0 && prio <= K_WORK_POOL_PRIO_DEFAULT,
+		 "invalid work pool priority %d", prio);
+
+	if (!atomic_test_and_set_bit(work->flags, K_WORK_STATE_PENDING)) {
+		work->queued_at = k_cycle_get_32();
+		k_queue_append(pool_queue(pool, prio), work);
+	}
+}
+
+static u32_t pool_queue_depth(struct k_queue *queue)
+{
+	k_spinlock_key_t key;
+	sys_sfnode_t *node;
+	u32_t depth = 0;
+
+#ifdef CONFIG_QUEUE_LOCKLESS_APPEND
+	z_queue_inbox_merge(queue);
+#endif
+	key = k_spin_lock(&queue->lock);
+	SYS_SFLIST_FOR_EACH_NODE(&queue->data_q, node) {
+		depth++;
+	}
+	k_spin_unlock(&queue->lock, key);
+
+	return depth;
+}
+
+void k_work_pool_stats_get(struct k_work_pool *pool,
+			   struct k_work_pool_stats *stats)
+{
+	k_spinlock_key_t key;
+
+	for (int prio = 0; prio <= K_WORK_POOL_PRIO_DEFAULT; prio++) {
+		stats->pending[prio] = pool_queue_depth(pool_queue(pool, prio));
+	}
+
+	key = k_spin_lock(&pool->lock);
+	stats->workers = pool->workers;
+	stats->busy = pool->busy;
+	stats->executed = pool->executed;
+	stats->latency_avg = pool->executed ?
+		(u32_t)(pool->latency_total / pool->executed) : 0;
+	stats->latency_max = pool->latency_max;
+	stats->run_max = pool->run_max;
+	k_spin_unlock(&pool->lock, key);
+}
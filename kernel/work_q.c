@@ -55,6 +55,20 @@ void k_work_q_start(struct k_work_q *work_q, k_thread_stack_t *stack,
 	_k_object_init(work_q);
 }
 
+#ifdef CONFIG_SCHED_CPU_MASK
+void k_work_q_start_on_cpu(struct k_work_q *work_q, k_thread_stack_t *stack,
+			   size_t stack_size, int prio, int cpu)
+{
+	k_queue_init(&work_q->queue);
+	k_thread_create(&work_q->thread, stack, stack_size, work_q_main,
+			work_q, 0, 0, prio, 0, K_FOREVER);
+	k_thread_cpu_mask_clear(&work_q->thread);
+	k_thread_cpu_mask_enable(&work_q->thread, cpu);
+	_k_object_init(work_q);
+	k_thread_start(&work_q->thread);
+}
+#endif
+
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 static void work_timeout(struct _timeout *t)
 {
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ *
+ * Wheel work items: delayed work on a hashed timer wheel
+ *
+ * An item expiring at tick T is linked in slot (T % CONFIG_WORK_WHEEL_SLOTS)
+ * and a single kernel timeout is armed for the next non-empty slot. When the
+ * wheel reaches a slot, the items that are due are submitted and the other
+ * ones, either postponed since they were linked or more than one turn away,
+ * are linked again in the slot of their expiry.
+ *
+ * Postponing an item only updates its expiry, so a timer that keeps being
+ * reset before it expires is touched by the wheel once per reset interval
+ * at most, not once per reset.
+ */
+
+#include <kernel_structs.h>
+#include <wait_q.h>
+#include <init.h>
+#include <errno.h>
+
+#define SLOTS CONFIG_WORK_WHEEL_SLOTS
+#define SLOT_MASK (SLOTS - 1)
+
+BUILD_ASSERT_MSG((SLOTS & SLOT_MASK) == 0,
+		 "CONFIG_WORK_WHEEL_SLOTS must be a power of 2");
+
+static sys_dlist_t slots[SLOTS];
+static u32_t slot_map[SLOTS / 32];
+static u32_t num_items;
+
+/* last tick the wheel went through */
+static u32_t wheel_tick;
+
+static struct _timeout wheel_timeout;
+static u32_t armed_tick;
+static bool armed;
+
+/* all the functions below must be called with interrupts locked */
+
+static void wheel_arm(u32_t tick)
+{
+	s32_t delay;
+
+	if (armed) {
+		if ((s32_t)(tick - armed_tick) >= 0) {
+			return;
+		}
+		_abort_timeout(&wheel_timeout);
+	}
+
+	armed = true;
+	armed_tick = tick;
+
+	delay = (s32_t)(tick - _tick_get_32());
+	_add_timeout(NULL, &wheel_timeout, NULL, max(delay, 1));
+}
+
+static void wheel_link(struct k_wheel_work *work, u32_t expiry)
+{
+	u32_t idx = expiry & SLOT_MASK;
+
+	if (!num_items++ && !armed) {
+		/* nothing left to go through before now */
+		wheel_tick = _tick_get_32();
+	}
+
+	work->slot = expiry;
+	work->linked = true;
+	sys_dlist_append(&slots[idx], &work->node);
+	slot_map[idx / 32] |= BIT(idx % 32);
+
+	/* first tick after wheel_tick that falls in the slot */
+	wheel_arm(wheel_tick + 1 + ((expiry - wheel_tick - 1) & SLOT_MASK));
+}
+
+static void wheel_unlink(struct k_wheel_work *work)
+{
+	u32_t idx = work->slot & SLOT_MASK;
+
+	sys_dlist_remove(&work->node);
+	work->linked = false;
+
+	if (sys_dlist_is_empty(&slots[idx])) {
+		slot_map[idx / 32] &= ~BIT(idx % 32);
+	}
+
+	if (!--num_items && armed) {
+		_abort_timeout(&wheel_timeout);
+		armed = false;
+	}
+}
+
+/* distance from wheel_tick to the next non-empty slot, 0 if none */
+static u32_t wheel_next(void)
+{
+	u32_t dist = 1, idx, bits;
+
+	while (dist <= SLOTS) {
+		idx = (wheel_tick + dist) & SLOT_MASK;
+		bits = slot_map[idx / 32] >> (idx % 32);
+		if (bits) {
+			dist += __builtin_ctz(bits);
+			return dist <= SLOTS ? dist : 0;
+		}
+		dist += 32 - (idx % 32);
+	}
+
+	return 0;
+}
+
+static void wheel_slot_expire(u32_t idx, u32_t now)
+{
+	struct k_wheel_work *work;
+	sys_dlist_t slot;
+	sys_dnode_t *node;
+
+	/* items linked again can land in this very slot: detach it first */
+	sys_dlist_init(&slot);
+	while ((node = sys_dlist_get(&slots[idx]))) {
+		sys_dlist_append(&slot, node);
+	}
+	slot_map[idx / 32] &= ~BIT(idx % 32);
+
+	while ((node = sys_dlist_get(&slot))) {
+		work = CONTAINER_OF(node, struct k_wheel_work, node);
+
+		if ((s32_t)(work->expiry - now) > 0) {
+			u32_t expiry_idx = work->expiry & SLOT_MASK;
+
+			work->slot = work->expiry;
+			sys_dlist_append(&slots[expiry_idx], &work->node);
+			slot_map[expiry_idx / 32] |= BIT(expiry_idx % 32);
+			continue;
+		}
+
+		work->linked = false;
+		num_items--;
+		k_work_submit_to_queue(work->work_q, &work->work);
+	}
+}
+
+static void wheel_expire(struct _timeout *t)
+{
+	unsigned int key = irq_lock();
+	u32_t now = _tick_get_32();
+	u32_t ticks = min(now - wheel_tick, SLOTS);
+	u32_t dist;
+
+	ARG_UNUSED(t);
+
+	armed = false;
+
+	for (u32_t i = 1; i <= ticks; i++) {
+		wheel_slot_expire((wheel_tick + i) & SLOT_MASK, now);
+	}
+	wheel_tick = now;
+
+	dist = wheel_next();
+	if (dist) {
+		wheel_arm(wheel_tick + dist);
+	}
+
+	irq_unlock(key);
+}
+
+void k_wheel_work_init(struct k_wheel_work *work, k_work_handler_t handler)
+{
+	k_work_init(&work->work, handler);
+	work->work_q = NULL;
+	work->linked = false;
+}
+
+int k_wheel_work_submit_to_queue(struct k_work_q *work_q,
+				 struct k_wheel_work *work,
+				 s32_t delay)
+{
+	unsigned int key = irq_lock();
+	u32_t expiry;
+
+	/* Work cannot be active in multiple queues */
+	if (work->work_q && work->work_q != work_q) {
+		irq_unlock(key);
+		return -EADDRINUSE;
+	}
+
+	work->work_q = work_q;
+
+	if (!work->linked && k_work_pending(&work->work)) {
+		/* Expired but not run yet: schedule it anew */
+		if (!k_queue_remove(&work_q->queue, &work->work)) {
+			irq_unlock(key);
+			return -EINVAL;
+		}
+		atomic_clear_bit(work->work.flags, K_WORK_STATE_PENDING);
+	}
+
+	if (!delay) {
+		if (work->linked) {
+			wheel_unlink(work);
+		}
+		k_work_submit_to_queue(work_q, &work->work);
+		irq_unlock(key);
+		return 0;
+	}
+
+	expiry = _tick_get_32() + _TICK_ALIGN + _ms_to_ticks(delay);
+	work->expiry = expiry;
+
+	if (work->linked) {
+		if ((s32_t)(expiry - work->slot) >= 0) {
+			/* postponed: the wheel reaches the item earlier than
+			 * needed and then links it again
+			 */
+			irq_unlock(key);
+			return 0;
+		}
+		wheel_unlink(work);
+	}
+
+	wheel_link(work, expiry);
+	irq_unlock(key);
+
+	return 0;
+}
+
+int k_wheel_work_cancel(struct k_wheel_work *work)
+{
+	unsigned int key = irq_lock();
+
+	if (!work->work_q) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	if (work->linked) {
+		wheel_unlink(work);
+	} else if (!k_work_pending(&work->work) ||
+		   !k_queue_remove(&work->work_q->queue, &work->work)) {
+		irq_unlock(key);
+		return -EINVAL;
+	}
+
+	/* Detach from workqueue */
+	work->work_q = NULL;
+
+	atomic_clear_bit(work->work.flags, K_WORK_STATE_PENDING);
+	irq_unlock(key);
+
+	return 0;
+}
+
+s32_t k_wheel_work_remaining_get(struct k_wheel_work *work)
+{
+	unsigned int key = irq_lock();
+	s32_t ticks = 0;
+
+	if (work->linked) {
+		ticks = max((s32_t)(work->expiry - _tick_get_32()), 0);
+	}
+	irq_unlock(key);
+
+	return __ticks_to_ms(ticks);
+}
+
+static int work_wheel_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	for (int i = 0; i < SLOTS; i++) {
+		sys_dlist_init(&slots[i]);
+	}
+	_init_timeout(&wheel_timeout, wheel_expire);
+
+	return 0;
+}
+
+SYS_INIT(work_wheel_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
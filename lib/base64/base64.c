@@ -54,6 +54,47 @@ static const u8_t base64_dec_map[128] = {
 
 #define BASE64_SIZE_T_MAX	((size_t) -1) /* SIZE_T_MAX is not standard */
 
+/* Encode 3 bytes into 4 symbols */
+static inline void encode_triplet(u8_t *dst, const u8_t *src)
+{
+	u32_t w = (src[0] << 16) | (src[1] << 8) | src[2];
+
+	dst[0] = base64_enc_map[w >> 18];
+	dst[1] = base64_enc_map[(w >> 12) & 0x3F];
+	dst[2] = base64_enc_map[(w >> 6) & 0x3F];
+	dst[3] = base64_enc_map[w & 0x3F];
+}
+
+/* Decode 4 symbols into 3 bytes, unless one of them is padding, a space
+ * or not in the alphabet: the decoded values of the symbols of the
+ * alphabet fit in 6 bits, all the other ones have bit 6 set.
+ */
+static inline bool decode_quartet(u8_t *dst, const u8_t *src)
+{
+	u32_t a, b, c, d;
+
+	if ((src[0] | src[1] | src[2] | src[3]) & 0x80) {
+		return false;
+	}
+
+	a = base64_dec_map[src[0]];
+	b = base64_dec_map[src[1]];
+	c = base64_dec_map[src[2]];
+	d = base64_dec_map[src[3]];
+
+	if ((a | b | c | d) & 0x40) {
+		return false;
+	}
+
+	a = (a << 18) | (b << 12) | (c << 6) | d;
+
+	dst[0] = a >> 16;
+	dst[1] = a >> 8;
+	dst[2] = a;
+
+	return true;
+}
+
 /*
  * Encode a buffer into base64 format
  */
@@ -61,7 +102,7 @@ int base64_encode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 		  size_t slen)
 {
 	size_t i, n;
-	int C1, C2, C3;
+	int C1, C2;
 	u8_t *p;
 
 	if (slen == 0) {
@@ -85,15 +126,8 @@ int base64_encode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 
 	n = (slen / 3) * 3;
 
-	for (i = 0, p = dst; i < n; i += 3) {
-		C1 = *src++;
-		C2 = *src++;
-		C3 = *src++;
-
-		*p++ = base64_enc_map[(C1 >> 2) & 0x3F];
-		*p++ = base64_enc_map[(((C1 &  3) << 4) + (C2 >> 4)) & 0x3F];
-		*p++ = base64_enc_map[(((C2 & 15) << 2) + (C3 >> 6)) & 0x3F];
-		*p++ = base64_enc_map[C3 & 0x3F];
+	for (i = 0, p = dst; i < n; i += 3, src += 3, p += 4) {
+		encode_triplet(p, src);
 	}
 
 	if (i < slen) {
@@ -189,6 +223,17 @@ int base64_decode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 
 	for (j = 3, n = x = 0, p = dst; i > 0; i--, src++) {
 
+		/* Whole quartets of data symbols, the bulk of the input */
+		while (n == 0 && i >= 4 && decode_quartet(p, src)) {
+			p += 3;
+			src += 4;
+			i -= 4;
+		}
+
+		if (i == 0) {
+			break;
+		}
+
 		if (*src == '\r' || *src == '\n' || *src == ' ') {
 			continue;
 		}
@@ -215,3 +260,175 @@ int base64_decode(u8_t *dst, size_t dlen, size_t *olen, const u8_t *src,
 	return 0;
 }
 
+void base64_encoder_init(struct base64_encoder *enc)
+{
+	enc->len = 0;
+}
+
+int base64_encode_update(struct base64_encoder *enc, u8_t *dst, size_t dlen,
+			 size_t *olen, const u8_t *src, size_t slen)
+{
+	size_t n;
+	u8_t *p = dst;
+
+	if (slen > BASE64_SIZE_T_MAX - enc->len) {
+		*olen = BASE64_SIZE_T_MAX;
+		return -ENOMEM;
+	}
+
+	n = (enc->len + slen) / 3;
+	if (n > BASE64_SIZE_T_MAX / 4) {
+		*olen = BASE64_SIZE_T_MAX;
+		return -ENOMEM;
+	}
+
+	if (dlen < n * 4 || (n && !dst)) {
+		*olen = n * 4;
+		return -ENOMEM;
+	}
+
+	/* Complete the bytes left over by the previous call */
+	if (enc->len && enc->len + slen >= 3) {
+		while (enc->len < 3) {
+			enc->buf[enc->len++] = *src++;
+			slen--;
+		}
+
+		encode_triplet(p, enc->buf);
+		p += 4;
+		enc->len = 0;
+	}
+
+	for (; slen >= 3; slen -= 3, src += 3, p += 4) {
+		encode_triplet(p, src);
+	}
+
+	while (slen--) {
+		enc->buf[enc->len++] = *src++;
+	}
+
+	*olen = p - dst;
+
+	return 0;
+}
+
+int base64_encode_finish(struct base64_encoder *enc, u8_t *dst, size_t dlen,
+			 size_t *olen)
+{
+	if (!enc->len) {
+		*olen = 0;
+		return 0;
+	}
+
+	if (dlen < 4 || !dst) {
+		*olen = 4;
+		return -ENOMEM;
+	}
+
+	if (enc->len == 1) {
+		enc->buf[1] = 0;
+	}
+
+	enc->buf[2] = 0;
+	encode_triplet(dst, enc->buf);
+
+	if (enc->len == 1) {
+		dst[2] = '=';
+	}
+
+	dst[3] = '=';
+
+	enc->len = 0;
+	*olen = 4;
+
+	return 0;
+}
+
+void base64_decoder_init(struct base64_decoder *dec)
+{
+	dec->bits = 0;
+	dec->len = 0;
+	dec->pad = 0;
+}
+
+int base64_decode_update(struct base64_decoder *dec, u8_t *dst, size_t dlen,
+			 size_t *olen, const u8_t *src, size_t slen)
+{
+	size_t n = (slen / 4 + 1) * 3;
+	u8_t *p = dst;
+	u32_t x;
+
+	if (slen > BASE64_SIZE_T_MAX / 3) {
+		*olen = BASE64_SIZE_T_MAX;
+		return -ENOMEM;
+	}
+
+	if (dlen < n || !dst) {
+		*olen = n;
+		return -ENOMEM;
+	}
+
+	for (; slen > 0; slen--, src++) {
+		if (dec->len == 0 && !dec->pad) {
+			while (slen >= 4 && decode_quartet(p, src)) {
+				p += 3;
+				src += 4;
+				slen -= 4;
+			}
+
+			if (slen == 0) {
+				break;
+			}
+		}
+
+		if (*src == ' ' || *src == '\r' || *src == '\n') {
+			continue;
+		}
+
+		if (*src > 127) {
+			return -EINVAL;
+		}
+
+		x = base64_dec_map[*src];
+		if (x == 127) {
+			return -EINVAL;
+		}
+
+		if (x == 64) {
+			/* Padding ends a quartet of at least 2 symbols */
+			if (dec->len < 2 || ++dec->pad > 2) {
+				return -EINVAL;
+			}
+		} else if (dec->pad) {
+			return -EINVAL;
+		}
+
+		dec->bits = (dec->bits << 6) | (x & 0x3F);
+
+		if (++dec->len == 4) {
+			*p++ = dec->bits >> 16;
+			if (dec->pad < 2) {
+				*p++ = dec->bits >> 8;
+			}
+			if (dec->pad < 1) {
+				*p++ = dec->bits;
+			}
+
+			dec->len = 0;
+			dec->bits = 0;
+		}
+	}
+
+	*olen = p - dst;
+
+	return 0;
+}
+
+int base64_decode_finish(struct base64_decoder *dec)
+{
+	if (dec->len) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
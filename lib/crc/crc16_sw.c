@@ -6,30 +6,64 @@
 
 #include <crc16.h>
 
+/* Remainders of n << 12 for the polynomials of crc16_ansi() and of the
+ * CCITT users of crc16(), so that the CRC is updated a nibble at a time.
+ */
+static const u16_t crc16_1021_table[16] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+	0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef
+};
+
+static const u16_t crc16_8005_table[16] = {
+	0x0000, 0x8005, 0x800f, 0x000a, 0x801b, 0x001e, 0x0014, 0x8011,
+	0x8033, 0x0036, 0x003c, 0x8039, 0x0028, 0x802d, 0x8027, 0x0022
+};
+
+static void crc16_make_table(u16_t *table, u16_t polynomial)
+{
+	int i, b;
+
+	for (i = 0; i < 16; i++) {
+		u16_t crc = i << 12;
+
+		for (b = 0; b < 4; b++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ polynomial :
+					       crc << 1;
+		}
+
+		table[i] = crc;
+	}
+}
+
 u16_t crc16(const u8_t *src, size_t len, u16_t polynomial,
 	    u16_t initial_value, bool pad)
 {
 	u16_t crc = initial_value;
 	size_t padding = pad ? sizeof(crc) : 0;
-	size_t i, b;
+	const u16_t *table;
+	u16_t local_table[16];
+	size_t i;
+
+	if (polynomial == 0x1021) {
+		table = crc16_1021_table;
+	} else if (polynomial == 0x8005) {
+		table = crc16_8005_table;
+	} else {
+		crc16_make_table(local_table, polynomial);
+		table = local_table;
+	}
 
 	/* src length + padding (if required) */
 	for (i = 0; i < len + padding; i++) {
+		/* choose input bytes or implicit trailing zeros */
+		u8_t in = (i < len) ? src[i] : 0;
 
-		for (b = 0; b < 8; b++) {
-			u16_t divide = crc & 0x8000;
-
-			crc = (crc << 1);
-
-			/* choose input bytes or implicit trailing zeros */
-			if (i < len) {
-				crc |= !!(src[i] & (0x80 >> b));
-			}
-
-			if (divide) {
-				crc = crc ^ polynomial;
-			}
-		}
+		/* the 4 input bits shifted in only reach the top of the CRC
+		 * after the 4 divisions, which thus only depend on the top
+		 * nibble
+		 */
+		crc = ((crc << 4) | (in >> 4)) ^ table[crc >> 12];
+		crc = ((crc << 4) | (in & 0x0f)) ^ table[crc >> 12];
 	}
 
 	return crc;
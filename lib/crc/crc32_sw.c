@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2018 Intel Corporation.
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <crc32.h>
+
+/* Remainders of the reflected polynomial 0xEDB88320 for each nibble */
+static const u32_t crc32_ieee_table[16] = {
+	0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+	0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+	0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+	0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+};
+
+u32_t crc32_ieee_update(u32_t crc, const u8_t *data, size_t len)
+{
+	crc = ~crc;
+
+	for (; len > 0; len--) {
+		u8_t byte = *data++;
+
+		crc = (crc >> 4) ^ crc32_ieee_table[(crc ^ byte) & 0x0f];
+		crc = (crc >> 4) ^ crc32_ieee_table[(crc ^ (byte >> 4)) & 0x0f];
+	}
+
+	return ~crc;
+}
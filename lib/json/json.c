@@ -17,6 +17,9 @@
 
 #include "json.h"
 
+/* Bytes of output gathered by json_obj_encode() per append_bytes call */
+#define JSON_ENCODE_CHUNK_SIZE 64
+
 struct token {
 	enum json_tokens type;
 	char *start;
@@ -541,7 +544,8 @@ static int obj_parse(struct json_obj *obj, const struct json_obj_descr *descr,
 {
 	struct json_obj_key_value kv;
 	s32_t decoded_fields = 0;
-	size_t i;
+	size_t next_field = 0;
+	size_t n, i;
 	int ret;
 
 	while (!obj_next(obj, &kv)) {
@@ -549,7 +553,12 @@ static int obj_parse(struct json_obj *obj, const struct json_obj_descr *descr,
 			return decoded_fields;
 		}
 
-		for (i = 0; i < descr_len; i++) {
+		/* Fields usually come in the order of the descriptors, so
+		 * start looking after the last field decoded: the first
+		 * descriptor tried is then the right one.
+		 */
+		for (n = 0, i = next_field; n < descr_len;
+		     n++, i = (i + 1 < descr_len) ? i + 1 : 0) {
 			void *decode_field = (char *)val + descr[i].offset;
 
 			/* Field has been decoded already, skip */
@@ -575,6 +584,7 @@ static int obj_parse(struct json_obj *obj, const struct json_obj_descr *descr,
 			}
 
 			decoded_fields |= 1<<i;
+			next_field = (i + 1) % descr_len;
 			break;
 		}
 	}
@@ -626,20 +636,32 @@ static int json_escape_internal(const char *str,
 				void *data)
 {
 	const char *cur;
+	const char *run = str;
 	int ret = 0;
 
+	/* Characters which need no escaping are appended in runs */
 	for (cur = str; ret == 0 && *cur; cur++) {
 		char escaped = escape_as(*cur);
 
 		if (escaped) {
 			char bytes[2] = { '\\', escaped };
 
+			if (cur > run) {
+				ret = append_bytes(run, cur - run, data);
+				if (ret < 0) {
+					return ret;
+				}
+			}
+
 			ret = append_bytes(bytes, 2, data);
-		} else {
-			ret = append_bytes(cur, 1, data);
+			run = cur + 1;
 		}
 	}
 
+	if (ret == 0 && cur > run) {
+		ret = append_bytes(run, cur - run, data);
+	}
+
 	return ret;
 }
 
@@ -699,6 +721,9 @@ ssize_t json_escape(char *str, size_t *len, size_t buf_size)
 
 static int encode(const struct json_obj_descr *descr, const void *val,
 		  json_append_bytes_t append_bytes, void *data);
+static int obj_encode(const struct json_obj_descr *descr, size_t descr_len,
+		      const void *val, json_append_bytes_t append_bytes,
+		      void *data);
 
 static int arr_encode(const struct json_obj_descr *elem_descr,
 		      const void *field, const void *val,
@@ -815,9 +840,9 @@ static int encode(const struct json_obj_descr *descr, const void *val,
 		return arr_encode(descr->array.element_descr, ptr,
 				  val, append_bytes, data);
 	case JSON_TOK_OBJECT_START:
-		return json_obj_encode(descr->object.sub_descr,
-				       descr->object.sub_descr_len,
-				       ptr, append_bytes, data);
+		return obj_encode(descr->object.sub_descr,
+				  descr->object.sub_descr_len,
+				  ptr, append_bytes, data);
 	case JSON_TOK_NUMBER:
 		return num_encode(ptr, append_bytes, data);
 	default:
@@ -825,9 +850,9 @@ static int encode(const struct json_obj_descr *descr, const void *val,
 	}
 }
 
-int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
-		    const void *val, json_append_bytes_t append_bytes,
-		    void *data)
+static int obj_encode(const struct json_obj_descr *descr, size_t descr_len,
+		      const void *val, json_append_bytes_t append_bytes,
+		      void *data)
 {
 	size_t i;
 	int ret;
@@ -886,6 +911,80 @@ static int append_bytes_to_buf(const char *bytes, size_t len, void *data)
 	return 0;
 }
 
+static int measure_bytes(const char *bytes, size_t len, void *data);
+
+/* Encoding produces many tokens of a few bytes: they are gathered here
+ * before being handed over to the append_bytes function of the user.
+ */
+struct chunker {
+	json_append_bytes_t append_bytes;
+	void *data;
+	size_t used;
+	char buffer[JSON_ENCODE_CHUNK_SIZE];
+};
+
+static int chunker_flush(struct chunker *chunker)
+{
+	size_t used = chunker->used;
+
+	chunker->used = 0;
+
+	if (!used) {
+		return 0;
+	}
+
+	return chunker->append_bytes(chunker->buffer, used, chunker->data);
+}
+
+static int append_bytes_to_chunk(const char *bytes, size_t len, void *data)
+{
+	struct chunker *chunker = data;
+	int ret;
+
+	if (len > sizeof(chunker->buffer) - chunker->used) {
+		ret = chunker_flush(chunker);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (len > sizeof(chunker->buffer)) {
+			return chunker->append_bytes(bytes, len,
+						     chunker->data);
+		}
+	}
+
+	memcpy(chunker->buffer + chunker->used, bytes, len);
+	chunker->used += len;
+
+	return 0;
+}
+
+int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
+		    const void *val, json_append_bytes_t append_bytes,
+		    void *data)
+{
+	struct chunker chunker;
+	int ret;
+
+	/* Nothing to gain when the output is a buffer already */
+	if (append_bytes == append_bytes_to_buf ||
+	    append_bytes == measure_bytes) {
+		return obj_encode(descr, descr_len, val, append_bytes, data);
+	}
+
+	chunker.append_bytes = append_bytes;
+	chunker.data = data;
+	chunker.used = 0;
+
+	ret = obj_encode(descr, descr_len, val, append_bytes_to_chunk,
+			 &chunker);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return chunker_flush(&chunker);
+}
+
 int json_obj_encode_buf(const struct json_obj_descr *descr, size_t descr_len,
 			const void *val, char *buffer, size_t buf_size)
 {
@@ -51,18 +51,19 @@ static int _reverse_and_pad(char *start, char *end, int minlen)
 	return len;
 }
 
-/* Writes the specified number into the buffer in the given base,
- * using the digit characters 0-9a-z (i.e. base>36 will start writing
- * odd bytes), padding with leading zeros up to the minimum length.
+/* Writes the specified number into the buffer in base 1 << shift, using
+ * the digit characters 0-9a-f, padding with leading zeros up to the
+ * minimum length.
  */
-static int _to_x(char *buf, uint32_t n, int base, int minlen)
+static int _to_x(char *buf, uint32_t n, int shift, int minlen)
 {
 	char *buf0 = buf;
+	uint32_t mask = (1 << shift) - 1;
 
 	do {
-		int d = n % base;
+		int d = n & mask;
 
-		n /= base;
+		n >>= shift;
 		*buf++ = '0' + d + (d > 9 ? ('a' - '0' - 10) : 0);
 	} while (n);
 	return _reverse_and_pad(buf0, buf, minlen);
@@ -79,7 +80,7 @@ static int _to_hex(char *buf, uint32_t value,
 		*buf++ = 'x';
 	}
 
-	len = _to_x(buf, value, 16, precision);
+	len = _to_x(buf, value, 4, precision);
 	if (prefix == 'X') {
 		_uc(buf0);
 	}
@@ -99,12 +100,51 @@ static int _to_octal(char *buf, uint32_t value, int alt_form, int precision)
 			return 1;
 		}
 	}
-	return (buf - buf0) + _to_x(buf, value, 8, precision);
+	return (buf - buf0) + _to_x(buf, value, 3, precision);
 }
 
+static const char _dec_pairs[] =
+	"00010203040506070809101112131415161718192021222324"
+	"25262728293031323334353637383940414243444546474849"
+	"50515253545556575859606162636465666768697071727374"
+	"75767778798081828384858687888990919293949596979899";
+
+/* Two digits per step: the division by the constant 100 is turned into a
+ * multiplication by its reciprocal by the compiler.
+ */
 static int _to_udec(char *buf, uint32_t value, int precision)
 {
-	return _to_x(buf, value, 10, precision);
+	char tmp[10];
+	char *p = tmp + sizeof(tmp);
+	int len, pad;
+
+	while (value >= 100) {
+		uint32_t q = value / 100;
+		uint32_t r = value - q * 100;
+
+		p -= 2;
+		p[0] = _dec_pairs[r * 2];
+		p[1] = _dec_pairs[r * 2 + 1];
+		value = q;
+	}
+
+	if (value >= 10) {
+		p -= 2;
+		p[0] = _dec_pairs[value * 2];
+		p[1] = _dec_pairs[value * 2 + 1];
+	} else {
+		*--p = '0' + value;
+	}
+
+	len = tmp + sizeof(tmp) - p;
+	for (pad = len; pad < precision; pad++) {
+		*buf++ = '0';
+	}
+
+	memcpy(buf, p, len);
+	buf[len] = '\0';
+
+	return (precision > len) ? precision : len;
 }
 
 static int _to_dec(char *buf, int32_t value, int fplus, int fspace, int precision)
@@ -389,7 +429,62 @@ static int _atoi(char **sptr)
 	return i;
 }
 
-int _prf(int (*func)(), void *dest, char *format, va_list vargs)
+/* Output is collected in a chunk and handed over to the caller in blocks,
+ * rather than a callback per character.
+ */
+#define PRF_CHUNK 32
+
+struct prf_out {
+	int (*func)();
+	int (*block)(const char *buf, int len, void *dest);
+	void *dest;
+	int len;
+	char buf[PRF_CHUNK];
+};
+
+static int _prf_flush(struct prf_out *out)
+{
+	int i, len = out->len;
+
+	out->len = 0;
+
+	if (out->block) {
+		return out->block(out->buf, len, out->dest);
+	}
+
+	for (i = 0; i < len; i++) {
+		if ((*out->func)(out->buf[i], out->dest) == EOF) {
+			return EOF;
+		}
+	}
+
+	return 0;
+}
+
+static int _prf_emit(struct prf_out *out, const char *buf, int len)
+{
+	int n;
+
+	while (len) {
+		if (out->len == PRF_CHUNK && _prf_flush(out) == EOF) {
+			return EOF;
+		}
+
+		n = PRF_CHUNK - out->len;
+		if (n > len) {
+			n = len;
+		}
+
+		memcpy(out->buf + out->len, buf, n);
+		out->len += n;
+		buf += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int _prf_out(struct prf_out *out, const char *format, va_list vargs)
 {
 	/*
 	 * Due the fact that buffer is passed to functions in this file,
@@ -400,7 +495,6 @@ int _prf(int (*func)(), void *dest, char *format, va_list vargs)
 	char			buf[MAXFLD + 1];
 	register int	c;
 	int				count;
-	register char	*cptr;
 	int				falt;
 	int				fminus;
 	int				fplus;
@@ -421,10 +515,11 @@ int _prf(int (*func)(), void *dest, char *format, va_list vargs)
 
 	while ((c = *format++)) {
 		if (c != '%') {
-			if ((*func) (c, dest) == EOF) {
+			if (out->len == PRF_CHUNK && _prf_flush(out) == EOF) {
 				return EOF;
 			}
 
+			out->buf[out->len++] = c;
 			count++;
 
 		} else {
@@ -622,7 +717,7 @@ int _prf(int (*func)(), void *dest, char *format, va_list vargs)
 				break;
 
 			case '%':
-				if ((*func)('%', dest) == EOF) {
+				if (_prf_emit(out, "%", 1) == EOF) {
 					return EOF;
 				}
 
@@ -655,12 +750,43 @@ int _prf(int (*func)(), void *dest, char *format, va_list vargs)
 					c = width;
 				}
 
-				for (cptr = buf; c > 0; c--, cptr++, count++) {
-					if ((*func)(*cptr, dest) == EOF)
+				if (c > 0) {
+					if (_prf_emit(out, buf, c) == EOF)
 						return EOF;
+					count += c;
 				}
 			}
 		}
 	}
 	return count;
 }
+
+int _prf(int (*func)(), void *dest, char *format, va_list vargs)
+{
+	struct prf_out out = { .func = func, .dest = dest };
+	int count;
+
+	count = _prf_out(&out, format, vargs);
+	if (count == EOF || _prf_flush(&out) == EOF) {
+		return EOF;
+	}
+
+	return count;
+}
+
+/* Same as _prf(), the output is passed to block() up to PRF_CHUNK bytes at
+ * a time.
+ */
+int _prf_block(int (*block)(const char *buf, int len, void *dest),
+	       void *dest, char *format, va_list vargs)
+{
+	struct prf_out out = { .block = block, .dest = dest };
+	int count;
+
+	count = _prf_out(&out, format, vargs);
+	if (count == EOF || _prf_flush(&out) == EOF) {
+		return EOF;
+	}
+
+	return count;
+}
@@ -8,21 +8,28 @@
 
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 
-extern int _prf(int (*func)(), void *dest,
-				const char *format, va_list vargs);
+extern int _prf_block(int (*block)(const char *buf, int len, void *dest),
+		      void *dest, const char *format, va_list vargs);
 
 struct emitter {
 	char *ptr;
 	int len;
 };
 
-static int sprintf_out(int c, struct emitter *p)
+static int sprintf_out(const char *buf, int len, void *dest)
 {
-	if (p->len > 1) { /* need to reserve a byte for EOS */
-		*(p->ptr) = c;
-		p->ptr += 1;
-		p->len -= 1;
+	struct emitter *p = dest;
+
+	if (len > p->len - 1) { /* need to reserve a byte for EOS */
+		len = p->len - 1;
+	}
+
+	if (len > 0) {
+		memcpy(p->ptr, buf, len);
+		p->ptr += len;
+		p->len -= len;
 	}
 	return 0; /* indicate keep going so we get the total count */
 }
@@ -44,7 +51,7 @@ int snprintf(char *_MLIBC_RESTRICT s, size_t len,
 	p.len = (int) len;
 
 	va_start(vargs, format);
-	r = _prf(sprintf_out, (void *) (&p), format, vargs);
+	r = _prf_block(sprintf_out, (void *) (&p), format, vargs);
 	va_end(vargs);
 
 	*(p.ptr) = 0;
@@ -62,7 +69,7 @@ int sprintf(char *_MLIBC_RESTRICT s, const char *_MLIBC_RESTRICT format, ...)
 	p.len = (int) 0x7fffffff; /* allow up to "maxint" characters */
 
 	va_start(vargs, format);
-	r = _prf(sprintf_out, (void *) (&p), format, vargs);
+	r = _prf_block(sprintf_out, (void *) (&p), format, vargs);
 	va_end(vargs);
 
 	*(p.ptr) = 0;
@@ -83,7 +90,7 @@ int vsnprintf(char *_MLIBC_RESTRICT s, size_t len,
 	p.ptr = s;
 	p.len = (int) len;
 
-	r = _prf(sprintf_out, (void *) (&p), format, vargs);
+	r = _prf_block(sprintf_out, (void *) (&p), format, vargs);
 
 	*(p.ptr) = 0;
 	return r;
@@ -98,7 +105,7 @@ int vsprintf(char *_MLIBC_RESTRICT s, const char *_MLIBC_RESTRICT format,
 	p.ptr = s;
 	p.len = (int) 0x7fffffff; /* allow up to "maxint" characters */
 
-	r = _prf(sprintf_out, (void *) (&p), format, vargs);
+	r = _prf_block(sprintf_out, (void *) (&p), format, vargs);
 
 	*(p.ptr) = 0;
 	return r;
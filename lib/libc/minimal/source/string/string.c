@@ -94,6 +94,7 @@ char *strrchr(const char *s, int c)
 	return match;
 }
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING)
 /**
  *
  * @brief Get string length
@@ -129,6 +130,7 @@ int strcmp(const char *s1, const char *s2)
 
 	return *s1 - *s2;
 }
+#endif
 
 /**
  *
@@ -169,6 +171,7 @@ char *strncat(char *_MLIBC_RESTRICT dest, const char *_MLIBC_RESTRICT src,
 	return orig_dest;
 }
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING)
 /**
  *
  * @brief Compare two memory areas
@@ -190,6 +193,7 @@ int memcmp(const void *m1, const void *m2, size_t n)
 
 	return *c1 - *c2;
 }
+#endif
 
 /**
  *
@@ -226,6 +230,7 @@ void *memmove(void *d, const void *s, size_t n)
 	return d;
 }
 
+#if !defined(CONFIG_MINIMAL_LIBC_OPTIMIZE_STRING)
 /**
  *
  * @brief Copy bytes in memory
@@ -322,6 +327,7 @@ void *memset(void *buf, int c, size_t n)
 
 	return buf;
 }
+#endif
 
 /**
  *
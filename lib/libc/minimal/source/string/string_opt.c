@@ -0,0 +1,256 @@
+/* string_opt.c - speed optimized memory and string routines */
+
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdint.h>
+
+/*
+ * Memory is accessed a machine word at a time once aligned. Words may alias
+ * the bytes of any object.
+ */
+typedef unsigned long __attribute__((__may_alias__)) mword_t;
+
+#define WSIZE sizeof(mword_t)
+#define WMASK (WSIZE - 1)
+
+/* non-zero if any byte of w is zero */
+#define ONES ((mword_t)-1 / 0xFF)
+#define HAS_ZERO(w) (((w) - ONES) & ~(w) & (ONES << 7))
+
+/**
+ *
+ * @brief Get string length
+ *
+ * Aligned words are read whole, which never crosses a page or memory
+ * protection region boundary.
+ *
+ * @return number of bytes in string <s>
+ */
+
+size_t strlen(const char *s)
+{
+	const char *p = s;
+	const mword_t *w;
+
+	while ((uintptr_t)p & WMASK) {
+		if (*p == '\0') {
+			return p - s;
+		}
+		p++;
+	}
+
+	for (w = (const mword_t *)p; !HAS_ZERO(*w); w++) {
+	}
+
+	for (p = (const char *)w; *p != '\0'; p++) {
+	}
+
+	return p - s;
+}
+
+/**
+ *
+ * @brief Compare two strings
+ *
+ * @return negative # if <s1> < <s2>, 0 if <s1> == <s2>, else positive #
+ */
+
+int strcmp(const char *s1, const char *s2)
+{
+	if (!(((uintptr_t)s1 | (uintptr_t)s2) & WMASK)) {
+		const mword_t *w1 = (const mword_t *)s1;
+		const mword_t *w2 = (const mword_t *)s2;
+
+		/* skip equal words without a terminator */
+		while (*w1 == *w2 && !HAS_ZERO(*w1)) {
+			w1++;
+			w2++;
+		}
+
+		s1 = (const char *)w1;
+		s2 = (const char *)w2;
+	}
+
+	while ((*s1 == *s2) && (*s1 != '\0')) {
+		s1++;
+		s2++;
+	}
+
+	return *s1 - *s2;
+}
+
+/**
+ *
+ * @brief Compare two memory areas
+ *
+ * @return negative # if <m1> < <m2>, 0 if <m1> == <m2>, else positive #
+ */
+int memcmp(const void *m1, const void *m2, size_t n)
+{
+	const char *c1 = m1;
+	const char *c2 = m2;
+
+	if (!(((uintptr_t)c1 | (uintptr_t)c2) & WMASK)) {
+		const mword_t *w1 = m1;
+		const mword_t *w2 = m2;
+
+		while (n >= WSIZE && *w1 == *w2) {
+			w1++;
+			w2++;
+			n -= WSIZE;
+		}
+
+		c1 = (const char *)w1;
+		c2 = (const char *)w2;
+	}
+
+	for (; n > 0; n--, c1++, c2++) {
+		if (*c1 != *c2) {
+			return *c1 - *c2;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ *
+ * @brief Copy bytes in memory
+ *
+ * @return pointer to start of destination buffer
+ */
+
+void *memcpy(void *_MLIBC_RESTRICT d, const void *_MLIBC_RESTRICT s, size_t n)
+{
+#if defined(CONFIG_X86)
+	void *dest = d;
+	size_t words = n / 4;
+
+	/* string moves are fast on any alignment, the direction flag is
+	 * clear as the ABI requires on function entry
+	 */
+	__asm__ volatile ("rep movsl\n\t"
+			  "movl %3, %%ecx\n\t"
+			  "rep movsb"
+			  : "+D" (d), "+S" (s), "+c" (words)
+			  : "r" (n & 3)
+			  : "memory");
+
+	return dest;
+#else
+	unsigned char *d_byte = d;
+	const unsigned char *s_byte = s;
+
+	/* word copies only if buffers have identical alignment */
+	if (n >= WSIZE && !(((uintptr_t)d ^ (uintptr_t)s) & WMASK)) {
+		mword_t *d_word;
+		const mword_t *s_word;
+
+		while ((uintptr_t)d_byte & WMASK) {
+			*(d_byte++) = *(s_byte++);
+			n--;
+		}
+
+		d_word = (mword_t *)d_byte;
+		s_word = (const mword_t *)s_byte;
+
+		/* four words per iteration, compiled to load/store multiple
+		 * on ARM and to back to back loads on RISC-V
+		 */
+		while (n >= 4 * WSIZE) {
+			mword_t w0 = s_word[0];
+			mword_t w1 = s_word[1];
+			mword_t w2 = s_word[2];
+			mword_t w3 = s_word[3];
+
+			d_word[0] = w0;
+			d_word[1] = w1;
+			d_word[2] = w2;
+			d_word[3] = w3;
+			d_word += 4;
+			s_word += 4;
+			n -= 4 * WSIZE;
+		}
+
+		while (n >= WSIZE) {
+			*(d_word++) = *(s_word++);
+			n -= WSIZE;
+		}
+
+		d_byte = (unsigned char *)d_word;
+		s_byte = (const unsigned char *)s_word;
+	}
+
+	while (n > 0) {
+		*(d_byte++) = *(s_byte++);
+		n--;
+	}
+
+	return d;
+#endif
+}
+
+/**
+ *
+ * @brief Set bytes in memory
+ *
+ * @return pointer to start of buffer
+ */
+
+void *memset(void *buf, int c, size_t n)
+{
+	mword_t c_word = (unsigned char)c * ONES;
+#if defined(CONFIG_X86)
+	void *d = buf;
+	size_t words = n / 4;
+
+	__asm__ volatile ("rep stosl\n\t"
+			  "movl %3, %%ecx\n\t"
+			  "rep stosb"
+			  : "+D" (d), "+c" (words)
+			  : "a" (c_word), "r" (n & 3)
+			  : "memory");
+
+	return buf;
+#else
+	unsigned char *d_byte = buf;
+	mword_t *d_word;
+
+	if (n >= WSIZE) {
+		while ((uintptr_t)d_byte & WMASK) {
+			*(d_byte++) = c;
+			n--;
+		}
+
+		d_word = (mword_t *)d_byte;
+
+		while (n >= 4 * WSIZE) {
+			d_word[0] = c_word;
+			d_word[1] = c_word;
+			d_word[2] = c_word;
+			d_word[3] = c_word;
+			d_word += 4;
+			n -= 4 * WSIZE;
+		}
+
+		while (n >= WSIZE) {
+			*(d_word++) = c_word;
+			n -= WSIZE;
+		}
+
+		d_byte = (unsigned char *)d_word;
+	}
+
+	while (n > 0) {
+		*(d_byte++) = c;
+		n--;
+	}
+
+	return buf;
+#endif
+}
@@ -301,6 +301,32 @@ void _sys_mem_pool_block_free(struct sys_mem_pool_base *p, u32_t level,
 	block_free(p, level, lsizes, block);
 }
 
+size_t _sys_mem_pool_base_level_size(struct sys_mem_pool_base *p, u32_t level)
+{
+	size_t lsz = _ALIGN4(p->max_sz);
+
+	while (level--) {
+		lsz = _ALIGN4(lsz / 4);
+	}
+
+	return lsz;
+}
+
+u32_t _sys_mem_pool_base_free_count(struct sys_mem_pool_base *p, u32_t level)
+{
+	sys_dnode_t *node;
+	u32_t count = 0;
+	int key = pool_irq_lock(p);
+
+	SYS_DLIST_FOR_EACH_NODE(&p->levels[level].free_list, node) {
+		count++;
+	}
+
+	pool_irq_unlock(p, key);
+
+	return count;
+}
+
 /*
  * Functions specific to user-mode blocks
  */
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <misc/__assert.h>
+#include <misc/tlsf.h>
+
+#define MIN_BLOCK_SIZE sizeof(struct sys_tlsf_block)
+
+/* Largest block the size classes can represent */
+#define MAX_BLOCK_SIZE \
+	((((size_t)1 << (_TLSF_FL_INDEX_MAX + 1)) - 1) & ~(_TLSF_ALIGN - 1))
+
+static inline size_t block_size(struct sys_tlsf_block *b)
+{
+	return b->size & ~(size_t)1;
+}
+
+static inline bool block_is_free(struct sys_tlsf_block *b)
+{
+	return b->size & 1;
+}
+
+static inline struct sys_tlsf_block *next_phys(struct sys_tlsf_block *b)
+{
+	return (struct sys_tlsf_block *)((char *)b + block_size(b));
+}
+
+static inline int msb(u32_t v)
+{
+	return 31 - __builtin_clz(v);
+}
+
+/* Size class of a free block of the given size */
+static void mapping(size_t size, int *fl, int *sl)
+{
+	if (size < (1 << _TLSF_FL_SHIFT)) {
+		*fl = 0;
+		*sl = size >> _TLSF_ALIGN_LOG2;
+	} else {
+		int f = msb(size);
+
+		*fl = f - _TLSF_FL_SHIFT + 1;
+		*sl = (size >> (f - _TLSF_SL_LOG2)) - _TLSF_SL_COUNT;
+	}
+}
+
+/* Smallest size class whose blocks are all at least the given size */
+static void mapping_search(size_t size, int *fl, int *sl)
+{
+	if (size >= (1 << _TLSF_FL_SHIFT)) {
+		size += (1 << (msb(size) - _TLSF_SL_LOG2)) - 1;
+	}
+
+	mapping(size, fl, sl);
+}
+
+static void insert_free(struct sys_tlsf *h, struct sys_tlsf_block *b)
+{
+	struct sys_tlsf_block **head;
+	int fl, sl;
+
+	mapping(block_size(b), &fl, &sl);
+	head = &h->free[fl][sl];
+
+	b->prev_free = NULL;
+	b->next_free = *head;
+	if (*head != NULL) {
+		(*head)->prev_free = b;
+	}
+	*head = b;
+
+	h->fl_bitmap |= 1 << fl;
+	h->sl_bitmap[fl] |= 1 << sl;
+	b->size |= 1;
+}
+
+static void remove_free(struct sys_tlsf *h, struct sys_tlsf_block *b)
+{
+	int fl, sl;
+
+	mapping(block_size(b), &fl, &sl);
+
+	if (b->prev_free != NULL) {
+		b->prev_free->next_free = b->next_free;
+	} else {
+		h->free[fl][sl] = b->next_free;
+	}
+	if (b->next_free != NULL) {
+		b->next_free->prev_free = b->prev_free;
+	}
+
+	if (h->free[fl][sl] == NULL) {
+		h->sl_bitmap[fl] &= ~(1 << sl);
+		if (h->sl_bitmap[fl] == 0) {
+			h->fl_bitmap &= ~(1 << fl);
+		}
+	}
+
+	b->size &= ~(size_t)1;
+}
+
+static struct sys_tlsf_block *find_free(struct sys_tlsf *h, size_t size)
+{
+	u32_t sl_map, fl_map;
+	int fl, sl;
+
+	mapping_search(size, &fl, &sl);
+
+	if (fl < _TLSF_FL_COUNT) {
+		sl_map = h->sl_bitmap[fl] & (~0U << sl);
+		if (sl_map == 0) {
+			fl_map = fl + 1 < 32 ? h->fl_bitmap & (~0U << (fl + 1)) : 0;
+			if (fl_map != 0) {
+				fl = __builtin_ctz(fl_map);
+				sl_map = h->sl_bitmap[fl];
+			}
+		}
+
+		if (sl_map != 0) {
+			return h->free[fl][__builtin_ctz(sl_map)];
+		}
+	}
+
+	/* The classes above are all full: the class of the size itself
+	 * may still hold a large enough block. Only its first block is
+	 * checked, to stay O(1).
+	 */
+	mapping(size, &fl, &sl);
+	if (fl < _TLSF_FL_COUNT && h->free[fl][sl] != NULL &&
+	    block_size(h->free[fl][sl]) >= size) {
+		return h->free[fl][sl];
+	}
+
+	return NULL;
+}
+
+void _sys_tlsf_init(struct sys_tlsf *h)
+{
+	char *p = (char *)ROUND_UP(h->buf, _TLSF_ALIGN);
+	char *end = (char *)ROUND_DOWN((char *)h->buf + h->buf_size,
+				       _TLSF_ALIGN) - _TLSF_HDR_SIZE;
+	struct sys_tlsf_block *b, *prev = NULL;
+
+	__ASSERT(_TLSF_SL_LOG2 <= 5 && _TLSF_FL_COUNT <= 32,
+		 "TLSF bitmaps too small");
+
+	h->fl_bitmap = 0;
+	memset(h->sl_bitmap, 0, sizeof(h->sl_bitmap));
+	memset(h->free, 0, sizeof(h->free));
+
+	/* Pools larger than the largest block are made of several free
+	 * blocks, never merged together.
+	 */
+	while (end - p >= (ptrdiff_t)MIN_BLOCK_SIZE) {
+		b = (struct sys_tlsf_block *)p;
+		b->prev_phys = prev;
+		b->size = min((size_t)(end - p), MAX_BLOCK_SIZE);
+		insert_free(h, b);
+		prev = b;
+		p += block_size(b);
+	}
+
+	/* Allocated, empty sentinel block, ending merges */
+	b = (struct sys_tlsf_block *)p;
+	b->prev_phys = prev;
+	b->size = 0;
+}
+
+void *_sys_tlsf_alloc(struct sys_tlsf *h, size_t size)
+{
+	struct sys_tlsf_block *b, *rest;
+	size_t need;
+
+	if (size == 0 || size > MAX_BLOCK_SIZE - _TLSF_HDR_SIZE) {
+		return NULL;
+	}
+
+	need = _TLSF_BLOCK_SIZE(size);
+	b = find_free(h, need);
+	if (b == NULL) {
+		return NULL;
+	}
+
+	remove_free(h, b);
+
+	if (block_size(b) - need >= MIN_BLOCK_SIZE) {
+		rest = (struct sys_tlsf_block *)((char *)b + need);
+		rest->prev_phys = b;
+		rest->size = block_size(b) - need;
+		next_phys(rest)->prev_phys = rest;
+		b->size = need;
+		insert_free(h, rest);
+	}
+
+	return (char *)b + _TLSF_HDR_SIZE;
+}
+
+void _sys_tlsf_free(struct sys_tlsf *h, void *ptr)
+{
+	struct sys_tlsf_block *b, *next, *prev;
+
+	b = (struct sys_tlsf_block *)((char *)ptr - _TLSF_HDR_SIZE);
+	__ASSERT(!block_is_free(b), "double free of %p", ptr);
+
+	next = next_phys(b);
+	if (block_is_free(next) &&
+	    block_size(b) + block_size(next) <= MAX_BLOCK_SIZE) {
+		remove_free(h, next);
+		b->size += block_size(next);
+	}
+
+	prev = b->prev_phys;
+	if (prev != NULL && block_is_free(prev) &&
+	    block_size(prev) + block_size(b) <= MAX_BLOCK_SIZE) {
+		remove_free(h, prev);
+		prev->size += block_size(b);
+		b = prev;
+	}
+
+	next_phys(b)->prev_phys = b;
+	insert_free(h, b);
+}
+
+void _sys_tlsf_foreach_free(struct sys_tlsf *h,
+			    void (*cb)(size_t size, void *arg), void *arg)
+{
+	struct sys_tlsf_block *b;
+	int fl, sl;
+
+	for (fl = 0; fl < _TLSF_FL_COUNT; fl++) {
+		for (sl = 0; sl < _TLSF_SL_COUNT; sl++) {
+			for (b = h->free[fl][sl]; b != NULL; b = b->next_free) {
+				cb(block_size(b) - _TLSF_HDR_SIZE, arg);
+			}
+		}
+	}
+}
@@ -10,11 +10,33 @@
 #include <posix/time.h>
 #include <posix/mqueue.h>
 
+/*
+ * Messages are stored in slots of the queue's buffer, which are copied to
+ * and from the caller's buffer once. Queued slots are kept in a binary
+ * heap ordered by priority, then by sending order, so that the oldest
+ * message of the highest priority is received first.
+ */
+struct mq_msg {
+	struct mq_msg *next;	/* next free slot */
+	u32_t seq;		/* sending order */
+	unsigned int prio;
+	size_t len;
+	char data[];
+};
+
 typedef struct mqueue_object {
 	sys_snode_t snode;
 	char *mem_buffer;
 	char *mem_obj;
-	struct k_msgq queue;
+	struct mq_msg **heap;
+	struct mq_msg *free_list;
+	struct k_sem free_sem;		/* free slots */
+	struct k_sem msg_sem;		/* queued messages */
+	struct k_spinlock lock;
+	u32_t msg_size;
+	u32_t max_msgs;
+	u32_t used_msgs;
+	u32_t seq;
 	atomic_t ref_count;
 	char *name;
 } mqueue_object;
@@ -32,12 +54,18 @@ sys_slist_t mq_list = SYS_SLIST_STATIC_INIT(&mq_list);
 
 s64_t timespec_to_timeoutms(const struct timespec *abstime);
 static mqueue_object *find_in_list(const char *name);
+static void init_mq(mqueue_object *msg_queue, u32_t msg_size,
+		    u32_t max_msgs);
 static s32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
-			  s32_t timeout);
+			  unsigned int msg_prio, s32_t timeout);
 static int receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
-			   s32_t timeout);
+			   unsigned int *msg_prio, s32_t timeout);
 static void remove_mq(mqueue_object *msg_queue);
 
+/* Size of a message slot, keeping the next slot aligned */
+#define MQ_MSG_SIZE(msg_size) \
+	ROUND_UP(sizeof(struct mq_msg) + (msg_size), sizeof(void *))
+
 /**
  * @brief Open a message queue.
  *
@@ -135,19 +163,17 @@ mqd_t mq_open(const char *name, int oflags, ...)
 
 		strcpy(msg_queue->name, name);
 
-		mq_buf_ptr = k_malloc(msg_size * max_msgs * sizeof(u8_t));
+		/* heap of queued messages, followed by the message slots */
+		mq_buf_ptr = k_malloc(max_msgs * (sizeof(struct mq_msg *) +
+						  MQ_MSG_SIZE(msg_size)));
 		if (mq_buf_ptr != NULL) {
-			memset(mq_buf_ptr, 0,
-			       msg_size * max_msgs * sizeof(u8_t));
 			msg_queue->mem_buffer = mq_buf_ptr;
 		} else {
 			goto free_mq_buffer;
 		}
 
 		atomic_set(&msg_queue->ref_count, 1);
-		/* initialize zephyr message queue */
-		k_msgq_init(&msg_queue->queue, msg_queue->mem_buffer, msg_size,
-			    max_msgs);
+		init_mq(msg_queue, msg_size, max_msgs);
 		k_sem_take(&mq_sem, K_FOREVER);
 		sys_slist_append(&mq_list, (sys_snode_t *)&(msg_queue->snode));
 		k_sem_give(&mq_sem);
@@ -224,7 +250,8 @@ int mq_unlink(const char *name)
 /**
  * @brief Send a message to a message queue.
  *
- * All messages in message queue are of equal priority.
+ * Messages are received by decreasing priority, up to MQ_PRIO_MAX - 1,
+ * and in sending order within a priority.
  *
  * See IEEE 1003.1
  */
@@ -234,14 +261,12 @@ int mq_send(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
 	mqueue_desc *mqd = (mqueue_desc *)mqdes;
 	s32_t  timeout = K_FOREVER;
 
-	return send_message(mqd, msg_ptr, msg_len, timeout);
+	return send_message(mqd, msg_ptr, msg_len, msg_prio, timeout);
 }
 
 /**
  * @brief Send message to a message queue within abstime time.
  *
- * All messages in message queue are of equal priority.
- *
  * See IEEE 1003.1
  */
 int mq_timedsend(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
@@ -251,13 +276,14 @@ int mq_timedsend(mqd_t mqdes, const char *msg_ptr, size_t msg_len,
 	s32_t  timeout;
 
 	timeout = (s32_t) timespec_to_timeoutms(abstime);
-	return send_message(mqd, msg_ptr, msg_len, timeout);
+	return send_message(mqd, msg_ptr, msg_len, msg_prio, timeout);
 }
 
 /**
  * @brief Receive a message from a message queue.
  *
- * All messages in message queue are of equal priority.
+ * The oldest message of the highest priority is received. Its length is
+ * returned, and its priority stored in @a msg_prio unless NULL.
  *
  * See IEEE 1003.1
  */
@@ -267,15 +293,13 @@ int mq_receive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
 	mqueue_desc *mqd = (mqueue_desc *)mqdes;
 	s32_t  timeout = K_FOREVER;
 
-	return receive_message(mqd, msg_ptr, msg_len, timeout);
+	return receive_message(mqd, msg_ptr, msg_len, msg_prio, timeout);
 
 }
 
 /**
  * @brief Receive message from a message queue within abstime time.
  *
- * All messages in message queue are of equal priority.
- *
  * See IEEE 1003.1
  */
 int mq_timedreceive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
@@ -285,7 +309,7 @@ int mq_timedreceive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
 	s32_t  timeout = K_NO_WAIT;
 
 	timeout = (s32_t) timespec_to_timeoutms(abstime);
-	return receive_message(mqd, msg_ptr, msg_len, timeout);
+	return receive_message(mqd, msg_ptr, msg_len, msg_prio, timeout);
 }
 
 /**
@@ -296,7 +320,6 @@ int mq_timedreceive(mqd_t mqdes, char *msg_ptr, size_t msg_len,
 int mq_getattr(mqd_t mqdes, struct mq_attr *mqstat)
 {
 	mqueue_desc *mqd = (mqueue_desc *)mqdes;
-	struct k_msgq_attrs attrs;
 
 	if (mqd == NULL) {
 		errno = EBADF;
@@ -304,11 +327,10 @@ int mq_getattr(mqd_t mqdes, struct mq_attr *mqstat)
 	}
 
 	k_sem_take(&mq_sem, K_FOREVER);
-	k_msgq_get_attrs(&mqd->mqueue->queue, &attrs);
 	mqstat->mq_flags = mqd->flags;
-	mqstat->mq_maxmsg = attrs.max_msgs;
-	mqstat->mq_msgsize = attrs.msg_size;
-	mqstat->mq_curmsgs = attrs.used_msgs;
+	mqstat->mq_maxmsg = mqd->mqueue->max_msgs;
+	mqstat->mq_msgsize = mqd->mqueue->msg_size;
+	mqstat->mq_curmsgs = mqd->mqueue->used_msgs;
 	k_sem_give(&mq_sem);
 	return 0;
 }
@@ -364,9 +386,92 @@ static mqueue_object *find_in_list(const char *name)
 	return NULL;
 }
 
+static void init_mq(mqueue_object *msg_queue, u32_t msg_size,
+		    u32_t max_msgs)
+{
+	char *slots = msg_queue->mem_buffer +
+		      max_msgs * sizeof(struct mq_msg *);
+	struct mq_msg *msg;
+	u32_t i;
+
+	msg_queue->heap = (struct mq_msg **)msg_queue->mem_buffer;
+	msg_queue->free_list = NULL;
+	msg_queue->msg_size = msg_size;
+	msg_queue->max_msgs = max_msgs;
+	msg_queue->used_msgs = 0;
+	msg_queue->seq = 0;
+
+	for (i = 0; i < max_msgs; i++) {
+		msg = (struct mq_msg *)(slots + i * MQ_MSG_SIZE(msg_size));
+		msg->next = msg_queue->free_list;
+		msg_queue->free_list = msg;
+	}
+
+	k_sem_init(&msg_queue->free_sem, max_msgs, max_msgs);
+	k_sem_init(&msg_queue->msg_sem, 0, max_msgs);
+}
+
+/* Whether message a is received before message b */
+static inline bool msg_before(struct mq_msg *a, struct mq_msg *b)
+{
+	if (a->prio != b->prio) {
+		return a->prio > b->prio;
+	}
+
+	return (s32_t)(a->seq - b->seq) < 0;
+}
+
+static void heap_push(mqueue_object *msg_queue, struct mq_msg *msg)
+{
+	struct mq_msg **heap = msg_queue->heap;
+	u32_t i = msg_queue->used_msgs++;
+	u32_t parent;
+
+	while (i > 0) {
+		parent = (i - 1) / 2;
+		if (!msg_before(msg, heap[parent])) {
+			break;
+		}
+
+		heap[i] = heap[parent];
+		i = parent;
+	}
+
+	heap[i] = msg;
+}
+
+static struct mq_msg *heap_pop(mqueue_object *msg_queue)
+{
+	struct mq_msg **heap = msg_queue->heap;
+	struct mq_msg *top = heap[0];
+	struct mq_msg *last = heap[--msg_queue->used_msgs];
+	u32_t n = msg_queue->used_msgs;
+	u32_t i = 0, child;
+
+	/* sift the last message down from the root */
+	while ((child = 2 * i + 1) < n) {
+		if (child + 1 < n && msg_before(heap[child + 1], heap[child])) {
+			child++;
+		}
+
+		if (!msg_before(heap[child], last)) {
+			break;
+		}
+
+		heap[i] = heap[child];
+		i = child;
+	}
+
+	heap[i] = last;
+	return top;
+}
+
 static s32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
-			  s32_t timeout)
+			  unsigned int msg_prio, s32_t timeout)
 {
+	mqueue_object *msg_queue;
+	struct mq_msg *msg;
+	k_spinlock_key_t key;
 	s32_t ret = -1;
 
 	if (mqd == NULL) {
@@ -378,22 +483,49 @@ static s32_t send_message(mqueue_desc *mqd, const char *msg_ptr, size_t msg_len,
 		timeout = K_NO_WAIT;
 	}
 
-	if (msg_len >  mqd->mqueue->queue.msg_size) {
+	msg_queue = mqd->mqueue;
+
+	if (msg_len >  msg_queue->msg_size) {
 		errno = EMSGSIZE;
 		return ret;
 	}
 
-	if (k_msgq_put(&mqd->mqueue->queue, (void *)msg_ptr, timeout) != 0) {
+	if (msg_prio >= MQ_PRIO_MAX) {
+		errno = EINVAL;
+		return ret;
+	}
+
+	if (k_sem_take(&msg_queue->free_sem, timeout) != 0) {
 		errno = (timeout == K_NO_WAIT) ?   EAGAIN : ETIMEDOUT;
 		return ret;
 	}
 
+	key = k_spin_lock(&msg_queue->lock);
+	msg = msg_queue->free_list;
+	msg_queue->free_list = msg->next;
+	k_spin_unlock(&msg_queue->lock, key);
+
+	/* the slot is ours until queued: copy outside of the lock */
+	memcpy(msg->data, msg_ptr, msg_len);
+	msg->len = msg_len;
+	msg->prio = msg_prio;
+
+	key = k_spin_lock(&msg_queue->lock);
+	msg->seq = msg_queue->seq++;
+	heap_push(msg_queue, msg);
+	k_spin_unlock(&msg_queue->lock, key);
+
+	k_sem_give(&msg_queue->msg_sem);
+
 	return 0;
 }
 
 static s32_t receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
-			     s32_t timeout)
+			     unsigned int *msg_prio, s32_t timeout)
 {
+	mqueue_object *msg_queue;
+	struct mq_msg *msg;
+	k_spinlock_key_t key;
 	int ret = -1;
 
 	if (mqd == NULL) {
@@ -401,7 +533,9 @@ static s32_t receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
 		return ret;
 	}
 
-	if (msg_len < mqd->mqueue->queue.msg_size) {
+	msg_queue = mqd->mqueue;
+
+	if (msg_len < msg_queue->msg_size) {
 		errno = EMSGSIZE;
 		return ret;
 	}
@@ -410,12 +544,28 @@ static s32_t receive_message(mqueue_desc *mqd, char *msg_ptr, size_t msg_len,
 		timeout = K_NO_WAIT;
 	}
 
-	if (k_msgq_get(&mqd->mqueue->queue, (void *)msg_ptr, timeout) != 0) {
+	if (k_sem_take(&msg_queue->msg_sem, timeout) != 0) {
 		errno = (timeout != K_NO_WAIT) ? ETIMEDOUT : EAGAIN;
-	} else {
-		ret = mqd->mqueue->queue.msg_size;
+		return ret;
+	}
+
+	key = k_spin_lock(&msg_queue->lock);
+	msg = heap_pop(msg_queue);
+	k_spin_unlock(&msg_queue->lock, key);
+
+	memcpy(msg_ptr, msg->data, msg->len);
+	ret = msg->len;
+	if (msg_prio != NULL) {
+		*msg_prio = msg->prio;
 	}
 
+	key = k_spin_lock(&msg_queue->lock);
+	msg->next = msg_queue->free_list;
+	msg_queue->free_list = msg;
+	k_spin_unlock(&msg_queue->lock, key);
+
+	k_sem_give(&msg_queue->free_sem);
+
 	return ret;
 }
 
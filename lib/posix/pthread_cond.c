@@ -9,30 +9,77 @@
 #include <wait_q.h>
 #include <posix/pthread.h>
 
+/* Give the mutex to a thread pending on it, the mutex waits are woken
+ * with the mutex already owned.  Called with interrupts locked.
+ */
+static void mutex_hand_over(pthread_mutex_t *mut, struct k_thread *thread)
+{
+	mut->owner = (pthread_t)thread;
+	mut->lock_count = 1;
+	_ready_thread(thread);
+	_set_thread_return_value(thread, 0);
+}
+
 static int cond_wait(pthread_cond_t *cv, pthread_mutex_t *mut, int timeout)
 {
 	__ASSERT(mut->lock_count == 1, "");
 
+	struct k_thread *thread;
 	int ret, key = irq_lock();
 
-	mut->lock_count = 0;
-	mut->owner = NULL;
-	_ready_one_thread(&mut->wait_q);
+	cv->mutex = mut;
+
+	thread = _unpend_first_thread(&mut->wait_q);
+	if (thread) {
+		mutex_hand_over(mut, thread);
+	} else {
+		mut->lock_count = 0;
+		mut->owner = NULL;
+	}
+
 	ret = _pend_current_thread(key, &cv->wait_q, timeout);
 
-	/* FIXME: this extra lock (and the potential context switch it
-	 * can cause) could be optimized out.  At the point of the
-	 * signal/broadcast, it's possible to detect whether or not we
-	 * will be swapping back to this particular thread and lock it
-	 * (i.e. leave the lock variable unchanged) on our behalf.
-	 * But that requires putting scheduler intelligence into this
-	 * higher level abstraction and is probably not worth it.
+	/* A signal hands the mutex over to us, either directly or through
+	 * its wait queue, only a timeout needs to lock it again.
 	 */
+	if (ret == 0) {
+		return 0;
+	}
+
 	pthread_mutex_lock(mut);
 
 	return ret == -EAGAIN ? ETIMEDOUT : ret;
 }
 
+/* Wake the first waiter of the condition variable, called with
+ * interrupts locked.  Rather than making it runnable only to block on
+ * the mutex again, the waiter gets the mutex if it is free, otherwise
+ * it is moved to the mutex wait queue ("wait morphing") and runs once
+ * the owner unlocks.  Returns 0 if there was no waiter.
+ */
+static int wake_one(pthread_cond_t *cv)
+{
+	pthread_mutex_t *mut = cv->mutex;
+	struct k_thread *thread;
+
+	if (!mut) {
+		return 0;
+	}
+
+	if (mut->owner) {
+		return _requeue_first_thread(&cv->wait_q, &mut->wait_q) != NULL;
+	}
+
+	thread = _unpend_first_thread(&cv->wait_q);
+	if (!thread) {
+		return 0;
+	}
+
+	mutex_hand_over(mut, thread);
+
+	return 1;
+}
+
 /* This implements a "fair" scheduling policy: at the end of a POSIX
  * thread call that might result in a change of the current maximum
  * priority thread, we always check and context switch if needed.
@@ -48,7 +95,7 @@ int pthread_cond_signal(pthread_cond_t *cv)
 {
 	int key = irq_lock();
 
-	_ready_one_thread(&cv->wait_q);
+	wake_one(cv);
 	_reschedule(key);
 
 	return 0;
@@ -58,8 +105,8 @@ int pthread_cond_broadcast(pthread_cond_t *cv)
 {
 	int key = irq_lock();
 
-	while (_waitq_head(&cv->wait_q)) {
-		_ready_one_thread(&cv->wait_q);
+	/* At most the first waiter runs, the others queue on the mutex */
+	while (wake_one(cv)) {
 	}
 
 	_reschedule(key);
@@ -77,4 +124,3 @@ int pthread_cond_timedwait(pthread_cond_t *cv, pthread_mutex_t *mut,
 {
 	return cond_wait(cv, mut, _ts_to_ms(to));
 }
-
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 #include <kernel.h>
+#include <ksched.h>
+#include <wait_q.h>
 #include <errno.h>
 #include <posix/time.h>
 #include <posix/sys/types.h>
@@ -11,11 +13,10 @@
 #define INITIALIZED 1
 #define NOT_INITIALIZED 0
 
-#define CONCURRENT_READER_LIMIT  (CONFIG_MAX_PTHREAD_COUNT + 1)
-
 s64_t timespec_to_timeoutms(const struct timespec *abstime);
 static u32_t read_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout);
 static u32_t write_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout);
+static int wake_readers(pthread_rwlock_t *rwlock);
 
 /**
  * @brief Initialize read-write lock object.
@@ -25,10 +26,9 @@ static u32_t write_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout);
 int pthread_rwlock_init(pthread_rwlock_t *rwlock,
 			const pthread_rwlockattr_t *attr)
 {
-	k_sem_init(&rwlock->rd_sem, CONCURRENT_READER_LIMIT,
-		   CONCURRENT_READER_LIMIT);
-	k_sem_init(&rwlock->wr_sem, 1, 1);
-	k_sem_init(&rwlock->reader_active, 1, 1);
+	_waitq_init(&rwlock->rd_wait_q);
+	_waitq_init(&rwlock->wr_wait_q);
+	rwlock->readers = 0;
 	rwlock->wr_owner = NULL;
 	rwlock->status = INITIALIZED;
 	return 0;
@@ -45,7 +45,7 @@ int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
 		return EINVAL;
 	}
 
-	if (rwlock->wr_owner != NULL) {
+	if (rwlock->wr_owner != NULL || rwlock->readers != 0) {
 		return EBUSY;
 	}
 
@@ -60,8 +60,7 @@ int pthread_rwlock_destroy(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for reading.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
+ * Readers don't get the lock while a writer is waiting for it.
  *
  * See IEEE 1003.1
  */
@@ -77,9 +76,6 @@ int pthread_rwlock_rdlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for reading within specific time.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
- *
  * See IEEE 1003.1
  */
 int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock,
@@ -105,9 +101,6 @@ int pthread_rwlock_timedrdlock(pthread_rwlock_t *rwlock,
 /**
  * @brief Lock a read-write lock object for reading immedately.
  *
- * API behaviour is unpredictable if number of concurrent reader
- * lock held is greater than CONCURRENT_READER_LIMIT.
- *
  * See IEEE 1003.1
  */
 int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
@@ -122,8 +115,9 @@ int pthread_rwlock_tryrdlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for writing.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
+ * Waiting writers get the lock in priority order, ahead of the readers
+ * arriving after them. Readers waiting when a writer unlocks all get the
+ * lock before the next writer.
  *
  * See IEEE 1003.1
  */
@@ -139,9 +133,6 @@ int pthread_rwlock_wrlock(pthread_rwlock_t *rwlock)
 /**
  * @brief Lock a read-write lock object for writing within specific time.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
- *
  * See IEEE 1003.1
  */
 int pthread_rwlock_timedwrlock(pthread_rwlock_t *rwlock,
@@ -167,9 +158,6 @@ int pthread_rwlock_timedwrlock(pthread_rwlock_t *rwlock,
 /**
  * @brief Lock a read-write lock object for writing immedately.
  *
- * Write lock does not have priority over reader lock,
- * threads get lock based on priority.
- *
  * See IEEE 1003.1
  */
 int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock)
@@ -189,69 +177,131 @@ int pthread_rwlock_trywrlock(pthread_rwlock_t *rwlock)
  */
 int pthread_rwlock_unlock(pthread_rwlock_t *rwlock)
 {
+	struct k_thread *thread;
+	int key;
+
 	if (rwlock->status == NOT_INITIALIZED) {
 		return EINVAL;
 	}
 
+	key = irq_lock();
+
 	if (k_current_get() == rwlock->wr_owner) {
-		/* Write unlock */
+		/* Write unlock, readers waiting first then a writer */
 		rwlock->wr_owner = NULL;
-		k_sem_give(&rwlock->reader_active);
-		k_sem_give(&rwlock->wr_sem);
-	} else {
-		/* Read unlock */
-		if (k_sem_count_get(&rwlock->rd_sem) ==
-				    (CONCURRENT_READER_LIMIT - 1)) {
-			/* Last read lock, unlock writer */
-			k_sem_give(&rwlock->reader_active);
+
+		if (wake_readers(rwlock)) {
+			_reschedule(key);
+			return 0;
+		}
+	} else if (rwlock->readers) {
+		/* Read unlock, the last one lets a writer in. Without a
+		 * waiting writer, the readers queued behind one that timed
+		 * out get the lock.
+		 */
+		rwlock->readers--;
+
+		if (_waitq_head(&rwlock->wr_wait_q) == NULL) {
+			if (wake_readers(rwlock)) {
+				_reschedule(key);
+			} else {
+				irq_unlock(key);
+			}
+			return 0;
+		}
+
+		if (rwlock->readers) {
+			irq_unlock(key);
+			return 0;
 		}
+	} else {
+		irq_unlock(key);
+		return EPERM;
+	}
 
-		k_sem_give(&rwlock->rd_sem);
+	thread = _unpend_first_thread(&rwlock->wr_wait_q);
+	if (thread) {
+		rwlock->wr_owner = thread;
+		_ready_thread(thread);
+		_set_thread_return_value(thread, 0);
 	}
+
+	_reschedule(key);
 	return 0;
 }
 
+/* Give the lock to all the waiting readers, return how many there were */
+static int wake_readers(pthread_rwlock_t *rwlock)
+{
+	struct k_thread *thread;
+	int woken = 0;
+
+	while ((thread = _unpend_first_thread(&rwlock->rd_wait_q))) {
+		rwlock->readers++;
+		_ready_thread(thread);
+		_set_thread_return_value(thread, 0);
+		woken++;
+	}
+
+	return woken;
+}
 
+/* Waiting threads are given the lock by pthread_rwlock_unlock() before
+ * being woken up, a successful wait has nothing left to do.
+ */
 static u32_t read_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout)
 {
-	u32_t ret = 0;
+	int key = irq_lock();
 
-	if (k_sem_take(&rwlock->wr_sem, timeout) == 0) {
-		k_sem_take(&rwlock->reader_active, K_NO_WAIT);
-		k_sem_take(&rwlock->rd_sem, K_NO_WAIT);
-		k_sem_give(&rwlock->wr_sem);
-	} else {
-		ret = EBUSY;
+	/* fast path, no writer holding or waiting for the lock */
+	if (rwlock->wr_owner == NULL &&
+	    _waitq_head(&rwlock->wr_wait_q) == NULL) {
+		rwlock->readers++;
+		irq_unlock(key);
+		return 0;
 	}
 
-	return ret;
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return EBUSY;
+	}
+
+	if (_pend_current_thread(key, &rwlock->rd_wait_q, timeout) != 0) {
+		return EBUSY;
+	}
+
+	return 0;
 }
 
 static u32_t write_lock_acquire(pthread_rwlock_t *rwlock, s32_t timeout)
 {
-	u32_t ret = 0;
-	s64_t elapsed_time, st_time = k_uptime_get();
-
-	/* waiting for release of write lock */
-	if (k_sem_take(&rwlock->wr_sem, timeout) == 0) {
-		if (timeout > K_NO_WAIT) {
-			elapsed_time = k_uptime_get() - st_time;
-			timeout = timeout <= elapsed_time ? K_NO_WAIT :
-				  timeout - elapsed_time;
-		}
+	int key = irq_lock();
+
+	if (rwlock->wr_owner == NULL && rwlock->readers == 0) {
+		rwlock->wr_owner = k_current_get();
+		irq_unlock(key);
+		return 0;
+	}
 
-		/* waiting for reader to complete operation */
-		if (k_sem_take(&rwlock->reader_active, timeout) == 0) {
-			rwlock->wr_owner = k_current_get();
+	if (timeout == K_NO_WAIT) {
+		irq_unlock(key);
+		return EBUSY;
+	}
+
+	if (_pend_current_thread(key, &rwlock->wr_wait_q, timeout) != 0) {
+		/* Readers held back by this writer may take the lock now */
+		key = irq_lock();
+
+		if (rwlock->wr_owner == NULL &&
+		    _waitq_head(&rwlock->wr_wait_q) == NULL &&
+		    wake_readers(rwlock)) {
+			_reschedule(key);
 		} else {
-			k_sem_give(&rwlock->wr_sem);
-			ret = EBUSY;
+			irq_unlock(key);
 		}
 
-	} else {
-		ret = EBUSY;
+		return EBUSY;
 	}
-	return ret;
-}
-
 
+	return 0;
+}
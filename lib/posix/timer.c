@@ -7,6 +7,7 @@
 #include <errno.h>
 #include <string.h>
 #include <misc/printk.h>
+#include <init.h>
 #include <posix/time.h>
 
 #define ACTIVE 1
@@ -21,11 +22,71 @@ struct timer_obj {
 	struct timespec interval;	/* Reload value */
 	u32_t reload;			/* Reload value in ms */
 	u32_t status;
+#if defined(CONFIG_POSIX_TIMER_SIGEV_THREAD)
+	int sigev_notify;
+	struct k_work work;
+#endif
 };
 
 K_MEM_SLAB_DEFINE(posix_timer_slab, sizeof(struct timer_obj),
 		  CONFIG_MAX_TIMER_COUNT, 4);
 
+#if defined(CONFIG_POSIX_TIMER_SIGEV_THREAD)
+/*
+ * SIGEV_THREAD notifications of all the timers run on one work pool,
+ * instead of a thread per expiry. An expiry while the previous
+ * notification of the timer is still pending is merged into it.
+ */
+static struct k_work_pool timer_pool;
+
+K_THREAD_STACK_ARRAY_DEFINE(timer_pool_stacks, CONFIG_POSIX_TIMER_WORKERS,
+			    CONFIG_POSIX_TIMER_WORKER_STACK_SIZE);
+#if CONFIG_POSIX_TIMER_WORKERS > 1
+static struct k_thread timer_pool_threads[CONFIG_POSIX_TIMER_WORKERS - 1];
+#endif
+
+static void timer_work_handler(struct k_work *work)
+{
+	struct timer_obj *timer = CONTAINER_OF(work, struct timer_obj, work);
+
+	(timer->sigev_notify_function)(timer->val);
+}
+
+static int timer_pool_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_pool_start(&timer_pool, timer_pool_stacks[0],
+			  CONFIG_POSIX_TIMER_WORKER_STACK_SIZE,
+			  CONFIG_POSIX_TIMER_WORKER_PRIORITY);
+
+#if CONFIG_POSIX_TIMER_WORKERS > 1
+	for (int i = 1; i < CONFIG_POSIX_TIMER_WORKERS; i++) {
+		k_work_pool_add_worker(&timer_pool, &timer_pool_threads[i - 1],
+				       timer_pool_stacks[i],
+				       CONFIG_POSIX_TIMER_WORKER_STACK_SIZE, -1);
+	}
+#endif
+
+	return 0;
+}
+
+SYS_INIT(timer_pool_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+/* Drop a notification not yet taken by a worker */
+static void timer_work_cancel(struct timer_obj *timer)
+{
+	int key = irq_lock();
+
+	if (k_work_pending(&timer->work) &&
+	    k_queue_remove(&timer_pool.work_q.queue, &timer->work)) {
+		atomic_clear_bit(timer->work.flags, K_WORK_STATE_PENDING);
+	}
+
+	irq_unlock(key);
+}
+#endif /* CONFIG_POSIX_TIMER_SIGEV_THREAD */
+
 static void zephyr_timer_wrapper(struct k_timer *ztimer)
 {
 	struct timer_obj *timer;
@@ -36,14 +97,24 @@ static void zephyr_timer_wrapper(struct k_timer *ztimer)
 		timer->status = NOT_ACTIVE;
 	}
 
+#if defined(CONFIG_POSIX_TIMER_SIGEV_THREAD)
+	if (timer->sigev_notify == SIGEV_THREAD) {
+		k_work_submit_to_queue(&timer_pool.work_q, &timer->work);
+		return;
+	}
+#endif
+
 	(timer->sigev_notify_function)(timer->val);
 }
 
 /**
  * @brief Create a per-process timer.
  *
- * This API does not accept SIGEV_THREAD as valid signal event notification
- * type.
+ * SIGEV_SIGNAL notification functions are called from the timer
+ * interrupt. SIGEV_THREAD is only accepted with
+ * CONFIG_POSIX_TIMER_SIGEV_THREAD: notification functions then run on a
+ * work pool thread shared by all timers, and sigev_notify_attributes is
+ * ignored.
  *
  * See IEEE 1003.1
  */
@@ -53,7 +124,9 @@ int timer_create(clockid_t clockid, struct sigevent *evp, timer_t *timerid)
 
 	if (clockid != CLOCK_MONOTONIC || evp == NULL ||
 	    (evp->sigev_notify != SIGEV_NONE &&
-	     evp->sigev_notify != SIGEV_SIGNAL)) {
+	     evp->sigev_notify != SIGEV_SIGNAL &&
+	     !(IS_ENABLED(CONFIG_POSIX_TIMER_SIGEV_THREAD) &&
+	       evp->sigev_notify == SIGEV_THREAD))) {
 		errno = EINVAL;
 		return -1;
 	}
@@ -72,6 +145,11 @@ int timer_create(clockid_t clockid, struct sigevent *evp, timer_t *timerid)
 	timer->reload = 0;
 	timer->status = NOT_ACTIVE;
 
+#if defined(CONFIG_POSIX_TIMER_SIGEV_THREAD)
+	timer->sigev_notify = evp->sigev_notify;
+	k_work_init(&timer->work, timer_work_handler);
+#endif
+
 	if (evp->sigev_notify == SIGEV_NONE) {
 		k_timer_init(&timer->ztimer, NULL, NULL);
 	} else {
@@ -181,6 +259,9 @@ int timer_settime(timer_t timerid, int flags, const struct itimerspec *value,
 /**
  * @brief Delete a per-process timer.
  *
+ * A pending SIGEV_THREAD notification is dropped, one already running is
+ * not waited for.
+ *
  * See IEEE 1003.1
  */
 int timer_delete(timer_t timerid)
@@ -197,6 +278,10 @@ int timer_delete(timer_t timerid)
 		k_timer_stop(&timer->ztimer);
 	}
 
+#if defined(CONFIG_POSIX_TIMER_SIGEV_THREAD)
+	timer_work_cancel(timer);
+#endif
+
 	k_mem_slab_free(&posix_timer_slab, (void *) &timer);
 
 	return 0;
@@ -216,11 +216,17 @@ void rb_insert(struct rbtree *tree, struct rbnode *node)
 
 	if (!tree->root) {
 		tree->root = node;
+		tree->min = node;
 		tree->max_depth = 1;
 		set_color(node, BLACK);
 		return;
 	}
 
+	/* Equal nodes are inserted to the right, after the minimum */
+	if (tree->lessthan_fn(node, tree->min)) {
+		tree->min = node;
+	}
+
 	struct rbnode *stack[tree->max_depth + 1];
 
 	int stacksz = find_and_stack(tree, node, stack);
@@ -363,6 +369,24 @@ void rb_remove(struct rbtree *tree, struct rbnode *node)
 		return;
 	}
 
+	/* The minimum has no left child, so its successor is the leftmost
+	 * node of its right subtree if any, or else its parent.  Nodes
+	 * don't move in memory, the rebalancing below keeps it valid.
+	 */
+	if (node == tree->min) {
+		struct rbnode *next = get_child(node, 1);
+
+		if (next) {
+			while (get_child(next, 0)) {
+				next = get_child(next, 0);
+			}
+		} else {
+			next = stacksz > 1 ? stack[stacksz - 2] : NULL;
+		}
+
+		tree->min = next;
+	}
+
 	/* We can only remove a node with zero or one child, if we
 	 * have two then pick the "biggest" child of side 0 (smallest
 	 * of 1 would work too) and swap our spot in the tree with
@@ -498,6 +522,34 @@ int _rb_is_black(struct rbnode *node)
 	return is_black(node);
 }
 
+struct rbnode *rb_next(struct rbtree *tree, struct rbnode *node)
+{
+	struct rbnode *n = get_child(node, 1);
+	struct rbnode *next = NULL;
+
+	if (n) {
+		while (get_child(n, 0)) {
+			n = get_child(n, 0);
+		}
+
+		return n;
+	}
+
+	/* The successor is the lowest ancestor whose left subtree holds
+	 * the node, follow the same path as insertion does
+	 */
+	for (n = tree->root; n && n != node; ) {
+		if (tree->lessthan_fn(node, n)) {
+			next = n;
+			n = get_child(n, 0);
+		} else {
+			n = get_child(n, 1);
+		}
+	}
+
+	return next;
+}
+
 int rb_contains(struct rbtree *tree, struct rbnode *node)
 {
 	struct rbnode *n = tree->root;
@@ -7,6 +7,7 @@
  */
 
 #include <ring_buffer.h>
+#include <string.h>
 
 /**
  * Internal data structure for a buffer header.
@@ -92,3 +93,100 @@ int sys_ring_buf_get(struct ring_buf *buf, u16_t *type, u8_t *value,
 
 	return 0;
 }
+
+/*
+ * Byte ring buffers: the producer only writes the tail and the consumer
+ * only writes the head. The atomic accessors order the accesses to the
+ * data with the index updates.
+ */
+
+u32_t sys_ring_buf_bytes_put_claim(struct ring_buf_bytes *buf, u8_t **data,
+				   u32_t size)
+{
+	u32_t tail = atomic_get(&buf->tail);
+	u32_t space = sys_ring_buf_bytes_space_get(buf);
+	u32_t offset = tail & buf->mask;
+
+	size = min(size, space);
+	size = min(size, buf->mask + 1 - offset);
+
+	*data = &buf->buf[offset];
+
+	return size;
+}
+
+int sys_ring_buf_bytes_put_finish(struct ring_buf_bytes *buf, u32_t size)
+{
+	if (size > sys_ring_buf_bytes_space_get(buf)) {
+		return -EINVAL;
+	}
+
+	atomic_set(&buf->tail, (u32_t)atomic_get(&buf->tail) + size);
+
+	return 0;
+}
+
+u32_t sys_ring_buf_bytes_put(struct ring_buf_bytes *buf, const u8_t *data,
+			     u32_t size)
+{
+	u32_t total = 0, len;
+	u8_t *dst;
+
+	/* at most two spans, before and after the end of the buffer */
+	do {
+		len = sys_ring_buf_bytes_put_claim(buf, &dst, size);
+		memcpy(dst, data, len);
+		sys_ring_buf_bytes_put_finish(buf, len);
+
+		data += len;
+		size -= len;
+		total += len;
+	} while (size && len);
+
+	return total;
+}
+
+u32_t sys_ring_buf_bytes_get_claim(struct ring_buf_bytes *buf, u8_t **data,
+				   u32_t size)
+{
+	u32_t head = atomic_get(&buf->head);
+	u32_t used = sys_ring_buf_bytes_used_get(buf);
+	u32_t offset = head & buf->mask;
+
+	size = min(size, used);
+	size = min(size, buf->mask + 1 - offset);
+
+	*data = &buf->buf[offset];
+
+	return size;
+}
+
+int sys_ring_buf_bytes_get_finish(struct ring_buf_bytes *buf, u32_t size)
+{
+	if (size > sys_ring_buf_bytes_used_get(buf)) {
+		return -EINVAL;
+	}
+
+	atomic_set(&buf->head, (u32_t)atomic_get(&buf->head) + size);
+
+	return 0;
+}
+
+u32_t sys_ring_buf_bytes_get(struct ring_buf_bytes *buf, u8_t *data,
+			     u32_t size)
+{
+	u32_t total = 0, len;
+	u8_t *src;
+
+	do {
+		len = sys_ring_buf_bytes_get_claim(buf, &src, size);
+		memcpy(data, src, len);
+		sys_ring_buf_bytes_get_finish(buf, len);
+
+		data += len;
+		size -= len;
+		total += len;
+	} while (size && len);
+
+	return total;
+}
@@ -18,6 +18,10 @@
 #include <toolchain.h>
 #include <linker/sections.h>
 #include <syscall_handler.h>
+#if defined(CONFIG_PRINTK_DICTIONARY)
+#include <string.h>
+#include <linker/linker-defs.h>
+#endif
 
 typedef int (*out_func_t)(int c, void *ctx);
 
@@ -285,10 +289,165 @@ int vprintk(const char *fmt, va_list ap)
 	}
 }
 #else
+#if defined(CONFIG_PRINTK_DICTIONARY)
+/*
+ * Dictionary mode: instead of the formatted text, a frame made of
+ * DICT_FRAME_START, the payload length and the payload is output. The
+ * payload holds the offset of the format string in read-only data,
+ * followed by the arguments as LEB128 numbers (zigzag encoded for %d and
+ * %i). A string argument is either its offset in read-only data plus
+ * one, or 0 followed by its null terminated characters. The host decodes
+ * the frames with scripts/printk_dict.py and the string database
+ * generated along with the image.
+ */
+#define DICT_FRAME_START 0xfe
+/* payload length must fit in a single LEB128 byte */
+#define DICT_FRAME_SIZE 127
+
+static inline bool dict_in_rodata(const char *str)
+{
+	return str >= _image_rodata_start && str < _image_rodata_end;
+}
+
+static u8_t *dict_put_uint(u8_t *ptr, u8_t *end, u64_t value)
+{
+	do {
+		if (ptr == end) {
+			return NULL;
+		}
+
+		*ptr++ = (value & 0x7f) | ((value > 0x7f) ? 0x80 : 0);
+		value >>= 7;
+	} while (value);
+
+	return ptr;
+}
+
+static u8_t *dict_put_str(u8_t *ptr, u8_t *end, const char *str)
+{
+	if (str && dict_in_rodata(str)) {
+		return dict_put_uint(ptr, end, str - _image_rodata_start + 1);
+	}
+
+	if (!str) {
+		str = "(null)";
+	}
+
+	ptr = dict_put_uint(ptr, end, 0);
+
+	while (ptr && ptr < end) {
+		*ptr = *str++;
+		if (!*ptr++) {
+			return ptr;
+		}
+	}
+
+	return NULL;
+}
+
+/* Return the number of bytes output, -1 if the message needs text */
+static int dict_vprintk(const char *fmt, va_list ap)
+{
+	u8_t frame[2 + DICT_FRAME_SIZE];
+	u8_t *end = frame + sizeof(frame);
+	u8_t *ptr = frame + 2;
+	long long value;
+	int long_ctr;
+	int i, len;
+
+	if (!dict_in_rodata(fmt)) {
+		return -1;
+	}
+
+	ptr = dict_put_uint(ptr, end, fmt - _image_rodata_start);
+
+	while (ptr && (fmt = strchr(fmt, '%')) != NULL) {
+		fmt++;
+
+		/* flags, width and precision are applied by the host */
+		while (*fmt && strchr("-+ #0123456789.", *fmt)) {
+			fmt++;
+		}
+
+		for (long_ctr = 0; *fmt == 'l' || *fmt == 'h' || *fmt == 'z';
+		     fmt++) {
+			long_ctr += (*fmt == 'l');
+		}
+
+		switch (*fmt) {
+		case 's':
+			ptr = dict_put_str(ptr, end, va_arg(ap, const char *));
+			break;
+		case 'd':
+		case 'i':
+			if (long_ctr > 1) {
+				value = va_arg(ap, long long);
+			} else if (long_ctr) {
+				value = va_arg(ap, long);
+			} else {
+				value = va_arg(ap, int);
+			}
+			ptr = dict_put_uint(ptr, end,
+					    ((u64_t)value << 1) ^ (value >> 63));
+			break;
+		case 'c':
+		case 'o':
+		case 'p':
+		case 'u':
+		case 'x':
+		case 'X':
+			if (long_ctr > 1) {
+				value = va_arg(ap, unsigned long long);
+			} else if (long_ctr) {
+				value = va_arg(ap, unsigned long);
+			} else {
+				value = va_arg(ap, unsigned int);
+			}
+			ptr = dict_put_uint(ptr, end, value);
+			break;
+		case '\0':
+			fmt--;
+			break;
+		default:
+			break;
+		}
+
+		fmt++;
+	}
+
+	if (!ptr) {
+		return -1;
+	}
+
+	len = ptr - frame;
+	frame[0] = DICT_FRAME_START;
+	frame[1] = len - 2;
+
+	for (i = 0; i < len; i++) {
+		_char_out(frame[i]);
+	}
+
+	return len;
+}
+#endif /* CONFIG_PRINTK_DICTIONARY */
+
 int vprintk(const char *fmt, va_list ap)
 {
 	struct out_context ctx = { 0 };
 
+#if defined(CONFIG_PRINTK_DICTIONARY)
+	va_list aq;
+	int ret;
+
+	va_copy(aq, ap);
+	ret = dict_vprintk(fmt, aq);
+	va_end(aq);
+
+	if (ret >= 0) {
+		return ret;
+	}
+#endif
+
 	_vprintk(char_out, &ctx, fmt, ap);
 
 	return ctx.count;
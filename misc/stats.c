@@ -9,19 +9,25 @@
 #include <stdio.h>
 #include <errno.h>
 #include <zephyr/types.h>
+#include <misc/printk.h>
+#include <misc/util.h>
 #include <stats.h>
 
 #define STATS_GEN_NAME_MAX_LEN  (sizeof("s255"))
 
+/* Histogram bucket names are generated as <histogram>.<bucket> */
+#define STATS_NAME_MAX_LEN      32
+
 /* The global list of registered statistic groups. */
 static struct stats_hdr *stats_list;
 
 static const char *
-stats_get_name(const struct stats_hdr *hdr, int idx)
+stats_get_name(const struct stats_hdr *hdr, int idx, char *buf)
 {
 #ifdef CONFIG_STATS_NAMES
 	const struct stats_name_map *cur;
 	u16_t off;
+	int bucket;
 	int i;
 
 	/* The stats name map contains two elements, an offset into the
@@ -32,9 +38,16 @@ stats_get_name(const struct stats_hdr *hdr, int idx)
 	off = sizeof(*hdr) + idx * hdr->s_size;
 	for (i = 0; i < hdr->s_map_cnt; i++) {
 		cur = hdr->s_map + i;
-		if (cur->snm_off == off) {
+		if (cur->snm_off == off && cur->snm_cnt <= 1) {
 			return cur->snm_name;
 		}
+
+		bucket = (off - cur->snm_off) / hdr->s_size;
+		if (off >= cur->snm_off && bucket < cur->snm_cnt) {
+			snprintk(buf, STATS_NAME_MAX_LEN, "%s.%d",
+				 cur->snm_name, bucket);
+			return buf;
+		}
 	}
 #endif
 
@@ -97,12 +110,12 @@ int
 stats_walk(struct stats_hdr *hdr, stats_walk_fn *walk_func, void *arg)
 {
 	const char *name;
-	char name_buf[STATS_GEN_NAME_MAX_LEN];
+	char name_buf[max(STATS_GEN_NAME_MAX_LEN, STATS_NAME_MAX_LEN)];
 	int rc;
 	int i;
 
 	for (i = 0; i < hdr->s_cnt; i++) {
-		name = stats_get_name(hdr, i);
+		name = stats_get_name(hdr, i, name_buf);
 		if (name == NULL) {
 			/* No assigned name; generate a temporary s<#> name. */
 			stats_gen_name(i, name_buf);
@@ -283,3 +296,96 @@ stats_reset(struct stats_hdr *hdr)
 {
 	memset(hdr + 1, 0, hdr->s_size * hdr->s_cnt);
 }
+
+u64_t
+stats_value_get(const struct stats_hdr *hdr, u16_t off)
+{
+	const void *entry = (const u8_t *)hdr + off;
+	unsigned int key;
+	u64_t value;
+
+	switch (hdr->s_size) {
+	case sizeof(u16_t):
+		return *(const u16_t *)entry;
+	case sizeof(u32_t):
+		return *(const u32_t *)entry;
+	default:
+		/* not read atomically on 32-bit CPUs */
+		key = irq_lock();
+		value = *(const u64_t *)entry;
+		irq_unlock(key);
+		return value;
+	}
+}
+
+static int
+stats_snapshot_group(const struct stats_hdr *hdr, u8_t *buf, size_t len)
+{
+	size_t name_len = strlen(hdr->s_name);
+	size_t need;
+	u64_t value;
+	u16_t off;
+	int i, j;
+
+	name_len = min(name_len, 255);
+	need = 1 + name_len + 2 + hdr->s_cnt * hdr->s_size;
+	if (need > len) {
+		return -ENOMEM;
+	}
+
+	*buf++ = name_len;
+	memcpy(buf, hdr->s_name, name_len);
+	buf += name_len;
+	*buf++ = hdr->s_size;
+	*buf++ = hdr->s_cnt;
+
+	for (i = 0; i < hdr->s_cnt; i++) {
+		off = stats_get_off(hdr, i);
+		value = stats_value_get(hdr, off);
+
+		for (j = 0; j < hdr->s_size; j++) {
+			*buf++ = value;
+			value >>= 8;
+		}
+	}
+
+	return need;
+}
+
+/**
+ * Writes a binary snapshot of one or all statistics groups.
+ *
+ * @param name The group to take, NULL for all groups.
+ * @param buf The buffer to write the snapshot into.
+ * @param len The size of the buffer.
+ *
+ * @return The snapshot length on success, -ENOENT if the group is not
+ *         found, -ENOMEM if the buffer is too small.
+ */
+int
+stats_snapshot(const char *name, u8_t *buf, size_t len)
+{
+	struct stats_hdr *hdr;
+	size_t off = 0;
+	int rc;
+
+	if (name) {
+		hdr = stats_group_find(name);
+		if (hdr == NULL) {
+			return -ENOENT;
+		}
+
+		return stats_snapshot_group(hdr, buf, len);
+	}
+
+	for (hdr = stats_list; hdr != NULL; hdr = hdr->s_next) {
+		rc = stats_snapshot_group(hdr, buf + off, len - off);
+		if (rc < 0) {
+			return rc;
+		}
+
+		off += rc;
+	}
+
+	return off;
+}
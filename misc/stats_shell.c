@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/types.h>
+#include <errno.h>
+#include <shell/shell.h>
+#include <misc/printk.h>
+#include <stats.h>
+
+#define STATS_SHELL_MODULE "stats"
+
+static int stats_shell_list_cb(struct stats_hdr *hdr, void *arg)
+{
+	ARG_UNUSED(arg);
+
+	printk("%s (%u entries of %u bytes)\n", hdr->s_name, hdr->s_cnt,
+	       hdr->s_size);
+
+	return 0;
+}
+
+static int shell_cmd_list(int argc, char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	stats_group_walk(stats_shell_list_cb, NULL);
+
+	return 0;
+}
+
+static int stats_shell_show_cb(struct stats_hdr *hdr, void *arg,
+			       const char *name, u16_t off)
+{
+	ARG_UNUSED(arg);
+
+	printk("  %s: %llu\n", name, stats_value_get(hdr, off));
+
+	return 0;
+}
+
+static int shell_cmd_show(int argc, char *argv[])
+{
+	struct stats_hdr *hdr;
+
+	if (argc < 2) {
+		return -EINVAL;
+	}
+
+	hdr = stats_group_find(argv[1]);
+	if (!hdr) {
+		printk("No group %s\n", argv[1]);
+		return -ENOENT;
+	}
+
+	printk("%s:\n", hdr->s_name);
+	stats_walk(hdr, stats_shell_show_cb, NULL);
+
+	return 0;
+}
+
+static int shell_cmd_snapshot(int argc, char *argv[])
+{
+	u8_t buf[CONFIG_STATS_SHELL_SNAPSHOT_SIZE];
+	int len, i;
+
+	len = stats_snapshot(argc > 1 ? argv[1] : NULL, buf, sizeof(buf));
+	if (len < 0) {
+		printk("Snapshot failed (%d)\n", len);
+		return len;
+	}
+
+	for (i = 0; i < len; i++) {
+		printk("%02x%s", buf[i], (i % 32 == 31) ? "\n" : "");
+	}
+
+	if (len % 32) {
+		printk("\n");
+	}
+
+	return 0;
+}
+
+static struct shell_cmd stats_commands[] = {
+	{ "list", shell_cmd_list, NULL },
+	{ "show", shell_cmd_show, "<group>" },
+	{ "snapshot", shell_cmd_snapshot, "[<group>]" },
+	{ NULL, NULL, NULL },
+};
+
+SHELL_REGISTER(STATS_SHELL_MODULE, stats_commands);
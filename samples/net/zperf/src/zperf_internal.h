@@ -97,6 +97,9 @@ extern void zperf_udp_upload(struct net_context *net_context,
 
 extern void zperf_receiver_init(int port);
 
+void zperf_sysstats_start(void);
+void zperf_sysstats_print(const char *tag);
+
 #if defined(CONFIG_NET_TCP)
 extern void zperf_tcp_receiver_init(int port);
 extern void zperf_tcp_uploader_init(struct k_fifo *tx_queue);
@@ -425,6 +425,15 @@ static void shell_tcp_upload2_usage(void)
 }
 #endif
 
+static void print_packet_rate(const char *tag, u32_t packets,
+			      u32_t time_in_us)
+{
+	if (time_in_us) {
+		printk("%s packet rate:\t\t%u pkt/s\n", tag,
+		       (u32_t)((u64_t)packets * USEC_PER_SEC / time_in_us));
+	}
+}
+
 #if defined(CONFIG_NET_UDP)
 static void shell_udp_upload_print_stats(struct zperf_results *results)
 {
@@ -481,6 +490,10 @@ static void shell_udp_upload_print_stats(struct zperf_results *results)
 	printk("\t(");
 	print_number(client_rate_in_kbps, KBPS, KBPS_UNIT);
 	printk(")\n");
+
+	print_packet_rate("[" CMD_STR_UDP_UPLOAD "]", results->nb_packets_sent,
+			  results->client_time_in_us);
+	zperf_sysstats_print("[" CMD_STR_UDP_UPLOAD "]");
 }
 #endif
 
@@ -511,6 +524,10 @@ static void shell_tcp_upload_print_stats(struct zperf_results *results)
 	printk("[%s] rate:\t", CMD_STR_TCP_UPLOAD);
 	print_number(client_rate_in_kbps, KBPS, KBPS_UNIT);
 	printk("\n");
+
+	print_packet_rate("[" CMD_STR_TCP_UPLOAD "]", results->nb_packets_sent,
+			  results->client_time_in_us);
+	zperf_sysstats_print("[" CMD_STR_TCP_UPLOAD "]");
 }
 #endif
 
@@ -606,6 +623,8 @@ static int execute_upload(struct net_context *context6,
 	printk("[%s] packet size:\t%u bytes\n", argv0, packet_size);
 	printk("[%s] start...\n", argv0);
 
+	zperf_sysstats_start();
+
 #if defined(CONFIG_NET_IPV6)
 	if (family == AF_INET6 && context6) {
 		/* For IPv6, we should make sure that neighbor discovery
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * System resources used during a test: CPU utilization, from the time
+ * spent by the idle threads, and the lowest number of free network
+ * buffers.
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+
+#include <net/net_pkt.h>
+#include <net/buf.h>
+
+#include "zperf_internal.h"
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+#define ZPERF_CPU_LOAD 1
+
+static u32_t start_time;
+static u64_t start_idle;
+
+static void idle_cycles_cb(const struct k_thread *thread, void *user_data)
+{
+	struct k_thread_runtime_stats stats;
+	k_tid_t tid = (k_tid_t)thread;
+
+	if (k_thread_priority_get(tid) != K_IDLE_PRIO) {
+		return;
+	}
+
+	if (!k_thread_runtime_stats_get(tid, &stats)) {
+		*(u64_t *)user_data += stats.execution_cycles;
+	}
+}
+
+static u64_t idle_cycles(void)
+{
+	u64_t cycles = 0;
+
+	k_thread_foreach(idle_cycles_cb, &cycles);
+
+	return cycles;
+}
+#endif
+
+void zperf_sysstats_start(void)
+{
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	struct net_buf_pool *rx_data, *tx_data;
+	struct k_mem_slab *rx, *tx;
+
+	net_pkt_get_info(&rx, &tx, &rx_data, &tx_data);
+	rx_data->min_avail_count = rx_data->avail_count;
+	tx_data->min_avail_count = tx_data->avail_count;
+#endif
+
+#if defined(ZPERF_CPU_LOAD)
+	start_idle = idle_cycles();
+	start_time = k_cycle_get_32();
+#endif
+}
+
+void zperf_sysstats_print(const char *tag)
+{
+#if defined(ZPERF_CPU_LOAD)
+	u64_t elapsed = (u64_t)time_delta(start_time, k_cycle_get_32()) *
+			CONFIG_MP_NUM_CPUS;
+	u64_t idle = idle_cycles() - start_idle;
+
+	if (elapsed) {
+		printk("%s CPU load:\t\t%u %%\n", tag,
+		       (u32_t)(100 - min(idle, elapsed) * 100 / elapsed));
+	}
+#endif
+
+#if defined(CONFIG_NET_BUF_POOL_USAGE)
+	struct net_buf_pool *rx_data, *tx_data;
+	struct k_mem_slab *rx, *tx;
+
+	net_pkt_get_info(&rx, &tx, &rx_data, &tx_data);
+	printk("%s RX buffers min free:\t%d/%u\n", tag,
+	       rx_data->min_avail_count, rx_data->buf_count);
+	printk("%s TX buffers min free:\t%d/%u\n", tag,
+	       tx_data->min_avail_count, tx_data->buf_count);
+#endif
+}
@@ -63,6 +63,7 @@ static void tcp_received(struct net_context *context,
 	case STATE_COMPLETED:
 		printk(TAG "New session started\n");
 		zperf_reset_session_stats(session);
+		zperf_sysstats_start();
 		session->start_time = k_cycle_get_32();
 		session->state = STATE_ONGOING;
 		/* fall through */
@@ -97,6 +98,11 @@ static void tcp_received(struct net_context *context,
 			printk(TAG " rate:\t\t\t");
 			print_number(rate_in_kbps, KBPS, KBPS_UNIT);
 			printk("\n");
+
+			printk(TAG " packet rate:\t\t%u pkt/s\n", duration ?
+			       (u32_t)((u64_t)session->counter *
+				       USEC_PER_SEC / duration) : 0);
+			zperf_sysstats_print(CMD_STR_TCP_DOWNLOAD);
 		}
 		break;
 	case STATE_LAST_PACKET_RECEIVED:
@@ -200,6 +200,7 @@ static void udp_received(struct net_context *context,
 		printk(TAG "New session started.\n");
 
 		zperf_reset_session_stats(session);
+		zperf_sysstats_start();
 		session->state = STATE_ONGOING;
 		session->start_time = time;
 	}
@@ -293,6 +294,8 @@ static void udp_received(struct net_context *context,
 			printk(TAG " rate:\t\t\t");
 			print_number(rate_in_kbps, KBPS, KBPS_UNIT);
 			printk("\n");
+
+			zperf_sysstats_print(CMD_STR_UDP_DOWNLOAD);
 		}
 	} else {
 		net_pkt_unref(pkt);
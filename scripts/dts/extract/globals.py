@@ -16,7 +16,9 @@ reduced = {}
 regs_config = {
     'zephyr,flash' : 'CONFIG_FLASH',
     'zephyr,sram'  : 'CONFIG_SRAM',
-    'zephyr,ccm'   : 'CONFIG_CCM'
+    'zephyr,ccm'   : 'CONFIG_CCM',
+    'zephyr,itcm'  : 'CONFIG_ITCM',
+    'zephyr,dtcm'  : 'CONFIG_DTCM'
 }
 
 name_config = {
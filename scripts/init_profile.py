@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2018 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Report the time taken by the boot time init functions of a Zephyr image.
+
+The input is the captured output of device_init_profile_print()
+(CONFIG_BOOT_INIT_PROFILE), printed at boot with
+CONFIG_BOOT_INIT_PROFILE_PRINT or by the "kernel initcalls" shell command.
+Other lines of the capture are ignored.
+
+The init functions are listed from the slowest, followed by a timeline of
+the boot. With the ELF image, init functions are named by symbol, as
+listed by readelf, else by device name or address. A folded stacks file,
+as taken by flamegraph.pl, can be written as well.
+"""
+
+import sys
+import re
+import argparse
+import subprocess
+
+HEADER = re.compile(r"init profile: (\d+) entries, (\d+) dropped, "
+                    r"(\d+) cycles/s")
+ENTRY = re.compile(r"init: (\d+) (0x[0-9a-fA-F]+) (\d+) (\d+) ?(.*)$")
+READELF_SYMBOL = re.compile(
+    r"^\s*\d+:\s+([0-9a-f]+)\s+\S+\s+FUNC\s+\w+\s+\w+\s+\S+\s+(\S+)$")
+
+LEVELS = ["PRE_KERNEL_1", "PRE_KERNEL_2", "POST_KERNEL", "APPLICATION"]
+
+
+class InitCall:
+    def __init__(self, level, addr, start, cycles, device):
+        self.level = LEVELS[level] if level < len(LEVELS) else str(level)
+        self.addr = addr
+        self.start = start
+        self.cycles = cycles
+        self.device = device
+        self.name = None
+
+
+def load_symbols(readelf, elf_name):
+    funcs = {}
+    thumb = False
+
+    out = subprocess.check_output([readelf, "-W", "-h", "-s", elf_name],
+                                  universal_newlines=True)
+    for line in out.splitlines():
+        key, _, value = line.partition(":")
+        if key.strip() == "Machine":
+            thumb = value.strip() == "ARM"
+            continue
+
+        m = READELF_SYMBOL.match(line)
+        if m:
+            funcs[int(m.group(1), 16)] = m.group(2)
+
+    if thumb:
+        # thumb functions have the lowest bit set
+        funcs = {addr & ~1: name for addr, name in funcs.items()}
+
+    return funcs, thumb
+
+
+def parse(f):
+    calls = []
+    freq = None
+    dropped = 0
+
+    for line in f:
+        m = HEADER.search(line)
+        if m:
+            # keep the last profile of the capture only
+            calls = []
+            dropped = int(m.group(2))
+            freq = int(m.group(3))
+            continue
+
+        m = ENTRY.search(line.rstrip("\r\n"))
+        if m:
+            calls.append(InitCall(int(m.group(1)), int(m.group(2), 16),
+                                  int(m.group(3)), int(m.group(4)),
+                                  m.group(5)))
+
+    return calls, freq, dropped
+
+
+def parse_args():
+    global args
+
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+
+    parser.add_argument("input", nargs="?",
+                        help="Captured output, standard input by default")
+    parser.add_argument("-e", "--elf", help="Zephyr ELF binary")
+    parser.add_argument("--readelf", default="readelf",
+                        help="readelf of the toolchain")
+    parser.add_argument("-w", "--width", type=int, default=60,
+                        help="Width of the timeline bars (default 60)")
+    parser.add_argument("-f", "--folded",
+                        help="Write folded stacks for flamegraph.pl")
+
+    args = parser.parse_args()
+
+
+def main():
+    parse_args()
+
+    if args.input:
+        with open(args.input, errors="replace") as f:
+            calls, freq, dropped = parse(f)
+    else:
+        calls, freq, dropped = parse(sys.stdin)
+
+    if not calls:
+        sys.exit("no init profile found in the input")
+
+    funcs, thumb = {}, False
+    if args.elf:
+        funcs, thumb = load_symbols(args.readelf, args.elf)
+    for call in calls:
+        addr = call.addr & ~1 if thumb else call.addr
+        call.name = funcs.get(addr) or call.device or "0x%x" % call.addr
+
+    # start times are relative to the first init function, modulo the
+    # 32 bit cycle counter
+    t0 = calls[0].start
+    for call in calls:
+        call.start = (call.start - t0) & 0xffffffff
+
+    total = sum(c.cycles for c in calls)
+    span = max(c.start + c.cycles for c in calls) or 1
+
+    def us(cycles):
+        return "%.1f" % (cycles * 1e6 / freq) if freq else "-"
+
+    print("%-14s %-32s %-16s %10s %10s %6s" % ("Level", "Function",
+                                               "Device", "Cycles", "us",
+                                               "%"))
+    for call in sorted(calls, key=lambda c: c.cycles, reverse=True):
+        print("%-14s %-32s %-16s %10d %10s %6.1f" % (
+            call.level, call.name, call.device or "-", call.cycles,
+            us(call.cycles), 100.0 * call.cycles / (total or 1)))
+
+    print("%-14s %-32s %-16s %10d %10s" % ("Total", "", "", total,
+                                           us(total)))
+    if dropped:
+        print("%d init functions not profiled" % dropped)
+
+    print("\nTimeline (%s cycles):" % span)
+    for call in calls:
+        pos = call.start * args.width // span
+        length = max(call.cycles * args.width // span,
+                     1 if call.cycles else 0)
+        print("%-32s |%s%s%s|" % (call.name[:32], " " * pos, "#" * length,
+                                  " " * max(args.width - pos - length, 0)))
+
+    if args.folded:
+        with open(args.folded, "w") as f:
+            for call in calls:
+                f.write("%s;%s %d\n" % (call.level, call.name, call.cycles))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2018 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Support for the dictionary mode of printk (CONFIG_PRINTK_DICTIONARY).
+
+In this mode the target outputs, instead of formatted text, frames holding
+the offset of the format string in read-only data and the raw arguments.
+
+  database: extract the strings of read-only data from the ELF image into
+            a JSON database, done at build time.
+  decode:   turn the output of the target back into text using the
+            database. Text outside of frames is passed through unchanged.
+"""
+
+import sys
+import argparse
+import bisect
+import json
+import re
+
+FRAME_START = 0xfe
+
+CONVERSION = re.compile(rb"%([-+ #0]*[0-9]*(?:\.[0-9]*)?)([lhz]*)(.|$)",
+                        re.DOTALL)
+
+
+def gen_database(elf_name, db_name):
+    from elftools.elf.elffile import ELFFile
+    from elftools.elf.sections import SymbolTableSection
+
+    with open(elf_name, "rb") as f:
+        elf = ELFFile(f)
+
+        syms = {}
+        for section in elf.iter_sections():
+            if isinstance(section, SymbolTableSection):
+                for sym in section.iter_symbols():
+                    syms[sym.name] = sym.entry.st_value
+
+        start = syms["_image_rodata_start"]
+        end = syms["_image_rodata_end"]
+
+        rodata = bytearray(end - start)
+        for section in elf.iter_sections():
+            addr = section["sh_addr"]
+            size = section["sh_size"]
+            if (section["sh_type"] != "SHT_PROGBITS" or
+                    addr + size <= start or addr >= end):
+                continue
+
+            data = section.data()
+            lo = max(addr, start)
+            hi = min(addr + size, end)
+            rodata[lo - start:hi - start] = data[lo - addr:hi - addr]
+
+    # Every null terminated run of text is a candidate, pointers into the
+    # middle of a string (merged suffixes) are resolved by the decoder.
+    strings = {}
+    for m in re.finditer(rb"[\t\n\r\x1b\x20-\x7e]+\x00", bytes(rodata)):
+        strings[m.start()] = m.group()[:-1].decode("ascii")
+
+    with open(db_name, "w") as f:
+        json.dump({"rodata_start": start, "strings": strings}, f)
+
+
+class Decoder:
+    def __init__(self, db_name):
+        with open(db_name) as f:
+            db = json.load(f)
+
+        self.strings = {int(k): v.encode("ascii")
+                        for k, v in db["strings"].items()}
+        self.offsets = sorted(self.strings)
+
+    def string(self, offset):
+        i = bisect.bisect_right(self.offsets, offset) - 1
+        if i < 0:
+            return None
+
+        base = self.offsets[i]
+        s = self.strings[base]
+        if offset - base > len(s):
+            return None
+
+        return s[offset - base:]
+
+    @staticmethod
+    def uint(payload, pos):
+        value = 0
+        shift = 0
+        while True:
+            byte = payload[pos]
+            pos += 1
+            value |= (byte & 0x7f) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value, pos
+
+    def frame(self, payload):
+        offset, pos = self.uint(payload, 0)
+        fmt = self.string(offset)
+        if fmt is None:
+            return b"<unknown format string 0x%x>\n" % offset
+
+        out = b""
+        last = 0
+        for m in CONVERSION.finditer(fmt):
+            out += fmt[last:m.start()]
+            last = m.end()
+
+            flags, longs, conv = m.groups()
+            if conv == b"%":
+                out += b"%"
+                continue
+            if conv == b"":
+                break
+
+            if conv == b"s":
+                offset, pos = self.uint(payload, pos)
+                if offset:
+                    arg = self.string(offset - 1) or b"<unknown string>"
+                else:
+                    end = payload.index(0, pos)
+                    arg = bytes(payload[pos:end])
+                    pos = end + 1
+            elif conv in b"diouxXcp":
+                arg, pos = self.uint(payload, pos)
+                if conv in b"di":
+                    arg = (arg >> 1) ^ -(arg & 1)
+            else:
+                out += m.group()
+                continue
+
+            if conv == b"p":
+                out += b"0x%x" % arg
+            elif conv == b"u":
+                out += (b"%" + flags + b"d") % arg
+            else:
+                out += (b"%" + flags + conv) % arg
+
+        return out + fmt[last:]
+
+    def decode(self, data, out, final=True):
+        """Decode data, return the number of bytes consumed.
+
+        Unless final is set, decoding stops before an incomplete frame.
+        """
+        pos = 0
+        while pos < len(data):
+            start = data.find(bytes([FRAME_START]), pos)
+            if start < 0:
+                start = len(data)
+
+            out.write(data[pos:start])
+            pos = start
+            if pos == len(data):
+                break
+
+            if pos + 1 >= len(data) or \
+                    pos + 2 + data[pos + 1] > len(data):
+                if not final:
+                    break
+                out.write(b"<truncated frame>\n")
+                return len(data)
+
+            length = data[pos + 1]
+            try:
+                out.write(self.frame(data[pos + 2:pos + 2 + length]))
+            except (IndexError, ValueError):
+                out.write(b"<corrupted frame>\n")
+            pos += 2 + length
+
+        return pos
+
+
+def parse_args():
+    global args
+
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+
+    sub = parser.add_subparsers(dest="cmd")
+
+    p = sub.add_parser("database", help="Generate the string database")
+    p.add_argument("elf", help="Input zephyr ELF binary")
+    p.add_argument("db", help="Output string database")
+
+    p = sub.add_parser("decode", help="Decode the output of the target")
+    p.add_argument("db", help="String database of the image")
+    p.add_argument("input", nargs="?",
+                   help="Captured output, standard input by default")
+
+    args = parser.parse_args()
+    if not args.cmd:
+        parser.error("missing command")
+
+
+def main():
+    parse_args()
+
+    if args.cmd == "database":
+        gen_database(args.elf, args.db)
+        return
+
+    decoder = Decoder(args.db)
+    out = sys.stdout.buffer
+
+    if args.input:
+        with open(args.input, "rb") as f:
+            decoder.decode(f.read(), out)
+        return
+
+    # decode as the data comes, keeping incomplete frames for later
+    pending = b""
+    while True:
+        chunk = sys.stdin.buffer.read1(256)
+        if not chunk:
+            decoder.decode(pending, out)
+            return
+
+        pending += chunk
+        pending = pending[decoder.decode(pending, out, final=False):]
+        out.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,382 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2018 Intel Corporation
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""
+Report the worst case stack depth of the threads of a Zephyr image.
+
+The stack frame sizes come from the .su files generated by GCC with
+CONFIG_STACK_USAGE (-fstack-usage), the call graph from the disassembly
+of the image. The threads are the ones defined with K_THREAD_DEFINE()
+and the kernel ones (main, idle and system work queue), found with the
+symbol table and section headers printed by readelf.
+
+The output of the "kernel stacks" shell command, captured from the
+target, can be given as well: the stack usage measured at run time is
+then reported alongside, for all the threads of the kernel thread list.
+
+The suggested stack sizes are the largest of the static and measured
+depths, plus a safety margin.
+
+Calls through function pointers (callbacks, work items, ...) are not
+followed, nor the interrupt frames pushed on thread stacks: the static
+depth is a lower bound for the threads marked as such.
+"""
+
+import os
+import re
+import argparse
+import subprocess
+import struct
+
+FUNC_HEADER = re.compile(r"^([0-9a-f]+) <([^>]+)>:$")
+INSN = re.compile(r"^\s*[0-9a-f]+:\s+(\S+)\s*(.*)$")
+DIRECT_TARGET = re.compile(r"<([^>+]+)>$")
+SU_LINE = re.compile(r"^(?:.*:)?([^:\s]+)\t(\d+)\t(\S+)$")
+READELF_SECTION = re.compile(
+    r"^\s*\[\s*\d+\]\s+(\S+)\s+(\S+)\s+([0-9a-f]+)\s+([0-9a-f]+)"
+    r"\s+([0-9a-f]+)\s")
+READELF_SYMBOL = re.compile(
+    r"^\s*\d+:\s+([0-9a-f]+)\s+(\S+)\s+(\w+)\s+\w+\s+\w+\s+\S+\s+(\S+)$")
+RUNTIME_LINE = re.compile(
+    r"(0x[0-9a-fA-F]+) \(real size (\d+)\):\s*unused (\d+)")
+
+# Calls through a register
+INDIRECT_CALLS = {
+    "blx": re.compile(r"^(r\d+|sb|sl|fp|ip|lr)$"),
+    "call": re.compile(r"^\*"),
+    "calll": re.compile(r"^\*"),
+    "jalr": re.compile(r""),
+    "jl": re.compile(r"^\[?r\d+"),
+}
+
+# name, thread object symbol, stack symbol, entry function
+KERNEL_THREADS = [
+    ("main", "_main_thread_s", "_main_stack", "bg_thread_main"),
+    ("idle", "_idle_thread_s", "_idle_stack", "idle"),
+    ("workqueue", "k_sys_work_q", "sys_work_q_stack", "work_q_main"),
+]
+
+
+class Thread:
+    def __init__(self, name, addr, addr_end, size, entry):
+        self.name = name
+        # range of the thread object, or of the object holding it
+        self.addr = addr
+        self.addr_end = addr_end
+        self.size = size
+        self.entry = entry
+        self.depth = None
+        self.notes = set()
+        self.unused = None
+
+
+def parse_su(dirs):
+    frames = {}
+    dynamic = set()
+
+    for top in dirs:
+        for root, _, files in os.walk(top):
+            for name in files:
+                if not name.endswith(".su"):
+                    continue
+
+                with open(os.path.join(root, name)) as f:
+                    for line in f:
+                        m = SU_LINE.match(line.rstrip("\n"))
+                        if not m:
+                            continue
+
+                        func, size, qual = m.groups()
+                        # file local functions may share a name
+                        frames[func] = max(frames.get(func, 0), int(size))
+                        if "dynamic" in qual and "bounded" not in qual:
+                            dynamic.add(func)
+
+    return frames, dynamic
+
+
+def parse_calls(objdump, elf_name):
+    calls = {}
+    indirect = set()
+    func = None
+
+    out = subprocess.check_output([objdump, "-d", "--no-show-raw-insn",
+                                   elf_name], universal_newlines=True)
+    for line in out.splitlines():
+        m = FUNC_HEADER.match(line)
+        if m:
+            func = m.group(2)
+            calls.setdefault(func, set())
+            continue
+
+        m = INSN.match(line)
+        if not m or not func:
+            continue
+
+        mnemonic, operands = m.groups()
+        mnemonic = mnemonic.split(".")[0]
+
+        # Branches inside the function are annotated <func+0x..>, so
+        # any other target is a call or a tail call.
+        m = DIRECT_TARGET.search(operands)
+        if m:
+            if m.group(1) != func:
+                calls[func].add(m.group(1))
+            continue
+
+        regex = INDIRECT_CALLS.get(mnemonic)
+        if regex and regex.search(operands.strip()):
+            indirect.add(func)
+
+    return calls, indirect
+
+
+def readelf(readelf_name, option, elf_name):
+    return subprocess.check_output([readelf_name, "-W", option, elf_name],
+                                   universal_newlines=True).splitlines()
+
+
+class Image:
+    def __init__(self, readelf_name, elf_name):
+        self.elf_name = elf_name
+        self.syms = {}
+        self.funcs = {}
+        self.sections = []
+
+        header = {}
+        for line in readelf(readelf_name, "-h", elf_name):
+            key, _, value = line.partition(":")
+            header[key.strip()] = value.strip()
+
+        self.ptr_size = 8 if header["Class"] == "ELF64" else 4
+        self.endian = "<" if "little endian" in header["Data"] else ">"
+        self.arm = header["Machine"] == "ARM"
+
+        for line in readelf(readelf_name, "-S", elf_name):
+            m = READELF_SECTION.match(line)
+            if m and m.group(2) == "PROGBITS":
+                addr, offset, size = (int(v, 16) for v in m.group(3, 4, 5))
+                self.sections.append((addr, offset, size))
+
+        for line in readelf(readelf_name, "-s", elf_name):
+            m = READELF_SYMBOL.match(line)
+            if not m:
+                continue
+
+            value, size, sym_type, name = m.groups()
+            value = int(value, 16)
+            # large sizes are printed in hexadecimal
+            size = int(size, 0)
+            if sym_type == "FUNC":
+                # thumb functions have the lowest bit set
+                if self.arm:
+                    value &= ~1
+                self.funcs[value] = name
+            if sym_type in ("FUNC", "OBJECT"):
+                self.syms[name] = (value, size)
+
+        self.objects = sorted((addr, size, name) for name, (addr, size)
+                              in self.syms.items())
+
+    def read(self, addr, size):
+        for start, offset, length in self.sections:
+            if start <= addr < start + length:
+                with open(self.elf_name, "rb") as f:
+                    f.seek(offset + addr - start)
+                    return f.read(min(size, start + length - addr))
+
+        return None
+
+    def name_of(self, addr):
+        """Symbolic name of an address, e.g. k_sys_work_q+0x14"""
+        best = None
+        for start, size, name in self.objects:
+            if start > addr:
+                break
+            if start <= addr < start + max(size, 1):
+                best = (start, name)
+
+        if not best:
+            return "0x%x" % addr
+        if best[0] == addr:
+            return best[1]
+        return "%s+0x%x" % (best[1], addr - best[0])
+
+    def static_threads(self):
+        threads = []
+        ptr = "I" if self.ptr_size == 4 else "Q"
+        pad = "" if self.ptr_size == 4 else "4x"
+        fmt = self.endian + ptr * 2 + "I" + pad + ptr
+
+        for name, (addr, _) in sorted(self.syms.items()):
+            if not name.startswith("_k_thread_data_"):
+                continue
+
+            data = self.read(addr, struct.calcsize(fmt))
+            if not data or len(data) < struct.calcsize(fmt):
+                continue
+
+            thread, _, size, entry = struct.unpack(fmt, data)
+            if self.arm:
+                entry &= ~1
+
+            threads.append(Thread(name[len("_k_thread_data_"):], thread,
+                                  thread + 1, size, self.funcs.get(entry)))
+
+        for name, thread_sym, stack_sym, entry in KERNEL_THREADS:
+            if thread_sym in self.syms and stack_sym in self.syms:
+                addr, size = self.syms[thread_sym]
+                threads.append(Thread(name, addr, addr + max(size, 1),
+                                      self.syms[stack_sym][1], entry))
+
+        return threads
+
+
+class CallGraph:
+    def __init__(self, frames, dynamic, calls, indirect):
+        self.frames = frames
+        self.dynamic = dynamic
+        self.calls = calls
+        self.indirect = indirect
+        self.memo = {}
+
+    def depth(self, func, notes, path=()):
+        """Worst case depth from func, and the call path reaching it"""
+        if func in path:
+            notes.add("recursion in %s" % func)
+            return 0, []
+
+        if func in self.memo:
+            depth, worst, sub_notes = self.memo[func]
+            notes.update(sub_notes)
+            return depth, worst
+
+        sub_notes = set()
+        if func not in self.frames:
+            sub_notes.add("no frame size for %s" % func)
+        if func in self.dynamic:
+            sub_notes.add("dynamic frame in %s" % func)
+        if func in self.indirect:
+            sub_notes.add("indirect calls")
+
+        depth, worst = 0, []
+        for callee in sorted(self.calls.get(func, ())):
+            d, w = self.depth(callee, sub_notes, path + (func,))
+            if d > depth:
+                depth, worst = d, w
+
+        depth += self.frames.get(func, 0)
+        worst = [func] + worst
+
+        # results found under a recursion are not cached, as they depend
+        # on the path
+        if not any(n.startswith("recursion") for n in sub_notes):
+            self.memo[func] = (depth, worst, sub_notes)
+
+        notes.update(sub_notes)
+        return depth, worst
+
+
+def parse_runtime(name):
+    used = {}
+    with open(name, errors="replace") as f:
+        for line in f:
+            m = RUNTIME_LINE.search(line)
+            if m:
+                used[int(m.group(1), 16)] = (int(m.group(2)),
+                                             int(m.group(3)))
+    return used
+
+
+def round_up(value, align):
+    return (value + align - 1) // align * align
+
+
+def parse_args():
+    global args
+
+    parser = argparse.ArgumentParser(
+        description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+
+    parser.add_argument("elf", help="Zephyr ELF binary")
+    parser.add_argument("dirs", nargs="+",
+                        help="Build directories holding the .su files")
+    parser.add_argument("-r", "--runtime",
+                        help="Captured output of \"kernel stacks\"")
+    parser.add_argument("--objdump", default="objdump",
+                        help="objdump of the toolchain")
+    parser.add_argument("--readelf", default="readelf",
+                        help="readelf of the toolchain")
+    parser.add_argument("-m", "--margin", type=int, default=25,
+                        help="Safety margin in percent (default 25)")
+    parser.add_argument("-x", "--extra", type=int, default=0,
+                        help="Bytes added to the static depth of every "
+                        "thread, e.g. for the interrupt frames")
+    parser.add_argument("-a", "--align", type=int, default=8,
+                        help="Alignment of the suggested sizes")
+    parser.add_argument("-v", "--verbose", action="store_true",
+                        help="Print the worst case call path")
+
+    args = parser.parse_args()
+
+
+def main():
+    parse_args()
+
+    image = Image(args.readelf, args.elf)
+    frames, dynamic = parse_su(args.dirs)
+    calls, indirect = parse_calls(args.objdump, args.elf)
+    graph = CallGraph(frames, dynamic, calls, indirect)
+
+    threads = image.static_threads()
+    paths = {}
+    for thread in threads:
+        if not thread.entry:
+            thread.notes.add("unknown entry function")
+            continue
+        thread.depth, paths[thread.name] = graph.depth(thread.entry,
+                                                       thread.notes)
+        thread.depth += args.extra
+
+    if args.runtime:
+        runtime = parse_runtime(args.runtime)
+        for addr, (size, unused) in sorted(runtime.items()):
+            thread = next((t for t in threads
+                           if t.addr <= addr < t.addr_end), None)
+            if not thread:
+                thread = Thread(image.name_of(addr), addr, addr + 1, size,
+                                None)
+                thread.notes.add("created at run time")
+                threads.append(thread)
+            thread.unused = unused
+            thread.size = size
+
+    print("%-24s %-24s %7s %7s %8s %9s" % ("Thread", "Entry", "Size",
+                                           "Static", "Measured",
+                                           "Suggested"))
+    for thread in threads:
+        measured = None
+        if thread.unused is not None:
+            measured = thread.size - thread.unused
+
+        worst = max(thread.depth or 0, measured or 0)
+        suggested = round_up(worst * (100 + args.margin) // 100, args.align)
+
+        print("%-24s %-24s %7d %7s %8s %9d" % (
+            thread.name, thread.entry or "-", thread.size,
+            "-" if thread.depth is None else thread.depth,
+            "-" if measured is None else measured, suggested))
+
+        for note in sorted(thread.notes):
+            print("    %s" % note)
+
+        if args.verbose and thread.name in paths:
+            print("    worst path: %s" % " -> ".join(paths[thread.name]))
+
+
+if __name__ == "__main__":
+    main()
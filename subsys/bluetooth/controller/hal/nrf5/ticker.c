@@ -86,6 +86,10 @@ void hal_ticker_instance0_sched(u8_t caller_id, u8_t callee_id, u8_t chain,
 						  ticker_job};
 
 			m.param = instance;
+#if defined(CONFIG_BT_CTLR_MAYFLY_PRIO)
+			/* ticker bookkeeping ahead of link layer work */
+			m.prio = MAYFLY_PRIO_HIGH;
+#endif
 
 			mayfly_enqueue(TICKER_MAYFLY_CALL_ID_WORKER,
 				       TICKER_MAYFLY_CALL_ID_JOB,
@@ -124,6 +128,10 @@ void hal_ticker_instance0_sched(u8_t caller_id, u8_t callee_id, u8_t chain,
 						  ticker_job};
 
 			m.param = instance;
+#if defined(CONFIG_BT_CTLR_MAYFLY_PRIO)
+			/* ticker bookkeeping ahead of link layer work */
+			m.prio = MAYFLY_PRIO_HIGH;
+#endif
 
 			mayfly_enqueue(TICKER_MAYFLY_CALL_ID_JOB,
 				       TICKER_MAYFLY_CALL_ID_JOB,
@@ -147,6 +155,10 @@ void hal_ticker_instance0_sched(u8_t caller_id, u8_t callee_id, u8_t chain,
 						  ticker_job};
 
 			m.param = instance;
+#if defined(CONFIG_BT_CTLR_MAYFLY_PRIO)
+			/* ticker bookkeeping ahead of link layer work */
+			m.prio = MAYFLY_PRIO_HIGH;
+#endif
 
 			/* TODO: scheduler lock, if preemptive threads used */
 			mayfly_enqueue(TICKER_MAYFLY_CALL_ID_PROGRAM,
@@ -48,12 +48,28 @@ static u16_t _opcode;
 struct dup {
 	u8_t         mask;
 	bt_addr_le_t addr;
+	u32_t        used;
+#if defined(CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA)
+	/* Data hash per PDU type carrying data, i.e. the even PDU types */
+	u16_t        hash[4];
+#endif /* CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA */
 };
 static struct dup dup_filter[CONFIG_BT_CTLR_DUP_FILTER_LEN];
 static s32_t dup_count;
-static u32_t dup_curr;
+static u32_t dup_used;
 #endif
 
+#if CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0
+/* Scan report payload patterns */
+struct scan_pattern {
+	u8_t ad_type;
+	u8_t len;
+	u8_t data[BT_HCI_VS_SCAN_PATTERN_LEN_MAX];
+};
+static struct scan_pattern scan_pattern[CONFIG_BT_CTLR_SCAN_PATTERN_COUNT];
+static u8_t scan_pattern_count;
+#endif /* CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0 */
+
 #if defined(CONFIG_BT_HCI_ACL_FLOW_CONTROL)
 s32_t    hci_hbuf_total;
 u32_t    hci_hbuf_sent;
@@ -968,7 +984,7 @@ static void le_set_scan_enable(struct net_buf *buf, struct net_buf **evt)
 	/* initialize duplicate filtering */
 	if (cmd->enable && cmd->filter_dup) {
 		dup_count = 0;
-		dup_curr = 0;
+		dup_used = 0;
 	} else {
 		dup_count = -1;
 	}
@@ -1780,6 +1796,10 @@ static void vs_read_supported_commands(struct net_buf *buf,
 	rp->commands[0] |= BIT(5) | BIT(7);
 	/* Read Static Addresses, Read Key Hierarchy Roots */
 	rp->commands[1] |= BIT(0) | BIT(1);
+#if CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0
+	/* Set Scan Pattern */
+	rp->commands[1] |= BIT(5);
+#endif /* CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0 */
 #endif /* CONFIG_BT_HCI_VS_EXT */
 }
 
@@ -1915,6 +1935,45 @@ static void vs_read_key_hierarchy_roots(struct net_buf *buf,
 #endif /* CONFIG_SOC_FAMILY_NRF */
 }
 
+#if CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0
+static void vs_set_scan_pattern(struct net_buf *buf, struct net_buf **evt)
+{
+	struct bt_hci_cp_vs_set_scan_pattern *cmd = (void *)buf->data;
+	struct bt_hci_evt_cc_status *ccst;
+	struct scan_pattern *p;
+
+	ccst = cmd_complete(evt, sizeof(*ccst));
+
+	/* AD type 0x00 clears all patterns */
+	if (!cmd->ad_type) {
+		scan_pattern_count = 0;
+		ccst->status = 0x00;
+		return;
+	}
+
+	if ((cmd->len > BT_HCI_VS_SCAN_PATTERN_LEN_MAX) ||
+	    (buf->len < sizeof(*cmd) + cmd->len)) {
+		ccst->status = BT_HCI_ERR_INVALID_PARAM;
+		return;
+	}
+
+	if (scan_pattern_count == CONFIG_BT_CTLR_SCAN_PATTERN_COUNT) {
+		ccst->status = BT_HCI_ERR_MEM_CAPACITY_EXCEEDED;
+		return;
+	}
+
+	p = &scan_pattern[scan_pattern_count];
+	p->ad_type = cmd->ad_type;
+	p->len = cmd->len;
+	memcpy(p->data, cmd->data, cmd->len);
+
+	/* publish the pattern only once it is complete */
+	scan_pattern_count++;
+
+	ccst->status = 0x00;
+}
+#endif /* CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0 */
+
 #endif /* CONFIG_BT_HCI_VS_EXT */
 
 static int vendor_cmd_handle(u16_t ocf, struct net_buf *cmd,
@@ -1949,6 +2008,12 @@ static int vendor_cmd_handle(u16_t ocf, struct net_buf *cmd,
 	case BT_OCF(BT_HCI_OP_VS_READ_KEY_HIERARCHY_ROOTS):
 		vs_read_key_hierarchy_roots(cmd, evt);
 		break;
+
+#if CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0
+	case BT_OCF(BT_HCI_OP_VS_SET_SCAN_PATTERN):
+		vs_set_scan_pattern(cmd, evt);
+		break;
+#endif /* CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0 */
 #endif /* CONFIG_BT_HCI_VS_EXT */
 
 	default:
@@ -2087,50 +2152,139 @@ int hci_acl_handle(struct net_buf *buf, struct net_buf **evt)
 }
 
 #if CONFIG_BT_CTLR_DUP_FILTER_LEN > 0
+#if defined(CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA)
+static u16_t dup_hash(const u8_t *data, u8_t len)
+{
+	u32_t hash = 2166136261U;
+
+	/* FNV-1a, folded to 16 bits */
+	while (len--) {
+		hash ^= *data++;
+		hash *= 16777619U;
+	}
+
+	return (hash >> 16) ^ (hash & 0xffff);
+}
+#endif /* CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA */
+
 static inline bool dup_found(struct pdu_adv *adv)
 {
+	struct dup *lru;
+#if defined(CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA)
+	u16_t hash = 0;
+#endif /* CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA */
+	int i;
+
 	/* check for duplicate filtering */
-	if (dup_count >= 0) {
-		int i;
-
-		for (i = 0; i < dup_count; i++) {
-			if (!memcmp(&adv->adv_ind.addr[0],
-				    &dup_filter[i].addr.a.val[0],
-				    sizeof(bt_addr_t)) &&
-			    adv->tx_addr == dup_filter[i].addr.type) {
-
-				if (dup_filter[i].mask & BIT(adv->type)) {
-					/* duplicate found */
-					return true;
-				}
-				/* report different adv types */
-				dup_filter[i].mask |= BIT(adv->type);
-				return false;
+	if (dup_count < 0) {
+		return false;
+	}
+
+#if defined(CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA)
+	if (!(adv->type & 0x01)) {
+		hash = dup_hash(&adv->adv_ind.data[0], adv->len - BDADDR_SIZE);
+	}
+#endif /* CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA */
+
+	dup_used++;
+
+	lru = &dup_filter[0];
+	for (i = 0; i < dup_count; i++) {
+		struct dup *dup = &dup_filter[i];
+
+		if (memcmp(&adv->adv_ind.addr[0], &dup->addr.a.val[0],
+			   sizeof(bt_addr_t)) ||
+		    adv->tx_addr != dup->addr.type) {
+			/* track the least recently used entry */
+			if ((s32_t)(dup->used - lru->used) < 0) {
+				lru = dup;
 			}
+
+			continue;
 		}
 
-		/* insert into the duplicate filter */
-		memcpy(&dup_filter[dup_curr].addr.a.val[0],
-		       &adv->adv_ind.addr[0], sizeof(bt_addr_t));
-		dup_filter[dup_curr].addr.type = adv->tx_addr;
-		dup_filter[dup_curr].mask = BIT(adv->type);
+		dup->used = dup_used;
 
-		if (dup_count < CONFIG_BT_CTLR_DUP_FILTER_LEN) {
-			dup_count++;
-			dup_curr = dup_count;
-		} else {
-			dup_curr++;
+		if (!(dup->mask & BIT(adv->type))) {
+			/* report different adv types */
+			dup->mask |= BIT(adv->type);
+#if defined(CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA)
+			dup->hash[adv->type >> 1] = hash;
+#endif /* CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA */
+			return false;
 		}
 
-		if (dup_curr == CONFIG_BT_CTLR_DUP_FILTER_LEN) {
-			dup_curr = 0;
+#if defined(CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA)
+		/* report changed adv data */
+		if (!(adv->type & 0x01) && (dup->hash[adv->type >> 1] != hash)) {
+			dup->hash[adv->type >> 1] = hash;
+			return false;
 		}
+#endif /* CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA */
+
+		/* duplicate found */
+		return true;
 	}
 
+	/* insert into the duplicate filter, replacing the least recently
+	 * used entry when full
+	 */
+	if (dup_count < CONFIG_BT_CTLR_DUP_FILTER_LEN) {
+		lru = &dup_filter[dup_count++];
+	}
+
+	memcpy(&lru->addr.a.val[0], &adv->adv_ind.addr[0], sizeof(bt_addr_t));
+	lru->addr.type = adv->tx_addr;
+	lru->mask = BIT(adv->type);
+	lru->used = dup_used;
+#if defined(CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA)
+	lru->hash[adv->type >> 1] = hash;
+#endif /* CONFIG_BT_CTLR_DUP_FILTER_ADV_DATA */
+
 	return false;
 }
 #endif /* CONFIG_BT_CTLR_DUP_FILTER_LEN > 0 */
 
+#if CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0
+static bool scan_pattern_match(struct pdu_adv *adv)
+{
+	u8_t data_len;
+	u8_t *data;
+	u8_t i;
+
+	/* no patterns, report everything */
+	if (!scan_pattern_count) {
+		return true;
+	}
+
+	/* directed advertising carries no data, always report it */
+	if (adv->type == PDU_ADV_TYPE_DIRECT_IND) {
+		return true;
+	}
+
+	data = &adv->adv_ind.data[0];
+	data_len = adv->len - BDADDR_SIZE;
+
+	/* walk the AD structures: length, AD type, value */
+	while ((data_len >= 2) && data[0] && (data[0] < data_len)) {
+		for (i = 0; i < scan_pattern_count; i++) {
+			struct scan_pattern *p = &scan_pattern[i];
+
+			if ((data[1] == p->ad_type) &&
+			    ((data[0] - 1) >= p->len) &&
+			    !memcmp(&data[2], p->data, p->len)) {
+				return true;
+			}
+		}
+
+		data_len -= data[0] + 1;
+		data += data[0] + 1;
+	}
+
+	return false;
+}
+#endif /* CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0 */
+
 static void le_advertising_report(struct pdu_data *pdu_data, u8_t *b,
 				  struct net_buf *buf)
 {
@@ -2178,6 +2332,12 @@ static void le_advertising_report(struct pdu_data *pdu_data, u8_t *b,
 #endif /* CONFIG_BT_CTLR_EXT_SCAN_FP */
 
 
+#if CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0
+	if (!scan_pattern_match(adv)) {
+		return;
+	}
+#endif /* CONFIG_BT_CTLR_SCAN_PATTERN_COUNT > 0 */
+
 #if CONFIG_BT_CTLR_DUP_FILTER_LEN > 0
 	if (dup_found(adv)) {
 		return;
@@ -68,6 +68,7 @@ u32_t ll_feature_req_send(u16_t handle);
 u32_t ll_version_ind_send(u16_t handle);
 u32_t ll_terminate_ind_send(u16_t handle, u8_t reason);
 u32_t ll_rssi_get(u16_t handle, u8_t *rssi);
+u32_t ll_octets_get(u16_t handle, u32_t *tx, u32_t *rx);
 u32_t ll_tx_pwr_lvl_get(u16_t handle, u8_t type, s8_t *tx_pwr_lvl);
 void ll_tx_pwr_get(s8_t *min, s8_t *max);
 
@@ -52,6 +52,15 @@
 
 #define SILENT_CONNECTION	0
 
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+/* Keep the connection event open while tx announces more data, unless data
+ * tx is paused, in which case the MD bit only reflects queued packets.
+ */
+#define TX_MD_OPEN(conn, pdu) ((pdu)->md && !(conn)->pause_tx)
+#else /* !CONFIG_BT_CTLR_CONN_MD */
+#define TX_MD_OPEN(conn, pdu) 0
+#endif /* !CONFIG_BT_CTLR_CONN_MD */
+
 /* Macro to convert time in us to connection interval units */
 #define RADIO_CONN_EVENTS(x, y) ((u16_t)(((x) + (y) - 1) / (y)))
 
@@ -772,12 +781,19 @@ static inline void isr_radio_state_tx(void)
 #endif /* CONFIG_BT_CTLR_PROFILE_ISR */
 
 		/* Route the tx packet to respective connections */
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+		/* Stage all queued tx packets while the radio receives, so
+		 * that the next tx PDU and its MD bit are ready at T_IFS.
+		 */
+		packet_tx_enqueue(0xFF);
+#else /* !CONFIG_BT_CTLR_CONN_MD */
 		/* TODO: use timebox for tx enqueue (instead of 1 packet
 		 * that is routed, which may not be for the current connection)
 		 * try to route as much tx packet in queue into corresponding
 		 * connection's tx list.
 		 */
 		packet_tx_enqueue(1);
+#endif /* !CONFIG_BT_CTLR_CONN_MD */
 
 		break;
 
@@ -3360,6 +3376,12 @@ isr_rx_conn_pkt(struct radio_pdu_node_rx *node_rx,
 						isr_rx_conn_pkt_ack(pdu_data_tx,
 								    &node_tx);
 				}
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+				else {
+					_radio.conn_curr->octets_tx +=
+						pdu_data_tx_len;
+				}
+#endif /* CONFIG_BT_CTLR_CONN_MD */
 			}
 
 			_radio.conn_curr->packet_tx_head_offset += pdu_data_tx_len;
@@ -3444,6 +3466,10 @@ isr_rx_conn_pkt(struct radio_pdu_node_rx *node_rx,
 			case PDU_DATA_LLID_DATA_START:
 				/* enqueue data packet */
 				*rx_enqueue = 1;
+
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+				_radio.conn_curr->octets_rx += pdu_data_rx->len;
+#endif /* CONFIG_BT_CTLR_CONN_MD */
 				break;
 
 			case PDU_DATA_LLID_CTRL:
@@ -3593,7 +3619,8 @@ static inline void isr_rx_conn(u8_t crc_ok, u8_t trx_done,
 	pdu_data_rx = (void *)node_rx->pdu_data;
 	_radio.state = ((_radio.state == STATE_CLOSE) || (crc_close) ||
 			((crc_ok) && (pdu_data_rx->md == 0) &&
-			 (pdu_data_tx->len == 0)) ||
+			 (pdu_data_tx->len == 0) &&
+			 !TX_MD_OPEN(_radio.conn_curr, pdu_data_tx)) ||
 			_radio.conn_curr->llcp_terminate.reason_peer) ?
 			STATE_CLOSE : STATE_TX;
 
@@ -4026,6 +4053,14 @@ static inline void isr_close_conn(void)
 		return;
 	}
 
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+	/* Latch the data octets exchanged in this connection event */
+	_radio.conn_curr->octets_tx_event = _radio.conn_curr->octets_tx;
+	_radio.conn_curr->octets_rx_event = _radio.conn_curr->octets_rx;
+	_radio.conn_curr->octets_tx = 0;
+	_radio.conn_curr->octets_rx = 0;
+#endif /* CONFIG_BT_CTLR_CONN_MD */
+
 	ticks_drift_plus = 0;
 	ticks_drift_minus = 0;
 	latency_event = _radio.conn_curr->latency_event;
@@ -8517,6 +8552,19 @@ static void tx_packet_set(struct connection *conn, struct pdu_data *pdu_data_tx)
 	}
 }
 
+static inline u8_t tx_pending(struct connection *conn)
+{
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+	/* Look ahead into the common tx queue, its head packet may be for this
+	 * connection but not yet routed to it.
+	 */
+	return (_radio.packet_tx_first != _radio.packet_tx_last) &&
+	       (_radio.pkt_tx[_radio.packet_tx_first].handle == conn->handle);
+#else /* !CONFIG_BT_CTLR_CONN_MD */
+	return 0;
+#endif /* !CONFIG_BT_CTLR_CONN_MD */
+}
+
 static void prepare_pdu_data_tx(struct connection *conn,
 				struct pdu_data **pdu_data_tx)
 {
@@ -8614,7 +8662,7 @@ static void prepare_pdu_data_tx(struct connection *conn,
 			_pdu_data_tx->md = 1;
 		}
 
-		if (conn->pkt_tx_head->next) {
+		if (conn->pkt_tx_head->next || tx_pending(conn)) {
 			_pdu_data_tx->md = 1;
 		}
 
@@ -8807,7 +8855,7 @@ static struct pdu_data *empty_tx_enqueue(struct connection *conn)
 	pdu_data_tx = (void *)radio_pkt_empty_get();
 	pdu_data_tx->ll_id = PDU_DATA_LLID_DATA_CONTINUE;
 	pdu_data_tx->len = 0;
-	if (conn->pkt_tx_head) {
+	if (conn->pkt_tx_head || tx_pending(conn)) {
 		pdu_data_tx->md = 1;
 	} else {
 		pdu_data_tx->md = 0;
@@ -10070,6 +10118,13 @@ u32_t radio_adv_enable(u16_t interval, u8_t chan_map, u8_t filter_policy,
 		conn->rssi_sample_count = 0;
 #endif /* CONFIG_BT_CTLR_CONN_RSSI */
 
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+		conn->octets_tx = 0;
+		conn->octets_rx = 0;
+		conn->octets_tx_event = 0;
+		conn->octets_rx_event = 0;
+#endif /* CONFIG_BT_CTLR_CONN_MD */
+
 		_radio.advertiser.conn = conn;
 	} else {
 		conn = NULL;
@@ -10549,6 +10604,13 @@ u32_t radio_connect_enable(u8_t adv_addr_type, u8_t *adv_addr, u16_t interval,
 	conn->rssi_sample_count = 0;
 #endif /* CONFIG_BT_CTLR_CONN_RSSI */
 
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+	conn->octets_tx = 0;
+	conn->octets_rx = 0;
+	conn->octets_tx_event = 0;
+	conn->octets_rx_event = 0;
+#endif /* CONFIG_BT_CTLR_CONN_MD */
+
 	_radio.scanner.conn = conn;
 
 	return 0;
@@ -10904,6 +10966,23 @@ u32_t ll_rssi_get(u16_t handle, u8_t *rssi)
 }
 #endif /* CONFIG_BT_CTLR_CONN_RSSI */
 
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+u32_t ll_octets_get(u16_t handle, u32_t *tx, u32_t *rx)
+{
+	struct connection *conn;
+
+	conn = connection_get(handle);
+	if (!conn) {
+		return 1;
+	}
+
+	*tx = conn->octets_tx_event;
+	*rx = conn->octets_rx_event;
+
+	return 0;
+}
+#endif /* CONFIG_BT_CTLR_CONN_MD */
+
 #if defined(CONFIG_BT_CTLR_LE_PING)
 u32_t ll_apto_get(u16_t handle, u16_t *apto)
 {
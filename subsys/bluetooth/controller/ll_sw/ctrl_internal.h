@@ -286,6 +286,13 @@ struct connection {
 	u8_t  rssi_reported;
 	u8_t  rssi_sample_count;
 #endif /* CONFIG_BT_CTLR_CONN_RSSI */
+
+#if defined(CONFIG_BT_CTLR_CONN_MD)
+	u32_t octets_tx;
+	u32_t octets_rx;
+	u32_t octets_tx_event;
+	u32_t octets_rx_event;
+#endif /* CONFIG_BT_CTLR_CONN_MD */
 };
 #define CONNECTION_T_SIZE MROUND(sizeof(struct connection))
 
@@ -100,6 +100,19 @@ struct ticker_user {
 	struct ticker_user_op *user_op;
 };
 
+/* Position reached by a ticker_enqueue() walk that stopped on a
+ * collision. A retry with a later expiry resumes from here instead of
+ * walking the list again from its head, as long as the list is not
+ * modified in between.
+ */
+struct ticker_enqueue_pos {
+	u32_t ticks_walked;
+	u32_t ticks_slot_previous;
+	u8_t  ticker_id_slot_previous;
+	u8_t  previous;
+	u8_t  current;
+};
+
 struct ticker_instance {
 	struct ticker_node *node;
 	struct ticker_user *user;
@@ -190,7 +203,18 @@ static void ticker_by_next_slot_get(struct ticker_instance *instance,
 	*ticks_to_expire = _ticks_to_expire;
 }
 
-static u8_t ticker_enqueue(struct ticker_instance *instance, u8_t id)
+static void ticker_enqueue_pos_reset(struct ticker_instance *instance,
+				     struct ticker_enqueue_pos *pos)
+{
+	pos->ticks_walked = 0;
+	pos->ticks_slot_previous = instance->ticks_slot_previous;
+	pos->ticker_id_slot_previous = TICKER_NULL;
+	pos->previous = instance->ticker_id_head;
+	pos->current = instance->ticker_id_head;
+}
+
+static u8_t ticker_enqueue(struct ticker_instance *instance, u8_t id,
+			   struct ticker_enqueue_pos *pos)
 {
 	struct ticker_node *ticker_current;
 	struct ticker_node *ticker_new;
@@ -205,12 +229,19 @@ static u8_t ticker_enqueue(struct ticker_instance *instance, u8_t id)
 
 	node = &instance->node[0];
 	ticker_new = &node[id];
-	ticks_to_expire = ticker_new->ticks_to_expire;
 
-	collide = ticker_id_slot_previous = TICKER_NULL;
-	current = instance->ticker_id_head;
-	previous = current;
-	ticks_slot_previous = instance->ticks_slot_previous;
+	/* Walk again from the head unless the expiry is still past the
+	 * tickers walked by the previous attempt.
+	 */
+	if (ticker_new->ticks_to_expire <= pos->ticks_walked) {
+		ticker_enqueue_pos_reset(instance, pos);
+	}
+
+	ticks_to_expire = ticker_new->ticks_to_expire - pos->ticks_walked;
+	ticker_id_slot_previous = pos->ticker_id_slot_previous;
+	ticks_slot_previous = pos->ticks_slot_previous;
+	previous = pos->previous;
+	current = pos->current;
 	while ((current != TICKER_NULL) &&
 	       (ticks_to_expire >
 		(ticks_to_expire_current =
@@ -250,6 +281,13 @@ static u8_t ticker_enqueue(struct ticker_instance *instance, u8_t id)
 			node[current].ticks_to_expire -= ticks_to_expire;
 		}
 	} else {
+		pos->ticks_walked = ticker_new->ticks_to_expire -
+				    ticks_to_expire;
+		pos->ticks_slot_previous = ticks_slot_previous;
+		pos->ticker_id_slot_previous = ticker_id_slot_previous;
+		pos->previous = previous;
+		pos->current = current;
+
 		if (ticks_slot_previous > ticks_to_expire) {
 			id = ticker_id_slot_previous;
 		} else {
@@ -777,11 +815,13 @@ static inline u32_t ticker_job_insert(struct ticker_instance *instance,
 				      u8_t *insert_head)
 {
 	struct ticker_node *node = &instance->node[0];
+	struct ticker_enqueue_pos pos;
 	u8_t id_collide;
 	u16_t skip;
 
 	/* Prepare to insert */
 	ticker->next = TICKER_NULL;
+	ticker_enqueue_pos_reset(instance, &pos);
 
 	/* No. of times ticker has skipped its interval */
 	if (ticker->lazy_current > ticker->lazy_periodic) {
@@ -793,7 +833,7 @@ static inline u32_t ticker_job_insert(struct ticker_instance *instance,
 
 	/* If insert collides, remove colliding or advance to next interval */
 	while (id_insert !=
-	       (id_collide = ticker_enqueue(instance, id_insert))) {
+	       (id_collide = ticker_enqueue(instance, id_insert, &pos))) {
 		/* check for collision */
 		if (id_collide != TICKER_NULL) {
 			struct ticker_node *ticker_collide = &node[id_collide];
@@ -826,6 +866,9 @@ static inline u32_t ticker_job_insert(struct ticker_instance *instance,
 				ticker_collide->next = *insert_head;
 				*insert_head = id_collide;
 
+				/* list changed, walk it again from the head */
+				ticker_enqueue_pos_reset(instance, &pos);
+
 				continue;
 			}
 		}
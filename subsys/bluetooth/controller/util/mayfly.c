@@ -6,19 +6,65 @@
  */
 
 #include <zephyr/types.h>
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+#include <string.h>
+#include <kernel.h>
+#endif
 #include "memq.h"
 #include "mayfly.h"
 
+/* Each caller and callee pair has one queue per priority class. A queue
+ * has a single producer (the caller) and a single consumer (the callee),
+ * so memq needs no locking, even when they run on different cores.
+ */
 static struct {
-	memq_link_t *head;
-	memq_link_t *tail;
+	struct {
+		memq_link_t *head;
+		memq_link_t *tail;
+	} q[MAYFLY_PRIO_COUNT];
 	u8_t        enable_req;
 	u8_t        enable_ack;
 	u8_t        disable_req;
 	u8_t        disable_ack;
 } mft[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT];
 
-static memq_link_t mfl[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT];
+static memq_link_t mfl[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT]
+		      [MAYFLY_PRIO_COUNT];
+
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+static struct mayfly_stats mfs[MAYFLY_CALLEE_COUNT][MAYFLY_CALLER_COUNT];
+#endif
+
+static inline u8_t mayfly_prio(struct mayfly *m)
+{
+#if defined(CONFIG_BT_CTLR_MAYFLY_PRIO)
+	return m->prio;
+#else
+	return 0;
+#endif
+}
+
+static inline void mayfly_stamp(struct mayfly *m)
+{
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+	m->_enqueued = k_cycle_get_32();
+#endif
+}
+
+static inline void mayfly_account(u8_t caller_id, u8_t callee_id,
+				  struct mayfly *m)
+{
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+	struct mayfly_stats *stats = &mfs[callee_id][caller_id];
+	u32_t cycles = k_cycle_get_32() - m->_enqueued;
+
+	stats->count++;
+	stats->cycles_total += cycles;
+	if (cycles > stats->cycles_max) {
+		stats->cycles_max = cycles;
+	}
+#endif
+}
 
 void mayfly_init(void)
 {
@@ -30,9 +76,17 @@ void mayfly_init(void)
 
 		caller_id = MAYFLY_CALLER_COUNT;
 		while (caller_id--) {
-			memq_init(&mfl[callee_id][caller_id],
-				  &mft[callee_id][caller_id].head,
-				  &mft[callee_id][caller_id].tail);
+			u8_t prio;
+
+			prio = MAYFLY_PRIO_COUNT;
+			while (prio--) {
+				memq_link_t **head, **tail;
+
+				head = &mft[callee_id][caller_id].q[prio].head;
+				tail = &mft[callee_id][caller_id].q[prio].tail;
+				memq_init(&mfl[callee_id][caller_id][prio],
+					  head, tail);
+			}
 		}
 	}
 }
@@ -76,6 +130,7 @@ u32_t mayfly_enqueue(u8_t caller_id, u8_t callee_id, u8_t chain,
 		if (chain) {
 			if (state != 1) {
 				/* mark as ready in queue */
+				mayfly_stamp(m);
 				m->_req = ack + 1;
 
 				/* pend the callee for execution */
@@ -101,8 +156,10 @@ u32_t mayfly_enqueue(u8_t caller_id, u8_t callee_id, u8_t chain,
 	}
 
 	/* new, add as ready in the queue */
+	mayfly_stamp(m);
 	m->_req = ack + 1;
-	memq_enqueue(m->_link, m, &mft[callee_id][caller_id].tail);
+	memq_enqueue(m->_link, m,
+		     &mft[callee_id][caller_id].q[mayfly_prio(m)].tail);
 
 	/* pend the callee for execution */
 	mayfly_pend(caller_id, callee_id);
@@ -115,67 +172,80 @@ void mayfly_run(u8_t callee_id)
 	u8_t disable = 0;
 	u8_t enable = 0;
 	u8_t caller_id;
+	u8_t prio;
 
-	/* iterate through each caller queue to this callee_id */
-	caller_id = MAYFLY_CALLER_COUNT;
-	while (caller_id--) {
-		memq_link_t *link;
-		struct mayfly *m = 0;
-
-		/* fetch mayfly in callee queue, if any */
-		link = memq_peek(mft[callee_id][caller_id].head,
-				 mft[callee_id][caller_id].tail,
-				 (void **)&m);
-		while (link) {
-			u8_t state;
-			u8_t req;
-
-			/* execute work if ready */
-			req = m->_req;
-			state = (req - m->_ack) & 0x03;
-			if (state == 1) {
-				/* mark mayfly as ran */
-				m->_ack--;
-
-				/* call the mayfly function */
-				m->fp(m->param);
-			}
+	/* iterate through each priority class, then through each caller
+	 * queue to this callee_id
+	 */
+	prio = MAYFLY_PRIO_COUNT;
+	while (prio--) {
+		caller_id = MAYFLY_CALLER_COUNT;
+		while (caller_id--) {
+			memq_link_t **head, **tail;
+			memq_link_t *link;
+			struct mayfly *m = 0;
+
+			head = &mft[callee_id][caller_id].q[prio].head;
+			tail = &mft[callee_id][caller_id].q[prio].tail;
+
+			/* fetch mayfly in callee queue, if any */
+			link = memq_peek(*head, *tail, (void **)&m);
+			while (link) {
+				u8_t state;
+				u8_t req;
+
+				/* execute work if ready */
+				req = m->_req;
+				state = (req - m->_ack) & 0x03;
+				if (state == 1) {
+					/* mark mayfly as ran */
+					m->_ack--;
+
+					mayfly_account(caller_id, callee_id,
+						       m);
+
+					/* call the mayfly function */
+					m->fp(m->param);
+				}
 
-			/* dequeue if not re-pended */
-			req = m->_req;
-			if (((req - m->_ack) & 0x03) != 1) {
-				memq_dequeue(mft[callee_id][caller_id].tail,
-					     &mft[callee_id][caller_id].head,
-					     0);
+				/* dequeue if not re-pended */
+				req = m->_req;
+				if (((req - m->_ack) & 0x03) != 1) {
+					memq_dequeue(*tail, head, 0);
 
-				/* release link into dequeued mayfly struct */
-				m->_link = link;
+					/* release link into dequeued mayfly
+					 * struct
+					 */
+					m->_link = link;
 
-				/* reset mayfly state to idle */
-				m->_ack = req;
-			}
+					/* reset mayfly state to idle */
+					m->_ack = req;
+				}
 
-			/* fetch next mayfly in callee queue, if any */
-			link = memq_peek(mft[callee_id][caller_id].head,
-					 mft[callee_id][caller_id].tail,
-					 (void **)&m);
-
-			/* yield out of mayfly_run if a mayfly function was
-			 * called.
-			 */
-			if (state == 1) {
-				/* pend callee (tailchain) if mayfly queue is
-				 * not empty or all caller queues are not
-				 * processed.
-				 */
-				if (caller_id || link) {
-					mayfly_pend(callee_id, callee_id);
+				/* fetch next mayfly in callee queue, if any */
+				link = memq_peek(*head, *tail, (void **)&m);
 
-					return;
+				/* yield out of mayfly_run if a mayfly function
+				 * was called.
+				 */
+				if (state == 1) {
+					/* pend callee (tailchain) if mayfly
+					 * queue is not empty or all caller
+					 * queues are not processed.
+					 */
+					if (prio || caller_id || link) {
+						mayfly_pend(callee_id,
+							    callee_id);
+
+						return;
+					}
 				}
 			}
 		}
+	}
 
+	caller_id = MAYFLY_CALLER_COUNT;
+	while (caller_id--) {
 		if (mft[callee_id][caller_id].disable_req !=
 		    mft[callee_id][caller_id].disable_ack) {
 			disable = 1;
@@ -197,3 +267,16 @@ void mayfly_run(u8_t callee_id)
 		mayfly_enable_cb(callee_id, callee_id, 0);
 	}
 }
+
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+void mayfly_stats_get(u8_t caller_id, u8_t callee_id,
+		      struct mayfly_stats *stats)
+{
+	*stats = mfs[callee_id][caller_id];
+}
+
+void mayfly_stats_reset(void)
+{
+	memset(mfs, 0, sizeof(mfs));
+}
+#endif /* CONFIG_BT_CTLR_MAYFLY_STATS */
@@ -12,14 +12,42 @@
 #define MAYFLY_CALLER_COUNT    4
 #define MAYFLY_CALLEE_COUNT    4
 
+#if defined(CONFIG_BT_CTLR_MAYFLY_PRIO)
+/* Priority classes within a callee, higher classes run first */
+#define MAYFLY_PRIO_NORMAL     0
+#define MAYFLY_PRIO_HIGH       1
+#define MAYFLY_PRIO_COUNT      2
+#else
+#define MAYFLY_PRIO_COUNT      1
+#endif
+
 struct mayfly {
 	u8_t volatile _req;
 	u8_t _ack;
 	memq_link_t *_link;
 	void *param;
 	void (*fp)(void *);
+#if defined(CONFIG_BT_CTLR_MAYFLY_PRIO)
+	u8_t prio;
+#endif
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+	u32_t _enqueued;
+#endif
+};
+
+#if defined(CONFIG_BT_CTLR_MAYFLY_STATS)
+/* Latency from enqueue to execution, in hardware cycles */
+struct mayfly_stats {
+	u32_t count;
+	u32_t cycles_max;
+	u64_t cycles_total;
 };
 
+void mayfly_stats_get(u8_t caller_id, u8_t callee_id,
+		      struct mayfly_stats *stats);
+void mayfly_stats_reset(void);
+#endif
+
 void mayfly_init(void);
 void mayfly_enable(u8_t caller_id, u8_t callee_id, u8_t enable);
 u32_t mayfly_enqueue(u8_t caller_id, u8_t callee_id, u8_t chain,
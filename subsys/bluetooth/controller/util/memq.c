@@ -10,6 +10,17 @@
 
 #include "memq.h"
 
+/* A memq has a single producer, which only moves the tail, and a single
+ * consumer, which only moves the head, so no lock is needed. The link
+ * contents must however be visible before the tail that publishes them,
+ * which on SMP needs a hardware barrier and otherwise only a compiler one.
+ */
+#if defined(CONFIG_SMP)
+#define memq_barrier() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+#define memq_barrier() __asm__ volatile ("" : : : "memory")
+#endif
+
 inline memq_link_t *memq_peek(memq_link_t *head, memq_link_t *tail, void **mem);
 
 memq_link_t *memq_init(memq_link_t *link, memq_link_t **head, memq_link_t **tail)
@@ -28,6 +39,9 @@ memq_link_t *memq_enqueue(memq_link_t *link, void *mem, memq_link_t **tail)
 	/* assign mem to current tail link's mem */
 	(*tail)->mem = mem;
 
+	/* publish the link before the tail moves */
+	memq_barrier();
+
 	/* increment the tail! */
 	*tail = link;
 
@@ -41,6 +55,9 @@ memq_link_t *memq_peek(memq_link_t *head, memq_link_t *tail, void **mem)
 		return NULL;
 	}
 
+	/* pairs with the barrier in memq_enqueue */
+	memq_barrier();
+
 	/* extract the link's mem */
 	if (mem) {
 		*mem = head->mem;
@@ -16,11 +16,13 @@
 #include <misc/util.h>
 #include <misc/printk.h>
 #include <assert.h>
+#include <random/rand32.h>
 
 #include <bluetooth/bluetooth.h>
 #include <bluetooth/l2cap.h>
 #include <bluetooth/avdtp.h>
 #include <bluetooth/a2dp.h>
+#include <bluetooth/a2dp-codec.h>
 
 #define BT_DBG_ENABLED IS_ENABLED(CONFIG_BT_DEBUG_A2DP)
 #include "common/log.h"
@@ -159,3 +161,332 @@ int bt_a2dp_register_endpoint(struct bt_a2dp_endpoint *endpoint,
 
 	return 0;
 }
+
+u16_t bt_a2dp_sbc_frame_samples(const struct bt_a2dp_codec_sbc_params *cfg)
+{
+	u8_t blocks, subbands;
+
+	switch (BT_A2DP_SBC_BLK_LEN(cfg)) {
+	case A2DP_SBC_BLK_LEN_4 >> 4:
+		blocks = 4;
+		break;
+	case A2DP_SBC_BLK_LEN_8 >> 4:
+		blocks = 8;
+		break;
+	case A2DP_SBC_BLK_LEN_12 >> 4:
+		blocks = 12;
+		break;
+	case A2DP_SBC_BLK_LEN_16 >> 4:
+		blocks = 16;
+		break;
+	default:
+		return 0;
+	}
+
+	switch (BT_A2DP_SBC_SUB_BAND(cfg)) {
+	case A2DP_SBC_SUBBAND_4 >> 2:
+		subbands = 4;
+		break;
+	case A2DP_SBC_SUBBAND_8 >> 2:
+		subbands = 8;
+		break;
+	default:
+		return 0;
+	}
+
+	return blocks * subbands;
+}
+
+u16_t bt_a2dp_sbc_frame_len(const struct bt_a2dp_codec_sbc_params *cfg,
+			    u8_t bitpool)
+{
+	u8_t subbands = (BT_A2DP_SBC_SUB_BAND(cfg) ==
+			 A2DP_SBC_SUBBAND_4 >> 2) ? 4 : 8;
+	u16_t samples = bt_a2dp_sbc_frame_samples(cfg);
+	u8_t blocks = samples / subbands;
+	u16_t len;
+
+	if (!samples) {
+		return 0;
+	}
+
+	/* Header, CRC and join octets, then the scale factors */
+	switch (BT_A2DP_SBC_CHAN_MODE(cfg)) {
+	case A2DP_SBC_CH_MODE_MONO:
+		len = 4 + (4 * subbands) / 8;
+		return len + (blocks * bitpool + 7) / 8;
+	case A2DP_SBC_CH_MODE_DUAL:
+		len = 4 + (4 * subbands * 2) / 8;
+		return len + (blocks * 2 * bitpool + 7) / 8;
+	case A2DP_SBC_CH_MODE_STREO:
+		len = 4 + (4 * subbands * 2) / 8;
+		return len + (blocks * bitpool + 7) / 8;
+	case A2DP_SBC_CH_MODE_JOINT:
+		len = 4 + (4 * subbands * 2) / 8;
+		return len + (subbands + blocks * bitpool + 7) / 8;
+	default:
+		return 0;
+	}
+}
+
+void bt_a2dp_media_tx_init(struct bt_a2dp_media_tx *tx,
+			   struct bt_l2cap_br_chan *chan,
+			   struct net_buf_pool *pool, u16_t frame_samples)
+{
+	memset(tx, 0, sizeof(*tx));
+
+	tx->chan = chan;
+	tx->pool = pool;
+	tx->frame_samples = frame_samples;
+
+	/* RFC 3550 wants random initial values */
+	tx->seq = sys_rand32_get();
+	tx->ts = sys_rand32_get();
+	tx->ssrc = sys_rand32_get();
+}
+
+int bt_a2dp_media_tx_flush(struct bt_a2dp_media_tx *tx)
+{
+	struct net_buf *buf = tx->buf;
+	struct bt_avdtp_media_hdr *hdr;
+	struct bt_a2dp_sbc_hdr *sbc;
+	u8_t frames = tx->frames;
+	int err;
+
+	if (!buf) {
+		return 0;
+	}
+
+	tx->buf = NULL;
+	tx->frames = 0;
+
+	sbc = net_buf_push(buf, sizeof(*sbc));
+	sbc->frames = frames;
+
+	hdr = net_buf_push(buf, sizeof(*hdr));
+	hdr->flags = BT_AVDTP_MEDIA_VERSION;
+	hdr->pt = BT_A2DP_MEDIA_PT;
+	hdr->seq = sys_cpu_to_be16(tx->seq);
+	hdr->ts = sys_cpu_to_be32(tx->ts);
+	hdr->ssrc = sys_cpu_to_be32(tx->ssrc);
+
+	/* The audio time passes even if the packet gets dropped */
+	tx->ts += frames * tx->frame_samples;
+
+	err = bt_l2cap_chan_send(&tx->chan->chan, buf);
+	if (err < 0) {
+		BT_WARN("Media packet dropped (err %d)", err);
+		net_buf_unref(buf);
+		return err;
+	}
+
+	tx->seq++;
+
+	return 0;
+}
+
+u8_t *bt_a2dp_media_tx_frame(struct bt_a2dp_media_tx *tx, u16_t len)
+{
+	u16_t max = tx->chan->tx.mtu - BT_A2DP_MEDIA_HDR_LEN;
+
+	if (tx->chan->tx.mtu < BT_A2DP_MEDIA_HDR_LEN || len > max) {
+		BT_ERR("SBC frame of %u octets exceeds the MTU", len);
+		return NULL;
+	}
+
+	if (tx->buf && (tx->frames == BT_A2DP_SBC_MAX_FRAMES ||
+			tx->buf->len + len > max ||
+			net_buf_tailroom(tx->buf) < len)) {
+		if (bt_a2dp_media_tx_flush(tx) < 0) {
+			return NULL;
+		}
+	}
+
+	if (!tx->buf) {
+		tx->buf = net_buf_alloc(tx->pool, K_NO_WAIT);
+		if (!tx->buf) {
+			BT_WARN("No media buffer available");
+			return NULL;
+		}
+
+		net_buf_reserve(tx->buf, BT_A2DP_MEDIA_RESERVE);
+
+		if (net_buf_tailroom(tx->buf) < len) {
+			BT_ERR("Media buffers too small for the SBC frames");
+			net_buf_unref(tx->buf);
+			tx->buf = NULL;
+			return NULL;
+		}
+	}
+
+	tx->frames++;
+
+	return net_buf_add(tx->buf, len);
+}
+
+static u16_t media_seq(struct net_buf *buf)
+{
+	struct bt_avdtp_media_hdr *hdr = (void *)buf->data;
+
+	return sys_be16_to_cpu(hdr->seq);
+}
+
+static u32_t media_ts(struct net_buf *buf)
+{
+	struct bt_avdtp_media_hdr *hdr = (void *)buf->data;
+
+	return sys_be32_to_cpu(hdr->ts);
+}
+
+static u8_t media_frames(struct net_buf *buf)
+{
+	struct bt_a2dp_sbc_hdr *sbc;
+
+	sbc = (void *)(buf->data + sizeof(struct bt_avdtp_media_hdr));
+
+	return sbc->frames & BT_A2DP_SBC_FRAMES_MASK;
+}
+
+static void media_rx_drop(struct bt_a2dp_media_rx *rx, u8_t i)
+{
+	net_buf_unref(rx->bufs[i]);
+
+	rx->count--;
+	memmove(&rx->bufs[i], &rx->bufs[i + 1],
+		(rx->count - i) * sizeof(rx->bufs[0]));
+}
+
+void bt_a2dp_media_rx_init(struct bt_a2dp_media_rx *rx,
+			   struct net_buf_pool *pool, u16_t frame_samples,
+			   u32_t target)
+{
+	memset(rx, 0, sizeof(*rx));
+
+	rx->pool = pool;
+	rx->frame_samples = frame_samples;
+	rx->target = target;
+}
+
+void bt_a2dp_media_rx_reset(struct bt_a2dp_media_rx *rx)
+{
+	while (rx->count) {
+		media_rx_drop(rx, rx->count - 1);
+	}
+
+	rx->playing = false;
+	rx->synced = false;
+}
+
+int bt_a2dp_media_rx_recv(struct bt_a2dp_media_rx *rx, struct net_buf *buf)
+{
+	struct bt_avdtp_media_hdr *hdr = (void *)buf->data;
+	struct bt_a2dp_sbc_hdr *sbc;
+	struct net_buf *media;
+	u16_t seq;
+	u8_t i;
+
+	if (buf->len <= BT_A2DP_MEDIA_HDR_LEN ||
+	    (hdr->flags & BT_AVDTP_MEDIA_VER_MASK) != BT_AVDTP_MEDIA_VERSION) {
+		BT_WARN("Invalid media packet");
+		return -EINVAL;
+	}
+
+	sbc = (void *)(buf->data + sizeof(*hdr));
+	if ((sbc->frames & BT_A2DP_SBC_FRAGMENTED) ||
+	    !(sbc->frames & BT_A2DP_SBC_FRAMES_MASK)) {
+		BT_WARN("Unsupported SBC payload 0x%02x", sbc->frames);
+		return -ENOTSUP;
+	}
+
+	seq = sys_be16_to_cpu(hdr->seq);
+
+	/* Too late, the packet's slot has been played already */
+	if (rx->synced && (s16_t)(seq - rx->next_seq) < 0) {
+		return -EALREADY;
+	}
+
+	/* Find the insertion point, newest packets being the most likely */
+	for (i = rx->count; i > 0; i--) {
+		s16_t diff = seq - media_seq(rx->bufs[i - 1]);
+
+		if (!diff) {
+			return -EALREADY;
+		}
+
+		if (diff > 0) {
+			break;
+		}
+	}
+
+	if (rx->count == ARRAY_SIZE(rx->bufs)) {
+		/* Keep the newest packets, latency has to stay bounded */
+		if (!i) {
+			return -ENOBUFS;
+		}
+
+		BT_WARN("Jitter buffer overflow, dropping seq %u",
+			media_seq(rx->bufs[0]));
+		rx->next_seq = media_seq(rx->bufs[0]) + 1;
+		media_rx_drop(rx, 0);
+		i--;
+	}
+
+	media = net_buf_alloc(rx->pool, K_NO_WAIT);
+	if (!media) {
+		BT_WARN("No media buffer available");
+		return -ENOMEM;
+	}
+
+	if (net_buf_tailroom(media) < buf->len) {
+		BT_ERR("Media buffers too small for a %u octet packet",
+		       buf->len);
+		net_buf_unref(media);
+		return -EMSGSIZE;
+	}
+
+	net_buf_add_mem(media, buf->data, buf->len);
+
+	memmove(&rx->bufs[i + 1], &rx->bufs[i],
+		(rx->count - i) * sizeof(rx->bufs[0]));
+	rx->bufs[i] = media;
+	rx->count++;
+
+	return 0;
+}
+
+struct net_buf *bt_a2dp_media_rx_get(struct bt_a2dp_media_rx *rx,
+				     u32_t *ts, u8_t *frames)
+{
+	struct net_buf *buf;
+
+	if (!rx->count) {
+		rx->playing = false;
+		return NULL;
+	}
+
+	if (!rx->playing) {
+		struct net_buf *last = rx->bufs[rx->count - 1];
+		u32_t span;
+
+		span = media_ts(last) - media_ts(rx->bufs[0]) +
+		       media_frames(last) * rx->frame_samples;
+		if (span < rx->target) {
+			return NULL;
+		}
+
+		rx->playing = true;
+	}
+
+	buf = rx->bufs[0];
+	rx->count--;
+	memmove(&rx->bufs[0], &rx->bufs[1], rx->count * sizeof(rx->bufs[0]));
+
+	rx->synced = true;
+	rx->next_seq = media_seq(buf) + 1;
+	*ts = media_ts(buf);
+	*frames = media_frames(buf);
+
+	net_buf_pull(buf, BT_A2DP_MEDIA_HDR_LEN);
+
+	return buf;
+}
@@ -10,3 +10,19 @@
 
 /* To be called when first SEP is being registered */
 int bt_a2dp_init(void);
+
+/* SBC media payload header, following the AVDTP media header. Several
+ * whole SBC frames share one media packet, up to BT_A2DP_SBC_MAX_FRAMES.
+ */
+#define BT_A2DP_SBC_FRAGMENTED   BIT(7)
+#define BT_A2DP_SBC_START        BIT(6)
+#define BT_A2DP_SBC_LAST         BIT(5)
+#define BT_A2DP_SBC_FRAMES_MASK  0x0f
+#define BT_A2DP_SBC_MAX_FRAMES   BT_A2DP_SBC_FRAMES_MASK
+
+struct bt_a2dp_sbc_hdr {
+	u8_t frames;
+} __packed;
+
+/* Dynamic RTP payload type used for A2DP media */
+#define BT_A2DP_MEDIA_PT         96
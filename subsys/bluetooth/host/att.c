@@ -809,7 +809,8 @@ static u8_t att_read_type_rsp(struct bt_att *att, struct bt_uuid *uuid,
 	/* Pre-set error if no attr will be found in handle */
 	data.err = BT_ATT_ERR_ATTRIBUTE_NOT_FOUND;
 
-	bt_gatt_foreach_attr(start_handle, end_handle, read_type_cb, &data);
+	bt_gatt_foreach_attr_type(start_handle, end_handle, uuid, read_type_cb,
+				  &data);
 
 	if (data.err) {
 		net_buf_unref(data.buf);
@@ -87,6 +87,22 @@
 #define BT_AVDTP_MIN_SEID 0x01
 #define BT_AVDTP_MAX_SEID 0x3E
 
+/* Media packets on the transport channel carry an RTP header (RFC 3550)
+ * without CSRC list or extension, all fields big-endian.
+ */
+#define BT_AVDTP_MEDIA_VERSION   0x80 /* RTP version 2 */
+#define BT_AVDTP_MEDIA_VER_MASK  0xc0
+#define BT_AVDTP_MEDIA_MARKER    0x80
+#define BT_AVDTP_MEDIA_PT_MASK   0x7f
+
+struct bt_avdtp_media_hdr {
+	u8_t  flags;
+	u8_t  pt;
+	u16_t seq;
+	u32_t ts;
+	u32_t ssrc;
+} __packed;
+
 struct bt_avdtp;
 struct bt_avdtp_req;
 
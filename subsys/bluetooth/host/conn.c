@@ -1157,11 +1157,18 @@ static bool send_frag(struct bt_conn *conn, struct net_buf *buf, u8_t flags,
 	struct bt_hci_acl_hdr *hdr;
 	bt_conn_tx_cb_t cb;
 	sys_snode_t *node;
+	u16_t len;
 	int err;
 
 	BT_DBG("conn %p buf %p len %u flags 0x%02x", conn, buf, buf->len,
 	       flags);
 
+#if defined(CONFIG_BT_CONN_TX_STATS)
+	if (!k_sem_count_get(bt_conn_get_pkts(conn))) {
+		conn->tx_stats.stalls++;
+	}
+#endif
+
 	/* Wait until the controller can accept ACL packets */
 	k_sem_take(bt_conn_get_pkts(conn), K_FOREVER);
 
@@ -1173,9 +1180,11 @@ static bool send_frag(struct bt_conn *conn, struct net_buf *buf, u8_t flags,
 		goto fail;
 	}
 
+	len = buf->len;
+
 	hdr = net_buf_push(buf, sizeof(*hdr));
 	hdr->handle = sys_cpu_to_le16(bt_acl_handle_pack(conn->handle, flags));
-	hdr->len = sys_cpu_to_le16(buf->len - sizeof(*hdr));
+	hdr->len = sys_cpu_to_le16(len);
 
 	cb = conn_tx(buf)->cb;
 	bt_buf_set_type(buf, BT_BUF_ACL_OUT);
@@ -1189,6 +1198,13 @@ static bool send_frag(struct bt_conn *conn, struct net_buf *buf, u8_t flags,
 		goto fail;
 	}
 
+#if defined(CONFIG_BT_CONN_TX_STATS)
+	conn->tx_stats.pkts++;
+	conn->tx_stats.bytes += len;
+#else
+	ARG_UNUSED(len);
+#endif
+
 	return true;
 
 fail:
@@ -1302,6 +1318,7 @@ static void conn_cleanup(struct bt_conn *conn)
 
 int bt_conn_prepare_events(struct k_poll_event events[])
 {
+	static u8_t first;
 	int i, ev_count = 0;
 
 	BT_DBG("");
@@ -1310,8 +1327,13 @@ int bt_conn_prepare_events(struct k_poll_event events[])
 	k_poll_event_init(&events[ev_count++], K_POLL_TYPE_SIGNAL,
 			  K_POLL_MODE_NOTIFY_ONLY, &conn_change);
 
+	/* Events are processed in order, so rotate the first connection on
+	 * each round to share the controller buffers fairly.
+	 */
+	first = (first + 1) % ARRAY_SIZE(conns);
+
 	for (i = 0; i < ARRAY_SIZE(conns); i++) {
-		struct bt_conn *conn = &conns[i];
+		struct bt_conn *conn = &conns[(first + i) % ARRAY_SIZE(conns)];
 
 		if (!atomic_get(&conn->ref)) {
 			continue;
@@ -1345,9 +1367,19 @@ int bt_conn_prepare_events(struct k_poll_event events[])
 	return ev_count;
 }
 
+static bool tx_credits_available(struct bt_conn *conn, struct net_buf *buf)
+{
+	u16_t mtu = conn_mtu(conn);
+
+	/* Number of ACL fragments the buffer is going to be sent as */
+	return k_sem_count_get(bt_conn_get_pkts(conn)) >=
+	       (buf->len + mtu - 1) / mtu;
+}
+
 void bt_conn_process_tx(struct bt_conn *conn)
 {
 	struct net_buf *buf;
+	int quota;
 
 	BT_DBG("conn %p", conn);
 
@@ -1364,6 +1396,26 @@ void bt_conn_process_tx(struct bt_conn *conn)
 	if (!send_buf(conn, buf)) {
 		net_buf_unref(buf);
 	}
+
+	/* Keep feeding the controller while it has room for the whole next
+	 * packet so that several of them can go out in the same connection
+	 * event, up to a quota to leave room for the other connections.
+	 */
+	for (quota = CONFIG_BT_CONN_TX_BATCH - 1; quota; quota--) {
+		if (conn->state != BT_CONN_CONNECTED) {
+			break;
+		}
+
+		buf = k_fifo_peek_head(&conn->tx_queue);
+		if (!buf || !tx_credits_available(conn, buf)) {
+			break;
+		}
+
+		buf = net_buf_get(&conn->tx_queue, K_NO_WAIT);
+		if (!send_buf(conn, buf)) {
+			net_buf_unref(buf);
+		}
+	}
 }
 
 struct bt_conn *bt_conn_add_le(const bt_addr_le_t *peer)
@@ -1691,6 +1743,20 @@ int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
 	return -EINVAL;
 }
 
+#if defined(CONFIG_BT_CONN_TX_STATS)
+int bt_conn_get_tx_stats(const struct bt_conn *conn,
+			 struct bt_conn_tx_stats *stats)
+{
+	if (conn->state != BT_CONN_CONNECTED) {
+		return -ENOTCONN;
+	}
+
+	*stats = conn->tx_stats;
+
+	return 0;
+}
+#endif /* CONFIG_BT_CONN_TX_STATS */
+
 static int bt_hci_disconnect(struct bt_conn *conn, u8_t reason)
 {
 	struct net_buf *buf;
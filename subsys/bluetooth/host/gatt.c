@@ -51,6 +51,75 @@ static const u16_t gap_appearance = CONFIG_BT_DEVICE_APPEARANCE;
 
 static sys_slist_t db;
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+#define DB_UUID_BUCKETS 16
+
+/* Attributes indexed by handle - 1, plus per UUID hash bucket chains of
+ * handles kept in ascending order (0 terminates a chain).
+ */
+static struct bt_gatt_attr *db_attrs[CONFIG_BT_GATT_DB_INDEX_SIZE];
+static u16_t db_uuid_next[CONFIG_BT_GATT_DB_INDEX_SIZE];
+static u16_t db_uuid_head[DB_UUID_BUCKETS];
+static u16_t db_uuid_tail[DB_UUID_BUCKETS];
+
+static u8_t db_uuid_hash(const struct bt_uuid *uuid)
+{
+	u16_t val;
+
+	/* Only use the bits 16, 32 and 128 bit forms of a UUID have in
+	 * common so that UUIDs equal for bt_uuid_cmp() share a bucket.
+	 */
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		val = BT_UUID_16(uuid)->val;
+		break;
+	case BT_UUID_TYPE_32:
+		val = BT_UUID_32(uuid)->val;
+		break;
+	default:
+		val = sys_get_le16(&BT_UUID_128(uuid)->val[12]);
+		break;
+	}
+
+	return (val ^ (val >> 8)) % DB_UUID_BUCKETS;
+}
+
+static void db_index_add(struct bt_gatt_attr *attr)
+{
+	u8_t bucket = db_uuid_hash(attr->uuid);
+
+	db_attrs[attr->handle - 1] = attr;
+	db_uuid_next[attr->handle - 1] = 0;
+
+	/* Handles are allocated in ascending order so appending keeps the
+	 * chain sorted.
+	 */
+	if (db_uuid_tail[bucket]) {
+		db_uuid_next[db_uuid_tail[bucket] - 1] = attr->handle;
+	} else {
+		db_uuid_head[bucket] = attr->handle;
+	}
+
+	db_uuid_tail[bucket] = attr->handle;
+}
+
+static void db_index_rebuild(void)
+{
+	struct bt_gatt_service *svc;
+	u16_t i;
+
+	memset(db_attrs, 0, sizeof(db_attrs));
+	memset(db_uuid_head, 0, sizeof(db_uuid_head));
+	memset(db_uuid_tail, 0, sizeof(db_uuid_tail));
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&db, svc, node) {
+		for (i = 0; i < svc->attr_count; i++) {
+			db_index_add(&svc->attrs[i]);
+		}
+	}
+}
+#endif /* CONFIG_BT_GATT_DB_INDEX */
+
 static ssize_t read_name(struct bt_conn *conn, const struct bt_gatt_attr *attr,
 			 void *buf, u16_t len, u16_t offset)
 {
@@ -131,6 +200,18 @@ populate:
 		       attrs->perm);
 	}
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+	if (handle > CONFIG_BT_GATT_DB_INDEX_SIZE) {
+		BT_ERR("Handle 0x%04x does not fit in the index", handle);
+		return -ENOMEM;
+	}
+
+	for (attrs = svc->attrs, count = svc->attr_count; count;
+	     attrs++, count--) {
+		db_index_add(attrs);
+	}
+#endif /* CONFIG_BT_GATT_DB_INDEX */
+
 	sys_slist_append(&db, &svc->node);
 
 	return 0;
@@ -283,6 +364,10 @@ int bt_gatt_service_unregister(struct bt_gatt_service *svc)
 		return -ENOENT;
 	}
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+	db_index_rebuild();
+#endif
+
 	sc_indicate(&gatt_sc, svc->attrs[0].handle,
 		    svc->attrs[svc->attr_count - 1].handle);
 
@@ -424,6 +509,80 @@ ssize_t bt_gatt_attr_read_chrc(struct bt_conn *conn,
 	return bt_gatt_attr_read(conn, attr, buf, len, offset, &pdu, value_len);
 }
 
+#if defined(CONFIG_BT_GATT_DB_INDEX)
+void bt_gatt_foreach_attr(u16_t start_handle, u16_t end_handle,
+			  bt_gatt_attr_func_t func, void *user_data)
+{
+	u32_t handle;
+
+	for (handle = max(start_handle, 1);
+	     handle <= min(end_handle, CONFIG_BT_GATT_DB_INDEX_SIZE);
+	     handle++) {
+		struct bt_gatt_attr *attr = db_attrs[handle - 1];
+
+		if (!attr) {
+			continue;
+		}
+
+		if (func(attr, user_data) == BT_GATT_ITER_STOP) {
+			return;
+		}
+	}
+}
+
+void bt_gatt_foreach_attr_type(u16_t start_handle, u16_t end_handle,
+			       const struct bt_uuid *uuid,
+			       bt_gatt_attr_func_t func, void *user_data)
+{
+	u16_t handle;
+
+	handle = db_uuid_head[db_uuid_hash(uuid)];
+
+	for (; handle && handle <= end_handle;
+	     handle = db_uuid_next[handle - 1]) {
+		struct bt_gatt_attr *attr = db_attrs[handle - 1];
+
+		/* Skip attributes out of range or colliding in the hash */
+		if (handle < start_handle || bt_uuid_cmp(attr->uuid, uuid)) {
+			continue;
+		}
+
+		if (func(attr, user_data) == BT_GATT_ITER_STOP) {
+			return;
+		}
+	}
+}
+#else
+struct foreach_type_data {
+	const struct bt_uuid *uuid;
+	bt_gatt_attr_func_t func;
+	void *user_data;
+};
+
+static u8_t foreach_type_cb(const struct bt_gatt_attr *attr, void *user_data)
+{
+	struct foreach_type_data *data = user_data;
+
+	if (bt_uuid_cmp(attr->uuid, data->uuid)) {
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	return data->func(attr, data->user_data);
+}
+
+void bt_gatt_foreach_attr_type(u16_t start_handle, u16_t end_handle,
+			       const struct bt_uuid *uuid,
+			       bt_gatt_attr_func_t func, void *user_data)
+{
+	struct foreach_type_data data = {
+		.uuid = uuid,
+		.func = func,
+		.user_data = user_data,
+	};
+
+	bt_gatt_foreach_attr(start_handle, end_handle, foreach_type_cb, &data);
+}
+
 void bt_gatt_foreach_attr(u16_t start_handle, u16_t end_handle,
 			  bt_gatt_attr_func_t func, void *user_data)
 {
@@ -447,6 +606,7 @@ void bt_gatt_foreach_attr(u16_t start_handle, u16_t end_handle,
 		}
 	}
 }
+#endif /* CONFIG_BT_GATT_DB_INDEX */
 
 static u8_t find_next(const struct bt_gatt_attr *attr, void *user_data)
 {
@@ -991,6 +1151,8 @@ void bt_gatt_notification(struct bt_conn *conn, u16_t handle,
 
 	BT_DBG("handle 0x%04x length %u", handle, length);
 
+	bt_gatt_cache_notification(conn, handle);
+
 	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&subscriptions, params, tmp, node) {
 		if (bt_conn_addr_le_cmp(conn, &params->_peer) ||
 		    handle != params->value_handle) {
@@ -1085,6 +1247,32 @@ int bt_gatt_exchange_mtu(struct bt_conn *conn,
 	return gatt_send(conn, buf, gatt_mtu_rsp, params, NULL);
 }
 
+static int gatt_discover(struct bt_conn *conn,
+			 struct bt_gatt_discover_params *params);
+
+static u8_t discover_attr(struct bt_conn *conn, struct bt_gatt_attr *attr,
+			  struct bt_gatt_discover_params *params)
+{
+	bt_gatt_cache_attr(conn, params, attr);
+
+	if (params->func(conn, attr, params) == BT_GATT_ITER_CONTINUE) {
+		return BT_GATT_ITER_CONTINUE;
+	}
+
+	bt_gatt_cache_stop(conn, params, attr->handle);
+
+	return BT_GATT_ITER_STOP;
+}
+
+static void discover_complete(struct bt_conn *conn,
+			      struct bt_gatt_discover_params *params,
+			      bool complete)
+{
+	bt_gatt_cache_done(conn, params, complete);
+
+	params->func(conn, NULL, params);
+}
+
 static void gatt_discover_next(struct bt_conn *conn, u16_t last_handle,
 			       struct bt_gatt_discover_params *params)
 {
@@ -1100,17 +1288,17 @@ static void gatt_discover_next(struct bt_conn *conn, u16_t last_handle,
 
 	/* Stop if over the range or the requests */
 	if (params->start_handle >= params->end_handle) {
-		goto done;
+		discover_complete(conn, params, true);
+		return;
 	}
 
 discover:
 	/* Discover next range */
-	if (!bt_gatt_discover(conn, params)) {
+	if (!gatt_discover(conn, params)) {
 		return;
 	}
 
-done:
-	params->func(conn, NULL, params);
+	discover_complete(conn, params, false);
 }
 
 static void gatt_find_type_rsp(struct bt_conn *conn, u8_t err,
@@ -1125,7 +1313,9 @@ static void gatt_find_type_rsp(struct bt_conn *conn, u8_t err,
 	BT_DBG("err 0x%02x", err);
 
 	if (err) {
-		goto done;
+		discover_complete(conn, params,
+				  err == BT_ATT_ERR_ATTRIBUTE_NOT_FOUND);
+		return;
 	}
 
 	/* Parse attributes found */
@@ -1152,21 +1342,18 @@ static void gatt_find_type_rsp(struct bt_conn *conn, u8_t err,
 		attr.handle = start_handle;
 		attr.user_data = &value;
 
-		if (params->func(conn, &attr, params) == BT_GATT_ITER_STOP) {
+		if (discover_attr(conn, &attr, params) == BT_GATT_ITER_STOP) {
 			return;
 		}
 	}
 
 	/* Stop if could not parse the whole PDU */
 	if (length > 0) {
-		goto done;
+		discover_complete(conn, params, false);
+		return;
 	}
 
 	gatt_discover_next(conn, end_handle, params);
-
-	return;
-done:
-	params->func(conn, NULL, params);
 }
 
 static int gatt_find_type(struct bt_conn *conn,
@@ -1227,7 +1414,7 @@ static void read_included_uuid_cb(struct bt_conn *conn, u8_t err,
 
 	if (length != 16) {
 		BT_ERR("Invalid data len %u", length);
-		params->func(conn, NULL, params);
+		discover_complete(conn, params, false);
 		return;
 	}
 
@@ -1251,7 +1438,7 @@ static void read_included_uuid_cb(struct bt_conn *conn, u8_t err,
 		.user_data = &value, });
 	attr->handle = params->_included.attr_handle;
 
-	if (params->func(conn, attr, params) == BT_GATT_ITER_STOP) {
+	if (discover_attr(conn, attr, params) == BT_GATT_ITER_STOP) {
 		return;
 	}
 next:
@@ -1356,7 +1543,7 @@ static u16_t parse_include(struct bt_conn *conn, const void *pdu,
 			.user_data = &value, });
 		attr->handle = handle;
 
-		if (params->func(conn, attr, params) == BT_GATT_ITER_STOP) {
+		if (discover_attr(conn, attr, params) == BT_GATT_ITER_STOP) {
 			return 0;
 		}
 	}
@@ -1367,7 +1554,7 @@ static u16_t parse_include(struct bt_conn *conn, const void *pdu,
 	}
 
 done:
-	params->func(conn, NULL, params);
+	discover_complete(conn, params, false);
 	return 0;
 }
 
@@ -1436,7 +1623,7 @@ static u16_t parse_characteristic(struct bt_conn *conn, const void *pdu,
 							   chrc->properties));
 		attr->handle = handle;
 
-		if (params->func(conn, attr, params) == BT_GATT_ITER_STOP) {
+		if (discover_attr(conn, attr, params) == BT_GATT_ITER_STOP) {
 			return 0;
 		}
 	}
@@ -1447,7 +1634,7 @@ static u16_t parse_characteristic(struct bt_conn *conn, const void *pdu,
 	}
 
 done:
-	params->func(conn, NULL, params);
+	discover_complete(conn, params, false);
 	return 0;
 }
 
@@ -1461,7 +1648,8 @@ static void gatt_read_type_rsp(struct bt_conn *conn, u8_t err,
 	BT_DBG("err 0x%02x", err);
 
 	if (err) {
-		params->func(conn, NULL, params);
+		discover_complete(conn, params,
+				  err == BT_ATT_ERR_ATTRIBUTE_NOT_FOUND);
 		return;
 	}
 
@@ -1526,7 +1714,9 @@ static void gatt_find_info_rsp(struct bt_conn *conn, u8_t err,
 	BT_DBG("err 0x%02x", err);
 
 	if (err) {
-		goto done;
+		discover_complete(conn, params,
+				  err == BT_ATT_ERR_ATTRIBUTE_NOT_FOUND);
+		return;
 	}
 
 	/* Data can be either in UUID16 or UUID128 */
@@ -1572,7 +1762,7 @@ static void gatt_find_info_rsp(struct bt_conn *conn, u8_t err,
 			BT_GATT_DESCRIPTOR(&u.uuid, 0, NULL, NULL, NULL));
 		attr->handle = handle;
 
-		if (params->func(conn, attr, params) == BT_GATT_ITER_STOP) {
+		if (discover_attr(conn, attr, params) == BT_GATT_ITER_STOP) {
 			return;
 		}
 	}
@@ -1587,7 +1777,7 @@ static void gatt_find_info_rsp(struct bt_conn *conn, u8_t err,
 	return;
 
 done:
-	params->func(conn, NULL, params);
+	discover_complete(conn, params, false);
 }
 
 static int gatt_find_info(struct bt_conn *conn,
@@ -1611,9 +1801,30 @@ static int gatt_find_info(struct bt_conn *conn,
 	return gatt_send(conn, buf, gatt_find_info_rsp, params, NULL);
 }
 
+static int gatt_discover(struct bt_conn *conn,
+			 struct bt_gatt_discover_params *params)
+{
+	switch (params->type) {
+	case BT_GATT_DISCOVER_PRIMARY:
+	case BT_GATT_DISCOVER_SECONDARY:
+		return gatt_find_type(conn, params);
+	case BT_GATT_DISCOVER_INCLUDE:
+	case BT_GATT_DISCOVER_CHARACTERISTIC:
+		return gatt_read_type(conn, params);
+	case BT_GATT_DISCOVER_DESCRIPTOR:
+		return gatt_find_info(conn, params);
+	default:
+		BT_ERR("Invalid discovery type: %u", params->type);
+	}
+
+	return -EINVAL;
+}
+
 int bt_gatt_discover(struct bt_conn *conn,
 		     struct bt_gatt_discover_params *params)
 {
+	int err;
+
 	__ASSERT(conn, "invalid parameters\n");
 	__ASSERT(params && params->func, "invalid parameters\n");
 	__ASSERT((params->start_handle && params->end_handle),
@@ -1625,20 +1836,18 @@ int bt_gatt_discover(struct bt_conn *conn,
 		return -ENOTCONN;
 	}
 
-	switch (params->type) {
-	case BT_GATT_DISCOVER_PRIMARY:
-	case BT_GATT_DISCOVER_SECONDARY:
-		return gatt_find_type(conn, params);
-	case BT_GATT_DISCOVER_INCLUDE:
-	case BT_GATT_DISCOVER_CHARACTERISTIC:
-		return gatt_read_type(conn, params);
-	case BT_GATT_DISCOVER_DESCRIPTOR:
-		return gatt_find_info(conn, params);
-	default:
-		BT_ERR("Invalid discovery type: %u", params->type);
+	if (bt_gatt_cache_discover(conn, params)) {
+		return 0;
 	}
 
-	return -EINVAL;
+	bt_gatt_cache_start(conn, params);
+
+	err = gatt_discover(conn, params);
+	if (err) {
+		bt_gatt_cache_done(conn, params, false);
+	}
+
+	return err;
 }
 
 static void gatt_read_rsp(struct bt_conn *conn, u8_t err, const void *pdu,
@@ -2114,7 +2323,8 @@ static void add_subscriptions(struct bt_conn *conn)
 void bt_gatt_connected(struct bt_conn *conn)
 {
 	BT_DBG("conn %p", conn);
-	bt_gatt_foreach_attr(0x0001, 0xffff, connected_cb, conn);
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_CCC,
+				  connected_cb, conn);
 #if defined(CONFIG_BT_GATT_CLIENT)
 	add_subscriptions(conn);
 #endif /* CONFIG_BT_GATT_CLIENT */
@@ -2123,7 +2333,8 @@ void bt_gatt_connected(struct bt_conn *conn)
 void bt_gatt_disconnected(struct bt_conn *conn)
 {
 	BT_DBG("conn %p", conn);
-	bt_gatt_foreach_attr(0x0001, 0xffff, disconnected_cb, conn);
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_CCC,
+				  disconnected_cb, conn);
 
 	if (IS_ENABLED(CONFIG_BT_SETTINGS) &&
 	    bt_addr_le_is_bonded(&conn->le.dst)) {
@@ -2133,6 +2344,8 @@ void bt_gatt_disconnected(struct bt_conn *conn)
 #if defined(CONFIG_BT_GATT_CLIENT)
 	remove_subscriptions(conn);
 #endif /* CONFIG_BT_GATT_CLIENT */
+
+	bt_gatt_cache_disconnected(conn);
 }
 
 #if defined(CONFIG_BT_SETTINGS)
@@ -2199,7 +2412,8 @@ int bt_gatt_store_ccc(const bt_addr_le_t *addr)
 	save.addr = addr;
 	save.count = 0;
 
-	bt_gatt_foreach_attr(0x0001, 0xffff, ccc_save, &save);
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_CCC,
+				  ccc_save, &save);
 
 	str = settings_str_from_bytes(save.store,
 				      save.count * sizeof(*save.store),
@@ -2338,7 +2552,8 @@ static int ccc_set(int argc, char **argv, char *val)
 		load.count = len / sizeof(*ccc_store);
 	}
 
-	bt_gatt_foreach_attr(0x0001, 0xffff, ccc_load, &load);
+	bt_gatt_foreach_attr_type(0x0001, 0xffff, BT_UUID_GATT_CCC,
+				  ccc_load, &load);
 
 	BT_DBG("Restored CCC for %s", bt_addr_le_str(&load.addr));
 
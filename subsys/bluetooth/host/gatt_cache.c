@@ -0,0 +1,802 @@
+/* gatt_cache.c - Generic Attribute Profile client discovery cache */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <misc/byteorder.h>
+#include <misc/util.h>
+
+#include <settings/settings.h>
+
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/conn.h>
+#include <bluetooth/uuid.h>
+#include <bluetooth/gatt.h>
+
+#define BT_DBG_ENABLED IS_ENABLED(CONFIG_BT_DEBUG_GATT)
+#include "common/log.h"
+
+#include "hci_core.h"
+#include "conn_internal.h"
+#include "settings.h"
+#include "gatt_internal.h"
+
+/* Attribute reported by a cached discovery procedure */
+struct cache_attr {
+	u16_t handle;
+	/* Service end handle or included service handle range */
+	u16_t start_handle;
+	u16_t end_handle;
+	/* Characteristic properties */
+	u8_t properties;
+	u8_t uuid_type;
+	u8_t uuid[16];
+} __packed;
+
+/* The query was stopped by the application before reaching the end of
+ * the range, only a prefix of the results is known.
+ */
+#define CACHE_QUERY_PARTIAL	BIT(0)
+
+/* Discovery procedure whose results are cached */
+struct cache_query {
+	/* Start handle of the procedure, 0 if the entry is unused */
+	u16_t start_handle;
+	u16_t end_handle;
+	u8_t type;
+	u8_t flags;
+	/* UUID filter of the procedure, type 0 if none */
+	u8_t uuid_type;
+	u8_t uuid[16];
+	/* Attributes found, stored in attrs[first] to attrs[first + count] */
+	u8_t first;
+	u8_t count;
+} __packed;
+
+struct gatt_cache {
+	bt_addr_le_t addr;
+
+	/* Discovery procedure being recorded */
+	struct bt_gatt_discover_params *params;
+	struct cache_query pending;
+
+	/* Discovery requested while replaying another one */
+	struct bt_gatt_discover_params *next;
+	bool serving;
+
+	/* Queries already present in storage */
+	u32_t stored;
+
+	struct cache_query queries[CONFIG_BT_GATT_CACHE_QUERIES];
+	struct cache_attr attrs[CONFIG_BT_GATT_CACHE_ATTRS];
+};
+
+union cache_uuid {
+	struct bt_uuid uuid;
+	struct bt_uuid_16 u16;
+	struct bt_uuid_32 u32;
+	struct bt_uuid_128 u128;
+};
+
+static struct gatt_cache caches[CONFIG_BT_MAX_PAIRED];
+
+static struct gatt_cache *cache_find(const bt_addr_le_t *addr)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(caches); i++) {
+		if (!bt_addr_le_cmp(&caches[i].addr, addr)) {
+			return &caches[i];
+		}
+	}
+
+	return NULL;
+}
+
+static struct gatt_cache *cache_get(const bt_addr_le_t *addr)
+{
+	struct gatt_cache *cache;
+
+	cache = cache_find(addr);
+	if (cache) {
+		return cache;
+	}
+
+	cache = cache_find(BT_ADDR_LE_ANY);
+	if (cache) {
+		bt_addr_le_copy(&cache->addr, addr);
+	}
+
+	return cache;
+}
+
+static void uuid_store(u8_t *type, u8_t *val, const struct bt_uuid *uuid)
+{
+	*type = uuid->type;
+
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		sys_put_le16(BT_UUID_16(uuid)->val, val);
+		break;
+	case BT_UUID_TYPE_32:
+		sys_put_le32(BT_UUID_32(uuid)->val, val);
+		break;
+	case BT_UUID_TYPE_128:
+		memcpy(val, BT_UUID_128(uuid)->val, 16);
+		break;
+	}
+}
+
+static const struct bt_uuid *uuid_load(u8_t type, const u8_t *val,
+				       union cache_uuid *u)
+{
+	u->uuid.type = type;
+
+	switch (type) {
+	case BT_UUID_TYPE_16:
+		u->u16.val = sys_get_le16(val);
+		break;
+	case BT_UUID_TYPE_32:
+		u->u32.val = sys_get_le32(val);
+		break;
+	case BT_UUID_TYPE_128:
+		memcpy(u->u128.val, val, 16);
+		break;
+	default:
+		return NULL;
+	}
+
+	return &u->uuid;
+}
+
+static bool query_match(const struct cache_query *query,
+			const struct cache_query *key)
+{
+	if (query->start_handle != key->start_handle ||
+	    query->end_handle != key->end_handle ||
+	    query->type != key->type || query->uuid_type != key->uuid_type) {
+		return false;
+	}
+
+	if (!key->uuid_type) {
+		return true;
+	}
+
+	return !memcmp(query->uuid, key->uuid, sizeof(key->uuid));
+}
+
+static void query_init(struct cache_query *query,
+		       const struct bt_gatt_discover_params *params)
+{
+	memset(query, 0, sizeof(*query));
+
+	query->start_handle = params->start_handle;
+	query->end_handle = params->end_handle;
+	query->type = params->type;
+
+	if (params->uuid) {
+		uuid_store(&query->uuid_type, query->uuid, params->uuid);
+	}
+}
+
+static struct cache_query *
+query_find(struct gatt_cache *cache,
+	   const struct bt_gatt_discover_params *params)
+{
+	struct cache_query key;
+	int i;
+
+	query_init(&key, params);
+
+	for (i = 0; i < ARRAY_SIZE(cache->queries); i++) {
+		if (query_match(&cache->queries[i], &key)) {
+			return &cache->queries[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Number of attribute entries used by committed queries */
+static u8_t attrs_used(struct gatt_cache *cache)
+{
+	u8_t used = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache->queries); i++) {
+		struct cache_query *query = &cache->queries[i];
+
+		if (query->start_handle) {
+			used = max(used, query->first + query->count);
+		}
+	}
+
+	return used;
+}
+
+#if defined(CONFIG_BT_SETTINGS)
+static void cache_save(const bt_addr_le_t *addr, char type, u8_t idx,
+		       const void *data, size_t len)
+{
+	char val[BT_SETTINGS_SIZE(max(sizeof(struct cache_query),
+				      sizeof(struct cache_attr)))];
+	char key[BT_SETTINGS_KEY_MAX];
+	char name[4];
+	char *str = NULL;
+	int err;
+
+	snprintk(name, sizeof(name), "%c%x", type, idx);
+	bt_settings_encode_key(key, sizeof(key), "gcache",
+			       (bt_addr_le_t *)addr, name);
+
+	if (data) {
+		str = settings_str_from_bytes(data, len, val, sizeof(val));
+		if (!str) {
+			BT_ERR("Unable to encode %s", key);
+			return;
+		}
+	}
+
+	err = settings_save_one(key, str);
+	if (err) {
+		BT_ERR("Failed to store %s (err %d)", key, err);
+	}
+}
+
+static void cache_store(struct gatt_cache *cache)
+{
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(cache->queries); i++) {
+		struct cache_query *query = &cache->queries[i];
+
+		if (!query->start_handle || (cache->stored & BIT(i))) {
+			continue;
+		}
+
+		/* Attributes first so a stored query is always complete */
+		for (j = query->first; j < query->first + query->count; j++) {
+			cache_save(&cache->addr, 'a', j, &cache->attrs[j],
+				   sizeof(cache->attrs[j]));
+		}
+
+		cache_save(&cache->addr, 'q', i, query, sizeof(*query));
+		cache->stored |= BIT(i);
+	}
+
+	BT_DBG("Stored cache for %s", bt_addr_le_str(&cache->addr));
+}
+
+static void cache_delete(struct gatt_cache *cache)
+{
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(cache->queries); i++) {
+		struct cache_query *query = &cache->queries[i];
+
+		if (!(cache->stored & BIT(i))) {
+			continue;
+		}
+
+		cache_save(&cache->addr, 'q', i, NULL, 0);
+
+		for (j = query->first; j < query->first + query->count; j++) {
+			cache_save(&cache->addr, 'a', j, NULL, 0);
+		}
+	}
+}
+
+static int cache_set(int argc, char **argv, char *val)
+{
+	struct gatt_cache *cache;
+	bt_addr_le_t addr;
+	unsigned long idx;
+	void *data;
+	int len, err;
+
+	if (argc < 2) {
+		BT_ERR("Insufficient number of arguments");
+		return -EINVAL;
+	}
+
+	BT_DBG("argv[0] %s argv[1] %s val %s", argv[0], argv[1],
+	       val ? val : "(null)");
+
+	err = bt_settings_decode_key(argv[0], &addr);
+	if (err) {
+		BT_ERR("Unable to decode address %s", argv[0]);
+		return -EINVAL;
+	}
+
+	cache = val ? cache_get(&addr) : cache_find(&addr);
+	if (!cache) {
+		return val ? -ENOMEM : 0;
+	}
+
+	idx = strtoul(argv[1] + 1, NULL, 16);
+
+	switch (argv[1][0]) {
+	case 'q':
+		if (idx >= ARRAY_SIZE(cache->queries)) {
+			return -EINVAL;
+		}
+
+		data = &cache->queries[idx];
+		len = sizeof(cache->queries[idx]);
+
+		if (val) {
+			cache->stored |= BIT(idx);
+		} else {
+			cache->stored &= ~BIT(idx);
+		}
+		break;
+	case 'a':
+		if (idx >= ARRAY_SIZE(cache->attrs)) {
+			return -EINVAL;
+		}
+
+		data = &cache->attrs[idx];
+		len = sizeof(cache->attrs[idx]);
+		break;
+	default:
+		BT_ERR("Unknown key %s", argv[1]);
+		return -EINVAL;
+	}
+
+	if (!val) {
+		memset(data, 0, len);
+		return 0;
+	}
+
+	err = settings_bytes_from_str(val, data, &len);
+	if (err) {
+		BT_ERR("Failed to decode value (err %d)", err);
+		return err;
+	}
+
+	return 0;
+}
+
+static int cache_commit(void)
+{
+	int i, j, k;
+
+	/* Drop queries that did not make it completely to storage */
+	for (i = 0; i < ARRAY_SIZE(caches); i++) {
+		struct gatt_cache *cache = &caches[i];
+
+		for (j = 0; j < ARRAY_SIZE(cache->queries); j++) {
+			struct cache_query *query = &cache->queries[j];
+
+			if (query->first + query->count >
+			    ARRAY_SIZE(cache->attrs)) {
+				memset(query, 0, sizeof(*query));
+				continue;
+			}
+
+			for (k = query->first;
+			     k < query->first + query->count; k++) {
+				if (!cache->attrs[k].handle) {
+					memset(query, 0, sizeof(*query));
+					break;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+BT_SETTINGS_DEFINE(gcache, cache_set, cache_commit, NULL);
+#else
+static inline void cache_store(struct gatt_cache *cache)
+{
+}
+
+static inline void cache_delete(struct gatt_cache *cache)
+{
+}
+#endif /* CONFIG_BT_SETTINGS */
+
+static void cache_reset(struct gatt_cache *cache)
+{
+	memset(cache, 0, sizeof(*cache));
+	bt_addr_le_copy(&cache->addr, BT_ADDR_LE_ANY);
+}
+
+static void cache_commit_query(struct gatt_cache *cache, u8_t flags)
+{
+	struct bt_gatt_discover_params *params = cache->params;
+	int i;
+
+	cache->params = NULL;
+
+	if (query_find(cache, params)) {
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(cache->queries); i++) {
+		struct cache_query *query = &cache->queries[i];
+
+		if (query->start_handle) {
+			continue;
+		}
+
+		*query = cache->pending;
+		query->flags = flags;
+
+		BT_DBG("type %u start 0x%04x end 0x%04x count %u flags 0x%02x",
+		       query->type, query->start_handle, query->end_handle,
+		       query->count, query->flags);
+		return;
+	}
+
+	BT_WARN("No space to cache discovery results");
+}
+
+static struct gatt_cache *
+cache_recording(struct bt_conn *conn,
+		const struct bt_gatt_discover_params *params)
+{
+	struct gatt_cache *cache;
+
+	cache = cache_find(&conn->le.dst);
+	if (!cache || cache->params != params) {
+		return NULL;
+	}
+
+	return cache;
+}
+
+void bt_gatt_cache_start(struct bt_conn *conn,
+			 struct bt_gatt_discover_params *params)
+{
+	struct gatt_cache *cache;
+
+	cache = cache_get(&conn->le.dst);
+	if (!cache) {
+		return;
+	}
+
+	/* The application reused the parameters from its callback, which
+	 * means the procedure being recorded is about to be stopped.
+	 */
+	if (cache->params == params && cache->pending.count) {
+		cache_commit_query(cache, CACHE_QUERY_PARTIAL);
+	}
+
+	/* Record only one procedure at a time */
+	if (cache->params && cache->params != params) {
+		return;
+	}
+
+	cache->params = params;
+	query_init(&cache->pending, params);
+	cache->pending.first = attrs_used(cache);
+}
+
+void bt_gatt_cache_attr(struct bt_conn *conn,
+			struct bt_gatt_discover_params *params,
+			const struct bt_gatt_attr *attr)
+{
+	struct gatt_cache *cache;
+	struct cache_attr *entry;
+	u16_t idx;
+
+	cache = cache_recording(conn, params);
+	if (!cache) {
+		return;
+	}
+
+	idx = cache->pending.first + cache->pending.count;
+	if (idx >= ARRAY_SIZE(cache->attrs)) {
+		BT_WARN("No space to cache attribute 0x%04x", attr->handle);
+		cache->params = NULL;
+		return;
+	}
+
+	entry = &cache->attrs[idx];
+	memset(entry, 0, sizeof(*entry));
+	entry->handle = attr->handle;
+
+	switch (cache->pending.type) {
+	case BT_GATT_DISCOVER_PRIMARY:
+	case BT_GATT_DISCOVER_SECONDARY: {
+		struct bt_gatt_service_val *svc = attr->user_data;
+
+		entry->end_handle = svc->end_handle;
+		uuid_store(&entry->uuid_type, entry->uuid, svc->uuid);
+		break;
+	}
+	case BT_GATT_DISCOVER_INCLUDE: {
+		struct bt_gatt_include *incl = attr->user_data;
+
+		entry->start_handle = incl->start_handle;
+		entry->end_handle = incl->end_handle;
+		uuid_store(&entry->uuid_type, entry->uuid, incl->uuid);
+		break;
+	}
+	case BT_GATT_DISCOVER_CHARACTERISTIC: {
+		struct bt_gatt_chrc *chrc = attr->user_data;
+
+		entry->properties = chrc->properties;
+		uuid_store(&entry->uuid_type, entry->uuid, chrc->uuid);
+		break;
+	}
+	default:
+		uuid_store(&entry->uuid_type, entry->uuid, attr->uuid);
+		break;
+	}
+
+	cache->pending.count++;
+}
+
+void bt_gatt_cache_stop(struct bt_conn *conn,
+			struct bt_gatt_discover_params *params, u16_t handle)
+{
+	struct gatt_cache *cache;
+	struct cache_query *pending;
+
+	cache = cache_recording(conn, params);
+	if (!cache) {
+		return;
+	}
+
+	/* Parameters already reused for a new procedure */
+	pending = &cache->pending;
+	if (!pending->count ||
+	    cache->attrs[pending->first + pending->count - 1].handle !=
+	    handle) {
+		return;
+	}
+
+	cache_commit_query(cache, CACHE_QUERY_PARTIAL);
+}
+
+void bt_gatt_cache_done(struct bt_conn *conn,
+			struct bt_gatt_discover_params *params, bool complete)
+{
+	struct gatt_cache *cache;
+
+	cache = cache_recording(conn, params);
+	if (!cache) {
+		return;
+	}
+
+	if (!complete) {
+		cache->params = NULL;
+		return;
+	}
+
+	cache_commit_query(cache, 0);
+}
+
+static u8_t cache_attr_notify(struct bt_conn *conn,
+			      const struct cache_attr *entry,
+			      struct bt_gatt_discover_params *params)
+{
+	struct bt_gatt_attr attr = {
+		.handle = entry->handle,
+	};
+	union {
+		struct bt_gatt_service_val svc;
+		struct bt_gatt_include incl;
+		struct bt_gatt_chrc chrc;
+	} value;
+	union cache_uuid u;
+	const struct bt_uuid *uuid;
+
+	uuid = uuid_load(entry->uuid_type, entry->uuid, &u);
+
+	switch (params->type) {
+	case BT_GATT_DISCOVER_PRIMARY:
+	case BT_GATT_DISCOVER_SECONDARY:
+		if (params->type == BT_GATT_DISCOVER_PRIMARY) {
+			attr.uuid = BT_UUID_GATT_PRIMARY;
+		} else {
+			attr.uuid = BT_UUID_GATT_SECONDARY;
+		}
+
+		value.svc.uuid = uuid;
+		value.svc.end_handle = entry->end_handle;
+		attr.user_data = &value.svc;
+		break;
+	case BT_GATT_DISCOVER_INCLUDE:
+		attr.uuid = BT_UUID_GATT_INCLUDE;
+		value.incl.uuid = uuid;
+		value.incl.start_handle = entry->start_handle;
+		value.incl.end_handle = entry->end_handle;
+		attr.user_data = &value.incl;
+		break;
+	case BT_GATT_DISCOVER_CHARACTERISTIC:
+		attr.uuid = BT_UUID_GATT_CHRC;
+		attr.perm = BT_GATT_PERM_READ;
+		attr.read = bt_gatt_attr_read_chrc;
+		value.chrc.uuid = uuid;
+		value.chrc.properties = entry->properties;
+		attr.user_data = &value.chrc;
+		break;
+	default:
+		attr.uuid = uuid;
+		break;
+	}
+
+	return params->func(conn, &attr, params);
+}
+
+static void cache_serve(struct bt_conn *conn, struct gatt_cache *cache,
+			struct bt_gatt_discover_params *params)
+{
+	struct cache_query *query;
+	const struct cache_attr *entry = NULL;
+	u16_t last;
+	u8_t i, first, count, flags;
+
+	query = query_find(cache, params);
+	if (!query) {
+		/* Cache cleared from a callback */
+		params->func(conn, NULL, params);
+		return;
+	}
+
+	BT_DBG("type %u start 0x%04x end 0x%04x count %u", query->type,
+	       query->start_handle, query->end_handle, query->count);
+
+	/* The callback may start new procedures which change the cache */
+	first = query->first;
+	count = query->count;
+	flags = query->flags;
+
+	for (i = 0; i < count; i++) {
+		entry = &cache->attrs[first + i];
+
+		if (cache_attr_notify(conn, entry, params) ==
+		    BT_GATT_ITER_STOP) {
+			return;
+		}
+	}
+
+	if (!(flags & CACHE_QUERY_PARTIAL) || !entry) {
+		params->func(conn, NULL, params);
+		return;
+	}
+
+	/* Only a prefix is cached, continue the procedure from there */
+	if (params->type == BT_GATT_DISCOVER_PRIMARY ||
+	    params->type == BT_GATT_DISCOVER_SECONDARY) {
+		last = entry->end_handle;
+	} else {
+		last = entry->handle;
+	}
+
+	params->start_handle = last;
+	if (params->start_handle < UINT16_MAX) {
+		params->start_handle++;
+	}
+
+	if (params->start_handle >= params->end_handle ||
+	    bt_gatt_discover(conn, params)) {
+		params->func(conn, NULL, params);
+	}
+}
+
+bool bt_gatt_cache_discover(struct bt_conn *conn,
+			    struct bt_gatt_discover_params *params)
+{
+	struct gatt_cache *cache;
+
+	cache = cache_find(&conn->le.dst);
+	if (!cache || !query_find(cache, params)) {
+		return false;
+	}
+
+	/* Replay procedures started from a callback once the current one
+	 * is done, like responses received over the air would be, so
+	 * chained discoveries do not nest on the stack.
+	 */
+	if (cache->serving) {
+		if (cache->next) {
+			return false;
+		}
+
+		cache->next = params;
+		return true;
+	}
+
+	cache->serving = true;
+
+	while (params) {
+		cache_serve(conn, cache, params);
+
+		params = cache->next;
+		cache->next = NULL;
+	}
+
+	cache->serving = false;
+
+	return true;
+}
+
+void bt_gatt_cache_notification(struct bt_conn *conn, u16_t handle)
+{
+	struct gatt_cache *cache;
+	union cache_uuid u;
+	int i, j;
+
+	cache = cache_find(&conn->le.dst);
+	if (!cache) {
+		return;
+	}
+
+	/* Any Service Changed indication invalidates the whole cache, the
+	 * affected range is not worth tracking for a rediscovery.
+	 */
+	for (i = 0; i < ARRAY_SIZE(cache->queries); i++) {
+		struct cache_query *query = &cache->queries[i];
+
+		if (!query->start_handle ||
+		    query->type != BT_GATT_DISCOVER_CHARACTERISTIC) {
+			continue;
+		}
+
+		for (j = query->first; j < query->first + query->count; j++) {
+			struct cache_attr *entry = &cache->attrs[j];
+
+			if (entry->handle + 1 != handle ||
+			    !uuid_load(entry->uuid_type, entry->uuid, &u) ||
+			    bt_uuid_cmp(&u.uuid, BT_UUID_GATT_SC)) {
+				continue;
+			}
+
+			BT_DBG("Service Changed from %s",
+			       bt_addr_le_str(&conn->le.dst));
+
+			bt_gatt_cache_clear(&conn->le.dst);
+			return;
+		}
+	}
+}
+
+void bt_gatt_cache_disconnected(struct bt_conn *conn)
+{
+	struct gatt_cache *cache;
+
+	cache = cache_find(&conn->le.dst);
+	if (!cache) {
+		return;
+	}
+
+	cache->params = NULL;
+
+	if (!bt_addr_le_is_bonded(&conn->le.dst)) {
+		cache_reset(cache);
+		return;
+	}
+
+	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
+		cache_store(cache);
+	}
+}
+
+void bt_gatt_cache_clear(const bt_addr_le_t *addr)
+{
+	struct gatt_cache *cache;
+
+	cache = cache_find(addr);
+	if (!cache) {
+		return;
+	}
+
+	if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
+		cache_delete(cache);
+	}
+
+	cache_reset(cache);
+}
@@ -24,3 +24,65 @@ static inline void bt_gatt_notification(struct bt_conn *conn, u16_t handle,
 {
 }
 #endif /* CONFIG_BT_GATT_CLIENT */
+
+struct bt_gatt_attr;
+struct bt_gatt_discover_params;
+
+#if defined(CONFIG_BT_GATT_CACHE)
+bool bt_gatt_cache_discover(struct bt_conn *conn,
+			    struct bt_gatt_discover_params *params);
+void bt_gatt_cache_start(struct bt_conn *conn,
+			 struct bt_gatt_discover_params *params);
+void bt_gatt_cache_attr(struct bt_conn *conn,
+			struct bt_gatt_discover_params *params,
+			const struct bt_gatt_attr *attr);
+void bt_gatt_cache_stop(struct bt_conn *conn,
+			struct bt_gatt_discover_params *params, u16_t handle);
+void bt_gatt_cache_done(struct bt_conn *conn,
+			struct bt_gatt_discover_params *params, bool complete);
+void bt_gatt_cache_notification(struct bt_conn *conn, u16_t handle);
+void bt_gatt_cache_disconnected(struct bt_conn *conn);
+void bt_gatt_cache_clear(const bt_addr_le_t *addr);
+#else
+static inline bool bt_gatt_cache_discover(struct bt_conn *conn,
+				struct bt_gatt_discover_params *params)
+{
+	return false;
+}
+
+static inline void bt_gatt_cache_start(struct bt_conn *conn,
+				struct bt_gatt_discover_params *params)
+{
+}
+
+static inline void bt_gatt_cache_attr(struct bt_conn *conn,
+				struct bt_gatt_discover_params *params,
+				const struct bt_gatt_attr *attr)
+{
+}
+
+static inline void bt_gatt_cache_stop(struct bt_conn *conn,
+				struct bt_gatt_discover_params *params,
+				u16_t handle)
+{
+}
+
+static inline void bt_gatt_cache_done(struct bt_conn *conn,
+				struct bt_gatt_discover_params *params,
+				bool complete)
+{
+}
+
+static inline void bt_gatt_cache_notification(struct bt_conn *conn,
+					      u16_t handle)
+{
+}
+
+static inline void bt_gatt_cache_disconnected(struct bt_conn *conn)
+{
+}
+
+static inline void bt_gatt_cache_clear(const bt_addr_le_t *addr)
+{
+}
+#endif /* CONFIG_BT_GATT_CACHE */
@@ -1328,6 +1328,8 @@ int bt_unpair(const bt_addr_le_t *addr)
 		bt_gatt_clear_ccc(addr);
 	}
 
+	bt_gatt_cache_clear(addr);
+
 	return 0;
 }
 
@@ -2432,6 +2434,9 @@ int bt_id_add(struct bt_keys *keys)
 
 	BT_DBG("addr %s", bt_addr_le_str(&keys->addr));
 
+	/* RPAs which didn't resolve so far may belong to the new IRK */
+	bt_keys_rpa_cache_flush();
+
 	/* Nothing to be done if host-side resolving is used */
 	if (!bt_dev.le.rl_size || bt_dev.le.rl_entries > bt_dev.le.rl_size) {
 		bt_dev.le.rl_entries++;
@@ -4391,6 +4396,16 @@ int bt_send(struct net_buf *buf)
 	return bt_dev.drv->send(buf);
 }
 
+#if !defined(CONFIG_BT_RECV_IS_RX_THREAD)
+static void rx_queue_put(struct net_buf *buf)
+{
+#if defined(CONFIG_BT_RX_DIRECT_ACL)
+	atomic_inc(&bt_dev.rx_pending);
+#endif
+	net_buf_put(&bt_dev.rx_queue, buf);
+}
+#endif /* !CONFIG_BT_RECV_IS_RX_THREAD */
+
 int bt_recv(struct net_buf *buf)
 {
 	bt_monitor_send(bt_monitor_opcode(buf), buf->data, buf->len);
@@ -4402,8 +4417,18 @@ int bt_recv(struct net_buf *buf)
 	case BT_BUF_ACL_IN:
 #if defined(CONFIG_BT_RECV_IS_RX_THREAD)
 		hci_acl(buf);
+#elif defined(CONFIG_BT_RX_DIRECT_ACL)
+		/* Process the data right away unless called from an ISR or
+		 * the RX thread has not caught up yet, e.g. with the
+		 * Connection Complete event the data belongs to.
+		 */
+		if (!k_is_in_isr() && !atomic_get(&bt_dev.rx_pending)) {
+			hci_acl(buf);
+		} else {
+			rx_queue_put(buf);
+		}
 #else
-		net_buf_put(&bt_dev.rx_queue, buf);
+		rx_queue_put(buf);
 #endif
 		return 0;
 #endif /* BT_CONN */
@@ -4411,7 +4436,7 @@ int bt_recv(struct net_buf *buf)
 #if defined(CONFIG_BT_RECV_IS_RX_THREAD)
 		hci_event(buf);
 #else
-		net_buf_put(&bt_dev.rx_queue, buf);
+		rx_queue_put(buf);
 #endif
 		return 0;
 	default:
@@ -4539,9 +4564,34 @@ static void init_work(struct k_work *work)
 }
 
 #if !defined(CONFIG_BT_RECV_IS_RX_THREAD)
+static void hci_rx_process(struct net_buf *buf)
+{
+	BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf), buf->len);
+
+	switch (bt_buf_get_type(buf)) {
+#if defined(CONFIG_BT_CONN)
+	case BT_BUF_ACL_IN:
+		hci_acl(buf);
+		break;
+#endif /* CONFIG_BT_CONN */
+	case BT_BUF_EVT:
+		hci_event(buf);
+		break;
+	default:
+		BT_ERR("Unknown buf type %u", bt_buf_get_type(buf));
+		net_buf_unref(buf);
+		break;
+	}
+
+#if defined(CONFIG_BT_RX_DIRECT_ACL)
+	atomic_dec(&bt_dev.rx_pending);
+#endif
+}
+
 static void hci_rx_thread(void)
 {
 	struct net_buf *buf;
+	int count;
 
 	BT_DBG("started");
 
@@ -4549,22 +4599,15 @@ static void hci_rx_thread(void)
 		BT_DBG("calling fifo_get_wait");
 		buf = net_buf_get(&bt_dev.rx_queue, K_FOREVER);
 
-		BT_DBG("buf %p type %u len %u", buf, bt_buf_get_type(buf),
-		       buf->len);
+		/* Drain what is already queued, up to a limit, before
+		 * giving up the CPU.
+		 */
+		for (count = CONFIG_BT_RX_BATCH; buf && count; count--) {
+			hci_rx_process(buf);
 
-		switch (bt_buf_get_type(buf)) {
-#if defined(CONFIG_BT_CONN)
-		case BT_BUF_ACL_IN:
-			hci_acl(buf);
-			break;
-#endif /* CONFIG_BT_CONN */
-		case BT_BUF_EVT:
-			hci_event(buf);
-			break;
-		default:
-			BT_ERR("Unknown buf type %u", bt_buf_get_type(buf));
-			net_buf_unref(buf);
-			break;
+			if (count > 1) {
+				buf = net_buf_get(&bt_dev.rx_queue, K_NO_WAIT);
+			}
 		}
 
 		/* Make sure we don't hog the CPU if the rx_queue never
@@ -4839,6 +4882,27 @@ int bt_le_adv_start(const struct bt_le_adv_param *param,
 	return 0;
 }
 
+int bt_le_adv_update_data(const struct bt_data *ad, size_t ad_len,
+			  const struct bt_data *sd, size_t sd_len)
+{
+	int err;
+
+	if (!atomic_test_bit(bt_dev.flags, BT_DEV_ADVERTISING)) {
+		return -EAGAIN;
+	}
+
+	err = set_ad(BT_HCI_OP_LE_SET_ADV_DATA, ad, ad_len);
+	if (err) {
+		return err;
+	}
+
+	if (sd) {
+		return set_ad(BT_HCI_OP_LE_SET_SCAN_RSP_DATA, sd, sd_len);
+	}
+
+	return 0;
+}
+
 int bt_le_adv_stop(void)
 {
 	int err;
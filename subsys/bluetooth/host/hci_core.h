@@ -148,6 +148,10 @@ struct bt_dev {
 #if !defined(CONFIG_BT_RECV_IS_RX_THREAD)
 	/* Queue for incoming HCI events & ACL data */
 	struct k_fifo		rx_queue;
+#if defined(CONFIG_BT_RX_DIRECT_ACL)
+	/* Buffers queued to or being processed by the RX thread */
+	atomic_t		rx_pending;
+#endif
 #endif
 
 	/* Queue for outgoing HCI commands */
@@ -75,6 +75,15 @@ static struct {
 	};
 } ecc;
 
+#if defined(CONFIG_BT_TINYCRYPT_ECC_PREGEN)
+/* Key pair generated ahead of the next public key request */
+static struct {
+	u8_t private_key[32];
+	u8_t pk[64];
+	bool valid;
+} next_key;
+#endif
+
 static void send_cmd_status(u16_t opcode, u8_t status)
 {
 	struct bt_hci_evt_cmd_status *evt;
@@ -98,27 +107,63 @@ static void send_cmd_status(u16_t opcode, u8_t status)
 	bt_recv_prio(buf);
 }
 
-static u8_t generate_keys(void)
+static u8_t generate_keys(u8_t *pk, u8_t *private_key)
 {
 #if !defined(CONFIG_BT_USE_DEBUG_KEYS)
 	do {
 		int rc;
 
-		rc = uECC_make_key(ecc.pk, ecc.private_key, &curve_secp256r1);
+		rc = uECC_make_key(pk, private_key, &curve_secp256r1);
 		if (rc == TC_CRYPTO_FAIL) {
 			BT_ERR("Failed to create ECC public/private pair");
 			return BT_HCI_ERR_UNSPECIFIED;
 		}
 
 	/* make sure generated key isn't debug key */
-	} while (memcmp(ecc.private_key, debug_private_key, 32) == 0);
+	} while (memcmp(private_key, debug_private_key, 32) == 0);
 #else
-	memcpy(&ecc.pk, debug_public_key, 64);
-	memcpy(ecc.private_key, debug_private_key, 32);
+	memcpy(pk, debug_public_key, 64);
+	memcpy(private_key, debug_private_key, 32);
 #endif
 	return 0;
 }
 
+#if defined(CONFIG_BT_TINYCRYPT_ECC_PREGEN)
+static void pregenerate_keys(void)
+{
+	if (next_key.valid) {
+		return;
+	}
+
+	next_key.valid = !generate_keys(next_key.pk, next_key.private_key);
+}
+
+static u8_t take_keys(void)
+{
+	if (!next_key.valid) {
+		return generate_keys(ecc.pk, ecc.private_key);
+	}
+
+	memcpy(ecc.pk, next_key.pk, sizeof(next_key.pk));
+	memcpy(ecc.private_key, next_key.private_key,
+	       sizeof(next_key.private_key));
+
+	memset(next_key.private_key, 0, sizeof(next_key.private_key));
+	next_key.valid = false;
+
+	return 0;
+}
+#else
+static inline void pregenerate_keys(void)
+{
+}
+
+static u8_t take_keys(void)
+{
+	return generate_keys(ecc.pk, ecc.private_key);
+}
+#endif /* CONFIG_BT_TINYCRYPT_ECC_PREGEN */
+
 static void emulate_le_p256_public_key_cmd(void)
 {
 	struct bt_hci_evt_le_p256_public_key_complete *evt;
@@ -129,7 +174,7 @@ static void emulate_le_p256_public_key_cmd(void)
 
 	BT_DBG("");
 
-	status = generate_keys();
+	status = take_keys();
 
 	buf = bt_buf_get_rx(BT_BUF_EVT, K_FOREVER);
 
@@ -209,6 +254,10 @@ static void ecc_thread(void *p1, void *p2, void *p3)
 
 		if (atomic_test_bit(flags, PENDING_PUB_KEY)) {
 			emulate_le_p256_public_key_cmd();
+			/* Only after the first key has been requested, so
+			 * that the random source is known to be ready.
+			 */
+			pregenerate_keys();
 		} else if (atomic_test_bit(flags, PENDING_DHKEY)) {
 			emulate_le_generate_dhkey();
 		} else {
@@ -28,6 +28,58 @@
 
 static struct bt_keys key_pool[CONFIG_BT_MAX_PAIRED];
 
+#if defined(CONFIG_BT_KEYS_RPA_CACHE_SIZE) && CONFIG_BT_KEYS_RPA_CACHE_SIZE > 0
+/* Recently seen RPAs which none of the IRKs resolve */
+static struct {
+	bt_addr_t rpa[CONFIG_BT_KEYS_RPA_CACHE_SIZE];
+	u8_t count;
+	u8_t next;
+} rpa_cache;
+
+static bool rpa_cache_find(const bt_addr_t *rpa)
+{
+	int i;
+
+	for (i = 0; i < rpa_cache.count; i++) {
+		if (!bt_addr_cmp(&rpa_cache.rpa[i], rpa)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void rpa_cache_add(const bt_addr_t *rpa)
+{
+	/* Replace the oldest entry once the cache is full */
+	bt_addr_copy(&rpa_cache.rpa[rpa_cache.next], rpa);
+	rpa_cache.next = (rpa_cache.next + 1) % ARRAY_SIZE(rpa_cache.rpa);
+
+	if (rpa_cache.count < ARRAY_SIZE(rpa_cache.rpa)) {
+		rpa_cache.count++;
+	}
+}
+
+void bt_keys_rpa_cache_flush(void)
+{
+	rpa_cache.count = 0;
+	rpa_cache.next = 0;
+}
+#else
+static inline bool rpa_cache_find(const bt_addr_t *rpa)
+{
+	return false;
+}
+
+static inline void rpa_cache_add(const bt_addr_t *rpa)
+{
+}
+
+void bt_keys_rpa_cache_flush(void)
+{
+}
+#endif /* CONFIG_BT_KEYS_RPA_CACHE_SIZE > 0 */
+
 struct bt_keys *bt_keys_get_addr(const bt_addr_le_t *addr)
 {
 	struct bt_keys *keys;
@@ -125,6 +177,11 @@ struct bt_keys *bt_keys_find_irk(const bt_addr_le_t *addr)
 		}
 	}
 
+	if (rpa_cache_find(&addr->a)) {
+		BT_DBG("RPA %s known to be unresolvable", bt_addr_str(&addr->a));
+		return NULL;
+	}
+
 	for (i = 0; i < ARRAY_SIZE(key_pool); i++) {
 		if (!(key_pool[i].keys & BT_KEYS_IRK)) {
 			continue;
@@ -143,6 +200,8 @@ struct bt_keys *bt_keys_find_irk(const bt_addr_le_t *addr)
 
 	BT_DBG("No IRK for %s", bt_addr_le_str(addr));
 
+	rpa_cache_add(&addr->a);
+
 	return NULL;
 }
 
@@ -69,6 +69,7 @@ struct bt_keys *bt_keys_get_addr(const bt_addr_le_t *addr);
 struct bt_keys *bt_keys_get_type(int type, const bt_addr_le_t *addr);
 struct bt_keys *bt_keys_find(int type, const bt_addr_le_t *addr);
 struct bt_keys *bt_keys_find_irk(const bt_addr_le_t *addr);
+void bt_keys_rpa_cache_flush(void);
 struct bt_keys *bt_keys_find_addr(const bt_addr_le_t *addr);
 
 void bt_keys_add_type(struct bt_keys *keys, int type);
@@ -1048,15 +1048,15 @@ static struct net_buf *l2cap_chan_create_seg(struct bt_l2cap_le_chan *ch,
 
 	headroom = BT_L2CAP_CHAN_SEND_RESERVE + sdu_hdr_len;
 
-	/* Check if original buffer has enough headroom and don't have any
-	 * fragments.
+	/* Send the original buffer as is if it has enough headroom, the
+	 * caller then detaches it from any following fragments.
 	 */
-	if (net_buf_headroom(buf) >= headroom && !buf->frags) {
+	if (net_buf_headroom(buf) >= headroom) {
 		if (sdu_hdr_len) {
 			/* Push SDU length if set */
 			net_buf_push_le16(buf, net_buf_frags_len(buf));
 		}
-		return net_buf_ref(buf);
+		return buf;
 	}
 
 segment:
@@ -1078,9 +1078,13 @@ segment:
 	return seg;
 }
 
-static int l2cap_chan_le_send(struct bt_l2cap_le_chan *ch, struct net_buf *buf,
-			      u16_t sdu_hdr_len)
+/* Send one segment from the fragment *buf.  When the whole fragment is
+ * sent as the segment, *buf is advanced to the next fragment, if any.
+ */
+static int l2cap_chan_le_send(struct bt_l2cap_le_chan *ch,
+			      struct net_buf **buf, u16_t sdu_hdr_len)
 {
+	struct net_buf *seg;
 	int len;
 
 	/* Wait for credits */
@@ -1089,20 +1093,27 @@ static int l2cap_chan_le_send(struct bt_l2cap_le_chan *ch, struct net_buf *buf,
 		return -EAGAIN;
 	}
 
-	buf = l2cap_chan_create_seg(ch, buf, sdu_hdr_len);
+	seg = l2cap_chan_create_seg(ch, *buf, sdu_hdr_len);
 
 	/* Channel may have been disconnected while waiting for a buffer */
 	if (!ch->chan.conn) {
-		net_buf_unref(buf);
+		if (seg != *buf) {
+			net_buf_unref(seg);
+		}
 		return -ECONNRESET;
 	}
 
+	if (seg == *buf) {
+		*buf = seg->frags;
+		seg->frags = NULL;
+	}
+
 	BT_DBG("ch %p cid 0x%04x len %u credits %u", ch, ch->tx.cid,
-	       buf->len, k_sem_count_get(&ch->tx.credits));
+	       seg->len, k_sem_count_get(&ch->tx.credits));
 
-	len = buf->len - sdu_hdr_len;
+	len = seg->len - sdu_hdr_len;
 
-	bt_l2cap_send(ch->chan.conn, ch->tx.cid, buf);
+	bt_l2cap_send(ch->chan.conn, ch->tx.cid, seg);
 
 	return len;
 }
@@ -1126,7 +1137,7 @@ static int l2cap_chan_le_send_sdu(struct bt_l2cap_le_chan *ch,
 
 	if (!sent) {
 		/* Add SDU length for the first segment */
-		ret = l2cap_chan_le_send(ch, frag, BT_L2CAP_SDU_HDR_LEN);
+		ret = l2cap_chan_le_send(ch, &frag, BT_L2CAP_SDU_HDR_LEN);
 		if (ret < 0) {
 			if (ret == -EAGAIN) {
 				/* Store sent data into user_data */
@@ -1146,7 +1157,7 @@ static int l2cap_chan_le_send_sdu(struct bt_l2cap_le_chan *ch,
 			frag = net_buf_frag_del(NULL, frag);
 		}
 
-		ret = l2cap_chan_le_send(ch, frag, 0);
+		ret = l2cap_chan_le_send(ch, &frag, 0);
 		if (ret < 0) {
 			if (ret == -EAGAIN) {
 				/* Store sent data into user_data */
@@ -1161,7 +1172,10 @@ static int l2cap_chan_le_send_sdu(struct bt_l2cap_le_chan *ch,
 	BT_DBG("ch %p cid 0x%04x sent %u total_len %u", ch, ch->tx.cid, sent,
 	       total_len);
 
-	net_buf_unref(frag);
+	/* Unless the last fragment was itself sent as the last segment */
+	if (frag) {
+		net_buf_unref(frag);
+	}
 
 	return ret;
 }
@@ -1386,6 +1400,12 @@ static void l2cap_chan_le_recv_sdu(struct bt_l2cap_le_chan *chan,
 		return;
 	}
 
+	/* Without alloc_buf the segments themselves make up the SDU */
+	if (!chan->chan.ops->alloc_buf) {
+		net_buf_frag_add(chan->_sdu, net_buf_ref(buf));
+		goto done;
+	}
+
 	/* Jump to last fragment */
 	frag = net_buf_frag_last(chan->_sdu);
 
@@ -1407,6 +1427,7 @@ static void l2cap_chan_le_recv_sdu(struct bt_l2cap_le_chan *chan,
 		BT_DBG("frag %p len %u", frag, frag->len);
 	}
 
+done:
 	if (net_buf_frags_len(chan->_sdu) == chan->_sdu_len) {
 		/* Receiving complete SDU, notify channel and reset SDU buf */
 		chan->chan.ops->recv(&chan->chan, chan->_sdu);
@@ -1458,6 +1479,16 @@ static void l2cap_chan_le_recv(struct bt_l2cap_le_chan *chan,
 		return;
 	}
 
+	/* Otherwise keep the first segment of a segmented SDU, the next
+	 * ones are chained to it without copying.
+	 */
+	if (buf->len < sdu_len) {
+		chan->_sdu = net_buf_ref(buf);
+		chan->_sdu_len = sdu_len;
+		l2cap_chan_update_credits(chan, buf);
+		return;
+	}
+
 	chan->chan.ops->recv(&chan->chan, buf);
 
 	l2cap_chan_update_credits(chan, buf);
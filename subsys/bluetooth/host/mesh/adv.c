@@ -54,6 +54,11 @@
 #endif
 
 static K_FIFO_DEFINE(adv_queue);
+#if defined(CONFIG_BT_MESH_RELAY_QUEUE)
+/* Relayed messages, sorted by descending TTL */
+static sys_slist_t relay_queue;
+static K_SEM_DEFINE(relay_sem, 0, UINT_MAX);
+#endif
 static struct k_thread adv_thread_data;
 static BT_STACK_NOINIT(adv_thread_stack, ADV_STACK_SIZE);
 
@@ -91,19 +96,108 @@ static inline void adv_send_end(int err, const struct bt_mesh_send_cb *cb,
 	}
 }
 
-static inline void adv_send(struct net_buf *buf)
+static u16_t adv_int_get(struct net_buf *buf)
 {
 	const s32_t adv_int_min = ((bt_dev.hci_version >= BT_HCI_VERSION_5_0) ?
 				   ADV_INT_FAST_MS : ADV_INT_DEFAULT_MS);
+
+	return max(adv_int_min, BT_MESH_TRANSMIT_INT(BT_MESH_ADV(buf)->xmit));
+}
+
+#if defined(CONFIG_BT_MESH_RELAY_QUEUE)
+static struct net_buf *relay_get(void)
+{
+	struct net_buf *buf;
+	sys_snode_t *node;
+	unsigned int key;
+	u16_t age;
+
+	while (1) {
+		key = irq_lock();
+		node = sys_slist_get(&relay_queue);
+		irq_unlock(key);
+
+		if (!node) {
+			return NULL;
+		}
+
+		k_sem_take(&relay_sem, K_NO_WAIT);
+
+		buf = CONTAINER_OF(node, struct net_buf, node);
+		age = k_uptime_get_32() - BT_MESH_ADV(buf)->relay.timestamp;
+		if (age <= CONFIG_BT_MESH_RELAY_QUEUE_AGE) {
+			return buf;
+		}
+
+		BT_DBG("Dropping stale relay (TTL %u age %u ms)",
+		       BT_MESH_ADV(buf)->relay.ttl, age);
+		net_buf_unref(buf);
+	}
+}
+#endif /* CONFIG_BT_MESH_RELAY_QUEUE */
+
+/* Next buffer to send, locally originated messages go first */
+static struct net_buf *adv_get(s32_t timeout)
+{
+	struct net_buf *buf;
+
+#if defined(CONFIG_BT_MESH_RELAY_QUEUE)
+	struct k_poll_event events[] = {
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_FIFO_DATA_AVAILABLE,
+					 K_POLL_MODE_NOTIFY_ONLY,
+					 &adv_queue),
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SEM_AVAILABLE,
+					 K_POLL_MODE_NOTIFY_ONLY,
+					 &relay_sem),
+	};
+
+	buf = net_buf_get(&adv_queue, K_NO_WAIT);
+	if (!buf) {
+		buf = relay_get();
+	}
+
+	if (!buf && timeout != K_NO_WAIT) {
+		k_poll(events, ARRAY_SIZE(events), timeout);
+
+		buf = net_buf_get(&adv_queue, K_NO_WAIT);
+		if (!buf) {
+			buf = relay_get();
+		}
+	}
+#else
+	buf = net_buf_get(&adv_queue, timeout);
+#endif
+
+	if (!buf) {
+		return NULL;
+	}
+
+	/* busy == 0 means this was canceled */
+	if (!BT_MESH_ADV(buf)->busy) {
+		net_buf_unref(buf);
+		return NULL;
+	}
+
+	BT_MESH_ADV(buf)->busy = 0;
+
+	return buf;
+}
+
+/* Send buf, followed back-to-back by the next queued buffers that use the
+ * same advertising interval. Returns a dequeued buffer that could not be
+ * chained, if any.
+ */
+static struct net_buf *adv_send(struct net_buf *buf)
+{
 	const struct bt_mesh_send_cb *cb = BT_MESH_ADV(buf)->cb;
 	void *cb_data = BT_MESH_ADV(buf)->cb_data;
+	struct net_buf *next = NULL;
 	struct bt_le_adv_param param;
 	u16_t duration, adv_int;
 	struct bt_data ad;
 	int err;
 
-	adv_int = max(adv_int_min,
-		      BT_MESH_TRANSMIT_INT(BT_MESH_ADV(buf)->xmit));
+	adv_int = adv_int_get(buf);
 	duration = (MESH_SCAN_WINDOW_MS +
 		    ((BT_MESH_TRANSMIT_COUNT(BT_MESH_ADV(buf)->xmit) + 1) *
 		     (adv_int + 10)));
@@ -132,21 +226,61 @@ static inline void adv_send(struct net_buf *buf)
 	adv_send_start(duration, err, cb, cb_data);
 	if (err) {
 		BT_ERR("Advertising failed: err %d", err);
-		return;
+		return NULL;
 	}
 
 	BT_DBG("Advertising started. Sleeping %u ms", duration);
 
 	k_sleep(K_MSEC(duration));
 
+	/* Replacing the advertising data keeps the advertiser running and
+	 * saves the parameter, enable and disable commands.
+	 */
+	while (IS_ENABLED(CONFIG_BT_MESH_ADV_BACK_TO_BACK)) {
+		next = adv_get(K_NO_WAIT);
+		if (!next || adv_int_get(next) != adv_int) {
+			break;
+		}
+
+		adv_send_end(0, cb, cb_data);
+
+		cb = BT_MESH_ADV(next)->cb;
+		cb_data = BT_MESH_ADV(next)->cb_data;
+		duration = (MESH_SCAN_WINDOW_MS +
+			    ((BT_MESH_TRANSMIT_COUNT(BT_MESH_ADV(next)->xmit) +
+			      1) * (adv_int + 10)));
+
+		BT_DBG("type %u len %u: %s", BT_MESH_ADV(next)->type,
+		       next->len, bt_hex(next->data, next->len));
+
+		ad.type = adv_type[BT_MESH_ADV(next)->type];
+		ad.data_len = next->len;
+		ad.data = next->data;
+
+		err = bt_le_adv_update_data(&ad, 1, NULL, 0);
+		net_buf_unref(next);
+		next = NULL;
+		adv_send_start(duration, err, cb, cb_data);
+		if (err) {
+			BT_ERR("Updating advertising data failed: err %d",
+			       err);
+			cb = NULL;
+			break;
+		}
+
+		k_sleep(K_MSEC(duration));
+	}
+
 	err = bt_le_adv_stop();
 	adv_send_end(err, cb, cb_data);
 	if (err) {
 		BT_ERR("Stopping advertising failed: err %d", err);
-		return;
+		return next;
 	}
 
 	BT_DBG("Advertising stopped");
+
+	return next;
 }
 
 static void adv_stack_dump(const struct k_thread *thread, void *user_data)
@@ -157,37 +291,44 @@ static void adv_stack_dump(const struct k_thread *thread, void *user_data)
 #endif
 }
 
+static struct net_buf *adv_wait(void)
+{
+	struct net_buf *buf;
+
+	if (!IS_ENABLED(CONFIG_BT_MESH_PROXY)) {
+		return adv_get(K_FOREVER);
+	}
+
+	buf = adv_get(K_NO_WAIT);
+	while (!buf) {
+		s32_t timeout;
+
+		timeout = bt_mesh_proxy_adv_start();
+		BT_DBG("Proxy Advertising up to %d ms", timeout);
+		buf = adv_get(timeout);
+		bt_mesh_proxy_adv_stop();
+	}
+
+	return buf;
+}
+
 static void adv_thread(void *p1, void *p2, void *p3)
 {
+	struct net_buf *buf = NULL;
+
 	BT_DBG("started");
 
 	while (1) {
-		struct net_buf *buf;
-
-		if (IS_ENABLED(CONFIG_BT_MESH_PROXY)) {
-			buf = net_buf_get(&adv_queue, K_NO_WAIT);
-			while (!buf) {
-				s32_t timeout;
-
-				timeout = bt_mesh_proxy_adv_start();
-				BT_DBG("Proxy Advertising up to %d ms",
-				       timeout);
-				buf = net_buf_get(&adv_queue, timeout);
-				bt_mesh_proxy_adv_stop();
-			}
-		} else {
-			buf = net_buf_get(&adv_queue, K_FOREVER);
+		/* A buffer may be left over from a back-to-back sequence */
+		if (!buf) {
+			buf = adv_wait();
 		}
 
 		if (!buf) {
 			continue;
 		}
 
-		/* busy == 0 means this was canceled */
-		if (BT_MESH_ADV(buf)->busy) {
-			BT_MESH_ADV(buf)->busy = 0;
-			adv_send(buf);
-		}
+		buf = adv_send(buf);
 
 		STACK_ANALYZE("adv stack", adv_thread_stack);
 		k_thread_foreach(adv_stack_dump, "BT_MESH");
@@ -248,6 +389,45 @@ void bt_mesh_adv_send(struct net_buf *buf, const struct bt_mesh_send_cb *cb,
 	net_buf_put(&adv_queue, net_buf_ref(buf));
 }
 
+void bt_mesh_adv_relay(struct net_buf *buf, u8_t ttl)
+{
+#if defined(CONFIG_BT_MESH_RELAY_QUEUE)
+	struct net_buf *cur, *prev = NULL;
+	unsigned int key;
+
+	BT_DBG("TTL %u len %u", ttl, buf->len);
+
+	BT_MESH_ADV(buf)->cb = NULL;
+	BT_MESH_ADV(buf)->cb_data = NULL;
+	BT_MESH_ADV(buf)->busy = 1;
+	BT_MESH_ADV(buf)->relay.ttl = ttl;
+	BT_MESH_ADV(buf)->relay.timestamp = k_uptime_get_32();
+
+	net_buf_ref(buf);
+
+	/* Messages with more hops left go first, so relaying does not add
+	 * up delays along long paths. Equal TTLs are kept in FIFO order.
+	 */
+	key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&relay_queue, cur, node) {
+		if (BT_MESH_ADV(cur)->relay.ttl < ttl) {
+			break;
+		}
+
+		prev = cur;
+	}
+
+	sys_slist_insert(&relay_queue, prev ? &prev->node : NULL, &buf->node);
+
+	irq_unlock(key);
+
+	k_sem_give(&relay_sem);
+#else
+	bt_mesh_adv_send(buf, NULL, NULL);
+#endif
+}
+
 static void bt_mesh_scan_cb(const bt_addr_le_t *addr, s8_t rssi,
 			    u8_t adv_type, struct net_buf_simple *buf)
 {
@@ -40,6 +40,12 @@ struct bt_mesh_adv {
 		struct {
 			u8_t attempts;
 		} seg;
+
+		/* For relayed messages waiting in the relay queue */
+		struct {
+			u16_t timestamp;
+			u8_t  ttl;
+		} relay;
 	};
 };
 
@@ -57,6 +63,11 @@ struct net_buf *bt_mesh_adv_create_from_pool(struct net_buf_pool *pool,
 void bt_mesh_adv_send(struct net_buf *buf, const struct bt_mesh_send_cb *cb,
 		      void *cb_data);
 
+/* Queue a relayed message behind locally originated ones, ttl is the
+ * TTL the message is sent with.
+ */
+void bt_mesh_adv_relay(struct net_buf *buf, u8_t ttl);
+
 void bt_mesh_adv_update(void);
 
 void bt_mesh_adv_init(void);
@@ -10,6 +10,7 @@
 #include <stdbool.h>
 #include <errno.h>
 #include <toolchain.h>
+#include <kernel.h>
 #include <zephyr/types.h>
 #include <misc/byteorder.h>
 #include <misc/util.h>
@@ -202,10 +203,93 @@ int bt_mesh_id128(const u8_t n[16], const char *s, u8_t out[16])
 	return bt_mesh_k1(n, 16, salt, id128, out);
 }
 
-static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
-			       const u8_t *enc_msg, size_t msg_len,
-			       const u8_t *aad, size_t aad_len,
-			       u8_t *out_msg, size_t mic_size)
+/* AES-128 block cipher used by the CCM and obfuscation functions. With
+ * the software controller the ECB peripheral is used directly, otherwise
+ * TinyCrypt key schedules are cached so that hot keys (NetKey derived
+ * keys and AppKeys) are not expanded again for every block.
+ */
+struct mesh_aes {
+#if defined(CONFIG_BT_HOST_CRYPTO)
+	const struct tc_aes_key_sched_struct *sched;
+#else
+	const u8_t *key;
+#endif
+};
+
+#if defined(CONFIG_BT_HOST_CRYPTO)
+static struct {
+	u8_t key[16];
+	/* Last use, 0 if the entry is unused */
+	u32_t used;
+	struct tc_aes_key_sched_struct sched;
+} key_cache[CONFIG_BT_MESH_CRYPTO_KEY_CACHE];
+
+static u32_t key_cache_clock;
+static K_MUTEX_DEFINE(key_cache_lock);
+#endif
+
+static int aes_key_get(struct mesh_aes *aes, const u8_t key[16])
+{
+#if defined(CONFIG_BT_HOST_CRYPTO)
+	int i, lru = 0;
+
+	k_mutex_lock(&key_cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(key_cache); i++) {
+		if (key_cache[i].used && !memcmp(key_cache[i].key, key, 16)) {
+			goto done;
+		}
+
+		if (key_cache[i].used < key_cache[lru].used) {
+			lru = i;
+		}
+	}
+
+	/* Replace the least recently used schedule */
+	i = lru;
+	if (tc_aes128_set_encrypt_key(&key_cache[i].sched, key) ==
+	    TC_CRYPTO_FAIL) {
+		key_cache[i].used = 0;
+		k_mutex_unlock(&key_cache_lock);
+		return -EINVAL;
+	}
+
+	memcpy(key_cache[i].key, key, 16);
+
+done:
+	key_cache[i].used = ++key_cache_clock;
+	aes->sched = &key_cache[i].sched;
+#else
+	aes->key = key;
+#endif
+	return 0;
+}
+
+static void aes_key_put(struct mesh_aes *aes)
+{
+#if defined(CONFIG_BT_HOST_CRYPTO)
+	k_mutex_unlock(&key_cache_lock);
+#endif
+}
+
+static int aes_encrypt(const struct mesh_aes *aes, const u8_t in[16],
+		       u8_t out[16])
+{
+#if defined(CONFIG_BT_HOST_CRYPTO)
+	if (tc_aes_encrypt(out, in, aes->sched) == TC_CRYPTO_FAIL) {
+		return -EINVAL;
+	}
+
+	return 0;
+#else
+	return bt_encrypt_be(aes->key, in, out);
+#endif
+}
+
+static int ccm_decrypt(const struct mesh_aes *aes, u8_t nonce[13],
+		       const u8_t *enc_msg, size_t msg_len,
+		       const u8_t *aad, size_t aad_len,
+		       u8_t *out_msg, size_t mic_size)
 {
 	u8_t msg[16], pmsg[16], cmic[16], cmsg[16], Xn[16], mic[16];
 	u16_t last_blk, blk_cnt;
@@ -221,7 +305,7 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 	memcpy(pmsg + 1, nonce, 13);
 	sys_put_be16(0x0000, pmsg + 14);
 
-	err = bt_encrypt_be(key, pmsg, cmic);
+	err = aes_encrypt(aes, pmsg, cmic);
 	if (err) {
 		return err;
 	}
@@ -236,7 +320,7 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 	memcpy(pmsg + 1, nonce, 13);
 	sys_put_be16(msg_len, pmsg + 14);
 
-	err = bt_encrypt_be(key, pmsg, Xn);
+	err = aes_encrypt(aes, pmsg, Xn);
 	if (err) {
 		return err;
 	}
@@ -260,7 +344,7 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 			aad_len -= 16;
 			i = 0;
 
-			err = bt_encrypt_be(key, pmsg, Xn);
+			err = aes_encrypt(aes, pmsg, Xn);
 			if (err) {
 				return err;
 			}
@@ -274,7 +358,7 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 			pmsg[i] = Xn[i];
 		}
 
-		err = bt_encrypt_be(key, pmsg, Xn);
+		err = aes_encrypt(aes, pmsg, Xn);
 		if (err) {
 			return err;
 		}
@@ -293,7 +377,7 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 			memcpy(pmsg + 1, nonce, 13);
 			sys_put_be16(j + 1, pmsg + 14);
 
-			err = bt_encrypt_be(key, pmsg, cmsg);
+			err = aes_encrypt(aes, pmsg, cmsg);
 			if (err) {
 				return err;
 			}
@@ -314,7 +398,7 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 				pmsg[i] = Xn[i] ^ 0x00;
 			}
 
-			err = bt_encrypt_be(key, pmsg, Xn);
+			err = aes_encrypt(aes, pmsg, Xn);
 			if (err) {
 				return err;
 			}
@@ -329,7 +413,7 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 			memcpy(pmsg + 1, nonce, 13);
 			sys_put_be16(j + 1, pmsg + 14);
 
-			err = bt_encrypt_be(key, pmsg, cmsg);
+			err = aes_encrypt(aes, pmsg, cmsg);
 			if (err) {
 				return err;
 			}
@@ -346,7 +430,7 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 				pmsg[i] = Xn[i] ^ msg[i];
 			}
 
-			err = bt_encrypt_be(key, pmsg, Xn);
+			err = aes_encrypt(aes, pmsg, Xn);
 			if (err) {
 				return err;
 			}
@@ -360,10 +444,31 @@ static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
 	return 0;
 }
 
-static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
-			       const u8_t *msg, size_t msg_len,
+static int bt_mesh_ccm_decrypt(const u8_t key[16], u8_t nonce[13],
+			       const u8_t *enc_msg, size_t msg_len,
 			       const u8_t *aad, size_t aad_len,
 			       u8_t *out_msg, size_t mic_size)
+{
+	struct mesh_aes aes;
+	int err;
+
+	err = aes_key_get(&aes, key);
+	if (err) {
+		return err;
+	}
+
+	err = ccm_decrypt(&aes, nonce, enc_msg, msg_len, aad, aad_len,
+			  out_msg, mic_size);
+
+	aes_key_put(&aes);
+
+	return err;
+}
+
+static int ccm_encrypt(const struct mesh_aes *aes, u8_t nonce[13],
+		       const u8_t *msg, size_t msg_len,
+		       const u8_t *aad, size_t aad_len,
+		       u8_t *out_msg, size_t mic_size)
 {
 	u8_t pmsg[16], cmic[16], cmsg[16], mic[16], Xn[16];
 	u16_t blk_cnt, last_blk;
@@ -385,7 +490,7 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 	memcpy(pmsg + 1, nonce, 13);
 	sys_put_be16(0x0000, pmsg + 14);
 
-	err = bt_encrypt_be(key, pmsg, cmic);
+	err = aes_encrypt(aes, pmsg, cmic);
 	if (err) {
 		return err;
 	}
@@ -400,7 +505,7 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 	memcpy(pmsg + 1, nonce, 13);
 	sys_put_be16(msg_len, pmsg + 14);
 
-	err = bt_encrypt_be(key, pmsg, Xn);
+	err = aes_encrypt(aes, pmsg, Xn);
 	if (err) {
 		return err;
 	}
@@ -424,7 +529,7 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 			aad_len -= 16;
 			i = 0;
 
-			err = bt_encrypt_be(key, pmsg, Xn);
+			err = aes_encrypt(aes, pmsg, Xn);
 			if (err) {
 				return err;
 			}
@@ -438,7 +543,7 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 			pmsg[i] = Xn[i];
 		}
 
-		err = bt_encrypt_be(key, pmsg, Xn);
+		err = aes_encrypt(aes, pmsg, Xn);
 		if (err) {
 			return err;
 		}
@@ -460,7 +565,7 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 				pmsg[i] = Xn[i] ^ 0x00;
 			}
 
-			err = bt_encrypt_be(key, pmsg, Xn);
+			err = aes_encrypt(aes, pmsg, Xn);
 			if (err) {
 				return err;
 			}
@@ -475,7 +580,7 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 			memcpy(pmsg + 1, nonce, 13);
 			sys_put_be16(j + 1, pmsg + 14);
 
-			err = bt_encrypt_be(key, pmsg, cmsg);
+			err = aes_encrypt(aes, pmsg, cmsg);
 			if (err) {
 				return err;
 			}
@@ -491,7 +596,7 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 				pmsg[i] = Xn[i] ^ msg[(j * 16) + i];
 			}
 
-			err = bt_encrypt_be(key, pmsg, Xn);
+			err = aes_encrypt(aes, pmsg, Xn);
 			if (err) {
 				return err;
 			}
@@ -501,7 +606,7 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 			memcpy(pmsg + 1, nonce, 13);
 			sys_put_be16(j + 1, pmsg + 14);
 
-			err = bt_encrypt_be(key, pmsg, cmsg);
+			err = aes_encrypt(aes, pmsg, cmsg);
 			if (err) {
 				return err;
 			}
@@ -520,6 +625,27 @@ static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
 	return 0;
 }
 
+static int bt_mesh_ccm_encrypt(const u8_t key[16], u8_t nonce[13],
+			       const u8_t *msg, size_t msg_len,
+			       const u8_t *aad, size_t aad_len,
+			       u8_t *out_msg, size_t mic_size)
+{
+	struct mesh_aes aes;
+	int err;
+
+	err = aes_key_get(&aes, key);
+	if (err) {
+		return err;
+	}
+
+	err = ccm_encrypt(&aes, nonce, msg, msg_len, aad, aad_len,
+			  out_msg, mic_size);
+
+	aes_key_put(&aes);
+
+	return err;
+}
+
 #if defined(CONFIG_BT_MESH_PROXY)
 static void create_proxy_nonce(u8_t nonce[13], const u8_t *pdu,
 			       u32_t iv_index)
@@ -578,6 +704,7 @@ int bt_mesh_net_obfuscate(u8_t *pdu, u32_t iv_index,
 			  const u8_t privacy_key[16])
 {
 	u8_t priv_rand[16] = { 0x00, 0x00, 0x00, 0x00, 0x00, };
+	struct mesh_aes aes;
 	u8_t tmp[16];
 	int err, i;
 
@@ -588,7 +715,13 @@ int bt_mesh_net_obfuscate(u8_t *pdu, u32_t iv_index,
 
 	BT_DBG("PrivacyRandom %s", bt_hex(priv_rand, 16));
 
-	err = bt_encrypt_be(privacy_key, priv_rand, tmp);
+	err = aes_key_get(&aes, privacy_key);
+	if (err) {
+		return err;
+	}
+
+	err = aes_encrypt(&aes, priv_rand, tmp);
+	aes_key_put(&aes);
 	if (err) {
 		return err;
 	}
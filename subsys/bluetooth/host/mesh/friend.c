@@ -60,6 +60,9 @@ NET_BUF_POOL_FIXED_DEFINE(friend_buf_pool, FRIEND_BUF_COUNT,
 static struct friend_adv {
 	struct bt_mesh_adv adv;
 	u64_t seq_auth;
+	u32_t iv_index;
+	u8_t  master_cred:1,
+	      encrypted:1;
 } adv_pool[FRIEND_BUF_COUNT];
 
 static struct bt_mesh_adv *adv_alloc(int id)
@@ -67,10 +70,38 @@ static struct bt_mesh_adv *adv_alloc(int id)
 	return &adv_pool[id].adv;
 }
 
-static void discard_buffer(void)
+static bool discard_buffer(struct bt_mesh_friend *frnd)
 {
-	struct bt_mesh_friend *frnd = &bt_mesh.frnd[0];
 	struct net_buf *buf;
+
+	buf = net_buf_slist_get(&frnd->queue);
+	if (!buf) {
+		return false;
+	}
+
+	frnd->queue_size--;
+	BT_WARN("Discarding buffer %p for LPN 0x%04x", buf, frnd->lpn);
+	net_buf_unref(buf);
+
+	return true;
+}
+
+/* Each LPN has its own Friend Queue budget, so that an LPN receiving a
+ * lot of traffic only ever pushes out its own oldest messages.
+ */
+static void friend_queue_prepare_space(struct bt_mesh_friend *frnd,
+				       u32_t count)
+{
+	while (frnd->queue_size + count > CONFIG_BT_MESH_FRIEND_QUEUE_SIZE) {
+		if (!discard_buffer(frnd)) {
+			break;
+		}
+	}
+}
+
+static void discard_largest_queue(void)
+{
+	struct bt_mesh_friend *frnd = &bt_mesh.frnd[0];
 	int i;
 
 	/* Find the Friend context with the most queued buffers */
@@ -80,10 +111,9 @@ static void discard_buffer(void)
 		}
 	}
 
-	buf = net_buf_slist_get(&frnd->queue);
-	__ASSERT_NO_MSG(buf != NULL);
-	BT_WARN("Discarding buffer %p for LPN 0x%04x", buf, frnd->lpn);
-	net_buf_unref(buf);
+	if (!discard_buffer(frnd)) {
+		__ASSERT_NO_MSG(0);
+	}
 }
 
 static struct net_buf *friend_buf_alloc(u16_t src)
@@ -96,13 +126,18 @@ static struct net_buf *friend_buf_alloc(u16_t src)
 		buf = bt_mesh_adv_create_from_pool(&friend_buf_pool, adv_alloc,
 						   BT_MESH_ADV_DATA,
 						   FRIEND_XMIT, K_NO_WAIT);
+		/* The pool only runs out when incomplete segmented
+		 * messages, which are outside of the queue budgets, hold
+		 * on to buffers.
+		 */
 		if (!buf) {
-			discard_buffer();
+			discard_largest_queue();
 		}
 	} while (!buf);
 
 	BT_MESH_ADV(buf)->addr = src;
 	FRIEND_ADV(buf)->seq_auth = TRANS_SEQ_AUTH_NVAL;
+	FRIEND_ADV(buf)->encrypted = 0;
 
 	BT_DBG("allocated buf %p", buf);
 
@@ -312,33 +347,25 @@ static void friend_sub_rem(struct bt_mesh_friend *frnd, u16_t addr)
 	}
 }
 
-static struct net_buf *create_friend_pdu(struct bt_mesh_friend *frnd,
-					 struct friend_pdu_info *info,
+/* The PDU is stored unencrypted, encrypt_friend_pdu() takes care of
+ * the NID, encryption and obfuscation once the PDU gets sent.
+ */
+static struct net_buf *create_friend_pdu(struct friend_pdu_info *info,
 					 struct net_buf_simple *sdu)
 {
-	struct bt_mesh_subnet *sub;
-	const u8_t *enc, *priv;
+	struct friend_adv *adv;
 	struct net_buf *buf;
-	u8_t nid;
-
-	sub = bt_mesh_subnet_get(frnd->net_idx);
-	__ASSERT_NO_MSG(sub != NULL);
 
 	buf = friend_buf_alloc(info->src);
 
+	adv = FRIEND_ADV(buf);
+	adv->iv_index = info->iv_index;
+
 	/* Friend Offer needs master security credentials */
-	if (info->ctl && TRANS_CTL_OP(sdu->data) == TRANS_CTL_OP_FRIEND_OFFER) {
-		enc = sub->keys[sub->kr_flag].enc;
-		priv = sub->keys[sub->kr_flag].privacy;
-		nid = sub->keys[sub->kr_flag].nid;
-	} else {
-		if (friend_cred_get(sub, frnd->lpn, &nid, &enc, &priv)) {
-			BT_ERR("friend_cred_get failed");
-			goto failed;
-		}
-	}
+	adv->master_cred = (info->ctl && TRANS_CTL_OP(sdu->data) ==
+			    TRANS_CTL_OP_FRIEND_OFFER);
 
-	net_buf_add_u8(buf, (nid | (info->iv_index & 1) << 7));
+	net_buf_add_u8(buf, (info->iv_index & 1) << 7);
 
 	if (info->ctl) {
 		net_buf_add_u8(buf, info->ttl | 0x80);
@@ -353,25 +380,58 @@ static struct net_buf *create_friend_pdu(struct bt_mesh_friend *frnd,
 
 	net_buf_add_mem(buf, sdu->data, sdu->len);
 
+	return buf;
+}
+
+static int encrypt_friend_pdu(struct bt_mesh_friend *frnd,
+			      struct net_buf *buf)
+{
+	struct friend_adv *adv = FRIEND_ADV(buf);
+	struct bt_mesh_subnet *sub;
+	const u8_t *enc, *priv;
+	u8_t nid;
+	int err;
+
+	if (adv->encrypted) {
+		return 0;
+	}
+
+	sub = bt_mesh_subnet_get(frnd->net_idx);
+	__ASSERT_NO_MSG(sub != NULL);
+
+	if (adv->master_cred) {
+		enc = sub->keys[sub->kr_flag].enc;
+		priv = sub->keys[sub->kr_flag].privacy;
+		nid = sub->keys[sub->kr_flag].nid;
+	} else {
+		err = friend_cred_get(sub, frnd->lpn, &nid, &enc, &priv);
+		if (err) {
+			BT_ERR("friend_cred_get failed");
+			return err;
+		}
+	}
+
+	buf->data[0] |= nid;
+
 	/* We re-encrypt and obfuscate using the received IVI rather than
 	 * the normal TX IVI (which may be different) since the transport
 	 * layer nonce includes the IVI.
 	 */
-	if (bt_mesh_net_encrypt(enc, &buf->b, info->iv_index, false)) {
+	err = bt_mesh_net_encrypt(enc, &buf->b, adv->iv_index, false);
+	if (err) {
 		BT_ERR("Re-encrypting failed");
-		goto failed;
+		return err;
 	}
 
-	if (bt_mesh_net_obfuscate(buf->data, info->iv_index, priv)) {
+	err = bt_mesh_net_obfuscate(buf->data, adv->iv_index, priv);
+	if (err) {
 		BT_ERR("Re-obfuscating failed");
-		goto failed;
+		return err;
 	}
 
-	return buf;
+	adv->encrypted = 1;
 
-failed:
-	net_buf_unref(buf);
-	return NULL;
+	return 0;
 }
 
 static struct net_buf *encode_friend_ctl(struct bt_mesh_friend *frnd,
@@ -398,7 +458,7 @@ static struct net_buf *encode_friend_ctl(struct bt_mesh_friend *frnd,
 
 	info.iv_index = BT_MESH_NET_IVI_TX;
 
-	return create_friend_pdu(frnd, &info, sdu);
+	return create_friend_pdu(&info, sdu);
 }
 
 static struct net_buf *encode_update(struct bt_mesh_friend *frnd, u8_t md)
@@ -528,6 +588,8 @@ int bt_mesh_friend_sub_rem(struct bt_mesh_net_rx *rx,
 
 static void enqueue_buf(struct bt_mesh_friend *frnd, struct net_buf *buf)
 {
+	friend_queue_prepare_space(frnd, 1);
+
 	net_buf_slist_put(&frnd->queue, buf);
 	frnd->queue_size++;
 }
@@ -940,10 +1002,18 @@ static void enqueue_friend_pdu(struct bt_mesh_friend *frnd,
 	net_buf_slist_put(&seg->queue, buf);
 
 	if (type == BT_MESH_FRIEND_PDU_COMPLETE) {
+		u32_t count = 0;
+
 		if (frnd->sec_update) {
 			enqueue_update(frnd, 1);
 		}
 
+		SYS_SLIST_FOR_EACH_CONTAINER(&seg->queue, buf, node) {
+			count++;
+		}
+
+		friend_queue_prepare_space(frnd, count);
+
 		/* Only acks should have a valid SeqAuth in the Friend queue
 		 * (otherwise we can't easily detect them there), so clear
 		 * the SeqAuth information from the segments before merging.
@@ -1001,6 +1071,7 @@ static void friend_timeout(struct k_work *work)
 		.start = buf_send_start,
 		.end = buf_send_end,
 	};
+	int err;
 
 	__ASSERT_NO_MSG(frnd->pending_buf == 0);
 
@@ -1032,6 +1103,16 @@ static void friend_timeout(struct k_work *work)
 
 send_last:
 	frnd->pending_req = 0;
+
+	err = encrypt_friend_pdu(frnd, frnd->last);
+	if (err) {
+		BT_ERR("Dropping buf %p for LPN 0x%04x", frnd->last, frnd->lpn);
+		net_buf_unref(frnd->last);
+		frnd->last = NULL;
+		buf_send_end(err, frnd);
+		return;
+	}
+
 	frnd->pending_buf = 1;
 	bt_mesh_adv_send(frnd->last, &buf_sent_cb, frnd);
 }
@@ -1116,7 +1197,7 @@ static void friend_lpn_enqueue_rx(struct bt_mesh_friend *frnd,
 
 	info.iv_index = BT_MESH_NET_IVI_RX(rx);
 
-	buf = create_friend_pdu(frnd, &info, sbuf);
+	buf = create_friend_pdu(&info, sbuf);
 	if (!buf) {
 		BT_ERR("Failed to encode Friend buffer");
 		return;
@@ -1160,7 +1241,7 @@ static void friend_lpn_enqueue_tx(struct bt_mesh_friend *frnd,
 
 	info.iv_index = BT_MESH_NET_IVI_TX;
 
-	buf = create_friend_pdu(frnd, &info, sbuf);
+	buf = create_friend_pdu(&info, sbuf);
 	if (!buf) {
 		BT_ERR("Failed to encode Friend buffer");
 		return;
@@ -69,8 +69,19 @@
 static struct friend_cred friend_cred[FRIEND_CRED_COUNT];
 #endif
 
+/* Received message hashes in arrival order, the oldest one is evicted
+ * first. msg_cache_idx is an open addressing (linear probing) hash set
+ * over them holding positions in msg_cache, kept at most half full.
+ */
+#define MSG_CACHE_BUCKETS (2 * CONFIG_BT_MESH_MSG_CACHE_SIZE)
+#define MSG_CACHE_EMPTY   0xffff
+
 static u64_t msg_cache[CONFIG_BT_MESH_MSG_CACHE_SIZE];
 static u16_t msg_cache_next;
+static u16_t msg_cache_count;
+static u16_t msg_cache_idx[MSG_CACHE_BUCKETS] = {
+	[0 ... (MSG_CACHE_BUCKETS - 1)] = MSG_CACHE_EMPTY,
+};
 
 /* Singleton network context (the implementation only supports one) */
 struct bt_mesh_net bt_mesh = {
@@ -123,21 +134,101 @@ static u64_t msg_hash(struct bt_mesh_net_rx *rx, struct net_buf_simple *pdu)
 	return (u64_t)hash1 << 32 | (u64_t)hash2;
 }
 
+static u32_t msg_cache_bucket(u64_t hash)
+{
+	u32_t val = (u32_t)hash ^ (u32_t)(hash >> 32);
+
+	/* Spread consecutive sequence numbers over the table */
+	return (val * 2654435761U) % MSG_CACHE_BUCKETS;
+}
+
+static int msg_cache_find(u64_t hash)
+{
+	u32_t i = msg_cache_bucket(hash);
+
+	while (msg_cache_idx[i] != MSG_CACHE_EMPTY) {
+		if (msg_cache[msg_cache_idx[i]] == hash) {
+			return i;
+		}
+
+		i = (i + 1) % MSG_CACHE_BUCKETS;
+	}
+
+	return -1;
+}
+
+static void msg_cache_remove(u32_t i)
+{
+	u32_t j = i, home;
+
+	msg_cache_idx[i] = MSG_CACHE_EMPTY;
+
+	/* Shift back the following entries of the probe sequence so that
+	 * lookups do not stop early at the freed bucket.
+	 */
+	for (;;) {
+		j = (j + 1) % MSG_CACHE_BUCKETS;
+		if (msg_cache_idx[j] == MSG_CACHE_EMPTY) {
+			return;
+		}
+
+		home = msg_cache_bucket(msg_cache[msg_cache_idx[j]]);
+
+		/* Keep the entry if its home bucket is within (i, j] */
+		if (i <= j) {
+			if (i < home && home <= j) {
+				continue;
+			}
+		} else if (i < home || home <= j) {
+			continue;
+		}
+
+		msg_cache_idx[i] = msg_cache_idx[j];
+		msg_cache_idx[j] = MSG_CACHE_EMPTY;
+		i = j;
+	}
+}
+
+static void msg_cache_add(u64_t hash)
+{
+	u32_t i;
+
+	/* Evict the oldest entry once the cache is full */
+	if (msg_cache_count == ARRAY_SIZE(msg_cache)) {
+		msg_cache_remove(msg_cache_find(msg_cache[msg_cache_next]));
+	} else {
+		msg_cache_count++;
+	}
+
+	msg_cache[msg_cache_next] = hash;
+
+	i = msg_cache_bucket(hash);
+	while (msg_cache_idx[i] != MSG_CACHE_EMPTY) {
+		i = (i + 1) % MSG_CACHE_BUCKETS;
+	}
+
+	msg_cache_idx[i] = msg_cache_next;
+
+	msg_cache_next = (msg_cache_next + 1) % ARRAY_SIZE(msg_cache);
+}
+
+static void msg_cache_reset(void)
+{
+	memset(msg_cache_idx, 0xff, sizeof(msg_cache_idx));
+	msg_cache_next = 0;
+	msg_cache_count = 0;
+}
+
 static bool msg_cache_match(struct bt_mesh_net_rx *rx,
 			    struct net_buf_simple *pdu)
 {
 	u64_t hash = msg_hash(rx, pdu);
-	u16_t i;
 
-	for (i = 0; i < ARRAY_SIZE(msg_cache); i++) {
-		if (msg_cache[i] == hash) {
-			return true;
-		}
+	if (msg_cache_find(hash) >= 0) {
+		return true;
 	}
 
-	/* Add to the cache */
-	msg_cache[msg_cache_next++] = hash;
-	msg_cache_next %= ARRAY_SIZE(msg_cache);
+	msg_cache_add(hash);
 
 	return false;
 }
@@ -451,8 +542,7 @@ int bt_mesh_net_create(u16_t idx, u8_t flags, const u8_t key[16],
 		return -EALREADY;
 	}
 
-	memset(msg_cache, 0, sizeof(msg_cache));
-	msg_cache_next = 0;
+	msg_cache_reset();
 
 	sub = &bt_mesh.sub[0];
 
@@ -559,9 +649,81 @@ bool bt_mesh_kr_update(struct bt_mesh_subnet *sub, u8_t new_kr, bool new_key)
 	return false;
 }
 
+/* The RPL is kept sorted by source address, with all the free entries
+ * at the end, so that a source is found with a binary search. Return
+ * whether src was found, and its position or where it would be inserted.
+ */
+static bool rpl_search(u16_t src, int *pos)
+{
+	int lo = 0, hi = ARRAY_SIZE(bt_mesh.rpl);
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		u16_t mid_src = bt_mesh.rpl[mid].src;
+
+		if (mid_src == src) {
+			*pos = mid;
+			return true;
+		}
+
+		if (!mid_src || mid_src > src) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	*pos = lo;
+
+	return false;
+}
+
+struct bt_mesh_rpl *bt_mesh_rpl_find(u16_t src)
+{
+	int pos;
+
+	if (!rpl_search(src, &pos)) {
+		return NULL;
+	}
+
+	return &bt_mesh.rpl[pos];
+}
+
+struct bt_mesh_rpl *bt_mesh_rpl_alloc(u16_t src)
+{
+	struct bt_mesh_rpl *rpl;
+	int pos;
+
+	if (rpl_search(src, &pos)) {
+		return &bt_mesh.rpl[pos];
+	}
+
+	/* Full */
+	if (bt_mesh.rpl[ARRAY_SIZE(bt_mesh.rpl) - 1].src) {
+		return NULL;
+	}
+
+	rpl = &bt_mesh.rpl[pos];
+	memmove(rpl + 1, rpl,
+		(ARRAY_SIZE(bt_mesh.rpl) - pos - 1) * sizeof(*rpl));
+	memset(rpl, 0, sizeof(*rpl));
+	rpl->src = src;
+
+	return rpl;
+}
+
+void bt_mesh_rpl_remove(struct bt_mesh_rpl *rpl)
+{
+	int pos = rpl - bt_mesh.rpl;
+
+	memmove(rpl, rpl + 1,
+		(ARRAY_SIZE(bt_mesh.rpl) - pos - 1) * sizeof(*rpl));
+	memset(&bt_mesh.rpl[ARRAY_SIZE(bt_mesh.rpl) - 1], 0, sizeof(*rpl));
+}
+
 void bt_mesh_rpl_reset(void)
 {
-	int i;
+	int i, used = 0;
 
 	/* Discard "old old" IV Index entries from RPL and flag
 	 * any other ones (which are valid) as old.
@@ -569,14 +731,26 @@ void bt_mesh_rpl_reset(void)
 	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
 		struct bt_mesh_rpl *rpl = &bt_mesh.rpl[i];
 
-		if (rpl->src) {
-			if (rpl->old_iv) {
-				memset(rpl, 0, sizeof(*rpl));
-			} else {
-				rpl->old_iv = true;
-			}
+		if (!rpl->src) {
+			break;
+		}
+
+		if (rpl->old_iv) {
+			continue;
 		}
+
+		rpl->old_iv = true;
+
+		/* Keep the remaining entries sorted and packed */
+		if (i != used) {
+			bt_mesh.rpl[used] = *rpl;
+		}
+
+		used++;
 	}
+
+	memset(&bt_mesh.rpl[used], 0,
+	       (ARRAY_SIZE(bt_mesh.rpl) - used) * sizeof(bt_mesh.rpl[0]));
 }
 
 #if defined(CONFIG_BT_MESH_IV_UPDATE_TEST)
@@ -1224,7 +1398,11 @@ static void bt_mesh_net_relay(struct net_buf_simple *sbuf,
 	}
 
 	if (relay_to_adv(rx->net_if)) {
-		bt_mesh_adv_send(buf, NULL, NULL);
+		if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
+			bt_mesh_adv_send(buf, NULL, NULL);
+		} else {
+			bt_mesh_adv_relay(buf, rx->ctx.recv_ttl - 1);
+		}
 	}
 
 done:
@@ -299,6 +299,12 @@ void bt_mesh_net_revoke_keys(struct bt_mesh_subnet *sub);
 
 int bt_mesh_net_beacon_update(struct bt_mesh_subnet *sub);
 
+struct bt_mesh_rpl *bt_mesh_rpl_find(u16_t src);
+
+struct bt_mesh_rpl *bt_mesh_rpl_alloc(u16_t src);
+
+void bt_mesh_rpl_remove(struct bt_mesh_rpl *rpl);
+
 void bt_mesh_rpl_reset(void);
 
 bool bt_mesh_net_iv_update(u32_t iv_index, bool iv_update);
@@ -47,6 +47,9 @@ static struct key_update {
 
 static struct k_delayed_work pending_store;
 
+/* Number of RPL entries waiting to be stored */
+static u16_t rpl_pending;
+
 /* Mesh network storage information */
 struct net_val {
 	u16_t primary_addr;
@@ -235,33 +238,6 @@ static int seq_set(int argc, char **argv, char *val)
 	return 0;
 }
 
-static struct bt_mesh_rpl *rpl_find(u16_t src)
-{
-	int i;
-
-	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
-		if (bt_mesh.rpl[i].src == src) {
-			return &bt_mesh.rpl[i];
-		}
-	}
-
-	return NULL;
-}
-
-static struct bt_mesh_rpl *rpl_alloc(u16_t src)
-{
-	int i;
-
-	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
-		if (!bt_mesh.rpl[i].src) {
-			bt_mesh.rpl[i].src = src;
-			return &bt_mesh.rpl[i];
-		}
-	}
-
-	return NULL;
-}
-
 static int rpl_set(int argc, char **argv, char *val)
 {
 	struct bt_mesh_rpl *entry;
@@ -277,11 +253,11 @@ static int rpl_set(int argc, char **argv, char *val)
 	BT_DBG("argv[0] %s val %s", argv[0], val ? val : "(null)");
 
 	src = strtol(argv[0], NULL, 16);
-	entry = rpl_find(src);
+	entry = bt_mesh_rpl_find(src);
 
 	if (!val) {
 		if (entry) {
-			memset(entry, 0, sizeof(*entry));
+			bt_mesh_rpl_remove(entry);
 		} else {
 			BT_WARN("Unable to find RPL entry for 0x%04x", src);
 		}
@@ -290,7 +266,7 @@ static int rpl_set(int argc, char **argv, char *val)
 	}
 
 	if (!entry) {
-		entry = rpl_alloc(src);
+		entry = bt_mesh_rpl_alloc(src);
 		if (!entry) {
 			BT_ERR("Unable to allocate RPL entry for 0x%04x", src);
 			return -ENOMEM;
@@ -841,7 +817,7 @@ BT_SETTINGS_DEFINE(mesh, mesh_set, mesh_commit, NULL);
 
 static void schedule_store(int flag)
 {
-	s32_t timeout;
+	s32_t timeout, remaining;
 
 	atomic_set_bit(bt_mesh.flags, flag);
 
@@ -849,6 +825,9 @@ static void schedule_store(int flag)
 	    atomic_test_bit(bt_mesh.flags, BT_MESH_IV_PENDING) ||
 	    atomic_test_bit(bt_mesh.flags, BT_MESH_SEQ_PENDING)) {
 		timeout = K_NO_WAIT;
+	} else if (CONFIG_BT_MESH_RPL_STORE_COUNT &&
+		   rpl_pending >= CONFIG_BT_MESH_RPL_STORE_COUNT) {
+		timeout = K_NO_WAIT;
 	} else if (atomic_test_bit(bt_mesh.flags, BT_MESH_RPL_PENDING) &&
 		   (CONFIG_BT_MESH_RPL_STORE_TIMEOUT <
 		    CONFIG_BT_MESH_STORE_TIMEOUT)) {
@@ -857,6 +836,15 @@ static void schedule_store(int flag)
 		timeout = K_SECONDS(CONFIG_BT_MESH_STORE_TIMEOUT);
 	}
 
+	/* Don't postpone a store which is already due sooner, or frequent
+	 * changes would keep the pending ones from ever being stored.
+	 */
+	remaining = k_delayed_work_remaining_get(&pending_store);
+	if (remaining && remaining <= timeout) {
+		BT_DBG("Store already due in %d ms", remaining);
+		return;
+	}
+
 	BT_DBG("Waiting %d seconds", timeout / MSEC_PER_SEC);
 
 	k_delayed_work_submit(&pending_store, timeout);
@@ -1005,6 +993,8 @@ static void clear_rpl(void)
 
 		memset(rpl, 0, sizeof(*rpl));
 	}
+
+	rpl_pending = 0;
 }
 
 static void store_pending_rpl(void)
@@ -1021,6 +1011,8 @@ static void store_pending_rpl(void)
 			store_rpl(rpl);
 		}
 	}
+
+	rpl_pending = 0;
 }
 
 static void store_pending_hb_pub(void)
@@ -1394,7 +1386,11 @@ static void store_pending(struct k_work *work)
 
 void bt_mesh_store_rpl(struct bt_mesh_rpl *entry)
 {
-	entry->store = true;
+	if (!entry->store) {
+		entry->store = true;
+		rpl_pending++;
+	}
+
 	schedule_store(BT_MESH_RPL_PENDING);
 }
 
@@ -526,52 +526,46 @@ int bt_mesh_trans_resend(struct bt_mesh_net_tx *tx, struct net_buf_simple *msg,
 
 static bool is_replay(struct bt_mesh_net_rx *rx)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(bt_mesh.rpl); i++) {
-		struct bt_mesh_rpl *rpl = &bt_mesh.rpl[i];
+	rpl = bt_mesh_rpl_find(rx->ctx.addr);
+	if (!rpl) {
+		rpl = bt_mesh_rpl_alloc(rx->ctx.addr);
+		if (!rpl) {
+			BT_ERR("RPL is full!");
+			return true;
+		}
 
-		/* Empty slot */
-		if (!rpl->src) {
-			rpl->src = rx->ctx.addr;
-			rpl->seq = rx->seq;
-			rpl->old_iv = rx->old_iv;
+		rpl->seq = rx->seq;
+		rpl->old_iv = rx->old_iv;
 
-			if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-				bt_mesh_store_rpl(rpl);
-			}
-
-			return false;
+		if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
+			bt_mesh_store_rpl(rpl);
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+		return false;
+	}
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				rpl->seq = rx->seq;
-				rpl->old_iv = rx->old_iv;
+	if (rx->old_iv && !rpl->old_iv) {
+		return true;
+	}
 
-				if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
-					bt_mesh_store_rpl(rpl);
-				}
+	if ((!rx->old_iv && rpl->old_iv) || rpl->seq < rx->seq) {
+		rpl->seq = rx->seq;
+		rpl->old_iv = rx->old_iv;
 
-				return false;
-			} else {
-				return true;
-			}
+		if (IS_ENABLED(CONFIG_BT_SETTINGS)) {
+			bt_mesh_store_rpl(rpl);
 		}
+
+		return false;
 	}
 
-	BT_ERR("RPL is full!");
 	return true;
 }
 
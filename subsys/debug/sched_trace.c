@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Scheduler tracing
+ *
+ * Each CPU records into its own ring of CONFIG_SCHED_TRACE_BUFFER_EVENTS
+ * slots. A slot is reserved by moving the head of the ring forward with a
+ * compare-and-swap, which makes recording safe against interrupts and other
+ * CPUs without any lock, then committed by writing its sequence number once
+ * filled. The single consumer only reads committed slots, in order. When a
+ * ring is full, new events are dropped and counted.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <atomic.h>
+#include <debug/sched_trace.h>
+
+#if defined(CONFIG_SCHED_TRACE_STREAM_UART)
+#include <device.h>
+#include <uart.h>
+#elif defined(CONFIG_SCHED_TRACE_STREAM_RTT)
+#include <rtt/SEGGER_RTT.h>
+#endif
+
+#define NUM_SLOTS CONFIG_SCHED_TRACE_BUFFER_EVENTS
+#define SLOT_MASK (NUM_SLOTS - 1)
+
+BUILD_ASSERT_MSG((NUM_SLOTS & SLOT_MASK) == 0,
+		 "CONFIG_SCHED_TRACE_BUFFER_EVENTS must be a power of 2");
+
+struct trace_slot {
+	/* sequence number of the event + 1, once committed */
+	atomic_t seq;
+	struct sched_trace_event event;
+};
+
+struct trace_ring {
+	atomic_t head;
+	atomic_t tail;
+	atomic_t dropped;
+	struct trace_slot slots[NUM_SLOTS];
+};
+
+static struct trace_ring trace_rings[CONFIG_MP_NUM_CPUS];
+static unsigned int next_drained_cpu;
+
+void _sched_trace_event(u16_t id, u32_t arg, u16_t data)
+{
+#ifdef CONFIG_SMP
+	struct trace_ring *ring = &trace_rings[_arch_curr_cpu()->id];
+#else
+	struct trace_ring *ring = &trace_rings[0];
+#endif
+	struct trace_slot *slot;
+	atomic_val_t head;
+
+	do {
+		head = atomic_get(&ring->head);
+
+		if ((u32_t)(head - atomic_get(&ring->tail)) >= NUM_SLOTS) {
+			atomic_inc(&ring->dropped);
+			return;
+		}
+	} while (!atomic_cas(&ring->head, head, head + 1));
+
+	slot = &ring->slots[head & SLOT_MASK];
+
+	slot->event.timestamp = k_cycle_get_32();
+	slot->event.arg = arg;
+	slot->event.id = id;
+	slot->event.data = data;
+
+	atomic_set(&slot->seq, head + 1);
+}
+
+void _sched_trace_isr_enter(void)
+{
+	_sched_trace_event(SCHED_TRACE_ISR_ENTER, 0, 0);
+}
+
+void _sched_trace_isr_exit(void)
+{
+	_sched_trace_event(SCHED_TRACE_ISR_EXIT, 0, 0);
+}
+
+size_t sched_trace_drain(void *buf, size_t len)
+{
+	struct sched_trace_packet_header *hdr = buf;
+	struct sched_trace_event *events = (void *)(hdr + 1);
+	size_t max = (len - sizeof(*hdr)) / sizeof(*events);
+	int i;
+
+	__ASSERT(len >= sizeof(*hdr) + sizeof(*events), "buffer too small");
+
+	if (max > 0xffff) {
+		max = 0xffff;
+	}
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		unsigned int cpu = next_drained_cpu;
+		struct trace_ring *ring = &trace_rings[cpu];
+		atomic_val_t tail = atomic_get(&ring->tail);
+		size_t count = 0;
+
+		next_drained_cpu = (cpu + 1) % CONFIG_MP_NUM_CPUS;
+
+		while (count < max) {
+			struct trace_slot *slot = &ring->slots[tail & SLOT_MASK];
+
+			if (atomic_get(&slot->seq) != tail + 1) {
+				break;
+			}
+
+			events[count++] = slot->event;
+			tail++;
+		}
+
+		if (!count && !atomic_get(&ring->dropped)) {
+			continue;
+		}
+
+		/* free the slots only once copied */
+		atomic_set(&ring->tail, tail);
+
+		hdr->magic = SCHED_TRACE_PACKET_MAGIC;
+		hdr->cpu = cpu;
+		hdr->count = count;
+		hdr->dropped = atomic_clear(&ring->dropped);
+
+		return sizeof(*hdr) + count * sizeof(*events);
+	}
+
+	return 0;
+}
+
+#if defined(CONFIG_SCHED_TRACE_STREAM_UART) || \
+	defined(CONFIG_SCHED_TRACE_STREAM_RTT)
+
+#define PACKET_EVENTS 32
+
+static u32_t packet[(sizeof(struct sched_trace_packet_header) +
+		     PACKET_EVENTS * sizeof(struct sched_trace_event)) /
+		    sizeof(u32_t)];
+
+#ifdef CONFIG_SCHED_TRACE_STREAM_RTT
+static u8_t rtt_buf[CONFIG_SCHED_TRACE_RTT_BUFFER_SIZE];
+#endif
+
+static void sched_trace_stream(void *p1, void *p2, void *p3)
+{
+	size_t len;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+#if defined(CONFIG_SCHED_TRACE_STREAM_UART)
+	struct device *dev =
+		device_get_binding(CONFIG_SCHED_TRACE_UART_ON_DEV_NAME);
+
+	if (!dev) {
+		return;
+	}
+#else
+	SEGGER_RTT_ConfigUpBuffer(CONFIG_SCHED_TRACE_RTT_CHANNEL,
+				  "sched_trace", rtt_buf, sizeof(rtt_buf),
+				  SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+#endif
+
+	while (1) {
+		while ((len = sched_trace_drain(packet, sizeof(packet)))) {
+#if defined(CONFIG_SCHED_TRACE_STREAM_UART)
+			u8_t *p = (u8_t *)packet;
+
+			while (len--) {
+				uart_poll_out(dev, *p++);
+			}
+#else
+			SEGGER_RTT_Write(CONFIG_SCHED_TRACE_RTT_CHANNEL,
+					 packet, len);
+#endif
+		}
+
+		k_sleep(CONFIG_SCHED_TRACE_STREAM_PERIOD);
+	}
+}
+
+K_THREAD_DEFINE(_sched_trace_stream_thread,
+		CONFIG_SCHED_TRACE_STREAM_STACK_SIZE, sched_trace_stream,
+		NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0,
+		K_NO_WAIT);
+
+#endif /* CONFIG_SCHED_TRACE_STREAM_UART || CONFIG_SCHED_TRACE_STREAM_RTT */
@@ -0,0 +1,265 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#define SYS_LOG_DOMAIN "fota/delta"
+#define SYS_LOG_LEVEL CONFIG_SYS_LOG_IMG_MANAGER_LEVEL
+#include <logging/sys_log.h>
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <flash.h>
+#include <board.h>
+#include <misc/byteorder.h>
+#include <dfu/delta_img.h>
+
+/* bytes of the old image patched per flash read */
+#define DELTA_IMG_CHUNK 32
+
+enum {
+	DELTA_IMG_HDR,
+	DELTA_IMG_CTRL,
+	DELTA_IMG_DIFF,
+	DELTA_IMG_EXTRA,
+	DELTA_IMG_DONE,
+	DELTA_IMG_ERROR,
+};
+
+/* collect a header or record control of len bytes */
+static bool delta_img_collect(struct delta_img_context *ctx,
+			      const u8_t **data, size_t *len, size_t need)
+{
+	size_t n = min(*len, need - ctx->hdr_len);
+
+	memcpy(ctx->hdr + ctx->hdr_len, *data, n);
+	ctx->hdr_len += n;
+	*data += n;
+	*len -= n;
+
+	if (ctx->hdr_len < need) {
+		return false;
+	}
+
+	ctx->hdr_len = 0;
+	return true;
+}
+
+static int delta_img_ctrl(struct delta_img_context *ctx)
+{
+	ctx->diff_left = sys_get_le32(&ctx->hdr[0]);
+	ctx->extra_left = sys_get_le32(&ctx->hdr[4]);
+	ctx->adjust = (s32_t)sys_get_le32(&ctx->hdr[8]);
+
+	if (ctx->diff_left > ctx->img_size - ctx->out_bytes ||
+	    ctx->extra_left > ctx->img_size - ctx->out_bytes -
+			      ctx->diff_left) {
+		SYS_LOG_ERR("record past the end of the image");
+		return -EINVAL;
+	}
+
+	ctx->state = DELTA_IMG_DIFF;
+	return 0;
+}
+
+/* patch n bytes of the old image with data, or copy them if data is NULL */
+static int delta_img_patch(struct delta_img_context *ctx, const u8_t *data,
+			   size_t n)
+{
+	u8_t buf[DELTA_IMG_CHUNK];
+	size_t i;
+	int rc;
+
+	if (ctx->src_off < 0 ||
+	    ctx->src_off + n > FLASH_AREA_IMAGE_0_SIZE) {
+		SYS_LOG_ERR("source offset 0x%08x out of slot 0",
+			    ctx->src_off);
+		return -EINVAL;
+	}
+
+	rc = flash_read(ctx->img.dev, FLASH_AREA_IMAGE_0_OFFSET + ctx->src_off,
+			buf, n);
+	if (rc) {
+		SYS_LOG_ERR("flash_read error %d offset=0x%08x",
+			    rc, ctx->src_off);
+		return rc;
+	}
+
+	if (data) {
+		for (i = 0; i < n; i++) {
+			buf[i] += data[i];
+		}
+	}
+
+	rc = flash_img_buffered_write(&ctx->img, buf, n, false);
+	if (rc) {
+		return rc;
+	}
+
+	ctx->src_off += n;
+	ctx->run_left -= n;
+	ctx->diff_left -= n;
+	ctx->out_bytes += n;
+
+	return 0;
+}
+
+static int delta_img_process(struct delta_img_context *ctx,
+			     const u8_t *data, size_t len)
+{
+	size_t n;
+	int rc;
+
+	while (1) {
+		switch (ctx->state) {
+		case DELTA_IMG_HDR:
+			if (!delta_img_collect(ctx, &data, &len, 8)) {
+				return 0;
+			}
+
+			if (sys_get_le32(&ctx->hdr[0]) != DELTA_IMG_MAGIC) {
+				SYS_LOG_ERR("not a patch");
+				return -EINVAL;
+			}
+
+			ctx->img_size = sys_get_le32(&ctx->hdr[4]);
+			if (ctx->img_size > FLASH_AREA_IMAGE_1_SIZE) {
+				SYS_LOG_ERR("image of %u bytes too large",
+					    ctx->img_size);
+				return -EINVAL;
+			}
+
+			ctx->state = ctx->img_size ? DELTA_IMG_CTRL :
+						     DELTA_IMG_DONE;
+			break;
+
+		case DELTA_IMG_CTRL:
+			if (!delta_img_collect(ctx, &data, &len,
+					       DELTA_IMG_HDR_SIZE)) {
+				return 0;
+			}
+
+			rc = delta_img_ctrl(ctx);
+			if (rc) {
+				return rc;
+			}
+			break;
+
+		case DELTA_IMG_DIFF:
+			if (!ctx->diff_left) {
+				ctx->state = DELTA_IMG_EXTRA;
+				break;
+			}
+
+			if (!ctx->run_left) {
+				if (!len) {
+					return 0;
+				}
+
+				ctx->run_copy = (*data & 0x80) != 0;
+				ctx->run_left = (*data & 0x7f) + 1;
+				data++;
+				len--;
+
+				if (ctx->run_left > ctx->diff_left) {
+					SYS_LOG_ERR("diff run too long");
+					return -EINVAL;
+				}
+				break;
+			}
+
+			n = min(ctx->run_left, DELTA_IMG_CHUNK);
+			if (ctx->run_copy) {
+				rc = delta_img_patch(ctx, NULL, n);
+			} else {
+				if (!len) {
+					return 0;
+				}
+
+				n = min(n, len);
+				rc = delta_img_patch(ctx, data, n);
+				data += n;
+				len -= n;
+			}
+
+			if (rc) {
+				return rc;
+			}
+			break;
+
+		case DELTA_IMG_EXTRA:
+			if (!ctx->extra_left) {
+				ctx->src_off += ctx->adjust;
+				ctx->state = (ctx->out_bytes == ctx->img_size) ?
+					     DELTA_IMG_DONE : DELTA_IMG_CTRL;
+				break;
+			}
+
+			if (!len) {
+				return 0;
+			}
+
+			n = min(ctx->extra_left, len);
+			rc = flash_img_buffered_write(&ctx->img, (u8_t *)data,
+						      n, false);
+			if (rc) {
+				return rc;
+			}
+
+			data += n;
+			len -= n;
+			ctx->extra_left -= n;
+			ctx->out_bytes += n;
+			break;
+
+		case DELTA_IMG_DONE:
+			if (len) {
+				SYS_LOG_ERR("data after the end of the patch");
+				return -EINVAL;
+			}
+			return 0;
+
+		default:
+			return -EINVAL;
+		}
+	}
+}
+
+void delta_img_init(struct delta_img_context *ctx, struct device *dev)
+{
+	flash_img_init(&ctx->img, dev);
+	ctx->state = DELTA_IMG_HDR;
+	ctx->hdr_len = 0;
+	ctx->run_left = 0;
+	ctx->img_size = 0;
+	ctx->out_bytes = 0;
+	ctx->src_off = 0;
+}
+
+int delta_img_write(struct delta_img_context *ctx, const u8_t *data,
+		    size_t len, bool flush)
+{
+	int rc;
+
+	rc = delta_img_process(ctx, data, len);
+	if (rc) {
+		/* the patch can't be resumed from here */
+		ctx->state = DELTA_IMG_ERROR;
+		return rc;
+	}
+
+	if (!flush) {
+		return 0;
+	}
+
+	if (ctx->state != DELTA_IMG_DONE) {
+		SYS_LOG_ERR("patch truncated at %u of %u bytes",
+			    ctx->out_bytes, ctx->img_size);
+		return -EINVAL;
+	}
+
+	return flash_img_buffered_write(&ctx->img, NULL, 0, true);
+}
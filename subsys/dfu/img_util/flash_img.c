@@ -17,6 +17,9 @@
 #include <flash.h>
 #include <board.h>
 #include <dfu/flash_img.h>
+#if defined(CONFIG_IMG_HASH_SHA256)
+#include <tinycrypt/constants.h>
+#endif
 
 BUILD_ASSERT_MSG((CONFIG_IMG_BLOCK_BUF_SIZE % FLASH_WRITE_BLOCK_SIZE == 0),
 		 "CONFIG_IMG_BLOCK_BUF_SIZE is not a multiple of "
@@ -52,6 +55,167 @@ static bool flash_verify(struct device *dev, off_t offset,
 	return (len == 0) ? true : false;
 }
 
+#if defined(CONFIG_IMG_WRITE_ASYNC)
+static void flash_img_write_done(struct flash_async_req *req, int result)
+{
+	struct flash_img_context *ctx =
+		CONTAINER_OF(req, struct flash_img_context, req);
+
+	ctx->write_rc = result;
+	k_sem_give(&ctx->done);
+}
+
+#if defined(CONFIG_IMG_ERASE_PROGRESSIVELY)
+static void flash_img_erase_done(struct flash_async_req *req, int result)
+{
+	struct flash_img_context *ctx =
+		CONTAINER_OF(req, struct flash_img_context, erase_req);
+
+	ctx->erase_rc = result;
+}
+#endif
+#endif
+
+/* wait for the block handed to the flash request thread to be written */
+static int flash_block_wait(struct flash_img_context *ctx)
+{
+#if defined(CONFIG_IMG_WRITE_ASYNC)
+	int rc;
+
+	if (!ctx->pending) {
+		return 0;
+	}
+
+	k_sem_take(&ctx->done, K_FOREVER);
+	ctx->pending = false;
+
+	/* the erase is queued before the write, it is done by now */
+#if defined(CONFIG_IMG_ERASE_PROGRESSIVELY)
+	rc = ctx->erase_rc;
+	if (rc) {
+		SYS_LOG_ERR("flash_erase error %d", rc);
+		return rc;
+	}
+#endif
+
+	rc = ctx->write_rc;
+	if (rc) {
+		SYS_LOG_ERR("flash_write error %d offset=0x%08x",
+			    rc, ctx->req.offset);
+		return rc;
+	}
+
+	if (!flash_verify(ctx->dev, ctx->req.offset, (u8_t *)ctx->req.data,
+			  ctx->req.len)) {
+		return -EIO;
+	}
+#endif
+	return 0;
+}
+
+#if defined(CONFIG_IMG_ERASE_PROGRESSIVELY)
+/* erase the pages up to end which are not erased yet */
+static int flash_block_erase(struct flash_img_context *ctx, off_t end)
+{
+	struct flash_pages_info info;
+	off_t start = ctx->erased_end;
+	int rc;
+
+	while (ctx->erased_end < end) {
+		rc = flash_get_page_info_by_offs(ctx->dev, ctx->erased_end,
+						 &info);
+		if (rc) {
+			SYS_LOG_ERR("no flash page at offset=0x%08x",
+				    ctx->erased_end);
+			return rc;
+		}
+
+		ctx->erased_end = info.start_offset + info.size;
+	}
+
+	if (ctx->erased_end == start) {
+		return 0;
+	}
+
+#if defined(CONFIG_IMG_WRITE_ASYNC)
+	ctx->erase_req.dev = ctx->dev;
+	ctx->erase_req.offset = start;
+	ctx->erase_req.len = ctx->erased_end - start;
+	ctx->erase_req.cb = flash_img_erase_done;
+	ctx->erase_req.signal = NULL;
+	ctx->erase_rc = 0;
+
+	rc = flash_erase_async(&ctx->erase_req);
+#else
+	flash_write_protection_set(ctx->dev, false);
+	rc = flash_erase(ctx->dev, start, ctx->erased_end - start);
+	flash_write_protection_set(ctx->dev, true);
+#endif
+	if (rc) {
+		SYS_LOG_ERR("flash_erase error %d offset=0x%08x", rc, start);
+	}
+
+	return rc;
+}
+#endif
+
+/* write out ctx->buf, which holds len bytes of image data */
+static int flash_block_flush(struct flash_img_context *ctx, off_t offset,
+			     size_t len)
+{
+	off_t addr = offset + ctx->bytes_written;
+	int rc;
+
+	/* the other buffer is reused once its block is written */
+	rc = flash_block_wait(ctx);
+	if (rc) {
+		return rc;
+	}
+
+#if defined(CONFIG_IMG_ERASE_PROGRESSIVELY)
+	rc = flash_block_erase(ctx, addr + CONFIG_IMG_BLOCK_BUF_SIZE);
+	if (rc) {
+		return rc;
+	}
+#endif
+
+#if defined(CONFIG_IMG_WRITE_ASYNC)
+	ctx->req.dev = ctx->dev;
+	ctx->req.offset = addr;
+	ctx->req.data = ctx->buf;
+	ctx->req.len = CONFIG_IMG_BLOCK_BUF_SIZE;
+	ctx->req.cb = flash_img_write_done;
+	ctx->req.signal = NULL;
+
+	rc = flash_write_async(&ctx->req);
+	if (rc) {
+		SYS_LOG_ERR("flash_write error %d offset=0x%08x", rc, addr);
+		return rc;
+	}
+
+	ctx->pending = true;
+	ctx->buf = (ctx->buf == ctx->bufs[0]) ? ctx->bufs[1] : ctx->bufs[0];
+#else
+	flash_write_protection_set(ctx->dev, false);
+	rc = flash_write(ctx->dev, addr, ctx->buf, CONFIG_IMG_BLOCK_BUF_SIZE);
+	flash_write_protection_set(ctx->dev, true);
+	if (rc) {
+		SYS_LOG_ERR("flash_write error %d offset=0x%08x", rc, addr);
+		return rc;
+	}
+
+	if (!flash_verify(ctx->dev, addr, ctx->buf,
+			  CONFIG_IMG_BLOCK_BUF_SIZE)) {
+		return -EIO;
+	}
+#endif
+
+	ctx->bytes_written += len;
+	ctx->buf_bytes = 0;
+
+	return 0;
+}
+
 /* buffer data into block writes */
 static int flash_block_write(struct flash_img_context *ctx, off_t offset,
 			     u8_t *data, size_t len, bool finished)
@@ -63,25 +227,12 @@ static int flash_block_write(struct flash_img_context *ctx, off_t offset,
 	       (CONFIG_IMG_BLOCK_BUF_SIZE - ctx->buf_bytes)) {
 		memcpy(ctx->buf + ctx->buf_bytes, data + processed,
 		       (CONFIG_IMG_BLOCK_BUF_SIZE - ctx->buf_bytes));
+		processed += (CONFIG_IMG_BLOCK_BUF_SIZE - ctx->buf_bytes);
 
-		flash_write_protection_set(ctx->dev, false);
-		rc = flash_write(ctx->dev, offset + ctx->bytes_written,
-				 ctx->buf, CONFIG_IMG_BLOCK_BUF_SIZE);
-		flash_write_protection_set(ctx->dev, true);
+		rc = flash_block_flush(ctx, offset, CONFIG_IMG_BLOCK_BUF_SIZE);
 		if (rc) {
-			SYS_LOG_ERR("flash_write error %d offset=0x%08x",
-				    rc, offset + ctx->bytes_written);
 			return rc;
 		}
-
-		if (!flash_verify(ctx->dev, offset + ctx->bytes_written,
-				  ctx->buf, CONFIG_IMG_BLOCK_BUF_SIZE)) {
-			return -EIO;
-		}
-
-		ctx->bytes_written += CONFIG_IMG_BLOCK_BUF_SIZE;
-		processed += (CONFIG_IMG_BLOCK_BUF_SIZE - ctx->buf_bytes);
-		ctx->buf_bytes = 0;
 	}
 
 	/* place rest of the data into ctx->buf */
@@ -96,23 +247,14 @@ static int flash_block_write(struct flash_img_context *ctx, off_t offset,
 		memset(ctx->buf + ctx->buf_bytes, 0xFF,
 		       CONFIG_IMG_BLOCK_BUF_SIZE - ctx->buf_bytes);
 
-		flash_write_protection_set(ctx->dev, false);
-		rc = flash_write(ctx->dev, offset + ctx->bytes_written,
-				 ctx->buf, CONFIG_IMG_BLOCK_BUF_SIZE);
-		flash_write_protection_set(ctx->dev, true);
+		rc = flash_block_flush(ctx, offset, ctx->buf_bytes);
 		if (rc) {
-			SYS_LOG_ERR("flash_write error %d offset=0x%08x",
-				    rc, offset + ctx->bytes_written);
 			return rc;
 		}
+	}
 
-		if (!flash_verify(ctx->dev, offset + ctx->bytes_written,
-				  ctx->buf, CONFIG_IMG_BLOCK_BUF_SIZE)) {
-			return -EIO;
-		}
-
-		ctx->bytes_written = ctx->bytes_written + ctx->buf_bytes;
-		ctx->buf_bytes = 0;
+	if (finished) {
+		rc = flash_block_wait(ctx);
 	}
 
 	return rc;
@@ -128,11 +270,44 @@ void flash_img_init(struct flash_img_context *ctx, struct device *dev)
 	ctx->dev = dev;
 	ctx->bytes_written = 0;
 	ctx->buf_bytes = 0;
+#if defined(CONFIG_IMG_WRITE_ASYNC)
+	ctx->buf = ctx->bufs[0];
+	ctx->pending = false;
+	k_sem_init(&ctx->done, 0, 1);
+#endif
+#if defined(CONFIG_IMG_ERASE_PROGRESSIVELY)
+	ctx->erased_end = FLASH_AREA_IMAGE_1_OFFSET;
+#endif
+#if defined(CONFIG_IMG_HASH_SHA256)
+	tc_sha256_init(&ctx->sha);
+#endif
 }
 
 int flash_img_buffered_write(struct flash_img_context *ctx, u8_t *data,
 			     size_t len, bool flush)
 {
+#if defined(CONFIG_IMG_HASH_SHA256)
+	if (len) {
+		tc_sha256_update(&ctx->sha, data, len);
+	}
+#endif
+
 	return flash_block_write(ctx, FLASH_AREA_IMAGE_1_OFFSET, data, len,
 				 flush);
 }
+
+#if defined(CONFIG_IMG_HASH_SHA256)
+int flash_img_hash_get(struct flash_img_context *ctx, u8_t *digest)
+{
+	if (ctx->buf_bytes) {
+		/* the image is not flushed yet */
+		return -EBUSY;
+	}
+
+	if (tc_sha256_final(digest, &ctx->sha) != TC_CRYPTO_SUCCESS) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+#endif
@@ -88,6 +88,18 @@ fcb_erase_sector(const struct fcb *fcb, const struct flash_sector *sector)
 	return 0;
 }
 
+#if defined(CONFIG_FCB_SECTOR_CACHE)
+void
+fcb_sector_cache_reset(struct fcb *fcb, struct flash_sector *sector)
+{
+	int idx = sector - fcb->f_sectors;
+
+	if (idx < CONFIG_FCB_SECTOR_CACHE_SIZE) {
+		fcb->f_valid_off[idx] = sizeof(struct fcb_disk_area);
+	}
+}
+#endif
+
 int
 fcb_init(int f_area_id, struct fcb *fcb)
 {
@@ -116,6 +128,7 @@ fcb_init(int f_area_id, struct fcb *fcb)
 	/* Fill last used, first used */
 	for (i = 0; i < fcb->f_sector_cnt; i++) {
 		sector = &fcb->f_sectors[i];
+		fcb_sector_cache_reset(fcb, sector);
 		rc = fcb_sector_hdr_read(fcb, sector, &fda);
 		if (rc < 0) {
 			return rc;
@@ -241,6 +254,8 @@ fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, u16_t id)
 	fda._pad = 0xff;
 	fda.fd_id = id;
 
+	fcb_sector_cache_reset(fcb, sector);
+
 	rc = fcb_flash_write(fcb, sector, 0, &fda, sizeof(fda));
 	if (rc != 0) {
 		return FCB_ERR_FLASH;
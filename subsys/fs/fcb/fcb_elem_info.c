@@ -63,12 +63,49 @@ fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, u8_t *c8p)
 	return 0;
 }
 
+#if defined(CONFIG_FCB_SECTOR_CACHE)
+/*
+ * Elements below the cached offset have had their CRC checked before, only
+ * their length needs to be read.
+ */
+static int fcb_elem_info_cached(struct fcb *fcb, struct fcb_entry *loc)
+{
+	u8_t tmp_str[2];
+	int cnt;
+	int rc;
+
+	rc = fcb_flash_read(fcb, loc->fe_sector, loc->fe_elem_off, tmp_str, 2);
+	if (rc) {
+		return FCB_ERR_FLASH;
+	}
+
+	cnt = fcb_get_len(tmp_str, &loc->fe_data_len);
+	if (cnt < 0) {
+		return cnt;
+	}
+	loc->fe_data_off = loc->fe_elem_off + fcb_len_in_flash(fcb, cnt);
+
+	return 0;
+}
+#endif
+
 int fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc)
 {
 	int rc;
 	u8_t crc8;
 	u8_t fl_crc8;
 	off_t off;
+#if defined(CONFIG_FCB_SECTOR_CACHE)
+	u32_t *valid_off = NULL;
+	int idx = loc->fe_sector - fcb->f_sectors;
+
+	if (idx < CONFIG_FCB_SECTOR_CACHE_SIZE) {
+		valid_off = &fcb->f_valid_off[idx];
+		if (loc->fe_elem_off < *valid_off) {
+			return fcb_elem_info_cached(fcb, loc);
+		}
+	}
+#endif
 
 	rc = fcb_elem_crc8(fcb, loc, &crc8);
 	if (rc) {
@@ -84,5 +121,12 @@ int fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc)
 	if (fl_crc8 != crc8) {
 		return FCB_ERR_CRC;
 	}
+
+#if defined(CONFIG_FCB_SECTOR_CACHE)
+	/* extend the cache only while the valid elements are contiguous */
+	if (valid_off && loc->fe_elem_off == *valid_off) {
+		*valid_off = off + fcb_len_in_flash(fcb, FCB_CRC_SZ);
+	}
+#endif
 	return 0;
 }
@@ -47,6 +47,15 @@ int fcb_getnext_nolock(struct fcb *fcb, struct fcb_entry *loc);
 int fcb_elem_info(struct fcb *fcb, struct fcb_entry *loc);
 int fcb_elem_crc8(struct fcb *fcb, struct fcb_entry *loc, u8_t *crc8p);
 
+#if defined(CONFIG_FCB_SECTOR_CACHE)
+void fcb_sector_cache_reset(struct fcb *fcb, struct flash_sector *sector);
+#else
+static inline void fcb_sector_cache_reset(struct fcb *fcb,
+					  struct flash_sector *sector)
+{
+}
+#endif
+
 int fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, u16_t id);
 int fcb_sector_hdr_read(struct fcb *fcb, struct flash_sector *sector,
 			struct fcb_disk_area *fdap);
@@ -20,6 +20,7 @@ fcb_rotate(struct fcb *fcb)
 	}
 
 	rc = fcb_erase_sector(fcb, fcb->f_oldest);
+	fcb_sector_cache_reset(fcb, fcb->f_oldest);
 	if (rc) {
 		rc = FCB_ERR_FLASH;
 		goto out;
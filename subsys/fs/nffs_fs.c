@@ -16,6 +16,7 @@
 #include <misc/printk.h>
 #include <nffs/os.h>
 #include <nffs/nffs.h>
+#include <fs/nffs_fs.h>
 
 #define NFFS_MAX_FILE_NAME 256
 
@@ -48,6 +49,10 @@ K_MEM_SLAB_DEFINE(nffs_cache_inode_pool,	sizeof(struct nffs_cache_inode),
 K_MEM_SLAB_DEFINE(nffs_cache_block_pool,	sizeof(struct nffs_cache_block),
 		  CONFIG_FS_NFFS_NUM_CACHE_BLOCKS,	4);
 
+/* Runtime limits of the caches, at most the size of their pools */
+static u32_t cache_inode_limit = CONFIG_FS_NFFS_NUM_CACHE_INODES;
+static u32_t cache_block_limit = CONFIG_FS_NFFS_NUM_CACHE_BLOCKS;
+
 static int translate_error(int error)
 {
 	switch (error) {
@@ -120,6 +125,14 @@ void *nffs_os_mempool_get(nffs_os_mempool_t *pool)
 	int rc;
 	void *ptr;
 
+	/* Failing makes NFFS evict the least recently used entries */
+	if ((pool == &nffs_cache_inode_pool &&
+	     k_mem_slab_num_used_get(pool) >= cache_inode_limit) ||
+	    (pool == &nffs_cache_block_pool &&
+	     k_mem_slab_num_used_get(pool) >= cache_block_limit)) {
+		return NULL;
+	}
+
 	rc = k_mem_slab_alloc(pool, &ptr, K_NO_WAIT);
 	if (rc) {
 		ptr = NULL;
@@ -569,6 +582,29 @@ static int nffs_mount(struct fs_mount_t *mountp)
 }
 
 /* File system interface */
+int fs_nffs_cache_limit_set(u32_t inodes, u32_t blocks)
+{
+	if (inodes < 1 || inodes > CONFIG_FS_NFFS_NUM_CACHE_INODES ||
+	    blocks < 1 || blocks > CONFIG_FS_NFFS_NUM_CACHE_BLOCKS) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&nffs_lock, K_FOREVER);
+
+	/*
+	 * Start over with empty caches so that they never hold more entries
+	 * than the new limits, NFFS only evicts one entry at a time.
+	 */
+	nffs_cache_clear();
+
+	cache_inode_limit = inodes;
+	cache_block_limit = blocks;
+
+	k_mutex_unlock(&nffs_lock);
+
+	return 0;
+}
+
 static struct fs_file_system_t nffs_fs = {
 	.open = nffs_open,
 	.close = nffs_close,
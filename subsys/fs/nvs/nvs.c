@@ -6,6 +6,7 @@
  */
 
 #include <flash.h>
+#include <init.h>
 #include <crc16.h>
 #include <string.h>
 #include <errno.h>
@@ -13,6 +14,16 @@
 #include <nvs/nvs.h>
 #include "nvs_priv.h"
 
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+static void _nvs_gc_work_handler(struct k_work *work);
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+
+/* ids used internally, not available to users */
+static inline bool _nvs_id_is_special(u16_t id)
+{
+	return (id == NVS_ID_EMPTY) || (id == NVS_ID_SECTOR_END) ||
+	       (IS_ENABLED(CONFIG_NVS_BATCH) && (id == NVS_ID_BATCH));
+}
 
 static inline u16_t _nvs_len_in_flash(struct nvs_fs *fs, u16_t len)
 {
@@ -154,126 +165,186 @@ int _nvs_flash_erase(struct nvs_fs *fs, off_t offset, size_t len)
 	return 0;
 }
 
-void _nvs_entry_sector_advance(struct nvs_fs *fs)
+/* read the header of the entry at entry->data_addr. Batches are walked
+ * into: for a committed batch the header of its first member is returned,
+ * a batch that was never committed (no valid crc) is skipped as a whole.
+ * entry->data_addr is moved along when this happens. *batch_end is the end
+ * of the batch data while walking the members of a batch and -1 otherwise.
+ */
+static int _nvs_head_read(struct nvs_fs *fs, struct nvs_entry *entry,
+			  struct _nvs_data_hdr *head, off_t *batch_end)
 {
-	fs->entry_sector++;
-	if (fs->entry_sector == fs->sector_count) {
-		fs->entry_sector = 0;
+	off_t hdr_addr;
+#if defined(CONFIG_NVS_BATCH)
+	int rc;
+	struct nvs_entry batch;
+	u16_t hdr_len, slt_len;
+
+	hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_hdr));
+	slt_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_slt));
+	while (1) {
+		hdr_addr = _nvs_head_addr_in_flash(fs, entry);
+		if (hdr_addr == *batch_end) {
+			/* end of the batch, continue after its slot */
+			*batch_end = -1;
+			_nvs_addr_advance(fs, &entry->data_addr, slt_len);
+			continue;
+		}
+		rc = nvs_flash_read(fs, hdr_addr, head, sizeof(*head));
+		if (rc) {
+			return rc;
+		}
+		if ((head->id != NVS_ID_BATCH) || (*batch_end >= 0)) {
+			return 0;
+		}
+		batch.data_addr = entry->data_addr;
+		batch.len = head->len;
+		if (!nvs_check_crc(fs, &batch)) {
+			/* the members start at the batch data */
+			*batch_end = entry->data_addr + head->len;
+			entry->data_addr += hdr_len;
+			continue;
+		}
+		SYS_LOG_DBG("Skipping uncommitted batch");
+		_nvs_addr_advance(fs, &entry->data_addr,
+				  _nvs_entry_len_in_flash(fs, head->len));
 	}
+#else
+	ARG_UNUSED(batch_end);
+
+	hdr_addr = _nvs_head_addr_in_flash(fs, entry);
+	return nvs_flash_read(fs, hdr_addr, head, sizeof(*head));
+#endif /* CONFIG_NVS_BATCH */
 }
 
-/* garbage collection: addr is set to the start of the sector to be gc'ed,
- * the entry sector has been updated to point to the sector just after the
- * sector being gc'ed
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+/* find the lookup cache slot for id, or the free slot to use for it,
+ * returns NULL when id is not cached and the cache is full
  */
-int _nvs_gc(struct nvs_fs *fs, off_t addr)
+static struct nvs_lookup *_nvs_lookup_slot(struct nvs_fs *fs, u16_t id)
 {
-	int rc, len, bytes_to_copy;
-	off_t rd_addr;
-	struct nvs_entry walker, walker_last, last_entry, search;
+	struct nvs_lookup *slot;
+	u16_t i, idx;
+
+	idx = id % CONFIG_NVS_LOOKUP_CACHE_SIZE;
+	for (i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		slot = &fs->lookup_cache[idx];
+		if ((slot->id == id) || (slot->id == NVS_ID_EMPTY)) {
+			return slot;
+		}
+		if (++idx == CONFIG_NVS_LOOKUP_CACHE_SIZE) {
+			idx = 0;
+		}
+	}
+	return NULL;
+}
+
+static void _nvs_lookup_update(struct nvs_fs *fs, u16_t id, off_t data_addr,
+			       u16_t len)
+{
+	struct nvs_lookup *slot;
+
+	slot = _nvs_lookup_slot(fs, id);
+	if (!slot) {
+		/* id not cached, reads of it walk the flash */
+		return;
+	}
+	slot->id = id;
+	slot->len = len;
+	slot->data_addr = data_addr;
+}
+
+static void _nvs_lookup_clear(struct nvs_fs *fs)
+{
+	u16_t i;
+
+	for (i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		fs->lookup_cache[i].id = NVS_ID_EMPTY;
+	}
+}
+
+/* fill the cache from all entries in flash, later entries overwrite
+ * earlier ones
+ */
+static int _nvs_lookup_build(struct nvs_fs *fs)
+{
+	int rc;
+	struct nvs_entry entry;
 	struct _nvs_data_hdr head;
-	u16_t sec_hdr_len, hdr_len, walker_len, walker_last_len;
-	u8_t buf[NVS_MOVE_BLOCK_SIZE];
+	off_t batch_end = -1;
 
-	walker.data_addr = addr;
-	sec_hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_sector_hdr));
-	hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_hdr));
-	_nvs_addr_advance(fs, &walker.data_addr, sec_hdr_len + hdr_len);
+	_nvs_lookup_clear(fs);
+	nvs_set_start_entry(fs, &entry);
 	while (1) {
-		rd_addr = _nvs_head_addr_in_flash(fs, &walker);
-		rc = nvs_flash_read(fs, rd_addr, &head, sizeof(head));
+		rc = _nvs_head_read(fs, &entry, &head, &batch_end);
 		if (rc) {
 			return rc;
 		}
-		if ((head.id == NVS_ID_SECTOR_END) ||
-		    (head.id == NVS_ID_EMPTY)) {
+		if (head.id == NVS_ID_EMPTY) {
 			return 0;
 		}
-		walker.len = head.len;
-		walker.id = head.id;
-		search.id = walker.id;
-		if (nvs_get_first_entry(fs, &search)) {
-			/* entry is not found, copy needed - but find the last
-			 * entry first
-			 */
-			last_entry.len = 0;
-			last_entry.data_addr = 0;
-			walker_last = walker;
-			while (walker_last.id != NVS_ID_SECTOR_END) {
-				rd_addr = _nvs_head_addr_in_flash(
-						fs, &walker_last);
-				rc = nvs_flash_read(
-					fs, rd_addr, &head, sizeof(head));
-				if (rc) {
-					return rc;
-				}
-				walker_last.len = head.len;
-				walker_last.id = head.id;
-				if (walker_last.id == walker.id) {
-					last_entry = walker_last;
-				}
-				walker_last_len = _nvs_entry_len_in_flash(
-							fs, walker_last.len);
-				_nvs_addr_advance(
-					fs, &walker_last.data_addr,
-					walker_last_len);
-			}
-			if (last_entry.len == 0) {
-				SYS_LOG_DBG("Skipped move of removed entry id"
-					"%x", search.id);
-			} else {
-				rd_addr = _nvs_head_addr_in_flash(
-						fs, &last_entry);
-				len = _nvs_entry_len_in_flash(
-					fs, last_entry.len);
-				while (len > 0) {
-					bytes_to_copy =
-						min(NVS_MOVE_BLOCK_SIZE, len);
-					rc = nvs_flash_read(fs, rd_addr,
-						&buf, bytes_to_copy);
-					if (rc) {
-						return rc;
-					}
-					rc = nvs_flash_write(fs,
-						fs->write_location,
-						&buf, bytes_to_copy);
-					if (rc) {
-						return rc;
-					}
-					len -= bytes_to_copy;
-					rd_addr += bytes_to_copy;
-					fs->write_location += bytes_to_copy;
-				}
-				SYS_LOG_DBG("Entry with id %x moved to new "
-					    "flash sector", search.id);
-			}
+		if (head.id != NVS_ID_SECTOR_END) {
+			_nvs_lookup_update(fs, head.id, entry.data_addr,
+					   head.len);
 		}
-		walker_len = _nvs_entry_len_in_flash(fs, walker.len);
-		_nvs_addr_advance(fs, &walker.data_addr, walker_len);
+		_nvs_addr_advance(fs, &entry.data_addr,
+				  _nvs_entry_len_in_flash(fs, head.len));
 	}
 }
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
 
-void nvs_set_start_entry(struct nvs_fs *fs, struct nvs_entry *entry)
+/* find the latest entry for entry->id, from the lookup cache if possible */
+static int _nvs_get_latest_entry(struct nvs_fs *fs, struct nvs_entry *entry)
+{
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	struct nvs_lookup *slot;
+
+	slot = _nvs_lookup_slot(fs, entry->id);
+	if (slot && (slot->id == entry->id)) {
+		entry->len = slot->len;
+		entry->data_addr = slot->data_addr;
+		return 0;
+	}
+	if (slot) {
+		/* a free slot means the id is not stored at all */
+		entry->len = 0;
+		return -ENOENT;
+	}
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+	return nvs_get_last_entry(fs, entry);
+}
+
+void _nvs_entry_sector_advance(struct nvs_fs *fs)
+{
+	fs->entry_sector++;
+	if (fs->entry_sector == fs->sector_count) {
+		fs->entry_sector = 0;
+	}
+}
+
+static void _nvs_set_start_entry_at(struct nvs_fs *fs,
+				    struct nvs_entry *entry, u8_t sector)
 {
 	u16_t sector_hdr_len, data_hdr_len;
 
-	entry->data_addr = fs->entry_sector * fs->sector_size;
+	entry->data_addr = sector * fs->sector_size;
 	sector_hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_sector_hdr));
 	data_hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_hdr));
 	_nvs_addr_advance(fs, &entry->data_addr, sector_hdr_len + data_hdr_len);
 }
 
-int nvs_get_first_entry(struct nvs_fs *fs, struct nvs_entry *entry)
+/* find the first entry with entry->id, walking from the start of sector */
+static int _nvs_get_first_entry_at(struct nvs_fs *fs, struct nvs_entry *entry,
+				   u8_t sector, off_t *batch_end)
 {
 	int rc;
 	struct _nvs_data_hdr head;
-	off_t hdr_addr;
 	u16_t adv_len;
 
-	nvs_set_start_entry(fs, entry);
+	*batch_end = -1;
+	_nvs_set_start_entry_at(fs, entry, sector);
 	while (1) {
-		hdr_addr = _nvs_head_addr_in_flash(fs, entry);
-		rc = nvs_flash_read(fs, hdr_addr, &head, sizeof(head));
+		rc = _nvs_head_read(fs, entry, &head, batch_end);
 		if (rc) {
 			return rc;
 		}
@@ -289,16 +360,155 @@ int nvs_get_first_entry(struct nvs_fs *fs, struct nvs_entry *entry)
 	}
 }
 
+/* garbage collection of a single entry: walker points to an entry in the
+ * sector being gc'ed. When no entry with the same id exists in the sectors
+ * after it, the last entry for the id in the gc'ed sector is moved to the
+ * write sector. The walker is advanced to the next entry, 1 is returned
+ * when the end of the sector is reached. Members of a batch are moved as
+ * separate entries, batch_end keeps track of the batch the walker is in.
+ */
+static int _nvs_gc_entry(struct nvs_fs *fs, struct nvs_entry *walker,
+			 off_t *batch_end)
+{
+	int rc, len, bytes_to_copy;
+	off_t rd_addr, last_batch_end, search_batch_end;
+	struct nvs_entry walker_last, last_entry, search;
+	struct _nvs_data_hdr head;
+	u16_t hdr_len, walker_len, walker_last_len;
+	u8_t buf[NVS_MOVE_BLOCK_SIZE];
+	u8_t sector;
+
+	hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_hdr));
+	rc = _nvs_head_read(fs, walker, &head, batch_end);
+	if (rc) {
+		return rc;
+	}
+	if ((head.id == NVS_ID_SECTOR_END) ||
+	    (head.id == NVS_ID_EMPTY)) {
+		return 1;
+	}
+	rd_addr = _nvs_head_addr_in_flash(fs, walker);
+	walker->len = head.len;
+	walker->id = head.id;
+	search.id = walker->id;
+	/* search from the sector just after the sector being gc'ed */
+	sector = rd_addr / fs->sector_size + 1;
+	if (sector == fs->sector_count) {
+		sector = 0;
+	}
+	if (_nvs_get_first_entry_at(fs, &search, sector, &search_batch_end)) {
+		/* entry is not found, copy needed - but find the last
+		 * entry first
+		 */
+		last_entry.len = 0;
+		last_entry.data_addr = 0;
+		walker_last = *walker;
+		last_batch_end = *batch_end;
+		while (walker_last.id != NVS_ID_SECTOR_END) {
+			rc = _nvs_head_read(fs, &walker_last, &head,
+					    &last_batch_end);
+			if (rc) {
+				return rc;
+			}
+			walker_last.len = head.len;
+			walker_last.id = head.id;
+			if (walker_last.id == walker->id) {
+				last_entry = walker_last;
+			}
+			walker_last_len = _nvs_entry_len_in_flash(
+						fs, walker_last.len);
+			_nvs_addr_advance(fs, &walker_last.data_addr,
+					  walker_last_len);
+		}
+		if (last_entry.len == 0) {
+			SYS_LOG_DBG("Skipped move of removed entry id"
+				"%x", search.id);
+		} else {
+			rd_addr = _nvs_head_addr_in_flash(fs, &last_entry);
+			len = _nvs_entry_len_in_flash(fs, last_entry.len);
+			while (len > 0) {
+				bytes_to_copy = min(NVS_MOVE_BLOCK_SIZE, len);
+				rc = nvs_flash_read(fs, rd_addr,
+					&buf, bytes_to_copy);
+				if (rc) {
+					return rc;
+				}
+				rc = nvs_flash_write(fs,
+					fs->write_location,
+					&buf, bytes_to_copy);
+				if (rc) {
+					return rc;
+				}
+				len -= bytes_to_copy;
+				rd_addr += bytes_to_copy;
+				fs->write_location += bytes_to_copy;
+			}
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+			/* the entry now ends at write_location */
+			_nvs_lookup_update(fs, last_entry.id,
+				fs->write_location + hdr_len -
+				_nvs_entry_len_in_flash(fs, last_entry.len),
+				last_entry.len);
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+			SYS_LOG_DBG("Entry with id %x moved to new "
+				    "flash sector", search.id);
+		}
+	}
+	walker_len = _nvs_entry_len_in_flash(fs, walker->len);
+	_nvs_addr_advance(fs, &walker->data_addr, walker_len);
+	return 0;
+}
+
+/* set the walker to the first entry of the sector at addr */
+static void _nvs_gc_start(struct nvs_fs *fs, off_t addr,
+			  struct nvs_entry *walker, off_t *batch_end)
+{
+	u16_t sec_hdr_len, hdr_len;
+
+	*batch_end = -1;
+	walker->data_addr = addr;
+	sec_hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_sector_hdr));
+	hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_hdr));
+	_nvs_addr_advance(fs, &walker->data_addr, sec_hdr_len + hdr_len);
+}
+
+/* garbage collection: addr is set to the start of the sector to be gc'ed,
+ * the entry sector is advanced by the caller once this completes
+ */
+int _nvs_gc(struct nvs_fs *fs, off_t addr)
+{
+	int rc;
+	struct nvs_entry walker;
+	off_t batch_end;
+
+	_nvs_gc_start(fs, addr, &walker, &batch_end);
+	do {
+		rc = _nvs_gc_entry(fs, &walker, &batch_end);
+	} while (!rc);
+	return (rc < 0) ? rc : 0;
+}
+
+void nvs_set_start_entry(struct nvs_fs *fs, struct nvs_entry *entry)
+{
+	_nvs_set_start_entry_at(fs, entry, fs->entry_sector);
+}
+
+int nvs_get_first_entry(struct nvs_fs *fs, struct nvs_entry *entry,
+			off_t *batch_end)
+{
+	return _nvs_get_first_entry_at(fs, entry, fs->entry_sector, batch_end);
+}
+
 
 int nvs_get_last_entry(struct nvs_fs *fs, struct nvs_entry *entry)
 {
 	int rc;
 	struct nvs_entry latest;
 	struct _nvs_data_hdr head;
-	off_t hdr_addr;
+	off_t batch_end;
 	u16_t adv_len;
 
-	rc = nvs_get_first_entry(fs, entry);
+	rc = nvs_get_first_entry(fs, entry, &batch_end);
 	if (rc) {
 		return rc;
 	}
@@ -306,8 +516,7 @@ int nvs_get_last_entry(struct nvs_fs *fs, struct nvs_entry *entry)
 	latest.data_addr = entry->data_addr;
 	latest.len = entry->len;
 	while (1) {
-		hdr_addr = _nvs_head_addr_in_flash(fs, entry);
-		rc = nvs_flash_read(fs, hdr_addr, &head, sizeof(head));
+		rc = _nvs_head_read(fs, entry, &head, &batch_end);
 		if (rc) {
 			return rc;
 		}
@@ -327,11 +536,11 @@ int nvs_get_last_entry(struct nvs_fs *fs, struct nvs_entry *entry)
 }
 
 /* walking over entries, stops on empty or entry with same entry id */
-int nvs_walk_entry(struct nvs_fs *fs, struct nvs_entry *entry)
+int nvs_walk_entry(struct nvs_fs *fs, struct nvs_entry *entry,
+		   off_t *batch_end)
 {
 	int rc;
 	struct _nvs_data_hdr head;
-	off_t hdr_addr;
 	u16_t adv_len;
 
 
@@ -340,8 +549,7 @@ int nvs_walk_entry(struct nvs_fs *fs, struct nvs_entry *entry)
 		_nvs_addr_advance(fs, &entry->data_addr, adv_len);
 	}
 	while (1) {
-		hdr_addr = _nvs_head_addr_in_flash(fs, entry);
-		rc = nvs_flash_read(fs, hdr_addr, &head, sizeof(head));
+		rc = _nvs_head_read(fs, entry, &head, batch_end);
 		if (rc) {
 			return rc;
 		}
@@ -365,7 +573,7 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name, u32_t magic)
 	u16_t entry_sector_id, active_sector_id, max_item_len;
 	struct _nvs_sector_hdr sector_hdr;
 	struct nvs_entry entry;
-	off_t addr;
+	off_t addr, batch_end;
 
 	fs->magic = magic;
 	fs->sector_id = 0;
@@ -446,10 +654,18 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name, u32_t magic)
 	fs->entry_sector = entry_sector;
 	fs->sector_id = active_sector_id;
 
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	rc = _nvs_lookup_build(fs);
+	if (rc) {
+		return rc;
+	}
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+
 	/* Find the first empty entry */
 	nvs_set_start_entry(fs, &entry);
 	entry.id = NVS_ID_EMPTY;
-	rc = nvs_walk_entry(fs, &entry);
+	batch_end = -1;
+	rc = nvs_walk_entry(fs, &entry, &batch_end);
 	if (rc) {
 		return rc;
 	}
@@ -461,11 +677,11 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name, u32_t magic)
 		 */
 		SYS_LOG_DBG("Restarting garbage collection");
 		addr = fs->entry_sector * fs->sector_size;
-		_nvs_entry_sector_advance(fs);
 		rc = _nvs_gc(fs, addr);
 		if (rc) {
 			return rc;
 		}
+		_nvs_entry_sector_advance(fs);
 		rc = _nvs_flash_erase(fs, addr, fs->sector_size);
 		if (rc) {
 			return rc;
@@ -479,6 +695,11 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name, u32_t magic)
 		fs->entry_sector, fs->sector_id);
 
 	k_mutex_init(&fs->nvs_lock);
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	k_mutex_init(&fs->gc_lock);
+	k_work_init(&fs->gc_work, _nvs_gc_work_handler);
+	fs->gc_reserve = 0;
+#endif /* CONFIG_NVS_BACKGROUND_GC */
 
 	return 0;
 }
@@ -501,6 +722,11 @@ int nvs_append(struct nvs_fs *fs, struct nvs_entry *entry)
 	slt_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_slt));
 	extended_len = required_len + hdr_len + slt_len;
 
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	/* leave room for entries a background gc still has to move */
+	extended_len += fs->gc_reserve;
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+
 	if ((fs->sector_size - (fs->write_location & (fs->sector_size - 1))) <
 		extended_len) {
 		rc = NVS_STATUS_NOSPACE;
@@ -565,17 +791,19 @@ int nvs_check_crc(struct nvs_fs *fs, struct nvs_entry *entry)
 
 
 
-/* rotate the nvs, frees the next sector (based on fs->write_location) */
-int nvs_rotate(struct nvs_fs *fs)
+/* close the current sector and open the next one for writing, called with
+ * nvs_lock held. When the sector after the new one is the oldest sector, it
+ * has to be garbage collected before the next rotation: its address is
+ * returned in gc_addr, otherwise gc_addr is set to -1.
+ */
+static int _nvs_sector_close(struct nvs_fs *fs, off_t *gc_addr)
 {
 	int rc;
 	off_t addr;
 	struct _nvs_data_hdr head;
 	u16_t hdr_len, slt_len, sec_hdr_len;
 
-	rc = 0;
-
-	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	*gc_addr = -1;
 
 	/* fill previous sector with data to jump to the next sector */
 	head.id = NVS_ID_SECTOR_END;
@@ -587,7 +815,7 @@ int nvs_rotate(struct nvs_fs *fs)
 		   - slt_len - hdr_len + sec_hdr_len;
 	rc = nvs_flash_write(fs, fs->write_location, &head, sizeof(head));
 	if (rc) {
-		goto out;
+		return rc;
 	}
 
 	/* advance to next sector for writing */
@@ -597,36 +825,169 @@ int nvs_rotate(struct nvs_fs *fs)
 	/* initialize the new sector */
 	rc = _nvs_sector_init(fs, addr);
 	if (rc) {
-		goto out;
+		return rc;
 	}
 
-	/* data copy */
+	/* Do we need to advance the entry_sector, if so we need to copy */
 	addr = (fs->write_location & ~(fs->sector_size - 1));
 	_nvs_addr_advance(fs, &addr, fs->sector_size);
-	/* Do we need to advance the entry_sector, if so we need to copy */
 	if ((addr & ~(fs->sector_size - 1)) ==
 		fs->entry_sector * fs->sector_size) {
-		SYS_LOG_DBG("Starting data copy...");
-		_nvs_entry_sector_advance(fs);
-		rc = _nvs_gc(fs, addr);
-		if (rc) {
-			SYS_LOG_DBG("Quit data copy - gc error");
-			goto out;
-		}
-		rc = _nvs_flash_erase(fs, addr, fs->sector_size);
-		if (rc) {
-			SYS_LOG_DBG("Quit data copy - flash erase error");
-			goto out;
-		}
-		SYS_LOG_DBG("Done data copy - no error");
+		*gc_addr = addr;
 	}
-	rc = 0;
+	return 0;
+}
+
+/* rotate the nvs, frees the next sector (based on fs->write_location) */
+int nvs_rotate(struct nvs_fs *fs)
+{
+	int rc;
+	off_t addr;
+
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	/* wait for a background garbage collection to complete */
+	k_mutex_lock(&fs->gc_lock, K_FOREVER);
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	rc = _nvs_sector_close(fs, &addr);
+	if (rc || (addr < 0)) {
+		goto out;
+	}
+
+	/* data copy */
+	SYS_LOG_DBG("Starting data copy...");
+	rc = _nvs_gc(fs, addr);
+	if (rc) {
+		SYS_LOG_DBG("Quit data copy - gc error");
+		goto out;
+	}
+	_nvs_entry_sector_advance(fs);
+	rc = _nvs_flash_erase(fs, addr, fs->sector_size);
+	if (rc) {
+		SYS_LOG_DBG("Quit data copy - flash erase error");
+		goto out;
+	}
+	SYS_LOG_DBG("Done data copy - no error");
 
 out:
 	k_mutex_unlock(&fs->nvs_lock);
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	k_mutex_unlock(&fs->gc_lock);
+#endif /* CONFIG_NVS_BACKGROUND_GC */
 	return rc;
 }
 
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+static K_THREAD_STACK_DEFINE(nvs_gc_stack, CONFIG_NVS_BACKGROUND_GC_STACK_SIZE);
+static struct k_work_q nvs_gc_work_q;
+
+/* check if the write sector has filled past the threshold while the next
+ * rotation would need a garbage collection
+ */
+static bool _nvs_gc_due(struct nvs_fs *fs)
+{
+	off_t addr;
+	u32_t used;
+
+	used = fs->write_location & (fs->sector_size - 1);
+	if (used * 100 < fs->sector_size * CONFIG_NVS_BACKGROUND_GC_THRESHOLD) {
+		return false;
+	}
+	addr = fs->write_location & ~(fs->sector_size - 1);
+	_nvs_addr_advance(fs, &addr, fs->sector_size);
+	_nvs_addr_advance(fs, &addr, fs->sector_size);
+	return addr == fs->entry_sector * fs->sector_size;
+}
+
+/* rotate ahead of the writer and garbage collect one entry at a time,
+ * giving up nvs_lock in between so that writes can proceed. The erase of
+ * the collected sector is done without nvs_lock, the sector is no longer
+ * part of the file system by then.
+ */
+static void _nvs_gc_work_handler(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, gc_work);
+	struct nvs_entry walker;
+	off_t addr, batch_end;
+	int rc;
+
+	k_mutex_lock(&fs->gc_lock, K_FOREVER);
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+	if (!_nvs_gc_due(fs)) {
+		k_mutex_unlock(&fs->nvs_lock);
+		goto out;
+	}
+	rc = _nvs_sector_close(fs, &addr);
+	if (rc || (addr < 0)) {
+		k_mutex_unlock(&fs->nvs_lock);
+		goto err;
+	}
+	_nvs_gc_start(fs, addr, &walker, &batch_end);
+	fs->gc_reserve = fs->sector_size -
+		(_nvs_head_addr_in_flash(fs, &walker) & (fs->sector_size - 1));
+	k_mutex_unlock(&fs->nvs_lock);
+
+	SYS_LOG_DBG("Starting background data copy...");
+	do {
+		k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+		rc = _nvs_gc_entry(fs, &walker, &batch_end);
+		if (!rc) {
+			/* keep room for what is left in the gc'ed sector */
+			fs->gc_reserve = fs->sector_size -
+				(_nvs_head_addr_in_flash(fs, &walker) &
+				 (fs->sector_size - 1));
+		} else {
+			fs->gc_reserve = 0;
+			if (rc == 1) {
+				_nvs_entry_sector_advance(fs);
+			}
+		}
+		k_mutex_unlock(&fs->nvs_lock);
+	} while (!rc);
+	if (rc < 0) {
+		goto err;
+	}
+
+	rc = _nvs_flash_erase(fs, addr, fs->sector_size);
+	if (rc) {
+		goto err;
+	}
+	SYS_LOG_DBG("Done background data copy - no error");
+	goto out;
+
+err:
+	SYS_LOG_ERR("Background garbage collection failed (%d)", rc);
+out:
+	k_mutex_unlock(&fs->gc_lock);
+}
+
+/* wait for a background garbage collection, returns true if the write
+ * sector is no longer wr_sector, i.e. a write should be retried
+ */
+static bool _nvs_gc_sync(struct nvs_fs *fs, off_t wr_sector)
+{
+	bool moved;
+
+	k_mutex_lock(&fs->gc_lock, K_FOREVER);
+	moved = (fs->write_location & ~(fs->sector_size - 1)) != wr_sector;
+	k_mutex_unlock(&fs->gc_lock);
+	return moved;
+}
+
+static int _nvs_gc_work_q_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_q_start(&nvs_gc_work_q, nvs_gc_stack,
+		       K_THREAD_STACK_SIZEOF(nvs_gc_stack),
+		       CONFIG_NVS_BACKGROUND_GC_PRIORITY);
+	return 0;
+}
+
+SYS_INIT(_nvs_gc_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+
 int nvs_compute_crc(struct nvs_fs *fs, const struct nvs_entry *entry,
 		    u16_t *crc16)
 {
@@ -659,6 +1020,9 @@ int nvs_clear(struct nvs_fs *fs)
 			goto out;
 		}
 	}
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	_nvs_lookup_clear(fs);
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
 	rc = 0;
 
 out:
@@ -725,17 +1089,63 @@ int nvs_flash_write(struct nvs_fs *fs, off_t offset, const void *data,
 }
 
 
+/* append entry, rotating to the next sector(s) until it fits */
+static int _nvs_append_rotate(struct nvs_fs *fs, struct nvs_entry *entry)
+{
+	int rc;
+	int rot_cnt = 0;
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	off_t wr_sector;
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+
+	while (1) {
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+		wr_sector = fs->write_location & ~(fs->sector_size - 1);
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+		rc = nvs_append(fs, entry);
+		if (rc) {
+			if (rc == NVS_STATUS_NOSPACE) {
+				if (fs->free_space == 0) {
+					/* if we get here when there is no
+					 * free_space available this means
+					 * even deletes fails, we just
+					 * give up and say the file system
+					 * is full
+					 */
+					return -ENOSPC;
+				}
+				if (rot_cnt == fs->sector_count) {
+					fs->free_space = 0;
+					return -ENOSPC;
+				}
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+				if (_nvs_gc_sync(fs, wr_sector)) {
+					/* rotated in the background, retry */
+					continue;
+				}
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+				if (nvs_rotate(fs)) {
+					return rc;
+				}
+				rot_cnt++;
+			} else {
+				return -ENOSPC;
+			}
+		} else {
+			return 0;
+		}
+	}
+}
+
 ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 {
 	int rc, entry_cmp;
-	int rot_cnt = 0;
 	u16_t free_up, entry_len_fl, hdr_len, slt_len;
 	struct nvs_entry entry, stored_entry;
 	off_t stored_entry_addr;
 
 
-	if ((id == NVS_ID_EMPTY) ||
-	    (id == NVS_ID_SECTOR_END) ||
+	if (_nvs_id_is_special(id) ||
 	    (len > fs->max_len) ||
 	    ((len > 0) && (data == NULL))) {
 		return -EINVAL;
@@ -746,7 +1156,7 @@ ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 	if ((!len) || IS_ENABLED(CONFIG_NVS_PROTECT_FLASH)) {
 		/* find item to delete or check rewriting same data  */
 		stored_entry.id = id;
-		rc = nvs_get_last_entry(fs, &stored_entry);
+		rc = _nvs_get_latest_entry(fs, &stored_entry);
 		if (!rc) {
 			entry_len_fl = _nvs_len_in_flash(fs, len);
 			if (stored_entry.len == entry_len_fl) {
@@ -766,36 +1176,9 @@ ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 	entry.id = id;
 	entry.len = len;
 	/* new data or data has changed */
-	while (1) {
-		rc = nvs_append(fs, &entry);
-		if (rc) {
-			if (rc == NVS_STATUS_NOSPACE) {
-				if (fs->free_space == 0) {
-					/* if we get here when there is no
-					 * free_space available this means
-					 * even deletes fails, we just
-					 * give up and say the file system
-					 * is full
-					 */
-					rc = -ENOSPC;
-					goto err;
-				}
-				if (rot_cnt == fs->sector_count) {
-					fs->free_space = 0;
-					rc = -ENOSPC;
-					goto err;
-				}
-				if (nvs_rotate(fs)) {
-					goto err;
-				}
-				rot_cnt++;
-			} else {
-				rc = -ENOSPC;
-				goto err;
-			}
-		} else {
-			break;
-		}
+	rc = _nvs_append_rotate(fs, &entry);
+	if (rc) {
+		goto err;
 	}
 	rc = nvs_flash_write(fs, entry.data_addr, data, entry.len);
 	if (rc) {
@@ -805,6 +1188,15 @@ ssize_t nvs_write(struct nvs_fs *fs, u16_t id, const void *data, size_t len)
 	if (rc) {
 		goto err;
 	}
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	_nvs_lookup_update(fs, entry.id, entry.data_addr,
+			   _nvs_len_in_flash(fs, entry.len));
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	if (_nvs_gc_due(fs)) {
+		k_work_submit_to_queue(&nvs_gc_work_q, &fs->gc_work);
+	}
+#endif /* CONFIG_NVS_BACKGROUND_GC */
 	if ((!entry.len) && (fs->free_space < fs->max_len)) {
 		/* freeing up space by deleting */
 		hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_hdr));
@@ -822,17 +1214,115 @@ int nvs_delete(struct nvs_fs *fs, u16_t id)
 	return nvs_write(fs, id, NULL, 0);
 }
 
+#if defined(CONFIG_NVS_BATCH)
+void nvs_batch_init(struct nvs_batch *batch, void *buf, size_t size)
+{
+	batch->buf = buf;
+	batch->size = size;
+	batch->used = 0;
+}
+
+/* stage an entry in the batch buffer, laid out as it will be in flash:
+ * header, data and slot, with the crc computed here
+ */
+int nvs_batch_write(struct nvs_fs *fs, struct nvs_batch *batch, u16_t id,
+		    const void *data, size_t len)
+{
+	struct _nvs_data_hdr data_hdr;
+	struct _nvs_data_slt data_slt;
+	u16_t hdr_len, data_len, entry_len;
+	u8_t *ptr;
+
+	if (_nvs_id_is_special(id) ||
+	    (len > fs->max_len) ||
+	    ((len > 0) && (data == NULL))) {
+		return -EINVAL;
+	}
+	entry_len = _nvs_entry_len_in_flash(fs, len);
+	/* the batch is written as a single entry */
+	if (batch->used + entry_len > min(batch->size, fs->max_len)) {
+		return -ENOMEM;
+	}
+	hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_hdr));
+	data_len = _nvs_len_in_flash(fs, len);
+	ptr = batch->buf + batch->used;
+	memset(ptr, 0xff, entry_len);
+
+	data_hdr.id = id;
+	data_hdr.len = data_len;
+	memcpy(ptr, &data_hdr, sizeof(data_hdr));
+	if (len) {
+		memcpy(ptr + hdr_len, data, len);
+	}
+	data_slt.crc16 = crc16_ccitt(0xFFFF, ptr + hdr_len, data_len);
+	memcpy(ptr + hdr_len + data_len, &data_slt, sizeof(data_slt));
+
+	batch->used += entry_len;
+	return 0;
+}
+
+int nvs_batch_commit(struct nvs_fs *fs, struct nvs_batch *batch)
+{
+	int rc;
+	struct nvs_entry entry;
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	struct _nvs_data_hdr data_hdr;
+	u16_t hdr_len, offset;
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+
+	if (!batch->used) {
+		return 0;
+	}
+	if (fs->free_space < fs->max_len) {
+		return -ENOSPC;
+	}
+	entry.id = NVS_ID_BATCH;
+	entry.len = batch->used;
+	rc = _nvs_append_rotate(fs, &entry);
+	if (rc) {
+		return rc;
+	}
+	/* all staged entries go out in one write */
+	rc = nvs_flash_write(fs, entry.data_addr, batch->buf, batch->used);
+	if (rc) {
+		return rc;
+	}
+	/* the crc of the batch commits all of its entries at once */
+	rc = nvs_append_close(fs, &entry);
+	if (rc) {
+		return rc;
+	}
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	hdr_len = _nvs_len_in_flash(fs, sizeof(struct _nvs_data_hdr));
+	for (offset = 0; offset < batch->used;
+	     offset += _nvs_entry_len_in_flash(fs, data_hdr.len)) {
+		memcpy(&data_hdr, batch->buf + offset, sizeof(data_hdr));
+		_nvs_lookup_update(fs, data_hdr.id,
+				   entry.data_addr + offset + hdr_len,
+				   data_hdr.len);
+	}
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	if (_nvs_gc_due(fs)) {
+		k_work_submit_to_queue(&nvs_gc_work_q, &fs->gc_work);
+	}
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+	batch->used = 0;
+	return 0;
+}
+#endif /* CONFIG_NVS_BATCH */
+
 ssize_t nvs_read(struct nvs_fs *fs, u16_t id, void *data, size_t len)
 {
 	int rc;
 	struct nvs_entry entry;
 
-	if ((id == NVS_ID_EMPTY) || (id == NVS_ID_SECTOR_END)) {
+	if (_nvs_id_is_special(id)) {
 		return -EINVAL;
 	}
 	entry.id = id;
 	/* Read last entry */
-	rc = nvs_get_last_entry(fs, &entry);
+	rc = _nvs_get_latest_entry(fs, &entry);
 	if (entry.len == 0) {
 		return -ENOENT;
 	}
@@ -859,21 +1349,22 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 {
 	int rc;
 	struct nvs_entry entry;
+	off_t batch_end;
 	u16_t cnt_his;
 
-	if ((id == NVS_ID_EMPTY) || (id == NVS_ID_SECTOR_END)) {
+	if (_nvs_id_is_special(id)) {
 		return -EINVAL;
 	}
 	entry.id = id;
 	/* Read history entry */
 	/* First find out how many entries are in the history */
-	rc = nvs_get_first_entry(fs, &entry);
+	rc = nvs_get_first_entry(fs, &entry, &batch_end);
 	if (rc) {
 		goto err;
 	}
 	cnt_his = 0;
 	while (1) {
-		rc = nvs_walk_entry(fs, &entry);
+		rc = nvs_walk_entry(fs, &entry, &batch_end);
 		if (rc) {
 			break;
 		}
@@ -889,7 +1380,7 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 	/* Now get the correct item by decreasing cnt_his until cnt
 	 * is reached
 	 */
-	rc = nvs_get_first_entry(fs, &entry);
+	rc = nvs_get_first_entry(fs, &entry, &batch_end);
 	if (rc) {
 		goto err;
 	}
@@ -897,7 +1388,7 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, u16_t id, void *data, size_t len,
 		if (cnt_his == cnt) {
 			break;
 		}
-		rc = nvs_walk_entry(fs, &entry);
+		rc = nvs_walk_entry(fs, &entry, &batch_end);
 		if (rc) {
 			break;
 		}
@@ -23,6 +23,7 @@ extern "C" {
  */
 #define NVS_ID_EMPTY      0xFFFF
 #define NVS_ID_SECTOR_END 0xFFFE
+#define NVS_ID_BATCH      0xFFFD
 /*
  * Status return values
  */
@@ -56,8 +57,10 @@ struct _nvs_data_slt {
 int nvs_append(struct nvs_fs *fs, struct nvs_entry *entry);
 int nvs_append_close(struct nvs_fs *fs, const struct nvs_entry *entry);
 void nvs_set_start_entry(struct nvs_fs *fs, struct nvs_entry *entry);
-int nvs_walk_entry(struct nvs_fs *fs, struct nvs_entry *entry);
-int nvs_get_first_entry(struct nvs_fs *fs, struct nvs_entry *entry);
+int nvs_walk_entry(struct nvs_fs *fs, struct nvs_entry *entry,
+		   off_t *batch_end);
+int nvs_get_first_entry(struct nvs_fs *fs, struct nvs_entry *entry,
+			off_t *batch_end);
 int nvs_get_last_entry(struct nvs_fs *fs, struct nvs_entry *entry);
 int nvs_check_crc(struct nvs_fs *fs, struct nvs_entry *entry);
 int nvs_rotate(struct nvs_fs *fs);
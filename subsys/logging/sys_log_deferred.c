@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Deferred output of the system log: the logging call only stores the
+ * format string pointer and the raw arguments in a ring buffer, a low
+ * priority thread formats and outputs the messages later on.
+ *
+ * Message layout, in 32-bit words after the ring buffer header (whose
+ * type is the log level):
+ *
+ *   format string pointer
+ *   one word per integer argument, two for long long arguments
+ *   for strings, either the pointer to a string in read-only data, or 0
+ *   followed by a copy of the string, null terminated and padded to a
+ *   whole word
+ */
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <ring_buffer.h>
+#include <linker/linker-defs.h>
+#include <misc/printk.h>
+
+/* the backend is needed whatever the default level */
+#define SYS_LOG_LEVEL SYS_LOG_LEVEL_DEBUG
+#include <logging/sys_log.h>
+
+#define MSG_WORDS (CONFIG_SYS_LOG_DEFERRED_MSG_SIZE / sizeof(u32_t))
+
+SYS_RING_BUF_DECLARE_SIZE(log_buf,
+			  CONFIG_SYS_LOG_DEFERRED_BUF_SIZE / sizeof(u32_t));
+
+static K_SEM_DEFINE(log_sem, 0, 1);
+
+struct log_filter {
+	const char *domain;
+	int level;
+};
+
+static struct log_filter log_filters[CONFIG_SYS_LOG_DEFERRED_FILTERS];
+static bool log_filters_used;
+
+enum arg_type {
+	ARG_NONE,
+	ARG_INT,
+	ARG_LONG_LONG,
+	ARG_STR,
+};
+
+/* Skip a conversion specification, fmt points after the '%' */
+static const char *parse_conversion(const char *fmt, enum arg_type *type)
+{
+	int longs = 0;
+
+	/* flags, width and precision */
+	while (*fmt && strchr("-+ #0123456789.", *fmt)) {
+		fmt++;
+	}
+
+	for (; *fmt == 'l' || *fmt == 'h' || *fmt == 'z'; fmt++) {
+		longs += *fmt == 'l';
+	}
+
+	switch (*fmt) {
+	case '\0':
+		*type = ARG_NONE;
+		return fmt;
+	case 's':
+		*type = ARG_STR;
+		break;
+	case 'd':
+	case 'i':
+	case 'u':
+	case 'o':
+	case 'x':
+	case 'X':
+		*type = (longs > 1) ? ARG_LONG_LONG : ARG_INT;
+		break;
+	case 'c':
+	case 'p':
+		*type = ARG_INT;
+		break;
+	default:
+		*type = ARG_NONE;
+		break;
+	}
+
+	return fmt + 1;
+}
+
+static inline bool is_rodata(const char *str)
+{
+	return str >= _image_rodata_start && str < _image_rodata_end;
+}
+
+static bool log_filtered(const char *domain, int level)
+{
+	int i;
+
+	if (!log_filters_used) {
+		return false;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(log_filters); i++) {
+		if (log_filters[i].domain &&
+		    !strcmp(log_filters[i].domain, domain)) {
+			return level > log_filters[i].level;
+		}
+	}
+
+	return false;
+}
+
+/* Store a string argument at msg[n], return the words used or 0 */
+static unsigned int put_str(u32_t *msg, unsigned int n, const char *str)
+{
+	size_t len, room;
+
+	if (n >= MSG_WORDS) {
+		return 0;
+	}
+
+	if (str && is_rodata(str)) {
+		msg[n] = (u32_t)str;
+		return 1;
+	}
+
+	if (!str) {
+		str = "(null)";
+	}
+
+	room = (MSG_WORDS - n - 1) * sizeof(u32_t);
+	if (!room) {
+		return 0;
+	}
+
+	/* truncate strings which don't fit */
+	len = min(strlen(str), room - 1);
+
+	msg[n] = 0;
+	memcpy(&msg[n + 1], str, len);
+	((char *)&msg[n + 1])[len] = '\0';
+
+	return 1 + (len + sizeof(u32_t)) / sizeof(u32_t);
+}
+
+void sys_log_deferred(int level, const char *domain, const char *fmt, ...)
+{
+	u32_t msg[MSG_WORDS];
+	unsigned int n = 0, words = 0;
+	enum arg_type type;
+	unsigned int key;
+	va_list ap;
+	u64_t ll;
+	int ret;
+
+	if (log_filtered(domain, level)) {
+		return;
+	}
+
+	msg[n++] = (u32_t)fmt;
+
+	va_start(ap, fmt);
+
+	/* arguments which don't fit are left out of the message */
+	while ((fmt = strchr(fmt, '%')) != NULL) {
+		fmt = parse_conversion(fmt + 1, &type);
+
+		switch (type) {
+		case ARG_INT:
+			words = (n < MSG_WORDS);
+			if (words) {
+				msg[n] = va_arg(ap, u32_t);
+			}
+			break;
+		case ARG_LONG_LONG:
+			words = (n + 1 < MSG_WORDS) ? 2 : 0;
+			if (words) {
+				ll = va_arg(ap, u64_t);
+				memcpy(&msg[n], &ll, sizeof(ll));
+			}
+			break;
+		case ARG_STR:
+			words = put_str(msg, n, va_arg(ap, const char *));
+			break;
+		default:
+			continue;
+		}
+
+		if (!words) {
+			break;
+		}
+
+		n += words;
+	}
+
+	va_end(ap);
+
+	key = irq_lock();
+	ret = sys_ring_buf_put(&log_buf, level, 0, msg, n);
+	irq_unlock(key);
+
+	if (!ret) {
+		k_sem_give(&log_sem);
+	}
+}
+
+int sys_log_filter_set(const char *domain, int level)
+{
+	struct log_filter *free = NULL;
+	unsigned int key;
+	int i;
+
+	if (level < SYS_LOG_LEVEL_OFF || level > SYS_LOG_LEVEL_DEBUG) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+
+	for (i = 0; i < ARRAY_SIZE(log_filters); i++) {
+		if (!log_filters[i].domain) {
+			free = free ? free : &log_filters[i];
+		} else if (!strcmp(log_filters[i].domain, domain)) {
+			log_filters[i].level = level;
+			irq_unlock(key);
+			return 0;
+		}
+	}
+
+	if (!free) {
+		irq_unlock(key);
+		return -ENOMEM;
+	}
+
+	free->level = level;
+	free->domain = domain;
+	log_filters_used = true;
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+/* Format a message the same way as printk() would have */
+static void log_output(const u32_t *msg, unsigned int words)
+{
+	char line[CONFIG_SYS_LOG_DEFERRED_LINE_SIZE];
+	const char *fmt = (const char *)msg[0];
+	const char *conv, *end;
+	unsigned int n = 1;
+	size_t pos = 0, len;
+	enum arg_type type;
+	const char *str;
+	size_t room;
+	char spec[16];
+	u64_t ll;
+	int ret;
+
+	while (*fmt) {
+		conv = strchr(fmt, '%');
+		if (!conv) {
+			conv = fmt + strlen(fmt);
+		}
+
+		len = min(conv - fmt, sizeof(line) - 1 - pos);
+		memcpy(line + pos, fmt, len);
+		pos += len;
+
+		if (!*conv) {
+			break;
+		}
+
+		end = parse_conversion(conv + 1, &type);
+		if (end - conv >= sizeof(spec)) {
+			break;
+		}
+
+		memcpy(spec, conv, end - conv);
+		spec[end - conv] = '\0';
+		room = sizeof(line) - pos;
+
+		switch (type) {
+		case ARG_INT:
+			if (n >= words) {
+				goto out;
+			}
+			ret = snprintk(line + pos, room, spec, msg[n++]);
+			break;
+		case ARG_LONG_LONG:
+			if (n + 1 >= words) {
+				goto out;
+			}
+			memcpy(&ll, &msg[n], sizeof(ll));
+			n += 2;
+			ret = snprintk(line + pos, room, spec, ll);
+			break;
+		case ARG_STR:
+			if (n >= words) {
+				goto out;
+			}
+			str = (const char *)msg[n++];
+			if (!str) {
+				str = (const char *)&msg[n];
+				n += (strlen(str) + sizeof(u32_t)) /
+				     sizeof(u32_t);
+			}
+			ret = snprintk(line + pos, room, spec, str);
+			break;
+		default:
+			ret = snprintk(line + pos, room, spec);
+			break;
+		}
+
+		if (ret > 0) {
+			pos = min(pos + ret, sizeof(line) - 1);
+		}
+
+		fmt = end;
+	}
+
+out:
+	line[pos] = '\0';
+	SYS_LOG_BACKEND_FN("%s", line);
+}
+
+static void log_thread(void *p1, void *p2, void *p3)
+{
+	u32_t msg[MSG_WORDS];
+	u32_t dropped;
+	unsigned int key;
+	u16_t level;
+	u8_t value;
+	u8_t words;
+	int ret;
+
+	while (1) {
+		k_sem_take(&log_sem, K_FOREVER);
+
+		do {
+			words = MSG_WORDS;
+
+			key = irq_lock();
+			ret = sys_ring_buf_get(&log_buf, &level, &value, msg,
+					       &words);
+			dropped = log_buf.dropped_put_count;
+			log_buf.dropped_put_count = 0;
+			irq_unlock(key);
+
+			if (dropped) {
+				SYS_LOG_BACKEND_FN("--- %u messages dropped"
+						   " ---\n", dropped);
+			}
+
+			if (!ret) {
+				log_output(msg, words);
+			}
+		} while (!ret);
+	}
+}
+
+K_THREAD_DEFINE(sys_log_thread, CONFIG_SYS_LOG_DEFERRED_STACK_SIZE,
+		log_thread, NULL, NULL, NULL,
+		CONFIG_SYS_LOG_DEFERRED_THREAD_PRIORITY, 0, K_NO_WAIT);
@@ -49,6 +49,189 @@ struct net_buf_pool *get_data_pool(void)
 	return &syslog_tx_bufs;
 }
 
+#if defined(CONFIG_SYS_LOG_BACKEND_NET_BATCH)
+/* Records are collected in batch[], one per line, and sent together in
+ * one datagram when the next record doesn't fit or when the batch timeout
+ * expires. The batch is protected by irq_lock() as the hook can be called
+ * from any context.
+ */
+static char batch[CONFIG_SYS_LOG_BACKEND_NET_MAX_BUF_SIZE];
+static size_t batch_len;
+static u32_t batch_records;
+static u32_t dropped;
+static struct k_delayed_work flush_work;
+
+#if CONFIG_SYS_LOG_BACKEND_NET_RATE > 0
+static u32_t rate_start;
+static u32_t rate_count;
+
+static bool rate_exceeded(void)
+{
+	u32_t now = k_uptime_get_32();
+
+	if (now - rate_start >= MSEC_PER_SEC) {
+		rate_start = now;
+		rate_count = 0;
+	}
+
+	return ++rate_count > CONFIG_SYS_LOG_BACKEND_NET_RATE;
+}
+#else
+#define rate_exceeded() false
+#endif
+
+static int append_header(char *ptr, size_t size)
+{
+	return snprintk(ptr, size, "<%d>1 %s %s - - - - ",
+			facility * 8 + severity, date, hostname);
+}
+
+/* Move the batch to a packet, called with interrupts locked */
+static struct net_pkt *take_batch(void)
+{
+	struct net_pkt *pkt = NULL;
+	struct net_buf *frag;
+
+	if (!batch_len) {
+		return NULL;
+	}
+
+	if (rate_exceeded()) {
+		goto drop;
+	}
+
+	pkt = net_pkt_get_tx(ctx, K_NO_WAIT);
+	if (!pkt) {
+		goto drop;
+	}
+
+	frag = net_pkt_get_data(ctx, K_NO_WAIT);
+	if (!frag) {
+		net_pkt_unref(pkt);
+		goto drop;
+	}
+
+	net_pkt_frag_add(pkt, frag);
+
+	/* the last record ends with a line feed, no need to send it */
+	net_buf_add_mem(frag, batch, batch_len - 1);
+
+#if DEBUG_PRINTING
+	printk("%u records:\n%s", batch_records, batch);
+#endif
+	batch_len = 0;
+	batch_records = 0;
+
+	return pkt;
+
+drop:
+	dropped += batch_records;
+	batch_len = 0;
+	batch_records = 0;
+
+	return NULL;
+}
+
+static void send_batch(struct net_pkt *pkt)
+{
+	if (pkt && net_context_send(pkt, NULL, K_NO_WAIT, NULL, NULL) < 0) {
+		net_pkt_unref(pkt);
+	}
+}
+
+static void flush_handler(struct k_work *work)
+{
+	unsigned int key = irq_lock();
+	struct net_pkt *pkt = take_batch();
+
+	irq_unlock(key);
+
+	send_batch(pkt);
+}
+
+/* Append a record, return false if it doesn't fit */
+static bool append_record(const char *fmt, va_list vargs)
+{
+	size_t room = sizeof(batch) - batch_len;
+	char *ptr = batch + batch_len;
+	int hdr, ret;
+
+	hdr = append_header(ptr, room);
+	if (hdr < 0 || hdr >= room) {
+		return false;
+	}
+
+	ret = vsnprintk(ptr + hdr, room - hdr, fmt, vargs);
+	if (ret < 0 || hdr + ret >= room) {
+		return false;
+	}
+
+	ret += hdr;
+	if (!ret || ptr[ret - 1] != '\n') {
+		if (ret + 1 >= room) {
+			return false;
+		}
+
+		ptr[ret++] = '\n';
+		ptr[ret] = '\0';
+	}
+
+	batch_len += ret;
+	batch_records++;
+
+	return true;
+}
+
+static void syslog_hook_net(const char *fmt, ...)
+{
+	struct net_pkt *pkt = NULL;
+	unsigned int key;
+	va_list vargs;
+	u32_t count;
+	bool start;
+
+	key = irq_lock();
+
+	if (dropped) {
+		/* report the records lost since the last successful send */
+		count = dropped;
+		dropped = 0;
+		irq_unlock(key);
+
+		syslog_hook_net("--- %u messages dropped ---", count);
+
+		key = irq_lock();
+	}
+
+	start = !batch_len;
+
+	va_start(vargs, fmt);
+	if (!append_record(fmt, vargs)) {
+		va_end(vargs);
+
+		pkt = take_batch();
+		start = true;
+
+		va_start(vargs, fmt);
+		if (!append_record(fmt, vargs)) {
+			/* too long for a datagram, send it truncated */
+			batch_len = sizeof(batch) - 1;
+			batch[batch_len - 1] = '\n';
+			batch_records = 1;
+		}
+	}
+	va_end(vargs);
+
+	irq_unlock(key);
+
+	send_batch(pkt);
+
+	if (start) {
+		k_delayed_work_submit(&flush_work,
+				      CONFIG_SYS_LOG_BACKEND_NET_BATCH_TIMEOUT);
+	}
+}
+#else
 static void fill_header(struct net_buf *buf)
 {
 	snprintk(net_buf_tail(buf),
@@ -115,6 +298,7 @@ static void syslog_hook_net(const char *fmt, ...)
 		net_pkt_unref(pkt);
 	}
 }
+#endif /* CONFIG_SYS_LOG_BACKEND_NET_BATCH */
 
 void syslog_net_hook_install(void)
 {
@@ -227,5 +411,9 @@ void syslog_net_hook_install(void)
 
 	net_context_setup_pools(ctx, get_tx_slab, get_data_pool);
 
+#if defined(CONFIG_SYS_LOG_BACKEND_NET_BATCH)
+	k_delayed_work_init(&flush_work, flush_handler);
+#endif
+
 	syslog_hook_install(syslog_hook_net);
 }
@@ -12,12 +12,14 @@
 
 #include <zephyr.h>
 #include <init.h>
+#include <misc/byteorder.h>
 #include <bluetooth/bluetooth.h>
 #include <bluetooth/uuid.h>
 #include <bluetooth/gatt.h>
 
 #include <mgmt/smp_bt.h>
 #include <mgmt/buf.h>
+#include <mgmt/mgmt.h>
 
 #include <mgmt/smp.h>
 
@@ -25,6 +27,9 @@ struct device;
 
 static struct zephyr_smp_transport smp_bt_transport;
 
+/* Request being reassembled from several writes. */
+static struct net_buf *smp_bt_rx_nb;
+
 /* SMP service.
  * {8D53DC1D-1DB7-4CD3-868B-8A527460AA84}
  */
@@ -39,8 +44,26 @@ static struct bt_uuid_128 smp_bt_chr_uuid = BT_UUID_INIT_128(
 	0x48, 0x7c, 0x99, 0x74, 0x11, 0x26, 0x9e, 0xae,
 	0x01, 0x4e, 0xce, 0xfb, 0x28, 0x78, 0x2e, 0xda);
 
+/**
+ * Indicates whether the specified net_buf holds a complete SMP request, as
+ * given by the payload length in its header.
+ */
+static bool smp_bt_req_complete(const struct net_buf *nb)
+{
+	struct mgmt_hdr hdr;
+
+	if (nb->len < sizeof(hdr)) {
+		return false;
+	}
+
+	memcpy(&hdr, nb->data, sizeof(hdr));
+	return nb->len >= sizeof(hdr) + sys_be16_to_cpu(hdr.nh_len);
+}
+
 /**
  * Write handler for the SMP characteristic; processes an incoming SMP request.
+ * A request larger than the ATT MTU is sent as consecutive writes, which are
+ * collected until the payload announced in the SMP header is complete.
  */
 static ssize_t smp_bt_chr_write(struct bt_conn *conn,
 				const struct bt_gatt_attr *attr,
@@ -50,12 +73,39 @@ static ssize_t smp_bt_chr_write(struct bt_conn *conn,
 	const bt_addr_le_t *addr;
 	struct net_buf *nb;
 
-	nb = mcumgr_buf_alloc();
+	addr = bt_conn_get_dst(conn);
+	nb = smp_bt_rx_nb;
+
+	/* Drop a partial request of another peer. */
+	if (nb != NULL && memcmp(net_buf_user_data(nb), addr, sizeof(*addr))) {
+		mcumgr_buf_free(nb);
+		nb = NULL;
+	}
+
+	if (nb == NULL) {
+		nb = mcumgr_buf_alloc();
+		if (nb == NULL) {
+			smp_bt_rx_nb = NULL;
+			return BT_GATT_ERR(BT_ATT_ERR_INSUFFICIENT_RESOURCES);
+		}
+
+		memcpy(net_buf_user_data(nb), addr, sizeof(*addr));
+	}
+
+	if (len > net_buf_tailroom(nb)) {
+		mcumgr_buf_free(nb);
+		smp_bt_rx_nb = NULL;
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+	}
+
 	net_buf_add_mem(nb, buf, len);
 
-	addr = bt_conn_get_dst(conn);
-	memcpy(net_buf_user_data(nb), addr, sizeof(*addr));
+	if (!smp_bt_req_complete(nb)) {
+		smp_bt_rx_nb = nb;
+		return len;
+	}
 
+	smp_bt_rx_nb = NULL;
 	zephyr_smp_rx_req(&smp_bt_transport, nb);
 
 	return len;
@@ -337,6 +337,9 @@ success:
 #if defined(CONFIG_NET_BUF_POOL_USAGE)
 	pool->avail_count--;
 	NET_BUF_ASSERT(pool->avail_count >= 0);
+	if (pool->avail_count < pool->min_avail_count) {
+		pool->min_avail_count = pool->avail_count;
+	}
 #endif
 
 	return buf;
@@ -47,6 +47,43 @@ static inline u8_t get_6co_cid(struct net_icmpv6_nd_opt_6co *opt)
 static struct net_6lo_context ctx_6co[CONFIG_NET_MAX_6LO_CONTEXTS];
 #endif
 
+/* The address part of the IPHC header is worked out on its own, into
+ * a buffer holding the second IPHC byte at [1], the context identifiers
+ * at [2] and the in-line address bytes from IPHC_ADDR_OFFSET on.
+ */
+#define IPHC_ADDR_OFFSET 3
+#define IPHC_ADDR_MAX_LEN (IPHC_ADDR_OFFSET + 2 * sizeof(struct in6_addr))
+
+#if defined(CONFIG_NET_6LO_IPHC_CACHE)
+/* Address compression of the recently seen neighbours. The elided forms
+ * depend on the link layer addresses, so these are part of the key.
+ */
+struct net_6lo_iphc_cache {
+	struct in6_addr src;
+	struct in6_addr dst;
+	struct net_if *iface;
+	u8_t ll_src[8];
+	u8_t ll_dst[8];
+	u8_t ll_src_len;
+	u8_t ll_dst_len;
+	u8_t addr_len;
+	u8_t addr[IPHC_ADDR_MAX_LEN];
+};
+
+static struct net_6lo_iphc_cache iphc_cache[CONFIG_NET_6LO_IPHC_CACHE_SIZE];
+
+static inline void iphc_cache_flush(void)
+{
+	unsigned int key = irq_lock();
+
+	memset(iphc_cache, 0, sizeof(iphc_cache));
+
+	irq_unlock(key);
+}
+#else
+#define iphc_cache_flush(...)
+#endif
+
 /* TODO: Unicast-Prefix based IPv6 Multicast(dst) address compression
  *       Mesh header compression
  */
@@ -109,6 +146,9 @@ void net_6lo_set_context(struct net_if *iface,
 	int unused = -1;
 	u8_t i;
 
+	/* Cached address compressions may depend on the old contexts */
+	iphc_cache_flush();
+
 	/* If the context information already exists, update or remove
 	 * as per data.
 	 */
@@ -197,7 +237,7 @@ get_6lo_context_by_addr(struct net_if *iface, struct in6_addr *addr)
  * DSCP(6), ECN(2).
  */
 static inline u8_t compress_tfl(struct net_ipv6_hdr *ipv6,
-				   struct net_buf *frag,
+				   u8_t *iphc,
 				   u8_t offset)
 {
 	u8_t tcl;
@@ -248,7 +288,7 @@ static inline u8_t compress_tfl(struct net_ipv6_hdr *ipv6,
 
 /* Helper to compress Hop limit */
 static inline u8_t compress_hoplimit(struct net_ipv6_hdr *ipv6,
-				     struct net_buf *frag,
+				     u8_t *iphc,
 				     u8_t offset)
 {
 	/* Hop Limit */
@@ -272,7 +312,7 @@ static inline u8_t compress_hoplimit(struct net_ipv6_hdr *ipv6,
 
 /* Helper to compress Next header */
 static inline u8_t compress_nh(struct net_ipv6_hdr *ipv6,
-			       struct net_buf *frag, u8_t offset)
+			       u8_t *iphc, u8_t offset)
 {
 	/* Next header */
 	if (ipv6->nexthdr == IPPROTO_UDP) {
@@ -287,7 +327,7 @@ static inline u8_t compress_nh(struct net_ipv6_hdr *ipv6,
 /* Helpers to compress Source Address */
 static inline u8_t compress_sa(struct net_ipv6_hdr *ipv6,
 			       struct net_pkt *pkt,
-			       struct net_buf *frag,
+			       u8_t *iphc,
 			       u8_t offset)
 {
 	if (net_is_ipv6_addr_unspecified(&ipv6->src)) {
@@ -352,12 +392,12 @@ static inline u8_t compress_sa(struct net_ipv6_hdr *ipv6,
 #if defined(CONFIG_NET_6LO_CONTEXT)
 static inline u8_t compress_sa_ctx(struct net_ipv6_hdr *ipv6,
 				   struct net_pkt *pkt,
-				   struct net_buf *frag,
+				   u8_t *iphc,
 				   u8_t offset,
 				   struct net_6lo_context *src)
 {
 	if (!src) {
-		return compress_sa(ipv6, pkt, frag, offset);
+		return compress_sa(ipv6, pkt, iphc, offset);
 	}
 
 	IPHC[1] |= NET_6LO_IPHC_SAC_1;
@@ -393,7 +433,7 @@ static inline u8_t compress_sa_ctx(struct net_ipv6_hdr *ipv6,
 /* Helpers to compress Destination Address */
 static inline u8_t compress_da_mcast(struct net_ipv6_hdr *ipv6,
 				     struct net_pkt *pkt,
-				     struct net_buf *frag,
+				     u8_t *iphc,
 				     u8_t offset)
 {
 	IPHC[1] |= NET_6LO_IPHC_M_1;
@@ -444,12 +484,12 @@ static inline u8_t compress_da_mcast(struct net_ipv6_hdr *ipv6,
 
 static inline u8_t compress_da(struct net_ipv6_hdr *ipv6,
 			       struct net_pkt *pkt,
-			       struct net_buf *frag,
+			       u8_t *iphc,
 			       u8_t offset)
 {
 	/* If destination address is multicast */
 	if (net_is_ipv6_addr_mcast(&ipv6->dst)) {
-		return compress_da_mcast(ipv6, pkt, frag, offset);
+		return compress_da_mcast(ipv6, pkt, iphc, offset);
 	}
 
 	/* If address is link-local prefix and padded with zeros */
@@ -502,12 +542,12 @@ static inline u8_t compress_da(struct net_ipv6_hdr *ipv6,
 #if defined(CONFIG_NET_6LO_CONTEXT)
 static inline u8_t compress_da_ctx(struct net_ipv6_hdr *ipv6,
 				   struct net_pkt *pkt,
-				   struct net_buf *frag,
+				   u8_t *iphc,
 				   u8_t offset,
 				   struct net_6lo_context *dst)
 {
 	if (!dst) {
-		return compress_da(ipv6, pkt, frag, offset);
+		return compress_da(ipv6, pkt, iphc, offset);
 	}
 
 	IPHC[1] |= NET_6LO_IPHC_DAC_1;
@@ -544,7 +584,7 @@ static inline u8_t compress_da_ctx(struct net_ipv6_hdr *ipv6,
 
 /* Helper to compress Next header UDP */
 static inline u8_t compress_nh_udp(struct net_udp_hdr *udp,
-				   struct net_buf *frag, u8_t offset)
+				   u8_t *iphc, u8_t offset)
 {
 	u8_t tmp;
 
@@ -629,7 +669,7 @@ static inline u8_t compress_nh_udp(struct net_udp_hdr *udp,
 #if defined(CONFIG_NET_6LO_CONTEXT)
 static inline bool is_src_and_dst_addr_ctx_based(struct net_ipv6_hdr *ipv6,
 						 struct net_pkt *pkt,
-						 struct net_buf *frag,
+						 u8_t *iphc,
 						 struct net_6lo_context **src,
 						 struct net_6lo_context **dst)
 {
@@ -668,6 +708,143 @@ static inline bool is_src_and_dst_addr_ctx_based(struct net_ipv6_hdr *ipv6,
 
 #endif
 
+/* Helper to compress Source and Destination Address */
+static inline u8_t compress_addr(struct net_ipv6_hdr *ipv6,
+				 struct net_pkt *pkt,
+				 u8_t *iphc)
+{
+#if defined(CONFIG_NET_6LO_CONTEXT)
+	struct net_6lo_context *src = NULL;
+	struct net_6lo_context *dst = NULL;
+#endif
+	u8_t offset = IPHC_ADDR_OFFSET;
+
+	IPHC[1] = 0;
+	IPHC[2] = 0;
+
+#if defined(CONFIG_NET_6LO_CONTEXT)
+	is_src_and_dst_addr_ctx_based(ipv6, pkt, iphc, &src, &dst);
+#endif
+
+	/* Source Address Compression */
+#if defined(CONFIG_NET_6LO_CONTEXT)
+	offset = compress_sa_ctx(ipv6, pkt, iphc, offset, src);
+#else
+	offset = compress_sa(ipv6, pkt, iphc, offset);
+#endif
+	if (!offset) {
+		return 0;
+	}
+
+	/* Destination Address Compression */
+#if defined(CONFIG_NET_6LO_CONTEXT)
+	offset = compress_da_ctx(ipv6, pkt, iphc, offset, dst);
+#else
+	offset = compress_da(ipv6, pkt, iphc, offset);
+#endif
+
+	return offset;
+}
+
+#if defined(CONFIG_NET_6LO_IPHC_CACHE)
+static inline struct net_6lo_iphc_cache *
+iphc_cache_entry(struct net_ipv6_hdr *ipv6)
+{
+	u32_t hash;
+
+	hash = UNALIGNED_GET(&ipv6->src.s6_addr32[3]) ^
+	       UNALIGNED_GET(&ipv6->dst.s6_addr32[3]);
+
+	return &iphc_cache[hash % CONFIG_NET_6LO_IPHC_CACHE_SIZE];
+}
+
+static inline bool iphc_cache_ll_cmp(const u8_t *addr, u8_t len,
+				     struct net_linkaddr *lladdr)
+{
+	u8_t ll_len = lladdr->addr ? lladdr->len : 0;
+
+	return len == ll_len && (!len || !memcmp(addr, lladdr->addr, len));
+}
+
+static inline bool iphc_cache_match(struct net_6lo_iphc_cache *entry,
+				    struct net_ipv6_hdr *ipv6,
+				    struct net_pkt *pkt)
+{
+	return entry->iface == net_pkt_iface(pkt) &&
+		net_ipv6_addr_cmp(&entry->src, &ipv6->src) &&
+		net_ipv6_addr_cmp(&entry->dst, &ipv6->dst) &&
+		iphc_cache_ll_cmp(entry->ll_src, entry->ll_src_len,
+				  net_pkt_ll_src(pkt)) &&
+		iphc_cache_ll_cmp(entry->ll_dst, entry->ll_dst_len,
+				  net_pkt_ll_dst(pkt));
+}
+
+static inline void iphc_cache_ll_set(u8_t *addr, u8_t *len,
+				     struct net_linkaddr *lladdr)
+{
+	*len = lladdr->addr ? lladdr->len : 0;
+	if (*len) {
+		memcpy(addr, lladdr->addr, *len);
+	}
+}
+
+static u8_t compress_addr_cached(struct net_ipv6_hdr *ipv6,
+				 struct net_pkt *pkt,
+				 u8_t *iphc)
+{
+	struct net_6lo_iphc_cache *entry;
+	unsigned int key;
+	u8_t offset;
+
+	if ((net_pkt_ll_src(pkt)->addr &&
+	     net_pkt_ll_src(pkt)->len > sizeof(entry->ll_src)) ||
+	    (net_pkt_ll_dst(pkt)->addr &&
+	     net_pkt_ll_dst(pkt)->len > sizeof(entry->ll_dst))) {
+		return compress_addr(ipv6, pkt, iphc);
+	}
+
+	entry = iphc_cache_entry(ipv6);
+
+	key = irq_lock();
+
+	if (entry->iface && iphc_cache_match(entry, ipv6, pkt)) {
+		offset = entry->addr_len;
+		memcpy(iphc, entry->addr, offset);
+
+		irq_unlock(key);
+
+		NET_DBG("Address compression cached");
+
+		return offset;
+	}
+
+	irq_unlock(key);
+
+	offset = compress_addr(ipv6, pkt, iphc);
+	if (!offset) {
+		return 0;
+	}
+
+	key = irq_lock();
+
+	net_ipaddr_copy(&entry->src, &ipv6->src);
+	net_ipaddr_copy(&entry->dst, &ipv6->dst);
+	entry->iface = net_pkt_iface(pkt);
+	iphc_cache_ll_set(entry->ll_src, &entry->ll_src_len,
+			  net_pkt_ll_src(pkt));
+	iphc_cache_ll_set(entry->ll_dst, &entry->ll_dst_len,
+			  net_pkt_ll_dst(pkt));
+	entry->addr_len = offset;
+	memcpy(entry->addr, iphc, offset);
+
+	irq_unlock(key);
+
+	return offset;
+}
+#else
+#define compress_addr_cached compress_addr
+#endif
+
 /* RFC 6282 LOWPAN IPHC Encoding format (3.1)
  *  Base Format
  *   0                                       1
@@ -675,77 +852,59 @@ static inline bool is_src_and_dst_addr_ctx_based(struct net_ipv6_hdr *ipv6,
  * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
  * | 0 | 1 | 1 |  TF   |NH | HLIM  |CID|SAC|  SAM  | M |DAC|  DAM  |
  * +---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+---+
+ *
+ * The header is built on the stack and written over the uncompressed
+ * one, which is never shorter.
  */
 static inline bool compress_IPHC_header(struct net_pkt *pkt,
 					fragment_handler_t fragment)
 {
-#if defined(CONFIG_NET_6LO_CONTEXT)
-	struct net_6lo_context *src = NULL;
-	struct net_6lo_context *dst = NULL;
-#endif
 	struct net_ipv6_hdr *ipv6 = NET_IPV6_HDR(pkt);
+	u8_t iphc[NET_6LO_IPHC_MAX_LEN];
+	u8_t addr[IPHC_ADDR_MAX_LEN];
+	struct net_buf *frag = pkt->frags;
 	u8_t offset = 0;
-	struct net_buf *frag;
 	u8_t compressed;
+	u8_t addr_len;
 
-	if (pkt->frags->len < NET_IPV6H_LEN) {
+	if (frag->len < NET_IPV6H_LEN) {
 		NET_ERR("Invalid length %d, min %d",
-			pkt->frags->len, NET_IPV6H_LEN);
+			frag->len, NET_IPV6H_LEN);
 		return false;
 	}
 
 	if (ipv6->nexthdr == IPPROTO_UDP &&
-	    pkt->frags->len < NET_IPV6UDPH_LEN) {
+	    frag->len < NET_IPV6UDPH_LEN) {
 		NET_ERR("Invalid length %d, min %d",
-			pkt->frags->len, NET_IPV6UDPH_LEN);
+			frag->len, NET_IPV6UDPH_LEN);
 		return false;
 	}
 
-	frag = net_pkt_get_frag(pkt, K_FOREVER);
-	if (!frag) {
+	addr_len = compress_addr_cached(ipv6, pkt, addr);
+	if (!addr_len) {
 		return false;
 	}
 
 	IPHC[offset++] = NET_6LO_DISPATCH_IPHC;
-	IPHC[offset++] = 0;
+	IPHC[offset++] = addr[1];
 
-#if defined(CONFIG_NET_6LO_CONTEXT)
-	if (is_src_and_dst_addr_ctx_based(ipv6, pkt, frag, &src, &dst)) {
-		offset++;
+	if (addr[1] & NET_6LO_IPHC_CID_1) {
+		IPHC[offset++] = addr[2];
 	}
-#endif
 
 	/* Compress Traffic class and Flow lablel */
-	offset = compress_tfl(ipv6, frag, offset);
+	offset = compress_tfl(ipv6, iphc, offset);
 
 	/* Next Header */
-	offset = compress_nh(ipv6, frag, offset);
+	offset = compress_nh(ipv6, iphc, offset);
 
 	/* Hop limit */
-	offset = compress_hoplimit(ipv6, frag, offset);
-
-	/* Source Address Compression */
-#if defined(CONFIG_NET_6LO_CONTEXT)
-	offset = compress_sa_ctx(ipv6, pkt, frag, offset, src);
-#else
-	offset = compress_sa(ipv6, pkt, frag, offset);
-#endif
-	if (!offset) {
-		net_pkt_frag_unref(frag);
-		return false;
-	}
+	offset = compress_hoplimit(ipv6, iphc, offset);
 
-	/* Destination Address Compression */
-#if defined(CONFIG_NET_6LO_CONTEXT)
-	offset = compress_da_ctx(ipv6, pkt, frag, offset, dst);
-#else
-	offset = compress_da(ipv6, pkt, frag, offset);
-#endif
-
-	if (!offset) {
-		net_pkt_frag_unref(frag);
-		return false;
-	}
+	/* Source and Destination Address */
+	memcpy(&IPHC[offset], &addr[IPHC_ADDR_OFFSET],
+	       addr_len - IPHC_ADDR_OFFSET);
+	offset += addr_len - IPHC_ADDR_OFFSET;
 
 	compressed = NET_IPV6H_LEN;
 
@@ -765,29 +924,29 @@ static inline bool compress_IPHC_header(struct net_pkt *pkt,
 		}
 
 		IPHC[offset] = NET_6LO_NHC_UDP_BARE;
-		offset = compress_nh_udp(udp, frag, offset);
+		offset = compress_nh_udp(udp, iphc, offset);
 
 		compressed += NET_UDPH_LEN;
-
-		net_udp_set_hdr(pkt, udp);
 	}
 
 end:
-	net_buf_add(frag, offset);
+	NET_ASSERT(offset <= compressed);
 
-	/* Copy the rest of the data to compressed fragment */
-	memcpy(&IPHC[offset], pkt->frags->data + compressed,
-	       pkt->frags->len - compressed);
-	net_buf_add(frag, pkt->frags->len - compressed);
-
-	/* Delete uncompressed(original) header fragment */
-	net_pkt_frag_del(pkt, NULL, pkt->frags);
+	if (!frag->frags) {
+		/* Single fragment, just drop the bytes saved in front */
+		net_buf_pull(frag, compressed - offset);
+	} else {
+		/* Keep the tailroom, so that the gaps can be filled */
+		memmove(frag->data + offset, frag->data + compressed,
+			frag->len - compressed);
+		frag->len -= compressed - offset;
+	}
 
-	/* Insert compressed header fragment */
-	net_pkt_frag_insert(pkt, frag);
+	memcpy(frag->data, iphc, offset);
 
-	/* Compact the fragments, so that gaps will be filled */
-	net_pkt_compact(pkt);
+	if (frag->frags) {
+		net_pkt_compact(pkt);
+	}
 
 	if (fragment) {
 		return fragment(pkt, compressed - offset);
@@ -1218,11 +1377,13 @@ static inline void uncompress_cid(struct net_pkt *pkt,
 
 static inline bool uncompress_IPHC_header(struct net_pkt *pkt)
 {
+	u8_t hdr[NET_IPV6UDPH_LEN];
 	struct net_udp_hdr *udp = NULL;
 	u8_t offset = 2;
 	u8_t chksum = 0;
 	struct net_ipv6_hdr *ipv6;
 	struct net_buf *frag;
+	u8_t hdr_len;
 	u16_t len;
 #if defined(CONFIG_NET_6LO_CONTEXT)
 	struct net_6lo_context *src = NULL;
@@ -1239,12 +1400,11 @@ static inline bool uncompress_IPHC_header(struct net_pkt *pkt)
 #endif
 	}
 
-	frag = net_pkt_get_frag(pkt, NET_6LO_RX_PKT_TIMEOUT);
-	if (!frag) {
-		return false;
-	}
-
-	ipv6 = (struct net_ipv6_hdr *)(frag->data);
+	/* Headers are uncompressed on the stack first, as they are then
+	 * written over the compressed ones.
+	 */
+	memset(hdr, 0, sizeof(hdr));
+	ipv6 = (struct net_ipv6_hdr *)hdr;
 
 	/* Version is always 6 */
 	ipv6->vtc = 0x60;
@@ -1261,10 +1421,6 @@ static inline bool uncompress_IPHC_header(struct net_pkt *pkt)
 	/* Uncompress Hoplimit */
 	offset = uncompress_hoplimit(pkt, ipv6, offset);
 
-	/* First set to zero and copy relevant bits */
-	memset(&ipv6->src.s6_addr[0], 0, 16);
-	memset(&ipv6->dst.s6_addr[0], 0, 16);
-
 	/* Uncompress Source Address */
 	if (CIPHC[1] & NET_6LO_IPHC_SAC_1) {
 		NET_DBG("SAC_1");
@@ -1275,13 +1431,13 @@ static inline bool uncompress_IPHC_header(struct net_pkt *pkt)
 #if defined(CONFIG_NET_6LO_CONTEXT)
 			if (!src) {
 				NET_ERR("Src context doesn't exists");
-				goto fail;
+				return false;
 			}
 
 			offset = uncompress_sa_ctx(pkt, ipv6, offset, src);
 #else
 			NET_WARN("Context based uncompression not enabled");
-			goto fail;
+			return false;
 #endif
 		}
 	} else {
@@ -1296,12 +1452,12 @@ static inline bool uncompress_IPHC_header(struct net_pkt *pkt)
 			 * Addresses. DAM_01, DAM_10 and DAM_11 are reserved.
 			 */
 			NET_ERR("DAC_1 and M_1 is not supported");
-			goto fail;
+			return false;
 		}
 
 		if (!dst) {
 			NET_ERR("DAC is set but dst context doesn't exists");
-			goto fail;
+			return false;
 		}
 
 		offset = uncompress_da_ctx(pkt, ipv6, offset, dst);
@@ -1312,7 +1468,7 @@ static inline bool uncompress_IPHC_header(struct net_pkt *pkt)
 	offset = uncompress_da(pkt, ipv6, offset);
 #endif
 
-	net_buf_add(frag, NET_IPV6H_LEN);
+	hdr_len = NET_IPV6H_LEN;
 
 	if (!(CIPHC[0] & NET_6LO_IPHC_NH_1)) {
 		NET_DBG("No following compressed header");
@@ -1324,13 +1480,13 @@ static inline bool uncompress_IPHC_header(struct net_pkt *pkt)
 		 * Supports only UDP header (next header) compression.
 		 */
 		NET_ERR("Unsupported next header");
-		goto fail;
+		return false;
 	}
 
 	/* Uncompress UDP header */
 	ipv6->nexthdr = IPPROTO_UDP;
 
-	udp = (struct net_udp_hdr *)(frag->data + NET_IPV6H_LEN);
+	udp = (struct net_udp_hdr *)(hdr + NET_IPV6H_LEN);
 	chksum = CIPHC[offset] & NET_6LO_NHC_UDP_CHKSUM_1;
 	offset = uncompress_nh_udp(pkt, udp, offset);
 
@@ -1339,30 +1495,53 @@ static inline bool uncompress_IPHC_header(struct net_pkt *pkt)
 		offset += 2;
 	}
 
-	net_buf_add(frag, NET_UDPH_LEN);
+	hdr_len += NET_UDPH_LEN;
 
 end:
-	if (pkt->frags->len < offset) {
+	frag = pkt->frags;
+
+	if (frag->len < offset) {
 		NET_ERR("pkt %p too short len %d vs %d", pkt,
-			pkt->frags->len, offset);
-		goto fail;
+			frag->len, offset);
+		return false;
 	}
 
-	/* Move the data to beginning, no need for headers now */
-	NET_DBG("Removing %u bytes of compressed hdr", offset);
-	memmove(pkt->frags->data, pkt->frags->data + offset,
-		pkt->frags->len - offset);
-	pkt->frags->len -= offset;
+	if (hdr_len <= offset + net_buf_tailroom(frag)) {
+		/* Make room in place, the link layer header in front of
+		 * the data is left untouched.
+		 */
+		memmove(frag->data + hdr_len, frag->data + offset,
+			frag->len - offset);
+		frag->len += hdr_len - offset;
+	} else {
+		frag = net_pkt_get_frag(pkt, NET_6LO_RX_PKT_TIMEOUT);
+		if (!frag) {
+			return false;
+		}
+
+		net_buf_add(frag, hdr_len);
 
-	/* Copying ll part, if any */
-	if (net_pkt_ll_reserve(pkt)) {
-		memcpy(frag->data - net_pkt_ll_reserve(pkt),
-		       net_pkt_ll(pkt), net_pkt_ll_reserve(pkt));
+		/* Copying ll part, if any */
+		if (net_pkt_ll_reserve(pkt)) {
+			memcpy(frag->data - net_pkt_ll_reserve(pkt),
+			       net_pkt_ll(pkt), net_pkt_ll_reserve(pkt));
+		}
+
+		/* No need for the compressed headers now */
+		NET_DBG("Removing %u bytes of compressed hdr", offset);
+		net_buf_pull(pkt->frags, offset);
+
+		/* Insert the fragment (this one holds uncompressed headers) */
+		net_pkt_frag_insert(pkt, frag);
+		net_pkt_compact(pkt);
 	}
 
-	/* Insert the fragment (this one holds uncompressed headers) */
-	net_pkt_frag_insert(pkt, frag);
-	net_pkt_compact(pkt);
+	memcpy(frag->data, hdr, hdr_len);
+
+	ipv6 = (struct net_ipv6_hdr *)frag->data;
+	if (udp) {
+		udp = (struct net_udp_hdr *)(frag->data + NET_IPV6H_LEN);
+	}
 
 	/* Set IPv6 header and UDP (if next header is) length */
 	len = net_pkt_get_len(pkt) - NET_IPV6H_LEN;
@@ -1378,10 +1557,6 @@ end:
 	}
 
 	return true;
-
-fail:
-	net_pkt_frag_unref(frag);
-	return false;
 }
 
 /* Adds IPv6 dispatch as first byte and adjust fragments  */
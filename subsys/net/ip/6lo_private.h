@@ -84,9 +84,15 @@
 #define NET_6LO_NHC_UDP_8_BIT_PORT	0xF0
 #define NET_6LO_NHC_UDP_4_BIT_PORT	0xF0B
 
-#define IPHC ((frag)->data)
+#define IPHC (iphc)
 #define CIPHC ((pkt->frags)->data)
 
+/* Largest IPHC header: dispatch, IPHC, CID, 4 bytes of traffic class and
+ * flow label, next header, hop limit, both addresses in-line and the UDP
+ * NHC with both ports and the checksum in-line.
+ */
+#define NET_6LO_IPHC_MAX_LEN		48
+
 #define NET_6LO_FRAG1_HDR_LEN		4
 #define NET_6LO_FRAGN_HDR_LEN		5
 
@@ -82,66 +82,6 @@ static struct conn_hash conn_cache[CONFIG_NET_MAX_CONN];
  */
 static struct conn_hash_neg conn_cache_neg[CONFIG_NET_MAX_CONN];
 
-#define TAKE_BIT(val, bit, max, used)				\
-	(((val & BIT(bit)) >> bit) << (max - used))
-
-static inline u8_t ports_to_hash(u16_t remote_port,
-				    u16_t local_port)
-{
-	/* Note that we do not convert port value to network byte order */
-	return (remote_port & BIT(0)) |
-		((remote_port & BIT(4)) >> 3) |
-		((remote_port & BIT(8)) >> 6) |
-		((remote_port & BIT(15)) >> 12) |
-		(((local_port & BIT(0)) |
-		  ((local_port & BIT(4)) >> 3) |
-		  ((local_port & BIT(8)) >> 6) |
-		  ((local_port & BIT(15)) >> 12)) << 4);
-}
-
-static inline u16_t ipv6_to_hash(struct in6_addr *addr)
-{
-	/* There is 11 bits available for IPv6 address */
-	/* Use more bits from the lower part of address space */
-	return
-		/* Take 3 bits from higher values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 31, 11, 1) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 15, 11, 2) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[0]), 7, 11, 3) |
-
-		/* Take 2 bits from higher middle values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[1]), 31, 11, 4) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[1]), 15, 11, 5) |
-
-		/* Take 2 bits from lower middle values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[2]), 31, 11, 6) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[2]), 15, 11, 7) |
-
-		/* Take 4 bits from lower values */
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 31, 11, 8) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 15, 11, 9) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 7, 11, 10) |
-		TAKE_BIT(UNALIGNED_GET(&addr->s6_addr32[3]), 0, 11, 11);
-}
-
-static inline u16_t ipv4_to_hash(struct in_addr *addr)
-{
-	/* There is 11 bits available for IPv4 address */
-	/* Use more bits from the lower part of address space */
-	return
-		TAKE_BIT(addr->s_addr, 31, 11, 1) |
-		TAKE_BIT(addr->s_addr, 27, 11, 2) |
-		TAKE_BIT(addr->s_addr, 21, 11, 3) |
-		TAKE_BIT(addr->s_addr, 17, 11, 4) |
-		TAKE_BIT(addr->s_addr, 14, 11, 5) |
-		TAKE_BIT(addr->s_addr, 11, 11, 6) |
-		TAKE_BIT(addr->s_addr, 8, 11, 7) |
-		TAKE_BIT(addr->s_addr, 5, 11, 8) |
-		TAKE_BIT(addr->s_addr, 3, 11, 9) |
-		TAKE_BIT(addr->s_addr, 2, 11, 10) |
-		TAKE_BIT(addr->s_addr, 0, 11, 11);
-}
-
 /* Return either the first free position in the cache (idx < 0) or
  * the existing cached position (idx >= 0)
  */
@@ -156,7 +96,7 @@ static s32_t check_hash(enum net_ip_protocol proto,
 	int i, free_pos = -1;
 	u32_t value = 0;
 
-	value = ports_to_hash(remote_port, local_port);
+	value = net_conn_ports_to_hash(remote_port, local_port);
 
 #if defined(CONFIG_NET_UDP)
 	if (proto == IPPROTO_UDP) {
@@ -173,16 +113,20 @@ static s32_t check_hash(enum net_ip_protocol proto,
 #if defined(CONFIG_NET_IPV6)
 	if (family == AF_INET6) {
 		value |= BIT(30);
-		value |= ipv6_to_hash((struct in6_addr *)remote_addr) << 8;
-		value |= ipv6_to_hash((struct in6_addr *)local_addr) << 19;
+		value |= net_conn_ipv6_to_hash((struct in6_addr *)remote_addr)
+			<< 8;
+		value |= net_conn_ipv6_to_hash((struct in6_addr *)local_addr)
+			<< 19;
 	}
 #endif
 
 #if defined(CONFIG_NET_IPV4)
 	if (family == AF_INET) {
 		value &= ~BIT(30);
-		value |= ipv4_to_hash((struct in_addr *)remote_addr) << 8;
-		value |= ipv4_to_hash((struct in_addr *)local_addr) << 19;
+		value |= net_conn_ipv4_to_hash((struct in_addr *)remote_addr)
+			<< 8;
+		value |= net_conn_ipv4_to_hash((struct in_addr *)local_addr)
+			<< 19;
 	}
 #endif
 
@@ -346,6 +290,240 @@ static inline void cache_remove(struct net_conn *conn)
 #define cache_remove(...)
 #endif /* CONFIG_NET_CONN_CACHE */
 
+#if defined(CONFIG_NET_CONN_HASH)
+
+/* The connections are linked in one of the lists below depending on what
+ * they match: the ones with both addresses and both ports set are hashed by
+ * all of them, the ones with a local port by that port and all the others
+ * are in the wildcard list. The candidates for a packet are then in one
+ * bucket of each table and in the wildcard list.
+ *
+ * Every list is sorted like the conns array, so that the candidates are
+ * checked in the same order as when going through the whole array.
+ */
+#define CONN_BUCKETS CONFIG_NET_CONN_HASH_BUCKETS
+
+BUILD_ASSERT_MSG((CONN_BUCKETS & (CONN_BUCKETS - 1)) == 0,
+		 "CONFIG_NET_CONN_HASH_BUCKETS must be a power of 2");
+
+#define NET_RANK_EXACT (NET_RANK_LOCAL_PORT | NET_RANK_REMOTE_PORT | \
+			NET_RANK_LOCAL_SPEC_ADDR | NET_RANK_REMOTE_SPEC_ADDR)
+
+static sys_slist_t conn_exact[CONN_BUCKETS];
+static sys_slist_t conn_port[CONN_BUCKETS];
+static sys_slist_t conn_wild;
+
+static inline u32_t conn_bucket(u32_t value)
+{
+	value ^= value >> 16;
+	value *= 0x45d9f3b;
+	value ^= value >> 16;
+
+	return value & (CONN_BUCKETS - 1);
+}
+
+static u32_t conn_addr_hash(sa_family_t family, void *addr)
+{
+#if defined(CONFIG_NET_IPV6)
+	if (family == AF_INET6) {
+		struct in6_addr *addr6 = addr;
+
+		return UNALIGNED_GET(&addr6->s6_addr32[0]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[1]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[2]) ^
+			UNALIGNED_GET(&addr6->s6_addr32[3]);
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (family == AF_INET) {
+		return UNALIGNED_GET(&((struct in_addr *)addr)->s_addr);
+	}
+#endif
+
+	return 0;
+}
+
+/* Ports are in network byte order */
+static u32_t conn_exact_bucket(u8_t proto, sa_family_t family,
+			       void *remote_addr, void *local_addr,
+			       u16_t remote_port, u16_t local_port)
+{
+	u32_t value = conn_addr_hash(family, remote_addr);
+
+	value = ((value << 7) | (value >> 25)) ^
+		conn_addr_hash(family, local_addr);
+	value ^= ((u32_t)remote_port << 16) ^ local_port ^ proto;
+
+	return conn_bucket(value);
+}
+
+static u32_t conn_port_bucket(u8_t proto, u16_t local_port)
+{
+	return conn_bucket(((u32_t)local_port << 8) ^ proto);
+}
+
+static void *conn_sockaddr_ip(struct sockaddr *addr)
+{
+#if defined(CONFIG_NET_IPV6)
+	if (addr->sa_family == AF_INET6) {
+		return &net_sin6(addr)->sin6_addr;
+	}
+#endif
+
+	return &net_sin(addr)->sin_addr;
+}
+
+static sys_slist_t *conn_list(struct net_conn *conn)
+{
+	if ((conn->rank & NET_RANK_EXACT) == NET_RANK_EXACT) {
+		return &conn_exact[conn_exact_bucket(
+				conn->proto, conn->local_addr.sa_family,
+				conn_sockaddr_ip(&conn->remote_addr),
+				conn_sockaddr_ip(&conn->local_addr),
+				net_sin(&conn->remote_addr)->sin_port,
+				net_sin(&conn->local_addr)->sin_port)];
+	}
+
+	if (conn->rank & NET_RANK_LOCAL_PORT) {
+		return &conn_port[conn_port_bucket(
+				conn->proto,
+				net_sin(&conn->local_addr)->sin_port)];
+	}
+
+	return &conn_wild;
+}
+
+static void conn_hash_add(struct net_conn *conn)
+{
+	sys_slist_t *list = conn_list(conn);
+	sys_snode_t *node, *prev = NULL;
+
+	SYS_SLIST_FOR_EACH_NODE(list, node) {
+		if (CONTAINER_OF(node, struct net_conn, node) > conn) {
+			break;
+		}
+
+		prev = node;
+	}
+
+	sys_slist_insert(list, prev, &conn->node);
+}
+
+static void conn_hash_remove(struct net_conn *conn)
+{
+	sys_slist_find_and_remove(conn_list(conn), &conn->node);
+}
+
+static void conn_hash_init(void)
+{
+	int i;
+
+	for (i = 0; i < CONN_BUCKETS; i++) {
+		sys_slist_init(&conn_exact[i]);
+		sys_slist_init(&conn_port[i]);
+	}
+
+	sys_slist_init(&conn_wild);
+}
+#else
+#define conn_hash_add(...)
+#define conn_hash_remove(...)
+#define conn_hash_init(...)
+#endif /* CONFIG_NET_CONN_HASH */
+
+/* Connections that can match a received packet, in the conns array order */
+struct conn_iter {
+#if defined(CONFIG_NET_CONN_HASH)
+	sys_snode_t *nodes[3];
+#else
+	int idx;
+#endif
+};
+
+static void conn_iter_init(struct conn_iter *iter,
+			   enum net_ip_protocol proto,
+			   struct net_pkt *pkt,
+			   u16_t src_port,
+			   u16_t dst_port)
+{
+#if defined(CONFIG_NET_CONN_HASH)
+	void *src = NULL, *dst = NULL;
+
+#if defined(CONFIG_NET_IPV6)
+	if (net_pkt_family(pkt) == AF_INET6) {
+		src = &NET_IPV6_HDR(pkt)->src;
+		dst = &NET_IPV6_HDR(pkt)->dst;
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (net_pkt_family(pkt) == AF_INET) {
+		src = &NET_IPV4_HDR(pkt)->src;
+		dst = &NET_IPV4_HDR(pkt)->dst;
+	}
+#endif
+
+	iter->nodes[0] = NULL;
+	if (src) {
+		iter->nodes[0] = sys_slist_peek_head(
+			&conn_exact[conn_exact_bucket(proto,
+						      net_pkt_family(pkt),
+						      src, dst,
+						      src_port, dst_port)]);
+	}
+
+	iter->nodes[1] = sys_slist_peek_head(
+		&conn_port[conn_port_bucket(proto, dst_port)]);
+	iter->nodes[2] = sys_slist_peek_head(&conn_wild);
+#else
+	ARG_UNUSED(proto);
+	ARG_UNUSED(pkt);
+	ARG_UNUSED(src_port);
+	ARG_UNUSED(dst_port);
+
+	iter->idx = 0;
+#endif
+}
+
+static struct net_conn *conn_iter_next(struct conn_iter *iter)
+{
+#if defined(CONFIG_NET_CONN_HASH)
+	struct net_conn *conn = NULL;
+	int i, next = 0;
+
+	for (i = 0; i < ARRAY_SIZE(iter->nodes); i++) {
+		struct net_conn *candidate;
+
+		if (!iter->nodes[i]) {
+			continue;
+		}
+
+		candidate = CONTAINER_OF(iter->nodes[i], struct net_conn, node);
+		if (!conn || candidate < conn) {
+			conn = candidate;
+			next = i;
+		}
+	}
+
+	if (conn) {
+		iter->nodes[next] = sys_slist_peek_next(iter->nodes[next]);
+	}
+
+	return conn;
+#else
+	while (iter->idx < CONFIG_NET_MAX_CONN) {
+		struct net_conn *conn = &conns[iter->idx++];
+
+		if (conn->flags & NET_CONN_IN_USE) {
+			return conn;
+		}
+	}
+
+	return NULL;
+#endif
+}
+
 int net_conn_unregister(struct net_conn_handle *handle)
 {
 	struct net_conn *conn = (struct net_conn *)handle;
@@ -359,6 +537,7 @@ int net_conn_unregister(struct net_conn_handle *handle)
 	}
 
 	cache_remove(conn);
+	conn_hash_remove(conn);
 
 	NET_DBG("[%zu] connection handler %p removed",
 		(conn - conns) / sizeof(*conn), conn);
@@ -678,6 +857,7 @@ int net_conn_register(enum net_ip_protocol proto,
 
 		/* Cache needs to be cleared if new entries are added. */
 		cache_clear();
+		conn_hash_add(&conns[i]);
 
 #if defined(CONFIG_NET_DEBUG_CONN)
 		do {
@@ -803,10 +983,49 @@ static bool is_invalid_packet(struct net_pkt *pkt,
 	return my_src_addr && (src_port == dst_port);
 }
 
+static bool conn_match(struct net_conn *conn,
+		       enum net_ip_protocol proto,
+		       struct net_pkt *pkt,
+		       u16_t src_port,
+		       u16_t dst_port)
+{
+	if (conn->proto != proto) {
+		return false;
+	}
+
+	if (net_sin(&conn->remote_addr)->sin_port) {
+		if (net_sin(&conn->remote_addr)->sin_port != src_port) {
+			return false;
+		}
+	}
+
+	if (net_sin(&conn->local_addr)->sin_port) {
+		if (net_sin(&conn->local_addr)->sin_port != dst_port) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_REMOTE_ADDR_SET) {
+		if (!check_addr(pkt, &conn->remote_addr, true)) {
+			return false;
+		}
+	}
+
+	if (conn->flags & NET_CONN_LOCAL_ADDR_SET) {
+		if (!check_addr(pkt, &conn->local_addr, false)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 {
-	int i, best_match = -1;
+	int best_match = -1;
 	s16_t best_rank = -1;
+	struct conn_iter iter;
+	struct net_conn *conn;
 	u16_t src_port, dst_port;
 	u16_t chksum;
 	struct net_if *pkt_iface = net_pkt_iface(pkt);
@@ -815,7 +1034,11 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 	enum net_verdict verdict;
 	u32_t cache_value = 0;
 	s32_t pos;
+#endif
+
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_IP);
 
+#if defined(CONFIG_NET_CONN_CACHE)
 	verdict = cache_check(proto, pkt, &cache_value, &pos);
 	if (verdict != NET_CONTINUE) {
 		return verdict;
@@ -883,41 +1106,13 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 			net_pkt_family(pkt), ntohs(chksum), data_len);
 	}
 
-	for (i = 0; i < CONFIG_NET_MAX_CONN; i++) {
-		if (!(conns[i].flags & NET_CONN_IN_USE)) {
-			continue;
-		}
+	conn_iter_init(&iter, proto, pkt, src_port, dst_port);
 
-		if (conns[i].proto != proto) {
+	while ((conn = conn_iter_next(&iter))) {
+		if (!conn_match(conn, proto, pkt, src_port, dst_port)) {
 			continue;
 		}
 
-		if (net_sin(&conns[i].remote_addr)->sin_port) {
-			if (net_sin(&conns[i].remote_addr)->sin_port !=
-			    src_port) {
-				continue;
-			}
-		}
-
-		if (net_sin(&conns[i].local_addr)->sin_port) {
-			if (net_sin(&conns[i].local_addr)->sin_port !=
-			    dst_port) {
-				continue;
-			}
-		}
-
-		if (conns[i].flags & NET_CONN_REMOTE_ADDR_SET) {
-			if (!check_addr(pkt, &conns[i].remote_addr, true)) {
-				continue;
-			}
-		}
-
-		if (conns[i].flags & NET_CONN_LOCAL_ADDR_SET) {
-			if (!check_addr(pkt, &conns[i].local_addr, false)) {
-				continue;
-			}
-		}
-
 		/* If we have an existing best_match, and that one
 		 * specifies a remote port, then we've matched to a
 		 * LISTENING connection that should not override.
@@ -927,9 +1122,9 @@ enum net_verdict net_conn_input(enum net_ip_protocol proto, struct net_pkt *pkt)
 			continue;
 		}
 
-		if (best_rank < conns[i].rank) {
-			best_rank = conns[i].rank;
-			best_match = i;
+		if (best_rank < conn->rank) {
+			best_rank = conn->rank;
+			best_match = conn - conns;
 		}
 	}
 
@@ -1050,6 +1245,8 @@ void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data)
 
 void net_conn_init(void)
 {
+	conn_hash_init();
+
 #if defined(CONFIG_NET_CONN_CACHE)
 	do {
 		int i;
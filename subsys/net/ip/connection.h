@@ -45,6 +45,11 @@ typedef enum net_verdict (*net_conn_cb_t)(struct net_conn *conn,
  *
  */
 struct net_conn {
+#if defined(CONFIG_NET_CONN_HASH)
+	/** Node in the hash table bucket of the connection */
+	sys_snode_t node;
+#endif
+
 	/** Remote IP address */
 	struct sockaddr remote_addr;
 
@@ -162,6 +167,77 @@ typedef void (*net_conn_foreach_cb_t)(struct net_conn *conn, void *user_data);
  */
 void net_conn_foreach(net_conn_foreach_cb_t cb, void *user_data);
 
+/* Partial hashes of the connection end points: the connection cache packs
+ * them into a 32 bit value, see check_hash() in connection.c, and the Rx
+ * traffic classes use them to spread flows over their queues.
+ */
+#define NET_CONN_TAKE_BIT(val, bit, max, used)			\
+	((((val) & BIT(bit)) >> (bit)) << ((max) - (used)))
+
+static inline u8_t net_conn_ports_to_hash(u16_t remote_port,
+					  u16_t local_port)
+{
+	/* Note that we do not convert port value to network byte order */
+	return (remote_port & BIT(0)) |
+		((remote_port & BIT(4)) >> 3) |
+		((remote_port & BIT(8)) >> 6) |
+		((remote_port & BIT(15)) >> 12) |
+		(((local_port & BIT(0)) |
+		  ((local_port & BIT(4)) >> 3) |
+		  ((local_port & BIT(8)) >> 6) |
+		  ((local_port & BIT(15)) >> 12)) << 4);
+}
+
+static inline u16_t net_conn_ipv6_to_hash(struct in6_addr *addr)
+{
+	u32_t addr0 = UNALIGNED_GET(&addr->s6_addr32[0]);
+	u32_t addr1 = UNALIGNED_GET(&addr->s6_addr32[1]);
+	u32_t addr2 = UNALIGNED_GET(&addr->s6_addr32[2]);
+	u32_t addr3 = UNALIGNED_GET(&addr->s6_addr32[3]);
+
+	/* There is 11 bits available for IPv6 address */
+	/* Use more bits from the lower part of address space */
+	return
+		/* Take 3 bits from higher values */
+		NET_CONN_TAKE_BIT(addr0, 31, 11, 1) |
+		NET_CONN_TAKE_BIT(addr0, 15, 11, 2) |
+		NET_CONN_TAKE_BIT(addr0, 7, 11, 3) |
+
+		/* Take 2 bits from higher middle values */
+		NET_CONN_TAKE_BIT(addr1, 31, 11, 4) |
+		NET_CONN_TAKE_BIT(addr1, 15, 11, 5) |
+
+		/* Take 2 bits from lower middle values */
+		NET_CONN_TAKE_BIT(addr2, 31, 11, 6) |
+		NET_CONN_TAKE_BIT(addr2, 15, 11, 7) |
+
+		/* Take 4 bits from lower values */
+		NET_CONN_TAKE_BIT(addr3, 31, 11, 8) |
+		NET_CONN_TAKE_BIT(addr3, 15, 11, 9) |
+		NET_CONN_TAKE_BIT(addr3, 7, 11, 10) |
+		NET_CONN_TAKE_BIT(addr3, 0, 11, 11);
+}
+
+static inline u16_t net_conn_ipv4_to_hash(struct in_addr *addr)
+{
+	u32_t addr0 = UNALIGNED_GET(&addr->s_addr);
+
+	/* There is 11 bits available for IPv4 address */
+	/* Use more bits from the lower part of address space */
+	return
+		NET_CONN_TAKE_BIT(addr0, 31, 11, 1) |
+		NET_CONN_TAKE_BIT(addr0, 27, 11, 2) |
+		NET_CONN_TAKE_BIT(addr0, 21, 11, 3) |
+		NET_CONN_TAKE_BIT(addr0, 17, 11, 4) |
+		NET_CONN_TAKE_BIT(addr0, 14, 11, 5) |
+		NET_CONN_TAKE_BIT(addr0, 11, 11, 6) |
+		NET_CONN_TAKE_BIT(addr0, 8, 11, 7) |
+		NET_CONN_TAKE_BIT(addr0, 5, 11, 8) |
+		NET_CONN_TAKE_BIT(addr0, 3, 11, 9) |
+		NET_CONN_TAKE_BIT(addr0, 2, 11, 10) |
+		NET_CONN_TAKE_BIT(addr0, 0, 11, 11);
+}
+
 void net_conn_init(void);
 
 #ifdef __cplusplus
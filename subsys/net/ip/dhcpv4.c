@@ -29,6 +29,10 @@
 #include <net/dhcpv4.h>
 #include <net/dns_resolve.h>
 
+#if defined(CONFIG_NET_DHCPV4_LEASE_CACHE)
+#include <settings/settings.h>
+#endif
+
 static struct net_mgmt_event_callback mgmt4_cb;
 
 struct dhcp_msg {
@@ -91,6 +95,7 @@ enum dhcpv4_msg_type {
 #define DHCPV4_OPTIONS_REQ_LIST		55
 #define DHCPV4_OPTIONS_RENEWAL		58
 #define DHCPV4_OPTIONS_REBINDING	59
+#define DHCPV4_OPTIONS_RAPID_COMMIT	80
 #define DHCPV4_OPTIONS_END		255
 
 /* TODO:
@@ -122,6 +127,101 @@ static const u8_t magic_cookie[4] = { 0x63, 0x82, 0x53, 0x63 };
 
 static void dhcpv4_timeout(struct k_work *work);
 
+#if defined(CONFIG_NET_DHCPV4_LEASE_CACHE)
+#define LEASE_KEY "dhcpv4/lease"
+
+/* Last lease obtained, confirmed with the server at the next start */
+struct dhcpv4_lease {
+	u8_t ll_addr[NET_LINK_ADDR_MAX_LENGTH];
+	struct in_addr addr;
+	struct in_addr server_id;
+};
+
+static struct dhcpv4_lease cached_lease;
+
+static bool lease_cached(struct net_if *iface)
+{
+	struct net_linkaddr *ll = net_if_get_link_addr(iface);
+
+	return cached_lease.addr.s_addr &&
+	       ll->len <= sizeof(cached_lease.ll_addr) &&
+	       !memcmp(cached_lease.ll_addr, ll->addr, ll->len);
+}
+
+static void lease_save(struct net_if *iface)
+{
+	char buf[SETTINGS_STR_FROM_BYTES_LEN(sizeof(cached_lease))];
+	struct net_linkaddr *ll = net_if_get_link_addr(iface);
+	char *str;
+
+	/* Avoid wearing the flash out when the same lease is renewed */
+	if (lease_cached(iface) &&
+	    net_ipv4_addr_cmp(&cached_lease.addr,
+			      &iface->config.dhcpv4.requested_ip) &&
+	    net_ipv4_addr_cmp(&cached_lease.server_id,
+			      &iface->config.dhcpv4.server_id)) {
+		return;
+	}
+
+	memset(&cached_lease, 0, sizeof(cached_lease));
+	memcpy(cached_lease.ll_addr, ll->addr,
+	       min(ll->len, sizeof(cached_lease.ll_addr)));
+	net_ipaddr_copy(&cached_lease.addr, &iface->config.dhcpv4.requested_ip);
+	net_ipaddr_copy(&cached_lease.server_id,
+			&iface->config.dhcpv4.server_id);
+
+	str = settings_str_from_bytes(&cached_lease, sizeof(cached_lease),
+				      buf, sizeof(buf));
+	if (!str) {
+		NET_ERR("Unable to encode lease");
+		return;
+	}
+
+	settings_save_one(LEASE_KEY, str);
+}
+
+static void lease_forget(void)
+{
+	if (!cached_lease.addr.s_addr) {
+		return;
+	}
+
+	memset(&cached_lease, 0, sizeof(cached_lease));
+	settings_save_one(LEASE_KEY, NULL);
+}
+
+static int lease_set(int argc, char **argv, char *val)
+{
+	int len = sizeof(cached_lease);
+
+	if (argc != 1 || strcmp(argv[0], "lease")) {
+		return -ENOENT;
+	}
+
+	if (!val) {
+		memset(&cached_lease, 0, sizeof(cached_lease));
+		return 0;
+	}
+
+	if (settings_bytes_from_str(val, &cached_lease, &len) ||
+	    len != sizeof(cached_lease)) {
+		NET_ERR("Invalid lease in storage");
+		memset(&cached_lease, 0, sizeof(cached_lease));
+	}
+
+	return 0;
+}
+
+static struct settings_handler lease_settings = {
+	.name = "dhcpv4",
+	.h_set = lease_set,
+};
+#else
+#define lease_cached(...) false
+#define lease_save(...)
+#define lease_forget(...)
+#endif /* CONFIG_NET_DHCPV4_LEASE_CACHE */
+
 static const char *
 net_dhcpv4_msg_type_name(enum dhcpv4_msg_type msg_type) __attribute__((unused));
 
@@ -135,6 +235,7 @@ const char *net_dhcpv4_state_name(enum net_dhcpv4_state state)
 		"renewing",
 		"rebinding",
 		"bound",
+		"rebooting",
 	};
 
 	__ASSERT_NO_MSG(state >= 0 && state < sizeof(name));
@@ -205,6 +306,17 @@ static bool add_req_options(struct net_pkt *pkt)
 	return net_pkt_append_all(pkt, sizeof(data), data, K_FOREVER);
 }
 
+#if defined(CONFIG_NET_DHCPV4_RAPID_COMMIT)
+/* Ask for a DHCPACK in reply to DHCPDISCOVER, RFC 4039 */
+static bool add_rapid_commit(struct net_pkt *pkt)
+{
+	return add_option_length_value(pkt, DHCPV4_OPTIONS_RAPID_COMMIT, 0,
+				       NULL);
+}
+#else
+#define add_rapid_commit(...) true
+#endif
+
 static bool add_server_id(struct net_pkt *pkt, const struct in_addr *addr)
 {
 	return add_option_length_value(pkt, DHCPV4_OPTIONS_SERVER_ID, 4,
@@ -385,6 +497,12 @@ static void send_request(struct net_if *iface)
 		with_server_id = true;
 		with_requested_ip = true;
 		break;
+	case NET_DHCPV4_REBOOTING:
+		/* RFC2131 4.3.2 Client MUST NOT include server
+		 * identifier when verifying a previous lease.
+		 */
+		with_requested_ip = true;
+		break;
 	case NET_DHCPV4_RENEWING:
 		/* Since we have an address populate the ciaddr field.
 		 */
@@ -482,6 +600,7 @@ static void send_discover(struct net_if *iface)
 	}
 
 	if (!add_req_options(pkt) ||
+	    !add_rapid_commit(pkt) ||
 	    !add_end(pkt)) {
 		goto fail;
 	}
@@ -538,6 +657,20 @@ static void enter_requesting(struct net_if *iface)
 	send_request(iface);
 }
 
+#if defined(CONFIG_NET_DHCPV4_LEASE_CACHE)
+static void enter_rebooting(struct net_if *iface)
+{
+	iface->config.dhcpv4.attempts = 0;
+	iface->config.dhcpv4.requested_ip = cached_lease.addr;
+	iface->config.dhcpv4.server_id = cached_lease.server_id;
+	iface->config.dhcpv4.state = NET_DHCPV4_REBOOTING;
+	NET_DBG("enter state=%s",
+		net_dhcpv4_state_name(iface->config.dhcpv4.state));
+
+	send_request(iface);
+}
+#endif
+
 static void dhcpv4_t1_timeout(struct k_work *work)
 {
 	struct net_if *iface = CONTAINER_OF(work, struct net_if,
@@ -552,6 +685,7 @@ static void dhcpv4_t1_timeout(struct k_work *work)
 	case NET_DHCPV4_REQUESTING:
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_REBINDING:
+	case NET_DHCPV4_REBOOTING:
 		/* This path cannot happen. */
 		NET_ASSERT_INFO(0, "Invalid state %s",
 			net_dhcpv4_state_name(iface->config.dhcpv4.state));
@@ -579,6 +713,7 @@ static void dhcpv4_t2_timeout(struct k_work *work)
 	case NET_DHCPV4_SELECTING:
 	case NET_DHCPV4_REQUESTING:
 	case NET_DHCPV4_REBINDING:
+	case NET_DHCPV4_REBOOTING:
 		NET_ASSERT_INFO(0, "Invalid state %s",
 			net_dhcpv4_state_name(iface->config.dhcpv4.state));
 		break;
@@ -643,6 +778,12 @@ static void dhcpv4_timeout(struct k_work *work)
 	case NET_DHCPV4_DISABLED:
 		break;
 	case NET_DHCPV4_INIT:
+#if defined(CONFIG_NET_DHCPV4_LEASE_CACHE)
+		if (lease_cached(iface)) {
+			enter_rebooting(iface);
+			break;
+		}
+#endif
 		enter_selecting(iface);
 		break;
 	case NET_DHCPV4_SELECTING:
@@ -661,6 +802,19 @@ static void dhcpv4_timeout(struct k_work *work)
 			send_request(iface);
 		}
 
+		break;
+	case NET_DHCPV4_REBOOTING:
+		/* The server of the previous lease is not answering, look
+		 * for any server.
+		 */
+		if (iface->config.dhcpv4.attempts >=
+					DHCPV4_MAX_NUMBER_OF_ATTEMPTS) {
+			NET_DBG("too many attempts, restart");
+			enter_selecting(iface);
+		} else {
+			send_request(iface);
+		}
+
 		break;
 	case NET_DHCPV4_BOUND:
 		break;
@@ -691,7 +845,8 @@ static void dhcpv4_timeout(struct k_work *work)
 static enum net_verdict parse_options(struct net_if *iface,
 				      struct net_buf *frag,
 				      u16_t offset,
-				      enum dhcpv4_msg_type *msg_type)
+				      enum dhcpv4_msg_type *msg_type,
+				      bool *rapid_commit)
 {
 	u8_t cookie[4];
 	u8_t length;
@@ -875,6 +1030,15 @@ static enum net_verdict parse_options(struct net_if *iface,
 			*msg_type = v;
 			break;
 		}
+		case DHCPV4_OPTIONS_RAPID_COMMIT:
+			if (length != 0) {
+				NET_DBG("options_rapid_commit, bad length");
+				return NET_DROP;
+			}
+
+			NET_DBG("options_rapid_commit");
+			*rapid_commit = true;
+			break;
 		default:
 			NET_DBG("option unknown: %d", type);
 			frag = net_frag_skip(frag, pos, &pos, length);
@@ -899,6 +1063,7 @@ static inline void handle_offer(struct net_if *iface)
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_REBINDING:
 	case NET_DHCPV4_BOUND:
+	case NET_DHCPV4_REBOOTING:
 		break;
 	case NET_DHCPV4_SELECTING:
 		k_delayed_work_cancel(&iface->config.dhcpv4.timer);
@@ -907,15 +1072,25 @@ static inline void handle_offer(struct net_if *iface)
 	}
 }
 
-static void handle_ack(struct net_if *iface)
+static void handle_ack(struct net_if *iface, bool rapid_commit)
 {
 	switch (iface->config.dhcpv4.state) {
 	case NET_DHCPV4_DISABLED:
 	case NET_DHCPV4_INIT:
-	case NET_DHCPV4_SELECTING:
 	case NET_DHCPV4_BOUND:
 		break;
+	case NET_DHCPV4_SELECTING:
+		/* RFC4039 An ACK in reply to DISCOVER commits the lease
+		 * only if it carries the Rapid Commit option.
+		 */
+		if (!IS_ENABLED(CONFIG_NET_DHCPV4_RAPID_COMMIT) ||
+		    !rapid_commit) {
+			break;
+		}
+
+		/* Fall through */
 	case NET_DHCPV4_REQUESTING:
+	case NET_DHCPV4_REBOOTING:
 		NET_INFO("Received: %s",
 			 net_sprint_ipv4_addr(
 				 &iface->config.dhcpv4.requested_ip));
@@ -927,6 +1102,7 @@ static void handle_ack(struct net_if *iface)
 			return;
 		}
 
+		lease_save(iface);
 		enter_bound(iface);
 		break;
 
@@ -949,6 +1125,11 @@ static void handle_nak(struct net_if *iface)
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_BOUND:
 		break;
+	case NET_DHCPV4_REBOOTING:
+		/* The previous lease is not valid any more */
+		lease_forget();
+
+		/* Fall through */
 	case NET_DHCPV4_REQUESTING:
 	case NET_DHCPV4_REBINDING:
 		/* Restart the configuration process. */
@@ -963,7 +1144,8 @@ static void handle_nak(struct net_if *iface)
 }
 
 static void handle_dhcpv4_reply(struct net_if *iface,
-				enum dhcpv4_msg_type msg_type)
+				enum dhcpv4_msg_type msg_type,
+				bool rapid_commit)
 {
 	NET_DBG("state=%s msg=%s",
 		net_dhcpv4_state_name(iface->config.dhcpv4.state),
@@ -974,7 +1156,7 @@ static void handle_dhcpv4_reply(struct net_if *iface,
 		handle_offer(iface);
 		break;
 	case DHCPV4_MSG_TYPE_ACK:
-		handle_ack(iface);
+		handle_ack(iface, rapid_commit);
 		break;
 	case DHCPV4_MSG_TYPE_NAK:
 		handle_nak(iface);
@@ -993,6 +1175,7 @@ static enum net_verdict net_dhcpv4_input(struct net_conn *conn,
 	struct net_buf *frag;
 	struct net_if *iface;
 	enum dhcpv4_msg_type msg_type = 0;
+	bool rapid_commit = false;
 	u8_t min;
 	u16_t pos;
 
@@ -1057,14 +1240,15 @@ static enum net_verdict net_dhcpv4_input(struct net_conn *conn,
 		goto drop;
 	}
 
-	if (parse_options(iface, frag, pos, &msg_type) == NET_DROP) {
+	if (parse_options(iface, frag, pos, &msg_type,
+			  &rapid_commit) == NET_DROP) {
 		NET_DBG("Invalid Options");
 		goto drop;
 	}
 
 	net_pkt_unref(pkt);
 
-	handle_dhcpv4_reply(iface, msg_type);
+	handle_dhcpv4_reply(iface, msg_type, rapid_commit);
 
 	return NET_OK;
 
@@ -1149,6 +1333,13 @@ void net_dhcpv4_start(struct net_if *iface)
 			(DHCPV4_INITIAL_DELAY_MAX - DHCPV4_INITIAL_DELAY_MIN) +
 			DHCPV4_INITIAL_DELAY_MIN;
 
+		/* A previous lease is verified at once, RFC2131 4.4.2 does
+		 * not require the delay in INIT-REBOOT state.
+		 */
+		if (lease_cached(iface)) {
+			timeout = 0;
+		}
+
 		NET_DBG("wait timeout=%"PRIu32"s", timeout);
 
 		k_delayed_work_submit(&iface->config.dhcpv4.timer,
@@ -1160,6 +1351,7 @@ void net_dhcpv4_start(struct net_if *iface)
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_REBINDING:
 	case NET_DHCPV4_BOUND:
+	case NET_DHCPV4_REBOOTING:
 		break;
 	}
 
@@ -1191,6 +1383,7 @@ void net_dhcpv4_stop(struct net_if *iface)
 	case NET_DHCPV4_REQUESTING:
 	case NET_DHCPV4_RENEWING:
 	case NET_DHCPV4_REBINDING:
+	case NET_DHCPV4_REBOOTING:
 		iface->config.dhcpv4.state = NET_DHCPV4_DISABLED;
 		NET_DBG("state=%s",
 			net_dhcpv4_state_name(iface->config.dhcpv4.state));
@@ -1209,6 +1402,18 @@ int dhcpv4_init(void)
 
 	NET_DBG("");
 
+#if defined(CONFIG_NET_DHCPV4_LEASE_CACHE)
+	/* The lease is loaded by the application with settings_load() */
+	ret = settings_subsys_init();
+	if (!ret) {
+		ret = settings_register(&lease_settings);
+	}
+
+	if (ret) {
+		NET_ERR("Lease cache not available (%d)", ret);
+	}
+#endif
+
 	net_ipaddr_copy(&net_sin(&local_addr)->sin_addr,
 			net_ipv4_unspecified_address());
 	local_addr.sa_family = AF_INET;
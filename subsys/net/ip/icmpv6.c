@@ -164,12 +164,11 @@ struct net_icmp_hdr *net_icmpv6_get_hdr(struct net_pkt *pkt,
 					struct net_icmp_hdr *hdr)
 {
 	struct net_icmp_hdr *icmp_hdr;
-	struct net_buf *frag;
-	u16_t pos;
+	struct net_pkt_cursor cursor;
 
 	/* If the ICMP header can fit the first fragment, then access it
-	 * directly (fast path), otherwise read the values one by one
-	 * using net_frag_read*() functions (slow path).
+	 * directly (fast path), otherwise read it across the fragments
+	 * using a cursor (slow path).
 	 */
 
 	icmp_hdr = net_pkt_icmp_data(pkt);
@@ -177,12 +176,9 @@ struct net_icmp_hdr *net_icmpv6_get_hdr(struct net_pkt *pkt,
 		return icmp_hdr;
 	}
 
-	frag = net_frag_read_u8(pkt->frags, net_pkt_ip_hdr_len(pkt) +
-				net_pkt_ipv6_ext_len(pkt), &pos, &hdr->type);
-	frag = net_frag_read_u8(frag, pos, &pos, &hdr->code);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->chksum),
-			     (u8_t *)&hdr->chksum);
-	if (pos > 0 && !frag) {
+	if (net_pkt_cursor_init(pkt, &cursor, net_pkt_ip_hdr_len(pkt) +
+				net_pkt_ipv6_ext_len(pkt)) ||
+	    net_pkt_cursor_read(&cursor, hdr, sizeof(*hdr))) {
 		NET_ERR("Malformed ICMPv6 packet");
 		return NULL;
 	}
@@ -362,27 +358,18 @@ struct net_icmpv6_na_hdr *net_icmpv6_set_na_hdr(struct net_pkt *pkt,
 struct net_icmpv6_ra_hdr *net_icmpv6_get_ra_hdr(struct net_pkt *pkt,
 						struct net_icmpv6_ra_hdr *hdr)
 {
-	struct net_buf *frag;
+	struct net_pkt_cursor cursor;
 	u8_t *opt_data;
-	u16_t pos;
 
 	opt_data = net_pkt_icmp_opt_data(pkt, sizeof(struct net_icmp_hdr));
 	if (net_header_fits(pkt, opt_data, sizeof(*hdr))) {
 		return (struct net_icmpv6_ra_hdr *)opt_data;
 	}
 
-	frag = net_frag_read_u8(pkt->frags, net_pkt_ip_hdr_len(pkt) +
+	if (net_pkt_cursor_init(pkt, &cursor, net_pkt_ip_hdr_len(pkt) +
 				net_pkt_ipv6_ext_len(pkt) +
-				sizeof(struct net_icmp_hdr),
-				&pos, &hdr->cur_hop_limit);
-	frag = net_frag_read_u8(frag, pos, &pos, &hdr->flags);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->router_lifetime),
-			     (u8_t *)&hdr->router_lifetime);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->reachable_time),
-			     (u8_t *)&hdr->reachable_time);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->retrans_timer),
-			     (u8_t *)&hdr->retrans_timer);
-	if (pos > 0 && !frag) {
+				sizeof(struct net_icmp_hdr)) ||
+	    net_pkt_cursor_read(&cursor, hdr, sizeof(*hdr))) {
 		NET_ERR("Cannot get the ICMPv6 RA header");
 		return NULL;
 	}
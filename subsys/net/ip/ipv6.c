@@ -161,6 +161,62 @@ static inline struct net_nbr *get_nbr(int idx)
 	return &net_neighbor_pool[idx].nbr;
 }
 
+/* Index of the neighbors in use by IPv6 address: every bucket is a chain of
+ * neighbor pool indexes linked through nbr_hash_next.
+ */
+#define NBR_HASH_SIZE 16
+#define NBR_HASH_END 0xff
+
+BUILD_ASSERT(CONFIG_NET_IPV6_MAX_NEIGHBORS < NBR_HASH_END);
+
+static u8_t nbr_hash[NBR_HASH_SIZE] = {
+	[0 ... (NBR_HASH_SIZE - 1)] = NBR_HASH_END
+};
+static u8_t nbr_hash_next[CONFIG_NET_IPV6_MAX_NEIGHBORS];
+
+static inline u8_t nbr_hash_bucket(const struct in6_addr *addr)
+{
+	u32_t value = UNALIGNED_GET(&addr->s6_addr32[0]) ^
+		UNALIGNED_GET(&addr->s6_addr32[1]) ^
+		UNALIGNED_GET(&addr->s6_addr32[2]) ^
+		UNALIGNED_GET(&addr->s6_addr32[3]);
+
+	value ^= value >> 16;
+	value ^= value >> 8;
+
+	return value % NBR_HASH_SIZE;
+}
+
+static inline u8_t nbr_pool_idx(struct net_nbr *nbr)
+{
+	return ((u8_t *)nbr - (u8_t *)net_neighbor_pool) /
+		sizeof(net_neighbor_pool[0]);
+}
+
+static void nbr_hash_add(struct net_nbr *nbr)
+{
+	u8_t *head = &nbr_hash[nbr_hash_bucket(&net_ipv6_nbr_data(nbr)->addr)];
+	u8_t idx = nbr_pool_idx(nbr);
+
+	nbr_hash_next[idx] = *head;
+	*head = idx;
+}
+
+static void nbr_hash_remove(struct net_nbr *nbr)
+{
+	u8_t *link = &nbr_hash[nbr_hash_bucket(&net_ipv6_nbr_data(nbr)->addr)];
+	u8_t idx = nbr_pool_idx(nbr);
+
+	while (*link != NBR_HASH_END) {
+		if (*link == idx) {
+			*link = nbr_hash_next[idx];
+			return;
+		}
+
+		link = &nbr_hash_next[*link];
+	}
+}
+
 static inline struct net_nbr *get_nbr_from_data(struct net_ipv6_nbr_data *data)
 {
 	int i;
@@ -245,15 +301,12 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 				  struct net_if *iface,
 				  struct in6_addr *addr)
 {
-	int i;
+	u8_t i;
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
+	for (i = nbr_hash[nbr_hash_bucket(addr)]; i != NBR_HASH_END;
+	     i = nbr_hash_next[i]) {
 		struct net_nbr *nbr = get_nbr(i);
 
-		if (!nbr->ref) {
-			continue;
-		}
-
 		if (iface && nbr->iface != iface) {
 			continue;
 		}
@@ -266,10 +319,82 @@ static struct net_nbr *nbr_lookup(struct net_nbr_table *table,
 	return NULL;
 }
 
+/* Packets waiting for the link address of a neighbor, besides the first
+ * one that is kept in the neighbor data. The queue is shared by all the
+ * neighbors and kept in sending order.
+ */
+static struct {
+	struct net_nbr *nbr;
+	struct net_pkt *pkt;
+} nbr_queue[CONFIG_NET_IPV6_NBR_PENDING_QUEUE_SIZE];
+static int nbr_queue_len;
+
+static bool nbr_queue_add(struct net_nbr *nbr, struct net_pkt *pkt)
+{
+	unsigned int key;
+	int i, count = 1;
+
+	key = irq_lock();
+
+	for (i = 0; i < nbr_queue_len; i++) {
+		if (nbr_queue[i].nbr == nbr) {
+			count++;
+		}
+	}
+
+	if (count >= CONFIG_NET_IPV6_NBR_PENDING_COUNT ||
+	    nbr_queue_len == ARRAY_SIZE(nbr_queue)) {
+		irq_unlock(key);
+		return false;
+	}
+
+	nbr_queue[nbr_queue_len].nbr = nbr;
+	nbr_queue[nbr_queue_len].pkt = pkt;
+	nbr_queue_len++;
+
+	irq_unlock(key);
+
+	return true;
+}
+
+/* Send the queued packets of a neighbor as a batch, or drop them */
+static void nbr_queue_flush(struct net_nbr *nbr, bool send)
+{
+	struct net_pkt *pkts[CONFIG_NET_IPV6_NBR_PENDING_COUNT];
+	unsigned int key;
+	int i, j, count = 0;
+
+	/* Take the packets out first, sending might queue new ones */
+	key = irq_lock();
+
+	for (i = 0, j = 0; i < nbr_queue_len; i++) {
+		if (nbr_queue[i].nbr == nbr) {
+			pkts[count++] = nbr_queue[i].pkt;
+		} else {
+			nbr_queue[j++] = nbr_queue[i];
+		}
+	}
+
+	nbr_queue_len = j;
+
+	irq_unlock(key);
+
+	for (i = 0; i < count; i++) {
+		NET_DBG("%s queued pkt %p", send ? "Sending" : "Dropping",
+			pkts[i]);
+
+		if (!send || net_send_data(pkts[i]) < 0) {
+			net_pkt_unref(pkts[i]);
+		}
+	}
+}
+
 static inline void nbr_clear_ns_pending(struct net_ipv6_nbr_data *data)
 {
 	k_delayed_work_cancel(&data->send_ns);
 
+	nbr_queue_flush(get_nbr_from_data(data), false);
+
 	if (data->pending) {
 		net_pkt_unref(data->pending);
 		data->pending = NULL;
@@ -352,6 +477,8 @@ static void ns_reply_timeout(struct k_work *work)
 
 	data->pending = NULL;
 
+	nbr_queue_flush(nbr, false);
+
 	net_nbr_unref(nbr);
 }
 
@@ -386,6 +513,7 @@ static struct net_nbr *nbr_new(struct net_if *iface,
 	}
 
 	nbr_init(nbr, iface, addr, true, state);
+	nbr_hash_add(nbr);
 
 	NET_DBG("nbr %p iface %p state %d IPv6 %s",
 		nbr, iface, state, net_sprint_ipv6_addr(addr));
@@ -556,7 +684,7 @@ void net_neighbor_data_remove(struct net_nbr *nbr)
 {
 	NET_DBG("Neighbor %p removed", nbr);
 
-	return;
+	nbr_hash_remove(nbr);
 }
 
 void net_neighbor_table_clear(struct net_nbr_table *table)
@@ -1563,7 +1691,8 @@ nexthop_found:
 			goto drop;
 		}
 
-		if (ifaddr->addr_state == NET_ADDR_TENTATIVE) {
+		if (ifaddr->addr_state == NET_ADDR_TENTATIVE ||
+		    ifaddr->addr_state == NET_ADDR_OPTIMISTIC) {
 			NET_DBG("DAD failed for %s iface %p",
 				net_sprint_ipv6_addr(&ifaddr->address.in6_addr),
 				net_pkt_iface(pkt));
@@ -1628,6 +1757,14 @@ nexthop_found:
 	}
 
 send_na:
+	/* RFC 4429 3.3 Do not override the cache entries of the neighbors
+	 * with an address which may turn out to be a duplicate.
+	 */
+	if (IS_ENABLED(CONFIG_NET_IPV6_OPTIMISTIC_DAD) && ifaddr &&
+	    ifaddr->addr_state == NET_ADDR_OPTIMISTIC) {
+		flags &= ~NET_ICMPV6_NA_FLAG_OVERRIDE;
+	}
+
 	ret = net_ipv6_send_na(net_pkt_iface(pkt),
 			       src,
 			       &NET_IPV6_HDR(pkt)->dst,
@@ -1935,6 +2072,8 @@ send_pending:
 			nbr_clear_ns_pending(net_ipv6_nbr_data(nbr));
 		} else {
 			net_ipv6_nbr_data(nbr)->pending = NULL;
+			k_delayed_work_cancel(&net_ipv6_nbr_data(nbr)->send_ns);
+			nbr_queue_flush(nbr, true);
 		}
 
 		net_pkt_unref(pending);
@@ -2029,7 +2168,8 @@ static enum net_verdict handle_na_input(struct net_pkt *pkt)
 			net_sprint_ipv6_addr(&na_hdr->tgt));
 
 #if defined(CONFIG_NET_IPV6_DAD)
-		if (ifaddr->addr_state == NET_ADDR_TENTATIVE) {
+		if (ifaddr->addr_state == NET_ADDR_TENTATIVE ||
+		    ifaddr->addr_state == NET_ADDR_OPTIMISTIC) {
 			dad_failed(net_pkt_iface(pkt), &na_hdr->tgt);
 		}
 #endif /* CONFIG_NET_IPV6_DAD */
@@ -2053,6 +2193,19 @@ drop:
 	return NET_DROP;
 }
 
+#if defined(CONFIG_NET_IPV6_OPTIMISTIC_DAD)
+static bool is_optimistic_addr(struct net_if *iface, struct in6_addr *addr)
+{
+	struct net_if_addr *ifaddr;
+
+	ifaddr = net_if_ipv6_addr_lookup_by_iface(iface, addr);
+
+	return ifaddr && ifaddr->addr_state == NET_ADDR_OPTIMISTIC;
+}
+#else
+#define is_optimistic_addr(...) false
+#endif
+
 int net_ipv6_send_ns(struct net_if *iface,
 		     struct net_pkt *pending,
 		     struct in6_addr *src,
@@ -2134,13 +2287,21 @@ int net_ipv6_send_ns(struct net_if *iface,
 			goto drop;
 		}
 
-		net_buf_add(frag, llao_len);
+		/* RFC 4429 3.3 The link address is not announced from an
+		 * optimistic address, as it would update the neighbor
+		 * cache of the target.
+		 */
+		if (is_optimistic_addr(iface, &NET_IPV6_HDR(pkt)->src)) {
+			NET_IPV6_HDR(pkt)->len[1] -= llao_len;
+		} else {
+			net_buf_add(frag, llao_len);
 
-		set_llao(net_if_get_link_addr(net_pkt_iface(pkt)),
-			 (u8_t *)net_pkt_icmp_data(pkt) +
+			set_llao(net_if_get_link_addr(net_pkt_iface(pkt)),
+				 (u8_t *)net_pkt_icmp_data(pkt) +
 					sizeof(struct net_icmp_hdr) +
 					sizeof(struct net_icmpv6_ns_hdr),
-			 llao_len, NET_ICMPV6_ND_OPT_SLLAO);
+				 llao_len, NET_ICMPV6_ND_OPT_SLLAO);
+		}
 	}
 
 	net_icmpv6_set_chksum(pkt, pkt->frags);
@@ -2165,6 +2326,14 @@ int net_ipv6_send_ns(struct net_if *iface,
 	if (pending) {
 		if (!net_ipv6_nbr_data(nbr)->pending) {
 			net_ipv6_nbr_data(nbr)->pending = net_pkt_ref(pending);
+		} else if (nbr_queue_add(nbr, pending)) {
+			/* The NS already sent for the pending packet will
+			 * resolve the address for this one too.
+			 */
+			NET_DBG("Packet %p queued behind pending %p",
+				pending, net_ipv6_nbr_data(nbr)->pending);
+			net_pkt_unref(pkt);
+			return 0;
 		} else {
 			NET_DBG("Packet %p already pending for "
 				"operation. Discarding pending %p and pkt %p",
@@ -2759,6 +2928,7 @@ static enum net_verdict handle_ra_input(struct net_pkt *pkt)
 			net_pkt_unref(net_ipv6_nbr_data(nbr)->pending);
 		}
 
+		nbr_queue_flush(nbr, true);
 		nbr_clear_ns_pending(net_ipv6_nbr_data(nbr));
 	}
 
@@ -3130,54 +3300,37 @@ static struct net_ipv6_reassembly *reassembly_get(u32_t id,
 	net_ipaddr_copy(&reassembly[avail].dst, dst);
 
 	reassembly[avail].id = id;
+	reassembly[avail].len = 0;
 
 	return &reassembly[avail];
 }
 
-static bool reassembly_cancel(u32_t id,
-			      struct in6_addr *src,
-			      struct in6_addr *dst)
+static void reassembly_release(struct net_ipv6_reassembly *reass)
 {
-	int i, j;
+	s32_t remaining;
+	int i;
 
-	NET_DBG("Cancel 0x%x", id);
+	remaining = k_delayed_work_remaining_get(&reass->timer);
+	if (remaining) {
+		k_delayed_work_cancel(&reass->timer);
+	}
 
-	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
-		s32_t remaining;
+	NET_DBG("IPv6 reassembly id 0x%x remaining %d ms",
+		reass->id, remaining);
 
-		if (reassembly[i].id != id ||
-		    !net_ipv6_addr_cmp(src, &reassembly[i].src) ||
-		    !net_ipv6_addr_cmp(dst, &reassembly[i].dst)) {
-			continue;
-		}
+	reass->id = 0;
 
-		remaining = k_delayed_work_remaining_get(&reassembly[i].timer);
-		if (remaining) {
-			k_delayed_work_cancel(&reassembly[i].timer);
+	for (i = 0; i < NET_IPV6_FRAGMENTS_MAX_PKT; i++) {
+		if (!reass->pkt[i]) {
+			continue;
 		}
 
-		NET_DBG("IPv6 reassembly id 0x%x remaining %d ms",
-			reassembly[i].id, remaining);
-
-		reassembly[i].id = 0;
-
-		for (j = 0; j < NET_IPV6_FRAGMENTS_MAX_PKT; j++) {
-			if (!reassembly[i].pkt[j]) {
-				continue;
-			}
-
-			NET_DBG("[%d] IPv6 reassembly pkt %p %zd bytes data",
-				j, reassembly[i].pkt[j],
-				net_pkt_get_len(reassembly[i].pkt[j]));
-
-			net_pkt_unref(reassembly[i].pkt[j]);
-			reassembly[i].pkt[j] = NULL;
-		}
+		NET_DBG("[%d] IPv6 reassembly pkt %p %zd bytes data",
+			i, reass->pkt[i], net_pkt_get_len(reass->pkt[i]));
 
-		return true;
+		net_pkt_unref(reass->pkt[i]);
+		reass->pkt[i] = NULL;
 	}
-
-	return false;
 }
 
 static void reassembly_info(char *str, struct net_ipv6_reassembly *reass)
@@ -3207,7 +3360,81 @@ static void reassembly_timeout(struct k_work *work)
 
 	reassembly_info("Reassembly cancelled", reass);
 
-	reassembly_cancel(reass->id, &reass->src, &reass->dst);
+	reassembly_release(reass);
+}
+
+/* Length of the fragmentable part of the original packet that is carried
+ * by a fragment, i.e. the data after the fragment header.
+ */
+static u16_t fragment_len(struct net_pkt *pkt)
+{
+	return net_pkt_get_len(pkt) - sizeof(struct net_ipv6_frag_hdr) -
+		(net_pkt_ipv6_fragment_start(pkt) - pkt->frags->data);
+}
+
+/* Amount of fragment data held by the reassemblies of an interface */
+static size_t reassembly_mem(struct net_if *iface)
+{
+	size_t mem = 0;
+	int i, j;
+
+	for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
+		if (!reassembly[i].pkt[0] ||
+		    net_pkt_iface(reassembly[i].pkt[0]) != iface) {
+			continue;
+		}
+
+		for (j = 0; j < NET_IPV6_FRAGMENTS_MAX_PKT &&
+			     reassembly[i].pkt[j]; j++) {
+			mem += net_pkt_get_len(reassembly[i].pkt[j]);
+		}
+	}
+
+	return mem;
+}
+
+/* Cancel the oldest reassemblies of the interface, except the one given,
+ * until len more bytes fit in its reassembly memory.
+ */
+static bool reassembly_reclaim(struct net_if *iface, size_t len,
+			       struct net_ipv6_reassembly *keep)
+{
+	struct net_ipv6_reassembly *reass, *oldest;
+	s32_t remaining, min;
+	int i;
+
+	while (reassembly_mem(iface) + len >
+	       CONFIG_NET_IPV6_FRAGMENT_MAX_MEM) {
+		oldest = NULL;
+		min = 0;
+
+		for (i = 0; i < CONFIG_NET_IPV6_FRAGMENT_MAX_COUNT; i++) {
+			reass = &reassembly[i];
+
+			if (reass == keep || !reass->pkt[0] ||
+			    net_pkt_iface(reass->pkt[0]) != iface) {
+				continue;
+			}
+
+			/* All reassemblies get the same timeout, the one
+			 * with the least time left is the oldest.
+			 */
+			remaining = k_delayed_work_remaining_get(&reass->timer);
+			if (!oldest || remaining < min) {
+				oldest = reass;
+				min = remaining;
+			}
+		}
+
+		if (!oldest) {
+			return false;
+		}
+
+		reassembly_info("Reassembly reclaimed", oldest);
+		reassembly_release(oldest);
+	}
+
+	return true;
 }
 
 static void reassemble_packet(struct net_ipv6_reassembly *reass)
@@ -3227,7 +3454,7 @@ static void reassemble_packet(struct net_ipv6_reassembly *reass)
 	/* We start from 2nd packet which is then appended to
 	 * the first one.
 	 */
-	for (i = 1; i < NET_IPV6_FRAGMENTS_MAX_PKT; i++) {
+	for (i = 1; i < NET_IPV6_FRAGMENTS_MAX_PKT && reass->pkt[i]; i++) {
 		int removed_len;
 
 		pkt = reass->pkt[i];
@@ -3329,66 +3556,27 @@ void net_ipv6_frag_foreach(net_ipv6_frag_cb_t cb, void *user_data)
 	}
 }
 
-/* Verify that we have all the fragments received and in correct order.
+/* Verify that all the fragments have been received: they must follow each
+ * other without holes, from offset 0 up to the end of the last fragment.
  */
-static bool fragment_verify(struct net_ipv6_reassembly *reass)
+static bool reassembly_complete(struct net_ipv6_reassembly *reass)
 {
-	u16_t offset;
-	int i, prev_len;
-
-	prev_len = net_pkt_get_len(reass->pkt[0]);
-	offset = net_pkt_ipv6_fragment_offset(reass->pkt[0]);
-
-	NET_DBG("pkt %p offset %u", reass->pkt[0], offset);
+	u32_t end = 0;
+	int i;
 
-	if (offset != 0) {
+	if (!reass->len) {
 		return false;
 	}
 
-	for (i = 1; i < NET_IPV6_FRAGMENTS_MAX_PKT; i++) {
-		offset = net_pkt_ipv6_fragment_offset(reass->pkt[i]);
-
-		NET_DBG("pkt %p offset %u prev_len %d", reass->pkt[i],
-			offset, prev_len);
-
-		if (prev_len < offset) {
-			/* Something wrong with the offset value */
+	for (i = 0; i < NET_IPV6_FRAGMENTS_MAX_PKT && reass->pkt[i]; i++) {
+		if (net_pkt_ipv6_fragment_offset(reass->pkt[i]) != end) {
 			return false;
 		}
 
-		prev_len = net_pkt_get_len(reass->pkt[i]);
-	}
-
-	return true;
-}
-
-static int shift_packets(struct net_ipv6_reassembly *reass, int pos)
-{
-	int i;
-
-	for (i = pos + 1; i < NET_IPV6_FRAGMENTS_MAX_PKT; i++) {
-		if (!reass->pkt[i]) {
-			NET_DBG("Moving [%d] %p (offset 0x%x) to [%d]",
-				pos, reass->pkt[pos],
-				net_pkt_ipv6_fragment_offset(reass->pkt[pos]),
-				i);
-
-			/* Do we have enough space in packet array to make
-			 * the move?
-			 */
-			if (((i - pos) + 1) >
-			    (NET_IPV6_FRAGMENTS_MAX_PKT - i)) {
-				return -ENOMEM;
-			}
-
-			memmove(&reass->pkt[i], &reass->pkt[pos],
-				sizeof(void *) * (i - pos));
-
-			return 0;
-		}
+		end += fragment_len(reass->pkt[i]);
 	}
 
-	return -EINVAL;
+	return end == reass->len;
 }
 
 static enum net_verdict handle_fragment_hdr(struct net_pkt *pkt,
@@ -3397,14 +3585,16 @@ static enum net_verdict handle_fragment_hdr(struct net_pkt *pkt,
 					    u16_t buf_offset)
 {
 	struct net_ipv6_reassembly *reass = NULL;
+	struct net_pkt *prev, *next;
 	u32_t id;
+	u32_t end;
 	u16_t loc;
 	u16_t offset;
 	u16_t flag;
+	u16_t len;
 	u8_t nexthdr;
 	u8_t more;
-	bool found;
-	int i;
+	int i, n;
 
 	if (!reassembly_init_done) {
 		/* Static initializing does not work here because of the array
@@ -3429,109 +3619,124 @@ static enum net_verdict handle_fragment_hdr(struct net_pkt *pkt,
 		goto drop;
 	}
 
-	reass = reassembly_get(id, &NET_IPV6_HDR(pkt)->src,
-			       &NET_IPV6_HDR(pkt)->dst);
-	if (!reass) {
-		NET_DBG("Cannot get reassembly slot, dropping pkt %p", pkt);
-		goto drop;
-	}
-
 	offset = flag & 0xfff8;
 	more = flag & 0x01;
+	len = fragment_len(pkt);
+	end = offset + len;
 
 	net_pkt_set_ipv6_fragment_offset(pkt, offset);
 
-	if (!reass->pkt[0]) {
-		NET_DBG("Storing pkt %p to slot %d offset 0x%x", pkt, 0,
-			offset);
-		reass->pkt[0] = pkt;
+	if (more && len % 8) {
+		/* Fragment length is not multiple of 8, discard
+		 * the packet and send parameter problem error.
+		 */
+		net_icmpv6_send_error(pkt, NET_ICMPV6_PARAM_PROBLEM,
+				      NET_ICMPV6_PARAM_PROB_OPTION, 0);
+		goto drop;
+	}
 
-		reassembly_info("Reassembly 1st pkt", reass);
+	if (!len || end > 0xffff) {
+		NET_DBG("Invalid fragment offset 0x%x len %u", offset, len);
+		goto drop;
+	}
 
-		/* Wait for more fragments to receive. */
-		goto accept;
+	reass = reassembly_get(id, &NET_IPV6_HDR(pkt)->src,
+			       &NET_IPV6_HDR(pkt)->dst);
+	if (!reass) {
+		NET_DBG("Cannot get reassembly slot, dropping pkt %p", pkt);
+		goto drop;
 	}
 
-	/* The fragments might come in wrong order so place them
-	 * in reassembly chain in correct order.
-	 */
-	for (i = 0, found = false; i < NET_IPV6_FRAGMENTS_MAX_PKT; i++) {
-		if (!reass->pkt[i]) {
-			NET_DBG("Storing pkt %p to slot %d offset 0x%x", pkt,
-				i, offset);
-			reass->pkt[i] = pkt;
-			found = true;
-			break;
+	if (!more) {
+		if (reass->len && reass->len != end) {
+			NET_DBG("Last fragments differ for 0x%x", reass->id);
+			goto cancel;
 		}
 
-		if (net_pkt_ipv6_fragment_offset(reass->pkt[i]) < offset) {
-			continue;
-		}
+		reass->len = end;
+	}
 
-		/* Make room for this fragment, if there is no room, then
-		 * discard the whole reassembly.
-		 */
-		if (shift_packets(reass, i)) {
-			break;
+	/* The fragments are kept in offset order, they might come in
+	 * any order so find the place of this one.
+	 */
+	i = n = 0;
+	while (n < NET_IPV6_FRAGMENTS_MAX_PKT && reass->pkt[n]) {
+		if (net_pkt_ipv6_fragment_offset(reass->pkt[n]) < offset) {
+			i = n + 1;
 		}
 
-		NET_DBG("Storing %p (offset 0x%x) to [%d]", pkt, offset, i);
-		reass->pkt[i] = pkt;
-		found = true;
-		break;
+		n++;
 	}
 
-	if (!found) {
-		/* We could not add this fragment into our saved fragment
-		 * list. We must discard the whole packet at this point.
-		 */
-		NET_DBG("No slots available for 0x%x", reass->id);
-		net_pkt_unref(pkt);
+	prev = i > 0 ? reass->pkt[i - 1] : NULL;
+	next = i < n ? reass->pkt[i] : NULL;
+
+	if (next && net_pkt_ipv6_fragment_offset(next) == offset &&
+	    fragment_len(next) == len) {
+		NET_DBG("Duplicate pkt %p offset 0x%x", pkt, offset);
 		goto drop;
 	}
 
-	if (more) {
-		if (net_pkt_get_len(pkt) % 8) {
-			/* Fragment length is not multiple of 8, discard
-			 * the packet and send parameter problem error.
-			 */
-			net_icmpv6_send_error(pkt, NET_ICMPV6_PARAM_PROBLEM,
-					      NET_ICMPV6_PARAM_PROB_OPTION, 0);
-			goto drop;
-		}
+	/* Overlapping fragments cancel the whole reassembly (RFC 8200
+	 * ch 4.5), as do fragments going beyond the last one.
+	 */
+	if ((prev && net_pkt_ipv6_fragment_offset(prev) +
+	     fragment_len(prev) > offset) ||
+	    (next && end > net_pkt_ipv6_fragment_offset(next))) {
+		NET_DBG("Overlapping fragments for 0x%x", reass->id);
+		goto cancel;
+	}
 
-		reassembly_info("Reassembly nth pkt", reass);
+	if (reass->len && n && (end > reass->len ||
+	    net_pkt_ipv6_fragment_offset(reass->pkt[n - 1]) +
+	    fragment_len(reass->pkt[n - 1]) > reass->len)) {
+		NET_DBG("Fragment beyond the end of 0x%x", reass->id);
+		goto cancel;
+	}
 
-		NET_DBG("More fragments to be received");
-		goto accept;
+	if (n == NET_IPV6_FRAGMENTS_MAX_PKT) {
+		/* The packet cannot be reassembled without this fragment */
+		NET_DBG("No slots available for 0x%x", reass->id);
+		goto cancel;
 	}
 
-	reassembly_info("Reassembly last pkt", reass);
+	if (CONFIG_NET_IPV6_FRAGMENT_MAX_MEM > 0 &&
+	    !reassembly_reclaim(net_pkt_iface(pkt), net_pkt_get_len(pkt),
+				reass)) {
+		NET_DBG("No reassembly memory left for 0x%x", reass->id);
+		goto cancel;
+	}
 
-	if (!fragment_verify(reass)) {
-		NET_DBG("Reassembled IPv6 verify failed, dropping id %u",
-			reass->id);
+	NET_DBG("Storing pkt %p to slot %d offset 0x%x", pkt, i, offset);
 
-		/* Let the caller release the already inserted pkt */
-		if (i < NET_IPV6_FRAGMENTS_MAX_PKT) {
-			reass->pkt[i] = NULL;
-		}
+	memmove(&reass->pkt[i + 1], &reass->pkt[i],
+		(n - i) * sizeof(reass->pkt[0]));
+	reass->pkt[i] = pkt;
 
-		net_pkt_unref(pkt);
-		goto drop;
+	if (!reassembly_complete(reass)) {
+		reassembly_info("Reassembly pkt", reass);
+
+		NET_DBG("More fragments to be received");
+		return NET_OK;
 	}
 
+	reassembly_info("Reassembly last pkt", reass);
+
 	/* The last fragment received, reassemble the packet */
 	reassemble_packet(reass);
 
-accept:
 	return NET_OK;
 
+cancel:
+	reassembly_info("Reassembly cancelled", reass);
+	reassembly_release(reass);
+
+	return NET_DROP;
+
 drop:
-	if (reass) {
-		if (reassembly_cancel(reass->id, &reass->src, &reass->dst)) {
-			return NET_OK;
-		}
+	if (reass && !reass->pkt[0]) {
+		/* Nothing was stored for it, do not keep the slot */
+		reassembly_release(reass);
 	}
 
 	return NET_DROP;
@@ -364,10 +364,11 @@ static inline void net_ipv6_nbr_set_reachable_timer(struct net_if *iface,
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 /* We do not have to accept larger than 1500 byte IPv6 packet (RFC 2460 ch 5).
  * This means that we should receive everything within first two fragments.
- * The first one being 1280 bytes and the second one 220 bytes.
+ * The first one being 1280 bytes and the second one 220 bytes. Senders
+ * using a smaller MTU, or larger packets, need more fragments.
  */
 #if !defined(NET_IPV6_FRAGMENTS_MAX_PKT)
-#define NET_IPV6_FRAGMENTS_MAX_PKT 2
+#define NET_IPV6_FRAGMENTS_MAX_PKT CONFIG_NET_IPV6_FRAGMENT_MAX_PKT
 #endif
 
 /** Store pending IPv6 fragment information that is needed for reassembly. */
@@ -384,11 +385,17 @@ struct net_ipv6_reassembly {
 	 */
 	struct k_delayed_work timer;
 
-	/** Pointers to pending fragments */
+	/** Pointers to pending fragments, sorted by fragment offset */
 	struct net_pkt *pkt[NET_IPV6_FRAGMENTS_MAX_PKT];
 
 	/** IPv6 fragment identification */
 	u32_t id;
+
+	/**
+	 * Length of the fragmentable part of the packet, known once the
+	 * last fragment has been received, 0 before that.
+	 */
+	u16_t len;
 };
 
 /**
@@ -89,7 +89,10 @@ static inline u16_t net_bt_reserve(struct net_if *iface, void *unused)
 	ARG_UNUSED(iface);
 	ARG_UNUSED(unused);
 
-	return 0;
+	/* Room for the L2CAP headers, so that L2CAP can send the data
+	 * fragments as they are
+	 */
+	return BT_L2CAP_SDU_CHAN_SEND_RESERVE;
 }
 
 static int net_bt_enable(struct net_if *iface, bool state)
@@ -198,7 +201,8 @@ static void ipsp_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
 	net_pkt_ll_src(pkt)->type = NET_LINK_BLUETOOTH;
 
 	/* Add data buffer as fragment of RX buffer, take a reference while
-	 * doing so since L2CAP will unref the buffer after return.
+	 * doing so since L2CAP will unref the buffer after return. Without
+	 * ipsp_alloc_buf() these are the L2CAP segments as received.
 	 */
 	net_pkt_frag_add(pkt, net_buf_ref(buf));
 
@@ -208,15 +212,19 @@ static void ipsp_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
 	}
 }
 
+#if !defined(CONFIG_NET_L2_BT_RX_ZERO_COPY)
 static struct net_buf *ipsp_alloc_buf(struct bt_l2cap_chan *chan)
 {
 	NET_DBG("Channel %p requires buffer", chan);
 
 	return net_pkt_get_reserve_rx_data(0, K_FOREVER);
 }
+#endif
 
 static struct bt_l2cap_chan_ops ipsp_ops = {
+#if !defined(CONFIG_NET_L2_BT_RX_ZERO_COPY)
 	.alloc_buf	= ipsp_alloc_buf,
+#endif
 	.recv		= ipsp_recv,
 	.connected	= ipsp_connected,
 	.disconnected	= ipsp_disconnected,
@@ -26,15 +26,191 @@
 
 static struct arp_entry arp_table[CONFIG_NET_ARP_TABLE_SIZE];
 
+/* Index of the entries in use by IP address: every bucket is a chain of
+ * arp_table indexes linked through arp_hash_next.
+ */
+#define ARP_HASH_SIZE 16
+#define ARP_HASH_END 0xff
+
+BUILD_ASSERT(CONFIG_NET_ARP_TABLE_SIZE < ARP_HASH_END);
+
+static u8_t arp_hash[ARP_HASH_SIZE];
+static u8_t arp_hash_next[CONFIG_NET_ARP_TABLE_SIZE];
+
+/* A single timer expires the pending requests of all the entries */
+static struct k_delayed_work arp_request_timer;
+
+/* Packets waiting for an ARP reply, besides the first one that is kept
+ * in the entry. The queue is shared by all the entries and kept in
+ * sending order.
+ */
+static struct {
+	struct arp_entry *entry;
+	struct net_pkt *pkt;
+} arp_queue[CONFIG_NET_ARP_PENDING_QUEUE_SIZE];
+static int arp_queue_len;
+
+static inline u8_t arp_hash_bucket(struct in_addr *addr)
+{
+	u32_t value = UNALIGNED_GET(&addr->s_addr);
+
+	value ^= value >> 16;
+	value ^= value >> 8;
+
+	return value % ARP_HASH_SIZE;
+}
+
+static void arp_entry_clear(struct arp_entry *entry)
+{
+	u8_t idx = entry - arp_table;
+	u8_t *link = &arp_hash[arp_hash_bucket(&entry->ip)];
+
+	while (*link != ARP_HASH_END) {
+		if (*link == idx) {
+			*link = arp_hash_next[idx];
+			break;
+		}
+
+		link = &arp_hash_next[*link];
+	}
+
+	entry->iface = NULL;
+}
+
+static void arp_entry_set(struct arp_entry *entry, struct net_if *iface,
+			  struct in_addr *addr)
+{
+	u8_t idx = entry - arp_table;
+	u8_t *head;
+
+	if (entry->iface) {
+		arp_entry_clear(entry);
+	}
+
+	entry->iface = iface;
+	net_ipaddr_copy(&entry->ip, addr);
+
+	head = &arp_hash[arp_hash_bucket(&entry->ip)];
+	arp_hash_next[idx] = *head;
+	*head = idx;
+}
+
+static struct arp_entry *arp_entry_lookup(struct net_if *iface,
+					  struct in_addr *addr)
+{
+	u8_t i;
+
+	for (i = arp_hash[arp_hash_bucket(addr)]; i != ARP_HASH_END;
+	     i = arp_hash_next[i]) {
+		if (arp_table[i].iface == iface &&
+		    net_ipv4_addr_cmp(&arp_table[i].ip, addr)) {
+			return &arp_table[i];
+		}
+	}
+
+	return NULL;
+}
+
+static bool arp_queue_add(struct arp_entry *entry, struct net_pkt *pkt)
+{
+	unsigned int key;
+	int i, count = 1;
+
+	if (entry->pending == pkt) {
+		return true;
+	}
+
+	key = irq_lock();
+
+	for (i = 0; i < arp_queue_len; i++) {
+		if (arp_queue[i].entry != entry) {
+			continue;
+		}
+
+		if (arp_queue[i].pkt == pkt) {
+			irq_unlock(key);
+			return true;
+		}
+
+		count++;
+	}
+
+	if (count >= CONFIG_NET_ARP_PENDING_COUNT ||
+	    arp_queue_len == ARRAY_SIZE(arp_queue)) {
+		irq_unlock(key);
+		return false;
+	}
+
+	arp_queue[arp_queue_len].entry = entry;
+	arp_queue[arp_queue_len].pkt = net_pkt_ref(pkt);
+	arp_queue_len++;
+
+	irq_unlock(key);
+
+	return true;
+}
+
+/* Send the queued packets of an entry as a batch, or drop them */
+static void arp_queue_flush(struct arp_entry *entry, bool send)
+{
+	struct net_pkt *pkts[CONFIG_NET_ARP_PENDING_COUNT];
+	unsigned int key;
+	int i, j, count = 0;
+
+	/* Take the packets out first, sending might queue new ones */
+	key = irq_lock();
+
+	for (i = 0, j = 0; i < arp_queue_len; i++) {
+		if (arp_queue[i].entry == entry) {
+			pkts[count++] = arp_queue[i].pkt;
+		} else {
+			arp_queue[j++] = arp_queue[i];
+		}
+	}
+
+	arp_queue_len = j;
+
+	irq_unlock(key);
+
+	for (i = 0; i < count; i++) {
+		NET_DBG("%s queued pkt %p", send ? "Sending" : "Dropping",
+			pkts[i]);
+
+		if (!send ||
+		    net_if_send_data(entry->iface, pkts[i]) == NET_DROP) {
+			net_pkt_unref(pkts[i]);
+		}
+	}
+}
+
 static inline struct arp_entry *find_entry(struct net_if *iface,
 					   struct in_addr *dst,
 					   struct arp_entry **free_entry,
 					   struct arp_entry **non_pending)
 {
+	struct arp_entry *entry;
 	int i;
 
 	NET_DBG("dst %s", net_sprint_ipv4_addr(dst));
 
+	entry = arp_entry_lookup(iface, dst);
+	if (entry) {
+		/* Is there already pending operation for this
+		 * IP address.
+		 */
+		if (entry->pending) {
+			NET_DBG("ARP already pending to %s ll %s",
+				net_sprint_ipv4_addr(dst),
+				net_sprint_ll_addr((u8_t *)&entry->eth.addr,
+						   sizeof(struct net_eth_addr)));
+			*free_entry = NULL;
+			*non_pending = NULL;
+			return NULL;
+		}
+
+		return entry;
+	}
+
 	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
 
 		NET_DBG("[%d] iface %p dst %s ll %s pending %p", i, iface,
@@ -43,25 +219,6 @@ static inline struct arp_entry *find_entry(struct net_if *iface,
 					   sizeof(struct net_eth_addr)),
 			arp_table[i].pending);
 
-		if (arp_table[i].iface == iface &&
-		    net_ipv4_addr_cmp(&arp_table[i].ip, dst)) {
-			/* Is there already pending operation for this
-			 * IP address.
-			 */
-			if (arp_table[i].pending) {
-				NET_DBG("ARP already pending to %s ll %s",
-					net_sprint_ipv4_addr(dst),
-					net_sprint_ll_addr((u8_t *)
-						&arp_table[i].eth.addr,
-						sizeof(struct net_eth_addr)));
-				*free_entry = NULL;
-				*non_pending = NULL;
-				return NULL;
-			}
-
-			return &arp_table[i];
-		}
-
 		/* We return also the first free entry */
 		if (!*free_entry && !arp_table[i].pending &&
 		    !arp_table[i].iface) {
@@ -150,12 +307,13 @@ static inline struct net_pkt *prepare_arp(struct net_if *iface,
 	 */
 	if (entry) {
 		entry->pending = net_pkt_ref(pending);
-		entry->iface = net_pkt_iface(pkt);
-
-		k_delayed_work_submit(&entry->arp_request_timer,
-				      ARP_REQUEST_TIMEOUT);
+		entry->req_start = k_uptime_get_32();
+		arp_entry_set(entry, net_pkt_iface(pkt), next_addr);
 
-		net_ipaddr_copy(&entry->ip, next_addr);
+		if (!k_delayed_work_remaining_get(&arp_request_timer)) {
+			k_delayed_work_submit(&arp_request_timer,
+					      ARP_REQUEST_TIMEOUT);
+		}
 
 		memcpy(&eth->src.addr,
 		       net_if_get_link_addr(entry->iface)->addr,
@@ -200,17 +358,40 @@ static inline struct net_pkt *prepare_arp(struct net_if *iface,
 
 static void arp_request_timeout(struct k_work *work)
 {
-	/* This means that the ARP failed. */
-	struct arp_entry *entry = CONTAINER_OF(work,
-					       struct arp_entry,
-					       arp_request_timer);
+	u32_t now = k_uptime_get_32();
+	s32_t next = 0;
+	int i;
+
+	ARG_UNUSED(work);
+
+	/* The requests that were not answered in time failed */
+	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
+		struct arp_entry *entry = &arp_table[i];
+		s32_t left;
+
+		if (!entry->pending) {
+			continue;
+		}
+
+		left = ARP_REQUEST_TIMEOUT - (s32_t)(now - entry->req_start);
+		if (left > 0) {
+			if (!next || left < next) {
+				next = left;
+			}
+
+			continue;
+		}
 
-	if (entry->pending) {
 		NET_DBG("Releasing pending pkt %p (ref %d)", entry->pending,
 			entry->pending->ref - 1);
 		net_pkt_unref(entry->pending);
 		entry->pending = NULL;
-		entry->iface = NULL;
+		arp_queue_flush(entry, false);
+		arp_entry_clear(entry);
+	}
+
+	if (next) {
+		k_delayed_work_submit(&arp_request_timer, next);
 	}
 }
 
@@ -286,6 +467,16 @@ struct net_pkt *net_arp_prepare(struct net_pkt *pkt)
 				 */
 				struct net_pkt *req;
 
+				/* Keep the packet for when the pending
+				 * request is answered, if there is room.
+				 */
+				entry = arp_entry_lookup(net_pkt_iface(pkt),
+							 addr);
+				if (entry && entry->pending &&
+				    !arp_queue_add(entry, pkt)) {
+					NET_DBG("No room to queue pkt %p", pkt);
+				}
+
 				req = prepare_arp(net_pkt_iface(pkt),
 						  addr, NULL, pkt);
 				NET_DBG("Resending ARP %p", req);
@@ -331,43 +522,36 @@ static inline void arp_update(struct net_if *iface,
 			      struct in_addr *src,
 			      struct net_eth_addr *hwaddr)
 {
-	int i;
+	struct arp_entry *entry;
 
 	NET_DBG("src %s", net_sprint_ipv4_addr(src));
 
-	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
-
-		NET_DBG("[%d] iface %p dst %s ll %s pending %p", i, iface,
-			net_sprint_ipv4_addr(&arp_table[i].ip),
-			net_sprint_ll_addr((u8_t *)&arp_table[i].eth.addr,
-					   sizeof(struct net_eth_addr)),
-			arp_table[i].pending);
-
-		if (arp_table[i].iface != iface ||
-		    !net_ipv4_addr_cmp(&arp_table[i].ip, src)) {
-			continue;
-		}
-
-		if (arp_table[i].pending) {
-			/* We only update the ARP cache if we were
-			 * initiating a request.
-			 */
-			k_delayed_work_cancel(&arp_table[i].arp_request_timer);
-
-			memcpy(&arp_table[i].eth, hwaddr,
-			       sizeof(struct net_eth_addr));
-
-			/* Set the dst in the pending packet */
-			net_pkt_ll_dst(arp_table[i].pending)->len =
-				sizeof(struct net_eth_addr);
-			net_pkt_ll_dst(arp_table[i].pending)->addr =
-				(u8_t *)
-				&NET_ETH_HDR(arp_table[i].pending)->dst.addr;
+	entry = arp_entry_lookup(iface, src);
+	if (!entry) {
+		return;
+	}
 
-			send_pending(iface, &arp_table[i].pending);
-		}
+	NET_DBG("[%d] iface %p dst %s ll %s pending %p",
+		(int)(entry - arp_table), iface,
+		net_sprint_ipv4_addr(&entry->ip),
+		net_sprint_ll_addr((u8_t *)&entry->eth.addr,
+				   sizeof(struct net_eth_addr)),
+		entry->pending);
 
-		return;
+	if (entry->pending) {
+		/* We only update the ARP cache if we were
+		 * initiating a request.
+		 */
+		memcpy(&entry->eth, hwaddr, sizeof(struct net_eth_addr));
+
+		/* Set the dst in the pending packet */
+		net_pkt_ll_dst(entry->pending)->len =
+			sizeof(struct net_eth_addr);
+		net_pkt_ll_dst(entry->pending)->addr =
+			(u8_t *)&NET_ETH_HDR(entry->pending)->dst.addr;
+
+		send_pending(iface, &entry->pending);
+		arp_queue_flush(entry, true);
 	}
 }
 
@@ -515,11 +699,14 @@ void net_arp_clear_cache(struct net_if *iface)
 
 		if (arp_table[i].pending) {
 			net_pkt_unref(arp_table[i].pending);
-			k_delayed_work_cancel(&arp_table[i].arp_request_timer);
+			arp_queue_flush(&arp_table[i], false);
+		}
+
+		if (arp_table[i].iface) {
+			arp_entry_clear(&arp_table[i]);
 		}
 
 		arp_table[i].pending = NULL;
-		arp_table[i].iface = NULL;
 
 		memset(&arp_table[i].ip, 0, sizeof(arp_table[i].ip));
 		memset(&arp_table[i].eth, 0, sizeof(arp_table[i].eth));
@@ -545,12 +732,8 @@ int net_arp_foreach(net_arp_cb_t cb, void *user_data)
 
 void net_arp_init(void)
 {
-	int i;
-
-	net_arp_clear_cache(NULL);
+	memset(arp_hash, ARP_HASH_END, sizeof(arp_hash));
+	memset(arp_table, 0, sizeof(arp_table));
 
-	for (i = 0; i < CONFIG_NET_ARP_TABLE_SIZE; i++) {
-		k_delayed_work_init(&arp_table[i].arp_request_timer,
-				    arp_request_timeout);
-	}
+	k_delayed_work_init(&arp_request_timer, arp_request_timeout);
 }
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#if defined(CONFIG_NET_DEBUG_L2_ETHERNET)
+#define SYS_LOG_DOMAIN "net/ethernet"
+#define NET_LOG_ENABLED 1
+#endif
+
+#include <kernel.h>
+#include <net/net_core.h>
+#include <net/ethernet_rx_poll.h>
+
+/* All the pollers run from the same thread, one budget at a time */
+static K_THREAD_STACK_DEFINE(rx_poll_stack,
+			     CONFIG_NET_L2_ETHERNET_RX_POLL_STACK_SIZE);
+static struct k_work_q rx_poll_work_q;
+static bool rx_poll_started;
+
+static void rx_poll_submit(struct net_eth_rx_poll *rx_poll, s32_t delay)
+{
+	k_delayed_work_submit_to_queue(&rx_poll_work_q, &rx_poll->work,
+				       delay);
+}
+
+static void rx_poll_handler(struct k_work *work)
+{
+	struct net_eth_rx_poll *rx_poll =
+		CONTAINER_OF(work, struct net_eth_rx_poll, work.work);
+	int count;
+
+	count = rx_poll->poll(rx_poll, rx_poll->budget);
+	rx_poll->irq_pkts += count;
+
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	if (rx_poll->stats) {
+		rx_poll->stats->polls++;
+		rx_poll->stats->pkts += count;
+		if (count >= rx_poll->budget) {
+			rx_poll->stats->budget_exhausted++;
+		}
+	}
+#endif
+
+	if (count >= rx_poll->budget) {
+		/* Go to the back of the queue, there may be more */
+		rx_poll_submit(rx_poll, K_NO_WAIT);
+		return;
+	}
+
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	if (rx_poll->stats) {
+		rx_poll->stats->max_pkts_per_irq =
+			max(rx_poll->stats->max_pkts_per_irq,
+			    rx_poll->irq_pkts);
+	}
+#endif
+
+	NET_DBG("RX poller %p drained, %u frames", rx_poll, rx_poll->irq_pkts);
+
+	rx_poll->irq_pkts = 0;
+	atomic_clear(&rx_poll->scheduled);
+
+	if (rx_poll->complete(rx_poll) &&
+	    !atomic_set(&rx_poll->scheduled, 1)) {
+		rx_poll_submit(rx_poll, K_NO_WAIT);
+	}
+}
+
+void net_eth_rx_poll_init(struct net_eth_rx_poll *rx_poll,
+			  net_eth_rx_poll_cb_t poll,
+			  net_eth_rx_complete_cb_t complete,
+			  struct net_stats_eth *stats)
+{
+	NET_ASSERT(poll && complete);
+
+	if (!rx_poll_started) {
+		rx_poll_started = true;
+
+		k_work_q_start(&rx_poll_work_q, rx_poll_stack,
+			       K_THREAD_STACK_SIZEOF(rx_poll_stack),
+			       K_PRIO_COOP(CONFIG_NET_L2_ETHERNET_RX_POLL_PRIO));
+	}
+
+	k_delayed_work_init(&rx_poll->work, rx_poll_handler);
+	rx_poll->poll = poll;
+	rx_poll->complete = complete;
+	atomic_clear(&rx_poll->scheduled);
+	rx_poll->irq_pkts = 0;
+
+	net_eth_rx_poll_set_coalesce(rx_poll,
+				     CONFIG_NET_L2_ETHERNET_RX_POLL_BUDGET,
+				     CONFIG_NET_L2_ETHERNET_RX_POLL_DELAY);
+
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	rx_poll->stats = stats ? &stats->rx_poll : NULL;
+#else
+	ARG_UNUSED(stats);
+#endif
+}
+
+void net_eth_rx_poll_set_coalesce(struct net_eth_rx_poll *rx_poll,
+				  u16_t budget, u16_t delay)
+{
+	rx_poll->budget = max(budget, 1);
+	rx_poll->delay = delay;
+}
+
+void net_eth_rx_poll_schedule(struct net_eth_rx_poll *rx_poll)
+{
+	if (atomic_set(&rx_poll->scheduled, 1)) {
+		return;
+	}
+
+#if defined(CONFIG_NET_STATISTICS_ETHERNET)
+	if (rx_poll->stats) {
+		rx_poll->stats->interrupts++;
+	}
+#endif
+
+	rx_poll_submit(rx_poll, rx_poll->delay);
+}
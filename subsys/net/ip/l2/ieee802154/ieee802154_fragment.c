@@ -80,13 +80,23 @@ static struct frag_cache cache[REASS_CACHE_SIZE];
  */
 
 static inline struct net_buf *prepare_new_fragment(struct net_pkt *pkt,
-						   u8_t offset)
+						   u8_t offset,
+						   struct net_buf **spare)
 {
 	struct net_buf *frag;
 
-	frag = net_pkt_get_frag(pkt, K_FOREVER);
-	if (!frag) {
-		return NULL;
+	/* Reuse an emptied buffer of the packet if there is one */
+	if (*spare) {
+		frag = *spare;
+		*spare = NULL;
+
+		net_buf_reset(frag);
+		net_buf_reserve(frag, net_pkt_ll_reserve(pkt));
+	} else {
+		frag = net_pkt_get_frag(pkt, K_FOREVER);
+		if (!frag) {
+			return NULL;
+		}
 	}
 
 	/* Reserve space for fragmentation header */
@@ -187,16 +197,29 @@ static inline u8_t move_frag_data(struct net_buf *frag,
 
 static inline void compact_frag(struct net_buf *frag, u8_t moved)
 {
-	u8_t remaining = frag->len - moved;
-
-	/* Move remaining data next to fragmentation header,
-	 * (leave space for header).
+	/* The buffer is only read from here on, or recycled once empty,
+	 * so the remaining data does not need to be moved to its start.
 	 */
-	if (remaining) {
-		memmove(frag->data, frag->data + moved, remaining);
+	net_buf_pull(frag, moved);
+}
+
+/* Unlink the emptied buffer from the chain to be fragmented, keeping it
+ * for the next fragment if nobody else holds it.
+ */
+static inline struct net_buf *release_frag(struct net_buf *frag,
+					   struct net_buf **spare)
+{
+	struct net_buf *next = frag->frags;
+
+	frag->frags = NULL;
+
+	if (frag->ref == 1 && !*spare) {
+		*spare = frag;
+	} else {
+		net_pkt_frag_unref(frag);
 	}
 
-	frag->len = remaining;
+	return next;
 }
 
 /**
@@ -220,10 +243,12 @@ static inline void compact_frag(struct net_buf *frag, u8_t moved)
  *  Create the first fragment, add fragmentation header and insert
  *  fragment at beginning of pkt, move data from next fragments to
  *  previous one, from here on insert fragmentation header and adjust
- *  data on subsequent packets.
+ *  data on subsequent packets. The buffers of the input chain are reused
+ *  for the fragments as they get emptied.
  */
 bool ieee802154_fragment(struct net_pkt *pkt, int hdr_diff)
 {
+	struct net_buf *spare = NULL;
 	struct net_buf *frag;
 	struct net_buf *next;
 	u16_t processed;
@@ -262,7 +287,7 @@ bool ieee802154_fragment(struct net_pkt *pkt, int hdr_diff)
 	while (1) {
 		if (!room) {
 			/* Prepare new fragment based on offset */
-			frag = prepare_new_fragment(pkt, offset);
+			frag = prepare_new_fragment(pkt, offset, &spare);
 			if (!frag) {
 				return false;
 			}
@@ -287,13 +312,17 @@ bool ieee802154_fragment(struct net_pkt *pkt, int hdr_diff)
 		compact_frag(next, move);
 
 		if (!next->len) {
-			next = net_pkt_frag_del(pkt, NULL, next);
+			next = release_frag(next, &spare);
 			if (!next) {
 				break;
 			}
 		}
 	}
 
+	if (spare) {
+		net_pkt_frag_unref(spare);
+	}
+
 	return true;
 }
 
@@ -27,7 +27,7 @@ static inline int csma_ca_tx_fragment(struct net_if *iface,
 {
 	const u8_t max_bo = CONFIG_NET_L2_IEEE802154_RADIO_CSMA_CA_MAX_BO;
 	const u8_t max_be = CONFIG_NET_L2_IEEE802154_RADIO_CSMA_CA_MAX_BE;
-	u8_t retries = CONFIG_NET_L2_IEEE802154_RADIO_TX_RETRIES;
+	u8_t retries = tx_attempts(iface);
 	struct ieee802154_context *ctx = net_if_l2_data(iface);
 	bool ack_required = prepare_for_ack(ctx, pkt, frag);
 	u8_t be = CONFIG_NET_L2_IEEE802154_RADIO_CSMA_CA_MIN_BE;
@@ -41,7 +41,8 @@ loop:
 		retries--;
 
 		if (be) {
-			u8_t bo_n = sys_rand32_get() & (2 << (be + 1));
+			/* random number of backoff periods in [0, 2^BE - 1] */
+			u8_t bo_n = sys_rand32_get() & ((1 << be) - 1);
 
 			k_busy_wait(bo_n * 20);
 		}
@@ -13,6 +13,20 @@ typedef int (ieee802154_radio_tx_frag_t)(struct net_if *iface,
 					 struct net_pkt *pkt,
 					 struct net_buf *frag);
 
+/* Transmission attempts left to the radio protocol for one fragment */
+static inline u8_t tx_attempts(struct net_if *iface)
+{
+	const enum ieee802154_hw_caps offload = IEEE802154_HW_TX_RX_ACK |
+						IEEE802154_HW_RETRANSMISSION;
+
+	/* Retrying would only repeat what the radio has already done */
+	if ((ieee802154_get_hw_capabilities(iface) & offload) == offload) {
+		return 1;
+	}
+
+	return CONFIG_NET_L2_IEEE802154_RADIO_TX_RETRIES;
+}
+
 static inline bool prepare_for_ack(struct ieee802154_context *ctx,
 				   struct net_pkt *pkt,
 				   struct net_buf *frag)
@@ -82,12 +96,18 @@ static inline int tx_packet_fragments(struct net_if *iface,
 {
 	int ret = 0;
 	struct net_buf *frag;
+	bool hw_csma;
+
+	hw_csma = IS_ENABLED(CONFIG_NET_L2_IEEE802154_RADIO_CSMA_CA) &&
+		  (ieee802154_get_hw_capabilities(iface) & IEEE802154_HW_CSMA);
 
+	/* With the channel access done by the radio, one call per fragment
+	 * is needed: fragments are handed over back to back, with no
+	 * software backoff or ACK wait in between.
+	 */
 	frag = pkt->frags;
 	while (frag) {
-		if (IS_ENABLED(CONFIG_NET_L2_IEEE802154_RADIO_CSMA_CA) &&
-		    ieee802154_get_hw_capabilities(iface) &
-		    IEEE802154_HW_CSMA) {
+		if (hw_csma) {
 			ret = ieee802154_tx(iface, pkt, frag);
 		} else {
 			ret = tx_func(iface, pkt, frag);
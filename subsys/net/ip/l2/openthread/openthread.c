@@ -94,10 +94,10 @@ void ot_receive_handler(otMessage *aMessage, void *context)
 {
 	struct openthread_context *ot_context = context;
 
+	u16_t len = otMessageGetLength(aMessage);
 	u16_t offset = 0;
 	u16_t read_len;
 	struct net_pkt *pkt;
-	struct net_buf *prev_buf = NULL;
 
 	pkt = net_pkt_get_reserve_rx(0, K_NO_WAIT);
 	if (!pkt) {
@@ -105,36 +105,27 @@ void ot_receive_handler(otMessage *aMessage, void *context)
 		goto out;
 	}
 
-	while (1) {
+	/* Only allocate the fragments the message fills */
+	while (offset < len) {
 		struct net_buf *pkt_buf;
 
 		pkt_buf = net_pkt_get_frag(pkt, K_NO_WAIT);
 		if (!pkt_buf) {
 			NET_ERR("Failed to get fragment buf");
 			net_pkt_unref(pkt);
+			pkt = NULL;
 			goto out;
 		}
 
-		read_len = otMessageRead(aMessage,
-					 offset,
-					 pkt_buf->data,
-					 net_buf_tailroom(pkt_buf));
+		net_pkt_frag_add(pkt, pkt_buf);
 
+		read_len = otMessageRead(aMessage, offset, pkt_buf->data,
+					 net_buf_tailroom(pkt_buf));
 		if (!read_len) {
-			net_buf_unref(pkt_buf);
 			break;
 		}
 
 		net_buf_add(pkt_buf, read_len);
-
-		if (!prev_buf) {
-			net_pkt_frag_insert(pkt, pkt_buf);
-		} else {
-			net_buf_frag_insert(prev_buf, pkt_buf);
-		}
-
-		prev_buf = pkt_buf;
-
 		offset += read_len;
 	}
 
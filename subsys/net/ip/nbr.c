@@ -21,6 +21,69 @@
 
 NET_NBR_LLADDR_INIT(net_neighbor_lladdr, CONFIG_NET_IPV6_MAX_NEIGHBORS);
 
+/* Index of the link layer addresses in use: every bucket is a chain of
+ * net_neighbor_lladdr indexes linked through lladdr_hash_next.
+ */
+#define LLADDR_HASH_SIZE 16
+
+static u8_t lladdr_hash[LLADDR_HASH_SIZE] = {
+	[0 ... (LLADDR_HASH_SIZE - 1)] = NET_NBR_LLADDR_UNKNOWN
+};
+static u8_t lladdr_hash_next[CONFIG_NET_IPV6_MAX_NEIGHBORS];
+
+static u8_t lladdr_hash_bucket(const u8_t *addr, u8_t len)
+{
+	u32_t value = len;
+
+	while (len--) {
+		value = (value * 31) + *addr++;
+	}
+
+	return value % LLADDR_HASH_SIZE;
+}
+
+static int lladdr_find(struct net_linkaddr *lladdr)
+{
+	u8_t i;
+
+	for (i = lladdr_hash[lladdr_hash_bucket(lladdr->addr, lladdr->len)];
+	     i != NET_NBR_LLADDR_UNKNOWN; i = lladdr_hash_next[i]) {
+		if (net_neighbor_lladdr[i].lladdr.len == lladdr->len &&
+		    !memcmp(lladdr->addr, net_neighbor_lladdr[i].lladdr.addr,
+			    lladdr->len)) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static void lladdr_hash_add(u8_t idx)
+{
+	struct net_linkaddr_storage *lladdr = &net_neighbor_lladdr[idx].lladdr;
+	u8_t *head = &lladdr_hash[lladdr_hash_bucket(lladdr->addr,
+						     lladdr->len)];
+
+	lladdr_hash_next[idx] = *head;
+	*head = idx;
+}
+
+static void lladdr_hash_remove(u8_t idx)
+{
+	struct net_linkaddr_storage *lladdr = &net_neighbor_lladdr[idx].lladdr;
+	u8_t *link = &lladdr_hash[lladdr_hash_bucket(lladdr->addr,
+						     lladdr->len)];
+
+	while (*link != NET_NBR_LLADDR_UNKNOWN) {
+		if (*link == idx) {
+			*link = lladdr_hash_next[idx];
+			return;
+		}
+
+		link = &lladdr_hash_next[*link];
+	}
+}
+
 #if defined(CONFIG_NET_DEBUG_IPV6_NBR_CACHE)
 void net_nbr_unref_debug(struct net_nbr *nbr, const char *caller, int line)
 #define net_nbr_unref(nbr) net_nbr_unref_debug(nbr, __func__, __LINE__)
@@ -94,24 +157,23 @@ int net_nbr_link(struct net_nbr *nbr, struct net_if *iface,
 		return -EALREADY;
 	}
 
-	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
-		if (avail < 0 && !net_neighbor_lladdr[i].ref) {
-			avail = i;
-		}
+	i = lladdr_find(lladdr);
+	if (i >= 0) {
+		/* We found same lladdr in nbr cache so just
+		 * increase the ref count.
+		 */
+		net_neighbor_lladdr[i].ref++;
 
-		if (net_neighbor_lladdr[i].ref &&
-		    !memcmp(lladdr->addr,
-			    net_neighbor_lladdr[i].lladdr.addr,
-			    lladdr->len)) {
-			/* We found same lladdr in nbr cache so just
-			 * increase the ref count.
-			 */
-			net_neighbor_lladdr[i].ref++;
+		nbr->idx = i;
+		nbr->iface = iface;
 
-			nbr->idx = i;
-			nbr->iface = iface;
+		return 0;
+	}
 
-			return 0;
+	for (i = 0; i < CONFIG_NET_IPV6_MAX_NEIGHBORS; i++) {
+		if (!net_neighbor_lladdr[i].ref) {
+			avail = i;
+			break;
 		}
 	}
 
@@ -128,6 +190,7 @@ int net_nbr_link(struct net_nbr *nbr, struct net_if *iface,
 	net_linkaddr_set(&net_neighbor_lladdr[avail].lladdr, lladdr->addr,
 			 lladdr->len);
 	net_neighbor_lladdr[avail].lladdr.len = lladdr->len;
+	lladdr_hash_add(avail);
 
 	nbr->iface = iface;
 
@@ -148,6 +211,7 @@ int net_nbr_unlink(struct net_nbr *nbr, struct net_linkaddr *lladdr)
 	net_neighbor_lladdr[nbr->idx].ref--;
 
 	if (!net_neighbor_lladdr[nbr->idx].ref) {
+		lladdr_hash_remove(nbr->idx);
 		memset(net_neighbor_lladdr[nbr->idx].lladdr.addr, 0,
 		       sizeof(net_neighbor_lladdr[nbr->idx].lladdr.addr));
 	}
@@ -162,15 +226,17 @@ struct net_nbr *net_nbr_lookup(struct net_nbr_table *table,
 			       struct net_if *iface,
 			       struct net_linkaddr *lladdr)
 {
-	int i;
+	int i, idx;
+
+	idx = lladdr_find(lladdr);
+	if (idx < 0) {
+		return NULL;
+	}
 
 	for (i = 0; i < table->nbr_count; i++) {
 		struct net_nbr *nbr = get_nbr(table->nbr, i);
 
-		if (nbr->ref && nbr->iface == iface &&
-		    net_neighbor_lladdr[nbr->idx].ref &&
-		    !memcmp(net_neighbor_lladdr[nbr->idx].lladdr.addr,
-			    lladdr->addr, lladdr->len)) {
+		if (nbr->ref && nbr->iface == iface && nbr->idx == idx) {
 			return nbr;
 		}
 	}
@@ -217,6 +217,24 @@ int net_context_get(sa_family_t family,
 		memset(&contexts[i].remote, 0, sizeof(struct sockaddr));
 		memset(&contexts[i].local, 0, sizeof(struct sockaddr_ptr));
 
+#if defined(CONFIG_NET_SOCKETS)
+		k_poll_signal_init(&contexts[i].poll_signal);
+#endif
+
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+#if defined(CONFIG_NET_TCP)
+		contexts[i].options.rcvbuf = ip_proto == IPPROTO_TCP ?
+			CONFIG_NET_TCP_RECV_WINDOW :
+			CONFIG_NET_CONTEXT_RCVBUF_DEFAULT;
+#else
+		contexts[i].options.rcvbuf = CONFIG_NET_CONTEXT_RCVBUF_DEFAULT;
+#endif
+#endif
+
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+		contexts[i].options.sndbuf = CONFIG_NET_TCP_SEND_BUFFER;
+#endif
+
 #if defined(CONFIG_NET_IPV6)
 		if (family == AF_INET6) {
 			struct sockaddr_in6 *addr6 = (struct sockaddr_in6
@@ -823,6 +841,7 @@ int net_context_accept(struct net_context *context,
 static int create_udp_packet(struct net_context *context,
 			     struct net_pkt *pkt,
 			     const struct sockaddr *dst_addr,
+			     const void *src,
 			     struct net_pkt **out_pkt)
 {
 	int r = 0;
@@ -832,7 +851,7 @@ static int create_udp_packet(struct net_context *context,
 	if (net_pkt_family(pkt) == AF_INET6) {
 		struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)dst_addr;
 
-		pkt = net_ipv6_create(context, pkt, NULL, &addr6->sin6_addr);
+		pkt = net_ipv6_create(context, pkt, src, &addr6->sin6_addr);
 		tmp = net_udp_insert(context, pkt,
 				     net_pkt_ip_hdr_len(pkt) +
 				     net_pkt_ipv6_ext_len(pkt),
@@ -851,7 +870,7 @@ static int create_udp_packet(struct net_context *context,
 	if (net_pkt_family(pkt) == AF_INET) {
 		struct sockaddr_in *addr4 = (struct sockaddr_in *)dst_addr;
 
-		pkt = net_ipv4_create(context, pkt, NULL, &addr4->sin_addr);
+		pkt = net_ipv4_create(context, pkt, src, &addr4->sin_addr);
 		tmp = net_udp_insert(context, pkt, net_pkt_ip_hdr_len(pkt),
 				     addr4->sin_port);
 		if (!tmp) {
@@ -873,27 +892,16 @@ static int create_udp_packet(struct net_context *context,
 }
 #endif /* CONFIG_NET_UDP */
 
-static int sendto(struct net_pkt *pkt,
-		  const struct sockaddr *dst_addr,
-		  socklen_t addrlen,
-		  net_context_send_cb_t cb,
-		  s32_t timeout,
-		  void *token,
-		  void *user_data)
+static int check_dst_addr(sa_family_t family,
+			  const struct sockaddr *dst_addr,
+			  socklen_t addrlen)
 {
-	struct net_context *context = net_pkt_context(pkt);
-	int ret = 0;
-
-	if (!net_context_is_used(context)) {
-		return -EBADF;
-	}
-
 	if (!dst_addr) {
 		return -EDESTADDRREQ;
 	}
 
 #if defined(CONFIG_NET_IPV6)
-	if (net_pkt_family(pkt) == AF_INET6) {
+	if (family == AF_INET6) {
 		struct sockaddr_in6 *addr6 = (struct sockaddr_in6 *)dst_addr;
 
 		if (addrlen < sizeof(struct sockaddr_in6)) {
@@ -907,7 +915,7 @@ static int sendto(struct net_pkt *pkt,
 #endif /* CONFIG_NET_IPV6 */
 
 #if defined(CONFIG_NET_IPV4)
-	if (net_pkt_family(pkt) == AF_INET) {
+	if (family == AF_INET) {
 		struct sockaddr_in *addr4 = (struct sockaddr_in *)dst_addr;
 
 		if (addrlen < sizeof(struct sockaddr_in)) {
@@ -920,10 +928,33 @@ static int sendto(struct net_pkt *pkt,
 	} else
 #endif /* CONFIG_NET_IPV4 */
 	{
-		NET_DBG("Invalid protocol family %d", net_pkt_family(pkt));
+		NET_DBG("Invalid protocol family %d", family);
 		return -EINVAL;
 	}
 
+	return 0;
+}
+
+static int sendto(struct net_pkt *pkt,
+		  const struct sockaddr *dst_addr,
+		  socklen_t addrlen,
+		  net_context_send_cb_t cb,
+		  s32_t timeout,
+		  void *token,
+		  void *user_data)
+{
+	struct net_context *context = net_pkt_context(pkt);
+	int ret = 0;
+
+	if (!net_context_is_used(context)) {
+		return -EBADF;
+	}
+
+	ret = check_dst_addr(net_pkt_family(pkt), dst_addr, addrlen);
+	if (ret < 0) {
+		return ret;
+	}
+
 #if defined(CONFIG_NET_OFFLOAD)
 	if (net_if_is_ip_offloaded(net_pkt_iface(pkt))) {
 		return net_offload_sendto(
@@ -933,6 +964,8 @@ static int sendto(struct net_pkt *pkt,
 	}
 #endif /* CONFIG_NET_OFFLOAD */
 
+	net_stats_latency_start(pkt);
+
 	switch (net_context_get_ip_proto(context)) {
 	case IPPROTO_UDP:
 #if defined(CONFIG_NET_UDP)
@@ -942,7 +975,7 @@ static int sendto(struct net_pkt *pkt,
 			return ret;
 		}
 
-		ret = create_udp_packet(context, pkt, dst_addr, &pkt);
+		ret = create_udp_packet(context, pkt, dst_addr, NULL, &pkt);
 #endif /* CONFIG_NET_UDP */
 		break;
 
@@ -1046,6 +1079,181 @@ int net_context_sendto(struct net_pkt *pkt,
 	return sendto(pkt, dst_addr, addrlen, cb, timeout, token, user_data);
 }
 
+#if defined(CONFIG_NET_UDP)
+/* What a batch remembers of the previous datagram, reused when the next one
+ * goes to the same peer.
+ */
+struct sendto_batch_peer {
+	struct sockaddr dst;
+	socklen_t addrlen;
+	union {
+#if defined(CONFIG_NET_IPV6)
+		struct in6_addr in6;
+#endif
+#if defined(CONFIG_NET_IPV4)
+		struct in_addr in;
+#endif
+	} src;
+	struct net_linkaddr ll_dst;
+};
+
+static void sendto_batch_peer_set(struct sendto_batch_peer *peer,
+				  struct net_pkt *pkt,
+				  const struct sockaddr *dst_addr,
+				  socklen_t addrlen)
+{
+	peer->ll_dst.addr = NULL;
+
+	if (addrlen > sizeof(peer->dst)) {
+		peer->addrlen = 0;
+		return;
+	}
+
+	memcpy(&peer->dst, dst_addr, addrlen);
+	peer->addrlen = addrlen;
+
+#if defined(CONFIG_NET_IPV6)
+	if (net_pkt_family(pkt) == AF_INET6) {
+		net_ipaddr_copy(&peer->src.in6, &NET_IPV6_HDR(pkt)->src);
+	}
+#endif
+#if defined(CONFIG_NET_IPV4)
+	if (net_pkt_family(pkt) == AF_INET) {
+		net_ipaddr_copy(&peer->src.in, &NET_IPV4_HDR(pkt)->src);
+	}
+#endif
+}
+
+int net_context_sendto_batch(struct net_context *context,
+			     struct net_context_dgram *dgrams,
+			     int count,
+			     net_context_send_cb_t cb,
+			     s32_t timeout,
+			     void *user_data)
+{
+	struct sendto_batch_peer peer = { .addrlen = 0 };
+	int i, queued, ret = 0;
+
+	NET_ASSERT(PART_OF_ARRAY(contexts, context));
+
+	if (!net_context_is_used(context)) {
+		return -EBADF;
+	}
+
+	if (net_context_get_ip_proto(context) != IPPROTO_UDP) {
+		return -EPROTOTYPE;
+	}
+
+	if (count <= 0) {
+		return 0;
+	}
+
+#if defined(CONFIG_NET_OFFLOAD)
+	if (net_if_is_ip_offloaded(net_context_get_iface(context))) {
+		for (i = 0; i < count; i++) {
+			ret = net_context_sendto(dgrams[i].pkt,
+						 dgrams[i].dst_addr,
+						 dgrams[i].addrlen, cb,
+						 timeout, dgrams[i].token,
+						 user_data);
+			if (ret < 0) {
+				break;
+			}
+		}
+
+		return i ? i : ret;
+	}
+#endif /* CONFIG_NET_OFFLOAD */
+
+	ret = bind_default(context);
+	if (ret) {
+		return ret;
+	}
+
+	context->send_cb = cb;
+	context->user_data = user_data;
+
+	net_tc_tx_batch_begin();
+
+	for (i = 0; i < count; i++) {
+		const struct sockaddr *dst_addr = dgrams[i].dst_addr;
+		socklen_t addrlen = dgrams[i].addrlen;
+		struct net_pkt *pkt = dgrams[i].pkt;
+		bool same_peer;
+
+		if (!dst_addr) {
+			if (!(context->flags & NET_CONTEXT_REMOTE_ADDR_SET) ||
+			    !net_sin(&context->remote)->sin_port) {
+				ret = -EDESTADDRREQ;
+				break;
+			}
+
+			dst_addr = &context->remote;
+			addrlen = net_context_get_family(context) == AF_INET6 ?
+				sizeof(struct sockaddr_in6) :
+				sizeof(struct sockaddr_in);
+		}
+
+		same_peer = peer.addrlen && addrlen == peer.addrlen &&
+			!memcmp(dst_addr, &peer.dst, addrlen);
+
+		if (!same_peer) {
+			ret = check_dst_addr(net_pkt_family(pkt), dst_addr,
+					     addrlen);
+			if (ret < 0) {
+				break;
+			}
+		}
+
+		/* The source address selection is done for the first
+		 * datagram to the peer only.
+		 */
+		ret = create_udp_packet(context, pkt, dst_addr,
+					same_peer ? &peer.src : NULL, &pkt);
+		if (ret < 0) {
+			NET_DBG("Could not create network packet to send (%d)",
+				ret);
+			break;
+		}
+
+		if (!same_peer) {
+			sendto_batch_peer_set(&peer, pkt, dst_addr, addrlen);
+		} else if (peer.ll_dst.addr) {
+			/* Skip the neighbor lookup */
+			net_pkt_ll_dst(pkt)->addr = peer.ll_dst.addr;
+			net_pkt_ll_dst(pkt)->len = peer.ll_dst.len;
+		}
+
+		net_pkt_set_token(pkt, dgrams[i].token);
+		dgrams[i].pkt = pkt;
+
+		queued = net_tc_tx_batch_len();
+
+		ret = net_send_data(pkt);
+		if (ret < 0) {
+			break;
+		}
+
+#if defined(CONFIG_NET_IPV6)
+		/* The packet waits in the batch, so the link address it was
+		 * given is still valid. Multicast ones point into the packet.
+		 */
+		if (!peer.ll_dst.addr && net_pkt_family(pkt) == AF_INET6 &&
+		    net_tc_tx_batch_len() == queued + 1 &&
+		    !net_is_ipv6_addr_mcast(&NET_IPV6_HDR(pkt)->dst)) {
+			peer.ll_dst = *net_pkt_ll_dst(pkt);
+		}
+#else
+		ARG_UNUSED(queued);
+#endif
+	}
+
+	net_tc_tx_batch_end();
+
+	return i ? i : ret;
+}
+#endif /* CONFIG_NET_UDP */
+
 void net_context_set_appdata_values(struct net_pkt *pkt,
 				    enum net_ip_protocol proto)
 {
@@ -1117,6 +1325,8 @@ enum net_verdict net_context_packet_received(struct net_conn *conn,
 		net_pkt_appdata(pkt), net_pkt_appdatalen(pkt),
 		net_pkt_get_len(pkt));
 
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_L4);
+
 	context->recv_cb(context, pkt, 0, user_data);
 
 #if defined(CONFIG_NET_CONTEXT_SYNC_RECV)
@@ -1292,6 +1502,87 @@ static int get_context_priority(struct net_context *context,
 #endif
 }
 
+static int set_context_rcvbuf(struct net_context *context,
+			      const void *value, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	u32_t rcvbuf;
+
+	if (len != sizeof(u32_t)) {
+		return -EINVAL;
+	}
+
+	rcvbuf = *((u32_t *)value);
+
+#if defined(CONFIG_NET_TCP)
+	/* The receive window follows the space left in the buffer */
+	if (net_context_get_ip_proto(context) == IPPROTO_TCP) {
+		int ret;
+
+		ret = net_tcp_update_recv_wnd(context,
+					      rcvbuf - context->options.rcvbuf);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+#endif
+
+	context->options.rcvbuf = rcvbuf;
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int get_context_rcvbuf(struct net_context *context,
+			      void *value, size_t *len)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	*((u32_t *)value) = context->options.rcvbuf;
+
+	if (len) {
+		*len = sizeof(u32_t);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int set_context_sndbuf(struct net_context *context,
+			      const void *value, size_t len)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	if (len != sizeof(u32_t)) {
+		return -EINVAL;
+	}
+
+	context->options.sndbuf = *((u32_t *)value);
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
+static int get_context_sndbuf(struct net_context *context,
+			      void *value, size_t *len)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	*((u32_t *)value) = context->options.sndbuf;
+
+	if (len) {
+		*len = sizeof(u32_t);
+	}
+
+	return 0;
+#else
+	return -ENOTSUP;
+#endif
+}
+
 int net_context_set_option(struct net_context *context,
 			   enum net_context_option option,
 			   const void *value, size_t len)
@@ -1308,6 +1599,12 @@ int net_context_set_option(struct net_context *context,
 	case NET_OPT_PRIORITY:
 		ret = set_context_priority(context, value, len);
 		break;
+	case NET_OPT_RCVBUF:
+		ret = set_context_rcvbuf(context, value, len);
+		break;
+	case NET_OPT_SNDBUF:
+		ret = set_context_sndbuf(context, value, len);
+		break;
 	}
 
 	return ret;
@@ -1329,6 +1626,12 @@ int net_context_get_option(struct net_context *context,
 	case NET_OPT_PRIORITY:
 		ret = get_context_priority(context, value, len);
 		break;
+	case NET_OPT_RCVBUF:
+		ret = get_context_rcvbuf(context, value, len);
+		break;
+	case NET_OPT_SNDBUF:
+		ret = get_context_sndbuf(context, value, len);
+		break;
 	}
 
 	return ret;
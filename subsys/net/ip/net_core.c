@@ -272,6 +272,7 @@ int net_send_data(struct net_pkt *pkt)
 		 * to RX processing.
 		 */
 		NET_DBG("Loopback pkt %p back to us", pkt);
+		net_stats_latency_start(pkt);
 		processing_data(pkt, true);
 		return 0;
 	}
@@ -310,6 +311,8 @@ static void process_rx_packet(struct k_work *work)
 
 	pkt = CONTAINER_OF(work, struct net_pkt, work);
 
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_QUEUE);
+
 	net_rx(net_pkt_iface(pkt), pkt);
 }
 
@@ -359,6 +362,8 @@ int net_recv_data(struct net_if *iface, struct net_pkt *pkt)
 
 	net_pkt_set_iface(pkt, iface);
 
+	net_stats_latency_start(pkt);
+
 	net_queue_rx(iface, pkt);
 
 	return 0;
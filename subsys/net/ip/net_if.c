@@ -125,6 +125,9 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 	struct net_context *context;
 	void *context_token;
 	int status;
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+	u32_t start;
+#endif
 
 	if (!pkt) {
 		return false;
@@ -142,7 +145,15 @@ static bool net_if_tx(struct net_if *iface, struct net_pkt *pkt)
 			net_pkt_set_queued(pkt, false);
 		}
 
+		net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_QUEUE);
+
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+		start = k_cycle_get_32();
+#endif
 		status = api->send(iface, pkt);
+
+		net_stats_update_latency_cycles(NET_STATS_LATENCY_TX_DRIVER,
+						k_cycle_get_32() - start);
 	} else {
 		/* Drop packet if interface is not up */
 		NET_WARN("iface %p is down", iface);
@@ -189,6 +200,8 @@ void net_if_queue_tx(struct net_if *iface, struct net_pkt *pkt)
 
 	k_work_init(net_pkt_work(pkt), process_tx_packet);
 
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_TX_STACK);
+
 #if defined(CONFIG_NET_STATISTICS)
 	pkt->total_pkt_len = net_pkt_get_len(pkt);
 
@@ -396,6 +409,171 @@ static u8_t get_ipaddr_diff(const u8_t *src, const u8_t *dst, int addr_len)
 }
 
 #if defined(CONFIG_NET_IPV6)
+#if defined(CONFIG_NET_IF_IPV6_ADDR_HASH)
+/* The unicast and multicast addresses of all the interfaces are also
+ * linked in hash tables, so that checking if an address is ours does
+ * not need to compare it with every address slot of every interface.
+ */
+static sys_slist_t ipv6_addr_hash[CONFIG_NET_IF_IPV6_ADDR_HASH_SIZE];
+static sys_slist_t ipv6_maddr_hash[CONFIG_NET_IF_IPV6_ADDR_HASH_SIZE];
+
+static sys_slist_t *ipv6_hash_bucket(sys_slist_t *table,
+				     const struct in6_addr *addr)
+{
+	u32_t hash = 0;
+	int i;
+
+	/* The address might not be aligned if it is in a packet */
+	for (i = 0; i < sizeof(addr->s6_addr); i++) {
+		hash = hash * 31 + addr->s6_addr[i];
+	}
+
+	return &table[hash % CONFIG_NET_IF_IPV6_ADDR_HASH_SIZE];
+}
+
+/* Find out the interface owning an address slot */
+static struct net_if *ipv6_hash_iface(const void *slot)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ipv6_addresses); i++) {
+		const void *start = &ipv6_addresses[i].ipv6;
+		const void *end = &ipv6_addresses[i].ipv6 + 1;
+
+		if (slot >= start && slot < end) {
+			return ipv6_addresses[i].iface;
+		}
+	}
+
+	return NULL;
+}
+
+static inline void ipv6_addr_hash_add(struct net_if_addr *ifaddr)
+{
+	sys_slist_append(ipv6_hash_bucket(ipv6_addr_hash,
+					  &ifaddr->address.in6_addr),
+			 &ifaddr->hash_node);
+}
+
+static inline void ipv6_addr_hash_rm(struct net_if_addr *ifaddr)
+{
+	sys_slist_find_and_remove(ipv6_hash_bucket(ipv6_addr_hash,
+						   &ifaddr->address.in6_addr),
+				  &ifaddr->hash_node);
+}
+
+static inline void ipv6_maddr_hash_add(struct net_if_mcast_addr *maddr)
+{
+	sys_slist_append(ipv6_hash_bucket(ipv6_maddr_hash,
+					  &maddr->address.in6_addr),
+			 &maddr->hash_node);
+}
+
+static inline void ipv6_maddr_hash_rm(struct net_if_mcast_addr *maddr)
+{
+	sys_slist_find_and_remove(ipv6_hash_bucket(ipv6_maddr_hash,
+						   &maddr->address.in6_addr),
+				  &maddr->hash_node);
+}
+
+/* When an address is set on several interfaces, the first interface
+ * is returned, as when going through the interfaces in order.
+ */
+static struct net_if_addr *ipv6_addr_hash_lookup(const struct in6_addr *addr,
+						 struct net_if **ret)
+{
+	struct net_if_addr *ifaddr, *found = NULL;
+	struct net_if *iface, *found_iface = NULL;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(ipv6_hash_bucket(ipv6_addr_hash, addr),
+				     ifaddr, hash_node) {
+		if (!net_ipv6_addr_cmp(addr, &ifaddr->address.in6_addr)) {
+			continue;
+		}
+
+		iface = ipv6_hash_iface(ifaddr);
+		if (!found || iface < found_iface) {
+			found = ifaddr;
+			found_iface = iface;
+		}
+	}
+
+	if (found && ret) {
+		*ret = found_iface;
+	}
+
+	return found;
+}
+
+static struct net_if_mcast_addr *
+ipv6_maddr_hash_lookup(const struct in6_addr *addr, struct net_if **ret)
+{
+	struct net_if_mcast_addr *maddr, *found = NULL;
+	struct net_if *iface, *found_iface = NULL;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(ipv6_hash_bucket(ipv6_maddr_hash, addr),
+				     maddr, hash_node) {
+		if (!net_ipv6_addr_cmp(addr, &maddr->address.in6_addr)) {
+			continue;
+		}
+
+		iface = ipv6_hash_iface(maddr);
+		if (ret && *ret && iface != *ret) {
+			continue;
+		}
+
+		if (!found || iface < found_iface ||
+		    (iface == found_iface && maddr < found)) {
+			found = maddr;
+			found_iface = iface;
+		}
+	}
+
+	if (found && ret) {
+		*ret = found_iface;
+	}
+
+	return found;
+}
+
+static void ipv6_hash_flush(struct net_if_ipv6 *ipv6)
+{
+	int i;
+
+	for (i = 0; i < NET_IF_MAX_IPV6_ADDR; i++) {
+		if (ipv6->unicast[i].is_used) {
+			ipv6_addr_hash_rm(&ipv6->unicast[i]);
+		}
+	}
+
+	for (i = 0; i < NET_IF_MAX_IPV6_MADDR; i++) {
+		if (ipv6->mcast[i].is_used) {
+			ipv6_maddr_hash_rm(&ipv6->mcast[i]);
+		}
+	}
+}
+#else
+static inline void ipv6_addr_hash_add(struct net_if_addr *ifaddr)
+{
+}
+
+static inline void ipv6_addr_hash_rm(struct net_if_addr *ifaddr)
+{
+}
+
+static inline void ipv6_maddr_hash_add(struct net_if_mcast_addr *maddr)
+{
+}
+
+static inline void ipv6_maddr_hash_rm(struct net_if_mcast_addr *maddr)
+{
+}
+
+static inline void ipv6_hash_flush(struct net_if_ipv6 *ipv6)
+{
+}
+#endif /* CONFIG_NET_IF_IPV6_ADDR_HASH */
+
 int net_if_config_ipv6_get(struct net_if *iface, struct net_if_ipv6 **ipv6)
 {
 	int i;
@@ -439,6 +617,8 @@ int net_if_config_ipv6_put(struct net_if *iface)
 			continue;
 		}
 
+		ipv6_hash_flush(iface->config.ip.ipv6);
+
 		iface->config.ip.ipv6 = NULL;
 		ipv6_addresses[i].iface = NULL;
 
@@ -536,13 +716,23 @@ static void dad_timeout(struct k_work *work)
 static void net_if_ipv6_start_dad(struct net_if *iface,
 				  struct net_if_addr *ifaddr)
 {
-	ifaddr->addr_state = NET_ADDR_TENTATIVE;
+	/* RFC 4429 3.1 Manually configured addresses should not be
+	 * optimistic.
+	 */
+	if (IS_ENABLED(CONFIG_NET_IPV6_OPTIMISTIC_DAD) &&
+	    ifaddr->addr_type == NET_ADDR_AUTOCONF) {
+		ifaddr->addr_state = NET_ADDR_OPTIMISTIC;
+	} else {
+		ifaddr->addr_state = NET_ADDR_TENTATIVE;
+	}
 
 	if (net_if_is_up(iface)) {
-		NET_DBG("Interface %p ll addr %s tentative IPv6 addr %s",
+		NET_DBG("Interface %p ll addr %s %s IPv6 addr %s",
 			iface,
 			net_sprint_ll_addr(net_if_get_link_addr(iface)->addr,
 					   net_if_get_link_addr(iface)->len),
+			ifaddr->addr_state == NET_ADDR_OPTIMISTIC ?
+			"optimistic" : "tentative",
 			net_sprint_ipv6_addr(&ifaddr->address.in6_addr));
 
 		ifaddr->dad_count = 1;
@@ -671,6 +861,9 @@ void net_if_start_rs(struct net_if *iface)
 struct net_if_addr *net_if_ipv6_addr_lookup(const struct in6_addr *addr,
 					    struct net_if **ret)
 {
+#if defined(CONFIG_NET_IF_IPV6_ADDR_HASH)
+	return ipv6_addr_hash_lookup(addr, ret);
+#else
 	struct net_if *iface;
 
 	for (iface = __net_if_start; iface != __net_if_end; iface++) {
@@ -702,6 +895,7 @@ struct net_if_addr *net_if_ipv6_addr_lookup(const struct in6_addr *addr,
 	}
 
 	return NULL;
+#endif /* CONFIG_NET_IF_IPV6_ADDR_HASH */
 }
 
 static void ipv6_addr_expired(struct k_work *work)
@@ -789,7 +983,8 @@ static inline struct in6_addr *check_global_addr(struct net_if *iface)
 	for (i = 0; i < NET_IF_MAX_IPV6_ADDR; i++) {
 		if (!ipv6->unicast[i].is_used ||
 		    (ipv6->unicast[i].addr_state != NET_ADDR_TENTATIVE &&
-		     ipv6->unicast[i].addr_state != NET_ADDR_PREFERRED) ||
+		     ipv6->unicast[i].addr_state != NET_ADDR_PREFERRED &&
+		     ipv6->unicast[i].addr_state != NET_ADDR_OPTIMISTIC) ||
 		    ipv6->unicast[i].address.family != AF_INET6) {
 			continue;
 		}
@@ -830,6 +1025,7 @@ struct net_if_addr *net_if_ipv6_addr_add(struct net_if *iface,
 
 		net_if_addr_init(&ipv6->unicast[i], addr, addr_type,
 				 vlifetime);
+		ipv6_addr_hash_add(&ipv6->unicast[i]);
 
 		NET_DBG("[%d] interface %p address %s type %s added", i,
 			iface, net_sprint_ipv6_addr(addr),
@@ -892,6 +1088,7 @@ bool net_if_ipv6_addr_rm(struct net_if *iface, const struct in6_addr *addr)
 			k_delayed_work_cancel(&ipv6->unicast[i].lifetime);
 		}
 
+		ipv6_addr_hash_rm(&ipv6->unicast[i]);
 		ipv6->unicast[i].is_used = false;
 
 		net_ipv6_addr_create_solicited_node(addr, &maddr);
@@ -934,6 +1131,7 @@ struct net_if_mcast_addr *net_if_ipv6_maddr_add(struct net_if *iface,
 		ipv6->mcast[i].is_used = true;
 		ipv6->mcast[i].address.family = AF_INET6;
 		memcpy(&ipv6->mcast[i].address.in6_addr, addr, 16);
+		ipv6_maddr_hash_add(&ipv6->mcast[i]);
 
 		NET_DBG("[%d] interface %p address %s added", i, iface,
 			net_sprint_ipv6_addr(addr));
@@ -965,6 +1163,7 @@ bool net_if_ipv6_maddr_rm(struct net_if *iface, const struct in6_addr *addr)
 			continue;
 		}
 
+		ipv6_maddr_hash_rm(&ipv6->mcast[i]);
 		ipv6->mcast[i].is_used = false;
 
 		NET_DBG("[%d] interface %p address %s removed",
@@ -981,6 +1180,9 @@ bool net_if_ipv6_maddr_rm(struct net_if *iface, const struct in6_addr *addr)
 struct net_if_mcast_addr *net_if_ipv6_maddr_lookup(const struct in6_addr *maddr,
 						   struct net_if **ret)
 {
+#if defined(CONFIG_NET_IF_IPV6_ADDR_HASH)
+	return ipv6_maddr_hash_lookup(maddr, ret);
+#else
 	struct net_if *iface;
 
 	for (iface = __net_if_start; iface != __net_if_end; iface++) {
@@ -1015,6 +1217,7 @@ struct net_if_mcast_addr *net_if_ipv6_maddr_lookup(const struct in6_addr *maddr,
 	}
 
 	return NULL;
+#endif /* CONFIG_NET_IF_IPV6_ADDR_HASH */
 }
 
 void net_if_mcast_mon_register(struct net_if_mcast_monitor *mon,
@@ -1490,9 +1693,10 @@ static u8_t get_diff_ipv6(const struct in6_addr *src,
 	return get_ipaddr_diff((const u8_t *)src, (const u8_t *)dst, 16);
 }
 
-static inline bool is_proper_ipv6_address(struct net_if_addr *addr)
+static inline bool is_proper_ipv6_address(struct net_if_addr *addr,
+					  enum net_addr_state addr_state)
 {
-	if (addr->is_used && addr->addr_state == NET_ADDR_PREFERRED &&
+	if (addr->is_used && addr->addr_state == addr_state &&
 	    addr->address.family == AF_INET6 &&
 	    !net_is_ipv6_ll_addr(&addr->address.in6_addr)) {
 		return true;
@@ -1501,9 +1705,11 @@ static inline bool is_proper_ipv6_address(struct net_if_addr *addr)
 	return false;
 }
 
-static inline struct in6_addr *net_if_ipv6_get_best_match(struct net_if *iface,
-							  struct in6_addr *dst,
-							  u8_t *best_so_far)
+static inline
+struct in6_addr *net_if_ipv6_get_best_match(struct net_if *iface,
+					    struct in6_addr *dst,
+					    u8_t *best_so_far,
+					    enum net_addr_state addr_state)
 {
 	struct net_if_ipv6 *ipv6 = iface->config.ip.ipv6;
 	struct in6_addr *src = NULL;
@@ -1515,7 +1721,7 @@ static inline struct in6_addr *net_if_ipv6_get_best_match(struct net_if *iface,
 	}
 
 	for (i = 0; i < NET_IF_MAX_IPV6_ADDR; i++) {
-		if (!is_proper_ipv6_address(&ipv6->unicast[i])) {
+		if (!is_proper_ipv6_address(&ipv6->unicast[i], addr_state)) {
 			continue;
 		}
 
@@ -1529,8 +1735,9 @@ static inline struct in6_addr *net_if_ipv6_get_best_match(struct net_if *iface,
 	return src;
 }
 
-const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
-						   struct in6_addr *dst)
+static struct in6_addr *select_src_addr(struct net_if *dst_iface,
+					struct in6_addr *dst,
+					enum net_addr_state addr_state)
 {
 	struct in6_addr *src = NULL;
 	u8_t best_match = 0;
@@ -1544,7 +1751,8 @@ const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
 			struct in6_addr *addr;
 
 			addr = net_if_ipv6_get_best_match(iface, dst,
-							  &best_match);
+							  &best_match,
+							  addr_state);
 			if (addr) {
 				src = addr;
 			}
@@ -1553,7 +1761,8 @@ const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
 		/* If caller has supplied interface, then use that */
 		if (dst_iface) {
 			src = net_if_ipv6_get_best_match(dst_iface, dst,
-							 &best_match);
+							 &best_match,
+							 addr_state);
 		}
 
 	} else {
@@ -1562,7 +1771,7 @@ const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
 		     iface++) {
 			struct in6_addr *addr;
 
-			addr = net_if_ipv6_get_ll(iface, NET_ADDR_PREFERRED);
+			addr = net_if_ipv6_get_ll(iface, addr_state);
 			if (addr) {
 				src = addr;
 				break;
@@ -1570,10 +1779,27 @@ const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
 		}
 
 		if (dst_iface) {
-			src = net_if_ipv6_get_ll(dst_iface, NET_ADDR_PREFERRED);
+			src = net_if_ipv6_get_ll(dst_iface, addr_state);
 		}
 	}
 
+	return src;
+}
+
+const struct in6_addr *net_if_ipv6_select_src_addr(struct net_if *dst_iface,
+						   struct in6_addr *dst)
+{
+	struct in6_addr *src;
+
+	src = select_src_addr(dst_iface, dst, NET_ADDR_PREFERRED);
+
+	/* RFC 4429 3.3 An optimistic address is only used when there is
+	 * no preferred one.
+	 */
+	if (!src && IS_ENABLED(CONFIG_NET_IPV6_OPTIMISTIC_DAD)) {
+		src = select_src_addr(dst_iface, dst, NET_ADDR_OPTIMISTIC);
+	}
+
 	if (!src) {
 		return net_ipv6_unspecified_address();
 	}
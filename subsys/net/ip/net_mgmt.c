@@ -36,17 +36,82 @@ struct mgmt_event_wait {
 
 static K_SEM_DEFINE(network_event, 0, UINT_MAX);
 static K_SEM_DEFINE(net_mgmt_lock, 1, 1);
+static K_SEM_DEFINE(net_mgmt_direct_lock, 1, 1);
 
 NET_STACK_DEFINE(MGMT, mgmt_stack, CONFIG_NET_MGMT_EVENT_STACK_SIZE,
 		 CONFIG_NET_MGMT_EVENT_STACK_SIZE);
 static struct k_thread mgmt_thread_data;
 static struct mgmt_event_entry events[CONFIG_NET_MGMT_EVENT_QUEUE_SIZE];
-static u32_t global_event_mask;
-static sys_slist_t event_callbacks;
+static sys_slist_t event_callbacks[CONFIG_NET_MGMT_EVENT_HASH_SIZE];
+static sys_slist_t direct_callbacks;
 static s16_t in_event;
 static s16_t out_event;
 
-static inline void mgmt_push_event(u32_t mgmt_event, struct net_if *iface,
+static inline sys_slist_t *mgmt_event_callbacks(u32_t mgmt_event)
+{
+	u32_t key = (NET_MGMT_GET_LAYER(mgmt_event) << 11) |
+		NET_MGMT_GET_LAYER_CODE(mgmt_event);
+
+	return &event_callbacks[key % CONFIG_NET_MGMT_EVENT_HASH_SIZE];
+}
+
+static inline bool mgmt_cb_match(struct net_mgmt_event_callback *cb,
+				 u32_t mgmt_event)
+{
+	if (NET_MGMT_GET_LAYER(mgmt_event) !=
+	    NET_MGMT_GET_LAYER(cb->event_mask) ||
+	    NET_MGMT_GET_LAYER_CODE(mgmt_event) !=
+	    NET_MGMT_GET_LAYER_CODE(cb->event_mask)) {
+		return false;
+	}
+
+	return !NET_MGMT_GET_COMMAND(mgmt_event) ||
+		!NET_MGMT_GET_COMMAND(cb->event_mask) ||
+		(NET_MGMT_GET_COMMAND(mgmt_event) &
+		 NET_MGMT_GET_COMMAND(cb->event_mask));
+}
+
+#if defined(CONFIG_NET_MGMT_EVENT_COALESCE)
+/* Is the very same event already waiting in the queue? */
+static bool mgmt_is_event_queued(u32_t mgmt_event, struct net_if *iface,
+				 void *info, size_t length)
+{
+	s16_t idx = out_event;
+
+	if (out_event < 0) {
+		return false;
+	}
+
+	while (1) {
+		struct mgmt_event_entry *entry = &events[idx];
+
+		if (entry->event == mgmt_event && entry->iface == iface) {
+#ifdef CONFIG_NET_MGMT_EVENT_INFO
+			if (entry->info_length == (info ? length : 0) &&
+			    (!entry->info_length ||
+			     !memcmp(entry->info, info, length))) {
+				return true;
+			}
+#else
+			return true;
+#endif /* CONFIG_NET_MGMT_EVENT_INFO */
+		}
+
+		if (idx == in_event) {
+			return false;
+		}
+
+		if (++idx == CONFIG_NET_MGMT_EVENT_QUEUE_SIZE) {
+			idx = 0;
+		}
+	}
+}
+#else
+#define mgmt_is_event_queued(...) false
+#endif /* CONFIG_NET_MGMT_EVENT_COALESCE */
+
+/* Called with net_mgmt_lock held, return true if the event was queued */
+static inline bool mgmt_push_event(u32_t mgmt_event, struct net_if *iface,
 				   void *info, size_t length)
 {
 	s16_t i_idx;
@@ -56,7 +121,10 @@ static inline void mgmt_push_event(u32_t mgmt_event, struct net_if *iface,
 	ARG_UNUSED(length);
 #endif /* CONFIG_NET_MGMT_EVENT_INFO */
 
-	k_sem_take(&net_mgmt_lock, K_FOREVER);
+	if (mgmt_is_event_queued(mgmt_event, iface, info, length)) {
+		NET_DBG("Event 0x%08x already queued", mgmt_event);
+		return false;
+	}
 
 	i_idx = in_event + 1;
 	if (i_idx == CONFIG_NET_MGMT_EVENT_QUEUE_SIZE) {
@@ -71,9 +139,8 @@ static inline void mgmt_push_event(u32_t mgmt_event, struct net_if *iface,
 		} else {
 			NET_ERR("Event info length %u > max size %u",
 				length, NET_EVENT_INFO_MAX_SIZE);
-			k_sem_give(&net_mgmt_lock);
 
-			return;
+			return false;
 		}
 	} else {
 		events[i_idx].info_length = 0;
@@ -99,7 +166,7 @@ static inline void mgmt_push_event(u32_t mgmt_event, struct net_if *iface,
 
 	in_event = i_idx;
 
-	k_sem_give(&net_mgmt_lock);
+	return true;
 }
 
 static inline struct mgmt_event_entry *mgmt_pop_event(void)
@@ -129,37 +196,57 @@ static inline void mgmt_clean_event(struct mgmt_event_entry *mgmt_event)
 	mgmt_event->iface = NULL;
 }
 
-static inline void mgmt_add_event_mask(u32_t event_mask)
+static inline bool mgmt_is_event_handled(u32_t mgmt_event)
 {
-	global_event_mask |= event_mask;
+	struct net_mgmt_event_callback *cb;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(mgmt_event_callbacks(mgmt_event),
+				     cb, node) {
+		if (mgmt_cb_match(cb, mgmt_event)) {
+			return true;
+		}
+	}
+
+	return false;
 }
 
-static inline void mgmt_rebuild_global_event_mask(void)
+static inline void mgmt_run_direct_callbacks(u32_t mgmt_event,
+					     struct net_if *iface,
+					     void *info, size_t length)
 {
-	struct net_mgmt_event_callback *cb, *tmp;
+	struct net_mgmt_event_callback *cb;
+
+#ifndef CONFIG_NET_MGMT_EVENT_INFO
+	ARG_UNUSED(info);
+	ARG_UNUSED(length);
+#endif /* CONFIG_NET_MGMT_EVENT_INFO */
+
+	if (sys_slist_is_empty(&direct_callbacks)) {
+		return;
+	}
 
-	global_event_mask = 0;
+	k_sem_take(&net_mgmt_direct_lock, K_FOREVER);
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&event_callbacks, cb, tmp, node) {
-		mgmt_add_event_mask(cb->event_mask);
+	SYS_SLIST_FOR_EACH_CONTAINER(&direct_callbacks, cb, node) {
+		if (!mgmt_cb_match(cb, mgmt_event)) {
+			continue;
+		}
+
+#ifdef CONFIG_NET_MGMT_EVENT_INFO
+		cb->info = length ? info : NULL;
+#endif /* CONFIG_NET_MGMT_EVENT_INFO */
+
+		NET_DBG("Running direct callback %p : %p", cb, cb->handler);
+
+		cb->handler(cb, mgmt_event, iface);
 	}
-}
 
-static inline bool mgmt_is_event_handled(u32_t mgmt_event)
-{
-	return (((NET_MGMT_GET_LAYER(mgmt_event) &
-		  NET_MGMT_GET_LAYER(global_event_mask)) ==
-		 NET_MGMT_GET_LAYER(mgmt_event)) &&
-		((NET_MGMT_GET_LAYER_CODE(mgmt_event) &
-		  NET_MGMT_GET_LAYER_CODE(global_event_mask)) ==
-		 NET_MGMT_GET_LAYER_CODE(mgmt_event)) &&
-		((NET_MGMT_GET_COMMAND(mgmt_event) &
-		  NET_MGMT_GET_COMMAND(global_event_mask)) ==
-		 NET_MGMT_GET_COMMAND(mgmt_event)));
+	k_sem_give(&net_mgmt_direct_lock);
 }
 
 static inline void mgmt_run_callbacks(struct mgmt_event_entry *mgmt_event)
 {
+	sys_slist_t *callbacks = mgmt_event_callbacks(mgmt_event->event);
 	sys_snode_t *prev = NULL;
 	struct net_mgmt_event_callback *cb, *tmp;
 
@@ -168,15 +255,9 @@ static inline void mgmt_run_callbacks(struct mgmt_event_entry *mgmt_event)
 		NET_MGMT_GET_LAYER_CODE(mgmt_event->event),
 		NET_MGMT_GET_COMMAND(mgmt_event->event));
 
-	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&event_callbacks, cb, tmp, node) {
-		if (!(NET_MGMT_GET_LAYER(mgmt_event->event) ==
-		      NET_MGMT_GET_LAYER(cb->event_mask)) ||
-		    !(NET_MGMT_GET_LAYER_CODE(mgmt_event->event) ==
-		      NET_MGMT_GET_LAYER_CODE(cb->event_mask)) ||
-		    (NET_MGMT_GET_COMMAND(mgmt_event->event) &&
-		     NET_MGMT_GET_COMMAND(cb->event_mask) &&
-		     !(NET_MGMT_GET_COMMAND(mgmt_event->event) &
-		       NET_MGMT_GET_COMMAND(cb->event_mask)))) {
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(callbacks, cb, tmp, node) {
+		if (!mgmt_cb_match(cb, mgmt_event->event)) {
+			prev = &cb->node;
 			continue;
 		}
 
@@ -195,6 +276,7 @@ static inline void mgmt_run_callbacks(struct mgmt_event_entry *mgmt_event)
 
 			if (sync_data->iface &&
 			    sync_data->iface != mgmt_event->iface) {
+				prev = &cb->node;
 				continue;
 			}
 
@@ -203,7 +285,7 @@ static inline void mgmt_run_callbacks(struct mgmt_event_entry *mgmt_event)
 			cb->raised_event = mgmt_event->event;
 			sync_data->iface = mgmt_event->iface;
 
-			sys_slist_remove(&event_callbacks, prev, &cb->node);
+			sys_slist_remove(callbacks, prev, &cb->node);
 
 			k_sem_give(cb->sync_call);
 		} else {
@@ -283,6 +365,8 @@ static int mgmt_event_wait_call(struct net_if *iface,
 
 	ret = k_sem_take(sync.sync_call, timeout);
 	if (ret == -EAGAIN) {
+		/* Not unlocked by any event, so still in the list */
+		net_mgmt_del_event_callback(&sync);
 		ret = -ETIMEDOUT;
 	} else {
 		if (!ret) {
@@ -311,36 +395,61 @@ void net_mgmt_add_event_callback(struct net_mgmt_event_callback *cb)
 
 	k_sem_take(&net_mgmt_lock, K_FOREVER);
 
-	sys_slist_prepend(&event_callbacks, &cb->node);
-
-	mgmt_add_event_mask(cb->event_mask);
+	sys_slist_prepend(mgmt_event_callbacks(cb->event_mask), &cb->node);
 
 	k_sem_give(&net_mgmt_lock);
 }
 
+void net_mgmt_add_direct_event_callback(struct net_mgmt_event_callback *cb)
+{
+	NET_DBG("Adding direct event callback %p", cb);
+
+	k_sem_take(&net_mgmt_direct_lock, K_FOREVER);
+
+	sys_slist_prepend(&direct_callbacks, &cb->node);
+
+	k_sem_give(&net_mgmt_direct_lock);
+}
+
 void net_mgmt_del_event_callback(struct net_mgmt_event_callback *cb)
 {
 	NET_DBG("Deleting event callback %p", cb);
 
 	k_sem_take(&net_mgmt_lock, K_FOREVER);
 
-	sys_slist_find_and_remove(&event_callbacks, &cb->node);
-
-	mgmt_rebuild_global_event_mask();
+	sys_slist_find_and_remove(mgmt_event_callbacks(cb->event_mask),
+				  &cb->node);
 
 	k_sem_give(&net_mgmt_lock);
+
+	k_sem_take(&net_mgmt_direct_lock, K_FOREVER);
+
+	sys_slist_find_and_remove(&direct_callbacks, &cb->node);
+
+	k_sem_give(&net_mgmt_direct_lock);
 }
 
 void net_mgmt_event_notify_with_info(u32_t mgmt_event, struct net_if *iface,
 				     void *info, size_t length)
 {
+	bool queued = false;
+
+	mgmt_run_direct_callbacks(mgmt_event, iface, info, length);
+
+	k_sem_take(&net_mgmt_lock, K_FOREVER);
+
 	if (mgmt_is_event_handled(mgmt_event)) {
 		NET_DBG("Notifying Event layer %u code %u type %u",
 			NET_MGMT_GET_LAYER(mgmt_event),
 			NET_MGMT_GET_LAYER_CODE(mgmt_event),
 			NET_MGMT_GET_COMMAND(mgmt_event));
 
-		mgmt_push_event(mgmt_event, iface, info, length);
+		queued = mgmt_push_event(mgmt_event, iface, info, length);
+	}
+
+	k_sem_give(&net_mgmt_lock);
+
+	if (queued) {
 		k_sem_give(&network_event);
 	}
 }
@@ -370,8 +479,13 @@ int net_mgmt_event_wait_on_iface(struct net_if *iface,
 
 void net_mgmt_event_init(void)
 {
-	sys_slist_init(&event_callbacks);
-	global_event_mask = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(event_callbacks); i++) {
+		sys_slist_init(&event_callbacks[i]);
+	}
+
+	sys_slist_init(&direct_callbacks);
 
 	in_event = -1;
 	out_event = -1;
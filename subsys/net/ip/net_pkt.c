@@ -84,9 +84,292 @@
 NET_PKT_SLAB_DEFINE(rx_pkts, CONFIG_NET_PKT_RX_COUNT);
 NET_PKT_SLAB_DEFINE(tx_pkts, CONFIG_NET_PKT_TX_COUNT);
 
+#if defined(CONFIG_NET_BUF_SHARED_DATA)
+/* The RX and TX data fragments take their data from one shared slab.
+ * Each direction is guaranteed its reserve of blocks, and can borrow
+ * the blocks nobody else has reserved up to the size of its pool.
+ */
+#if CONFIG_NET_BUF_RX_RESERVE + CONFIG_NET_BUF_TX_RESERVE > \
+	CONFIG_NET_BUF_SHARED_COUNT
+#error "Network buffer reserves larger than the shared data area"
+#endif
+
+struct shared_data_class {
+	/* First, net_buf_alloc() reads the data size from it */
+	struct net_buf_pool_fixed fixed;
+	u16_t reserve;
+	u16_t used;
+};
+
+enum {
+	SHARED_DATA_RX,
+	SHARED_DATA_TX,
+	SHARED_DATA_CLASSES,
+};
+
+K_MEM_SLAB_DEFINE(shared_data_slab, ROUND_UP(CONFIG_NET_BUF_DATA_SIZE, 4),
+		  CONFIG_NET_BUF_SHARED_COUNT, 4);
+
+static K_SEM_DEFINE(shared_data_freed, 0, 1);
+
+static struct shared_data_class shared_data[SHARED_DATA_CLASSES] = {
+	[SHARED_DATA_RX] = {
+		.fixed.data_size = CONFIG_NET_BUF_DATA_SIZE,
+		.reserve = CONFIG_NET_BUF_RX_RESERVE,
+	},
+	[SHARED_DATA_TX] = {
+		.fixed.data_size = CONFIG_NET_BUF_DATA_SIZE,
+		.reserve = CONFIG_NET_BUF_TX_RESERVE,
+	},
+};
+
+/* Called with interrupts locked */
+static bool shared_data_admit(struct shared_data_class *cls)
+{
+	u32_t reserved = 0;
+	int i;
+
+	/* There is always a free block left for a class below its
+	 * reserve, as no class takes the blocks others have reserved.
+	 */
+	if (cls->used < cls->reserve) {
+		return true;
+	}
+
+	for (i = 0; i < SHARED_DATA_CLASSES; i++) {
+		if (shared_data[i].used < shared_data[i].reserve) {
+			reserved += shared_data[i].reserve -
+				    shared_data[i].used;
+		}
+	}
+
+	return k_mem_slab_num_free_get(&shared_data_slab) > reserved;
+}
+
+static u8_t *shared_data_alloc(struct net_buf *buf, size_t *size,
+			       s32_t timeout)
+{
+	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
+	struct shared_data_class *cls = pool->alloc->alloc_data;
+	unsigned int key;
+	void *data;
+	u32_t start;
+
+	*size = min(cls->fixed.data_size, *size);
+
+	key = irq_lock();
+
+	/* Several waiters share the wake up of a single free, the others
+	 * try again on the next one.
+	 */
+	while (!shared_data_admit(cls)) {
+		irq_unlock(key);
+
+		if (timeout == K_NO_WAIT) {
+			return NULL;
+		}
+
+		start = k_uptime_get_32();
+
+		if (k_sem_take(&shared_data_freed, timeout)) {
+			return NULL;
+		}
+
+		if (timeout != K_FOREVER) {
+			timeout -= min(timeout, k_uptime_get_32() - start);
+		}
+
+		key = irq_lock();
+	}
+
+	k_mem_slab_alloc(&shared_data_slab, &data, K_NO_WAIT);
+	cls->used++;
+
+	irq_unlock(key);
+
+	return data;
+}
+
+static void shared_data_unref(struct net_buf *buf, u8_t *data)
+{
+	struct net_buf_pool *pool = net_buf_pool_get(buf->pool_id);
+	struct shared_data_class *cls = pool->alloc->alloc_data;
+	unsigned int key;
+
+	key = irq_lock();
+	k_mem_slab_free(&shared_data_slab, (void **)&data);
+	cls->used--;
+	irq_unlock(key);
+
+	k_sem_give(&shared_data_freed);
+}
+
+static const struct net_buf_data_cb shared_data_cb = {
+	.alloc = shared_data_alloc,
+	.unref = shared_data_unref,
+};
+
+#define SHARED_DATA_POOL_DEFINE(name, count, class)			\
+	static struct net_buf _net_buf_##name[count] __noinit;		\
+	static const struct net_buf_data_alloc net_buf_data_alloc_##name = { \
+		.cb = &shared_data_cb,					\
+		.alloc_data = &shared_data[class],			\
+	};								\
+	struct net_buf_pool name __net_buf_align			\
+			__in_section(_net_buf_pool, static, name) =	\
+		NET_BUF_POOL_INITIALIZER(name, &net_buf_data_alloc_##name, \
+					 _net_buf_##name, count, NULL)
+
+/* The pool sizes are the most fragments each direction can hold. */
+SHARED_DATA_POOL_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT, SHARED_DATA_RX);
+SHARED_DATA_POOL_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT, SHARED_DATA_TX);
+#else
 /* The data fragment pool is for storing network data. */
 NET_PKT_DATA_POOL_DEFINE(rx_bufs, CONFIG_NET_BUF_RX_COUNT);
 NET_PKT_DATA_POOL_DEFINE(tx_bufs, CONFIG_NET_BUF_TX_COUNT);
+#endif /* CONFIG_NET_BUF_SHARED_DATA */
+
+#if defined(CONFIG_NET_PKT_LINEAR)
+/* Contiguous data buffers, sized to the frame they hold. */
+NET_PKT_LINEAR_POOL_DEFINE(rx_linear_bufs, CONFIG_NET_PKT_LINEAR_RX_COUNT);
+NET_PKT_LINEAR_POOL_DEFINE(tx_linear_bufs, CONFIG_NET_PKT_LINEAR_TX_COUNT);
+#define LINEAR_BUF_COUNT (CONFIG_NET_PKT_LINEAR_RX_COUNT + \
+			  CONFIG_NET_PKT_LINEAR_TX_COUNT)
+#else
+#define LINEAR_BUF_COUNT 0
+#endif
+
+#if defined(CONFIG_NET_PKT_ALLOC_TRACK)
+/* Low overhead leak tracking: each packet in use is in a hash table
+ * keyed on its index in the slab, and counted against the call site
+ * which allocated it.
+ */
+#define TRACK_SIZE (CONFIG_NET_PKT_RX_COUNT + CONFIG_NET_PKT_TX_COUNT + \
+		    CONFIG_NET_PKT_ALLOC_TRACK_EXTERNALS)
+#define TRACK_SITES CONFIG_NET_PKT_ALLOC_TRACK_SITES
+#define TRACK_SITE __builtin_return_address(0)
+
+struct pkt_track_site {
+	void *addr;
+	u32_t allocs;
+	u16_t live;
+};
+
+struct pkt_track {
+	struct net_pkt *pkt;
+	struct pkt_track_site *site;
+};
+
+static struct pkt_track pkt_tracks[TRACK_SIZE];
+
+/* The last site counts the allocations of the sites which don't fit */
+static struct pkt_track_site pkt_track_sites[TRACK_SITES + 1];
+
+static inline unsigned int pkt_track_hash(struct net_pkt *pkt)
+{
+	/* The packets of a slab are contiguous, this is their index */
+	return ((uintptr_t)pkt / sizeof(struct net_pkt)) % TRACK_SIZE;
+}
+
+static struct pkt_track_site *pkt_track_site_get(void *addr)
+{
+	unsigned int i = ((uintptr_t)addr >> 1) % TRACK_SITES;
+	unsigned int n;
+
+	for (n = 0; n < TRACK_SITES; n++) {
+		if (pkt_track_sites[i].addr == addr) {
+			return &pkt_track_sites[i];
+		}
+
+		if (!pkt_track_sites[i].addr) {
+			pkt_track_sites[i].addr = addr;
+			return &pkt_track_sites[i];
+		}
+
+		i = (i + 1) % TRACK_SITES;
+	}
+
+	return &pkt_track_sites[TRACK_SITES];
+}
+
+static void pkt_track_alloc(struct net_pkt *pkt, void *addr)
+{
+	struct pkt_track_site *site;
+	unsigned int i, n, key;
+
+	key = irq_lock();
+
+	site = pkt_track_site_get(addr);
+	site->allocs++;
+
+	/* A packet which doesn't fit is not counted as in use */
+	i = pkt_track_hash(pkt);
+	for (n = 0; n < TRACK_SIZE; n++) {
+		if (!pkt_tracks[i].pkt) {
+			pkt_tracks[i].pkt = pkt;
+			pkt_tracks[i].site = site;
+			site->live++;
+			break;
+		}
+
+		i = (i + 1) % TRACK_SIZE;
+	}
+
+	irq_unlock(key);
+}
+
+static void pkt_track_free(struct net_pkt *pkt)
+{
+	unsigned int i, j, n, home, key;
+
+	key = irq_lock();
+
+	i = pkt_track_hash(pkt);
+	for (n = 0; pkt_tracks[i].pkt != pkt; n++) {
+		if (!pkt_tracks[i].pkt || n == TRACK_SIZE) {
+			irq_unlock(key);
+			return;
+		}
+
+		i = (i + 1) % TRACK_SIZE;
+	}
+
+	pkt_tracks[i].site->live--;
+
+	/* Move back the following entries which can take the free slot,
+	 * so that lookups never stop early at it.
+	 */
+	for (j = (i + 1) % TRACK_SIZE; pkt_tracks[j].pkt && j != i;
+	     j = (j + 1) % TRACK_SIZE) {
+		home = pkt_track_hash(pkt_tracks[j].pkt);
+
+		if ((i + TRACK_SIZE - home) % TRACK_SIZE <
+		    (j + TRACK_SIZE - home) % TRACK_SIZE) {
+			pkt_tracks[i] = pkt_tracks[j];
+			i = j;
+		}
+	}
+
+	pkt_tracks[i].pkt = NULL;
+
+	irq_unlock(key);
+}
+
+void net_pkt_track_foreach(net_pkt_track_cb_t cb, void *user_data)
+{
+	int i;
+
+	for (i = 0; i <= TRACK_SITES; i++) {
+		if (pkt_track_sites[i].allocs) {
+			cb(pkt_track_sites[i].addr,
+			   pkt_track_sites[i].allocs,
+			   pkt_track_sites[i].live, user_data);
+		}
+	}
+}
+#else
+#define TRACK_SITE NULL
+#endif /* CONFIG_NET_PKT_ALLOC_TRACK */
 
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
 
@@ -116,6 +399,7 @@ struct net_pkt_alloc {
 			    CONFIG_NET_PKT_TX_COUNT + \
 			    CONFIG_NET_BUF_RX_COUNT + \
 			    CONFIG_NET_BUF_TX_COUNT + \
+			    LINEAR_BUF_COUNT + \
 			    CONFIG_NET_DEBUG_NET_PKT_EXTERNALS)
 
 static struct net_pkt_alloc net_pkt_allocs[MAX_NET_PKT_ALLOCS];
@@ -233,6 +517,14 @@ const char *net_pkt_pool2str(struct net_buf_pool *pool)
 		return "TDATA";
 	}
 
+#if defined(CONFIG_NET_PKT_LINEAR)
+	if (pool == &rx_linear_bufs) {
+		return "RLINEAR";
+	} else if (pool == &tx_linear_bufs) {
+		return "TLINEAR";
+	}
+#endif
+
 	return "EDATA";
 }
 
@@ -294,9 +586,9 @@ struct net_pkt *net_pkt_get_reserve_debug(struct k_mem_slab *slab,
 					  const char *caller,
 					  int line)
 #else /* CONFIG_NET_DEBUG_NET_PKT */
-struct net_pkt *net_pkt_get_reserve(struct k_mem_slab *slab,
-				    u16_t reserve_head,
-				    s32_t timeout)
+static struct net_pkt *pkt_get_reserve(struct k_mem_slab *slab,
+				       u16_t reserve_head,
+				       s32_t timeout, void *site)
 #endif /* CONFIG_NET_DEBUG_NET_PKT */
 {
 	struct net_pkt *pkt;
@@ -328,10 +620,22 @@ struct net_pkt *net_pkt_get_reserve(struct k_mem_slab *slab,
 	NET_DBG("%s [%u] pkt %p reserve %u ref %d (%s():%d)",
 		slab2str(slab), k_mem_slab_num_free_get(slab),
 		pkt, reserve_head, pkt->ref, caller, line);
+#endif
+#if defined(CONFIG_NET_PKT_ALLOC_TRACK)
+	pkt_track_alloc(pkt, site);
 #endif
 	return pkt;
 }
 
+#if !defined(CONFIG_NET_DEBUG_NET_PKT)
+struct net_pkt *net_pkt_get_reserve(struct k_mem_slab *slab,
+				    u16_t reserve_head,
+				    s32_t timeout)
+{
+	return pkt_get_reserve(slab, reserve_head, timeout, TRACK_SITE);
+}
+#endif
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
 struct net_buf *net_pkt_get_reserve_data_debug(struct net_buf_pool *pool,
 					       u16_t reserve_head,
@@ -424,6 +728,46 @@ struct net_buf *net_pkt_get_frag(struct net_pkt *pkt,
 #endif
 }
 
+#if defined(CONFIG_NET_PKT_LINEAR)
+#if defined(CONFIG_NET_DEBUG_NET_PKT)
+struct net_buf *net_pkt_get_frag_linear_debug(struct net_pkt *pkt,
+					      size_t len, s32_t timeout,
+					      const char *caller, int line)
+#else
+struct net_buf *net_pkt_get_frag_linear(struct net_pkt *pkt, size_t len,
+					s32_t timeout)
+#endif
+{
+	struct net_buf_pool *pool;
+	struct net_buf *frag;
+
+	pool = pkt->slab == &rx_pkts ? &rx_linear_bufs : &tx_linear_bufs;
+
+	if (k_is_in_isr()) {
+		timeout = K_NO_WAIT;
+	}
+
+	frag = net_buf_alloc_len(pool, net_pkt_ll_reserve(pkt) + len, timeout);
+	if (!frag) {
+		return NULL;
+	}
+
+	net_buf_reserve(frag, net_pkt_ll_reserve(pkt));
+
+#if defined(CONFIG_NET_DEBUG_NET_PKT)
+	NET_FRAG_CHECK_IF_NOT_IN_USE(frag, frag->ref + 1);
+
+	net_pkt_alloc_add(frag, false, caller, line);
+
+	NET_DBG("%s (%s) [%d] frag %p len %zu ref %d (%s():%d)",
+		pool2str(pool), pool->name, get_frees(pool),
+		frag, len, frag->ref, caller, line);
+#endif
+
+	return frag;
+}
+#endif /* CONFIG_NET_PKT_LINEAR */
+
 #if defined(CONFIG_NET_DEBUG_NET_PKT)
 struct net_pkt *net_pkt_get_reserve_rx_debug(u16_t reserve_head,
 					     s32_t timeout,
@@ -462,13 +806,13 @@ struct net_buf *net_pkt_get_reserve_tx_data_debug(u16_t reserve_head,
 struct net_pkt *net_pkt_get_reserve_rx(u16_t reserve_head,
 				       s32_t timeout)
 {
-	return net_pkt_get_reserve(&rx_pkts, reserve_head, timeout);
+	return pkt_get_reserve(&rx_pkts, reserve_head, timeout, TRACK_SITE);
 }
 
 struct net_pkt *net_pkt_get_reserve_tx(u16_t reserve_head,
 				       s32_t timeout)
 {
-	return net_pkt_get_reserve(&tx_pkts, reserve_head, timeout);
+	return pkt_get_reserve(&tx_pkts, reserve_head, timeout, TRACK_SITE);
 }
 
 struct net_buf *net_pkt_get_reserve_rx_data(u16_t reserve_head,
@@ -494,7 +838,7 @@ static struct net_pkt *net_pkt_get_debug(struct k_mem_slab *slab,
 #else
 static struct net_pkt *net_pkt_get(struct k_mem_slab *slab,
 				   struct net_context *context,
-				   s32_t timeout)
+				   s32_t timeout, void *site)
 #endif /* CONFIG_NET_DEBUG_NET_PKT */
 {
 	struct in6_addr *addr6 = NULL;
@@ -521,8 +865,8 @@ static struct net_pkt *net_pkt_get(struct k_mem_slab *slab,
 					net_if_get_ll_reserve(iface, addr6),
 					timeout, caller, line);
 #else
-	pkt = net_pkt_get_reserve(slab, net_if_get_ll_reserve(iface, addr6),
-				  timeout);
+	pkt = pkt_get_reserve(slab, net_if_get_ll_reserve(iface, addr6),
+			      timeout, site);
 #endif
 	if (!pkt) {
 		return NULL;
@@ -565,6 +909,13 @@ static struct net_pkt *net_pkt_get(struct k_mem_slab *slab,
 		if (IS_ENABLED(CONFIG_NET_TCP) && proto == IPPROTO_TCP) {
 			data_len -= NET_TCPH_LEN;
 			data_len -= NET_TCP_MAX_OPT_SIZE;
+
+#if defined(CONFIG_NET_TCP_TSO)
+			if (net_tcp_tso_enabled(iface)) {
+				data_len = max(data_len,
+					       CONFIG_NET_TCP_TSO_MAX_SIZE);
+			}
+#endif
 		}
 
 		if (IS_ENABLED(CONFIG_NET_UDP) && proto == IPPROTO_UDP) {
@@ -685,7 +1036,7 @@ struct net_pkt *net_pkt_get_rx(struct net_context *context, s32_t timeout)
 {
 	NET_ASSERT_INFO(context, "RX context not set");
 
-	return net_pkt_get(&rx_pkts, context, timeout);
+	return net_pkt_get(&rx_pkts, context, timeout, TRACK_SITE);
 }
 
 struct net_pkt *net_pkt_get_tx(struct net_context *context, s32_t timeout)
@@ -696,7 +1047,8 @@ struct net_pkt *net_pkt_get_tx(struct net_context *context, s32_t timeout)
 
 	slab = get_tx_slab(context);
 
-	return net_pkt_get(slab ? slab : &tx_pkts, context, timeout);
+	return net_pkt_get(slab ? slab : &tx_pkts, context, timeout,
+			   TRACK_SITE);
 }
 
 struct net_buf *net_pkt_get_data(struct net_context *context, s32_t timeout)
@@ -794,6 +1146,10 @@ done:
 		return;
 	}
 
+#if defined(CONFIG_NET_PKT_ALLOC_TRACK)
+	pkt_track_free(pkt);
+#endif
+
 	if (pkt->frags) {
 		net_pkt_frag_unref(pkt->frags);
 	}
@@ -1246,7 +1602,11 @@ u16_t net_pkt_append(struct net_pkt *pkt, u16_t len, const u8_t *data,
 		max_len = pkt->data_len;
 
 #if defined(CONFIG_NET_TCP)
-		if (ctx->tcp && (ctx->tcp->send_mss < max_len)) {
+		/* With segmentation offload the data is split into
+		 * segments when sent.
+		 */
+		if (ctx->tcp && (ctx->tcp->send_mss < max_len) &&
+		    !net_tcp_tso_enabled(net_pkt_iface(pkt))) {
 			max_len = ctx->tcp->send_mss;
 		}
 #endif
@@ -1323,6 +1683,24 @@ struct net_buf *net_frag_read(struct net_buf *frag, u16_t offset,
 		goto error;
 	}
 
+	/* Fast path: data does not cross the fragment boundary, which is
+	 * always the case for linear packets.
+	 */
+	if (*pos + len <= frag->len) {
+		if (data) {
+			memcpy(data, frag->data + *pos, len);
+		}
+
+		*pos += len;
+		if (*pos >= frag->len) {
+			*pos = 0;
+
+			return frag->frags;
+		}
+
+		return frag;
+	}
+
 	while (len-- > 0 && frag) {
 		if (data) {
 			frag = net_frag_read_byte(frag, *pos,
@@ -1372,6 +1750,104 @@ struct net_buf *net_frag_read_be32(struct net_buf *frag, u16_t offset,
 	return ret_frag;
 }
 
+/* Move from frag/pos over len bytes, copying them from or to data if any */
+static int cursor_move(struct net_pkt_cursor *cursor, u8_t *data, u16_t len,
+		       bool write)
+{
+	struct net_buf *frag = cursor->frag;
+	u16_t pos = cursor->pos;
+	u16_t left = len;
+
+	/* check that there is enough data first, so that failures have
+	 * no side effects
+	 */
+	while (frag && left > frag->len - pos) {
+		left -= frag->len - pos;
+		frag = frag->frags;
+		pos = 0;
+	}
+
+	if (!frag && left) {
+		return -ENOBUFS;
+	}
+
+	while (len) {
+		u16_t count = min(len, cursor->frag->len - cursor->pos);
+
+		if (data && write) {
+			memcpy(cursor->frag->data + cursor->pos, data, count);
+		} else if (data) {
+			memcpy(data, cursor->frag->data + cursor->pos, count);
+		}
+
+		if (data) {
+			data += count;
+		}
+		len -= count;
+		cursor->pos += count;
+
+		/* never stop on the end of a fragment or an empty one */
+		while (cursor->frag && cursor->pos == cursor->frag->len) {
+			cursor->frag = cursor->frag->frags;
+			cursor->pos = 0;
+		}
+	}
+
+	return 0;
+}
+
+int net_pkt_cursor_init(struct net_pkt *pkt, struct net_pkt_cursor *cursor,
+			u16_t offset)
+{
+	cursor->frag = pkt->frags;
+	cursor->pos = 0;
+
+	/* skip empty fragments, so that the cursor points to data */
+	while (cursor->frag && !cursor->frag->len) {
+		cursor->frag = cursor->frag->frags;
+	}
+
+	return cursor_move(cursor, NULL, offset, false);
+}
+
+int net_pkt_cursor_read(struct net_pkt_cursor *cursor, void *data,
+			u16_t len)
+{
+	return cursor_move(cursor, data, len, false);
+}
+
+int net_pkt_cursor_read_be16(struct net_pkt_cursor *cursor, u16_t *value)
+{
+	u8_t v16[2];
+	int ret;
+
+	ret = cursor_move(cursor, v16, sizeof(v16), false);
+	if (!ret) {
+		*value = v16[0] << 8 | v16[1];
+	}
+
+	return ret;
+}
+
+int net_pkt_cursor_read_be32(struct net_pkt_cursor *cursor, u32_t *value)
+{
+	u8_t v32[4];
+	int ret;
+
+	ret = cursor_move(cursor, v32, sizeof(v32), false);
+	if (!ret) {
+		*value = v32[0] << 24 | v32[1] << 16 | v32[2] << 8 | v32[3];
+	}
+
+	return ret;
+}
+
+int net_pkt_cursor_write(struct net_pkt_cursor *cursor, const void *data,
+			 u16_t len)
+{
+	return cursor_move(cursor, (u8_t *)data, len, true);
+}
+
 static inline struct net_buf *check_and_create_data(struct net_pkt *pkt,
 						    struct net_buf *data,
 						    s32_t timeout)
@@ -2012,6 +2488,10 @@ struct net_pkt *net_pkt_clone(struct net_pkt *pkt, s32_t timeout)
 	net_pkt_set_next_hdr(clone, NULL);
 	net_pkt_set_ip_hdr_len(clone, net_pkt_ip_hdr_len(pkt));
 	net_pkt_set_vlan_tag(clone, net_pkt_vlan_tag(pkt));
+	net_pkt_set_tso_mss(clone, net_pkt_tso_mss(pkt));
+#if defined(CONFIG_NET_PKT_TIMESTAMP)
+	net_pkt_set_timestamp(clone, net_pkt_timestamp(pkt));
+#endif
 
 	net_pkt_set_family(clone, net_pkt_family(pkt));
 
@@ -50,6 +50,9 @@ extern void net_tc_tx_init(void);
 extern void net_tc_rx_init(void);
 extern void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt);
 extern void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt);
+extern void net_tc_tx_batch_begin(void);
+extern int net_tc_tx_batch_len(void);
+extern void net_tc_tx_batch_end(void);
 
 #if defined(CONFIG_NET_IPV6_FRAGMENT)
 int net_ipv6_send_fragmented_pkt(struct net_if *iface, struct net_pkt *pkt,
@@ -61,6 +64,13 @@ extern char *net_byte_to_hex(char *ptr, u8_t byte, char base, bool pad);
 extern char *net_sprint_ll_addr_buf(const u8_t *ll, u8_t ll_len,
 				    char *buf, int buflen);
 extern u16_t net_calc_chksum(struct net_pkt *pkt, u8_t proto);
+
+/* Update a checksum after a 16 bit word of the data it covers changed
+ * from old_val to new_val (RFC 1624). The three values must be in the
+ * same byte order, e.g. all as found in the packet.
+ */
+extern u16_t net_calc_chksum_update(u16_t chksum, u16_t old_val,
+				    u16_t new_val);
 bool net_header_fits(struct net_pkt *pkt, u8_t *hdr, size_t hdr_size);
 
 struct net_icmp_hdr *net_pkt_icmp_data(struct net_pkt *pkt);
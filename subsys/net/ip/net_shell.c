@@ -97,6 +97,8 @@ static inline const char *addrstate2str(enum net_addr_state addr_state)
 		return "preferred";
 	case NET_ADDR_DEPRECATED:
 		return "deprecated";
+	case NET_ADDR_OPTIMISTIC:
+		return "optimistic";
 	}
 
 	return "<invalid state>";
@@ -517,6 +519,19 @@ static void print_eth_stats(struct net_if *iface, struct net_stats_eth *data)
 	printk("Bcast sent       : %u\n", data->broadcast.tx);
 	printk("Mcast received   : %u\n", data->multicast.rx);
 	printk("Mcast sent       : %u\n", data->multicast.tx);
+
+#if defined(CONFIG_NET_L2_ETHERNET_RX_POLL)
+	if (data->rx_poll.interrupts) {
+		printk("RX poll irqs     : %u\n", data->rx_poll.interrupts);
+		printk("RX poll runs     : %u\n", data->rx_poll.polls);
+		printk("RX poll pkts     : %u\n", data->rx_poll.pkts);
+		printk("RX poll budget   : %u runs exhausted\n",
+		       data->rx_poll.budget_exhausted);
+		printk("Pkts per irq     : %u avg %u max\n",
+		       data->rx_poll.pkts / data->rx_poll.interrupts,
+		       data->rx_poll.max_pkts_per_irq);
+	}
+#endif
 }
 #endif /* CONFIG_NET_STATISTICS_ETHERNET && CONFIG_NET_STATISTICS_USER_API */
 
@@ -609,6 +624,9 @@ static void net_shell_print_statistics(struct net_if *iface, void *user_data)
 	printk("TCP conn drop  %d\tconnrst\t%d\n",
 	       GET_STAT(iface, tcp.conndrop),
 	       GET_STAT(iface, tcp.connrst));
+	printk("TCP fast rexmt %d\ttimeout\t%d\n",
+	       GET_STAT(iface, tcp.fast_rexmit),
+	       GET_STAT(iface, tcp.timeout));
 #endif
 
 #if defined(CONFIG_NET_STATISTICS_RPL)
@@ -833,6 +851,17 @@ static void tcp_cb(struct net_tcp *tcp, void *user_data)
 	       tcp->send_seq, tcp->send_ack, recv_mss,
 	       net_tcp_state_str(net_tcp_get_state(tcp)));
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	{
+		struct net_stats_tcp_cc cc;
+
+		if (!net_stats_tcp_cc_get(tcp->context, &cc)) {
+			printk("    cwnd %u ssthresh %u srtt %u rttvar %u\n",
+			       cc.cwnd, cc.ssthresh, cc.srtt, cc.rttvar);
+		}
+	}
+#endif
+
 	(*count)++;
 }
 
@@ -985,6 +1014,17 @@ buf:
 }
 #endif /* CONFIG_NET_DEBUG_NET_PKT */
 
+#if defined(CONFIG_NET_PKT_ALLOC_TRACK)
+static void track_cb(void *site, u32_t allocs, u16_t live, void *user_data)
+{
+	if (site) {
+		printk("%p\t%u\t%u\n", site, allocs, live);
+	} else {
+		printk("other\t\t%u\t%u\n", allocs, live);
+	}
+}
+#endif /* CONFIG_NET_PKT_ALLOC_TRACK */
+
 /* Put the actual shell commands after this */
 
 int net_shell_cmd_allocs(int argc, char *argv[])
@@ -996,8 +1036,13 @@ int net_shell_cmd_allocs(int argc, char *argv[])
 	printk("Network memory allocations\n\n");
 	printk("memory\t\tStatus\tPool\tFunction alloc -> freed\n");
 	net_pkt_allocs_foreach(allocs_cb, NULL);
+#elif defined(CONFIG_NET_PKT_ALLOC_TRACK)
+	printk("Network packet allocations per call site\n\n");
+	printk("Caller\t\tAllocs\tIn use\n");
+	net_pkt_track_foreach(track_cb, NULL);
 #else
-	printk("Enable CONFIG_NET_DEBUG_NET_PKT to see allocations.\n");
+	printk("Enable CONFIG_NET_DEBUG_NET_PKT or CONFIG_NET_PKT_ALLOC_TRACK "
+	       "to see allocations.\n");
 #endif /* CONFIG_NET_DEBUG_NET_PKT */
 
 	return 0;
@@ -2433,6 +2478,54 @@ static void net_shell_print_statistics_all(void)
 }
 #endif
 
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+static void net_shell_print_latency(void)
+{
+	static const char * const stages[] = {
+		[NET_STATS_LATENCY_RX_QUEUE] = "RX queue",
+		[NET_STATS_LATENCY_RX_IP] = "RX IP",
+		[NET_STATS_LATENCY_RX_L4] = "RX L4",
+		[NET_STATS_LATENCY_RX_SOCKET] = "RX socket",
+		[NET_STATS_LATENCY_TX_STACK] = "TX stack",
+		[NET_STATS_LATENCY_TX_QUEUE] = "TX queue",
+		[NET_STATS_LATENCY_TX_DRIVER] = "TX driver",
+	};
+	struct net_stats_latency lat;
+	unsigned int key;
+	int i, j;
+
+	printk("Stage      Count      Avg (us)   Max (us)\n");
+
+	for (i = 0; i < NET_STATS_LATENCY_STAGES; i++) {
+		key = irq_lock();
+		lat = net_stats_latency[i];
+		irq_unlock(key);
+
+		printk("%-10s %-10u %-10u %u\n", stages[i], lat.count,
+		       lat.count ? (u32_t)(lat.sum / lat.count) : 0,
+		       lat.max);
+
+		if (!lat.count) {
+			continue;
+		}
+
+		printk("          ");
+
+		for (j = 0; j < NET_STATS_LATENCY_BUCKETS - 1; j++) {
+			if (lat.hist[j]) {
+				printk(" <%u:%u", 1 << j, lat.hist[j]);
+			}
+		}
+
+		if (lat.hist[j]) {
+			printk(" >=%u:%u", 1 << (j - 1), lat.hist[j]);
+		}
+
+		printk("\n");
+	}
+}
+#endif /* CONFIG_NET_STATISTICS_LATENCY */
+
 int net_shell_cmd_stats(int argc, char *argv[])
 {
 #if defined(CONFIG_NET_STATISTICS)
@@ -2448,6 +2541,13 @@ int net_shell_cmd_stats(int argc, char *argv[])
 		return 0;
 	}
 
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+	if (strcmp(argv[arg], "latency") == 0) {
+		net_shell_print_latency();
+		return 0;
+	}
+#endif
+
 #if defined(CONFIG_NET_STATISTICS_PER_INTERFACE)
 	if (strcmp(argv[arg], "all") == 0) {
 		/* Print information about all network interfaces */
@@ -2965,7 +3065,8 @@ static struct shell_cmd net_commands[] = {
 		"stats all\n\tShow network statistics for all network "
 						"interfaces\n"
 		"stats <idx>\n\tShow network statistics for one specific "
-						"network interfaces\n" },
+						"network interfaces\n"
+		"stats latency\n\tShow packet latency statistics\n" },
 	{ "tcp", net_shell_cmd_tcp, "connect <ip> port\n\tConnect to TCP peer\n"
 		"tcp send <data>\n\tSend data to peer using TCP\n"
 		"tcp close\n\tClose TCP connection" },
@@ -24,6 +24,62 @@
  */
 struct net_stats net_stats = { 0 };
 
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+struct net_stats_latency net_stats_latency[NET_STATS_LATENCY_STAGES];
+
+void net_stats_update_latency_cycles(enum net_stats_latency_stage stage,
+				     u32_t cycles)
+{
+	struct net_stats_latency *lat = &net_stats_latency[stage];
+	u32_t us = SYS_CLOCK_HW_CYCLES_TO_NS64(cycles) / NSEC_PER_USEC;
+	int bucket = 0;
+	unsigned int key;
+
+	while (us >> bucket && bucket < NET_STATS_LATENCY_BUCKETS - 1) {
+		bucket++;
+	}
+
+	/* stages end in the RX/TX threads as well as in the application
+	 * threads
+	 */
+	key = irq_lock();
+
+	lat->count++;
+	lat->sum += us;
+	lat->hist[bucket]++;
+
+	if (us > lat->max) {
+		lat->max = us;
+	}
+
+	irq_unlock(key);
+}
+
+void net_stats_update_latency(struct net_pkt *pkt,
+			      enum net_stats_latency_stage stage)
+{
+	u32_t now;
+
+	if (!pkt->stage_time) {
+		return;
+	}
+
+	now = k_cycle_get_32();
+
+	net_stats_update_latency_cycles(stage, now - pkt->stage_time);
+
+	/* A packet queued again later on, like a TCP retransmission, must
+	 * not account the time it waited in between.
+	 */
+	if (stage == NET_STATS_LATENCY_RX_SOCKET ||
+	    stage == NET_STATS_LATENCY_TX_QUEUE) {
+		pkt->stage_time = 0;
+	} else {
+		pkt->stage_time = now | 1;
+	}
+}
+#endif /* CONFIG_NET_STATISTICS_LATENCY */
+
 #if defined(CONFIG_NET_STATISTICS_PERIODIC_OUTPUT)
 
 #define PRINT_STATISTICS_INTERVAL K_SECONDS(30)
@@ -251,6 +251,16 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 {
 	UPDATE_STAT(iface, stats.tcp.rexmit++);
 }
+
+static inline void net_stats_update_tcp_seg_fast_rexmit(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tcp.fast_rexmit++);
+}
+
+static inline void net_stats_update_tcp_seg_timeout(struct net_if *iface)
+{
+	UPDATE_STAT(iface, stats.tcp.timeout++);
+}
 #else
 #define net_stats_update_tcp_sent(iface, bytes)
 #define net_stats_update_tcp_resent(iface, bytes)
@@ -265,6 +275,8 @@ static inline void net_stats_update_tcp_seg_rexmit(struct net_if *iface)
 #define net_stats_update_tcp_seg_ackerr(iface)
 #define net_stats_update_tcp_seg_rsterr(iface)
 #define net_stats_update_tcp_seg_rexmit(iface)
+#define net_stats_update_tcp_seg_fast_rexmit(iface)
+#define net_stats_update_tcp_seg_timeout(iface)
 #endif /* CONFIG_NET_STATISTICS_TCP */
 
 static inline void net_stats_update_per_proto_recv(struct net_if *iface,
@@ -451,6 +463,20 @@ static inline void net_stats_update_tc_recv_priority(struct net_if *iface,
 #define net_stats_update_tc_recv_priority(iface, tc, priority)
 #endif /* NET_TC_COUNT > 1 */
 
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+#include <net/net_pkt.h>
+
+/* Start measuring the latency of a packet entering the stack */
+static inline void net_stats_latency_start(struct net_pkt *pkt)
+{
+	pkt->stage_time = k_cycle_get_32() | 1;
+}
+#else
+#define net_stats_latency_start(pkt)
+#define net_stats_update_latency(pkt, stage)
+#define net_stats_update_latency_cycles(stage, cycles)
+#endif /* CONFIG_NET_STATISTICS_LATENCY */
+
 #if defined(CONFIG_NET_STATISTICS_PERIODIC_OUTPUT)
 /* A simple periodic statistic printer, used only in net core */
 void net_print_statistics_all(void);
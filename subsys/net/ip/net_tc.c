@@ -15,9 +15,14 @@
 #include <net/net_core.h>
 #include <net/net_pkt.h>
 #include <net/net_stats.h>
+#include <net/ethernet.h>
 
 #include "net_private.h"
 #include "net_stats.h"
+#include "connection.h"
+
+/* Each Rx traffic class has NET_TC_RX_FLOW_QUEUES consecutive queues */
+#define NET_TC_RX_QUEUE_COUNT (NET_TC_RX_COUNT * NET_TC_RX_FLOW_QUEUES)
 
 /* Stacks for TX work queue */
 NET_STACK_ARRAY_DEFINE(TX, tx_stack,
@@ -29,19 +34,190 @@ NET_STACK_ARRAY_DEFINE(TX, tx_stack,
 NET_STACK_ARRAY_DEFINE(RX, rx_stack,
 		       CONFIG_NET_RX_STACK_SIZE,
 		       CONFIG_NET_RX_STACK_SIZE + CONFIG_NET_RX_STACK_RPL,
-		       NET_TC_RX_COUNT);
+		       NET_TC_RX_QUEUE_COUNT);
 
 static struct net_traffic_class tx_classes[NET_TC_TX_COUNT];
-static struct net_traffic_class rx_classes[NET_TC_RX_COUNT];
+static struct net_traffic_class rx_classes[NET_TC_RX_QUEUE_COUNT];
+
+/* Packets held back by the thread owning the TX batch, see
+ * net_tc_tx_batch_begin(). They are linked through their work item.
+ */
+static K_MUTEX_DEFINE(tx_batch_lock);
+static k_tid_t tx_batch_owner;
+static int tx_batch_depth;
+static int tx_batch_count;
+static sys_slist_t tx_batch[NET_TC_TX_COUNT];
 
 void net_tc_submit_to_tx_queue(u8_t tc, struct net_pkt *pkt)
 {
-	k_work_submit_to_queue(&tx_classes[tc].work_q, net_pkt_work(pkt));
+	struct k_work *work = net_pkt_work(pkt);
+
+	if (tx_batch_owner && !k_is_in_isr() &&
+	    tx_batch_owner == k_current_get()) {
+		if (!atomic_test_and_set_bit(work->flags,
+					     K_WORK_STATE_PENDING)) {
+			sys_slist_append(&tx_batch[tc], (sys_snode_t *)work);
+			tx_batch_count++;
+		}
+
+		return;
+	}
+
+	k_work_submit_to_queue(&tx_classes[tc].work_q, work);
+}
+
+/* Hold back the packets the current thread sends until
+ * net_tc_tx_batch_end(), which wakes up each TX thread only once for all
+ * of them. Batches can be nested.
+ */
+void net_tc_tx_batch_begin(void)
+{
+	k_mutex_lock(&tx_batch_lock, K_FOREVER);
+
+	if (!tx_batch_depth++) {
+		tx_batch_owner = k_current_get();
+		tx_batch_count = 0;
+	}
+}
+
+/* Number of packets held back by the batch of the current thread */
+int net_tc_tx_batch_len(void)
+{
+	return tx_batch_owner == k_current_get() ? tx_batch_count : 0;
+}
+
+void net_tc_tx_batch_end(void)
+{
+	int i;
+
+	NET_ASSERT(tx_batch_owner == k_current_get());
+
+	if (!--tx_batch_depth) {
+		tx_batch_owner = NULL;
+
+		for (i = 0; i < NET_TC_TX_COUNT; i++) {
+			if (!sys_slist_is_empty(&tx_batch[i])) {
+				k_queue_merge_slist(&tx_classes[i].work_q.queue,
+						    &tx_batch[i]);
+			}
+		}
+	}
+
+	k_mutex_unlock(&tx_batch_lock);
+}
+
+#if NET_TC_RX_FLOW_QUEUES > 1
+/* Hash the flow of a received packet, before L2 has processed it, the same
+ * way the connection cache does. Only IPv4 and IPv6 packets, either raw or
+ * in Ethernet frames, are hashed, all the other packets are in flow 0.
+ */
+static u32_t rx_flow_hash(struct net_pkt *pkt)
+{
+	struct net_pkt_cursor cursor;
+	u16_t ports[2];
+	u32_t value;
+	u8_t *version;
+	u8_t proto;
+
+	if (net_pkt_cursor_init(pkt, &cursor, 0) < 0) {
+		return 0;
+	}
+
+#if defined(CONFIG_NET_L2_ETHERNET)
+	if (net_if_l2(net_pkt_iface(pkt)) == &NET_L2_GET_NAME(ETHERNET)) {
+		u16_t type;
+
+		if (net_pkt_cursor_skip(&cursor,
+					2 * sizeof(struct net_eth_addr)) < 0 ||
+		    net_pkt_cursor_read_be16(&cursor, &type) < 0) {
+			return 0;
+		}
+
+		/* Skip the tag of a VLAN frame */
+		if (type == NET_ETH_PTYPE_VLAN &&
+		    (net_pkt_cursor_skip(&cursor, sizeof(u16_t)) < 0 ||
+		     net_pkt_cursor_read_be16(&cursor, &type) < 0)) {
+			return 0;
+		}
+
+		if (type != NET_ETH_PTYPE_IP && type != NET_ETH_PTYPE_IPV6) {
+			return 0;
+		}
+	}
+#endif
+
+	version = net_pkt_cursor_peek(&cursor, sizeof(u8_t));
+	if (!version) {
+		return 0;
+	}
+
+	switch (*version & 0xf0) {
+#if defined(CONFIG_NET_IPV6)
+	case 0x60: {
+		struct net_ipv6_hdr hdr;
+
+		if (net_pkt_cursor_read(&cursor, &hdr, sizeof(hdr)) < 0) {
+			return 0;
+		}
+
+		proto = hdr.nexthdr;
+		value = BIT(30) |
+			(net_conn_ipv6_to_hash(&hdr.src) << 8) |
+			(net_conn_ipv6_to_hash(&hdr.dst) << 19);
+		break;
+	}
+#endif
+#if defined(CONFIG_NET_IPV4)
+	case 0x40: {
+		struct net_ipv4_hdr hdr;
+
+		if (net_pkt_cursor_read(&cursor, &hdr, sizeof(hdr)) < 0 ||
+		    net_pkt_cursor_skip(&cursor, (hdr.vhl & 0x0f) * 4 -
+					sizeof(hdr)) < 0) {
+			return 0;
+		}
+
+		/* Only the first fragment has the ports, keep all the
+		 * fragments of a datagram in the same queue.
+		 */
+		proto = (hdr.offset[0] & 0x3f) || hdr.offset[1] ?
+			0 : hdr.proto;
+		value = (net_conn_ipv4_to_hash(&hdr.src) << 8) |
+			(net_conn_ipv4_to_hash(&hdr.dst) << 19);
+		break;
+	}
+#endif
+	default:
+		return 0;
+	}
+
+	/* TCP and UDP headers both start with the ports */
+	if ((proto == IPPROTO_TCP || proto == IPPROTO_UDP) &&
+	    !net_pkt_cursor_read(&cursor, ports, sizeof(ports))) {
+		value |= net_conn_ports_to_hash(ports[0], ports[1]);
+
+		if (proto == IPPROTO_UDP) {
+			value |= BIT(31);
+		}
+	}
+
+	/* Fold the bits of all the fields into the low ones */
+	value ^= value >> 16;
+	value ^= value >> 8;
+
+	return value;
 }
+#endif /* NET_TC_RX_FLOW_QUEUES > 1 */
 
 void net_tc_submit_to_rx_queue(u8_t tc, struct net_pkt *pkt)
 {
-	k_work_submit_to_queue(&rx_classes[tc].work_q, net_pkt_work(pkt));
+	int queue = tc * NET_TC_RX_FLOW_QUEUES;
+
+#if NET_TC_RX_FLOW_QUEUES > 1
+	queue += rx_flow_hash(pkt) % NET_TC_RX_FLOW_QUEUES;
+#endif
+
+	k_work_submit_to_queue(&rx_classes[queue].work_q, net_pkt_work(pkt));
 }
 
 int net_tx_priority2tc(enum net_priority prio)
@@ -357,10 +533,10 @@ void net_tc_rx_init(void)
 	net_if_foreach(net_tc_rx_stats_priority_setup, NULL);
 #endif
 
-	for (i = 0; i < NET_TC_RX_COUNT; i++) {
+	for (i = 0; i < NET_TC_RX_QUEUE_COUNT; i++) {
 		u8_t thread_priority;
 
-		thread_priority = rx_tc2thread(i);
+		thread_priority = rx_tc2thread(i / NET_TC_RX_FLOW_QUEUES);
 		rx_classes[i].tc = thread_priority;
 
 #if defined(CONFIG_NET_SHELL)
@@ -378,6 +554,19 @@ void net_tc_rx_init(void)
 			K_THREAD_STACK_SIZEOF(rx_stack[i]),
 			thread_priority, K_PRIO_COOP(thread_priority));
 
+#if defined(CONFIG_SCHED_CPU_MASK)
+		if (NET_TC_RX_FLOW_QUEUES > 1) {
+			/* Spread the flow queues of the class on the CPUs */
+			k_work_q_start_on_cpu(&rx_classes[i].work_q,
+					      rx_stack[i],
+					      K_THREAD_STACK_SIZEOF(rx_stack[i]),
+					      K_PRIO_COOP(thread_priority),
+					      (i % NET_TC_RX_FLOW_QUEUES) %
+					      CONFIG_MP_NUM_CPUS);
+			continue;
+		}
+#endif
+
 		k_work_q_start(&rx_classes[i].work_q,
 			       rx_stack[i],
 			       K_THREAD_STACK_SIZEOF(rx_stack[i]),
@@ -16,6 +16,7 @@
 
 #include <kernel.h>
 #include <limits.h>
+#include <string.h>
 #include <zephyr/types.h>
 #include <misc/slist.h>
 
@@ -256,12 +257,276 @@ static int nbr_nexthop_put(struct net_nbr *nbr)
 /* Route was accessed, so place it in front of the routes list */
 static inline void update_route_access(struct net_route_entry *route)
 {
+	if (sys_slist_peek_head(&routes) == &route->node) {
+		return;
+	}
+
 	sys_slist_find_and_remove(&routes, &route->node);
 	sys_slist_prepend(&routes, &route->node);
 }
 
-struct net_route_entry *net_route_lookup(struct net_if *iface,
-					 struct in6_addr *dst)
+#if defined(CONFIG_NET_ROUTE_TRIE)
+/* The routes are also kept in a path compressed binary trie of their
+ * prefixes. A trie node holds the routes of one prefix, on different
+ * interfaces, and the nodes without routes are only there to branch: they
+ * always have two children. There is then at most one branching node for
+ * each prefix.
+ */
+struct net_route_trie {
+	struct in6_addr prefix;
+	struct net_route_trie *parent;
+	struct net_route_trie *child[2];
+	sys_slist_t routes;
+	u8_t len;
+	bool used;
+};
+
+static struct net_route_trie trie_nodes[2 * CONFIG_NET_MAX_ROUTES];
+static struct net_route_trie *trie_root;
+
+/* Last route found on each interface, for the destination it was found */
+static struct {
+	struct net_if *iface;
+	struct net_route_entry *route;
+	struct in6_addr dst;
+} route_cache[CONFIG_NET_IF_MAX_IPV6_COUNT];
+
+static inline int trie_bit(const struct in6_addr *addr, u8_t bit)
+{
+	return (addr->s6_addr[bit / 8] >> (7 - (bit % 8))) & 1;
+}
+
+static u8_t trie_common_len(const struct in6_addr *addr1,
+			    const struct in6_addr *addr2,
+			    u8_t max)
+{
+	u8_t len = 0;
+
+	while (len + 8 <= max &&
+	       addr1->s6_addr[len / 8] == addr2->s6_addr[len / 8]) {
+		len += 8;
+	}
+
+	while (len < max && trie_bit(addr1, len) == trie_bit(addr2, len)) {
+		len++;
+	}
+
+	return len;
+}
+
+static struct net_route_trie *trie_node_alloc(const struct in6_addr *addr,
+					      u8_t len)
+{
+	struct net_route_trie *node;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(trie_nodes); i++) {
+		node = &trie_nodes[i];
+		if (node->used) {
+			continue;
+		}
+
+		memset(node, 0, sizeof(*node));
+		node->used = true;
+		node->len = len;
+		sys_slist_init(&node->routes);
+
+		/* Only keep the prefix bits */
+		memcpy(&node->prefix, addr, len / 8);
+		if (len % 8) {
+			node->prefix.s6_addr[len / 8] =
+				addr->s6_addr[len / 8] & (0xff00 >> (len % 8));
+		}
+
+		return node;
+	}
+
+	return NULL;
+}
+
+/* Put node where it belongs below parent, or at the root */
+static void trie_link(struct net_route_trie *parent,
+		      struct net_route_trie *node)
+{
+	node->parent = parent;
+
+	if (!parent) {
+		trie_root = node;
+	} else {
+		parent->child[trie_bit(&node->prefix, parent->len)] = node;
+	}
+}
+
+static struct net_route_trie *trie_insert(const struct in6_addr *addr,
+					  u8_t len)
+{
+	struct net_route_trie *parent = NULL, *node = trie_root;
+	struct net_route_trie *new, *branch;
+	u8_t common = 0;
+
+	while (node) {
+		common = trie_common_len(&node->prefix, addr,
+					 min(node->len, len));
+		if (common < node->len) {
+			break;
+		}
+
+		if (node->len == len) {
+			return node;
+		}
+
+		parent = node;
+		node = node->child[trie_bit(addr, node->len)];
+	}
+
+	new = trie_node_alloc(addr, len);
+	if (!new) {
+		return NULL;
+	}
+
+	if (!node) {
+		trie_link(parent, new);
+		return new;
+	}
+
+	/* The prefixes of node and new diverge after common bits: node goes
+	 * below new if new is the common prefix, otherwise both go below a
+	 * new branching node.
+	 */
+	if (common == len) {
+		trie_link(parent, new);
+		trie_link(new, node);
+		return new;
+	}
+
+	branch = trie_node_alloc(addr, common);
+	if (!branch) {
+		new->used = false;
+		return NULL;
+	}
+
+	trie_link(parent, branch);
+	trie_link(branch, node);
+	trie_link(branch, new);
+
+	return new;
+}
+
+/* Drop the nodes that are not needed anymore, from node up */
+static void trie_remove(struct net_route_trie *node)
+{
+	while (node && sys_slist_is_empty(&node->routes)) {
+		struct net_route_trie *parent = node->parent;
+		struct net_route_trie *child;
+
+		if (node->child[0] && node->child[1]) {
+			return;
+		}
+
+		node->used = false;
+
+		child = node->child[0] ? node->child[0] : node->child[1];
+		if (child) {
+			trie_link(parent, child);
+			return;
+		}
+
+		if (!parent) {
+			trie_root = NULL;
+			return;
+		}
+
+		parent->child[trie_bit(&node->prefix, parent->len)] = NULL;
+		node = parent;
+	}
+}
+
+static inline void route_cache_clear(void)
+{
+	memset(route_cache, 0, sizeof(route_cache));
+}
+
+static int route_trie_add(struct net_route_entry *route)
+{
+	struct net_route_trie *node;
+
+	if (route->prefix_len > 128) {
+		return -EINVAL;
+	}
+
+	node = trie_insert(&route->addr, route->prefix_len);
+	if (!node) {
+		return -ENOMEM;
+	}
+
+	sys_slist_append(&node->routes, &route->trie_node);
+	route->trie = node;
+
+	route_cache_clear();
+
+	return 0;
+}
+
+static void route_trie_del(struct net_route_entry *route)
+{
+	if (!route->trie) {
+		return;
+	}
+
+	sys_slist_find_and_remove(&route->trie->routes, &route->trie_node);
+	trie_remove(route->trie);
+	route->trie = NULL;
+
+	route_cache_clear();
+}
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
+{
+	struct net_route_trie *node = trie_root;
+	struct net_route_entry *route, *found = NULL;
+	int idx = 0;
+
+	if (iface) {
+		idx = net_if_get_by_iface(iface) % ARRAY_SIZE(route_cache);
+
+		if (route_cache[idx].iface == iface &&
+		    net_ipv6_addr_cmp(&route_cache[idx].dst, dst)) {
+			return route_cache[idx].route;
+		}
+	}
+
+	/* The prefixes get longer down the trie */
+	while (node && net_is_ipv6_prefix((u8_t *)dst, node->prefix.s6_addr,
+					  node->len)) {
+		SYS_SLIST_FOR_EACH_CONTAINER(&node->routes, route, trie_node) {
+			if (!iface || route->iface == iface) {
+				found = route;
+				break;
+			}
+		}
+
+		if (node->len == 128) {
+			break;
+		}
+
+		node = node->child[trie_bit(dst, node->len)];
+	}
+
+	if (found && iface) {
+		route_cache[idx].iface = iface;
+		route_cache[idx].route = found;
+		net_ipaddr_copy(&route_cache[idx].dst, dst);
+	}
+
+	return found;
+}
+#else
+#define route_trie_add(...) 0
+#define route_trie_del(...)
+
+static struct net_route_entry *route_find(struct net_if *iface,
+					  struct in6_addr *dst)
 {
 	struct net_route_entry *route, *found = NULL;
 	u8_t longest_match = 0;
@@ -289,6 +554,16 @@ struct net_route_entry *net_route_lookup(struct net_if *iface,
 		}
 	}
 
+	return found;
+}
+#endif /* CONFIG_NET_ROUTE_TRIE */
+
+struct net_route_entry *net_route_lookup(struct net_if *iface,
+					 struct in6_addr *dst)
+{
+	struct net_route_entry *found;
+
+	found = route_find(iface, dst);
 	if (found) {
 		net_route_info("Found", found, dst);
 
@@ -401,6 +676,13 @@ struct net_route_entry *net_route_add(struct net_if *iface,
 	route = net_route_data(nbr);
 	route->iface = iface;
 
+	if (route_trie_add(route) < 0) {
+		NET_ERR("Cannot add route to the trie!");
+		net_nbr_unref(tmp);
+		nbr_free(nbr);
+		return NULL;
+	}
+
 	sys_slist_prepend(&routes, &route->node);
 
 	tmp = nbr_nexthop_get(iface, nexthop);
@@ -463,6 +745,8 @@ int net_route_del(struct net_route_entry *route)
 
 	net_route_info("Deleted", route, &route->addr);
 
+	route_trie_del(route);
+
 	SYS_SLIST_FOR_EACH_CONTAINER(&route->nexthop, nexthop_route, node) {
 		if (!nexthop_route->nbr) {
 			continue;
@@ -61,6 +61,14 @@ struct net_route_entry {
 
 	/** IPv6 address/prefix length. */
 	u8_t prefix_len;
+
+#if defined(CONFIG_NET_ROUTE_TRIE)
+	/** Trie node of the prefix of the route. */
+	struct net_route_trie *trie;
+
+	/** Node in the list of routes of the trie node. */
+	sys_snode_t trie_node;
+#endif
 };
 
 /**
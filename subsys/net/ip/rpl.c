@@ -107,6 +107,12 @@
 #define NET_RPL_PARENT_FLAG_UPDATED           0x1
 #define NET_RPL_PARENT_FLAG_LINK_METRIC_VALID 0x2
 
+/* Target option of a DAO message */
+struct net_rpl_dao_target {
+	struct in6_addr addr;
+	u8_t prefix_len;
+};
+
 static struct net_rpl_instance rpl_instances[CONFIG_NET_RPL_MAX_INSTANCES];
 static struct net_rpl_instance *rpl_default_instance;
 static struct net_if *rpl_default_iface;
@@ -1689,7 +1695,6 @@ static void schedule_dao(struct net_rpl_instance *instance, int latency)
 	}
 
 	if (latency != 0) {
-		latency = K_SECONDS(latency);
 		expiration = latency / 2 + (sys_rand32_get() % latency);
 	} else {
 		expiration = 0;
@@ -1709,9 +1714,17 @@ static void schedule_dao(struct net_rpl_instance *instance, int latency)
 
 static inline void net_rpl_schedule_dao(struct net_rpl_instance *instance)
 {
-	schedule_dao(instance, CONFIG_NET_RPL_DAO_TIMER);
+	schedule_dao(instance, K_SECONDS(CONFIG_NET_RPL_DAO_TIMER));
 }
 
+#if defined(CONFIG_NET_RPL_DAO_AGGREGATION)
+static inline
+void net_rpl_schedule_dao_aggregated(struct net_rpl_instance *instance)
+{
+	schedule_dao(instance, CONFIG_NET_RPL_DAO_AGGREGATION_DELAY);
+}
+#endif
+
 static inline void net_rpl_schedule_dao_now(struct net_rpl_instance *instance)
 {
 	schedule_dao(instance, 0);
@@ -3017,10 +3030,11 @@ out:
 	return NET_DROP;
 }
 
-int net_rpl_dao_send(struct net_if *iface,
-		     struct net_rpl_parent *parent,
-		     struct in6_addr *prefix,
-		     u8_t lifetime)
+static int dao_send_targets(struct net_if *iface,
+			    struct net_rpl_parent *parent,
+			    struct net_rpl_dao_target *targets,
+			    int count,
+			    u8_t lifetime)
 {
 	u16_t value = 0;
 	struct net_rpl_instance *instance;
@@ -3029,8 +3043,7 @@ int net_rpl_dao_send(struct net_if *iface,
 	struct in6_addr *dst;
 	struct net_pkt *pkt;
 	u8_t prefix_bytes;
-	u8_t prefixlen;
-	int ret;
+	int ret, i;
 
 	/* No DAOs in feather mode. */
 	if (net_rpl_get_mode() == NET_RPL_MODE_FEATHER) {
@@ -3097,14 +3110,17 @@ int net_rpl_dao_send(struct net_if *iface,
 			K_FOREVER);
 #endif
 
-	prefixlen = sizeof(*prefix) * CHAR_BIT;
-	prefix_bytes = (prefixlen + 7) / CHAR_BIT;
+	/* The transit option applies to all the targets before it */
+	for (i = 0; i < count; i++) {
+		prefix_bytes = (targets[i].prefix_len + 7) / CHAR_BIT;
 
-	net_pkt_append_u8(pkt, NET_RPL_OPTION_TARGET);
-	net_pkt_append_u8(pkt, 2 + prefix_bytes);
-	net_pkt_append_u8(pkt, 0); /* reserved */
-	net_pkt_append_u8(pkt, prefixlen);
-	net_pkt_append_all(pkt, prefix_bytes, prefix->s6_addr, K_FOREVER);
+		net_pkt_append_u8(pkt, NET_RPL_OPTION_TARGET);
+		net_pkt_append_u8(pkt, 2 + prefix_bytes);
+		net_pkt_append_u8(pkt, 0); /* reserved */
+		net_pkt_append_u8(pkt, targets[i].prefix_len);
+		net_pkt_append_all(pkt, prefix_bytes, targets[i].addr.s6_addr,
+				   K_FOREVER);
+	}
 
 	net_pkt_append_u8(pkt, NET_RPL_OPTION_TRANSIT);
 	net_pkt_append_u8(pkt, 4); /* length */
@@ -3121,7 +3137,7 @@ int net_rpl_dao_send(struct net_if *iface,
 
 	ret = net_send_data(pkt);
 	if (ret >= 0) {
-		net_rpl_dao_info(pkt, src, dst, prefix);
+		net_rpl_dao_info(pkt, src, dst, &targets[0].addr);
 
 		net_stats_update_icmp_sent(iface);
 		net_stats_update_rpl_dao_sent(iface);
@@ -3132,6 +3148,111 @@ int net_rpl_dao_send(struct net_if *iface,
 	return ret;
 }
 
+int net_rpl_dao_send(struct net_if *iface,
+		     struct net_rpl_parent *parent,
+		     struct in6_addr *prefix,
+		     u8_t lifetime)
+{
+	struct net_rpl_dao_target target;
+
+	net_ipaddr_copy(&target.addr, prefix);
+	target.prefix_len = sizeof(*prefix) * CHAR_BIT;
+
+	return dao_send_targets(iface, parent, &target, 1, lifetime);
+}
+
+#if defined(CONFIG_NET_RPL_DAO_AGGREGATION)
+struct dao_aggregate {
+	struct net_rpl_dao_target targets[CONFIG_NET_RPL_DAO_MAX_TARGETS];
+	struct net_rpl_parent *parent;
+	struct net_if *iface;
+	u8_t lifetime;
+	int count;
+	int ret;
+};
+
+static void dao_aggregate_flush(struct dao_aggregate *aggr)
+{
+	int ret;
+
+	if (!aggr->count) {
+		return;
+	}
+
+	ret = dao_send_targets(aggr->iface, aggr->parent, aggr->targets,
+			       aggr->count, aggr->lifetime);
+	if (ret < 0) {
+		aggr->ret = ret;
+	}
+
+	aggr->count = 0;
+}
+
+static void dao_aggregate_route(struct net_route_entry *route,
+				void *user_data)
+{
+	struct dao_aggregate *aggr = user_data;
+	struct net_rpl_route_entry *extra = NULL;
+	struct net_nbr *nbr;
+
+	if (route->iface != aggr->iface) {
+		return;
+	}
+
+	nbr = net_route_get_nbr(route);
+	if (nbr) {
+		extra = net_nbr_extra_data(nbr);
+	}
+
+	/* Only the routes learned from the DAOs of our sub-DODAG */
+	if (!extra || extra->dag != aggr->parent->dag ||
+	    extra->route_source != NET_RPL_ROUTE_UNICAST_DAO ||
+	    extra->no_path_received || !extra->lifetime) {
+		return;
+	}
+
+	net_ipaddr_copy(&aggr->targets[aggr->count].addr, &route->addr);
+	aggr->targets[aggr->count].prefix_len = route->prefix_len;
+
+	if (++aggr->count == ARRAY_SIZE(aggr->targets)) {
+		dao_aggregate_flush(aggr);
+	}
+}
+
+/* Advertise our own address and the routes below us, in as few DAOs as
+ * possible.
+ */
+static int dao_send_aggregated(struct net_if *iface,
+			       struct net_rpl_parent *parent,
+			       struct in6_addr *prefix,
+			       u8_t lifetime)
+{
+	struct dao_aggregate aggr;
+
+	if (!parent || !parent->dag) {
+		return -EINVAL;
+	}
+
+	aggr.parent = parent;
+	aggr.iface = iface;
+	aggr.lifetime = lifetime;
+	aggr.ret = 0;
+
+	net_ipaddr_copy(&aggr.targets[0].addr, prefix);
+	aggr.targets[0].prefix_len = sizeof(*prefix) * CHAR_BIT;
+	aggr.count = 1;
+
+	if (ARRAY_SIZE(aggr.targets) == 1) {
+		dao_aggregate_flush(&aggr);
+	}
+
+	net_route_foreach(dao_aggregate_route, &aggr);
+	dao_aggregate_flush(&aggr);
+
+	return aggr.ret;
+}
+#endif /* CONFIG_NET_RPL_DAO_AGGREGATION */
+
 static int dao_send(struct net_rpl_parent *parent,
 		    u8_t lifetime,
 		    struct net_if *iface)
@@ -3146,7 +3267,11 @@ static int dao_send(struct net_rpl_parent *parent,
 
 	NET_ASSERT_INFO(iface, "Interface not set");
 
+#if defined(CONFIG_NET_RPL_DAO_AGGREGATION)
+	return dao_send_aggregated(iface, parent, prefix, lifetime);
+#else
 	return net_rpl_dao_send(iface, parent, prefix, lifetime);
+#endif
 }
 
 static inline int dao_forward(struct net_if *iface,
@@ -3293,18 +3418,130 @@ static bool is_root(struct net_rpl_instance *instance)
 	return true;
 }
 
+/* Mark the route to a target removed by a No-Path DAO, return true if
+ * it went through the sender.
+ */
+static bool dao_no_path(struct net_pkt *pkt, struct in6_addr *dao_sender,
+			struct net_rpl_dao_target *target)
+{
+	struct net_rpl_route_entry *extra = NULL;
+	struct net_route_entry *route;
+	struct in6_addr *nexthop;
+	struct net_nbr *rpl_nbr;
+
+	route = net_route_lookup(net_pkt_iface(pkt), &target->addr);
+
+	rpl_nbr = net_route_get_nbr(route);
+	if (rpl_nbr) {
+		extra = net_nbr_extra_data(rpl_nbr);
+	}
+
+	nexthop = net_route_get_nexthop(route);
+
+	/* No-Path DAO received; invoke the route purging routine. */
+	if (route && extra && !extra->no_path_received &&
+	    route->prefix_len == target->prefix_len && nexthop &&
+	    net_ipv6_addr_cmp(nexthop, dao_sender)) {
+		NET_DBG("Setting expiration timer for target %s",
+			net_sprint_ipv6_addr(&target->addr));
+
+		extra->no_path_received = true;
+		extra->lifetime = NET_RPL_DAO_EXPIRATION_TIMEOUT;
+
+		return true;
+	}
+
+	return false;
+}
+
+/* Make sure the sender of a DAO is in the neighbor cache */
+static bool dao_nbr_update(struct net_pkt *pkt, struct in6_addr *dao_sender)
+{
+	struct net_nbr *ipv6_nbr;
+
+	NET_DBG("Adding DAO route to %s", net_sprint_ipv6_addr(dao_sender));
+
+	ipv6_nbr = net_ipv6_nbr_lookup(net_pkt_iface(pkt), dao_sender);
+	if (ipv6_nbr) {
+		struct net_linkaddr_storage *nbr_lladdr;
+		struct net_linkaddr *src_lladdr;
+
+		NET_DBG("Neighbor %s [%s] already in neighbor cache",
+			net_sprint_ipv6_addr(dao_sender),
+			net_sprint_ll_addr(net_pkt_ll_src(pkt)->addr,
+					   net_pkt_ll_src(pkt)->len));
+
+		nbr_lladdr = net_nbr_get_lladdr(ipv6_nbr->idx);
+		if (!nbr_lladdr) {
+			NET_ERR("Invalid lladdr from ipv6 nbr");
+			return false;
+		}
+
+		src_lladdr = net_pkt_ll_src(pkt);
+		if (!src_lladdr || !src_lladdr->addr) {
+			NET_ERR("Invalid src lladdr in net pkt");
+			return false;
+		}
+
+		/* DAO received from different LLAddr, so remove IPv6 nbr from
+		 * previous LLAddr and add as a new nbr from current LLAddr.
+		 */
+		if (memcmp(nbr_lladdr->addr, src_lladdr->addr,
+			   nbr_lladdr->len)) {
+
+			if (!net_ipv6_nbr_rm(net_pkt_iface(pkt), dao_sender)) {
+				NET_ERR("Failed to remove %s, doesn't exist",
+					net_sprint_ipv6_addr(dao_sender));
+				return false;
+			}
+
+			ipv6_nbr = NULL;
+		}
+	}
+
+	if (!ipv6_nbr) {
+		ipv6_nbr = net_ipv6_nbr_add(net_pkt_iface(pkt), dao_sender,
+					    net_pkt_ll_src(pkt), false,
+					    NET_IPV6_NBR_STATE_REACHABLE);
+		if (ipv6_nbr) {
+			/* Set reachable timer */
+			net_ipv6_nbr_set_reachable_timer(net_pkt_iface(pkt),
+							 ipv6_nbr);
+
+			NET_DBG("Neighbor %s [%s] added to neighbor cache",
+				net_sprint_ipv6_addr(dao_sender),
+				net_sprint_ll_addr(net_pkt_ll_src(pkt)->addr,
+						   net_pkt_ll_src(pkt)->len));
+		} else {
+			NET_DBG("Out of memory, dropping DAO from %s [%s]",
+				net_sprint_ipv6_addr(dao_sender),
+				net_sprint_ll_addr(net_pkt_ll_src(pkt)->addr,
+						   net_pkt_ll_src(pkt)->len));
+			return false;
+		}
+	}
+
+	return true;
+}
+
 static enum net_verdict handle_dao(struct net_pkt *pkt)
 {
+	struct net_rpl_dao_target targets[CONFIG_NET_RPL_DAO_MAX_TARGETS];
 	struct in6_addr *dao_sender = &NET_IPV6_HDR(pkt)->src;
 	struct net_rpl_route_entry *extra = NULL;
 	struct net_rpl_parent *parent = NULL;
 	enum net_rpl_route_source learned_from;
+	struct net_rpl_dao_target *target;
 	struct net_rpl_instance *instance;
 	struct net_route_entry *route;
 	struct net_rpl_dag *dag;
 	struct net_buf *frag;
 	struct in6_addr addr;
-	struct net_nbr *ipv6_nbr, *rpl_nbr;
+	struct net_nbr *rpl_nbr;
+	bool nbr_updated = false;
+	bool no_path = false;
+	bool forward = false;
+	bool ack = false;
 	u16_t offset;
 	u16_t pos;
 	u8_t sequence;
@@ -3314,6 +3551,7 @@ static enum net_verdict handle_dao(struct net_pkt *pkt)
 	u8_t flags;
 	u8_t subopt_type;
 	u8_t len;
+	int count, i;
 	int r = -EINVAL;
 
 	net_rpl_info(pkt, "Destination Advertisement Object");
@@ -3391,7 +3629,7 @@ static enum net_verdict handle_dao(struct net_pkt *pkt)
 		}
 	}
 
-	target_len = 0;
+	count = 0;
 
 	/* Handle any DAO suboptions */
 	while (frag) {
@@ -3424,9 +3662,25 @@ static enum net_verdict handle_dao(struct net_pkt *pkt)
 		case NET_RPL_OPTION_TARGET:
 			frag = net_frag_skip(frag, pos, &pos, 1); /* reserved */
 			frag = net_frag_read_u8(frag, pos, &pos, &target_len);
+			if (target_len > sizeof(addr) * CHAR_BIT) {
+				NET_DBG("Invalid DAO target length %d",
+					target_len);
+				net_stats_update_rpl_malformed_msgs(
+							net_pkt_iface(pkt));
+				return NET_DROP;
+			}
+
+			memset(&addr, 0, sizeof(addr));
 			frag = net_frag_read(frag, pos, &pos,
 					     (target_len + 7) / 8,
 					     addr.s6_addr);
+
+			/* Targets which do not fit are left out */
+			if (count < ARRAY_SIZE(targets)) {
+				net_ipaddr_copy(&targets[count].addr, &addr);
+				targets[count].prefix_len = target_len;
+				count++;
+			}
 			break;
 		case NET_RPL_OPTION_TRANSIT:
 			/* The flags, path sequence and control are ignored. */
@@ -3440,171 +3694,121 @@ static enum net_verdict handle_dao(struct net_pkt *pkt)
 		}
 	}
 
-	NET_DBG("DAO lifetime %d addr %s/%d", lifetime,
-		net_sprint_ipv6_addr(&addr), target_len);
-
-#if NET_RPL_MULTICAST
-	if (net_is_ipv6_addr_mcast_global(&addr)) {
-		struct net_route_entry_mcast *mcast_group;
-
-		mcast_group = net_route_mcast_add(net_pkt_iface(pkt), &addr);
-		if (mcast_group) {
-			mcast_group->data = (void *)dag;
-			mcast_group->lifetime = net_rpl_lifetime(instance,
-								 lifetime);
-		}
-
-		goto fwd_dao;
+	if (!count) {
+		NET_DBG("No target in DAO");
+		return NET_DROP;
 	}
-#endif
 
-	if (lifetime == NET_RPL_ZERO_LIFETIME) {
-		struct in6_addr *nexthop;
+	for (i = 0; i < count; i++) {
+		target = &targets[i];
 
-		NET_DBG("No-Path DAO received");
+		NET_DBG("DAO lifetime %d addr %s/%d", lifetime,
+			net_sprint_ipv6_addr(&target->addr),
+			target->prefix_len);
 
-		route = net_route_lookup(net_pkt_iface(pkt), &addr);
+#if NET_RPL_MULTICAST
+		if (net_is_ipv6_addr_mcast_global(&target->addr)) {
+			struct net_route_entry_mcast *mcast_group;
+
+			mcast_group = net_route_mcast_add(net_pkt_iface(pkt),
+							  &target->addr);
+			if (mcast_group) {
+				mcast_group->data = (void *)dag;
+				mcast_group->lifetime =
+					net_rpl_lifetime(instance, lifetime);
+			}
 
-		rpl_nbr = net_route_get_nbr(route);
-		if (rpl_nbr) {
-			extra = net_nbr_extra_data(rpl_nbr);
+			forward = true;
+			continue;
 		}
-
-		nexthop = net_route_get_nexthop(route);
-
-		/* No-Path DAO received; invoke the route purging routine. */
-		if (route && extra && !extra->no_path_received &&
-		    route->prefix_len == target_len && nexthop &&
-		    net_ipv6_addr_cmp(nexthop, dao_sender)) {
-			NET_DBG("Setting expiration timer for target %s",
-				net_sprint_ipv6_addr(&addr));
-
-			extra->no_path_received = true;
-			extra->lifetime = NET_RPL_DAO_EXPIRATION_TIMEOUT;
-
-			/* We forward the incoming no-path DAO to our parent,
-			 * if we have one.
-			 */
-			if (dag->preferred_parent) {
-				r = forwarding_dao(instance, dag,
-						   pkt, sequence, flags,
-#if defined(CONFIG_NET_DEBUG_RPL)
-						   "Forwarding no-path DAO to "
-						   "parent"
-#else
-						   ""
 #endif
-						  );
-				if (r >= 0) {
-					net_pkt_unref(pkt);
-					return NET_OK;
-				}
-			}
-		}
-
-		return NET_DROP;
-	}
-
-	NET_DBG("Adding DAO route to %s", net_sprint_ipv6_addr(dao_sender));
-
-	ipv6_nbr = net_ipv6_nbr_lookup(net_pkt_iface(pkt), dao_sender);
-	if (ipv6_nbr) {
-		struct net_linkaddr_storage *nbr_lladdr;
-		struct net_linkaddr *src_lladdr;
 
-		NET_DBG("Neighbor %s [%s] already in neighbor cache",
-			net_sprint_ipv6_addr(dao_sender),
-			net_sprint_ll_addr(net_pkt_ll_src(pkt)->addr,
-					   net_pkt_ll_src(pkt)->len));
+		if (lifetime == NET_RPL_ZERO_LIFETIME) {
+			NET_DBG("No-Path DAO received");
 
-		nbr_lladdr = net_nbr_get_lladdr(ipv6_nbr->idx);
-		if (!nbr_lladdr) {
-			NET_ERR("Invalid lladdr from ipv6 nbr");
-			return NET_DROP;
-		}
+			if (dao_no_path(pkt, dao_sender, target)) {
+				no_path = true;
+			}
 
-		src_lladdr = net_pkt_ll_src(pkt);
-		if (!src_lladdr || !src_lladdr->addr) {
-			NET_ERR("Invalid src lladdr in net pkt");
-			return NET_DROP;
+			continue;
 		}
 
-		/* DAO received from different LLAddr, so remove IPv6 nbr from
-		 * previous LLAddr and add as a new nbr from current LLAddr.
-		 */
-		if (memcmp(nbr_lladdr->addr, src_lladdr->addr,
-			   nbr_lladdr->len)) {
-
-			if (!net_ipv6_nbr_rm(net_pkt_iface(pkt), dao_sender)) {
-				NET_ERR("Failed to remove %s, doesn't exist",
-					net_sprint_ipv6_addr(dao_sender));
+		if (!nbr_updated) {
+			if (!dao_nbr_update(pkt, dao_sender)) {
 				return NET_DROP;
 			}
 
-			ipv6_nbr = NULL;
+			nbr_updated = true;
 		}
-	}
 
-	if (!ipv6_nbr) {
-		ipv6_nbr = net_ipv6_nbr_add(net_pkt_iface(pkt), dao_sender,
-					    net_pkt_ll_src(pkt), false,
-					    NET_IPV6_NBR_STATE_REACHABLE);
-		if (ipv6_nbr) {
-			/* Set reachable timer */
-			net_ipv6_nbr_set_reachable_timer(net_pkt_iface(pkt),
-							 ipv6_nbr);
+		route = net_rpl_add_route(dag, net_pkt_iface(pkt),
+					  &target->addr, target->prefix_len,
+					  dao_sender);
+		if (!route) {
+			net_stats_update_rpl_mem_overflows(net_pkt_iface(pkt));
 
-			NET_DBG("Neighbor %s [%s] added to neighbor cache",
-				net_sprint_ipv6_addr(dao_sender),
-				net_sprint_ll_addr(net_pkt_ll_src(pkt)->addr,
-						   net_pkt_ll_src(pkt)->len));
-		} else {
-			NET_DBG("Out of memory, dropping DAO from %s [%s]",
-				net_sprint_ipv6_addr(dao_sender),
-				net_sprint_ll_addr(net_pkt_ll_src(pkt)->addr,
-						   net_pkt_ll_src(pkt)->len));
-			return NET_DROP;
+			NET_DBG("Could not add a route after receiving a DAO");
+			continue;
 		}
-	}
-
-	route = net_rpl_add_route(dag, net_pkt_iface(pkt),
-				  &addr, target_len, dao_sender);
-	if (!route) {
-		net_stats_update_rpl_mem_overflows(net_pkt_iface(pkt));
 
-		NET_DBG("Could not add a route after receiving a DAO");
-		return NET_DROP;
-	}
+		rpl_nbr = net_route_get_nbr(route);
 
-	rpl_nbr = net_route_get_nbr(route);
+		extra = net_nbr_extra_data(rpl_nbr);
+		if (extra) {
+			extra->lifetime = net_rpl_lifetime(instance, lifetime);
+			extra->route_source = learned_from;
+			extra->no_path_received = false;
+		}
 
-	extra = net_nbr_extra_data(rpl_nbr);
-	if (extra) {
-		extra->lifetime = net_rpl_lifetime(instance, lifetime);
-		extra->route_source = learned_from;
-		extra->no_path_received = false;
+		forward = true;
 	}
 
-#if NET_RPL_MULTICAST
-fwd_dao:
+	if (no_path && !forward) {
+		/* We forward the incoming no-path DAO to our parent,
+		 * if we have one.
+		 */
+		if (dag->preferred_parent) {
+			r = forwarding_dao(instance, dag, pkt, sequence, flags,
+#if defined(CONFIG_NET_DEBUG_RPL)
+					   "Forwarding no-path DAO to parent"
+#else
+					   ""
 #endif
+					  );
+			if (r >= 0) {
+				net_pkt_unref(pkt);
+				return NET_OK;
+			}
+		}
+
+		return NET_DROP;
+	}
 
-	if (learned_from != NET_RPL_ROUTE_UNICAST_DAO) {
+	if (!forward || learned_from != NET_RPL_ROUTE_UNICAST_DAO) {
 		return NET_DROP;
 	}
 
 	if (dag->preferred_parent) {
+#if defined(CONFIG_NET_RPL_DAO_AGGREGATION)
+		/* The targets go up in our next DAO instead, so the DAO is
+		 * acknowledged here.
+		 */
+		net_rpl_schedule_dao_aggregated(instance);
+		ack = true;
+#else
 		r = forwarding_dao(instance, dag, pkt, sequence, flags,
 				   "Forwarding DAO to parent");
 		if (r < 0) {
 			return NET_DROP;
-		} else {
-			goto end;
 		}
+
+		net_pkt_unref(pkt);
+		return NET_OK;
+#endif
 	}
 
 	if (IS_ENABLED(CONFIG_NET_RPL_DAO_ACK) && (flags & NET_RPL_DAO_K_FLAG)
-	    && is_root(instance)) {
+	    && (ack || is_root(instance))) {
 		NET_DBG("Sending DAO-ACK to %s (iface %p)",
 			net_sprint_ipv6_addr(&NET_IPV6_HDR(pkt)->src),
 			net_pkt_iface(pkt));
@@ -3618,7 +3822,6 @@ fwd_dao:
 		}
 	}
 
-end:
 	net_pkt_unref(pkt);
 	return NET_OK;
 }
@@ -27,6 +27,7 @@
 #include <net/net_ip.h>
 #include <net/net_context.h>
 #include <net/tcp.h>
+#include <net/ethernet.h>
 #include <misc/byteorder.h>
 
 #include "connection.h"
@@ -37,6 +38,10 @@
 #include "tcp_internal.h"
 #include "net_stats.h"
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+#include "tcp_cc.h"
+#endif
+
 #define ALLOC_TIMEOUT K_MSEC(500)
 
 /*
@@ -52,6 +57,9 @@ static struct tcp_backlog_entry {
 	u32_t send_seq;
 	u32_t send_ack;
 	u16_t send_mss;
+	u8_t send_wscale;
+	u8_t wscale_ok : 1;
+	u8_t sack_ok : 1;
 	struct k_delayed_work ack_timer;
 } tcp_backlog[CONFIG_NET_TCP_BACKLOG_SIZE];
 
@@ -156,8 +164,16 @@ static void net_tcp_trace(struct net_pkt *pkt, struct net_tcp *tcp)
 
 static inline u32_t retry_timeout(const struct net_tcp *tcp)
 {
-	return ((u32_t)1 << tcp->retry_timeout_shift) *
-				CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+	u32_t rto = CONFIG_NET_TCP_INIT_RETRANSMISSION_TIMEOUT;
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	/* RFC 6298 2.3, but never below the initial value */
+	if (tcp->srtt) {
+		rto = max(rto, (tcp->srtt >> 3) + tcp->rttvar);
+	}
+#endif
+
+	return ((u32_t)1 << tcp->retry_timeout_shift) * rto;
 }
 
 #define is_6lo_technology(pkt)						    \
@@ -200,13 +216,304 @@ static void abort_connection(struct net_tcp *tcp)
 	net_context_unref(ctx);
 }
 
+#if defined(CONFIG_NET_TCP_REASSEMBLY) || \
+	defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+static u32_t tcp_pkt_seq(struct net_pkt *pkt)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr) {
+		return 0;
+	}
+
+	return sys_get_be32(tcp_hdr->seq);
+}
+#endif
+
+#if defined(CONFIG_NET_TCP_SACK)
+static bool tcp_pkt_sacked(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+	u32_t seq, end;
+	int i;
+
+	if (!net_pkt_appdatalen(pkt)) {
+		return false;
+	}
+
+	seq = tcp_pkt_seq(pkt);
+	end = seq + net_pkt_appdatalen(pkt);
+
+	for (i = 0; i < tcp->sacked_count; i++) {
+		if (net_tcp_seq_cmp(seq, tcp->sacked[i].start) >= 0 &&
+		    net_tcp_seq_cmp(end, tcp->sacked[i].end) <= 0) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
+/* First sent packet that the peer has not reported as received */
+static struct net_pkt *tcp_first_unsacked(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+#if defined(CONFIG_NET_TCP_SACK)
+		if (tcp_pkt_sacked(tcp, pkt)) {
+			continue;
+		}
+#endif
+		return pkt;
+	}
+
+	return NULL;
+}
+
+static void tcp_retransmit(struct net_tcp *tcp, struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	/* Karn's algorithm: ACKs of retransmitted data give no RTT */
+	tcp->rtt_timing = 0;
+#endif
+
+	if (net_pkt_sent(pkt)) {
+		do_ref_if_needed(tcp, pkt);
+		net_pkt_set_sent(pkt, false);
+	}
+
+	net_pkt_set_queued(pkt, true);
+
+	if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
+		NET_DBG("retry %u: [%p] pkt %p send failed",
+			tcp->retry_timeout_shift, tcp, pkt);
+		net_pkt_unref(pkt);
+	} else {
+		NET_DBG("retry %u: [%p] sent pkt %p",
+			tcp->retry_timeout_shift, tcp, pkt);
+		if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
+		    !is_6lo_technology(pkt)) {
+			net_stats_update_tcp_seg_rexmit(net_pkt_iface(pkt));
+		}
+	}
+}
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+/* Data sent and not acknowledged yet */
+static u32_t tcp_flight_size(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt;
+	u32_t flight = 0;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
+		if (!net_pkt_queued(pkt)) {
+			break;
+		}
+
+		flight += net_pkt_appdatalen(pkt);
+	}
+
+	return flight;
+}
+
+/* Oldest unacknowledged sequence number */
+static u32_t tcp_send_una(struct net_tcp *tcp)
+{
+	if (sys_slist_is_empty(&tcp->sent_list)) {
+		return tcp->send_seq;
+	}
+
+	return tcp_pkt_seq(CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+					struct net_pkt, sent_list));
+}
+
+static void tcp_cc_init(struct net_tcp *tcp)
+{
+	u32_t mss = tcp->send_mss;
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	tcp->cc = &net_tcp_cc_cubic;
+#else
+	tcp->cc = &net_tcp_cc_newreno;
+#endif
+
+	/* RFC 5681 3.1 initial window */
+	if (mss > 2190) {
+		tcp->cwnd = 2 * mss;
+	} else if (mss > 1095) {
+		tcp->cwnd = 3 * mss;
+	} else {
+		tcp->cwnd = 4 * mss;
+	}
+
+	tcp->ssthresh = UINT32_MAX;
+	tcp->send_wnd = UINT32_MAX;
+	tcp->recover = tcp->send_seq - 1;
+	tcp->cc_dup_acks = 0;
+	tcp->in_recovery = 0;
+	tcp->rtt_timing = 0;
+
+	tcp->cc->init(tcp);
+
+	NET_DBG("[%p] %s cwnd %u", tcp, tcp->cc->name, tcp->cwnd);
+}
+
+static void tcp_cc_retransmit(struct net_tcp *tcp)
+{
+	struct net_pkt *pkt = tcp_first_unsacked(tcp);
+
+	/* Nothing to do while still in the transmit queue */
+	if (pkt && net_pkt_queued(pkt) && net_pkt_sent(pkt)) {
+		tcp_retransmit(tcp, pkt);
+	}
+}
+
+static void tcp_cc_new_ack(struct net_tcp *tcp, u32_t ack, u32_t acked)
+{
+	u32_t mss = tcp->send_mss;
+
+	tcp->cc_dup_acks = 0;
+
+	if (tcp->rtt_timing && net_tcp_seq_cmp(ack, tcp->rtt_seq) >= 0) {
+		tcp->rtt_timing = 0;
+		net_tcp_cc_rtt_update(tcp, k_uptime_get_32() - tcp->rtt_start);
+	}
+
+	if (!tcp->in_recovery) {
+		tcp->cc->cong_avoid(tcp, acked);
+		return;
+	}
+
+	if (net_tcp_seq_cmp(ack, tcp->recover) >= 0) {
+		/* Full ACK, RFC 6582 3.2 step 3 */
+		tcp->cwnd = min(tcp->ssthresh, tcp_flight_size(tcp) + mss);
+		tcp->in_recovery = 0;
+
+		NET_DBG("[%p] recovered, cwnd %u", tcp, tcp->cwnd);
+		return;
+	}
+
+	/* Partial ACK: the next unacknowledged segment is lost as well.
+	 * Deflate the window by the amount of data acknowledged and add
+	 * back one segment (RFC 6582 3.2 step 4).
+	 */
+	tcp_cc_retransmit(tcp);
+
+	tcp->cwnd = tcp->cwnd > acked ? tcp->cwnd - acked : 0;
+	if (acked >= mss) {
+		tcp->cwnd += mss;
+	}
+
+	tcp->cwnd = max(tcp->cwnd, mss);
+}
+
+static void tcp_cc_dup_ack(struct net_tcp *tcp, u32_t ack)
+{
+	if (tcp->in_recovery) {
+		/* A segment left the network: inflate the window */
+		tcp->cwnd += tcp->send_mss;
+		return;
+	}
+
+	/* Only data sent after the previous recovery starts a new one */
+	if (++tcp->cc_dup_acks != 3 ||
+	    !net_tcp_seq_greater(ack, tcp->recover)) {
+		return;
+	}
+
+	net_tcp_cc_fast_rexmit(tcp, tcp_send_una(tcp), tcp_flight_size(tcp));
+
+	tcp_cc_retransmit(tcp);
+
+	net_stats_update_tcp_seg_fast_rexmit(net_context_get_iface(tcp->context));
+
+	NET_DBG("[%p] fast retransmit, ssthresh %u", tcp, tcp->ssthresh);
+}
+
+static void tcp_update_send_wnd(struct net_tcp *tcp,
+				struct net_tcp_hdr *tcp_hdr)
+{
+	tcp->send_wnd = (u32_t)sys_get_be16(tcp_hdr->wnd) << tcp->send_wscale;
+}
+
+/* Update the congestion state for an ACK received, una being the oldest
+ * unacknowledged sequence number before it.
+ */
+static void tcp_cc_ack(struct net_tcp *tcp, struct net_tcp_hdr *tcp_hdr,
+		       u32_t una, bool no_data)
+{
+	u32_t ack = sys_get_be32(tcp_hdr->ack);
+	struct net_pkt *head;
+
+	if (!tcp->cc) {
+		return;
+	}
+
+	tcp_update_send_wnd(tcp, tcp_hdr);
+
+	if (net_tcp_seq_greater(ack, una)) {
+		tcp_cc_new_ack(tcp, ack, ack - una);
+		return;
+	}
+
+	if (!no_data || sys_slist_is_empty(&tcp->sent_list)) {
+		return;
+	}
+
+	/* RFC 5681 2: an ACK for outstanding data carrying nothing new */
+	head = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+			    struct net_pkt, sent_list);
+	if (ack == una && net_pkt_queued(head)) {
+		tcp_cc_dup_ack(tcp, ack);
+	}
+}
+
+static void tcp_cc_timeout(struct net_tcp *tcp)
+{
+	bool first = tcp->retry_timeout_shift == 1;
+
+	if (!tcp->cc) {
+		return;
+	}
+
+	net_tcp_cc_rto(tcp, tcp_send_una(tcp), tcp_flight_size(tcp), first);
+
+	if (first) {
+		net_stats_update_tcp_seg_timeout(
+			net_context_get_iface(tcp->context));
+	}
+}
+
+int net_stats_tcp_cc_get(struct net_context *context,
+			 struct net_stats_tcp_cc *stats)
+{
+	struct net_tcp *tcp = context->tcp;
+
+	if (!tcp || !tcp->cc) {
+		return -ENOTCONN;
+	}
+
+	stats->cwnd = tcp->cwnd;
+	stats->ssthresh = tcp->ssthresh;
+	stats->srtt = tcp->srtt >> 3;
+	stats->rttvar = tcp->rttvar >> 2;
+	stats->fast_rexmit = tcp->fast_rexmits;
+	stats->timeout = tcp->timeouts;
+
+	return 0;
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 static void tcp_retry_expired(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp, retry_timer);
 	struct net_pkt *pkt;
 
 	/* Double the retry period for exponential backoff and resent
-	 * the first (only the first!) unack'd packet.
+	 * the first (only the first!) unack'd packet that the peer did
+	 * not selectively acknowledge.
 	 */
 	if (!sys_slist_is_empty(&tcp->sent_list)) {
 		tcp->retry_timeout_shift++;
@@ -216,31 +523,22 @@ static void tcp_retry_expired(struct k_work *work)
 			return;
 		}
 
-		k_delayed_work_submit(&tcp->retry_timer, retry_timeout(tcp));
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		tcp_cc_timeout(tcp);
+#endif
 
-		pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
-				   struct net_pkt, sent_list);
+		k_delayed_work_submit(&tcp->retry_timer, retry_timeout(tcp));
 
-		if (net_pkt_sent(pkt)) {
-			do_ref_if_needed(tcp, pkt);
-			net_pkt_set_sent(pkt, false);
+		pkt = tcp_first_unsacked(tcp);
+		if (!pkt) {
+			/* The peer may discard SACKed data (RFC 2018
+			 * section 8), send the first packet again anyway.
+			 */
+			pkt = CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+					   struct net_pkt, sent_list);
 		}
 
-		net_pkt_set_queued(pkt, true);
-
-		if (net_tcp_send_pkt(pkt) < 0 && !is_6lo_technology(pkt)) {
-			NET_DBG("retry %u: [%p] pkt %p send failed",
-				tcp->retry_timeout_shift, tcp, pkt);
-			net_pkt_unref(pkt);
-		} else {
-			NET_DBG("retry %u: [%p] sent pkt %p",
-				tcp->retry_timeout_shift, tcp, pkt);
-			if (IS_ENABLED(CONFIG_NET_STATISTICS_TCP) &&
-			    !is_6lo_technology(pkt)) {
-				net_stats_update_tcp_seg_rexmit(
-							net_pkt_iface(pkt));
-			}
-		}
+		tcp_retransmit(tcp, pkt);
 	} else if (CONFIG_NET_TCP_TIME_WAIT_DELAY != 0) {
 		if (tcp->fin_sent && tcp->fin_rcvd) {
 			NET_DBG("[%p] Closing connection (context %p)",
@@ -250,6 +548,23 @@ static void tcp_retry_expired(struct k_work *work)
 	}
 }
 
+/* Smallest shift advertising the whole receive window */
+static u8_t tcp_recv_wscale(void)
+{
+	u8_t shift = 0;
+
+	if (!IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE)) {
+		return 0;
+	}
+
+	while (shift < NET_TCP_MAX_WINDOW_SCALE &&
+	       (CONFIG_NET_TCP_RECV_WINDOW >> shift) > UINT16_MAX) {
+		shift++;
+	}
+
+	return shift;
+}
+
 struct net_tcp *net_tcp_alloc(struct net_context *context)
 {
 	int i, key;
@@ -274,9 +589,16 @@ struct net_tcp *net_tcp_alloc(struct net_context *context)
 	tcp_context[i].context = context;
 
 	tcp_context[i].send_seq = tcp_init_isn();
-	tcp_context[i].recv_wnd = min(NET_TCP_MAX_WIN, NET_TCP_BUF_MAX_LEN);
+	tcp_context[i].recv_wnd = CONFIG_NET_TCP_RECV_WINDOW;
+	tcp_context[i].recv_wscale = tcp_recv_wscale();
+	tcp_context[i].wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE);
+	tcp_context[i].sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK);
 	tcp_context[i].send_mss = NET_TCP_DEFAULT_MSS;
 
+#if defined(CONFIG_NET_TCP_REASSEMBLY)
+	sys_slist_init(&tcp_context[i].ooo_list);
+#endif
+
 	tcp_context[i].accept_cb = NULL;
 
 	k_delayed_work_init(&tcp_context[i].retry_timer, tcp_retry_expired);
@@ -305,6 +627,30 @@ static void timewait_timer_cancel(struct net_tcp *tcp)
 	k_delayed_work_cancel(&tcp->timewait_timer);
 }
 
+static void delayed_ack_timer_cancel(struct net_tcp *tcp)
+{
+#if defined(CONFIG_NET_TCP_DELAYED_ACK)
+	k_delayed_work_cancel(&tcp->delayed_ack_timer);
+#endif
+	tcp->ack_delayed = 0;
+}
+
+static void tcp_ooo_flush(struct net_tcp *tcp)
+{
+#if defined(CONFIG_NET_TCP_REASSEMBLY)
+	struct net_pkt *pkt;
+	struct net_pkt *tmp;
+
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&tcp->ooo_list, pkt, tmp,
+					  sent_list) {
+		sys_slist_remove(&tcp->ooo_list, NULL, &pkt->sent_list);
+		net_pkt_unref(pkt);
+	}
+
+	tcp->ooo_count = 0;
+#endif
+}
+
 int net_tcp_release(struct net_tcp *tcp)
 {
 	struct net_pkt *pkt;
@@ -321,12 +667,15 @@ int net_tcp_release(struct net_tcp *tcp)
 		net_pkt_unref(pkt);
 	}
 
+	tcp_ooo_flush(tcp);
+
 	retry_timer_cancel(tcp);
 	k_sem_reset(&tcp->connect_wait);
 
 	ack_timer_cancel(tcp);
 	fin_timer_cancel(tcp);
 	timewait_timer_cancel(tcp);
+	delayed_ack_timer_cancel(tcp);
 
 	net_tcp_change_state(tcp, NET_TCP_CLOSED);
 	tcp->context = NULL;
@@ -500,6 +849,27 @@ u32_t net_tcp_get_recv_wnd(const struct net_tcp *tcp)
 	return tcp->recv_wnd;
 }
 
+static u16_t tcp_window_field(const struct net_tcp *tcp, u8_t flags)
+{
+	u32_t wnd = net_tcp_get_recv_wnd(tcp);
+
+#if defined(CONFIG_NET_CONTEXT_RCVBUF) && defined(CONFIG_NET_BUF_POOL_USAGE)
+	struct net_buf_pool *rx_data;
+
+	/* Do not offer more than the RX buffers left can hold */
+	net_pkt_get_info(NULL, NULL, &rx_data, NULL);
+	wnd = min(wnd, (u32_t)max(rx_data->avail_count, 0) *
+		  CONFIG_NET_BUF_DATA_SIZE);
+#endif
+
+	/* RFC 7323 2.2: the window of SYN segments is never scaled */
+	if (tcp->wscale_ok && !(flags & NET_TCP_SYN)) {
+		wnd >>= tcp->recv_wscale;
+	}
+
+	return min(wnd, UINT16_MAX);
+}
+
 int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 			    void *options, size_t optlen,
 			    const struct sockaddr_ptr *local,
@@ -554,7 +924,7 @@ int net_tcp_prepare_segment(struct net_tcp *tcp, u8_t flags,
 		}
 	}
 
-	wnd = net_tcp_get_recv_wnd(tcp);
+	wnd = tcp_window_field(tcp, flags);
 
 	segment.src_addr = (struct sockaddr_ptr *)local;
 	segment.dst_addr = remote;
@@ -647,6 +1017,25 @@ u16_t net_tcp_get_recv_mss(const struct net_tcp *tcp)
 	return 0;
 }
 
+/* Options negotiated in SYN and SYN-ACK segments, besides the MSS */
+static void net_tcp_set_syn_ext_opt(struct net_tcp *tcp, u8_t *options,
+				    u8_t *optionlen)
+{
+	if (tcp->wscale_ok) {
+		options[(*optionlen)++] = NET_TCP_NOP_OPT;
+		options[(*optionlen)++] = NET_TCP_WINDOW_SCALE_OPT;
+		options[(*optionlen)++] = NET_TCP_WINDOW_SCALE_SIZE;
+		options[(*optionlen)++] = tcp->recv_wscale;
+	}
+
+	if (tcp->sack_ok) {
+		options[(*optionlen)++] = NET_TCP_NOP_OPT;
+		options[(*optionlen)++] = NET_TCP_NOP_OPT;
+		options[(*optionlen)++] = NET_TCP_SACK_PERM_OPT;
+		options[(*optionlen)++] = NET_TCP_SACK_PERM_SIZE;
+	}
+}
+
 static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
 				u8_t *optionlen)
 {
@@ -666,13 +1055,73 @@ static void net_tcp_set_syn_opt(struct net_tcp *tcp, u8_t *options,
 		      (u32_t *)(options + *optionlen));
 
 	*optionlen += NET_TCP_MSS_SIZE;
+
+	net_tcp_set_syn_ext_opt(tcp, options, optionlen);
 }
 
+#if defined(CONFIG_NET_TCP_SACK)
+/* Describe the queued out of order data, the block holding the last
+ * segment received coming first as RFC 2018 section 4 requires.
+ */
+static void tcp_set_sack_opt(struct net_tcp *tcp, u8_t *options,
+			     u8_t *optionlen)
+{
+	struct net_tcp_sack_block blocks[NET_TCP_SACK_BLOCKS];
+	struct net_tcp_sack_block last;
+	struct net_pkt *pkt;
+	int count = 0;
+	int i;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, pkt, sent_list) {
+		u32_t seq = tcp_pkt_seq(pkt);
+		u32_t end = seq + net_pkt_appdatalen(pkt);
+
+		if (count && blocks[count - 1].end == seq) {
+			blocks[count - 1].end = end;
+			continue;
+		}
+
+		if (count == NET_TCP_SACK_BLOCKS) {
+			break;
+		}
+
+		blocks[count].start = seq;
+		blocks[count].end = end;
+		count++;
+	}
+
+	if (!count) {
+		return;
+	}
+
+	for (i = 1; i < count; i++) {
+		if (net_tcp_seq_cmp(tcp->ooo_last_seq, blocks[i].start) >= 0 &&
+		    net_tcp_seq_cmp(tcp->ooo_last_seq, blocks[i].end) < 0) {
+			last = blocks[i];
+			blocks[i] = blocks[0];
+			blocks[0] = last;
+			break;
+		}
+	}
+
+	options[(*optionlen)++] = NET_TCP_NOP_OPT;
+	options[(*optionlen)++] = NET_TCP_NOP_OPT;
+	options[(*optionlen)++] = NET_TCP_SACK_OPT;
+	options[(*optionlen)++] = 2 + count * NET_TCP_SACK_BLOCK_SIZE;
+
+	for (i = 0; i < count; i++) {
+		sys_put_be32(blocks[i].start, options + *optionlen);
+		sys_put_be32(blocks[i].end, options + *optionlen + 4);
+		*optionlen += NET_TCP_SACK_BLOCK_SIZE;
+	}
+}
+#endif
+
 int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 			struct net_pkt **pkt)
 {
-	u8_t options[NET_TCP_MAX_OPT_SIZE];
-	u8_t optionlen;
+	u8_t options[NET_TCP_MAX_HDR_OPT_SIZE];
+	u8_t optionlen = 0;
 
 	switch (net_tcp_get_state(tcp)) {
 	case NET_TCP_SYN_RCVD:
@@ -692,8 +1141,13 @@ int net_tcp_prepare_ack(struct net_tcp *tcp, const struct sockaddr *remote,
 		return net_tcp_prepare_segment(tcp, NET_TCP_FIN | NET_TCP_ACK,
 					       0, 0, NULL, remote, pkt);
 	default:
-		return net_tcp_prepare_segment(tcp, NET_TCP_ACK, 0, 0, NULL,
-					       remote, pkt);
+#if defined(CONFIG_NET_TCP_SACK)
+		if (tcp->sack_ok) {
+			tcp_set_sack_opt(tcp, options, &optionlen);
+		}
+#endif
+		return net_tcp_prepare_segment(tcp, NET_TCP_ACK, options,
+					       optionlen, NULL, remote, pkt);
 	}
 
 	return -EINVAL;
@@ -792,6 +1246,138 @@ const char *net_tcp_state_str(enum net_tcp_state state)
 	return "";
 }
 
+#if defined(CONFIG_NET_TCP_TSO)
+bool net_tcp_tso_enabled(struct net_if *iface)
+{
+	return iface && net_if_l2(iface) == &NET_L2_GET_NAME(ETHERNET);
+}
+
+/* Segment size of a packet holding more data than fits in a segment */
+static void tcp_tso_setup(struct net_tcp *tcp, struct net_pkt *pkt,
+			  size_t data_len)
+{
+	int seg_len;
+
+	seg_len = net_if_get_mtu(net_pkt_iface(pkt)) -
+		net_pkt_ip_hdr_len(pkt) - net_pkt_ipv6_ext_len(pkt) -
+		tcp_hdr_len(pkt);
+	seg_len = min(seg_len, tcp->send_mss);
+
+	if (seg_len > 0 && data_len > (size_t)seg_len) {
+		net_pkt_set_tso_mss(pkt, seg_len);
+	}
+}
+
+/* Software segmentation, for drivers without TCP segmentation offload.
+ * The packet stays as it is in the sent list, the segments carry copies
+ * of its headers and data.
+ */
+static int tcp_tso_send(struct net_pkt *pkt)
+{
+	struct net_context *ctx = net_pkt_context(pkt);
+	u16_t mss = net_pkt_tso_mss(pkt);
+	u16_t hdr_len, data_len, pos, hdr_pos;
+	struct net_tcp_hdr hdr, *tcp_hdr;
+	size_t offset;
+	struct net_buf *frag;
+	u32_t seq;
+	int ret;
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr) {
+		return -EMSGSIZE;
+	}
+
+	seq = sys_get_be32(tcp_hdr->seq);
+	hdr_len = net_pkt_ip_hdr_len(pkt) + net_pkt_ipv6_ext_len(pkt) +
+		NET_TCP_HDR_LEN(tcp_hdr);
+	data_len = net_pkt_get_len(pkt) - hdr_len;
+
+	frag = net_frag_skip(pkt->frags, 0, &pos, hdr_len);
+
+	for (offset = 0; offset < data_len; offset += mss) {
+		u16_t len = min(mss, data_len - offset);
+		struct net_buf *header;
+		struct net_pkt *seg;
+
+		seg = net_pkt_get_tx(ctx, ALLOC_TIMEOUT);
+		if (!seg) {
+			return -ENOMEM;
+		}
+
+		header = net_pkt_get_data(ctx, ALLOC_TIMEOUT);
+		if (!header) {
+			net_pkt_unref(seg);
+			return -ENOMEM;
+		}
+
+		net_pkt_frag_add(seg, header);
+
+		if (net_buf_tailroom(header) < hdr_len) {
+			net_pkt_unref(seg);
+			return -EMSGSIZE;
+		}
+
+		net_frag_read(pkt->frags, 0, &hdr_pos, hdr_len,
+			      net_buf_add(header, hdr_len));
+
+		while (len) {
+			struct net_buf *data;
+			u16_t chunk;
+
+			data = net_pkt_get_frag(seg, ALLOC_TIMEOUT);
+			if (!data) {
+				net_pkt_unref(seg);
+				return -ENOMEM;
+			}
+
+			net_pkt_frag_add(seg, data);
+
+			chunk = min(len, net_buf_tailroom(data));
+			frag = net_frag_read(frag, pos, &pos, chunk,
+					     net_buf_add(data, chunk));
+			len -= chunk;
+		}
+
+		net_pkt_set_ip_hdr_len(seg, net_pkt_ip_hdr_len(pkt));
+		net_pkt_set_ipv6_ext_len(seg, net_pkt_ipv6_ext_len(pkt));
+		net_pkt_set_vlan_tci(seg, net_pkt_vlan_tci(pkt));
+		net_pkt_set_priority(seg, net_pkt_priority(pkt));
+		net_pkt_set_token(seg, net_pkt_token(pkt));
+
+		tcp_hdr = net_tcp_get_hdr(seg, &hdr);
+		sys_put_be32(seq + offset, tcp_hdr->seq);
+		if (offset + mss < data_len) {
+			tcp_hdr->flags &= ~(NET_TCP_PSH | NET_TCP_FIN);
+		}
+
+		net_tcp_set_hdr(seg, tcp_hdr);
+
+		if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		    net_pkt_family(seg) == AF_INET) {
+			ret = net_ipv4_finalize_raw(seg, IPPROTO_TCP);
+		} else {
+			ret = net_ipv6_finalize_raw(seg, IPPROTO_TCP);
+		}
+
+		if (!ret) {
+			ret = net_send_data(seg);
+		}
+
+		if (ret < 0) {
+			net_pkt_unref(seg);
+			return ret;
+		}
+	}
+
+	/* The reference of the send goes away as the driver would drop it */
+	net_pkt_set_sent(pkt, true);
+	net_pkt_unref(pkt);
+
+	return 0;
+}
+#endif /* CONFIG_NET_TCP_TSO */
+
 int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 {
 	struct net_conn *conn = (struct net_conn *)context->conn_handler;
@@ -821,6 +1407,12 @@ int net_tcp_queue_data(struct net_context *context, struct net_pkt *pkt)
 		return ret;
 	}
 
+#if defined(CONFIG_NET_TCP_TSO)
+	if (net_tcp_tso_enabled(net_pkt_iface(pkt))) {
+		tcp_tso_setup(context->tcp, pkt, data_len);
+	}
+#endif
+
 	context->tcp->send_seq += data_len;
 
 	net_stats_update_tcp_sent(net_pkt_iface(pkt), data_len);
@@ -875,6 +1467,7 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 	}
 
 	ctx->tcp->sent_ack = ctx->tcp->send_ack;
+	ctx->tcp->ack_delayed = 0;
 
 	/* As we modified the header, we need to write it back.
 	 */
@@ -929,6 +1522,14 @@ int net_tcp_send_pkt(struct net_pkt *pkt)
 		}
 	}
 
+#if defined(CONFIG_NET_TCP_TSO)
+	if (net_pkt_tso_mss(pkt) &&
+	    !(net_eth_get_hw_capabilities(net_pkt_iface(pkt)) &
+	      ETHERNET_HW_TCP_TSO)) {
+		return tcp_tso_send(pkt);
+	}
+#endif
+
 	return net_send_data(pkt);
 }
 
@@ -953,38 +1554,70 @@ static void restart_timer(struct net_tcp *tcp)
 	}
 }
 
-int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
-		      void *token, void *user_data)
+static void tcp_send_queued(struct net_tcp *tcp)
 {
 	struct net_pkt *pkt;
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	u32_t flight = tcp_flight_size(tcp);
+	u32_t wnd = min(tcp->cwnd, tcp->send_wnd);
+#endif
 
-	/* For now, just send all queued data synchronously.  Need to
-	 * add window handling and retry/ACK logic.
-	 */
-	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, pkt, sent_list) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->sent_list, pkt, sent_list) {
 		/* Do not resend packets that were sent by expire timer */
 		if (net_pkt_queued(pkt)) {
 			NET_DBG("[%p] Skipping pkt %p because it was already "
-				"sent.", context->tcp, pkt);
+				"sent.", tcp, pkt);
 			continue;
 		}
 
 		if (!net_pkt_sent(pkt)) {
 			int ret;
 
-			NET_DBG("[%p] Sending pkt %p (%zd bytes)", context->tcp,
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+			if (tcp->cc) {
+				u16_t len = net_pkt_appdatalen(pkt);
+
+				/* Always let one segment out, so that a
+				 * closed window gets probed.
+				 */
+				if (flight && flight + len > wnd) {
+					NET_DBG("[%p] pkt %p waits, %u in "
+						"flight", tcp, pkt, flight);
+					break;
+				}
+
+				flight += len;
+
+				if (!tcp->rtt_timing) {
+					tcp->rtt_seq = tcp_pkt_seq(pkt) + len;
+					tcp->rtt_start = k_uptime_get_32();
+					tcp->rtt_timing = 1;
+				}
+			}
+#endif
+
+			NET_DBG("[%p] Sending pkt %p (%zd bytes)", tcp,
 				pkt, net_pkt_get_len(pkt));
 
 			ret = net_tcp_send_pkt(pkt);
 			if (ret < 0 && !is_6lo_technology(pkt)) {
 				NET_DBG("[%p] pkt %p not sent (%d)",
-					context->tcp, pkt, ret);
+					tcp, pkt, ret);
 				net_pkt_unref(pkt);
 			}
 
 			net_pkt_set_queued(pkt, true);
 		}
 	}
+}
+
+int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
+		      void *token, void *user_data)
+{
+	/* Send the queued data the windows allow, the rest is sent as
+	 * ACKs come in.
+	 */
+	tcp_send_queued(context->tcp);
 
 	/* Just make the callback synchronously even if it didn't
 	 * go over the wire.  In theory it would be nice to track
@@ -999,6 +1632,31 @@ int net_tcp_send_data(struct net_context *context, net_context_send_cb_t cb,
 	return 0;
 }
 
+size_t net_tcp_get_send_space(struct net_context *context)
+{
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	size_t sndbuf = context->options.sndbuf;
+#else
+	size_t sndbuf = CONFIG_NET_TCP_SEND_BUFFER;
+#endif
+	struct net_pkt *pkt;
+	size_t queued = 0;
+
+	if (!context->tcp) {
+		return 0;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&context->tcp->sent_list, pkt, sent_list) {
+		queued += net_pkt_appdatalen(pkt);
+	}
+
+	if (queued >= sndbuf) {
+		return 0;
+	}
+
+	return sndbuf - queued;
+}
+
 bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 {
 	struct net_tcp *tcp = ctx->tcp;
@@ -1007,6 +1665,9 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 	struct net_pkt *pkt;
 	u32_t seq;
 	bool valid_ack = false;
+#if defined(CONFIG_NET_SOCKETS)
+	bool was_full = !net_tcp_get_send_space(ctx);
+#endif
 
 	if (net_tcp_seq_greater(ack, ctx->tcp->send_seq)) {
 		NET_ERR("ctx %p: ACK for unsent data", ctx);
@@ -1066,6 +1727,13 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack)
 		restart_timer(ctx->tcp);
 	}
 
+#if defined(CONFIG_NET_SOCKETS)
+	/* Wake up the pollers waiting for room to write */
+	if (was_full && net_tcp_get_send_space(ctx)) {
+		k_poll_signal(&ctx->poll_signal, 0);
+	}
+#endif
+
 	return true;
 }
 
@@ -1137,6 +1805,12 @@ void net_tcp_change_state(struct net_tcp *tcp,
 
 	tcp->state = new_state;
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	if (new_state == NET_TCP_ESTABLISHED) {
+		tcp_cc_init(tcp);
+	}
+#endif
+
 	if (net_tcp_get_state(tcp) != NET_TCP_CLOSED) {
 		return;
 	}
@@ -1201,8 +1875,7 @@ struct net_tcp_hdr *net_tcp_get_hdr(struct net_pkt *pkt,
 				    struct net_tcp_hdr *hdr)
 {
 	struct net_tcp_hdr *tcp_hdr;
-	struct net_buf *frag;
-	u16_t pos;
+	struct net_pkt_cursor cursor;
 
 	tcp_hdr = net_pkt_tcp_data(pkt);
 	if (!tcp_hdr) {
@@ -1214,28 +1887,16 @@ struct net_tcp_hdr *net_tcp_get_hdr(struct net_pkt *pkt,
 		return tcp_hdr;
 	}
 
-	frag = net_frag_read(pkt->frags, net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt),
-			     &pos, sizeof(hdr->src_port),
-			     (u8_t *)&hdr->src_port);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->dst_port),
-			     (u8_t *)&hdr->dst_port);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->seq), hdr->seq);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->ack), hdr->ack);
-	frag = net_frag_read_u8(frag, pos, &pos, &hdr->offset);
-	frag = net_frag_read_u8(frag, pos, &pos, &hdr->flags);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->wnd), hdr->wnd);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->chksum),
-			     (u8_t *)&hdr->chksum);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->urg), hdr->urg);
-
-	if (!frag && pos == 0xffff) {
+	/* the header is packed: read it at once across the fragments */
+	if (net_pkt_cursor_init(pkt, &cursor, net_pkt_ip_hdr_len(pkt) +
+				net_pkt_ipv6_ext_len(pkt)) ||
+	    net_pkt_cursor_read(&cursor, hdr, NET_TCPH_LEN)) {
 		/* If the pkt is compressed, then this is the typical outcome
 		 * so no use printing error in this case.
 		 */
 		if (IS_ENABLED(CONFIG_NET_DEBUG_TCP) &&
 		    !is_6lo_technology(pkt)) {
-			NET_ASSERT(frag);
+			NET_ASSERT_INFO(false, "Truncated TCP header");
 		}
 
 		return NULL;
@@ -1341,7 +2002,7 @@ struct net_buf *net_tcp_set_chksum(struct net_pkt *pkt, struct net_buf *frag)
 int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 		       struct net_tcp_options *opts)
 {
-	struct net_buf *frag = pkt->frags;
+	struct net_pkt_cursor cursor;
 	u16_t pos = net_pkt_ip_hdr_len(pkt)
 		  + net_pkt_ipv6_ext_len(pkt)
 		  + sizeof(struct net_tcp_hdr);
@@ -1354,8 +2015,11 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 		return -EINVAL;
 	}
 
+	/* the length was checked above: the reads below cannot fail */
+	net_pkt_cursor_init(pkt, &cursor, pos);
+
 	while (opt_totlen) {
-		frag = net_frag_read(frag, pos, &pos, sizeof(opt), &opt);
+		net_pkt_cursor_read_u8(&cursor, &opt);
 		opt_totlen--;
 
 		/* https://www.iana.org/assignments/tcp-parameters/tcp-parameters.xhtml#tcp-parameters-1 */
@@ -1375,7 +2039,7 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 			goto error;
 		}
 
-		frag = net_frag_read(frag, pos, &pos, sizeof(optlen), &optlen);
+		net_pkt_cursor_read_u8(&cursor, &optlen);
 		opt_totlen--;
 		if (optlen < 2) {
 			goto error;
@@ -1394,11 +2058,46 @@ int net_tcp_parse_opts(struct net_pkt *pkt, int opt_totlen,
 			if (optlen != 2) {
 				goto error;
 			}
-			frag = net_frag_read_be16(frag, pos, &pos,
-						  &opts->mss);
+			net_pkt_cursor_read_be16(&cursor, &opts->mss);
+			break;
+		case NET_TCP_WINDOW_SCALE_OPT:
+			if (optlen != 1) {
+				goto error;
+			}
+			net_pkt_cursor_read_u8(&cursor, &opts->wscale);
+			opts->wscale_set = 1;
+			break;
+		case NET_TCP_SACK_PERM_OPT:
+			if (optlen != 0) {
+				goto error;
+			}
+			opts->sack_perm = 1;
+			break;
+		case NET_TCP_SACK_OPT:
+			if (!optlen || optlen % NET_TCP_SACK_BLOCK_SIZE) {
+				goto error;
+			}
+
+			opts->sack_count = 0;
+			while (optlen) {
+				struct net_tcp_sack_block *block =
+					&opts->sack[opts->sack_count];
+
+				if (opts->sack_count == NET_TCP_SACK_BLOCKS) {
+					net_pkt_cursor_skip(&cursor, optlen);
+					break;
+				}
+
+				net_pkt_cursor_read_be32(&cursor,
+							 &block->start);
+				net_pkt_cursor_read_be32(&cursor, &block->end);
+				opts->sack_count++;
+				optlen -= NET_TCP_SACK_BLOCK_SIZE;
+				opt_totlen -= NET_TCP_SACK_BLOCK_SIZE;
+			}
 			break;
 		default:
-			frag = net_frag_skip(frag, pos, &pos, optlen);
+			net_pkt_cursor_skip(&cursor, optlen);
 			break;
 		}
 
@@ -1490,21 +2189,37 @@ int net_tcp_listen(struct net_context *context)
 	return -EOPNOTSUPP;
 }
 
+static int send_ack(struct net_context *context,
+		    struct sockaddr *remote, bool force);
+
 int net_tcp_update_recv_wnd(struct net_context *context, s32_t delta)
 {
+	struct net_tcp *tcp = context->tcp;
+	u16_t mss;
 	s32_t new_win;
 
-	if (!context->tcp) {
+	if (!tcp) {
 		NET_ERR("context->tcp == NULL");
 		return -EPROTOTYPE;
 	}
 
-	new_win = context->tcp->recv_wnd + delta;
-	if (new_win < 0 || new_win > UINT16_MAX) {
+	new_win = tcp->recv_wnd + delta;
+	if (new_win < 0 || new_win > NET_TCP_MAX_RECV_WND) {
 		return -EINVAL;
 	}
 
-	context->tcp->recv_wnd = new_win;
+	/* A peer that filled the window waits for it to open again: tell
+	 * it as soon as a segment fits (RFC 1122 4.2.3.3).
+	 */
+	mss = net_tcp_get_recv_mss(tcp);
+	if (tcp->recv_wnd < mss && new_win >= mss &&
+	    net_tcp_get_state(tcp) == NET_TCP_ESTABLISHED) {
+		tcp->recv_wnd = new_win;
+		send_ack(context, &context->remote, true);
+		return 0;
+	}
+
+	tcp->recv_wnd = new_win;
 
 	return 0;
 }
@@ -1592,8 +2307,19 @@ static int tcp_backlog_find(struct net_pkt *pkt, int *empty_slot)
 	return -EADDRNOTAVAIL;
 }
 
+/* Window scaling and SACK are only used if both ends offer them */
+static void tcp_negotiate_opts(struct net_tcp *tcp,
+			       struct net_tcp_options *opts)
+{
+	tcp->wscale_ok = IS_ENABLED(CONFIG_NET_TCP_WINDOW_SCALE) &&
+			 opts->wscale_set;
+	tcp->send_wscale = tcp->wscale_ok ?
+		min(opts->wscale, NET_TCP_MAX_WINDOW_SCALE) : 0;
+	tcp->sack_ok = IS_ENABLED(CONFIG_NET_TCP_SACK) && opts->sack_perm;
+}
+
 static int tcp_backlog_syn(struct net_pkt *pkt, struct net_context *context,
-			   u16_t send_mss)
+			   struct net_tcp_options *opts)
 {
 	int empty_slot = -1;
 	int ret;
@@ -1619,7 +2345,10 @@ static int tcp_backlog_syn(struct net_pkt *pkt, struct net_context *context,
 
 	tcp_backlog[empty_slot].send_seq = context->tcp->send_seq;
 	tcp_backlog[empty_slot].send_ack = context->tcp->send_ack;
-	tcp_backlog[empty_slot].send_mss = send_mss;
+	tcp_backlog[empty_slot].send_mss = opts->mss;
+	tcp_backlog[empty_slot].send_wscale = context->tcp->send_wscale;
+	tcp_backlog[empty_slot].wscale_ok = context->tcp->wscale_ok;
+	tcp_backlog[empty_slot].sack_ok = context->tcp->sack_ok;
 
 	k_delayed_work_init(&tcp_backlog[empty_slot].ack_timer,
 			    backlog_ack_timeout);
@@ -1654,6 +2383,9 @@ static int tcp_backlog_ack(struct net_pkt *pkt, struct net_context *context)
 	context->tcp->send_seq = tcp_backlog[r].send_seq + 1;
 	context->tcp->send_ack = tcp_backlog[r].send_ack;
 	context->tcp->send_mss = tcp_backlog[r].send_mss;
+	context->tcp->send_wscale = tcp_backlog[r].send_wscale;
+	context->tcp->wscale_ok = tcp_backlog[r].wscale_ok;
+	context->tcp->sack_ok = tcp_backlog[r].sack_ok;
 
 	k_delayed_work_cancel(&tcp_backlog[r].ack_timer);
 	memset(&tcp_backlog[r], 0, sizeof(struct tcp_backlog_entry));
@@ -1717,6 +2449,22 @@ static void handle_ack_timeout(struct k_work *work)
 	}
 }
 
+#if defined(CONFIG_NET_TCP_DELAYED_ACK)
+static void handle_delayed_ack_timeout(struct k_work *work)
+{
+	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp,
+					   delayed_ack_timer);
+
+	if (!tcp->ack_delayed) {
+		return;
+	}
+
+	NET_DBG("Sending delayed ACK %u", tcp->send_ack);
+
+	send_ack(tcp->context, &tcp->context->remote, false);
+}
+#endif
+
 static void handle_timewait_timeout(struct k_work *work)
 {
 	struct net_tcp *tcp = CONTAINER_OF(work, struct net_tcp,
@@ -1748,6 +2496,10 @@ int net_tcp_get(struct net_context *context)
 	k_delayed_work_init(&context->tcp->fin_timer, handle_fin_timeout);
 	k_delayed_work_init(&context->tcp->timewait_timer,
 			    handle_timewait_timeout);
+#if defined(CONFIG_NET_TCP_DELAYED_ACK)
+	k_delayed_work_init(&context->tcp->delayed_ack_timer,
+			    handle_delayed_ack_timeout);
+#endif
 
 	return 0;
 }
@@ -1830,11 +2582,13 @@ static inline int send_syn_segment(struct net_context *context,
 {
 	struct net_pkt *pkt = NULL;
 	int ret;
-	u8_t options[NET_TCP_MAX_OPT_SIZE];
+	u8_t options[NET_TCP_MAX_HDR_OPT_SIZE];
 	u8_t optionlen = 0;
 
 	if (flags == NET_TCP_SYN) {
 		net_tcp_set_syn_opt(context->tcp, options, &optionlen);
+	} else if (flags & NET_TCP_SYN) {
+		net_tcp_set_syn_ext_opt(context->tcp, options, &optionlen);
 	}
 
 	ret = net_tcp_prepare_segment(context->tcp, flags, options, optionlen,
@@ -1923,6 +2677,192 @@ static int send_reset(struct net_context *context,
 	return ret;
 }
 
+static inline bool tcp_ooo_empty(struct net_tcp *tcp)
+{
+#if defined(CONFIG_NET_TCP_REASSEMBLY)
+	return sys_slist_is_empty(&tcp->ooo_list);
+#else
+	return true;
+#endif
+}
+
+#if defined(CONFIG_NET_TCP_REASSEMBLY)
+/* Keep a segment received after missing data. Only plain data segments
+ * that do not overlap the ones already queued are kept: anything else
+ * is left for the peer to retransmit.
+ */
+static bool tcp_ooo_queue(struct net_tcp *tcp, struct net_pkt *pkt,
+			  u32_t seq, u8_t tcp_flags)
+{
+	sys_snode_t *prev = NULL;
+	struct net_pkt *queued;
+	u16_t data_len;
+
+	if (net_tcp_get_state(tcp) != NET_TCP_ESTABLISHED ||
+	    (tcp_flags & ~NET_TCP_PSH) != NET_TCP_ACK ||
+	    tcp->ooo_count >= CONFIG_NET_TCP_REASSEMBLY_SEGMENTS) {
+		return false;
+	}
+
+	net_context_set_appdata_values(pkt, IPPROTO_TCP);
+
+	data_len = net_pkt_appdatalen(pkt);
+	if (!data_len ||
+	    seq - tcp->send_ack + data_len > net_tcp_get_recv_wnd(tcp)) {
+		return false;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&tcp->ooo_list, queued, sent_list) {
+		u32_t queued_seq = tcp_pkt_seq(queued);
+
+		if (net_tcp_seq_cmp(seq, queued_seq) < 0) {
+			if (net_tcp_seq_greater(seq + data_len, queued_seq)) {
+				return false;
+			}
+
+			break;
+		}
+
+		if (net_tcp_seq_greater(queued_seq +
+					net_pkt_appdatalen(queued), seq)) {
+			return false;
+		}
+
+		prev = &queued->sent_list;
+	}
+
+	/* Received packets are never in a sent list: reuse its node */
+	sys_slist_insert(&tcp->ooo_list, prev, &pkt->sent_list);
+	tcp->ooo_count++;
+	tcp->ooo_last_seq = seq;
+
+	NET_DBG("[%p] queued seq %u len %u (%u queued)", tcp, seq, data_len,
+		tcp->ooo_count);
+
+	return true;
+}
+
+/* Hand over the queued segments that the last received data made
+ * contiguous. Returns true if any was.
+ */
+static bool tcp_ooo_deliver(struct net_context *context,
+			    struct net_conn *conn)
+{
+	struct net_tcp *tcp = context->tcp;
+	bool delivered = false;
+	sys_snode_t *node;
+
+	while ((node = sys_slist_peek_head(&tcp->ooo_list))) {
+		struct net_pkt *pkt = CONTAINER_OF(node, struct net_pkt,
+						   sent_list);
+		u32_t seq = tcp_pkt_seq(pkt);
+		u16_t data_len = net_pkt_appdatalen(pkt);
+
+		if (net_tcp_seq_greater(seq, tcp->send_ack)) {
+			break;
+		}
+
+		sys_slist_remove(&tcp->ooo_list, NULL, node);
+		tcp->ooo_count--;
+
+		/* The data was received again with another segmentation */
+		if (seq != tcp->send_ack) {
+			net_pkt_unref(pkt);
+			continue;
+		}
+
+		if (net_context_packet_received(conn, pkt,
+						tcp->recv_user_data) ==
+		    NET_DROP) {
+			net_pkt_unref(pkt);
+		}
+
+		tcp->send_ack += data_len;
+		delivered = true;
+	}
+
+	return delivered;
+}
+#endif
+
+#if defined(CONFIG_NET_TCP_SACK)
+/* Record the data the peer holds above the cumulative ACK and, on the
+ * third duplicate ACK reporting some, retransmit the first segment it
+ * misses instead of waiting for the retransmission timer (RFC 6675).
+ */
+static void tcp_sack_received(struct net_tcp *tcp, struct net_pkt *pkt,
+			      struct net_tcp_hdr *tcp_hdr)
+{
+	struct net_tcp_options opts = { 0 };
+	u32_t ack = sys_get_be32(tcp_hdr->ack);
+	struct net_pkt *lost;
+	int opt_totlen;
+	int i;
+
+	if (!tcp->sack_ok) {
+		return;
+	}
+
+	opt_totlen = NET_TCP_HDR_LEN(tcp_hdr) - sizeof(struct net_tcp_hdr);
+	if (opt_totlen > 0 && net_tcp_parse_opts(pkt, opt_totlen, &opts) < 0) {
+		return;
+	}
+
+	tcp->sacked_count = 0;
+
+	for (i = 0; i < opts.sack_count; i++) {
+		/* Blocks below the cumulative ACK report duplicates */
+		if (net_tcp_seq_cmp(opts.sack[i].start, ack) >= 0) {
+			tcp->sacked[tcp->sacked_count++] = opts.sack[i];
+		}
+	}
+
+	if (!tcp->sacked_count || sys_slist_is_empty(&tcp->sent_list) ||
+	    tcp_pkt_seq(CONTAINER_OF(sys_slist_peek_head(&tcp->sent_list),
+				     struct net_pkt, sent_list)) != ack) {
+		tcp->dup_acks = 0;
+		return;
+	}
+
+	/* With congestion control, the core does the fast retransmit */
+	if (IS_ENABLED(CONFIG_NET_TCP_CONGESTION_CONTROL) ||
+	    ++tcp->dup_acks != 3) {
+		return;
+	}
+
+	lost = tcp_first_unsacked(tcp);
+	if (lost && net_pkt_sent(lost)) {
+		NET_DBG("[%p] SACK recovery of seq %u", tcp,
+			tcp_pkt_seq(lost));
+		tcp_retransmit(tcp, lost);
+	}
+}
+#endif
+
+/* Acknowledge the data received in a segment. With delayed ACKs, the
+ * first in-order data segment only arms the timer and the next one is
+ * acknowledged together with it, unless data sent meanwhile carried
+ * the ACK already.
+ */
+static int ack_received_data(struct net_context *context,
+			     struct sockaddr *remote, u16_t data_len,
+			     u8_t tcp_flags)
+{
+#if defined(CONFIG_NET_TCP_DELAYED_ACK)
+	struct net_tcp *tcp = context->tcp;
+
+	if (data_len && !(tcp_flags & NET_TCP_FIN) && !tcp->ack_delayed &&
+	    net_tcp_get_state(tcp) == NET_TCP_ESTABLISHED) {
+		tcp->ack_delayed = 1;
+		k_delayed_work_submit(&tcp->delayed_ack_timer,
+				      CONFIG_NET_TCP_DELAYED_ACK_TIMEOUT);
+		return 0;
+	}
+#endif
+
+	return send_ack(context, remote, false);
+}
+
 /* This is called when we receive data after the connection has been
  * established. The core TCP logic is located here.
  */
@@ -1951,6 +2891,37 @@ NET_CONN_CB(tcp_established)
 
 	tcp_flags = NET_TCP_FLAGS(tcp_hdr);
 
+	/* Header prediction: the next in-order data segment, that does not
+	 * acknowledge anything new while nothing is in flight, changes no
+	 * state and can be handed over to the application right away.
+	 */
+	if (net_tcp_get_state(context->tcp) == NET_TCP_ESTABLISHED &&
+	    (tcp_flags & ~NET_TCP_PSH) == NET_TCP_ACK &&
+	    sys_get_be32(tcp_hdr->seq) == context->tcp->send_ack &&
+	    sys_get_be32(tcp_hdr->ack) == context->tcp->send_seq &&
+	    sys_slist_is_empty(&context->tcp->sent_list) &&
+	    tcp_ooo_empty(context->tcp)) {
+		net_context_set_appdata_values(pkt, IPPROTO_TCP);
+
+		data_len = net_pkt_appdatalen(pkt);
+		if (data_len > 0 &&
+		    data_len <= net_tcp_get_recv_wnd(context->tcp)) {
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+			if (context->tcp->cc) {
+				tcp_update_send_wnd(context->tcp, tcp_hdr);
+			}
+#endif
+			ret = net_context_packet_received(conn, pkt,
+						context->tcp->recv_user_data);
+
+			context->tcp->send_ack += data_len;
+			ack_received_data(context, &conn->remote_addr,
+					  data_len, tcp_flags);
+
+			return ret;
+		}
+	}
+
 	if (net_tcp_seq_cmp(sys_get_be32(tcp_hdr->seq),
 			    context->tcp->send_ack) < 0) {
 		/* Peer sent us packet we've already seen. Apparently,
@@ -1967,9 +2938,16 @@ resend_ack:
 
 	if (net_tcp_seq_cmp(sys_get_be32(tcp_hdr->seq),
 			    context->tcp->send_ack) > 0) {
-		/* Don't try to reorder packets.  If it doesn't
-		 * match the next segment exactly, drop and wait for
-		 * retransmit
+#if defined(CONFIG_NET_TCP_REASSEMBLY)
+		if (tcp_ooo_queue(context->tcp, pkt,
+				  sys_get_be32(tcp_hdr->seq), tcp_flags)) {
+			/* RFC 5681 4.2: tell the peer about the hole */
+			send_ack(context, &conn->remote_addr, true);
+			return NET_OK;
+		}
+#endif
+		/* If it doesn't match the next segment exactly and
+		 * cannot be queued, drop and wait for retransmit
 		 */
 		return NET_DROP;
 	}
@@ -1999,13 +2977,32 @@ resend_ack:
 		return NET_DROP;
 	}
 
+	net_context_set_appdata_values(pkt, IPPROTO_TCP);
+
 	/* Handle TCP state transition */
 	if (tcp_flags & NET_TCP_ACK) {
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		u32_t una = tcp_send_una(context->tcp);
+#endif
+
+#if defined(CONFIG_NET_TCP_SACK)
+		tcp_sack_received(context->tcp, pkt, tcp_hdr);
+#endif
+
 		if (!net_tcp_ack_received(context,
 				     sys_get_be32(tcp_hdr->ack))) {
 			return NET_DROP;
 		}
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		tcp_cc_ack(context->tcp, tcp_hdr, una,
+			   !net_pkt_appdatalen(pkt) &&
+			   !(tcp_flags & NET_TCP_FIN));
+
+		/* The windows may let more data out now */
+		tcp_send_queued(context->tcp);
+#endif
+
 		/* TCP state might be changed after maintaining the sent pkt
 		 * list, e.g., an ack of FIN is received.
 		 */
@@ -2047,8 +3044,6 @@ resend_ack:
 		context->tcp->fin_rcvd = 1;
 	}
 
-	net_context_set_appdata_values(pkt, IPPROTO_TCP);
-
 	data_len = net_pkt_appdatalen(pkt);
 	if (data_len > net_tcp_get_recv_wnd(context->tcp)) {
 		/* In case we have zero window, we should still accept
@@ -2085,7 +3080,17 @@ resend_ack:
 		context->tcp->send_ack += 1;
 	}
 
-	send_ack(context, &conn->remote_addr, false);
+#if defined(CONFIG_NET_TCP_REASSEMBLY)
+	if (data_len > 0 && !(tcp_flags & NET_TCP_FIN) &&
+	    tcp_ooo_deliver(context, conn)) {
+		/* Filling a hole is acknowledged at once */
+		send_ack(context, &conn->remote_addr, false);
+	} else
+#endif
+	{
+		ack_received_data(context, &conn->remote_addr, data_len,
+				  tcp_flags);
+	}
 
 clean_up:
 	if (net_tcp_get_state(context->tcp) == NET_TCP_TIME_WAIT) {
@@ -2163,6 +3168,18 @@ NET_CONN_CB(tcp_synack_received)
 		 */
 		struct sockaddr local_addr;
 		struct sockaddr remote_addr;
+		struct net_tcp_options tcp_opts = {
+			.mss = NET_TCP_DEFAULT_MSS,
+		};
+		int opt_totlen;
+
+		opt_totlen = NET_TCP_HDR_LEN(tcp_hdr)
+			     - sizeof(struct net_tcp_hdr);
+		if (net_tcp_parse_opts(pkt, opt_totlen, &tcp_opts) < 0) {
+			return NET_DROP;
+		}
+
+		tcp_negotiate_opts(context->tcp, &tcp_opts);
 
 		if (net_pkt_get_src_addr(
 			pkt, &remote_addr, sizeof(remote_addr)) < 0) {
@@ -2251,6 +3268,18 @@ static inline void copy_pool_vars(struct net_context *new_context,
 #define copy_pool_vars(...)
 #endif /* CONFIG_NET_CONTEXT_NET_PKT_POOL */
 
+static inline void copy_buf_sizes(struct net_context *new_context,
+				  struct net_context *listen_context)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	new_context->options.rcvbuf = listen_context->options.rcvbuf;
+	new_context->tcp->recv_wnd = new_context->options.rcvbuf;
+#endif
+#if defined(CONFIG_NET_CONTEXT_SNDBUF)
+	new_context->options.sndbuf = listen_context->options.sndbuf;
+#endif
+}
+
 /* This callback is called when we are waiting connections and we receive
  * a packet. We need to check if we are receiving proper msg (SYN) here.
  * The ACK could also be received, in which case we have an established
@@ -2331,9 +3360,12 @@ NET_CONN_CB(tcp_syn_rcvd)
 		context->tcp->send_ack =
 			sys_get_be32(tcp_hdr->seq) + 1;
 
+		/* The SYN-ACK only offers what the peer supports */
+		tcp_negotiate_opts(context->tcp, &tcp_opts);
+
 		/* Get MSS from TCP options here*/
 
-		r = tcp_backlog_syn(pkt, context, tcp_opts.mss);
+		r = tcp_backlog_syn(pkt, context, &tcp_opts);
 		if (r < 0) {
 			if (r == -EADDRINUSE) {
 				NET_DBG("TCP connection already exists");
@@ -2437,6 +3469,7 @@ NET_CONN_CB(tcp_syn_rcvd)
 		 * must be listening to accept other connections.
 		 */
 		copy_pool_vars(new_context, context);
+		copy_buf_sizes(new_context, context);
 
 		net_tcp_change_state(tcp, NET_TCP_LISTEN);
 
@@ -2445,6 +3478,10 @@ NET_CONN_CB(tcp_syn_rcvd)
 		 */
 		new_context->tcp->state = NET_TCP_ESTABLISHED;
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+		tcp_cc_init(new_context->tcp);
+#endif
+
 		net_context_set_state(new_context, NET_CONTEXT_CONNECTED);
 
 		if (new_context->remote.sa_family == AF_INET) {
@@ -0,0 +1,118 @@
+/** @file
+ @brief TCP congestion control algorithms
+
+ This is not to be included by the application.
+ */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __TCP_CC_H
+#define __TCP_CC_H
+
+#include <zephyr/types.h>
+
+#include "tcp_internal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Congestion control algorithm
+ *
+ * The TCP core does the loss detection, fast retransmit and NewReno
+ * fast recovery (RFC 6582) for all the algorithms: they only decide how
+ * the congestion window grows and how much it shrinks after a loss.
+ * Their private state lives in net_tcp.cc_data.
+ */
+struct net_tcp_cc {
+	/** Name of the algorithm */
+	const char *name;
+
+	/** Set up the state of a connection that gets established */
+	void (*init)(struct net_tcp *tcp);
+
+	/** New data was acknowledged outside of loss recovery */
+	void (*cong_avoid)(struct net_tcp *tcp, u32_t acked);
+
+	/** A loss was detected: return the new slow start threshold */
+	u32_t (*ssthresh)(struct net_tcp *tcp, u32_t flight_size);
+};
+
+extern const struct net_tcp_cc net_tcp_cc_newreno;
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+extern const struct net_tcp_cc net_tcp_cc_cubic;
+
+/** Integer cube root, rounded down */
+u32_t net_tcp_cc_cubic_root(u64_t a);
+#endif
+
+/* RFC 5681 3.1: slow start grows by at most one segment per ACK */
+static inline void net_tcp_cc_slow_start(struct net_tcp *tcp, u32_t acked)
+{
+	tcp->cwnd += min(acked, tcp->send_mss);
+}
+
+/* RFC 6298 2.2 and 2.3 with srtt scaled by 8 and rttvar by 4 */
+static inline void net_tcp_cc_rtt_update(struct net_tcp *tcp, u32_t rtt)
+{
+	s32_t delta;
+
+	rtt = max(rtt, 1);
+
+	if (!tcp->srtt) {
+		tcp->srtt = rtt << 3;
+		tcp->rttvar = rtt << 1;
+		return;
+	}
+
+	delta = rtt - (tcp->srtt >> 3);
+	tcp->srtt += delta;
+
+	if (delta < 0) {
+		delta = -delta;
+	}
+
+	tcp->rttvar += delta - (tcp->rttvar >> 2);
+}
+
+/* Fast retransmit, RFC 6582 3.2 step 2: una is the oldest unacknowledged
+ * sequence number and flight_size the data outstanding.
+ */
+static inline void net_tcp_cc_fast_rexmit(struct net_tcp *tcp, u32_t una,
+					  u32_t flight_size)
+{
+	tcp->ssthresh = tcp->cc->ssthresh(tcp, flight_size);
+	tcp->cwnd = tcp->ssthresh + 3 * tcp->send_mss;
+	tcp->recover = una + flight_size;
+	tcp->in_recovery = 1;
+	tcp->fast_rexmits++;
+}
+
+/* Retransmission timeout: RFC 5681 equation (4) only applies the first
+ * time a segment is sent again.
+ */
+static inline void net_tcp_cc_rto(struct net_tcp *tcp, u32_t una,
+				  u32_t flight_size, bool first)
+{
+	if (first) {
+		tcp->ssthresh = tcp->cc->ssthresh(tcp, flight_size);
+		tcp->timeouts++;
+	}
+
+	tcp->cwnd = tcp->send_mss;
+	tcp->recover = una + flight_size;
+	tcp->in_recovery = 0;
+	tcp->cc_dup_acks = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TCP_CC_H */
@@ -0,0 +1,168 @@
+/** @file
+ * @brief TCP CUBIC congestion control
+ *
+ * Window growth of RFC 8312: after a loss the window follows a cubic
+ * function of the time elapsed, coming back quickly close to the window
+ * where the loss happened, staying there and then probing for more
+ * bandwidth. The growth is never slower than what NewReno would get
+ * (the TCP-friendly region).
+ *
+ * Windows are in bytes and times in milliseconds.
+ */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+
+#include "tcp_cc.h"
+
+/* Multiplicative decrease factor beta, in tenths */
+#define CUBIC_BETA 7
+
+/* W_cubic(t) = C * (t - K)^3 + W_max with C = 0.4 segment/s^3: with t in
+ * ms and W in bytes, C * mss * t^3 = 4 * mss * t^3 / CUBIC_C_DIV.
+ */
+#define CUBIC_C_DIV 10000000000LL
+
+/* Bound of |t - K| in ms, keeping the cube within 64 bits */
+#define CUBIC_MAX_DELTA 30000
+
+struct cubic {
+	/* Window before the last reduction */
+	u32_t w_max;
+	/* Start of the current congestion avoidance epoch, 0 if none */
+	u32_t epoch_start;
+	/* Time to grow back to origin */
+	u32_t k;
+	/* Window at the plateau of the cubic function */
+	u32_t origin;
+};
+
+BUILD_ASSERT(sizeof(struct cubic) <=
+	     sizeof(((struct net_tcp *)0)->cc_data));
+
+static inline struct cubic *cubic_get(struct net_tcp *tcp)
+{
+	return (struct cubic *)tcp->cc_data;
+}
+
+/* Bit by bit */
+u32_t net_tcp_cc_cubic_root(u64_t a)
+{
+	u64_t y = 0;
+	int s;
+
+	for (s = 63; s >= 0; s -= 3) {
+		u64_t b;
+
+		y <<= 1;
+		b = 3 * y * (y + 1) + 1;
+		if ((a >> s) >= b) {
+			a -= b << s;
+			y++;
+		}
+	}
+
+	return y;
+}
+
+static void cubic_init(struct net_tcp *tcp)
+{
+	struct cubic *ca = cubic_get(tcp);
+
+	ca->w_max = 0;
+	ca->epoch_start = 0;
+	ca->k = 0;
+	ca->origin = 0;
+}
+
+static u32_t cubic_target(struct net_tcp *tcp, u32_t now)
+{
+	struct cubic *ca = cubic_get(tcp);
+	u32_t rtt = tcp->srtt >> 3;
+	s64_t t, target;
+
+	/* The window a RTT from now */
+	t = (s64_t)(now - ca->epoch_start + rtt) - ca->k;
+	t = max(min(t, CUBIC_MAX_DELTA), -CUBIC_MAX_DELTA);
+
+	target = ca->origin + 4 * tcp->send_mss * t * t * t / CUBIC_C_DIV;
+
+	/* TCP-friendly window, equation (4) of RFC 8312 with beta = 0.7 */
+	if (rtt) {
+		s64_t w_est = (s64_t)ca->w_max * CUBIC_BETA / 10 +
+			(s64_t)529 * tcp->send_mss *
+			(now - ca->epoch_start) / (1000 * rtt);
+
+		target = max(target, w_est);
+	}
+
+	return max(target, (s64_t)tcp->send_mss);
+}
+
+static void cubic_cong_avoid(struct net_tcp *tcp, u32_t acked)
+{
+	struct cubic *ca = cubic_get(tcp);
+	u32_t now = k_uptime_get_32();
+	u32_t target;
+
+	if (tcp->cwnd < tcp->ssthresh) {
+		net_tcp_cc_slow_start(tcp, acked);
+		return;
+	}
+
+	if (!ca->epoch_start) {
+		ca->epoch_start = now ? now : 1;
+
+		if (tcp->cwnd < ca->w_max) {
+			/* K = cbrt((W_max - cwnd) / C), in ms */
+			ca->k = net_tcp_cc_cubic_root(
+				(u64_t)(ca->w_max - tcp->cwnd) *
+				(CUBIC_C_DIV / 4) / tcp->send_mss);
+			ca->origin = ca->w_max;
+		} else {
+			ca->k = 0;
+			ca->origin = tcp->cwnd;
+		}
+	}
+
+	target = cubic_target(tcp, now);
+	if (target > tcp->cwnd) {
+		/* (target - cwnd) / cwnd segments per segment acked, never
+		 * faster than slow start
+		 */
+		tcp->cwnd += min((u64_t)(target - tcp->cwnd) * acked /
+				 tcp->cwnd, acked);
+	}
+}
+
+static u32_t cubic_ssthresh(struct net_tcp *tcp, u32_t flight_size)
+{
+	struct cubic *ca = cubic_get(tcp);
+
+	ARG_UNUSED(flight_size);
+
+	ca->epoch_start = 0;
+
+	/* Fast convergence: release bandwidth to newer flows when the
+	 * losses happen before the previous maximum is reached.
+	 */
+	if (tcp->cwnd < ca->w_max) {
+		ca->w_max = (u64_t)tcp->cwnd * (10 + CUBIC_BETA) / 20;
+	} else {
+		ca->w_max = tcp->cwnd;
+	}
+
+	return max((u64_t)tcp->cwnd * CUBIC_BETA / 10, 2 * tcp->send_mss);
+}
+
+const struct net_tcp_cc net_tcp_cc_cubic = {
+	.name = "cubic",
+	.init = cubic_init,
+	.cong_avoid = cubic_cong_avoid,
+	.ssthresh = cubic_ssthresh,
+};
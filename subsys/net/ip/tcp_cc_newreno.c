@@ -0,0 +1,54 @@
+/** @file
+ * @brief TCP NewReno congestion control
+ *
+ * Congestion avoidance of RFC 5681, the fast recovery being done by the
+ * TCP core.
+ */
+
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <kernel.h>
+
+#include "tcp_cc.h"
+
+/* Bytes acknowledged since the window last grew */
+#define bytes_acked(tcp) ((tcp)->cc_data[0])
+
+static void newreno_init(struct net_tcp *tcp)
+{
+	bytes_acked(tcp) = 0;
+}
+
+static void newreno_cong_avoid(struct net_tcp *tcp, u32_t acked)
+{
+	if (tcp->cwnd < tcp->ssthresh) {
+		net_tcp_cc_slow_start(tcp, acked);
+		return;
+	}
+
+	/* One segment more per window of acknowledged data */
+	bytes_acked(tcp) += acked;
+	if (bytes_acked(tcp) >= tcp->cwnd) {
+		bytes_acked(tcp) -= tcp->cwnd;
+		tcp->cwnd += tcp->send_mss;
+	}
+}
+
+static u32_t newreno_ssthresh(struct net_tcp *tcp, u32_t flight_size)
+{
+	bytes_acked(tcp) = 0;
+
+	/* RFC 5681 equation (4) */
+	return max(flight_size / 2, 2 * tcp->send_mss);
+}
+
+const struct net_tcp_cc net_tcp_cc_newreno = {
+	.name = "newreno",
+	.init = newreno_init,
+	.cong_avoid = newreno_cong_avoid,
+	.ssthresh = newreno_ssthresh,
+};
@@ -84,26 +84,60 @@ enum net_tcp_state {
 /* TCP max window size */
 #define NET_TCP_MAX_WIN   (4 * 1024)
 
+/* Largest receive window that can be advertised */
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+#define NET_TCP_MAX_RECV_WND (UINT16_MAX << 14)
+#else
+#define NET_TCP_MAX_RECV_WND UINT16_MAX
+#endif
+
 /* Maximal value of the sequence number */
 #define NET_TCP_MAX_SEQ   0xffffffff
 
+/* Options space reserved in data segments */
 #define NET_TCP_MAX_OPT_SIZE  8
 
+/* Maximal options length of any segment */
+#define NET_TCP_MAX_HDR_OPT_SIZE 40
+
 /* TCP Option codes */
 #define NET_TCP_END_OPT          0
 #define NET_TCP_NOP_OPT          1
 #define NET_TCP_MSS_OPT          2
 #define NET_TCP_WINDOW_SCALE_OPT 3
+#define NET_TCP_SACK_PERM_OPT    4
+#define NET_TCP_SACK_OPT         5
 
 /* TCP Option sizes */
 #define NET_TCP_END_SIZE          1
 #define NET_TCP_NOP_SIZE          1
 #define NET_TCP_MSS_SIZE          4
 #define NET_TCP_WINDOW_SCALE_SIZE 3
+#define NET_TCP_SACK_PERM_SIZE    2
+#define NET_TCP_SACK_BLOCK_SIZE   8
+
+/* RFC 7323 2.3: the shift count must not be larger than 14 */
+#define NET_TCP_MAX_WINDOW_SCALE 14
+
+/* SACK blocks fitting in the option space without timestamps */
+#define NET_TCP_SACK_BLOCKS 4
+
+/** Range of sequence numbers selectively acknowledged, end excluded */
+struct net_tcp_sack_block {
+	u32_t start;
+	u32_t end;
+};
 
 /** Parsed TCP option values for net_tcp_parse_opts()  */
 struct net_tcp_options {
 	u16_t mss;
+	/** Window scale shift, if wscale_set */
+	u8_t wscale;
+	u8_t wscale_set : 1;
+	u8_t sack_perm : 1;
+	/** Number of SACK blocks */
+	u8_t sack_count;
+	struct net_tcp_sack_block sack[NET_TCP_SACK_BLOCKS];
 };
 
 /* Max received bytes to buffer internally */
@@ -113,6 +147,7 @@ struct net_tcp_options {
 #define NET_TCP_MAX_SEG_LIFETIME 60
 
 struct net_context;
+struct net_tcp_cc;
 
 struct net_tcp {
 	/** Network context back pointer. */
@@ -133,6 +168,78 @@ struct net_tcp {
 	/** TIME_WAIT timer */
 	struct k_delayed_work timewait_timer;
 
+#if defined(CONFIG_NET_TCP_DELAYED_ACK)
+	/** Delayed ACK timer */
+	struct k_delayed_work delayed_ack_timer;
+#endif
+
+#if defined(CONFIG_NET_TCP_REASSEMBLY)
+	/** Received segments waiting for the missing data before them,
+	 * sorted by sequence number.
+	 */
+	sys_slist_t ooo_list;
+
+	/** Sequence number of the last segment queued in ooo_list */
+	u32_t ooo_last_seq;
+
+	/** Number of segments in ooo_list */
+	u8_t ooo_count;
+#endif
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+	/** Congestion control algorithm */
+	const struct net_tcp_cc *cc;
+
+	/** Private state of the congestion control algorithm */
+	u32_t cc_data[4];
+
+	/** Congestion window, in bytes */
+	u32_t cwnd;
+
+	/** Slow start threshold, in bytes */
+	u32_t ssthresh;
+
+	/** Receive window of the peer, in bytes */
+	u32_t send_wnd;
+
+	/** Last sequence number sent when the loss recovery started */
+	u32_t recover;
+
+	/** Sequence number whose ACK ends the RTT measurement */
+	u32_t rtt_seq;
+
+	/** Uptime when the measured segment was sent */
+	u32_t rtt_start;
+
+	/** Smoothed RTT in 1/8 ms and its variation in 1/4 ms */
+	u32_t srtt;
+	u32_t rttvar;
+
+	/** Number of fast retransmits and retransmission timeouts */
+	u32_t fast_rexmits;
+	u32_t timeouts;
+
+	/** Duplicate ACKs received in a row */
+	u8_t cc_dup_acks;
+
+	/** In fast recovery */
+	u8_t in_recovery : 1;
+
+	/** A RTT measurement is ongoing */
+	u8_t rtt_timing : 1;
+#endif
+
+#if defined(CONFIG_NET_TCP_SACK)
+	/** Data above the cumulative ACK the peer reported as received */
+	struct net_tcp_sack_block sacked[NET_TCP_SACK_BLOCKS];
+
+	/** Number of valid blocks in sacked */
+	u8_t sacked_count;
+
+	/** Duplicate ACKs carrying SACK information in a row */
+	u8_t dup_acks;
+#endif
+
 	/** List pointer used for TCP retransmit buffering */
 	sys_slist_t sent_list;
 
@@ -155,8 +262,14 @@ struct net_tcp {
 	u32_t fin_sent : 1;
 	/* An inbound FIN packet has been received */
 	u32_t fin_rcvd : 1;
+	/* Received data is waiting for a delayed ACK */
+	u32_t ack_delayed : 1;
+	/* Window scaling is offered, or agreed once established */
+	u32_t wscale_ok : 1;
+	/* SACK is offered, or agreed once established */
+	u32_t sack_ok : 1;
 	/** Remaining bits in this u32_t */
-	u32_t _padding : 13;
+	u32_t _padding : 10;
 
 	/** Accept callback to be called when the connection has been
 	 * established.
@@ -171,7 +284,13 @@ struct net_tcp {
 	/**
 	 * Current TCP receive window for our side
 	 */
-	u16_t recv_wnd;
+	u32_t recv_wnd;
+
+	/**
+	 * Window scale shift of our side and of the peer
+	 */
+	u8_t recv_wscale;
+	u8_t send_wscale;
 
 	/**
 	 * Send MSS for the peer
@@ -374,6 +493,25 @@ bool net_tcp_ack_received(struct net_context *ctx, u32_t ack);
  */
 u16_t net_tcp_get_recv_mss(const struct net_tcp *tcp);
 
+#if defined(CONFIG_NET_TCP_TSO)
+/**
+ * @brief Tells if TCP data sent through an interface can be queued in
+ * packets larger than a segment
+ *
+ * @param iface Network interface
+ *
+ * @return True if the packets are split into segments by the driver or
+ * the stack when sent.
+ */
+bool net_tcp_tso_enabled(struct net_if *iface);
+#else
+static inline bool net_tcp_tso_enabled(struct net_if *iface)
+{
+	ARG_UNUSED(iface);
+	return false;
+}
+#endif
+
 /**
  * @brief Returns the receive window for a given TCP context
  *
@@ -178,26 +178,18 @@ struct net_udp_hdr *net_udp_get_hdr(struct net_pkt *pkt,
 				    struct net_udp_hdr *hdr)
 {
 	struct net_udp_hdr *udp_hdr;
-	struct net_buf *frag;
-	u16_t pos;
+	struct net_pkt_cursor cursor;
 
 	udp_hdr = net_pkt_udp_data(pkt);
 	if (net_udp_header_fits(pkt, udp_hdr)) {
 		return udp_hdr;
 	}
 
-	frag = net_frag_read(pkt->frags, net_pkt_ip_hdr_len(pkt) +
-			     net_pkt_ipv6_ext_len(pkt),
-			     &pos, sizeof(hdr->src_port),
-			     (u8_t *)&hdr->src_port);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->dst_port),
-			     (u8_t *)&hdr->dst_port);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->len),
-			     (u8_t *)&hdr->len);
-	frag = net_frag_read(frag, pos, &pos, sizeof(hdr->chksum),
-			     (u8_t *)&hdr->chksum);
-	if (!frag) {
-		NET_ASSERT(frag);
+	/* the header is packed: read it at once across the fragments */
+	if (net_pkt_cursor_init(pkt, &cursor, net_pkt_ip_hdr_len(pkt) +
+				net_pkt_ipv6_ext_len(pkt)) ||
+	    net_pkt_cursor_read(&cursor, hdr, NET_UDPH_LEN)) {
+		NET_ASSERT_INFO(false, "Truncated UDP header");
 		return NULL;
 	}
 
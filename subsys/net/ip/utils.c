@@ -373,31 +373,60 @@ int net_addr_pton(sa_family_t family, const char *src,
 	return 0;
 }
 
+static inline u16_t chksum_fold(u32_t sum)
+{
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return sum;
+}
+
+static inline u16_t chksum_add(u16_t sum, u16_t value)
+{
+	return chksum_fold((u32_t)sum + value);
+}
+
+/* Add the data, as big endian 16 bit words, to a ones' complement sum.
+ * The words are loaded 32 bits at a time in CPU byte order: the sum of
+ * byte swapped words is the byte swapped sum (RFC 1071, section 2), so
+ * converting the result once at the end is enough.
+ */
 static u16_t calc_chksum(u16_t sum, const u8_t *ptr, u16_t len)
 {
-	u16_t tmp;
-	const u8_t *end;
+	u64_t acc = 0;
 
-	end = ptr + len - 1;
+	while (len >= 16) {
+		acc += UNALIGNED_GET((u32_t *)ptr);
+		acc += UNALIGNED_GET((u32_t *)(ptr + 4));
+		acc += UNALIGNED_GET((u32_t *)(ptr + 8));
+		acc += UNALIGNED_GET((u32_t *)(ptr + 12));
+		ptr += 16;
+		len -= 16;
+	}
 
-	while (ptr < end) {
-		tmp = (ptr[0] << 8) + ptr[1];
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	while (len >= 4) {
+		acc += UNALIGNED_GET((u32_t *)ptr);
+		ptr += 4;
+		len -= 4;
+	}
+
+	if (len >= 2) {
+		acc += UNALIGNED_GET((u16_t *)ptr);
 		ptr += 2;
+		len -= 2;
 	}
 
-	if (ptr == end) {
-		tmp = ptr[0] << 8;
-		sum += tmp;
-		if (sum < tmp) {
-			sum++;
-		}
+	if (len) {
+		/* odd byte: pad the last word with a zero */
+		u8_t last[2] = { ptr[0], 0 };
+
+		acc += UNALIGNED_GET((u16_t *)last);
 	}
 
-	return sum;
+	acc = (acc & 0xffffffff) + (acc >> 32);
+	acc = (acc & 0xffffffff) + (acc >> 32);
+
+	return chksum_add(sum, ntohs(chksum_fold(acc)));
 }
 
 static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
@@ -406,8 +435,9 @@ static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
 	u16_t proto_len = net_pkt_ip_hdr_len(pkt) +
 		net_pkt_ipv6_ext_len(pkt);
 	struct net_buf *frag;
+	bool odd = false;
 	u16_t offset;
-	s16_t len;
+	u16_t len;
 	u8_t *ptr;
 
 	ARG_UNUSED(upper_layer_len);
@@ -425,26 +455,25 @@ static inline u16_t calc_chksum_pkt(u16_t sum, struct net_pkt *pkt,
 	len = frag->len - offset;
 
 	while (frag) {
-		sum = calc_chksum(sum, ptr, len);
+		u16_t part = calc_chksum(0, ptr, len);
+
+		/* A fragment starting at an odd offset has its bytes in
+		 * swapped positions in the words of the packet.
+		 */
+		if (odd) {
+			part = (part << 8) | (part >> 8);
+		}
+
+		sum = chksum_add(sum, part);
+		odd ^= len & 1;
+
 		frag = frag->frags;
 		if (!frag) {
 			break;
 		}
 
 		ptr = frag->data;
-
-		/* Do we need to take first byte from next fragment */
-		if (len % 2) {
-			u16_t tmp = *ptr;
-			sum += tmp;
-			if (sum < tmp) {
-				sum++;
-			}
-			len = frag->len - 1;
-			ptr++;
-		} else {
-			len = frag->len;
-		}
+		len = frag->len;
 	}
 
 	return sum;
@@ -491,6 +520,13 @@ u16_t net_calc_chksum(struct net_pkt *pkt, u8_t proto)
 	return sum;
 }
 
+u16_t net_calc_chksum_update(u16_t chksum, u16_t old_val, u16_t new_val)
+{
+	/* RFC 1624: HC' = ~(~HC + ~m + m') */
+	return ~chksum_fold((u32_t)(u16_t)~chksum + (u16_t)~old_val +
+			    new_val);
+}
+
 #if defined(CONFIG_NET_IPV4)
 u16_t net_calc_chksum_ipv4(struct net_pkt *pkt)
 {
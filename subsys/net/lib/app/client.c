@@ -941,3 +941,163 @@ int net_app_client_tls(struct net_app_ctx *ctx,
 	return 0;
 }
 #endif /* CONFIG_NET_APP_TLS || CONFIG_NET_APP_DTLS */
+
+#if defined(CONFIG_NET_APP_TLS_SESSION_CACHE)
+/* Sessions negotiated with the peers, offered again on reconnection. They
+ * outlive the net_app contexts, which are released on disconnection.
+ */
+struct tls_session_entry {
+	struct sockaddr peer;
+	mbedtls_ssl_session session;
+	u32_t last_used;
+	bool valid;
+};
+
+static struct tls_session_entry
+	tls_sessions[CONFIG_NET_APP_TLS_SESSION_CACHE_SIZE];
+static K_MUTEX_DEFINE(tls_sessions_lock);
+
+static bool peer_equal(const struct sockaddr *a, const struct sockaddr *b)
+{
+	if (a->sa_family != b->sa_family) {
+		return false;
+	}
+
+#if defined(CONFIG_NET_IPV6)
+	if (a->sa_family == AF_INET6) {
+		return net_sin6(a)->sin6_port == net_sin6(b)->sin6_port &&
+		       net_ipv6_addr_cmp(&net_sin6(a)->sin6_addr,
+					 &net_sin6(b)->sin6_addr);
+	}
+#endif
+
+#if defined(CONFIG_NET_IPV4)
+	if (a->sa_family == AF_INET) {
+		return net_sin(a)->sin_port == net_sin(b)->sin_port &&
+		       net_ipv4_addr_cmp(&net_sin(a)->sin_addr,
+					 &net_sin(b)->sin_addr);
+	}
+#endif
+
+	return false;
+}
+
+static struct tls_session_entry *tls_session_find(struct net_app_ctx *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(tls_sessions); i++) {
+		if (tls_sessions[i].valid &&
+		    peer_equal(&tls_sessions[i].peer,
+			       &ctx->default_ctx->remote)) {
+			return &tls_sessions[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void tls_session_free(struct tls_session_entry *entry)
+{
+	mbedtls_ssl_session_free(&entry->session);
+	entry->valid = false;
+}
+
+void _net_app_tls_session_load(struct net_app_ctx *ctx)
+{
+	struct tls_session_entry *entry;
+	int ret;
+
+	k_mutex_lock(&tls_sessions_lock, K_FOREVER);
+
+	entry = tls_session_find(ctx);
+	if (entry) {
+		ret = mbedtls_ssl_set_session(&ctx->tls.mbedtls.ssl,
+					      &entry->session);
+		if (ret != 0) {
+			_net_app_print_error("mbedtls_ssl_set_session "
+					     "returned -0x%x", ret);
+		} else {
+			NET_DBG("Offering cached TLS session");
+			entry->last_used = k_uptime_get_32();
+		}
+	}
+
+	k_mutex_unlock(&tls_sessions_lock);
+}
+
+void _net_app_tls_session_save(struct net_app_ctx *ctx)
+{
+	struct tls_session_entry *entry;
+	int ret, i;
+
+	k_mutex_lock(&tls_sessions_lock, K_FOREVER);
+
+	entry = tls_session_find(ctx);
+	if (!entry) {
+		/* Take a free entry, or the least recently used one */
+		entry = &tls_sessions[0];
+
+		for (i = 0; i < ARRAY_SIZE(tls_sessions); i++) {
+			if (!tls_sessions[i].valid) {
+				entry = &tls_sessions[i];
+				break;
+			}
+
+			if ((s32_t)(tls_sessions[i].last_used -
+				    entry->last_used) < 0) {
+				entry = &tls_sessions[i];
+			}
+		}
+	}
+
+	if (entry->valid) {
+		tls_session_free(entry);
+	}
+
+	mbedtls_ssl_session_init(&entry->session);
+
+	ret = mbedtls_ssl_get_session(&ctx->tls.mbedtls.ssl, &entry->session);
+	if (ret != 0) {
+		_net_app_print_error("mbedtls_ssl_get_session returned -0x%x",
+				     ret);
+		mbedtls_ssl_session_free(&entry->session);
+	} else {
+		memcpy(&entry->peer, &ctx->default_ctx->remote,
+		       sizeof(entry->peer));
+		entry->last_used = k_uptime_get_32();
+		entry->valid = true;
+	}
+
+	k_mutex_unlock(&tls_sessions_lock);
+}
+
+void _net_app_tls_session_drop(struct net_app_ctx *ctx)
+{
+	struct tls_session_entry *entry;
+
+	k_mutex_lock(&tls_sessions_lock, K_FOREVER);
+
+	entry = tls_session_find(ctx);
+	if (entry) {
+		tls_session_free(entry);
+	}
+
+	k_mutex_unlock(&tls_sessions_lock);
+}
+
+void net_app_client_tls_sessions_clear(void)
+{
+	int i;
+
+	k_mutex_lock(&tls_sessions_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(tls_sessions); i++) {
+		if (tls_sessions[i].valid) {
+			tls_session_free(&tls_sessions[i]);
+		}
+	}
+
+	k_mutex_unlock(&tls_sessions_lock);
+}
+#endif /* CONFIG_NET_APP_TLS_SESSION_CACHE */
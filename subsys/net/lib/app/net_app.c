@@ -43,6 +43,19 @@
 #define DTLS_TIMEOUT K_SECONDS(15)
 #endif
 
+#if defined(CONFIG_NET_APP_TLS_SESSION_TICKETS)
+#if !defined(MBEDTLS_SSL_SESSION_TICKETS) || !defined(MBEDTLS_SSL_TICKET_C)
+#error "Session tickets are not enabled in the mbedtls configuration"
+#endif
+
+/* Tickets are protected with an AEAD cipher, use the one mbedtls has */
+#if defined(MBEDTLS_GCM_C)
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_AES_128_GCM
+#else
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_AES_128_CCM
+#endif
+#endif /* CONFIG_NET_APP_TLS_SESSION_TICKETS */
+
 #if defined(CONFIG_NET_DEBUG_APP)
 static sys_slist_t _net_app_instances;
 
@@ -1218,6 +1231,89 @@ int _net_app_tls_trigger_close(struct net_app_ctx *ctx)
 	return 0;
 }
 
+#if defined(CONFIG_NET_APP_DTLS_COALESCE)
+/* Send the datagram of coalesced DTLS records, if any */
+static int dtls_tx_flush(struct net_app_ctx *ctx)
+{
+	struct net_pkt *pkt = ctx->dtls.tx_pkt;
+	int ret;
+
+	if (!pkt) {
+		return 0;
+	}
+
+	ctx->dtls.tx_pkt = NULL;
+
+	if (!ctx->dtls.ctx) {
+		net_pkt_unref(pkt);
+		return -ENOTCONN;
+	}
+
+	ret = net_context_sendto(pkt, &ctx->dtls.ctx->remote,
+				 sizeof(ctx->dtls.ctx->remote),
+				 ssl_sent, K_NO_WAIT, NULL, ctx);
+	if (ret < 0) {
+		net_pkt_unref(pkt);
+		return ret;
+	}
+
+	k_sem_take(&ctx->tls.mbedtls.ssl_ctx.tx_sem, K_FOREVER);
+
+	return 0;
+}
+
+/* Add a DTLS record to the datagram being built, return false if the
+ * record is to be sent on its own.
+ */
+static bool dtls_tx_coalesce(struct net_app_ctx *ctx,
+			     const unsigned char *buf, size_t size)
+{
+	size_t added;
+
+	if (!ctx->tls.tx_coalesce ||
+	    size > CONFIG_NET_APP_DTLS_COALESCE_SIZE) {
+		dtls_tx_flush(ctx);
+		return false;
+	}
+
+	if (ctx->dtls.tx_pkt && net_pkt_get_len(ctx->dtls.tx_pkt) + size >
+	    CONFIG_NET_APP_DTLS_COALESCE_SIZE) {
+		dtls_tx_flush(ctx);
+	}
+
+	if (!ctx->dtls.tx_pkt) {
+		ctx->dtls.tx_pkt = net_app_get_net_pkt(ctx, AF_UNSPEC,
+						       BUF_ALLOC_TIMEOUT);
+		if (!ctx->dtls.tx_pkt) {
+			return false;
+		}
+	}
+
+	added = net_pkt_append(ctx->dtls.tx_pkt, size, (u8_t *)buf,
+			       BUF_ALLOC_TIMEOUT);
+	if (added != size) {
+		/* A partial record cannot be sent, the datagram is lost just
+		 * as if the network dropped it.
+		 */
+		NET_DBG("Out of buffers, coalesced records dropped");
+		net_pkt_unref(ctx->dtls.tx_pkt);
+		ctx->dtls.tx_pkt = NULL;
+	}
+
+	return true;
+}
+
+/* Is the next message in the fifo to be sent too */
+static bool dtls_tx_more_queued(struct net_app_ctx *ctx)
+{
+	struct net_app_fifo_block *next;
+
+	next = k_fifo_peek_head(&ctx->tls.mbedtls.ssl_ctx.tx_rx_fifo);
+
+	return next && next->pkt && next->dir == NET_APP_PKT_TX;
+}
+#endif /* CONFIG_NET_APP_DTLS_COALESCE */
+
 /* Send encrypted data */
 int _net_app_ssl_tx(void *context, const unsigned char *buf, size_t size)
 {
@@ -1226,6 +1322,13 @@ int _net_app_ssl_tx(void *context, const unsigned char *buf, size_t size)
 	size_t sent = 0;
 	int ret, len = 0;
 
+#if defined(CONFIG_NET_APP_DTLS_COALESCE)
+	/* Each call carries one whole DTLS record */
+	if (ctx->proto == IPPROTO_UDP && dtls_tx_coalesce(ctx, buf, size)) {
+		return size;
+	}
+#endif
+
 	while (size) {
 		send_buf = net_app_get_net_pkt(ctx, AF_UNSPEC,
 					       BUF_ALLOC_TIMEOUT);
@@ -1796,8 +1899,18 @@ int _net_app_ssl_mux(void *context, unsigned char *buf, size_t size)
 		 * to send it here and then go back waiting more data.
 		 */
 		if (rx_data->dir == NET_APP_PKT_TX) {
+#if defined(CONFIG_NET_APP_DTLS_COALESCE)
+			ctx->tls.tx_coalesce = (ctx->proto == IPPROTO_UDP);
+#endif
 			tls_sendto(ctx, rx_data);
 			k_mem_pool_free(&rx_data->block);
+#if defined(CONFIG_NET_APP_DTLS_COALESCE)
+			ctx->tls.tx_coalesce = false;
+
+			if (!dtls_tx_more_queued(ctx)) {
+				dtls_tx_flush(ctx);
+			}
+#endif
 			goto again;
 		}
 
@@ -1977,6 +2090,12 @@ reset:
 	mbedtls_ssl_set_bio(&ctx->tls.mbedtls.ssl, ctx,
 			    _net_app_ssl_tx, _net_app_ssl_mux, NULL);
 
+#if defined(CONFIG_NET_APP_TLS_SESSION_CACHE)
+	if (ctx->app_type == NET_APP_CLIENT) {
+		_net_app_tls_session_load(ctx);
+	}
+#endif
+
 	/* SSL handshake. The ssl_rx() function will be called next by
 	 * mbedtls library. The ssl_rx() will block and wait that data is
 	 * received by ssl_received() and passed to it via fifo. After
@@ -2003,6 +2122,14 @@ reset:
 			}
 
 			if (ret < 0) {
+#if defined(CONFIG_NET_APP_TLS_SESSION_CACHE)
+				/* Do not offer a possibly stale session
+				 * again.
+				 */
+				if (ctx->app_type == NET_APP_CLIENT) {
+					_net_app_tls_session_drop(ctx);
+				}
+#endif
 				goto close;
 			}
 		}
@@ -2012,6 +2139,12 @@ reset:
 
 	NET_DBG("TLS handshake done");
 
+#if defined(CONFIG_NET_APP_TLS_SESSION_CACHE)
+	if (ctx->app_type == NET_APP_CLIENT) {
+		_net_app_tls_session_save(ctx);
+	}
+#endif
+
 	/* We call the connect cb only once for each connection. The TLS
 	 * might require new handshakes etc, but application does not need
 	 * to care about that.
@@ -2202,6 +2335,9 @@ int _net_app_tls_init(struct net_app_ctx *ctx, int client_or_server)
 #if defined(CONFIG_NET_APP_SERVER)
 	if (client_or_server == MBEDTLS_SSL_IS_SERVER) {
 		mbedtls_pk_init(&ctx->tls.mbedtls.pkey);
+#if defined(CONFIG_NET_APP_TLS_SESSION_TICKETS)
+		mbedtls_ssl_ticket_init(&ctx->tls.mbedtls.ticket_ctx);
+#endif
 	}
 #endif
 
@@ -2314,6 +2450,28 @@ int _net_app_tls_init(struct net_app_ctx *ctx, int client_or_server)
 	}
 #endif /* MBEDTLS_X509_CRT_PARSE_C */
 
+#if defined(CONFIG_NET_APP_TLS_SESSION_TICKETS)
+	if (client_or_server == MBEDTLS_SSL_IS_SERVER) {
+		ret = mbedtls_ssl_ticket_setup(
+			&ctx->tls.mbedtls.ticket_ctx,
+			mbedtls_ctr_drbg_random,
+			&ctx->tls.mbedtls.ctr_drbg,
+			TLS_TICKET_CIPHER,
+			CONFIG_NET_APP_TLS_SESSION_TICKET_LIFETIME);
+		if (ret != 0) {
+			_net_app_print_error("mbedtls_ssl_ticket_setup "
+					     "returned -0x%x", ret);
+			goto exit;
+		}
+
+		mbedtls_ssl_conf_session_tickets_cb(
+			&ctx->tls.mbedtls.conf,
+			mbedtls_ssl_ticket_write,
+			mbedtls_ssl_ticket_parse,
+			&ctx->tls.mbedtls.ticket_ctx);
+	}
+#endif /* CONFIG_NET_APP_TLS_SESSION_TICKETS */
+
 	ret = mbedtls_ssl_setup(&ctx->tls.mbedtls.ssl,
 				&ctx->tls.mbedtls.conf);
 	if (ret != 0) {
@@ -2348,8 +2506,20 @@ exit:
 
 void _net_app_tls_handler_stop(struct net_app_ctx *ctx)
 {
+#if defined(CONFIG_NET_APP_DTLS_COALESCE)
+	if (ctx->dtls.tx_pkt) {
+		net_pkt_unref(ctx->dtls.tx_pkt);
+		ctx->dtls.tx_pkt = NULL;
+	}
+#endif
+
 	mbedtls_ssl_free(&ctx->tls.mbedtls.ssl);
 	mbedtls_ssl_config_free(&ctx->tls.mbedtls.conf);
+#if defined(CONFIG_NET_APP_TLS_SESSION_TICKETS)
+	if (ctx->app_type == NET_APP_SERVER) {
+		mbedtls_ssl_ticket_free(&ctx->tls.mbedtls.ticket_ctx);
+	}
+#endif
 	mbedtls_ctr_drbg_free(&ctx->tls.mbedtls.ctr_drbg);
 	mbedtls_entropy_free(&ctx->tls.mbedtls.entropy);
 
@@ -96,8 +96,11 @@ void _net_app_accept_cb(struct net_context *net_ctx,
 			int status, void *data);
 #endif /* CONFIG_NET_APP_SERVER */
 
-#if defined(CONFIG_NET_APP_CLIENT)
-#endif /* CONFIG_NET_APP_CLIENT */
+#if defined(CONFIG_NET_APP_TLS_SESSION_CACHE)
+void _net_app_tls_session_load(struct net_app_ctx *ctx);
+void _net_app_tls_session_save(struct net_app_ctx *ctx);
+void _net_app_tls_session_drop(struct net_app_ctx *ctx);
+#endif /* CONFIG_NET_APP_TLS_SESSION_CACHE */
 
 #if defined(CONFIG_NET_APP_TLS) || defined(CONFIG_NET_APP_DTLS)
 bool _net_app_server_tls_enable(struct net_app_ctx *ctx);
@@ -27,6 +27,8 @@ struct option_context {
 	u16_t delta;
 	u16_t offset;
 	struct net_buf *frag;
+	/* packet whose option index is filled in while parsing */
+	struct coap_packet *index;
 };
 
 #define COAP_VERSION 1
@@ -74,6 +76,130 @@ static void option_header_set_len(u8_t *opt, u8_t len)
 	*opt |= (len & 0xF);
 }
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+/* Slot + 1 in coap_packet.opt_idx_first for each known option number */
+static const u8_t option_index_slot[COAP_OPTION_SIZE1 + 1] = {
+	[COAP_OPTION_IF_MATCH] = 1,
+	[COAP_OPTION_URI_HOST] = 2,
+	[COAP_OPTION_ETAG] = 3,
+	[COAP_OPTION_IF_NONE_MATCH] = 4,
+	[COAP_OPTION_OBSERVE] = 5,
+	[COAP_OPTION_URI_PORT] = 6,
+	[COAP_OPTION_LOCATION_PATH] = 7,
+	[COAP_OPTION_URI_PATH] = 8,
+	[COAP_OPTION_CONTENT_FORMAT] = 9,
+	[COAP_OPTION_MAX_AGE] = 10,
+	[COAP_OPTION_URI_QUERY] = 11,
+	[COAP_OPTION_ACCEPT] = 12,
+	[COAP_OPTION_LOCATION_QUERY] = 13,
+	[COAP_OPTION_BLOCK2] = 14,
+	[COAP_OPTION_BLOCK1] = 15,
+	[COAP_OPTION_SIZE2] = 16,
+	[COAP_OPTION_PROXY_URI] = 17,
+	[COAP_OPTION_PROXY_SCHEME] = 18,
+	[COAP_OPTION_SIZE1] = 19,
+};
+
+static u8_t option_index_get_slot(u16_t num)
+{
+	return num < ARRAY_SIZE(option_index_slot) ?
+		option_index_slot[num] : 0;
+}
+
+static void option_index_reset(struct coap_packet *cpkt, bool valid)
+{
+	memset(cpkt->opt_idx_first, 0, sizeof(cpkt->opt_idx_first));
+	cpkt->opt_idx_num = 0;
+	cpkt->opt_idx_valid = valid;
+}
+
+static void option_index_add(struct coap_packet *cpkt, u16_t num,
+			     u16_t len, u16_t offset)
+{
+	struct coap_option_pos *pos;
+	u8_t slot;
+
+	if (!cpkt || !cpkt->opt_idx_valid) {
+		return;
+	}
+
+	/* Too many options, coap_find_options() has to parse them */
+	if (cpkt->opt_idx_num == CONFIG_COAP_OPTION_INDEX_SIZE) {
+		cpkt->opt_idx_valid = false;
+		return;
+	}
+
+	slot = option_index_get_slot(num);
+	if (slot && !cpkt->opt_idx_first[slot - 1]) {
+		cpkt->opt_idx_first[slot - 1] = cpkt->opt_idx_num + 1;
+	}
+
+	pos = &cpkt->opt_idx[cpkt->opt_idx_num++];
+	pos->num = num;
+	pos->offset = offset;
+	pos->len = len;
+}
+
+static int option_index_find(const struct coap_packet *cpkt, u16_t code,
+			     struct coap_option *options, u16_t veclen)
+{
+	const struct coap_option_pos *pos, *end;
+	struct net_buf *frag;
+	u16_t offset;
+	u8_t slot;
+	int count;
+
+	end = &cpkt->opt_idx[cpkt->opt_idx_num];
+	slot = option_index_get_slot(code);
+
+	if (slot) {
+		if (!cpkt->opt_idx_first[slot - 1]) {
+			return 0;
+		}
+
+		pos = &cpkt->opt_idx[cpkt->opt_idx_first[slot - 1] - 1];
+	} else {
+		/* Options are stored in ascending order */
+		for (pos = cpkt->opt_idx; pos < end && pos->num < code;
+		     pos++) {
+		}
+	}
+
+	for (count = 0; pos < end && pos->num == code && count < veclen;
+	     pos++, count++) {
+		if (pos->len > sizeof(options[count].value)) {
+			NET_ERR("%u is > sizeof(coap_option->value)(%zu)!",
+				pos->len, sizeof(options[count].value));
+			return -EINVAL;
+		}
+
+		options[count].delta = code;
+		options[count].len = pos->len;
+
+		if (!pos->len) {
+			continue;
+		}
+
+		frag = net_frag_read(cpkt->frag, cpkt->offset + pos->offset,
+				     &offset, pos->len, options[count].value);
+		if (!frag && offset == 0xffff) {
+			return -EINVAL;
+		}
+	}
+
+	return count;
+}
+#else
+static inline void option_index_reset(struct coap_packet *cpkt, bool valid)
+{
+}
+
+static inline void option_index_add(struct coap_packet *cpkt, u16_t num,
+				    u16_t len, u16_t offset)
+{
+}
+#endif /* CONFIG_COAP_OPTION_INDEX */
+
 static u16_t get_coap_packet_len(struct net_pkt *pkt)
 {
 	u16_t len;
@@ -206,6 +332,8 @@ static int parse_option(const struct coap_packet *cpkt,
 	if (r == 0) {
 		if (len == 0) {
 			context->delta += delta;
+			option_index_add(context->index, context->delta, 0,
+					 cpkt->hdr_len + *opt_len);
 			return r;
 		}
 
@@ -246,17 +374,20 @@ static int parse_option(const struct coap_packet *cpkt,
 	}
 
 	context->delta += delta;
+	option_index_add(context->index, context->delta, len,
+			 cpkt->hdr_len + *opt_len - len);
 
 	return r;
 }
 
-static int parse_options(const struct coap_packet *cpkt,
+static int parse_options(struct coap_packet *cpkt,
 			 struct coap_option *options, u8_t opt_num)
 {
 	struct option_context context = {
 					.delta = 0,
 					.frag = NULL,
-					.offset = 0
+					.offset = 0,
+					.index = cpkt
 					};
 	u16_t opt_len;
 	u8_t num;
@@ -357,6 +488,7 @@ int coap_packet_parse(struct coap_packet *cpkt, struct net_pkt *pkt,
 	cpkt->pkt = pkt;
 	cpkt->hdr_len = 0;
 	cpkt->opt_len = 0;
+	option_index_reset(cpkt, false);
 
 	cpkt->frag = net_frag_skip(pkt->frags, 0, &cpkt->offset,
 				   net_pkt_ip_hdr_len(pkt) +
@@ -372,8 +504,11 @@ int coap_packet_parse(struct coap_packet *cpkt, struct net_pkt *pkt,
 		return -EINVAL;
 	}
 
+	option_index_reset(cpkt, true);
+
 	ret = parse_options(cpkt, options, opt_num);
 	if (ret < 0) {
+		option_index_reset(cpkt, false);
 		return -EINVAL;
 	}
 
@@ -420,6 +555,224 @@ int coap_packet_init(struct coap_packet *cpkt, struct net_pkt *pkt,
 	return 0;
 }
 
+static bool sockaddr_equal(const struct sockaddr *a,
+			   const struct sockaddr *b)
+{
+	/* FIXME: Should we consider ipv6-mapped ipv4 addresses as equal to
+	 * ipv4 addresses?
+	 */
+	if (a->sa_family != b->sa_family) {
+		return false;
+	}
+
+	if (a->sa_family == AF_INET) {
+		const struct sockaddr_in *a4 = net_sin(a);
+		const struct sockaddr_in *b4 = net_sin(b);
+
+		if (a4->sin_port != b4->sin_port) {
+			return false;
+		}
+
+		return net_ipv4_addr_cmp(&a4->sin_addr, &b4->sin_addr);
+	}
+
+	if (b->sa_family == AF_INET6) {
+		const struct sockaddr_in6 *a6 = net_sin6(a);
+		const struct sockaddr_in6 *b6 = net_sin6(b);
+
+		if (a6->sin6_port != b6->sin6_port) {
+			return false;
+		}
+
+		return net_ipv6_addr_cmp(&a6->sin6_addr, &b6->sin6_addr);
+	}
+
+	/* Invalid address family */
+	return false;
+}
+
+/* TODO: random generated initial ACK timeout
+ * ACK_TIMEOUT < INIT_ACK_TIMEOUT < ACK_TIMEOUT * ACK_RANDOM_FACTOR
+ * where ACK_TIMEOUT = 2 and ACK_RANDOM_FACTOR = 1.5 by default
+ * Ref: https://tools.ietf.org/html/rfc7252#section-4.8
+ */
+#define INIT_ACK_TIMEOUT	CONFIG_COAP_INIT_ACK_TIMEOUT_MS
+
+#define MAX_RETRANSMIT		4
+
+/* Backoff factors are kept in halves, so 1.5 can be represented */
+#define BACKOFF_DEFAULT		4
+
+#if defined(CONFIG_COAP_COCOA)
+/*
+ * CoCoA retransmission timeout estimation, see
+ * https://tools.ietf.org/html/draft-ietf-core-cocoa-03
+ *
+ * Each peer keeps two RFC 6298 style estimators: the strong one is fed
+ * by exchanges answered without retransmission, the weak one by
+ * exchanges that needed one or two retransmissions, measured from the
+ * first transmission.  Both are blended into the overall RTO used to
+ * start new exchanges.
+ */
+#define COCOA_RTO_MAX			K_SECONDS(60)
+#define COCOA_WEAK_MAX_RETRIES		2
+#define COCOA_STRONG_K			4
+#define COCOA_WEAK_K			1
+
+struct cocoa_peer {
+	struct sockaddr addr;
+	u32_t last_update;
+	s32_t rto;
+	s32_t strong_srtt;
+	s32_t strong_rttvar;
+	s32_t weak_srtt;
+	s32_t weak_rttvar;
+};
+
+static struct cocoa_peer cocoa_peers[CONFIG_COAP_COCOA_MAX_PEERS];
+
+/* Must be called with interrupts locked */
+static struct cocoa_peer *cocoa_peer_get(const struct sockaddr *addr,
+					 u32_t now)
+{
+	struct cocoa_peer *peer, *oldest = NULL;
+	size_t i;
+
+	for (i = 0; i < CONFIG_COAP_COCOA_MAX_PEERS; i++) {
+		peer = &cocoa_peers[i];
+
+		if (!peer->rto) {
+			/* Free entries are preferred over evicting a peer */
+			if (!oldest || oldest->rto) {
+				oldest = peer;
+			}
+
+			continue;
+		}
+
+		if (sockaddr_equal(&peer->addr, addr)) {
+			return peer;
+		}
+
+		if (!oldest || (oldest->rto && now - peer->last_update >
+					       now - oldest->last_update)) {
+			oldest = peer;
+		}
+	}
+
+	/* Forget the peer we have not heard from for the longest time */
+	memset(oldest, 0, sizeof(*oldest));
+	memcpy(&oldest->addr, addr, sizeof(*addr));
+	oldest->rto = INIT_ACK_TIMEOUT;
+	oldest->last_update = now;
+
+	return oldest;
+}
+
+/* Let estimates that were not refreshed for a while decay */
+static void cocoa_age(struct cocoa_peer *peer, u32_t now)
+{
+	u32_t idle = now - peer->last_update;
+
+	if (peer->rto < K_SECONDS(1) && idle > 16 * peer->rto) {
+		peer->rto *= 2;
+		peer->last_update = now;
+	} else if (peer->rto > K_SECONDS(3) && idle > 4 * peer->rto) {
+		peer->rto = K_SECONDS(1) + peer->rto / 2;
+		peer->last_update = now;
+	}
+}
+
+static s32_t cocoa_estimate(s32_t *srtt, s32_t *rttvar, s32_t rtt, int k)
+{
+	if (!*srtt) {
+		*srtt = rtt;
+		*rttvar = rtt / 2;
+	} else {
+		*rttvar = (3 * *rttvar + abs(*srtt - rtt)) / 4;
+		*srtt = (7 * *srtt + rtt) / 8;
+	}
+
+	return *srtt + k * *rttvar;
+}
+
+static void cocoa_update(const struct coap_pending *pending)
+{
+	struct cocoa_peer *peer;
+	unsigned int key;
+	u32_t now;
+	s32_t rtt, rto;
+
+	if (pending->retries > COCOA_WEAK_MAX_RETRIES) {
+		/* Can't tell which transmission was answered */
+		return;
+	}
+
+	now = k_uptime_get_32();
+	rtt = max((s32_t)(now - pending->t0), 1);
+
+	key = irq_lock();
+
+	peer = cocoa_peer_get(&pending->addr, now);
+
+	if (!pending->retries) {
+		rto = cocoa_estimate(&peer->strong_srtt,
+				     &peer->strong_rttvar, rtt,
+				     COCOA_STRONG_K);
+		peer->rto = (rto + peer->rto) / 2;
+	} else {
+		rto = cocoa_estimate(&peer->weak_srtt,
+				     &peer->weak_rttvar, rtt,
+				     COCOA_WEAK_K);
+		peer->rto = (rto + 3 * peer->rto) / 4;
+	}
+
+	peer->rto = min(peer->rto, COCOA_RTO_MAX);
+	peer->last_update = now;
+
+	irq_unlock(key);
+}
+
+static s32_t init_ack_timeout(struct coap_pending *pending, u32_t now)
+{
+	struct cocoa_peer *peer;
+	unsigned int key;
+	s32_t rto;
+
+	key = irq_lock();
+
+	peer = cocoa_peer_get(&pending->addr, now);
+	cocoa_age(peer, now);
+	rto = peer->rto;
+
+	irq_unlock(key);
+
+	/* Variable backoff: retry short RTOs faster, long ones slower */
+	if (rto < K_SECONDS(1)) {
+		pending->backoff = 6;
+	} else if (rto > K_SECONDS(3)) {
+		pending->backoff = 3;
+	} else {
+		pending->backoff = BACKOFF_DEFAULT;
+	}
+
+	/* Dither over [RTO, RTO * 1.5] so peers do not retry in lockstep */
+	return rto + sys_rand32_get() % (rto / 2 + 1);
+}
+#else
+static inline s32_t init_ack_timeout(struct coap_pending *pending,
+				     u32_t now)
+{
+	pending->backoff = BACKOFF_DEFAULT;
+
+	return INIT_ACK_TIMEOUT;
+}
+
+static inline void cocoa_update(const struct coap_pending *pending)
+{
+}
+#endif /* CONFIG_COAP_COCOA */
+
 int coap_pending_init(struct coap_pending *pending,
 		      const struct coap_packet *request,
 		      const struct sockaddr *addr)
@@ -512,6 +865,7 @@ struct coap_pending *coap_pending_received(
 			continue;
 		}
 
+		cocoa_update(p);
 		coap_pending_clear(p);
 		return p;
 	}
@@ -526,7 +880,11 @@ struct coap_pending *coap_pending_next_to_expire(
 	size_t i;
 
 	for (i = 0, p = pendings; i < len; i++, p++) {
-		if (p->timeout && (!found || found->timeout < p->timeout)) {
+		if (!p->timeout) {
+			continue;
+		}
+
+		if (!found || (s32_t)(p->deadline - found->deadline) < 0) {
 			found = p;
 		}
 	}
@@ -534,46 +892,66 @@ struct coap_pending *coap_pending_next_to_expire(
 	return found;
 }
 
-/* TODO: random generated initial ACK timeout
- * ACK_TIMEOUT < INIT_ACK_TIMEOUT < ACK_TIMEOUT * ACK_RANDOM_FACTOR
- * where ACK_TIMEOUT = 2 and ACK_RANDOM_FACTOR = 1.5 by default
- * Ref: https://tools.ietf.org/html/rfc7252#section-4.8
- */
-#define INIT_ACK_TIMEOUT	CONFIG_COAP_INIT_ACK_TIMEOUT_MS
+s32_t coap_pending_next_timeout(struct coap_pending *pendings, size_t len)
+{
+	struct coap_pending *p;
+	s32_t remaining;
 
-static s32_t next_timeout(s32_t previous)
+	p = coap_pending_next_to_expire(pendings, len);
+	if (!p) {
+		return K_FOREVER;
+	}
+
+	remaining = (s32_t)(p->deadline - k_uptime_get_32());
+
+	return remaining > 0 ? remaining : 0;
+}
+
+int coap_pending_outstanding(struct coap_pending *pendings, size_t len,
+			     const struct sockaddr *addr)
 {
-	switch (previous) {
-	case INIT_ACK_TIMEOUT:
-	case (INIT_ACK_TIMEOUT * 2):
-	case (INIT_ACK_TIMEOUT * 4):
-		return previous << 1;
-	case (INIT_ACK_TIMEOUT * 8):
-		/* equal value is returned to end retransmit */
-		return previous;
+	struct coap_pending *p;
+	size_t i;
+	int count = 0;
+
+	for (i = 0, p = pendings; i < len; i++, p++) {
+		if (p->timeout && sockaddr_equal(&p->addr, addr)) {
+			count++;
+		}
 	}
 
-	/* initial or unrecognized */
-	return INIT_ACK_TIMEOUT;
+	return count;
 }
 
 bool coap_pending_cycle(struct coap_pending *pending)
 {
-	s32_t old = pending->timeout;
-	bool cont;
+	u32_t now = k_uptime_get_32();
 
-	pending->timeout = next_timeout(pending->timeout);
+	if (!pending->timeout) {
+		/* First transmission of the request */
+		pending->t0 = now;
+		pending->retries = 0;
+		pending->timeout = init_ack_timeout(pending, now);
+	} else {
+		pending->retries++;
+		if (pending->retries >= MAX_RETRANSMIT) {
+			/* When it is the last retransmission, the buffer
+			 * will be destroyed when it is transmitted.
+			 */
+			return false;
+		}
 
-	/* If the timeout changed, it's not the last, continue... */
-	cont = (old != pending->timeout);
-	if (cont) {
-		/* When it it is the last retransmission, the buffer
-		 * will be destroyed when it is transmitted.
-		 */
-		net_pkt_ref(pending->pkt);
+		pending->timeout = pending->timeout * pending->backoff / 2;
+#if defined(CONFIG_COAP_COCOA)
+		pending->timeout = min(pending->timeout, COCOA_RTO_MAX);
+#endif
 	}
 
-	return cont;
+	pending->deadline = now + pending->timeout;
+
+	net_pkt_ref(pending->pkt);
+
+	return true;
 }
 
 void coap_pending_clear(struct coap_pending *pending)
@@ -676,6 +1054,195 @@ int coap_handle_request(struct coap_packet *cpkt,
 	return -ENOENT;
 }
 
+static bool node_is_wildcard(const struct coap_resource_node *node)
+{
+	return node->len == 1 &&
+		node->segment[0] == COAP_RESOURCE_WILDCARD[0];
+}
+
+static struct coap_resource_node *
+node_find_child(struct coap_resource_node *node, const char *segment,
+		u8_t len)
+{
+	struct coap_resource_node *child;
+
+	for (child = node->child; child; child = child->next) {
+		if (child->len == len &&
+		    !memcmp(child->segment, segment, len)) {
+			return child;
+		}
+	}
+
+	return NULL;
+}
+
+int coap_resource_tree_init(struct coap_resource_tree *tree,
+			    struct coap_resource_node *nodes,
+			    u16_t max_nodes,
+			    struct coap_resource *resources)
+{
+	struct coap_resource *resource;
+	int r;
+
+	if (!tree || (max_nodes && !nodes)) {
+		return -EINVAL;
+	}
+
+	memset(tree, 0, sizeof(*tree));
+	tree->nodes = nodes;
+	tree->max_nodes = max_nodes;
+
+	for (resource = resources; resource && resource->path; resource++) {
+		r = coap_resource_tree_add(tree, resource);
+		if (r < 0) {
+			return r;
+		}
+	}
+
+	return 0;
+}
+
+int coap_resource_tree_add(struct coap_resource_tree *tree,
+			   struct coap_resource *resource)
+{
+	struct coap_resource_node *node, *child;
+	const char * const *segment;
+	size_t len;
+
+	if (!tree || !resource || !resource->path) {
+		return -EINVAL;
+	}
+
+	node = &tree->root;
+
+	for (segment = resource->path; *segment; segment++) {
+		len = strlen(*segment);
+		if (len > UINT8_MAX) {
+			return -EINVAL;
+		}
+
+		child = node_find_child(node, *segment, len);
+		if (!child) {
+			if (tree->num_nodes == tree->max_nodes) {
+				return -ENOMEM;
+			}
+
+			child = &tree->nodes[tree->num_nodes++];
+			memset(child, 0, sizeof(*child));
+			child->segment = *segment;
+			child->len = len;
+			child->next = node->child;
+			node->child = child;
+		}
+
+		node = child;
+	}
+
+	if (node->resource) {
+		return -EALREADY;
+	}
+
+	node->resource = resource;
+
+	return 0;
+}
+
+static struct coap_resource *
+tree_match(const struct coap_resource_node *node,
+	   struct coap_option *options, u8_t opt_num, u8_t i)
+{
+	const struct coap_resource_node *child, *wildcard = NULL;
+	struct coap_resource *resource;
+
+	/* Move on to the next Uri-Path segment */
+	while (i < opt_num && options[i].delta != COAP_OPTION_URI_PATH) {
+		i++;
+	}
+
+	if (i == opt_num) {
+		return node->resource;
+	}
+
+	for (child = node->child; child; child = child->next) {
+		if (node_is_wildcard(child)) {
+			wildcard = child;
+			continue;
+		}
+
+		if (child->len == options[i].len &&
+		    !memcmp(child->segment, options[i].value, child->len)) {
+			resource = tree_match(child, options, opt_num, i + 1);
+			if (resource) {
+				return resource;
+			}
+
+			/* Segments are unique among siblings */
+			break;
+		}
+	}
+
+	if (!wildcard) {
+		/* The wildcard may come after the exact match */
+		for (; child; child = child->next) {
+			if (node_is_wildcard(child)) {
+				wildcard = child;
+				break;
+			}
+		}
+	}
+
+	if (wildcard) {
+		return tree_match(wildcard, options, opt_num, i + 1);
+	}
+
+	return NULL;
+}
+
+coap_method_t coap_resource_tree_match(const struct coap_resource_tree *tree,
+				       u8_t code,
+				       struct coap_option *options,
+				       u8_t opt_num,
+				       struct coap_resource **resource)
+{
+	struct coap_resource *found;
+
+	found = tree_match(&tree->root, options, opt_num, 0);
+	if (resource) {
+		*resource = found;
+	}
+
+	if (!found) {
+		return NULL;
+	}
+
+	return method_from_code(found, code);
+}
+
+int coap_handle_request_tree(struct coap_packet *cpkt,
+			     const struct coap_resource_tree *tree,
+			     struct coap_option *options,
+			     u8_t opt_num)
+{
+	struct coap_resource *resource;
+	coap_method_t method;
+
+	if (!is_request(cpkt)) {
+		return 0;
+	}
+
+	method = coap_resource_tree_match(tree, coap_header_get_code(cpkt),
+					  options, opt_num, &resource);
+	if (!resource) {
+		return -ENOENT;
+	}
+
+	if (!method) {
+		return 0;
+	}
+
+	return method(resource, cpkt);
+}
+
 unsigned int coap_option_value_to_int(const struct coap_option *option)
 {
 	switch (option->len) {
@@ -807,6 +1374,30 @@ int coap_resource_notify(struct coap_resource *resource)
 	return 0;
 }
 
+int coap_resource_notify_shared(struct coap_resource *resource,
+				const struct coap_packet *notification,
+				coap_notify_send_t send)
+{
+	struct coap_observer *o, *next;
+	int ret = 0;
+	int r;
+
+	if (!notification || !send) {
+		return -EINVAL;
+	}
+
+	/* the callback may remove the observer it is called for */
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&resource->observers, o, next,
+					  list) {
+		r = send(resource, o, notification);
+		if (r < 0 && !ret) {
+			ret = r;
+		}
+	}
+
+	return ret;
+}
+
 bool coap_request_is_observe(const struct coap_packet *request)
 {
 	return get_observe_option(request) == 0;
@@ -851,42 +1442,6 @@ void coap_remove_observer(struct coap_resource *resource,
 	sys_slist_find_and_remove(&resource->observers, &observer->list);
 }
 
-static bool sockaddr_equal(const struct sockaddr *a,
-			   const struct sockaddr *b)
-{
-	/* FIXME: Should we consider ipv6-mapped ipv4 addresses as equal to
-	 * ipv4 addresses?
-	 */
-	if (a->sa_family != b->sa_family) {
-		return false;
-	}
-
-	if (a->sa_family == AF_INET) {
-		const struct sockaddr_in *a4 = net_sin(a);
-		const struct sockaddr_in *b4 = net_sin(b);
-
-		if (a4->sin_port != b4->sin_port) {
-			return false;
-		}
-
-		return net_ipv4_addr_cmp(&a4->sin_addr, &b4->sin_addr);
-	}
-
-	if (b->sa_family == AF_INET6) {
-		const struct sockaddr_in6 *a6 = net_sin6(a);
-		const struct sockaddr_in6 *b6 = net_sin6(b);
-
-		if (a6->sin6_port != b6->sin6_port) {
-			return false;
-		}
-
-		return net_ipv6_addr_cmp(&a6->sin6_addr, &b6->sin6_addr);
-	}
-
-	/* Invalid address family */
-	return false;
-}
-
 struct coap_observer *coap_find_observer_by_addr(
 	struct coap_observer *observers, size_t len,
 	const struct sockaddr *addr)
@@ -1022,6 +1577,9 @@ int coap_packet_append_option(struct coap_packet *cpkt, u16_t code,
 		return -EINVAL;
 	}
 
+	/* The index no longer covers all options */
+	option_index_reset(cpkt, false);
+
 	cpkt->opt_len += r;
 	cpkt->last_delta += code;
 
@@ -1070,6 +1628,12 @@ int coap_find_options(const struct coap_packet *cpkt, u16_t code,
 		return -EINVAL;
 	}
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (cpkt->opt_idx_valid) {
+		return option_index_find(cpkt, code, options, veclen);
+	}
+#endif
+
 	/* Skip CoAP header */
 	context.frag = net_frag_skip(cpkt->frag, cpkt->offset,
 				     &context.offset, cpkt->hdr_len);
@@ -1225,6 +1789,45 @@ u16_t coap_header_get_id(const struct coap_packet *cpkt)
 	return id;
 }
 
+int coap_packet_init_shared(struct coap_packet *cpkt, struct net_pkt *pkt,
+			    const struct coap_packet *shared, u8_t type,
+			    u8_t tokenlen, u8_t *token, u16_t id)
+{
+	struct net_buf *frag;
+	u16_t offset;
+	int r;
+
+	if (!shared || !shared->frag) {
+		return -EINVAL;
+	}
+
+	r = coap_packet_init(cpkt, pkt, coap_header_get_version(shared), type,
+			     tokenlen, token, __coap_header_get_code(shared),
+			     id);
+	if (r < 0) {
+		return r;
+	}
+
+	/* Options and payload follow the header and token */
+	frag = net_frag_skip(shared->frag, shared->offset, &offset,
+			     shared->hdr_len);
+	if (!frag && offset == 0xffff) {
+		return -EINVAL;
+	}
+
+	for (; frag; frag = frag->frags, offset = 0) {
+		if (!net_pkt_append_all(pkt, frag->len - offset,
+					frag->data + offset, PKT_WAIT_TIME)) {
+			return -ENOMEM;
+		}
+	}
+
+	cpkt->opt_len = shared->opt_len;
+	cpkt->last_delta = shared->last_delta;
+
+	return 0;
+}
+
 struct net_buf *coap_packet_get_payload(const struct coap_packet *cpkt,
 					u16_t *offset, u16_t *len)
 {
@@ -49,6 +49,33 @@ static struct net_context *ipv6;
 NET_BUF_POOL_DEFINE(dns_msg_pool, DNS_RESOLVER_BUF_CTR,
 		    DNS_RESOLVER_MAX_BUF_SIZE, 0, NULL);
 
+/* Longest DNS label, RFC 1035 ch 2.3.4 */
+#define MDNS_LABEL_MAX 63
+#define MDNS_LOCAL_LABEL "\x05local"
+#define MDNS_NAME_MAX (1 + MDNS_LABEL_MAX + sizeof(MDNS_LOCAL_LABEL))
+
+/* How often a record can be multicast on a link, RFC 6762 ch 6 */
+#define MDNS_RESPONSE_INTERVAL K_SECONDS(1)
+#define MDNS_RESPONSE_HISTORY 4
+
+/* Records asked for in a query */
+#define ANSWER_A	BIT(0)
+#define ANSWER_AAAA	BIT(1)
+
+/* Our name, packed once as DNS labels */
+static struct {
+	u8_t data[MDNS_NAME_MAX];
+	u8_t len;
+} mdns_name;
+
+/* When records were last multicast, and where */
+static struct {
+	struct net_if *iface;
+	s64_t time;
+	sa_family_t family;
+	u16_t qtype;
+} mdns_sent[MDNS_RESPONSE_HISTORY];
+
 #if defined(CONFIG_NET_IPV6)
 static void create_ipv6_addr(struct sockaddr_in6 *addr)
 {
@@ -124,28 +151,67 @@ static void setup_dns_hdr(struct net_pkt *pkt, u16_t answers)
 	net_pkt_append_be16(pkt, 0);       /* Additional RR count */
 }
 
-static int add_answer(struct net_pkt *pkt, enum dns_rr_type qtype,
-		      struct net_buf *query, u32_t ttl,
-		      u16_t addr_len, u8_t *addr)
+/* Pack <hostname>.local as DNS labels, unless already done */
+static bool update_name(const char *hostname, size_t hostname_len)
 {
-	char *dot = query->data;
-	char *prev = NULL;
+	if (mdns_name.len && mdns_name.data[0] == hostname_len &&
+	    !memcmp(&mdns_name.data[1], hostname, hostname_len)) {
+		return true;
+	}
 
-	while ((dot = strchr(dot, '.'))) {
-		if (!prev) {
-			prev = dot++;
-			continue;
+	if (hostname_len > MDNS_LABEL_MAX) {
+		NET_DBG("Hostname %s too long", hostname);
+		return false;
+	}
+
+	mdns_name.data[0] = hostname_len;
+	memcpy(&mdns_name.data[1], hostname, hostname_len);
+	memcpy(&mdns_name.data[1 + hostname_len], MDNS_LOCAL_LABEL,
+	       sizeof(MDNS_LOCAL_LABEL));
+	mdns_name.len = 1 + hostname_len + sizeof(MDNS_LOCAL_LABEL);
+
+	return true;
+}
+
+/* Check whether a record was multicast on the interface less than
+ * MDNS_RESPONSE_INTERVAL ago, RFC 6762 ch 6. If not, it is considered
+ * sent from now on.
+ */
+static bool sent_recently(struct net_if *iface, sa_family_t family,
+			  enum dns_rr_type qtype)
+{
+	s64_t now = k_uptime_get();
+	int i, oldest = 0;
+
+	for (i = 0; i < ARRAY_SIZE(mdns_sent); i++) {
+		if (mdns_sent[i].iface == iface &&
+		    mdns_sent[i].family == family &&
+		    mdns_sent[i].qtype == qtype) {
+			if (now - mdns_sent[i].time < MDNS_RESPONSE_INTERVAL) {
+				return true;
+			}
+
+			mdns_sent[i].time = now;
+			return false;
 		}
 
-		*prev = dot - prev - 1;
-		prev = dot++;
+		if (mdns_sent[i].time < mdns_sent[oldest].time) {
+			oldest = i;
+		}
 	}
 
-	if (prev) {
-		*prev = strlen(prev) - 1;
-	}
+	mdns_sent[oldest].iface = iface;
+	mdns_sent[oldest].family = family;
+	mdns_sent[oldest].qtype = qtype;
+	mdns_sent[oldest].time = now;
 
-	if (!net_pkt_append_all(pkt, query->len + 1, query->data,
+	return false;
+}
+
+static int add_answer(struct net_pkt *pkt, enum dns_rr_type qtype,
+		      u32_t ttl, u16_t addr_len, const u8_t *addr)
+{
+	if (!net_pkt_append_all(pkt, mdns_name.len, mdns_name.data,
 				BUF_ALLOC_TIMEOUT)) {
 		return -ENOMEM;
 	}
@@ -166,91 +232,113 @@ static int add_answer(struct net_pkt *pkt, enum dns_rr_type qtype,
 	return 0;
 }
 
-static struct net_pkt *create_answer(struct net_context *ctx,
-				     sa_family_t family,
-				     enum dns_rr_type qtype,
-				     struct net_buf *query,
-				     u16_t addr_len, u8_t *addr)
-{
-	struct net_pkt *pkt;
-
-	pkt = net_pkt_get_tx(ctx, BUF_ALLOC_TIMEOUT);
-	if (!pkt) {
-		return NULL;
-	}
-
-	net_pkt_set_family(pkt, family);
-
-	setup_dns_hdr(pkt, 1);
-
-	add_answer(pkt, qtype, query, MDNS_TTL, addr_len, addr);
-
-	return pkt;
-}
-
+/* Answer all the questions of a query in one multicast reply */
 static int send_response(struct net_context *ctx, struct net_pkt *pkt,
-			 struct net_buf *query,
-			 enum dns_rr_type qtype)
+			 u8_t answers)
 {
+	struct net_if *iface = net_pkt_iface(pkt);
+	sa_family_t family = net_pkt_family(pkt);
+	const struct in6_addr *addr6 = NULL;
+	struct in_addr *addr4 = NULL;
 	struct net_pkt *reply;
 	struct sockaddr dst;
 	socklen_t dst_len;
+	u16_t count = 0;
 	int ret;
 
-	if (qtype == DNS_RR_TYPE_A) {
+	if (answers & ANSWER_A) {
 #if defined(CONFIG_NET_IPV4)
-		struct in_addr *addr;
-
 		/* For IPv4 we take the first address in the interface */
-		addr = &net_pkt_iface(pkt)->ipv4.unicast[0].address.in_addr;
+		if (!sent_recently(iface, family, DNS_RR_TYPE_A)) {
+			addr4 = &iface->ipv4.unicast[0].address.in_addr;
+			count++;
+		}
+#endif /* CONFIG_NET_IPV4 */
+	}
+
+	if (answers & ANSWER_AAAA) {
+#if defined(CONFIG_NET_IPV6)
+		if (!sent_recently(iface, family, DNS_RR_TYPE_AAAA)) {
+			struct in6_addr group;
+
+			if (family == AF_INET6) {
+				addr6 = net_if_ipv6_select_src_addr(iface,
+						&NET_IPV6_HDR(pkt)->src);
+			} else {
+				net_ipv6_addr_create(&group, 0xff02, 0, 0, 0,
+						     0, 0, 0, 0x00fb);
+				addr6 = net_if_ipv6_select_src_addr(iface,
+								    &group);
+			}
+
+			count++;
+		}
+#endif /* CONFIG_NET_IPV6 */
+	}
+
+	if (!count) {
+		return 0;
+	}
+
+	reply = net_pkt_get_tx(ctx, BUF_ALLOC_TIMEOUT);
+	if (!reply) {
+		return -ENOMEM;
+	}
+
+	net_pkt_set_family(reply, family);
 
+	if (family == AF_INET) {
+#if defined(CONFIG_NET_IPV4)
 		create_ipv4_addr(net_sin(&dst));
 		dst_len = sizeof(struct sockaddr_in);
 
-		reply = create_answer(ctx, AF_INET, qtype, query,
-				      sizeof(struct in_addr), (u8_t *)addr);
-		if (!reply) {
-			return -ENOMEM;
-		}
-
 		net_pkt_set_ipv4_ttl(reply, 255);
 #else /* CONFIG_NET_IPV4 */
-		return -EPFNOSUPPORT;
+		ret = -EPFNOSUPPORT;
+		goto fail;
 #endif /* CONFIG_NET_IPV4 */
-
-	} else if (qtype == DNS_RR_TYPE_AAAA) {
+	} else {
 #if defined(CONFIG_NET_IPV6)
-		const struct in6_addr *addr;
-
-		addr = net_if_ipv6_select_src_addr(net_pkt_iface(pkt),
-						   &NET_IPV6_HDR(pkt)->src);
-
 		create_ipv6_addr(net_sin6(&dst));
 		dst_len = sizeof(struct sockaddr_in6);
 
-		reply = create_answer(ctx, AF_INET6, qtype, query,
-				      sizeof(struct in6_addr), (u8_t *)addr);
-		if (!reply) {
-			return -ENOMEM;
-		}
-
 		net_pkt_set_ipv6_hop_limit(reply, 255);
 #else /* CONFIG_NET_IPV6 */
-		return -EPFNOSUPPORT;
+		ret = -EPFNOSUPPORT;
+		goto fail;
 #endif /* CONFIG_NET_IPV6 */
+	}
 
-	} else {
-		/* TODO: support also service PTRs */
-		return -EINVAL;
+	setup_dns_hdr(reply, count);
+
+	if (addr4) {
+		ret = add_answer(reply, DNS_RR_TYPE_A, MDNS_TTL,
+				 sizeof(struct in_addr), (const u8_t *)addr4);
+		if (ret < 0) {
+			goto fail;
+		}
+	}
+
+	if (addr6) {
+		ret = add_answer(reply, DNS_RR_TYPE_AAAA, MDNS_TTL,
+				 sizeof(struct in6_addr), (const u8_t *)addr6);
+		if (ret < 0) {
+			goto fail;
+		}
 	}
 
 	ret = net_context_sendto(reply, &dst, dst_len, NULL, K_NO_WAIT,
 				 NULL, NULL);
 	if (ret < 0) {
 		NET_DBG("Cannot send mDNS reply (%d)", ret);
-		net_pkt_unref(reply);
+		goto fail;
 	}
 
+	return ret;
+
+fail:
+	net_pkt_unref(reply);
+
 	return ret;
 }
 
@@ -264,6 +352,7 @@ static int dns_read(struct net_context *ctx,
 	int hostname_len = strlen(hostname);
 	struct net_buf *result;
 	struct dns_msg_t dns_msg;
+	u8_t answers = 0;
 	int data_len;
 	int queries;
 	int offset;
@@ -317,7 +406,7 @@ static int dns_read(struct net_context *ctx,
 
 		ret = dns_unpack_query(&dns_msg, result, &qtype, &qclass);
 		if (ret < 0) {
-			goto quit;
+			break;
 		}
 
 		/* Handle only .local queries */
@@ -330,7 +419,7 @@ static int dns_read(struct net_context *ctx,
 			qtype == DNS_RR_TYPE_A ? "A" : "AAAA", "IN",
 			result->data, ret);
 
-		/* If the query matches to our hostname, then send reply.
+		/* If the query matches to our hostname, then answer it.
 		 * We skip the first dot, and make sure there is dot after
 		 * matching hostname.
 		 */
@@ -339,11 +428,19 @@ static int dns_read(struct net_context *ctx,
 		    &(result->data + 1)[hostname_len] == lquery) {
 			NET_DBG("mDNS query to our hostname %s.local",
 				hostname);
-			send_response(ctx, pkt, result, qtype);
+			answers |= (qtype == DNS_RR_TYPE_A) ?
+				ANSWER_A : ANSWER_AAAA;
 		}
 	} while (--queries);
 
-	ret = 0;
+	/* Repeated questions are answered only once */
+	if (answers && update_name(hostname, hostname_len)) {
+		send_response(ctx, pkt, answers);
+	}
+
+	if (ret > 0) {
+		ret = 0;
+	}
 
 quit:
 	if (result) {
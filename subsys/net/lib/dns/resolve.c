@@ -66,6 +66,12 @@ static int dns_write(struct dns_resolve_context *ctx,
  */
 #define DNS_QUERY_POS		0x0c
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+#define NEGATIVE_TTL CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL
+#else
+#define NEGATIVE_TTL 0
+#endif
+
 #define DNS_IPV4_LEN		sizeof(struct in_addr)
 #define DNS_IPV6_LEN		sizeof(struct in6_addr)
 
@@ -261,6 +267,246 @@ static inline int get_slot_by_id(struct dns_resolve_context *ctx,
 	return -ENOENT;
 }
 
+/* Is the query waiting for the answer having the given DNS id */
+static inline bool is_waiting_for(struct dns_pending_query *query,
+				  u16_t dns_id)
+{
+	if (!query->cb) {
+		return false;
+	}
+
+	if (query->id == dns_id) {
+		return true;
+	}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	/* Queries for a name already being resolved share its answer */
+	return query->cache && query->cache->is_pending &&
+		query->cache->id == dns_id;
+#else
+	return false;
+#endif
+}
+
+static inline int get_slot_by_answer_id(struct dns_resolve_context *ctx,
+					u16_t dns_id)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (is_waiting_for(&ctx->queries[i], dns_id)) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Drop a pending entry once no query waits for its answer any more */
+static void cache_release(struct dns_resolve_context *ctx,
+			  struct dns_cache_entry *entry)
+{
+	int i;
+
+	if (!entry || !entry->is_pending) {
+		return;
+	}
+
+	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (ctx->queries[i].cb && ctx->queries[i].cache == entry) {
+			return;
+		}
+	}
+
+	entry->is_pending = false;
+	entry->is_used = false;
+}
+
+static struct dns_cache_entry *cache_lookup(struct dns_resolve_context *ctx,
+					    const char *query,
+					    enum dns_query_type type)
+{
+	s64_t now = k_uptime_get();
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_RESOLVER_CACHE_ENTRIES; i++) {
+		struct dns_cache_entry *entry = &ctx->cache[i];
+
+		if (!entry->is_used || entry->query_type != type ||
+		    strcmp(entry->name, query)) {
+			continue;
+		}
+
+		if (entry->is_pending) {
+			/* Might have been given up in the meantime */
+			cache_release(ctx, entry);
+
+			return entry->is_used ? entry : NULL;
+		}
+
+		if (entry->expires <= now) {
+			NET_DBG("Cached answer of %s expired", query);
+
+			entry->is_used = false;
+			return NULL;
+		}
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+static struct dns_cache_entry *cache_reserve(struct dns_resolve_context *ctx,
+					     const char *query,
+					     enum dns_query_type type)
+{
+	struct dns_cache_entry *entry = NULL;
+	s64_t now = k_uptime_get();
+	size_t len = strlen(query);
+	int i;
+
+	if (len > CONFIG_DNS_RESOLVER_CACHE_MAX_NAME_LEN) {
+		return NULL;
+	}
+
+	/* Take a free or expired entry, else the least recently used
+	 * answer. Entries still waiting for their answer are kept.
+	 */
+	for (i = 0; i < CONFIG_DNS_RESOLVER_CACHE_ENTRIES; i++) {
+		struct dns_cache_entry *tmp = &ctx->cache[i];
+
+		if (!tmp->is_used ||
+		    (!tmp->is_pending && tmp->expires <= now)) {
+			entry = tmp;
+			break;
+		}
+
+		if (tmp->is_pending) {
+			continue;
+		}
+
+		if (!entry || (s32_t)(tmp->last_used - entry->last_used) < 0) {
+			entry = tmp;
+		}
+	}
+
+	if (!entry) {
+		return NULL;
+	}
+
+	memcpy(entry->name, query, len + 1);
+	entry->query_type = type;
+	entry->addr_count = 0;
+	entry->is_used = true;
+	entry->is_pending = true;
+
+	return entry;
+}
+
+static inline void cache_add_addr(struct dns_cache_entry *entry,
+				  struct sockaddr *addr)
+{
+	if (!entry || entry->addr_count >= CONFIG_DNS_RESOLVER_CACHE_MAX_ADDRS) {
+		return;
+	}
+
+	memcpy(&entry->addr[entry->addr_count++], addr, sizeof(*addr));
+}
+
+static void cache_answer(struct dns_cache_entry *entry,
+			 dns_resolve_cb_t cb, void *user_data)
+{
+	struct dns_addrinfo info = { 0 };
+	int i;
+
+	entry->last_used = k_uptime_get_32();
+
+	for (i = 0; i < entry->addr_count; i++) {
+		memcpy(&info.ai_addr, &entry->addr[i], sizeof(info.ai_addr));
+		info.ai_family = info.ai_addr.sa_family;
+
+		if (info.ai_family == AF_INET) {
+			info.ai_addrlen = sizeof(struct sockaddr_in);
+		} else {
+			info.ai_addrlen = sizeof(struct sockaddr_in6);
+		}
+
+		cb(DNS_EAI_INPROGRESS, &info, user_data);
+	}
+
+	cb(entry->addr_count ? DNS_EAI_ALLDONE : DNS_EAI_NODATA, NULL,
+	   user_data);
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
+/* Pass a resolved address to all the queries waiting for it */
+static void dns_report(struct dns_resolve_context *ctx, u16_t dns_id,
+		       struct dns_addrinfo *info)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (is_waiting_for(&ctx->queries[i], dns_id)) {
+			ctx->queries[i].cb(DNS_EAI_INPROGRESS, info,
+					   ctx->queries[i].user_data);
+		}
+	}
+}
+
+/* Mark the end of the results for all the queries waiting for them. The
+ * answer is cached for ttl seconds, if non zero.
+ */
+static void dns_finish(struct dns_resolve_context *ctx, u16_t dns_id,
+		       int status, u32_t ttl)
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct dns_cache_entry *entry = NULL;
+#endif
+	int i;
+
+	for (i = 0; i < CONFIG_DNS_NUM_CONCUR_QUERIES; i++) {
+		if (!is_waiting_for(&ctx->queries[i], dns_id)) {
+			continue;
+		}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		if (ctx->queries[i].cache) {
+			entry = ctx->queries[i].cache;
+		}
+#endif
+
+		if (k_delayed_work_remaining_get(&ctx->queries[i].timer) > 0) {
+			k_delayed_work_cancel(&ctx->queries[i].timer);
+		}
+
+		ctx->queries[i].cb(status, NULL, ctx->queries[i].user_data);
+		ctx->queries[i].cb = NULL;
+	}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (!entry || !entry->is_pending) {
+		return;
+	}
+
+	if (!ttl) {
+		cache_release(ctx, entry);
+		return;
+	}
+
+	ttl = min(ttl, CONFIG_DNS_RESOLVER_CACHE_MAX_TTL);
+
+	entry->expires = k_uptime_get() + (s64_t)ttl * MSEC_PER_SEC;
+	entry->last_used = k_uptime_get_32();
+	entry->is_pending = false;
+
+	NET_DBG("Caching answer of %s for %u s", entry->name, ttl);
+#else
+	ARG_UNUSED(ttl);
+#endif
+}
+
 static int dns_read(struct dns_resolve_context *ctx,
 		    struct net_pkt *pkt,
 		    struct net_buf *dns_data,
@@ -270,7 +516,8 @@ static int dns_read(struct dns_resolve_context *ctx,
 	struct dns_addrinfo info = { 0 };
 	/* Helper struct to track the dns msg received from the server */
 	struct dns_msg_t dns_msg;
-	u32_t ttl; /* RR ttl, so far it is not passed to caller */
+	u32_t ttl; /* RR ttl, only used for caching so far */
+	u32_t min_ttl = UINT32_MAX;
 	u8_t *src, *addr;
 	int address_size;
 	/* index that points to the current answer being analyzed */
@@ -303,7 +550,7 @@ static int dns_read(struct dns_resolve_context *ctx,
 	 */
 	*dns_id = dns_unpack_header_id(dns_msg.msg);
 
-	query_idx = get_slot_by_id(ctx, *dns_id);
+	query_idx = get_slot_by_answer_id(ctx, *dns_id);
 	if (query_idx < 0) {
 		ret = DNS_EAI_SYSTEM;
 		goto quit;
@@ -314,6 +561,16 @@ static int dns_read(struct dns_resolve_context *ctx,
 		goto quit;
 	}
 
+	/* No such name, or no address of the type asked for */
+	if (dns_header_qr(dns_msg.msg) == DNS_RESPONSE &&
+	    dns_header_qdcount(dns_msg.msg) == 1 &&
+	    (dns_header_rcode(dns_msg.msg) == DNS_HEADER_NAMEERROR ||
+	     (dns_header_rcode(dns_msg.msg) == DNS_HEADER_NOERROR &&
+	      dns_header_ancount(dns_msg.msg) == 0))) {
+		ret = DNS_EAI_NODATA;
+		goto done;
+	}
+
 	ret = dns_unpack_response_header(&dns_msg, *dns_id);
 	if (ret < 0) {
 		ret = DNS_EAI_FAIL;
@@ -380,8 +637,13 @@ static int dns_read(struct dns_resolve_context *ctx,
 
 			memcpy(addr, src, address_size);
 
-			ctx->queries[query_idx].cb(DNS_EAI_INPROGRESS, &info,
-					ctx->queries[query_idx].user_data);
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			cache_add_addr(ctx->queries[query_idx].cache,
+				       &info.ai_addr);
+#endif
+			min_ttl = min(min_ttl, ttl);
+
+			dns_report(ctx, *dns_id, &info);
 			items++;
 			break;
 
@@ -429,14 +691,13 @@ static int dns_read(struct dns_resolve_context *ctx,
 		ret = DNS_EAI_ALLDONE;
 	}
 
-	if (k_delayed_work_remaining_get(&ctx->queries[query_idx].timer) > 0) {
-		k_delayed_work_cancel(&ctx->queries[query_idx].timer);
+done:
+	if (ret == DNS_EAI_NODATA) {
+		min_ttl = NEGATIVE_TTL;
 	}
 
 	/* Marks the end of the results */
-	ctx->queries[query_idx].cb(ret, NULL,
-				   ctx->queries[query_idx].user_data);
-	ctx->queries[query_idx].cb = NULL;
+	dns_finish(ctx, *dns_id, ret, min_ttl);
 
 	net_pkt_unref(pkt);
 
@@ -523,18 +784,8 @@ static void cb_recv(struct net_context *net_ctx,
 	}
 
 quit:
-	i = get_slot_by_id(ctx, dns_id);
-	if (i < 0) {
-		goto free_buf;
-	}
-
-	if (k_delayed_work_remaining_get(&ctx->queries[i].timer) > 0) {
-		k_delayed_work_cancel(&ctx->queries[i].timer);
-	}
-
 	/* Marks the end of the results */
-	ctx->queries[i].cb(ret, NULL, ctx->queries[i].user_data);
-	ctx->queries[i].cb = NULL;
+	dns_finish(ctx, dns_id, ret, 0);
 
 free_buf:
 	if (dns_data) {
@@ -646,6 +897,10 @@ int dns_resolve_cancel(struct dns_resolve_context *ctx, u16_t dns_id)
 	ctx->queries[i].cb(DNS_EAI_CANCELED, NULL, ctx->queries[i].user_data);
 	ctx->queries[i].cb = NULL;
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	cache_release(ctx, ctx->queries[i].cache);
+#endif
+
 	return 0;
 }
 
@@ -669,6 +924,9 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 {
 	struct net_buf *dns_data = NULL;
 	struct net_buf *dns_qname = NULL;
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct dns_cache_entry *cache;
+#endif
 	struct sockaddr addr;
 	int ret, i = -1, j = 0;
 	int failure = 0;
@@ -719,6 +977,17 @@ int dns_resolve_name(struct dns_resolve_context *ctx,
 	}
 
 try_resolve:
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	cache = cache_lookup(ctx, query, type);
+	if (cache && !cache->is_pending) {
+		NET_DBG("Answering %s from cache", query);
+
+		cache_answer(cache, cb, user_data);
+
+		return 0;
+	}
+#endif
+
 	i = get_cb_slot(ctx);
 	if (i < 0) {
 		return -EAGAIN;
@@ -733,6 +1002,27 @@ try_resolve:
 
 	k_delayed_work_init(&ctx->queries[i].timer, query_timeout);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (cache) {
+		/* The name is already being resolved, just wait for the
+		 * answer of that query.
+		 */
+		NET_DBG("Waiting for pending query of %s", query);
+
+		ctx->queries[i].cache = cache;
+		ctx->queries[i].id = sys_rand32_get();
+
+		if (dns_id) {
+			*dns_id = ctx->queries[i].id;
+		}
+
+		ret = k_delayed_work_submit(&ctx->queries[i].timer, timeout);
+		goto quit;
+	}
+
+	ctx->queries[i].cache = cache_reserve(ctx, query, type);
+#endif
+
 	dns_data = net_buf_alloc(&dns_msg_pool, ctx->buf_timeout);
 	if (!dns_data) {
 		ret = -ENOMEM;
@@ -762,6 +1052,12 @@ try_resolve:
 		NET_DBG("DNS id will be %u", *dns_id);
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (ctx->queries[i].cache) {
+		ctx->queries[i].cache->id = ctx->queries[i].id;
+	}
+#endif
+
 	/* If mDNS is enabled, then send .local queries only to multicast
 	 * address.
 	 */
@@ -820,6 +1116,10 @@ quit:
 			}
 
 			ctx->queries[i].cb = NULL;
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			cache_release(ctx, ctx->queries[i].cache);
+#endif
 		}
 
 		if (dns_id) {
@@ -857,6 +1157,37 @@ int dns_resolve_close(struct dns_resolve_context *ctx)
 	return 0;
 }
 
+int dns_resolve_flush(struct dns_resolve_context *ctx, const char *query)
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	int i;
+#endif
+
+	if (!ctx || !ctx->is_used) {
+		return -EINVAL;
+	}
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	for (i = 0; i < CONFIG_DNS_RESOLVER_CACHE_ENTRIES; i++) {
+		struct dns_cache_entry *entry = &ctx->cache[i];
+
+		if (!entry->is_used || entry->is_pending) {
+			continue;
+		}
+
+		if (query && strcmp(entry->name, query)) {
+			continue;
+		}
+
+		entry->is_used = false;
+	}
+#else
+	ARG_UNUSED(query);
+#endif
+
+	return 0;
+}
+
 struct dns_resolve_context *dns_resolve_get_default(void)
 {
 	return &dns_default_ctx;
@@ -473,6 +473,40 @@ int parser_header_state(struct http_parser *parser, char ch, char c)
 	return 0;
 }
 
+/* Word-at-a-time search for CR or LF, see "Determine if a word has a zero
+ * byte" in Bit Twiddling Hacks: x has a zero byte iff HAS_ZERO(x) != 0.
+ */
+#define WORD_ONES (~0UL / 0xff)
+#define WORD_HAS_ZERO(x) (((x) - WORD_ONES) & ~(x) & (WORD_ONES << 7))
+
+static const char *find_eol(const char *p, size_t len)
+{
+	const char *end = p + len;
+	unsigned long word;
+
+	for (; p != end && ((uintptr_t)p & (sizeof(word) - 1)); p++) {
+		if (*p == CR || *p == LF) {
+			return p;
+		}
+	}
+
+	for (; (size_t)(end - p) >= sizeof(word); p += sizeof(word)) {
+		memcpy(&word, p, sizeof(word));
+		if (WORD_HAS_ZERO(word ^ (WORD_ONES * CR)) ||
+		    WORD_HAS_ZERO(word ^ (WORD_ONES * LF))) {
+			break;
+		}
+	}
+
+	for (; p != end; p++) {
+		if (*p == CR || *p == LF) {
+			return p;
+		}
+	}
+
+	return NULL;
+}
+
 static
 int header_states(struct http_parser *parser, const char *data, size_t len,
 		  const char **ptr, enum state *p_state,
@@ -485,20 +519,12 @@ int header_states(struct http_parser *parser, const char *data, size_t len,
 	switch (h_state) {
 	case h_general: {
 		size_t limit = data + len - p;
-		const char *p_cr;
-		const char *p_lf;
+		const char *p_eol;
 
 		limit = MIN(limit, HTTP_MAX_HEADER_SIZE);
-		p_cr = (const char *)memchr(p, CR, limit);
-		p_lf = (const char *)memchr(p, LF, limit);
-		if (p_cr != NULL) {
-			if (p_lf != NULL && p_cr >= p_lf) {
-				p = p_lf;
-			} else {
-				p = p_cr;
-			}
-		} else if (UNLIKELY(p_lf != NULL)) {
-			p = p_lf;
+		p_eol = find_eol(p, limit);
+		if (p_eol != NULL) {
+			p = p_eol;
 		} else {
 			p = data + len;
 		}
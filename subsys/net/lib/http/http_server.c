@@ -42,6 +42,24 @@
 #define HTTP_STATUS_500_BR	"HTTP/1.1 500 Internal Server Error\r\n" \
 				"\r\n"
 
+#define HTTP_CHUNKED		"Transfer-Encoding: chunked\r\n"
+#define HTTP_CONNECTION_CLOSE	"Connection: close\r\n"
+#define HTTP_LAST_CHUNK		"0\r\n\r\n"
+
+/* Chunk size is always written with four hex digits, as a network buffer
+ * cannot hold more than 0xffff bytes.
+ */
+#define CHUNK_HEADER_LEN	(sizeof("xxxx" HTTP_CRLF) - 1)
+#define CHUNK_OVERHEAD		(CHUNK_HEADER_LEN + sizeof(HTTP_CRLF) - 1)
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_RESPONSES)
+/* Buffers pointing to static response data, they never allocate any data
+ * of their own.
+ */
+NET_BUF_POOL_FIXED_DEFINE(http_static_bufs, CONFIG_HTTP_SERVER_STATIC_BUFFERS,
+			  1, NULL);
+#endif
+
 #if defined(CONFIG_NET_DEBUG_HTTP_CONN)
 /** List of http connections */
 static sys_slist_t http_conn;
@@ -364,7 +382,8 @@ struct http_root_url *http_server_add_url(struct http_server_urls *my,
 
 		NET_DBG("[%d] %s URL %s", i,
 			flags == HTTP_URL_STANDARD ? "HTTP" :
-			(flags == HTTP_URL_WEBSOCKET ? "WS" : "<unknown>"),
+			(flags == HTTP_URL_WEBSOCKET ? "WS" :
+			 (flags == HTTP_URL_STATIC ? "static" : "<unknown>")),
 			url);
 
 		return &my->urls[i];
@@ -422,6 +441,21 @@ int http_server_del_default(struct http_server_urls *my)
 	return 0;
 }
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_RESPONSES)
+struct http_root_url *http_server_add_static(struct http_server_urls *my,
+				const struct http_static_response *rsp)
+{
+	struct http_root_url *root_url;
+
+	root_url = http_server_add_url(my, rsp->url, HTTP_URL_STATIC);
+	if (root_url) {
+		root_url->user_data = (u8_t *)rsp;
+	}
+
+	return root_url;
+}
+#endif /* CONFIG_HTTP_SERVER_STATIC_RESPONSES */
+
 static int http_url_cmp(const char *url, u16_t url_len,
 			const char *root_url, u16_t root_url_len)
 {
@@ -484,12 +518,293 @@ struct http_root_url *http_url_find(struct http_ctx *ctx,
 	return NULL;
 }
 
+static inline struct net_pkt *get_net_pkt(struct http_ctx *ctx,
+					  const struct sockaddr *dst)
+{
+	if (!dst) {
+		return net_app_get_net_pkt(&ctx->app_ctx, AF_UNSPEC,
+					   ctx->timeout);
+	}
+
+	return net_app_get_net_pkt_with_dst(&ctx->app_ctx, dst, ctx->timeout);
+}
+
+/* Can the connection be used for the next request after the response to
+ * the current one.
+ */
+static bool http_keep_alive(struct http_ctx *ctx)
+{
+#if defined(CONFIG_HTTP_SERVER_KEEPALIVE)
+	return http_should_keep_alive(&ctx->http.parser);
+#else
+	ARG_UNUSED(ctx);
+
+	return false;
+#endif
+}
+
+/* Produce one chunk of a streamed response into a network buffer of the
+ * pending packet. Returns the length of the chunk, 0 at the end of the
+ * body.
+ */
+static int http_stream_chunk(struct http_ctx *ctx, http_stream_cb_t cb,
+			     void *stream_data, const struct sockaddr *dst,
+			     void *user_send_data)
+{
+	char chunk_header[CHUNK_HEADER_LEN + 1];
+	struct net_buf *frag;
+	size_t room;
+	int ret;
+
+	/* Do not start a chunk that would not fit into the packet, the
+	 * packet data length is the same limit that net_pkt_append() uses.
+	 */
+	if (ctx->pending && ctx->pending->data_len <= CHUNK_OVERHEAD) {
+		ret = http_send_flush(ctx, user_send_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (!ctx->pending) {
+		ctx->pending = get_net_pkt(ctx, dst);
+		if (!ctx->pending) {
+			return -ENOMEM;
+		}
+	}
+
+	frag = net_pkt_get_frag(ctx->pending, ctx->timeout);
+	if (!frag) {
+		return -ENOMEM;
+	}
+
+	room = min(net_buf_tailroom(frag), ctx->pending->data_len);
+	if (room <= CHUNK_OVERHEAD) {
+		net_pkt_frag_unref(frag);
+		return -EMSGSIZE;
+	}
+
+	ret = cb(ctx, net_buf_tail(frag) + CHUNK_HEADER_LEN,
+		 room - CHUNK_OVERHEAD, stream_data);
+	if (ret <= 0) {
+		net_pkt_frag_unref(frag);
+		return ret;
+	}
+
+	snprintk(chunk_header, sizeof(chunk_header), "%04x" HTTP_CRLF, ret);
+	memcpy(net_buf_add(frag, CHUNK_HEADER_LEN), chunk_header,
+	       CHUNK_HEADER_LEN);
+	net_buf_add(frag, ret);
+	net_buf_add_mem(frag, HTTP_CRLF, sizeof(HTTP_CRLF) - 1);
+
+	net_pkt_frag_add(ctx->pending, frag);
+	ctx->pending->data_len -= ret + CHUNK_OVERHEAD;
+
+	return ret;
+}
+
+int http_send_stream(struct http_ctx *ctx, const char *header,
+		     http_stream_cb_t cb, void *stream_data,
+		     const struct sockaddr *dst,
+		     void *user_send_data)
+{
+	int ret;
+
+	ret = http_add_header(ctx, header, dst, user_send_data);
+	if (ret < 0) {
+		goto quit;
+	}
+
+	ret = http_add_header(ctx, HTTP_CHUNKED, dst, user_send_data);
+	if (ret < 0) {
+		goto quit;
+	}
+
+	if (!http_keep_alive(ctx)) {
+		ret = http_add_header(ctx, HTTP_CONNECTION_CLOSE, dst,
+				      user_send_data);
+		if (ret < 0) {
+			goto quit;
+		}
+	}
+
+	ret = http_add_header(ctx, HTTP_CRLF, dst, user_send_data);
+	if (ret < 0) {
+		goto quit;
+	}
+
+	do {
+		ret = http_stream_chunk(ctx, cb, stream_data, dst,
+					user_send_data);
+	} while (ret > 0);
+
+	if (ret < 0) {
+		NET_DBG("[%p] Cannot stream response (%d)", ctx, ret);
+		goto quit;
+	}
+
+	ret = http_prepare_and_send(ctx, HTTP_LAST_CHUNK,
+				    sizeof(HTTP_LAST_CHUNK) - 1, dst,
+				    user_send_data);
+	if (ret < 0) {
+		goto quit;
+	}
+
+	ret = http_send_flush(ctx, user_send_data);
+
+quit:
+	if (ret < 0 && ctx->pending) {
+		net_pkt_unref(ctx->pending);
+		ctx->pending = NULL;
+	}
+
+	return ret;
+}
+
+#if defined(CONFIG_HTTP_SERVER_STATIC_RESPONSES)
+static const struct http_static_response *http_static_find(
+							struct http_ctx *ctx)
+{
+	struct http_root_url *root_url;
+	int i;
+
+	if (!ctx->http.urls ||
+	    (ctx->http.parser.method != HTTP_GET &&
+	     ctx->http.parser.method != HTTP_HEAD)) {
+		return NULL;
+	}
+
+	for (i = 0; i < CONFIG_HTTP_SERVER_NUM_URLS; i++) {
+		root_url = &ctx->http.urls->urls[i];
+		if (!root_url->is_used || root_url->flags != HTTP_URL_STATIC) {
+			continue;
+		}
+
+		if (root_url->root_len == ctx->http.url_len &&
+		    !memcmp(root_url->root, ctx->http.url, ctx->http.url_len)) {
+			return (const struct http_static_response *)
+				root_url->user_data;
+		}
+	}
+
+	return NULL;
+}
+
+/* Add static data to the pending packets by reference. */
+static int http_add_static_data(struct http_ctx *ctx, const u8_t *data,
+				size_t len, const struct sockaddr *dst)
+{
+	struct net_buf *frag;
+	u16_t frag_len;
+	int ret;
+
+	while (len) {
+		if (!ctx->pending) {
+			ctx->pending = get_net_pkt(ctx, dst);
+			if (!ctx->pending) {
+				return -ENOMEM;
+			}
+		}
+
+		frag_len = min(len, ctx->pending->data_len);
+
+		frag = net_buf_alloc_with_data(&http_static_bufs, (void *)data,
+					       frag_len, ctx->timeout);
+		if (!frag) {
+			return -ENOMEM;
+		}
+
+		net_pkt_frag_add(ctx->pending, frag);
+		ctx->pending->data_len -= frag_len;
+
+		data += frag_len;
+		len -= frag_len;
+
+		/* Appending to a full packet would fail, send it now */
+		if (!ctx->pending->data_len) {
+			ret = http_send_flush(ctx, NULL);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int http_send_static(struct http_ctx *ctx,
+			    const struct http_static_response *rsp,
+			    const struct sockaddr *dst)
+{
+	char fields[sizeof("Content-Length: 4294967295" HTTP_CRLF
+			   HTTP_CONNECTION_CLOSE HTTP_CRLF)];
+	int ret;
+
+	NET_DBG("[%p] Static response to %s", ctx, rsp->url);
+
+	ret = http_send_flush(ctx, NULL);
+	if (ret < 0) {
+		goto quit;
+	}
+
+	ret = http_add_static_data(ctx, (const u8_t *)rsp->header,
+				   strlen(rsp->header), dst);
+	if (ret < 0) {
+		goto quit;
+	}
+
+	snprintk(fields, sizeof(fields), "Content-Length: %u" HTTP_CRLF
+		 "%s" HTTP_CRLF, (unsigned int)rsp->body_len,
+		 http_keep_alive(ctx) ? "" : HTTP_CONNECTION_CLOSE);
+
+	ret = http_prepare_and_send(ctx, fields, strlen(fields), dst, NULL);
+	if (ret < 0) {
+		goto quit;
+	}
+
+	if (ctx->http.parser.method != HTTP_HEAD) {
+		ret = http_add_static_data(ctx, rsp->body, rsp->body_len, dst);
+		if (ret < 0) {
+			goto quit;
+		}
+	}
+
+	ret = http_send_flush(ctx, NULL);
+
+quit:
+	if (ret < 0 && ctx->pending) {
+		net_pkt_unref(ctx->pending);
+		ctx->pending = NULL;
+	}
+
+	return ret;
+}
+#endif /* CONFIG_HTTP_SERVER_STATIC_RESPONSES */
+
 static int http_process_recv(struct http_ctx *ctx,
 			     const struct sockaddr *dst)
 {
 	struct http_root_url *root_url;
 	int ret;
 
+#if defined(CONFIG_HTTP_SERVER_STATIC_RESPONSES)
+	const struct http_static_response *rsp;
+
+	rsp = http_static_find(ctx);
+	if (rsp) {
+		ret = http_send_static(ctx, rsp, dst);
+
+		/* With keep-alive the caller decides whether the
+		 * connection is closed.
+		 */
+		if (!IS_ENABLED(CONFIG_HTTP_SERVER_KEEPALIVE)) {
+			http_close(ctx);
+		}
+
+		goto out;
+	}
+#endif
+
 	root_url = http_url_find(ctx, HTTP_URL_STANDARD);
 	if (!root_url) {
 		if (!ctx->http.urls) {
@@ -554,8 +869,110 @@ static void http_closed(struct net_app_ctx *app_ctx,
 #endif
 
 	ctx->http.field_values_ctr = 0;
+	ctx->http.data_len = 0;
+}
+
+#if defined(CONFIG_HTTP_SERVER_KEEPALIVE)
+static void http_request_reset(struct http_ctx *ctx)
+{
+	/* on_url() adds the connection to the monitored ones again */
+	http_server_conn_del(ctx);
+	http_change_state(ctx, HTTP_STATE_CLOSED);
 }
 
+/* Append the received data to the request buffer and serve the complete
+ * requests found there one after the other. An incomplete request is
+ * moved to the start of the buffer and parsed again when more data has
+ * been received. Returns 1 if the connection was upgraded to websocket.
+ */
+static int http_serve_requests(struct http_ctx *ctx, struct net_buf *frag,
+			       const struct sockaddr *dst)
+{
+	size_t offset = 0;
+	bool keep_alive;
+	int parsed_len;
+
+	for (; frag; frag = frag->frags) {
+		if ((ctx->http.data_len + frag->len) >
+		    ctx->http.request_buf_len) {
+			NET_DBG("[%p] Request does not fit into %zd bytes",
+				ctx, ctx->http.request_buf_len);
+			http_send_error(ctx, 400, NULL, 0, dst);
+			goto close;
+		}
+
+		memcpy(ctx->http.request_buf + ctx->http.data_len,
+		       frag->data, frag->len);
+
+		ctx->http.data_len += frag->len;
+	}
+
+	http_request_reset(ctx);
+
+	while (offset < ctx->http.data_len) {
+		http_parser_init(&ctx->http.parser, HTTP_REQUEST);
+		ctx->http.parser.addr = dst;
+		ctx->http.field_values_ctr = 0;
+
+		parsed_len = http_parser_execute(&ctx->http.parser,
+						 &ctx->http.parser_settings,
+						 ctx->http.request_buf + offset,
+						 ctx->http.data_len - offset);
+
+		if (ctx->state == HTTP_STATE_HEADER_RECEIVED) {
+			ctx->http.data_len = 0;
+			return 1;
+		}
+
+		if (HTTP_PARSER_ERRNO(&ctx->http.parser) == HPE_OK) {
+			/* The rest of the request is still to come */
+			break;
+		}
+
+		if (HTTP_PARSER_ERRNO(&ctx->http.parser) != HPE_PAUSED) {
+			NET_DBG("[%p] Cannot parse request (%s %s)", ctx,
+				http_errno_name(ctx->http.parser.http_errno),
+				http_errno_description(
+					ctx->http.parser.http_errno));
+			http_send_error(ctx, 400, NULL, 0, dst);
+			goto close;
+		}
+
+		http_parser_pause(&ctx->http.parser, 0);
+		offset += parsed_len;
+
+		keep_alive = http_should_keep_alive(&ctx->http.parser);
+
+		if (http_process_recv(ctx, dst) < 0) {
+			goto close;
+		}
+
+		if (ctx->state == HTTP_STATE_CLOSED) {
+			NET_DBG("[%p] Connection closed by application", ctx);
+			return 0;
+		}
+
+		if (!keep_alive) {
+			goto close;
+		}
+
+		http_request_reset(ctx);
+	}
+
+	ctx->http.data_len -= offset;
+	memmove(ctx->http.request_buf, ctx->http.request_buf + offset,
+		ctx->http.data_len);
+
+	return 0;
+
+close:
+	ctx->http.data_len = 0;
+	http_close(ctx);
+
+	return 0;
+}
+#endif /* CONFIG_HTTP_SERVER_KEEPALIVE */
+
 static void http_received(struct net_app_ctx *app_ctx,
 			  struct net_pkt *pkt,
 			  int status,
@@ -606,6 +1023,16 @@ static void http_received(struct net_app_ctx *app_ctx,
 		goto ws_only;
 	}
 
+#if defined(CONFIG_HTTP_SERVER_KEEPALIVE)
+	if (http_serve_requests(ctx, frag, dst) > 0) {
+		goto ws_ready;
+	}
+
+	net_pkt_unref(pkt);
+
+	return;
+#endif
+
 	while (frag) {
 		/* If this fragment cannot be copied to result buf,
 		 * then parse what we have which will cause the callback to be
@@ -711,8 +1138,6 @@ ws_only:
 
 				pkt->frags = NULL;
 				net_pkt_unref(pkt);
-
-				net_pkt_compact(ctx->websocket.pending);
 			} else {
 				ctx->websocket.pending = pkt;
 			}
@@ -767,8 +1192,7 @@ ws_only:
 			/* If we have more data pending than the header len,
 			 * then discard the header as we do not need that.
 			 */
-			net_buf_pull(ctx->websocket.pending->frags,
-				     header_len);
+			ws_pull_header(ctx->websocket.pending, header_len);
 
 			pkt = ctx->websocket.pending;
 			ctx->websocket.pending = NULL;
@@ -784,36 +1208,38 @@ ws_only:
 			struct net_buf *hdr, *payload;
 			struct net_pkt *cloned;
 
-			ret = net_pkt_split(pkt, pkt->frags,
-					    ctx->websocket.data_waiting,
-					    &payload, &hdr,
-					    ctx->timeout);
-			if (ret < 0) {
+			/* Split at the frame boundary without linearizing,
+			 * only the fragment holding the boundary is copied.
+			 */
+			hdr = ws_split_frags(pkt, ctx->websocket.data_waiting,
+					     ctx->timeout);
+			if (!hdr) {
 				net_pkt_unref(pkt);
 				return;
 			}
 
-			net_pkt_frag_unref(pkt->frags);
+			/* Clone only the packet metadata */
+			payload = pkt->frags;
 			pkt->frags = NULL;
 
 			cloned = net_pkt_clone(pkt, ctx->timeout);
+
+			pkt->frags = payload;
+
 			if (!cloned) {
+				net_pkt_frag_unref(hdr);
 				net_pkt_unref(pkt);
 				return;
 			}
 
-			pkt->frags = payload;
-			payload->frags = NULL;
-
-			net_pkt_compact(pkt);
-
 			cloned->frags = hdr;
 
 			ctx->websocket.pending = cloned;
 			ctx->websocket.data_waiting = 0;
 
 			net_pkt_set_appdatalen(pkt, net_pkt_get_len(pkt));
-			net_pkt_set_appdata(pkt, pkt->frags->data);
+			net_pkt_set_appdata(pkt, pkt->frags ?
+					    pkt->frags->data : NULL);
 
 			net_pkt_set_appdatalen(cloned, net_pkt_get_len(cloned));
 			net_pkt_set_appdata(cloned, cloned->frags->data);
@@ -977,6 +1403,18 @@ static int on_headers_complete(struct http_parser *parser)
 #endif
 }
 
+#if defined(CONFIG_HTTP_SERVER_KEEPALIVE)
+static int on_message_complete(struct http_parser *parser)
+{
+	/* Stop here so that the request is served before the next
+	 * pipelined one is parsed.
+	 */
+	http_parser_pause(parser, 1);
+
+	return 0;
+}
+#endif
+
 static int init_http_parser(struct http_ctx *ctx)
 {
 	memset(ctx->http.field_values, 0, sizeof(ctx->http.field_values));
@@ -985,6 +1423,9 @@ static int init_http_parser(struct http_ctx *ctx)
 	ctx->http.parser_settings.on_header_value = on_header_value;
 	ctx->http.parser_settings.on_url = on_url;
 	ctx->http.parser_settings.on_headers_complete = on_headers_complete;
+#if defined(CONFIG_HTTP_SERVER_KEEPALIVE)
+	ctx->http.parser_settings.on_message_complete = on_message_complete;
+#endif
 
 	http_parser_init(&ctx->http.parser, HTTP_REQUEST);
 
@@ -49,12 +49,13 @@
 #ifdef CONFIG_LWM2M_RW_JSON_SUPPORT
 #include "lwm2m_rw_json.h"
 #endif
+#ifdef CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT
+#include "lwm2m_rw_senml_cbor.h"
+#endif
 #ifdef CONFIG_LWM2M_RD_CLIENT_SUPPORT
 #include "lwm2m_rd_client.h"
 #endif
 
-#define ENGINE_UPDATE_INTERVAL K_MSEC(500)
-
 #define WELL_KNOWN_CORE_PATH	"</.well-known/core>"
 
 /*
@@ -95,16 +96,20 @@
 
 struct observe_node {
 	sys_snode_t node;
+	sys_snode_t wheel_node;
 	struct lwm2m_ctx *ctx;
 	struct lwm2m_obj_path path;
 	u8_t  token[MAX_TOKEN_LEN];
 	s64_t event_timestamp;
 	s64_t last_timestamp;
+	s64_t due_timestamp;
 	u32_t min_period_sec;
 	u32_t max_period_sec;
 	u32_t counter;
 	u16_t format;
 	u8_t  tkl;
+	u8_t  wheel_slot;
+	u8_t  scheduled;
 };
 
 struct notification_attrs {
@@ -132,9 +137,35 @@ static struct service_node service_node_data[MAX_PERIODIC_SERVICE];
 
 static sys_slist_t engine_obj_list;
 static sys_slist_t engine_obj_inst_list;
+
+/* Objects and object instances are also kept in hash tables, so that
+ * path lookups do not walk the lists above.
+ */
+#define ENGINE_OBJ_HASH_SIZE	8
+#define ENGINE_OBJ_HASH(obj_id)	((obj_id) % ENGINE_OBJ_HASH_SIZE)
+#define ENGINE_OBJ_INST_HASH(obj_id, obj_inst_id) \
+	(((obj_id) * 31 + (obj_inst_id)) % \
+	 CONFIG_LWM2M_ENGINE_OBJ_INST_HASH_SIZE)
+
+static sys_slist_t engine_obj_hash[ENGINE_OBJ_HASH_SIZE];
+static sys_slist_t engine_obj_inst_hash[CONFIG_LWM2M_ENGINE_OBJ_INST_HASH_SIZE];
 static sys_slist_t engine_observer_list;
 static sys_slist_t engine_service_list;
 
+/* Pending notifications are kept on a timing wheel with one second
+ * slots, so the engine thread only looks at observers which are due and
+ * can sleep until the next deadline instead of polling all of them.
+ * Deadlines further away than one revolution stay in their slot until
+ * the wheel comes round again.
+ */
+#define OBSERVE_WHEEL_SLOTS	64
+
+static sys_slist_t observe_wheel[OBSERVE_WHEEL_SLOTS];
+static s64_t observe_wheel_sec;
+
+/* given whenever the engine thread has to recompute its timeout */
+static K_SEM_DEFINE(engine_wake_sem, 0, 1);
+
 #define NUM_BLOCK1_CONTEXT	CONFIG_LWM2M_NUM_BLOCK1_CONTEXT
 
 /* TODO: figure out what's correct value */
@@ -377,6 +408,62 @@ static void clear_attrs(void *ref)
 	}
 }
 
+/* must be called with interrupts locked */
+static void observer_wheel_remove(struct observe_node *obs)
+{
+	if (!obs->scheduled) {
+		return;
+	}
+
+	sys_slist_find_and_remove(&observe_wheel[obs->wheel_slot],
+				  &obs->wheel_node);
+	obs->scheduled = 0;
+}
+
+static void observer_unschedule(struct observe_node *obs)
+{
+	unsigned int key = irq_lock();
+
+	observer_wheel_remove(obs);
+	irq_unlock(key);
+}
+
+/*
+ * Put an observer on the wheel at its next deadline:
+ * - pmin after the last notification if a resource changed since then
+ * - pmax after the last notification otherwise (never if pmax is 0)
+ */
+static void observer_schedule(struct observe_node *obs)
+{
+	unsigned int key;
+	s64_t due, sec;
+
+	if (obs->event_timestamp > obs->last_timestamp) {
+		due = obs->last_timestamp + K_SECONDS(obs->min_period_sec);
+	} else if (obs->max_period_sec) {
+		due = obs->last_timestamp + K_SECONDS(obs->max_period_sec);
+	} else {
+		observer_unschedule(obs);
+		return;
+	}
+
+	key = irq_lock();
+
+	observer_wheel_remove(obs);
+
+	/* overdue observers go into the slot the engine looks at next */
+	sec = max(due / MSEC_PER_SEC, observe_wheel_sec);
+
+	obs->due_timestamp = due;
+	obs->wheel_slot = sec % OBSERVE_WHEEL_SLOTS;
+	obs->scheduled = 1;
+	sys_slist_append(&observe_wheel[obs->wheel_slot], &obs->wheel_node);
+
+	irq_unlock(key);
+
+	k_sem_give(&engine_wake_sem);
+}
+
 int lwm2m_notify_observer(u16_t obj_id, u16_t obj_inst_id, u16_t res_id)
 {
 	struct observe_node *obs;
@@ -388,8 +475,15 @@ int lwm2m_notify_observer(u16_t obj_id, u16_t obj_inst_id, u16_t res_id)
 		    obs->path.obj_inst_id == obj_inst_id &&
 		    (obs->path.level < 3 ||
 		     obs->path.res_id == res_id)) {
-			/* update the event time for this observer */
-			obs->event_timestamp = k_uptime_get();
+			/*
+			 * Only the first change since the last notification
+			 * moves the deadline, further changes are reported
+			 * together with it.
+			 */
+			if (obs->event_timestamp <= obs->last_timestamp) {
+				obs->event_timestamp = k_uptime_get();
+				observer_schedule(obs);
+			}
 
 			SYS_LOG_DBG("NOTIFY EVENT %u/%u/%u",
 				    obj_id, obj_inst_id, res_id);
@@ -534,6 +628,7 @@ static int engine_add_observer(struct lwm2m_message *msg,
 	observe_node_data[i].counter = 1;
 	sys_slist_append(&engine_observer_list,
 			 &observe_node_data[i].node);
+	observer_schedule(&observe_node_data[i]);
 
 	SYS_LOG_DBG("OBSERVER ADDED %u/%u/%u(%u) token:'%s' addr:%s",
 		    path->obj_id, path->obj_inst_id, path->res_id, path->level,
@@ -567,6 +662,7 @@ static int engine_remove_observer(const u8_t *token, u8_t tkl)
 		return -ENOENT;
 	}
 
+	observer_unschedule(found_obj);
 	sys_slist_remove(&engine_observer_list, prev_node, &found_obj->node);
 	memset(found_obj, 0, sizeof(*found_obj));
 
@@ -589,6 +685,7 @@ static void engine_remove_observer_by_id(u16_t obj_id, s32_t obj_inst_id)
 			continue;
 		}
 
+		observer_unschedule(obs);
 		sys_slist_remove(&engine_observer_list, prev_node, &obs->node);
 		memset(obs, 0, sizeof(*obs));
 	}
@@ -599,19 +696,24 @@ static void engine_remove_observer_by_id(u16_t obj_id, s32_t obj_inst_id)
 void lwm2m_register_obj(struct lwm2m_engine_obj *obj)
 {
 	sys_slist_append(&engine_obj_list, &obj->node);
+	sys_slist_append(&engine_obj_hash[ENGINE_OBJ_HASH(obj->obj_id)],
+			 &obj->hash_node);
 }
 
 void lwm2m_unregister_obj(struct lwm2m_engine_obj *obj)
 {
 	engine_remove_observer_by_id(obj->obj_id, -1);
 	sys_slist_find_and_remove(&engine_obj_list, &obj->node);
+	sys_slist_find_and_remove(&engine_obj_hash[ENGINE_OBJ_HASH(obj->obj_id)],
+				  &obj->hash_node);
 }
 
 static struct lwm2m_engine_obj *get_engine_obj(int obj_id)
 {
 	struct lwm2m_engine_obj *obj;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node) {
+	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_hash[ENGINE_OBJ_HASH(obj_id)],
+				     obj, hash_node) {
 		if (obj->obj_id == obj_id) {
 			return obj;
 		}
@@ -638,9 +740,18 @@ lwm2m_get_engine_obj_field(struct lwm2m_engine_obj *obj, int res_id)
 
 /* engine object instance */
 
+static inline sys_slist_t *
+engine_obj_inst_bucket(struct lwm2m_engine_obj_inst *obj_inst)
+{
+	return &engine_obj_inst_hash[ENGINE_OBJ_INST_HASH(
+			obj_inst->obj->obj_id, obj_inst->obj_inst_id)];
+}
+
 static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_append(engine_obj_inst_bucket(obj_inst),
+			 &obj_inst->hash_node);
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -648,6 +759,8 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	engine_remove_observer_by_id(
 			obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+	sys_slist_find_and_remove(engine_obj_inst_bucket(obj_inst),
+				  &obj_inst->hash_node);
 }
 
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
@@ -655,8 +768,10 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
-				     node) {
+	SYS_SLIST_FOR_EACH_CONTAINER(
+		&engine_obj_inst_hash[ENGINE_OBJ_INST_HASH(obj_id,
+							   obj_inst_id)],
+		obj_inst, hash_node) {
 		if (obj_inst->obj->obj_id == obj_id &&
 		    obj_inst->obj_inst_id == obj_inst_id) {
 			return obj_inst;
@@ -1044,6 +1159,24 @@ int lwm2m_send_message(struct lwm2m_message *msg)
 	}
 
 	if (msg->type == COAP_TYPE_CON) {
+#if defined(CONFIG_COAP_COCOA)
+		/*
+		 * Hold new requests back while NSTART exchanges with the
+		 * server are outstanding, retransmit_request() sends them
+		 * once one of those completes.
+		 */
+		if (!msg->send_attempts &&
+		    coap_pending_outstanding(msg->ctx->pendings,
+					     CONFIG_LWM2M_ENGINE_MAX_PENDING,
+					     &msg->pending->addr) >=
+		    CONFIG_COAP_NSTART) {
+			msg->send_deferred = true;
+			return 0;
+		}
+
+		msg->send_deferred = false;
+#endif
+
 		/*
 		 * Increase packet ref count to avoid being unref after
 		 * net_app_send_pkt()
@@ -1069,8 +1202,10 @@ int lwm2m_send_message(struct lwm2m_message *msg)
 			return 0;
 		}
 
+		/* one timer serves all pending retransmissions */
 		k_delayed_work_submit(&msg->ctx->retransmit_work,
-				      msg->pending->timeout);
+			coap_pending_next_timeout(msg->ctx->pendings,
+					CONFIG_LWM2M_ENGINE_MAX_PENDING));
 	} else {
 		lwm2m_reset_message(msg, true);
 	}
@@ -1164,6 +1299,12 @@ static int select_writer(struct lwm2m_output_context *out, u16_t accept)
 		break;
 #endif
 
+#ifdef CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		out->writer = &senml_cbor_writer;
+		break;
+#endif
+
 	default:
 		SYS_LOG_WRN("Unknown content type %u", accept);
 		return -ENOMSG;
@@ -1188,6 +1329,12 @@ static int select_reader(struct lwm2m_input_context *in, u16_t format)
 		in->reader = &oma_tlv_reader;
 		break;
 
+#ifdef CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		in->reader = &senml_cbor_reader;
+		break;
+#endif
+
 	default:
 		SYS_LOG_WRN("Unknown content type %u", format);
 		return -ENOMSG;
@@ -1323,6 +1470,55 @@ static int path_to_objs(const struct lwm2m_obj_path *path,
 	return 0;
 }
 
+int lwm2m_engine_get_res_handle(char *pathstr,
+				struct lwm2m_res_handle *handle)
+{
+	struct lwm2m_obj_path path;
+	int ret;
+
+	/* translate path -> path_obj */
+	ret = string_to_path(pathstr, &path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (path.level < 3) {
+		SYS_LOG_ERR("path must have 3 parts");
+		return -EINVAL;
+	}
+
+	/* look up resource obj */
+	ret = path_to_objs(&path, &handle->obj_inst, &handle->obj_field,
+			   &handle->res);
+	if (ret < 0) {
+		return ret;
+	}
+
+	handle->obj_id = path.obj_id;
+	handle->obj_inst_id = path.obj_inst_id;
+	handle->res_id = path.res_id;
+
+	return 0;
+}
+
+/* A handle outlives the object instance it was resolved to if that is
+ * deleted, so make sure it still points to the same resource.
+ */
+static int check_res_handle(const struct lwm2m_res_handle *handle)
+{
+	if (!handle->obj_inst || !handle->obj_inst->obj ||
+	    handle->obj_inst->obj->obj_id != handle->obj_id ||
+	    handle->obj_inst->obj_inst_id != handle->obj_inst_id ||
+	    handle->res->res_id != handle->res_id) {
+		SYS_LOG_ERR("res handle %u/%u/%u is no longer valid",
+			    handle->obj_id, handle->obj_inst_id,
+			    handle->res_id);
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
 int lwm2m_engine_create_obj_inst(char *pathstr)
 {
 	struct lwm2m_obj_path path;
@@ -1377,41 +1573,17 @@ int lwm2m_engine_set_res_data(char *pathstr, void *data_ptr, u16_t data_len,
 	return ret;
 }
 
-static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
+static int engine_set_res(struct lwm2m_res_handle *handle, void *value,
+			  u16_t len)
 {
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res_inst *res = NULL;
+	struct lwm2m_engine_obj_inst *obj_inst = handle->obj_inst;
+	struct lwm2m_engine_obj_field *obj_field = handle->obj_field;
+	struct lwm2m_engine_res_inst *res = handle->res;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 	int ret = 0;
 	bool changed = false;
 
-	SYS_LOG_DBG("path:%s, value:%p, len:%d", pathstr, value, len);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		SYS_LOG_ERR("path must have 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res);
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (!res) {
-		SYS_LOG_ERR("res instance %d not found", path.res_id);
-		return -ENOENT;
-	}
-
 	if (LWM2M_HAS_RES_FLAG(res, LWM2M_RES_DATA_FLAG_RO)) {
 		SYS_LOG_ERR("res data pointer is read-only");
 		return -EACCES;
@@ -1435,7 +1607,7 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 	if (len > res->data_len -
 		(obj_field->data_type == LWM2M_RES_TYPE_STRING ? 1 : 0)) {
 		SYS_LOG_ERR("length %u is too long for resource %d data",
-			    len, path.res_id);
+			    len, handle->res_id);
 		return -ENOMEM;
 	}
 
@@ -1518,12 +1690,41 @@ static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
 	}
 
 	if (changed) {
-		NOTIFY_OBSERVER_PATH(&path);
+		NOTIFY_OBSERVER(handle->obj_id, handle->obj_inst_id,
+				handle->res_id);
 	}
 
 	return ret;
 }
 
+static int lwm2m_engine_set(char *pathstr, void *value, u16_t len)
+{
+	struct lwm2m_res_handle handle;
+	int ret;
+
+	SYS_LOG_DBG("path:%s, value:%p, len:%d", pathstr, value, len);
+
+	ret = lwm2m_engine_get_res_handle(pathstr, &handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_set_res(&handle, value, len);
+}
+
+static int lwm2m_engine_handle_set(struct lwm2m_res_handle *handle,
+				   void *value, u16_t len)
+{
+	int ret;
+
+	ret = check_res_handle(handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_set_res(handle, value, len);
+}
+
 int lwm2m_engine_set_opaque(char *pathstr, char *data_ptr, u16_t data_len)
 {
 	return lwm2m_engine_set(pathstr, data_ptr, data_len);
@@ -1624,40 +1825,15 @@ int lwm2m_engine_get_res_data(char *pathstr, void **data_ptr, u16_t *data_len,
 	return 0;
 }
 
-static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
+static int engine_get_res(struct lwm2m_res_handle *handle, void *buf,
+			  u16_t buflen)
 {
-	int ret = 0;
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res_inst *res = NULL;
+	struct lwm2m_engine_obj_inst *obj_inst = handle->obj_inst;
+	struct lwm2m_engine_obj_field *obj_field = handle->obj_field;
+	struct lwm2m_engine_res_inst *res = handle->res;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 
-	SYS_LOG_DBG("path:%s, buf:%p, buflen:%d", pathstr, buf, buflen);
-
-	/* translate path -> path_obj */
-	ret = string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		SYS_LOG_ERR("path must have 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res);
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (!res) {
-		SYS_LOG_ERR("res instance %d not found", path.res_id);
-		return -ENOENT;
-	}
-
 	/* setup initial data elements */
 	data_ptr = res->data_ptr;
 	data_len = res->data_len;
@@ -1746,6 +1922,34 @@ static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
 	return 0;
 }
 
+static int lwm2m_engine_get(char *pathstr, void *buf, u16_t buflen)
+{
+	struct lwm2m_res_handle handle;
+	int ret;
+
+	SYS_LOG_DBG("path:%s, buf:%p, buflen:%d", pathstr, buf, buflen);
+
+	ret = lwm2m_engine_get_res_handle(pathstr, &handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_get_res(&handle, buf, buflen);
+}
+
+static int lwm2m_engine_handle_get(struct lwm2m_res_handle *handle,
+				   void *buf, u16_t buflen)
+{
+	int ret;
+
+	ret = check_res_handle(handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_get_res(handle, buf, buflen);
+}
+
 int lwm2m_engine_get_opaque(char *pathstr, void *buf, u16_t buflen)
 {
 	return lwm2m_engine_get(pathstr, buf, buflen);
@@ -1819,6 +2023,165 @@ int lwm2m_engine_get_float64(char *pathstr, float64_value_t *buf)
 	return lwm2m_engine_get(pathstr, buf, sizeof(float64_value_t));
 }
 
+/* pre-resolved resource setter and getter functions */
+
+int lwm2m_engine_handle_set_opaque(struct lwm2m_res_handle *handle,
+				   char *data_ptr, u16_t data_len)
+{
+	return lwm2m_engine_handle_set(handle, data_ptr, data_len);
+}
+
+int lwm2m_engine_handle_set_string(struct lwm2m_res_handle *handle,
+				   char *data_ptr)
+{
+	return lwm2m_engine_handle_set(handle, data_ptr, strlen(data_ptr));
+}
+
+int lwm2m_engine_handle_set_u8(struct lwm2m_res_handle *handle, u8_t value)
+{
+	return lwm2m_engine_handle_set(handle, &value, 1);
+}
+
+int lwm2m_engine_handle_set_u16(struct lwm2m_res_handle *handle, u16_t value)
+{
+	return lwm2m_engine_handle_set(handle, &value, 2);
+}
+
+int lwm2m_engine_handle_set_u32(struct lwm2m_res_handle *handle, u32_t value)
+{
+	return lwm2m_engine_handle_set(handle, &value, 4);
+}
+
+int lwm2m_engine_handle_set_u64(struct lwm2m_res_handle *handle, u64_t value)
+{
+	return lwm2m_engine_handle_set(handle, &value, 8);
+}
+
+int lwm2m_engine_handle_set_s8(struct lwm2m_res_handle *handle, s8_t value)
+{
+	return lwm2m_engine_handle_set(handle, &value, 1);
+}
+
+int lwm2m_engine_handle_set_s16(struct lwm2m_res_handle *handle, s16_t value)
+{
+	return lwm2m_engine_handle_set(handle, &value, 2);
+}
+
+int lwm2m_engine_handle_set_s32(struct lwm2m_res_handle *handle, s32_t value)
+{
+	return lwm2m_engine_handle_set(handle, &value, 4);
+}
+
+int lwm2m_engine_handle_set_s64(struct lwm2m_res_handle *handle, s64_t value)
+{
+	return lwm2m_engine_handle_set(handle, &value, 8);
+}
+
+int lwm2m_engine_handle_set_bool(struct lwm2m_res_handle *handle, bool value)
+{
+	u8_t temp = (value != 0 ? 1 : 0);
+
+	return lwm2m_engine_handle_set(handle, &temp, 1);
+}
+
+int lwm2m_engine_handle_set_float32(struct lwm2m_res_handle *handle,
+				    float32_value_t *value)
+{
+	return lwm2m_engine_handle_set(handle, value,
+				       sizeof(float32_value_t));
+}
+
+int lwm2m_engine_handle_set_float64(struct lwm2m_res_handle *handle,
+				    float64_value_t *value)
+{
+	return lwm2m_engine_handle_set(handle, value,
+				       sizeof(float64_value_t));
+}
+
+int lwm2m_engine_handle_get_opaque(struct lwm2m_res_handle *handle,
+				   void *buf, u16_t buflen)
+{
+	return lwm2m_engine_handle_get(handle, buf, buflen);
+}
+
+int lwm2m_engine_handle_get_string(struct lwm2m_res_handle *handle,
+				   void *buf, u16_t buflen)
+{
+	return lwm2m_engine_handle_get(handle, buf, buflen);
+}
+
+int lwm2m_engine_handle_get_u8(struct lwm2m_res_handle *handle, u8_t *value)
+{
+	return lwm2m_engine_handle_get(handle, value, 1);
+}
+
+int lwm2m_engine_handle_get_u16(struct lwm2m_res_handle *handle,
+				u16_t *value)
+{
+	return lwm2m_engine_handle_get(handle, value, 2);
+}
+
+int lwm2m_engine_handle_get_u32(struct lwm2m_res_handle *handle,
+				u32_t *value)
+{
+	return lwm2m_engine_handle_get(handle, value, 4);
+}
+
+int lwm2m_engine_handle_get_u64(struct lwm2m_res_handle *handle,
+				u64_t *value)
+{
+	return lwm2m_engine_handle_get(handle, value, 8);
+}
+
+int lwm2m_engine_handle_get_s8(struct lwm2m_res_handle *handle, s8_t *value)
+{
+	return lwm2m_engine_handle_get(handle, value, 1);
+}
+
+int lwm2m_engine_handle_get_s16(struct lwm2m_res_handle *handle,
+				s16_t *value)
+{
+	return lwm2m_engine_handle_get(handle, value, 2);
+}
+
+int lwm2m_engine_handle_get_s32(struct lwm2m_res_handle *handle,
+				s32_t *value)
+{
+	return lwm2m_engine_handle_get(handle, value, 4);
+}
+
+int lwm2m_engine_handle_get_s64(struct lwm2m_res_handle *handle,
+				s64_t *value)
+{
+	return lwm2m_engine_handle_get(handle, value, 8);
+}
+
+int lwm2m_engine_handle_get_bool(struct lwm2m_res_handle *handle,
+				 bool *value)
+{
+	int ret = 0;
+	s8_t temp = 0;
+
+	ret = lwm2m_engine_handle_get_s8(handle, &temp);
+	if (!ret) {
+		*value = temp != 0;
+	}
+
+	return ret;
+}
+
+int lwm2m_engine_handle_get_float32(struct lwm2m_res_handle *handle,
+				    float32_value_t *buf)
+{
+	return lwm2m_engine_handle_get(handle, buf, sizeof(float32_value_t));
+}
+
+int lwm2m_engine_handle_get_float64(struct lwm2m_res_handle *handle,
+				    float64_value_t *buf)
+{
+	return lwm2m_engine_handle_get(handle, buf, sizeof(float64_value_t));
+}
+
 int lwm2m_engine_get_resource(char *pathstr, struct lwm2m_engine_res_inst **res)
 {
 	int ret;
@@ -2588,6 +2951,7 @@ static int lwm2m_write_attr_handler(struct lwm2m_engine_obj *obj,
 			    nattrs.pmin, max(nattrs.pmin, nattrs.pmax));
 		obs->min_period_sec = (u32_t)nattrs.pmin;
 		obs->max_period_sec = (u32_t)max(nattrs.pmin, nattrs.pmax);
+		observer_schedule(obs);
 		memset(&nattrs, 0, sizeof(nattrs));
 	}
 
@@ -3021,6 +3385,11 @@ static int do_write_op(struct lwm2m_engine_obj *obj,
 		return do_write_op_json(obj, context);
 #endif
 
+#ifdef CONFIG_LWM2M_RW_SENML_CBOR_SUPPORT
+	case LWM2M_FORMAT_APP_SENML_CBOR:
+		return do_write_op_senml_cbor(obj, context);
+#endif
+
 	default:
 		SYS_LOG_ERR("Unsupported format: %u", format);
 		return -ENOMSG;
@@ -3417,6 +3786,11 @@ void lwm2m_udp_receive(struct lwm2m_ctx *client_ctx, struct net_pkt *pkt,
 		if (msg) {
 			msg->pending = NULL;
 		}
+
+#if defined(CONFIG_COAP_COCOA)
+		/* an exchange completed: deferred requests may be sent */
+		k_delayed_work_submit(&client_ctx->retransmit_work, K_NO_WAIT);
+#endif
 	}
 
 	SYS_LOG_DBG("checking for reply from [%s]",
@@ -3516,23 +3890,15 @@ static void udp_receive(struct net_app_ctx *app_ctx, struct net_pkt *pkt,
 	lwm2m_udp_receive(client_ctx, pkt, false, handle_request);
 }
 
-static void retransmit_request(struct k_work *work)
+static void retransmit_pending(struct coap_pending *pending)
 {
-	struct lwm2m_ctx *client_ctx;
 	struct lwm2m_message *msg;
-	struct coap_pending *pending;
 	int r;
 
-	client_ctx = CONTAINER_OF(work, struct lwm2m_ctx, retransmit_work);
-	pending = coap_pending_next_to_expire(client_ctx->pendings,
-					      CONFIG_LWM2M_ENGINE_MAX_PENDING);
-	if (!pending) {
-		return;
-	}
-
 	msg = find_msg(pending, NULL);
 	if (!msg) {
 		SYS_LOG_ERR("pending has no valid LwM2M message!");
+		coap_pending_clear(pending);
 		return;
 	}
 
@@ -3573,7 +3939,56 @@ static void retransmit_request(struct k_work *work)
 
 	/* unref to balance ref we made for sendto() */
 	net_pkt_unref(pending->pkt);
-	k_delayed_work_submit(&client_ctx->retransmit_work, pending->timeout);
+}
+
+#if defined(CONFIG_COAP_COCOA)
+static void send_deferred_messages(struct lwm2m_ctx *client_ctx)
+{
+	struct lwm2m_message *msg;
+	size_t i;
+	int r;
+
+	for (i = 0; i < CONFIG_LWM2M_ENGINE_MAX_MESSAGES; i++) {
+		msg = &messages[i];
+		if (msg->ctx != client_ctx || !msg->send_deferred) {
+			continue;
+		}
+
+		/* deferred again if NSTART is still reached */
+		r = lwm2m_send_message(msg);
+		if (r < 0) {
+			SYS_LOG_ERR("Error sending deferred message: %d", r);
+			lwm2m_reset_message(msg, true);
+		}
+	}
+}
+#endif
+
+static void retransmit_request(struct k_work *work)
+{
+	struct lwm2m_ctx *client_ctx;
+	struct coap_pending *pending;
+	s32_t timeout;
+
+	client_ctx = CONTAINER_OF(work, struct lwm2m_ctx, retransmit_work);
+
+	/* handle every pending whose deadline has passed */
+	while (!coap_pending_next_timeout(client_ctx->pendings,
+					  CONFIG_LWM2M_ENGINE_MAX_PENDING)) {
+		pending = coap_pending_next_to_expire(client_ctx->pendings,
+					CONFIG_LWM2M_ENGINE_MAX_PENDING);
+		retransmit_pending(pending);
+	}
+
+#if defined(CONFIG_COAP_COCOA)
+	send_deferred_messages(client_ctx);
+#endif
+
+	timeout = coap_pending_next_timeout(client_ctx->pendings,
+					    CONFIG_LWM2M_ENGINE_MAX_PENDING);
+	if (timeout != K_FOREVER) {
+		k_delayed_work_submit(&client_ctx->retransmit_work, timeout);
+	}
 }
 
 static int notify_message_reply_cb(const struct coap_packet *response,
@@ -3753,47 +4168,122 @@ int lwm2m_engine_add_service(void (*service)(void), u32_t period_ms)
 
 	sys_slist_append(&engine_service_list,
 			 &service_node_data[i].node);
+	k_sem_give(&engine_wake_sem);
 
 	return 0;
 }
 
-/* TODO: this needs to be triggered via work_queue */
+static struct observe_node *observer_wheel_pop_due(u8_t slot,
+						   s64_t timestamp)
+{
+	struct observe_node *obs;
+	unsigned int key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&observe_wheel[slot], obs, wheel_node) {
+		if (obs->due_timestamp <= timestamp) {
+			observer_wheel_remove(obs);
+			irq_unlock(key);
+			return obs;
+		}
+	}
+
+	irq_unlock(key);
+	return NULL;
+}
+
+/* return the time in ms till the next observer is due, or K_FOREVER */
+static s32_t observer_next_timeout_ms(s64_t timestamp)
+{
+	struct observe_node *obs;
+	s64_t sec, now_sec = timestamp / MSEC_PER_SEC;
+	s64_t end = K_SECONDS(now_sec + OBSERVE_WHEEL_SLOTS);
+	s64_t due = 0;
+	bool empty = true, found = false;
+	unsigned int key = irq_lock();
+
+	for (sec = now_sec; sec < now_sec + OBSERVE_WHEEL_SLOTS; sec++) {
+		SYS_SLIST_FOR_EACH_CONTAINER(
+				&observe_wheel[sec % OBSERVE_WHEEL_SLOTS],
+				obs, wheel_node) {
+			empty = false;
+
+			/* due in a later revolution of the wheel */
+			if (obs->due_timestamp >= end) {
+				continue;
+			}
+
+			if (!found || obs->due_timestamp < due) {
+				due = obs->due_timestamp;
+				found = true;
+			}
+		}
+
+		if (found) {
+			break;
+		}
+	}
+
+	irq_unlock(key);
+
+	if (found) {
+		return due > timestamp ? (s32_t)(due - timestamp) : 0;
+	}
+
+	/* only far deadlines left: come back after one revolution */
+	return empty ? K_FOREVER : K_SECONDS(OBSERVE_WHEEL_SLOTS);
+}
+
 static void lwm2m_engine_service(void)
 {
 	struct observe_node *obs;
 	struct service_node *srv;
-	s64_t timestamp, service_due_timestamp;
+	s64_t timestamp, service_due_timestamp, sec, start_sec;
+	s32_t timeout;
+	unsigned int key;
+	bool manual;
 
 	while (true) {
 		/*
-		 * 1. scan the observer list
-		 * 2. For each notify event found, scan the observer list
-		 * 3. For each observer match, generate a NOTIFY message,
-		 *    attaching the notify response handler
+		 * 1. advance the observer wheel up to the current second
+		 * 2. for each observer whose deadline has passed, generate
+		 *    a NOTIFY message, attaching the notify response handler
+		 * 3. put the observer back on the wheel at its next deadline
 		 */
 		timestamp = k_uptime_get();
-		SYS_SLIST_FOR_EACH_CONTAINER(&engine_observer_list, obs, node) {
-			/*
-			 * manual notify requirements:
-			 * - event_timestamp > last_timestamp
-			 * - current timestamp > last_timestamp + min_period_sec
-			 */
-			if (obs->event_timestamp > obs->last_timestamp &&
-			    timestamp > obs->last_timestamp +
-					K_SECONDS(obs->min_period_sec)) {
-				obs->last_timestamp = k_uptime_get();
-				generate_notify_message(obs, true);
 
-			/*
-			 * automatic time-based notify requirements:
-			 * - current timestamp > last_timestamp + max_period_sec
-			 */
-			} else if (timestamp > obs->last_timestamp +
-					K_SECONDS(obs->min_period_sec)) {
+		/*
+		 * Move the wheel position first, observers scheduled from
+		 * now on land in the current slot or later ones.
+		 */
+		key = irq_lock();
+		start_sec = observe_wheel_sec;
+		observe_wheel_sec = timestamp / MSEC_PER_SEC;
+		irq_unlock(key);
+
+		if (observe_wheel_sec - start_sec >= OBSERVE_WHEEL_SLOTS) {
+			start_sec = observe_wheel_sec - OBSERVE_WHEEL_SLOTS + 1;
+		}
+
+		for (sec = start_sec; sec <= observe_wheel_sec; sec++) {
+			while ((obs = observer_wheel_pop_due(
+					sec % OBSERVE_WHEEL_SLOTS,
+					timestamp))) {
+				/*
+				 * manual notify: a resource changed and
+				 * min_period_sec has passed, otherwise this
+				 * is the time-based notify after
+				 * max_period_sec
+				 */
+				manual = obs->event_timestamp >
+					 obs->last_timestamp;
 				obs->last_timestamp = k_uptime_get();
-				generate_notify_message(obs, false);
-			}
+				generate_notify_message(obs, manual);
 
+				/* the observer may have been cancelled */
+				if (obs->ctx) {
+					observer_schedule(obs);
+				}
+			}
 		}
 
 		timestamp = k_uptime_get();
@@ -3811,8 +4301,10 @@ static void lwm2m_engine_service(void)
 			}
 		}
 
-		/* calculate how long to sleep till the next service */
-		k_sleep(engine_next_service_timeout_ms(ENGINE_UPDATE_INTERVAL));
+		/* sleep till the next observer or service is due */
+		timeout = engine_next_service_timeout_ms(
+				observer_next_timeout_ms(k_uptime_get()));
+		k_sem_take(&engine_wake_sem, timeout);
 	}
 }
 
@@ -17,6 +17,7 @@
 #define LWM2M_FORMAT_APP_OCTET_STREAM	42
 #define LWM2M_FORMAT_APP_EXI		47
 #define LWM2M_FORMAT_APP_JSON		50
+#define LWM2M_FORMAT_APP_SENML_CBOR	112
 #define LWM2M_FORMAT_OMA_PLAIN_TEXT	1541
 #define LWM2M_FORMAT_OMA_OLD_TLV	1542
 #define LWM2M_FORMAT_OMA_OLD_JSON	1543
@@ -72,6 +73,9 @@ struct lwm2m_message {
 
 	/** Counter for message re-send / abort handling */
 	u8_t send_attempts;
+
+	/** Held back until fewer than NSTART exchanges are outstanding */
+	bool send_deferred;
 };
 
 /* Establish a request handler callback type */
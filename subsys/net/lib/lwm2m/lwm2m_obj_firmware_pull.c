@@ -35,6 +35,34 @@ static struct lwm2m_ctx firmware_ctx;
 static int firmware_retry;
 static struct coap_block_context firmware_block_ctx;
 
+#define PULL_WINDOW CONFIG_LWM2M_FIRMWARE_UPDATE_PULL_WINDOW
+#define PULL_BLOCK_SIZE CONFIG_LWM2M_FIRMWARE_UPDATE_PULL_BLOCK_SIZE
+
+#if PULL_WINDOW >= CONFIG_LWM2M_ENGINE_MAX_PENDING || \
+	PULL_WINDOW >= CONFIG_LWM2M_ENGINE_MAX_REPLIES
+#error "Firmware pull window larger than the LWM2M engine pending replies"
+#endif
+
+/* A block request in flight, or the block received ahead of the data
+ * written so far.
+ */
+struct firmware_block {
+	u8_t token[8];
+	size_t offset;
+	u16_t len;
+	bool in_use;
+	bool received;
+	bool last;
+};
+
+static struct firmware_block firmware_blocks[PULL_WINDOW];
+static u8_t firmware_block_data[PULL_WINDOW][PULL_BLOCK_SIZE];
+/* next offset given to the write callback, and to be requested */
+static size_t firmware_write_offset;
+static size_t firmware_request_offset;
+/* block size and image size settled by the first reply */
+static bool firmware_negotiated;
+
 #if defined(CONFIG_LWM2M_FIRMWARE_UPDATE_PULL_COAP_PROXY_SUPPORT)
 #define COAP2COAP_PROXY_URI_PATH	"coap2coap"
 #define COAP2HTTP_PROXY_URI_PATH	"coap2http"
@@ -43,6 +71,10 @@ static char proxy_uri[URI_LEN];
 #endif
 
 static void do_transmit_timeout_cb(struct lwm2m_message *msg);
+static int
+do_firmware_transfer_reply_cb(const struct coap_packet *response,
+			      struct coap_reply *reply,
+			      const struct sockaddr *from);
 
 static void
 firmware_udp_receive(struct net_app_ctx *app_ctx, struct net_pkt *pkt,
@@ -247,23 +279,187 @@ cleanup:
 	return ret;
 }
 
+/* Pick up the request a reply is for */
+static struct firmware_block *find_block(u8_t *token, u8_t tkl)
+{
+	int i;
+
+	if (tkl != sizeof(firmware_blocks[0].token)) {
+		return NULL;
+	}
+
+	for (i = 0; i < PULL_WINDOW; i++) {
+		if (firmware_blocks[i].in_use && !firmware_blocks[i].received &&
+		    !memcmp(firmware_blocks[i].token, token, tkl)) {
+			return &firmware_blocks[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int request_block(struct firmware_block *block, size_t offset)
+{
+	struct coap_block_context ctx = firmware_block_ctx;
+	int ret;
+
+	ctx.current = offset;
+	memcpy(block->token, coap_next_token(), sizeof(block->token));
+	block->offset = offset;
+	block->received = false;
+	block->in_use = true;
+
+	ret = transfer_request(&ctx, block->token, sizeof(block->token),
+			       do_firmware_transfer_reply_cb);
+	if (ret < 0) {
+		block->in_use = false;
+	}
+
+	return ret;
+}
+
+/* Keep the window of block requests full */
+static int request_blocks(void)
+{
+	size_t bytes = coap_block_size_to_bytes(firmware_block_ctx.block_size);
+	size_t total = firmware_block_ctx.total_size;
+	int window = 1;
+	int i, ret;
+
+	/* Blocks are requested one at a time until the block size is
+	 * settled and the size of the image known, so as not to ask for
+	 * blocks past its end.
+	 */
+	if (firmware_negotiated && total) {
+		window = PULL_WINDOW;
+	}
+
+	for (i = 0; i < window; i++) {
+		if (firmware_blocks[i].in_use) {
+			continue;
+		}
+
+		if (firmware_request_offset >=
+		    firmware_write_offset + window * bytes ||
+		    (total && firmware_request_offset >= total)) {
+			break;
+		}
+
+		ret = request_block(&firmware_blocks[i],
+				    firmware_request_offset);
+		if (ret < 0) {
+			return ret;
+		}
+
+		firmware_request_offset += bytes;
+	}
+
+	return 0;
+}
+
+static int write_payload(struct net_buf *payload_frag, u16_t payload_offset,
+			 u16_t payload_len, bool last_block)
+{
+	struct lwm2m_engine_res_inst *res = NULL;
+	lwm2m_engine_set_data_cb_t write_cb;
+	size_t write_buflen;
+	u8_t *write_buf;
+	u16_t len;
+	int ret;
+
+	/* look up firmware package resource */
+	ret = lwm2m_engine_get_resource("5/0/0", &res);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* get buffer data */
+	write_buf = res->data_ptr;
+	write_buflen = res->data_len;
+
+	/* check for user override to buffer */
+	if (res->pre_write_cb) {
+		write_buf = res->pre_write_cb(0, &write_buflen);
+	}
+
+	write_cb = lwm2m_firmware_get_write_cb();
+	if (!write_cb) {
+		return 0;
+	}
+
+	/* flush incoming data to write_cb */
+	while (payload_len > 0) {
+		len = (payload_len > write_buflen) ?
+		       write_buflen : payload_len;
+		payload_len -= len;
+		payload_frag = net_frag_read(payload_frag, payload_offset,
+					     &payload_offset, len, write_buf);
+		/* check for end of packet */
+		if (!payload_frag && payload_offset == 0xffff) {
+			/* malformed packet */
+			return -EFAULT;
+		}
+
+		ret = write_cb(0, write_buf, len, !payload_frag && last_block,
+			       firmware_block_ctx.total_size);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+/* Write the blocks received ahead which now follow the written data */
+static int write_buffered_blocks(bool *done)
+{
+	lwm2m_engine_set_data_cb_t write_cb = lwm2m_firmware_get_write_cb();
+	struct firmware_block *block;
+	int i, ret;
+
+	for (i = 0; i < PULL_WINDOW; i++) {
+		block = &firmware_blocks[i];
+		if (!block->in_use || !block->received ||
+		    block->offset != firmware_write_offset) {
+			continue;
+		}
+
+		if (write_cb) {
+			ret = write_cb(0, firmware_block_data[i], block->len,
+				       block->last,
+				       firmware_block_ctx.total_size);
+			if (ret < 0) {
+				return ret;
+			}
+		}
+
+		block->in_use = false;
+		firmware_write_offset += block->len;
+		*done = block->last;
+
+		/* start over, the next one may be in an earlier slot */
+		i = -1;
+	}
+
+	return 0;
+}
+
 static int
 do_firmware_transfer_reply_cb(const struct coap_packet *response,
 			      struct coap_reply *reply,
 			      const struct sockaddr *from)
 {
 	int ret;
-	bool last_block;
+	bool last_block, done = false;
 	u8_t token[8];
 	u8_t tkl;
-	u16_t payload_len, payload_offset, len;
+	u16_t payload_len, payload_offset;
 	struct net_buf *payload_frag;
 	struct coap_packet *check_response = (struct coap_packet *)response;
-	struct lwm2m_engine_res_inst *res = NULL;
-	lwm2m_engine_set_data_cb_t write_cb;
-	size_t write_buflen;
-	u8_t resp_code, *write_buf;
+	struct firmware_block *block;
+	u8_t resp_code;
 	struct coap_block_context received_block_ctx;
+	size_t bytes;
 
 	/* token is used to determine a valid ACK vs a separated response */
 	tkl = coap_header_get_token(check_response, token);
@@ -280,6 +476,12 @@ do_firmware_transfer_reply_cb(const struct coap_packet *response,
 		}
 	}
 
+	block = find_block(token, tkl);
+	if (!block) {
+		SYS_LOG_WRN("Duplicate or aborted packet ignored");
+		return 0;
+	}
+
 	/* Check response code from server. Expecting (2.05) */
 	resp_code = coap_header_get_code(check_response);
 	if (resp_code != COAP_RESPONSE_CODE_CONTENT) {
@@ -290,119 +492,128 @@ do_firmware_transfer_reply_cb(const struct coap_packet *response,
 		goto error;
 	}
 
-	/* save main firmware block context */
-	memcpy(&received_block_ctx, &firmware_block_ctx,
-	       sizeof(firmware_block_ctx));
+	/* the server may answer with smaller blocks than requested */
+	coap_block_transfer_init(&received_block_ctx,
+				 firmware_block_ctx.block_size,
+				 firmware_block_ctx.total_size);
 
-	ret = coap_update_from_block(check_response, &firmware_block_ctx);
-	if (ret < 0) {
+	ret = coap_update_from_block(check_response, &received_block_ctx);
+	if (ret < 0 || received_block_ctx.current != block->offset) {
 		SYS_LOG_ERR("Error from block update: %d", ret);
 		ret = -EFAULT;
 		goto error;
 	}
 
-	/* test for duplicate transfer */
-	if (firmware_block_ctx.current < received_block_ctx.current) {
-		SYS_LOG_WRN("Duplicate packet ignored");
-
-		/* restore main firmware block context */
-		memcpy(&firmware_block_ctx, &received_block_ctx,
-		       sizeof(firmware_block_ctx));
-
-		/* set reply->user_data to error to avoid releasing */
-		reply->user_data = (void *)COAP_REPLY_STATUS_ERROR;
-		return 0;
+	if (!firmware_negotiated) {
+		/* Only this first request was in flight */
+		firmware_block_ctx.block_size = received_block_ctx.block_size;
+		firmware_block_ctx.total_size = received_block_ctx.total_size;
+		firmware_request_offset = block->offset +
+			coap_block_size_to_bytes(firmware_block_ctx.block_size);
+		firmware_negotiated = true;
+	} else if (received_block_ctx.block_size !=
+		   firmware_block_ctx.block_size) {
+		SYS_LOG_ERR("Block size changed during transfer");
+		ret = -EFAULT;
+		goto error;
 	}
 
+	bytes = coap_block_size_to_bytes(firmware_block_ctx.block_size);
+
 	/* Reach last block if ret equals to 0 */
-	last_block = !coap_next_block(check_response, &firmware_block_ctx);
+	last_block = !coap_next_block(check_response, &received_block_ctx);
 
-	/* Process incoming data */
 	payload_frag = coap_packet_get_payload(check_response, &payload_offset,
 					       &payload_len);
-	if (payload_len > 0) {
-		SYS_LOG_DBG("total: %zd, current: %zd",
-			    firmware_block_ctx.total_size,
-			    firmware_block_ctx.current);
+	if (payload_len > bytes || (!last_block && payload_len != bytes)) {
+		SYS_LOG_ERR("Invalid block length %u", payload_len);
+		ret = -EFAULT;
+		goto error;
+	}
 
-		/* look up firmware package resource */
-		ret = lwm2m_engine_get_resource("5/0/0", &res);
-		if (ret < 0) {
-			goto error;
-		}
+	SYS_LOG_DBG("total: %zd, offset: %zd", firmware_block_ctx.total_size,
+		    block->offset);
 
-		/* get buffer data */
-		write_buf = res->data_ptr;
-		write_buflen = res->data_len;
+	if (last_block) {
+		/* no block past this one is requested any more */
+		firmware_block_ctx.total_size = block->offset + payload_len;
+	}
 
-		/* check for user override to buffer */
-		if (res->pre_write_cb) {
-			write_buf = res->pre_write_cb(0, &write_buflen);
+	if (block->offset != firmware_write_offset) {
+		/* Received ahead, keep it until the preceding ones are in */
+		payload_frag = net_frag_read(payload_frag, payload_offset,
+					     &payload_offset, payload_len,
+				firmware_block_data[block - firmware_blocks]);
+		if (!payload_frag && payload_offset == 0xffff) {
+			ret = -EFAULT;
+			goto error;
 		}
 
-		write_cb = lwm2m_firmware_get_write_cb();
-		if (write_cb) {
-			/* flush incoming data to write_cb */
-			while (payload_len > 0) {
-				len = (payload_len > write_buflen) ?
-				       write_buflen : payload_len;
-				payload_len -= len;
-				payload_frag = net_frag_read(payload_frag,
-							     payload_offset,
-							     &payload_offset,
-							     len,
-							     write_buf);
-				/* check for end of packet */
-				if (!payload_frag && payload_offset == 0xffff) {
-					/* malformed packet */
-					ret = -EFAULT;
-					goto error;
-				}
-
-				ret = write_cb(0, write_buf, len,
-					       !payload_frag && last_block,
-					       firmware_block_ctx.total_size);
-				if (ret < 0) {
-					goto error;
-				}
-			}
+		block->len = payload_len;
+		block->last = last_block;
+		block->received = true;
+	} else {
+		ret = write_payload(payload_frag, payload_offset, payload_len,
+				    last_block);
+		if (ret < 0) {
+			goto error;
 		}
-	}
 
-	if (!last_block) {
-		/* More block(s) to come, setup next transfer */
-		ret = transfer_request(&firmware_block_ctx, token, tkl,
-				       do_firmware_transfer_reply_cb);
+		block->in_use = false;
+		firmware_write_offset += payload_len;
+		done = last_block;
+
+		ret = write_buffered_blocks(&done);
 		if (ret < 0) {
 			goto error;
 		}
-	} else {
+	}
+
+	if (done) {
 		/* Download finished */
 		lwm2m_firmware_set_update_state(STATE_DOWNLOADED);
+		return 0;
+	}
+
+	/* More block(s) to come, setup next transfers */
+	ret = request_blocks();
+	if (ret < 0) {
+		goto error;
 	}
 
 	return 0;
 
 error:
+	/* replies to the requests still in flight are ignored */
+	memset(firmware_blocks, 0, sizeof(firmware_blocks));
 	set_update_result_from_error(ret);
 	return ret;
 }
 
 static void do_transmit_timeout_cb(struct lwm2m_message *msg)
 {
+	struct coap_block_context ctx = firmware_block_ctx;
+	struct firmware_block *block;
 	u8_t token[8];
 	u8_t tkl;
 	int ret;
 
+	tkl = coap_header_get_token(&msg->cpkt, token);
+	block = find_block(token, tkl);
+	if (!block) {
+		return;
+	}
+
 	if (firmware_retry < PACKET_TRANSFER_RETRY_MAX) {
 		/* retry block */
 		SYS_LOG_WRN("TIMEOUT - Sending a retry packet!");
-		tkl = coap_header_get_token(&msg->cpkt, token);
+		ctx.current = block->offset;
 
-		ret = transfer_request(&firmware_block_ctx, token, tkl,
+		ret = transfer_request(&ctx, block->token, tkl,
 				       do_firmware_transfer_reply_cb);
 		if (ret < 0) {
 			/* abort retries / transfer */
+			memset(firmware_blocks, 0, sizeof(firmware_blocks));
 			set_update_result_from_error(ret);
 			firmware_retry = PACKET_TRANSFER_RETRY_MAX;
 			return;
@@ -412,6 +623,7 @@ static void do_transmit_timeout_cb(struct lwm2m_message *msg)
 	} else {
 		SYS_LOG_ERR("TIMEOUT - Too many retry packet attempts! "
 			    "Aborting firmware download.");
+		memset(firmware_blocks, 0, sizeof(firmware_blocks));
 		lwm2m_firmware_set_update_result(RESULT_CONNECTION_LOST);
 	}
 }
@@ -527,11 +739,15 @@ static void firmware_transfer(struct k_work *work)
 		goto cleanup;
 	}
 
-	/* reset block transfer context */
+	/* reset block transfer context, asking for the largest blocks */
 	coap_block_transfer_init(&firmware_block_ctx,
-				 lwm2m_default_block_size(), 0);
-	ret = transfer_request(&firmware_block_ctx, coap_next_token(), 8,
-			       do_firmware_transfer_reply_cb);
+				 find_msb_set(PULL_BLOCK_SIZE) - 5, 0);
+	memset(firmware_blocks, 0, sizeof(firmware_blocks));
+	firmware_write_offset = 0;
+	firmware_request_offset = 0;
+	firmware_negotiated = false;
+
+	ret = request_blocks();
 	if (ret < 0) {
 		goto cleanup;
 	}
@@ -0,0 +1,887 @@
+/*
+ * Copyright (c) 2017 Linaro Limited
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * SenML CBOR (RFC 8428) content format.
+ *
+ * A payload is an array of records, each record a map keyed by small
+ * integers.  The first record carries the base name "/obj/inst/", every
+ * record names its resource relative to it:
+ *
+ *   [{-2: "/3/0/", 0: "0", 3: "Zephyr"}, {0: "9", 2: 80}, ...]
+ *
+ * The writer encodes directly into the CoAP packet.  The record array is
+ * written with indefinite length so nothing has to be counted or moved
+ * once the resources have been written.  The reader decodes values in
+ * place from the received fragments.
+ */
+
+#define SYS_LOG_DOMAIN "lib/lwm2m_senml_cbor"
+#define SYS_LOG_LEVEL CONFIG_SYS_LOG_LWM2M_LEVEL
+#include <logging/sys_log.h>
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ctype.h>
+
+#include "lwm2m_object.h"
+#include "lwm2m_rw_senml_cbor.h"
+#include "lwm2m_engine.h"
+
+/* CBOR major types */
+#define CBOR_UINT		0
+#define CBOR_NINT		1
+#define CBOR_BYTES		2
+#define CBOR_TEXT		3
+#define CBOR_ARRAY		4
+#define CBOR_MAP		5
+#define CBOR_TAG		6
+#define CBOR_SIMPLE		7
+
+/* CBOR additional information */
+#define CBOR_INFO_U8		24
+#define CBOR_INFO_U16		25
+#define CBOR_INFO_U32		26
+#define CBOR_INFO_U64		27
+#define CBOR_INFO_INDEFINITE	31
+
+/* simple values and floats (major type 7) */
+#define CBOR_FALSE		20
+#define CBOR_TRUE		21
+#define CBOR_FLOAT16		CBOR_INFO_U16
+#define CBOR_FLOAT32		CBOR_INFO_U32
+#define CBOR_FLOAT64		CBOR_INFO_U64
+
+#define CBOR_BREAK		0xff
+
+/* SenML labels */
+#define SENML_BASE_NAME		-2
+#define SENML_NAME		0
+#define SENML_VALUE		2
+#define SENML_STRING_VALUE	3
+#define SENML_BOOL_VALUE	4
+#define SENML_DATA_VALUE	8
+
+/* "/65535/65535/" or "65535/65535" */
+#define SENML_NAME_LEN		16
+
+static size_t cbor_put(struct lwm2m_output_context *out,
+		       const void *buf, size_t len)
+{
+	out->frag = net_pkt_write(out->out_cpkt->pkt, out->frag,
+				  out->offset, &out->offset, len, (u8_t *)buf,
+				  BUF_ALLOC_TIMEOUT);
+	if (!out->frag && out->offset == 0xffff) {
+		/* TODO: Generate error? */
+		return 0;
+	}
+
+	return len;
+}
+
+/* initial byte followed by a big endian value of size bytes */
+static size_t cbor_put_raw(struct lwm2m_output_context *out, u8_t initial,
+			   u64_t value, u8_t size)
+{
+	u8_t buf[9];
+	int i;
+
+	buf[0] = initial;
+	for (i = size; i > 0; i--) {
+		buf[i] = value & 0xff;
+		value >>= 8;
+	}
+
+	return cbor_put(out, buf, size + 1);
+}
+
+static size_t cbor_put_header(struct lwm2m_output_context *out, u8_t major,
+			      u64_t value)
+{
+	u8_t initial = major << 5;
+
+	if (value < CBOR_INFO_U8) {
+		return cbor_put_raw(out, initial | value, 0, 0);
+	} else if (value <= 0xff) {
+		return cbor_put_raw(out, initial | CBOR_INFO_U8, value, 1);
+	} else if (value <= 0xffff) {
+		return cbor_put_raw(out, initial | CBOR_INFO_U16, value, 2);
+	} else if (value <= 0xffffffff) {
+		return cbor_put_raw(out, initial | CBOR_INFO_U32, value, 4);
+	}
+
+	return cbor_put_raw(out, initial | CBOR_INFO_U64, value, 8);
+}
+
+static size_t cbor_put_int(struct lwm2m_output_context *out, s64_t value)
+{
+	if (value < 0) {
+		return cbor_put_header(out, CBOR_NINT, (u64_t)(-(value + 1)));
+	}
+
+	return cbor_put_header(out, CBOR_UINT, (u64_t)value);
+}
+
+static size_t cbor_put_string(struct lwm2m_output_context *out, u8_t major,
+			      const char *buf, size_t buflen)
+{
+	size_t len;
+
+	len = cbor_put_header(out, major, buflen);
+	if (len == 0) {
+		return 0;
+	}
+
+	if (buflen > 0) {
+		if (cbor_put(out, buf, buflen) == 0) {
+			return 0;
+		}
+	}
+
+	return len + buflen;
+}
+
+/* use the shortest float encoding which keeps the value */
+static size_t cbor_put_float(struct lwm2m_output_context *out, double value)
+{
+	union {
+		float f;
+		u32_t u;
+	} f32;
+	union {
+		double d;
+		u64_t u;
+	} f64;
+
+	f32.f = (float)value;
+	if ((double)f32.f == value) {
+		return cbor_put_raw(out, (CBOR_SIMPLE << 5) | CBOR_FLOAT32,
+				    f32.u, 4);
+	}
+
+	f64.d = value;
+	return cbor_put_raw(out, (CBOR_SIMPLE << 5) | CBOR_FLOAT64, f64.u, 8);
+}
+
+/* record header up to the value label, the value itself comes next */
+static size_t put_record(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path, s8_t label)
+{
+	bool first = !(out->writer_flags & WRITER_OUTPUT_VALUE);
+	char name[SENML_NAME_LEN];
+	size_t len;
+	int name_len;
+
+	len = cbor_put_header(out, CBOR_MAP, first ? 3 : 2);
+
+	if (first) {
+		name_len = snprintk(name, sizeof(name), "/%u/%u/",
+				    path->obj_id, path->obj_inst_id);
+		len += cbor_put_int(out, SENML_BASE_NAME);
+		len += cbor_put_string(out, CBOR_TEXT, name, name_len);
+		out->writer_flags |= WRITER_OUTPUT_VALUE;
+	}
+
+	if (out->writer_flags & WRITER_RESOURCE_INSTANCE) {
+		name_len = snprintk(name, sizeof(name), "%u/%u",
+				    path->res_id, path->res_inst_id);
+	} else {
+		name_len = snprintk(name, sizeof(name), "%u", path->res_id);
+	}
+
+	len += cbor_put_int(out, SENML_NAME);
+	len += cbor_put_string(out, CBOR_TEXT, name, name_len);
+	len += cbor_put_int(out, label);
+
+	return len;
+}
+
+static size_t put_begin(struct lwm2m_output_context *out,
+			struct lwm2m_obj_path *path)
+{
+	out->writer_flags = 0;
+	return cbor_put_raw(out, (CBOR_ARRAY << 5) | CBOR_INFO_INDEFINITE,
+			    0, 0);
+}
+
+static size_t put_end(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path)
+{
+	return cbor_put_raw(out, CBOR_BREAK, 0, 0);
+}
+
+static size_t put_begin_ri(struct lwm2m_output_context *out,
+			   struct lwm2m_obj_path *path)
+{
+	out->writer_flags |= WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+static size_t put_end_ri(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path)
+{
+	out->writer_flags &= ~WRITER_RESOURCE_INSTANCE;
+	return 0;
+}
+
+static size_t put_s64(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, s64_t value)
+{
+	size_t len;
+
+	len = put_record(out, path, SENML_VALUE);
+	len += cbor_put_int(out, value);
+	return len;
+}
+
+static size_t put_s32(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, s32_t value)
+{
+	return put_s64(out, path, (s64_t)value);
+}
+
+static size_t put_s16(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path, s16_t value)
+{
+	return put_s64(out, path, (s64_t)value);
+}
+
+static size_t put_s8(struct lwm2m_output_context *out,
+		     struct lwm2m_obj_path *path, s8_t value)
+{
+	return put_s64(out, path, (s64_t)value);
+}
+
+static size_t put_string(struct lwm2m_output_context *out,
+			 struct lwm2m_obj_path *path,
+			 char *buf, size_t buflen)
+{
+	size_t len;
+
+	len = put_record(out, path, SENML_STRING_VALUE);
+	len += cbor_put_string(out, CBOR_TEXT, buf, buflen);
+	return len;
+}
+
+/* whole numbers are sent as integers, they are shorter than floats */
+static size_t put_fix(struct lwm2m_output_context *out,
+		      struct lwm2m_obj_path *path,
+		      s64_t val1, s64_t val2, double scale)
+{
+	double value;
+	size_t len;
+
+	if (val2 == 0) {
+		return put_s64(out, path, val1);
+	}
+
+	value = (double)(val2 < 0 ? -val2 : val2) / scale;
+	if (val1 < 0 || val2 < 0) {
+		value = (double)val1 - value;
+	} else {
+		value = (double)val1 + value;
+	}
+
+	len = put_record(out, path, SENML_VALUE);
+	len += cbor_put_float(out, value);
+	return len;
+}
+
+static size_t put_float32fix(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path,
+			     float32_value_t *value)
+{
+	return put_fix(out, path, value->val1, value->val2, 1000000.0);
+}
+
+static size_t put_float64fix(struct lwm2m_output_context *out,
+			     struct lwm2m_obj_path *path,
+			     float64_value_t *value)
+{
+	return put_fix(out, path, value->val1, value->val2, 1000000000.0);
+}
+
+static size_t put_bool(struct lwm2m_output_context *out,
+		       struct lwm2m_obj_path *path,
+		       bool value)
+{
+	size_t len;
+
+	len = put_record(out, path, SENML_BOOL_VALUE);
+	len += cbor_put_raw(out, (CBOR_SIMPLE << 5) |
+				 (value ? CBOR_TRUE : CBOR_FALSE), 0, 0);
+	return len;
+}
+
+const struct lwm2m_writer senml_cbor_writer = {
+	put_begin,
+	put_end,
+	put_begin_ri,
+	put_end_ri,
+	put_s8,
+	put_s16,
+	put_s32,
+	put_s64,
+	put_string,
+	put_float32fix,
+	put_float64fix,
+	put_bool,
+	NULL
+};
+
+/*
+ * Read an item header.  For integers and floats value holds the number
+ * (or its bits), for strings, arrays and maps the length.  Returns the
+ * number of bytes read or 0 on error.
+ */
+static size_t cbor_get_header(struct lwm2m_input_context *in,
+			      u8_t *major, u8_t *info, u64_t *value)
+{
+	u8_t initial, buf[8];
+	size_t size = 0, i;
+
+	if (!in->frag) {
+		return 0;
+	}
+
+	in->frag = net_frag_read_u8(in->frag, in->offset, &in->offset,
+				    &initial);
+	if (!in->frag && in->offset == 0xffff) {
+		return 0;
+	}
+
+	*major = initial >> 5;
+	*info = initial & 0x1f;
+	*value = *info;
+
+	if (*info >= CBOR_INFO_U8 && *info <= CBOR_INFO_U64) {
+		size = 1 << (*info - CBOR_INFO_U8);
+		if (!in->frag) {
+			return 0;
+		}
+
+		in->frag = net_frag_read(in->frag, in->offset, &in->offset,
+					 size, buf);
+		if (!in->frag && in->offset == 0xffff) {
+			return 0;
+		}
+
+		*value = 0;
+		for (i = 0; i < size; i++) {
+			*value = (*value << 8) | buf[i];
+		}
+	} else if (*info > CBOR_INFO_U64 && *info != CBOR_INFO_INDEFINITE) {
+		SYS_LOG_ERR("reserved additional info %u", *info);
+		return 0;
+	}
+
+	return 1 + size;
+}
+
+static bool cbor_to_double(u8_t info, u64_t value, double *result)
+{
+	union {
+		float f;
+		u32_t u;
+	} f32;
+	union {
+		double d;
+		u64_t u;
+	} f64;
+	int exp;
+
+	switch (info) {
+
+	case CBOR_FLOAT16:
+		exp = (value >> 10) & 0x1f;
+		if (exp == 0x1f) {
+			/* infinity and NaN */
+			return false;
+		}
+
+		*result = (double)(value & 0x3ff);
+		if (exp) {
+			*result += 1024.0;
+		} else {
+			exp = 1;
+		}
+
+		/* value = mantissa * 2^(exp - 25) */
+		for (exp -= 25; exp < 0; exp++) {
+			*result /= 2.0;
+		}
+
+		for (; exp > 0; exp--) {
+			*result *= 2.0;
+		}
+
+		if (value & 0x8000) {
+			*result = -*result;
+		}
+
+		return true;
+
+	case CBOR_FLOAT32:
+		f32.u = (u32_t)value;
+		*result = (double)f32.f;
+		return true;
+
+	case CBOR_FLOAT64:
+		f64.u = value;
+		*result = f64.d;
+		return true;
+
+	}
+
+	return false;
+}
+
+/* integers, floats (truncated) and booleans */
+static size_t get_number(struct lwm2m_input_context *in, s64_t *value)
+{
+	u8_t major, info;
+	u64_t val;
+	double d;
+	size_t size;
+
+	*value = 0;
+	size = cbor_get_header(in, &major, &info, &val);
+	if (size == 0) {
+		return 0;
+	}
+
+	switch (major) {
+
+	case CBOR_UINT:
+		*value = (s64_t)val;
+		break;
+
+	case CBOR_NINT:
+		*value = -1 - (s64_t)val;
+		break;
+
+	case CBOR_SIMPLE:
+		if (info == CBOR_FALSE || info == CBOR_TRUE) {
+			*value = (info == CBOR_TRUE);
+		} else if (cbor_to_double(info, val, &d)) {
+			*value = (s64_t)d;
+		} else {
+			return 0;
+		}
+
+		break;
+
+	default:
+		SYS_LOG_ERR("expected a number, got major type %u", major);
+		return 0;
+
+	}
+
+	return size;
+}
+
+static size_t get_s64(struct lwm2m_input_context *in, s64_t *value)
+{
+	return get_number(in, value);
+}
+
+static size_t get_s32(struct lwm2m_input_context *in, s32_t *value)
+{
+	s64_t temp;
+	size_t size;
+
+	size = get_number(in, &temp);
+	*value = (s32_t)temp;
+	return size;
+}
+
+static size_t get_fix(struct lwm2m_input_context *in,
+		      s64_t *val1, s64_t *val2, double scale)
+{
+	u8_t major, info;
+	u64_t val;
+	double d;
+	size_t size;
+
+	*val1 = 0;
+	*val2 = 0;
+	size = cbor_get_header(in, &major, &info, &val);
+	if (size == 0) {
+		return 0;
+	}
+
+	if (major == CBOR_UINT) {
+		*val1 = (s64_t)val;
+	} else if (major == CBOR_NINT) {
+		*val1 = -1 - (s64_t)val;
+	} else if (major == CBOR_SIMPLE && cbor_to_double(info, val, &d)) {
+		*val1 = (s64_t)d;
+		d = (d - (double)*val1) * scale;
+		*val2 = (s64_t)(d < 0 ? d - 0.5 : d + 0.5);
+	} else {
+		SYS_LOG_ERR("expected a number, got major type %u", major);
+		return 0;
+	}
+
+	return size;
+}
+
+static size_t get_float32fix(struct lwm2m_input_context *in,
+			     float32_value_t *value)
+{
+	s64_t val1, val2;
+	size_t size;
+
+	size = get_fix(in, &val1, &val2, 1000000.0);
+	value->val1 = (s32_t)val1;
+	value->val2 = (s32_t)val2;
+	return size;
+}
+
+static size_t get_float64fix(struct lwm2m_input_context *in,
+			     float64_value_t *value)
+{
+	s64_t val1, val2;
+	size_t size;
+
+	size = get_fix(in, &val1, &val2, 1000000000.0);
+	value->val1 = val1;
+	value->val2 = val2;
+	return size;
+}
+
+static size_t get_bool(struct lwm2m_input_context *in, bool *value)
+{
+	s64_t temp;
+	size_t size;
+
+	size = get_number(in, &temp);
+	*value = (temp != 0);
+	return size;
+}
+
+/* text or byte string into a NUL terminated buffer */
+static size_t get_string(struct lwm2m_input_context *in,
+			 u8_t *buf, size_t buflen)
+{
+	u8_t major, info;
+	u64_t len;
+	size_t size;
+
+	size = cbor_get_header(in, &major, &info, &len);
+	if (size == 0) {
+		return 0;
+	}
+
+	if ((major != CBOR_TEXT && major != CBOR_BYTES) ||
+	    info == CBOR_INFO_INDEFINITE) {
+		SYS_LOG_ERR("expected a string, got major type %u", major);
+		return 0;
+	}
+
+	if (len >= buflen) {
+		SYS_LOG_ERR("string too long: %u", (unsigned int)len);
+		/* skip it to stay in sync with the payload */
+		buf = NULL;
+	}
+
+	if (len > 0) {
+		in->frag = net_frag_read(in->frag, in->offset, &in->offset,
+					 len, buf);
+		if (!in->frag && in->offset == 0xffff) {
+			return 0;
+		}
+	}
+
+	if (!buf) {
+		return 0;
+	}
+
+	buf[len] = '\0';
+	return size + len;
+}
+
+static size_t get_opaque(struct lwm2m_input_context *in,
+			 u8_t *value, size_t buflen, bool *last_block)
+{
+	u8_t major, info;
+	u64_t len;
+
+	if (!cbor_get_header(in, &major, &info, &len) ||
+	    major != CBOR_BYTES || info == CBOR_INFO_INDEFINITE) {
+		*last_block = true;
+		return 0;
+	}
+
+	in->opaque_len = len;
+	return lwm2m_engine_get_opaque_more(in, value, buflen, last_block);
+}
+
+const struct lwm2m_reader senml_cbor_reader = {
+	get_s32,
+	get_s64,
+	get_string,
+	get_float32fix,
+	get_float64fix,
+	get_bool,
+	get_opaque
+};
+
+/* skip a value we are not interested in */
+static int cbor_skip(struct lwm2m_input_context *in)
+{
+	u8_t major, info;
+	u64_t value;
+
+	if (!cbor_get_header(in, &major, &info, &value)) {
+		return -EINVAL;
+	}
+
+	switch (major) {
+
+	case CBOR_UINT:
+	case CBOR_NINT:
+		return 0;
+
+	case CBOR_SIMPLE:
+		return info == CBOR_INFO_INDEFINITE ? -EINVAL : 0;
+
+	case CBOR_BYTES:
+	case CBOR_TEXT:
+		if (info == CBOR_INFO_INDEFINITE) {
+			return -ENOTSUP;
+		}
+
+		if (value > 0) {
+			in->frag = net_frag_read(in->frag, in->offset,
+						 &in->offset, value, NULL);
+			if (!in->frag && in->offset == 0xffff) {
+				return -EINVAL;
+			}
+		}
+
+		return 0;
+
+	case CBOR_TAG:
+		return cbor_skip(in);
+
+	}
+
+	/* SenML values are never arrays or maps */
+	return -ENOTSUP;
+}
+
+/* resolve base name + name ("/3/0/" + "1") into path */
+static int senml_parse_path(const char *base, const char *name,
+			    struct lwm2m_obj_path *path)
+{
+	const char *part[] = { base, name };
+	u16_t id[4];
+	u32_t val = 0;
+	bool digits = false;
+	int i, level = 0;
+	const char *c;
+
+	for (i = 0; i < ARRAY_SIZE(part); i++) {
+		for (c = part[i]; *c; c++) {
+			if (isdigit((unsigned char)*c)) {
+				val = val * 10 + (*c - '0');
+				if (val > 0xffff) {
+					return -EINVAL;
+				}
+
+				digits = true;
+			} else if (*c == '/') {
+				if (!digits) {
+					continue;
+				}
+
+				if (level == ARRAY_SIZE(id)) {
+					return -EINVAL;
+				}
+
+				id[level++] = val;
+				val = 0;
+				digits = false;
+			} else {
+				SYS_LOG_ERR("illegal char '%c' in name", *c);
+				return -EINVAL;
+			}
+		}
+	}
+
+	if (digits) {
+		if (level == ARRAY_SIZE(id)) {
+			return -EINVAL;
+		}
+
+		id[level++] = val;
+	}
+
+	if (level < 3 || id[0] != path->obj_id) {
+		SYS_LOG_ERR("name '%s%s' is not a resource of object %u",
+			    base, name, path->obj_id);
+		return -EINVAL;
+	}
+
+	path->obj_inst_id = id[1];
+	path->res_id = id[2];
+	path->res_inst_id = level > 3 ? id[3] : 0;
+	path->level = 3;
+
+	return 0;
+}
+
+static int do_write_op_senml_cbor_item(struct lwm2m_engine_context *context)
+{
+	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	struct lwm2m_engine_res_inst *res = NULL;
+	struct lwm2m_engine_obj_field *obj_field = NULL;
+	u8_t created = 0;
+	int ret, i;
+
+	ret = lwm2m_get_or_create_engine_obj(context, &obj_inst, &created);
+	if (ret < 0) {
+		return ret;
+	}
+
+	obj_field = lwm2m_get_engine_obj_field(obj_inst->obj,
+					       context->path->res_id);
+	/* if obj_field is not found, treat as an optional resource */
+	if (!obj_field) {
+		if (context->operation == LWM2M_OP_CREATE) {
+			return -ENOTSUP;
+		}
+
+		return -ENOENT;
+	}
+
+	if (!LWM2M_HAS_PERM(obj_field, LWM2M_PERM_W)) {
+		return -EPERM;
+	}
+
+	if (!obj_inst->resources || obj_inst->resource_count == 0) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < obj_inst->resource_count; i++) {
+		if (obj_inst->resources[i].res_id == context->path->res_id) {
+			res = &obj_inst->resources[i];
+			break;
+		}
+	}
+
+	if (!res) {
+		return -ENOENT;
+	}
+
+	return lwm2m_write_handler(obj_inst, res, obj_field, context);
+}
+
+int do_write_op_senml_cbor(struct lwm2m_engine_obj *obj,
+			   struct lwm2m_engine_context *context)
+{
+	struct lwm2m_input_context *in = context->in;
+	char base[SENML_NAME_LEN] = "";
+	char name[SENML_NAME_LEN];
+	u8_t major, info, map_info;
+	u64_t records, pairs;
+	s64_t label;
+	int ret;
+
+	if (!cbor_get_header(in, &major, &info, &records) ||
+	    major != CBOR_ARRAY) {
+		SYS_LOG_ERR("SenML pack is not an array");
+		return -EINVAL;
+	}
+
+	while (info == CBOR_INFO_INDEFINITE || records-- > 0) {
+		if (!cbor_get_header(in, &major, &map_info, &pairs)) {
+			return -EINVAL;
+		}
+
+		/* end of an indefinite length pack */
+		if (major == CBOR_SIMPLE && map_info == CBOR_INFO_INDEFINITE &&
+		    info == CBOR_INFO_INDEFINITE) {
+			break;
+		}
+
+		if (major != CBOR_MAP || map_info == CBOR_INFO_INDEFINITE) {
+			SYS_LOG_ERR("SenML record is not a map");
+			return -EINVAL;
+		}
+
+		/* the base name carries over to the following records */
+		name[0] = '\0';
+
+		while (pairs-- > 0) {
+			if (!get_number(in, &label)) {
+				return -EINVAL;
+			}
+
+			switch (label) {
+
+			case SENML_BASE_NAME:
+				if (!get_string(in, (u8_t *)base,
+						sizeof(base))) {
+					return -EINVAL;
+				}
+
+				break;
+
+			case SENML_NAME:
+				if (!get_string(in, (u8_t *)name,
+						sizeof(name))) {
+					return -EINVAL;
+				}
+
+				break;
+
+			case SENML_VALUE:
+			case SENML_STRING_VALUE:
+			case SENML_BOOL_VALUE:
+			case SENML_DATA_VALUE:
+				/* names have to come before the value */
+				ret = senml_parse_path(base, name,
+						       context->path);
+				if (ret < 0) {
+					return ret;
+				}
+
+				/* the value is decoded by the write handler */
+				ret = do_write_op_senml_cbor_item(context);
+
+				/*
+				 * ignore errors for CREATE op
+				 * TODO: support BOOTSTRAP WRITE where optional
+				 * resources are ignored
+				 */
+				if (ret == -ENOTSUP &&
+				    context->operation == LWM2M_OP_CREATE) {
+					ret = cbor_skip(in);
+				}
+
+				if (ret < 0) {
+					return ret;
+				}
+
+				break;
+
+			default:
+				ret = cbor_skip(in);
+				if (ret < 0) {
+					return ret;
+				}
+
+				break;
+
+			}
+		}
+	}
+
+	return 0;
+}
@@ -12,6 +12,7 @@
 #include <net/net_app.h>
 #include <net/buf.h>
 #include <errno.h>
+#include <string.h>
 
 #define MSG_SIZE	CONFIG_MQTT_MSG_MAX_SIZE
 #define MQTT_BUF_CTR	(1 + CONFIG_MQTT_ADDITIONAL_BUFFER_CTR)
@@ -86,6 +87,9 @@ int mqtt_tx_disconnect(struct mqtt_ctx *ctx)
 		return -EINVAL;
 	}
 
+	/* Queued PUBLISH msgs must reach the broker before DISCONNECT */
+	mqtt_tx_flush(ctx);
+
 	tx = net_app_get_net_pkt(&ctx->net_app_ctx,
 				AF_UNSPEC, ctx->net_timeout);
 	if (tx == NULL) {
@@ -209,49 +213,340 @@ int mqtt_tx_pubrel(struct mqtt_ctx *ctx, u16_t id)
 	return mqtt_tx_pub_msgs(ctx, id, MQTT_PUBREL);
 }
 
-int mqtt_tx_publish(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg)
+/**
+ * Sends a batch of MQTT msgs built by mqtt_batch_add()
+ *
+ * @param [in] ctx MQTT context
+ * @param [in,out] tx Batch, set to NULL once sent
+ * @param [in,out] tx_len Number of bytes in the batch
+ *
+ * @retval 0 on success or if the batch is empty
+ * @retval -EIO on network error
+ */
+static
+int mqtt_batch_send(struct mqtt_ctx *ctx, struct net_pkt **tx, u32_t *tx_len)
 {
-	struct net_buf *data = NULL;
-	struct net_pkt *tx = NULL;
+	struct net_pkt *pkt = *tx;
 	int rc;
 
-	data = net_buf_alloc(&mqtt_msg_pool, ctx->net_timeout);
-	if (data == NULL) {
+	if (pkt == NULL) {
+		return 0;
+	}
+
+	*tx = NULL;
+	*tx_len = 0;
+
+	rc = net_app_send_pkt(&ctx->net_app_ctx,
+			pkt, NULL, 0, ctx->net_timeout, NULL);
+	if (rc < 0) {
+		net_pkt_unref(pkt);
+	}
+
+	return rc;
+}
+
+/**
+ * Adds an MQTT msg to a batch of messages sent in one TCP segment
+ *
+ * @details The batch takes ownership of frags, and it is sent once it
+ * holds at least CONFIG_MQTT_PUBLISH_QUEUE_LEN bytes.
+ *
+ * @param [in] ctx MQTT context
+ * @param [in,out] tx Batch, allocated if NULL
+ * @param [in,out] tx_len Number of bytes in the batch
+ * @param [in] frags Fragments holding the packed MQTT msg
+ *
+ * @retval 0 on success
+ * @retval -ENOMEM if a tx packet is not available
+ * @retval -EIO on network error
+ */
+static
+int mqtt_batch_add(struct mqtt_ctx *ctx, struct net_pkt **tx,
+		   u32_t *tx_len, struct net_buf *frags)
+{
+	if (*tx == NULL) {
+		*tx = net_app_get_net_pkt(&ctx->net_app_ctx,
+					  AF_UNSPEC, ctx->net_timeout);
+		if (*tx == NULL) {
+			net_pkt_frag_unref(frags);
+			return -ENOMEM;
+		}
+
+		*tx_len = 0;
+	}
+
+	*tx_len += net_buf_frags_len(frags);
+	net_pkt_frag_add(*tx, frags);
+
+	if (*tx_len >= CONFIG_MQTT_PUBLISH_QUEUE_LEN) {
+		return mqtt_batch_send(ctx, tx, tx_len);
+	}
+
+	return 0;
+}
+
+/**
+ * Packs the MQTT PUBLISH msg straight into network buffers
+ *
+ * @param [in] ctx MQTT context
+ * @param [in] msg MQTT PUBLISH msg
+ * @param [out] frags Fragments holding the packed msg
+ *
+ * @retval 0 on success
+ * @retval -EINVAL
+ * @retval -ENOMEM if a tx buffer is not available
+ */
+static
+int mqtt_publish_frags(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg,
+		       struct net_buf **frags)
+{
+	struct net_pkt *pkt;
+	int rc;
+
+	pkt = net_app_get_net_pkt(&ctx->net_app_ctx,
+				  AF_UNSPEC, ctx->net_timeout);
+	if (pkt == NULL) {
 		return -ENOMEM;
 	}
 
-	rc = mqtt_pack_publish(data->data, &data->len, data->size, msg);
-	if (rc != 0) {
-		rc = -EINVAL;
-		goto exit_publish;
+	rc = mqtt_pack_publish_pkt(pkt, msg, ctx->net_timeout);
+	if (rc == 0) {
+		*frags = pkt->frags;
+		pkt->frags = NULL;
 	}
 
-	tx = net_app_get_net_pkt(&ctx->net_app_ctx,
-				AF_UNSPEC, ctx->net_timeout);
-	if (tx == NULL) {
-		rc = -ENOMEM;
-		goto exit_publish;
+	net_pkt_unref(pkt);
+
+	return rc;
+}
+
+#if CONFIG_MQTT_INFLIGHT_WINDOW > 0
+/**
+ * Copies a chain of fragments, the copy is what gets sent while the
+ * original is kept for retransmission
+ */
+static
+struct net_buf *mqtt_frags_copy(struct mqtt_ctx *ctx, struct net_buf *frags)
+{
+	struct net_buf *copy;
+	struct net_pkt *pkt;
+
+	pkt = net_app_get_net_pkt(&ctx->net_app_ctx,
+				  AF_UNSPEC, ctx->net_timeout);
+	if (pkt == NULL) {
+		return NULL;
 	}
 
-	net_pkt_frag_add(tx, data);
-	data = NULL;
+	for (; frags; frags = frags->frags) {
+		if (!net_pkt_append_all(pkt, frags->len, frags->data,
+					ctx->net_timeout)) {
+			net_pkt_unref(pkt);
+			return NULL;
+		}
+	}
 
-	rc = net_app_send_pkt(&ctx->net_app_ctx,
-			tx, NULL, 0, ctx->net_timeout, NULL);
+	copy = pkt->frags;
+	pkt->frags = NULL;
+	net_pkt_unref(pkt);
+
+	return copy;
+}
+
+/* The entry takes ownership of frags on success */
+static
+int mqtt_inflight_add(struct mqtt_ctx *ctx, u16_t pkt_id,
+		      struct net_buf *frags)
+{
+	struct mqtt_inflight *entry = NULL;
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+
+	for (i = 0; i < CONFIG_MQTT_INFLIGHT_WINDOW; i++) {
+		if (ctx->inflight[i].state == MQTT_INVALID) {
+			if (entry == NULL) {
+				entry = &ctx->inflight[i];
+			}
+		} else if (ctx->inflight[i].pkt_id == pkt_id) {
+			irq_unlock(key);
+			return -EALREADY;
+		}
+	}
+
+	if (entry == NULL) {
+		irq_unlock(key);
+		return -EAGAIN;
+	}
+
+	entry->frags = frags;
+	entry->pkt_id = pkt_id;
+	entry->state = MQTT_PUBLISH;
+
+	irq_unlock(key);
+
+	return 0;
+}
+
+/**
+ * Updates the in-flight entry of pkt_id after a PUBxxx msg is received
+ *
+ * @details PUBACK and PUBCOMP end the exchange. After a PUBREC only the
+ * PUBREL is left to be sent again on reconnection.
+ */
+static
+void mqtt_inflight_ack(struct mqtt_ctx *ctx, u16_t pkt_id,
+		       enum mqtt_packet type)
+{
+	struct mqtt_inflight *entry;
+	struct net_buf *frags = NULL;
+	unsigned int key;
+	int i;
+
+	key = irq_lock();
+
+	for (i = 0; i < CONFIG_MQTT_INFLIGHT_WINDOW; i++) {
+		entry = &ctx->inflight[i];
+		if (entry->state == MQTT_INVALID || entry->pkt_id != pkt_id) {
+			continue;
+		}
+
+		frags = entry->frags;
+		entry->frags = NULL;
+
+		if (type == MQTT_PUBREC) {
+			entry->state = MQTT_PUBREL;
+		} else {
+			entry->state = MQTT_INVALID;
+		}
+
+		break;
+	}
+
+	irq_unlock(key);
+
+	if (frags) {
+		net_pkt_frag_unref(frags);
+	}
+}
+
+static
+void mqtt_inflight_release(struct mqtt_ctx *ctx, u16_t pkt_id)
+{
+	mqtt_inflight_ack(ctx, pkt_id, MQTT_PUBCOMP);
+}
+
+/**
+ * Sends the in-flight PUBLISH msgs again, with the DUP flag set, and the
+ * PUBREL msgs of the QoS 2 exchanges that were not completed
+ */
+static
+int mqtt_inflight_resend(struct mqtt_ctx *ctx)
+{
+	struct mqtt_inflight *entry;
+	struct net_pkt *tx = NULL;
+	struct net_buf *copy;
+	u32_t tx_len = 0;
+	int rc = 0;
+	int i;
+
+	for (i = 0; i < CONFIG_MQTT_INFLIGHT_WINDOW; i++) {
+		entry = &ctx->inflight[i];
+
+		if (entry->state == MQTT_PUBLISH) {
+			entry->frags->data[0] |= 0x08;
+			copy = mqtt_frags_copy(ctx, entry->frags);
+			if (copy == NULL) {
+				rc = -ENOMEM;
+			} else {
+				rc = mqtt_batch_add(ctx, &tx, &tx_len, copy);
+			}
+		} else if (entry->state == MQTT_PUBREL) {
+			rc = mqtt_batch_send(ctx, &tx, &tx_len);
+			if (rc >= 0) {
+				rc = mqtt_tx_pubrel(ctx, entry->pkt_id);
+			}
+		}
+
+		if (rc < 0) {
+			if (tx) {
+				net_pkt_unref(tx);
+			}
+
+			return rc;
+		}
+	}
+
+	return mqtt_batch_send(ctx, &tx, &tx_len);
+}
+#else
+static inline
+void mqtt_inflight_ack(struct mqtt_ctx *ctx, u16_t pkt_id,
+		       enum mqtt_packet type)
+{
+}
+
+static inline
+int mqtt_inflight_resend(struct mqtt_ctx *ctx)
+{
+	return 0;
+}
+#endif
+
+int mqtt_tx_publish_queue(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg)
+{
+	struct net_buf *frags;
+	int rc;
+
+	rc = mqtt_publish_frags(ctx, msg, &frags);
 	if (rc < 0) {
-		net_pkt_unref(tx);
+		return rc;
 	}
 
-	tx = NULL;
+#if CONFIG_MQTT_INFLIGHT_WINDOW > 0
+	if (msg->qos != MQTT_QoS0) {
+		rc = mqtt_inflight_add(ctx, msg->pkt_id, frags);
+		if (rc < 0) {
+			net_pkt_frag_unref(frags);
+			return rc;
+		}
 
-	return rc;
+		/* the window keeps the original for retransmission */
+		frags = mqtt_frags_copy(ctx, frags);
+		if (frags == NULL) {
+			mqtt_inflight_release(ctx, msg->pkt_id);
+			return -ENOMEM;
+		}
+	}
+#endif
 
-exit_publish:
-	net_pkt_frag_unref(data);
+	rc = mqtt_batch_add(ctx, &ctx->tx_queue, &ctx->tx_queue_len, frags);
+#if CONFIG_MQTT_INFLIGHT_WINDOW > 0
+	if (rc < 0 && msg->qos != MQTT_QoS0) {
+		mqtt_inflight_release(ctx, msg->pkt_id);
+	}
+#endif
 
 	return rc;
 }
 
+int mqtt_tx_flush(struct mqtt_ctx *ctx)
+{
+	return mqtt_batch_send(ctx, &ctx->tx_queue, &ctx->tx_queue_len);
+}
+
+int mqtt_tx_publish(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg)
+{
+	int rc;
+
+	rc = mqtt_tx_publish_queue(ctx, msg);
+	if (rc < 0) {
+		return rc;
+	}
+
+	return mqtt_tx_flush(ctx);
+}
+
 int mqtt_tx_pingreq(struct mqtt_ctx *ctx)
 {
 	struct net_pkt *tx = NULL;
@@ -424,6 +719,11 @@ int mqtt_rx_connack(struct mqtt_ctx *ctx, struct net_buf *rx, int clean_session)
 
 	ctx->connected = 1;
 
+	/* Unacknowledged msgs are sent again before any new one. On error
+	 * they are kept for the next connection.
+	 */
+	mqtt_inflight_resend(ctx);
+
 	if (ctx->connect) {
 		ctx->connect(ctx);
 	}
@@ -497,6 +797,9 @@ int mqtt_rx_pub_msgs(struct mqtt_ctx *ctx, struct net_buf *rx,
 		}
 	} else {
 		rc = ctx->publish_tx(ctx, pkt_id, type);
+		if (rc == 0) {
+			mqtt_inflight_ack(ctx, pkt_id, type);
+		}
 	}
 
 	if (rc != 0) {
@@ -609,27 +912,22 @@ int mqtt_rx_unsuback(struct mqtt_ctx *ctx, struct net_buf *rx)
 	return 0;
 }
 
-int mqtt_rx_publish(struct mqtt_ctx *ctx, struct net_buf *rx)
+static
+int mqtt_rx_publish_msg(struct mqtt_ctx *ctx, struct mqtt_publish_msg *msg)
 {
-	struct mqtt_publish_msg msg;
 	int rc;
 
-	rc = mqtt_unpack_publish(rx->data, rx->len, &msg);
+	rc = ctx->publish_rx(ctx, msg, msg->pkt_id, MQTT_PUBLISH);
 	if (rc != 0) {
 		return -EINVAL;
 	}
 
-	rc = ctx->publish_rx(ctx, &msg, msg.pkt_id, MQTT_PUBLISH);
-	if (rc != 0) {
-		return -EINVAL;
-	}
-
-	switch (msg.qos) {
+	switch (msg->qos) {
 	case MQTT_QoS2:
-		rc = mqtt_tx_pubrec(ctx, msg.pkt_id);
+		rc = mqtt_tx_pubrec(ctx, msg->pkt_id);
 		break;
 	case MQTT_QoS1:
-		rc = mqtt_tx_puback(ctx, msg.pkt_id);
+		rc = mqtt_tx_puback(ctx, msg->pkt_id);
 		break;
 	case MQTT_QoS0:
 		break;
@@ -640,6 +938,68 @@ int mqtt_rx_publish(struct mqtt_ctx *ctx, struct net_buf *rx)
 	return rc;
 }
 
+int mqtt_rx_publish(struct mqtt_ctx *ctx, struct net_buf *rx)
+{
+	struct mqtt_publish_msg msg;
+	int rc;
+
+	rc = mqtt_unpack_publish(rx->data, rx->len, &msg);
+	if (rc != 0) {
+		return -EINVAL;
+	}
+
+	return mqtt_rx_publish_msg(ctx, &msg);
+}
+
+/**
+ * Handles the MQTT PUBLISH msg contained in rx without copying it
+ *
+ * @details The topic and payload handed to the application point into
+ * the rx fragments. Payloads that span several fragments but fit into
+ * CONFIG_MQTT_MSG_MAX_SIZE are still linearized, so that msg->msg is set
+ * as before; larger ones are only available through msg->msg_frag.
+ *
+ * @param ctx MQTT context
+ * @param rx RX packet
+ *
+ * @retval 0 on success
+ * @retval -EAGAIN if rx must be linearized and parsed by mqtt_rx_publish
+ * @retval -EINVAL on error
+ */
+static
+int mqtt_rx_publish_pkt(struct mqtt_ctx *ctx, struct net_pkt *rx)
+{
+	struct mqtt_publish_msg msg;
+	struct net_buf *frag;
+	u16_t data_len;
+	u16_t offset;
+	u16_t pos;
+	u8_t type;
+	int rc;
+
+	data_len = net_pkt_appdatalen(rx);
+	if (data_len < MQTT_PUBLISHER_MIN_MSG_SIZE) {
+		return -EAGAIN;
+	}
+
+	offset = net_pkt_get_len(rx) - data_len;
+	frag = net_frag_read_u8(rx->frags, offset, &pos, &type);
+	if (!frag || MQTT_PACKET_TYPE(type) != MQTT_PUBLISH) {
+		return -EAGAIN;
+	}
+
+	rc = mqtt_unpack_publish_frags(rx->frags, offset, data_len, &msg);
+	if (rc != 0) {
+		return rc;
+	}
+
+	if (!msg.msg && msg.msg_len && data_len <= CONFIG_MQTT_MSG_MAX_SIZE) {
+		return -EAGAIN;
+	}
+
+	return mqtt_rx_publish_msg(ctx, &msg);
+}
+
 /**
  * Linearizes an IP fragmented packet
  *
@@ -711,6 +1071,15 @@ int mqtt_parser(struct mqtt_ctx *ctx, struct net_pkt *rx)
 	struct net_buf *data = NULL;
 	int rc = -EINVAL;
 
+	rc = mqtt_rx_publish_pkt(ctx, rx);
+	if (rc != -EAGAIN) {
+		if (rc != 0 && ctx->malformed) {
+			ctx->malformed(ctx, MQTT_PUBLISH);
+		}
+
+		return rc;
+	}
+
 	data = mqtt_linearize_packet(ctx, rx, MQTT_PUBLISHER_MIN_MSG_SIZE);
 	if (!data) {
 		return -ENOMEM;
@@ -878,6 +1247,13 @@ int mqtt_init(struct mqtt_ctx *ctx, enum mqtt_app app_type)
 	ctx->app_type = app_type;
 	ctx->rcv = mqtt_parser;
 
+	ctx->tx_queue = NULL;
+	ctx->tx_queue_len = 0;
+
+#if CONFIG_MQTT_INFLIGHT_WINDOW > 0
+	memset(ctx->inflight, 0, sizeof(ctx->inflight));
+#endif
+
 #if defined(CONFIG_MQTT_LIB_TLS)
 	if (ctx->tls_hs_timeout == 0) {
 		ctx->tls_hs_timeout = TLS_HS_DEFAULT_TIMEOUT;
@@ -895,6 +1271,12 @@ int mqtt_close(struct mqtt_ctx *ctx)
 		return -EFAULT;
 	}
 
+	if (ctx->tx_queue) {
+		net_pkt_unref(ctx->tx_queue);
+		ctx->tx_queue = NULL;
+		ctx->tx_queue_len = 0;
+	}
+
 	if (ctx->net_app_ctx.is_init) {
 		net_app_close(&ctx->net_app_ctx);
 		net_app_release(&ctx->net_app_ctx);
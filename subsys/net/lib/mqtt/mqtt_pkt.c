@@ -895,6 +895,139 @@ int mqtt_pack_publish(u8_t *buf, u16_t *length, u16_t size,
 	return 0;
 }
 
+int mqtt_pack_publish_pkt(struct net_pkt *pkt, struct mqtt_publish_msg *msg,
+			  s32_t timeout)
+{
+	u8_t hdr[PACKET_TYPE_SIZE + ENCLENBUF_MAX_SIZE + INT_SIZE];
+	u8_t pkt_id[PACKET_ID_SIZE];
+	u16_t offset;
+	u16_t rlen_size;
+	u32_t payload;
+	int rc;
+
+	if (msg->qos < MQTT_QoS0 || msg->qos > MQTT_QoS2) {
+		return -EINVAL;
+	}
+
+	/* Same layout as mqtt_pack_publish(), see MQTT 3.3.2 */
+	payload = INT_SIZE + msg->topic_len +
+		  (msg->qos > MQTT_QoS0 ? PACKET_ID_SIZE : 0) + msg->msg_len;
+
+	rc = compute_rlen_size(&rlen_size, payload);
+	if (rc != 0) {
+		return -EINVAL;
+	}
+
+	hdr[0] = (MQTT_PUBLISH << 4) | ((msg->dup ? 1 : 0) << 3) |
+		 (msg->qos << 1) | (msg->retain ? 1 : 0);
+	rlen_encode(hdr + PACKET_TYPE_SIZE, payload);
+
+	offset = PACKET_TYPE_SIZE + rlen_size;
+	UNALIGNED_PUT(htons(msg->topic_len), (u16_t *)(hdr + offset));
+	offset += INT_SIZE;
+
+	if (!net_pkt_append_all(pkt, offset, hdr, timeout) ||
+	    !net_pkt_append_all(pkt, msg->topic_len, (u8_t *)msg->topic,
+				timeout)) {
+		return -ENOMEM;
+	}
+
+	if (msg->qos > MQTT_QoS0) {
+		UNALIGNED_PUT(htons(msg->pkt_id), (u16_t *)pkt_id);
+		if (!net_pkt_append_all(pkt, PACKET_ID_SIZE, pkt_id,
+					timeout)) {
+			return -ENOMEM;
+		}
+	}
+
+	if (!net_pkt_append_all(pkt, msg->msg_len, msg->msg, timeout)) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+int mqtt_unpack_publish_frags(struct net_buf *frag, u16_t offset,
+			      u16_t length, struct mqtt_publish_msg *msg)
+{
+	u16_t rmlen_size = 0;
+	u16_t consumed;
+	u32_t rmlen = 0;
+	u16_t pos;
+	u8_t val;
+
+	frag = net_frag_read_u8(frag, offset, &pos, &val);
+	if (!frag || val >> 4 != MQTT_PUBLISH) {
+		return -EINVAL;
+	}
+
+	msg->dup = (val & 0x08) >> 3;
+	msg->qos = (val & 0x06) >> 1;
+	msg->retain = val & 0x01;
+
+	/* Remaining Length, see MQTT 2.2.3 */
+	do {
+		if (!frag || rmlen_size == ENCLENBUF_MAX_SIZE) {
+			return -EINVAL;
+		}
+
+		frag = net_frag_read_u8(frag, pos, &pos, &val);
+		if (!frag && pos == 0xffff) {
+			return -EINVAL;
+		}
+
+		rmlen |= (u32_t)(val & 0x7F) << (7 * rmlen_size);
+		rmlen_size++;
+	} while (val & 0x80);
+
+	if (!frag || PACKET_TYPE_SIZE + rmlen_size + rmlen > length) {
+		return -EINVAL;
+	}
+
+	frag = net_frag_read_be16(frag, pos, &pos, &msg->topic_len);
+	if (!frag) {
+		return -EINVAL;
+	}
+
+	consumed = INT_SIZE + msg->topic_len +
+		   (msg->qos > MQTT_QoS0 ? PACKET_ID_SIZE : 0);
+	if (consumed > rmlen) {
+		return -EINVAL;
+	}
+
+	if (pos + msg->topic_len > frag->len) {
+		return -EAGAIN;
+	}
+
+	msg->topic = (char *)(frag->data + pos);
+	frag = net_frag_skip(frag, pos, &pos, msg->topic_len);
+
+	if (msg->qos == MQTT_QoS1 || msg->qos == MQTT_QoS2) {
+		frag = net_frag_read_be16(frag, pos, &pos, &msg->pkt_id);
+		if (!frag && pos == 0xffff) {
+			return -EINVAL;
+		}
+	} else {
+		msg->pkt_id = 0;
+	}
+
+	msg->msg_len = rmlen - consumed;
+	msg->msg_frag = frag;
+	msg->msg_offset = pos;
+
+	if (msg->msg_len && !frag) {
+		return -EINVAL;
+	}
+
+	if (frag && pos + msg->msg_len <= frag->len) {
+		msg->msg = frag->data + pos;
+	} else {
+		msg->msg = NULL;
+	}
+
+	return 0;
+}
+
 int mqtt_unpack_publish(u8_t *buf, u16_t length,
 			struct mqtt_publish_msg *msg)
 {
@@ -944,6 +1077,8 @@ int mqtt_unpack_publish(u8_t *buf, u16_t length,
 
 	msg->msg_len = length - offset;
 	msg->msg = buf + offset;
+	msg->msg_frag = NULL;
+	msg->msg_offset = 0;
 
 	return 0;
 }
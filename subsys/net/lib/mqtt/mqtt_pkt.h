@@ -21,6 +21,7 @@
 #include <stddef.h>
 
 #include <net/mqtt_types.h>
+#include <net/net_pkt.h>
 
 #define MQTT_PACKET_TYPE(first_byte)	(((first_byte) & 0xF0) >> 4)
 
@@ -235,6 +236,44 @@ int mqtt_unpack_suback(u8_t *buf, u16_t length, u16_t *pkt_id,
 int mqtt_pack_publish(u8_t *buf, u16_t *length, u16_t size,
 		      struct mqtt_publish_msg *msg);
 
+/**
+ * Packs the MQTT PUBLISH message into a network packet
+ *
+ * @details Unlike mqtt_pack_publish(), the message is appended to pkt
+ * as it is encoded, so no intermediate buffer is required and the
+ * message size is not limited by CONFIG_MQTT_MSG_MAX_SIZE. On error,
+ * pkt may contain part of the message.
+ *
+ * @param [in] pkt Network packet the message is appended to
+ * @param [in] msg MQTT PUBLISH message
+ * @param [in] timeout Time to wait for network buffers
+ *
+ * @retval 0 on success
+ * @retval -EINVAL
+ * @retval -ENOMEM
+ */
+int mqtt_pack_publish_pkt(struct net_pkt *pkt, struct mqtt_publish_msg *msg,
+			  s32_t timeout);
+
+/**
+ * Unpacks the MQTT PUBLISH message stored in a fragment chain
+ *
+ * @details The topic and payload are not copied: msg->topic points into
+ * the fragment holding it and msg->msg_frag / msg->msg_offset locate the
+ * payload. msg->msg is set only if the payload is contiguous.
+ *
+ * @param [in] frag Fragment chain where the message is stored
+ * @param [in] offset Offset of the message in the fragment chain
+ * @param [in] length Message's length
+ * @param [out] msg MQTT PUBLISH message
+ *
+ * @retval 0 on success
+ * @retval -EINVAL
+ * @retval -EAGAIN if the topic spans several fragments
+ */
+int mqtt_unpack_publish_frags(struct net_buf *frag, u16_t offset,
+			      u16_t length, struct mqtt_publish_msg *msg);
+
 /**
  * Unpacks the MQTT PUBLISH message
  *
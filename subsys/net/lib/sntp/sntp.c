@@ -10,6 +10,7 @@
 #define NET_LOG_ENABLED 1
 #endif
 
+#include <stdlib.h>
 #include <net/sntp.h>
 #include "sntp_pkt.h"
 
@@ -108,6 +109,155 @@ static s32_t parse_response(u8_t *data, u16_t len, u32_t orig_ts,
 	return 0;
 }
 
+#if defined(CONFIG_SNTP_SERVICE)
+/* Offsets larger than this are stepped, smaller ones are slewed */
+#define SNTP_STEP_THRESHOLD_MS 128
+/* Maximum slew rate, same as the NTP reference implementation */
+#define SNTP_SLEW_PPM 500
+
+struct sntp_sample {
+	/* Wall clock minus uptime, in milliseconds */
+	s64_t offset;
+	/* Round trip delay, in milliseconds */
+	u32_t delay;
+};
+
+static struct {
+	struct sntp_ctx ctx;
+	struct k_delayed_work work;
+	struct sntp_sample samples[CONFIG_SNTP_SERVICE_SAMPLES];
+
+	/* Uptime and originate timestamp of the outstanding request */
+	s64_t t1;
+	u32_t orig_tm_f;
+
+	/* Wall clock is uptime + offset, plus the part of slew that has
+	 * been applied since slew_start.
+	 */
+	s64_t offset;
+	s64_t slew_start;
+	s32_t slew;
+
+	/* Current poll interval, in seconds */
+	u32_t poll;
+
+	u8_t count;
+	u8_t next;
+	bool synced;
+	bool waiting;
+} service;
+
+static s64_t ntp_to_epoch_ms(u32_t secs, u32_t frac)
+{
+	u64_t ts = secs;
+
+	/* See parse_response() for the era handling */
+	if (!(secs & 0x80000000)) {
+		ts += 0x100000000;
+	}
+
+	return (ts - OFFSET_1970_JAN_1) * MSEC_PER_SEC +
+		(((u64_t)frac * MSEC_PER_SEC) >> 32);
+}
+
+/* Must be called with interrupts locked */
+static s64_t service_offset(s64_t now)
+{
+	s64_t applied;
+
+	applied = (now - service.slew_start) * SNTP_SLEW_PPM / 1000000;
+	if (applied >= abs(service.slew)) {
+		return service.offset + service.slew;
+	}
+
+	return service.offset + (service.slew < 0 ? -applied : applied);
+}
+
+static void service_update(struct sntp_pkt *pkt, s64_t t4)
+{
+	struct sntp_sample *sample, *best;
+	s64_t t1, t2, t3, now, current, diff;
+	unsigned int key;
+	s32_t delay;
+	u8_t i;
+
+	if (!service.waiting || ntohl(pkt->orig_tm_f) != service.orig_tm_f) {
+		NET_DBG("Unexpected reply, ignoring");
+		return;
+	}
+
+	service.waiting = false;
+
+	t1 = service.t1;
+	t2 = ntp_to_epoch_ms(ntohl(pkt->rx_tm_s), ntohl(pkt->rx_tm_f));
+	t3 = ntp_to_epoch_ms(ntohl(pkt->tx_tm_s), ntohl(pkt->tx_tm_f));
+
+	delay = (t4 - t1) - (t3 - t2);
+	if (delay < 0) {
+		delay = 0;
+	}
+
+	sample = &service.samples[service.next];
+	sample->offset = ((t2 - t1) + (t3 - t4)) / 2;
+	sample->delay = delay;
+
+	service.next = (service.next + 1) % CONFIG_SNTP_SERVICE_SAMPLES;
+	if (service.count < CONFIG_SNTP_SERVICE_SAMPLES) {
+		service.count++;
+	}
+
+	/* The sample with the lowest delay is the one least disturbed by
+	 * queuing in the network, use its offset.
+	 */
+	best = &service.samples[0];
+	for (i = 1; i < service.count; i++) {
+		if (service.samples[i].delay < best->delay) {
+			best = &service.samples[i];
+		}
+	}
+
+	now = k_uptime_get();
+
+	key = irq_lock();
+
+	current = service_offset(now);
+
+	diff = best->offset - current;
+	if (diff < 0) {
+		diff = -diff;
+	}
+
+	if (!service.synced || diff > SNTP_STEP_THRESHOLD_MS) {
+		service.offset = best->offset;
+		service.slew = 0;
+	} else {
+		service.offset = current;
+		service.slew = best->offset - current;
+	}
+
+	service.slew_start = now;
+	service.synced = true;
+
+	irq_unlock(key);
+
+	/* Back off while the clock stays within a quarter of the step
+	 * threshold, poll faster again when it wanders off.
+	 */
+	if (diff < SNTP_STEP_THRESHOLD_MS / 4) {
+		service.poll = min(service.poll * 2,
+				   CONFIG_SNTP_SERVICE_POLL_MAX);
+	} else {
+		service.poll = max(service.poll / 2,
+				   CONFIG_SNTP_SERVICE_POLL_MIN);
+	}
+
+	NET_DBG("offset %lld ms delay %d ms, next poll in %u s",
+		best->offset, delay, service.poll);
+
+	k_delayed_work_submit(&service.work, K_SECONDS(service.poll));
+}
+#endif /* CONFIG_SNTP_SERVICE */
+
 static void sntp_recv_cb(struct net_app_ctx *ctx, struct net_pkt *pkt,
 			int status, void *user_data)
 {
@@ -116,6 +266,9 @@ static void sntp_recv_cb(struct net_app_ctx *ctx, struct net_pkt *pkt,
 	u64_t epoch_time = 0;
 	u64_t tmp = 0;
 	u16_t offset = 0;
+#if defined(CONFIG_SNTP_SERVICE)
+	s64_t rx_time = k_uptime_get();
+#endif
 
 	if (status < 0) {
 		goto error_exit;
@@ -140,6 +293,17 @@ static void sntp_recv_cb(struct net_app_ctx *ctx, struct net_pkt *pkt,
 		epoch_time = tmp;
 	}
 
+#if defined(CONFIG_SNTP_SERVICE)
+	if (sntp == &service.ctx) {
+		if (status == 0) {
+			service_update(&buf, rx_time);
+		}
+
+		net_pkt_unref(pkt);
+		return;
+	}
+#endif
+
 error_exit:
 	if (sntp->cb) {
 		sntp->cb(sntp, status, epoch_time, sntp->user_data);
@@ -188,31 +352,19 @@ int sntp_init(struct sntp_ctx *ctx, const char *srv_addr, u16_t srv_port,
 	return 0;
 }
 
-int sntp_request(struct sntp_ctx *ctx,
-		 u32_t timeout,
-		 sntp_resp_cb_t callback,
-		 void *user_data)
+static int send_request(struct sntp_ctx *ctx, u32_t tx_tm_s, u32_t tx_tm_f,
+			u32_t timeout)
 {
 	struct sntp_pkt tx_pkt = { 0 };
-	int rv = 0;
-
-	if (!ctx) {
-		return -EFAULT;
-	}
-
-	if (!ctx->is_init) {
-		return -EINVAL;
-	}
-
-	ctx->cb = callback;
-	ctx->user_data = user_data;
+	int rv;
 
 	/* prepare request pkt */
 	LVM_SET_LI(tx_pkt.lvm, 0);
 	LVM_SET_VN(tx_pkt.lvm, SNTP_VERSION_NUMBER);
 	LVM_SET_MODE(tx_pkt.lvm, SNTP_MODE_CLIENT);
-	ctx->expected_orig_ts = get_uptime_in_sec() + OFFSET_1970_JAN_1;
-	tx_pkt.tx_tm_s = htonl(ctx->expected_orig_ts);
+	ctx->expected_orig_ts = tx_tm_s;
+	tx_pkt.tx_tm_s = htonl(tx_tm_s);
+	tx_pkt.tx_tm_f = htonl(tx_tm_f);
 
 	rv = net_app_connect(&ctx->net_app_ctx, K_NO_WAIT);
 	if (rv < 0) {
@@ -228,6 +380,26 @@ int sntp_request(struct sntp_ctx *ctx,
 	return rv;
 }
 
+int sntp_request(struct sntp_ctx *ctx,
+		 u32_t timeout,
+		 sntp_resp_cb_t callback,
+		 void *user_data)
+{
+	if (!ctx) {
+		return -EFAULT;
+	}
+
+	if (!ctx->is_init) {
+		return -EINVAL;
+	}
+
+	ctx->cb = callback;
+	ctx->user_data = user_data;
+
+	return send_request(ctx, get_uptime_in_sec() + OFFSET_1970_JAN_1, 0,
+			    timeout);
+}
+
 void sntp_close(struct sntp_ctx *ctx)
 {
 	if (!ctx || !ctx->is_init) {
@@ -238,3 +410,93 @@ void sntp_close(struct sntp_ctx *ctx)
 	net_app_release(&ctx->net_app_ctx);
 	ctx->is_init = false;
 }
+
+#if defined(CONFIG_SNTP_SERVICE)
+static void service_poll(struct k_work *work)
+{
+	s64_t now;
+	u32_t secs;
+	int rv;
+
+	if (service.waiting) {
+		/* Previous request got no reply */
+		service.poll = CONFIG_SNTP_SERVICE_POLL_MIN;
+	}
+
+	/* The originate timestamp is only echoed back by the server, so
+	 * uptime is used for it and kept locally for the computation.
+	 */
+	now = k_uptime_get();
+	secs = now / MSEC_PER_SEC + OFFSET_1970_JAN_1;
+
+	service.t1 = now;
+	service.orig_tm_f = ((u64_t)(now % MSEC_PER_SEC) << 32) /
+		MSEC_PER_SEC;
+	service.waiting = true;
+
+	rv = send_request(&service.ctx, secs, service.orig_tm_f, K_NO_WAIT);
+	if (rv < 0) {
+		NET_DBG("Failed to send request: %d", rv);
+	}
+
+	k_delayed_work_submit(&service.work, K_SECONDS(service.poll));
+}
+
+int sntp_service_start(const char *srv_addr, u16_t srv_port, u32_t timeout)
+{
+	int rv;
+
+	if (service.ctx.is_init) {
+		return -EALREADY;
+	}
+
+	rv = sntp_init(&service.ctx, srv_addr, srv_port, timeout);
+	if (rv < 0) {
+		return rv;
+	}
+
+	service.count = 0;
+	service.next = 0;
+	service.waiting = false;
+	service.poll = CONFIG_SNTP_SERVICE_POLL_MIN;
+
+	k_delayed_work_init(&service.work, service_poll);
+
+	return k_delayed_work_submit(&service.work, K_NO_WAIT);
+}
+
+void sntp_service_stop(void)
+{
+	if (!service.ctx.is_init) {
+		return;
+	}
+
+	k_delayed_work_cancel(&service.work);
+	sntp_close(&service.ctx);
+}
+
+int sntp_time_get(u64_t *epoch_ms)
+{
+	unsigned int key;
+	s64_t now;
+
+	if (!epoch_ms) {
+		return -EINVAL;
+	}
+
+	now = k_uptime_get();
+
+	key = irq_lock();
+
+	if (!service.synced) {
+		irq_unlock(key);
+		return -EAGAIN;
+	}
+
+	*epoch_ms = now + service_offset(now);
+
+	irq_unlock(key);
+
+	return 0;
+}
+#endif /* CONFIG_SNTP_SERVICE */
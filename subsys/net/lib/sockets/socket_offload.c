@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * BSD Sockets compatible API provided by an offloading driver. The calls
+ * go straight to the driver, with no net_context or net_pkt in between.
+ */
+
+#include <errno.h>
+#include <kernel.h>
+#include <net/net_ip.h>
+#include <net/socket_offload.h>
+
+static const struct socket_offload *socket_ops;
+
+/* Call an operation of the driver, failing if it doesn't provide it */
+#define SOCKET_OFFLOAD(op, ...)					\
+	((socket_ops && socket_ops->op) ?			\
+	 socket_ops->op(__VA_ARGS__) : (errno = EOPNOTSUPP, -1))
+
+void socket_offload_register(const struct socket_offload *ops)
+{
+	__ASSERT_NO_MSG(ops);
+	__ASSERT(!socket_ops, "Socket offload already registered");
+
+	socket_ops = ops;
+}
+
+int zsock_socket(int family, int type, int proto)
+{
+	return SOCKET_OFFLOAD(socket, family, type, proto);
+}
+
+int zsock_close(int sock)
+{
+	return SOCKET_OFFLOAD(close, sock);
+}
+
+int zsock_bind(int sock, const struct sockaddr *addr, socklen_t addrlen)
+{
+	return SOCKET_OFFLOAD(bind, sock, addr, addrlen);
+}
+
+int zsock_connect(int sock, const struct sockaddr *addr, socklen_t addrlen)
+{
+	return SOCKET_OFFLOAD(connect, sock, addr, addrlen);
+}
+
+int zsock_listen(int sock, int backlog)
+{
+	return SOCKET_OFFLOAD(listen, sock, backlog);
+}
+
+int zsock_accept(int sock, struct sockaddr *addr, socklen_t *addrlen)
+{
+	return SOCKET_OFFLOAD(accept, sock, addr, addrlen);
+}
+
+ssize_t zsock_send(int sock, const void *buf, size_t len, int flags)
+{
+	return SOCKET_OFFLOAD(sendto, sock, buf, len, flags, NULL, 0);
+}
+
+ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
+		     const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	return SOCKET_OFFLOAD(sendto, sock, buf, len, flags, dest_addr,
+			      addrlen);
+}
+
+ssize_t zsock_recv(int sock, void *buf, size_t max_len, int flags)
+{
+	return SOCKET_OFFLOAD(recvfrom, sock, buf, max_len, flags, NULL,
+			      NULL);
+}
+
+ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	return SOCKET_OFFLOAD(recvfrom, sock, buf, max_len, flags, src_addr,
+			      addrlen);
+}
+
+int zsock_setsockopt(int sock, int level, int optname,
+		     const void *optval, socklen_t optlen)
+{
+	return SOCKET_OFFLOAD(setsockopt, sock, level, optname, optval,
+			      optlen);
+}
+
+int zsock_getsockopt(int sock, int level, int optname,
+		     void *optval, socklen_t *optlen)
+{
+	return SOCKET_OFFLOAD(getsockopt, sock, level, optname, optval,
+			      optlen);
+}
+
+int zsock_fcntl(int sock, int cmd, int flags)
+{
+	return SOCKET_OFFLOAD(fcntl, sock, cmd, flags);
+}
+
+int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
+{
+	return SOCKET_OFFLOAD(poll, fds, nfds, timeout);
+}
+
+int zsock_getaddrinfo(const char *host, const char *service,
+		      const struct zsock_addrinfo *hints,
+		      struct zsock_addrinfo **res)
+{
+	return SOCKET_OFFLOAD(getaddrinfo, host, service, hints, res);
+}
+
+int zsock_inet_pton(sa_family_t family, const char *src, void *dst)
+{
+	if (net_addr_pton(family, src, dst) == 0) {
+		return 1;
+	} else {
+		return 0;
+	}
+}
@@ -16,8 +16,19 @@
 #include <kernel.h>
 #include <net/net_context.h>
 #include <net/net_pkt.h>
+#include <net/tcp.h>
 #include <net/socket.h>
 
+#if defined(CONFIG_NET_STATISTICS_LATENCY)
+#include <net/net_stats.h>
+
+/* Only the first look at a packet is accounted */
+#define sock_update_latency(pkt) \
+	net_stats_update_latency(pkt, NET_STATS_LATENCY_RX_SOCKET)
+#else
+#define sock_update_latency(pkt)
+#endif
+
 #define SOCK_EOF 1
 #define SOCK_NONBLOCK 2
 
@@ -73,6 +84,88 @@ static void zsock_flush_queue(struct net_context *ctx)
 	}
 }
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+struct zsock_epoll_entry {
+	/* Waits for the poll signal of the socket */
+	struct k_poll_event poll_event;
+	struct net_context *ctx;
+	struct zsock_epoll_event event;
+};
+
+struct zsock_epoll {
+	struct k_poll_set set;
+	struct zsock_epoll_entry entries[CONFIG_NET_SOCKETS_EPOLL_FDS];
+	bool used;
+};
+
+static struct zsock_epoll epolls[CONFIG_NET_SOCKETS_EPOLL_MAX];
+
+static struct zsock_epoll *zsock_epoll_get(int epfd)
+{
+	struct zsock_epoll *ep = INT_TO_POINTER(epfd);
+
+	if (ep < epolls || ep >= epolls + ARRAY_SIZE(epolls) || !ep->used) {
+		return NULL;
+	}
+
+	return ep;
+}
+
+static struct zsock_epoll_entry *zsock_epoll_find(struct zsock_epoll *ep,
+						  struct net_context *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ep->entries); i++) {
+		if (ep->entries[i].ctx == ctx) {
+			return &ep->entries[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void zsock_epoll_del(struct zsock_epoll *ep,
+			    struct zsock_epoll_entry *entry)
+{
+	(void)k_poll_set_remove(&ep->set, &entry->poll_event);
+	entry->ctx = NULL;
+}
+
+/* A closed socket leaves the interest lists it is in */
+static void zsock_epoll_forget(struct net_context *ctx)
+{
+	struct zsock_epoll_entry *entry;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(epolls); i++) {
+		if (!epolls[i].used) {
+			continue;
+		}
+
+		entry = zsock_epoll_find(&epolls[i], ctx);
+		if (entry) {
+			zsock_epoll_del(&epolls[i], entry);
+		}
+	}
+}
+
+static int zsock_epoll_close(struct zsock_epoll *ep)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(ep->entries); i++) {
+		if (ep->entries[i].ctx) {
+			zsock_epoll_del(ep, &ep->entries[i]);
+		}
+	}
+
+	ep->used = false;
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 int zsock_socket(int family, int type, int proto)
 {
 	struct net_context *ctx;
@@ -84,6 +177,9 @@ int zsock_socket(int family, int type, int proto)
 
 	/* recv_q and accept_q are in union */
 	k_fifo_init(&ctx->recv_q);
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	atomic_set(&ctx->recv_q_len, 0);
+#endif
 
 	/* TODO: Ensure non-negative */
 	return POINTER_TO_INT(ctx);
@@ -93,6 +189,16 @@ int zsock_close(int sock)
 {
 	struct net_context *ctx = INT_TO_POINTER(sock);
 
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+	struct zsock_epoll *ep = zsock_epoll_get(sock);
+
+	if (ep) {
+		return zsock_epoll_close(ep);
+	}
+
+	zsock_epoll_forget(ctx);
+#endif
+
 	/* Reset callbacks to avoid any race conditions while
 	 * flushing queues. No need to check return values here,
 	 * as these are fail-free operations and we're closing
@@ -119,8 +225,12 @@ static void zsock_accepted_cb(struct net_context *new_ctx,
 		(void)net_context_recv(new_ctx, zsock_received_cb, K_NO_WAIT,
 				       NULL);
 		k_fifo_init(&new_ctx->recv_q);
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+		atomic_set(&new_ctx->recv_q_len, 0);
+#endif
 
 		k_fifo_put(&parent->accept_q, new_ctx);
+		k_poll_signal(&parent->poll_signal, 0);
 	}
 }
 
@@ -147,6 +257,8 @@ static void zsock_received_cb(struct net_context *ctx, struct net_pkt *pkt,
 			net_pkt_set_eof(last_pkt, true);
 			NET_DBG("Set EOF flag on pkt %p", ctx);
 		}
+
+		k_poll_signal(&ctx->poll_signal, 0);
 		return;
 	}
 
@@ -161,8 +273,26 @@ static void zsock_received_cb(struct net_context *ctx, struct net_pkt *pkt,
 		net_buf_pull(pkt->frags, header_len);
 		net_context_update_recv_wnd(ctx, -net_pkt_appdatalen(pkt));
 	}
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	else {
+		u32_t len = net_pkt_appdatalen(pkt);
+
+		/* Datagrams are dropped rather than holding on to RX
+		 * buffers the other sockets need.
+		 */
+		if (atomic_get(&ctx->recv_q_len) + len > ctx->options.rcvbuf) {
+			NET_DBG("ctx %p receive buffer full, dropping pkt %p",
+				ctx, pkt);
+			net_pkt_unref(pkt);
+			return;
+		}
+
+		atomic_add(&ctx->recv_q_len, len);
+	}
+#endif
 
 	k_fifo_put(&ctx->recv_q, pkt);
+	k_poll_signal(&ctx->poll_signal, 0);
 }
 
 int zsock_bind(int sock, const struct sockaddr *addr, socklen_t addrlen)
@@ -235,50 +365,32 @@ ssize_t zsock_send(int sock, const void *buf, size_t len, int flags)
 	return zsock_sendto(sock, buf, len, flags, NULL, 0);
 }
 
-ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
-		     const struct sockaddr *dest_addr, socklen_t addrlen)
+static ssize_t zsock_send_pkt(struct net_context *ctx, struct net_pkt *pkt,
+			      const struct sockaddr *dest_addr,
+			      socklen_t addrlen, s32_t timeout)
 {
+	ssize_t len = net_pkt_get_len(pkt);
 	int err;
-	struct net_pkt *send_pkt;
-	s32_t timeout = K_FOREVER;
-	struct net_context *ctx = INT_TO_POINTER(sock);
-
-	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
-		timeout = K_NO_WAIT;
-	}
-
-	send_pkt = net_pkt_get_tx(ctx, timeout);
-	if (!send_pkt) {
-		errno = EAGAIN;
-		return -1;
-	}
-
-	len = net_pkt_append(send_pkt, len, buf, timeout);
-	if (!len) {
-		net_pkt_unref(send_pkt);
-		errno = EAGAIN;
-		return -1;
-	}
 
 	/* Register the callback before sending in order to receive the response
 	 * from the peer.
 	 */
 	err = net_context_recv(ctx, zsock_received_cb, K_NO_WAIT, ctx->user_data);
 	if (err < 0) {
-		net_pkt_unref(send_pkt);
+		net_pkt_unref(pkt);
 		errno = -err;
 		return -1;
 	}
 
 	if (dest_addr) {
-		err = net_context_sendto(send_pkt, dest_addr, addrlen, NULL,
+		err = net_context_sendto(pkt, dest_addr, addrlen, NULL,
 					 timeout, NULL, ctx->user_data);
 	} else {
-		err = net_context_send(send_pkt, NULL, timeout, NULL, ctx->user_data);
+		err = net_context_send(pkt, NULL, timeout, NULL, ctx->user_data);
 	}
 
 	if (err < 0) {
-		net_pkt_unref(send_pkt);
+		net_pkt_unref(pkt);
 		errno = -err;
 		return -1;
 	}
@@ -286,289 +398,1087 @@ ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
 	return len;
 }
 
-static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
-				       void *buf,
-				       size_t max_len,
-				       int flags,
-				       struct sockaddr *src_addr,
-				       socklen_t *addrlen)
+static inline s32_t zsock_timeout(struct net_context *ctx, int flags)
 {
-	size_t recv_len = 0;
-	s32_t timeout = K_FOREVER;
-	unsigned int header_len;
-	struct net_pkt *pkt;
-
 	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
-		timeout = K_NO_WAIT;
+		return K_NO_WAIT;
 	}
 
-	if (flags & ZSOCK_MSG_PEEK) {
-		int res;
+	return K_FOREVER;
+}
 
-		res = _k_fifo_wait_non_empty(&ctx->recv_q, timeout);
-		/* EAGAIN when timeout expired, EINTR when cancelled */
-		if (res && res != -EAGAIN && res != -EINTR) {
-			errno = -res;
-			return -1;
-		}
+ssize_t zsock_sendto(int sock, const void *buf, size_t len, int flags,
+		     const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	struct zsock_iovec iov = {
+		.iov_base = (void *)buf,
+		.iov_len = len,
+	};
+	struct zsock_msghdr msg = {
+		.msg_name = (void *)dest_addr,
+		.msg_namelen = addrlen,
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
 
-		pkt = k_fifo_peek_head(&ctx->recv_q);
-	} else {
-		pkt = k_fifo_get(&ctx->recv_q, timeout);
-	}
+	return zsock_sendmsg(sock, &msg, flags);
+}
 
-	if (!pkt) {
-		errno = EAGAIN;
-		return -1;
-	}
+#if defined(CONFIG_NET_TCP)
+/* Wait for room in the send buffer, 0 if there is none */
+static size_t zsock_wait_send_space(struct net_context *ctx, s32_t timeout)
+{
+	struct k_poll_event event;
+	size_t space;
 
-	if (src_addr && addrlen) {
-		int rv;
+	k_poll_event_init(&event, K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY,
+			  &ctx->poll_signal);
 
-		rv = net_pkt_get_src_addr(pkt, src_addr, *addrlen);
-		if (rv < 0) {
-			errno = rv;
-			return -1;
-		}
+	while (1) {
+		/* Reset first: an ACK from now on raises the signal again */
+		ctx->poll_signal.signaled = 0;
 
-		/* addrlen is a value-result argument, set to actual
-		 * size of source address
-		 */
-		if (src_addr->sa_family == AF_INET) {
-			*addrlen = sizeof(struct sockaddr_in);
-		} else if (src_addr->sa_family == AF_INET6) {
-			*addrlen = sizeof(struct sockaddr_in6);
-		} else {
-			errno = ENOTSUP;
-			return -1;
+		space = net_tcp_get_send_space(ctx);
+		if (space || timeout == K_NO_WAIT ||
+		    net_context_get_state(ctx) != NET_CONTEXT_CONNECTED) {
+			return space;
 		}
-	}
-
-	/* Set starting point behind packet header since we've
-	 * handled src addr and port.
-	 */
-	header_len = net_pkt_appdata(pkt) - pkt->frags->data;
 
-	recv_len = net_pkt_appdatalen(pkt);
-	if (recv_len > max_len) {
-		recv_len = max_len;
-	}
-
-	net_frag_linearize(buf, recv_len, pkt, header_len, recv_len);
-
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_pkt_unref(pkt);
+		event.state = K_POLL_STATE_NOT_READY;
+		if (k_poll(&event, 1, timeout) == -EAGAIN) {
+			return 0;
+		}
 	}
-
-	return recv_len;
 }
 
-static inline ssize_t zsock_recv_stream(struct net_context *ctx,
-					void *buf,
-					size_t max_len,
-					int flags)
+/* Queue as much as the send buffer takes, waiting for the peer to
+ * acknowledge data unless non-blocking.
+ */
+static ssize_t zsock_send_stream(struct net_context *ctx,
+				 const struct zsock_msghdr *msg, int flags)
 {
-	size_t recv_len = 0;
-	s32_t timeout = K_FOREVER;
-	int res;
-
-	if ((flags & ZSOCK_MSG_DONTWAIT) || sock_is_nonblock(ctx)) {
-		timeout = K_NO_WAIT;
-	}
-
-	do {
-		struct net_pkt *pkt;
-		struct net_buf *frag;
-		u32_t frag_len;
+	s32_t timeout = zsock_timeout(ctx, flags);
+	size_t i = 0, iov_off = 0;
+	ssize_t sent = 0;
+	bool short_append = false;
+
+	while (i < msg->msg_iovlen && !short_append) {
+		struct net_pkt *send_pkt;
+		size_t space;
+		ssize_t ret;
+
+		if (!msg->msg_iov[i].iov_len) {
+			i++;
+			continue;
+		}
 
-		if (sock_is_eof(ctx)) {
-			return 0;
+		space = zsock_wait_send_space(ctx, timeout);
+		if (!space) {
+			break;
 		}
 
-		res = _k_fifo_wait_non_empty(&ctx->recv_q, timeout);
-		/* EAGAIN when timeout expired, EINTR when cancelled */
-		if (res && res != -EAGAIN && res != -EINTR) {
-			errno = -res;
-			return -1;
+		send_pkt = net_pkt_get_tx(ctx, timeout);
+		if (!send_pkt) {
+			break;
 		}
 
-		pkt = k_fifo_peek_head(&ctx->recv_q);
-		if (!pkt) {
-			/* Either timeout expired, or wait was cancelled
-			 * due to connection closure by peer.
-			 */
-			NET_DBG("NULL return from fifo");
-			if (sock_is_eof(ctx)) {
-				return 0;
-			} else {
-				errno = EAGAIN;
-				return -1;
+		while (i < msg->msg_iovlen && space) {
+			const struct zsock_iovec *iov = &msg->msg_iov[i];
+			u16_t len, appended;
+
+			len = min(iov->iov_len - iov_off, min(space, UINT16_MAX));
+			appended = net_pkt_append(send_pkt, len,
+						  (u8_t *)iov->iov_base + iov_off,
+						  timeout);
+			iov_off += appended;
+			space -= appended;
+
+			if (iov_off == iov->iov_len) {
+				i++;
+				iov_off = 0;
 			}
-		}
 
-		frag = pkt->frags;
-		if (!frag) {
-			NET_ERR("net_pkt has empty fragments on start!");
-			errno = EAGAIN;
-			return -1;
+			if (appended < len) {
+				/* Out of buffers: send what was queued */
+				short_append = true;
+				break;
+			}
 		}
 
-		frag_len = frag->len;
-		recv_len = frag_len;
-		if (recv_len > max_len) {
-			recv_len = max_len;
+		if (!net_pkt_get_len(send_pkt)) {
+			net_pkt_unref(send_pkt);
+			break;
 		}
 
-		/* Actually copy data to application buffer */
-		memcpy(buf, frag->data, recv_len);
-
-		if (!(flags & ZSOCK_MSG_PEEK)) {
-			if (recv_len != frag_len) {
-				net_buf_pull(frag, recv_len);
-			} else {
-				frag = net_pkt_frag_del(pkt, NULL, frag);
-				if (!frag) {
-					/* Finished processing head pkt in
-					 * the fifo. Drop it from there.
-					 */
-					k_fifo_get(&ctx->recv_q, K_NO_WAIT);
-					if (net_pkt_eof(pkt)) {
-						sock_set_eof(ctx);
-					}
-
-					net_pkt_unref(pkt);
-				}
-			}
+		ret = zsock_send_pkt(ctx, send_pkt, NULL, 0, timeout);
+		if (ret < 0) {
+			return sent ? sent : -1;
 		}
-	} while (recv_len == 0);
 
-	if (!(flags & ZSOCK_MSG_PEEK)) {
-		net_context_update_recv_wnd(ctx, recv_len);
+		sent += ret;
 	}
 
-	return recv_len;
-}
+	if (sent || i == msg->msg_iovlen) {
+		return sent;
+	}
 
-ssize_t zsock_recv(int sock, void *buf, size_t max_len, int flags)
-{
-	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
+	errno = net_context_get_state(ctx) == NET_CONTEXT_CONNECTED ?
+		EAGAIN : ENOTCONN;
+	return -1;
 }
+#endif /* CONFIG_NET_TCP */
 
-ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
-		       struct sockaddr *src_addr, socklen_t *addrlen)
+/* Packet holding the data of a datagram, NULL with errno set if none */
+static struct net_pkt *zsock_dgram_pkt(struct net_context *ctx,
+				       const struct zsock_msghdr *msg,
+				       s32_t timeout)
 {
-	struct net_context *ctx = INT_TO_POINTER(sock);
-	enum net_sock_type sock_type = net_context_get_type(ctx);
+	struct net_pkt *send_pkt;
+	size_t i;
 
-	if (sock_type == SOCK_DGRAM) {
-		return zsock_recv_dgram(ctx, buf, max_len, flags, src_addr, addrlen);
-	} else if (sock_type == SOCK_STREAM) {
-		return zsock_recv_stream(ctx, buf, max_len, flags);
-	} else {
-		__ASSERT(0, "Unknown socket type");
+	send_pkt = net_pkt_get_tx(ctx, timeout);
+	if (!send_pkt) {
+		errno = EAGAIN;
+		return NULL;
 	}
 
-	return 0;
-}
-
-/* As this is limited function, we don't follow POSIX signature, with
- * "..." instead of last arg.
- */
-int zsock_fcntl(int sock, int cmd, int flags)
-{
-	struct net_context *ctx = INT_TO_POINTER(sock);
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		const struct zsock_iovec *iov = &msg->msg_iov[i];
+		u16_t len;
 
-	switch (cmd) {
-	case F_GETFL:
-		if (sock_is_nonblock(ctx)) {
-		    return O_NONBLOCK;
+		if (!iov->iov_len) {
+			continue;
 		}
-		return 0;
-	case F_SETFL:
-		if (flags & O_NONBLOCK) {
-			sock_set_flag(ctx, SOCK_NONBLOCK, SOCK_NONBLOCK);
-		} else {
-			sock_set_flag(ctx, SOCK_NONBLOCK, 0);
+
+		len = net_pkt_append(send_pkt, iov->iov_len, iov->iov_base,
+				     timeout);
+		if (len < iov->iov_len) {
+			/* Send what could be queued, as write() does */
+			break;
 		}
-		return 0;
-	default:
-		errno = EINVAL;
-		return -1;
 	}
+
+	if (!net_pkt_get_len(send_pkt)) {
+		net_pkt_unref(send_pkt);
+		errno = EAGAIN;
+		return NULL;
+	}
+
+	return send_pkt;
 }
 
-int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
+ssize_t zsock_sendmsg(int sock, const struct zsock_msghdr *msg, int flags)
 {
-	int i;
-	int ret = 0;
-	struct zsock_pollfd *pfd;
-	struct k_poll_event *pev;
-	struct k_poll_event *pev_end = poll_events + ARRAY_SIZE(poll_events);
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	s32_t timeout = zsock_timeout(ctx, flags);
+	struct net_pkt *send_pkt;
 
-	if (timeout < 0) {
-		timeout = K_FOREVER;
+#if defined(CONFIG_NET_TCP)
+	if (net_context_get_type(ctx) == SOCK_STREAM) {
+		return zsock_send_stream(ctx, msg, flags);
 	}
+#endif
 
-	pev = poll_events;
-	for (pfd = fds, i = nfds; i--; pfd++) {
+	send_pkt = zsock_dgram_pkt(ctx, msg, timeout);
+	if (!send_pkt) {
+		return -1;
+	}
 
-		/* Per POSIX, negative fd's are just ignored */
-		if (pfd->fd < 0) {
-			continue;
-		}
+	return zsock_send_pkt(ctx, send_pkt, msg->msg_name, msg->msg_namelen,
+			      timeout);
+}
 
-		if (pfd->events & ZSOCK_POLLIN) {
-			struct net_context *ctx = INT_TO_POINTER(pfd->fd);
+int zsock_sendmmsg(int sock, struct zsock_mmsghdr *msgvec, unsigned int vlen,
+		   int flags)
+{
+	struct net_context_dgram dgrams[CONFIG_NET_SOCKETS_MMSG_BATCH];
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	s32_t timeout = zsock_timeout(ctx, flags);
+	unsigned int sent = 0;
+	int err, n, i;
 
-			if (pev == pev_end) {
-				errno = ENOMEM;
-				return -1;
+	if (net_context_get_type(ctx) != SOCK_DGRAM) {
+		while (sent < vlen) {
+			ssize_t len;
+
+			len = zsock_sendmsg(sock, &msgvec[sent].msg_hdr, flags);
+			if (len < 0) {
+				break;
 			}
 
-			pev->obj = &ctx->recv_q;
-			pev->type = K_POLL_TYPE_FIFO_DATA_AVAILABLE;
-			pev->mode = K_POLL_MODE_NOTIFY_ONLY;
-			pev->state = K_POLL_STATE_NOT_READY;
-			pev++;
+			msgvec[sent++].msg_len = len;
 		}
+
+		return sent ? sent : -1;
 	}
 
-	ret = k_poll(poll_events, pev - poll_events, timeout);
-	if (ret != 0 && ret != -EAGAIN) {
-		errno = -ret;
+	/* Register the callback before sending in order to receive the response
+	 * from the peer.
+	 */
+	err = net_context_recv(ctx, zsock_received_cb, K_NO_WAIT, ctx->user_data);
+	if (err < 0) {
+		errno = -err;
 		return -1;
 	}
 
-	ret = 0;
+	while (sent < vlen) {
+		for (n = 0; n < ARRAY_SIZE(dgrams) && sent + n < vlen; n++) {
+			struct zsock_mmsghdr *mmsg = &msgvec[sent + n];
 
-	pev = poll_events;
-	for (pfd = fds, i = nfds; i--; pfd++) {
-		pfd->revents = 0;
+			dgrams[n].pkt = zsock_dgram_pkt(ctx, &mmsg->msg_hdr,
+							timeout);
+			if (!dgrams[n].pkt) {
+				break;
+			}
 
-		if (pfd->fd < 0) {
-			continue;
+			dgrams[n].dst_addr = mmsg->msg_hdr.msg_name;
+			dgrams[n].addrlen = mmsg->msg_hdr.msg_namelen;
+			dgrams[n].token = NULL;
+			mmsg->msg_len = net_pkt_get_len(dgrams[n].pkt);
 		}
 
-		/* For now, assume that socket is always writable */
-		if (pfd->events & ZSOCK_POLLOUT) {
-			pfd->revents |= ZSOCK_POLLOUT;
+		if (!n) {
+			break;
 		}
 
-		if (pfd->events & ZSOCK_POLLIN) {
-			if (pev->state != K_POLL_STATE_NOT_READY) {
-				pfd->revents |= ZSOCK_POLLIN;
+		err = net_context_sendto_batch(ctx, dgrams, n, NULL, timeout,
+					       ctx->user_data);
+		if (err < 0) {
+			errno = -err;
+			err = 0;
+		}
+
+		/* The datagrams left belong to us again */
+		for (i = err; i < n; i++) {
+			net_pkt_unref(dgrams[i].pkt);
+		}
+
+		sent += err;
+		if (err < n) {
+			break;
+		}
+	}
+
+	return sent ? sent : -1;
+}
+
+static int zsock_get_src_addr(struct net_pkt *pkt, struct sockaddr *src_addr,
+			      socklen_t *addrlen)
+{
+	int rv;
+
+	rv = net_pkt_get_src_addr(pkt, src_addr, *addrlen);
+	if (rv < 0) {
+		return rv;
+	}
+
+	/* addrlen is a value-result argument, set to actual
+	 * size of source address
+	 */
+	if (src_addr->sa_family == AF_INET) {
+		*addrlen = sizeof(struct sockaddr_in);
+	} else if (src_addr->sa_family == AF_INET6) {
+		*addrlen = sizeof(struct sockaddr_in6);
+	} else {
+		return -ENOTSUP;
+	}
+
+	return 0;
+}
+
+/* A datagram left the receive queue */
+static inline void zsock_dgram_dequeued(struct net_context *ctx,
+					struct net_pkt *pkt)
+{
+#if defined(CONFIG_NET_CONTEXT_RCVBUF)
+	atomic_sub(&ctx->recv_q_len, net_pkt_appdatalen(pkt));
+#endif
+}
+
+static struct net_pkt *zsock_wait_dgram(struct net_context *ctx, int flags)
+{
+	s32_t timeout = zsock_timeout(ctx, flags);
+	struct net_pkt *pkt;
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		int res;
+
+		res = _k_fifo_wait_non_empty(&ctx->recv_q, timeout);
+		/* EAGAIN when timeout expired, EINTR when cancelled */
+		if (res && res != -EAGAIN && res != -EINTR) {
+			errno = -res;
+			return NULL;
+		}
+
+		pkt = k_fifo_peek_head(&ctx->recv_q);
+	} else {
+		pkt = k_fifo_get(&ctx->recv_q, timeout);
+		if (pkt) {
+			zsock_dgram_dequeued(ctx, pkt);
+		}
+	}
+
+	if (!pkt) {
+		errno = EAGAIN;
+	} else {
+		sock_update_latency(pkt);
+	}
+
+	return pkt;
+}
+
+static inline ssize_t zsock_recv_dgram(struct net_context *ctx,
+				       struct zsock_msghdr *msg,
+				       int flags)
+{
+	size_t recv_len = 0;
+	unsigned int header_len;
+	struct net_pkt *pkt;
+	size_t i;
+
+	pkt = zsock_wait_dgram(ctx, flags);
+	if (!pkt) {
+		return -1;
+	}
+
+	if (msg->msg_name) {
+		int rv;
+
+		rv = zsock_get_src_addr(pkt, msg->msg_name,
+					&msg->msg_namelen);
+		if (rv < 0) {
+			errno = -rv;
+			return -1;
+		}
+	}
+
+	/* Set starting point behind packet header since we've
+	 * handled src addr and port.
+	 */
+	header_len = net_pkt_appdata(pkt) - pkt->frags->data;
+
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		struct zsock_iovec *iov = &msg->msg_iov[i];
+		size_t len;
+
+		len = min(iov->iov_len, net_pkt_appdatalen(pkt) - recv_len);
+		if (!len) {
+			continue;
+		}
+
+		net_frag_linearize(iov->iov_base, len, pkt,
+				   header_len + recv_len, len);
+		recv_len += len;
+	}
+
+	if (recv_len < net_pkt_appdatalen(pkt)) {
+		/* The rest of the datagram is discarded */
+		msg->msg_flags |= ZSOCK_MSG_TRUNC;
+	}
+
+	if (!(flags & ZSOCK_MSG_PEEK)) {
+		net_pkt_unref(pkt);
+	}
+
+	return recv_len;
+}
+
+/* Wait for the head packet of the receive queue of a stream socket.
+ * Returns NULL with res set to 0 on EOF, to a negative errno otherwise.
+ */
+static struct net_pkt *zsock_wait_stream(struct net_context *ctx,
+					 s32_t timeout, int *res)
+{
+	struct net_pkt *pkt;
+
+	if (sock_is_eof(ctx)) {
+		*res = 0;
+		return NULL;
+	}
+
+	*res = _k_fifo_wait_non_empty(&ctx->recv_q, timeout);
+	/* EAGAIN when timeout expired, EINTR when cancelled */
+	if (*res && *res != -EAGAIN && *res != -EINTR) {
+		return NULL;
+	}
+
+	pkt = k_fifo_peek_head(&ctx->recv_q);
+	if (!pkt) {
+		/* Either timeout expired, or wait was cancelled
+		 * due to connection closure by peer.
+		 */
+		NET_DBG("NULL return from fifo");
+		*res = sock_is_eof(ctx) ? 0 : -EAGAIN;
+		return NULL;
+	}
+
+	if (!pkt->frags) {
+		NET_ERR("net_pkt has empty fragments on start!");
+		*res = -EAGAIN;
+		return NULL;
+	}
+
+	sock_update_latency(pkt);
+
+	*res = 0;
+
+	return pkt;
+}
+
+/* The head packet was consumed: drop it from the fifo */
+static void zsock_stream_pkt_done(struct net_context *ctx,
+				  struct net_pkt *pkt)
+{
+	k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+	if (net_pkt_eof(pkt)) {
+		sock_set_eof(ctx);
+	}
+
+	net_pkt_unref(pkt);
+}
+
+static inline ssize_t zsock_recv_stream(struct net_context *ctx,
+					struct zsock_msghdr *msg,
+					int flags)
+{
+	bool peek = flags & ZSOCK_MSG_PEEK;
+	s32_t timeout = zsock_timeout(ctx, flags);
+	size_t recv_len = 0, max_len = 0;
+	size_t i;
+
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		max_len += msg->msg_iov[i].iov_len;
+	}
+
+	do {
+		size_t iov_off = 0, frag_off = 0;
+		struct net_buf *frag;
+		struct net_pkt *pkt;
+		int res;
+
+		pkt = zsock_wait_stream(ctx, timeout, &res);
+		if (!pkt) {
+			if (res) {
+				errno = -res;
+				return -1;
+			}
+
+			return 0;
+		}
+
+		frag = pkt->frags;
+		i = 0;
+
+		/* Copy as much as is queued, without waiting for more */
+		while (i < msg->msg_iovlen) {
+			struct zsock_iovec *iov = &msg->msg_iov[i];
+			size_t len;
+
+			len = min(iov->iov_len - iov_off, frag->len - frag_off);
+
+			/* Actually copy data to application buffer */
+			memcpy((u8_t *)iov->iov_base + iov_off,
+			       frag->data + frag_off, len);
+			recv_len += len;
+			iov_off += len;
+			frag_off += len;
+
+			if (iov_off == iov->iov_len) {
+				i++;
+				iov_off = 0;
+			}
+
+			if (frag_off < frag->len) {
+				continue;
+			}
+
+			frag_off = 0;
+
+			if (peek) {
+				/* Only the head packet can be peeked at */
+				frag = frag->frags;
+				if (!frag) {
+					break;
+				}
+
+				continue;
+			}
+
+			frag = net_pkt_frag_del(pkt, NULL, frag);
+			if (frag) {
+				continue;
+			}
+
+			/* Finished processing head pkt in the fifo */
+			zsock_stream_pkt_done(ctx, pkt);
+			if (sock_is_eof(ctx)) {
+				break;
+			}
+
+			pkt = k_fifo_peek_head(&ctx->recv_q);
+			if (!pkt || !pkt->frags) {
+				break;
 			}
-			pev++;
+
+			sock_update_latency(pkt);
+
+			frag = pkt->frags;
 		}
 
-		if (pfd->revents != 0) {
-			ret++;
+		if (!peek && frag_off) {
+			net_buf_pull(frag, frag_off);
 		}
+	} while (recv_len == 0 && max_len);
+
+	if (!peek) {
+		net_context_update_recv_wnd(ctx, recv_len);
+	}
+
+	return recv_len;
+}
+
+ssize_t zsock_recv(int sock, void *buf, size_t max_len, int flags)
+{
+	return zsock_recvfrom(sock, buf, max_len, flags, NULL, NULL);
+}
+
+ssize_t zsock_recvfrom(int sock, void *buf, size_t max_len, int flags,
+		       struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct zsock_iovec iov = {
+		.iov_base = buf,
+		.iov_len = max_len,
+	};
+	struct zsock_msghdr msg = {
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
+	ssize_t ret;
+
+	if (src_addr && addrlen) {
+		msg.msg_name = src_addr;
+		msg.msg_namelen = *addrlen;
+	}
+
+	ret = zsock_recvmsg(sock, &msg, flags);
+	if (ret >= 0 && msg.msg_name) {
+		*addrlen = msg.msg_namelen;
 	}
 
 	return ret;
 }
 
+ssize_t zsock_recvmsg(int sock, struct zsock_msghdr *msg, int flags)
+{
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	enum net_sock_type sock_type = net_context_get_type(ctx);
+
+	/* No ancillary data is supported */
+	msg->msg_controllen = 0;
+	msg->msg_flags = 0;
+
+	if (sock_type == SOCK_DGRAM) {
+		return zsock_recv_dgram(ctx, msg, flags);
+	} else if (sock_type == SOCK_STREAM) {
+		/* There is no peer address to report */
+		msg->msg_namelen = 0;
+		return zsock_recv_stream(ctx, msg, flags);
+	} else {
+		__ASSERT(0, "Unknown socket type");
+	}
+
+	return 0;
+}
+
+int zsock_recvmmsg(int sock, struct zsock_mmsghdr *msgvec, unsigned int vlen,
+		   int flags)
+{
+	unsigned int recvd = 0;
+	int saved_errno = errno;
+
+	while (recvd < vlen) {
+		ssize_t len;
+
+		len = zsock_recvmsg(sock, &msgvec[recvd].msg_hdr, flags);
+		if (len < 0) {
+			break;
+		}
+
+		msgvec[recvd++].msg_len = len;
+
+		if (flags & ZSOCK_MSG_WAITFORONE) {
+			flags |= ZSOCK_MSG_DONTWAIT;
+		}
+	}
+
+	if (!recvd) {
+		return -1;
+	}
+
+	/* Running out of datagrams after the first one is no error */
+	errno = saved_errno;
+
+	return recvd;
+}
+
+struct net_buf *zsock_zc_buf_get(int sock, s32_t timeout)
+{
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	struct net_buf *buf;
+
+	buf = net_pkt_get_data(ctx, timeout);
+	if (!buf) {
+		errno = ENOMEM;
+	}
+
+	return buf;
+}
+
+void zsock_zc_buf_put(struct net_buf *frags)
+{
+	net_buf_unref(frags);
+}
+
+ssize_t zsock_sendto_zc(int sock, struct net_buf *frags, int flags,
+			const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	s32_t timeout = zsock_timeout(ctx, flags);
+	struct net_pkt *send_pkt;
+
+	send_pkt = net_pkt_get_tx(ctx, timeout);
+	if (!send_pkt) {
+		errno = EAGAIN;
+		return -1;
+	}
+
+	/* The stack adds the headers in fragments of their own, in front
+	 * of the data.
+	 */
+	net_pkt_frag_add(send_pkt, frags);
+
+	return zsock_send_pkt(ctx, send_pkt, dest_addr, addrlen, timeout);
+}
+
+ssize_t zsock_recvfrom_zc(int sock, struct net_buf **frags, int flags,
+			  struct sockaddr *src_addr, socklen_t *addrlen)
+{
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	struct net_pkt *pkt;
+	ssize_t recv_len;
+
+	if (flags & ZSOCK_MSG_PEEK) {
+		errno = EOPNOTSUPP;
+		return -1;
+	}
+
+	if (net_context_get_type(ctx) == SOCK_DGRAM) {
+		pkt = zsock_wait_dgram(ctx, flags);
+		if (!pkt) {
+			return -1;
+		}
+
+		if (src_addr && addrlen) {
+			int rv = zsock_get_src_addr(pkt, src_addr, addrlen);
+
+			if (rv < 0) {
+				net_pkt_unref(pkt);
+				errno = -rv;
+				return -1;
+			}
+		}
+
+		net_buf_pull(pkt->frags, net_pkt_appdata(pkt) -
+			     pkt->frags->data);
+		recv_len = net_pkt_appdatalen(pkt);
+	} else {
+		int res;
+
+		pkt = zsock_wait_stream(ctx, zsock_timeout(ctx, flags), &res);
+		if (!pkt) {
+			if (res) {
+				errno = -res;
+				return -1;
+			}
+
+			*frags = NULL;
+			return 0;
+		}
+
+		/* The header was pulled when the packet was queued */
+		recv_len = net_buf_frags_len(pkt->frags);
+		k_fifo_get(&ctx->recv_q, K_NO_WAIT);
+		if (net_pkt_eof(pkt)) {
+			sock_set_eof(ctx);
+		}
+
+		/* The window opens now, not when the buffers come back */
+		net_context_update_recv_wnd(ctx, recv_len);
+	}
+
+	/* Hand the data fragments over, the packet itself is done */
+	*frags = pkt->frags;
+	pkt->frags = NULL;
+	net_pkt_unref(pkt);
+
+	return recv_len;
+}
+
+static int zsock_sockopt_get(int level, int optname,
+			     enum net_context_option *option)
+{
+	if (level != SOL_SOCKET) {
+		return -ENOPROTOOPT;
+	}
+
+	switch (optname) {
+	case SO_RCVBUF:
+		*option = NET_OPT_RCVBUF;
+		return 0;
+	case SO_SNDBUF:
+		*option = NET_OPT_SNDBUF;
+		return 0;
+	}
+
+	return -ENOPROTOOPT;
+}
+
+int zsock_setsockopt(int sock, int level, int optname,
+		     const void *optval, socklen_t optlen)
+{
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	enum net_context_option option;
+	u32_t val;
+
+	SET_ERRNO(zsock_sockopt_get(level, optname, &option));
+
+	if (optlen != sizeof(int) || *(const int *)optval < 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	val = *(const int *)optval;
+
+	SET_ERRNO(net_context_set_option(ctx, option, &val, sizeof(val)));
+
+	return 0;
+}
+
+int zsock_getsockopt(int sock, int level, int optname,
+		     void *optval, socklen_t *optlen)
+{
+	struct net_context *ctx = INT_TO_POINTER(sock);
+	enum net_context_option option;
+	size_t len;
+	u32_t val;
+
+	SET_ERRNO(zsock_sockopt_get(level, optname, &option));
+
+	if (*optlen < sizeof(int)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	SET_ERRNO(net_context_get_option(ctx, option, &val, &len));
+
+	*(int *)optval = val;
+	*optlen = sizeof(int);
+
+	return 0;
+}
+
+/* As this is limited function, we don't follow POSIX signature, with
+ * "..." instead of last arg.
+ */
+int zsock_fcntl(int sock, int cmd, int flags)
+{
+	struct net_context *ctx = INT_TO_POINTER(sock);
+
+	switch (cmd) {
+	case F_GETFL:
+		if (sock_is_nonblock(ctx)) {
+		    return O_NONBLOCK;
+		}
+		return 0;
+	case F_SETFL:
+		if (flags & O_NONBLOCK) {
+			sock_set_flag(ctx, SOCK_NONBLOCK, SOCK_NONBLOCK);
+		} else {
+			sock_set_flag(ctx, SOCK_NONBLOCK, 0);
+		}
+		return 0;
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+}
+
+/* Current readiness of a socket, as ZSOCK_POLL* events */
+static u32_t zsock_ready(struct net_context *ctx)
+{
+	u32_t events = 0;
+
+	/* recv_q and accept_q are shared via a union */
+	if (!k_fifo_is_empty(&ctx->recv_q) || sock_is_eof(ctx)) {
+		events |= ZSOCK_POLLIN;
+	}
+
+	if (net_context_get_type(ctx) != SOCK_STREAM) {
+		events |= ZSOCK_POLLOUT;
+	}
+#if defined(CONFIG_NET_TCP)
+	else if (net_context_get_state(ctx) == NET_CONTEXT_CONNECTED &&
+		 net_tcp_get_send_space(ctx)) {
+		events |= ZSOCK_POLLOUT;
+	}
+#endif
+
+	return events;
+}
+
+/* Readiness of a socket for the given events. The poll signal is reset
+ * first, so that any change from then on raises it again.
+ */
+static u32_t zsock_check(struct net_context *ctx, u32_t events)
+{
+	ctx->poll_signal.signaled = 0;
+
+	return zsock_ready(ctx) & events;
+}
+
+int zsock_poll(struct zsock_pollfd *fds, int nfds, int timeout)
+{
+	int i;
+	int ret = 0;
+	struct zsock_pollfd *pfd;
+	struct k_poll_event *pev;
+	struct k_poll_event *pev_end = poll_events + ARRAY_SIZE(poll_events);
+	s64_t end = timeout > 0 ? k_uptime_get() + timeout : 0;
+
+	if (timeout < 0) {
+		timeout = K_FOREVER;
+	}
+
+	while (1) {
+		pev = poll_events;
+		for (pfd = fds, i = nfds; i--; pfd++) {
+			struct net_context *ctx = INT_TO_POINTER(pfd->fd);
+
+			pfd->revents = 0;
+
+			/* Per POSIX, negative fd's are just ignored */
+			if (pfd->fd < 0) {
+				continue;
+			}
+
+			if (pev == pev_end) {
+				errno = ENOMEM;
+				return -1;
+			}
+
+			pfd->revents = zsock_check(ctx, pfd->events);
+			if (pfd->revents != 0) {
+				ret++;
+			}
+
+			/* Every readiness change raises the poll signal */
+			k_poll_event_init(pev++, K_POLL_TYPE_SIGNAL,
+					  K_POLL_MODE_NOTIFY_ONLY,
+					  &ctx->poll_signal);
+		}
+
+		if (ret || timeout == K_NO_WAIT) {
+			return ret;
+		}
+
+		ret = k_poll(poll_events, pev - poll_events, timeout);
+		if (ret == -EAGAIN) {
+			return 0;
+		}
+
+		if (ret != 0) {
+			errno = -ret;
+			return -1;
+		}
+
+		if (timeout != K_FOREVER) {
+			timeout = max(end - k_uptime_get(), K_NO_WAIT);
+		}
+	}
+}
+
+#if defined(CONFIG_NET_SOCKETS_EPOLL)
+int zsock_epoll_create1(int flags)
+{
+	int i;
+
+	ARG_UNUSED(flags);
+
+	for (i = 0; i < ARRAY_SIZE(epolls); i++) {
+		if (!epolls[i].used) {
+			memset(&epolls[i], 0, sizeof(epolls[i]));
+			k_poll_set_init(&epolls[i].set);
+			epolls[i].used = true;
+
+			return POINTER_TO_INT(&epolls[i]);
+		}
+	}
+
+	errno = EMFILE;
+	return -1;
+}
+
+int zsock_epoll_ctl(int epfd, int op, int fd, struct zsock_epoll_event *event)
+{
+	struct zsock_epoll *ep = zsock_epoll_get(epfd);
+	struct net_context *ctx = INT_TO_POINTER(fd);
+	struct zsock_epoll_entry *entry;
+	int ret;
+
+	if (!ep || fd < 0) {
+		errno = EBADF;
+		return -1;
+	}
+
+	entry = zsock_epoll_find(ep, ctx);
+
+	switch (op) {
+	case ZSOCK_EPOLL_CTL_ADD:
+		if (entry) {
+			errno = EEXIST;
+			return -1;
+		}
+
+		entry = zsock_epoll_find(ep, NULL);
+		if (!entry) {
+			errno = ENOSPC;
+			return -1;
+		}
+
+		k_poll_event_init(&entry->poll_event, K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, &ctx->poll_signal);
+
+		/* Only one poller waits for a given signal */
+		ret = k_poll_set_add(&ep->set, &entry->poll_event);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+
+		entry->ctx = ctx;
+		entry->event = *event;
+		break;
+
+	case ZSOCK_EPOLL_CTL_MOD:
+		if (!entry) {
+			errno = ENOENT;
+			return -1;
+		}
+
+		entry->event = *event;
+		break;
+
+	case ZSOCK_EPOLL_CTL_DEL:
+		if (!entry) {
+			errno = ENOENT;
+			return -1;
+		}
+
+		zsock_epoll_del(ep, entry);
+		return 0;
+
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+
+	/* Have the next wait report what the socket is ready for already */
+	k_poll_signal(&ctx->poll_signal, 0);
+
+	return 0;
+}
+
+int zsock_epoll_wait(int epfd, struct zsock_epoll_event *events,
+		     int maxevents, int timeout)
+{
+	struct zsock_epoll *ep = zsock_epoll_get(epfd);
+	struct k_poll_event *ready[CONFIG_NET_SOCKETS_EPOLL_FDS];
+	s64_t end = timeout > 0 ? k_uptime_get() + timeout : 0;
+	int i, num_events, ret;
+
+	if (!ep) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (maxevents <= 0) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (timeout < 0) {
+		timeout = K_FOREVER;
+	}
+
+	maxevents = min(maxevents, ARRAY_SIZE(ready));
+
+	while (1) {
+		/* Only the sockets whose signal was raised are looked at */
+		ret = k_poll_set_wait(&ep->set, ready, maxevents, timeout);
+		if (ret == -EAGAIN) {
+			return 0;
+		}
+
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+
+		num_events = 0;
+		for (i = 0; i < ret; i++) {
+			struct zsock_epoll_entry *entry;
+			u32_t revents;
+
+			entry = CONTAINER_OF(ready[i],
+					     struct zsock_epoll_entry,
+					     poll_event);
+
+			revents = zsock_check(entry->ctx, entry->event.events &
+					      (ZSOCK_EPOLLIN | ZSOCK_EPOLLOUT));
+			if (!revents) {
+				continue;
+			}
+
+			if (!(entry->event.events & ZSOCK_EPOLLET)) {
+				/* Level-triggered: keep reporting the socket
+				 * until it is not ready anymore.
+				 */
+				entry->ctx->poll_signal.signaled = 1;
+			}
+
+			events[num_events].events = revents;
+			events[num_events].data = entry->event.data;
+			num_events++;
+		}
+
+		if (num_events) {
+			return num_events;
+		}
+
+		/* The changes did not make any socket ready: wait again
+		 * for what is left of the waiting period.
+		 */
+		if (timeout != K_FOREVER) {
+			timeout = max(end - k_uptime_get(), K_NO_WAIT);
+			if (timeout == K_NO_WAIT) {
+				return 0;
+			}
+		}
+	}
+}
+
+#endif /* CONFIG_NET_SOCKETS_EPOLL */
+
 int zsock_inet_pton(sa_family_t family, const char *src, void *dst)
 {
 	if (net_addr_pton(family, src, dst) == 0) {
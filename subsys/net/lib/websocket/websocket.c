@@ -30,13 +30,39 @@
 /* From RFC 6455 chapter 4.2.2 */
 #define WS_MAGIC "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
 
-static void ws_mask_payload(u8_t *payload, size_t payload_len,
-			    u32_t masking_value)
+/* XOR data with the masking key, data[0] being byte "offset" of the
+ * payload. Aligned data is processed a 32-bit word at a time.
+ */
+static void ws_mask_data(u8_t *data, size_t len, u32_t masking_value,
+			 u32_t offset)
 {
-	int i;
+	u32_t word_key;
+	u8_t key[4];
+	size_t i;
+
+	for (i = 0; i < sizeof(key); i++) {
+		key[i] = masking_value >> (8 * (3 - (offset + i) % 4));
+	}
 
-	for (i = 0; i < payload_len; i++) {
-		payload[i] ^= masking_value >> (8 * (3 - i % 4));
+	for (i = 0; i < len && (POINTER_TO_UINT(data + i) & 3); i++) {
+		data[i] ^= key[i % 4];
+	}
+
+	if (len - i >= sizeof(word_key)) {
+		u8_t rotated[4] = {
+			key[i % 4], key[(i + 1) % 4],
+			key[(i + 2) % 4], key[(i + 3) % 4],
+		};
+
+		memcpy(&word_key, rotated, sizeof(word_key));
+
+		for (; len - i >= sizeof(word_key); i += sizeof(word_key)) {
+			*(u32_t *)(data + i) ^= word_key;
+		}
+	}
+
+	for (; i < len; i++) {
+		data[i] ^= key[i % 4];
 	}
 }
 
@@ -44,7 +70,6 @@ void ws_mask_pkt(struct net_pkt *pkt, u32_t masking_value, u32_t *data_read)
 {
 	struct net_buf *frag;
 	u16_t pos;
-	int i;
 
 	frag = net_frag_get_pos(pkt,
 				net_pkt_get_len(pkt) - net_pkt_appdatalen(pkt),
@@ -56,22 +81,99 @@ void ws_mask_pkt(struct net_pkt *pkt, u32_t masking_value, u32_t *data_read)
 	NET_ASSERT(net_pkt_appdata(pkt) == frag->data + pos);
 
 	while (frag) {
-		for (i = pos; i < frag->len; i++, (*data_read)++) {
-			frag->data[i] ^=
-				masking_value >> (8 * (3 - (*data_read) % 4));
-		}
+		ws_mask_data(frag->data + pos, frag->len - pos,
+			     masking_value, *data_read);
+		*data_read += frag->len - pos;
 
 		pos = 0;
 		frag = frag->frags;
 	}
 }
 
+void ws_pull_header(struct net_pkt *pkt, u32_t header_len)
+{
+	struct net_buf *frag;
+
+	while (header_len && pkt->frags) {
+		frag = pkt->frags;
+
+		if (header_len < frag->len) {
+			net_buf_pull(frag, header_len);
+			return;
+		}
+
+		header_len -= frag->len;
+		net_pkt_frag_del(pkt, NULL, frag);
+	}
+}
+
+struct net_buf *ws_split_frags(struct net_pkt *pkt, u32_t len,
+			       s32_t timeout)
+{
+	struct net_buf *frag = pkt->frags;
+	struct net_buf *rest = NULL;
+	struct net_buf *copy;
+	u16_t tail_len;
+	u8_t *tail;
+
+	if (!len) {
+		pkt->frags = NULL;
+		return frag;
+	}
+
+	while (frag && len > frag->len) {
+		len -= frag->len;
+		frag = frag->frags;
+	}
+
+	if (!frag) {
+		return NULL;
+	}
+
+	/* Only the tail of the fragment holding the boundary is copied,
+	 * the following fragments are moved as they are.
+	 */
+	tail = frag->data + len;
+	tail_len = frag->len - len;
+
+	while (tail_len) {
+		copy = net_pkt_get_frag(pkt, timeout);
+		if (!copy) {
+			if (rest) {
+				net_pkt_frag_unref(rest);
+			}
+
+			return NULL;
+		}
+
+		copy->len = min(tail_len, net_buf_tailroom(copy));
+		memcpy(copy->data, tail, copy->len);
+		tail += copy->len;
+		tail_len -= copy->len;
+
+		rest = net_buf_frag_add(rest, copy);
+	}
+
+	if (rest) {
+		net_buf_frag_last(rest)->frags = frag->frags;
+	} else {
+		rest = frag->frags;
+	}
+
+	frag->frags = NULL;
+	frag->len = len;
+
+	return rest;
+}
+
 int ws_send_msg(struct http_ctx *ctx, u8_t *payload, size_t payload_len,
 		enum ws_opcode opcode, bool mask, bool final,
 		const struct sockaddr *dst,
 		void *user_send_data)
 {
 	u8_t header[14], hdr_len = 2;
+	struct net_buf *frag;
+	struct net_pkt *pkt;
 	int ret;
 
 	if (ctx->state != HTTP_STATE_OPEN) {
@@ -115,9 +217,36 @@ int ws_send_msg(struct http_ctx *ctx, u8_t *payload, size_t payload_len,
 		hdr_len += 8;
 	}
 
-	/* Add masking value if needed */
+	/* Data queued by the HTTP layer must go out before this frame */
+	ret = http_send_flush(ctx, user_send_data);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (dst) {
+		pkt = net_app_get_net_pkt_with_dst(&ctx->app_ctx, dst,
+						   ctx->timeout);
+	} else {
+		pkt = net_app_get_net_pkt(&ctx->app_ctx, AF_UNSPEC,
+					  ctx->timeout);
+	}
+
+	if (!pkt) {
+		return -ENOMEM;
+	}
+
+	if (payload && !net_pkt_append_all(pkt, payload_len, payload,
+					   ctx->timeout)) {
+		NET_DBG("Cannot add %zd bytes message", payload_len);
+		ret = -ENOMEM;
+		goto fail;
+	}
+
+	/* Add masking value if needed, the copy of the payload in the
+	 * packet is masked so the caller's buffer is left untouched.
+	 */
 	if (mask) {
-		u32_t masking_value;
+		u32_t masking_value, offset = 0;
 
 		masking_value = sys_rand32_get();
 
@@ -126,28 +255,41 @@ int ws_send_msg(struct http_ctx *ctx, u8_t *payload, size_t payload_len,
 		header[hdr_len++] |= masking_value >> 8;
 		header[hdr_len++] |= masking_value;
 
-		ws_mask_payload(payload, payload_len, masking_value);
+		for (frag = pkt->frags; frag; frag = frag->frags) {
+			ws_mask_data(frag->data, frag->len, masking_value,
+				     offset);
+			offset += frag->len;
+		}
 	}
 
-	ret = http_prepare_and_send(ctx, header, hdr_len, dst, user_send_data);
-	if (ret < 0) {
-		NET_DBG("Cannot add ws header (%d)", ret);
-		goto quit;
+	/* The header goes into the headroom of the first fragment when
+	 * there is enough of it, otherwise into a fragment of its own.
+	 */
+	frag = pkt->frags;
+	if (frag && net_buf_headroom(frag) >= hdr_len) {
+		memcpy(net_buf_push(frag, hdr_len), header, hdr_len);
+	} else {
+		frag = net_pkt_get_frag(pkt, ctx->timeout);
+		if (!frag) {
+			ret = -ENOMEM;
+			goto fail;
+		}
+
+		net_buf_add_mem(frag, header, hdr_len);
+		net_pkt_frag_insert(pkt, frag);
 	}
 
-	if (payload) {
-		ret = http_prepare_and_send(ctx, payload, payload_len,
-					    dst, user_send_data);
-		if (ret < 0) {
-			NET_DBG("Cannot send %zd bytes message (%d)",
-				payload_len, ret);
-			goto quit;
-		}
+	ret = http_send_msg_raw(ctx, pkt, user_send_data);
+	if (ret < 0) {
+		NET_DBG("Cannot send ws message (%d)", ret);
+		goto fail;
 	}
 
-	ret = http_send_flush(ctx, user_send_data);
+	return ret;
+
+fail:
+	net_pkt_unref(pkt);
 
-quit:
 	return ret;
 }
 
@@ -156,7 +298,7 @@ int ws_strip_header(struct net_pkt *pkt, bool *masked, u32_t *mask_value,
 		    u32_t *header_len)
 {
 	struct net_buf *frag;
-	u16_t value, pos, appdata_pos;
+	u16_t value, pos;
 	u8_t len; /* message length byte */
 	u8_t len_len; /* length of the length field in header */
 
@@ -203,17 +345,28 @@ int ws_strip_header(struct net_pkt *pkt, bool *masked, u32_t *mask_value,
 
 		*message_length = msg_len;
 	} else {
-		len_len = 4;
+		u32_t msg_len_high;
+
+		/* 64 bit length, only the lower 32 bits are supported */
+		len_len = 8;
+
+		frag = net_frag_read_be32(frag, pos, &pos, &msg_len_high);
+		if (!frag && pos == 0xffff) {
+			return -ENOMSG;
+		}
 
 		frag = net_frag_read_be32(frag, pos, &pos, message_length);
 		if (!frag && pos == 0xffff) {
 			return -ENOMSG;
 		}
+
+		if (msg_len_high) {
+			return -EMSGSIZE;
+		}
 	}
 
 	if (value & 0x0080) {
 		*masked = true;
-		appdata_pos = 0;
 
 		frag = net_frag_read_be32(frag, pos, &pos, mask_value);
 		if (!frag && pos == 0xffff) {
@@ -221,18 +374,10 @@ int ws_strip_header(struct net_pkt *pkt, bool *masked, u32_t *mask_value,
 		}
 	} else {
 		*masked = false;
-		appdata_pos = len_len;
 	}
 
-	frag = net_frag_get_pos(pkt, pos + appdata_pos, &pos);
-	if (!frag && pos == 0xffff) {
-		return -ENOMSG;
-	}
-
-	/* Minimum websocket header is 6 bytes, header length might be
-	 * bigger depending on length field len.
-	 */
-	*header_len = 6 + len_len;
+	/* Fixed 2 bytes, extended length and masking key */
+	*header_len = 2 + len_len + (*masked ? 4 : 0);
 
 	return 0;
 }
@@ -44,6 +44,33 @@ int ws_strip_header(struct net_pkt *pkt, bool *masked, u32_t *mask_value,
  */
 void ws_mask_pkt(struct net_pkt *pkt, u32_t masking_value, u32_t *data_read);
 
+/**
+ * @brief Remove websocket header from the start of the packet.
+ *
+ * @details The header may span several fragments, fragments that become
+ * empty are released.
+ *
+ * @param pkt Network packet to process
+ * @param header_len Length of the websocket header.
+ */
+void ws_pull_header(struct net_pkt *pkt, u32_t header_len);
+
+/**
+ * @brief Split the packet data at a websocket frame boundary.
+ *
+ * @details The packet is left with the first len bytes of data. Only the
+ * fragment containing the boundary is copied, the fragments after it are
+ * moved to the returned chain as they are.
+ *
+ * @param pkt Network packet to split
+ * @param len Number of bytes to keep in the packet
+ * @param timeout Timeout for fragment allocation
+ *
+ * @return Fragment chain holding the data after len bytes, NULL if error
+ */
+struct net_buf *ws_split_frags(struct net_pkt *pkt, u32_t len,
+			       s32_t timeout);
+
 /**
  * @brief This is called by HTTP server after all the HTTP headers have been
  * received.
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Cryptographically secure random numbers from the TinyCrypt AES-CTR
+ * DRBG, seeded from the entropy driver. The DRBG output is generated a
+ * block at a time into a small buffer, so most calls only copy four
+ * bytes out of it. Neither blocks, so sys_rand32_get() can be used from
+ * ISRs.
+ */
+
+#include <init.h>
+#include <device.h>
+#include <entropy.h>
+#include <kernel.h>
+#include <string.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/ctr_prng.h>
+
+#define SEED_LEN (TC_AES_KEY_SIZE + TC_AES_BLOCK_SIZE)
+
+static TCCtrPrng_t ctx;
+static bool ctx_ready;
+static struct device *entropy_dev;
+
+static u32_t pool[CONFIG_CTR_DRBG_BUF_SIZE / sizeof(u32_t)];
+static u8_t pool_pos = ARRAY_SIZE(pool);
+
+static int ctr_drbg_reseed(void)
+{
+	u8_t seed[SEED_LEN];
+	int ret;
+
+	if (entropy_get_entropy(entropy_dev, seed, sizeof(seed)) < 0) {
+		return -EIO;
+	}
+
+	ret = tc_ctr_prng_reseed(&ctx, seed, sizeof(seed), NULL, 0);
+	memset(seed, 0, sizeof(seed));
+
+	return ret == TC_CRYPTO_SUCCESS ? 0 : -EIO;
+}
+
+static int ctr_drbg_initialize(struct device *dev)
+{
+	static const char personalization[] = "zephyr ctr-drbg";
+	u8_t seed[SEED_LEN];
+	int ret;
+
+	entropy_dev = device_get_binding(CONFIG_ENTROPY_NAME);
+	if (!entropy_dev) {
+		return -EINVAL;
+	}
+
+	if (entropy_get_entropy(entropy_dev, seed, sizeof(seed)) < 0) {
+		return -EINVAL;
+	}
+
+	ret = tc_ctr_prng_init(&ctx, seed, sizeof(seed),
+			       (const u8_t *)personalization,
+			       sizeof(personalization));
+	memset(seed, 0, sizeof(seed));
+
+	if (ret != TC_CRYPTO_SUCCESS) {
+		return -EINVAL;
+	}
+
+	ctx_ready = true;
+
+	return 0;
+}
+
+static void ctr_drbg_refill(void)
+{
+	int ret = TC_CRYPTO_FAIL;
+
+	if (ctx_ready) {
+		ret = tc_ctr_prng_generate(&ctx, NULL, 0, (u8_t *)pool,
+					   sizeof(pool));
+		if (ret == TC_CTR_PRNG_RESEED_REQ && !ctr_drbg_reseed()) {
+			ret = tc_ctr_prng_generate(&ctx, NULL, 0,
+						   (u8_t *)pool,
+						   sizeof(pool));
+		}
+	}
+
+	/* Without DRBG output, take the numbers from the entropy source
+	 * itself. Never hand out anything that is not random.
+	 */
+	if (ret != TC_CRYPTO_SUCCESS &&
+	    (!entropy_dev ||
+	     entropy_get_entropy(entropy_dev, (u8_t *)pool,
+				 sizeof(pool)) < 0)) {
+		k_panic();
+	}
+
+	pool_pos = 0;
+}
+
+u32_t sys_rand32_get(void)
+{
+	unsigned int key;
+	u32_t ret;
+
+	key = irq_lock();
+
+	if (pool_pos == ARRAY_SIZE(pool)) {
+		ctr_drbg_refill();
+	}
+
+	ret = pool[pool_pos];
+	/* Consumed output must not stay around */
+	pool[pool_pos++] = 0;
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+/* In-tree entropy drivers will initialize in PRE_KERNEL_1; ensure that they're
+ * initialized properly before initializing ourselves.
+ */
+SYS_INIT(ctr_drbg_initialize, PRE_KERNEL_2,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef __SETTINGS_NVS_H_
+#define __SETTINGS_NVS_H_
+
+#include <nvs/nvs.h>
+#include "settings/settings.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Each setting is stored in two NVS entries: the name at a name id and the
+ * value at name id + SETTINGS_NVS_NAME_ID_OFFSET. The entry at
+ * SETTINGS_NVS_NAMECNT_ID holds the highest name id in use, name ids are
+ * allocated upwards from it.
+ */
+#define SETTINGS_NVS_NAMECNT_ID		0x8000
+#define SETTINGS_NVS_NAME_ID_OFFSET	0x4000
+#define SETTINGS_NVS_MAX_NAME_ID	(SETTINGS_NVS_NAMECNT_ID + \
+					 SETTINGS_NVS_NAME_ID_OFFSET - 1)
+
+struct settings_nvs {
+	struct settings_store cf_store;
+	struct nvs_fs cf_nvs;
+	const char *cf_dev_name; /* flash device holding the NVS */
+	u16_t cf_last_name_id; /* private */
+};
+
+/* register NVS to be source of settings */
+extern int settings_nvs_src(struct settings_nvs *cf);
+
+/* settings saves go to NVS */
+extern int settings_nvs_dst(struct settings_nvs *cf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SETTINGS_NVS_H_ */
@@ -95,6 +95,51 @@ static void settings_init_fcb(void)
 	}
 }
 
+#elif defined(CONFIG_SETTINGS_NVS)
+#include <flash_map.h>
+#include "settings/settings_nvs.h"
+
+static struct settings_nvs config_init_settings_nvs = {
+	.cf_dev_name = FLASH_DEV_NAME,
+};
+
+static void settings_init_nvs(void)
+{
+	struct settings_nvs *cf = &config_init_settings_nvs;
+	struct flash_sector sector;
+	const struct flash_area *fap;
+	u32_t cnt = 1;
+	int rc;
+
+	rc = flash_area_open(CONFIG_SETTINGS_NVS_FLASH_AREA, &fap);
+	if (rc) {
+		k_panic();
+	}
+
+	/* NVS sectors all have the size of the first flash sector */
+	rc = flash_area_get_sectors(CONFIG_SETTINGS_NVS_FLASH_AREA, &cnt,
+				    &sector);
+	if (rc != 0 && rc != -ENOMEM) {
+		k_panic();
+	}
+
+	cf->cf_nvs.offset = fap->fa_off;
+	cf->cf_nvs.sector_size = sector.fs_size;
+	cf->cf_nvs.sector_count = min(CONFIG_SETTINGS_NVS_SECTOR_COUNT,
+				      fap->fa_size / sector.fs_size);
+	flash_area_close(fap);
+
+	rc = settings_nvs_src(cf);
+	if (rc != 0) {
+		k_panic();
+	}
+
+	rc = settings_nvs_dst(cf);
+	if (rc != 0) {
+		k_panic();
+	}
+}
+
 #endif
 
 int settings_subsys_init(void)
@@ -124,6 +169,9 @@ int settings_subsys_init(void)
 #elif defined(CONFIG_SETTINGS_FCB)
 	settings_init_fcb(); /* func rises kernel panic once error */
 	err = 0;
+#elif defined(CONFIG_SETTINGS_NVS)
+	settings_init_nvs(); /* func rises kernel panic once error */
+	err = 0;
 #endif
 
 	if (!err) {
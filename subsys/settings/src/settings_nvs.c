@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <stdbool.h>
+#include <nvs/nvs.h>
+
+#include "settings/settings.h"
+#include "settings/settings_nvs.h"
+#include "settings_priv.h"
+
+/* names and values are stored with their terminating '\0' */
+#define SETTINGS_NVS_NAME_BUF_LEN	(SETTINGS_MAX_NAME_LEN + \
+					 SETTINGS_EXTRA_LEN + 1)
+#define SETTINGS_NVS_VAL_BUF_LEN	(SETTINGS_MAX_VAL_LEN + 1)
+
+static int settings_nvs_load(struct settings_store *cs, load_cb cb,
+			     void *cb_arg);
+static int settings_nvs_read(struct settings_store *cs, const char *name,
+			     char *buf, int buf_len);
+static int settings_nvs_save(struct settings_store *cs, const char *name,
+			     const char *value);
+
+static struct settings_store_itf settings_nvs_itf = {
+	.csi_load = settings_nvs_load,
+	.csi_read = settings_nvs_read,
+	.csi_save = settings_nvs_save,
+};
+
+int settings_nvs_src(struct settings_nvs *cf)
+{
+	int rc;
+	u16_t last_name_id;
+
+	cf->cf_nvs.max_len = SETTINGS_NVS_VAL_BUF_LEN;
+	rc = nvs_init(&cf->cf_nvs, cf->cf_dev_name, CONFIG_SETTINGS_NVS_MAGIC);
+	if (rc) {
+		return -EINVAL;
+	}
+
+	rc = nvs_read(&cf->cf_nvs, SETTINGS_NVS_NAMECNT_ID, &last_name_id,
+		      sizeof(last_name_id));
+	if (rc < 0) {
+		/* nothing stored yet */
+		last_name_id = SETTINGS_NVS_NAMECNT_ID;
+	}
+	cf->cf_last_name_id = last_name_id;
+
+	cf->cf_store.cs_itf = &settings_nvs_itf;
+	settings_src_register(&cf->cf_store);
+
+	return 0;
+}
+
+int settings_nvs_dst(struct settings_nvs *cf)
+{
+	cf->cf_store.cs_itf = &settings_nvs_itf;
+	settings_dst_register(&cf->cf_store);
+
+	return 0;
+}
+
+/*
+ * Read a '\0' terminated string entry, returns its length or a negative
+ * value when the entry does not exist.
+ */
+static int settings_nvs_read_str(struct settings_nvs *cf, u16_t id, char *buf,
+				 int buf_len)
+{
+	int rc;
+
+	rc = nvs_read(&cf->cf_nvs, id, buf, buf_len - 1);
+	if (rc <= 0) {
+		return -ENOENT;
+	}
+	buf[min(rc, buf_len - 1)] = '\0';
+	return strlen(buf);
+}
+
+/*
+ * NVS already keeps only the latest value of every entry in view, so each
+ * setting is handed to the callback once, with no parsing of lines.
+ */
+static int settings_nvs_load(struct settings_store *cs, load_cb cb,
+			     void *cb_arg)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	char name[SETTINGS_NVS_NAME_BUF_LEN];
+	char val[SETTINGS_NVS_VAL_BUF_LEN];
+	u16_t name_id;
+	int rc;
+
+	for (name_id = SETTINGS_NVS_NAMECNT_ID + 1;
+	     name_id <= cf->cf_last_name_id; name_id++) {
+		rc = settings_nvs_read_str(cf, name_id, name, sizeof(name));
+		if (rc < 0) {
+			/* deleted setting */
+			continue;
+		}
+		rc = settings_nvs_read_str(cf, name_id +
+					   SETTINGS_NVS_NAME_ID_OFFSET,
+					   val, sizeof(val));
+		if (rc < 0) {
+			/* save of the setting was interrupted */
+			continue;
+		}
+		cb(name, val, cb_arg);
+	}
+	return 0;
+}
+
+/*
+ * Only the names are compared, the value of the matching name is the only
+ * one read.
+ */
+static int settings_nvs_read(struct settings_store *cs, const char *name,
+			     char *buf, int buf_len)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	char rdname[SETTINGS_NVS_NAME_BUF_LEN];
+	u16_t name_id;
+	int rc;
+
+	for (name_id = SETTINGS_NVS_NAMECNT_ID + 1;
+	     name_id <= cf->cf_last_name_id; name_id++) {
+		rc = settings_nvs_read_str(cf, name_id, rdname,
+					   sizeof(rdname));
+		if (rc < 0 || strcmp(name, rdname)) {
+			continue;
+		}
+		return settings_nvs_read_str(cf, name_id +
+					     SETTINGS_NVS_NAME_ID_OFFSET,
+					     buf, buf_len);
+	}
+	return -ENOENT;
+}
+
+static int settings_nvs_save(struct settings_store *cs, const char *name,
+			     const char *value)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	char rdname[SETTINGS_NVS_NAME_BUF_LEN];
+	u16_t name_id, write_name_id;
+	bool delete, write_name;
+	int rc;
+
+	if (!name) {
+		return -EINVAL;
+	}
+
+	delete = (!value || value[0] == '\0');
+
+	/* look for the name, remembering the first free name id */
+	write_name_id = 0;
+	write_name = true;
+	for (name_id = cf->cf_last_name_id;
+	     name_id > SETTINGS_NVS_NAMECNT_ID; name_id--) {
+		rc = nvs_read(&cf->cf_nvs, name_id, rdname,
+			      sizeof(rdname) - 1);
+		if (rc == -ENOENT) {
+			write_name_id = name_id;
+			continue;
+		}
+		if (rc <= 0) {
+			continue;
+		}
+		rdname[min(rc, sizeof(rdname) - 1)] = '\0';
+		if (strcmp(name, rdname)) {
+			continue;
+		}
+		if (delete) {
+			rc = nvs_delete(&cf->cf_nvs,
+					name_id + SETTINGS_NVS_NAME_ID_OFFSET);
+			if (rc && rc != -ENOENT) {
+				return rc;
+			}
+			return nvs_delete(&cf->cf_nvs, name_id);
+		}
+		write_name_id = name_id;
+		write_name = false;
+		break;
+	}
+
+	if (delete) {
+		/* not stored, nothing to delete */
+		return 0;
+	}
+
+	if (!write_name_id) {
+		if (cf->cf_last_name_id == SETTINGS_NVS_MAX_NAME_ID) {
+			return -ENOMEM;
+		}
+		write_name_id = cf->cf_last_name_id + 1;
+		/* the count goes first, a name id it covers without a name
+		 * is skipped on load
+		 */
+		rc = nvs_write(&cf->cf_nvs, SETTINGS_NVS_NAMECNT_ID,
+			       &write_name_id, sizeof(write_name_id));
+		if (rc < 0) {
+			return rc;
+		}
+		cf->cf_last_name_id = write_name_id;
+	}
+
+	/* the value goes before the name, a name is only found once its
+	 * value is in place
+	 */
+	rc = nvs_write(&cf->cf_nvs, write_name_id + SETTINGS_NVS_NAME_ID_OFFSET,
+		       value, strlen(value) + 1);
+	if (rc < 0) {
+		return rc;
+	}
+	if (write_name) {
+		rc = nvs_write(&cf->cf_nvs, write_name_id, name,
+			       strlen(name) + 1);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+	return 0;
+}
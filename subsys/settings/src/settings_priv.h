@@ -30,6 +30,11 @@ int settings_line_make2(char *dst, int dlen, const char *name,
 typedef void (*load_cb)(char *name, char *val, void *cb_arg);
 struct settings_store_itf {
 	int (*csi_load)(struct settings_store *cs, load_cb cb, void *cb_arg);
+	/* optional, stores which can find a single item without walking all
+	 * of their contents provide it, returns the value length or -ENOENT
+	 */
+	int (*csi_read)(struct settings_store *cs, const char *name, char *buf,
+			int buf_len);
 	int (*csi_save_start)(struct settings_store *cs);
 	int (*csi_save)(struct settings_store *cs, const char *name,
 			const char *value);
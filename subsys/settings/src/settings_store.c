@@ -7,6 +7,7 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdbool.h>
 
 #include <zephyr/types.h>
 #include <stddef.h>
@@ -23,6 +24,15 @@ struct settings_dup_check_arg {
 	int is_dup;
 };
 
+struct settings_read_arg {
+	const char *name;
+	char *buf;
+	int buf_len;
+	int rc;
+};
+
+#define SETTINGS_NAME_BUF_LEN (SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1)
+
 sys_slist_t  settings_load_srcs;
 struct settings_store *settings_save_dst;
 
@@ -68,6 +78,119 @@ int settings_load(void)
 	return settings_commit(NULL);
 }
 
+/*
+ * Check if name is subtree itself or one of the items below it.
+ */
+static bool settings_name_in_subtree(const char *name, const char *subtree)
+{
+	size_t len = strlen(subtree);
+
+	if (strncmp(name, subtree, len)) {
+		return false;
+	}
+	return name[len] == '\0' || name[len] == *SETTINGS_NAME_SEPARATOR;
+}
+
+static void settings_load_subtree_cb(char *name, char *val, void *cb_arg)
+{
+	if (settings_name_in_subtree(name, cb_arg)) {
+		settings_load_cb(name, val, NULL);
+	}
+}
+
+int settings_load_subtree(const char *subtree)
+{
+	struct settings_store *cs;
+	char name[SETTINGS_NAME_BUF_LEN];
+
+	if (strlen(subtree) >= sizeof(name)) {
+		return -EINVAL;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
+		cs->cs_itf->csi_load(cs, settings_load_subtree_cb,
+				     (void *)subtree);
+	}
+
+	/* settings_commit() splits the name it is given */
+	strcpy(name, subtree);
+	return settings_commit(name);
+}
+
+/*
+ * Fallback for stores without csi_read, the last record of the name wins
+ * the same way it does in settings_load().
+ */
+static void settings_read_cb(char *name, char *val, void *cb_arg)
+{
+	struct settings_read_arg *cra = (struct settings_read_arg *)cb_arg;
+	int len;
+
+	if (strcmp(name, cra->name)) {
+		return;
+	}
+	if (!val) {
+		cra->rc = -ENOENT;
+		return;
+	}
+	len = strlen(val);
+	if (len >= cra->buf_len) {
+		cra->rc = -EINVAL;
+		return;
+	}
+	strcpy(cra->buf, val);
+	cra->rc = len;
+}
+
+/*
+ * Find the stored value of a single item, later sources override earlier
+ * ones as they do on a full load.
+ */
+static int settings_read_stored(const char *name, char *buf, int buf_len)
+{
+	struct settings_store *cs;
+	struct settings_read_arg cra;
+	int rc = -ENOENT;
+	int rc2;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
+		if (cs->cs_itf->csi_read) {
+			rc2 = cs->cs_itf->csi_read(cs, name, buf, buf_len);
+		} else {
+			cra.name = name;
+			cra.buf = buf;
+			cra.buf_len = buf_len;
+			cra.rc = -ENOENT;
+			cs->cs_itf->csi_load(cs, settings_read_cb, &cra);
+			rc2 = cra.rc;
+		}
+		if (rc2 != -ENOENT) {
+			rc = rc2;
+		}
+	}
+	return rc;
+}
+
+int settings_load_one(const char *name)
+{
+	char name_buf[SETTINGS_NAME_BUF_LEN];
+	char val[SETTINGS_MAX_VAL_LEN + 1];
+	int rc;
+
+	if (strlen(name) >= sizeof(name_buf)) {
+		return -EINVAL;
+	}
+
+	rc = settings_read_stored(name, val, sizeof(val));
+	if (rc < 0) {
+		return rc;
+	}
+
+	/* settings_set_value() splits the name it is given */
+	strcpy(name_buf, name);
+	return settings_set_value(name_buf, val);
+}
+
 static void settings_dup_check_cb(char *name, char *val, void *cb_arg)
 {
 	struct settings_dup_check_arg *cdca = (struct settings_dup_check_arg *)
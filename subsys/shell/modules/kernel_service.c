@@ -75,13 +75,126 @@ static int shell_cmd_threads(int argc, char *argv[])
 				&& defined(CONFIG_THREAD_STACK_INFO)
 static void shell_stack_dump(const struct k_thread *thread, void *user_data)
 {
-	stack_analyze((char *)user_data, (char *)thread->stack_info.start,
-						thread->stack_info.size);
+	char name[16];
+
+	/* named by thread address, which scripts/stack_report.py maps */
+	snprintk(name, sizeof(name), "%p", thread);
+
+	stack_analyze(name, (char *)thread->stack_info.start,
+		      thread->stack_info.size);
+#if defined(CONFIG_THREAD_STACK_WATERMARK)
+	printk("    unused at context switches %u\n",
+	       (unsigned int)k_thread_stack_unused_get((k_tid_t)thread));
+#endif
 }
 
 static int shell_cmd_stack(int argc, char *argv[])
 {
-	k_thread_foreach(shell_stack_dump, "Shell");
+	k_thread_foreach(shell_stack_dump, NULL);
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+static void shell_runtime_dump(const struct k_thread *thread, void *user_data)
+{
+	struct k_thread_runtime_stats stats;
+	int i;
+
+	k_thread_runtime_stats_get((k_tid_t)thread, &stats);
+
+	printk("%s%p:   cycles: %llu switches: %u preempted: %u "
+	       "max ready latency: %u\n",
+		(thread == k_current_get()) ? "*" : " ",
+		thread,
+		stats.execution_cycles,
+		stats.switch_count,
+		stats.preempt_count,
+		stats.ready_latency_max);
+
+	printk("    ready latency histogram:");
+	for (i = 0; i < CONFIG_THREAD_RUNTIME_STATS_HIST_BUCKETS; i++) {
+		printk(" %u", stats.ready_latency_hist[i]);
+	}
+	printk("\n");
+}
+
+static int shell_cmd_runtime(int argc, char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	printk("Thread runtime statistics (hw cycles):\n");
+	k_thread_foreach(shell_runtime_dump, NULL);
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_MEM_POOL_STATS)
+static void shell_hist_dump(const char *name, const u32_t *hist)
+{
+	int i;
+
+	printk("    %s:", name);
+	for (i = 0; i < CONFIG_MEM_POOL_STATS_BUCKETS; i++) {
+		printk(" %u", hist[i]);
+	}
+	printk("\n");
+}
+
+static int shell_cmd_pools(int argc, char *argv[])
+{
+	extern struct k_mem_pool _k_mem_pool_list_start[];
+	extern struct k_mem_pool _k_mem_pool_list_end[];
+	struct k_mem_pool_stats stats;
+	struct k_mem_pool *pool;
+	int i;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	printk("Memory pool statistics (histograms from 16 bytes, x2):\n");
+
+	for (pool = _k_mem_pool_list_start; pool < _k_mem_pool_list_end;
+	     pool++) {
+		k_mem_pool_stats_get(pool, &stats);
+
+		printk("%p:   allocs: %u frees: %u failed: %u "
+		       "used: %u bytes/%u blocks max: %u bytes/%u blocks\n",
+		       pool, stats.alloc_count, stats.free_count,
+		       stats.failed_count, stats.used_bytes, stats.used_blocks,
+		       stats.max_used_bytes, stats.max_used_blocks);
+
+		shell_hist_dump("requests", stats.request_hist);
+		shell_hist_dump("used blocks", stats.used_hist);
+		shell_hist_dump("free blocks", stats.free_hist);
+
+		if (stats.failed_count) {
+			printk("    last failure: %u bytes from %p\n",
+			       stats.last_failed_size,
+			       stats.last_failed_caller);
+		}
+
+		for (i = 0; i < CONFIG_MEM_POOL_STATS_SAMPLES &&
+			    stats.samples[i].caller; i++) {
+			printk("    sample: %u bytes from %p\n",
+			       stats.samples[i].size, stats.samples[i].caller);
+		}
+	}
+
+	return 0;
+}
+#endif
+
+#if defined(CONFIG_BOOT_INIT_PROFILE)
+static int shell_cmd_initcalls(int argc, char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	device_init_profile_print();
+
 	return 0;
 }
 #endif
@@ -119,6 +232,15 @@ struct shell_cmd kernel_commands[] = {
 				&& defined(CONFIG_THREAD_STACK_INFO)
 	{ "stacks", shell_cmd_stack, "show system stacks" },
 #endif
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+	{ "runtime", shell_cmd_runtime, "show thread runtime statistics" },
+#endif
+#if defined(CONFIG_MEM_POOL_STATS)
+	{ "pools", shell_cmd_pools, "show memory pool statistics" },
+#endif
+#if defined(CONFIG_BOOT_INIT_PROFILE)
+	{ "initcalls", shell_cmd_initcalls, "show init function timings" },
+#endif
 #if defined(CONFIG_REBOOT)
 	{ "reboot", shell_cmd_reboot, "<warm cold>" },
 #endif
@@ -151,15 +151,25 @@ static size_t line2argv(char *str, char *argv[], size_t size)
 	return argc;
 }
 
+/* The linker sorts the modules by name */
 static struct shell_module *get_destination_module(const char *module_str)
 {
-	int i;
+	int lo = 0, hi = NUM_OF_SHELL_ENTITIES;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		int cmp = strncmp(module_str,
+				  __shell_module_start[mid].module_name,
+				  MODULE_NAME_MAX_LEN);
 
-	for (i = 0; i < NUM_OF_SHELL_ENTITIES; i++) {
-		if (!strncmp(module_str,
-			     __shell_module_start[i].module_name,
-			     MODULE_NAME_MAX_LEN)) {
-			return &__shell_module_start[i];
+		if (!cmp) {
+			return &__shell_module_start[mid];
+		}
+
+		if (cmp < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
 		}
 	}
 
@@ -211,13 +221,23 @@ static const struct shell_cmd *get_module_cmd(struct shell_module *module,
 	return get_cmd(module->commands, cmd_str);
 }
 
+/* The linker sorts the standalone commands by name */
 static const struct shell_cmd *get_standalone(const char *command)
 {
-	int i;
+	int lo = 0, hi = NUM_OF_SHELL_CMDS;
+
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		int cmp = strcmp(command, __shell_cmd_start[mid].cmd_name);
 
-	for (i = 0; i < NUM_OF_SHELL_CMDS; i++) {
-		if (!strcmp(command, __shell_cmd_start[i].cmd_name)) {
-			return &__shell_cmd_start[i];
+		if (!cmp) {
+			return &__shell_cmd_start[mid];
+		}
+
+		if (cmp < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
 		}
 	}
 
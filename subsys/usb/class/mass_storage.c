@@ -106,7 +106,9 @@ static struct k_thread mass_thread_data;
 static struct k_sem disk_wait_sem;
 static volatile u32_t defered_wr_sz;
 
-static u8_t page[BLOCK_SIZE];
+#define PAGE_SECTORS	CONFIG_MASS_STORAGE_DISK_BUF_SECTORS
+
+static u8_t page[BLOCK_SIZE * PAGE_SECTORS];
 
 /* Initialized during mass_storage_init() */
 static u32_t memory_size;
@@ -164,6 +166,10 @@ static u32_t addr;
 /*length of a reading or writing*/
 static u32_t length;
 
+/*disk addr of page[0] and number of sectors held by page*/
+static u32_t page_addr;
+static u32_t page_sectors;
+
 static u8_t max_lun_count;
 
 /*memory OK (after a memoryVerify)*/
@@ -181,6 +187,24 @@ static void msd_init(void)
 	memset(page, 0, sizeof(page));
 	addr = 0;
 	length = 0;
+	page_sectors = 0;
+}
+
+/*
+ * Number of sectors, starting at addr, that the disk transfers into or out
+ * of page at once: as many as are left in the current command, up to the
+ * size of page.
+ */
+static u32_t page_span(void)
+{
+	u32_t cnt = min(length, memory_size - addr) / BLOCK_SIZE;
+
+	return max(1, min(cnt, PAGE_SECTORS));
+}
+
+static bool page_holds(u32_t a)
+{
+	return a >= page_addr && a - page_addr < page_sectors * BLOCK_SIZE;
 }
 
 static void sendCSW(void)
@@ -356,7 +380,7 @@ static void thread_memory_read_done(void)
 	}
 
 	if (usb_write(mass_ep_data[MSD_IN_EP_IDX].ep_addr,
-		&page[addr % BLOCK_SIZE], n, NULL) != 0) {
+		&page[addr - page_addr], n, NULL) != 0) {
 		SYS_LOG_ERR("Failed to write EP 0x%x",
 			    mass_ep_data[MSD_IN_EP_IDX].ep_addr);
 	}
@@ -382,15 +406,15 @@ static void memoryRead(void)
 		stage = ERROR;
 	}
 
-	/* we read an entire block */
-	if (!(addr % BLOCK_SIZE)) {
+	/* we read entire blocks, as many as fit in page */
+	if (!(addr % BLOCK_SIZE) && !page_holds(addr)) {
 		thread_op = THREAD_OP_READ_QUEUED;
 		SYS_LOG_DBG("Signal thread for %d", (addr/BLOCK_SIZE));
 		k_sem_give(&disk_wait_sem);
 		return;
 	}
 	usb_write(mass_ep_data[MSD_IN_EP_IDX].ep_addr,
-		  &page[addr % BLOCK_SIZE], n, NULL);
+		  &page[addr - page_addr], n, NULL);
 	addr += n;
 	length -= n;
 
@@ -412,6 +436,7 @@ static bool infoTransfer(void)
 
 	SYS_LOG_DBG("LBA (block) : 0x%x ", n);
 	addr = n * BLOCK_SIZE;
+	page_sectors = 0;
 
 	/* Number of Blocks to transfer */
 	switch (cbw.CB[0]) {
@@ -620,13 +645,28 @@ static void memoryWrite(u8_t *buf, u16_t size)
 		SYS_LOG_WRN("Stall OUT endpoint");
 	}
 
-	/* we fill an array in RAM of 1 block before writing it in memory */
+	/* we fill an array in RAM of 1 or more blocks before writing it in
+	 * memory
+	 */
+	if (!page_sectors) {
+		page_addr = addr;
+		page_sectors = page_span();
+	}
+
+	/* never write past the page, whatever the host sends */
+	if (addr - page_addr + size > page_sectors * BLOCK_SIZE) {
+		size = page_addr + page_sectors * BLOCK_SIZE - addr;
+		stage = ERROR;
+		usb_ep_set_stall(mass_ep_data[MSD_OUT_EP_IDX].ep_addr);
+		SYS_LOG_WRN("Stall OUT endpoint");
+	}
+
 	for (int i = 0; i < size; i++) {
-		page[addr % BLOCK_SIZE + i] = buf[i];
+		page[addr - page_addr + i] = buf[i];
 	}
 
 	/* if the array is filled, write it in memory */
-	if (!((addr + size) % BLOCK_SIZE)) {
+	if (addr + size == page_addr + page_sectors * BLOCK_SIZE) {
 		if (!(disk_access_status(disk_pdrv) &
 					DISK_STATUS_WR_PROTECT)) {
 			SYS_LOG_DBG("Disk WRITE Qd %d", (addr/BLOCK_SIZE));
@@ -635,6 +675,10 @@ static void memoryWrite(u8_t *buf, u16_t size)
 			k_sem_give(&disk_wait_sem);
 			return;
 		}
+
+		/* the data is dropped, the next one starts a new page */
+		page_addr = addr + size;
+		page_sectors = 0;
 	}
 
 	addr += size;
@@ -847,8 +891,10 @@ static void mass_thread_main(int arg1, int unused)
 
 		switch (thread_op) {
 		case THREAD_OP_READ_QUEUED:
-			if (disk_access_read(disk_pdrv,
-						page, (addr/BLOCK_SIZE), 1)) {
+			page_addr = addr;
+			page_sectors = page_span();
+			if (disk_access_read(disk_pdrv, page,
+					     (addr/BLOCK_SIZE), page_sectors)) {
 				SYS_LOG_ERR("!! Disk Read Error %d !",
 					    addr/BLOCK_SIZE);
 			}
@@ -856,11 +902,14 @@ static void mass_thread_main(int arg1, int unused)
 			thread_memory_read_done();
 			break;
 		case THREAD_OP_WRITE_QUEUED:
-			if (disk_access_write(disk_pdrv,
-						page, (addr/BLOCK_SIZE), 1)) {
+			if (disk_access_write(disk_pdrv, page,
+					      (page_addr/BLOCK_SIZE),
+					      page_sectors)) {
 				SYS_LOG_ERR("!!!!! Disk Write Error %d !!!!!",
-					    addr/BLOCK_SIZE);
+					    page_addr/BLOCK_SIZE);
 			}
+			page_addr = addr + defered_wr_sz;
+			page_sectors = 0;
 			thread_memory_write_done();
 			break;
 		default:
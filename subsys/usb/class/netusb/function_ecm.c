@@ -53,7 +53,18 @@ static struct usb_ep_cfg_data ecm_ep_data[] = {
 	},
 };
 
-static u8_t tx_buf[NETUSB_MTU], rx_buf[NETUSB_MTU];
+#define ECM_FRAME_SIZE (NETUSB_MTU + sizeof(struct net_eth_hdr))
+
+/* Frames are copied to one buffer while the other one is sent */
+static u8_t tx_buf[2][ECM_FRAME_SIZE];
+static u8_t tx_buf_idx;
+static K_SEM_DEFINE(tx_sem, 2, 2);
+
+/* Frames are received straight into the fragments of the packet */
+static struct net_pkt *rx_pkt;
+static struct net_buf *rx_frag, *rx_prev;
+static size_t rx_len;
+static bool rx_enabled;
 
 static int ecm_class_handler(struct usb_setup_packet *setup, s32_t *len,
 			     u8_t **data)
@@ -110,9 +121,19 @@ static size_t ecm_eth_size(void *ecm_pkt, size_t len)
 	return sizeof(struct net_eth_hdr) + ip_len;
 }
 
+static void ecm_write_cb(u8_t ep, int size, void *priv)
+{
+	if (size != POINTER_TO_INT(priv)) {
+		SYS_LOG_ERR("Transfer failure");
+	}
+
+	k_sem_give(&tx_sem);
+}
+
 static int ecm_send(struct net_pkt *pkt)
 {
 	struct net_buf *frag;
+	u8_t *buf;
 	int b_idx = 0, ret;
 
 	net_hexdump_frags("<", pkt);
@@ -121,81 +142,163 @@ static int ecm_send(struct net_pkt *pkt)
 		return -ENODATA;
 	}
 
+	if (net_pkt_ll_reserve(pkt) + net_pkt_get_len(pkt) > ECM_FRAME_SIZE) {
+		return -EMSGSIZE;
+	}
+
+	/* the previous frame may still be in flight from the other buffer */
+	k_sem_take(&tx_sem, K_FOREVER);
+	buf = tx_buf[tx_buf_idx];
+	tx_buf_idx ^= 1;
+
 	/* copy header */
-	memcpy(&tx_buf[b_idx], net_pkt_ll(pkt), net_pkt_ll_reserve(pkt));
+	memcpy(&buf[b_idx], net_pkt_ll(pkt), net_pkt_ll_reserve(pkt));
 	b_idx += net_pkt_ll_reserve(pkt);
 
 	/* copy payload */
 	for (frag = pkt->frags; frag; frag = frag->frags) {
-		memcpy(&tx_buf[b_idx], frag->data, frag->len);
+		memcpy(&buf[b_idx], frag->data, frag->len);
 		b_idx += frag->len;
 	}
 
-	/* transfer data to host */
-	ret = usb_transfer_sync(ecm_ep_data[ECM_IN_EP_IDX].ep_addr,
-				tx_buf, b_idx, USB_TRANS_WRITE);
-	if (ret != b_idx) {
+	/* transfer data to host, completion is reported to ecm_write_cb */
+	ret = usb_transfer(ecm_ep_data[ECM_IN_EP_IDX].ep_addr, buf, b_idx,
+			   USB_TRANS_WRITE, ecm_write_cb, INT_TO_POINTER(b_idx));
+	if (ret) {
 		SYS_LOG_ERR("Transfer failure");
+		k_sem_give(&tx_sem);
 		return -EINVAL;
 	}
 
 	return 0;
 }
 
-static void ecm_read_cb(u8_t ep, int size, void *priv)
+static void ecm_read_cb(u8_t ep, int size, void *priv);
+
+/* Read the next part of the frame straight into a new fragment of rx_pkt */
+static int ecm_read_frag(void)
 {
-	struct net_pkt *pkt;
+	u8_t ep = ecm_ep_data[ECM_OUT_EP_IDX].ep_addr;
 	struct net_buf *frag;
 
-	if (size <= 0) {
-		goto done;
+	frag = net_pkt_get_frag(rx_pkt, K_FOREVER);
+	if (!frag) {
+		return -ENOMEM;
 	}
 
-	/* Linux considers by default that network usb device controllers are
-	 * not able to handle Zero Lenght Packet (ZLP) and then generates
-	 * a short packet containing a null byte. Handle by checking the IP
-	 * header length and dropping the extra byte.
+	/* A fragment must be filled by whole packets, a short packet ends
+	 * the frame.
 	 */
-	if (rx_buf[size - 1] == 0) { /* last byte is null */
-		if (ecm_eth_size(rx_buf, size) == (size - 1)) {
-			/* last byte has been appended as delimiter, drop it */
-			size--;
-		}
+	rx_len = net_buf_tailroom(frag);
+	rx_len -= rx_len % usb_dc_ep_mps(ep);
+	if (!rx_len) {
+		net_pkt_frag_unref(frag);
+		return -ENOMEM;
 	}
 
-	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
-	if (!pkt) {
+	rx_prev = rx_pkt->frags ? net_buf_frag_last(rx_pkt->frags) : NULL;
+	net_pkt_frag_add(rx_pkt, frag);
+	rx_frag = frag;
+
+	return usb_transfer(ep, frag->data, rx_len, USB_TRANS_READ,
+			    ecm_read_cb, NULL);
+}
+
+static void ecm_read_start(void)
+{
+	rx_pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+	if (!rx_pkt) {
 		SYS_LOG_ERR("no memory for network packet\n");
-		goto done;
+		return;
 	}
 
-	frag = net_pkt_get_frag(pkt, K_FOREVER);
-	if (!frag) {
+	if (ecm_read_frag()) {
 		SYS_LOG_ERR("no memory for network packet\n");
-		net_pkt_unref(pkt);
-		goto done;
+		net_pkt_unref(rx_pkt);
+		rx_pkt = NULL;
 	}
+}
 
-	net_pkt_frag_insert(pkt, frag);
+static void ecm_read_cb(u8_t ep, int size, void *priv)
+{
+	struct net_pkt *pkt = rx_pkt;
+	struct net_buf *last;
 
-	if (!net_pkt_append_all(pkt, size, rx_buf, K_FOREVER)) {
-		SYS_LOG_ERR("no memory for network packet\n");
-		net_pkt_unref(pkt);
-		goto done;
+	if (!pkt) {
+		return;
+	}
+
+	if (!rx_enabled) {
+		/* transfer cancelled on disconnection */
+		goto drop;
+	}
+
+	if (size > 0) {
+		net_buf_add(rx_frag, size);
+	}
+
+	if (size > 0 && size == (int)rx_len) {
+		/* fragment full, the frame may go on */
+		if (net_pkt_get_len(pkt) >= ECM_FRAME_SIZE) {
+			SYS_LOG_ERR("frame too long\n");
+			goto drop;
+		}
+
+		if (ecm_read_frag()) {
+			SYS_LOG_ERR("no memory for network packet\n");
+			goto drop;
+		}
+
+		return;
+	}
+
+	if (!rx_frag->len) {
+		/* ended by a zero length packet */
+		net_pkt_frag_del(pkt, rx_prev, rx_frag);
 	}
 
+	if (!pkt->frags) {
+		goto drop;
+	}
+
+	/* Linux considers by default that network usb device controllers are
+	 * not able to handle Zero Lenght Packet (ZLP) and then generates
+	 * a short packet containing a null byte. Handle by checking the IP
+	 * header length and dropping the extra byte.
+	 */
+	last = net_buf_frag_last(pkt->frags);
+	if (last->data[last->len - 1] == 0) { /* last byte is null */
+		if (ecm_eth_size(pkt->frags->data, pkt->frags->len) ==
+		    (net_pkt_get_len(pkt) - 1)) {
+			/* last byte has been appended as delimiter, drop it */
+			last->len--;
+		}
+	}
+
+	rx_pkt = NULL;
 	netusb_recv(pkt);
+	goto done;
+
+drop:
+	net_pkt_unref(pkt);
+	rx_pkt = NULL;
 
 done:
-	usb_transfer(ecm_ep_data[ECM_OUT_EP_IDX].ep_addr, rx_buf,
-		     sizeof(rx_buf), USB_TRANS_READ, ecm_read_cb, NULL);
+	if (rx_enabled) {
+		ecm_read_start();
+	}
 }
 
 static int ecm_connect(bool connected)
 {
 	if (connected) {
-		ecm_read_cb(ecm_ep_data[ECM_OUT_EP_IDX].ep_addr, 0, NULL);
+		rx_enabled = true;
+		if (!rx_pkt) {
+			ecm_read_start();
+		}
 	} else {
+		rx_enabled = false;
+
 		/* Cancel any transfer */
 		usb_cancel_transfer(ecm_ep_data[ECM_OUT_EP_IDX].ep_addr);
 		usb_cancel_transfer(ecm_ep_data[ECM_IN_EP_IDX].ep_addr);
@@ -59,6 +59,7 @@
 #include <errno.h>
 #include <stddef.h>
 #include <misc/util.h>
+#include <misc/slist.h>
 #include <misc/__assert.h>
 #include <init.h>
 #include <board.h>
@@ -97,7 +98,8 @@
 #define MAX_NUM_REQ_HANDLERS        (4)
 #define MAX_STD_REQ_MSG_SIZE        8
 
-#define MAX_NUM_TRANSFERS           4 /** Max number of parallel transfers */
+/** Max number of parallel transfers */
+#define MAX_NUM_TRANSFERS           CONFIG_USB_MAX_NUM_TRANSFERS
 
 /* Default USB control EP, always 0 and 0x80 */
 #define USB_CONTROL_OUT_EP0         0
@@ -108,6 +110,10 @@ extern struct usb_cfg_data __usb_data_start[];
 extern struct usb_cfg_data __usb_data_end[];
 
 struct usb_transfer_data {
+	/** Node in the queue of transfers waiting for their endpoint */
+	sys_snode_t node;
+	/** Transfer waits for an ongoing transfer of its endpoint */
+	bool queued;
 	/** endpoint associated to the transfer */
 	u8_t ep;
 	/** Transfer status */
@@ -159,6 +165,8 @@ static struct usb_dev_priv {
 	u8_t configuration;
 	/** Transfer list */
 	struct usb_transfer_data transfer[MAX_NUM_TRANSFERS];
+	/** Transfers waiting for their endpoint, in submission order */
+	sys_slist_t transfer_queue;
 } usb_dev;
 
 /*
@@ -1064,15 +1072,80 @@ int usb_ep_read_continue(u8_t ep)
 /* Transfer management */
 static struct usb_transfer_data *usb_ep_get_transfer(u8_t ep)
 {
+	struct usb_transfer_data *found = NULL;
 	int i;
 
 	for (i = 0; i < ARRAY_SIZE(usb_dev.transfer); i++) {
-		if (usb_dev.transfer[i].ep == ep) {
+		if (usb_dev.transfer[i].ep != ep) {
+			continue;
+		}
+
+		/* the ongoing transfer of the endpoint takes precedence */
+		if (usb_dev.transfer[i].status == -EBUSY &&
+		    !usb_dev.transfer[i].queued) {
 			return &usb_dev.transfer[i];
 		}
+
+		if (!found) {
+			found = &usb_dev.transfer[i];
+		}
+	}
+
+	return found;
+}
+
+static bool usb_ep_busy(u8_t ep)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(usb_dev.transfer); i++) {
+		if (usb_dev.transfer[i].ep == ep &&
+		    usb_dev.transfer[i].status == -EBUSY) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int usb_transfer_start(struct usb_transfer_data *trans)
+{
+	if (trans->flags & USB_TRANS_WRITE) {
+		/* start writing first chunk */
+		k_work_submit(&trans->work);
+		return 0;
+	}
+
+	/* ready to read, clear NAK */
+	return usb_dc_ep_read_continue(trans->ep);
+}
+
+/* Start the oldest transfer queued on ep, its previous one is complete */
+static void usb_transfer_start_next(u8_t ep)
+{
+	struct usb_transfer_data *trans;
+	sys_snode_t *prev = NULL;
+	int key;
+
+	key = irq_lock();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&usb_dev.transfer_queue, trans, node) {
+		if (trans->ep == ep) {
+			sys_slist_remove(&usb_dev.transfer_queue, prev,
+					 &trans->node);
+			trans->queued = false;
+
+			if (usb_transfer_start(trans)) {
+				trans->status = -EINVAL;
+				k_work_submit(&trans->work);
+			}
+			break;
+		}
+
+		prev = &trans->node;
 	}
 
-	return NULL;
+	irq_unlock(key);
 }
 
 static void usb_transfer_work(struct k_work *item)
@@ -1150,6 +1223,8 @@ done:
 		trans->cb = NULL;
 		k_sem_give(&trans->sem);
 
+		usb_transfer_start_next(ep);
+
 		/* Transfer completion callback */
 		cb(ep, tsize, priv);
 	}
@@ -1224,6 +1299,7 @@ int usb_transfer(u8_t ep, u8_t *data, size_t dlen, unsigned int flags,
 	}
 
 	/* Configure new transfer */
+	trans->queued = usb_ep_busy(ep);
 	trans->ep = ep;
 	trans->buffer = data;
 	trans->bsize = dlen;
@@ -1238,12 +1314,11 @@ int usb_transfer(u8_t ep, u8_t *data, size_t dlen, unsigned int flags,
 		trans->flags |= USB_TRANS_NO_ZLP;
 	}
 
-	if (flags & USB_TRANS_WRITE) {
-		/* start writing first chunk */
-		k_work_submit(&trans->work);
+	if (trans->queued) {
+		/* started once the ongoing transfers of ep are complete */
+		sys_slist_append(&usb_dev.transfer_queue, &trans->node);
 	} else {
-		/* ready to read, clear NAK */
-		ret = usb_dc_ep_read_continue(ep);
+		ret = usb_transfer_start(trans);
 	}
 
 done:
@@ -1253,11 +1328,26 @@ done:
 
 void usb_cancel_transfer(u8_t ep)
 {
-	struct usb_transfer_data *trans;
+	struct usb_transfer_data *trans, *tmp;
+	sys_snode_t *prev = NULL;
 	int key;
 
 	key = irq_lock();
 
+	/* transfers still waiting for the endpoint complete as cancelled */
+	SYS_SLIST_FOR_EACH_CONTAINER_SAFE(&usb_dev.transfer_queue, trans, tmp,
+					  node) {
+		if (trans->ep != ep) {
+			prev = &trans->node;
+			continue;
+		}
+
+		sys_slist_remove(&usb_dev.transfer_queue, prev, &trans->node);
+		trans->queued = false;
+		trans->status = -ECANCELED;
+		k_work_submit(&trans->work);
+	}
+
 	trans = usb_ep_get_transfer(ep);
 	if (!trans) {
 		goto done;
@@ -29,6 +29,9 @@
 #include <usb/usb_device.h>
 #include <watchdog.h>
 
+#include <cpp/kernel.h>
+#include <cpp/net_buf.h>
+
 #include <ztest.h>
 
 struct foo {
@@ -49,6 +52,27 @@ static int test_init(struct device *dev)
 
 SYS_INIT(test_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
 
+/* Check that the C++ wrappers of kernel objects compile. */
+ZEPHYR_MUTEX_DEFINE(foo_mutex);
+ZEPHYR_MSGQ_DEFINE(foo_msgq, struct foo, 4);
+ZEPHYR_MEM_SLAB_DEFINE(foo_slab, struct foo, 4);
+
+void test_wrappers(struct net_buf_pool *pool)
+{
+	zephyr::lock_guard<zephyr::mutex> guard(foo_mutex);
+	struct foo *f = foo_slab.alloc();
+	zephyr::net_buf_ptr buf = zephyr::net_buf_ptr::alloc(pool);
+
+	if (f) {
+		foo_msgq.put(*f);
+		foo_slab.free(f);
+	}
+
+	if (buf) {
+		buf.add(1);
+	}
+}
+
 void test_main(void)
 {
 	/* Does nothing.  This is a compile only test. */
@@ -0,0 +1,401 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Central side of the Bluetooth throughput benchmark: connects to
+ * CONFIG_BENCH_CONNECTIONS peripherals running the peripheral side, then
+ * measures in turn, over all the connections at once:
+ *
+ *   write:  GATT writes without response to the peripherals
+ *   notify: GATT notifications from the peripherals
+ *   l2cap:  data sent over L2CAP connection oriented channels
+ *
+ * Each measurement prints a line meant for tools comparing runs:
+ *
+ *   BENCH <test> <connections> <MTU> <interval in us> <bytes/s>
+ *         <PDUs per connection event, x100> <CPU load in %>
+ *
+ * The PDUs are counted at the GATT or L2CAP level, their number per
+ * connection event is an average over the connections.
+ */
+
+#include <zephyr.h>
+#include <string.h>
+#include <misc/printk.h>
+
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/hci.h>
+#include <bluetooth/conn.h>
+#include <bluetooth/gatt.h>
+#include <bluetooth/l2cap.h>
+
+#include "bench_bt.h"
+
+#define CONNECTIONS	CONFIG_BENCH_CONNECTIONS
+#define DURATION_MS	(CONFIG_BENCH_DURATION * MSEC_PER_SEC)
+
+struct peer {
+	struct bt_conn *conn;
+	u16_t write_handle;
+	u16_t notify_handle;
+	struct bt_gatt_subscribe_params subscribe;
+	struct bt_l2cap_le_chan chan;
+};
+
+static struct peer peers[CONNECTIONS];
+static int peer_count;
+
+static K_SEM_DEFINE(step_sem, 0, 1);
+static int step_err;
+
+static u32_t rx_bytes;
+static u32_t rx_pdus;
+static u8_t data[BENCH_DATA_MAX];
+
+NET_BUF_POOL_DEFINE(l2cap_tx_pool, CONNECTIONS * 2,
+		    BT_L2CAP_CHAN_SEND_RESERVE + BENCH_DATA_MAX,
+		    BT_BUF_USER_DATA_MIN, NULL);
+
+static void step_done(int err)
+{
+	step_err = err;
+	k_sem_give(&step_sem);
+}
+
+static int step_wait(void)
+{
+	if (k_sem_take(&step_sem, K_SECONDS(10))) {
+		return -ETIMEDOUT;
+	}
+
+	return step_err;
+}
+
+/* Look for the benchmark service in the advertising data */
+static bool has_bench_uuid(struct net_buf_simple *ad)
+{
+	static const u8_t uuid[] = { BENCH_UUID_BYTES(0) };
+	u8_t len, type;
+
+	while (ad->len > 1) {
+		len = net_buf_simple_pull_u8(ad);
+		if (!len || len > ad->len) {
+			return false;
+		}
+
+		type = ad->data[0];
+		if ((type == BT_DATA_UUID128_ALL ||
+		     type == BT_DATA_UUID128_SOME) && len == sizeof(uuid) + 1 &&
+		    !memcmp(&ad->data[1], uuid, sizeof(uuid))) {
+			return true;
+		}
+
+		net_buf_simple_pull(ad, len);
+	}
+
+	return false;
+}
+
+static void device_found(const bt_addr_le_t *addr, s8_t rssi, u8_t type,
+			 struct net_buf_simple *ad)
+{
+	if (type != BT_LE_ADV_IND || !has_bench_uuid(ad)) {
+		return;
+	}
+
+	if (bt_le_scan_stop()) {
+		return;
+	}
+
+	peers[peer_count].conn = bt_conn_create_le(addr,
+						   BT_LE_CONN_PARAM_DEFAULT);
+	if (!peers[peer_count].conn) {
+		step_done(-EIO);
+	}
+}
+
+static void connected(struct bt_conn *conn, u8_t err)
+{
+	if (conn != peers[peer_count].conn) {
+		return;
+	}
+
+	if (err) {
+		bt_conn_unref(conn);
+		peers[peer_count].conn = NULL;
+	}
+
+	step_done(err ? -EIO : 0);
+}
+
+static void disconnected(struct bt_conn *conn, u8_t reason)
+{
+	printk("Disconnected (reason %u)\n", reason);
+}
+
+static struct bt_conn_cb conn_callbacks = {
+	.connected = connected,
+	.disconnected = disconnected,
+};
+
+static void mtu_exchanged(struct bt_conn *conn, u8_t err,
+			  struct bt_gatt_exchange_params *params)
+{
+	step_done(err ? -EIO : 0);
+}
+
+static struct bt_gatt_exchange_params exchange_params = {
+	.func = mtu_exchanged,
+};
+
+static struct bt_gatt_discover_params discover_params;
+
+static u8_t discovered(struct bt_conn *conn, const struct bt_gatt_attr *attr,
+		       struct bt_gatt_discover_params *params)
+{
+	struct peer *peer = &peers[peer_count];
+	struct bt_gatt_chrc *chrc;
+
+	if (!attr) {
+		step_done((peer->write_handle && peer->notify_handle) ?
+			  0 : -ENOENT);
+		return BT_GATT_ITER_STOP;
+	}
+
+	chrc = attr->user_data;
+
+	if (!bt_uuid_cmp(chrc->uuid, BENCH_UUID_WRITE)) {
+		peer->write_handle = attr->handle + 1;
+	} else if (!bt_uuid_cmp(chrc->uuid, BENCH_UUID_NOTIFY)) {
+		peer->notify_handle = attr->handle + 1;
+	}
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static u8_t notified(struct bt_conn *conn,
+		     struct bt_gatt_subscribe_params *params,
+		     const void *buf, u16_t len)
+{
+	if (buf) {
+		rx_bytes += len;
+		rx_pdus++;
+	}
+
+	return BT_GATT_ITER_CONTINUE;
+}
+
+static void l2cap_connected(struct bt_l2cap_chan *chan)
+{
+	step_done(0);
+}
+
+static void l2cap_disconnected(struct bt_l2cap_chan *chan)
+{
+	/* reported if the connection is still pending */
+	step_done(-ECONNREFUSED);
+}
+
+static struct bt_l2cap_chan_ops l2cap_ops = {
+	.connected	= l2cap_connected,
+	.disconnected	= l2cap_disconnected,
+};
+
+/* Connect to the next peripheral and set it up */
+static int peer_add(void)
+{
+	struct peer *peer = &peers[peer_count];
+	int err;
+
+	err = bt_le_scan_start(BT_LE_SCAN_PASSIVE, device_found);
+	if (err) {
+		return err;
+	}
+
+	err = step_wait();
+	if (err) {
+		return err;
+	}
+
+	err = bt_gatt_exchange_mtu(peer->conn, &exchange_params);
+	if (!err) {
+		err = step_wait();
+	}
+
+	if (err) {
+		return err;
+	}
+
+	discover_params.uuid = NULL;
+	discover_params.func = discovered;
+	discover_params.start_handle = 0x0001;
+	discover_params.end_handle = 0xffff;
+	discover_params.type = BT_GATT_DISCOVER_CHARACTERISTIC;
+
+	err = bt_gatt_discover(peer->conn, &discover_params);
+	if (!err) {
+		err = step_wait();
+	}
+
+	if (err) {
+		return err;
+	}
+
+	peer->chan.chan.ops = &l2cap_ops;
+	peer->chan.rx.mtu = BENCH_DATA_MAX;
+
+	err = bt_l2cap_chan_connect(peer->conn, &peer->chan.chan, BENCH_PSM);
+	if (!err) {
+		err = step_wait();
+	}
+
+	if (err) {
+		return err;
+	}
+
+	peer_count++;
+
+	return 0;
+}
+
+static u32_t write_pdu(struct peer *peer)
+{
+	u16_t len = min(BENCH_DATA_MAX, bt_gatt_get_mtu(peer->conn) - 3);
+
+	if (bt_gatt_write_without_response(peer->conn, peer->write_handle,
+					   data, len, false)) {
+		return 0;
+	}
+
+	return len;
+}
+
+static u32_t l2cap_pdu(struct peer *peer)
+{
+	u16_t len = min(BENCH_DATA_MAX, peer->chan.tx.mtu);
+	struct net_buf *buf;
+
+	buf = net_buf_alloc(&l2cap_tx_pool, K_NO_WAIT);
+	if (!buf) {
+		return 0;
+	}
+
+	net_buf_reserve(buf, BT_L2CAP_CHAN_SEND_RESERVE);
+	net_buf_add_mem(buf, data, len);
+
+	if (bt_l2cap_chan_send(&peer->chan.chan, buf) < 0) {
+		net_buf_unref(buf);
+		return 0;
+	}
+
+	return len;
+}
+
+static void report(const char *test, u32_t bytes, u32_t pdus, int load)
+{
+	struct bt_conn_info info;
+	u32_t interval_us, events;
+
+	bt_conn_get_info(peers[0].conn, &info);
+	interval_us = info.le.interval * 1250;
+	events = (u64_t)DURATION_MS * USEC_PER_MSEC * peer_count /
+		 interval_us;
+
+	printk("%s: %u bytes/s over %d connections, load %d %%\n", test,
+	       bytes / CONFIG_BENCH_DURATION, peer_count, load);
+	printk("BENCH %s %d %u %u %u %u %d\n", test, peer_count,
+	       bt_gatt_get_mtu(peers[0].conn), interval_us,
+	       bytes / CONFIG_BENCH_DURATION,
+	       events ? (u32_t)((u64_t)pdus * 100 / events) : 0, load);
+}
+
+/* Send with fn to all the peers in turn for the test duration */
+static void measure_tx(const char *test, u32_t (*fn)(struct peer *peer))
+{
+	s64_t end = k_uptime_get() + DURATION_MS;
+	u32_t bytes = 0, pdus = 0, len;
+	bool sent;
+	int i;
+
+	bench_cpu_load_start();
+
+	while (k_uptime_get() < end) {
+		sent = false;
+
+		for (i = 0; i < peer_count; i++) {
+			len = fn(&peers[i]);
+			if (len) {
+				bytes += len;
+				pdus++;
+				sent = true;
+			}
+		}
+
+		/* out of buffers, let them drain */
+		if (!sent) {
+			k_sleep(1);
+		}
+	}
+
+	report(test, bytes, pdus, bench_cpu_load_get());
+}
+
+static void measure_notify(void)
+{
+	struct peer *peer;
+	int i;
+
+	for (i = 0; i < peer_count; i++) {
+		peer = &peers[i];
+		peer->subscribe.notify = notified;
+		peer->subscribe.value = BT_GATT_CCC_NOTIFY;
+		peer->subscribe.value_handle = peer->notify_handle;
+		peer->subscribe.ccc_handle = peer->notify_handle + 1;
+		bt_gatt_subscribe(peer->conn, &peer->subscribe);
+	}
+
+	rx_bytes = 0;
+	rx_pdus = 0;
+	bench_cpu_load_start();
+
+	k_sleep(DURATION_MS);
+
+	report("notify", rx_bytes, rx_pdus, bench_cpu_load_get());
+
+	for (i = 0; i < peer_count; i++) {
+		bt_gatt_unsubscribe(peers[i].conn, &peers[i].subscribe);
+	}
+}
+
+void main(void)
+{
+	int err;
+
+	err = bt_enable(NULL);
+	if (err) {
+		printk("Bluetooth init failed (err %d)\n", err);
+		return;
+	}
+
+	bt_conn_cb_register(&conn_callbacks);
+
+	while (peer_count < CONNECTIONS) {
+		err = peer_add();
+		if (err) {
+			printk("Peripheral %d setup failed (err %d)\n",
+			       peer_count, err);
+			return;
+		}
+
+		printk("Peripheral %d ready\n", peer_count);
+	}
+
+	measure_tx("write", write_pdu);
+	measure_notify();
+	measure_tx("l2cap", l2cap_pdu);
+
+	printk("Bluetooth throughput benchmark done\n");
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Definitions shared by the central and peripheral sides of the Bluetooth
+ * throughput benchmark.
+ */
+
+#ifndef __BENCH_BT_H
+#define __BENCH_BT_H
+
+#include <bluetooth/uuid.h>
+
+/* 12345678-1234-5678-1234-56789abcdef0 and following */
+#define BENCH_UUID_BYTES(n)						\
+	(0xf0 + (n)), 0xde, 0xbc, 0x9a, 0x78, 0x56, 0x34, 0x12,	\
+	0x78, 0x56, 0x34, 0x12, 0x78, 0x56, 0x34, 0x12
+
+/* service, characteristic written without response, notified one */
+#define BENCH_UUID_SVC		BT_UUID_DECLARE_128(BENCH_UUID_BYTES(0))
+#define BENCH_UUID_WRITE	BT_UUID_DECLARE_128(BENCH_UUID_BYTES(1))
+#define BENCH_UUID_NOTIFY	BT_UUID_DECLARE_128(BENCH_UUID_BYTES(2))
+
+/* L2CAP connection oriented channel */
+#define BENCH_PSM		0x0080
+
+/* largest payload sent at once */
+#define BENCH_DATA_MAX		512
+
+/**
+ * @brief Start measuring the CPU load
+ *
+ * The load is computed from the time spent by the idle threads, it needs
+ * CONFIG_THREAD_RUNTIME_STATS and CONFIG_THREAD_MONITOR.
+ */
+void bench_cpu_load_start(void);
+
+/**
+ * @brief Get the CPU load since bench_cpu_load_start()
+ *
+ * @return Load in percent, -1 if it is not measured
+ */
+int bench_cpu_load_get(void);
+
+#endif /* __BENCH_BT_H */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr.h>
+
+#include "bench_bt.h"
+
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+static u32_t start_time;
+static u64_t start_idle;
+
+static void idle_cycles_cb(const struct k_thread *thread, void *user_data)
+{
+	struct k_thread_runtime_stats stats;
+	k_tid_t tid = (k_tid_t)thread;
+
+	if (k_thread_priority_get(tid) != K_IDLE_PRIO) {
+		return;
+	}
+
+	if (!k_thread_runtime_stats_get(tid, &stats)) {
+		*(u64_t *)user_data += stats.execution_cycles;
+	}
+}
+
+static u64_t idle_cycles(void)
+{
+	u64_t cycles = 0;
+
+	k_thread_foreach(idle_cycles_cb, &cycles);
+
+	return cycles;
+}
+
+void bench_cpu_load_start(void)
+{
+	start_idle = idle_cycles();
+	start_time = k_cycle_get_32();
+}
+
+int bench_cpu_load_get(void)
+{
+	u64_t elapsed = (u64_t)(k_cycle_get_32() - start_time) *
+			CONFIG_MP_NUM_CPUS;
+	u64_t idle = idle_cycles() - start_idle;
+
+	if (!elapsed) {
+		return -1;
+	}
+
+	return 100 - min(idle, elapsed) * 100 / elapsed;
+}
+#else
+void bench_cpu_load_start(void)
+{
+}
+
+int bench_cpu_load_get(void)
+{
+	return -1;
+}
+#endif
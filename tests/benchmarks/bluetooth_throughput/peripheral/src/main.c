@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Peripheral side of the Bluetooth throughput benchmark: accepts
+ * connections from the central, counts the data it writes without
+ * response or sends over the L2CAP channel, and notifies as fast as
+ * possible while it is subscribed.
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+
+#include <bluetooth/bluetooth.h>
+#include <bluetooth/hci.h>
+#include <bluetooth/conn.h>
+#include <bluetooth/gatt.h>
+#include <bluetooth/l2cap.h>
+
+#include "bench_bt.h"
+
+#define DEVICE_NAME		CONFIG_BT_DEVICE_NAME
+#define DEVICE_NAME_LEN		(sizeof(DEVICE_NAME) - 1)
+
+static struct bt_conn *conns[CONFIG_BT_MAX_CONN];
+static u32_t rx_bytes;
+static u8_t data[BENCH_DATA_MAX];
+static bool notifying;
+
+static ssize_t write_data(struct bt_conn *conn,
+			  const struct bt_gatt_attr *attr, const void *buf,
+			  u16_t len, u16_t offset, u8_t flags)
+{
+	rx_bytes += len;
+
+	return len;
+}
+
+static struct bt_gatt_ccc_cfg notify_ccc_cfg[BT_GATT_CCC_MAX] = {};
+
+static void notify_ccc_cfg_changed(const struct bt_gatt_attr *attr,
+				   u16_t value)
+{
+	notifying = (value == BT_GATT_CCC_NOTIFY);
+}
+
+static struct bt_gatt_attr bench_attrs[] = {
+	BT_GATT_PRIMARY_SERVICE(BENCH_UUID_SVC),
+	BT_GATT_CHARACTERISTIC(BENCH_UUID_WRITE,
+			       BT_GATT_CHRC_WRITE_WITHOUT_RESP,
+			       BT_GATT_PERM_WRITE, NULL, write_data, NULL),
+	BT_GATT_CHARACTERISTIC(BENCH_UUID_NOTIFY, BT_GATT_CHRC_NOTIFY,
+			       BT_GATT_PERM_NONE, NULL, NULL, NULL),
+	BT_GATT_CCC(notify_ccc_cfg, notify_ccc_cfg_changed),
+};
+
+/* value attribute of the notified characteristic */
+#define NOTIFY_ATTR (&bench_attrs[4])
+
+static struct bt_gatt_service bench_svc = BT_GATT_SERVICE(bench_attrs);
+
+static const struct bt_data ad[] = {
+	BT_DATA_BYTES(BT_DATA_FLAGS, (BT_LE_AD_GENERAL | BT_LE_AD_NO_BREDR)),
+	BT_DATA_BYTES(BT_DATA_UUID128_ALL, BENCH_UUID_BYTES(0)),
+};
+
+static const struct bt_data sd[] = {
+	BT_DATA(BT_DATA_NAME_COMPLETE, DEVICE_NAME, DEVICE_NAME_LEN),
+};
+
+NET_BUF_POOL_DEFINE(l2cap_rx_pool, CONFIG_BT_MAX_CONN, BENCH_DATA_MAX,
+		    BT_BUF_USER_DATA_MIN, NULL);
+
+static struct bt_l2cap_le_chan l2cap_chans[CONFIG_BT_MAX_CONN];
+
+static void l2cap_recv(struct bt_l2cap_chan *chan, struct net_buf *buf)
+{
+	rx_bytes += buf->len;
+}
+
+static struct net_buf *l2cap_alloc_buf(struct bt_l2cap_chan *chan)
+{
+	return net_buf_alloc(&l2cap_rx_pool, K_FOREVER);
+}
+
+static struct bt_l2cap_chan_ops l2cap_ops = {
+	.alloc_buf	= l2cap_alloc_buf,
+	.recv		= l2cap_recv,
+};
+
+static int l2cap_accept(struct bt_conn *conn, struct bt_l2cap_chan **chan)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(l2cap_chans); i++) {
+		if (!l2cap_chans[i].chan.conn) {
+			l2cap_chans[i].chan.ops = &l2cap_ops;
+			l2cap_chans[i].rx.mtu = BENCH_DATA_MAX;
+			*chan = &l2cap_chans[i].chan;
+			return 0;
+		}
+	}
+
+	return -ENOMEM;
+}
+
+static struct bt_l2cap_server l2cap_server = {
+	.psm		= BENCH_PSM,
+	.accept		= l2cap_accept,
+};
+
+static void advertise(void)
+{
+	int err;
+
+	err = bt_le_adv_start(BT_LE_ADV_CONN, ad, ARRAY_SIZE(ad),
+			      sd, ARRAY_SIZE(sd));
+	if (err) {
+		printk("Advertising failed to start (err %d)\n", err);
+	}
+}
+
+static void connected(struct bt_conn *conn, u8_t err)
+{
+	int i;
+
+	if (err) {
+		printk("Connection failed (err %u)\n", err);
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(conns); i++) {
+		if (!conns[i]) {
+			conns[i] = bt_conn_ref(conn);
+			break;
+		}
+	}
+
+	printk("Connected\n");
+
+	/* accept more connections as long as possible */
+	if (i < ARRAY_SIZE(conns) - 1) {
+		advertise();
+	}
+}
+
+static void disconnected(struct bt_conn *conn, u8_t reason)
+{
+	int i;
+
+	printk("Disconnected (reason %u)\n", reason);
+
+	for (i = 0; i < ARRAY_SIZE(conns); i++) {
+		if (conns[i] == conn) {
+			bt_conn_unref(conns[i]);
+			conns[i] = NULL;
+		}
+	}
+
+	advertise();
+}
+
+static struct bt_conn_cb conn_callbacks = {
+	.connected = connected,
+	.disconnected = disconnected,
+};
+
+/* Notify all the subscribed centrals with the largest payload allowed */
+static void notify(void)
+{
+	u16_t len = BENCH_DATA_MAX;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(conns); i++) {
+		if (conns[i]) {
+			len = min(len, bt_gatt_get_mtu(conns[i]) - 3);
+		}
+	}
+
+	if (bt_gatt_notify(NULL, NOTIFY_ATTR, data, len)) {
+		/* out of buffers, let them drain */
+		k_sleep(1);
+	}
+}
+
+void main(void)
+{
+	s64_t report = k_uptime_get() + MSEC_PER_SEC;
+	int err;
+
+	err = bt_enable(NULL);
+	if (err) {
+		printk("Bluetooth init failed (err %d)\n", err);
+		return;
+	}
+
+	bt_conn_cb_register(&conn_callbacks);
+	bt_gatt_service_register(&bench_svc);
+
+	err = bt_l2cap_server_register(&l2cap_server);
+	if (err) {
+		printk("L2CAP server registration failed (err %d)\n", err);
+		return;
+	}
+
+	advertise();
+
+	printk("Bluetooth throughput peripheral started\n");
+
+	bench_cpu_load_start();
+
+	while (1) {
+		if (notifying) {
+			notify();
+		} else {
+			k_sleep(10);
+		}
+
+		if (k_uptime_get() < report) {
+			continue;
+		}
+
+		report += MSEC_PER_SEC;
+
+		if (rx_bytes) {
+			printk("received %u bytes/s, CPU load %d %%\n",
+			       rx_bytes, bench_cpu_load_get());
+			rx_bytes = 0;
+		}
+
+		bench_cpu_load_start();
+	}
+}
@@ -14,9 +14,12 @@
  *  2. From __start to main()
  *  3. From __start to task
  *  4. From __start to idle
+ *  5. From __start to the end of the slow device initializations, with
+ *     CONFIG_BOOT_TIME_SLOW_DEVICES
  */
 
 #include <zephyr.h>
+#include <device.h>
 
 #include <tc_util.h>
 
@@ -25,6 +28,25 @@ extern u64_t __start_time_stamp;    /* timestamp when kernel begins executing */
 extern u64_t __main_time_stamp;     /* timestamp when main() begins executing */
 extern u64_t __idle_time_stamp;     /* timestamp when CPU went idle */
 
+#ifdef CONFIG_BOOT_TIME_SLOW_DEVICES
+/* Stands for a PHY auto negotiation, a modem power up... */
+static int slow_init_finish(struct device *dev)
+{
+	k_sleep(CONFIG_BOOT_TIME_SLOW_INIT_MS);
+	return 0;
+}
+
+static int slow_init(struct device *dev)
+{
+	device_init_defer(dev, slow_init_finish);
+	return 0;
+}
+
+DEVICE_INIT(slow_0, "SLOW_0", slow_init, NULL, NULL, POST_KERNEL, 0);
+DEVICE_INIT(slow_1, "SLOW_1", slow_init, NULL, NULL, POST_KERNEL, 0);
+DEVICE_INIT(slow_2, "SLOW_2", slow_init, NULL, NULL, POST_KERNEL, 0);
+#endif
+
 void main(void)
 {
 	u64_t task_time_stamp;      /* timestamp at beginning of first task  */
@@ -38,6 +60,15 @@ void main(void)
 
 	task_time_stamp = (u64_t)k_cycle_get_32();
 
+#ifdef CONFIG_BOOT_TIME_SLOW_DEVICES
+	u64_t ready_time_stamp;     /* timestamp when slow devices are ready */
+
+	device_init_wait(DEVICE_GET(slow_0), K_FOREVER);
+	device_init_wait(DEVICE_GET(slow_1), K_FOREVER);
+	device_init_wait(DEVICE_GET(slow_2), K_FOREVER);
+	ready_time_stamp = (u64_t)k_cycle_get_32() - __start_time_stamp;
+#endif
+
 	/*
 	 * Go to sleep for 1 tick in order to timestamp when idle thread halts.
 	 */
@@ -71,6 +102,11 @@ void main(void)
 	TC_PRINT("_start->idle  : %u cycles, %u us\n",
 		 (u32_t)(s_idle_time_stamp & 0xFFFFFFFFULL),
 		 (u32_t)  (idle_us  & 0xFFFFFFFFULL));
+#ifdef CONFIG_BOOT_TIME_SLOW_DEVICES
+	TC_PRINT("_start->ready : %u cycles, %u us\n",
+		 (u32_t)(ready_time_stamp & 0xFFFFFFFFULL),
+		 (u32_t)((ready_time_stamp / freq) & 0xFFFFFFFFULL));
+#endif
 
 	TC_PRINT("Boot Time Measurement finished\n");
 
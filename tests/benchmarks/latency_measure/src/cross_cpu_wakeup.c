@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file measure the latency of waking up a thread on another CPU
+ *
+ * The test thread turns cooperative, so that the threads it wakes up
+ * cannot run on its own CPU, and measures the round trip from giving
+ * a semaphore to the waiter, running on the other (idle) CPU, having
+ * taken it.  Both timestamps are taken on the same CPU, as the cycle
+ * counters of the CPUs are not synchronized.
+ *
+ * Without an inter-processor interrupt, the idle CPU only notices the
+ * ready thread at its next timer interrupt.
+ */
+
+#include <zephyr.h>
+
+#include "timestamp.h"
+#include "utils.h"
+
+#if defined(CONFIG_SMP) && CONFIG_MP_NUM_CPUS > 1
+
+#define STACK_SIZE 1024
+
+/* preemptible, only the other CPU can run it */
+#define WAITER_PRIORITY 5
+
+static u32_t samples[BENCH_SAMPLES];
+static volatile bool waiter_started;
+/* number of wakeups seen by the waiter */
+static volatile int woken;
+
+K_SEM_DEFINE(wake_sem, 0, 1);
+K_THREAD_STACK_DEFINE(wake_waiter_stack, STACK_SIZE);
+static struct k_thread wake_waiter_thread;
+
+static void wake_waiter(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	waiter_started = true;
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		k_sem_take(&wake_sem, K_FOREVER);
+		woken = i + 1;
+	}
+}
+
+void cross_cpu_wakeup(void)
+{
+	int prio = k_thread_priority_get(k_current_get());
+	u32_t start;
+	int i;
+
+	PRINT_FORMAT(" 10 - Measure wakeup latency of a thread on another CPU");
+
+	k_thread_priority_set(k_current_get(), K_PRIO_COOP(1));
+
+	k_thread_create(&wake_waiter_thread, wake_waiter_stack, STACK_SIZE,
+			wake_waiter, NULL, NULL, NULL, WAITER_PRIORITY, 0,
+			K_NO_WAIT);
+
+	/* never give up this CPU, so the waiter starts on the other one */
+	while (!waiter_started) {
+	}
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		/* let the waiter block on the semaphore again */
+		k_busy_wait(100);
+
+		start = OS_GET_TIME();
+		k_sem_give(&wake_sem);
+
+		while (woken != i + 1) {
+		}
+
+		samples[i] = OS_GET_TIME() - start;
+	}
+
+	k_thread_priority_set(k_current_get(), prio);
+
+	bench_stats_print("cross_cpu_wakeup", samples, BENCH_SAMPLES);
+}
+#else
+void cross_cpu_wakeup(void)
+{
+	PRINT_FORMAT(" 10 - Cross CPU wakeup latency not measured without SMP");
+}
+#endif
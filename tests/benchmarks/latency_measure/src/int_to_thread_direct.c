@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file measure interrupt latencies of direct ISRs
+ *
+ * This file contains the tests comparing, over many samples, an ISR
+ * connected through the software ISR table with a direct ISR placed in RAM:
+ * the time from the interrupt being triggered to the ISR running, the time
+ * from the ISR back to the interrupted thread, and the time from the ISR to
+ * a higher priority thread it woke up.
+ *
+ * Spare interrupt lines at the end of the vector table are triggered from
+ * software, which is only done on ARM Cortex-M.
+ */
+
+#include <zephyr.h>
+#include <irq.h>
+
+#include "timestamp.h"
+#include "utils.h"
+
+#if defined(CONFIG_CPU_CORTEX_M) && defined(CONFIG_GEN_IRQ_VECTOR_TABLE)
+#include <arch/arm/cortex_m/cmsis.h>
+
+#define STACK_SIZE 1024
+
+/* the same spare lines as the gen_isr_table test uses */
+#define WRAPPED_IRQ (CONFIG_NUM_IRQS - 1)
+#define DIRECT_IRQ (CONFIG_NUM_IRQS - 2)
+
+/* above the test thread, so that a woken waiter runs at once */
+#define WAITER_PRIORITY 5
+
+static u32_t samples[BENCH_SAMPLES];
+/* time at which the last ISR ran */
+static volatile u32_t isr_ts;
+static volatile bool isr_wake;
+
+K_SEM_DEFINE(isr_sem, 0, 1);
+K_SEM_DEFINE(isr_done_sem, 0, 1);
+K_THREAD_STACK_DEFINE(isr_waiter_stack, STACK_SIZE);
+static struct k_thread isr_waiter_thread;
+
+static void trigger_irq(int irq)
+{
+#if defined(CONFIG_SOC_TI_LM3S6965_QEMU)
+	/* QEMU does not simulate the STIR register: this is a workaround */
+	NVIC_SetPendingIRQ(irq);
+#else
+	NVIC->STIR = irq;
+#endif
+	/* the interrupt is taken before going on */
+	__DSB();
+	__ISB();
+}
+
+static void wrapped_isr(void *unused)
+{
+	ARG_UNUSED(unused);
+
+	isr_ts = OS_GET_TIME();
+
+	if (isr_wake) {
+		k_sem_give(&isr_sem);
+	}
+}
+
+ISR_DIRECT_RAMFUNC_DECLARE(direct_isr)
+{
+	isr_ts = OS_GET_TIME();
+
+	if (!isr_wake) {
+		return 0;
+	}
+
+	k_sem_give(&isr_sem);
+
+	return 1;
+}
+
+/* Measure the time to the ISR, or back from it to the interrupted thread */
+static void isr_measure(int irq, bool back, const char *name)
+{
+	u32_t start;
+	int i;
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		start = OS_GET_TIME();
+		trigger_irq(irq);
+
+		if (back) {
+			samples[i] = OS_GET_TIME() - isr_ts;
+		} else {
+			samples[i] = isr_ts - start;
+		}
+	}
+
+	bench_stats_print(name, samples, BENCH_SAMPLES);
+}
+
+static void isr_waiter(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		k_sem_take(&isr_sem, K_FOREVER);
+		samples[i] = OS_GET_TIME() - isr_ts;
+	}
+
+	k_sem_give(&isr_done_sem);
+}
+
+/* Measure the time from the ISR to the thread it woke up */
+static void wake_measure(int irq, const char *name)
+{
+	int i;
+
+	k_thread_create(&isr_waiter_thread, isr_waiter_stack, STACK_SIZE,
+			isr_waiter, NULL, NULL, NULL, WAITER_PRIORITY, 0,
+			K_NO_WAIT);
+
+	isr_wake = true;
+
+	/* the waiter runs until it blocks, then once per sample */
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		trigger_irq(irq);
+	}
+
+	isr_wake = false;
+
+	k_sem_take(&isr_done_sem, K_FOREVER);
+	bench_stats_print(name, samples, BENCH_SAMPLES);
+}
+
+void int_to_thread_direct(void)
+{
+	PRINT_FORMAT(" 9 - Measure interrupt latencies, ISR table vs direct ISR"
+		     " in RAM");
+
+	IRQ_CONNECT(WRAPPED_IRQ, 0, wrapped_isr, NULL, 0);
+	IRQ_DIRECT_CONNECT(DIRECT_IRQ, 0, direct_isr, 0);
+	irq_enable(WRAPPED_IRQ);
+	irq_enable(DIRECT_IRQ);
+
+	isr_measure(WRAPPED_IRQ, false, "isr_entry");
+	isr_measure(WRAPPED_IRQ, true, "isr_exit");
+	wake_measure(WRAPPED_IRQ, "isr_to_thread");
+
+	isr_measure(DIRECT_IRQ, false, "direct_entry");
+	isr_measure(DIRECT_IRQ, true, "direct_exit");
+	wake_measure(DIRECT_IRQ, "direct_to_thread");
+
+	irq_disable(WRAPPED_IRQ);
+	irq_disable(DIRECT_IRQ);
+}
+#else
+void int_to_thread_direct(void)
+{
+	PRINT_FORMAT(" 9 - Direct ISR latencies not measured on this platform");
+}
+#endif
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @file measure wake up latencies
+ *
+ * This file contains the tests measuring, over many samples, the time from
+ * a thread waking up another one through a kernel object to the woken
+ * thread running: message queue, pipe, poll signal and queue, contended
+ * mutex with priority inheritance, and a wake up from another CPU on SMP
+ * systems. It also measures the jitter of a periodic timer. Statistics
+ * are printed for each measurement.
+ */
+
+#include <zephyr.h>
+
+#include "timestamp.h"
+#include "utils.h"
+
+#define STACK_SIZE 1024
+
+/* above the test thread, so that a woken waiter runs at once */
+#define WAITER_PRIORITY 5
+/* below the test thread, so that it is preempted when giving bench_sem */
+#define OWNER_PRIORITY 12
+
+/* a few timer periods per tick rate second, at least two */
+#define TIMER_SAMPLES max(2, min(BENCH_SAMPLES, \
+				 2 * CONFIG_SYS_CLOCK_TICKS_PER_SEC))
+#define TIMER_PERIOD_MS (MSEC_PER_SEC / CONFIG_SYS_CLOCK_TICKS_PER_SEC)
+
+#if defined(CONFIG_SMP) && (CONFIG_MP_NUM_CPUS > 1) && \
+	defined(CONFIG_SCHED_CPU_MASK)
+#define BENCH_SMP 1
+#endif
+
+enum wake_kind {
+	WAKE_MSGQ,
+	WAKE_PIPE,
+	WAKE_POLL,
+	WAKE_QUEUE,
+};
+
+static u32_t samples[BENCH_SAMPLES];
+/* time at which the waiter was woken up */
+static volatile u32_t wake_ts;
+
+K_THREAD_STACK_DEFINE(waiter_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(helper_stack, STACK_SIZE);
+static struct k_thread waiter_thread;
+static struct k_thread helper_thread;
+
+K_MSGQ_DEFINE(bench_msgq, sizeof(u32_t), 1, 4);
+K_PIPE_DEFINE(bench_pipe, 16, 4);
+K_QUEUE_DEFINE(bench_queue);
+K_SEM_DEFINE(bench_sem, 0, 1);
+K_SEM_DEFINE(bench_ack_sem, 0, 1);
+K_SEM_DEFINE(bench_done_sem, 0, 1);
+K_MUTEX_DEFINE(bench_mutex);
+K_TIMER_DEFINE(bench_timer, NULL, NULL);
+static struct k_poll_signal bench_signal =
+	K_POLL_SIGNAL_INITIALIZER(bench_signal);
+
+static struct {
+	void *reserved;
+} bench_item;
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	enum wake_kind kind = (enum wake_kind)p1;
+	struct k_poll_event event;
+	size_t bytes;
+	u32_t data;
+	int i;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		switch (kind) {
+		case WAKE_MSGQ:
+			k_msgq_get(&bench_msgq, &data, K_FOREVER);
+			break;
+		case WAKE_PIPE:
+			k_pipe_get(&bench_pipe, &data, sizeof(data), &bytes,
+				   sizeof(data), K_FOREVER);
+			break;
+		case WAKE_POLL:
+			k_poll_event_init(&event, K_POLL_TYPE_SIGNAL,
+					  K_POLL_MODE_NOTIFY_ONLY,
+					  &bench_signal);
+			k_poll(&event, 1, K_FOREVER);
+			k_poll_signal_reset(&bench_signal);
+			break;
+		case WAKE_QUEUE:
+			k_queue_get(&bench_queue, K_FOREVER);
+			break;
+		}
+
+		samples[i] = TIME_STAMP_DELTA_GET(wake_ts);
+	}
+}
+
+static void wake_measure(enum wake_kind kind, const char *name)
+{
+	u32_t data = 0;
+	size_t bytes;
+	int i;
+
+	k_thread_create(&waiter_thread, waiter_stack, STACK_SIZE, waiter,
+			(void *)kind, NULL, NULL, WAITER_PRIORITY, 0,
+			K_NO_WAIT);
+
+	/* the waiter runs until it blocks, then once per sample */
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		wake_ts = OS_GET_TIME();
+
+		switch (kind) {
+		case WAKE_MSGQ:
+			k_msgq_put(&bench_msgq, &data, K_NO_WAIT);
+			break;
+		case WAKE_PIPE:
+			k_pipe_put(&bench_pipe, &data, sizeof(data), &bytes,
+				   sizeof(data), K_NO_WAIT);
+			break;
+		case WAKE_POLL:
+			k_poll_signal(&bench_signal, 0);
+			break;
+		case WAKE_QUEUE:
+			k_queue_append(&bench_queue, &bench_item);
+			break;
+		}
+	}
+
+	bench_stats_print(name, samples, BENCH_SAMPLES);
+}
+
+static void mutex_owner(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		k_mutex_lock(&bench_mutex, K_FOREVER);
+		/* the test thread preempts us and waits for the mutex */
+		k_sem_give(&bench_sem);
+		/* running with the priority of the test thread */
+		k_mutex_unlock(&bench_mutex);
+	}
+}
+
+/* Time for a thread to get a mutex held by a lower priority thread:
+ * boosting the owner, switching to it, unlocking and switching back.
+ */
+static void mutex_inherit_measure(void)
+{
+	u32_t ts;
+	int i;
+
+	k_thread_create(&helper_thread, helper_stack, STACK_SIZE,
+			mutex_owner, NULL, NULL, NULL, OWNER_PRIORITY, 0,
+			K_NO_WAIT);
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		k_sem_take(&bench_sem, K_FOREVER);
+		ts = OS_GET_TIME();
+		k_mutex_lock(&bench_mutex, K_FOREVER);
+		samples[i] = TIME_STAMP_DELTA_GET(ts);
+		k_mutex_unlock(&bench_mutex);
+	}
+
+	bench_stats_print("mutex_inherit", samples, BENCH_SAMPLES);
+}
+
+/* Distance between the expiries of a periodic timer and its period */
+static void timer_jitter_measure(void)
+{
+	u32_t period = (u64_t)TIMER_PERIOD_MS *
+		       CONFIG_SYS_CLOCK_HW_CYCLES_PER_SEC / MSEC_PER_SEC;
+	u32_t ts, now, delta;
+	int i;
+
+	k_timer_start(&bench_timer, TIMER_PERIOD_MS, TIMER_PERIOD_MS);
+	k_timer_status_sync(&bench_timer);
+	ts = OS_GET_TIME();
+
+	for (i = 0; i < TIMER_SAMPLES; i++) {
+		k_timer_status_sync(&bench_timer);
+		now = OS_GET_TIME();
+		delta = now - ts;
+		ts = now;
+		samples[i] = (delta > period) ? delta - period :
+						period - delta;
+	}
+
+	k_timer_stop(&bench_timer);
+
+	bench_stats_print("timer_jitter", samples, TIMER_SAMPLES);
+}
+
+#ifdef BENCH_SMP
+static void smp_waiter(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		k_sem_take(&bench_sem, K_FOREVER);
+		samples[i] = TIME_STAMP_DELTA_GET(wake_ts);
+		k_sem_give(&bench_ack_sem);
+	}
+}
+
+static void smp_waker(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < BENCH_SAMPLES; i++) {
+		/* let the waiter block on the other CPU */
+		k_busy_wait(100);
+		wake_ts = OS_GET_TIME();
+		k_sem_give(&bench_sem);
+		k_sem_take(&bench_ack_sem, K_FOREVER);
+	}
+
+	k_sem_give(&bench_done_sem);
+}
+
+/* Wake up of a thread pinned to CPU 0 by a thread pinned to CPU 1,
+ * relies on the timer clock cycles being in sync on both CPUs.
+ */
+static void smp_wake_measure(void)
+{
+	k_thread_create(&waiter_thread, waiter_stack, STACK_SIZE,
+			smp_waiter, NULL, NULL, NULL, WAITER_PRIORITY, 0,
+			K_FOREVER);
+	k_thread_create(&helper_thread, helper_stack, STACK_SIZE,
+			smp_waker, NULL, NULL, NULL, WAITER_PRIORITY, 0,
+			K_FOREVER);
+
+	k_thread_cpu_mask_clear(&waiter_thread);
+	k_thread_cpu_mask_enable(&waiter_thread, 0);
+	k_thread_cpu_mask_clear(&helper_thread);
+	k_thread_cpu_mask_enable(&helper_thread, 1);
+
+	k_thread_start(&waiter_thread);
+	k_thread_start(&helper_thread);
+
+	k_sem_take(&bench_done_sem, K_FOREVER);
+
+	bench_stats_print("smp_wake", samples, BENCH_SAMPLES);
+}
+#endif /* BENCH_SMP */
+
+/**
+ *
+ * @brief Measure wake up latencies and timer jitter
+ *
+ * @return N/A
+ */
+void ipc_latency(void)
+{
+	PRINT_FORMAT(" 7 - Measure time from waking a thread up to it running");
+	wake_measure(WAKE_MSGQ, "msgq_wake");
+	wake_measure(WAKE_PIPE, "pipe_wake");
+	wake_measure(WAKE_POLL, "poll_wake");
+	wake_measure(WAKE_QUEUE, "queue_wake");
+	mutex_inherit_measure();
+#ifdef BENCH_SMP
+	smp_wake_measure();
+#endif
+	print_dash_line();
+
+	PRINT_FORMAT(" 8 - Measure periodic timer jitter");
+	timer_jitter_measure();
+}
@@ -25,6 +25,9 @@ extern void int_to_thread_evt(void);
 extern void sema_lock_unlock(void);
 extern void mutex_lock_unlock(void);
 extern int coop_ctx_switch(void);
+extern void ipc_latency(void);
+extern void int_to_thread_direct(void);
+extern void cross_cpu_wakeup(void);
 void test_thread(void *arg1, void *arg2, void *arg3)
 {
 	PRINT_BANNER();
@@ -50,6 +53,15 @@ void test_thread(void *arg1, void *arg2, void *arg3)
 	coop_ctx_switch();
 	print_dash_line();
 
+	ipc_latency();
+	print_dash_line();
+
+	int_to_thread_direct();
+	print_dash_line();
+
+	cross_cpu_wakeup();
+	print_dash_line();
+
 	TC_END_REPORT(error_count);
 }
 
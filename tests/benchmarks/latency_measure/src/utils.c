@@ -19,3 +19,59 @@
 /* scratchpad for the string used to print on console */
 char tmp_string[TMP_STRING_SIZE];
 
+/**
+ *
+ * @brief Print the statistics of a set of samples
+ *
+ * Prints the minimum, average, median, 99th percentile and maximum of the
+ * samples, in timer clock cycles, as a line of the result table. It is
+ * followed by a line meant for regression tools comparing runs:
+ *
+ *   BENCH <name> <count> <min> <avg> <p50> <p99> <max>
+ *
+ * with the values in nanoseconds. The samples are sorted in place.
+ *
+ * @param name name of the measurement, without spaces
+ * @param samples measured times, in timer clock cycles
+ * @param count number of samples
+ *
+ * @return N/A
+ */
+void bench_stats_print(const char *name, u32_t *samples, int count)
+{
+	u64_t sum = 0;
+	u32_t avg, p50, p99;
+	u32_t tmp;
+	int i, j;
+
+	if (count == 0) {
+		return;
+	}
+
+	/* insertion sort, the sample sets are small */
+	for (i = 1; i < count; i++) {
+		tmp = samples[i];
+		for (j = i; j > 0 && samples[j - 1] > tmp; j--) {
+			samples[j] = samples[j - 1];
+		}
+		samples[j] = tmp;
+	}
+
+	for (i = 0; i < count; i++) {
+		sum += samples[i];
+	}
+
+	avg = sum / count;
+	p50 = samples[count / 2];
+	p99 = samples[(count * 99) / 100];
+
+	PRINT_FORMAT(" %-16s min %u avg %u p50 %u p99 %u max %u tcs", name,
+		     samples[0], avg, p50, p99, samples[count - 1]);
+	PRINTF("BENCH %s %d %u %u %u %u %u\n", name, count,
+	       SYS_CLOCK_HW_CYCLES_TO_NS(samples[0]),
+	       SYS_CLOCK_HW_CYCLES_TO_NS(avg),
+	       SYS_CLOCK_HW_CYCLES_TO_NS(p50),
+	       SYS_CLOCK_HW_CYCLES_TO_NS(p99),
+	       SYS_CLOCK_HW_CYCLES_TO_NS(samples[count - 1]));
+}
+
@@ -76,6 +76,11 @@ static inline void print_dash_line(void)
 #error PRINTK configuration option needs to be enabled
 #endif
 
+/* number of samples of the tests reporting statistics */
+#define BENCH_SAMPLES 256
+
+void bench_stats_print(const char *name, u32_t *samples, int count);
+
 void raiseIntFunc(void);
 extern void raiseInt(u8_t id);
 
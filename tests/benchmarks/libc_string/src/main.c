@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the cycles taken by the string functions of the C library for
+ * several sizes. The functions are called through volatile pointers so
+ * that the compiler can neither inline them nor replace them with
+ * builtins, and each measure is the best of a few runs to filter out
+ * interrupts.
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+#include <string.h>
+
+#define MAX_SIZE 1024
+#define RUNS 8
+
+static u32_t src_buf[MAX_SIZE / sizeof(u32_t) + 2];
+static u32_t dst_buf[MAX_SIZE / sizeof(u32_t) + 2];
+
+static void *(*volatile memcpy_p)(void *, const void *, size_t) = memcpy;
+static void *(*volatile memset_p)(void *, int, size_t) = memset;
+static int (*volatile memcmp_p)(const void *, const void *, size_t) = memcmp;
+static size_t (*volatile strlen_p)(const char *) = strlen;
+static int (*volatile strcmp_p)(const char *, const char *) = strcmp;
+
+static const size_t sizes[] = { 4, 16, 64, 256, MAX_SIZE };
+
+enum {
+	BENCH_MEMCPY,
+	BENCH_MEMCPY_MISALIGNED,
+	BENCH_MEMSET,
+	BENCH_MEMCMP,
+	BENCH_STRLEN,
+	BENCH_STRCMP,
+	BENCH_COUNT,
+};
+
+static u32_t run(int bench, size_t size)
+{
+	char *src = (char *)src_buf;
+	char *dst = (char *)dst_buf;
+	u32_t start, end;
+
+	/* string functions go through size - 1 characters and the NUL */
+	memset(src, 'a', size - 1);
+	src[size - 1] = '\0';
+	memcpy(dst, src, size);
+
+	start = k_cycle_get_32();
+
+	switch (bench) {
+	case BENCH_MEMCPY:
+		memcpy_p(dst, src, size);
+		break;
+	case BENCH_MEMCPY_MISALIGNED:
+		memcpy_p(dst + 1, src, size);
+		break;
+	case BENCH_MEMSET:
+		memset_p(dst, 0x55, size);
+		break;
+	case BENCH_MEMCMP:
+		memcmp_p(dst, src, size);
+		break;
+	case BENCH_STRLEN:
+		strlen_p(src);
+		break;
+	case BENCH_STRCMP:
+		strcmp_p(dst, src);
+		break;
+	}
+
+	end = k_cycle_get_32();
+
+	return end - start;
+}
+
+static u32_t measure(int bench, size_t size)
+{
+	u32_t best = ~0;
+
+	for (int i = 0; i < RUNS; i++) {
+		u32_t cycles = run(bench, size);
+
+		if (cycles < best) {
+			best = cycles;
+		}
+	}
+
+	return best;
+}
+
+void main(void)
+{
+	printk("***** Minimal libc string benchmark *****\n");
+	printk("size   memcpy memcpy+1   memset   memcmp   strlen   strcmp\n");
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		printk("%4u", sizes[i]);
+		for (int bench = 0; bench < BENCH_COUNT; bench++) {
+			printk(" %8u", measure(bench, sizes[i]));
+		}
+		printk("\n");
+	}
+}
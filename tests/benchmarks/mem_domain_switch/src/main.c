@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the context switch latency between user threads of different
+ * memory domains: two user threads ping-pong through semaphores while the
+ * main thread times the whole exchange.
+ */
+
+#include <zephyr.h>
+#include <kernel_structs.h>
+#include <kernel_internal.h>
+#include <misc/printk.h>
+
+#define ITERATIONS 1000
+#define STACK_SIZE 512
+#define MAX_PARTS 8
+
+#if defined(CONFIG_BOARD_MPS2_AN385)
+#define PART_SIZE 1024
+#else
+#define PART_SIZE 32
+#endif
+
+/* MAX_PARTS - 1 shared partitions, and one private partition per domain */
+static u8_t __aligned(PART_SIZE) part_buf[MAX_PARTS + 1][PART_SIZE];
+static struct k_mem_partition parts[MAX_PARTS + 1];
+static struct k_mem_partition *dom_parts[2][MAX_PARTS];
+static struct k_mem_domain domains[2];
+
+static K_THREAD_STACK_ARRAY_DEFINE(stacks, 2, STACK_SIZE);
+static __kernel struct k_thread threads[2];
+static K_SEM_DEFINE(ping_sem, 0, 1);
+static K_SEM_DEFINE(pong_sem, 0, 1);
+static K_SEM_DEFINE(done_sem, 0, 2);
+
+static void ping(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		k_sem_give(&pong_sem);
+		k_sem_take(&ping_sem, K_FOREVER);
+	}
+	k_sem_give(&done_sem);
+}
+
+static void pong(void *p1, void *p2, void *p3)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		k_sem_take(&pong_sem, K_FOREVER);
+		k_sem_give(&ping_sem);
+	}
+	k_sem_give(&done_sem);
+}
+
+static void domains_init(int num_parts)
+{
+	for (int d = 0; d < 2; d++) {
+		for (int i = 0; i < num_parts - 1; i++) {
+			dom_parts[d][i] = &parts[i];
+		}
+		/* private partition last: the only region that differs */
+		dom_parts[d][num_parts - 1] = &parts[MAX_PARTS - 1 + d];
+
+		k_mem_domain_init(&domains[d], num_parts, dom_parts[d]);
+	}
+}
+
+static u32_t measure(int num_parts)
+{
+	k_thread_entry_t entries[2] = { ping, pong };
+	u32_t start, end;
+
+	domains_init(num_parts);
+
+	for (int t = 0; t < 2; t++) {
+		k_thread_create(&threads[t], stacks[t], STACK_SIZE,
+				entries[t], NULL, NULL, NULL,
+				K_PRIO_PREEMPT(1), K_USER, K_FOREVER);
+		k_thread_access_grant(&threads[t], &ping_sem, &pong_sem,
+				      &done_sem, NULL);
+		k_mem_domain_add_thread(&domains[t], &threads[t]);
+	}
+
+	start = k_cycle_get_32();
+	k_thread_start(&threads[0]);
+	k_thread_start(&threads[1]);
+	k_sem_take(&done_sem, K_FOREVER);
+	k_sem_take(&done_sem, K_FOREVER);
+	end = k_cycle_get_32();
+
+	for (int d = 0; d < 2; d++) {
+		k_mem_domain_destroy(&domains[d]);
+	}
+
+	/* two switches per iteration */
+	return (end - start) / (2 * ITERATIONS);
+}
+
+void main(void)
+{
+	static const int num_parts[] = { 1, 4, MAX_PARTS };
+	int max_parts = _arch_mem_domain_max_partitions_get();
+
+	for (int i = 0; i <= MAX_PARTS; i++) {
+		parts[i].start = (u32_t)part_buf[i];
+		parts[i].size = PART_SIZE;
+		parts[i].attr = K_MEM_PARTITION_P_RW_U_RW;
+	}
+
+	printk("***** Memory domain switch benchmark *****\n");
+
+	for (int i = 0; i < ARRAY_SIZE(num_parts); i++) {
+		u32_t cycles;
+
+		if (num_parts[i] > max_parts) {
+			printk("%d partition(s): skipped, %d partition regions "
+			       "available\n", num_parts[i], max_parts);
+			continue;
+		}
+
+		cycles = measure(num_parts[i]);
+		printk("%d partition(s): %u cycles (%u ns) per switch\n",
+		       num_parts[i], cycles,
+		       (u32_t)SYS_CLOCK_HW_CYCLES_TO_NS(cycles));
+	}
+
+	printk("PROJECT EXECUTION SUCCESSFUL\n");
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Compare the red/black tree with a sorted dlist when used as a priority
+ * queue: random inserts, removals of the lowest node and in order walks.
+ * Each figure is the average number of cycles per node.
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+#include <misc/rb.h>
+#include <misc/dlist.h>
+
+#define MAX_NODES 256
+
+struct node {
+	struct rbnode rbnode;
+	sys_dnode_t dnode;
+	u32_t key;
+};
+
+static struct node nodes[MAX_NODES];
+static struct rbtree tree;
+static sys_dlist_t list;
+
+static const int sizes[] = { 4, 16, 64, MAX_NODES };
+
+enum {
+	BENCH_RB_INSERT,
+	BENCH_DLIST_INSERT,
+	BENCH_RB_POP,
+	BENCH_DLIST_POP,
+	BENCH_RB_FOREACH,
+	BENCH_RB_NEXT,
+	BENCH_DLIST_WALK,
+	BENCH_COUNT,
+};
+
+static int node_lessthan(struct rbnode *a, struct rbnode *b)
+{
+	return CONTAINER_OF(a, struct node, rbnode)->key <
+	       CONTAINER_OF(b, struct node, rbnode)->key;
+}
+
+/* Same insertion as the dumb priority queue of the scheduler */
+static void dlist_insert(struct node *n)
+{
+	struct node *t;
+
+	SYS_DLIST_FOR_EACH_CONTAINER(&list, t, dnode) {
+		if (n->key < t->key) {
+			sys_dlist_insert_before(&list, &t->dnode, &n->dnode);
+			return;
+		}
+	}
+
+	sys_dlist_append(&list, &n->dnode);
+}
+
+/* Simple LCRNG, repeatable across platforms */
+static u32_t next_rand(void)
+{
+	static u64_t state = 123456789;
+
+	state = state * 2862933555777941757ull + 3037000493ull;
+
+	return state >> 32;
+}
+
+static void fill(int size)
+{
+	int i;
+
+	tree = (struct rbtree) { .lessthan_fn = node_lessthan };
+	sys_dlist_init(&list);
+
+	for (i = 0; i < size; i++) {
+		nodes[i].key = next_rand();
+		rb_insert(&tree, &nodes[i].rbnode);
+		dlist_insert(&nodes[i]);
+	}
+}
+
+static u32_t run(int bench, int size)
+{
+	volatile u32_t sum = 0;
+	struct rbnode *rn;
+	sys_dnode_t *dn;
+	struct node *n;
+	u32_t start;
+	int i;
+
+	if (bench == BENCH_RB_INSERT || bench == BENCH_DLIST_INSERT) {
+		tree = (struct rbtree) { .lessthan_fn = node_lessthan };
+		sys_dlist_init(&list);
+
+		for (i = 0; i < size; i++) {
+			nodes[i].key = next_rand();
+		}
+	} else {
+		fill(size);
+	}
+
+	start = k_cycle_get_32();
+
+	switch (bench) {
+	case BENCH_RB_INSERT:
+		for (i = 0; i < size; i++) {
+			rb_insert(&tree, &nodes[i].rbnode);
+		}
+		break;
+	case BENCH_DLIST_INSERT:
+		for (i = 0; i < size; i++) {
+			dlist_insert(&nodes[i]);
+		}
+		break;
+	case BENCH_RB_POP:
+		while ((rn = rb_get_min(&tree)) != NULL) {
+			rb_remove(&tree, rn);
+		}
+		break;
+	case BENCH_DLIST_POP:
+		while ((dn = sys_dlist_peek_head(&list)) != NULL) {
+			sys_dlist_remove(dn);
+		}
+		break;
+	case BENCH_RB_FOREACH:
+		RB_FOR_EACH_CONTAINER(&tree, n, rbnode) {
+			sum += n->key;
+		}
+		break;
+	case BENCH_RB_NEXT:
+		for (rn = rb_get_min(&tree); rn; rn = rb_next(&tree, rn)) {
+			sum += CONTAINER_OF(rn, struct node, rbnode)->key;
+		}
+		break;
+	case BENCH_DLIST_WALK:
+		SYS_DLIST_FOR_EACH_CONTAINER(&list, n, dnode) {
+			sum += n->key;
+		}
+		break;
+	}
+
+	return (k_cycle_get_32() - start) / size;
+}
+
+void main(void)
+{
+	int i, bench;
+
+	printk("***** Red/black tree benchmark *****\n");
+	printk("size  rb_ins  dl_ins  rb_pop  dl_pop rb_each rb_next"
+	       " dl_walk\n");
+
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		printk("%4d", sizes[i]);
+		for (bench = 0; bench < BENCH_COUNT; bench++) {
+			printk(" %7u", run(bench, sizes[i]));
+		}
+		printk("\n");
+	}
+}
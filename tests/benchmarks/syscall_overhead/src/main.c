@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measure the userspace overhead of system calls: the same loops of kernel
+ * API calls run in a supervisor thread and in a user thread, and are timed
+ * from the main thread, so that the cycle counter is only read in
+ * supervisor mode.
+ */
+
+#include <zephyr.h>
+#include <misc/printk.h>
+
+#define ITERATIONS 1000
+#define STACK_SIZE 1024
+
+K_MEM_POOL_DEFINE(bench_pool, 16, 64, 4, 4);
+
+static K_THREAD_STACK_DEFINE(bench_stack, STACK_SIZE);
+static __kernel struct k_thread bench_thread;
+static K_SEM_DEFINE(bench_sem, 0, 1);
+static K_SEM_DEFINE(start_sem, 0, 1);
+static K_SEM_DEFINE(done_sem, 0, 1);
+K_QUEUE_DEFINE(bench_queue);
+
+static int item;
+
+static void sem_loop(void)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		k_sem_give(&bench_sem);
+		k_sem_take(&bench_sem, K_NO_WAIT);
+	}
+}
+
+static void queue_loop(void)
+{
+	for (int i = 0; i < ITERATIONS; i++) {
+		k_queue_alloc_append(&bench_queue, &item);
+		k_queue_get(&bench_queue, K_NO_WAIT);
+	}
+}
+
+static void bench_entry(void *loop, void *p2, void *p3)
+{
+	void (*run)(void) = loop;
+
+	k_sem_take(&start_sem, K_FOREVER);
+	run();
+	k_sem_give(&done_sem);
+}
+
+static u32_t measure(void (*loop)(void), u32_t options)
+{
+	u32_t start, end;
+
+	k_thread_create(&bench_thread, bench_stack, STACK_SIZE,
+			bench_entry, loop, NULL, NULL,
+			K_PRIO_PREEMPT(1), options, K_FOREVER);
+	k_thread_access_grant(&bench_thread, &bench_sem, &start_sem,
+			      &done_sem, &bench_queue, NULL);
+	k_thread_resource_pool_assign(&bench_thread, &bench_pool);
+	k_thread_start(&bench_thread);
+
+	/* let the thread reach user mode before starting the clock */
+	k_sleep(10);
+
+	start = k_cycle_get_32();
+	k_sem_give(&start_sem);
+	k_sem_take(&done_sem, K_FOREVER);
+	end = k_cycle_get_32();
+
+	k_thread_abort(&bench_thread);
+
+	return (end - start) / ITERATIONS;
+}
+
+static void report(const char *name, void (*loop)(void))
+{
+	u32_t kernel = measure(loop, 0);
+	u32_t user = measure(loop, K_USER);
+
+	printk("%s: supervisor %u cycles, user %u cycles (+%d)\n",
+	       name, kernel, user, (int)(user - kernel));
+}
+
+void main(void)
+{
+	printk("***** System call overhead benchmark *****\n");
+
+	report("k_sem_give + k_sem_take", sem_loop);
+	report("k_queue_alloc_append + k_queue_get", queue_loop);
+
+	printk("PROJECT EXECUTION SUCCESSFUL\n");
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_driver_uart
+ * @{
+ * @defgroup t_uart_async test_uart_async_operations
+ * @}
+ */
+
+#include "test_uart.h"
+
+void test_main(void)
+{
+	ztest_test_suite(uart_async_test,
+			 ztest_unit_test(test_uart_async_tx),
+			 ztest_unit_test(test_uart_async_tx_abort),
+			 ztest_unit_test(test_uart_async_tx_timeout),
+			 ztest_unit_test(test_uart_async_rx),
+			 ztest_unit_test(test_uart_async_rx_disable));
+	ztest_run_test_suite(uart_async_test);
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief UART asynchronous API cases header file
+ *
+ * Header file for UART asynchronous API cases
+ */
+
+#ifndef __TEST_UART_H__
+#define __TEST_UART_H__
+
+#include <uart.h>
+#include <ztest.h>
+
+#define UART_DEVICE_NAME CONFIG_UART_CONSOLE_ON_DEV_NAME
+
+void test_uart_async_tx(void);
+void test_uart_async_tx_abort(void);
+void test_uart_async_tx_timeout(void);
+void test_uart_async_rx(void);
+void test_uart_async_rx_disable(void);
+
+#endif /* __TEST_UART_H__ */
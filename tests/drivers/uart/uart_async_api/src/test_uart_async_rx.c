@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @addtogroup t_uart_async
+ * @{
+ * @defgroup t_uart_async_rx test_uart_async_rx
+ * @brief TestPurpose: verify the asynchronous UART RX API
+ * @details
+ * - Test Steps
+ *   -# Set the callback using uart_callback_set().
+ *   -# Enable RX using uart_rx_enable() with a small buffer and answer
+ *      each UART_RX_BUF_REQUEST with the other of two buffers.
+ *   -# Wait for a line sent to the UART console.
+ *   -# Disable RX using uart_rx_disable().
+ * - Expected Results
+ *   -# The line is reported with UART_RX_RDY events across several
+ *      buffers, without losing bytes at the buffer swaps.
+ *   -# Every buffer given to the driver is released and UART_RX_DISABLED
+ *      is reported last.
+ * @}
+ */
+
+#include "test_uart.h"
+
+#define RX_BUF_SIZE 8
+#define RX_LINE_SIZE 128
+#define RX_TIMEOUT K_MSEC(50)
+
+static u8_t rx_buf[2][RX_BUF_SIZE];
+static u8_t *rx_next;
+static bool rx_swap;
+
+static u8_t rx_line[RX_LINE_SIZE];
+static size_t rx_line_len;
+static volatile bool rx_line_done;
+
+static int rx_provided;
+static int rx_released;
+static int rx_rdy_count;
+static struct k_sem rx_disabled;
+
+static void uart_rx_callback(struct uart_event *evt, void *user_data)
+{
+	struct device *uart_dev = user_data;
+	size_t i;
+
+	switch (evt->type) {
+	case UART_RX_BUF_REQUEST:
+		if (!rx_swap) {
+			break;
+		}
+
+		if (uart_rx_buf_rsp(uart_dev, rx_next, RX_BUF_SIZE) == 0) {
+			rx_provided++;
+			rx_next = rx_next == rx_buf[0] ? rx_buf[1] : rx_buf[0];
+		}
+		break;
+	case UART_RX_RDY:
+		rx_rdy_count++;
+
+		for (i = 0; i < evt->data.rx.len; i++) {
+			u8_t c = evt->data.rx.buf[evt->data.rx.offset + i];
+
+			if (rx_line_len < sizeof(rx_line)) {
+				rx_line[rx_line_len++] = c;
+			}
+
+			if (c == '\r' || c == '\n') {
+				rx_line_done = true;
+			}
+		}
+		break;
+	case UART_RX_BUF_RELEASED:
+		rx_released++;
+		break;
+	case UART_RX_DISABLED:
+		k_sem_give(&rx_disabled);
+		break;
+	default:
+		break;
+	}
+}
+
+static struct device *rx_setup(bool swap)
+{
+	struct device *uart_dev = device_get_binding(UART_DEVICE_NAME);
+
+	zassert_not_null(uart_dev, "Cannot get UART device");
+
+	k_sem_init(&rx_disabled, 0, 1);
+	rx_next = rx_buf[1];
+	rx_swap = swap;
+	rx_line_len = 0;
+	rx_line_done = false;
+	rx_provided = 1;
+	rx_released = 0;
+	rx_rdy_count = 0;
+
+	zassert_equal(uart_callback_set(uart_dev, uart_rx_callback, uart_dev),
+		      0, "Cannot set callback");
+
+	return uart_dev;
+}
+
+void test_uart_async_rx(void)
+{
+	struct device *uart_dev = rx_setup(true);
+	int ret;
+
+	TC_PRINT("Please send a line of more than %d characters to serial "
+		 "console\n", RX_BUF_SIZE);
+
+	ret = uart_rx_enable(uart_dev, rx_buf[0], RX_BUF_SIZE, RX_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot enable RX");
+
+	ret = uart_rx_enable(uart_dev, rx_buf[1], RX_BUF_SIZE, RX_TIMEOUT);
+	zassert_equal(ret, -EBUSY, "Second RX enable not refused");
+
+	while (!rx_line_done) {
+		k_sleep(K_MSEC(10));
+	}
+
+	zassert_equal(uart_rx_disable(uart_dev), 0, "Cannot disable RX");
+	zassert_equal(k_sem_take(&rx_disabled, K_MSEC(100)), 0,
+		      "RX not disabled");
+	zassert_equal(rx_released, rx_provided, "RX buffers not released");
+
+	TC_PRINT("Received %zu bytes in %d events and %d buffers: %.*s\n",
+		 rx_line_len, rx_rdy_count, rx_provided,
+		 (int)rx_line_len, rx_line);
+
+	zassert_true(rx_line_len > RX_BUF_SIZE, "Line too short");
+	zassert_true(rx_provided > 1, "RX buffers not swapped");
+}
+
+void test_uart_async_rx_disable(void)
+{
+	struct device *uart_dev = rx_setup(false);
+	int ret;
+
+	ret = uart_rx_enable(uart_dev, rx_buf[0], RX_BUF_SIZE, RX_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot enable RX");
+
+	ret = uart_rx_buf_rsp(uart_dev, rx_buf[1], RX_BUF_SIZE);
+	zassert_equal(ret, 0, "Cannot provide the next RX buffer");
+	rx_provided++;
+
+	ret = uart_rx_buf_rsp(uart_dev, rx_buf[0], RX_BUF_SIZE);
+	zassert_equal(ret, -EBUSY, "Third RX buffer not refused");
+
+	zassert_equal(uart_rx_disable(uart_dev), 0, "Cannot disable RX");
+	zassert_equal(k_sem_take(&rx_disabled, K_MSEC(100)), 0,
+		      "RX not disabled");
+	zassert_equal(rx_released, rx_provided, "RX buffers not released");
+	zassert_equal(rx_rdy_count, 0, "Unexpected RX data");
+
+	zassert_equal(uart_rx_disable(uart_dev), -EFAULT,
+		      "Second RX disable not refused");
+	zassert_equal(uart_rx_buf_rsp(uart_dev, rx_buf[1], RX_BUF_SIZE),
+		      -EACCES, "RX buffer accepted while disabled");
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * @addtogroup t_uart_async
+ * @{
+ * @defgroup t_uart_async_tx test_uart_async_tx
+ * @brief TestPurpose: verify the asynchronous UART TX API
+ * @details
+ * - Test Steps
+ *   -# Set the callback using uart_callback_set().
+ *   -# Send a buffer using uart_tx() and wait for UART_TX_DONE.
+ *   -# Start a long transmission and abort it using uart_tx_abort().
+ *   -# Start a long transmission with a short timeout.
+ * - Expected Results
+ *   -# UART_TX_DONE reports the whole buffer, a second uart_tx() is
+ *      refused while the first one is ongoing.
+ *   -# UART_TX_ABORTED reports the buffer and the part of it that was
+ *      sent, whether aborted by the call or by the timeout.
+ * @}
+ */
+
+#include "test_uart.h"
+
+static const u8_t tx_data[] = "This is an asynchronous TX test.\r\n";
+static u8_t tx_long[512];
+
+static struct k_sem tx_sem;
+static struct uart_event tx_evt;
+static int tx_evt_count;
+
+static void uart_tx_callback(struct uart_event *evt, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (evt->type != UART_TX_DONE && evt->type != UART_TX_ABORTED) {
+		return;
+	}
+
+	tx_evt = *evt;
+	tx_evt_count++;
+	k_sem_give(&tx_sem);
+}
+
+static struct device *tx_setup(void)
+{
+	struct device *uart_dev = device_get_binding(UART_DEVICE_NAME);
+
+	zassert_not_null(uart_dev, "Cannot get UART device");
+
+	k_sem_init(&tx_sem, 0, 1);
+	tx_evt_count = 0;
+
+	zassert_equal(uart_callback_set(uart_dev, uart_tx_callback, NULL), 0,
+		      "Cannot set callback");
+
+	return uart_dev;
+}
+
+static void tx_long_fill(void)
+{
+	int i;
+
+	for (i = 0; i < sizeof(tx_long) - 2; i++) {
+		tx_long[i] = 'a' + i % 26;
+	}
+
+	tx_long[i++] = '\r';
+	tx_long[i] = '\n';
+}
+
+void test_uart_async_tx(void)
+{
+	struct device *uart_dev = tx_setup();
+	int ret;
+
+	ret = uart_tx(uart_dev, tx_data, sizeof(tx_data) - 1, K_FOREVER);
+	zassert_equal(ret, 0, "Cannot start TX");
+
+	ret = uart_tx(uart_dev, tx_data, sizeof(tx_data) - 1, K_FOREVER);
+	zassert_equal(ret, -EBUSY, "Second TX not refused");
+
+	zassert_equal(k_sem_take(&tx_sem, K_MSEC(100)), 0, "TX not done");
+	zassert_equal(tx_evt_count, 1, "Unexpected TX events");
+	zassert_equal(tx_evt.type, UART_TX_DONE, "TX not done");
+	zassert_equal(tx_evt.data.tx.buf, tx_data, "Wrong TX buffer");
+	zassert_equal(tx_evt.data.tx.len, sizeof(tx_data) - 1,
+		      "Wrong TX length");
+
+	zassert_equal(uart_tx_abort(uart_dev), -EFAULT,
+		      "Abort without TX not refused");
+}
+
+void test_uart_async_tx_abort(void)
+{
+	struct device *uart_dev = tx_setup();
+	int ret;
+
+	tx_long_fill();
+
+	ret = uart_tx(uart_dev, tx_long, sizeof(tx_long), K_FOREVER);
+	zassert_equal(ret, 0, "Cannot start TX");
+
+	k_sleep(K_MSEC(5));
+
+	zassert_equal(uart_tx_abort(uart_dev), 0, "Cannot abort TX");
+
+	zassert_equal(k_sem_take(&tx_sem, K_MSEC(100)), 0, "TX not aborted");
+	zassert_equal(tx_evt_count, 1, "Unexpected TX events");
+	zassert_equal(tx_evt.type, UART_TX_ABORTED, "TX not aborted");
+	zassert_equal(tx_evt.data.tx.buf, tx_long, "Wrong TX buffer");
+	zassert_true(tx_evt.data.tx.len > 0 &&
+		     tx_evt.data.tx.len < sizeof(tx_long),
+		     "Wrong aborted TX length");
+
+	/* Let the byte in progress go out before ztest prints */
+	k_sleep(K_MSEC(1));
+	TC_PRINT("\n");
+}
+
+void test_uart_async_tx_timeout(void)
+{
+	struct device *uart_dev = tx_setup();
+	int ret;
+
+	tx_long_fill();
+
+	ret = uart_tx(uart_dev, tx_long, sizeof(tx_long), K_MSEC(5));
+	zassert_equal(ret, 0, "Cannot start TX");
+
+	zassert_equal(k_sem_take(&tx_sem, K_MSEC(100)), 0, "TX not aborted");
+	zassert_equal(tx_evt_count, 1, "Unexpected TX events");
+	zassert_equal(tx_evt.type, UART_TX_ABORTED, "TX not aborted");
+	zassert_true(tx_evt.data.tx.len > 0 &&
+		     tx_evt.data.tx.len < sizeof(tx_long),
+		     "Wrong aborted TX length");
+
+	k_sleep(K_MSEC(1));
+	TC_PRINT("\n");
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <misc/futex.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_WAITERS 3
+#define LOOPS 100
+
+K_THREAD_STACK_ARRAY_DEFINE(stacks, NUM_WAITERS, STACK_SIZE);
+static struct k_thread threads[NUM_WAITERS];
+
+static atomic_t futex;
+static atomic_t woken;
+
+static struct sys_futex_mutex mutex = SYS_FUTEX_MUTEX_INITIALIZER;
+static struct sys_futex_sem sem = SYS_FUTEX_SEM_INITIALIZER(0, 1);
+static volatile int counter;
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	if (k_futex_wait(&futex, 0, K_FOREVER) == 0) {
+		atomic_inc(&woken);
+	}
+}
+
+static void spawn(k_thread_entry_t entry, int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE, entry,
+				NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0,
+				K_NO_WAIT);
+	}
+}
+
+static void join(int num)
+{
+	int i;
+
+	for (i = 0; i < num; i++) {
+		k_thread_abort(&threads[i]);
+	}
+}
+
+/**
+ * @brief Test that waiting on a futex that changed returns immediately and
+ * that waits time out
+ */
+void test_futex_wait_no_block(void)
+{
+	atomic_set(&futex, 1);
+	zassert_equal(k_futex_wait(&futex, 0, K_FOREVER), -EAGAIN, NULL);
+
+	atomic_set(&futex, 0);
+	zassert_equal(k_futex_wait(&futex, 0, K_NO_WAIT), -ETIMEDOUT, NULL);
+	zassert_equal(k_futex_wait(&futex, 0, 10), -ETIMEDOUT, NULL);
+
+	zassert_equal(k_futex_wake(&futex, 1), 0, "woke a missing waiter");
+}
+
+/**
+ * @brief Test waking one and all futex waiters
+ */
+void test_futex_wake(void)
+{
+	atomic_set(&futex, 0);
+	atomic_set(&woken, 0);
+
+	spawn(waiter, NUM_WAITERS);
+	k_sleep(50);
+
+	zassert_equal(k_futex_wake(&futex, 0), 1, NULL);
+	k_sleep(10);
+	zassert_equal(atomic_get(&woken), 1, NULL);
+
+	zassert_equal(k_futex_wake(&futex, 1), NUM_WAITERS - 1, NULL);
+	k_sleep(10);
+	zassert_equal(atomic_get(&woken), NUM_WAITERS, NULL);
+
+	join(NUM_WAITERS);
+}
+
+static void mutex_worker(void *p1, void *p2, void *p3)
+{
+	int i, tmp;
+
+	for (i = 0; i < LOOPS; i++) {
+		zassert_equal(sys_futex_mutex_lock(&mutex, K_FOREVER), 0, NULL);
+		tmp = counter;
+		k_yield();
+		counter = tmp + 1;
+		sys_futex_mutex_unlock(&mutex);
+	}
+}
+
+/**
+ * @brief Test mutual exclusion of the futex mutex under contention
+ */
+void test_futex_mutex(void)
+{
+	zassert_equal(sys_futex_mutex_lock(&mutex, K_NO_WAIT), 0, NULL);
+	zassert_equal(sys_futex_mutex_lock(&mutex, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(sys_futex_mutex_lock(&mutex, 10), -EAGAIN, NULL);
+	sys_futex_mutex_unlock(&mutex);
+
+	counter = 0;
+	spawn(mutex_worker, NUM_WAITERS);
+	k_sleep(500);
+	zassert_equal(counter, NUM_WAITERS * LOOPS, "lost updates");
+	join(NUM_WAITERS);
+}
+
+static void sem_giver(void *p1, void *p2, void *p3)
+{
+	k_sleep(20);
+	sys_futex_sem_give(&sem);
+}
+
+/**
+ * @brief Test the futex semaphore
+ */
+void test_futex_sem(void)
+{
+	zassert_equal(sys_futex_sem_take(&sem, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(sys_futex_sem_take(&sem, 10), -EAGAIN, NULL);
+
+	sys_futex_sem_give(&sem);
+	sys_futex_sem_give(&sem);
+	zassert_equal(sys_futex_sem_count_get(&sem), 1, "limit ignored");
+	zassert_equal(sys_futex_sem_take(&sem, K_NO_WAIT), 0, NULL);
+
+	spawn(sem_giver, 1);
+	zassert_equal(sys_futex_sem_take(&sem, K_FOREVER), 0, NULL);
+	zassert_equal(sys_futex_sem_count_get(&sem), 0, NULL);
+	join(1);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(futex,
+			 ztest_unit_test(test_futex_wait_no_block),
+			 ztest_unit_test(test_futex_wake),
+			 ztest_unit_test(test_futex_mutex),
+			 ztest_unit_test(test_futex_sem));
+	ztest_run_test_suite(futex);
+}
@@ -26,6 +26,9 @@ extern void test_mbox_async_put_to_waiting_get(void);
 extern void test_mbox_get_waiting_put_incorrect_tid(void);
 extern void test_mbox_async_multiple_put(void);
 extern void test_mbox_multiple_waiting_get(void);
+extern void test_mbox_async_sg_put_in_place(void);
+extern void test_mbox_sg_put_gather(void);
+extern void test_mbox_sg_get_not_sg(void);
 
 /*test case main entry*/
 void test_main(void)
@@ -53,6 +56,9 @@ void test_main(void)
 			 ztest_unit_test(
 				test_mbox_get_waiting_put_incorrect_tid),
 			 ztest_unit_test(test_mbox_async_multiple_put),
-			 ztest_unit_test(test_mbox_multiple_waiting_get));
+			 ztest_unit_test(test_mbox_multiple_waiting_get),
+			 ztest_unit_test(test_mbox_async_sg_put_in_place),
+			 ztest_unit_test(test_mbox_sg_put_gather),
+			 ztest_unit_test(test_mbox_sg_get_not_sg));
 	ztest_run_test_suite(mbox_api);
 }
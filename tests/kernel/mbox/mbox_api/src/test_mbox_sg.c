@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define SG_COUNT 3
+
+K_MBOX_DEFINE(sg_mbox);
+static K_THREAD_STACK_DEFINE(sg_stack, STACK_SIZE);
+static struct k_thread sg_thread;
+
+static char frag0[] = "scatter";
+static char frag1[] = "-gather";
+static char frag2[] = " message";
+
+static const struct k_mbox_sg sg[SG_COUNT] = {
+	{ frag0, sizeof(frag0) - 1 },
+	{ frag1, sizeof(frag1) - 1 },
+	{ frag2, sizeof(frag2) },
+};
+
+static const char expected[] = "scatter-gather message";
+
+static void sg_sender(void *p1, void *p2, void *p3)
+{
+	struct k_mbox_msg mmsg = {
+		.info = SG_COUNT,
+		.tx_target_thread = K_ANY,
+	};
+
+	k_mbox_sg_put(&sg_mbox, &mmsg, sg, SG_COUNT, K_FOREVER);
+}
+
+/**
+ * @brief Test asynchronous scatter-gather messages consumed in place
+ */
+void test_mbox_async_sg_put_in_place(void)
+{
+	struct k_poll_signal signal = K_POLL_SIGNAL_INITIALIZER(signal);
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signal);
+	struct k_mbox_msg tx_msg = {
+		.info = SG_COUNT,
+		.tx_target_thread = K_ANY,
+	};
+	struct k_mbox_msg rx_msg = {
+		.size = sizeof(expected),
+		.rx_source_thread = K_ANY,
+	};
+	const struct k_mbox_sg *rx_sg;
+
+	k_mbox_async_sg_put(&sg_mbox, &tx_msg, sg, SG_COUNT, &signal);
+
+	zassert_equal(k_mbox_get(&sg_mbox, &rx_msg, NULL, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx_msg.size, sizeof(expected), NULL);
+	zassert_equal(rx_msg.info, SG_COUNT, NULL);
+
+	/**TESTPOINT: the receiver gets the sender's buffers, not copies*/
+	zassert_equal(k_mbox_data_sg_get(&rx_msg, &rx_sg), SG_COUNT, NULL);
+	for (int i = 0; i < SG_COUNT; i++) {
+		zassert_equal(rx_sg[i].data, sg[i].data, NULL);
+		zassert_equal(rx_sg[i].size, sg[i].size, NULL);
+	}
+
+	/**TESTPOINT: completion is only signalled on release*/
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), -EAGAIN, NULL);
+
+	k_mbox_data_release(&rx_msg);
+
+	zassert_equal(k_poll(&event, 1, K_NO_WAIT), 0, NULL);
+	zassert_equal(signal.result, sizeof(expected), NULL);
+}
+
+/**
+ * @brief Test scatter-gather messages copied by the receiver
+ */
+void test_mbox_sg_put_gather(void)
+{
+	struct k_mbox_msg rx_msg = {
+		.size = sizeof(expected),
+		.rx_source_thread = K_ANY,
+	};
+	const struct k_mbox_sg *rx_sg;
+	char buffer[sizeof(expected)];
+
+	k_thread_create(&sg_thread, sg_stack, STACK_SIZE,
+			sg_sender, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+
+	zassert_equal(k_mbox_get(&sg_mbox, &rx_msg, NULL, K_FOREVER), 0, NULL);
+	zassert_equal(k_mbox_data_sg_get(&rx_msg, &rx_sg), SG_COUNT, NULL);
+
+	/**TESTPOINT: k_mbox_data_get() gathers the buffers*/
+	k_mbox_data_get(&rx_msg, buffer);
+	zassert_true(memcmp(buffer, expected, sizeof(expected)) == 0, NULL);
+
+	k_thread_abort(&sg_thread);
+}
+
+/**
+ * @brief Test k_mbox_data_sg_get() on a regular message
+ */
+void test_mbox_sg_get_not_sg(void)
+{
+	struct k_mbox_msg tx_msg = {
+		.size = sizeof(expected),
+		.tx_data = (void *)expected,
+		.tx_target_thread = K_ANY,
+	};
+	struct k_mbox_msg rx_msg = {
+		.size = sizeof(expected),
+		.rx_source_thread = K_ANY,
+	};
+	const struct k_mbox_sg *rx_sg;
+
+	k_mbox_async_put(&sg_mbox, &tx_msg, NULL);
+
+	zassert_equal(k_mbox_get(&sg_mbox, &rx_msg, NULL, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_mbox_data_sg_get(&rx_msg, &rx_sg), -EINVAL, NULL);
+	k_mbox_data_get(&rx_msg, NULL);
+}
@@ -19,6 +19,16 @@ extern void test_mpool_alloc_free_isr(void);
 extern void test_mpool_kdefine_extern(void);
 extern void test_mpool_alloc_size(void);
 extern void test_mpool_alloc_timeout(void);
+#ifdef CONFIG_MEM_POOL_TLSF
+extern void test_mpool_alloc_variable(void);
+#else
+#define test_mpool_alloc_variable ztest_test_skip
+#endif
+#ifdef CONFIG_MEM_POOL_STATS
+extern void test_mpool_stats(void);
+#else
+#define test_mpool_stats ztest_test_skip
+#endif
 
 /*test case main entry*/
 void test_main(void)
@@ -28,7 +38,9 @@ void test_main(void)
 			 ztest_unit_test(test_mpool_alloc_free_isr),
 			 ztest_unit_test(test_mpool_kdefine_extern),
 			 ztest_unit_test(test_mpool_alloc_size),
-			 ztest_unit_test(test_mpool_alloc_timeout)
+			 ztest_unit_test(test_mpool_alloc_timeout),
+			 ztest_unit_test(test_mpool_alloc_variable),
+			 ztest_unit_test(test_mpool_stats)
 			 );
 	ztest_run_test_suite(mpool_api);
 }
@@ -171,3 +171,87 @@ void test_mpool_alloc_timeout(void)
 	}
 }
 
+
+#ifdef CONFIG_MEM_POOL_TLSF
+#define VAR_BLK_SIZE 70
+#define VAR_BLK_NUM 4
+
+/**
+ * @ingroup kernel_memory_pool_tests
+ * @brief Verify a TLSF pool serves blocks of their requested size
+ *
+ * @details A partitioned pool could only serve two 70 byte requests,
+ * each using a 128 byte block. A TLSF pool of the same definition holds
+ * more of them, and merges them back on free so that the largest blocks
+ * can be allocated again.
+ * @see k_mem_pool_alloc(), k_mem_pool_free()
+ */
+void test_mpool_alloc_variable(void)
+{
+	struct k_mem_block block[VAR_BLK_NUM];
+
+	for (int i = 0; i < VAR_BLK_NUM; i++) {
+		zassert_equal(k_mem_pool_alloc(&kmpool, &block[i],
+					       VAR_BLK_SIZE, K_NO_WAIT), 0,
+			      NULL);
+		zassert_true((u32_t)(block[i].data) % BLK_ALIGN == 0, NULL);
+	}
+
+	/* free out of order to exercise merging on both sides */
+	for (int i = 0; i < VAR_BLK_NUM; i += 2) {
+		k_mem_pool_free(&block[i]);
+	}
+	for (int i = 1; i < VAR_BLK_NUM; i += 2) {
+		k_mem_pool_free(&block[i]);
+	}
+
+	tmpool_alloc_free(NULL);
+}
+#endif
+
+#ifdef CONFIG_MEM_POOL_STATS
+/**
+ * @ingroup kernel_memory_pool_tests
+ * @brief Verify memory pool statistics
+ *
+ * @details Allocate a block, fail an allocation and free the block,
+ * checking counters, high watermarks and histograms along the way.
+ * @see k_mem_pool_stats_get(), k_mem_pool_stats_reset()
+ */
+void test_mpool_stats(void)
+{
+	struct k_mem_pool_stats stats;
+	struct k_mem_block block, fblock;
+	u32_t free_blocks = 0;
+
+	k_mem_pool_stats_reset(&kmpool);
+
+	zassert_equal(k_mem_pool_alloc(&kmpool, &block, BLK_SIZE_MIN,
+				       K_NO_WAIT), 0, NULL);
+	k_mem_pool_stats_get(&kmpool, &stats);
+	zassert_equal(stats.alloc_count, 1, NULL);
+	zassert_equal(stats.used_blocks, 1, NULL);
+	zassert_true(stats.used_bytes >= BLK_SIZE_MIN, NULL);
+	zassert_equal(stats.request_hist[0], 1, NULL);
+
+	zassert_equal(k_mem_pool_alloc(&kmpool, &fblock, 4 * BLK_SIZE_MAX,
+				       K_NO_WAIT), -ENOMEM, NULL);
+	k_mem_pool_stats_get(&kmpool, &stats);
+	zassert_equal(stats.failed_count, 1, NULL);
+	zassert_equal(stats.last_failed_size, 4 * BLK_SIZE_MAX, NULL);
+	zassert_not_null(stats.last_failed_caller, NULL);
+
+	k_mem_pool_free(&block);
+	k_mem_pool_stats_get(&kmpool, &stats);
+	zassert_equal(stats.free_count, 1, NULL);
+	zassert_equal(stats.used_blocks, 0, NULL);
+	zassert_equal(stats.used_bytes, 0, NULL);
+	zassert_equal(stats.max_used_blocks, 1, NULL);
+
+	for (int i = 0; i < CONFIG_MEM_POOL_STATS_BUCKETS; i++) {
+		zassert_equal(stats.used_hist[i], 0, NULL);
+		free_blocks += stats.free_hist[i];
+	}
+	zassert_true(free_blocks > 0, NULL);
+}
+#endif
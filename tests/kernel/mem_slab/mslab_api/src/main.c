@@ -13,6 +13,11 @@ extern void test_mslab_alloc_free_thread(void);
 extern void test_mslab_alloc_align(void);
 extern void test_mslab_alloc_timeout(void);
 extern void test_mslab_used_get(void);
+#ifdef CONFIG_MEM_SLAB_CPU_CACHE
+extern void test_mslab_cache(void);
+#else
+#define test_mslab_cache ztest_test_skip
+#endif
 
 /*test case main entry*/
 void test_main(void)
@@ -24,6 +29,7 @@ void test_main(void)
 			 ztest_unit_test(test_mslab_alloc_free_thread),
 			 ztest_unit_test(test_mslab_alloc_align),
 			 ztest_unit_test(test_mslab_alloc_timeout),
-			 ztest_unit_test(test_mslab_used_get));
+			 ztest_unit_test(test_mslab_used_get),
+			 ztest_unit_test(test_mslab_cache));
 	ztest_run_test_suite(mslab_api);
 }
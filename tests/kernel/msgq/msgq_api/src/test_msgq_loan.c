@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "test_msgq.h"
+
+K_MSGQ_DEFINE(loan_msgq, MSG_SIZE, MSGQ_LEN, 4);
+static K_THREAD_STACK_DEFINE(loan_stack, STACK_SIZE);
+static struct k_thread loan_tdata;
+
+static void loan_receiver(void *p1, void *p2, void *p3)
+{
+	u32_t msg;
+
+	zassert_equal(k_msgq_get(&loan_msgq, &msg, K_FOREVER), 0, NULL);
+	zassert_equal(msg, MSG1, NULL);
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test sending and receiving messages in place
+ * @see k_msgq_put_loan(), k_msgq_put_commit(), k_msgq_get_loan(),
+ * k_msgq_get_release()
+ */
+void test_msgq_loan(void)
+{
+	u32_t msg = MSG0;
+	void *slot, *slot2;
+
+	/**TESTPOINT: loan a slot, fill it and commit it*/
+	zassert_equal(k_msgq_put_loan(&loan_msgq, &slot, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_msgq_put_loan(&loan_msgq, &slot2, K_NO_WAIT), -EBUSY,
+		      NULL);
+	zassert_equal(k_msgq_put(&loan_msgq, &msg, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_num_used_get(&loan_msgq), 0, NULL);
+	*(u32_t *)slot = MSG0;
+	zassert_equal(k_msgq_put_commit(&loan_msgq), 0, NULL);
+	zassert_equal(k_msgq_put_commit(&loan_msgq), -EINVAL, NULL);
+	zassert_equal(k_msgq_num_used_get(&loan_msgq), 1, NULL);
+
+	/**TESTPOINT: read the message in place, then release it*/
+	zassert_equal(k_msgq_get_loan(&loan_msgq, &slot2, K_NO_WAIT), 0, NULL);
+	zassert_equal(slot2, slot, NULL);
+	zassert_equal(*(u32_t *)slot2, MSG0, NULL);
+	zassert_equal(k_msgq_get(&loan_msgq, &msg, K_NO_WAIT), -EBUSY, NULL);
+	zassert_equal(k_msgq_get_release(&loan_msgq), 0, NULL);
+	zassert_equal(k_msgq_get_release(&loan_msgq), -EINVAL, NULL);
+	zassert_equal(k_msgq_num_used_get(&loan_msgq), 0, NULL);
+
+	/**TESTPOINT: loans fail or time out on an empty or full queue*/
+	zassert_equal(k_msgq_get_loan(&loan_msgq, &slot, K_NO_WAIT), -ENOMSG,
+		      NULL);
+	zassert_equal(k_msgq_get_loan(&loan_msgq, &slot, TIMEOUT), -EAGAIN,
+		      NULL);
+	for (int i = 0; i < MSGQ_LEN; i++) {
+		zassert_equal(k_msgq_put(&loan_msgq, &msg, K_NO_WAIT), 0,
+			      NULL);
+	}
+	zassert_equal(k_msgq_put_loan(&loan_msgq, &slot, K_NO_WAIT), -ENOMSG,
+		      NULL);
+	zassert_equal(k_msgq_put_loan(&loan_msgq, &slot, TIMEOUT), -EAGAIN,
+		      NULL);
+	k_msgq_purge(&loan_msgq);
+
+	/**TESTPOINT: a committed message goes to a waiting receiver*/
+	k_thread_create(&loan_tdata, loan_stack, STACK_SIZE,
+			loan_receiver, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_put_loan(&loan_msgq, &slot, K_NO_WAIT), 0, NULL);
+	*(u32_t *)slot = MSG1;
+	zassert_equal(k_msgq_put_commit(&loan_msgq), 0, NULL);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_msgq_num_used_get(&loan_msgq), 0, NULL);
+	k_thread_abort(&loan_tdata);
+}
+
+/**
+ * @}
+ */
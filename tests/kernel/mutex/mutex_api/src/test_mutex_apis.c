@@ -15,6 +15,17 @@ static struct k_mutex mutex;
 static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
 static struct k_thread tdata;
 
+/* threads and mutexes of the priority inheritance chain test */
+#define CHAIN_LOW_PRIO K_PRIO_PREEMPT(12)
+#define CHAIN_MID_PRIO K_PRIO_PREEMPT(10)
+#define CHAIN_HIGH_PRIO K_PRIO_PREEMPT(5)
+K_MUTEX_DEFINE(chain_mutex_a);
+K_MUTEX_DEFINE(chain_mutex_b);
+static K_THREAD_STACK_DEFINE(chain_stack_mid, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(chain_stack_high, STACK_SIZE);
+static struct k_thread chain_mid;
+static struct k_thread chain_high;
+
 static void tThread_entry_lock_forever(void *p1, void *p2, void *p3)
 {
 	zassert_false(k_mutex_lock((struct k_mutex *)p1, K_FOREVER) == 0,
@@ -41,6 +52,24 @@ static void tThread_entry_lock_timeout_pass(void *p1, void *p2, void *p3)
 	k_mutex_unlock((struct k_mutex *)p1);
 }
 
+/* Holds mutex b while waiting for mutex a */
+static void tThread_entry_chain_mid(void *p1, void *p2, void *p3)
+{
+	zassert_true(k_mutex_lock(&chain_mutex_b, K_FOREVER) == 0, NULL);
+	zassert_true(k_mutex_lock(&chain_mutex_a, K_FOREVER) == 0, NULL);
+	k_mutex_unlock(&chain_mutex_a);
+	k_mutex_unlock(&chain_mutex_b);
+
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      CHAIN_MID_PRIO, "priority not restored");
+}
+
+static void tThread_entry_chain_high(void *p1, void *p2, void *p3)
+{
+	zassert_true(k_mutex_lock(&chain_mutex_b, K_FOREVER) == 0, NULL);
+	k_mutex_unlock(&chain_mutex_b);
+}
+
 static void tmutex_test_lock(struct k_mutex *pmutex,
 			     void (*entry_fn)(void *, void *, void *))
 {
@@ -130,6 +159,48 @@ void test_mutex_reent_lock_timeout_pass(void)
 	tmutex_test_lock_timeout(&kmutex, tThread_entry_lock_no_wait);
 }
 
+/**
+ * @brief Test priority inheritance through a chain of mutex owners
+ *
+ * The current thread holds mutex a, which a middle priority thread holding
+ * mutex b waits for, and a high priority thread then waits for mutex b.
+ * With CONFIG_MUTEX_PI_CHAIN the high priority is passed on to the current
+ * thread, otherwise it only inherits the middle priority.
+ */
+void test_mutex_priority_inheritance_chain(void)
+{
+	k_tid_t self = k_current_get();
+	int prio = k_thread_priority_get(self);
+
+	k_thread_priority_set(self, CHAIN_LOW_PRIO);
+	zassert_true(k_mutex_lock(&chain_mutex_a, K_FOREVER) == 0, NULL);
+
+	/* both threads preempt us and block on the mutexes */
+	k_thread_create(&chain_mid, chain_stack_mid, STACK_SIZE,
+			tThread_entry_chain_mid, NULL, NULL, NULL,
+			CHAIN_MID_PRIO, 0, 0);
+	zassert_equal(k_thread_priority_get(self), CHAIN_MID_PRIO, NULL);
+
+	k_thread_create(&chain_high, chain_stack_high, STACK_SIZE,
+			tThread_entry_chain_high, NULL, NULL, NULL,
+			CHAIN_HIGH_PRIO, 0, 0);
+#ifdef CONFIG_MUTEX_PI_CHAIN
+	zassert_equal(k_thread_priority_get(self), CHAIN_HIGH_PRIO,
+		      "priority not inherited through the chain");
+#else
+	zassert_equal(k_thread_priority_get(self), CHAIN_MID_PRIO, NULL);
+#endif
+
+	/* the other threads run to completion from here */
+	k_mutex_unlock(&chain_mutex_a);
+	zassert_equal(k_thread_priority_get(self), CHAIN_LOW_PRIO,
+		      "priority not restored");
+
+	k_thread_abort(&chain_mid);
+	k_thread_abort(&chain_high);
+	k_thread_priority_set(self, prio);
+}
+
 void test_mutex_lock_unlock(void)
 {
 	/**TESTPOINT: test k_mutex_init mutex*/
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+
+#define STACK_SIZE 1024
+#define PIPE_LEN 16
+#define FRAME_LEN 12
+#define TIMEOUT 100
+
+K_PIPE_DEFINE(loan_pipe, PIPE_LEN, 4);
+static K_THREAD_STACK_DEFINE(loan_stack, STACK_SIZE);
+static struct k_thread loan_tdata;
+static const unsigned char frame[FRAME_LEN] = "loaned frame";
+
+static void loan_reader(void *p1, void *p2, void *p3)
+{
+	unsigned char buf[FRAME_LEN];
+	size_t read;
+
+	zassert_equal(k_pipe_get(&loan_pipe, buf, FRAME_LEN, &read,
+				 FRAME_LEN, K_FOREVER), 0, NULL);
+	zassert_equal(memcmp(buf, frame, FRAME_LEN), 0, NULL);
+}
+
+/**
+ * @addtogroup kernel_pipe_tests
+ * @{
+ */
+
+/**
+ * @brief Test writing and reading pipe data in place
+ * @see k_pipe_put_loan(), k_pipe_put_commit(), k_pipe_get_loan(),
+ * k_pipe_get_release()
+ */
+void test_pipe_loan(void)
+{
+	void *data, *data2;
+	size_t bytes, bytes2, written;
+
+	/**TESTPOINT: loan buffer space, fill it and commit it*/
+	zassert_equal(k_pipe_get_loan(&loan_pipe, &data, &bytes), -EIO, NULL);
+	zassert_equal(k_pipe_put_loan(&loan_pipe, &data, &bytes), 0, NULL);
+	zassert_equal(bytes, PIPE_LEN, NULL);
+	zassert_equal(k_pipe_put_loan(&loan_pipe, &data2, &bytes2), -EBUSY,
+		      NULL);
+	zassert_equal(k_pipe_put(&loan_pipe, (void *)frame, 1, &written, 1,
+				 K_NO_WAIT), -EBUSY, NULL);
+	memcpy(data, frame, FRAME_LEN);
+	zassert_equal(k_pipe_put_commit(&loan_pipe, PIPE_LEN + 1), -EINVAL,
+		      NULL);
+	zassert_equal(k_pipe_put_commit(&loan_pipe, FRAME_LEN), 0, NULL);
+
+	/**TESTPOINT: loan data, read it and release it in two steps*/
+	zassert_equal(k_pipe_get_loan(&loan_pipe, &data2, &bytes2), 0, NULL);
+	zassert_equal(data2, data, NULL);
+	zassert_equal(bytes2, FRAME_LEN, NULL);
+	zassert_equal(memcmp(data2, frame, FRAME_LEN), 0, NULL);
+	zassert_equal(k_pipe_get_release(&loan_pipe, FRAME_LEN / 2), 0, NULL);
+	zassert_equal(k_pipe_get_release(&loan_pipe, 0), -EINVAL, NULL);
+	zassert_equal(k_pipe_get_loan(&loan_pipe, &data2, &bytes2), 0, NULL);
+	zassert_equal(bytes2, FRAME_LEN - FRAME_LEN / 2, NULL);
+	zassert_equal(k_pipe_get_release(&loan_pipe, bytes2), 0, NULL);
+
+	/**TESTPOINT: the free space after the data wraps around*/
+	zassert_equal(k_pipe_put_loan(&loan_pipe, &data, &bytes), 0, NULL);
+	zassert_equal(bytes, PIPE_LEN - FRAME_LEN, NULL);
+	zassert_equal(k_pipe_put_commit(&loan_pipe, 0), 0, NULL);
+
+	/**TESTPOINT: committed data goes to a waiting reader*/
+	k_thread_create(&loan_tdata, loan_stack, STACK_SIZE,
+			loan_reader, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_pipe_put_loan(&loan_pipe, &data, &written), 0, NULL);
+	zassert_equal(written, PIPE_LEN - FRAME_LEN, NULL);
+	memcpy(data, frame, written);
+	zassert_equal(k_pipe_put_commit(&loan_pipe, written), 0, NULL);
+	zassert_equal(k_pipe_put_loan(&loan_pipe, &data, &bytes), 0, NULL);
+	zassert_true(bytes >= FRAME_LEN - written, NULL);
+	memcpy(data, frame + written, FRAME_LEN - written);
+	zassert_equal(k_pipe_put_commit(&loan_pipe, FRAME_LEN - written), 0,
+		      NULL);
+	k_sleep(TIMEOUT >> 1);
+	zassert_equal(k_pipe_get_loan(&loan_pipe, &data, &bytes), -EIO, NULL);
+	k_thread_abort(&loan_tdata);
+}
+
+/**
+ * @}
+ */
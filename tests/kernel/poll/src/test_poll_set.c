@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <kernel.h>
+
+#define NUM_SEMS 8
+#define SET_SIGNAL_RESULT 0x600dcafe
+
+static struct k_sem set_sems[NUM_SEMS];
+static struct k_poll_signal set_signal;
+static struct k_poll_event set_events[NUM_SEMS + 1];
+static struct k_poll_set set;
+
+static struct k_thread set_helper_thread;
+static K_THREAD_STACK_DEFINE(set_helper_stack, KB(1));
+
+static void set_helper(void *p1, void *p2, void *p3)
+{
+	/* let both events be ready by the time the poller runs */
+	k_sched_lock();
+	k_sem_give(&set_sems[NUM_SEMS - 1]);
+	k_poll_signal(&set_signal, SET_SIGNAL_RESULT);
+	k_sched_unlock();
+}
+
+/* verify persistent poll sets */
+void test_poll_set(void)
+{
+	struct k_poll_event *ready[NUM_SEMS + 1];
+	int i;
+
+	k_poll_set_init(&set);
+	k_poll_signal_init(&set_signal);
+
+	for (i = 0; i < NUM_SEMS; i++) {
+		k_sem_init(&set_sems[i], 0, 1);
+		k_poll_event_init(&set_events[i], K_POLL_TYPE_SEM_AVAILABLE,
+				  K_POLL_MODE_NOTIFY_ONLY, &set_sems[i]);
+		set_events[i].tag = i;
+		zassert_equal(k_poll_set_add(&set, &set_events[i]), 0, NULL);
+	}
+	k_poll_event_init(&set_events[NUM_SEMS], K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &set_signal);
+	set_events[NUM_SEMS].tag = NUM_SEMS;
+	zassert_equal(k_poll_set_add(&set, &set_events[NUM_SEMS]), 0, NULL);
+	zassert_equal(k_poll_set_add(&set, &set_events[0]), -EBUSY, NULL);
+
+	/* nothing ready */
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), -EAGAIN, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready), 10),
+		      -EAGAIN, NULL);
+
+	/* only the ready events are reported */
+	k_sem_give(&set_sems[2]);
+	k_sem_give(&set_sems[5]);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), 2, NULL);
+	zassert_equal(ready[0]->tag, 2, NULL);
+	zassert_equal(ready[1]->tag, 5, NULL);
+	zassert_equal(ready[0]->state, K_POLL_STATE_SEM_AVAILABLE, NULL);
+
+	/* level-triggered: reported again until the condition goes away */
+	zassert_equal(k_sem_take(&set_sems[2], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, 1, K_NO_WAIT), 1, NULL);
+	zassert_equal(ready[0]->tag, 5, NULL);
+	zassert_equal(k_sem_take(&set_sems[5], K_NO_WAIT), 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), -EAGAIN, NULL);
+
+	/* registrations survive the waits: wake up on another thread */
+	k_thread_create(&set_helper_thread, set_helper_stack,
+			K_THREAD_STACK_SIZEOF(set_helper_stack),
+			set_helper, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, 0);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_FOREVER), 2, NULL);
+	zassert_equal(ready[0]->tag, NUM_SEMS - 1, NULL);
+	zassert_equal(ready[1]->tag, NUM_SEMS, NULL);
+	zassert_equal(ready[1]->state, K_POLL_STATE_SIGNALED, NULL);
+	zassert_equal(k_sem_take(&set_sems[NUM_SEMS - 1], K_NO_WAIT), 0, NULL);
+	k_poll_signal_reset(&set_signal);
+
+	/* removed events are not reported anymore */
+	zassert_equal(k_poll_set_remove(&set, &set_events[3]), 0, NULL);
+	zassert_equal(k_poll_set_remove(&set, &set_events[3]), -EINVAL, NULL);
+	k_sem_give(&set_sems[3]);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), -EAGAIN, NULL);
+
+	/* ... unless added back */
+	zassert_equal(k_poll_set_add(&set, &set_events[3]), 0, NULL);
+	zassert_equal(k_poll_set_wait(&set, ready, ARRAY_SIZE(ready),
+				      K_NO_WAIT), 1, NULL);
+	zassert_equal(ready[0]->tag, 3, NULL);
+
+	for (i = 0; i <= NUM_SEMS; i++) {
+		zassert_equal(k_poll_set_remove(&set, &set_events[i]), 0,
+			      NULL);
+	}
+}
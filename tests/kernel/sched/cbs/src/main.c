@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+#define HOG_PRIO 5
+#define VICTIM_PRIO 6
+
+K_THREAD_STACK_DEFINE(hog_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(victim_stack, STACK_SIZE);
+static struct k_thread hog_thread;
+static struct k_thread victim_thread;
+
+static volatile u32_t victim_count;
+
+static void hog(void *p1, void *p2, void *p3)
+{
+	while (1) {
+		/* never blocks */
+	}
+}
+
+static void victim(void *p1, void *p2, void *p3)
+{
+	while (1) {
+		victim_count++;
+	}
+}
+
+/**
+ * @brief Test that a server overrunning its budget is throttled
+ *
+ * A thread spinning forever at a given priority starves any lower priority
+ * thread, unless it runs as a server with a partial bandwidth.
+ */
+void test_cbs_throttle(void)
+{
+	k_tid_t hog_tid, victim_tid;
+
+	hog_tid = k_thread_create(&hog_thread, hog_stack, STACK_SIZE,
+				  hog, NULL, NULL, NULL, HOG_PRIO, 0,
+				  K_FOREVER);
+	victim_tid = k_thread_create(&victim_thread, victim_stack, STACK_SIZE,
+				     victim, NULL, NULL, NULL, VICTIM_PRIO, 0,
+				     K_NO_WAIT);
+
+	zassert_equal(k_thread_cbs_set(hog_tid, 20, 100), 0, NULL);
+	k_thread_start(hog_tid);
+
+	k_sleep(500);
+
+	/** TESTPOINT: the lower priority thread got some CPU time */
+	zassert_true(victim_count > 0, "server not throttled");
+
+	/** TESTPOINT: turning the server off lets the hog take over */
+	zassert_equal(k_thread_cbs_set(hog_tid, 0, 0), 0, NULL);
+	k_sleep(10);
+	victim_count = 0;
+	k_sleep(200);
+	zassert_equal(victim_count, 0, "thread still throttled");
+
+	k_thread_abort(hog_tid);
+	k_thread_abort(victim_tid);
+}
+
+/**
+ * @brief Test the admission control of servers
+ */
+void test_cbs_admission(void)
+{
+	k_tid_t tid = k_thread_create(&hog_thread, hog_stack, STACK_SIZE,
+				      hog, NULL, NULL, NULL, HOG_PRIO, 0,
+				      K_FOREVER);
+	k_tid_t tid2 = k_thread_create(&victim_thread, victim_stack,
+				       STACK_SIZE, victim, NULL, NULL, NULL,
+				       HOG_PRIO, 0, K_FOREVER);
+
+	/** TESTPOINT: invalid parameters */
+	zassert_equal(k_thread_cbs_set(tid, 200, 100), -EINVAL, NULL);
+
+	/** TESTPOINT: a set of servers over the limit is rejected */
+	zassert_equal(k_thread_cbs_set(tid, 60, 100), 0, NULL);
+	zassert_equal(k_thread_cbs_set(tid2, 60, 100), -EBUSY, NULL);
+
+	/** TESTPOINT: changing a server accounts its previous bandwidth */
+	zassert_equal(k_thread_cbs_set(tid, 30, 100), 0, NULL);
+	zassert_equal(k_thread_cbs_set(tid2, 60, 100), 0, NULL);
+
+	/** TESTPOINT: aborting a server releases its bandwidth */
+	k_thread_abort(tid2);
+	zassert_equal(k_thread_cbs_set(tid, 90, 100), 0, NULL);
+
+	k_thread_abort(tid);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sched_cbs,
+			 ztest_unit_test(test_cbs_throttle),
+			 ztest_unit_test(test_cbs_admission));
+	ztest_run_test_suite(sched_cbs);
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <debug/sched_trace.h>
+
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+#define NUM_EVENTS 16
+
+K_THREAD_STACK_DEFINE(helper_stack, STACK_SIZE);
+static struct k_thread helper_thread;
+static K_SEM_DEFINE(helper_sem, 0, 1);
+
+static u32_t packet[(sizeof(struct sched_trace_packet_header) +
+		     NUM_EVENTS * sizeof(struct sched_trace_event)) /
+		    sizeof(u32_t)];
+
+static void helper(void *p1, void *p2, void *p3)
+{
+	k_sem_give(&helper_sem);
+}
+
+static void drain_all(void)
+{
+	while (sched_trace_drain(packet, sizeof(packet))) {
+	}
+}
+
+/* look for one event in the trace, checking packets along the way */
+static int trace_has(u16_t id, u32_t arg)
+{
+	struct sched_trace_packet_header *hdr = (void *)packet;
+	struct sched_trace_event *events = (void *)(hdr + 1);
+	int found = 0;
+	size_t len;
+	int i;
+
+	while ((len = sched_trace_drain(packet, sizeof(packet)))) {
+		zassert_equal(hdr->magic, SCHED_TRACE_PACKET_MAGIC, NULL);
+		zassert_true(hdr->cpu < CONFIG_MP_NUM_CPUS, NULL);
+		zassert_true(hdr->count <= NUM_EVENTS, NULL);
+		zassert_equal(len, sizeof(*hdr) +
+			      hdr->count * sizeof(*events), NULL);
+
+		for (i = 0; i < hdr->count; i++) {
+			if (events[i].id == id && events[i].arg == arg) {
+				found = 1;
+			}
+		}
+	}
+
+	return found;
+}
+
+/**
+ * @brief Test that pending on a semaphore and being given it is traced
+ */
+void test_trace_pend_switch(void)
+{
+	u32_t self = (u32_t)(uintptr_t)k_current_get();
+
+	drain_all();
+
+	k_thread_create(&helper_thread, helper_stack, STACK_SIZE,
+			helper, NULL, NULL, NULL,
+			k_thread_priority_get(k_current_get()) + 1, 0,
+			K_NO_WAIT);
+
+	k_sem_take(&helper_sem, K_FOREVER);
+
+	zassert_true(trace_has(SCHED_TRACE_PEND, self), "pend not traced");
+}
+
+/**
+ * @brief Test that an expired sleep timeout is traced
+ */
+void test_trace_timeout(void)
+{
+	u32_t timeout = (u32_t)(uintptr_t)&k_current_get()->base.timeout;
+
+	drain_all();
+
+	k_sleep(10);
+
+	zassert_true(trace_has(SCHED_TRACE_TIMEOUT, timeout),
+		     "timeout not traced");
+}
+
+/**
+ * @brief Test that a full buffer drops and counts new events
+ */
+void test_trace_dropped(void)
+{
+	struct sched_trace_packet_header *hdr = (void *)packet;
+	int i;
+
+	drain_all();
+
+	for (i = 0; i < CONFIG_SCHED_TRACE_BUFFER_EVENTS + 4; i++) {
+		_sched_trace_event(0xffff, i, 0);
+	}
+
+	zassert_true(sched_trace_drain(packet, sizeof(packet)) > 0, NULL);
+	zassert_true(hdr->dropped >= 4, "dropped events not counted");
+
+	drain_all();
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sched_trace,
+			 ztest_unit_test(test_trace_pend_switch),
+			 ztest_unit_test(test_trace_timeout),
+			 ztest_unit_test(test_trace_dropped));
+	ztest_run_test_suite(sched_trace);
+}
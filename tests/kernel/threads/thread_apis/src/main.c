@@ -28,6 +28,7 @@ extern void test_abort_handler(void);
 extern void test_essential_thread_operation(void);
 extern void test_threads_priority_set(void);
 extern void test_delayed_thread_abort(void);
+extern void test_threads_runtime_stats(void);
 
 __kernel struct k_thread tdata;
 #define STACK_SIZE (256 + CONFIG_TEST_EXTRA_STACKSIZE)
@@ -131,6 +132,7 @@ void test_main(void)
 			 ztest_unit_test(test_threads_abort_repeat),
 			 ztest_unit_test(test_abort_handler),
 			 ztest_unit_test(test_delayed_thread_abort),
+			 ztest_unit_test(test_threads_runtime_stats),
 			 ztest_unit_test(test_essential_thread_operation),
 			 ztest_unit_test(test_systhreads_main),
 			 ztest_unit_test(test_systhreads_idle),
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define STACK_SIZE (256 + CONFIG_TEST_EXTRA_STACKSIZE)
+K_THREAD_STACK_EXTERN(tstack);
+extern struct k_thread tdata;
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+static void thread_entry(void *p1, void *p2, void *p3)
+{
+	/* run for a while, then yield the CPU once before exiting */
+	k_busy_wait(10000);
+	k_sleep(10);
+	k_busy_wait(10000);
+}
+
+/**
+ * @ingroup kernel_thread_tests
+ * @brief Check the runtime statistics of a thread
+ *
+ * @see k_thread_runtime_stats_get()
+ */
+void test_threads_runtime_stats(void)
+{
+	struct k_thread_runtime_stats stats;
+	u32_t hist_total = 0;
+	int i;
+
+	k_tid_t tid = k_thread_create(&tdata, tstack, STACK_SIZE,
+				      thread_entry, NULL, NULL, NULL,
+				      K_PRIO_PREEMPT(0), 0, 0);
+
+	k_sleep(100);
+
+	zassert_equal(k_thread_runtime_stats_get(tid, &stats), 0, NULL);
+
+	/** TESTPOINT: the thread ran twice, for at least its busy waits */
+	zassert_true(stats.switch_count >= 2, NULL);
+	zassert_true(stats.execution_cycles >=
+		     2 * 10000ULL * (sys_clock_hw_cycles_per_sec / 1000000),
+		     NULL);
+
+	/** TESTPOINT: each run is counted in the latency histogram */
+	for (i = 0; i < CONFIG_THREAD_RUNTIME_STATS_HIST_BUCKETS; i++) {
+		hist_total += stats.ready_latency_hist[i];
+	}
+	zassert_equal(hist_total, stats.switch_count, NULL);
+
+	/** TESTPOINT: the running thread accounts its current run */
+	zassert_equal(k_thread_runtime_stats_get(k_current_get(), &stats),
+		      0, NULL);
+	zassert_true(stats.execution_cycles > 0, NULL);
+
+	zassert_equal(k_thread_runtime_stats_get(NULL, &stats), -EINVAL, NULL);
+}
+#else
+void test_threads_runtime_stats(void)
+{
+	ztest_test_skip();
+}
+#endif
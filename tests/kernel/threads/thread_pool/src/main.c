@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE 1024
+#define NUM_WORKERS 2
+#define POOL_PRIO K_PRIO_PREEMPT(1)
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, NUM_WORKERS, STACK_SIZE);
+static struct k_thread_pool_worker workers[NUM_WORKERS];
+static struct k_thread_pool pool;
+
+static K_SEM_DEFINE(unblock_sema, 0, NUM_WORKERS);
+static K_SEM_DEFINE(sync_sema, 0, NUM_WORKERS);
+static k_tid_t ran_in[NUM_WORKERS];
+
+static void task(void *p1, void *p2, void *p3)
+{
+	int idx = POINTER_TO_INT(p1);
+
+	ARG_UNUSED(p3);
+
+	ran_in[idx] = k_current_get();
+	k_sem_give(&sync_sema);
+
+	if (p2) {
+		k_sem_take(&unblock_sema, K_FOREVER);
+	}
+}
+
+/**
+ * @brief Test that a dispatched function runs in a worker
+ * @see k_thread_pool_init(), k_thread_pool_dispatch()
+ */
+void test_thread_pool_dispatch(void)
+{
+	int i;
+
+	k_thread_pool_init(&pool, POOL_PRIO);
+	for (i = 0; i < NUM_WORKERS; i++) {
+		k_thread_pool_add_worker(&pool, &workers[i], worker_stacks[i],
+					 STACK_SIZE);
+	}
+
+	/* let the workers park themselves */
+	k_sleep(TIMEOUT >> 1);
+
+	zassert_equal(k_thread_pool_dispatch(&pool, task, INT_TO_POINTER(0),
+					     NULL, NULL, K_NO_WAIT), 0, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	zassert_not_equal(ran_in[0], k_current_get(), NULL);
+}
+
+/**
+ * @brief Test that dispatching waits for an idle worker
+ * @see k_thread_pool_dispatch()
+ */
+void test_thread_pool_busy(void)
+{
+	int i;
+
+	/* keep all the workers busy */
+	for (i = 0; i < NUM_WORKERS; i++) {
+		zassert_equal(k_thread_pool_dispatch(&pool, task,
+						     INT_TO_POINTER(i),
+						     INT_TO_POINTER(1), NULL,
+						     TIMEOUT), 0, NULL);
+		zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	}
+
+	zassert_not_equal(ran_in[0], ran_in[1], NULL);
+	zassert_equal(k_thread_pool_dispatch(&pool, task, INT_TO_POINTER(0),
+					     NULL, NULL, TIMEOUT), -EAGAIN,
+		      NULL);
+
+	/* the workers go back to the pool when their function returns */
+	for (i = 0; i < NUM_WORKERS; i++) {
+		k_sem_give(&unblock_sema);
+	}
+
+	zassert_equal(k_thread_pool_dispatch(&pool, task, INT_TO_POINTER(0),
+					     NULL, NULL, TIMEOUT), 0, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(thread_pool,
+			 ztest_unit_test(test_thread_pool_dispatch),
+			 ztest_unit_test(test_thread_pool_busy));
+	ztest_run_test_suite(thread_pool);
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define TIMEOUT 100
+#define STACK_SIZE 1024
+#define WORK_PRIO K_PRIO_PREEMPT(1)
+
+static K_THREAD_STACK_DEFINE(pool_stack, STACK_SIZE);
+static K_THREAD_STACK_DEFINE(worker_stack, STACK_SIZE);
+static struct k_thread worker_thread;
+static struct k_work_pool pool;
+
+static struct k_work blocker, low, high;
+static K_SEM_DEFINE(unblock_sema, 0, 1);
+static K_SEM_DEFINE(sync_sema, 0, 3);
+static struct k_work *order[2];
+static int order_idx;
+
+static void blocker_handler(struct k_work *w)
+{
+	k_sem_take(&unblock_sema, K_FOREVER);
+	k_sem_give(&sync_sema);
+}
+
+static void record_handler(struct k_work *w)
+{
+	order[order_idx++] = w;
+	k_sem_give(&sync_sema);
+}
+
+/**
+ * @brief Test that a work pool runs submitted work items
+ * @see k_work_pool_start(), k_work_submit_to_queue()
+ */
+void test_work_pool_submit(void)
+{
+	struct k_work_pool_stats stats;
+
+	k_work_pool_start(&pool, pool_stack, STACK_SIZE, WORK_PRIO);
+
+	k_work_init(&low, record_handler);
+	k_work_submit_to_queue(&pool.work_q, &low);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	/* let the worker account for the item */
+	k_sleep(TIMEOUT >> 1);
+
+	k_work_pool_stats_get(&pool, &stats);
+	zassert_equal(stats.workers, 1, NULL);
+	zassert_equal(stats.executed, 1, NULL);
+	order_idx = 0;
+}
+
+/**
+ * @brief Test that urgent items run first
+ * @see k_work_pool_submit()
+ */
+void test_work_pool_priority(void)
+{
+	struct k_work_pool_stats stats;
+
+	/* keep the single worker busy while queueing */
+	k_work_init(&blocker, blocker_handler);
+	k_work_init(&low, record_handler);
+	k_work_init(&high, record_handler);
+	k_work_pool_submit(&pool, &blocker, 0);
+	k_sleep(TIMEOUT >> 1);
+
+	k_work_pool_submit(&pool, &low, K_WORK_POOL_PRIO_DEFAULT);
+	k_work_pool_submit(&pool, &high, 0);
+
+	k_work_pool_stats_get(&pool, &stats);
+	zassert_equal(stats.busy, 1, NULL);
+	zassert_equal(stats.pending[0], 1, NULL);
+	zassert_equal(stats.pending[K_WORK_POOL_PRIO_DEFAULT], 1, NULL);
+
+	k_sem_give(&unblock_sema);
+	for (int i = 0; i < 3; i++) {
+		zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	}
+	zassert_equal(order[0], &high, NULL);
+	zassert_equal(order[1], &low, NULL);
+	order_idx = 0;
+}
+
+/**
+ * @brief Test that a blocked item does not hold up the other workers
+ * @see k_work_pool_add_worker()
+ */
+void test_work_pool_workers(void)
+{
+	struct k_work_pool_stats stats;
+
+	k_work_pool_add_worker(&pool, &worker_thread, worker_stack,
+			       STACK_SIZE, -1);
+
+	k_work_pool_submit(&pool, &blocker, 0);
+	k_sleep(TIMEOUT >> 1);
+	k_work_pool_submit(&pool, &low, K_WORK_POOL_PRIO_DEFAULT);
+
+	/* served by the second worker */
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	zassert_equal(order[0], &low, NULL);
+
+	k_sem_give(&unblock_sema);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), 0, NULL);
+	/* let the worker account for the item */
+	k_sleep(TIMEOUT >> 1);
+
+	k_work_pool_stats_get(&pool, &stats);
+	zassert_equal(stats.workers, 2, NULL);
+	zassert_equal(stats.busy, 0, NULL);
+	zassert_equal(stats.executed, 6, NULL);
+	zassert_true(stats.latency_max >= stats.latency_avg, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(work_pool,
+			 ztest_unit_test(test_work_pool_submit),
+			 ztest_unit_test(test_work_pool_priority),
+			 ztest_unit_test(test_work_pool_workers));
+	ztest_run_test_suite(work_pool);
+}
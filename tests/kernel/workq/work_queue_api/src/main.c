@@ -25,6 +25,9 @@ static struct k_work work[NUM_OF_WORK];
 static struct k_delayed_work new_work;
 static struct k_delayed_work delayed_work[NUM_OF_WORK], delayed_work_sleepy;
 static struct k_sem sync_sema;
+static struct k_sem block_sema;
+static struct k_work blocker_work;
+static bool cancelled_work_ran;
 
 static void work_sleepy(struct k_work *w)
 {
@@ -42,6 +45,17 @@ static void new_work_handler(struct k_work *w)
 	k_sem_give(&sync_sema);
 }
 
+static void blocker_handler(struct k_work *w)
+{
+	k_sem_take(&block_sema, K_FOREVER);
+	k_sem_give(&sync_sema);
+}
+
+static void cancelled_handler(struct k_work *w)
+{
+	cancelled_work_ran = true;
+}
+
 static void twork_submit(void *data)
 {
 	struct k_work_q *work_q = (struct k_work_q *)data;
@@ -408,6 +422,39 @@ void test_delayed_work_cancel_isr(void)
 	}
 }
 
+/**
+ * @ingroup kernel_workqueue_tests
+ *
+ * Cancel a delayed work item submitted while the workqueue thread is busy,
+ * which CONFIG_QUEUE_LOCKLESS_APPEND leaves in the queue's inbox.
+ *
+ * @see k_delayed_work_cancel(), k_queue_remove()
+ */
+void test_delayed_work_cancel_busy_queue(void)
+{
+	k_sem_reset(&sync_sema);
+	k_sem_init(&block_sema, 0, 1);
+	cancelled_work_ran = false;
+
+	/* keep the workqueue thread busy, not waiting on its queue */
+	k_work_init(&blocker_work, blocker_handler);
+	k_work_submit_to_queue(&workq, &blocker_work);
+	k_sleep(TIMEOUT);
+
+	k_delayed_work_init(&new_work, cancelled_handler);
+	zassert_equal(k_delayed_work_submit_to_queue(&workq, &new_work, 0), 0,
+		      NULL);
+	zassert_true(k_work_pending(&new_work.work), NULL);
+
+	/**TESTPOINT: a queued work item can be cancelled*/
+	zassert_equal(k_delayed_work_cancel(&new_work), 0, NULL);
+	zassert_false(k_work_pending(&new_work.work), NULL);
+
+	k_sem_give(&block_sema);
+	k_sem_take(&sync_sema, K_FOREVER);
+	k_sleep(TIMEOUT);
+	zassert_false(cancelled_work_ran, NULL);
+}
 
 void test_main(void)
 {
@@ -426,6 +473,7 @@ void test_main(void)
 			 ztest_unit_test(test_delayed_work_cancel_from_queue_thread),
 			 ztest_unit_test(test_delayed_work_cancel_from_queue_isr),
 			 ztest_unit_test(test_delayed_work_cancel_thread),
-			 ztest_unit_test(test_delayed_work_cancel_isr));
+			 ztest_unit_test(test_delayed_work_cancel_isr),
+			 ztest_unit_test(test_delayed_work_cancel_busy_queue));
 	ztest_run_test_suite(workqueue_api);
 }
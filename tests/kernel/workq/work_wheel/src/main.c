@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define TIMEOUT 100
+#define NUM_OF_WORK 4
+
+static struct k_wheel_work work[NUM_OF_WORK];
+static K_SEM_DEFINE(sync_sema, 0, NUM_OF_WORK);
+static struct k_wheel_work *order[NUM_OF_WORK];
+static int order_idx;
+
+static void work_handler(struct k_work *w)
+{
+	order[order_idx++] = CONTAINER_OF(w, struct k_wheel_work, work);
+	k_sem_give(&sync_sema);
+}
+
+static void work_reset(void)
+{
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		k_wheel_work_init(&work[i], work_handler);
+	}
+	order_idx = 0;
+	k_sem_reset(&sync_sema);
+}
+
+/**
+ * @brief Test that wheel work items run in expiry order
+ * @see k_wheel_work_submit()
+ */
+void test_wheel_work_submit(void)
+{
+	work_reset();
+
+	zassert_equal(k_wheel_work_submit(&work[0], TIMEOUT * 3), 0, NULL);
+	zassert_equal(k_wheel_work_submit(&work[1], TIMEOUT), 0, NULL);
+	zassert_equal(k_wheel_work_submit(&work[2], 0), 0, NULL);
+	/* more than one turn of the wheel away */
+	zassert_equal(k_wheel_work_submit(&work[3], TIMEOUT * 5), 0, NULL);
+	zassert_true(k_wheel_work_remaining_get(&work[1]) <= TIMEOUT, NULL);
+	zassert_true(k_wheel_work_remaining_get(&work[1]) > 0, NULL);
+
+	for (int i = 0; i < NUM_OF_WORK; i++) {
+		zassert_equal(k_sem_take(&sync_sema, TIMEOUT * 6), 0, NULL);
+	}
+	zassert_equal(order[0], &work[2], NULL);
+	zassert_equal(order[1], &work[1], NULL);
+	zassert_equal(order[2], &work[0], NULL);
+	zassert_equal(order[3], &work[3], NULL);
+	zassert_equal(k_wheel_work_remaining_get(&work[3]), 0, NULL);
+}
+
+/**
+ * @brief Test rescheduling wheel work items
+ * @see k_wheel_work_submit()
+ */
+void test_wheel_work_resubmit(void)
+{
+	work_reset();
+
+	/* keep postponing: must not run */
+	zassert_equal(k_wheel_work_submit(&work[0], TIMEOUT), 0, NULL);
+	for (int i = 0; i < 5; i++) {
+		k_sleep(TIMEOUT >> 1);
+		zassert_equal(k_wheel_work_submit(&work[0], TIMEOUT), 0, NULL);
+	}
+	zassert_equal(order_idx, 0, NULL);
+
+	/* bring forward */
+	zassert_equal(k_wheel_work_submit(&work[0], TIMEOUT >> 2), 0, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT >> 1), 0, NULL);
+	zassert_equal(order[0], &work[0], NULL);
+}
+
+/**
+ * @brief Test cancelling wheel work items
+ * @see k_wheel_work_cancel()
+ */
+void test_wheel_work_cancel(void)
+{
+	work_reset();
+
+	zassert_equal(k_wheel_work_cancel(&work[0]), -EINVAL, NULL);
+	zassert_equal(k_wheel_work_submit(&work[0], TIMEOUT), 0, NULL);
+	zassert_equal(k_wheel_work_submit(&work[1], TIMEOUT), 0, NULL);
+	zassert_equal(k_wheel_work_cancel(&work[0]), 0, NULL);
+	zassert_equal(k_wheel_work_remaining_get(&work[0]), 0, NULL);
+
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT * 2), 0, NULL);
+	zassert_equal(k_sem_take(&sync_sema, TIMEOUT), -EAGAIN, NULL);
+	zassert_equal(order[0], &work[1], NULL);
+	zassert_equal(k_wheel_work_cancel(&work[1]), -EINVAL, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(work_wheel,
+			 ztest_unit_test(test_wheel_work_submit),
+			 ztest_unit_test(test_wheel_work_resubmit),
+			 ztest_unit_test(test_wheel_work_cancel));
+	ztest_run_test_suite(work_wheel);
+}
@@ -65,10 +65,55 @@ static void test_base64_codec(void)
 	zassert_equal(rc, 0, "Decode test comparison");
 }
 
+static void test_base64_codec_incremental(void)
+{
+	struct base64_encoder enc;
+	struct base64_decoder dec;
+	size_t len, total, i;
+	int rc;
+	unsigned char buffer[128];
+
+	/* Uneven chunks, which split triplets and quartets */
+	base64_encoder_init(&enc);
+	for (i = 0, total = 0; i < 64; i += 5) {
+		rc = base64_encode_update(&enc, buffer + total,
+					  sizeof(buffer) - total, &len,
+					  base64_test_dec + i, min(5, 64 - i));
+		zassert_equal(rc, 0, "Encode update return value");
+		total += len;
+	}
+
+	rc = base64_encode_finish(&enc, buffer + total,
+				  sizeof(buffer) - total, &len);
+	zassert_equal(rc, 0, "Encode finish return value");
+	total += len;
+
+	zassert_equal(total, 88, "Encode test length");
+	rc = memcmp(base64_test_enc, buffer, 88);
+	zassert_equal(rc, 0, "Encode test comparison");
+
+	base64_decoder_init(&dec);
+	for (i = 0, total = 0; i < 88; i += 7) {
+		rc = base64_decode_update(&dec, buffer + total,
+					  sizeof(buffer) - total, &len,
+					  base64_test_enc + i, min(7, 88 - i));
+		zassert_equal(rc, 0, "Decode update return value");
+		total += len;
+	}
+
+	rc = base64_decode_finish(&dec);
+	zassert_equal(rc, 0, "Decode finish return value");
+
+	zassert_equal(total, 64, "Decode test length");
+	rc = memcmp(base64_test_dec, buffer, 64);
+	zassert_equal(rc, 0, "Decode test comparison");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_base64_test,
-			 ztest_unit_test(test_base64_codec));
+			 ztest_unit_test(test_base64_codec),
+			 ztest_unit_test(test_base64_codec_incremental));
 
 	ztest_run_test_suite(lib_base64_test);
 }
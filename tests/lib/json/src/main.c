@@ -129,6 +129,47 @@ static void test_json_encoding(void)
 	zassert_equal(ret, 0, "Encoded contents consistent");
 }
 
+struct chunk_output {
+	char buffer[64];
+	size_t used;
+	int calls;
+};
+
+static int append_chunk(const char *bytes, size_t len, void *data)
+{
+	struct chunk_output *out = data;
+
+	if (len >= sizeof(out->buffer) - out->used) {
+		return -ENOMEM;
+	}
+
+	memcpy(out->buffer + out->used, bytes, len);
+	out->used += len;
+	out->buffer[out->used] = '\0';
+	out->calls++;
+
+	return 0;
+}
+
+static void test_json_encoding_chunked(void)
+{
+	struct elt elt = {
+		.name = "\"Quoted\"",
+		.height = 123,
+	};
+	char encoded[] = "{\"name\":\"\\\"Quoted\\\"\",\"height\":123}";
+	struct chunk_output out = { .used = 0 };
+	int ret;
+
+	ret = json_obj_encode(elt_descr, ARRAY_SIZE(elt_descr), &elt,
+			      append_chunk, &out);
+	zassert_equal(ret, 0, "Encoding function returned no errors");
+
+	zassert_equal(strcmp(out.buffer, encoded), 0,
+		      "Encoded contents consistent");
+	zassert_equal(out.calls, 1, "Output handed over in a single chunk");
+}
+
 static void test_json_decoding(void)
 {
 	struct test_struct ts;
@@ -367,6 +408,35 @@ static void test_json_key_not_in_descr(void)
 	zassert_equal(ret, 0, "No items should be decoded");
 }
 
+static void test_json_keys_out_of_order(void)
+{
+	struct elt elt;
+	char encoded[] = "{\"height\":176,\"name\":\"Sam\"}";
+	int ret;
+
+	ret = json_obj_parse(encoded, sizeof(encoded) - 1, elt_descr,
+			     ARRAY_SIZE(elt_descr), &elt);
+	zassert_equal(ret, (1 << ARRAY_SIZE(elt_descr)) - 1,
+		      "All fields decoded correctly");
+	zassert_equal(elt.height, 176, "Integer decoded correctly");
+	zassert_true(!strcmp(elt.name, "Sam"), "String decoded correctly");
+}
+
+static void test_json_trailing_key_not_in_descr(void)
+{
+	struct elt elt;
+	char encoded[] = "{\"name\":\"Sam\",\"height\":176,"
+		"\"weight\":80}";
+	int ret;
+
+	ret = json_obj_parse(encoded, sizeof(encoded) - 1, elt_descr,
+			     ARRAY_SIZE(elt_descr), &elt);
+	zassert_equal(ret, (1 << ARRAY_SIZE(elt_descr)) - 1,
+		      "Unknown key after the last field ignored");
+	zassert_equal(elt.height, 176, "Integer decoded correctly");
+	zassert_true(!strcmp(elt.name, "Sam"), "String decoded correctly");
+}
+
 static void test_json_escape(void)
 {
 	char buf[42];
@@ -456,6 +526,7 @@ void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
 			 ztest_unit_test(test_json_encoding),
+			 ztest_unit_test(test_json_encoding_chunked),
 			 ztest_unit_test(test_json_decoding),
 			 ztest_unit_test(test_json_obj_arr_encoding),
 			 ztest_unit_test(test_json_obj_arr_decoding),
@@ -464,6 +535,8 @@ void test_main(void)
 			 ztest_unit_test(test_json_wrong_token),
 			 ztest_unit_test(test_json_item_wrong_type),
 			 ztest_unit_test(test_json_key_not_in_descr),
+			 ztest_unit_test(test_json_keys_out_of_order),
+			 ztest_unit_test(test_json_trailing_key_not_in_descr),
 			 ztest_unit_test(test_json_escape),
 			 ztest_unit_test(test_json_escape_one),
 			 ztest_unit_test(test_json_escape_empty),
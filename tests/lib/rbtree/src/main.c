@@ -129,24 +129,41 @@ void check_rb(void)
 	check_rbnode(tree.root, 0);
 }
 
+enum walk_mode {
+	WALK_RECURSIVE,
+	WALK_FOREACH,
+	WALK_NEXT,
+};
+
 /* First validates the external API behavior via a walk, then checks
  * interior tree and red/black state via internal APIs.
  */
-void _check_tree(int size, int use_foreach)
+void _check_tree(int size, enum walk_mode mode)
 {
 	int nwalked = 0, i, ni;
 	struct rbnode *n, *last = NULL;
 
 	memset(walked_nodes, 0, sizeof(walked_nodes));
 
-	if (use_foreach) {
+	switch (mode) {
+	case WALK_RECURSIVE:
+		rb_walk(&tree, visit_node, &nwalked);
+		break;
+	case WALK_FOREACH:
 		RB_FOR_EACH(&tree, n) {
 			visit_node(n, &nwalked);
 		}
-	} else {
-		rb_walk(&tree, visit_node, &nwalked);
+		break;
+	case WALK_NEXT:
+		for (n = rb_get_min(&tree); n; n = rb_next(&tree, n)) {
+			visit_node(n, &nwalked);
+		}
+		break;
 	}
 
+	/* The cached minimum is the first node walked */
+	CHECK(rb_get_min(&tree) == (nwalked ? walked_nodes[0] : NULL));
+
 	/* Make sure all found nodes are in-order and marked in the tree */
 	for (i = 0; i < nwalked; i++) {
 		n = walked_nodes[i];
@@ -181,9 +198,10 @@ void _check_tree(int size, int use_foreach)
 
 void check_tree(int size)
 {
-	/* Do it with both enumeration mechanisms */
-	_check_tree(size, 0);
-	_check_tree(size, 1);
+	/* Do it with all the enumeration mechanisms */
+	_check_tree(size, WALK_RECURSIVE);
+	_check_tree(size, WALK_FOREACH);
+	_check_tree(size, WALK_NEXT);
 }
 
 void checked_insert(struct rbtree *tree, struct rbnode *node)
@@ -32,6 +32,14 @@
  *   -# sys_ring_buf_space_get
  *   -# sys_ring_buf_put
  *   -# sys_ring_buf_get
+ *   -# SYS_RING_BUF_BYTES_DECLARE_POW2
+ *   -# sys_ring_buf_bytes_init
+ *   -# sys_ring_buf_bytes_put
+ *   -# sys_ring_buf_bytes_get
+ *   -# sys_ring_buf_bytes_put_claim
+ *   -# sys_ring_buf_bytes_put_finish
+ *   -# sys_ring_buf_bytes_get_claim
+ *   -# sys_ring_buf_bytes_get_finish
  * @}
  */
 
@@ -227,6 +235,111 @@ void test_ringbuffer_size_put_get_thread_isr(void)
 	irq_offload(tringbuf_get, (void *)2);
 }
 
+SYS_RING_BUF_BYTES_DECLARE_POW2(ringbuf_bytes, 4);
+
+static const u8_t byte_data[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+void test_ringbuffer_bytes_put_get(void)
+{
+	struct ring_buf_bytes *rb = &ringbuf_bytes;
+	u8_t rx_data[sizeof(byte_data)];
+	u32_t len;
+	int i;
+
+	zassert_true(sys_ring_buf_bytes_is_empty(rb), NULL);
+	zassert_equal(sys_ring_buf_bytes_space_get(rb), 16, NULL);
+
+	/* move the indexes around the end of the buffer a few times */
+	for (i = 0; i < 8; i++) {
+		len = sys_ring_buf_bytes_put(rb, byte_data, 11);
+		zassert_equal(len, 11, NULL);
+		zassert_equal(sys_ring_buf_bytes_used_get(rb), 11, NULL);
+
+		len = sys_ring_buf_bytes_get(rb, rx_data, sizeof(rx_data));
+		zassert_equal(len, 11, NULL);
+		zassert_equal(memcmp(rx_data, byte_data, len), 0, NULL);
+		zassert_true(sys_ring_buf_bytes_is_empty(rb), NULL);
+	}
+
+	/* a full buffer takes no more bytes */
+	len = sys_ring_buf_bytes_put(rb, byte_data, sizeof(byte_data));
+	zassert_equal(len, 16, NULL);
+	zassert_equal(sys_ring_buf_bytes_space_get(rb), 0, NULL);
+	zassert_equal(sys_ring_buf_bytes_put(rb, byte_data, 1), 0, NULL);
+
+	len = sys_ring_buf_bytes_get(rb, rx_data, sizeof(rx_data));
+	zassert_equal(len, 16, NULL);
+	zassert_equal(memcmp(rx_data, byte_data, len), 0, NULL);
+	zassert_equal(sys_ring_buf_bytes_get(rb, rx_data, 1), 0, NULL);
+}
+
+void test_ringbuffer_bytes_claim_finish(void)
+{
+	static u8_t buffer_bytes[8];
+	struct ring_buf_bytes rb;
+	u8_t *data;
+	u32_t len;
+
+	sys_ring_buf_bytes_init(&rb, sizeof(buffer_bytes), buffer_bytes);
+
+	len = sys_ring_buf_bytes_put(&rb, byte_data, 6);
+	zassert_equal(len, 6, NULL);
+	len = sys_ring_buf_bytes_get_claim(&rb, &data, 4);
+	zassert_equal(len, 4, NULL);
+	zassert_equal(memcmp(data, byte_data, len), 0, NULL);
+	zassert_equal(sys_ring_buf_bytes_get_finish(&rb, len), 0, NULL);
+
+	/* the free space wraps: only the span up to the end is claimed */
+	len = sys_ring_buf_bytes_put_claim(&rb, &data, 6);
+	zassert_equal(len, 2, NULL);
+	zassert_equal(data, &buffer_bytes[6], NULL);
+	memcpy(data, &byte_data[6], len);
+	zassert_equal(sys_ring_buf_bytes_put_finish(&rb, len), 0, NULL);
+
+	len = sys_ring_buf_bytes_put_claim(&rb, &data, 6);
+	zassert_equal(len, 4, NULL);
+	zassert_equal(data, buffer_bytes, NULL);
+	memcpy(data, &byte_data[8], len);
+	zassert_equal(sys_ring_buf_bytes_put_finish(&rb, len), 0, NULL);
+
+	/* committing more than the free space is refused */
+	zassert_equal(sys_ring_buf_bytes_put_finish(&rb, 1), -EINVAL, NULL);
+	zassert_equal(sys_ring_buf_bytes_space_get(&rb), 0, NULL);
+
+	len = sys_ring_buf_bytes_get_claim(&rb, &data, 8);
+	zassert_equal(len, 4, NULL);
+	zassert_equal(memcmp(data, &byte_data[4], len), 0, NULL);
+	zassert_equal(sys_ring_buf_bytes_get_finish(&rb, len), 0, NULL);
+
+	len = sys_ring_buf_bytes_get_claim(&rb, &data, 8);
+	zassert_equal(len, 4, NULL);
+	zassert_equal(memcmp(data, &byte_data[8], len), 0, NULL);
+	zassert_equal(sys_ring_buf_bytes_get_finish(&rb, 5), -EINVAL, NULL);
+	zassert_equal(sys_ring_buf_bytes_get_finish(&rb, len), 0, NULL);
+	zassert_true(sys_ring_buf_bytes_is_empty(&rb), NULL);
+}
+
+static void tringbuf_bytes_put(void *p)
+{
+	u32_t len = sys_ring_buf_bytes_put(&ringbuf_bytes, byte_data,
+					   POINTER_TO_INT(p));
+
+	zassert_equal(len, POINTER_TO_INT(p), NULL);
+}
+
+void test_ringbuffer_bytes_isr_producer(void)
+{
+	u8_t rx_data[sizeof(byte_data)];
+	int i;
+
+	for (i = 1; i < 16; i++) {
+		irq_offload(tringbuf_bytes_put, INT_TO_POINTER(i));
+		zassert_equal(sys_ring_buf_bytes_get(&ringbuf_bytes, rx_data,
+						     sizeof(rx_data)), i, NULL);
+		zassert_equal(memcmp(rx_data, byte_data, i), 0, NULL);
+	}
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -239,6 +352,9 @@ void test_main(void)
 			 ztest_unit_test(test_ringbuffer_put_get_thread_isr),
 			 ztest_unit_test(test_ringbuffer_pow2_put_get_thread_isr),
 			 ztest_unit_test(test_ringbuffer_size_put_get_thread_isr),
-			 ztest_unit_test(test_ring_buffer_main));
+			 ztest_unit_test(test_ring_buffer_main),
+			 ztest_unit_test(test_ringbuffer_bytes_put_get),
+			 ztest_unit_test(test_ringbuffer_bytes_claim_finish),
+			 ztest_unit_test(test_ringbuffer_bytes_isr_producer));
 	ztest_run_test_suite(test_ringbuffer_api);
 }
@@ -510,6 +510,38 @@ void test_sprintf_string(void)
 
 }
 
+/**
+ *
+ * @brief Test the decimal conversion and output longer than a chunk
+ *
+ */
+void test_sprintf_decimal(void)
+{
+	int len;
+	char buffer[100];
+
+	len = sprintf(buffer, "%u %u %u %u %u", 0, 9, 10, 99, 100);
+	zassert_true((len == 13), "sprintf(%%u). Got %d bytes", len);
+	zassert_true((strcmp(buffer, "0 9 10 99 100") == 0),
+		     "sprintf(%%u). Got '%s'", buffer);
+
+	len = sprintf(buffer, "%u|%d|%d", 4294967295u, -2147483647 - 1, 1001);
+	zassert_true((strcmp(buffer, "4294967295|-2147483648|1001") == 0),
+		     "sprintf(%%u). Got '%s'", buffer);
+
+	len = sprintf(buffer, "%.6u|%08d|%-6u|", 1234, -56, 7);
+	zassert_true((strcmp(buffer, "001234|-0000056|7     |") == 0),
+		     "sprintf(%%u) with precision. Got '%s'", buffer);
+
+	/* several chunks, truncated in the middle of one */
+	len = snprintf(buffer, 50, "%s%u%s", "0123456789abcdefghij",
+		       1234567890, "0123456789abcdefghij0123456789");
+	zassert_true((len == 60), "snprintf(). Expected 60, not %d", len);
+	zassert_true((strcmp(buffer, "0123456789abcdefghij1234567890"
+			     "0123456789abcdefghi") == 0),
+		     "snprintf(). Got '%s'", buffer);
+}
+
 /**
  *
  * @brief Test entry point
@@ -525,6 +557,7 @@ void test_main(void)
 			 ztest_unit_test(test_vsprintf),
 			 ztest_unit_test(test_vsnprintf),
 			 ztest_unit_test(test_sprintf_string),
-			 ztest_unit_test(test_sprintf_misc));
+			 ztest_unit_test(test_sprintf_misc),
+			 ztest_unit_test(test_sprintf_decimal));
 	ztest_run_test_suite(test_sprintf);
 }
@@ -942,9 +942,30 @@ void test_loop(void)
 	net_pkt_print();
 }
 
+#if defined(CONFIG_NET_6LO_IPHC_CACHE)
+/* Same packets again, the address compression now comes from the cache */
+void test_loop_cached(void)
+{
+	int count;
+
+	for (count = 0; count < ARRAY_SIZE(tests); count++) {
+		TC_START(tests[count].name);
+
+		test_6lo(tests[count].data);
+	}
+	net_pkt_print();
+}
+#else
+void test_loop_cached(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 /*test case main entry*/
 void test_main(void)
 {
-	ztest_test_suite(test_6lo, ztest_unit_test(test_loop));
+	ztest_test_suite(test_6lo, ztest_unit_test(test_loop),
+			 ztest_unit_test(test_loop_cached));
 	ztest_run_test_suite(test_6lo);
 }
@@ -681,11 +681,217 @@ static void test_send_ipv6_fragment(void)
 	}
 }
 
+#define RECV_REMOTE_PORT 5000
+#define RECV_LOCAL_PORT 6000
+#define RECV_DGRAM_LEN 64
+
+/* UDP header and payload of the datagram that is sent in fragments */
+static u8_t recv_dgram[RECV_DGRAM_LEN];
+static struct k_sem recv_data;
+
+static enum net_verdict udp_recv_dgram(struct net_conn *conn,
+				       struct net_pkt *pkt,
+				       void *user_data)
+{
+	u8_t data[RECV_DGRAM_LEN];
+	int ret;
+
+	DBG("Reassembled pkt %p received\n", pkt);
+
+	zassert_equal(net_pkt_get_len(pkt),
+		      sizeof(struct net_ipv6_hdr) + RECV_DGRAM_LEN,
+		      "Invalid reassembled length");
+
+	ret = net_frag_linearize(data, sizeof(data), pkt,
+				 sizeof(struct net_ipv6_hdr), sizeof(data));
+	zassert_equal(ret, sizeof(data), "Cannot linearize");
+	zassert_equal(memcmp(data, recv_dgram, sizeof(data)), 0,
+		      "Invalid reassembled data");
+
+	net_pkt_unref(pkt);
+
+	k_sem_give(&recv_data);
+
+	return NET_OK;
+}
+
+static u32_t chksum_add(u32_t sum, const u8_t *data, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i += 2) {
+		sum += data[i] << 8;
+		if (i + 1 < len) {
+			sum += data[i + 1];
+		}
+	}
+
+	return sum;
+}
+
+static void test_recv_setup(void)
+{
+	u8_t pseudo[8] = { 0, 0, 0, RECV_DGRAM_LEN, 0, 0, 0, IPPROTO_UDP };
+	struct net_conn_handle *handle;
+	struct sockaddr remote_addr = { 0 };
+	struct sockaddr local_addr = { 0 };
+	u32_t sum;
+	int i, ret;
+
+	k_sem_init(&recv_data, 0, UINT_MAX);
+
+	net_ipaddr_copy(&net_sin6(&local_addr)->sin6_addr, &my_addr1);
+	local_addr.sa_family = AF_INET6;
+
+	net_ipaddr_copy(&net_sin6(&remote_addr)->sin6_addr, &my_addr2);
+	remote_addr.sa_family = AF_INET6;
+
+	ret = net_udp_register(&remote_addr, &local_addr, RECV_REMOTE_PORT,
+			       RECV_LOCAL_PORT, udp_recv_dgram, NULL, &handle);
+	zassert_equal(ret, 0, "Cannot register UDP handler");
+
+	sys_put_be16(RECV_REMOTE_PORT, &recv_dgram[0]);
+	sys_put_be16(RECV_LOCAL_PORT, &recv_dgram[2]);
+	sys_put_be16(RECV_DGRAM_LEN, &recv_dgram[4]);
+
+	for (i = sizeof(struct net_udp_hdr); i < RECV_DGRAM_LEN; i++) {
+		recv_dgram[i] = i;
+	}
+
+	sum = chksum_add(0, my_addr2.s6_addr, sizeof(my_addr2));
+	sum = chksum_add(sum, my_addr1.s6_addr, sizeof(my_addr1));
+	sum = chksum_add(sum, pseudo, sizeof(pseudo));
+	sum = chksum_add(sum, recv_dgram, RECV_DGRAM_LEN);
+
+	while (sum >> 16) {
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	sys_put_be16(~sum, &recv_dgram[6]);
+}
+
+/* Feed one fragment of recv_dgram, with the given fragment id, to iface1
+ * as if it had been received from my_addr2.
+ */
+static void recv_fragment(u32_t id, u16_t offset, u16_t len, bool more)
+{
+	struct net_ipv6_hdr *hdr;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	u8_t *ptr;
+
+	zassert_true(offset + len <= RECV_DGRAM_LEN, "Invalid fragment");
+
+	pkt = net_pkt_get_reserve_rx(0, ALLOC_TIMEOUT);
+	zassert_not_null(pkt, "packet");
+
+	frag = net_pkt_get_frag(pkt, ALLOC_TIMEOUT);
+	zassert_not_null(frag, "fragment");
+
+	net_pkt_frag_add(pkt, frag);
+
+	net_pkt_set_iface(pkt, iface1);
+	net_pkt_set_family(pkt, AF_INET6);
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_ll_clear(pkt);
+
+	hdr = net_buf_add(frag, sizeof(struct net_ipv6_hdr));
+	memset(hdr, 0, sizeof(*hdr));
+	hdr->vtc = 0x60;
+	hdr->len[0] = (sizeof(struct net_ipv6_frag_hdr) + len) >> 8;
+	hdr->len[1] = (sizeof(struct net_ipv6_frag_hdr) + len) & 0xff;
+	hdr->nexthdr = NET_IPV6_NEXTHDR_FRAG;
+	hdr->hop_limit = 64;
+	net_ipaddr_copy(&hdr->src, &my_addr2);
+	net_ipaddr_copy(&hdr->dst, &my_addr1);
+
+	ptr = net_buf_add(frag, sizeof(struct net_ipv6_frag_hdr));
+	ptr[0] = IPPROTO_UDP;
+	ptr[1] = 0;
+	sys_put_be16(offset | more, &ptr[2]);
+	sys_put_be32(id, &ptr[4]);
+
+	net_buf_add_mem(frag, &recv_dgram[offset], len);
+
+	zassert_equal(net_recv_data(iface1, pkt), 0, "Cannot receive");
+}
+
+static void count_reassembly(struct net_ipv6_reassembly *reass,
+			     void *user_data)
+{
+	(*(int *)user_data)++;
+}
+
+static int pending_reassemblies(void)
+{
+	int count = 0;
+
+	net_ipv6_frag_foreach(count_reassembly, &count);
+
+	return count;
+}
+
 static void test_recv_ipv6_fragment(void)
 {
-	/* TODO: Verify that we can receive individual fragments and
-	 * then reassemble them back.
+	recv_fragment(0x1001, 0, 32, true);
+	recv_fragment(0x1001, 32, 32, false);
+
+	zassert_equal(k_sem_take(&recv_data, WAIT_TIME), 0,
+		      "Datagram not reassembled");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly left pending");
+}
+
+static void test_recv_ipv6_fragment_out_of_order(void)
+{
+	/* The last fragment arrives first */
+	recv_fragment(0x1002, 32, 32, false);
+	recv_fragment(0x1002, 0, 32, true);
+
+	zassert_equal(k_sem_take(&recv_data, WAIT_TIME), 0,
+		      "Datagram not reassembled");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly left pending");
+}
+
+static void test_recv_ipv6_fragment_duplicate(void)
+{
+	recv_fragment(0x1003, 0, 32, true);
+	recv_fragment(0x1003, 0, 32, true);
+	recv_fragment(0x1003, 32, 32, false);
+
+	zassert_equal(k_sem_take(&recv_data, WAIT_TIME), 0,
+		      "Datagram not reassembled");
+	zassert_not_equal(k_sem_take(&recv_data, K_MSEC(100)), 0,
+			  "Datagram delivered twice");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly left pending");
+}
+
+static void test_recv_ipv6_fragment_overlap(void)
+{
+	/* The second fragment overlaps the end of the first one, which
+	 * must cancel the whole reassembly.
 	 */
+	recv_fragment(0x1004, 0, 32, true);
+	recv_fragment(0x1004, 24, 40, false);
+
+	zassert_not_equal(k_sem_take(&recv_data, K_MSEC(100)), 0,
+			  "Overlapping fragments reassembled");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly left pending");
+}
+
+static void test_recv_ipv6_fragment_over_limit(void)
+{
+	int i;
+
+	/* One fragment more than a reassembly can hold */
+	for (i = 0; i < NET_IPV6_FRAGMENTS_MAX_PKT; i++) {
+		recv_fragment(0x1005, i * 8, 8, true);
+	}
+
+	recv_fragment(0x1005, i * 8, RECV_DGRAM_LEN - i * 8, false);
+
+	zassert_not_equal(k_sem_take(&recv_data, K_MSEC(100)), 0,
+			  "Too many fragments reassembled");
+	zassert_equal(pending_reassemblies(), 0, "Reassembly left pending");
 }
 
 void test_main(void)
@@ -696,7 +902,12 @@ void test_main(void)
 			 ztest_unit_test(test_find_last_ipv6_fragment_hbho_udp),
 			 ztest_unit_test(test_find_last_ipv6_fragment_hbho_frag),
 			 ztest_unit_test(test_send_ipv6_fragment),
-			 ztest_unit_test(test_recv_ipv6_fragment)
+			 ztest_unit_test(test_recv_setup),
+			 ztest_unit_test(test_recv_ipv6_fragment),
+			 ztest_unit_test(test_recv_ipv6_fragment_out_of_order),
+			 ztest_unit_test(test_recv_ipv6_fragment_duplicate),
+			 ztest_unit_test(test_recv_ipv6_fragment_overlap),
+			 ztest_unit_test(test_recv_ipv6_fragment_over_limit)
 			 );
 
 	ztest_run_test_suite(net_ipv6_fragment_test);
@@ -44,6 +44,25 @@ static struct coap_reply replies[NUM_REPLIES];
 bool _coap_match_path_uri(const char * const *path,
 			  const char *uri, u16_t len);
 
+static const char * const tree_path_a_b[] = { "a", "b", NULL };
+static const char * const tree_path_a_any_c[] = { "a", COAP_RESOURCE_WILDCARD,
+						 "c", NULL };
+static const char * const tree_path_a[] = { "a", NULL };
+static const char * const tree_path_any[] = { COAP_RESOURCE_WILDCARD, NULL };
+static const char * const tree_path_root[] = { NULL };
+
+static int tree_resource_get(struct coap_resource *resource,
+			     struct coap_packet *request);
+
+static struct coap_resource tree_resources[] = {
+	{ .get = tree_resource_get, .path = tree_path_a_b, },
+	{ .get = tree_resource_get, .path = tree_path_a_any_c, },
+	{ .path = tree_path_a, },
+	{ .get = tree_resource_get, .path = tree_path_any, },
+	{ .get = tree_resource_get, .path = tree_path_root, },
+	{ },
+};
+
 /* Some forward declarations */
 static void server_notify_callback(struct coap_resource *resource,
 				   struct coap_observer *observer);
@@ -486,6 +505,102 @@ done:
 	return result;
 }
 
+static int test_find_options(void)
+{
+	/* Observe, Uri-Path "a" "bc", Content-Format 40 and option 100 */
+	u8_t pdu[] = { 0x40, 0x01, 0x12, 0x34,
+		       0x60, 0x51, 'a', 0x02, 'b', 'c', 0x11, 0x28,
+		       0xd1, 0x4b, 'x', 0xff, 'p' };
+	struct coap_packet cpkt;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	struct coap_option options[4] = {};
+	int result = TC_FAIL;
+	int r, count;
+
+	pkt = net_pkt_get_reserve(&coap_pkt_slab, 0, K_NO_WAIT);
+	if (!pkt) {
+		TC_PRINT("Could not get packet from pool\n");
+		goto done;
+	}
+
+	frag = net_buf_alloc(&coap_data_pool, K_NO_WAIT);
+	if (!frag) {
+		TC_PRINT("Could not get buffer from pool\n");
+		goto done;
+	}
+
+	net_pkt_frag_add(pkt, frag);
+
+	net_pkt_append_all(pkt, sizeof(ipv6_simple_pdu),
+			   (u8_t *)ipv6_simple_pdu, K_FOREVER);
+	net_pkt_append_all(pkt, sizeof(pdu), (u8_t *)pdu, K_FOREVER);
+
+	net_pkt_set_ip_hdr_len(pkt, NET_IPV6H_LEN);
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	r = coap_packet_parse(&cpkt, pkt, NULL, 0);
+	if (r) {
+		TC_PRINT("Could not parse packet\n");
+		goto done;
+	}
+
+	count = coap_find_options(&cpkt, COAP_OPTION_URI_PATH, options,
+				  ARRAY_SIZE(options));
+	if (count != 2) {
+		TC_PRINT("Unexpected number of Uri-Path options\n");
+		goto done;
+	}
+
+	if (options[0].len != 1 || memcmp(options[0].value, "a", 1) ||
+	    options[1].len != 2 || memcmp(options[1].value, "bc", 2)) {
+		TC_PRINT("Uri-Path options don't match the reference\n");
+		goto done;
+	}
+
+	count = coap_find_options(&cpkt, COAP_OPTION_URI_PATH, options, 1);
+	if (count != 1) {
+		TC_PRINT("Uri-Path options should be limited to 1\n");
+		goto done;
+	}
+
+	count = coap_find_options(&cpkt, COAP_OPTION_OBSERVE, options,
+				  ARRAY_SIZE(options));
+	if (count != 1 || options[0].len != 0) {
+		TC_PRINT("Observe option doesn't match the reference\n");
+		goto done;
+	}
+
+	count = coap_find_options(&cpkt, COAP_OPTION_CONTENT_FORMAT, options,
+				  ARRAY_SIZE(options));
+	if (count != 1 || coap_option_value_to_int(&options[0]) != 40) {
+		TC_PRINT("Content-Format doesn't match the reference\n");
+		goto done;
+	}
+
+	count = coap_find_options(&cpkt, 100, options, ARRAY_SIZE(options));
+	if (count != 1 || options[0].len != 1 || options[0].value[0] != 'x') {
+		TC_PRINT("Option 100 doesn't match the reference\n");
+		goto done;
+	}
+
+	count = coap_find_options(&cpkt, COAP_OPTION_ETAG, options,
+				  ARRAY_SIZE(options));
+	if (count) {
+		TC_PRINT("There shouldn't be any ETAG option in the packet\n");
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	net_pkt_unref(pkt);
+
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 static int test_retransmit_second_round(void)
 {
 	struct coap_packet cpkt, resp;
@@ -542,6 +657,17 @@ static int test_retransmit_second_round(void)
 		goto done;
 	}
 
+	if (coap_pending_outstanding(pendings, NUM_PENDINGS,
+				     (struct sockaddr *) &dummy_addr) != 1) {
+		TC_PRINT("There should be one outstanding exchange\n");
+		goto done;
+	}
+
+	if (coap_pending_next_timeout(pendings, NUM_PENDINGS) <= 0) {
+		TC_PRINT("Pending should not have expired yet\n");
+		goto done;
+	}
+
 	resp_pkt = net_pkt_get_reserve(&coap_pkt_slab, 0, K_NO_WAIT);
 	if (!resp_pkt) {
 		TC_PRINT("Could not get packet from pool\n");
@@ -1016,6 +1142,159 @@ static const unsigned char ipv6_block[] = {
 	/* CoAP */
 };
 
+static const char * const shared_resource_path[] = { "shared", NULL };
+static struct coap_resource shared_resource = {
+	.path = shared_resource_path,
+};
+static int shared_notify_count;
+
+static int shared_notify_send(struct coap_resource *resource,
+			      struct coap_observer *observer,
+			      const struct coap_packet *notification)
+{
+	u8_t result_pdu[] = { 0x45, 0x45, 0x12, 0x34, 't', 'o', 'k', 'e',
+			      'n', 0x61, 0x03, 0x61, 0x00, 0xFF, 'h', 'i' };
+	struct coap_packet cpkt;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	int r = -EINVAL;
+
+	pkt = net_pkt_get_reserve(&coap_pkt_slab, 0, K_NO_WAIT);
+	if (!pkt) {
+		TC_PRINT("Could not get packet from pool\n");
+		return -ENOMEM;
+	}
+
+	frag = net_buf_alloc(&coap_data_pool, K_NO_WAIT);
+	if (!frag) {
+		TC_PRINT("Could not get buffer from pool\n");
+		goto done;
+	}
+
+	net_pkt_frag_add(pkt, frag);
+
+	r = coap_packet_init_shared(&cpkt, pkt, notification, COAP_TYPE_CON,
+				    observer->tkl, observer->token, 0x1234);
+	if (r) {
+		TC_PRINT("Could not initialize packet\n");
+		goto done;
+	}
+
+	if (frag->len != sizeof(result_pdu) ||
+	    memcmp(result_pdu, frag->data, frag->len)) {
+		TC_PRINT("Notification doesn't match reference packet\n");
+		r = -EINVAL;
+		goto done;
+	}
+
+	shared_notify_count++;
+
+done:
+	net_pkt_unref(pkt);
+
+	return r;
+}
+
+static int test_observer_shared(void)
+{
+	struct sockaddr_in6 peer = dummy_addr;
+	struct coap_observer shared_observers[2];
+	struct coap_packet notification;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	u8_t format = 0;
+	int result = TC_FAIL;
+	int i, r;
+
+	for (i = 0; i < ARRAY_SIZE(shared_observers); i++) {
+		memset(&shared_observers[i], 0, sizeof(shared_observers[i]));
+		memcpy(shared_observers[i].token, "token", 5);
+		shared_observers[i].tkl = 5;
+		peer.sin6_port = htons(5683 + i);
+		net_ipaddr_copy(&shared_observers[i].addr,
+				(struct sockaddr *)&peer);
+		coap_register_observer(&shared_resource,
+				       &shared_observers[i]);
+	}
+
+	pkt = net_pkt_get_reserve(&coap_pkt_slab, 0, K_NO_WAIT);
+	if (!pkt) {
+		TC_PRINT("Could not get packet from pool\n");
+		goto done;
+	}
+
+	frag = net_buf_alloc(&coap_data_pool, K_NO_WAIT);
+	if (!frag) {
+		TC_PRINT("Could not get buffer from pool\n");
+		goto done;
+	}
+
+	net_pkt_frag_add(pkt, frag);
+
+	/* The notification is encoded once, for any token */
+	r = coap_packet_init(&notification, pkt, 1, COAP_TYPE_NON_CON,
+			     3, (u8_t *)"abc", COAP_RESPONSE_CODE_CONTENT,
+			     0x1111);
+	if (r) {
+		TC_PRINT("Could not initialize packet\n");
+		goto done;
+	}
+
+	shared_resource.age++;
+
+	r = coap_append_option_int(&notification, COAP_OPTION_OBSERVE,
+				   shared_resource.age);
+	if (r) {
+		TC_PRINT("Could not append option\n");
+		goto done;
+	}
+
+	r = coap_packet_append_option(&notification,
+				      COAP_OPTION_CONTENT_FORMAT,
+				      &format, sizeof(format));
+	if (r) {
+		TC_PRINT("Could not append option\n");
+		goto done;
+	}
+
+	r = coap_packet_append_payload_marker(&notification);
+	if (r) {
+		TC_PRINT("Failed to set the payload marker\n");
+		goto done;
+	}
+
+	r = coap_packet_append_payload(&notification, (u8_t *)"hi", 2);
+	if (r) {
+		TC_PRINT("Could not append payload\n");
+		goto done;
+	}
+
+	r = coap_resource_notify_shared(&shared_resource, &notification,
+					shared_notify_send);
+	if (r) {
+		TC_PRINT("Could not notify resource\n");
+		goto done;
+	}
+
+	if (shared_notify_count != ARRAY_SIZE(shared_observers)) {
+		TC_PRINT("Not all the observers were notified\n");
+		goto done;
+	}
+
+	result = TC_PASS;
+
+done:
+	for (i = 0; i < ARRAY_SIZE(shared_observers); i++) {
+		coap_remove_observer(&shared_resource, &shared_observers[i]);
+	}
+
+	net_pkt_unref(pkt);
+
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 static int test_block_size(void)
 {
 	struct coap_block_context req_ctx, rsp_ctx;
@@ -1262,6 +1541,103 @@ out:
 
 }
 
+static int tree_resource_get(struct coap_resource *resource,
+			     struct coap_packet *request)
+{
+	return 0;
+}
+
+static int tree_match(const struct coap_resource_tree *tree,
+		      const char * const *uri, coap_method_t *method)
+{
+	struct coap_option options[8] = {};
+	struct coap_resource *resource;
+	int i;
+
+	/* Uri-Path options follow an unrelated one */
+	options[0].delta = COAP_OPTION_OBSERVE;
+
+	for (i = 0; uri[i]; i++) {
+		options[i + 1].delta = COAP_OPTION_URI_PATH;
+		options[i + 1].len = strlen(uri[i]);
+		memcpy(options[i + 1].value, uri[i], options[i + 1].len);
+	}
+
+	*method = coap_resource_tree_match(tree, COAP_METHOD_GET, options,
+					   ARRAY_SIZE(options), &resource);
+
+	return resource ? (int)(resource - tree_resources) : -1;
+}
+
+static int test_resource_tree(void)
+{
+	static const char * const uri_a_b[] = { "a", "b", NULL };
+	static const char * const uri_a_b_c[] = { "a", "b", "c", NULL };
+	static const char * const uri_a_x[] = { "a", "x", NULL };
+	static const char * const uri_a_x_c[] = { "a", "x", "c", NULL };
+	static const char * const uri_a[] = { "a", NULL };
+	static const char * const uri_z[] = { "z", NULL };
+	static const char * const uri_root[] = { NULL };
+	static const struct {
+		const char * const *uri;
+		int resource;
+	} matches[] = {
+		{ uri_a_b, 0 },
+		{ uri_a_b_c, 1 },
+		{ uri_a_x, -1 },
+		{ uri_a_x_c, 1 },
+		{ uri_a, 2 },
+		{ uri_z, 3 },
+		{ uri_root, 4 },
+	};
+	struct coap_resource_node nodes[8];
+	struct coap_resource_tree tree;
+	coap_method_t method;
+	int result = TC_FAIL;
+	int i, r;
+
+	r = coap_resource_tree_init(&tree, nodes, ARRAY_SIZE(nodes),
+				    tree_resources);
+	if (r) {
+		TC_PRINT("Could not build resource tree\n");
+		goto out;
+	}
+
+	r = coap_resource_tree_add(&tree, &tree_resources[0]);
+	if (r != -EALREADY) {
+		TC_PRINT("Resource with a duplicate path was added\n");
+		goto out;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(matches); i++) {
+		r = tree_match(&tree, matches[i].uri, &method);
+		if (r != matches[i].resource) {
+			TC_PRINT("Match %d returned resource %d\n", i, r);
+			goto out;
+		}
+	}
+
+	/* Resource "a" has no GET handler */
+	tree_match(&tree, uri_a_b, &method);
+	if (method != tree_resource_get) {
+		TC_PRINT("GET handler for a/b not returned\n");
+		goto out;
+	}
+
+	tree_match(&tree, uri_a, &method);
+	if (method) {
+		TC_PRINT("Unexpected GET handler for a\n");
+		goto out;
+	}
+
+	result = TC_PASS;
+
+out:
+	TC_END_RESULT(result);
+
+	return result;
+}
+
 /* IPv6 + UDP frame (48 bytes) */
 static const unsigned char ipv6_wrong_opt[] = {
 	/* IPv6 header starts here */
@@ -1561,11 +1937,14 @@ static const struct {
 	{ "Parse emtpy PDU test", test_parse_empty_pdu, },
 	{ "Parse empty PDU test no marker", test_parse_empty_pdu_1, },
 	{ "Parse simple PDU test", test_parse_simple_pdu, },
+	{ "Find options test", test_find_options, },
 	{ "Test retransmission", test_retransmit_second_round, },
 	{ "Test observer server", test_observer_server, },
 	{ "Test observer client", test_observer_client, },
+	{ "Test shared notification", test_observer_shared, },
 	{ "Test block sized transfer", test_block_size, },
 	{ "Test match path uri", test_match_path_uri, },
+	{ "Test resource tree", test_resource_tree, },
 	{ "Parse malformed option", test_parse_malformed_opt },
 	{ "Parse malformed option length", test_parse_malformed_opt_len },
 	{ "Parse malformed option ext", test_parse_malformed_opt_ext },
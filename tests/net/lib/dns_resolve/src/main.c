@@ -750,6 +750,20 @@ static void dns_query_ipv6_numeric(void)
 	}
 }
 
+static void dns_query_flush(void)
+{
+	int ret;
+
+	ret = dns_flush_addr_info(NAME4);
+	zassert_equal(ret, 0, "Cannot flush cached answers of a name");
+
+	ret = dns_flush_addr_info(NULL);
+	zassert_equal(ret, 0, "Cannot flush cached answers");
+
+	ret = dns_resolve_flush(NULL, NULL);
+	zassert_equal(ret, -EINVAL, "Flushing without context succeeded");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(dns_tests,
@@ -769,7 +783,8 @@ void test_main(void)
 			 ztest_unit_test(dns_query_ipv4),
 			 ztest_unit_test(dns_query_ipv6),
 			 ztest_unit_test(dns_query_ipv4_numeric),
-			 ztest_unit_test(dns_query_ipv6_numeric));
+			 ztest_unit_test(dns_query_ipv6_numeric),
+			 ztest_unit_test(dns_query_flush));
 
 	ztest_run_test_suite(dns_tests);
 }
@@ -25,6 +25,8 @@
 static u8_t buf[BUF_SIZE];
 static u16_t buf_len;
 
+NET_PKT_TX_SLAB_DEFINE(mqtt_pkt_slab, 2);
+
 /**
  * @brief MQTT test structure
  */
@@ -96,6 +98,15 @@ static int eval_msg_connect(struct mqtt_test *mqtt_test);
  */
 static int eval_msg_publish(struct mqtt_test *mqtt_test);
 
+/**
+ * @brief eval_msg_publish_pkt	Evaluate the given mqtt_test against the
+ *				publish routines working on network packets.
+ * @param [in] mqtt_test	MQTT test structure
+ * @return			TC_PASS on success
+ * @return			TC_FAIL on error
+ */
+static int eval_msg_publish_pkt(struct mqtt_test *mqtt_test);
+
 /**
  * @brief eval_msg_subscribe	Evaluate the given mqtt_test against the
  *				subscribe packing/unpacking routines.
@@ -850,8 +861,62 @@ static int eval_msg_publish(struct mqtt_test *mqtt_test)
 	/**TESTPOINT: Check eval_msg_publish function*/
 	zassert_false(rc, "mqtt_pack_publish failed");
 
-	return eval_buffers(buf, buf_len,
-			    mqtt_test->expected, mqtt_test->expected_len);
+	rc = eval_buffers(buf, buf_len,
+			  mqtt_test->expected, mqtt_test->expected_len);
+	if (rc != TC_PASS) {
+		return rc;
+	}
+
+	return eval_msg_publish_pkt(mqtt_test);
+}
+
+static int eval_msg_publish_pkt(struct mqtt_test *mqtt_test)
+{
+	struct mqtt_publish_msg *msg;
+	struct mqtt_publish_msg rx_msg;
+	struct net_pkt *pkt;
+	u16_t pos;
+	int rc;
+
+	msg = (struct mqtt_publish_msg *)mqtt_test->msg;
+
+	pkt = net_pkt_get_reserve(&mqtt_pkt_slab, 0, K_NO_WAIT);
+	zassert_not_null(pkt, "no packet available");
+
+	rc = mqtt_pack_publish_pkt(pkt, msg, K_NO_WAIT);
+
+	/**TESTPOINT: Check mqtt_pack_publish_pkt function*/
+	zassert_false(rc, "mqtt_pack_publish_pkt failed");
+
+	buf_len = net_pkt_get_len(pkt);
+	net_frag_read(pkt->frags, 0, &pos, buf_len, buf);
+
+	rc = eval_buffers(buf, buf_len,
+			  mqtt_test->expected, mqtt_test->expected_len);
+	if (rc != TC_PASS) {
+		goto exit_pkt;
+	}
+
+	rc = mqtt_unpack_publish_frags(pkt->frags, 0, buf_len, &rx_msg);
+
+	/**TESTPOINT: Check mqtt_unpack_publish_frags function*/
+	zassert_false(rc, "mqtt_unpack_publish_frags failed");
+	zassert_equal(rx_msg.qos, msg->qos, "invalid QoS");
+	zassert_equal(rx_msg.topic_len, msg->topic_len, "invalid topic");
+	zassert_false(memcmp(rx_msg.topic, msg->topic, msg->topic_len),
+		      "invalid topic");
+	zassert_equal(rx_msg.msg_len, msg->msg_len, "invalid payload");
+	zassert_false(memcmp(rx_msg.msg, msg->msg, msg->msg_len),
+		      "invalid payload");
+
+	if (msg->qos != MQTT_QoS0) {
+		zassert_equal(rx_msg.pkt_id, msg->pkt_id, "invalid pkt id");
+	}
+
+exit_pkt:
+	net_pkt_unref(pkt);
+
+	return rc;
 }
 
 static int eval_msg_subscribe(struct mqtt_test *mqtt_test)
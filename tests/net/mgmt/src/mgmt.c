@@ -218,6 +218,30 @@ static int test_synchronous_event_listener(u32_t times, bool on_iface)
 	return TC_PASS;
 }
 
+static int test_direct_event_callback(void)
+{
+	TC_PRINT("- Direct event callback\n");
+
+	net_mgmt_init_event_callback(&rx_cb, receiver_cb, TEST_MGMT_EVENT);
+	net_mgmt_add_direct_event_callback(&rx_cb);
+
+	net_mgmt_event_notify(TEST_MGMT_EVENT, net_if_get_default());
+
+	/* Run before returning, without yielding to the event thread */
+	zassert_equal(rx_calls, 1, "rx_calls check failed");
+	zassert_equal(rx_event, TEST_MGMT_EVENT, "rx_event check failed");
+
+	net_mgmt_event_notify(TEST_MGMT_EVENT_UNHANDLED,
+			      net_if_get_default());
+
+	zassert_equal(rx_calls, 1, "unhandled event received");
+
+	net_mgmt_del_event_callback(&rx_cb);
+	rx_event = rx_calls = 0;
+
+	return TC_PASS;
+}
+
 static void initialize_event_tests(void)
 {
 	event2throw = 0;
@@ -323,6 +347,9 @@ void test_mgmt(void)
 
 	zassert_false(test_synchronous_event_listener(2, true),
 		      "test_synchronous_event_listener failed");
+
+	zassert_false(test_direct_event_callback(),
+		      "test_direct_event_callback failed");
 }
 
 void test_main(void)
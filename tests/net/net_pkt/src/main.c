@@ -1072,6 +1072,112 @@ static void test_fragment_split(void)
 		      "Frag_b data mismatch");
 }
 
+static void test_pkt_linear(void)
+{
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+	u8_t buf[50];
+	u16_t pos;
+
+	pkt = net_pkt_get_reserve_rx(LL_RESERVE, K_FOREVER);
+	frag = net_pkt_get_frag_linear(pkt, 1280, K_FOREVER);
+	zassert_not_null(frag, "Cannot get linear fragment");
+	zassert_true(net_buf_headroom(frag) >= LL_RESERVE, "Headroom missing");
+	zassert_true(net_buf_tailroom(frag) >= 1280, "Tailroom too small");
+
+	net_pkt_frag_add(pkt, frag);
+
+	zassert_equal(net_pkt_append(pkt, sizeof(example_data),
+				     (const u8_t *)example_data, K_FOREVER),
+		      sizeof(example_data), "Cannot append data");
+	zassert_true(net_pkt_is_linear(pkt), "Packet is not linear");
+	zassert_equal(frag->len, sizeof(example_data), "Data length wrong");
+
+	frag = net_frag_read(pkt->frags, 100, &pos, sizeof(buf), buf);
+	zassert_equal_ptr(frag, pkt->frags, "Wrong fragment");
+	zassert_equal(pos, 100 + sizeof(buf), "Wrong position");
+	zassert_false(memcmp(buf, example_data + 100, sizeof(buf)),
+		      "Data mismatch");
+
+	/* reading up to the end of the data moves past the fragment */
+	frag = net_frag_read(pkt->frags, sizeof(example_data) - sizeof(buf),
+			     &pos, sizeof(buf), buf);
+	zassert_is_null(frag, "Fragment should be the last one");
+	zassert_equal(pos, 0, "Wrong position");
+	zassert_false(memcmp(buf, example_data + sizeof(example_data) -
+			     sizeof(buf), sizeof(buf)), "Data mismatch");
+
+	net_pkt_unref(pkt);
+}
+
+static void test_pkt_cursor(void)
+{
+	struct net_pkt_cursor cursor, saved;
+	struct net_pkt *pkt;
+	u8_t buf[10];
+	u16_t value;
+	u8_t *data;
+	int len;
+
+	pkt = net_pkt_get_reserve_rx(0, K_FOREVER);
+	zassert_equal(net_pkt_append(pkt, sizeof(example_data),
+				     (const u8_t *)example_data, K_FOREVER),
+		      sizeof(example_data), "Cannot append data");
+	zassert_not_null(pkt->frags->frags, "Packet should be fragmented");
+
+	len = pkt->frags->len;
+
+	/* peek at data in the first fragment, and across the boundary */
+	zassert_equal(net_pkt_cursor_init(pkt, &cursor, 20), 0, "Init failed");
+	data = net_pkt_cursor_peek(&cursor, 4);
+	zassert_equal_ptr(data, pkt->frags->data + 20, "Wrong peek");
+	zassert_is_null(net_pkt_cursor_peek(&cursor, len), "Peek crossed");
+
+	/* sequential reads go across fragments */
+	zassert_equal(net_pkt_cursor_skip(&cursor, len - 25), 0, "Skip failed");
+	zassert_equal(net_pkt_cursor_read(&cursor, buf, sizeof(buf)), 0,
+		      "Read failed");
+	zassert_false(memcmp(buf, example_data + len - 5, sizeof(buf)),
+		      "Data mismatch");
+	zassert_equal_ptr(cursor.frag, pkt->frags->frags, "Wrong fragment");
+	zassert_equal(cursor.pos, 5, "Wrong position");
+
+	zassert_equal(net_pkt_cursor_read_be16(&cursor, &value), 0,
+		      "Read failed");
+	zassert_equal(value, (u8_t)example_data[len + 5] << 8 |
+		      (u8_t)example_data[len + 6], "Wrong value");
+
+	/* failures leave the cursor untouched */
+	saved = cursor;
+	zassert_equal(net_pkt_cursor_skip(&cursor, sizeof(example_data)),
+		      -ENOBUFS, "Skip past the end");
+	zassert_equal_ptr(cursor.frag, saved.frag, "Cursor moved");
+	zassert_equal(cursor.pos, saved.pos, "Cursor moved");
+
+	/* reading up to the end leaves the cursor at the end */
+	zassert_equal(net_pkt_cursor_init(pkt, &cursor,
+					  sizeof(example_data) - 2), 0,
+		      "Init failed");
+	zassert_equal(net_pkt_cursor_skip(&cursor, 2), 0, "Skip failed");
+	zassert_is_null(cursor.frag, "Cursor not at the end");
+	zassert_equal(net_pkt_cursor_init(pkt, &cursor,
+					  sizeof(example_data) + 1), -ENOBUFS,
+		      "Init past the end");
+
+	/* overwrite data across the boundary */
+	zassert_equal(net_pkt_cursor_init(pkt, &cursor, len - 1), 0,
+		      "Init failed");
+	zassert_equal(net_pkt_cursor_write(&cursor, "XYZ", 3), 0,
+		      "Write failed");
+	zassert_equal(pkt->frags->data[len - 1], 'X', "Write failed");
+	zassert_false(memcmp(pkt->frags->frags->data, "YZ", 2),
+		      "Write failed");
+	zassert_equal(net_pkt_get_len(pkt), sizeof(example_data),
+		      "Packet length changed");
+
+	net_pkt_unref(pkt);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(net_pkt_tests,
@@ -1080,7 +1186,9 @@ void test_main(void)
 			 ztest_unit_test(test_pkt_read_append),
 			 ztest_unit_test(test_pkt_read_write_insert),
 			 ztest_unit_test(test_fragment_compact),
-			 ztest_unit_test(test_fragment_split)
+			 ztest_unit_test(test_fragment_split),
+			 ztest_unit_test(test_pkt_linear),
+			 ztest_unit_test(test_pkt_cursor)
 			 );
 
 	ztest_run_test_suite(net_pkt_tests);
@@ -469,6 +469,41 @@ static void route_del_many(void)
 	}
 }
 
+static void route_lookup_longest(void)
+{
+	struct net_route_entry *long_route, *short_route;
+	struct in6_addr addr;
+
+	long_route = net_route_add(my_iface, &generic_addr, 112, &peer_addr);
+	zassert_not_null(long_route, "Route /112 add failed");
+
+	short_route = net_route_add(my_iface, &dest_addr, 64, &peer_addr);
+	zassert_not_null(short_route, "Route /64 add failed");
+	zassert_not_equal(short_route, long_route, "Same route");
+
+	net_ipaddr_copy(&addr, &generic_addr);
+	addr.s6_addr[15] = 0x42;
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &addr), long_route,
+			  "Longest prefix not found");
+	zassert_equal_ptr(net_route_lookup(my_iface, &addr), long_route,
+			  "Longest prefix not found again");
+	zassert_equal_ptr(net_route_lookup(my_iface, &dest_addr), short_route,
+			  "Shorter prefix not found");
+	zassert_is_null(net_route_lookup(my_iface, &ll_addr),
+			"Route found for link local address");
+
+	zassert_false(net_route_del(long_route), "Route /112 del failed");
+
+	zassert_equal_ptr(net_route_lookup(my_iface, &addr), short_route,
+			  "Shorter prefix not found after del");
+
+	zassert_false(net_route_del(short_route), "Route /64 del failed");
+
+	zassert_is_null(net_route_lookup(my_iface, &addr),
+			"Route found after del");
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -488,6 +523,7 @@ void test_main(void)
 			ztest_unit_test(route_del_nexthop_again),
 			ztest_unit_test(populate_nbr_cache),
 			ztest_unit_test(route_add_many),
-			ztest_unit_test(route_del_many));
+			ztest_unit_test(route_del_many),
+			ztest_unit_test(route_lookup_longest));
 	ztest_run_test_suite(test_route);
 }
@@ -5,9 +5,11 @@
  */
 
 #include <stdio.h>
+#include <errno.h>
 #include <ztest_assert.h>
 
 #include <net/socket.h>
+#include <net/buf.h>
 
 #define BUF_AND_SIZE(buf) buf, sizeof(buf) - 1
 #define STRLEN(buf) (sizeof(buf) - 1)
@@ -322,6 +324,335 @@ void test_send_recv_2_sock(void)
 	zassert_equal(rv, 0, "close failed");
 }
 
+void test_v4_sendmsg_recvmsg(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in addr;
+	char rx_buf1[3], rx_buf2[10];
+	struct iovec iov[2];
+	struct msghdr msg;
+	ssize_t len;
+
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, ANY_PORT,
+			&client_sock, &client_addr);
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, SERVER_PORT,
+			&server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* "te" + "st" */
+	iov[0].iov_base = TEST_STR_SMALL;
+	iov[0].iov_len = 2;
+	iov[1].iov_base = TEST_STR_SMALL + 2;
+	iov[1].iov_len = STRLEN(TEST_STR_SMALL) - 2;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &server_addr;
+	msg.msg_namelen = sizeof(server_addr);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = 2;
+
+	len = sendmsg(client_sock, &msg, 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "sendmsg failed");
+
+	iov[0].iov_base = rx_buf1;
+	iov[0].iov_len = sizeof(rx_buf1);
+	iov[1].iov_base = rx_buf2;
+	iov[1].iov_len = sizeof(rx_buf2);
+
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_name = &addr;
+	msg.msg_namelen = sizeof(addr);
+	msg.msg_iov = iov;
+	msg.msg_iovlen = 2;
+
+	len = recvmsg(server_sock, &msg, 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "recvmsg failed");
+	zassert_equal(memcmp(rx_buf1, TEST_STR_SMALL, sizeof(rx_buf1)), 0,
+		      "unexpected data in first iovec");
+	zassert_equal(rx_buf2[0], TEST_STR_SMALL[3],
+		      "unexpected data in second iovec");
+	zassert_equal(msg.msg_namelen, sizeof(addr), "unexpected addrlen");
+	zassert_false(msg.msg_flags & MSG_TRUNC, "unexpected truncation");
+
+	/* A datagram larger than the buffers is truncated */
+	len = sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	msg.msg_iovlen = 1;
+	len = recvmsg(server_sock, &msg, 0);
+	zassert_equal(len, sizeof(rx_buf1), "recvmsg failed");
+	zassert_true(msg.msg_flags & MSG_TRUNC, "truncation not reported");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_zero_copy(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct net_buf *buf;
+	ssize_t len;
+
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, ANY_PORT,
+			&client_sock, &client_addr);
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, SERVER_PORT,
+			&server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	buf = zsock_zc_buf_get(client_sock, K_FOREVER);
+	zassert_not_null(buf, "no buffer");
+	net_buf_add_mem(buf, BUF_AND_SIZE(TEST_STR_SMALL));
+
+	len = zsock_sendto_zc(client_sock, buf, 0,
+			      (struct sockaddr *)&server_addr,
+			      sizeof(server_addr));
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "zsock_sendto_zc failed");
+
+	len = zsock_recvfrom_zc(server_sock, &buf, 0, NULL, NULL);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "zsock_recvfrom_zc failed");
+	zassert_equal(net_buf_frags_len(buf), len, "unexpected chain length");
+	zassert_equal(memcmp(buf->data, TEST_STR_SMALL, len), 0,
+		      "unexpected data");
+
+	zsock_zc_buf_put(buf);
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_epoll(void)
+{
+	int rv;
+	int epfd;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct epoll_event event;
+	char buf[10];
+	ssize_t len;
+
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, ANY_PORT,
+			&client_sock, &client_addr);
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, SERVER_PORT,
+			&server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	epfd = epoll_create1(0);
+	zassert_true(epfd >= 0, "epoll_create1 failed");
+
+	event.events = EPOLLIN;
+	event.data.fd = server_sock;
+	rv = epoll_ctl(epfd, EPOLL_CTL_ADD, server_sock, &event);
+	zassert_equal(rv, 0, "epoll_ctl failed");
+
+	rv = epoll_ctl(epfd, EPOLL_CTL_ADD, server_sock, &event);
+	zassert_equal(rv, -1, "socket added twice");
+	zassert_equal(errno, EEXIST, "unexpected errno");
+
+	rv = epoll_wait(epfd, &event, 1, 0);
+	zassert_equal(rv, 0, "socket readable before data was sent");
+
+	len = sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	rv = epoll_wait(epfd, &event, 1, 100);
+	zassert_equal(rv, 1, "no event");
+	zassert_equal(event.events, EPOLLIN, "unexpected events");
+	zassert_equal(event.data.fd, server_sock, "unexpected data");
+
+	/* Level-triggered: reported again as long as data is queued */
+	rv = epoll_wait(epfd, &event, 1, 0);
+	zassert_equal(rv, 1, "level-triggered event not reported again");
+
+	/* Edge-triggered: reported once for the data queued */
+	event.events = EPOLLIN | EPOLLET;
+	event.data.fd = server_sock;
+	rv = epoll_ctl(epfd, EPOLL_CTL_MOD, server_sock, &event);
+	zassert_equal(rv, 0, "epoll_ctl failed");
+
+	rv = epoll_wait(epfd, &event, 1, 0);
+	zassert_equal(rv, 1, "edge-triggered event not reported");
+
+	rv = epoll_wait(epfd, &event, 1, 0);
+	zassert_equal(rv, 0, "edge-triggered event reported twice");
+
+	len = recv(server_sock, buf, sizeof(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "recv failed");
+
+	rv = epoll_ctl(epfd, EPOLL_CTL_DEL, server_sock, NULL);
+	zassert_equal(rv, 0, "epoll_ctl failed");
+
+	rv = close(epfd);
+	zassert_equal(rv, 0, "close failed");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_rcvbuf(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	socklen_t optlen;
+	int rcvbuf;
+	char buf[10];
+	ssize_t len;
+
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, ANY_PORT,
+			&client_sock, &client_addr);
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, SERVER_PORT,
+			&server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* Room for one datagram only */
+	rcvbuf = STRLEN(TEST_STR_SMALL) + 1;
+	rv = setsockopt(server_sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf,
+			sizeof(rcvbuf));
+	zassert_equal(rv, 0, "setsockopt failed");
+
+	rcvbuf = 0;
+	optlen = sizeof(rcvbuf);
+	rv = getsockopt(server_sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, &optlen);
+	zassert_equal(rv, 0, "getsockopt failed");
+	zassert_equal(rcvbuf, STRLEN(TEST_STR_SMALL) + 1, "unexpected value");
+	zassert_equal(optlen, sizeof(rcvbuf), "unexpected optlen");
+
+	len = sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	len = sendto(client_sock, BUF_AND_SIZE(TEST_STR_SMALL), 0,
+		     (struct sockaddr *)&server_addr, sizeof(server_addr));
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "sendto failed");
+
+	/* Let both datagrams get through the stack */
+	k_sleep(100);
+
+	len = recv(server_sock, buf, sizeof(buf), 0);
+	zassert_equal(len, STRLEN(TEST_STR_SMALL), "recv failed");
+
+	len = recv(server_sock, buf, sizeof(buf), MSG_DONTWAIT);
+	zassert_equal(len, -1, "datagram beyond the buffer was queued");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
+void test_v4_sendmmsg_recvmmsg(void)
+{
+	int rv;
+	int client_sock;
+	int server_sock;
+	struct sockaddr_in client_addr;
+	struct sockaddr_in server_addr;
+	struct sockaddr_in addr[3];
+	char rx_buf[3][10];
+	struct iovec tx_iov[3], rx_iov[3];
+	struct mmsghdr msgs[3];
+	int i;
+
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, ANY_PORT,
+			&client_sock, &client_addr);
+	prepare_sock_v4(CONFIG_NET_APP_MY_IPV4_ADDR, SERVER_PORT,
+			&server_sock, &server_addr);
+
+	rv = bind(server_sock, (struct sockaddr *)&server_addr,
+		  sizeof(server_addr));
+	zassert_equal(rv, 0, "bind failed");
+
+	/* "t", "te", "tes" */
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < 3; i++) {
+		tx_iov[i].iov_base = TEST_STR_SMALL;
+		tx_iov[i].iov_len = i + 1;
+		msgs[i].msg_hdr.msg_name = &server_addr;
+		msgs[i].msg_hdr.msg_namelen = sizeof(server_addr);
+		msgs[i].msg_hdr.msg_iov = &tx_iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	rv = sendmmsg(client_sock, msgs, 3, 0);
+	zassert_equal(rv, 3, "sendmmsg failed");
+	for (i = 0; i < 3; i++) {
+		zassert_equal(msgs[i].msg_len, i + 1, "unexpected msg_len");
+	}
+
+	memset(msgs, 0, sizeof(msgs));
+	for (i = 0; i < 3; i++) {
+		rx_iov[i].iov_base = rx_buf[i];
+		rx_iov[i].iov_len = sizeof(rx_buf[i]);
+		msgs[i].msg_hdr.msg_name = &addr[i];
+		msgs[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+		msgs[i].msg_hdr.msg_iov = &rx_iov[i];
+		msgs[i].msg_hdr.msg_iovlen = 1;
+	}
+
+	/* Only two of them are asked for */
+	rv = recvmmsg(server_sock, msgs, 2, MSG_WAITFORONE);
+	zassert_equal(rv, 2, "recvmmsg failed");
+	for (i = 0; i < 2; i++) {
+		zassert_equal(msgs[i].msg_len, i + 1, "unexpected msg_len");
+		zassert_equal(memcmp(rx_buf[i], TEST_STR_SMALL, i + 1), 0,
+			      "unexpected data");
+		zassert_equal(msgs[i].msg_hdr.msg_namelen, sizeof(addr[i]),
+			      "unexpected addrlen");
+	}
+
+	/* The third one is there, and then the queue is empty */
+	rv = recvmmsg(server_sock, &msgs[2], 1, MSG_WAITFORONE);
+	zassert_equal(rv, 1, "recvmmsg failed");
+	zassert_equal(msgs[2].msg_len, 3, "unexpected msg_len");
+
+	rv = recvmmsg(server_sock, msgs, 3, MSG_DONTWAIT);
+	zassert_equal(rv, -1, "recvmmsg did not fail");
+	zassert_equal(errno, EAGAIN, "unexpected errno");
+
+	rv = close(client_sock);
+	zassert_equal(rv, 0, "close failed");
+
+	rv = close(server_sock);
+	zassert_equal(rv, 0, "close failed");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(socket_udp,
@@ -329,7 +660,12 @@ void test_main(void)
 			 ztest_unit_test(test_v4_sendto_recvfrom),
 			 ztest_unit_test(test_v6_sendto_recvfrom),
 			 ztest_unit_test(test_v4_bind_sendto),
-			 ztest_unit_test(test_v6_bind_sendto));
+			 ztest_unit_test(test_v6_bind_sendto),
+			 ztest_unit_test(test_v4_sendmsg_recvmsg),
+			 ztest_unit_test(test_v4_zero_copy),
+			 ztest_unit_test(test_v4_epoll),
+			 ztest_unit_test(test_v4_rcvbuf),
+			 ztest_unit_test(test_v4_sendmmsg_recvmmsg));
 
 	ztest_run_test_suite(socket_udp);
 }
@@ -34,6 +34,10 @@
 #include "tcp_internal.h"
 #include "net_private.h"
 
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+#include "tcp_cc.h"
+#endif
+
 static bool test_failed;
 static bool fail = true;
 static struct k_sem recv_lock;
@@ -76,6 +80,16 @@ static int accept_cb_called;
 #endif
 static bool syn_v6_sent;
 
+/* Segments sent to the SACK test peer are kept for inspection */
+#define SACK_TCP_PORT (MY_TCP_PORT + 1)
+#define SACK_PEER_PORT 9877
+#define SACK_PEER_ISN 1000
+
+static struct in6_addr sack_peer_inaddr = { { { 0x20, 0x01, 0x0d, 0xb8, 0, 0,
+					    0, 0, 0, 0, 0, 0, 0, 0, 0, 0x3 } } };
+static K_FIFO_DEFINE(sent_fifo);
+static bool capture_sent;
+
 struct net_tcp_context {
 };
 
@@ -138,6 +152,13 @@ static int tester_send(struct net_if *iface, struct net_pkt *pkt)
 		DBG("No data to send!\n");
 		return -ENODATA;
 	}
+	if (capture_sent && net_pkt_family(pkt) == AF_INET6 &&
+	    NET_IPV6_HDR(pkt)->nexthdr == IPPROTO_TCP &&
+	    NET_TCP_HDR(pkt)->dst_port == htons(SACK_PEER_PORT)) {
+		k_fifo_put(&sent_fifo, pkt);
+		send_status = 0;
+		return 0;
+	}
 	if (syn_v6_sent && net_pkt_family(pkt) == AF_INET6) {
 		DBG("v6 SYN was sent successfully\n");
 		syn_v6_sent = false;
@@ -1658,6 +1679,593 @@ static bool test_init_tcp_connect(void)
 }
 #endif
 
+static struct net_pkt *sack_peer_segment(u32_t seq, u32_t ack, u8_t flags,
+					 const u8_t *opts, u8_t optlen,
+					 const u8_t *data, u16_t len)
+{
+	struct net_if *iface = net_if_get_default();
+	struct net_tcp_hdr tcp_hdr = { 0 };
+	struct net_ipv6_hdr ipv6 = { 0 };
+	u16_t tcp_len = NET_TCPH_LEN + optlen + len;
+	struct net_pkt *pkt;
+	struct net_buf *frag;
+
+	pkt = net_pkt_get_reserve_tx(0, K_FOREVER);
+
+	net_pkt_set_ll_reserve(pkt, 0);
+
+	frag = net_pkt_get_frag(pkt, K_FOREVER);
+
+	net_pkt_frag_add(pkt, frag);
+
+	net_pkt_set_iface(pkt, iface);
+
+	ipv6.vtc = 0x60;
+	ipv6.len[0] = tcp_len >> 8;
+	ipv6.len[1] = tcp_len;
+	ipv6.nexthdr = IPPROTO_TCP;
+	ipv6.hop_limit = 255;
+
+	net_ipaddr_copy(&ipv6.src, &sack_peer_inaddr);
+	net_ipaddr_copy(&ipv6.dst, &my_v6_inaddr);
+
+	net_pkt_set_ip_hdr_len(pkt, sizeof(struct net_ipv6_hdr));
+	net_pkt_set_ipv6_ext_len(pkt, 0);
+
+	tcp_hdr.src_port = htons(SACK_PEER_PORT);
+	tcp_hdr.dst_port = htons(SACK_TCP_PORT);
+	sys_put_be32(seq, tcp_hdr.seq);
+	sys_put_be32(ack, tcp_hdr.ack);
+	tcp_hdr.offset = ((NET_TCPH_LEN + optlen) / 4) << 4;
+	tcp_hdr.flags = flags;
+	sys_put_be16(0xffff, tcp_hdr.wnd);
+
+	net_pkt_append_all(pkt, sizeof(ipv6), (u8_t *)&ipv6, K_FOREVER);
+	net_pkt_append_all(pkt, sizeof(tcp_hdr), (u8_t *)&tcp_hdr, K_FOREVER);
+	net_pkt_append_all(pkt, optlen, opts, K_FOREVER);
+	net_pkt_append_all(pkt, len, data, K_FOREVER);
+
+	return pkt;
+}
+
+static bool sack_parse(const u8_t *opts, u8_t optlen,
+		       struct net_tcp_options *parsed)
+{
+	struct net_pkt *pkt;
+	int ret;
+
+	pkt = sack_peer_segment(0, 0, NET_TCP_ACK, opts, optlen, NULL, 0);
+
+	memset(parsed, 0, sizeof(*parsed));
+	ret = net_tcp_parse_opts(pkt, optlen, parsed);
+
+	net_pkt_unref(pkt);
+
+	return ret == 0;
+}
+
+static bool test_sack_parse_opts(void)
+{
+	static const u8_t valid[] = {
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_SACK_OPT, 10,
+		0, 0, 0x10, 0, 0, 0, 0x10, 0x20,
+	};
+	static const u8_t no_block[] = {
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_SACK_OPT, 2,
+	};
+	static const u8_t partial_block[] = {
+		NET_TCP_SACK_OPT, 9, 0, 0, 0x10, 0, 0, 0, 0x10,
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_NOP_OPT,
+	};
+	static const u8_t truncated[] = {
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_SACK_OPT, 18,
+		0, 0, 0x10, 0, 0, 0, 0x10, 0x20,
+	};
+	struct net_tcp_options opts;
+
+	if (!sack_parse(valid, sizeof(valid), &opts) ||
+	    opts.sack_count != 1 || opts.sack[0].start != 0x1000 ||
+	    opts.sack[0].end != 0x1020) {
+		TC_ERROR("Valid SACK option not parsed\n");
+		return false;
+	}
+
+	if (sack_parse(no_block, sizeof(no_block), &opts)) {
+		TC_ERROR("SACK option without blocks accepted\n");
+		return false;
+	}
+
+	if (sack_parse(partial_block, sizeof(partial_block), &opts)) {
+		TC_ERROR("SACK option with a partial block accepted\n");
+		return false;
+	}
+
+	if (sack_parse(truncated, sizeof(truncated), &opts)) {
+		TC_ERROR("Truncated SACK option accepted\n");
+		return false;
+	}
+
+	return true;
+}
+
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_REASSEMBLY)
+static const u8_t sack_data[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h' };
+#define SACK_HOLE 4
+
+static struct net_context *sack_listen_ctx;
+static struct net_context *sack_ctx;
+static struct k_sem sack_accepted;
+static u8_t sack_recv_buf[sizeof(sack_data)];
+static u16_t sack_recv_len;
+static u32_t sack_local_isn;
+
+static void sack_recv_cb(struct net_context *context,
+			 struct net_pkt *pkt,
+			 int status,
+			 void *user_data)
+{
+	u16_t len;
+
+	if (!pkt) {
+		return;
+	}
+
+	len = net_pkt_appdatalen(pkt);
+	if (sack_recv_len + len <= sizeof(sack_recv_buf)) {
+		net_frag_linearize(sack_recv_buf + sack_recv_len, len, pkt,
+				   net_pkt_get_len(pkt) - len, len);
+	}
+
+	sack_recv_len += len;
+
+	net_pkt_unref(pkt);
+}
+
+static void sack_accept_cb(struct net_context *new_context,
+			   struct sockaddr *addr,
+			   socklen_t addrlen,
+			   int error,
+			   void *user_data)
+{
+	if (error) {
+		return;
+	}
+
+	sack_ctx = new_context;
+	net_context_recv(new_context, sack_recv_cb, K_NO_WAIT, NULL);
+
+	k_sem_give(&sack_accepted);
+}
+
+static bool sack_peer_send(u32_t seq, u8_t flags, const u8_t *opts,
+			   u8_t optlen, const u8_t *data, u16_t len)
+{
+	u32_t ack = (flags & NET_TCP_ACK) ? sack_local_isn + 1 : 0;
+	struct net_pkt *pkt;
+
+	pkt = sack_peer_segment(seq, ack, flags, opts, optlen, data, len);
+
+	if (net_recv_data(net_pkt_iface(pkt), pkt) < 0) {
+		net_pkt_unref(pkt);
+		return false;
+	}
+
+	return true;
+}
+
+/* Take the ACK sent back to the peer and check what it acknowledges */
+static bool sack_check_ack(u32_t ack, struct net_tcp_options *opts)
+{
+	struct net_tcp_hdr hdr, *tcp_hdr;
+	struct net_pkt *pkt;
+	bool ok = false;
+
+	pkt = k_fifo_get(&sent_fifo, WAIT_TIME);
+	if (!pkt) {
+		TC_ERROR("No ACK sent\n");
+		return false;
+	}
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr || NET_TCP_FLAGS(tcp_hdr) != NET_TCP_ACK) {
+		TC_ERROR("Not an ACK\n");
+		goto out;
+	}
+
+	if (sys_get_be32(tcp_hdr->ack) != ack) {
+		TC_ERROR("ACK %u, expected %u\n",
+			 sys_get_be32(tcp_hdr->ack), ack);
+		goto out;
+	}
+
+	memset(opts, 0, sizeof(*opts));
+	ok = net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) - NET_TCPH_LEN,
+				opts) == 0;
+
+out:
+	net_pkt_unref(pkt);
+
+	return ok;
+}
+
+static bool test_sack_connect(void)
+{
+	static const u8_t syn_opts[] = {
+		NET_TCP_MSS_OPT, NET_TCP_MSS_SIZE, 0x05, 0xa0,
+		NET_TCP_NOP_OPT, NET_TCP_WINDOW_SCALE_OPT,
+		NET_TCP_WINDOW_SCALE_SIZE, 2,
+		NET_TCP_NOP_OPT, NET_TCP_NOP_OPT, NET_TCP_SACK_PERM_OPT,
+		NET_TCP_SACK_PERM_SIZE,
+	};
+	struct net_tcp_options opts = { 0 };
+	struct net_tcp_hdr hdr, *tcp_hdr;
+	struct sockaddr_in6 addr;
+	struct net_pkt *pkt;
+	int ret;
+
+	k_sem_init(&sack_accepted, 0, 1);
+	capture_sent = true;
+
+	ret = net_context_get(AF_INET6, SOCK_STREAM, IPPROTO_TCP,
+			      &sack_listen_ctx);
+	if (ret) {
+		TC_ERROR("Context get SACK test failed (%d)\n", ret);
+		return false;
+	}
+
+	net_ipaddr_copy(&addr.sin6_addr, &my_v6_inaddr);
+	addr.sin6_family = AF_INET6;
+	addr.sin6_port = htons(SACK_TCP_PORT);
+
+	ret = net_context_bind(sack_listen_ctx, (struct sockaddr *)&addr,
+			       sizeof(addr));
+	if (ret) {
+		TC_ERROR("Context bind SACK test failed (%d)\n", ret);
+		return false;
+	}
+
+	ret = net_context_listen(sack_listen_ctx, 0);
+	if (ret) {
+		TC_ERROR("Context listen SACK test failed (%d)\n", ret);
+		return false;
+	}
+
+	ret = net_context_accept(sack_listen_ctx, sack_accept_cb, K_NO_WAIT,
+				 NULL);
+	if (ret) {
+		TC_ERROR("Context accept SACK test failed (%d)\n", ret);
+		return false;
+	}
+
+	if (!sack_peer_send(SACK_PEER_ISN, NET_TCP_SYN, syn_opts,
+			    sizeof(syn_opts), NULL, 0)) {
+		TC_ERROR("Cannot send SYN\n");
+		return false;
+	}
+
+	pkt = k_fifo_get(&sent_fifo, WAIT_TIME);
+	if (!pkt) {
+		TC_ERROR("No SYN-ACK sent\n");
+		return false;
+	}
+
+	tcp_hdr = net_tcp_get_hdr(pkt, &hdr);
+	if (!tcp_hdr ||
+	    NET_TCP_FLAGS(tcp_hdr) != (NET_TCP_SYN | NET_TCP_ACK) ||
+	    sys_get_be32(tcp_hdr->ack) != SACK_PEER_ISN + 1 ||
+	    net_tcp_parse_opts(pkt, NET_TCP_HDR_LEN(tcp_hdr) - NET_TCPH_LEN,
+			       &opts) < 0) {
+		TC_ERROR("Invalid SYN-ACK\n");
+		net_pkt_unref(pkt);
+		return false;
+	}
+
+	sack_local_isn = sys_get_be32(tcp_hdr->seq);
+	net_pkt_unref(pkt);
+
+	if (!opts.sack_perm) {
+		TC_ERROR("SACK not permitted in the SYN-ACK\n");
+		return false;
+	}
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	if (!opts.wscale_set) {
+		TC_ERROR("No window scale in the SYN-ACK\n");
+		return false;
+	}
+#endif
+
+	if (!sack_peer_send(SACK_PEER_ISN + 1, NET_TCP_ACK, NULL, 0,
+			    NULL, 0)) {
+		TC_ERROR("Cannot send ACK\n");
+		return false;
+	}
+
+	if (k_sem_take(&sack_accepted, WAIT_TIME)) {
+		TC_ERROR("Connection not accepted\n");
+		return false;
+	}
+
+	if (!sack_ctx->tcp->sack_ok) {
+		TC_ERROR("SACK not enabled on the connection\n");
+		return false;
+	}
+
+#if defined(CONFIG_NET_TCP_WINDOW_SCALE)
+	if (!sack_ctx->tcp->wscale_ok || sack_ctx->tcp->send_wscale != 2) {
+		TC_ERROR("Window scale not negotiated\n");
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+static bool test_sack_out_of_order(void)
+{
+	struct net_tcp_options opts;
+	u32_t seq = SACK_PEER_ISN + 1 + SACK_HOLE;
+
+	if (!sack_peer_send(seq, NET_TCP_ACK, NULL, 0, sack_data + SACK_HOLE,
+			    sizeof(sack_data) - SACK_HOLE)) {
+		TC_ERROR("Cannot send data\n");
+		return false;
+	}
+
+	/* The hole is reported at once, the data after it in a block */
+	if (!sack_check_ack(SACK_PEER_ISN + 1, &opts)) {
+		return false;
+	}
+
+	if (opts.sack_count != 1 || opts.sack[0].start != seq ||
+	    opts.sack[0].end != SACK_PEER_ISN + 1 + sizeof(sack_data)) {
+		TC_ERROR("Invalid SACK blocks (%d)\n", opts.sack_count);
+		return false;
+	}
+
+	if (sack_recv_len) {
+		TC_ERROR("Data after the hole delivered\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_sack_overlap(void)
+{
+	struct net_pkt *pkt;
+
+	/* Ends inside the queued segment: dropped without an ACK */
+	if (!sack_peer_send(SACK_PEER_ISN + 1 + SACK_HOLE / 2, NET_TCP_ACK,
+			    NULL, 0, sack_data + SACK_HOLE / 2, SACK_HOLE)) {
+		TC_ERROR("Cannot send data\n");
+		return false;
+	}
+
+	pkt = k_fifo_get(&sent_fifo, WAIT_TIME);
+	if (pkt) {
+		TC_ERROR("Overlapping segment acknowledged\n");
+		net_pkt_unref(pkt);
+		return false;
+	}
+
+	if (sack_ctx->tcp->ooo_count != 1 || sack_recv_len) {
+		TC_ERROR("Overlapping segment kept (%u queued)\n",
+			 sack_ctx->tcp->ooo_count);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_sack_fill_hole(void)
+{
+	struct net_tcp_options opts;
+
+	if (!sack_peer_send(SACK_PEER_ISN + 1, NET_TCP_ACK, NULL, 0,
+			    sack_data, SACK_HOLE)) {
+		TC_ERROR("Cannot send data\n");
+		return false;
+	}
+
+	if (!sack_check_ack(SACK_PEER_ISN + 1 + sizeof(sack_data), &opts)) {
+		return false;
+	}
+
+	if (opts.sack_count) {
+		TC_ERROR("SACK blocks sent without a hole\n");
+		return false;
+	}
+
+	if (sack_recv_len != sizeof(sack_data) ||
+	    memcmp(sack_recv_buf, sack_data, sizeof(sack_data))) {
+		TC_ERROR("Data not delivered in order (%u bytes)\n",
+			 sack_recv_len);
+		return false;
+	}
+
+	if (sack_ctx->tcp->ooo_count) {
+		TC_ERROR("Segments left queued\n");
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_sack_cleanup(void)
+{
+	struct net_pkt *pkt;
+
+	capture_sent = false;
+
+	while ((pkt = k_fifo_get(&sent_fifo, K_NO_WAIT))) {
+		net_pkt_unref(pkt);
+	}
+
+	if (net_context_put(sack_ctx)) {
+		TC_ERROR("Context free SACK failed.\n");
+		return false;
+	}
+
+	if (net_context_put(sack_listen_ctx)) {
+		TC_ERROR("Context free SACK listener failed.\n");
+		return false;
+	}
+
+	return true;
+}
+#endif /* CONFIG_NET_TCP_SACK && CONFIG_NET_TCP_REASSEMBLY */
+
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+#define CC_MSS 1000
+
+static struct net_tcp cc_tcp;
+
+static void cc_tcp_init(const struct net_tcp_cc *cc)
+{
+	memset(&cc_tcp, 0, sizeof(cc_tcp));
+
+	cc_tcp.send_mss = CC_MSS;
+	cc_tcp.cc = cc;
+	cc->init(&cc_tcp);
+
+	cc_tcp.cwnd = 10 * CC_MSS;
+	cc_tcp.ssthresh = UINT32_MAX;
+}
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+static bool test_cc_cubic_root(void)
+{
+	static const struct {
+		u64_t a;
+		u32_t root;
+	} roots[] = {
+		{ 0, 0 },
+		{ 1, 1 },
+		{ 7, 1 },
+		{ 8, 2 },
+		{ 26, 2 },
+		{ 27, 3 },
+		{ 1000, 10 },
+		{ 999999, 99 },
+		{ 1000000, 100 },
+		{ 9223358842721533950ULL, 2097150 },
+		{ 9223358842721533951ULL, 2097151 },
+		{ UINT64_MAX, 2642245 },
+	};
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(roots); i++) {
+		u32_t root = net_tcp_cc_cubic_root(roots[i].a);
+
+		if (root != roots[i].root) {
+			TC_ERROR("Cube root %d is %u, expected %u\n",
+				 i, root, roots[i].root);
+			return false;
+		}
+	}
+
+	return true;
+}
+#endif
+
+static bool test_cc_fast_rexmit(void)
+{
+	cc_tcp_init(&net_tcp_cc_newreno);
+
+	/* Third duplicate ACK with 8 segments in flight from seq 5000 */
+	net_tcp_cc_fast_rexmit(&cc_tcp, 5000, 8 * CC_MSS);
+
+	if (cc_tcp.ssthresh != 4 * CC_MSS || cc_tcp.cwnd != 7 * CC_MSS ||
+	    cc_tcp.recover != 5000 + 8 * CC_MSS || !cc_tcp.in_recovery ||
+	    cc_tcp.fast_rexmits != 1) {
+		TC_ERROR("NewReno: ssthresh %u cwnd %u recover %u\n",
+			 cc_tcp.ssthresh, cc_tcp.cwnd, cc_tcp.recover);
+		return false;
+	}
+
+	/* The threshold never goes below two segments */
+	cc_tcp_init(&net_tcp_cc_newreno);
+	net_tcp_cc_fast_rexmit(&cc_tcp, 5000, 3 * CC_MSS);
+
+	if (cc_tcp.ssthresh != 2 * CC_MSS || cc_tcp.cwnd != 5 * CC_MSS) {
+		TC_ERROR("NewReno: ssthresh %u cwnd %u\n",
+			 cc_tcp.ssthresh, cc_tcp.cwnd);
+		return false;
+	}
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	/* CUBIC reduces the window itself by beta = 0.7 */
+	cc_tcp_init(&net_tcp_cc_cubic);
+	net_tcp_cc_fast_rexmit(&cc_tcp, 5000, 8 * CC_MSS);
+
+	if (cc_tcp.ssthresh != 7 * CC_MSS || cc_tcp.cwnd != 10 * CC_MSS) {
+		TC_ERROR("CUBIC: ssthresh %u cwnd %u\n",
+			 cc_tcp.ssthresh, cc_tcp.cwnd);
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+static bool test_cc_rto(void)
+{
+	cc_tcp_init(&net_tcp_cc_newreno);
+	cc_tcp.in_recovery = 1;
+	cc_tcp.cc_dup_acks = 2;
+
+	net_tcp_cc_rto(&cc_tcp, 5000, 8 * CC_MSS, true);
+
+	if (cc_tcp.ssthresh != 4 * CC_MSS || cc_tcp.cwnd != CC_MSS ||
+	    cc_tcp.recover != 5000 + 8 * CC_MSS || cc_tcp.in_recovery ||
+	    cc_tcp.cc_dup_acks || cc_tcp.timeouts != 1) {
+		TC_ERROR("First timeout: ssthresh %u cwnd %u\n",
+			 cc_tcp.ssthresh, cc_tcp.cwnd);
+		return false;
+	}
+
+	/* The same segment timing out again keeps the threshold */
+	net_tcp_cc_rto(&cc_tcp, 5000, 2 * CC_MSS, false);
+
+	if (cc_tcp.ssthresh != 4 * CC_MSS || cc_tcp.cwnd != CC_MSS ||
+	    cc_tcp.timeouts != 1) {
+		TC_ERROR("Second timeout: ssthresh %u cwnd %u\n",
+			 cc_tcp.ssthresh, cc_tcp.cwnd);
+		return false;
+	}
+
+	return true;
+}
+
+static bool test_cc_rtt(void)
+{
+	cc_tcp_init(&net_tcp_cc_newreno);
+
+	/* First measurement: SRTT = R, RTTVAR = R / 2 */
+	net_tcp_cc_rtt_update(&cc_tcp, 100);
+
+	if (cc_tcp.srtt != 100 << 3 || cc_tcp.rttvar != 50 << 2) {
+		TC_ERROR("First sample: srtt %u/8 rttvar %u/4\n",
+			 cc_tcp.srtt, cc_tcp.rttvar);
+		return false;
+	}
+
+	/* RTTVAR = 3/4 * 50 + 1/4 * |100 - 60| = 47.5,
+	 * SRTT = 7/8 * 100 + 1/8 * 60 = 95
+	 */
+	net_tcp_cc_rtt_update(&cc_tcp, 60);
+
+	if (cc_tcp.srtt != 95 << 3 || cc_tcp.rttvar != 190) {
+		TC_ERROR("Second sample: srtt %u/8 rttvar %u/4\n",
+			 cc_tcp.srtt, cc_tcp.rttvar);
+		return false;
+	}
+
+	return true;
+}
+#endif /* CONFIG_NET_TCP_CONGESTION_CONTROL */
+
 static bool test_init(void)
 {
 	struct net_if_addr *ifaddr;
@@ -1737,6 +2345,22 @@ static const struct {
 	{ "test TCP seq validity", test_tcp_seq_validity },
 	{ "test TCP reply context init", test_init_tcp_reply_context },
 	{ "test TCP accept init", test_init_tcp_accept },
+	{ "test TCP SACK option parsing", test_sack_parse_opts },
+#if defined(CONFIG_NET_TCP_SACK) && defined(CONFIG_NET_TCP_REASSEMBLY)
+	{ "test TCP SACK connection", test_sack_connect },
+	{ "test TCP out of order segment", test_sack_out_of_order },
+	{ "test TCP overlapping segment", test_sack_overlap },
+	{ "test TCP hole filled", test_sack_fill_hole },
+	{ "test TCP SACK cleanup", test_sack_cleanup },
+#endif
+#if defined(CONFIG_NET_TCP_CONGESTION_CONTROL)
+#if defined(CONFIG_NET_TCP_CC_CUBIC)
+	{ "test TCP CUBIC cube root", test_cc_cubic_root },
+#endif
+	{ "test TCP fast retransmit window", test_cc_fast_rexmit },
+	{ "test TCP retransmission timeout window", test_cc_rto },
+	{ "test TCP RTT estimation", test_cc_rtt },
+#endif
 #if 0
 	/* TBD: more tests are needed */
 	{ "test TCP connect init", test_init_tcp_connect },
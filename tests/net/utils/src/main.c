@@ -504,6 +504,48 @@ void test_utils(void)
 #endif /* CONFIG_NET_IPV4 */
 }
 
+/* Reference ones' complement checksum over big endian words */
+static u16_t ref_chksum(const u16_t *words, int count)
+{
+	u32_t sum = 0;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		sum += words[i];
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+
+	return ~sum;
+}
+
+void test_chksum_update(void)
+{
+	/* IPv4 header, with the checksum word (5th) left out */
+	u16_t hdr[9] = { 0x4500, 0x0073, 0x0000, 0x4000, 0x4011,
+			 0xc0a8, 0x0001, 0xc0a8, 0x00c7 };
+	u16_t chksum, old_val;
+
+	chksum = ref_chksum(hdr, ARRAY_SIZE(hdr));
+	zassert_equal(chksum, 0xb861, "Wrong reference checksum");
+
+	/* TTL decrement */
+	old_val = hdr[4];
+	hdr[4] -= 0x0100;
+	chksum = net_calc_chksum_update(chksum, old_val, hdr[4]);
+	zassert_equal(chksum, ref_chksum(hdr, ARRAY_SIZE(hdr)),
+		      "Wrong checksum after TTL update");
+
+	/* address rewrite, as in NAT, one word at a time */
+	old_val = hdr[7];
+	hdr[7] = 0x0a00;
+	chksum = net_calc_chksum_update(chksum, old_val, hdr[7]);
+	old_val = hdr[8];
+	hdr[8] = 0xffff;
+	chksum = net_calc_chksum_update(chksum, old_val, hdr[8]);
+	zassert_equal(chksum, ref_chksum(hdr, ARRAY_SIZE(hdr)),
+		      "Wrong checksum after address update");
+}
+
 struct net_addr_test_data {
 	sa_family_t family;
 	bool pton;
@@ -1553,6 +1595,7 @@ void test_main(void)
 {
 	ztest_test_suite(test_utils_fn,
 			 ztest_unit_test(test_utils),
+			 ztest_unit_test(test_chksum_update),
 			 ztest_unit_test(test_net_addr),
 			 ztest_unit_test(test_addr_parse),
 			 ztest_unit_test(test_net_pkt_addr_parse));
@@ -107,8 +107,62 @@ void test_mqueue(void)
 	zassert_false(mq_unlink(queue), "Not able to unlink Queue");
 }
 
+void test_mqueue_prio(void)
+{
+	mqd_t mqd;
+	struct mq_attr attrs;
+	char rec_data[MESSAGE_SIZE];
+	unsigned int prio;
+	static const struct {
+		const char *data;
+		unsigned int prio;
+	} sent[] = { { "low", 1 }, { "high", 5 }, { "mid", 3 },
+		     { "high2", 5 } };
+	/* indexes of sent[] in the expected reception order */
+	static const int order[] = { 1, 3, 2, 0 };
+	int i;
+
+	attrs.mq_msgsize = MESSAGE_SIZE;
+	attrs.mq_maxmsg = MESG_COUNT_PERMQ;
+
+	mqd = mq_open("prio", O_RDWR | O_CREAT | O_NONBLOCK, 0777, &attrs);
+	zassert_not_equal(mqd, (mqd_t)-1, "Not able to open message queue");
+
+	for (i = 0; i < ARRAY_SIZE(sent); i++) {
+		zassert_false(mq_send(mqd, sent[i].data,
+				      strlen(sent[i].data) + 1, sent[i].prio),
+			      "Not able to send message");
+	}
+
+	/*TESTPOINT: Check that a full queue does not block*/
+	zassert_equal(mq_send(mqd, "full", 5, 0), -1, "Full queue accepted");
+	zassert_equal(errno, EAGAIN, "Wrong error on full queue");
+
+	zassert_equal(mq_send(mqd, "bad", 4, MQ_PRIO_MAX), -1,
+		      "Invalid priority accepted");
+
+	/*TESTPOINT: Check messages come by priority, then sending order*/
+	for (i = 0; i < ARRAY_SIZE(order); i++) {
+		zassert_equal(mq_receive(mqd, rec_data, MESSAGE_SIZE, &prio),
+			      strlen(sent[order[i]].data) + 1,
+			      "Wrong message length");
+		zassert_false(strcmp(rec_data, sent[order[i]].data),
+			      "Messages received out of order");
+		zassert_equal(prio, sent[order[i]].prio, "Wrong priority");
+	}
+
+	zassert_equal(mq_receive(mqd, rec_data, MESSAGE_SIZE, &prio), -1,
+		      "Received from empty queue");
+	zassert_equal(errno, EAGAIN, "Wrong error on empty queue");
+
+	zassert_false(mq_close(mqd),
+		      "unable to close message queue descriptor.");
+	zassert_false(mq_unlink("prio"), "Not able to unlink Queue");
+}
+
 void test_main(void)
 {
-	ztest_test_suite(test_posix_mqueue, ztest_unit_test(test_mqueue));
+	ztest_test_suite(test_posix_mqueue, ztest_unit_test(test_mqueue),
+			 ztest_unit_test(test_mqueue_prio));
 	ztest_run_test_suite(test_posix_mqueue);
 }
@@ -142,9 +142,102 @@ static void test_rw_lock(void)
 		      "Failed to destroy rwlock");
 }
 
+static void abstime_after(struct timespec *abstime, u32_t msecs)
+{
+	clock_gettime(CLOCK_MONOTONIC, abstime);
+	abstime->tv_sec += msecs / MSEC_PER_SEC;
+	abstime->tv_nsec += (msecs % MSEC_PER_SEC) * NSEC_PER_MSEC;
+	if (abstime->tv_nsec >= NSEC_PER_SEC) {
+		abstime->tv_sec++;
+		abstime->tv_nsec -= NSEC_PER_SEC;
+	}
+}
+
+static void *timed_writer(void *p1)
+{
+	struct timespec abstime;
+
+	abstime_after(&abstime, 100);
+	zassert_equal(pthread_rwlock_timedwrlock(&rwlock, &abstime),
+		      ETIMEDOUT, "Writer got a read locked lock");
+
+	pthread_exit(NULL);
+	return NULL;
+}
+
+static void *timed_reader(void *p1)
+{
+	struct timespec abstime;
+	int ret;
+
+	abstime_after(&abstime, 2000);
+	ret = pthread_rwlock_timedrdlock(&rwlock, &abstime);
+	zassert_false(ret, "Reader not woken after the writer timed out");
+
+	if (ret == 0) {
+		zassert_false(pthread_rwlock_unlock(&rwlock),
+			      "Failed to unlock");
+	}
+
+	pthread_exit(NULL);
+	return NULL;
+}
+
+static pthread_t create_thread(int i, void *(*entry)(void *))
+{
+	pthread_attr_t attr;
+	struct sched_param schedparam;
+	pthread_t thread;
+
+	zassert_equal(pthread_attr_init(&attr), 0,
+		      "Unable to create pthread object attrib");
+
+	schedparam.priority = i + 1;
+	pthread_attr_setschedparam(&attr, &schedparam);
+	pthread_attr_setstack(&attr, &stacks[i][0], STACKSZ);
+
+	zassert_false(pthread_create(&thread, &attr, entry, NULL),
+		      "Low memory to thread new thread");
+	pthread_attr_destroy(&attr);
+
+	return thread;
+}
+
+/* Readers queued behind a waiting writer must get the lock when that
+ * writer times out.
+ */
+static void test_rw_lock_writer_timeout(void)
+{
+	pthread_t writer, reader;
+	void *status;
+
+	zassert_false(pthread_rwlock_init(&rwlock, NULL),
+		      "Failed to create rwlock");
+	zassert_false(pthread_rwlock_rdlock(&rwlock), "Failed to lock");
+
+	/* the writer waits behind our read lock, then the reader behind
+	 * the writer
+	 */
+	writer = create_thread(0, timed_writer);
+	usleep(10 * USEC_PER_MSEC);
+	reader = create_thread(1, timed_reader);
+	usleep(10 * USEC_PER_MSEC);
+	zassert_equal(pthread_rwlock_tryrdlock(&rwlock), EBUSY,
+		      "Reader got the lock ahead of a waiting writer");
+
+	/* let the writer time out, then release our read lock */
+	zassert_false(pthread_join(writer, &status), "Failed to join");
+	zassert_false(pthread_rwlock_unlock(&rwlock), "Failed to unlock");
+
+	zassert_false(pthread_join(reader, &status), "Failed to join");
+	zassert_false(pthread_rwlock_destroy(&rwlock),
+		      "Failed to destroy rwlock");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_posix_rwlock_api,
-			 ztest_unit_test(test_rw_lock));
+			 ztest_unit_test(test_rw_lock),
+			 ztest_unit_test(test_rw_lock_writer_timeout));
 	ztest_run_test_suite(test_posix_rwlock_api);
 }
@@ -87,9 +87,49 @@ void test_timer(void)
 		      "POSIX timer test has failed");
 }
 
+static int thread_exp_count;
+static bool thread_in_isr;
+
+void thread_handler(union sigval val)
+{
+	thread_in_isr |= k_is_in_isr();
+	thread_exp_count += val.sival_int;
+}
+
+void test_timer_thread(void)
+{
+	struct sigevent sig = { 0 };
+	timer_t timerid;
+	struct itimerspec value;
+
+	sig.sigev_notify = SIGEV_THREAD;
+	sig.sigev_notify_function = thread_handler;
+	sig.sigev_value.sival_int = 1;
+
+	/*TESTPOINT: Check that SIGEV_THREAD timers are accepted*/
+	zassert_false(timer_create(CLOCK_MONOTONIC, &sig, &timerid),
+		      "SIGEV_THREAD timer create failed");
+
+	value.it_value.tv_sec = 0;
+	value.it_value.tv_nsec = 10 * NSEC_PER_MSEC;
+	value.it_interval.tv_sec = 0;
+	value.it_interval.tv_nsec = 10 * NSEC_PER_MSEC;
+	zassert_false(timer_settime(timerid, 0, &value, NULL),
+		      "POSIX timer failed to start");
+
+	usleep(105 * USEC_PER_MSEC);
+	timer_delete(timerid);
+
+	/*TESTPOINT: Check notifications ran in thread context*/
+	zassert_true(thread_exp_count >= 9 && thread_exp_count <= 10,
+		     "Wrong number of notifications: %d", thread_exp_count);
+	zassert_false(thread_in_isr, "Notification ran in an ISR");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_posix_timer,
-			 ztest_unit_test(test_timer));
+			 ztest_unit_test(test_timer),
+			 ztest_unit_test(test_timer_thread));
 	ztest_run_test_suite(test_posix_timer);
 }
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2018 Intel Corporation
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <power.h>
+
+#define SLEEP_MS 100
+
+/* both states only idle the CPU, they differ by their latencies */
+static int state_enter(s32_t ticks)
+{
+	ARG_UNUSED(ticks);
+
+	k_cpu_idle();
+
+	return SYS_PM_LOW_POWER_STATE;
+}
+
+static const struct sys_pm_state shallow_state = {
+	.enter = state_enter,
+};
+
+static const struct sys_pm_state deep_state = {
+	.entry_latency_us = 100,
+	.exit_latency_us = 1000,
+	.min_residency_us = 10000,
+	.enter = state_enter,
+};
+
+static int shallow, deep;
+
+static u32_t state_count(int state)
+{
+	struct sys_pm_state_stats stats;
+
+	zassert_equal(sys_pm_state_stats_get(state, &stats), 0, NULL);
+
+	return stats.count;
+}
+
+static void test_register(void)
+{
+	static const struct sys_pm_state no_enter;
+
+	zassert_equal(sys_pm_state_register(&no_enter), -EINVAL, NULL);
+
+	shallow = sys_pm_state_register(&shallow_state);
+	deep = sys_pm_state_register(&deep_state);
+
+	zassert_true(shallow >= 0, "shallow state not registered");
+	zassert_true(deep > shallow, "deep state not registered");
+}
+
+static void test_deepest_state(void)
+{
+	u32_t count = state_count(deep);
+
+	k_sleep(SLEEP_MS);
+
+	zassert_true(state_count(deep) > count, "deep state not entered");
+}
+
+static void test_latency_constraint(void)
+{
+	struct sys_pm_constraint constraint;
+	u32_t shallow_count = state_count(shallow);
+	u32_t deep_count = state_count(deep);
+
+	sys_pm_constraint_add(&constraint, 500);
+	k_sleep(SLEEP_MS);
+	sys_pm_constraint_remove(&constraint);
+
+	zassert_equal(state_count(deep), deep_count,
+		      "deep state entered despite the constraint");
+	zassert_true(state_count(shallow) > shallow_count,
+		     "shallow state not entered");
+
+	k_sleep(SLEEP_MS);
+
+	zassert_true(state_count(deep) > deep_count,
+		     "deep state not entered once the constraint removed");
+}
+
+static void test_stats(void)
+{
+	struct sys_pm_state_stats stats;
+
+	zassert_equal(sys_pm_state_stats_get(deep, &stats), 0, NULL);
+	zassert_true(stats.residency_us > 0, "no residency recorded");
+	zassert_equal(sys_pm_state_stats_get(-1, &stats), -EINVAL, NULL);
+	zassert_equal(sys_pm_state_stats_get(deep + 1, &stats), -EINVAL,
+		      NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(pm_policy,
+			 ztest_unit_test(test_register),
+			 ztest_unit_test(test_deepest_state),
+			 ztest_unit_test(test_latency_constraint),
+			 ztest_unit_test(test_stats));
+	ztest_run_test_suite(pm_policy);
+}
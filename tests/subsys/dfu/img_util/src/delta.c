@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <flash.h>
+#include <misc/byteorder.h>
+#include <dfu/delta_img.h>
+
+#define NEW_SIZE 300
+#define EXTRA_VALUE(i) (0xa5 ^ (i))
+
+static u8_t patch[512];
+static struct delta_img_context ctx;
+
+static size_t put_hdr(u8_t *p, u32_t magic, u32_t size)
+{
+	sys_put_le32(magic, &p[0]);
+	sys_put_le32(size, &p[4]);
+
+	return 8;
+}
+
+static size_t put_ctrl(u8_t *p, u32_t diff, u32_t extra, s32_t adjust)
+{
+	sys_put_le32(diff, &p[0]);
+	sys_put_le32(extra, &p[4]);
+	sys_put_le32((u32_t)adjust, &p[8]);
+
+	return DELTA_IMG_HDR_SIZE;
+}
+
+static size_t put_extra(u8_t *p, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		p[i] = EXTRA_VALUE(i);
+	}
+
+	return len;
+}
+
+/* A patch of NEW_SIZE bytes with two records:
+ *
+ * - 128 bytes copied and 72 bytes incremented from slot 0 offset 0,
+ *   50 extra bytes, then the source moves 100 bytes forward,
+ * - 50 bytes increased by 2 from slot 0 offset 300.
+ */
+static size_t build_patch(void)
+{
+	size_t len = 0;
+
+	len += put_hdr(&patch[len], DELTA_IMG_MAGIC, NEW_SIZE);
+
+	len += put_ctrl(&patch[len], 200, 50, 100);
+	patch[len++] = 0x80 | 127;
+	patch[len++] = 71;
+	memset(&patch[len], 1, 72);
+	len += 72;
+	len += put_extra(&patch[len], 50);
+
+	len += put_ctrl(&patch[len], 50, 0, 0);
+	patch[len++] = 49;
+	memset(&patch[len], 2, 50);
+	len += 50;
+
+	return len;
+}
+
+static struct device *delta_init(void)
+{
+	struct device *flash_dev = device_get_binding(FLASH_DEV_NAME);
+
+	zassert_not_null(flash_dev, "no flash device");
+	delta_img_init(&ctx, flash_dev);
+
+	return flash_dev;
+}
+
+/* errors must be found as the patch is received, not only at the end */
+static int feed(size_t len)
+{
+	return delta_img_write(&ctx, patch, len, false);
+}
+
+void test_delta_apply(void)
+{
+	struct device *flash_dev = delta_init();
+	u8_t old[350], new[NEW_SIZE];
+	size_t len, off, n;
+	int i;
+
+	zassert_equal(flash_read(flash_dev, FLASH_AREA_IMAGE_0_OFFSET, old,
+				 sizeof(old)), 0, "cannot read slot 0");
+
+	flash_write_protection_set(flash_dev, false);
+	flash_erase(flash_dev, FLASH_AREA_IMAGE_1_OFFSET,
+		    FLASH_AREA_IMAGE_1_SIZE);
+	flash_write_protection_set(flash_dev, true);
+
+	len = build_patch();
+
+	/* small pieces, cutting through headers and runs */
+	for (off = 0; off < len; off += n) {
+		n = min(len - off, 7);
+		zassert_equal(delta_img_write(&ctx, &patch[off], n,
+					      off + n == len), 0,
+			      "patch not applied");
+	}
+
+	zassert_equal(flash_img_bytes_written(&ctx.img), NEW_SIZE,
+		      "wrong image size");
+	zassert_equal(flash_read(flash_dev, FLASH_AREA_IMAGE_1_OFFSET, new,
+				 sizeof(new)), 0, "cannot read slot 1");
+
+	for (i = 0; i < 128; i++) {
+		zassert_equal(new[i], old[i], "copied byte %d", i);
+	}
+	for (; i < 200; i++) {
+		zassert_equal(new[i], (u8_t)(old[i] + 1), "diff byte %d", i);
+	}
+	for (; i < 250; i++) {
+		zassert_equal(new[i], EXTRA_VALUE(i - 200), "extra byte %d", i);
+	}
+	for (; i < NEW_SIZE; i++) {
+		zassert_equal(new[i], (u8_t)(old[i + 50] + 2),
+			      "diff byte %d", i);
+	}
+}
+
+void test_delta_bad_header(void)
+{
+	size_t len;
+
+	delta_init();
+	len = put_hdr(patch, 0x12345678, NEW_SIZE);
+	zassert_equal(feed(len), -EINVAL, "bad magic accepted");
+
+	/* the context stays in error */
+	len = build_patch();
+	zassert_equal(feed(len), -EINVAL, "patch accepted after an error");
+
+	delta_init();
+	len = put_hdr(patch, DELTA_IMG_MAGIC, FLASH_AREA_IMAGE_1_SIZE + 1);
+	zassert_equal(feed(len), -EINVAL, "image larger than slot 1");
+}
+
+void test_delta_bad_record(void)
+{
+	size_t len;
+
+	/* diff past the end of the new image */
+	delta_init();
+	len = put_hdr(patch, DELTA_IMG_MAGIC, 100);
+	len += put_ctrl(&patch[len], 101, 0, 0);
+	zassert_equal(feed(len), -EINVAL, "diff length accepted");
+
+	/* extra past the end of the new image */
+	delta_init();
+	len = put_hdr(patch, DELTA_IMG_MAGIC, 100);
+	len += put_ctrl(&patch[len], 50, 51, 0);
+	zassert_equal(feed(len), -EINVAL, "extra length accepted");
+
+	/* diff run longer than the diff data */
+	delta_init();
+	len = put_hdr(patch, DELTA_IMG_MAGIC, 100);
+	len += put_ctrl(&patch[len], 10, 90, 0);
+	patch[len++] = 0x80 | 20;
+	zassert_equal(feed(len), -EINVAL, "diff run accepted");
+
+	/* source offset moved before slot 0 */
+	delta_init();
+	len = put_hdr(patch, DELTA_IMG_MAGIC, 20);
+	len += put_ctrl(&patch[len], 0, 10, -1);
+	len += put_extra(&patch[len], 10);
+	len += put_ctrl(&patch[len], 10, 0, 0);
+	patch[len++] = 0x80 | 9;
+	zassert_equal(feed(len), -EINVAL, "negative source accepted");
+
+	/* source offset moved past slot 0 */
+	delta_init();
+	len = put_hdr(patch, DELTA_IMG_MAGIC, 20);
+	len += put_ctrl(&patch[len], 0, 10, FLASH_AREA_IMAGE_0_SIZE - 5);
+	len += put_extra(&patch[len], 10);
+	len += put_ctrl(&patch[len], 10, 0, 0);
+	patch[len++] = 0x80 | 9;
+	zassert_equal(feed(len), -EINVAL, "source past slot 0 accepted");
+}
+
+void test_delta_truncated(void)
+{
+	/* cut in the header, in a record header, in the diff runs, in the
+	 * diff values, in the extra data and in the last record
+	 */
+	static const size_t cuts[] = { 0, 5, 8, 14, 20, 21, 50, 100, 150,
+				       180, 206 };
+	size_t len;
+	int i;
+
+	len = build_patch();
+	zassert_equal(len, 207, "unexpected patch length");
+
+	for (i = 0; i < ARRAY_SIZE(cuts); i++) {
+		delta_init();
+		zassert_equal(delta_img_write(&ctx, patch, cuts[i], false), 0,
+			      "partial patch refused at %zu", cuts[i]);
+		zassert_equal(delta_img_write(&ctx, patch, 0, true), -EINVAL,
+			      "patch truncated at %zu accepted", cuts[i]);
+	}
+
+	/* data after the end of the patch */
+	delta_init();
+	patch[len] = 0;
+	zassert_equal(feed(len + 1), -EINVAL, "trailing data accepted");
+}
@@ -5,6 +5,7 @@
  */
 
 #include <ztest.h>
+#include <string.h>
 #include <flash.h>
 #include <dfu/flash_img.h>
 
@@ -14,6 +15,13 @@ void test_collecting(void)
 	struct flash_img_context ctx;
 	u32_t i, j;
 	u8_t data[5], temp, k;
+#if defined(CONFIG_IMG_HASH_SHA256)
+	struct tc_sha256_state_struct sha;
+	u8_t digest[TC_SHA256_DIGEST_SIZE];
+	u8_t expected[TC_SHA256_DIGEST_SIZE];
+
+	tc_sha256_init(&sha);
+#endif
 
 	flash_dev = device_get_binding(FLASH_DEV_NAME);
 
@@ -32,11 +40,21 @@ void test_collecting(void)
 		}
 		zassert(flash_img_buffered_write(&ctx, data, sizeof(data),
 						 false) == 0, "pass", "fail");
+#if defined(CONFIG_IMG_HASH_SHA256)
+		tc_sha256_update(&sha, data, sizeof(data));
+#endif
 	}
 
 	zassert(flash_img_buffered_write(&ctx, data, 0, true) == 0, "pass",
 					 "fail");
 
+#if defined(CONFIG_IMG_HASH_SHA256)
+	tc_sha256_final(expected, &sha);
+	zassert(flash_img_hash_get(&ctx, digest) == 0, "pass", "fail");
+	zassert(memcmp(digest, expected, sizeof(digest)) == 0, "pass",
+		"fail");
+#endif
+
 	k = 0;
 	for (i = 0; i < 300 * sizeof(data); i++) {
 		zassert(flash_read(flash_dev, FLASH_AREA_IMAGE_1_OFFSET + i,
@@ -46,9 +64,40 @@ void test_collecting(void)
 	}
 }
 
+#if defined(CONFIG_IMG_DELTA)
+void test_delta_apply(void);
+void test_delta_bad_header(void);
+void test_delta_bad_record(void);
+void test_delta_truncated(void);
+#else
+void test_delta_apply(void)
+{
+	ztest_test_skip();
+}
+
+void test_delta_bad_header(void)
+{
+	ztest_test_skip();
+}
+
+void test_delta_bad_record(void)
+{
+	ztest_test_skip();
+}
+
+void test_delta_truncated(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(test_util,
-			ztest_unit_test(test_collecting));
+			ztest_unit_test(test_collecting),
+			ztest_unit_test(test_delta_apply),
+			ztest_unit_test(test_delta_bad_header),
+			ztest_unit_test(test_delta_bad_record),
+			ztest_unit_test(test_delta_truncated));
 	ztest_run_test_suite(test_util);
 }
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2018 Laczen
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @addtogroup t_nvs
+ * @{
+ * @defgroup t_nvs_basic test_nvs_basic
+ * @brief Non-volatile Storage batch, recovery and garbage collection
+ * @}
+ */
+
+#include <ztest.h>
+#include <string.h>
+#include <device.h>
+#include <flash.h>
+#include <nvs/nvs.h>
+#include "nvs_priv.h"
+
+#define TEST_FLASH_DEV_NAME "nvs_ram_flash"
+#define TEST_PAGE_SIZE 1024
+#define TEST_PAGE_COUNT 4
+#define TEST_FLASH_SIZE (TEST_PAGE_SIZE * TEST_PAGE_COUNT)
+#define TEST_MAGIC 0x4e565354 /* "NVST" */
+#define TEST_MAX_LEN 256
+#define TEST_IDS 4
+
+static u8_t rambuf[TEST_FLASH_SIZE];
+static struct nvs_fs fs;
+
+/* Flash in RAM, programming can only clear bits like NOR flash does */
+
+static int ram_flash_init(struct device *dev)
+{
+	memset(rambuf, 0xff, sizeof(rambuf));
+	return 0;
+}
+
+static int ram_flash_write_protection(struct device *dev, bool enable)
+{
+	return 0;
+}
+
+static int ram_flash_erase(struct device *dev, off_t offset, size_t len)
+{
+	zassert_true(offset >= 0 && offset + len <= TEST_FLASH_SIZE,
+		     "flash address out of bounds");
+	zassert_false((offset | len) & (TEST_PAGE_SIZE - 1),
+		      "erase not page aligned");
+
+	memset(rambuf + offset, 0xff, len);
+	return 0;
+}
+
+static int ram_flash_write(struct device *dev, off_t offset,
+			   const void *data, size_t len)
+{
+	const u8_t *src = data;
+	size_t i;
+
+	zassert_true(offset >= 0 && offset + len <= TEST_FLASH_SIZE,
+		     "flash address out of bounds");
+
+	for (i = 0; i < len; i++) {
+		rambuf[offset + i] &= src[i];
+	}
+	return 0;
+}
+
+static int ram_flash_read(struct device *dev, off_t offset, void *data,
+			  size_t len)
+{
+	zassert_true(offset >= 0 && offset + len <= TEST_FLASH_SIZE,
+		     "flash address out of bounds");
+
+	memcpy(data, rambuf + offset, len);
+	return 0;
+}
+
+static void ram_flash_pages_layout(struct device *dev,
+				   const struct flash_pages_layout **layout,
+				   size_t *layout_size)
+{
+	static const struct flash_pages_layout dev_layout[] = {
+		{ TEST_PAGE_COUNT, TEST_PAGE_SIZE },
+	};
+
+	*layout = dev_layout;
+	*layout_size = ARRAY_SIZE(dev_layout);
+}
+
+static const struct flash_driver_api ram_flash_api = {
+	.write_protection = ram_flash_write_protection,
+	.erase = ram_flash_erase,
+	.write = ram_flash_write,
+	.read = ram_flash_read,
+	.page_layout = ram_flash_pages_layout,
+	.write_block_size = 1,
+};
+
+DEVICE_AND_API_INIT(nvs_ram_flash, TEST_FLASH_DEV_NAME, ram_flash_init,
+		    NULL, NULL, POST_KERNEL,
+		    CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &ram_flash_api);
+
+static void nvs_test_gc_settle(void)
+{
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	/* let a pending garbage collection finish */
+	k_sleep(100);
+#endif
+}
+
+/* Mount the file system as after a reset: nothing but the flash content
+ * is carried over from the previous mount.
+ */
+static int nvs_test_mount(void)
+{
+	nvs_test_gc_settle();
+	memset(&fs, 0, sizeof(fs));
+	fs.offset = 0;
+	fs.sector_size = TEST_PAGE_SIZE;
+	fs.sector_count = TEST_PAGE_COUNT;
+	fs.max_len = TEST_MAX_LEN;
+
+	return nvs_init(&fs, TEST_FLASH_DEV_NAME, TEST_MAGIC);
+}
+
+static void nvs_test_setup(void)
+{
+	nvs_test_gc_settle();
+	memset(rambuf, 0xff, sizeof(rambuf));
+	zassert_equal(nvs_test_mount(), 0, "mount failed");
+}
+
+static void check_entry(u16_t id, const void *expected, size_t len)
+{
+	u8_t buf[TEST_MAX_LEN];
+
+	zassert_equal(nvs_read(&fs, id, buf, sizeof(buf)), len,
+		      "unexpected length for id %u", id);
+	zassert_equal(memcmp(buf, expected, len), 0,
+		      "unexpected data for id %u", id);
+}
+
+static void check_no_entry(u16_t id)
+{
+	u8_t buf[TEST_MAX_LEN];
+
+	zassert_true(nvs_read(&fs, id, buf, sizeof(buf)) < 0,
+		     "id %u should not exist", id);
+}
+
+/**
+ * @brief Test mounting a file system that already holds entries
+ */
+void test_nvs_mount_existing(void)
+{
+	static const char first[] = "first";
+	static const char second[] = "second";
+	static const u32_t value = 0x12345678;
+	off_t write_location;
+	char buf[sizeof(second)];
+
+	nvs_test_setup();
+
+	zassert_equal(nvs_write(&fs, 1, first, sizeof(first)), sizeof(first),
+		      NULL);
+	zassert_equal(nvs_write(&fs, 1, second, sizeof(second)),
+		      sizeof(second), NULL);
+	zassert_equal(nvs_write(&fs, 2, &value, sizeof(value)),
+		      sizeof(value), NULL);
+	write_location = fs.write_location;
+
+	zassert_equal(nvs_test_mount(), 0, "remount failed");
+	zassert_equal(fs.write_location, write_location,
+		      "writes would not continue after the last entry");
+	check_entry(1, second, sizeof(second));
+	check_entry(2, &value, sizeof(value));
+	zassert_equal(nvs_read_hist(&fs, 1, buf, sizeof(buf), 1),
+		      sizeof(first), NULL);
+	zassert_equal(memcmp(buf, first, sizeof(first)), 0, NULL);
+
+	/* a file system with another magic is not mounted as this one */
+	zassert_equal(nvs_init(&fs, TEST_FLASH_DEV_NAME, ~TEST_MAGIC), 0,
+		      NULL);
+	check_no_entry(1);
+}
+
+/**
+ * @brief Test that a committed batch replaces and deletes entries at once
+ */
+void test_nvs_batch_commit(void)
+{
+	static const u32_t old1 = 1, old3 = 3;
+	static const u32_t new1 = 0x11111111, new2 = 0x22222222;
+	u8_t staging[TEST_MAX_LEN];
+	struct nvs_batch batch;
+	int i;
+
+	nvs_test_setup();
+
+	zassert_equal(nvs_write(&fs, 1, &old1, sizeof(old1)), sizeof(old1),
+		      NULL);
+	zassert_equal(nvs_write(&fs, 3, &old3, sizeof(old3)), sizeof(old3),
+		      NULL);
+
+	nvs_batch_init(&batch, staging, sizeof(staging));
+	zassert_equal(nvs_batch_write(&fs, &batch, 1, &new1, sizeof(new1)), 0,
+		      NULL);
+	zassert_equal(nvs_batch_write(&fs, &batch, 2, &new2, sizeof(new2)), 0,
+		      NULL);
+	zassert_equal(nvs_batch_write(&fs, &batch, 3, NULL, 0), 0, NULL);
+	zassert_equal(nvs_batch_write(&fs, &batch, NVS_ID_BATCH, &new1,
+				      sizeof(new1)), -EINVAL,
+		      "reserved id accepted");
+
+	/* nothing is visible before the commit */
+	check_entry(1, &old1, sizeof(old1));
+	check_no_entry(2);
+	check_entry(3, &old3, sizeof(old3));
+
+	zassert_equal(nvs_batch_commit(&fs, &batch), 0, "commit failed");
+	zassert_equal(batch.used, 0, "batch not emptied");
+	check_entry(1, &new1, sizeof(new1));
+	check_entry(2, &new2, sizeof(new2));
+	check_no_entry(3);
+
+	zassert_equal(nvs_test_mount(), 0, "remount failed");
+	check_entry(1, &new1, sizeof(new1));
+	check_entry(2, &new2, sizeof(new2));
+	check_no_entry(3);
+
+	/* a batch never grows past the staging buffer */
+	nvs_batch_init(&batch, staging, 32);
+	for (i = 0; i < 32; i++) {
+		if (nvs_batch_write(&fs, &batch, 4, &new1, sizeof(new1))) {
+			break;
+		}
+	}
+	zassert_true(i > 0 && i < 32, "batch overflow not detected");
+	zassert_equal(nvs_batch_write(&fs, &batch, 4, &new1, sizeof(new1)),
+		      -ENOMEM, NULL);
+	zassert_true(batch.used <= 32, NULL);
+}
+
+/**
+ * @brief Test recovery from a batch cut short by a power loss
+ */
+void test_nvs_batch_interrupted(void)
+{
+	static const u32_t old1 = 1, new1 = 0x11111111, new2 = 0x22222222;
+	static const u32_t after = 0xaaaaaaaa;
+	u8_t staging[TEST_MAX_LEN];
+	struct nvs_batch batch;
+	struct nvs_entry entry;
+
+	nvs_test_setup();
+
+	zassert_equal(nvs_write(&fs, 1, &old1, sizeof(old1)), sizeof(old1),
+		      NULL);
+
+	/* write the batch like nvs_batch_commit() does, but lose power
+	 * before the crc that commits it is written
+	 */
+	nvs_batch_init(&batch, staging, sizeof(staging));
+	zassert_equal(nvs_batch_write(&fs, &batch, 1, &new1, sizeof(new1)), 0,
+		      NULL);
+	zassert_equal(nvs_batch_write(&fs, &batch, 2, &new2, sizeof(new2)), 0,
+		      NULL);
+	entry.id = NVS_ID_BATCH;
+	entry.len = batch.used;
+	zassert_equal(nvs_append(&fs, &entry), 0, NULL);
+	zassert_equal(nvs_flash_write(&fs, entry.data_addr, batch.buf,
+				      batch.used), 0, NULL);
+
+	zassert_equal(nvs_test_mount(), 0, "remount failed");
+	check_entry(1, &old1, sizeof(old1));
+	check_no_entry(2);
+
+	/* new writes go after the dead batch and survive a remount */
+	zassert_equal(nvs_write(&fs, 2, &after, sizeof(after)),
+		      sizeof(after), NULL);
+	check_entry(2, &after, sizeof(after));
+	zassert_equal(nvs_test_mount(), 0, "remount failed");
+	check_entry(1, &old1, sizeof(old1));
+	check_entry(2, &after, sizeof(after));
+
+	/* power lost right after the batch header */
+	entry.id = NVS_ID_BATCH;
+	entry.len = batch.used;
+	zassert_equal(nvs_append(&fs, &entry), 0, NULL);
+
+	zassert_equal(nvs_test_mount(), 0, "remount failed");
+	check_entry(1, &old1, sizeof(old1));
+	check_entry(2, &after, sizeof(after));
+}
+
+/**
+ * @brief Test that reads find the latest entries through garbage collection
+ */
+void test_nvs_gc_lookup(void)
+{
+	struct {
+		u32_t seq;
+		u8_t fill[28];
+	} data, latest[TEST_IDS + 1];
+	u8_t staging[TEST_MAX_LEN];
+	struct nvs_batch batch;
+	u32_t seq;
+	u16_t id;
+	int i;
+
+	nvs_test_setup();
+
+	memset(&data, 0, sizeof(data));
+	memset(latest, 0, sizeof(latest));
+
+	/* rewrite a few ids until the flash has been cycled several times,
+	 * occasionally through a batch
+	 */
+	for (seq = 1; seq < 4 * TEST_FLASH_SIZE / sizeof(data); seq++) {
+		id = 1 + seq % TEST_IDS;
+		data.seq = seq;
+		memset(data.fill, seq, sizeof(data.fill));
+
+		if (seq % 7) {
+			zassert_equal(nvs_write(&fs, id, &data, sizeof(data)),
+				      sizeof(data), "write %u failed", seq);
+		} else {
+			nvs_batch_init(&batch, staging, sizeof(staging));
+			zassert_equal(nvs_batch_write(&fs, &batch, id, &data,
+						      sizeof(data)), 0, NULL);
+			zassert_equal(nvs_batch_commit(&fs, &batch), 0,
+				      "commit %u failed", seq);
+		}
+		latest[id] = data;
+
+		for (i = 1; i <= TEST_IDS; i++) {
+			if (latest[i].seq) {
+				check_entry(i, &latest[i], sizeof(data));
+			}
+		}
+	}
+
+	zassert_equal(nvs_delete(&fs, TEST_IDS), 0, NULL);
+
+	zassert_equal(nvs_test_mount(), 0, "remount failed");
+	for (i = 1; i < TEST_IDS; i++) {
+		check_entry(i, &latest[i], sizeof(data));
+	}
+	check_no_entry(TEST_IDS);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nvs,
+			 ztest_unit_test(test_nvs_mount_existing),
+			 ztest_unit_test(test_nvs_batch_commit),
+			 ztest_unit_test(test_nvs_batch_interrupted),
+			 ztest_unit_test(test_nvs_gc_lookup));
+	ztest_run_test_suite(nvs);
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2018 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdio.h>
+#include <ztest.h>
+
+#include <zephyr.h>
+#include <string.h>
+
+#include <settings/settings.h>
+
+static u32_t val32;
+static u8_t val8;
+static int val32_set_cnt;
+static int val8_set_cnt;
+
+static int c1_set(int argc, char **argv, char *val)
+{
+	int ret;
+
+	if (argc != 1) {
+		return -ENOENT;
+	}
+
+	if (!strcmp(argv[0], "val32")) {
+		val32_set_cnt++;
+		ret = SETTINGS_VALUE_SET(val, SETTINGS_INT32, val32);
+	} else if (!strcmp(argv[0], "val8")) {
+		val8_set_cnt++;
+		ret = SETTINGS_VALUE_SET(val, SETTINGS_INT8, val8);
+	} else {
+		return -ENOENT;
+	}
+
+	return ret ? -EIO : 0;
+}
+
+static struct settings_handler c1_settings = {
+	.name = "hello",
+	.h_set = c1_set,
+};
+
+static void load_clean(void)
+{
+	int err;
+
+	val32 = 0;
+	val8 = 0;
+	val32_set_cnt = 0;
+	val8_set_cnt = 0;
+
+	err = settings_load();
+	zassert_true(err == 0, "can't load settings");
+}
+
+void test_nvs_save_load(void)
+{
+	int err;
+
+	err = settings_save_one("hello/val32", "1234");
+	zassert_true(err == 0, "can't save settings");
+	err = settings_save_one("hello/val8", "12");
+	zassert_true(err == 0, "can't save settings");
+
+	load_clean();
+	zassert_equal(val32, 1234, "bad value read");
+	zassert_equal(val8, 12, "bad value read");
+}
+
+void test_nvs_overwrite(void)
+{
+	char buf[12];
+	int err;
+	int i;
+
+	for (i = 0; i < 10; i++) {
+		snprintf(buf, sizeof(buf), "%d", 4312 + i);
+		err = settings_save_one("hello/val32", buf);
+		zassert_true(err == 0, "can't save settings");
+	}
+
+	/* only the latest value is handed to the handler */
+	load_clean();
+	zassert_equal(val32, 4321, "bad value read");
+	zassert_equal(val32_set_cnt, 1, "value loaded more than once");
+	zassert_equal(val8, 12, "bad value read");
+	zassert_equal(val8_set_cnt, 1, "value loaded more than once");
+}
+
+void test_nvs_delete(void)
+{
+	int err;
+
+	err = settings_save_one("hello/val8", NULL);
+	zassert_true(err == 0, "can't delete setting");
+
+	load_clean();
+	zassert_equal(val8_set_cnt, 0, "deleted value loaded");
+	zassert_equal(val32, 4321, "bad value read");
+
+	/* the freed slot is reused */
+	err = settings_save_one("hello/val8", "21");
+	zassert_true(err == 0, "can't save settings");
+
+	load_clean();
+	zassert_equal(val8, 21, "bad value read");
+	zassert_equal(val8_set_cnt, 1, "value loaded more than once");
+}
+
+void test_nvs_load_one(void)
+{
+	int err;
+
+	val32 = 0;
+	val8 = 0;
+	val32_set_cnt = 0;
+	val8_set_cnt = 0;
+
+	err = settings_load_one("hello/val8");
+	zassert_true(err == 0, "can't load setting");
+	zassert_equal(val8, 21, "bad value read");
+	zassert_equal(val8_set_cnt, 1, "value loaded more than once");
+	zassert_equal(val32_set_cnt, 0, "other value loaded");
+
+	err = settings_load_one("hello/none");
+	zassert_equal(err, -ENOENT, "unknown setting loaded");
+}
+
+void test_nvs_load_subtree(void)
+{
+	int err;
+
+	err = settings_save_one("other/val", "1");
+	zassert_true(err == 0, "can't save settings");
+
+	val32 = 0;
+	val8 = 0;
+	val32_set_cnt = 0;
+	val8_set_cnt = 0;
+
+	err = settings_load_subtree("hello");
+	zassert_true(err == 0, "can't load subtree");
+	zassert_equal(val32, 4321, "bad value read");
+	zassert_equal(val8, 21, "bad value read");
+	zassert_equal(val32_set_cnt, 1, "value loaded more than once");
+	zassert_equal(val8_set_cnt, 1, "value loaded more than once");
+
+	err = settings_save_one("other/val", NULL);
+	zassert_true(err == 0, "can't delete setting");
+}
+
+void test_main(void)
+{
+	int err;
+
+	settings_subsys_init();
+
+	err = settings_register(&c1_settings);
+	zassert_true(err == 0, "can't register the settings handler");
+
+	ztest_test_suite(test_settings_nvs,
+			 ztest_unit_test(test_nvs_save_load),
+			 ztest_unit_test(test_nvs_overwrite),
+			 ztest_unit_test(test_nvs_delete),
+			 ztest_unit_test(test_nvs_load_one),
+			 ztest_unit_test(test_nvs_load_subtree)
+			);
+
+	ztest_run_test_suite(test_settings_nvs);
+}
@@ -8,6 +8,7 @@
 
 #include <lib/crc/crc16_sw.c>
 #include <lib/crc/crc8_sw.c>
+#include <lib/crc/crc32_sw.c>
 
 void test_crc16(void)
 {
@@ -23,6 +24,15 @@ void test_crc16(void)
 		      0xe5cc, NULL);
 }
 
+void test_crc16_other_polynomial(void)
+{
+	u8_t test2[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+
+	/* polynomial without precomputed table */
+	zassert_equal(crc16(test2, sizeof(test2), 0x3d65, 0, true),
+		      0x3d48, NULL);
+}
+
 void test_crc16_ansi(void)
 {
 	u8_t test0[] = { };
@@ -97,14 +107,33 @@ void test_crc8_ccitt(void)
 			   sizeof(test2)) == 0xFB, "pass", "fail");
 }
 
+void test_crc32_ieee(void)
+{
+	u8_t test0[] = { };
+	u8_t test1[] = { 'A' };
+	u8_t test2[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+	u32_t crc;
+
+	zassert_equal(crc32_ieee(test0, sizeof(test0)), 0x0, NULL);
+	zassert_equal(crc32_ieee(test1, sizeof(test1)), 0xd3d99e8b, NULL);
+	zassert_equal(crc32_ieee(test2, sizeof(test2)), 0xcbf43926, NULL);
+
+	/* computed over two blocks */
+	crc = crc32_ieee(test2, 4);
+	zassert_equal(crc32_ieee_update(crc, test2 + 4, sizeof(test2) - 4),
+		      0xcbf43926, NULL);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_crc,
 			 ztest_unit_test(test_crc16),
+			 ztest_unit_test(test_crc16_other_polynomial),
 			 ztest_unit_test(test_crc16_ansi),
 			 ztest_unit_test(test_crc16_ccitt),
 			 ztest_unit_test(test_crc16_ccitt_for_ppp),
 			 ztest_unit_test(test_crc16_itu_t),
-			 ztest_unit_test(test_crc8_ccitt));
+			 ztest_unit_test(test_crc8_ccitt),
+			 ztest_unit_test(test_crc32_ieee));
 	ztest_run_test_suite(test_crc);
 }